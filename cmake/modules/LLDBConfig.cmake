@@ -26,6 +26,9 @@ set(LLDB_DISABLE_PYTHON ${LLDB_DEFAULT_DISABLE_PYTHON} CACHE BOOL
 set(LLDB_DISABLE_CURSES ${LLDB_DEFAULT_DISABLE_CURSES} CACHE BOOL
   "Disables the Curses integration.")
 
+set(LLDB_BUILD_PERF_TOOLS 0 CACHE BOOL
+  "Builds the lldb-perf benchmarks in tools/lldb-perf.")
+
 set(LLDB_RELOCATABLE_PYTHON 0 CACHE BOOL
   "Causes LLDB to use the PYTHONHOME environment variable to locate Python.")
 
@@ -328,6 +331,38 @@ else()
 
 endif()
 
+# Optional libraries used to compress gdb-remote packets on slow connections.
+find_package(ZLIB)
+if (ZLIB_FOUND)
+  add_definitions( -DHAVE_LIBZ )
+  list(APPEND system_libs ${ZLIB_LIBRARIES})
+  include_directories(${ZLIB_INCLUDE_DIRS})
+endif()
+
+find_path(LZ4_INCLUDE_DIR lz4.h)
+find_library(LZ4_LIBRARY NAMES lz4 DOC "The LZ4 compression library")
+if (LZ4_INCLUDE_DIR AND LZ4_LIBRARY)
+  add_definitions( -DHAVE_LIBLZ4 )
+  list(APPEND system_libs ${LZ4_LIBRARY})
+  include_directories(${LZ4_INCLUDE_DIR})
+endif()
+
+# Optional library used to read MiniDebugInfo (.gnu_debugdata) symbol tables.
+find_package(LibLZMA)
+if (LIBLZMA_FOUND)
+  add_definitions( -DHAVE_LIBLZMA )
+  list(APPEND system_libs ${LIBLZMA_LIBRARIES})
+  include_directories(${LIBLZMA_INCLUDE_DIRS})
+endif()
+
+# Optional library used to download debug files from symbol servers.
+find_package(CURL)
+if (CURL_FOUND)
+  add_definitions( -DHAVE_LIBCURL )
+  list(APPEND system_libs ${CURL_LIBRARIES})
+  include_directories(${CURL_INCLUDE_DIRS})
+endif()
+
 if (HAVE_LIBPTHREAD)
   list(APPEND system_libs pthread)
 endif(HAVE_LIBPTHREAD)
@@ -101,4 +101,12 @@ class OperatingSystemPlugIn(object):
         else:
             return struct.pack('21Q',41,42,43,44,45,46,47,48,49,410,411,412,413,414,415,416,417,418,419,420,421);
         return None
+
+    def get_all_register_data(self):
+        # This method is optional. It returns the register data of all the threads from the
+        # last get_thread_info() call in one string of bytes: the register data of each thread,
+        # in the order of the get_thread_info() list. Each thread's data must be as long as
+        # the registers described by get_register_info(). Implementing this avoids a call to
+        # get_register_data() for each thread, which matters when there are many threads.
+        return ''.join(self.get_register_data(thread['tid']) for thread in self.get_thread_info())
     
@@ -72,6 +72,12 @@ public:
 
     bool
     IsOneShot () const;
+
+    void
+    SetCounting (bool counting);
+
+    bool
+    IsCounting () const;
     
     bool
     IsInternal ();
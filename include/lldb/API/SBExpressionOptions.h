@@ -86,6 +86,12 @@ public:
     
     void
     SetTrapExceptions (bool trap_exceptions = true);
+
+    bool
+    GetLightCall () const;
+
+    void
+    SetLightCall (bool light_call = true);
     
     void
     SetLanguage (lldb::LanguageType language);
@@ -385,6 +385,42 @@ public:
     
     lldb::SBThreadCollection
     GetHistoryThreads (addr_t addr);
+
+    //------------------------------------------------------------------
+    /// Get the frame PCs of every thread in one call.
+    ///
+    /// The threads of core files are unwound in parallel.
+    ///
+    /// @param [out] json
+    ///   Receives a JSON array with one {"tid", "index_id", "pcs"}
+    ///   dictionary per thread, "pcs" lists the frames innermost first.
+    ///
+    /// @param [in] max_frames
+    ///   The number of frames to unwind per thread, UINT32_MAX for all.
+    ///
+    /// @return
+    ///   \b true if the process is valid and stopped.
+    //------------------------------------------------------------------
+    bool
+    GetThreadBacktraces (lldb::SBStream &json, uint32_t max_frames = UINT32_MAX);
+
+    //------------------------------------------------------------------
+    /// Find the pointers to an address in the writable memory of the
+    /// process.
+    ///
+    /// @param [in] addr
+    ///   The address to find references to.
+    ///
+    /// @param [out] json
+    ///   Receives a JSON array with one {"address", "description"}
+    ///   dictionary per reference, "description" names the symbol,
+    ///   section or stack frame that holds it and is empty for the heap.
+    ///
+    /// @param [in] max_matches
+    ///   The maximum number of references to return.
+    //------------------------------------------------------------------
+    lldb::SBError
+    FindReferences (addr_t addr, lldb::SBStream &json, uint32_t max_matches = UINT32_MAX);
     
     bool
     IsInstrumentationRuntimePresent(InstrumentationRuntimeType type);
@@ -393,6 +429,11 @@ public:
     lldb::SBError
     SaveCore(const char *file_name);
 
+    // Save the loaded modules and the symbolicated backtraces of all
+    // threads as a compact crash triage record.
+    lldb::SBError
+    SaveTriageRecord(const char *file_name, uint32_t max_frames = UINT32_MAX);
+
 protected:
     friend class SBAddress;
     friend class SBBreakpoint;
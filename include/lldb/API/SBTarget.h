@@ -589,6 +589,32 @@ public:
     ResolveSymbolContextForAddress (const SBAddress& addr, 
                                     uint32_t resolve_scope);
 
+    //------------------------------------------------------------------
+    /// Resolve the symbol contexts of many load addresses with one call.
+    ///
+    /// This is much faster than ResolveLoadAddress() and
+    /// ResolveSymbolContextForAddress() for each address. The addresses
+    /// are grouped by module and the modules resolve their addresses in
+    /// parallel.
+    ///
+    /// @param[in] array
+    ///     The load addresses, in any order.
+    ///
+    /// @param[in] resolve_scope
+    ///     The parts of the symbol contexts to resolve, see
+    ///     lldb::SymbolContextItem. Ask for eSymbolContextBlock to walk
+    ///     the inlined call chain with SBBlock::GetContainingInlinedBlock().
+    ///
+    /// @return
+    ///     One symbol context per address, in the order of \a array.
+    ///     The symbol contexts of addresses that aren't in any module
+    ///     are invalid.
+    //------------------------------------------------------------------
+    lldb::SBSymbolContextList
+    ResolveLoadAddresses (uint64_t *array,
+                          size_t array_len,
+                          uint32_t resolve_scope);
+
     //------------------------------------------------------------------
     /// Read target memory. If a target process is running then memory  
     /// is read from here. Otherwise the memory is read from the object
@@ -813,6 +839,20 @@ public:
     bool
     GetDescription (lldb::SBStream &description, lldb::DescriptionLevel description_level);
 
+    //------------------------------------------------------------------
+    /// Get the statistics "statistics dump" shows for this target.
+    ///
+    /// @param[out] stats
+    ///     Gets a JSON dictionary with per module symbol table and debug
+    ///     info parsing times, expression, breakpoint and process
+    ///     connection statistics.
+    ///
+    /// @return
+    ///     \b true if the target is valid.
+    //------------------------------------------------------------------
+    bool
+    GetStatistics (lldb::SBStream &stats);
+
     lldb::SBValue
     EvaluateExpression (const char *expr);
 
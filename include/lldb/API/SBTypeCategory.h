@@ -13,7 +13,50 @@
 #include "lldb/API/SBDefines.h"
 
 namespace lldb {
-    
+
+    //------------------------------------------------------------------
+    /// The callbacks of a native synthetic children provider.
+    ///
+    /// A plug-in loaded with "plugin load" fills this in and passes it to
+    /// SBTypeCategory::AddTypeSyntheticWithCallbacks() so its types get
+    /// synthetic children without going through Python. New callbacks are
+    /// only ever added at the end, set \a size to the size of the structure
+    /// the plug-in was built with and the ones past it are treated as not
+    /// set.
+    //------------------------------------------------------------------
+    struct SBSyntheticChildrenCallbacks
+    {
+        // sizeof(SBSyntheticChildrenCallbacks) as seen by the plug-in.
+        uint32_t size;
+
+        // Passed to create.
+        void *baton;
+
+        // Called once for every value the provider is used for. The returned
+        // state is passed to the other callbacks, return nullptr to refuse
+        // the value.
+        void * (*create) (void *baton, SBValue valobj);
+
+        // Called when the value no longer uses the provider, may be nullptr.
+        void (*destroy) (void *state);
+
+        // Called when the value may have changed. Return true if the
+        // children handed out so far are still good.
+        bool (*update) (void *state);
+
+        // Return the number of children, counting no more than max of them.
+        uint32_t (*num_children) (void *state, uint32_t max);
+
+        SBValue (*child_at_index) (void *state, uint32_t idx);
+
+        // Return UINT32_MAX if there is no child with this name, may be
+        // nullptr if children can't be looked up by name.
+        uint32_t (*index_of_child) (void *state, const char *name);
+
+        // May be nullptr, num_children is called instead.
+        bool (*might_have_children) (void *state);
+    };
+
     class LLDB_API SBTypeCategory
     {
     public:
@@ -142,6 +185,12 @@ namespace lldb {
         bool
         DeleteTypeSynthetic (SBTypeNameSpecifier);
 #endif
+
+        bool
+        AddTypeSyntheticWithCallbacks (SBTypeNameSpecifier,
+                                       const SBSyntheticChildrenCallbacks &callbacks,
+                                       uint32_t options = 0, // see lldb::eTypeOption values
+                                       const char *description = nullptr);
         
         lldb::SBTypeCategory &
         operator = (const lldb::SBTypeCategory &rhs);
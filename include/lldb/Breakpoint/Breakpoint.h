@@ -401,6 +401,18 @@ public:
     uint32_t
     GetHitCount () const;
 
+    //------------------------------------------------------------------
+    /// Return the time spent resolving this breakpoint.
+    /// @return
+    ///     The time in nanoseconds spent looking for locations, in all
+    ///     modules so far.
+    //------------------------------------------------------------------
+    uint64_t
+    GetResolveTime () const
+    {
+        return m_resolve_time;
+    }
+
     //------------------------------------------------------------------
     /// If \a one_shot is \b true, breakpoint will be deleted on first hit.
     //------------------------------------------------------------------
@@ -415,6 +427,21 @@ public:
     bool
     IsOneShot () const;
 
+    //------------------------------------------------------------------
+    /// If \a counting is \b true, the breakpoint never stops and only
+    /// counts its hits. Process plug-ins that can count hits without
+    /// stopping the process are asked to, see
+    /// Process::UpdateBreakpointHitCounts().
+    //------------------------------------------------------------------
+    void
+    SetCounting (bool counting);
+
+    bool
+    IsCounting () const
+    {
+        return m_counting;
+    }
+
     //------------------------------------------------------------------
     /// Set the valid thread to be checked when the breakpoint is hit.
     /// @param[in] thread_id
@@ -748,9 +775,9 @@ protected:
     IgnoreCountShouldStop ();
 
     void
-    IncrementHitCount()
+    IncrementHitCount(uint32_t count = 1)
     {
-        m_hit_count++;
+        m_hit_count += count;
     }
 
     void
@@ -760,6 +787,19 @@ protected:
         m_hit_count--;
     }
 
+    //------------------------------------------------------------------
+    /// Move the locations in \a old_break_locs to the same file
+    /// addresses in \a new_module_sp without running the resolver. Only
+    /// valid when the new module is the same binary as the old one,
+    /// i.e. they have the same UUID.
+    ///
+    /// @return
+    ///     False if an address couldn't be found in the new module, no
+    ///     location was moved then.
+    //------------------------------------------------------------------
+    bool
+    RemapLocationsToModule (BreakpointLocationCollection &old_break_locs, const lldb::ModuleSP &new_module_sp);
+
 private:
     // This one should only be used by Target to copy breakpoints from target to target - primarily from the dummy
     // target to prime new targets.
@@ -771,6 +811,7 @@ private:
     //------------------------------------------------------------------
     bool m_being_created;
     bool m_hardware;                             // If this breakpoint is required to use a hardware breakpoint
+    bool m_counting;                             // If this breakpoint only counts its hits
     Target &m_target;                            // The target that holds this breakpoint.
     std::unordered_set<std::string> m_name_list; // If not empty, this is the name of this breakpoint (many breakpoints can share the same name.)
     lldb::SearchFilterSP m_filter_sp;            // The filter that constrains the breakpoint's domain.
@@ -786,6 +827,7 @@ private:
     uint32_t    m_hit_count;                   // Number of times this breakpoint/watchpoint has been hit.  This is kept
                                                // separately from the locations hit counts, since locations can go away when
                                                // their backing library gets unloaded, and we would lose hit counts.
+    uint64_t    m_resolve_time;                // Nanoseconds spent resolving this breakpoint.
 
     void
     SendBreakpointChangedEvent (lldb::BreakpointEventType eventKind);
@@ -179,6 +179,14 @@ public:
     bool
     ConditionSaysStop (ExecutionContext &exe_ctx, Error &error);
 
+    //------------------------------------------------------------------
+    /// Let the process know that the condition, the ignore count or the
+    /// thread spec that applies to this location changed, if the location
+    /// is resolved.
+    //------------------------------------------------------------------
+    void
+    NotifySiteConditionsChanged ();
+
     //------------------------------------------------------------------
     /// Set the valid thread to be checked when the breakpoint is hit.
     ///
@@ -412,7 +420,7 @@ private:
     SwapLocation (lldb::BreakpointLocationSP swap_from);
 
     void
-    BumpHitCount();
+    BumpHitCount(uint32_t count = 1);
 
     void
     UndoBumpHitCount();
@@ -66,6 +66,12 @@ public:
 
 protected:
     friend class Breakpoint;
+
+    // Set the breakpoint locations for a line of a compile unit that
+    // matched the regular expression.
+    void
+    SetMatchesForLine (SearchFilter &filter, CompileUnit &cu, FileSpec &file_spec, uint32_t line);
+
     RegularExpression m_regex; // This is the line expression that we are looking for.
     bool m_exact_match;        // If true, then if the source we match is in a comment, we won't set a location there.
     std::unordered_set<std::string> m_function_names; // Limit the search to functions in the comp_unit passed in.
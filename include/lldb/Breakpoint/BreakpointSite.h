@@ -269,6 +269,13 @@ public:
         m_type = type;
     }
 
+    //------------------------------------------------------------------
+    /// Add \a count hits that the process counted without reporting
+    /// them to this site and to the locations that own it.
+    //------------------------------------------------------------------
+    void
+    AddCountedHits (uint32_t count);
+
 private:
     friend class Process;
     friend class BreakpointLocation;
@@ -12,9 +12,11 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <functional>
-#include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -25,6 +27,11 @@ namespace lldb_private {
 //----------------------------------------------------------------------
 /// @class BreakpointSiteList BreakpointSiteList.h "lldb/Breakpoint/BreakpointSiteList.h"
 /// @brief Class that manages lists of BreakpointSite shared pointers.
+///
+/// The sites are kept in a vector sorted by load address. Every memory
+/// read looks for the sites in the range it read, so the lookups don't
+/// take the mutex once the list stopped changing: they use a snapshot of
+/// the vector that is published after a change and dropped by the next.
 //----------------------------------------------------------------------
 class BreakpointSiteList
 {
@@ -160,9 +167,51 @@ public:
     bool
     RemoveByAddress (lldb::addr_t addr);
     
+    //------------------------------------------------------------------
+    /// Adds the sites that overlap [\a lower_bound, \a upper_bound) to
+    /// \a bp_site_list.
+    ///
+    /// @result
+    ///   \b true if at least one site was found.
+    //------------------------------------------------------------------
     bool
     FindInRange (lldb::addr_t lower_bound, lldb::addr_t upper_bound, BreakpointSiteList &bp_site_list) const;
 
+    //------------------------------------------------------------------
+    /// Calls \a callback with each site that overlaps
+    /// [\a lower_bound, \a upper_bound), in address order.
+    ///
+    /// Unlike FindInRange() this doesn't copy the sites anywhere. The
+    /// callback must not add or remove sites.
+    //------------------------------------------------------------------
+    template <typename Callback>
+    void
+    ForEachInRange (lldb::addr_t lower_bound, lldb::addr_t upper_bound, Callback const &callback) const
+    {
+        if (lower_bound >= upper_bound)
+            return;
+
+        SnapshotSP snapshot_sp (GetSnapshot (false));
+        if (snapshot_sp)
+        {
+            for (size_t idx = FindFirstInRange (snapshot_sp->sites, lower_bound, upper_bound);
+                 idx < snapshot_sp->sites.size() && snapshot_sp->sites[idx]->GetLoadAddress() < upper_bound; ++idx)
+            {
+                if (Overlaps (*snapshot_sp->sites[idx], lower_bound))
+                    callback (snapshot_sp->sites[idx]);
+            }
+            return;
+        }
+
+        std::lock_guard<std::recursive_mutex> guard(m_mutex);
+        for (size_t idx = FindFirstInRange (m_bp_site_list, lower_bound, upper_bound);
+             idx < m_bp_site_list.size() && m_bp_site_list[idx]->GetLoadAddress() < upper_bound; ++idx)
+        {
+            if (Overlaps (*m_bp_site_list[idx], lower_bound))
+                callback (m_bp_site_list[idx]);
+        }
+    }
+
     typedef void (*BreakpointSiteSPMapFunc) (lldb::BreakpointSiteSP &bp, void *baton);
 
     //------------------------------------------------------------------
@@ -202,16 +251,53 @@ public:
     }
 
 protected:
-    typedef std::map<lldb::addr_t, lldb::BreakpointSiteSP> collection;
+    typedef std::vector<lldb::BreakpointSiteSP> collection;   // Sorted by load address
+
+    struct Snapshot
+    {
+        collection sites;
+        uint32_t generation;
+    };
+    typedef std::shared_ptr<const Snapshot> SnapshotSP;
+
+    //------------------------------------------------------------------
+    /// Returns the current snapshot of the list, or an empty pointer if
+    /// the list changed since the last one was taken and the caller
+    /// should look at m_bp_site_list under the mutex.
+    ///
+    /// A stale snapshot is rebuilt when it is asked for twice without a
+    /// change in between (or right away if \a force is set), so code
+    /// that alternates between adding a site and reading memory doesn't
+    /// copy the list every time.
+    //------------------------------------------------------------------
+    SnapshotSP
+    GetSnapshot (bool force) const;
 
-    collection::iterator
-    GetIDIterator(lldb::break_id_t breakID);
+    // Returns the index of the first site that can overlap the range.
+    static size_t
+    FindFirstInRange (const collection &sites, lldb::addr_t lower_bound, lldb::addr_t upper_bound);
 
-    collection::const_iterator
-    GetIDConstIterator(lldb::break_id_t breakID) const;
+    // Returns the index of the site at addr, or the size of sites.
+    static size_t
+    FindIndexByAddress (const collection &sites, lldb::addr_t addr);
+
+    static size_t
+    FindIndexByID (const collection &sites, lldb::break_id_t break_id);
+
+    static bool
+    Overlaps (const BreakpointSite &site, lldb::addr_t lower_bound)
+    {
+        return site.GetLoadAddress() >= lower_bound || site.GetLoadAddress() + site.GetByteSize() > lower_bound;
+    }
+
+    void
+    Changed ();
 
     mutable std::recursive_mutex m_mutex;
     collection m_bp_site_list;  // The breakpoint site list.
+    std::atomic<uint32_t> m_generation;             // Bumped by every change of m_bp_site_list
+    mutable SnapshotSP m_snapshot;                  // Only accessed with std::atomic_load/std::atomic_store
+    mutable uint32_t m_stale_snapshot_generation;   // The generation the snapshot was last found stale at
 };
 
 } // namespace lldb_private
@@ -129,9 +129,9 @@ protected:
 
     // If you override this, be sure to call the base class to increment the internal counter.
     void
-    IncrementHitCount ()
+    IncrementHitCount (uint32_t count = 1)
     {
-        ++m_hit_count;
+        m_hit_count += count;
     }
 
     void
@@ -41,6 +41,9 @@ public:
     Searcher::Depth
     GetDepth () override;
 
+    bool
+    GetSourceFileFilter (FileSpec &file_spec, bool &check_inlines) override;
+
     void
     GetDescription (Stream *s) override;
 
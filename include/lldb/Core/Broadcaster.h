@@ -618,8 +618,13 @@ protected:
         typedef std::list< std::pair<lldb::ListenerWP,uint32_t> > collection;
         typedef std::map<uint32_t, std::string> event_names_map;
 
+        // Call "callback" with each listener that is still alive as
+        // bool callback (const lldb::ListenerSP &listener_sp, uint32_t &event_mask)
+        // until it returns false. A template so broadcasting an event doesn't
+        // need a std::function.
+        template <typename Callback>
         void
-        ListenerIterator (std::function <bool (const lldb::ListenerSP &listener_sp, uint32_t &event_mask)> const &callback);
+        ListenerIterator (Callback const &callback);
 
 
         Broadcaster &m_broadcaster;                     ///< The broadcsater that this implements
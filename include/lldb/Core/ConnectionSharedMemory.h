@@ -55,9 +55,36 @@ public:
     std::string
     GetURI() override;
 
+    bool
+    InterruptRead() override;
+
     lldb::ConnectionStatus
     Open (bool create, const char *name, size_t size, Error *error_ptr);
 
+    //------------------------------------------------------------------
+    /// The shared memory, valid until Disconnect() is called. The
+    /// gdb-remote transport uses it to pass bulk data like memory reads
+    /// to a local lldb-server without copying it through the socket.
+    //------------------------------------------------------------------
+    uint8_t *
+    GetBytes ()
+    {
+        return m_mmap.GetBytes();
+    }
+
+    size_t
+    GetByteSize () const
+    {
+        return m_mmap.GetByteSize();
+    }
+
+    //------------------------------------------------------------------
+    /// Remove the name of the shared memory so no one else can open it,
+    /// the memory stays mapped.
+    //------------------------------------------------------------------
+    void
+    Unlink ();
+
 protected:
 
     std::string m_name;
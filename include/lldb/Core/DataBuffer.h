@@ -46,6 +46,17 @@ namespace lldb_private {
 class DataBuffer
 {
 public:
+    //------------------------------------------------------------------
+    /// How a range of the bytes is going to be accessed, see Advise().
+    //------------------------------------------------------------------
+    enum AccessPattern
+    {
+        eAccessPatternNormal,
+        eAccessPatternSequential,
+        eAccessPatternRandom,
+        eAccessPatternWillNeed
+    };
+
     //------------------------------------------------------------------
     /// Destructor
     ///
@@ -88,6 +99,18 @@ public:
     //------------------------------------------------------------------
     virtual lldb::offset_t
     GetByteSize() const = 0;
+
+    //------------------------------------------------------------------
+    /// Tell the host how the bytes in [offset, offset + length) are
+    /// going to be accessed.
+    ///
+    /// This is only a hint. Buffers that don't page their data in
+    /// lazily ignore it.
+    //------------------------------------------------------------------
+    virtual void
+    Advise (lldb::offset_t offset, lldb::offset_t length, AccessPattern pattern)
+    {
+    }
 };
 
 } // namespace lldb_private
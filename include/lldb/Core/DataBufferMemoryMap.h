@@ -70,6 +70,16 @@ public:
     lldb::offset_t
     GetByteSize () const override;
 
+    //------------------------------------------------------------------
+    /// @copydoc DataBuffer::Advise()
+    ///
+    /// Passes the hint on to madvise() so the kernel can read ahead
+    /// sequentially accessed data and skip read ahead for randomly
+    /// accessed data.
+    //------------------------------------------------------------------
+    void
+    Advise (lldb::offset_t offset, lldb::offset_t length, AccessPattern pattern) override;
+
     //------------------------------------------------------------------
     /// Error get accessor.
     ///
@@ -104,6 +114,11 @@ public:
     ///     scenario, mappings and views should be managed at a higher
     ///     level.
     ///
+    /// @param[in] writeable
+    ///     If \b true, the mapped data can be written to. The mapping is
+    ///     copy on write: only the pages that are written get copied
+    ///     and the file itself is never changed.
+    ///
     /// @return
     ///     The number of bytes mapped starting from the \a offset.
     //------------------------------------------------------------------
@@ -133,6 +148,13 @@ public:
     ///     bytes into the file. If \a length is \c SIZE_MAX, map
     ///     as many bytes as possible.
     ///
+    /// @param[in] write
+    ///     If true, the mapping is writeable.
+    ///
+    /// @param[in] fd_is_file
+    ///     If true, writes to the mapping are private copies, otherwise
+    ///     they go to the memory behind \a fd, e.g. shared memory.
+    ///
     /// @return
     ///     The number of bytes mapped starting from the \a offset.
     //------------------------------------------------------------------
@@ -21,6 +21,7 @@
 
 // Project includes
 #include "lldb/lldb-private.h"
+#include "lldb/Core/DataBuffer.h"
 
 namespace lldb_private {
 
@@ -576,6 +577,15 @@ public:
     size_t
     GetSharedDataOffset () const;
 
+    //------------------------------------------------------------------
+    /// Tell the shared data buffer (if any) how the bytes of this
+    /// object are going to be accessed.
+    ///
+    /// @see DataBuffer::Advise()
+    //------------------------------------------------------------------
+    void
+    Advise (DataBuffer::AccessPattern pattern) const;
+
     //------------------------------------------------------------------
     /// Get the data start pointer.
     ///
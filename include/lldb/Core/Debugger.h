@@ -14,9 +14,12 @@
 #include <stdint.h>
 
 // C++ Includes
+#include <condition_variable>
+#include <deque>
 #include <memory>
 #include <map>
 #include <mutex>
+#include <string>
 #include <vector>
 
 // Other libraries and framework includes
@@ -351,6 +354,12 @@ public:
     bool
     SetTabSize (uint32_t tab_size);
 
+    uint32_t
+    GetEventHandlerThreads () const;
+
+    bool
+    SetEventHandlerThreads (uint32_t num_threads);
+
     bool
     GetEscapeNonPrintables () const;
     
@@ -438,12 +447,79 @@ protected:
     void
     HandleThreadEvent (const lldb::EventSP &event_sp);
 
+    //------------------------------------------------------------------
+    // The process, thread and breakpoint events of the targets can be
+    // handled by a pool of threads instead of the event handler thread,
+    // see the "event-handler-threads" setting. All the events of a
+    // target go to the same thread, so they are still handled in order,
+    // but a slow stop in one target doesn't hold up the others.
+    //------------------------------------------------------------------
+    struct TargetEventQueue
+    {
+        TargetEventQueue (Debugger &debugger) :
+            debugger (debugger),
+            thread (),
+            mutex (),
+            cond (),
+            events (),
+            stopped (false)
+        {
+        }
+
+        Debugger &debugger;
+        HostThread thread;
+        std::mutex mutex;   // Protects events and stopped
+        std::condition_variable cond;
+        std::deque<lldb::EventSP> events;
+        bool stopped;
+    };
+    typedef std::vector<std::unique_ptr<TargetEventQueue>> TargetEventQueues;
+
+    // Handle an event broadcast by a target, a process or a thread.
+    void
+    HandleTargetEvent (const lldb::EventSP &event_sp);
+
+    // Hand the event to the queue of its target. Returns false if the
+    // event doesn't belong to a target, it has to be handled right away.
+    bool
+    QueueTargetEvent (const lldb::EventSP &event_sp, TargetEventQueues &queues);
+
+    static lldb::thread_result_t
+    TargetEventThread (lldb::thread_arg_t arg);
+
     size_t
     GetProcessSTDOUT (Process *process, Stream *stream);
     
     size_t
     GetProcessSTDERR (Process *process, Stream *stream);
 
+    //------------------------------------------------------------------
+    // Inferior output that arrives without a state change is handed to
+    // the process output thread instead of being printed from the event
+    // handler thread. The thread coalesces the chunks and writes them,
+    // and redraws the prompt of the top IOHandler, at most once every
+    // few milliseconds so a chatty inferior doesn't get throttled by the
+    // terminal.
+    //------------------------------------------------------------------
+    size_t
+    QueueProcessSTDIO (Process *process, bool is_stdout);
+
+    void
+    QueueProcessOutput (const char *s, size_t len, bool is_stdout);
+
+    // Synchronously print everything that is still queued.
+    void
+    FlushProcessOutput ();
+
+    void
+    StopProcessOutputThread ();
+
+    static lldb::thread_result_t
+    ProcessOutputThread (lldb::thread_arg_t arg);
+
+    void
+    ProcessOutputThreadLoop ();
+
     SourceManager::SourceFileCache &
     GetSourceFileCache ()
     {
@@ -481,6 +557,19 @@ protected:
     LoadedPluginsList m_loaded_plugins;
     HostThread m_event_handler_thread;
     HostThread m_io_handler_thread;
+    struct ProcessOutputChunk
+    {
+        bool is_stdout;
+        std::string data;
+    };
+    typedef std::vector<ProcessOutputChunk> ProcessOutputChunks;
+    HostThread m_process_output_thread;
+    std::mutex m_process_output_mutex;         // Protects m_process_output, m_process_output_size and m_process_output_stopped
+    std::mutex m_process_output_write_mutex;   // Held while a batch is printed so batches come out in order
+    std::condition_variable m_process_output_cond;
+    ProcessOutputChunks m_process_output;
+    size_t m_process_output_size;
+    bool m_process_output_stopped;
     Broadcaster m_sync_broadcaster;
     lldb::ListenerSP m_forward_listener_sp;
     std::once_flag m_clear_once;
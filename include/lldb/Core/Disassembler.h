@@ -12,6 +12,9 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <string>
 
@@ -27,6 +30,23 @@
 
 namespace lldb_private {
 
+//----------------------------------------------------------------------
+/// @struct DecodedInstruction Disassembler.h "lldb/Core/Disassembler.h"
+/// @brief What the disassembly cache keeps of a decoded instruction.
+///
+/// The opcode bytes stay in the buffer of the disassembled range, and the
+/// mnemonic, operands and comment are only formatted once an Instruction
+/// made out of this is displayed.
+//----------------------------------------------------------------------
+struct DecodedInstruction
+{
+    uint32_t offset;        // Offset of the opcode in the range
+    uint8_t byte_size;
+    uint8_t opcode_type;    // Opcode::Type
+    uint8_t address_class;  // lldb::AddressClass
+    uint8_t reserved;
+};
+
 class Instruction
 {
 public:
@@ -183,6 +203,16 @@ public:
     uint32_t
     GetData (DataExtractor &data);
 
+    //------------------------------------------------------------------
+    /// Set the opcode of this instruction from a cached decode of \a
+    /// data instead of decoding it again.
+    ///
+    /// @return
+    ///     False if \a decoded doesn't fit in \a data.
+    //------------------------------------------------------------------
+    bool
+    SetOpcode (const DataExtractor &data, const DecodedInstruction &decoded);
+
 protected:
     Address m_address; // The section offset address of this instruction
     // We include an address class in the Instruction class to
@@ -295,6 +325,70 @@ protected:
     DISALLOW_COPY_AND_ASSIGN (PseudoInstruction);
 };
 
+//----------------------------------------------------------------------
+/// @class DisassemblyCache Disassembler.h "lldb/Core/Disassembler.h"
+/// @brief The decoded instructions of file backed code in a module.
+///
+/// Stepping, unwinding and the disassembly views disassemble the same
+/// functions over and over. When the bytes of a range come from the
+/// object file they can't change, so Disassembler::ParseInstructions
+/// keeps the bytes and a DecodedInstruction for each instruction here and
+/// makes new instruction lists from them without reading memory or
+/// decoding again. Each Module owns one.
+//----------------------------------------------------------------------
+class DisassemblyCache
+{
+public:
+    struct Entry
+    {
+        lldb::DataBufferSP data_sp;
+        std::vector<DecodedInstruction> instructions;
+    };
+
+    typedef std::shared_ptr<const Entry> EntrySP;
+
+    struct Key
+    {
+        lldb::addr_t file_addr;
+        lldb::addr_t byte_size;
+        ConstString triple;
+        ConstString plugin_name;
+        ConstString flavor;
+
+        bool
+        operator < (const Key &rhs) const;
+    };
+
+    // Everything is dropped when the cache grows past this, which is
+    // enough for many thousands of functions.
+    static const size_t kMaxMemorySize = 16 * 1024 * 1024;
+
+    DisassemblyCache ();
+
+    ~DisassemblyCache ();
+
+    EntrySP
+    Find (const Key &key);
+
+    void
+    Add (const Key &key, const EntrySP &entry_sp);
+
+    void
+    Clear ();
+
+    size_t
+    GetMemorySize () const;
+
+private:
+    typedef std::map<Key, EntrySP> collection;
+
+    mutable std::mutex m_mutex;
+    collection m_entries;
+    size_t m_memory_size;
+
+    DISALLOW_COPY_AND_ASSIGN (DisassemblyCache);
+};
+
 class Disassembler :
     public std::enable_shared_from_this<Disassembler>,
     public PluginInterface
@@ -464,6 +558,34 @@ public:
     virtual bool
     FlavorValidForArchSpec (const lldb_private::ArchSpec &arch, const char *flavor) = 0;    
 
+    //------------------------------------------------------------------
+    /// Fill in the instruction list from a range that was decoded
+    /// before, without decoding the instructions again.
+    ///
+    /// Plugins that don't override this can't use the disassembly cache
+    /// and always decode.
+    ///
+    /// @param[in] base_addr
+    ///     The address of the start of the range.
+    ///
+    /// @param[in] data
+    ///     The bytes of the range.
+    ///
+    /// @param[in] decoded
+    ///     The instructions in the range, as DecodeInstructions found
+    ///     them.
+    ///
+    /// @return
+    ///     True if the instruction list was filled in.
+    //------------------------------------------------------------------
+    virtual bool
+    CreateCachedInstructions (const Address &base_addr,
+                              const DataExtractor &data,
+                              const std::vector<DecodedInstruction> &decoded)
+    {
+        return false;
+    }
+
 protected:
     //------------------------------------------------------------------
     // Classes that inherit from Disassembler can see and modify these
@@ -477,6 +599,9 @@ private:
     //------------------------------------------------------------------
     // For Disassembler only
     //------------------------------------------------------------------
+    DisassemblyCache::EntrySP
+    CreateCacheEntry (const Address &base_addr, const lldb::DataBufferSP &data_sp);
+
     DISALLOW_COPY_AND_ASSIGN (Disassembler);
 };
 
@@ -12,7 +12,9 @@
 
 // C Includes
 // C++ Includes
-#include <list>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <string>
@@ -22,7 +24,6 @@
 // Project includes
 #include "lldb/lldb-private.h"
 #include "lldb/Core/Broadcaster.h"
-#include "lldb/Host/Condition.h"
 #include "lldb/Core/Event.h"
 
 namespace lldb_private {
@@ -126,6 +127,22 @@ public:
     size_t
     HandleBroadcastEvent (lldb::EventSP &event_sp);
 
+    //------------------------------------------------------------------
+    /// The removal actions of an event, e.g. the breakpoint commands and
+    /// stop hooks of a process stop, are normally done by the thread
+    /// that takes the event off the queue. A listener that hands its
+    /// events to other threads can defer them, whoever handles the event
+    /// then has to call DoDeferredRemovalActions() with it.
+    //------------------------------------------------------------------
+    void
+    SetDeferRemovalActions (bool defer_removal_actions)
+    {
+        m_defer_removal_actions = defer_removal_actions;
+    }
+
+    static void
+    DoDeferredRemovalActions (const lldb::EventSP &event_sp);
+
 private:
     //------------------------------------------------------------------
     // Classes that inherit from Listener can see and modify these
@@ -147,11 +164,11 @@ private:
     typedef std::multimap<Broadcaster::BroadcasterImplWP,
                           BroadcasterInfo,
                           std::owner_less<Broadcaster::BroadcasterImplWP>> broadcaster_collection;
-    typedef std::list<lldb::EventSP> event_collection;
+    typedef std::deque<lldb::EventSP> event_collection;
     typedef std::vector<lldb::BroadcasterManagerWP> broadcaster_manager_collection;
 
     bool
-    FindNextEventInternal(Mutex::Locker& lock,
+    FindNextEventInternal(std::unique_lock<std::mutex> &lock,
                           Broadcaster *broadcaster,   // nullptr for any broadcaster
                           const ConstString *sources, // nullptr for any event
                           uint32_t num_sources,
@@ -178,8 +195,10 @@ private:
     broadcaster_collection m_broadcasters;
     std::recursive_mutex m_broadcasters_mutex; // Protects m_broadcasters
     event_collection m_events;
-    Mutex m_events_mutex; // Protects m_broadcasters and m_events
-    Condition m_events_condition;
+    std::mutex m_events_mutex; // Protects m_events and m_events_waiters
+    std::condition_variable m_events_condition;
+    uint32_t m_events_waiters; // Threads in WaitForEventsInternal(), AddEvent() only wakes up the listener if there are any
+    std::atomic<bool> m_defer_removal_actions;
     broadcaster_manager_collection m_broadcaster_managers;
 
     void
@@ -13,6 +13,8 @@
 // C Includes
 // C++ Includes
 #include <atomic>
+#include <functional>
+#include <map>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -20,14 +22,18 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-forward.h"
+#include "lldb/Core/Address.h"
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/UUID.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/TimeValue.h"
+#include "lldb/Symbol/Declaration.h"
 #include "lldb/Symbol/SymbolContextScope.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/PathMappingList.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringRef.h"
 
 namespace lldb_private {
 
@@ -585,10 +591,7 @@ public:
     }
 
     void
-    SetPlatformFileSpec (const FileSpec &file)
-    {
-        m_platform_file = file;
-    }
+    SetPlatformFileSpec (const FileSpec &file);
 
     const FileSpec &
     GetRemoteInstallFileSpec () const
@@ -789,6 +792,22 @@ public:
     const lldb_private::UUID &
     GetUUID ();
 
+    // Returns true if GetUUID() won't have to read the object file.
+    bool
+    HasParsedUUID () const
+    {
+        return m_did_parse_uuid.load();
+    }
+
+    //------------------------------------------------------------------
+    /// Get a number that changes whenever the file spec or platform
+    /// file spec of any module changes.
+    ///
+    /// ModuleList uses this to know when its path index is out of date.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetFileSpecGeneration ();
+
     //------------------------------------------------------------------
     /// A debugging function that will cause everything in a module to
     /// be parsed.
@@ -805,6 +824,31 @@ public:
     void
     ParseAllDebugSymbols();
 
+    //------------------------------------------------------------------
+    /// Build the symbol table and debug info name indexes that lookups
+    /// by name, like resolving breakpoints, use.
+    ///
+    /// The lookups build them on demand. Calling this first lets the
+    /// indexes of many modules be built in parallel.
+    ///
+    /// @param[in] index_debug_info
+    ///     If false, only read the object file and symbol table, and
+    ///     leave the debug info for later.
+    //------------------------------------------------------------------
+    void
+    PreloadSymbols (bool index_debug_info = true);
+
+    //------------------------------------------------------------------
+    /// Build the debug info name indexes a little at a time, releasing
+    /// the module lock in between so stopping and looking up addresses
+    /// in the module never waits for the whole index.
+    ///
+    /// Meant to be called on a background thread after
+    /// PreloadSymbols(false).
+    //------------------------------------------------------------------
+    void
+    PreloadSymbolsInBackground ();
+
     bool
     ResolveFileAddress (lldb::addr_t vm_addr, Address& so_addr);
 
@@ -953,6 +997,11 @@ public:
     TypeSystem *
     GetTypeSystemForLanguage (lldb::LanguageType language);
 
+    // Call \a callback with each type system the module created so far,
+    // until it returns false.
+    void
+    ForEachTypeSystem (std::function<bool(TypeSystem *)> const &callback);
+
     // Special error functions that can do printf style formatting that will prepend the message with
     // something appropriate for this module (like the architecture, path and object name (if any)). 
     // This centralizes code so that everyone doesn't need to format their error and log messages on
@@ -1003,6 +1052,105 @@ public:
     {
         return m_source_mappings;
     }
+
+    //------------------------------------------------------------------
+    /// Get the decoded instructions of this module's code that were
+    /// disassembled from the object file.
+    //------------------------------------------------------------------
+    DisassemblyCache &
+    GetDisassemblyCache ();
+
+    // One step out of an inlined function, the frame of its caller.
+    struct InlinedCallSite
+    {
+        Block *block;           // The block the function was inlined into
+        Address call_address;   // The start of the inlined range, used as the caller's PC
+        Declaration call_site;  // Where the inlined function was called from
+    };
+    typedef std::vector<InlinedCallSite> InlinedCallChain;
+
+    //------------------------------------------------------------------
+    /// Get the callers of the inlined functions that contain an address.
+    ///
+    /// The chain is computed by walking the parents of \a block once for
+    /// each range of \a block and cached, so synthesizing the inlined
+    /// frames of a backtrace doesn't walk the blocks again for each
+    /// concrete frame.
+    ///
+    /// @param[in] block
+    ///     The deepest block of this module that contains \a addr.
+    ///
+    /// @param[out] chain
+    ///     The callers, from the innermost inlined function outward.
+    ///     Empty if \a addr isn't in an inlined function.
+    ///
+    /// @return
+    ///     True if \a chain isn't empty.
+    //------------------------------------------------------------------
+    bool
+    GetInlinedCallChain (Block *block, const Address &addr, InlinedCallChain &chain);
+
+    //------------------------------------------------------------------
+    /// Find the names of the functions in this module that start with
+    /// a prefix, used to complete symbol names.
+    ///
+    /// The names of the code symbols and of the functions in the debug
+    /// info are sorted into an index the first time this is called, so
+    /// that completing a name is a binary search instead of a regular
+    /// expression match against every symbol.
+    ///
+    /// @param[in] prefix
+    ///     The start of the names, every name starts with an empty
+    ///     prefix.
+    ///
+    /// @param[in] max_matches
+    ///     Stop once this many names were appended to \a names.
+    ///
+    /// @return
+    ///     The number of names appended to \a names.
+    //------------------------------------------------------------------
+    size_t
+    FindFunctionNamesWithPrefix (llvm::StringRef prefix,
+                                 size_t max_matches,
+                                 std::vector<ConstString> &names);
+
+    //------------------------------------------------------------------
+    /// Find the compile units of this module whose file name starts
+    /// with \a file_prefix and whose directory starts with \a
+    /// dir_prefix, used to complete source file names.
+    ///
+    /// Like FindFunctionNamesWithPrefix(), the compile units are sorted
+    /// by file name the first time this is called.
+    ///
+    /// @return
+    ///     The number of compile units appended to \a comp_units.
+    //------------------------------------------------------------------
+    size_t
+    FindCompileUnitsWithFilePrefix (llvm::StringRef file_prefix,
+                                    llvm::StringRef dir_prefix,
+                                    size_t max_matches,
+                                    std::vector<lldb::CompUnitSP> &comp_units);
+
+    //------------------------------------------------------------------
+    /// Find the compile units that can have line entries for a source
+    /// file named \a filename, so file and line searches don't have to
+    /// look at every compile unit.
+    ///
+    /// The file names of the compile units, and with \a check_inlines
+    /// the names of all their support files, are indexed the first time
+    /// this is called. The name is matched case sensitively.
+    ///
+    /// @param[out] cu_indexes
+    ///     The indexes of the compile units, in increasing order.
+    ///
+    /// @return
+    ///     False if the file names of this module can't be matched case
+    ///     sensitively, the caller has to look at all compile units then.
+    //------------------------------------------------------------------
+    bool
+    FindCompileUnitIndexesForFilename (const ConstString &filename,
+                                       bool check_inlines,
+                                       std::vector<uint32_t> &cu_indexes);
     
     //------------------------------------------------------------------
     /// Finds a source file given a file spec using the module source
@@ -1124,12 +1272,23 @@ protected:
     TypeSystemMap               m_type_system_map;    ///< A map of any type systems associated with this module
     PathMappingList             m_source_mappings; ///< Module specific source remappings for when you have debug info for a module that doesn't match where the sources currently are
     lldb::SectionListUP         m_sections_ap; ///< Unified section list for module that is used by the ObjectFile and and ObjectFile instances for the debug info
+    std::unique_ptr<DisassemblyCache> m_disassembly_cache_ap; ///< Created the first time a range of this module is disassembled
+    std::map<std::pair<Block *, lldb::addr_t>, InlinedCallChain> m_inlined_call_chains; ///< The chains by block and file address of the block range
+    std::vector<ConstString>    m_completion_function_names; ///< The function names sorted by FindFunctionNamesWithPrefix()
+    std::vector<lldb::CompUnitSP> m_completion_comp_units; ///< The compile units sorted by FindCompileUnitsWithFilePrefix()
+    typedef llvm::DenseMap<const char *, std::vector<uint32_t>> FilenameToCompUnitIndexes;
+    FilenameToCompUnitIndexes   m_comp_unit_filename_index;   ///< The compile units by their own file name
+    FilenameToCompUnitIndexes   m_support_file_filename_index; ///< The compile units by the names of their support files
 
     std::atomic<bool>           m_did_load_objfile;
     std::atomic<bool>           m_did_load_symbol_vendor;
     std::atomic<bool>           m_did_parse_uuid;
     mutable bool                m_file_has_changed:1,
                                 m_first_file_changed_log:1;   /// See if the module was modified after it was initially opened.
+    bool                        m_completion_function_names_indexed:1,
+                                m_completion_comp_units_indexed:1,
+                                m_comp_unit_filenames_indexed:1,
+                                m_support_file_filenames_indexed:1;
 
     //------------------------------------------------------------------
     /// Resolve a file or load virtual address.
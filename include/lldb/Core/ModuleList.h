@@ -15,6 +15,8 @@
 #include <functional>
 #include <list>
 #include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -588,7 +590,49 @@ protected:
     
     void
     ClearImpl (bool use_notifier = true);
-    
+
+    //------------------------------------------------------------------
+    // Hash indexes of m_modules by UUID and by the basenames of the file
+    // and platform file of each module, for module spec lookups. They are
+    // built the first time a large list is searched and then kept up to
+    // date as modules are added and removed. A module spec first picks
+    // its candidates from an index and then checks them with
+    // Module::MatchesModuleSpec().
+    //
+    // Modules whose UUID wasn't parsed yet aren't kept in the UUID index
+    // until a UUID lookup parses it, the same as a linear search would.
+    //------------------------------------------------------------------
+    struct IndexedModule
+    {
+        lldb::ModuleSP module_sp;
+        uint64_t order;     // Increases with the position in m_modules
+    };
+
+    typedef std::unordered_multimap<std::string, IndexedModule> UUIDIndex;
+    typedef std::unordered_multimap<const char *, IndexedModule> NameIndex;
+
+    // Fills "candidates" with the modules that can match module_spec, in
+    // list order. Returns false if the list isn't indexed or the spec
+    // can't be looked up in the indexes, then all modules have to be
+    // checked. Must be called with m_modules_mutex locked.
+    bool
+    GetIndexCandidates (const ModuleSpec &module_spec, std::vector<lldb::ModuleSP> &candidates) const;
+
+    void
+    UpdateIndexes () const;
+
+    void
+    ClearIndexes () const;
+
+    void
+    AddToIndexes (const lldb::ModuleSP &module_sp) const;
+
+    void
+    RemoveFromIndexes (const lldb::ModuleSP &module_sp) const;
+
+    void
+    IndexParsedUUIDs () const;
+
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
@@ -596,6 +640,13 @@ protected:
     mutable std::recursive_mutex m_modules_mutex;
 
     Notifier* m_notifier;
+
+    mutable bool m_indexes_valid;
+    mutable uint32_t m_indexes_generation;      // Module::GetFileSpecGeneration() when the indexes were built
+    mutable uint64_t m_next_index_order;
+    mutable UUIDIndex m_uuid_index;
+    mutable NameIndex m_name_index;
+    mutable std::vector<IndexedModule> m_unparsed_uuid_modules;
     
 public:
     typedef LockingAdaptedIterable<collection, lldb::ModuleSP, vector_adapter, std::recursive_mutex> ModuleIterable;
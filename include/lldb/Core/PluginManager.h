@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
@@ -215,6 +217,24 @@ public:
     static ObjectFileCreateMemoryInstance
     GetObjectFileCreateMemoryCallbackForPluginName (const ConstString &name);
 
+    //------------------------------------------------------------------
+    /// Declare bytes that files the object file plug-in can read start
+    /// with. A plug-in can add several magics. Files are only offered to
+    /// the plug-ins whose magic they start with and to the plug-ins that
+    /// don't declare any magic.
+    //------------------------------------------------------------------
+    static bool
+    AddObjectFileMagic (ObjectFileCreateInstance create_callback, const void *magic, size_t magic_size);
+
+    //------------------------------------------------------------------
+    /// Get the indexes of the object file plug-ins that might be able to
+    /// read a file starting with \a data, in the order the plug-ins were
+    /// registered. The plug-ins are looked up by the first two bytes of
+    /// their magic, the other plug-ins don't have to be probed.
+    //------------------------------------------------------------------
+    static void
+    GetObjectFilePluginIndexesForData (const uint8_t *data, size_t data_size, std::vector<uint32_t> &indexes);
+
     static Error
     SaveCore (const lldb::ProcessSP &process_sp, const FileSpec &outfile);
 
@@ -345,6 +365,24 @@ public:
     static SymbolFileCreateInstance
     GetSymbolFileCreateCallbackForPluginName (const ConstString &name);
 
+    //------------------------------------------------------------------
+    /// Restrict a symbol file plug-in to the object files of one object
+    /// file plug-in, for plug-ins that never have any abilities for the
+    /// other object file formats.
+    //------------------------------------------------------------------
+    static bool
+    SetSymbolFileObjectFilePluginName (SymbolFileCreateInstance create_callback,
+                                       const ConstString &object_file_plugin_name);
+
+    //------------------------------------------------------------------
+    /// Get the symbol file plug-ins worth creating for an object file of
+    /// the named object file plug-in. The list is computed once per object
+    /// file plug-in.
+    //------------------------------------------------------------------
+    static void
+    GetSymbolFileCreateCallbacksForObjectFile (const ConstString &object_file_plugin_name,
+                                               std::vector<SymbolFileCreateInstance> &create_callbacks);
+
     //------------------------------------------------------------------
     // SymbolVendor
     //------------------------------------------------------------------
@@ -1067,6 +1067,7 @@ namespace lldb_private {
         Append (const Entry &entry)
         {
             m_entries.push_back (entry);
+            m_upper_bounds.clear();
         }
         
         void
@@ -1074,6 +1075,31 @@ namespace lldb_private {
         {
             if (m_entries.size() > 1)
                 std::stable_sort (m_entries.begin(), m_entries.end());
+            m_upper_bounds.clear();
+        }
+
+        //------------------------------------------------------------------
+        /// Make FindEntryIndexesThatContain() take O(log n + k) instead of
+        /// going through all entries.
+        ///
+        /// The sorted entries are seen as an implicit balanced binary tree,
+        /// the middle entry of each subrange being the root of that
+        /// subrange, and every node remembers the largest range end of its
+        /// subtree. Lookups skip the subtrees that end before the address
+        /// and the ones that start after it.
+        ///
+        /// Call this after Sort(), changing the entries in any way throws
+        /// the index away again.
+        //------------------------------------------------------------------
+        void
+        BuildContainmentIndex ()
+        {
+#ifdef ASSERT_RANGEMAP_ARE_SORTED
+            assert (IsSorted());
+#endif
+            m_upper_bounds.resize (m_entries.size());
+            if (!m_entries.empty())
+                ComputeUpperBounds (0, m_entries.size());
         }
         
 #ifdef ASSERT_RANGEMAP_ARE_SORTED
@@ -1129,6 +1155,7 @@ namespace lldb_private {
                 // We must swap when using the STL because std::vector objects never
                 // release or reduce the memory once it has been allocated/reserved.
                 m_entries.swap (minimal_ranges);
+                m_upper_bounds.clear();
             }
         }
         
@@ -1140,6 +1167,7 @@ namespace lldb_private {
 #ifdef ASSERT_RANGEMAP_ARE_SORTED
             assert (IsSorted());
 #endif
+            m_upper_bounds.clear();
             typename Collection::iterator pos;
             typename Collection::iterator end;
             typename Collection::iterator next;
@@ -1170,12 +1198,14 @@ namespace lldb_private {
         Clear ()
         {
             m_entries.clear();
+            m_upper_bounds.clear();
         }
 
         void
         Reserve (typename Collection::size_type size)
         {
             m_entries.resize (size);
+            m_upper_bounds.clear();
         }
 
         bool
@@ -1196,6 +1226,7 @@ namespace lldb_private {
             return ((i < m_entries.size()) ? &m_entries[i] : nullptr);
         }
 
+        // Changing the range of an entry needs a Sort() afterwards.
         Entry *
         GetMutableEntryAtIndex (size_t i)
         {
@@ -1244,9 +1275,13 @@ namespace lldb_private {
             assert (IsSorted());
 #endif
 
-            if (!m_entries.empty())
+            if (m_upper_bounds.size() == m_entries.size())
+            {
+                if (!m_entries.empty())
+                    FindEntryIndexesThatContain (0, m_entries.size(), addr, indexes);
+            }
+            else
             {
-                typename Collection::const_iterator pos;
                 for (const auto &entry : m_entries)
                 {
                     if (entry.Contains(addr))
@@ -1354,7 +1389,41 @@ namespace lldb_private {
         }
         
     protected:
+        // Fill in m_upper_bounds for the subtree of [lo, hi) and return its
+        // largest range end.
+        B
+        ComputeUpperBounds (size_t lo, size_t hi)
+        {
+            const size_t mid = lo + (hi - lo) / 2;
+            B upper_bound = m_entries[mid].GetRangeEnd();
+            if (lo < mid)
+                upper_bound = std::max (upper_bound, ComputeUpperBounds (lo, mid));
+            if (mid + 1 < hi)
+                upper_bound = std::max (upper_bound, ComputeUpperBounds (mid + 1, hi));
+            m_upper_bounds[mid] = upper_bound;
+            return upper_bound;
+        }
+
+        void
+        FindEntryIndexesThatContain (size_t lo, size_t hi, B addr, std::vector<uint32_t> &indexes) const
+        {
+            const size_t mid = lo + (hi - lo) / 2;
+            // Nothing in this subtree reaches addr.
+            if (m_upper_bounds[mid] <= addr)
+                return;
+            if (lo < mid)
+                FindEntryIndexesThatContain (lo, mid, addr, indexes);
+            // This entry and the ones after it start after addr.
+            if (m_entries[mid].GetRangeBase() > addr)
+                return;
+            if (m_entries[mid].Contains(addr))
+                indexes.push_back(m_entries[mid].data);
+            if (mid + 1 < hi)
+                FindEntryIndexesThatContain (mid + 1, hi, addr, indexes);
+        }
+
         Collection m_entries;
+        std::vector<B> m_upper_bounds; // See BuildContainmentIndex()
     };
 
     //----------------------------------------------------------------------
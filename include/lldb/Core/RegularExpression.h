@@ -231,13 +231,46 @@ public:
     bool
     operator < (const RegularExpression& rhs) const;
 
+    //------------------------------------------------------------------
+    /// Get the literal text every matching string starts with.
+    ///
+    /// For "^MyNamespace::Handler.*" this is "MyNamespace::Handler".
+    /// Execute() rejects the strings that don't start with it before
+    /// running the regular expression.
+    ///
+    /// @return
+    ///     The prefix, empty if the expression isn't anchored or
+    ///     doesn't start with a literal.
+    //------------------------------------------------------------------
+    const std::string &
+    GetLiteralPrefix () const
+    {
+        return m_literal_prefix;
+    }
+
+    //------------------------------------------------------------------
+    /// Get the longest literal text every matching string contains,
+    /// Execute() rejects the strings that don't contain it with a
+    /// substring search.
+    //------------------------------------------------------------------
+    const std::string &
+    GetRequiredLiteral () const
+    {
+        return m_required_literal;
+    }
+
 private:
+    void
+    ExtractLiterals ();
+
     //------------------------------------------------------------------
     // Member variables
     //------------------------------------------------------------------
     std::string m_re;   ///< A copy of the original regular expression text
     int m_comp_err;     ///< Error code for the regular expression compilation
     regex_t m_preg;     ///< The compiled regular expression
+    std::string m_literal_prefix;   ///< Text every match starts with
+    std::string m_required_literal; ///< Text every match contains
 };
 
 } // namespace lldb_private
@@ -61,6 +61,28 @@ public:
     virtual Depth
     GetDepth () = 0;
 
+    //------------------------------------------------------------------
+    /// Searchers at eDepthCompUnit that only match compile units with
+    /// line entries for one source file can return it here. The filter
+    /// then asks the module for the compile units that mention a file
+    /// with that name instead of visiting all of them.
+    ///
+    /// @param[out] file_spec
+    ///     The source file the searcher is looking for.
+    ///
+    /// @param[out] check_inlines
+    ///     True if the file can also be found in the support files of a
+    ///     compile unit, false if it has to be the compile unit's own file.
+    ///
+    /// @return
+    ///     True if the searcher filled in \a file_spec.
+    //------------------------------------------------------------------
+    virtual bool
+    GetSourceFileFilter (FileSpec &file_spec, bool &check_inlines)
+    {
+        return false;
+    }
+
     //------------------------------------------------------------------
     /// Prints a canonical description for the searcher to the stream \a s.
     ///
@@ -12,8 +12,10 @@
 
 // C Includes
 // C++ Includes
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
@@ -81,11 +83,20 @@ public:
 
         uint32_t
         GetNumLines ();
+
+        // The bytes held for the file contents and the line table.
+        size_t
+        GetMemoryUsage () const;
         
     protected:
+        // Index the line offsets up to and including "line", or the whole
+        // file for UINT32_MAX.
         bool
         CalculateLineOffsets (uint32_t line = UINT32_MAX);
 
+        void
+        ReadFileData ();
+
         FileSpec m_file_spec_orig;  // The original file spec that was used (can be different from m_file_spec)
         FileSpec m_file_spec;       // The actually file spec being used (if the target has source mappings, this might be different from m_file_spec_orig)
         TimeValue m_mod_time;       // Keep the modification time that this file data is valid for
@@ -93,6 +104,8 @@ public:
         lldb::DataBufferSP m_data_sp;
         typedef std::vector<uint32_t> LineOffsets;
         LineOffsets m_offsets;
+        bool m_offsets_complete;    // m_offsets covers the whole file
+        uint32_t m_offsets_scanned; // how far into m_data_sp m_offsets has been computed
     };
 #endif // SWIG
 
@@ -101,18 +114,47 @@ public:
 #ifndef SWIG
    // The SourceFileCache class separates the source manager from the cache of source files, so the 
    // cache can be stored in the Debugger, but the source managers can be per target.     
+   // The least recently used files are dropped once the files use more than GetMaxByteSize() bytes.
     class SourceFileCache
     {
     public:
-        SourceFileCache() = default;
+        SourceFileCache();
         ~SourceFileCache() = default;
         
         void AddSourceFile (const FileSP &file_sp);
-        FileSP FindSourceFile (const FileSpec &file_spec) const;
+        FileSP FindSourceFile (const FileSpec &file_spec);
+
+        size_t
+        GetMaxByteSize () const
+        {
+            return m_max_byte_size;
+        }
+
+        void
+        SetMaxByteSize (size_t max_byte_size);
+
+        size_t
+        GetByteSize ();
         
     protected:
-        typedef std::map <FileSpec, FileSP> FileCache;
+        typedef std::list<FileSpec> LRUList;  // most recently used first
+
+        struct CacheEntry
+        {
+            FileSP file_sp;
+            size_t byte_size;
+            LRUList::iterator lru_pos;
+        };
+
+        void
+        RemoveLeastRecentlyUsed ();
+
+        typedef std::map <FileSpec, CacheEntry> FileCache;
+        std::mutex m_mutex;  // the cache is filled from prefetch tasks too
         FileCache m_file_cache;
+        LRUList m_lru;
+        size_t m_byte_size;
+        size_t m_max_byte_size;
     };
 #endif // SWIG
 
@@ -175,9 +217,32 @@ public:
                             uint32_t end_line, 
                             std::vector<uint32_t> &match_lines);
     
+    //------------------------------------------------------------------
+    /// Find the lines of a file that match a regular expression without
+    /// going through the source cache. The file is memory mapped and no
+    /// line table is built, so this can run on many files in parallel.
+    ///
+    /// The file is used as is, the target's source path mappings are not
+    /// applied.
+    ///
+    /// @return
+    ///     False if the file couldn't be mapped.
+    //------------------------------------------------------------------
+    static bool
+    FindLinesMatchingRegexInFile (const FileSpec &file_spec,
+                                  const RegularExpression &regex,
+                                  std::vector<uint32_t> &match_lines);
+
     FileSP
     GetFile (const FileSpec &file_spec);
 
+    //------------------------------------------------------------------
+    /// Read a source file into the debugger's source cache on the
+    /// TaskPool, so that showing it later doesn't have to wait for it.
+    //------------------------------------------------------------------
+    void
+    PrefetchFile (const FileSpec &file_spec);
+
 protected:
     FileSP m_last_file_sp;
     uint32_t m_last_line;
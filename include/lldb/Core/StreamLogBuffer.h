@@ -0,0 +1,140 @@
+//===-- StreamLogBuffer.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_StreamLogBuffer_h_
+#define liblldb_StreamLogBuffer_h_
+
+// C Includes
+// C++ Includes
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Stream.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class StreamLogBuffer StreamLogBuffer.h "lldb/Core/StreamLogBuffer.h"
+/// @brief A log stream that keeps messages in a ring buffer.
+///
+/// Every Write() is one log message. It is copied into the next record
+/// of a fixed size ring buffer without taking a lock, so logging threads
+/// never wait for the log file.
+///
+/// In async mode, a background thread writes the records out to the
+/// wrapped stream. In flight recorder mode, the records are only
+/// written out when Drain() is called ("log dump") or when lldb
+/// crashes. Until then, newer messages overwrite the oldest ones.
+///
+/// Messages longer than a record are truncated.
+//----------------------------------------------------------------------
+class StreamLogBuffer : public Stream
+{
+public:
+    enum Mode
+    {
+        eModeAsync,
+        eModeFlightRecorder
+    };
+
+    static const size_t kRecordSize = 1024;
+    static const uint32_t kDefaultNumRecords = 4096;
+
+    StreamLogBuffer (const lldb::StreamSP &stream_sp, Mode mode, uint32_t num_records = kDefaultNumRecords);
+
+    ~StreamLogBuffer () override;
+
+    // Does nothing, the records are written out by Drain().
+    void
+    Flush () override;
+
+    size_t
+    Write (const void *src, size_t src_len) override;
+
+    //------------------------------------------------------------------
+    /// Write all the records that weren't written yet to the wrapped
+    /// stream.
+    ///
+    /// If messages were overwritten before they could be written, a line
+    /// saying how many is written in their place.
+    //------------------------------------------------------------------
+    void
+    Drain ();
+
+    Mode
+    GetMode () const
+    {
+        return m_mode;
+    }
+
+    // The number of messages that were overwritten before being written.
+    uint64_t
+    GetNumDroppedMessages () const
+    {
+        return m_num_dropped;
+    }
+
+    //------------------------------------------------------------------
+    /// Drain every flight recorder.
+    ///
+    /// @return
+    ///     The number of flight recorders that were drained.
+    //------------------------------------------------------------------
+    static size_t
+    DrainFlightRecorders ();
+
+private:
+    struct Record
+    {
+        // 2 * sequence + 1 while the message with that sequence number is
+        // being written, 2 * sequence + 2 once it is complete.
+        std::atomic<uint64_t> state;
+        uint32_t length;
+        char text[kRecordSize];
+    };
+
+    static uint64_t
+    WritingState (uint64_t seq)
+    {
+        return 2 * seq + 1;
+    }
+
+    static uint64_t
+    CompleteState (uint64_t seq)
+    {
+        return 2 * seq + 2;
+    }
+
+    void
+    DrainThread ();
+
+    lldb::StreamSP m_stream_sp;
+    const Mode m_mode;
+    const uint32_t m_num_records;
+    std::unique_ptr<Record[]> m_records;
+    std::atomic<uint64_t> m_next_seq;
+    std::mutex m_drain_mutex;           // held by whoever is reading the records
+    uint64_t m_drained_seq;             // protected by m_drain_mutex
+    uint64_t m_num_dropped;             // protected by m_drain_mutex
+    std::mutex m_thread_mutex;
+    std::condition_variable m_thread_cond;
+    bool m_stop_thread;
+    std::thread m_thread;
+
+    DISALLOW_COPY_AND_ASSIGN (StreamLogBuffer);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_StreamLogBuffer_h_
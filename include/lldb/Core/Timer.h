@@ -27,23 +27,58 @@ namespace lldb_private {
 
 //----------------------------------------------------------------------
 /// @class Timer Timer.h "lldb/Core/Timer.h"
-/// @brief A timer class that simplifies common timing metrics.
+/// @brief A scoped timer that adds up the time spent in a category.
 ///
-/// A scoped timer class that allows a variety of pthread mutex
-/// objects to have a mutex locked when a Timer::Locker
-/// object is created, and unlocked when it goes out of scope or
-/// when the Timer::Locker::Reset(pthread_mutex_t *)
-/// is called. This provides an exception safe way to lock a mutex
-/// in a scope.
+/// Timers are created at the start of a scope with a function local
+/// static Category:
+///
+///     static Timer::Category func_cat(__PRETTY_FUNCTION__);
+///     Timer scoped_timer(func_cat, "%s", __PRETTY_FUNCTION__);
+///
+/// While timers are disabled ("log timers disable", the default) this
+/// does nothing but check the display depth. The format is only used
+/// when timers are enabled and not quiet.
+///
+/// Enabled timers add their time, excluding the time of nested timers,
+/// to their category and record a trace event for their thread that
+/// DumpChromeTrace() can write out.
 //----------------------------------------------------------------------
 
 class Timer
 {
 public:
+    //--------------------------------------------------------------
+    /// A named group of timers whose times are added up.
+    ///
+    /// Categories are meant to be statics. They are put on a lock
+    /// free list when they are constructed and never removed from it.
+    //--------------------------------------------------------------
+    class Category
+    {
+    public:
+        explicit Category (const char *category_name);
+
+        const char *
+        GetName () const
+        {
+            return m_name;
+        }
+
+    private:
+        friend class Timer;
+
+        const char *m_name;
+        std::atomic<uint64_t> m_nanos;
+        std::atomic<uint64_t> m_count;
+        Category *m_next;
+
+        DISALLOW_COPY_AND_ASSIGN (Category);
+    };
+
     //--------------------------------------------------------------
     /// Default constructor.
     //--------------------------------------------------------------
-    Timer(const char *category, const char *format, ...)  __attribute__ ((format (printf, 3, 4)));
+    Timer(Category &category, const char *format, ...)  __attribute__ ((format (printf, 3, 4)));
 
     //--------------------------------------------------------------
     /// Destructor
@@ -62,6 +97,13 @@ public:
     static void
     DumpCategoryTimes (Stream *s);
 
+    //--------------------------------------------------------------
+    /// Write the trace events of all threads in the Chrome trace event
+    /// format, which chrome://tracing and other trace viewers can load.
+    //--------------------------------------------------------------
+    static void
+    DumpChromeTrace (Stream *s);
+
     static void
     ResetCategoryTimes ();
 
@@ -78,11 +120,12 @@ protected:
     uint64_t
     GetTimerElapsedNanoSeconds();
 
-    const char *m_category;
+    Category &m_category;
     TimeValue m_total_start;
     TimeValue m_timer_start;
     uint64_t m_total_ticks; // Total running time for this timer including when other timers below this are running
     uint64_t m_timer_ticks; // Ticks for this timer that do not include when other timers below this one are running
+    bool m_counted;         // True if this timer was counted in its thread's timer depth
 
     static std::atomic<bool> g_quiet;
     static std::atomic<unsigned> g_display_depth;
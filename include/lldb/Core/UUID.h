@@ -48,7 +48,7 @@ public:
     GetBytes() const;
 
     size_t
-    GetByteSize();
+    GetByteSize() const;
 
     bool
     IsValid () const;
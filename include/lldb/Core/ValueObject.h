@@ -556,6 +556,21 @@ public:
     virtual lldb::ValueObjectSP
     GetChildAtIndex (size_t idx, bool can_create);
 
+    //------------------------------------------------------------------
+    /// Get the children in [start_idx, start_idx + count), creating them
+    /// if necessary.
+    ///
+    /// Synthetic children providers can create a whole window of children
+    /// from a single memory read, so this is much faster than asking for
+    /// the children of a huge container one at a time.
+    ///
+    /// @return
+    ///     The number of children appended to \a children, less than
+    ///     \a count if the range goes past the last child.
+    //------------------------------------------------------------------
+    virtual size_t
+    GetChildrenInRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children);
+
     // this will always create the children if necessary
     lldb::ValueObjectSP
     GetChildAtIndexPath(const std::initializer_list<size_t> &idxs,
@@ -1080,6 +1095,14 @@ protected:
             m_children.clear();
         }
 
+        void
+        GetChildren (std::vector<ValueObject*> &children)
+        {
+            std::lock_guard<std::recursive_mutex> guard(m_mutex);
+            for (const ChildrenPair &pair : m_children)
+                children.push_back(pair.second);
+        }
+
     private:
         typedef std::map<size_t, ValueObject*> ChildrenMap;
         typedef ChildrenMap::iterator ChildrenIterator;
@@ -1220,6 +1243,19 @@ protected:
     virtual ValueObject *
     CreateChildAtIndex (size_t idx, bool synthetic_array_member, int32_t synthetic_index);
 
+    // Tell the memory cache what the child at idx and the ones after it
+    // are going to read: the rest of an array, or what a pointer points to.
+    void
+    PrefetchChildMemory (size_t idx);
+
+    // Tell the memory cache that the values in this hierarchy that have
+    // been read before, this one and the children created so far, are
+    // about to be read again. Nearby values are read together, so a tree
+    // of values refreshes with a few reads after a stop instead of one
+    // read per value.
+    void
+    PrefetchCachedValueMemory ();
+
     // Should only be called by ValueObject::GetNumChildren()
     virtual size_t
     CalculateNumChildren(uint32_t max=UINT32_MAX) = 0;
@@ -56,6 +56,9 @@ public:
     
     lldb::ValueObjectSP
     GetChildAtIndex(size_t idx, bool can_create) override;
+
+    size_t
+    GetChildrenInRange(size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children) override;
     
     lldb::ValueObjectSP
     GetChildMemberWithName(const ConstString &name, bool can_create) override;
@@ -35,6 +35,9 @@ public:
     static uint32_t
     GetCurrentRevision ();
     
+    static FormatCache::Statistics
+    GetCacheStatistics ();
+    
     static bool
     ShouldPrintAsOneLiner (ValueObject& valobj);
     
@@ -12,10 +12,12 @@
 
 // C Includes
 // C++ Includes
-#include <map>
-#include <mutex>
+#include <atomic>
+#include <unordered_map>
 
 // Other libraries and framework includes
+#include "llvm/Support/RWMutex.h"
+
 // Project includes
 #include "lldb/lldb-public.h"
 #include "lldb/Core/ConstString.h"
@@ -45,28 +47,28 @@ private:
         Entry (lldb::TypeFormatImplSP,lldb::TypeSummaryImplSP,lldb::SyntheticChildrenSP,lldb::TypeValidatorImplSP);
 
         bool
-        IsFormatCached ();
+        IsFormatCached () const;
         
         bool
-        IsSummaryCached ();
+        IsSummaryCached () const;
         
         bool
-        IsSyntheticCached ();
+        IsSyntheticCached () const;
         
         bool
-        IsValidatorCached ();
+        IsValidatorCached () const;
         
         lldb::TypeFormatImplSP
-        GetFormat ();
+        GetFormat () const;
         
         lldb::TypeSummaryImplSP
-        GetSummary ();
+        GetSummary () const;
         
         lldb::SyntheticChildrenSP
-        GetSynthetic ();
+        GetSynthetic () const;
         
         lldb::TypeValidatorImplSP
-        GetValidator ();
+        GetValidator () const;
         
         void
         SetFormat (lldb::TypeFormatImplSP);
@@ -80,17 +82,49 @@ private:
         void
         SetValidator (lldb::TypeValidatorImplSP);
     };
-    typedef std::map<ConstString,Entry> CacheMap;
-    CacheMap m_map;
-    std::recursive_mutex m_mutex;
+    // The entries are split into shards by type name, so lookups only take
+    // the reader lock of one shard and never wait for each other. A shard's
+    // entries are only valid for the generation they were added in; Clear()
+    // just bumps the generation and stale shards are emptied when they are
+    // next written to.
+    struct Shard
+    {
+        typedef std::unordered_map<const char *, Entry> CacheMap;   // keyed by the ConstString's pointer
+        llvm::sys::SmartRWMutex<false> m_mutex;
+        CacheMap m_map;
+        uint32_t m_generation;
+        std::atomic<uint64_t> m_cache_hits;
+        std::atomic<uint64_t> m_cache_misses;
 
-    uint64_t m_cache_hits;
-    uint64_t m_cache_misses;
-    
+        Shard ();
+    };
+
+    enum
+    {
+        kNumShards = 16
+    };
+
+    Shard m_shards[kNumShards];
+    std::atomic<uint32_t> m_generation;
+
+    Shard &
+    GetShard (const ConstString& type);
+
+    // Returns the current entry for type, adding it if needed. The caller
+    // must hold the writer lock of the shard.
     Entry&
-    GetEntry (const ConstString& type);
+    GetEntry (Shard &shard, const ConstString& type);
     
 public:
+    struct Statistics
+    {
+        uint64_t cache_hits;
+        uint64_t cache_misses;
+        size_t num_types;
+        size_t num_negative_entries;    // formatters cached as "none"
+        uint32_t generation;
+    };
+
     FormatCache ();
     
     bool
@@ -117,20 +151,18 @@ public:
     void
     SetValidator (const ConstString& type,lldb::TypeValidatorImplSP& synthetic_sp);
     
+    // Drop all entries, e.g. because a category was changed.
     void
     Clear ();
     
     uint64_t
-    GetCacheHits ()
-    {
-        return m_cache_hits;
-    }
+    GetCacheHits ();
     
     uint64_t
-    GetCacheMisses ()
-    {
-        return m_cache_misses;
-    }
+    GetCacheMisses ();
+
+    Statistics
+    GetStatistics ();
 };
 } // namespace lldb_private
 
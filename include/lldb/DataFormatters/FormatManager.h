@@ -247,6 +247,13 @@ public:
         return m_last_revision;
     }
 
+    // Statistics of the cache of formatters found for types, "type cache stats"
+    FormatCache::Statistics
+    GetCacheStatistics ()
+    {
+        return m_format_cache.GetStatistics();
+    }
+
     static FormattersMatchVector
     GetPossibleMatches (ValueObject& valobj,
                         lldb::DynamicValueType use_dynamic)
@@ -83,7 +83,7 @@ public:
     typedef typename MapType::iterator MapIterator;
     typedef std::function<bool(KeyType, const ValueSP&)> ForEachCallback;
 
-    FormatMap(IFormatChangeListener *lst) : m_map(), m_map_mutex(), listener(lst) {}
+    FormatMap(IFormatChangeListener *lst) : m_map(), m_map_mutex(), listener(lst), m_generation(0) {}
 
     void
     Add(KeyType name, const ValueSP &entry)
@@ -95,6 +95,7 @@ public:
 
         std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
         m_map[name] = entry;
+        ++m_generation;
         if (listener)
             listener->Changed();
     }
@@ -107,6 +108,7 @@ public:
         if (iter == m_map.end())
             return false;
         m_map.erase(name);
+        ++m_generation;
         if (listener)
             listener->Changed();
         return true;
@@ -117,6 +119,7 @@ public:
     {
         std::lock_guard<std::recursive_mutex> guard(m_map_mutex);
         m_map.clear();
+        ++m_generation;
         if (listener)
             listener->Changed();
     }
@@ -190,6 +193,7 @@ protected:
     MapType m_map;
     std::recursive_mutex m_map_mutex;
     IFormatChangeListener* listener;
+    uint32_t m_generation;  // bumped whenever the keys change, guarded by m_map_mutex
 
     MapType&
     map ()
@@ -226,7 +230,9 @@ public:
     FormattersContainer(std::string name,
                     IFormatChangeListener* lst) :
     m_format_map(lst),
-    m_name(name)
+    m_name(name),
+    m_combined_regex(),
+    m_combined_generation(UINT32_MAX)
     {
     }
     
@@ -305,6 +311,11 @@ public:
 protected:
     BackEndType m_format_map;
     std::string m_name;
+    // For regular expression keys: all of them as a single alternation, so
+    // a type name that none of them match, which is what most lookups are,
+    // is rejected by one regexec instead of one per key.
+    RegularExpression m_combined_regex;
+    uint32_t m_combined_generation;
     
     DISALLOW_COPY_AND_ASSIGN(FormattersContainer);
     
@@ -336,6 +347,7 @@ protected:
             if (::strcmp(type.AsCString(), regex->GetText()) == 0)
             {
                 m_format_map.map().erase(pos);
+                ++m_format_map.m_generation;
                 if (m_format_map.listener)
                     m_format_map.listener->Changed();
                 return true;
@@ -377,6 +389,54 @@ protected:
                                                                        true));
     }
 
+    // Rebuild m_combined_regex if the keys changed since it was built. The
+    // map's mutex must be held.
+    void
+    UpdateCombinedRegex ()
+    {
+        if (m_combined_generation == m_format_map.m_generation)
+            return;
+        m_combined_generation = m_format_map.m_generation;
+
+        std::string combined;
+        for (const auto &pos : m_format_map.map())
+        {
+            const char *text = pos.first ? pos.first->GetText() : nullptr;
+            // Back references would refer to the wrong groups once the
+            // expressions are wrapped in groups of their own, and an empty
+            // expression matches anything anyway.
+            if (text == nullptr || text[0] == '\0' || HasBackReference(text))
+            {
+                m_combined_regex.Clear();
+                return;
+            }
+            if (!combined.empty())
+                combined.push_back('|');
+            combined.push_back('(');
+            combined.append(text);
+            combined.push_back(')');
+        }
+        if (combined.empty() || !m_combined_regex.Compile(combined.c_str()))
+            m_combined_regex.Clear();
+    }
+
+    static bool
+    HasBackReference (const char *text)
+    {
+        for (const char *p = text; *p; ++p)
+        {
+            if (*p == '\\')
+            {
+                if (p[1] >= '1' && p[1] <= '9')
+                    return true;
+                if (p[1] == '\0')
+                    break;
+                ++p;
+            }
+        }
+        return false;
+    }
+
     bool
     Get_Impl(ConstString key, MapValueType &value, lldb::RegularExpressionSP *dummy)
     {
@@ -384,6 +444,10 @@ protected:
         if (!key_cstr)
             return false;
         std::lock_guard<std::recursive_mutex> guard(m_format_map.mutex());
+        UpdateCombinedRegex();
+        // If the combined expression couldn't be built every key is tried.
+        if (m_combined_regex.IsValid() && !m_combined_regex.Execute(key_cstr))
+            return false;
         MapIterator pos, end = m_format_map.map().end();
         for (pos = m_format_map.map().begin(); pos != end; pos++)
         {
@@ -68,6 +68,13 @@ namespace lldb_private {
         virtual lldb::ValueObjectSP
         GetChildAtIndex (size_t idx) = 0;
 
+        // Appends the children in [start_idx, start_idx + count) to children
+        // and returns how many were appended. Providers for containers that
+        // can fetch a window of children with one memory read should
+        // override this, the default asks for one child at a time.
+        virtual size_t
+        GetChildrenInRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children);
+
         virtual size_t
         GetIndexOfChildWithName (const ConstString &name) = 0;
         
@@ -621,6 +628,12 @@ namespace lldb_private {
             std::string m_python_class;
             StructuredData::ObjectSP m_wrapper_sp;
             ScriptInterpreter *m_interpreter;
+            // Children fetched ahead from providers that implement
+            // get_children_batch, starting at index m_batch_start. Dropped
+            // on Update().
+            std::vector<lldb::ValueObjectSP> m_batch_children;
+            size_t m_batch_start;
+            LazyBool m_supports_batch;
 
             DISALLOW_COPY_AND_ASSIGN(FrontEnd);
         };
@@ -10,6 +10,10 @@
 #ifndef liblldb_DWARFExpression_h_
 #define liblldb_DWARFExpression_h_
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include "lldb/lldb-private.h"
 #include "lldb/Core/Address.h"
 #include "lldb/Core/DataExtractor.h"
@@ -468,6 +472,53 @@ protected:
                                      lldb::addr_t& low_pc,
                                      lldb::addr_t& high_pc);
 
+    //------------------------------------------------------------------
+    /// A location list entry whose addresses are relative to the
+    /// location list base, with the offset and length of its location
+    /// expression in m_data.
+    //------------------------------------------------------------------
+    struct LocationListEntry
+    {
+        lldb::addr_t lo_pc;
+        lldb::addr_t hi_pc;
+        lldb::offset_t offset;
+        lldb::offset_t length;
+    };
+
+    //------------------------------------------------------------------
+    /// The entries of a location list, decoded the first time the list
+    /// is looked up so that every variable read doesn't walk the list
+    /// again.
+    //------------------------------------------------------------------
+    struct LocationListIndex
+    {
+        LocationListIndex () :
+            entries(),
+            sorted(false),
+            last_match(0)
+        {
+        }
+
+        std::vector<LocationListEntry> entries; ///< The entries with a location, in list order unless \a sorted
+        bool sorted;                            ///< The entries are sorted by lo_pc and don't overlap
+        mutable std::atomic<size_t> last_match; ///< The entry the previous lookup found, frames usually stay at the same PC
+    };
+
+    std::shared_ptr<const LocationListIndex>
+    GetLocationListIndex () const;
+
+    //------------------------------------------------------------------
+    /// Find the entry of the location list that covers \a pc, the same
+    /// entry the first match in list order would find.
+    ///
+    /// @return
+    ///     False if no entry with a location covers \a pc.
+    //------------------------------------------------------------------
+    bool
+    FindLocationListEntry (lldb::addr_t loclist_base_addr,
+                           lldb::addr_t pc,
+                           LocationListEntry &entry) const;
+
     //------------------------------------------------------------------
     /// Classes that inherit from DWARFExpression can see and modify these
     //------------------------------------------------------------------
@@ -481,6 +532,7 @@ protected:
     lldb::addr_t m_loclist_slide;               ///< A value used to slide the location list offsets so that 
                                                 ///< they are relative to the object that owns the location list
                                                 ///< (the function for frame base and variable location lists)
+    mutable std::shared_ptr<const LocationListIndex> m_loclist_index_sp; ///< Built by GetLocationListIndex(), reset when the data changes
 };
 
 } // namespace lldb_private
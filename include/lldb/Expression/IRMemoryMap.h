@@ -67,6 +67,23 @@ public:
     void ReadPointerFromMemory (lldb::addr_t *address, lldb::addr_t process_address, Error &error);
     bool GetAllocSize(lldb::addr_t address, size_t &size);
     void GetMemoryData (DataExtractor &extractor, lldb::addr_t process_address, size_t size, Error &error);
+
+    //------------------------------------------------------------------
+    /// Access a mirrored allocation through its host copy only.
+    ///
+    /// The allocation is read from the process once. Until
+    /// EndBatchedAccess() the reads are served from the host copy and the
+    /// writes only change the host copy, then the bytes that were written
+    /// go to the process with a single memory write. This turns the many
+    /// small accesses of (de)materializing an argument struct into a
+    /// couple of process memory operations.
+    ///
+    /// @return
+    ///     False if the allocation isn't mirrored or couldn't be read, its
+    ///     accesses then keep going to the process.
+    //------------------------------------------------------------------
+    bool BeginBatchedAccess (lldb::addr_t process_address);
+    void EndBatchedAccess (lldb::addr_t process_address, Error &error);
     
     lldb::ByteOrder GetByteOrder();
     uint32_t GetAddressByteSize();
@@ -103,6 +120,9 @@ private:
         ///< Flags
         AllocationPolicy    m_policy;
         bool                m_leak;
+        bool                m_batched;      ///< Accesses go to m_data only, see BeginBatchedAccess()
+        size_t              m_dirty_start;  ///< The range of m_data written while batched
+        size_t              m_dirty_end;
     public:
         Allocation (lldb::addr_t process_alloc,
                     lldb::addr_t process_start,
@@ -119,7 +139,10 @@ private:
             m_alignment (0),
             m_data (),
             m_policy (eAllocationPolicyInvalid),
-            m_leak (false)
+            m_leak (false),
+            m_batched (false),
+            m_dirty_start (0),
+            m_dirty_end (0)
         {
         }
     };
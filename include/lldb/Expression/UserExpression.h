@@ -317,6 +317,21 @@ protected:
     DoExecute(DiagnosticManager &diagnostic_manager, ExecutionContext &exe_ctx, const EvaluateExpressionOptions &options,
             lldb::UserExpressionSP &shared_ptr_to_me, lldb::ExpressionVariableSP &result) = 0;
 
+    //------------------------------------------------------------------
+    /// Does the work of Evaluate(), which times it for the target's
+    /// expression statistics.
+    //------------------------------------------------------------------
+    static lldb::ExpressionResults
+    DoEvaluate(ExecutionContext &exe_ctx,
+               const EvaluateExpressionOptions& options,
+               const char *expr_cstr,
+               const char *expr_prefix,
+               lldb::ValueObjectSP &result_valobj_sp,
+               Error &error,
+               uint32_t line_offset,
+               std::string *fixed_expression,
+               lldb::ModuleSP *jit_module_sp_ptr);
+
     static lldb::addr_t
     GetObjectPointer (lldb::StackFrameSP frame_sp,
                       ConstString &object_name,
@@ -336,6 +351,7 @@ protected:
                          lldb::StackFrameSP &frame_sp);
 
     Address                                     m_address;              ///< The address the process is stopped in.
+    Block                                      *m_block;                ///< The block m_address is in, which is valid as long as m_address's module is.
     std::string                                 m_expr_text;            ///< The text of the expression, as typed by the user
     std::string                                 m_expr_prefix;          ///< The text of the translation-level definitions, as provided by the user
     std::string                                 m_fixed_text;           ///< The text of the expression with fixits applied - this won't be set if the fixed text doesn't parse.
@@ -152,6 +152,21 @@ public:
     }
     
 protected:
+    //------------------------------------------------------------------
+    /// Look for a precompiled copy of the function in the process.
+    ///
+    /// Utility functions can be shipped prebuilt in a helper library
+    /// (see target.expr-helper-library) or linked into the program.  If a
+    /// function with this function's name is loaded, it is used instead
+    /// of compiling the text, which saves a parse and a JIT per session.
+    ///
+    /// @return
+    ///     True if a function was found; the start and end addresses are
+    ///     set to it.
+    //------------------------------------------------------------------
+    bool
+    FindPrecompiledFunction (ExecutionContext &exe_ctx);
+
     std::shared_ptr<IRExecutionUnit>         m_execution_unit_sp;
     lldb::ModuleWP                           m_jit_module_wp;
     std::string                              m_function_text;    ///< The text of the function.  Must be a well-formed translation unit.
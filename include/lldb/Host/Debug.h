@@ -28,6 +28,8 @@ namespace lldb_private {
         lldb::tid_t tid;        // The thread ID that this action applies to, LLDB_INVALID_THREAD_ID for the default thread action
         lldb::StateType state;  // Valid values are eStateStopped/eStateSuspended, eStateRunning, and eStateStepping.
         int signal;             // When resuming this thread, resume it with this signal if this value is > 0
+        lldb::addr_t step_range_start; // When stepping, keep stepping while the pc is in [step_range_start, step_range_end)
+        lldb::addr_t step_range_end;   // and only then report the stop. An empty range is a plain single step.
     };
 
     //------------------------------------------------------------------
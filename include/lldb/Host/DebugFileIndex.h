@@ -0,0 +1,133 @@
+//===-- DebugFileIndex.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_Host_DebugFileIndex_h_
+#define liblldb_Host_DebugFileIndex_h_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Error.h"
+#include "lldb/Host/FileSpec.h"
+
+namespace lldb_private {
+
+class FileSpecList;
+class UUID;
+
+//----------------------------------------------------------------------
+/// @class DebugFileIndex DebugFileIndex.h "lldb/Host/DebugFileIndex.h"
+/// @brief Finds separate debug files by build ID.
+///
+/// Debug roots like /usr/lib/debug keep debug files by build ID in
+/// .build-id/xx/yyyy.debug. Instead of probing those paths for every
+/// module, the .build-id directory of each root is read once into a
+/// build ID to path map. The map is saved in a cache directory together
+/// with the modification times of the directories it was read from, so
+/// later sessions only have to read the directories that changed.
+///
+/// Debug files that can't be found locally can be downloaded from
+/// debuginfod style symbol servers into a cache directory.
+//----------------------------------------------------------------------
+class DebugFileIndex
+{
+public:
+    static DebugFileIndex &
+    GetInstance ();
+
+    //------------------------------------------------------------------
+    /// Find the debug file for a build ID in the .build-id directories
+    /// of the given debug roots.
+    ///
+    /// Each root is indexed when it is first used in a session, debug
+    /// files that are added to a root later on aren't found until the
+    /// next session.
+    ///
+    /// @param[in] build_id
+    ///     The build ID of the module.
+    ///
+    /// @param[in] debug_roots
+    ///     The directories to look in, e.g. /usr/lib/debug.
+    ///
+    /// @param[in] cache_dir
+    ///     Where to save the index, or an invalid FileSpec to not save it.
+    ///
+    /// @return
+    ///     The path of the debug file, or an invalid FileSpec.
+    //------------------------------------------------------------------
+    FileSpec
+    FindDebugFile (const UUID &build_id, const FileSpecList &debug_roots, const FileSpec &cache_dir);
+
+    //------------------------------------------------------------------
+    /// Download the debug file for a build ID from symbol servers.
+    ///
+    /// The file is fetched from <url>/buildid/<build id>/debuginfo of the
+    /// first server that has it and stored in
+    /// <cache_dir>/<build id>/debuginfo, where later calls find it without
+    /// going to the network. Build IDs no server has are only asked for
+    /// once per session.
+    ///
+    /// @return
+    ///     The path of the downloaded file, or an invalid FileSpec.
+    //------------------------------------------------------------------
+    FileSpec
+    DownloadDebugFile (const UUID &build_id,
+                       const std::vector<std::string> &server_urls,
+                       const FileSpec &cache_dir,
+                       Error &error);
+
+    // Lower case hex without separators, the way build IDs are spelled in
+    // .build-id paths and symbol server URLs.
+    static std::string
+    GetBuildIDString (const UUID &build_id);
+
+private:
+    // The index of the .build-id directory of a debug root.
+    struct RootIndex
+    {
+        uint64_t mod_time = 0;
+        std::map<std::string, uint64_t> dir_mod_times; // "xx" -> mod time
+        std::set<std::string> build_ids;
+    };
+
+    DebugFileIndex ();
+
+    // Updates the index of a .build-id directory, and saves it if it
+    // changed. Returns false if the directory doesn't exist.
+    bool
+    UpdateRootIndex (const std::string &build_id_dir, const FileSpec &cache_dir, RootIndex &index);
+
+    static FileSpec
+    GetIndexFileSpec (const std::string &build_id_dir, const FileSpec &cache_dir);
+
+    static bool
+    LoadRootIndex (const FileSpec &index_file_spec, RootIndex &index);
+
+    static Error
+    SaveRootIndex (const FileSpec &index_file_spec, const RootIndex &index);
+
+    std::mutex m_mutex;
+    std::map<std::string, RootIndex> m_roots;    // keyed by .build-id directory
+    std::set<std::string> m_missing_build_ids;   // not on any symbol server
+
+    DISALLOW_COPY_AND_ASSIGN (DebugFileIndex);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_Host_DebugFileIndex_h_
@@ -573,13 +573,18 @@ public:
     ///     bytes into the file. If \a length is \c SIZE_MAX, map
     ///     as many bytes as possible.
     ///
+    /// @param[in] writeable
+    ///     If \b true, the data can be written to. Writes are private
+    ///     to this process and never reach the file, the pages that are
+    ///     written get copied.
+    ///
     /// @return
     ///     A shared pointer to the memory mapped data. This shared
     ///     pointer can contain a nullptr DataBuffer pointer, so the contained
     ///     pointer must be checked prior to using it.
     //------------------------------------------------------------------
     lldb::DataBufferSP
-    MemoryMapFileContents (off_t offset = 0, size_t length = SIZE_MAX) const;
+    MemoryMapFileContents (off_t offset = 0, size_t length = SIZE_MAX, bool writeable = false) const;
 
     //------------------------------------------------------------------
     /// Memory map part of, or the entire contents of, a file only if
@@ -611,13 +616,17 @@ public:
     ///     bytes into the file. If \a length is \c SIZE_MAX, map
     ///     as many bytes as possible.
     ///
+    /// @param[in] writeable
+    ///     If \b true, the data can be written to without the writes
+    ///     reaching the file. Heap buffers always can.
+    ///
     /// @return
     ///     A shared pointer to the memory mapped data. This shared
     ///     pointer can contain a nullptr DataBuffer pointer, so the contained
     ///     pointer must be checked prior to using it.
     //------------------------------------------------------------------
     lldb::DataBufferSP
-    MemoryMapFileContentsIfLocal(off_t file_offset, size_t file_size) const;
+    MemoryMapFileContentsIfLocal(off_t file_offset, size_t file_size, bool writeable = false) const;
 
     //------------------------------------------------------------------
     /// Read part of, or the entire contents of, a file into a heap based data buffer.
@@ -684,6 +693,9 @@ public:
     ///
     /// @param[out] result
     ///     The backup-resolved path will be written here.
+    ///
+    /// The result is remembered for each uniqued input, so comparing the
+    /// same directories again doesn't rebuild the path.
     //------------------------------------------------------------------
     static void RemoveBackupDots (const ConstString &input_const_str, ConstString &result_const_str);
 
@@ -838,6 +850,8 @@ public:
     ForEachItemInDirectory (const char *dir_path, DirectoryCallback const &callback);
 
 protected:
+    static void RemoveBackupDotsUncached (const ConstString &input_const_str, ConstString &result_const_str);
+
     //------------------------------------------------------------------
     // Member variables
     //------------------------------------------------------------------
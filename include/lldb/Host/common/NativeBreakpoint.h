@@ -10,7 +10,11 @@
 #ifndef liblldb_NativeBreakpoint_h_
 #define liblldb_NativeBreakpoint_h_
 
+#include <vector>
+
+#include "lldb/lldb-private-forward.h"
 #include "lldb/lldb-types.h"
+#include "lldb/Utility/AgentExpression.h"
 
 namespace lldb_private
 {
@@ -42,6 +46,58 @@ namespace lldb_private
         virtual bool
         IsSoftwareBreakpoint () const = 0;
 
+        //------------------------------------------------------------------
+        /// Replace the conditions of the breakpoint.
+        ///
+        /// A breakpoint with conditions only stops a thread when at least
+        /// one of them evaluates to a non-zero value. An empty list makes
+        /// the breakpoint unconditional again.
+        //------------------------------------------------------------------
+        void
+        SetConditions (const std::vector<AgentExpression> &conditions) { m_conditions = conditions; }
+
+        bool
+        HasConditions () const { return !m_conditions.empty(); }
+
+        //------------------------------------------------------------------
+        /// Evaluate the conditions in the context of a thread that hit the
+        /// breakpoint. A condition that fails to evaluate counts as true so
+        /// a broken condition never hides a stop.
+        //------------------------------------------------------------------
+        bool
+        ShouldStop (NativeThreadProtocol &thread);
+
+        //------------------------------------------------------------------
+        /// A counting breakpoint never stops a thread. The process counts
+        /// the hits and steps the thread over the breakpoint instead.
+        //------------------------------------------------------------------
+        void
+        SetCounting (bool counting) { m_counting = counting; }
+
+        //------------------------------------------------------------------
+        /// Limit the breakpoint to some threads. Hits of other threads are
+        /// neither reported nor counted, the process steps those threads
+        /// over the breakpoint. An empty list is for all threads.
+        //------------------------------------------------------------------
+        void
+        SetThreadIDs (const std::vector<lldb::tid_t> &thread_ids) { m_thread_ids = thread_ids; }
+
+        bool
+        HasThreadIDs () const { return !m_thread_ids.empty(); }
+
+        bool
+        IsForThread (lldb::tid_t tid) const;
+
+        bool
+        IsCounting () const { return m_counting; }
+
+        void
+        IncrementHitCount () { ++m_hit_count; }
+
+        // The number of hits that were counted and not reported.
+        uint64_t
+        GetHitCount () const { return m_hit_count; }
+
     protected:
         const lldb::addr_t m_addr;
         int32_t m_ref_count;
@@ -54,6 +110,10 @@ namespace lldb_private
 
     private:
         bool m_enabled;
+        std::vector<AgentExpression> m_conditions;
+        bool m_counting;
+        uint64_t m_hit_count;
+        std::vector<lldb::tid_t> m_thread_ids;
 
         // -----------------------------------------------------------
         // interface for NativeBreakpointList
@@ -45,6 +45,9 @@ namespace lldb_private
         Error
         RemoveTrapsFromBuffer(lldb::addr_t addr, void *buf, size_t size) const;
 
+        void
+        ForEach (std::function<void (const NativeBreakpointSP &breakpoint_sp)> const &callback);
+
     private:
         typedef std::map<lldb::addr_t, NativeBreakpointSP> BreakpointMap;
 
@@ -11,12 +11,16 @@
 #define liblldb_NativeProcessProtocol_h_
 
 #include <mutex>
+#include <string>
 #include <vector>
 
 #include "lldb/lldb-private-forward.h"
 #include "lldb/lldb-types.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Host/MainLoop.h"
+#include "lldb/Utility/AgentExpression.h"
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/StringRef.h"
 
 #include "NativeBreakpointList.h"
@@ -81,6 +85,37 @@ namespace lldb_private
         virtual Error
         Kill () = 0;
 
+        //------------------------------------------------------------------
+        /// Enable or disable non-stop mode.
+        ///
+        /// In non-stop mode a thread that stops because of a breakpoint,
+        /// signal, etc. is reported on its own through
+        /// NativeDelegate::ThreadStopped() while the remaining threads keep
+        /// running. The default implementation only supports all-stop mode.
+        ///
+        /// @return
+        ///     Returns an error object.
+        //------------------------------------------------------------------
+        virtual Error
+        SetNonStopMode (bool enable);
+
+        bool
+        GetNonStopMode () const
+        {
+            return m_non_stop_mode;
+        }
+
+        //------------------------------------------------------------------
+        /// Set the signals that are delivered to the process as soon as a
+        /// thread receives them, without stopping the process and telling
+        /// the delegates. This replaces the signals of an earlier call.
+        ///
+        /// @return
+        ///     Returns an error object.
+        //------------------------------------------------------------------
+        Error
+        IgnoreSignals (llvm::ArrayRef<int> signals);
+
         //----------------------------------------------------------------------
         // Memory and memory region functions
         //----------------------------------------------------------------------
@@ -94,6 +129,43 @@ namespace lldb_private
         virtual Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) = 0;
 
+        //------------------------------------------------------------------
+        /// One of the ranges read by ReadMemoryRanges().
+        //------------------------------------------------------------------
+        struct MemoryReadRange
+        {
+            lldb::addr_t addr;
+            void *buf;
+            size_t size;
+            size_t bytes_read;  // Set by ReadMemoryRanges()
+        };
+
+        //------------------------------------------------------------------
+        /// Read a batch of memory ranges.
+        ///
+        /// The default implementation calls ReadMemory() for every range,
+        /// processes that can read many ranges with a single system call
+        /// should override it. A range that can't be read doesn't stop the
+        /// other ranges from being read, the number of bytes that could be
+        /// read is stored in its \a bytes_read.
+        ///
+        /// @param[in,out] ranges
+        ///     The ranges to read.
+        ///
+        /// @return
+        ///     Returns an error object if the ranges couldn't be read at all.
+        //------------------------------------------------------------------
+        virtual Error
+        ReadMemoryRanges (std::vector<MemoryReadRange> &ranges);
+
+        //------------------------------------------------------------------
+        /// Same as ReadMemoryRanges() but with the software breakpoint
+        /// opcodes replaced by the original memory contents, like
+        /// ReadMemoryWithoutTrap().
+        //------------------------------------------------------------------
+        Error
+        ReadMemoryRangesWithoutTrap (std::vector<MemoryReadRange> &ranges);
+
         virtual Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) = 0;
 
@@ -106,6 +178,35 @@ namespace lldb_private
         virtual lldb::addr_t
         GetSharedLibraryInfoAddress () = 0;
 
+        //------------------------------------------------------------------
+        /// A shared library from the link_map list of an SVR4 dynamic
+        /// linker.
+        //------------------------------------------------------------------
+        struct SVR4LibraryInfo
+        {
+            std::string name;
+            lldb::addr_t link_map;  // Address of the link_map entry
+            lldb::addr_t base_addr; // l_addr, the load bias
+            lldb::addr_t ld_addr;   // l_ld, the address of the dynamic section
+        };
+
+        //------------------------------------------------------------------
+        /// Get the shared libraries the dynamic linker has loaded, as
+        /// reported by qXfer:libraries-svr4:read.
+        ///
+        /// @param[out] library_list
+        ///     The shared libraries, not including the main executable.
+        ///
+        /// @param[out] main_link_map
+        ///     The address of the link_map entry of the main executable.
+        ///
+        /// @return
+        ///     An error if the process doesn't have an SVR4 dynamic linker
+        ///     or it didn't set up its link_map list yet.
+        //------------------------------------------------------------------
+        virtual Error
+        GetLoadedSVR4Libraries (std::vector<SVR4LibraryInfo> &library_list, lldb::addr_t &main_link_map);
+
         virtual bool
         IsAlive () const;
 
@@ -124,12 +225,63 @@ namespace lldb_private
         virtual Error
         RemoveBreakpoint (lldb::addr_t addr);
 
+        //------------------------------------------------------------------
+        /// Set or remove a batch of software breakpoints.
+        ///
+        /// The default implementation calls SetBreakpoint() or
+        /// RemoveBreakpoint() for every breakpoint. One breakpoint that
+        /// fails doesn't stop the others from being set or removed.
+        ///
+        /// @param[in] breakpoints
+        ///     The address and opcode size hint of each breakpoint. The
+        ///     size is ignored when removing breakpoints.
+        ///
+        /// @param[out] errors
+        ///     The result for each breakpoint, in the same order.
+        //------------------------------------------------------------------
+        virtual void
+        SetBreakpoints (const std::vector<std::pair<lldb::addr_t, uint32_t>> &breakpoints, std::vector<Error> &errors);
+
+        virtual void
+        RemoveBreakpoints (const std::vector<std::pair<lldb::addr_t, uint32_t>> &breakpoints, std::vector<Error> &errors);
+
         virtual Error
         EnableBreakpoint (lldb::addr_t addr);
 
         virtual Error
         DisableBreakpoint (lldb::addr_t addr);
 
+        //------------------------------------------------------------------
+        /// Replace the conditions of the software breakpoint at \a addr.
+        /// Processes that evaluate conditions must check
+        /// NativeBreakpoint::ShouldStop() before reporting a stop.
+        //------------------------------------------------------------------
+        Error
+        SetBreakpointConditions (lldb::addr_t addr, const std::vector<AgentExpression> &conditions);
+
+        //------------------------------------------------------------------
+        /// Make the software breakpoint at \a addr count its hits instead
+        /// of stopping, see NativeBreakpoint::SetCounting(). Processes
+        /// that don't count hits report them as usual.
+        //------------------------------------------------------------------
+        Error
+        SetBreakpointCounting (lldb::addr_t addr, bool counting);
+
+        //------------------------------------------------------------------
+        /// Limit the software breakpoint at \a addr to some threads, see
+        /// NativeBreakpoint::SetThreadIDs(). Processes that don't step other
+        /// threads over the breakpoint report their hits as usual.
+        //------------------------------------------------------------------
+        Error
+        SetBreakpointThreads (lldb::addr_t addr, const std::vector<lldb::tid_t> &thread_ids);
+
+        //------------------------------------------------------------------
+        /// Get the address and the number of counted hits of every
+        /// counting breakpoint.
+        //------------------------------------------------------------------
+        void
+        GetBreakpointHitCounts (std::vector<std::pair<lldb::addr_t, uint64_t>> &hit_counts);
+
         //----------------------------------------------------------------------
         // Watchpoint functions
         //----------------------------------------------------------------------
@@ -145,6 +297,56 @@ namespace lldb_private
         virtual Error
         RemoveWatchpoint (lldb::addr_t addr);
 
+        //----------------------------------------------------------------------
+        // Branch trace functions
+        //----------------------------------------------------------------------
+
+        //------------------------------------------------------------------
+        /// Start recording the branches a thread takes while it runs.
+        ///
+        /// @param[in] buffer_size
+        ///     How many bytes of trace to keep. Only the most recent
+        ///     branches that fit are kept.
+        //------------------------------------------------------------------
+        virtual Error
+        StartBranchTrace (lldb::tid_t tid, size_t buffer_size);
+
+        virtual Error
+        StopBranchTrace (lldb::tid_t tid);
+
+        //------------------------------------------------------------------
+        /// Get the branches a traced thread took, the oldest one first.
+        ///
+        /// @param[out] branches
+        ///     The source and destination address of each branch.
+        //------------------------------------------------------------------
+        virtual Error
+        GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches);
+
+        //----------------------------------------------------------------------
+        // Checkpoint functions
+        //----------------------------------------------------------------------
+
+        //------------------------------------------------------------------
+        /// Save the state of the stopped process, so it can be restored
+        /// later without running the process up to here again.
+        ///
+        /// @param[out] checkpoint_id
+        ///     The ID to restore the checkpoint with, IDs start at 1.
+        //------------------------------------------------------------------
+        virtual Error
+        SaveCheckpoint (uint32_t &checkpoint_id);
+
+        //------------------------------------------------------------------
+        /// Replace the process with a copy of a checkpoint.
+        ///
+        /// The copy can be a new process with a new process ID and new
+        /// threads. It is stopped, the checkpoint stays and can be restored
+        /// again.
+        //------------------------------------------------------------------
+        virtual Error
+        RestoreCheckpoint (uint32_t checkpoint_id);
+
         //----------------------------------------------------------------------
         // Accessors
         //----------------------------------------------------------------------
@@ -247,6 +449,13 @@ namespace lldb_private
 
             virtual void
             DidExec (NativeProcessProtocol *process) = 0;
+
+            // Only called in non-stop mode, when a single thread stopped
+            // while the rest of the process keeps running.
+            virtual void
+            ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+            {
+            }
         };
 
         //------------------------------------------------------------------
@@ -378,6 +587,11 @@ namespace lldb_private
         NativeWatchpointList m_watchpoint_list;
         int m_terminal_fd;
         uint32_t m_stop_id;
+        bool m_non_stop_mode;
+
+        // Set by IgnoreSignals(), the plugins check it before reporting a
+        // thread stopped by a signal.
+        llvm::DenseSet<int> m_signals_to_ignore;
 
         // -----------------------------------------------------------
         // Internal interface for state handling
@@ -412,6 +626,12 @@ namespace lldb_private
         void
         NotifyDidExec ();
 
+        // -----------------------------------------------------------
+        /// Notify the delegates that \a tid stopped in non-stop mode.
+        // -----------------------------------------------------------
+        void
+        NotifyThreadStopped (lldb::tid_t tid);
+
         NativeThreadProtocolSP
         GetThreadByIDUnlocked (lldb::tid_t tid);
 
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
@@ -99,6 +101,17 @@ public:
     virtual Error
     ClearAllHardwareWatchpoints ();
 
+    //------------------------------------------------------------------
+    /// Make @a watchpoints the only hardware watchpoints.
+    ///
+    /// @a wp_indexes gets the index of each of the watchpoints. The
+    /// default clears all of them and sets them again one at a time,
+    /// register contexts that can compare the new debug registers with
+    /// the current ones override this to write only what changed.
+    //------------------------------------------------------------------
+    virtual Error
+    SetHardwareWatchpoints (const std::vector<NativeWatchpoint> &watchpoints, std::vector<uint32_t> &wp_indexes);
+
     virtual Error
     IsWatchpointHit(uint32_t wp_index, bool &is_hit);
 
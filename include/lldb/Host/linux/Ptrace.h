@@ -48,6 +48,15 @@ typedef int __ptrace_request;
 #ifndef PTRACE_SETREGSET
     #define PTRACE_SETREGSET 0x4205
 #endif
+#ifndef PTRACE_SEIZE
+    #define PTRACE_SEIZE 0x4206
+#endif
+#ifndef PTRACE_INTERRUPT
+    #define PTRACE_INTERRUPT 0x4207
+#endif
+#ifndef PTRACE_EVENT_STOP
+    #define PTRACE_EVENT_STOP 128
+#endif
 #ifndef PTRACE_GET_THREAD_AREA
     #define PTRACE_GET_THREAD_AREA 25
 #endif
@@ -17,8 +17,10 @@
 namespace lldb_private {
 
 // Posix implementation of the MainLoopBase class. It can monitor file descriptors for
-// readability using pselect. In addition to the common base, this class provides the ability to
-// invoke a given handler when a signal is received.
+// readability using pselect, or epoll on Linux, where the cost of a wait doesn't grow with the
+// value of the highest file descriptor and there is no FD_SETSIZE limit. In addition to the
+// common base, this class provides the ability to invoke a given handler when a signal is
+// received.
 //
 // Since this class is primarily intended to be used for single-threaded processing, it does not
 // attempt to perform any internal synchronisation and any concurrent accesses must be protected
@@ -34,6 +36,8 @@ private:
 public:
     typedef std::unique_ptr<SignalHandle> SignalHandleUP;
 
+    MainLoopPosix();
+
     ~MainLoopPosix() override;
 
     ReadHandleUP
@@ -90,6 +94,9 @@ private:
 
     llvm::DenseMap<IOObject::WaitableHandle, Callback> m_read_fds;
     llvm::DenseMap<int, SignalInfo> m_signals;
+#if defined(__linux__)
+    int m_epoll_fd; // Watches the file descriptors in m_read_fds
+#endif
     bool m_terminate_request : 1;
 };
 
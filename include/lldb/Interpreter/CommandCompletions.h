@@ -289,7 +289,6 @@ public:
 //            }
 //        };
 
-        RegularExpression m_regex;
         typedef std::set<ConstString> collection;
         collection m_match_set;
 
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
@@ -239,6 +241,12 @@ public:
         return StructuredData::StringSP();
     }
 
+    virtual StructuredData::StringSP
+    OSPlugin_AllRegisterContextData(StructuredData::ObjectSP os_plugin_object_sp)
+    {
+        return StructuredData::StringSP();
+    }
+
     virtual StructuredData::DictionarySP
     OSPlugin_CreateThread(StructuredData::ObjectSP os_plugin_object_sp, lldb::tid_t tid, lldb::addr_t context)
     {
@@ -357,6 +365,21 @@ public:
         return lldb::ValueObjectSP();
     }
 
+    //------------------------------------------------------------------
+    /// Get up to \a count children starting at index \a start in one
+    /// call into the script, if the provider supports that.
+    ///
+    /// @return
+    ///     False if the provider can only return one child at a time,
+    ///     use GetChildAtIndex() then.
+    //------------------------------------------------------------------
+    virtual bool
+    GetChildrenAtIndex(const StructuredData::ObjectSP &implementor, uint32_t start, uint32_t count,
+                       std::vector<lldb::ValueObjectSP> &children)
+    {
+        return false;
+    }
+
     virtual int
     GetIndexOfChildWithName(const StructuredData::ObjectSP &implementor, const char *child_name)
     {
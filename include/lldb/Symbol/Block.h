@@ -469,8 +469,36 @@ public:
     void
     SetDidParseVariables (bool b, bool set_children);
 
+    //------------------------------------------------------------------
+    /// Get the variables of this block and its parents that were in
+    /// scope at \a file_addr, see StackFrame::GetInScopeVariableList().
+    ///
+    /// Which variables are in scope only depends on the innermost block
+    /// and the address in it. The last few results are kept so that the
+    /// frames of a program that keeps stopping at the same places don't
+    /// filter the variables of the function again on every stop.
+    ///
+    /// @return
+    ///     The cached variables, or an empty shared pointer if none were
+    ///     cached for \a file_addr.
+    //------------------------------------------------------------------
+    lldb::VariableListSP
+    GetCachedInScopeVariables (lldb::addr_t file_addr, bool must_have_valid_location);
+
+    void
+    CacheInScopeVariables (lldb::addr_t file_addr,
+                           bool must_have_valid_location,
+                           const lldb::VariableListSP &variable_list_sp);
+
 protected:
     typedef std::vector<lldb::BlockSP> collection;
+
+    struct InScopeVariables
+    {
+        lldb::addr_t file_addr;
+        bool must_have_valid_location;
+        lldb::VariableListSP variable_list_sp;
+    };
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
@@ -479,6 +507,7 @@ protected:
     RangeList m_ranges;
     lldb::InlineFunctionInfoSP m_inlineInfoSP; ///< Inlined function information.
     lldb::VariableListSP m_variable_list_sp; ///< The variable list for all local, static and parameter variables scoped to this block.
+    std::vector<InScopeVariables> m_in_scope_variables; ///< The most recent results of CacheInScopeVariables(), oldest first.
     bool m_parsed_block_info:1,         ///< Set to true if this block and it's children have all been parsed
          m_parsed_block_variables:1,
          m_parsed_child_blocks:1;
@@ -67,6 +67,9 @@ public:
     void
     Finalize() override;
 
+    size_t
+    MemorySize() const override;
+
     //------------------------------------------------------------------
     // PluginInterface functions
     //------------------------------------------------------------------
@@ -545,6 +548,12 @@ public:
     static void
     CompleteObjCInterfaceDecl (void *baton, clang::ObjCInterfaceDecl *);
 
+    static void
+    FindExternalVisibleDeclsByName (void *baton,
+                                    const clang::DeclContext *decl_ctx,
+                                    clang::DeclarationName name,
+                                    llvm::SmallVectorImpl<clang::NamedDecl *> *results);
+
     static bool
     LayoutRecordType(void *baton,
                      const clang::RecordDecl *record_decl,
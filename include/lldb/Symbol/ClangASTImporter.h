@@ -39,7 +39,7 @@ public:
     static void DumpCounters (Log *log);
     static void ClearLocalCounters ()
     {
-        local_counters = { 0, 0, 0, 0, 0, 0 };
+        local_counters = { 0, 0, 0, 0, 0, 0, 0 };
     }
     
     static void RegisterVisibleQuery ()
@@ -66,6 +66,12 @@ public:
         ++local_counters.m_clang_import_count;
     }
     
+    static void RegisterReusedImport ()
+    {
+        ++global_counters.m_reused_import_count;
+        ++local_counters.m_reused_import_count;
+    }
+    
     static void RegisterDeclCompletion ()
     {
         ++global_counters.m_decls_completed_count;
@@ -85,6 +91,7 @@ private:
         uint64_t    m_lexical_query_count;
         uint64_t    m_lldb_import_count;
         uint64_t    m_clang_import_count;
+        uint64_t    m_reused_import_count;
         uint64_t    m_decls_completed_count;
         uint64_t    m_record_layout_count;
     };
@@ -338,6 +345,11 @@ private:
     typedef std::map<clang::ASTContext *, MinionSP> MinionMap;
     typedef std::map<const clang::NamespaceDecl *, NamespaceMapSP> NamespaceMetaMap;
     
+    // Maps a Decl in a module AST (its context and the Decl) to the copy
+    // of it in a destination AST.
+    typedef std::pair<clang::ASTContext *, const clang::Decl *> OriginKey;
+    typedef std::map<OriginKey, clang::Decl *> ImportedDeclMap;
+    
     struct ASTContextMetadata
     {
         ASTContextMetadata(clang::ASTContext *dst_ctx) :
@@ -345,7 +357,8 @@ private:
             m_minions (),
             m_origins (),
             m_namespace_maps (),
-            m_map_completer (nullptr)
+            m_map_completer (nullptr),
+            m_imported_decls ()
         {
         }
         
@@ -355,6 +368,14 @@ private:
         
         NamespaceMetaMap        m_namespace_maps;
         MapCompleter           *m_map_completer;
+        
+        // The first copy of every Decl imported into this context that
+        // has an origin.  Expression ASTs are thrown away after every
+        // expression, but their Decls keep pointing at the same origins,
+        // so when one is deported into this context again the copy made
+        // for an earlier expression is reused instead of importing it
+        // (and everything it refers to) again.
+        ImportedDeclMap         m_imported_decls;
     };
     
     typedef std::shared_ptr<ASTContextMetadata> ASTContextMetadataSP;    
@@ -412,6 +433,9 @@ private:
     
     DeclOrigin
     GetDeclOrigin (const clang::Decl *decl);
+    
+    void
+    ReuseImportedDecls (Minion &minion, clang::ASTContext *dst_ctx, clang::ASTContext *src_ctx);
         
     clang::FileManager      m_file_manager;
     typedef llvm::DenseMap<const clang::RecordDecl *, LayoutInfo> RecordDeclToLayoutMap;
@@ -31,6 +31,8 @@ class ClangExternalASTSourceCallbacks : public ClangExternalASTSourceCommon
 public:
     typedef void (*CompleteTagDeclCallback)(void *baton, clang::TagDecl *);
     typedef void (*CompleteObjCInterfaceDeclCallback)(void *baton, clang::ObjCInterfaceDecl *);
+    // Also called with an empty name when all declarations of a class are
+    // loaded.
     typedef void (*FindExternalVisibleDeclsByNameCallback)(void *baton, const clang::DeclContext *DC, clang::DeclarationName Name, llvm::SmallVectorImpl <clang::NamedDecl *> *results);
     typedef bool (*LayoutRecordTypeCallback)(
         void *baton, const clang::RecordDecl *Record, uint64_t &Size, uint64_t &Alignment,
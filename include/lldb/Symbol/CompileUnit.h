@@ -251,6 +251,35 @@ public:
     LineTable*
     GetLineTable ();
 
+    //------------------------------------------------------------------
+    /// Check if the line table was parsed or set, without parsing it.
+    //------------------------------------------------------------------
+    bool
+    HasParsedLineTable () const
+    {
+        return m_flags.Test(flagsParsedLineTable);
+    }
+
+    //------------------------------------------------------------------
+    /// Get the memory used by the functions, the line table and the
+    /// support files that were parsed so far, without parsing any more.
+    //------------------------------------------------------------------
+    size_t
+    GetFunctionsMemorySize () const;
+
+    size_t
+    GetLineTableMemorySize () const;
+
+    //------------------------------------------------------------------
+    /// Free the line table and the support files. They are parsed again
+    /// the next time they are asked for.
+    ///
+    /// @return
+    ///     The number of bytes that were released.
+    //------------------------------------------------------------------
+    size_t
+    ReleaseLineTable ();
+
     DebugMacros*
     GetDebugMacros ();
 
@@ -10,8 +10,10 @@
 #ifndef liblldb_DWARFCallFrameInfo_h_
 #define liblldb_DWARFCallFrameInfo_h_
 
+#include <atomic>
 #include <map>
 #include <mutex>
+#include <vector>
 
 #include "lldb/Core/AddressRange.h"
 #include "lldb/Core/DataExtractor.h"
@@ -125,6 +127,15 @@ private:
     void
     GetFDEIndex ();
 
+    bool
+    GetFDEOffsetsFromEHFrameHeader (std::vector<dw_offset_t> &fde_offsets);
+
+    bool
+    GetFDEOffsetsFromSection (std::vector<dw_offset_t> &fde_offsets);
+
+    bool
+    ParseFDEEntry (dw_offset_t fde_offset, FDEEntryMap::Entry &fde);
+
     bool
     FDEToUnwindPlan (uint32_t offset, Address startaddr, UnwindPlan& unwind_plan);
 
@@ -149,12 +160,14 @@ private:
     lldb::RegisterKind          m_reg_kind;
     Flags                       m_flags;
     cie_map_t                   m_cie_map;
+    std::mutex m_cie_map_mutex;                           // CIEs are parsed lazily by any unwinding thread
 
     DataExtractor               m_cfi_data;
-    bool                        m_cfi_data_initialized;   // only copy the section into the DE once
+    std::atomic<bool>           m_cfi_data_initialized;   // only copy the section into the DE once
+    std::mutex m_cfi_data_mutex;
 
     FDEEntryMap                 m_fde_index;
-    bool                        m_fde_index_initialized;  // only scan the section for FDEs once
+    std::atomic<bool>           m_fde_index_initialized;  // only scan the section for FDEs once
     std::mutex m_fde_index_mutex;                         // and isolate the thread that does it
 
     bool                        m_is_eh_frame;
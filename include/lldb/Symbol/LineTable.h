@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
@@ -236,6 +238,16 @@ public:
     uint32_t
     GetSize () const;
 
+    //------------------------------------------------------------------
+    /// Get the memory cost of this object.
+    ///
+    /// @return
+    ///     The number of bytes that this object occupies in memory,
+    ///     including the entries and the file line index.
+    //------------------------------------------------------------------
+    size_t
+    MemorySize () const;
+
     typedef lldb_private::RangeArray<lldb::addr_t, lldb::addr_t, 32> FileAddressRanges;
     
     //------------------------------------------------------------------
@@ -412,6 +424,35 @@ protected:
     bool
     ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry);
 
+    //------------------------------------------------------------------
+    // The rows of one file, sorted by line and then by row index. The
+    // lines are kept apart from the row indexes so that the binary
+    // search by line only touches the lines.
+    //------------------------------------------------------------------
+    struct FileLineIndex
+    {
+        std::vector<uint32_t> lines;
+        std::vector<uint32_t> rows;
+    };
+
+    // Build m_file_line_index if it hasn't been built since the entries
+    // last changed.
+    void
+    BuildFileLineIndex ();
+
+    void
+    ClearFileLineIndex ();
+
+    // Find the row of file_idx at or after start_idx whose line is line,
+    // or, if exact is false and there is none, the first row of the
+    // smallest line after it.
+    uint32_t
+    FindRowInFileLineIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact) const;
+
+    std::vector<FileLineIndex> m_file_line_index; ///< The rows of each file in the compile unit's file table, indexed by file index.
+    std::atomic<bool> m_file_line_index_built;
+    std::mutex m_file_line_index_mutex;
+
 private:
     DISALLOW_COPY_AND_ASSIGN (LineTable);
 };
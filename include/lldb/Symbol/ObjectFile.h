@@ -395,6 +395,19 @@ public:
     virtual Symtab *
     GetSymtab () = 0;
 
+    //------------------------------------------------------------------
+    /// Gets the symbol table only if it was already parsed.
+    ///
+    /// @return
+    ///     The symbol table for this object file, or nullptr if
+    ///     GetSymtab() hasn't parsed it yet.
+    //------------------------------------------------------------------
+    Symtab *
+    GetSymtabIfParsed () const
+    {
+        return m_symtab_ap.get();
+    }
+
     //------------------------------------------------------------------
     /// Appends a Symbol for the specified so_addr to the symbol table.
     ///
@@ -68,6 +68,27 @@ public:
     void
     Dump (Stream *s, Target *target, uint32_t index) const;
 
+    //------------------------------------------------------------------
+    /// Write the symbol to a binary stream, for the symbol table cache.
+    ///
+    /// The section of the address is saved by ID.
+    //------------------------------------------------------------------
+    void
+    Encode (Stream &strm) const;
+
+    //------------------------------------------------------------------
+    /// Read a symbol written by Encode().
+    ///
+    /// @param[in] section_list
+    ///     The sections the IDs of the encoded addresses refer to.
+    ///
+    /// @return
+    ///     False if the data is invalid or refers to a section that isn't
+    ///     in \a section_list.
+    //------------------------------------------------------------------
+    bool
+    Decode (const DataExtractor &data, lldb::offset_t *offset_ptr, const SectionList *section_list);
+
     bool
     ValueIsAddress() const;
 
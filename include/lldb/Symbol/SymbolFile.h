@@ -12,6 +12,7 @@
 
 #include "lldb/lldb-private.h"
 #include "lldb/Core/PluginInterface.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Symbol/CompilerType.h"
 #include "lldb/Symbol/CompilerDecl.h"
 #include "lldb/Symbol/CompilerDeclContext.h"
@@ -146,7 +147,17 @@ public:
     virtual uint32_t        FindTypes (const SymbolContext& sc, const ConstString &name, const CompilerDeclContext *parent_decl_ctx, bool append, uint32_t max_matches, llvm::DenseSet<lldb_private::SymbolFile *> &searched_symbol_files, TypeMap& types);
     virtual size_t          FindTypes (const std::vector<CompilerContext> &context, bool append, TypeMap& types);
 
+    // Build the tables lookups by name need now rather than on the first
+    // lookup, see Module::PreloadSymbols().
+    virtual void            PreloadSymbols() {}
+    // Do part of the work of PreloadSymbols(). Returns true if there is
+    // more to do, see Module::PreloadSymbolsInBackground().
+    virtual bool            PreloadSymbolsStep() { PreloadSymbols(); return false; }
     virtual void            GetMangledNamesForFunction(const std::string &scope_qualified_name, std::vector<ConstString> &mangled_names);
+    // Append the names of the functions in the debug info, for name
+    // completion. The names of the code symbols are already covered by the
+    // symbol table.
+    virtual void            GetFunctionNames(std::vector<ConstString> &names) {}
 //  virtual uint32_t        FindTypes (const SymbolContext& sc, const RegularExpression& regex, bool append, uint32_t max_matches, TypeList& types) = 0;
     virtual TypeList *      GetTypeList ();
     virtual size_t          GetTypes (lldb_private::SymbolContextScope *sc_scope,
@@ -176,6 +187,38 @@ public:
     { 
     }
 
+    //------------------------------------------------------------------
+    /// Add the symbol file specific numbers for "statistics dump", like
+    /// the time it took to index the debug info, to \a stats.
+    //------------------------------------------------------------------
+    virtual void
+    GetStatistics (StructuredData::Dictionary &stats)
+    {
+    }
+
+    //------------------------------------------------------------------
+    /// The memory held by data the symbol file parsed for itself, like
+    /// the extracted DWARF DIEs, in bytes.
+    //------------------------------------------------------------------
+    virtual size_t
+    GetCachedDataMemorySize ()
+    {
+        return 0;
+    }
+
+    //------------------------------------------------------------------
+    /// Free the data GetCachedDataMemorySize() counts that nothing else
+    /// refers to. It is read from the file again when it's needed.
+    ///
+    /// @return
+    ///     The number of bytes that were released.
+    //------------------------------------------------------------------
+    virtual size_t
+    ReleaseCachedData ()
+    {
+        return 0;
+    }
+
 protected:
     ObjectFile*             m_obj_file; // The object file that symbols can be extracted from.
     uint32_t                m_abilities;
@@ -192,6 +192,51 @@ public:
     virtual void
     SectionFileAddressesChanged ();
 
+    //------------------------------------------------------------------
+    /// The memory held by the parsed debug info of a module, in bytes.
+    //------------------------------------------------------------------
+    struct MemoryUsage
+    {
+        MemoryUsage () :
+            symbol_file (0),
+            types (0),
+            functions (0),
+            line_tables (0),
+            type_systems (0)
+        {
+        }
+
+        size_t
+        GetTotal () const
+        {
+            return symbol_file + types + functions + line_tables + type_systems;
+        }
+
+        size_t symbol_file;     // What the symbol file keeps, like the extracted DWARF DIEs
+        size_t types;           // The types in the type list
+        size_t functions;       // The parsed functions and their blocks
+        size_t line_tables;     // The line tables and support files
+        size_t type_systems;    // The ASTs of the module's type systems
+    };
+
+    //------------------------------------------------------------------
+    /// Add up the memory used by what was parsed so far, without parsing
+    /// anything.
+    //------------------------------------------------------------------
+    void
+    GetMemoryUsage (MemoryUsage &usage);
+
+    //------------------------------------------------------------------
+    /// Release the parsed data that can be parsed again when it's
+    /// needed: the line tables and support files of the compile units
+    /// and what the symbol file can give back.
+    ///
+    /// @return
+    ///     The number of bytes that were released.
+    //------------------------------------------------------------------
+    size_t
+    ReleaseCachedData ();
+
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
@@ -47,6 +47,7 @@ public:
             uint32_t    AddSymbol(const Symbol& symbol);
             size_t      GetNumSymbols() const;
             void        SectionFileAddressesChanged ();
+            void        PreloadSymbols ();   // Build the name indexes now instead of on the first lookup
             void        Dump(Stream *s, Target *target, SortOrder sort_type);
             void        Dump(Stream *s, Target *target, std::vector<uint32_t>& indexes) const;
             uint32_t    GetIndexForSymbol (const Symbol *symbol) const;
@@ -86,6 +87,14 @@ public:
             size_t      FindFunctionSymbols (const ConstString &name, uint32_t name_type_mask, SymbolContextList& sc_list);
             void        CalculateSymbolSizes ();
 
+            //----------------------------------------------------------------------
+            /// Write the symbols to a binary stream, or replace them with the
+            /// ones read from \a data, for object files that cache their parsed
+            /// symbol table. See Symbol::Encode().
+            //----------------------------------------------------------------------
+            void        Encode (Stream &strm) const;
+            bool        Decode (const DataExtractor &data, lldb::offset_t *offset_ptr, const SectionList *section_list);
+
             void        SortSymbolIndexesByValue (std::vector<uint32_t>& indexes, bool remove_duplicates) const;
 
     static  void        DumpSymbolHeader (Stream *s);
@@ -110,6 +119,23 @@ public:
                         {
                             return m_objfile;
                         }
+
+            //----------------------------------------------------------------------
+            /// The time in nanoseconds it took the object file to parse the
+            /// symbols, and to build the name indexes.
+            //----------------------------------------------------------------------
+            uint64_t    GetParseTime () const
+                        {
+                            return m_parse_time;
+                        }
+            void        SetParseTime (uint64_t nanos)
+                        {
+                            m_parse_time = nanos;
+                        }
+            uint64_t    GetIndexTime () const
+                        {
+                            return m_index_time;
+                        }
 protected:
     typedef std::vector<Symbol>         collection;
     typedef collection::iterator        iterator;
@@ -117,6 +143,11 @@ protected:
     typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t> FileRangeToIndexMap;
             void        InitNameIndexes ();
             void        InitAddressIndexes ();
+            void        DemangleSymbols ();
+            void        IndexDemangledNames ();
+            bool        GetDemangledNameCacheFileSpec (FileSpec &cache_file_spec) const;
+            bool        LoadDemangledNameCache ();
+            void        SaveDemangledNameCache () const;
 
     ObjectFile *        m_objfile;
     collection          m_symbols;
@@ -126,8 +157,12 @@ protected:
     UniqueCStringMap<uint32_t> m_method_to_index;
     UniqueCStringMap<uint32_t> m_selector_to_index;
     mutable std::recursive_mutex m_mutex; // Provide thread safety for this symbol table
+    uint64_t            m_parse_time;
+    uint64_t            m_index_time;
     bool                m_file_addr_to_index_computed:1,
-                        m_name_indexes_computed:1;
+                        m_name_indexes_computed:1,
+                        m_demangled_names_indexed:1,     // False if lazy demangling deferred some demangled names
+                        m_demangled_name_cache_loaded:1;
 private:
 
     bool
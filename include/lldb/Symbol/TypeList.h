@@ -47,6 +47,11 @@ public:
     uint32_t
     GetSize() const;
 
+    // The number of bytes the list and its types occupy in memory, not
+    // counting the compiler types they refer to.
+    size_t
+    MemorySize() const;
+
     lldb::TypeSP
     GetTypeAtIndex(uint32_t idx);
     
@@ -99,6 +99,14 @@ public:
     virtual void
     Finalize() {}
 
+    // The number of bytes the type system allocated for its types and
+    // declarations, or 0 if it can't tell.
+    virtual size_t
+    MemorySize() const
+    {
+        return 0;
+    }
+
     virtual DWARFASTParser *
     GetDWARFParser()
     {
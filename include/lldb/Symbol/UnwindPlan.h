@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <functional>
 #include <map>
 #include <memory>
 #include <vector>
@@ -439,6 +440,17 @@ public:
         void
         RemoveRegisterInfo (uint32_t reg_num);
 
+        size_t
+        GetRegisterInfoCount () const
+        {
+            return m_register_locations.size();
+        }
+
+        // Calls the callback with every register that has a location in
+        // this row until it returns false.
+        void
+        ForEachRegisterInfo (const std::function<bool(uint32_t, const RegisterLocation &)> &callback) const;
+
         lldb::addr_t
         GetOffset() const
         {
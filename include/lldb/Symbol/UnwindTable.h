@@ -11,8 +11,12 @@
 #ifndef liblldb_UnwindTable_h
 #define liblldb_UnwindTable_h
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "lldb/lldb-private.h" 
 
@@ -21,6 +25,11 @@ namespace lldb_private {
 // A class which holds all the FuncUnwinders objects for a given ObjectFile.
 // The UnwindTable is populated with FuncUnwinders objects lazily during
 // the debug session.
+//
+// The function boundaries of the eh_frame FDEs are read into a sorted
+// vector when the table is initialized. The vector doesn't change after
+// that, so the FuncUnwinders of those functions are looked up without
+// taking a lock; only addresses outside of all FDEs go through the map.
 
 class UnwindTable
 {
@@ -55,22 +64,76 @@ public:
     bool
     GetArchitecture (lldb_private::ArchSpec &arch);
 
+    //------------------------------------------------------------------
+    /// The unwind row RegisterContextLLDB picked for a return address,
+    /// reduced to a plain record.
+    ///
+    /// Only rows of the form "CFA = reg + offset" where every saved
+    /// register is at "[CFA + offset]" are cached, which covers the
+    /// "CFA = rsp + N" and "CFA = rbp + 16" frames that make up most
+    /// stacks. RegisterContextLLDB turns the record back into a one row
+    /// UnwindPlan instead of choosing between the unwind sources again.
+    //------------------------------------------------------------------
+    struct CachedUnwindRow
+    {
+        enum
+        {
+            kMaxSavedRegisters = 6
+        };
+
+        bool from_fast_plan;            // the row came from the fast UnwindPlan
+        lldb::RegisterKind register_kind;
+        lldb_private::LazyBool sourced_from_compiler;
+        lldb_private::LazyBool valid_at_all_instructions;
+        int function_offset;            // RegisterContextLLDB's m_current_offset for the pc
+        uint32_t cfa_reg;
+        int32_t cfa_offset;
+        uint32_t num_saved_registers;
+        uint32_t saved_regs[kMaxSavedRegisters];
+        int32_t saved_offsets[kMaxSavedRegisters];
+    };
+
+    bool
+    LookupCachedUnwindRow (lldb::addr_t file_addr, CachedUnwindRow &row);
+
+    void
+    AddCachedUnwindRow (lldb::addr_t file_addr, const CachedUnwindRow &row);
+
 private:
     void
     Dump (Stream &s);
     
     void Initialize ();
 
+    lldb::FuncUnwindersSP
+    FindFuncUnwinders (const Address& addr, lldb::addr_t file_addr);
+
+    // A function from the eh_frame, "unwinders" is created on first use
+    // and only accessed through std::atomic_load/atomic_compare_exchange.
+    struct FunctionEntry
+    {
+        lldb::addr_t base;
+        lldb::addr_t size;
+        lldb::FuncUnwindersSP unwinders;
+    };
+
+    FunctionEntry *
+    FindFunctionEntry (lldb::addr_t file_addr);
+
     typedef std::map<lldb::addr_t, lldb::FuncUnwindersSP> collection;
     typedef collection::iterator iterator;
     typedef collection::const_iterator const_iterator;
 
     ObjectFile&         m_object_file;
     collection          m_unwinds;
+    std::vector<FunctionEntry> m_functions; // sorted by base, immutable after Initialize
 
-    bool                m_initialized;  // delay some initialization until ObjectFile is set up
+    std::atomic<bool>   m_initialized;  // delay some initialization until ObjectFile is set up
     std::mutex m_mutex;
 
+    std::mutex m_cached_rows_mutex;
+    std::unordered_map<lldb::addr_t, CachedUnwindRow> m_cached_rows; // keyed by the file address of the pc
+
     std::unique_ptr<DWARFCallFrameInfo> m_eh_frame_up;
     std::unique_ptr<CompactUnwindInfo>  m_compact_unwind_up;
     std::unique_ptr<ArmUnwindInfo>      m_arm_unwind_up;
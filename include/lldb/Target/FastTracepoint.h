@@ -0,0 +1,156 @@
+//===-- FastTracepoint.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_FastTracepoint_h_
+#define liblldb_FastTracepoint_h_
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/UserID.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class FastTracepoint FastTracepoint.h "lldb/Target/FastTracepoint.h"
+/// @brief A tracepoint that records registers without stopping the process.
+///
+/// Installing a fast tracepoint replaces the instructions at an address
+/// with a jump to a trampoline in memory allocated in the inferior. The
+/// trampoline saves the general purpose registers into a ring buffer,
+/// also in the inferior, runs the relocated original instructions and
+/// jumps back. No thread ever stops at the tracepoint, the samples are
+/// read out the next time the process is stopped.
+///
+/// Only x86_64 is supported. The replaced instructions must not branch or
+/// use RIP relative operands, since they are executed from the
+/// trampoline.
+//----------------------------------------------------------------------
+class FastTracepoint : public UserID
+{
+public:
+    // The order the trampoline saves the registers in.
+    enum Register
+    {
+        eRegisterR15,
+        eRegisterR14,
+        eRegisterR13,
+        eRegisterR12,
+        eRegisterR11,
+        eRegisterR10,
+        eRegisterR9,
+        eRegisterR8,
+        eRegisterRDI,
+        eRegisterRSI,
+        eRegisterRBP,
+        eRegisterRSP,
+        eRegisterRBX,
+        eRegisterRDX,
+        eRegisterRCX,
+        eRegisterRAX,
+        eRegisterRFLAGS,
+        kNumSavedRegisters,
+        eRegisterRIP = kNumSavedRegisters,
+        kNumRegisters
+    };
+
+    struct Sample
+    {
+        // Counts the hits of the tracepoint, starting at zero.
+        uint64_t sequence;
+        uint64_t registers[kNumRegisters];
+    };
+
+    FastTracepoint (Process &process, lldb::user_id_t id, lldb::addr_t addr, uint32_t capacity);
+
+    ~FastTracepoint ();
+
+    static const char *
+    GetRegisterName (uint32_t reg);
+
+    lldb::addr_t
+    GetLoadAddress () const
+    {
+        return m_addr;
+    }
+
+    // The number of samples the ring buffer keeps, older ones are overwritten.
+    uint32_t
+    GetCapacity () const
+    {
+        return m_capacity;
+    }
+
+    bool
+    IsInstalled () const
+    {
+        return m_installed;
+    }
+
+    //------------------------------------------------------------------
+    /// Patch the code and allocate the trampoline and the ring buffer.
+    ///
+    /// The process must be stopped.
+    //------------------------------------------------------------------
+    Error
+    Install ();
+
+    //------------------------------------------------------------------
+    /// Restore the original instructions.
+    ///
+    /// The trampoline is freed unless a thread is still executing it.
+    //------------------------------------------------------------------
+    Error
+    Remove ();
+
+    //------------------------------------------------------------------
+    /// Read the samples still in the ring buffer, oldest first.
+    ///
+    /// @param[out] total_hits
+    ///     The number of times the tracepoint was hit, which can be more
+    ///     than the number of samples returned.
+    //------------------------------------------------------------------
+    Error
+    ReadSamples (std::vector<Sample> &samples, uint64_t &total_hits);
+
+    // Called when the process memory went away (exec) and there is nothing
+    // left to restore.
+    void
+    Invalidate ();
+
+private:
+    Error
+    GetRelocatableInstructions (size_t min_length, std::vector<uint8_t> &bytes);
+
+    void
+    BuildTrampoline (const std::vector<uint8_t> &relocated, std::vector<uint8_t> &code) const;
+
+    bool
+    IsAnyThreadInRange (lldb::addr_t addr, size_t size, bool include_start) const;
+
+    Process &m_process;
+    lldb::addr_t m_addr;
+    uint32_t m_capacity;
+    bool m_installed;
+    std::vector<uint8_t> m_original_bytes;
+    lldb::addr_t m_trampoline_addr;
+    size_t m_trampoline_size;
+    lldb::addr_t m_buffer_addr;
+
+    DISALLOW_COPY_AND_ASSIGN (FastTracepoint);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_FastTracepoint_h_
@@ -107,6 +107,8 @@ public:
     virtual std::vector<ConstString>
     GetPossibleFormattersMatches (ValueObject& valobj, lldb::DynamicValueType use_dynamic);
 
+    // The StringPrinter prints printable ASCII other than '"' and '\\' as it
+    // is, the helper is only asked about the other characters.
     virtual lldb_private::formatters::StringPrinter::EscapingHelper
     GetStringPrinterEscapingHelper (lldb_private::formatters::StringPrinter::GetPrintableElementType);
     
@@ -12,11 +12,13 @@
 
 // C Includes
 // C++ Includes
+#include <list>
 #include <map>
 #include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
+#include "llvm/ADT/DenseMap.h"
 
 // Project includes
 #include "lldb/lldb-private.h"
@@ -26,6 +28,16 @@ namespace lldb_private {
     //----------------------------------------------------------------------
     // A class to track memory that was read from a live process between 
     // runs. 
+    //
+    // The L2 cache keeps the most recently used lines up to a fixed size.
+    // Misses that follow each other read more lines ahead each time, up to
+    // 16 lines, so walking memory sequentially takes much fewer reads from
+    // the process.
+    //
+    // Lines of read only memory that is mapped from the file of a loaded
+    // module are kept across stops. Once such memory turned out to have
+    // the same bytes as the file, it is read from the file instead of the
+    // process.
     //----------------------------------------------------------------------
     class MemoryCache
     {
@@ -36,9 +48,51 @@ namespace lldb_private {
         MemoryCache (Process &process);
         
         ~MemoryCache ();
+
+        struct Statistics
+        {
+            uint64_t num_L1_hits;
+            uint64_t num_L2_hits;
+            uint64_t num_misses;
+            uint64_t num_prefetches;
+            uint64_t num_inferior_reads;    // reads that went to the process
+            uint64_t num_file_reads;        // reads that went to a module's file instead
+            uint64_t inferior_bytes_read;
+            uint64_t num_evictions;
+            uint64_t num_cached_lines;
+            uint64_t cached_bytes;
+            uint64_t num_file_backed_ranges;
+
+            Statistics () :
+                num_L1_hits (0),
+                num_L2_hits (0),
+                num_misses (0),
+                num_prefetches (0),
+                num_inferior_reads (0),
+                num_file_reads (0),
+                inferior_bytes_read (0),
+                num_evictions (0),
+                num_cached_lines (0),
+                cached_bytes (0),
+                num_file_backed_ranges (0)
+            {
+            }
+        };
         
+        //------------------------------------------------------------------
+        /// Throw away what may have changed since the process last ran.
+        ///
+        /// @param[in] clear_invalid_ranges
+        ///     Also forget the invalid ranges and which memory is file
+        ///     backed, for when the process starts over or execs.
+        //------------------------------------------------------------------
         void
         Clear(bool clear_invalid_ranges = false);
+
+        // Forget which memory is file backed and everything we cached,
+        // for when modules are loaded or unloaded.
+        void
+        ClearFileBackedRanges ();
         
         void
         Flush (lldb::addr_t addr, size_t size);
@@ -48,6 +102,20 @@ namespace lldb_private {
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        /// Hint that memory is about to be read, like the elements of an
+        /// array or the object a pointer points to.
+        ///
+        /// The lines of the range that aren't cached yet are read with one
+        /// read from the process. At most 16 lines are read, errors are
+        /// ignored.
+        //------------------------------------------------------------------
+        void
+        Prefetch (lldb::addr_t addr, size_t size);
+
+        Statistics
+        GetStatistics ();
         
         uint32_t
         GetMemoryCacheLineSize() const
@@ -72,15 +140,74 @@ namespace lldb_private {
         typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
         typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
         typedef Range<lldb::addr_t, lldb::addr_t> AddrRange;
+        struct L2Line
+        {
+            lldb::DataBufferSP data_sp;
+            std::list<lldb::addr_t>::iterator lru_pos;
+        };
+        typedef llvm::DenseMap<lldb::addr_t, L2Line> L2LineMap;
+
+        enum FileBackedState
+        {
+            eNotFileBacked,
+            eFileBackedUnverified,  // Not compared with the file yet
+            eFileBackedIdentical,   // Has the same bytes as the file
+            eFileBackedDifferent,   // Doesn't change, but differs from the file
+            eFileBackedWritten      // We wrote to it, like to any other memory
+        };
+        typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t> FileBackedRanges;
+
+        // Find out whether the memory at addr is file backed, and remember
+        // it for the range around addr.
+        FileBackedRanges::Entry *
+        FindFileBackedRange (lldb::addr_t addr);
+
+        // Whether the range is read only file backed memory, so its cached
+        // data stays valid across stops.
+        bool
+        IsPersistent (lldb::addr_t addr, size_t size);
+
+        // Read from the section data of the module that is loaded at addr.
+        size_t
+        ReadFromFile (lldb::addr_t addr, void *dst, size_t size);
+
+        // Find a line and mark it as the most recently used one.
+        lldb::DataBufferSP
+        FindL2Line (lldb::addr_t line_addr);
+
+        // Add a line unless there is one already, and evict the least
+        // recently used lines if the cache grew too big.
+        void
+        InsertL2Line (lldb::addr_t line_addr, const lldb::DataBufferSP &data_sp);
+
+        void
+        EraseL2Line (L2LineMap::iterator pos);
+
+        // Read up to num_lines lines from the process with one read and
+        // return the first one. guard is unlocked during the read.
+        lldb::DataBufferSP
+        FillL2Lines (std::unique_lock<std::recursive_mutex> &guard,
+                     lldb::addr_t first_line_addr,
+                     uint32_t cache_line_byte_size,
+                     uint32_t num_lines,
+                     Error &error);
+
         //------------------------------------------------------------------
         // Classes that inherit from MemoryCache can see and modify these
         //------------------------------------------------------------------
         std::recursive_mutex m_mutex;
         BlockMap m_L1_cache; // A first level memory cache whose chunk sizes vary that will be used only if the memory read fits entirely in a chunk
-        BlockMap m_L2_cache; // A memory cache of fixed size chinks (m_L2_cache_line_byte_size bytes in size each)
+        L2LineMap m_L2_cache; // A memory cache of fixed size chinks (m_L2_cache_line_byte_size bytes in size each)
+        std::list<lldb::addr_t> m_L2_lru; // The addresses of the L2 lines, the most recently used one first
+        size_t m_L2_cache_byte_size;
+        lldb::addr_t m_L2_next_sequential_addr; // The address right after the last lines we read from the process
+        uint32_t m_L2_readahead_lines;
         InvalidRanges m_invalid_ranges;
+        FileBackedRanges m_file_backed_ranges;
         Process &m_process;
         uint32_t m_L2_cache_line_byte_size;
+        uint32_t m_generation; // Bumped whenever cached data is thrown away
+        Statistics m_stats;
     private:
         DISALLOW_COPY_AND_ASSIGN (MemoryCache);
     };
@@ -131,6 +258,11 @@ namespace lldb_private {
         {
             return ((addr >= m_addr) && addr < (m_addr + m_byte_size));
         }
+
+        // The number of bytes handed out, rounded up to whole chunks.
+        uint32_t
+        GetBytesInUse () const;
+
     protected:
         uint32_t
         TotalChunks () const
@@ -166,6 +298,24 @@ namespace lldb_private {
         AllocatedMemoryCache (Process &process);
         
         ~AllocatedMemoryCache ();
+
+        struct BlockStatistics
+        {
+            lldb::addr_t addr;
+            uint32_t byte_size;
+            uint32_t bytes_in_use;
+            uint32_t permissions;
+        };
+
+        struct Statistics
+        {
+            uint64_t num_allocations;
+            uint64_t num_deallocations;
+            uint64_t num_process_allocations;   // blocks allocated in the process
+            uint64_t bytes_reserved;
+            uint64_t bytes_in_use;
+            std::vector<BlockStatistics> blocks;
+        };
         
         void
         Clear();
@@ -177,6 +327,9 @@ namespace lldb_private {
 
         bool
         DeallocateMemory (lldb::addr_t ptr);
+
+        Statistics
+        GetStatistics ();
         
     protected:
         typedef std::shared_ptr<AllocatedBlock> AllocatedBlockSP;
@@ -195,6 +348,9 @@ namespace lldb_private {
         std::recursive_mutex m_mutex;
         typedef std::multimap<uint32_t, AllocatedBlockSP> PermissionsToBlockMap;
         PermissionsToBlockMap m_memory_map;
+        uint64_t m_num_allocations;
+        uint64_t m_num_deallocations;
+        uint64_t m_num_process_allocations;
         
     private:
         DISALLOW_COPY_AND_ASSIGN (AllocatedMemoryCache);
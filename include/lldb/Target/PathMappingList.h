@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <mutex>
 #include <vector>
 // Other libraries and framework includes
 #include "lldb/Core/ConstString.h"
@@ -162,10 +163,33 @@ protected:
     const_iterator
     FindIteratorForPath (const ConstString &path) const;
 
+    // A node of the trie of the pair prefixes, the root is the empty prefix.
+    struct PrefixNode
+    {
+        std::vector<std::pair<char, uint32_t>> children; // The node index for each next character
+        uint32_t pair_idx; // The first pair whose prefix ends at this node, UINT32_MAX if none
+    };
+
+    // Rebuild the prefix trie and drop the remapped paths if the pairs
+    // changed. Must be called with m_index_mutex locked.
+    void
+    UpdateIndex () const;
+
+    // Get the indexes of the pairs whose prefix matches the start of \a
+    // path, in the order of m_pairs. Must be called with m_index_mutex
+    // locked.
+    void
+    FindPairIndexesForPath (const char *path, std::vector<uint32_t> &pair_indexes) const;
+
     collection m_pairs;
     ChangedCallback m_callback;
     void * m_callback_baton;
     uint32_t m_mod_id; // Incremented anytime anything is added or removed.
+    mutable std::mutex m_index_mutex;
+    mutable std::vector<PrefixNode> m_prefix_trie;
+    mutable std::map<const char *, ConstString> m_remapped_paths; // By ConstString pointer, empty if not remapped
+    mutable uint32_t m_index_mod_id; // The m_mod_id the trie and the remapped paths were made for
+    mutable bool m_index_valid;
 };
 
 } // namespace lldb_private
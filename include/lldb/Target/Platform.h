@@ -59,6 +59,21 @@ class ModuleCache;
         GetModuleCacheDirectory () const;
         bool
         SetModuleCacheDirectory (const FileSpec& dir_spec);
+
+        bool
+        GetLazySymbolDemangling () const;
+
+        bool
+        GetUseDemangledNameCache () const;
+
+        bool
+        GetUseDecompressedSectionCache () const;
+
+        bool
+        GetUseSymbolTableCache () const;
+
+        bool
+        GetUseObjCClassCache () const;
     };
 
     typedef std::shared_ptr<PlatformProperties> PlatformPropertiesSP;
@@ -18,7 +18,9 @@
 // C++ Includes
 #include <list>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_set>
 
@@ -109,6 +111,9 @@ public:
     bool
     GetWarningsOptimization () const;
 
+    bool
+    GetDisplacedStepping () const;
+
 protected:
     static void
     OptionValueChangedCallback (void *baton, OptionValue *option_value);
@@ -1158,6 +1163,26 @@ public:
        return 0;
     }
 
+    //------------------------------------------------------------------
+    /// Get the list of shared libraries the connection to the process
+    /// knows about, without loading them into the target.
+    ///
+    /// Dynamic loader plug-ins can compare the list with the one from the
+    /// previous shared library event and only load the modules that
+    /// changed.
+    ///
+    /// @param[out] list
+    ///     The loaded modules.
+    ///
+    /// @return
+    ///     An error if the process can't provide the list.
+    //------------------------------------------------------------------
+    virtual Error
+    GetLoadedModuleList (LoadedModuleInfoList &list)
+    {
+        return Error ("loaded module lists are not supported by this process");
+    }
+
 protected:
     virtual JITLoaderList &
     GetJITLoaders ();
@@ -1915,6 +1940,12 @@ public:
     virtual void
     ModulesDidLoad (ModuleList &module_list);
 
+    //------------------------------------------------------------------
+    /// Called by the target when modules were unloaded from the process.
+    //------------------------------------------------------------------
+    void
+    ModulesDidUnload (ModuleList &module_list);
+
     //------------------------------------------------------------------
     /// Retrieve the list of shared libraries that are loaded for this process
     /// 
@@ -1945,6 +1976,15 @@ public:
         return StructuredData::ObjectSP();
     }
 
+    //------------------------------------------------------------------
+    /// Add the numbers a process plug-in keeps about its connection, like
+    /// packet counts and round trip times, for "statistics dump".
+    //------------------------------------------------------------------
+    virtual void
+    GetStatistics (StructuredData::Dictionary &stats)
+    {
+    }
+
     //------------------------------------------------------------------
     /// Print a user-visible warning about a module being built with optimization
     ///
@@ -2065,6 +2105,49 @@ public:
     virtual bool
     IsAlive ();
 
+    //------------------------------------------------------------------
+    /// Check if this process is a running program rather than a
+    /// snapshot like a core file.
+    ///
+    /// @return
+    ///     Returns \b false if the memory and registers of the process
+    ///     can never change, \b true otherwise.
+    //------------------------------------------------------------------
+    virtual bool
+    IsLiveDebugSession () const
+    {
+        return true;
+    }
+
+    //------------------------------------------------------------------
+    /// Unwind the stacks of all threads up front.
+    ///
+    /// For processes that aren't live sessions the threads are unwound
+    /// in parallel on the TaskPool, later requests for their frames are
+    /// answered from the threads' stack frame lists. Live processes unwind
+    /// on demand as usual.
+    ///
+    /// @param[in] max_frames
+    ///     The number of frames to unwind per thread, UINT32_MAX for all.
+    //------------------------------------------------------------------
+    void
+    UnwindAllThreads (uint32_t max_frames);
+
+    //------------------------------------------------------------------
+    /// Write a crash triage record of the stopped process.
+    ///
+    /// The record holds the loaded modules and the symbolicated frames of
+    /// every thread, see TriageRecord for the layout.
+    ///
+    /// @param[in] file
+    ///     The file to write, it is overwritten if it exists.
+    ///
+    /// @param[in] max_frames
+    ///     The number of frames to save per thread, UINT32_MAX for all.
+    //------------------------------------------------------------------
+    Error
+    SaveTriageRecord (const FileSpec &file, uint32_t max_frames);
+
     //------------------------------------------------------------------
     /// Before lldb detaches from a process, it warns the user that they are about to lose their debug session.
     /// In some cases, this warning doesn't need to be emitted -- for instance, with core file debugging where 
@@ -2203,7 +2286,91 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
-    
+
+    //------------------------------------------------------------------
+    /// How many ReadMemoryFromInferior() calls are worth making from
+    /// different threads at the same time.
+    ///
+    /// Large reads like "memory read --stream" keep this many chunks in
+    /// flight. Plug-ins that can't read from several threads at once
+    /// return 1.
+    //------------------------------------------------------------------
+    virtual uint32_t
+    GetMaxConcurrentMemoryReads ()
+    {
+        return 1;
+    }
+
+    //------------------------------------------------------------------
+    /// Find the first occurrence of a byte pattern in memory.
+    ///
+    /// The memory is read in large chunks, memory regions that
+    /// GetMemoryRegionInfo() reports as unreadable are skipped.
+    /// Subclasses can override this to search on the remote side.
+    ///
+    /// @param[in] low
+    ///     The first address a match can start at.
+    ///
+    /// @param[in] high
+    ///     The end of the addresses a match can start at, a match may
+    ///     extend past it.
+    ///
+    /// @return
+    ///     The address of the match or LLDB_INVALID_ADDRESS.
+    //------------------------------------------------------------------
+    virtual lldb::addr_t
+    FindInMemory (lldb::addr_t low,
+                  lldb::addr_t high,
+                  const uint8_t *pattern,
+                  size_t pattern_size);
+
+    //------------------------------------------------------------------
+    /// Find the pointers to an address in the writable memory.
+    ///
+    /// The regions come from GetMemoryRegionInfo(), only the pointer
+    /// aligned words of readable and writable regions are compared.
+    /// Subclasses can override this to scan on the remote side.
+    ///
+    /// @param[in] value
+    ///     The address to find references to.
+    ///
+    /// @param[in] max_matches
+    ///     The scan stops after this many matches.
+    ///
+    /// @param[out] matches
+    ///     The addresses of the matching pointers, in ascending order.
+    //------------------------------------------------------------------
+    virtual Error
+    FindReferences (lldb::addr_t value, size_t max_matches, std::vector<lldb::addr_t> &matches);
+
+    //------------------------------------------------------------------
+    /// Describe where the memory at each address lives for "memory
+    /// find-refs": the symbol or section of a module, the frame whose
+    /// stack holds it, or nothing for the heap.
+    ///
+    /// The threads are unwound once for all the addresses.
+    //------------------------------------------------------------------
+    void
+    DescribeMemoryLocations (const std::vector<lldb::addr_t> &addrs, std::vector<std::string> &descriptions);
+
+    //------------------------------------------------------------------
+    /// Hint that memory is about to be read, so the memory cache can read
+    /// it together with the memory around it. Does nothing when the
+    /// memory cache is disabled.
+    //------------------------------------------------------------------
+    void
+    PrefetchMemory (lldb::addr_t vm_addr, size_t size);
+
+    //------------------------------------------------------------------
+    /// Get the hit rates and sizes of the memory cache, see "memory
+    /// stats".
+    //------------------------------------------------------------------
+    MemoryCache::Statistics
+    GetMemoryCacheStatistics ()
+    {
+        return m_memory_cache.GetStatistics();
+    }
+
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
     /// process memory.
@@ -2463,6 +2630,86 @@ public:
         error.SetErrorString ("Process::GetWatchpointSupportInfo() not supported");
         return error;
     }
+
+    //------------------------------------------------------------------
+    /// Start recording the branches a thread takes while it runs.
+    ///
+    /// @param[in] tid
+    ///     The protocol ID of the thread.
+    ///
+    /// @param[in] buffer_size
+    ///     How many bytes of trace to keep, only the most recent branches
+    ///     that fit are kept.
+    //------------------------------------------------------------------
+    virtual Error
+    StartBranchTrace (lldb::tid_t tid, size_t buffer_size)
+    {
+        return Error ("Process::StartBranchTrace() not supported");
+    }
+
+    virtual Error
+    StopBranchTrace (lldb::tid_t tid)
+    {
+        return Error ("Process::StopBranchTrace() not supported");
+    }
+
+    //------------------------------------------------------------------
+    /// Get the source and destination address of the branches a traced
+    /// thread took, the oldest one first.
+    //------------------------------------------------------------------
+    virtual Error
+    GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches)
+    {
+        branches.clear ();
+        return Error ("Process::GetBranchTrace() not supported");
+    }
+
+    //------------------------------------------------------------------
+    /// Save the state of the stopped process as a checkpoint.
+    ///
+    /// @param[out] checkpoint_id
+    ///     The ID to restore the checkpoint with.
+    //------------------------------------------------------------------
+    virtual Error
+    SaveCheckpoint (uint32_t &checkpoint_id)
+    {
+        return Error ("Process::SaveCheckpoint() not supported");
+    }
+
+    //------------------------------------------------------------------
+    /// Go back to a checkpoint. The process stops where the checkpoint
+    /// was saved, it can have a new process ID and new threads.
+    //------------------------------------------------------------------
+    virtual Error
+    RestoreCheckpoint (uint32_t checkpoint_id)
+    {
+        return Error ("Process::RestoreCheckpoint() not supported");
+    }
+
+    //------------------------------------------------------------------
+    /// Make the next resume a sampling run. All threads run and are
+    /// sampled \a frequency times a second until \a duration_ms
+    /// milliseconds have passed, then the process stops as if it was
+    /// interrupted. It stops earlier if a thread hits a breakpoint or
+    /// gets a signal.
+    //------------------------------------------------------------------
+    virtual Error
+    SampleNextResume (uint32_t duration_ms, uint32_t frequency)
+    {
+        return Error ("Process::SampleNextResume() not supported");
+    }
+
+    //------------------------------------------------------------------
+    /// Get the samples of the last sampling run. Each one is a thread ID
+    /// and the pc of the thread followed by the return addresses of its
+    /// callers, innermost first.
+    //------------------------------------------------------------------
+    virtual Error
+    GetSamples (std::vector<std::pair<lldb::tid_t, std::vector<lldb::addr_t>>> &samples)
+    {
+        samples.clear ();
+        return Error ("Process::GetSamples() not supported");
+    }
     
     lldb::ModuleSP
     ReadModuleFromMemory (const FileSpec& file_spec, 
@@ -2580,6 +2827,27 @@ public:
     //------------------------------------------------------------------
     Error
     DeallocateMemory (lldb::addr_t ptr);
+
+    //------------------------------------------------------------------
+    /// Get how much of the memory lldb allocated in the process is in
+    /// use, see "memory stats".
+    //------------------------------------------------------------------
+    AllocatedMemoryCache::Statistics
+    GetAllocatedMemoryStatistics ()
+    {
+        return m_allocated_memory_cache.GetStatistics();
+    }
+
+    //------------------------------------------------------------------
+    /// Load the library set in target.expr-helper-library into the
+    /// process, if there is one.
+    ///
+    /// This is only tried once per process (and once again after an
+    /// exec), utility functions call it before they compile themselves
+    /// so they can use the precompiled versions instead.
+    //------------------------------------------------------------------
+    void
+    LoadExpressionHelperLibrary ();
     
     //------------------------------------------------------------------
     /// Get any available STDOUT.
@@ -2715,6 +2983,28 @@ public:
         return error;
     }
 
+    //------------------------------------------------------------------
+    /// Called when the owners of an enabled breakpoint site, or the
+    /// conditions or ignore counts of those owners, change. Plug-ins that
+    /// hand breakpoint conditions to a remote stub use this to update them.
+    //------------------------------------------------------------------
+    virtual void
+    BreakpointSiteConditionsChanged (BreakpointSite *bp_site)
+    {
+    }
+
+    //------------------------------------------------------------------
+    /// Add the hits of counting breakpoints (see Breakpoint::SetCounting())
+    /// that were counted without stopping to the breakpoint hit counts.
+    /// Plug-ins that count hits in a remote stub fetch the counts here,
+    /// the process needs to be stopped for that. Hits that stop the
+    /// process are counted as usual.
+    //------------------------------------------------------------------
+    virtual void
+    UpdateBreakpointHitCounts ()
+    {
+    }
+
     // This is implemented completely using the lldb::Process API. Subclasses
     // don't need to implement this function unless the standard flow of
     // read existing opcode, write breakpoint opcode, verify breakpoint opcode
@@ -2758,6 +3048,75 @@ public:
                                    lldb::user_id_t owner_loc_id,
                                    lldb::BreakpointSiteSP &bp_site_sp);
 
+    //------------------------------------------------------------------
+    /// Enable or disable a batch of breakpoint sites.
+    ///
+    /// The default implementations call EnableBreakpointSite() or
+    /// DisableBreakpointSite() for each site. Plug-ins that can insert
+    /// many breakpoints with a single request should override them.
+    ///
+    /// @param[out] errors
+    ///     The result of enabling each of the sites, in the same order.
+    //------------------------------------------------------------------
+    virtual void
+    EnableBreakpointSites (const std::vector<lldb::BreakpointSiteSP> &bp_sites, std::vector<Error> &errors);
+
+    virtual void
+    DisableBreakpointSites (const std::vector<lldb::BreakpointSiteSP> &bp_sites);
+
+    //------------------------------------------------------------------
+    /// @class BreakpointSiteBatch
+    /// @brief Enable and disable breakpoint sites in batches.
+    ///
+    /// While one of these is alive, the breakpoint sites that the thread
+    /// that created it adds or removes are only collected. When the
+    /// outermost batch of the thread goes away, they are handed to
+    /// DisableBreakpointSites() and EnableBreakpointSites() at once.
+    /// Breakpoint resolution uses this so that a breakpoint with
+    /// thousands of locations is inserted with a few requests.
+    //------------------------------------------------------------------
+    class BreakpointSiteBatch
+    {
+    public:
+        BreakpointSiteBatch (const lldb::ProcessSP &process_sp);
+
+        ~BreakpointSiteBatch ();
+
+    private:
+        lldb::ProcessSP m_process_sp;   // Empty if this batch doesn't collect anything
+
+        DISALLOW_COPY_AND_ASSIGN (BreakpointSiteBatch);
+    };
+
+    //----------------------------------------------------------------------
+    // Displaced stepping
+    //
+    // A thread steps over a breakpoint by single stepping a copy of the
+    // original instruction in a scratch area, so the breakpoint stays
+    // inserted while the other threads run. The scratch area is the entry
+    // point of the executable, which doesn't run again once the process has
+    // started, and only one thread can use it at a time.
+    //----------------------------------------------------------------------
+
+    // Reserve the scratch area for an instruction of "size" bytes. Returns
+    // false if displaced stepping is disabled or unavailable, or another
+    // thread holds the scratch area.
+    bool
+    ReserveDisplacedStep (lldb::tid_t tid, size_t size);
+
+    void
+    ReleaseDisplacedStep (lldb::tid_t tid);
+
+    // Copy the instruction at "pc" to the reserved scratch area and point
+    // the PC of the thread at the copy.
+    Error
+    BeginDisplacedStep (Thread &thread, lldb::addr_t pc, const std::vector<uint8_t> &opcode);
+
+    // Called when the process stops. Moves the PC of the stepping thread
+    // back out of the scratch area and restores the contents of the area.
+    void
+    FinishDisplacedStep ();
+
     //----------------------------------------------------------------------
     // Process Watchpoints (optional)
     //----------------------------------------------------------------------
@@ -3156,6 +3515,33 @@ public:
     void
     ResetImageToken(size_t token);
 
+    //------------------------------------------------------------------
+    /// Fast tracepoints record registers at an address through a
+    /// trampoline in the inferior instead of stopping the process, see
+    /// FastTracepoint.
+    ///
+    /// @return
+    ///     The ID of the new tracepoint, or LLDB_INVALID_UID if it couldn't
+    ///     be installed.
+    //------------------------------------------------------------------
+    lldb::user_id_t
+    CreateFastTracepoint (lldb::addr_t addr, uint32_t capacity, Error &error);
+
+    Error
+    RemoveFastTracepoint (lldb::user_id_t id);
+
+    lldb::FastTracepointSP
+    GetFastTracepointByID (lldb::user_id_t id);
+
+    size_t
+    GetNumFastTracepoints () const
+    {
+        return m_fast_tracepoints.size();
+    }
+
+    lldb::FastTracepointSP
+    GetFastTracepointAtIndex (size_t idx);
+
     //------------------------------------------------------------------
     /// Find the next branch instruction to set a breakpoint on
     ///
@@ -3363,8 +3749,20 @@ protected:
     uint32_t                    m_queue_list_stop_id;   ///< The natural stop id when queue list was last fetched
     std::vector<Notifications>  m_notifications;        ///< The list of notifications that this process can deliver.
     std::vector<lldb::addr_t>   m_image_tokens;
+    std::vector<lldb::FastTracepointSP> m_fast_tracepoints;
+    lldb::user_id_t             m_next_fast_tracepoint_id;
+    bool                        m_expression_helper_library_attempted; ///< Whether target.expr-helper-library was loaded (or tried to be)
     lldb::ListenerSP            m_listener_sp;          ///< Shared pointer to the listener used for public events.  Can not be empty.
     BreakpointSiteList          m_breakpoint_site_list; ///< This is the list of breakpoint locations we intend to insert in the target.
+    std::mutex                  m_bp_site_batch_mutex;
+    std::thread::id             m_bp_site_batch_thread; ///< The thread with open BreakpointSiteBatches
+    uint32_t                    m_bp_site_batch_depth;
+    std::vector<lldb::BreakpointSiteSP> m_bp_sites_to_enable;   ///< New sites of the open batch
+    std::vector<lldb::BreakpointSiteSP> m_bp_sites_to_disable;  ///< Sites of the open batch that lost their last owner
+    lldb::tid_t                 m_displaced_step_tid;   ///< The thread that reserved the displaced stepping scratch area
+    lldb::addr_t                m_displaced_step_pc;    ///< The address of the instruction being displaced, LLDB_INVALID_ADDRESS if no step is active
+    lldb::addr_t                m_displaced_step_scratch_addr;
+    std::vector<uint8_t>        m_displaced_step_saved_bytes; ///< The original contents of the scratch area
     lldb::DynamicLoaderUP       m_dyld_ap;
     lldb::JITLoaderListUP       m_jit_loaders_ap;
     lldb::DynamicCheckerFunctionsUP m_dynamic_checkers_ap; ///< The functions used by the expression parser to validate data that expressions use.
@@ -3453,6 +3851,10 @@ private:
     lldb::thread_result_t
     RunPrivateStateThread (bool is_secondary_thread);
 
+    // True if the current thread has a BreakpointSiteBatch open.
+    bool
+    IsBatchingBreakpointSites ();
+
 protected:
     void
     HandlePrivateEvent (lldb::EventSP &event_sp);
@@ -3516,6 +3918,12 @@ protected:
     void
     LoadOperatingSystemPlugin(bool flush);
 
+    lldb::addr_t
+    GetDisplacedStepScratchAddress (size_t size);
+
+    void
+    RemoveAllFastTracepoints ();
+
 private:
     //------------------------------------------------------------------
     /// This is the part of the event handling that for a process event.
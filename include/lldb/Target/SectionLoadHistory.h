@@ -89,7 +89,7 @@ public:
 
 protected:
     
-    SectionLoadList *
+    lldb::SectionLoadListSP
     GetSectionLoadListForStopID (uint32_t stop_id, bool read_only);
 
     typedef std::map<uint32_t, lldb::SectionLoadListSP> StopIDToSectionLoadList;
@@ -13,7 +13,9 @@
 // C Includes
 // C++ Includes
 #include <map>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 // Other libraries and framework includes
 #include "llvm/ADT/DenseMap.h"
@@ -29,7 +31,7 @@ public:
     //------------------------------------------------------------------
     // Constructors and Destructors
     //------------------------------------------------------------------
-    SectionLoadList() : m_addr_to_sect(), m_sect_to_addr(), m_mutex() {}
+    SectionLoadList() : m_addr_to_sect(), m_sect_to_addr(), m_loaded_sections(), m_mutex() {}
 
     SectionLoadList (const SectionLoadList& rhs);
 
@@ -76,8 +78,32 @@ public:
 protected:
     typedef std::map<lldb::addr_t, lldb::SectionSP> addr_to_sect_collection;
     typedef llvm::DenseMap<const Section *, lldb::addr_t> sect_to_addr_collection;
+
+    //------------------------------------------------------------------
+    // A sorted copy of m_addr_to_sect that ResolveLoadAddress() searches
+    // without taking m_mutex. It is never modified once published: the
+    // functions that change the load list drop it and the next lookup
+    // builds a new one, so a batch of sections that gets loaded together
+    // only rebuilds it once. Copies of the list share it.
+    //------------------------------------------------------------------
+    struct LoadedSection
+    {
+        lldb::addr_t load_addr;
+        lldb::SectionSP section_sp;
+    };
+    typedef std::vector<LoadedSection> LoadedSectionArray;
+    typedef std::shared_ptr<const LoadedSectionArray> LoadedSectionArraySP;
+
+    LoadedSectionArraySP
+    GetLoadedSections () const;
+
+    // Must be called with m_mutex held after m_addr_to_sect changed.
+    void
+    InvalidateLoadedSections ();
+
     addr_to_sect_collection m_addr_to_sect;
     sect_to_addr_collection m_sect_to_addr;
+    mutable LoadedSectionArraySP m_loaded_sections; // Only accessed with std::atomic_load/std::atomic_store
     mutable std::recursive_mutex m_mutex;
 };
 
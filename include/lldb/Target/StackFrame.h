@@ -505,6 +505,12 @@ public:
 protected:
     friend class StackFrameList;
 
+    // Give a frame kept from the previous stop its place in the new frame
+    // list. The register context is made again when it is needed since the
+    // unwinder has been cleared.
+    void
+    UpdateFrameIndexForReuse (uint32_t frame_index, uint32_t concrete_frame_index);
+
     void
     SetSymbolContextScope (SymbolContextScope *symbol_scope);
 
@@ -104,6 +104,12 @@ protected:
 
     void
     GetFramesUpTo (uint32_t end_idx);
+
+    // If the concrete frame that was unwound at concrete_idx is still in
+    // the frames of the previous stop, append it and all its callers from
+    // there instead of unwinding them again.
+    bool
+    ReuseUnchangedFrames (uint32_t concrete_idx, lldb::addr_t cfa, lldb::addr_t pc);
     
     bool
     GetAllFramesFetched()
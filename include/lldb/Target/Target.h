@@ -12,9 +12,11 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -27,8 +29,10 @@
 #include "lldb/Core/Broadcaster.h"
 #include "lldb/Core/Disassembler.h"
 #include "lldb/Core/ModuleList.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Core/UserSettingsController.h"
 #include "lldb/Expression/Expression.h"
+#include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/ExecutionContextScope.h"
 #include "lldb/Target/PathMappingList.h"
@@ -141,6 +145,18 @@ public:
 
     FileSpecList &
     GetDebugFileSearchPaths ();
+
+    bool
+    GetUseDebugFileIndex () const;
+
+    bool
+    GetPreloadSymbols () const;
+
+    uint64_t
+    GetDebugInfoMemoryBudget () const;
+
+    bool
+    GetSymbolServerURLs (Args &urls) const;
     
     FileSpecList &
     GetClangModuleSearchPaths ();
@@ -153,6 +169,9 @@ public:
     
     bool
     GetEnableNotifyAboutFixIts () const;
+
+    bool
+    GetWarmUpExpressionParser () const;
     
     bool
     GetEnableSyntheticValue () const;
@@ -193,6 +212,9 @@ public:
     const char *
     GetExpressionPrefixContentsAsCString ();
 
+    FileSpec
+    GetExpressionHelperLibrary () const;
+
     bool
     GetUseHexImmediates() const;
 
@@ -277,6 +299,7 @@ public:
         m_stop_others (true),
         m_debug (false),
         m_trap_exceptions (true),
+        m_light_call (false),
         m_generate_debug_info (false),
         m_result_is_internal (false),
         m_auto_apply_fixits (true),
@@ -484,6 +507,31 @@ public:
     {
         m_trap_exceptions = b;
     }
+
+    bool
+    GetLightCall () const
+    {
+        return m_light_call;
+    }
+
+    //------------------------------------------------------------------
+    /// A light call only runs the calling thread and returns to a
+    /// breakpoint that the target keeps between calls, instead of
+    /// setting and removing one around every call.  This is meant for
+    /// tools that call into the inferior over and over.  Turning it on
+    /// also stops the other threads and doesn't try all threads after
+    /// the one thread timeout.
+    //------------------------------------------------------------------
+    void
+    SetLightCall (bool b = true)
+    {
+        m_light_call = b;
+        if (m_light_call)
+        {
+            m_stop_others = true;
+            m_try_others = false;
+        }
+    }
     
     bool
     GetREPLEnabled() const
@@ -575,6 +623,7 @@ private:
     bool m_stop_others;
     bool m_debug;
     bool m_trap_exceptions;
+    bool m_light_call;
     bool m_repl;
     bool m_generate_debug_info;
     bool m_ansi_color_errors;
@@ -826,6 +875,21 @@ public:
                       bool internal,
                       bool request_hardware);
 
+    //------------------------------------------------------------------
+    /// Get the internal breakpoint that light function calls return to.
+    ///
+    /// The breakpoint is created the first time and kept until the
+    /// process goes away, so repeated calls don't have to insert and
+    /// remove it.  It only stops threads that are running a function
+    /// call.
+    ///
+    /// @param[in] addr
+    ///     The return address of the calls, if it changes the old
+    ///     breakpoint is removed.
+    //------------------------------------------------------------------
+    lldb::BreakpointSP
+    GetFunctionCallReturnBreakpoint (const Address &addr);
+
     // Use this to create a function breakpoint by regexp in containingModule/containingSourceFiles, or all modules if it is nullptr
     // When "skip_prologue is set to eLazyBoolCalculate, we use the current target 
     // setting, else we use the values passed in
@@ -1007,6 +1071,25 @@ public:
     void
     ModulesDidLoad (ModuleList &module_list);
 
+    //------------------------------------------------------------------
+    /// Stop calling ModulesDidLoad() for each module that is added to
+    /// the image list.
+    ///
+    /// Dynamic loaders that load many modules at once set this while they
+    /// load them, and then call ModulesDidLoad() once with all of them so
+    /// that breakpoints are resolved in one pass.
+    ///
+    /// @return
+    ///     The previous value, to restore when done.
+    //------------------------------------------------------------------
+    bool
+    SetDeferModuleLoadNotifications (bool defer)
+    {
+        bool old_value = m_defer_module_load_notifications;
+        m_defer_module_load_notifications = defer;
+        return old_value;
+    }
+
     void
     ModulesDidUnload (ModuleList &module_list, bool delete_locations);
     
@@ -1287,6 +1370,15 @@ public:
     PathMappingList &
     GetImageSearchPathList ();
     
+    //------------------------------------------------------------------
+    /// Get the type system that expressions and their results use.
+    ///
+    /// Each target has its own scratch type system, it holds persistent
+    /// variables and the types copied in by expressions. The type
+    /// systems of the modules are not per target, targets that load the
+    /// same files get the same Module objects from the shared module
+    /// list and so share the parsed debug info and its types.
+    //------------------------------------------------------------------
     TypeSystem *
     GetScratchTypeSystemForLanguage (Error *error, lldb::LanguageType language, bool create_on_demand = true);
     
@@ -1350,6 +1442,25 @@ public:
     ResolveLoadAddress (lldb::addr_t load_addr,
                         Address &so_addr,
                         uint32_t stop_id = SectionLoadHistory::eStopIDNow);
+
+    //------------------------------------------------------------------
+    /// Resolve the symbol contexts of many load addresses at once.
+    ///
+    /// The addresses are grouped by module, and each module resolves its
+    /// addresses in address order on the task pool. An address that is
+    /// in the same line table entry, block, function and symbol as the
+    /// one before it gets a copy of its symbol context.
+    ///
+    /// @param[out] sc_list
+    ///     Gets one symbol context per address, in the order of
+    ///     \a load_addrs. The ones of addresses that aren't in a module
+    ///     are empty.
+    //------------------------------------------------------------------
+    void
+    ResolveLoadAddresses (const lldb::addr_t *load_addrs,
+                          size_t num_addrs,
+                          uint32_t resolve_scope,
+                          SymbolContextList &sc_list);
     
     bool
     SetSectionLoadAddress (const lldb::SectionSP &section,
@@ -1571,6 +1682,133 @@ public:
     void
     SetREPL (lldb::LanguageType language, lldb::REPLSP repl_sp);
 
+    //------------------------------------------------------------------
+    /// How the expressions of this target were run: interpreted in lldb
+    /// or JIT compiled and run in the inferior, and how long evaluating
+    /// them took from start to finish.
+    //------------------------------------------------------------------
+    struct ExpressionStatistics
+    {
+        uint64_t num_interpreted;
+        uint64_t num_jitted;
+        // The reasons expressions couldn't be interpreted, and how often.
+        std::map<std::string, uint64_t> jit_reasons;
+        uint64_t num_evaluations;
+        uint64_t num_failed_evaluations;
+        uint64_t total_evaluation_nanos;
+        uint64_t max_evaluation_nanos;
+
+        ExpressionStatistics () :
+            num_interpreted (0),
+            num_jitted (0),
+            jit_reasons (),
+            num_evaluations (0),
+            num_failed_evaluations (0),
+            total_evaluation_nanos (0),
+            max_evaluation_nanos (0)
+        {
+        }
+    };
+
+    void
+    RecordExpressionInterpreted ();
+
+    void
+    RecordExpressionJITed (const char *reason);
+
+    void
+    RecordExpressionEvaluation (bool success, uint64_t nanos);
+
+    ExpressionStatistics
+    GetExpressionStatistics ();
+
+    void
+    ClearExpressionStatistics ();
+
+    //------------------------------------------------------------------
+    /// Gather where the time and memory of this target went, for
+    /// "statistics dump" and SBTarget::GetStatistics().
+    ///
+    /// Only looks at what was already parsed, this doesn't parse any
+    /// symbol tables or debug info.
+    //------------------------------------------------------------------
+    StructuredData::ObjectSP
+    GetStatistics ();
+
+    //------------------------------------------------------------------
+    /// If the parsed debug info of the target's modules uses more than
+    /// target.debug-info-memory-budget, release what can be parsed again
+    /// from the modules no thread is stopped in, biggest first, until it
+    /// fits. This runs when the process stops.
+    ///
+    /// @return
+    ///     The number of bytes that were released.
+    //------------------------------------------------------------------
+    size_t
+    EnforceDebugInfoMemoryBudget ();
+
+    //------------------------------------------------------------------
+    /// Parsed user expressions are cached, so expressions that are
+    /// evaluated over and over, like IDE watch expressions, only go
+    /// through Clang and the JIT once for each block they are evaluated
+    /// in. The cache is cleared whenever modules are loaded or unloaded.
+    ///
+    /// @param[in] key
+    ///     The expression text and everything else it was parsed with,
+    ///     see UserExpression::Evaluate.
+    ///
+    /// @return
+    ///     A parsed expression for the key that can run in exe_ctx, or
+    ///     an empty shared pointer.
+    //------------------------------------------------------------------
+    lldb::UserExpressionSP
+    FindCachedUserExpression (const std::string &key, ExecutionContext &exe_ctx);
+
+    void
+    CacheUserExpression (const std::string &key, const lldb::UserExpressionSP &user_expression_sp);
+
+    void
+    ClearUserExpressionCache ();
+
+    //------------------------------------------------------------------
+    /// Create the scratch AST, the modules decl vendor and whatever else
+    /// the first expression for this target would have to set up, on a
+    /// background thread.
+    ///
+    /// Called when modules are loaded and when the process resumes, so
+    /// the work is done while the process runs and not after it stops.
+    /// Does nothing if target.warm-up-expression-parser is false.
+    //------------------------------------------------------------------
+    void
+    WarmUpExpressionParser ();
+
+    //------------------------------------------------------------------
+    /// Look a name up in the global scope of all the target's modules,
+    /// the way the expression parser does for each identifier it doesn't
+    /// know.
+    ///
+    /// The same names (e.g. "printf" or "size_t") come up in almost every
+    /// expression, and most of them are found in few or none of the
+    /// modules. The results, including not finding anything, are kept
+    /// until modules are added, removed or replaced or get new symbols.
+    ///
+    /// Variables are looked up with ModuleList::FindGlobalVariables, the
+    /// functions and symbols with ModuleList::FindFunctions for full names
+    /// without inlines, and the first type that isn't an exact match with
+    /// ModuleList::FindTypes. The results are appended.
+    //------------------------------------------------------------------
+    void
+    FindGlobalVariablesForExpressions (const ConstString &name, VariableList &variables);
+
+    void
+    FindFunctionsForExpressions (const ConstString &name, SymbolContextList &sc_list);
+
+    void
+    FindFirstTypeForExpressions (const ConstString &name, TypeList &types);
+
+    void
+    ClearGlobalLookupCache ();
+
 protected:
     //------------------------------------------------------------------
     /// Implementing of ModuleList::Notifier.
@@ -1604,6 +1842,7 @@ protected:
     lldb::BreakpointSP m_last_created_breakpoint;
     WatchpointList  m_watchpoint_list;
     lldb::WatchpointSP m_last_created_watchpoint;
+    lldb::BreakpointSP m_function_call_return_bp_sp; ///< Where light function calls return, see GetFunctionCallReturnBreakpoint()
     // We want to tightly control the process destruction process so
     // we can correctly tear down everything that we need to, so the only
     // class that knows about the process lifespan is this target class.
@@ -1625,7 +1864,35 @@ protected:
     lldb::user_id_t         m_stop_hook_next_id;
     bool                    m_valid;
     bool                    m_suppress_stop_hooks;
+    bool                    m_defer_module_load_notifications;
     bool                    m_is_dummy_target;
+    std::mutex              m_expression_stats_mutex;
+    ExpressionStatistics    m_expression_stats;
+    typedef std::list<std::pair<std::string, lldb::UserExpressionSP>> UserExpressionCache;
+    std::mutex              m_user_expression_cache_mutex;
+    UserExpressionCache     m_user_expression_cache;    ///< Most recently used first
+    std::atomic<bool>       m_expression_parser_warm_up_pending;
+
+    struct GlobalLookup
+    {
+        GlobalLookup () :
+            variables_valid (false),
+            functions_valid (false),
+            types_valid (false)
+        {
+        }
+
+        bool variables_valid;
+        bool functions_valid;
+        bool types_valid;
+        std::vector<lldb::VariableSP> variables;
+        SymbolContextList functions;
+        std::vector<lldb::TypeSP> types;
+    };
+    typedef std::map<const char *, GlobalLookup> GlobalLookupCache; ///< Keyed by ConstString
+    std::mutex              m_global_lookup_cache_mutex;
+    GlobalLookupCache       m_global_lookup_cache;
+    uint32_t                m_global_lookup_cache_generation; ///< Bumped by ClearGlobalLookupCache
     
     static void
     ImageSearchPathsChanged (const PathMappingList &path_list,
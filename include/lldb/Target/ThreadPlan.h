@@ -599,6 +599,11 @@ protected:
     {
         m_thread.SetStopInfo (stop_reason_sp);
     }
+
+    // Get the CFA of frame zero straight from the unwinder, without making
+    // the thread's stack frames.
+    bool
+    GetFrameZeroCFA (lldb::addr_t &cfa);
     
     void
     CachePlanExplainsStop (bool does_explain)
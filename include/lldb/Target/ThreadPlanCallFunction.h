@@ -164,6 +164,7 @@ protected:
     bool                                            m_ignore_breakpoints;
     bool                                            m_debug_execution;
     bool                                            m_trap_exceptions;
+    bool                                            m_light_call;       // Return to the target's function call return breakpoint instead of a subplan.
     Address                                         m_function_addr;
     Address                                         m_start_addr;
     lldb::addr_t                                    m_function_sp;
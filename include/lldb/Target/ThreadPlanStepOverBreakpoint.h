@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Target/Thread.h"
@@ -33,6 +35,7 @@ public:
     lldb::StateType GetPlanRunState() override;
     bool WillStop() override;
     bool MischiefManaged() override;
+    void WillPop() override;
     void ThreadDestroyed() override;
     void SetAutoContinue(bool do_it);
     bool ShouldAutoContinue(Event *event_ptr) override;
@@ -49,12 +52,20 @@ protected:
     bool DoWillResume(lldb::StateType resume_state, bool current_plan) override;
 
     void ReenableBreakpointSite ();
+
+    // Returns the instruction at the breakpoint if it can run out of line,
+    // i.e. it doesn't branch or otherwise depend on the PC.
+    bool GetDisplaceableOpcode (std::vector<uint8_t> &opcode);
+
+    void ReleaseDisplacedStep ();
 private:
 
     lldb::addr_t m_breakpoint_addr;
     lldb::user_id_t m_breakpoint_site_id;
     bool m_auto_continue;
     bool m_reenabled_breakpoint_site;
+    bool m_use_displaced_step; // Step a copy of the instruction and leave the breakpoint inserted
+    std::vector<uint8_t> m_displaced_opcode;
 
     DISALLOW_COPY_AND_ASSIGN (ThreadPlanStepOverBreakpoint);
 };
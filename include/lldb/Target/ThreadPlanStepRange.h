@@ -48,8 +48,19 @@ public:
 
     void AddRange(const AddressRange &new_range);
 
+    // Get the load address range of the step range the pc is in, so a stub
+    // that can step through a range on its own only stops when the pc leaves
+    // it. Returns false if the pc isn't in any of the ranges.
+    bool GetSteppingRange(lldb::addr_t &start, lldb::addr_t &end);
+
 protected:
     bool InRange();
+
+    // A cheap check for the usual stop of a step, still in one of the ranges
+    // and in the frame the step started in. It only uses the pc and the CFA
+    // of frame zero, so no stack frames or symbol contexts are made.
+    bool InRangeOfStartFrame();
+
     lldb::FrameComparison CompareCurrentFrameToStartFrame();
     bool InSymbol();
     void DumpRanges (Stream *s);
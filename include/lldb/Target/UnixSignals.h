@@ -14,6 +14,7 @@
 // C++ Includes
 #include <string>
 #include <map>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -101,6 +102,26 @@ public:
     ConstString
     GetShortName(ConstString name) const;
 
+    //------------------------------------------------------------------
+    /// Get the signals whose suppress, stop and notify settings all have
+    /// the given values, e.g. the signals a debug server can pass to the
+    /// process itself without telling the debugger.
+    //------------------------------------------------------------------
+    std::vector<int32_t>
+    GetFilteredSignals (bool should_suppress,
+                        bool should_stop,
+                        bool should_notify) const;
+
+    //------------------------------------------------------------------
+    /// Get a number that changes every time a signal is added, removed
+    /// or has its settings changed.
+    //------------------------------------------------------------------
+    uint64_t
+    GetVersion () const
+    {
+        return m_version;
+    }
+
     // We assume that the elements of this object are constant once it is constructed,
     // since a process should never need to add or remove symbols as it runs.  So don't
     // call these functions anywhere but the constructor of your subclass of UnixSignals or in
@@ -149,6 +170,8 @@ protected:
 
     collection m_signals;
 
+    uint64_t m_version;
+
     // GDBRemote signals need to be copyable.
     UnixSignals(const UnixSignals &rhs);
 
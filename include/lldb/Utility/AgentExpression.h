@@ -0,0 +1,147 @@
+//===-- AgentExpression.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_AgentExpression_h_
+#define utility_AgentExpression_h_
+
+// C Includes
+// C++ Includes
+#include <functional>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class AgentExpression AgentExpression.h "lldb/Utility/AgentExpression.h"
+/// @brief The bytecode of the GDB remote protocol agent expressions.
+///
+/// Agent expressions are small stack machine programs a debugger can hand
+/// to a remote stub, e.g. as the condition of a breakpoint ("Z0" packets
+/// with a ";X<len>,<bytes>" condition list). The stub evaluates them
+/// without talking to the debugger. Only the integer subset of the
+/// bytecode is supported, see the "Agent Expressions" appendix of the GDB
+/// manual for the semantics of each opcode.
+//----------------------------------------------------------------------
+class AgentExpression
+{
+public:
+    enum Opcode
+    {
+        eOpcodeAdd          = 0x02,
+        eOpcodeSub          = 0x03,
+        eOpcodeMul          = 0x04,
+        eOpcodeDivSigned    = 0x05,
+        eOpcodeDivUnsigned  = 0x06,
+        eOpcodeRemSigned    = 0x07,
+        eOpcodeRemUnsigned  = 0x08,
+        eOpcodeLsh          = 0x09,
+        eOpcodeRshSigned    = 0x0a,
+        eOpcodeRshUnsigned  = 0x0b,
+        eOpcodeLogNot       = 0x0e,
+        eOpcodeBitAnd       = 0x0f,
+        eOpcodeBitOr        = 0x10,
+        eOpcodeBitXor       = 0x11,
+        eOpcodeBitNot       = 0x12,
+        eOpcodeEqual        = 0x13,
+        eOpcodeLessSigned   = 0x14,
+        eOpcodeLessUnsigned = 0x15,
+        eOpcodeExt          = 0x16,
+        eOpcodeRef8         = 0x17,
+        eOpcodeRef16        = 0x18,
+        eOpcodeRef32        = 0x19,
+        eOpcodeRef64        = 0x1a,
+        eOpcodeIfGoto       = 0x20,
+        eOpcodeGoto         = 0x21,
+        eOpcodeConst8       = 0x22,
+        eOpcodeConst16      = 0x23,
+        eOpcodeConst32      = 0x24,
+        eOpcodeConst64      = 0x25,
+        eOpcodeReg          = 0x26,
+        eOpcodeEnd          = 0x27,
+        eOpcodeDup          = 0x28,
+        eOpcodePop          = 0x29,
+        eOpcodeZeroExt      = 0x2a,
+        eOpcodeSwap         = 0x2b,
+        eOpcodePick         = 0x32,
+        eOpcodeRot          = 0x33
+    };
+
+    // Reads the value of the register with the given stub register number.
+    typedef std::function<bool (uint32_t reg_num, uint64_t &value)> ReadRegisterCallback;
+
+    // Reads "size" bytes (1, 2, 4 or 8) of target memory as an integer in
+    // the target byte order.
+    typedef std::function<bool (lldb::addr_t addr, size_t size, uint64_t &value)> ReadMemoryCallback;
+
+    AgentExpression ();
+
+    AgentExpression (const uint8_t *bytes, size_t length);
+
+    const std::vector<uint8_t> &
+    GetBytes () const
+    {
+        return m_bytes;
+    }
+
+    bool
+    IsEmpty () const
+    {
+        return m_bytes.empty();
+    }
+
+    //------------------------------------------------------------------
+    // Helpers for building an expression.
+    //------------------------------------------------------------------
+    void
+    AppendOpcode (Opcode opcode);
+
+    // Appends an opcode that takes a one byte operand (ext, zero_ext, pick).
+    void
+    AppendOpcode (Opcode opcode, uint8_t operand);
+
+    // Pushes "value" using the smallest const opcode that can hold it.
+    void
+    AppendConstant (uint64_t value);
+
+    void
+    AppendRegister (uint32_t reg_num);
+
+    //------------------------------------------------------------------
+    /// Run the expression.
+    ///
+    /// @param[in] read_register
+    ///     Called for each "reg" opcode.
+    ///
+    /// @param[in] read_memory
+    ///     Called for each "ref" opcode.
+    ///
+    /// @param[out] result
+    ///     The value on top of the stack when the "end" opcode is reached.
+    ///
+    /// @return
+    ///     An error if the expression is malformed, uses an unsupported
+    ///     opcode or fails to read a register or memory.
+    //------------------------------------------------------------------
+    Error
+    Evaluate (const ReadRegisterCallback &read_register,
+              const ReadMemoryCallback &read_memory,
+              uint64_t &result) const;
+
+private:
+    std::vector<uint8_t> m_bytes;
+};
+
+} // namespace lldb_private
+
+#endif // utility_AgentExpression_h_
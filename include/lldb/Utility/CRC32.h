@@ -0,0 +1,47 @@
+//===-- CRC32.h -------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_CRC32_h_
+#define utility_CRC32_h_
+
+// C Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// Continue the CRC-32 (the one of zlib and .gnu_debuglink) \a crc
+/// with \a length more bytes. Start with a \a crc of 0.
+//----------------------------------------------------------------------
+uint32_t
+CRC32 (uint32_t crc, const void *data, size_t length);
+
+//----------------------------------------------------------------------
+/// Given the CRC-32 \a crc1 of a first block of data and \a crc2 of a
+/// second block of \a length2 bytes, return the CRC-32 of the two
+/// blocks one after the other.
+//----------------------------------------------------------------------
+uint32_t
+CRC32Combine (uint32_t crc1, uint32_t crc2, uint64_t length2);
+
+//----------------------------------------------------------------------
+/// Same as CRC32(), but large blocks are split in chunks that are
+/// checksummed on the task pool and combined.
+//----------------------------------------------------------------------
+uint32_t
+CRC32Parallel (uint32_t crc, const void *data, size_t length);
+
+} // namespace lldb_private
+
+#endif // utility_CRC32_h_
@@ -0,0 +1,50 @@
+//===-- HexEncoding.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_HexEncoding_h_
+#define utility_HexEncoding_h_
+
+// C Includes
+#include <stddef.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+// Conversion of bytes to and from pairs of ASCII hex digits, the way
+// memory and register contents are sent in gdb-remote packets. Large
+// buffers are converted 16 bytes at a time with SSE2 or NEON where the
+// host has them.
+//----------------------------------------------------------------------
+
+//----------------------------------------------------------------------
+/// Write \a length bytes as 2 * \a length lowercase hex digits, the
+/// high nibble of each byte first. \a dst is not NULL terminated.
+//----------------------------------------------------------------------
+void
+HexEncode (const void *src, size_t length, char *dst);
+
+//----------------------------------------------------------------------
+/// Decode up to \a length bytes from 2 * \a length hex digits of either
+/// case.
+///
+/// @return
+///     The number of bytes decoded, which is less than \a length if a
+///     character that isn't a hex digit was found. The bytes before it
+///     are decoded.
+//----------------------------------------------------------------------
+size_t
+HexDecode (const char *src, size_t length, void *dst);
+
+} // namespace lldb_private
+
+#endif // utility_HexEncoding_h_
@@ -20,6 +20,8 @@
 #include <string>
 #include <vector>
 
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Casting.h"
 
 namespace lldb_private {
@@ -356,6 +358,128 @@ namespace lldb_private {
         JSONValue::SP
         ParseJSONArray ();
     };
+
+    //----------------------------------------------------------------------
+    /// @class JSONPullParser JSON.h "lldb/Utility/JSON.h"
+    /// @brief Reads JSON text one event at a time without building a tree.
+    ///
+    /// Keys, strings and numbers are returned as references into the text,
+    /// which has to outlive the parser. Strings that contain escapes are
+    /// unescaped into a buffer of the parser that the next event reuses.
+    //----------------------------------------------------------------------
+    class JSONPullParser
+    {
+    public:
+        enum class Event
+        {
+            Error,
+            ObjectStart,
+            ObjectEnd,
+            ArrayStart,
+            ArrayEnd,
+            Key,
+            String,
+            Integer,
+            Float,
+            True,
+            False,
+            Null,
+            EndOfFile
+        };
+
+        JSONPullParser (llvm::StringRef text);
+
+        //------------------------------------------------------------------
+        /// Read the next event. Once an error is found every following
+        /// call returns Event::Error. The text after the first complete
+        /// value is ignored.
+        //------------------------------------------------------------------
+        Event
+        Next ();
+
+        //------------------------------------------------------------------
+        /// Skip the value whose first event Next() returned last, including
+        /// the contents of an object or array.
+        ///
+        /// @return
+        ///     False if the value isn't valid JSON.
+        //------------------------------------------------------------------
+        bool
+        SkipValue ();
+
+        // The key or string of the last event, or the text of its number.
+        llvm::StringRef
+        GetValue () const
+        {
+            return m_value;
+        }
+
+        uint64_t
+        GetValueAsUnsigned (uint64_t fail_value) const;
+
+        int64_t
+        GetValueAsSigned (int64_t fail_value) const;
+
+        // The offset in the text at which the last event starts.
+        size_t
+        GetEventOffset () const
+        {
+            return m_event_offset;
+        }
+
+        //------------------------------------------------------------------
+        /// Start over at \a offset as if the text started with the value
+        /// there, usually the offset of an earlier event.
+        //------------------------------------------------------------------
+        void
+        SetOffset (size_t offset);
+
+    private:
+        enum class State
+        {
+            Value,          // Any value
+            FirstKey,       // A key or the end of an object
+            Key,            // A key after a comma
+            FirstElement,   // A value or the end of an array
+            Separator,      // A comma or the end of the open object or array
+            Done,           // After the top level value
+            Error
+        };
+
+        Event
+        ReadValue ();
+
+        Event
+        ReadString (Event event);
+
+        Event
+        ReadNumber ();
+
+        Event
+        ReadLiteral (llvm::StringRef literal, Event event);
+
+        Event
+        CloseContainer (char ch);
+
+        Event
+        EndValue (Event event);
+
+        Event
+        SetError ();
+
+        void
+        SkipSpaces ();
+
+        llvm::StringRef m_text;
+        size_t m_index;
+        size_t m_event_offset;
+        State m_state;
+        Event m_event;
+        llvm::StringRef m_value;
+        std::string m_unescaped;
+        llvm::SmallVector<char, 8> m_containers; // '{' or '[' for each open object and array
+    };
+
 } // namespace lldb_private
 
 #endif // utility_JSON_h_
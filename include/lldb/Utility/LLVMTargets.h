@@ -0,0 +1,24 @@
+//===-- LLVMTargets.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_LLVMTargets_h_
+#define utility_LLVMTargets_h_
+
+namespace lldb_private {
+
+    // Register all of the LLVM targets, their MC layers, asm printers and
+    // disassemblers. This is done the first time something needs them (the
+    // disassembler, the x86 unwinder or the expression JIT) instead of when
+    // lldb starts, and only once no matter how often it is called.
+    void
+    InitializeLLVMTargets ();
+
+}
+
+#endif // utility_LLVMTargets_h_
@@ -0,0 +1,118 @@
+//===-- MemorySearch.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_MemorySearch_h_
+#define utility_MemorySearch_h_
+
+// C Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// C++ Includes
+#include <functional>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-enumerations.h"
+#include "lldb/lldb-types.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class MemorySearch MemorySearch.h "lldb/Utility/MemorySearch.h"
+/// @brief Finds a byte pattern in the memory of a process.
+///
+/// The memory is read in large chunks that overlap by the size of the
+/// pattern minus one, so matches that straddle two chunks are found.
+/// Memory the region callback reports as unreadable is skipped instead
+/// of ending the search. Both the debugger (Process::FindInMemory) and
+/// lldb-server (qSearch:memory) search this way.
+//----------------------------------------------------------------------
+class MemorySearch
+{
+public:
+    static const size_t kDefaultChunkSize = 256 * 1024;
+
+    // Reads up to "size" bytes at "addr" and returns how many bytes were
+    // read, a short read means the memory after them couldn't be read.
+    typedef std::function<size_t (lldb::addr_t addr, void *buf, size_t size)> ReadMemoryCallback;
+
+    // Returns false if nothing is known about the memory at "addr".
+    // Otherwise "region_end" is the end of the region that contains "addr"
+    // and "readable" says whether it can be read.
+    typedef std::function<bool (lldb::addr_t addr, lldb::addr_t &region_end, bool &readable)> RegionInfoCallback;
+
+    //------------------------------------------------------------------
+    /// Find the first occurrence of a pattern in a buffer.
+    ///
+    /// Candidates are found with memchr() on the first byte of the
+    /// pattern, the C library has vectorized versions of it on every
+    /// host lldb supports.
+    ///
+    /// @return
+    ///     A pointer to the match or nullptr.
+    //------------------------------------------------------------------
+    static const uint8_t *
+    FindInBuffer (const uint8_t *buf, size_t buf_size, const uint8_t *pattern, size_t pattern_size);
+
+    //------------------------------------------------------------------
+    /// Find the first match that starts in [low, high).
+    ///
+    /// A match may end past \a high, like the byte by byte search the
+    /// "memory find" command used to do.
+    ///
+    /// @param[in] region_info
+    ///     May be empty, then the search ends at the first memory that
+    ///     can't be read.
+    ///
+    /// @return
+    ///     The address of the match or LLDB_INVALID_ADDRESS.
+    //------------------------------------------------------------------
+    static lldb::addr_t
+    Find (lldb::addr_t low,
+          lldb::addr_t high,
+          const uint8_t *pattern,
+          size_t pattern_size,
+          const ReadMemoryCallback &read_memory,
+          const RegionInfoCallback &region_info,
+          size_t chunk_size = kDefaultChunkSize);
+
+    //------------------------------------------------------------------
+    /// Find the pointers to \a value in [low, high).
+    ///
+    /// Only the pointer aligned words are compared, the comparison loop
+    /// is simple enough for the compiler to vectorize. Memory that can't
+    /// be read is skipped a chunk at a time.
+    ///
+    /// @param[in] pointer_size
+    ///     4 or 8.
+    ///
+    /// @param[in] max_matches
+    ///     The scan stops once \a matches has this many entries.
+    ///
+    /// @return
+    ///     The address the scan stopped at, \a high if it got to the end
+    ///     of the range. The scan can be resumed from there.
+    //------------------------------------------------------------------
+    static lldb::addr_t
+    FindPointers (lldb::addr_t low,
+                  lldb::addr_t high,
+                  uint64_t value,
+                  uint32_t pointer_size,
+                  lldb::ByteOrder byte_order,
+                  const ReadMemoryCallback &read_memory,
+                  size_t max_matches,
+                  std::vector<lldb::addr_t> &matches,
+                  size_t chunk_size = kDefaultChunkSize);
+};
+
+} // namespace lldb_private
+
+#endif // utility_MemorySearch_h_
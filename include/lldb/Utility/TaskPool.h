@@ -26,10 +26,13 @@
 #pragma warning(disable:4062)
 #endif
 
+#include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <future>
 #include <list>
+#include <memory>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -39,15 +42,32 @@
 // and about what tasks will run in parrallel. None of the task added to the task pool should block
 // on something (mutex, future, condition variable) what will be set only by the completion of an
 // other task on the task pool as they may run on the same thread sequentally.
+//
+// Every worker thread has its own task queue and idle workers steal tasks from the queues of the
+// other workers, so adding and running tasks doesn't serialize on a single lock. Pending tasks with
+// a higher priority are always started before pending tasks with a lower priority.
 class TaskPool
 {
 public:
+    enum Priority
+    {
+        ePriorityHigh = 0,  // Work an user is waiting for
+        ePriorityNormal,
+        ePriorityLow        // Background work that should yield to everything else
+    };
+
     // Add a new task to the task pool and return a std::future belonging to the newly created task.
     // The caller of this function has to wait on the future for this task to complete.
     template<typename F, typename... Args>
     static std::future<typename std::result_of<F(Args...)>::type>
     AddTask(F&& f, Args&&... args);
 
+    // Same as AddTask but the task will be scheduled with the given priority instead of
+    // ePriorityNormal.
+    template<typename F, typename... Args>
+    static std::future<typename std::result_of<F(Args...)>::type>
+    AddTaskWithPriority(Priority priority, F&& f, Args&&... args);
+
     // Run all of the specified tasks on the task pool and wait until all of them are finished
     // before returning. This method is intended to be used for small number tasks where listing
     // them as function arguments is acceptable. For running large number of tasks you should use
@@ -63,7 +83,35 @@ private:
     struct RunTaskImpl;
 
     static void
-    AddTaskImpl(std::function<void()>&& task_fn);
+    AddTaskImpl(Priority priority, std::function<void()>&& task_fn);
+};
+
+// Flag shared between the owner of a set of tasks and the tasks themselves to let the owner ask the
+// tasks that haven't finished yet to stop early (e.g. because the module they are indexing is being
+// unloaded). The task pool never drops a task so the tasks have to check IsCancelled() themselves
+// and return as soon as possible. Copies of a token refer to the same flag.
+class TaskCancellationToken
+{
+public:
+    TaskCancellationToken() :
+        m_cancelled(std::make_shared<std::atomic<bool>>(false))
+    {
+    }
+
+    void
+    Cancel()
+    {
+        m_cancelled->store(true);
+    }
+
+    bool
+    IsCancelled() const
+    {
+        return m_cancelled->load();
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
 };
 
 // Wrapper class around the global TaskPool implementation to make it possible to create a set of
@@ -74,6 +122,13 @@ template <typename T> // The return type of the tasks what will be added to this
 class TaskRunner
 {
 public:
+    // All tasks added to this task runner will be scheduled with the given priority.
+    explicit
+    TaskRunner(TaskPool::Priority priority = TaskPool::ePriorityNormal) :
+        m_priority(priority)
+    {
+    }
+
     // Add a task to the task runner what will also add the task to the global TaskPool. The
     // function doesn't return the std::future for the task because it will be supplied by the
     // WaitForNextCompletedTask after the task is completed.
@@ -96,6 +151,7 @@ public:
     WaitForAllTasks();
 
 private:
+    const TaskPool::Priority  m_priority;
     std::list<std::future<T>> m_ready;
     std::list<std::future<T>> m_pending;
     std::mutex                m_mutex;
@@ -105,11 +161,18 @@ private:
 template<typename F, typename... Args>
 std::future<typename std::result_of<F(Args...)>::type>
 TaskPool::AddTask(F&& f, Args&&... args)
+{
+    return AddTaskWithPriority(ePriorityNormal, std::forward<F>(f), std::forward<Args>(args)...);
+}
+
+template<typename F, typename... Args>
+std::future<typename std::result_of<F(Args...)>::type>
+TaskPool::AddTaskWithPriority(Priority priority, F&& f, Args&&... args)
 {
     auto task_sp = std::make_shared<std::packaged_task<typename std::result_of<F(Args...)>::type()>>(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
-    AddTaskImpl([task_sp]() { (*task_sp)(); });
+    AddTaskImpl(priority, [task_sp]() { (*task_sp)(); });
 
     return task_sp->get_future();
 }
@@ -147,7 +210,8 @@ TaskRunner<T>::AddTask(F&& f, Args&&... args)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
     auto it = m_pending.emplace(m_pending.end());
-    *it = std::move(TaskPool::AddTask(
+    *it = std::move(TaskPool::AddTaskWithPriority(
+        m_priority,
         [this, it](F f, Args... args)
         {
             T&& r = f(std::forward<Args>(args)...);
@@ -170,7 +234,8 @@ TaskRunner<void>::AddTask(F&& f, Args&&... args)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
     auto it = m_pending.emplace(m_pending.end());
-    *it = std::move(TaskPool::AddTask(
+    *it = std::move(TaskPool::AddTaskWithPriority(
+        m_priority,
         [this, it](F f, Args... args)
         {
             f(std::forward<Args>(args)...);
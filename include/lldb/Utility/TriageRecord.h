@@ -0,0 +1,193 @@
+//===-- TriageRecord.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_TriageRecord_h_
+#define utility_TriageRecord_h_
+
+// C Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// C++ Includes
+#include <map>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/ConstString.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class TriageRecord TriageRecord.h "lldb/Utility/TriageRecord.h"
+/// @brief The layout of crash triage records ("process save-triage").
+///
+/// A triage record holds what crash bucketing needs from a process: the
+/// UUIDs of the loaded modules and the symbolicated frames of every
+/// thread. The file is a header followed by flat tables, so readers can
+/// memory map it and use it in place without any of lldb's Target or
+/// Process machinery:
+///
+///     Header
+///     Module[num_modules]
+///     Thread[num_threads]     frames [first_frame, first_frame + num_frames)
+///     Frame[num_frames]
+///     uint32_t[num_strings]   offsets into the string data
+///     char[string_data_size]  NULL terminated strings
+///
+/// All values are little endian and every table starts at a multiple of 8
+/// bytes. Module paths and function names are stored once each in the
+/// string table and referred to by index, kInvalidIndex means none.
+//----------------------------------------------------------------------
+class TriageRecord
+{
+public:
+    static const uint32_t kVersion = 1;
+    static const uint32_t kInvalidIndex = UINT32_MAX;
+
+    struct Header
+    {
+        char magic[8];          // "LLDBTRI\0"
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t pid;
+        uint32_t num_modules;
+        uint32_t num_threads;
+        uint32_t num_frames;
+        uint32_t num_strings;
+        uint64_t modules_offset;
+        uint64_t threads_offset;
+        uint64_t frames_offset;
+        uint64_t strings_offset;
+        uint64_t string_data_offset;
+        uint64_t string_data_size;
+    };
+
+    struct Module
+    {
+        uint8_t uuid[20];
+        uint32_t uuid_size;
+        uint32_t path;          // string index
+        uint32_t reserved;
+        uint64_t load_address;
+    };
+
+    struct Thread
+    {
+        uint64_t tid;
+        uint32_t index_id;
+        uint32_t first_frame;
+        uint32_t num_frames;
+        uint32_t reserved;
+    };
+
+    struct Frame
+    {
+        uint64_t pc;
+        uint64_t file_address;  // the PC as a file address in its module
+        uint32_t module;        // module index
+        uint32_t name;          // string index of the function name
+    };
+
+    static const char *
+    GetMagic ()
+    {
+        return "LLDBTRI";
+    }
+};
+
+//----------------------------------------------------------------------
+/// Builds a triage record in memory.
+//----------------------------------------------------------------------
+class TriageRecordWriter
+{
+public:
+    TriageRecordWriter (uint64_t pid);
+
+    uint32_t
+    AddModule (const uint8_t *uuid, size_t uuid_size, const ConstString &path, uint64_t load_address);
+
+    void
+    AddThread (uint64_t tid, uint32_t index_id);
+
+    // Adds a frame to the last added thread.
+    void
+    AddFrame (uint64_t pc, uint32_t module_idx, uint64_t file_address, const ConstString &name);
+
+    void
+    GetBytes (std::vector<uint8_t> &bytes) const;
+
+private:
+    uint32_t
+    AddString (const ConstString &str);
+
+    uint64_t m_pid;
+    std::vector<TriageRecord::Module> m_modules;
+    std::vector<TriageRecord::Thread> m_threads;
+    std::vector<TriageRecord::Frame> m_frames;
+    std::vector<ConstString> m_strings;
+    // ConstStrings are unique, so the pointers identify the strings.
+    std::map<const char *, uint32_t> m_string_indexes;
+};
+
+//----------------------------------------------------------------------
+/// Reads a triage record in place, e.g. out of a memory mapped file.
+///
+/// The bytes must stay valid and be 8 byte aligned while the reader is
+/// used. Only little endian hosts can read records this way.
+//----------------------------------------------------------------------
+class TriageRecordReader
+{
+public:
+    TriageRecordReader ();
+
+    // Returns false if the bytes aren't a valid triage record.
+    bool
+    SetData (const void *bytes, size_t size);
+
+    const TriageRecord::Header &
+    GetHeader () const
+    {
+        return *m_header;
+    }
+
+    uint32_t
+    GetNumModules () const
+    {
+        return m_header ? m_header->num_modules : 0;
+    }
+
+    uint32_t
+    GetNumThreads () const
+    {
+        return m_header ? m_header->num_threads : 0;
+    }
+
+    const TriageRecord::Module *
+    GetModuleAtIndex (uint32_t idx) const;
+
+    const TriageRecord::Thread *
+    GetThreadAtIndex (uint32_t idx) const;
+
+    const TriageRecord::Frame *
+    GetFrameAtIndex (const TriageRecord::Thread &thread, uint32_t idx) const;
+
+    // Returns nullptr for kInvalidIndex or an out of range index.
+    const char *
+    GetString (uint32_t idx) const;
+
+private:
+    const uint8_t *m_bytes;
+    size_t m_size;
+    const TriageRecord::Header *m_header;
+};
+
+} // namespace lldb_private
+
+#endif // utility_TriageRecord_h_
@@ -0,0 +1,35 @@
+//===-- XXHash.h ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_XXHash_h_
+#define utility_XXHash_h_
+
+// C Includes
+#include <stddef.h>
+#include <stdint.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// Hash \a length bytes with the 64 bit xxHash algorithm (XXH64).
+///
+/// This is a fast non-cryptographic hash, lldb-server uses it to
+/// summarize blocks of memory so a client can find out which blocks
+/// changed without reading them. The result is the same on every host.
+//----------------------------------------------------------------------
+uint64_t
+XXHash64 (const void *data, size_t length, uint64_t seed = 0);
+
+} // namespace lldb_private
+
+#endif // utility_XXHash_h_
@@ -82,6 +82,7 @@ class   Debugger;
 class   Declaration;
 class   DiagnosticManager;
 class   Disassembler;
+class   DisassemblyCache;
 class   DumpValueObjectOptions;
 class   DynamicCheckerFunctions;
 class   DynamicLoader;
@@ -99,6 +100,7 @@ class   Expression;
 class   ExpressionVariable;
 class   ExpressionVariableList;
 class   ExpressionTypeSystemHelper;
+class   FastTracepoint;
 class   File;
 class   FileSpec;
 class   FileSpecList;
@@ -335,6 +337,7 @@ namespace lldb {
     typedef std::shared_ptr<lldb_private::EventData> EventDataSP;
     typedef std::shared_ptr<lldb_private::ExecutionContextRef> ExecutionContextRefSP;
     typedef std::shared_ptr<lldb_private::ExpressionVariable> ExpressionVariableSP;
+    typedef std::shared_ptr<lldb_private::FastTracepoint> FastTracepointSP;
     typedef std::shared_ptr<lldb_private::File> FileSP;
     typedef std::shared_ptr<lldb_private::Function> FunctionSP;
     typedef std::shared_ptr<lldb_private::FunctionCaller> FunctionCallerSP;
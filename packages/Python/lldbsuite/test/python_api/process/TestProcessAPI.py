@@ -105,6 +105,18 @@ class ProcessAPITestCase(TestBase):
         if my_uint32 != 12345:
             self.fail("Result from SBProcess.ReadUnsignedFromMemory() does not match our expected output")
 
+        # Read the same bytes into a buffer we provide.
+        content = process.ReadMemory(val.AddressOf().GetValueAsUnsigned(), 4, error)
+        buf = bytearray(4)
+        bytes_read = process.ReadMemoryInto(val.AddressOf().GetValueAsUnsigned(), buf, error)
+        if not error.Success() or bytes_read != 4:
+            self.fail("SBProcess.ReadMemoryInto() failed")
+        self.assertEqual(bytes(buf), content)
+
+        # Immutable objects can't be read into.
+        process.ReadMemoryInto(val.AddressOf().GetValueAsUnsigned(), b'1234', error)
+        self.assertTrue(error.Fail())
+
     @add_test_categories(['pyapi'])
     def test_write_memory(self):
         """Test Python SBProcess.WriteMemory() API."""
@@ -124,6 +124,19 @@ public:
 
     bool
     IsOneShot ();
+
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// A counting breakpoint never stops and only counts its hits, see
+    /// GetHitCount(). Remote stubs that support it count the hits without
+    /// stopping the process.
+    //------------------------------------------------------------------
+    ") SetCounting;
+    void
+    SetCounting (bool counting);
+
+    bool
+    IsCounting ();
     
     bool
     IsInternal ();
@@ -254,6 +267,10 @@ public:
         __swig_getmethods__["one_shot"] = IsOneShot
         __swig_setmethods__["one_shot"] = SetOneShot
         if _newclass: one_shot = property(IsOneShot, SetOneShot, doc='''A read/write property that configures whether this breakpoint is one-shot (deleted when hit) or not.''')
+
+        __swig_getmethods__["counting"] = IsCounting
+        __swig_setmethods__["counting"] = SetCounting
+        if _newclass: counting = property(IsCounting, SetCounting, doc='''A read/write property that configures whether this breakpoint only counts its hits instead of stopping.''')
             
         __swig_getmethods__["num_locations"] = GetNumLocations
         if _newclass: num_locations = property(GetNumLocations, None, doc='''A read only property that returns the count of locations of this breakpoint.''')
@@ -91,6 +91,13 @@ public:
     %feature("docstring", "Sets whether to abort expression evaluation if an exception is thrown while executing.  Don't set this to false unless you know the function you are calling traps all exceptions itself.") SetTryAllThreads;
     void
     SetTrapExceptions (bool trap_exceptions = true);
+
+    bool
+    GetLightCall () const;
+
+    %feature("docstring", "Sets whether to make the cheapest function calls possible: only the calling thread runs and the calls return to a breakpoint that is kept between calls.  Setting this also sets StopOthers and turns off TryAllThreads.") SetLightCall;
+    void
+    SetLightCall (bool light_call = true);
     
     %feature ("docstring", "Sets the language that LLDB should assume the expression is written in") SetLanguage;
     void
@@ -394,6 +394,24 @@ public:
 
     lldb::SBThreadCollection
     GetHistoryThreads (addr_t addr);
+
+    %feature("autodoc", "
+    Writes the frame PCs of every thread as a JSON array of
+    {\"tid\", \"index_id\", \"pcs\"} dictionaries into the stream.
+    The threads of core files are unwound in parallel.
+    ") GetThreadBacktraces;
+
+    bool
+    GetThreadBacktraces (lldb::SBStream &json, uint32_t max_frames = UINT32_MAX);
+
+    %feature("autodoc", "
+    Finds the pointers to addr in the writable memory of the process and
+    writes them as a JSON array of {\"address\", \"description\"}
+    dictionaries into the stream.
+    ") FindReferences;
+
+    lldb::SBError
+    FindReferences (addr_t addr, lldb::SBStream &json, uint32_t max_matches = UINT32_MAX);
              
     bool
     IsInstrumentationRuntimePresent(lldb::InstrumentationRuntimeType type);
@@ -401,6 +419,14 @@ public:
     lldb::SBError
     SaveCore(const char *file_name);
 
+    %feature("autodoc", "
+    Saves the loaded modules and the symbolicated backtraces of all
+    threads as a compact crash triage record.
+    ") SaveTriageRecord;
+
+    lldb::SBError
+    SaveTriageRecord(const char *file_name, uint32_t max_frames = UINT32_MAX);
+
     %pythoncode %{
         def __get_is_alive__(self):
             '''Returns "True" if the process is currently alive, "False" otherwise'''
@@ -552,6 +552,19 @@ public:
     ResolveSymbolContextForAddress (const SBAddress& addr, 
                                     uint32_t resolve_scope);
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Resolve the symbol contexts of a list of load addresses with one
+    /// call, one symbol context per address in the order of the list.
+    /// The symbol contexts of addresses that aren't in any module are
+    /// invalid.
+    //------------------------------------------------------------------
+    ") ResolveLoadAddresses;
+    lldb::SBSymbolContextList
+    ResolveLoadAddresses (uint64_t *array,
+                          size_t array_len,
+                          uint32_t resolve_scope);
+
      %feature("docstring", "
     //------------------------------------------------------------------
     /// Read target memory. If a target process is running then memory  
@@ -814,6 +827,12 @@ public:
 
     bool
     GetDescription (lldb::SBStream &description, lldb::DescriptionLevel description_level);
+
+    %feature("docstring", "
+    Get the statistics 'statistics dump' shows for this target as JSON.
+    ") GetStatistics;
+    bool
+    GetStatistics (lldb::SBStream &stats);
     
     lldb::addr_t
     GetStackRedZoneSize();
@@ -244,6 +244,22 @@ public:
                      lldb::DynamicValueType use_dynamic,
                      bool can_create_synthetic);
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Get the children in [start_idx, start_idx + count) at once.
+    ///
+    /// Use this to page through containers with many children:
+    /// synthetic children providers, such as the one for libc++'s
+    /// std::vector, read the memory for the whole window at once.
+    ///
+    /// @return
+    ///     A list with the children in the range, shorter than \a count
+    ///     if the range goes past the last child.
+    //------------------------------------------------------------------
+    ") GetChildrenInRange;
+    lldb::SBValueList
+    GetChildrenInRange (uint32_t start_idx, uint32_t count);
+
     lldb::SBValue
     CreateChildAtOffset (const char *name, uint32_t offset, lldb::SBType type);
     
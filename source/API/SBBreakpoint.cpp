@@ -280,6 +280,34 @@ SBBreakpoint::IsOneShot () const
         return false;
 }
 
+void
+SBBreakpoint::SetCounting (bool counting)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    if (log)
+        log->Printf ("SBBreakpoint(%p)::SetCounting (counting=%i)",
+                     static_cast<void*>(m_opaque_sp.get()), counting);
+
+    if (m_opaque_sp)
+    {
+        std::lock_guard<std::recursive_mutex> guard(m_opaque_sp->GetTarget().GetAPIMutex());
+        m_opaque_sp->SetCounting (counting);
+    }
+}
+
+bool
+SBBreakpoint::IsCounting () const
+{
+    if (m_opaque_sp)
+    {
+        std::lock_guard<std::recursive_mutex> guard(m_opaque_sp->GetTarget().GetAPIMutex());
+        return m_opaque_sp->IsCounting();
+    }
+    else
+        return false;
+}
+
 bool
 SBBreakpoint::IsInternal ()
 {
@@ -336,6 +364,9 @@ SBBreakpoint::GetHitCount () const
     if (m_opaque_sp)
     {
         std::lock_guard<std::recursive_mutex> guard(m_opaque_sp->GetTarget().GetAPIMutex());
+        ProcessSP process_sp (m_opaque_sp->GetTarget().GetProcessSP());
+        if (process_sp && m_opaque_sp->IsCounting())
+            process_sp->UpdateBreakpointHitCounts();
         count = m_opaque_sp->GetHitCount();
     }
 
@@ -149,6 +149,18 @@ SBExpressionOptions::SetTrapExceptions (bool trap_exceptions)
     m_opaque_ap->SetTrapExceptions (trap_exceptions);
 }
 
+bool
+SBExpressionOptions::GetLightCall () const
+{
+    return m_opaque_ap->GetLightCall ();
+}
+
+void
+SBExpressionOptions::SetLightCall (bool light_call)
+{
+    m_opaque_ap->SetLightCall (light_call);
+}
+
 void
 SBExpressionOptions::SetLanguage (lldb::LanguageType language)
 {
@@ -1170,6 +1170,18 @@ SBFrame::GetVariables (const lldb::SBVariablesOptions& options)
                 size_t i;
                 VariableList *variable_list = nullptr;
                 variable_list = frame->GetVariableList(true);
+
+                // Which arguments and locals are in scope comes from the
+                // frame's block, which caches it per address.
+                std::set<Variable *> in_scope_variables;
+                if (variable_list && in_scope_only)
+                {
+                    VariableListSP in_scope_list_sp (frame->GetInScopeVariableList(false));
+                    const size_t num_in_scope = in_scope_list_sp ? in_scope_list_sp->GetSize() : 0;
+                    for (i = 0; i < num_in_scope; ++i)
+                        in_scope_variables.insert(in_scope_list_sp->GetVariableAtIndex(i).get());
+                }
+
                 if (variable_list)
                 {
                     const size_t num_variables = variable_list->GetSize();
@@ -1207,8 +1219,17 @@ SBFrame::GetVariables (const lldb::SBVariablesOptions& options)
                                     else
                                         continue;
 
-                                    if (in_scope_only && !variable_sp->IsInScope(frame))
-                                        continue;
+                                    if (in_scope_only)
+                                    {
+                                        const ValueType scope = variable_sp->GetScope();
+                                        if (scope == eValueTypeVariableArgument || scope == eValueTypeVariableLocal)
+                                        {
+                                            if (in_scope_variables.find(variable_sp.get()) == in_scope_variables.end())
+                                                continue;
+                                        }
+                                        else if (!variable_sp->IsInScope(frame))
+                                            continue;
+                                    }
 
                                     ValueObjectSP valobj_sp(frame->GetValueObjectForFrameVariable (variable_sp, eNoDynamicValues));
                                     
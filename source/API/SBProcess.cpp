@@ -23,8 +23,10 @@
 #include "lldb/Core/State.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -1080,7 +1082,8 @@ SBProcess::ReadMemory (addr_t addr, void *dst, size_t dst_len, SBError &sb_error
         Process::StopLocker stop_locker;
         if (stop_locker.TryLock(&process_sp->GetRunLock()))
         {
-            std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
+            // The run lock keeps the process stopped, memory reads don't
+            // need the API mutex and can run on several threads at once.
             bytes_read = process_sp->ReadMemory (addr, dst, dst_len, sb_error.ref());
         }
         else
@@ -1120,7 +1123,6 @@ SBProcess::ReadCStringFromMemory (addr_t addr, void *buf, size_t size, lldb::SBE
         Process::StopLocker stop_locker;
         if (stop_locker.TryLock(&process_sp->GetRunLock()))
         {
-            std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
             bytes_read = process_sp->ReadCStringFromMemory (addr, (char *)buf, size, sb_error.ref());
         }
         else
@@ -1149,7 +1151,6 @@ SBProcess::ReadUnsignedFromMemory (addr_t addr, uint32_t byte_size, lldb::SBErro
         Process::StopLocker stop_locker;
         if (stop_locker.TryLock(&process_sp->GetRunLock()))
         {
-            std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
             value = process_sp->ReadUnsignedIntegerFromMemory (addr, byte_size, 0, sb_error.ref());
         }
         else
@@ -1178,7 +1179,6 @@ SBProcess::ReadPointerFromMemory (addr_t addr, lldb::SBError &sb_error)
         Process::StopLocker stop_locker;
         if (stop_locker.TryLock(&process_sp->GetRunLock()))
         {
-            std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
             ptr = process_sp->ReadPointerFromMemory (addr, sb_error.ref());
         }
         else
@@ -1433,6 +1433,83 @@ SBProcess::GetHistoryThreads (addr_t addr)
     return threads;
 }
 
+bool
+SBProcess::GetThreadBacktraces (SBStream &json, uint32_t max_frames)
+{
+    ProcessSP process_sp(GetSP());
+    if (!process_sp)
+        return false;
+
+    std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
+
+    Process::StopLocker stop_locker;
+    if (!stop_locker.TryLock(&process_sp->GetRunLock()))
+        return false;
+
+    process_sp->UnwindAllThreads (max_frames);
+
+    StructuredData::Array backtraces;
+    for (ThreadSP thread_sp : process_sp->Threads())
+    {
+        StructuredData::ArraySP pcs_sp (new StructuredData::Array());
+        for (uint32_t idx = 0; idx < max_frames; ++idx)
+        {
+            StackFrameSP frame_sp (thread_sp->GetStackFrameAtIndex (idx));
+            if (!frame_sp)
+                break;
+            pcs_sp->AddItem (StructuredData::ObjectSP (new StructuredData::Integer (frame_sp->GetFrameCodeAddress().GetLoadAddress (&process_sp->GetTarget()))));
+        }
+
+        StructuredData::DictionarySP thread_dict_sp (new StructuredData::Dictionary());
+        thread_dict_sp->AddIntegerItem ("tid", thread_sp->GetID());
+        thread_dict_sp->AddIntegerItem ("index_id", thread_sp->GetIndexID());
+        thread_dict_sp->AddItem ("pcs", pcs_sp);
+        backtraces.AddItem (thread_dict_sp);
+    }
+    backtraces.Dump (json.ref());
+    return true;
+}
+
+lldb::SBError
+SBProcess::FindReferences (addr_t addr, SBStream &json, uint32_t max_matches)
+{
+    lldb::SBError error;
+    ProcessSP process_sp(GetSP());
+    if (!process_sp)
+    {
+        error.SetErrorString("SBProcess is invalid");
+        return error;
+    }
+
+    std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
+
+    Process::StopLocker stop_locker;
+    if (!stop_locker.TryLock(&process_sp->GetRunLock()))
+    {
+        error.SetErrorString("process is running");
+        return error;
+    }
+
+    std::vector<addr_t> matches;
+    error.ref() = process_sp->FindReferences (addr, max_matches, matches);
+    if (error.Fail())
+        return error;
+
+    std::vector<std::string> descriptions;
+    process_sp->DescribeMemoryLocations (matches, descriptions);
+
+    StructuredData::Array references;
+    for (size_t i = 0; i < matches.size(); ++i)
+    {
+        StructuredData::DictionarySP reference_dict_sp (new StructuredData::Dictionary());
+        reference_dict_sp->AddIntegerItem ("address", matches[i]);
+        reference_dict_sp->AddStringItem ("description", descriptions[i]);
+        references.AddItem (reference_dict_sp);
+    }
+    references.Dump (json.ref());
+    return error;
+}
+
 bool
 SBProcess::IsInstrumentationRuntimePresent(InstrumentationRuntimeType type)
 {
@@ -1471,3 +1548,28 @@ SBProcess::SaveCore(const char *file_name)
     error.ref() = PluginManager::SaveCore(process_sp, core_file);
     return error;
 }
+
+lldb::SBError
+SBProcess::SaveTriageRecord(const char *file_name, uint32_t max_frames)
+{
+    lldb::SBError error;
+    ProcessSP process_sp(GetSP());
+    if (!process_sp)
+    {
+        error.SetErrorString("SBProcess is invalid");
+        return error;
+    }
+
+    std::lock_guard<std::recursive_mutex> guard(process_sp->GetTarget().GetAPIMutex());
+
+    Process::StopLocker stop_locker;
+    if (!stop_locker.TryLock(&process_sp->GetRunLock()))
+    {
+        error.SetErrorString("the process is not stopped");
+        return error;
+    }
+
+    FileSpec triage_file(file_name, false);
+    error.ref() = process_sp->SaveTriageRecord(triage_file, max_frames);
+    return error;
+}
@@ -767,6 +767,26 @@ SBTarget::ResolveSymbolContextForAddress (const SBAddress& addr,
     return sc;
 }
 
+SBSymbolContextList
+SBTarget::ResolveLoadAddresses (uint64_t *array, size_t array_len, uint32_t resolve_scope)
+{
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    SBSymbolContextList sb_sc_list;
+    TargetSP target_sp(GetSP());
+    if (target_sp && array)
+    {
+        std::lock_guard<std::recursive_mutex> guard(target_sp->GetAPIMutex());
+        target_sp->ResolveLoadAddresses (array, array_len, resolve_scope, *sb_sc_list);
+    }
+
+    if (log)
+        log->Printf ("SBTarget(%p)::ResolveLoadAddresses (%" PRIu64 " addresses, resolve_scope = 0x%x) => %u symbol contexts",
+                     static_cast<void*>(target_sp.get()), static_cast<uint64_t>(array_len), resolve_scope,
+                     sb_sc_list.GetSize());
+    return sb_sc_list;
+}
+
 size_t
 SBTarget::ReadMemory (const SBAddress addr,
                       void *buf,
@@ -1790,6 +1810,17 @@ SBTarget::GetDescription (SBStream &description, lldb::DescriptionLevel descript
     return true;
 }
 
+bool
+SBTarget::GetStatistics (SBStream &stats)
+{
+    TargetSP target_sp(GetSP());
+    if (!target_sp)
+        return false;
+
+    target_sp->GetStatistics()->Dump (stats.ref());
+    return true;
+}
+
 lldb::SBSymbolContextList
 SBTarget::FindFunctions (const char *name, uint32_t name_type_mask)
 {
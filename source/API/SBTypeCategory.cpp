@@ -9,14 +9,20 @@
 
 #include "lldb/API/SBTypeCategory.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "lldb/API/SBTypeFilter.h"
 #include "lldb/API/SBTypeFormat.h"
 #include "lldb/API/SBTypeSummary.h"
 #include "lldb/API/SBTypeSynthetic.h"
 #include "lldb/API/SBTypeNameSpecifier.h"
 #include "lldb/API/SBStream.h"
+#include "lldb/API/SBValue.h"
 
 #include "lldb/Core/Debugger.h"
+#include "lldb/Core/ValueObject.h"
 #include "lldb/DataFormatters/DataVisualization.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/ScriptInterpreter.h"
@@ -26,6 +32,75 @@ using namespace lldb_private;
 
 typedef std::pair<lldb::TypeCategoryImplSP,user_id_t> ImplType;
 
+namespace
+{
+    // Forwards to the callbacks of a native synthetic children provider.
+    class CallbackSyntheticFrontEnd : public SyntheticChildrenFrontEnd
+    {
+    public:
+        CallbackSyntheticFrontEnd (const SBSyntheticChildrenCallbacks &callbacks, ValueObject &backend, void *state) :
+            SyntheticChildrenFrontEnd(backend),
+            m_callbacks(callbacks),
+            m_state(state)
+        {
+        }
+
+        ~CallbackSyntheticFrontEnd() override
+        {
+            if (m_callbacks.destroy)
+                m_callbacks.destroy(m_state);
+        }
+
+        size_t
+        CalculateNumChildren () override
+        {
+            return CalculateNumChildren(UINT32_MAX);
+        }
+
+        size_t
+        CalculateNumChildren (uint32_t max) override
+        {
+            return std::min(m_callbacks.num_children(m_state, max), max);
+        }
+
+        lldb::ValueObjectSP
+        GetChildAtIndex (size_t idx) override
+        {
+            if (idx >= UINT32_MAX)
+                return lldb::ValueObjectSP();
+            return m_callbacks.child_at_index(m_state, static_cast<uint32_t>(idx)).GetSP();
+        }
+
+        size_t
+        GetIndexOfChildWithName (const ConstString &name) override
+        {
+            if (!m_callbacks.index_of_child || !name)
+                return UINT32_MAX;
+            return m_callbacks.index_of_child(m_state, name.GetCString());
+        }
+
+        bool
+        Update () override
+        {
+            return m_callbacks.update(m_state);
+        }
+
+        bool
+        MightHaveChildren () override
+        {
+            if (m_callbacks.might_have_children)
+                return m_callbacks.might_have_children(m_state);
+            return CalculateNumChildren(1) > 0;
+        }
+
+    private:
+        SBSyntheticChildrenCallbacks m_callbacks;
+        void *m_state;
+
+        DISALLOW_COPY_AND_ASSIGN(CallbackSyntheticFrontEnd);
+    };
+}
+
 SBTypeCategory::SBTypeCategory() :
 m_opaque_sp()
 {
@@ -258,7 +333,8 @@ SBTypeCategory::GetSyntheticForType (SBTypeNameSpecifier spec)
     else
         m_opaque_sp->GetTypeSyntheticsContainer()->GetExact(ConstString(spec.GetName()), children_sp);
     
-    if (!children_sp)
+    // Native providers can't be represented by an SBTypeSynthetic.
+    if (!children_sp || !children_sp->IsScripted())
         return lldb::SBTypeSynthetic();
     
     ScriptedSyntheticChildrenSP synth_sp = std::static_pointer_cast<ScriptedSyntheticChildren>(children_sp);
@@ -310,7 +386,7 @@ SBTypeCategory::GetSyntheticAtIndex (uint32_t index)
         return SBTypeSynthetic();
     lldb::SyntheticChildrenSP children_sp = m_opaque_sp->GetSyntheticAtIndex((index));
     
-    if (!children_sp.get())
+    if (!children_sp.get() || !children_sp->IsScripted())
         return lldb::SBTypeSynthetic();
     
     ScriptedSyntheticChildrenSP synth_sp = std::static_pointer_cast<ScriptedSyntheticChildren>(children_sp);
@@ -535,6 +611,48 @@ SBTypeCategory::DeleteTypeSynthetic (SBTypeNameSpecifier type_name)
 }
 #endif // LLDB_DISABLE_PYTHON
 
+bool
+SBTypeCategory::AddTypeSyntheticWithCallbacks (SBTypeNameSpecifier type_name,
+                                               const SBSyntheticChildrenCallbacks &callbacks,
+                                               uint32_t options,
+                                               const char *description)
+{
+    if (!IsValid())
+        return false;
+
+    if (!type_name.IsValid())
+        return false;
+
+    // Copy the callbacks the plug-in knows about, the ones it was built
+    // without stay nullptr.
+    SBSyntheticChildrenCallbacks native_callbacks;
+    ::memset(&native_callbacks, 0, sizeof(native_callbacks));
+    ::memcpy(&native_callbacks, &callbacks, std::min<size_t>(callbacks.size, sizeof(native_callbacks)));
+    native_callbacks.size = sizeof(native_callbacks);
+
+    if (!native_callbacks.create || !native_callbacks.update ||
+        !native_callbacks.num_children || !native_callbacks.child_at_index)
+        return false;
+
+    SyntheticChildrenSP synth_sp(new CXXSyntheticChildren(options,
+                                                          description ? description : "callback synthetic children provider",
+                                                          [native_callbacks] (CXXSyntheticChildren *, lldb::ValueObjectSP valobj_sp) -> SyntheticChildrenFrontEnd* {
+                                                              if (!valobj_sp)
+                                                                  return nullptr;
+                                                              void *state = native_callbacks.create(native_callbacks.baton, SBValue(valobj_sp));
+                                                              if (!state)
+                                                                  return nullptr;
+                                                              return new CallbackSyntheticFrontEnd(native_callbacks, *valobj_sp, state);
+                                                          }));
+
+    if (type_name.IsRegex())
+        m_opaque_sp->GetRegexTypeSyntheticsContainer()->Add(lldb::RegularExpressionSP(new RegularExpression(type_name.GetName())), synth_sp);
+    else
+        m_opaque_sp->GetTypeSyntheticsContainer()->Add(ConstString(type_name.GetName()), synth_sp);
+
+    return true;
+}
+
 bool
 SBTypeCategory::GetDescription (lldb::SBStream &description, 
                 lldb::DescriptionLevel description_level)
@@ -15,6 +15,7 @@
 #include "lldb/API/SBTypeFormat.h"
 #include "lldb/API/SBTypeSummary.h"
 #include "lldb/API/SBTypeSynthetic.h"
+#include "lldb/API/SBValueList.h"
 
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/DataExtractor.h"
@@ -992,6 +993,42 @@ SBValue::GetChildAtIndex (uint32_t idx, lldb::DynamicValueType use_dynamic, bool
     return sb_value;
 }
 
+lldb::SBValueList
+SBValue::GetChildrenInRange (uint32_t start_idx, uint32_t count)
+{
+    lldb::DynamicValueType use_dynamic = eNoDynamicValues;
+    TargetSP target_sp;
+    if (m_opaque_sp)
+        target_sp = m_opaque_sp->GetTargetSP();
+    
+    if (target_sp)
+        use_dynamic = target_sp->GetPreferDynamicValue();
+
+    SBValueList sb_children;
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    ValueLocker locker;
+    lldb::ValueObjectSP value_sp(GetSP(locker));
+    if (value_sp)
+    {
+        std::vector<lldb::ValueObjectSP> children;
+        value_sp->GetChildrenInRange (start_idx, count, children);
+        for (const lldb::ValueObjectSP &child_sp : children)
+        {
+            SBValue sb_value;
+            sb_value.SetSP (child_sp, use_dynamic, GetPreferSyntheticValue());
+            sb_children.Append (sb_value);
+        }
+    }
+
+    if (log)
+        log->Printf ("SBValue(%p)::GetChildrenInRange (%u, %u) => %u children",
+                     static_cast<void*>(value_sp.get()), start_idx, count,
+                     sb_children.GetSize());
+
+    return sb_children;
+}
+
 uint32_t
 SBValue::GetIndexOfChildWithName (const char *name)
 {
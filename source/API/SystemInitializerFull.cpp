@@ -66,6 +66,7 @@
 #include "Plugins/OperatingSystem/Go/OperatingSystemGo.h"
 #include "Plugins/Platform/gdb-server/PlatformRemoteGDBServer.h"
 #include "Plugins/Process/elf-core/ProcessElfCore.h"
+#include "Plugins/Process/minidump/ProcessMinidump.h"
 #include "Plugins/Process/gdb-remote/ProcessGDBRemote.h"
 #include "Plugins/ScriptInterpreter/None/ScriptInterpreterNone.h"
 #include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
@@ -98,8 +99,6 @@
 #include "Plugins/Process/Windows/MiniDump/ProcessWinMiniDump.h"
 #endif
 
-#include "llvm/Support/TargetSelect.h"
-
 #include <string>
 
 using namespace lldb_private;
@@ -172,6 +171,9 @@ LLDBSwigPython_CalculateNumChildren (void *implementor, uint32_t max);
 extern "C" void *
 LLDBSwigPython_GetChildAtIndex (void *implementor, uint32_t idx);
 
+extern "C" void *
+LLDBSwigPython_GetChildrenAtIndex (void *implementor, uint32_t start, uint32_t count);
+
 extern "C" int
 LLDBSwigPython_GetIndexOfChildWithName (void *implementor, const char* child_name);
 
@@ -281,12 +283,9 @@ SystemInitializerFull::Initialize()
     ScriptInterpreterPython::Initialize();
 #endif
 
-    // Initialize LLVM and Clang
-    llvm::InitializeAllTargets();
-    llvm::InitializeAllAsmPrinters();
-    llvm::InitializeAllTargetMCs();
-    llvm::InitializeAllDisassemblers();
-
+    // The LLVM targets are registered by InitializeLLVMTargets() the first
+    // time a plug-in needs them, most sessions that only run scripts or
+    // read symbols never do.
     ClangASTContext::Initialize();
     GoASTContext::Initialize();
     JavaASTContext::Initialize();
@@ -308,6 +307,7 @@ SystemInitializerFull::Initialize()
 
     JITLoaderGDB::Initialize();
     ProcessElfCore::Initialize();
+    minidump::ProcessMinidump::Initialize();
 #if defined(_MSC_VER)
     ProcessWinMiniDump::Initialize();
 #endif
@@ -385,6 +385,7 @@ void SystemInitializerFull::InitializeSWIG()
         LLDBSwigPythonCreateCommandObject,
         LLDBSwigPython_CalculateNumChildren,
         LLDBSwigPython_GetChildAtIndex,
+        LLDBSwigPython_GetChildrenAtIndex,
         LLDBSwigPython_GetIndexOfChildWithName,
         LLDBSWIGPython_CastPyObjectToSBValue,
         LLDBSWIGPython_GetValueObjectSPFromSBValue,
@@ -409,7 +410,8 @@ void SystemInitializerFull::InitializeSWIG()
 void
 SystemInitializerFull::Terminate()
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat, __PRETTY_FUNCTION__);
 
     Debugger::SettingsTerminate();
 
@@ -437,6 +439,7 @@ SystemInitializerFull::Terminate()
 
     JITLoaderGDB::Terminate();
     ProcessElfCore::Terminate();
+    minidump::ProcessMinidump::Terminate();
 #if defined(_MSC_VER)
     ProcessWinMiniDump::Terminate();
 #endif
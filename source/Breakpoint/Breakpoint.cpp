@@ -26,9 +26,11 @@
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/ThreadSpec.h"
 
@@ -53,13 +55,15 @@ Breakpoint::Breakpoint(Target &target,
                        bool resolve_indirect_symbols) :
     m_being_created(true),
     m_hardware(hardware),
+    m_counting(false),
     m_target (target),
     m_filter_sp (filter_sp),
     m_resolver_sp (resolver_sp),
     m_options (),
     m_locations (*this),
     m_resolve_indirect_symbols(resolve_indirect_symbols),
-    m_hit_count(0)
+    m_hit_count(0),
+    m_resolve_time(0)
 {
     m_being_created = false;
 }
@@ -67,12 +71,14 @@ Breakpoint::Breakpoint(Target &target,
 Breakpoint::Breakpoint (Target &new_target, Breakpoint &source_bp) :
     m_being_created(true),
     m_hardware(source_bp.m_hardware),
+    m_counting(source_bp.m_counting),
     m_target(new_target),
     m_name_list (source_bp.m_name_list),
     m_options (source_bp.m_options),
     m_locations(*this),
     m_resolve_indirect_symbols(source_bp.m_resolve_indirect_symbols),
-    m_hit_count(0)
+    m_hit_count(0),
+    m_resolve_time(0)
 {
     // Now go through and copy the filter & resolver:
     m_resolver_sp = source_bp.m_resolver_sp->CopyForBreakpoint(*this);
@@ -147,10 +153,13 @@ Breakpoint::SetEnabled (bool enable)
         return;
 
     m_options.SetEnabled(enable);
-    if (enable)
-        m_locations.ResolveAllBreakpointSites();
-    else
-        m_locations.ClearAllBreakpointSites();
+    {
+        Process::BreakpointSiteBatch batch (m_target.GetProcessSP());
+        if (enable)
+            m_locations.ResolveAllBreakpointSites();
+        else
+            m_locations.ClearAllBreakpointSites();
+    }
         
     SendBreakpointChangedEvent (enable ? eBreakpointEventTypeEnabled : eBreakpointEventTypeDisabled);
 
@@ -170,6 +179,8 @@ Breakpoint::SetIgnoreCount (uint32_t n)
         
     m_options.SetIgnoreCount(n);
     SendBreakpointChangedEvent (eBreakpointEventTypeIgnoreChanged);
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
 }
 
 void
@@ -220,6 +231,17 @@ Breakpoint::SetOneShot (bool one_shot)
     m_options.SetOneShot (one_shot);
 }
 
+void
+Breakpoint::SetCounting (bool counting)
+{
+    if (m_counting == counting)
+        return;
+
+    m_counting = counting;
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
+}
+
 void
 Breakpoint::SetThreadID (lldb::tid_t thread_id)
 {
@@ -228,6 +250,8 @@ Breakpoint::SetThreadID (lldb::tid_t thread_id)
         
     m_options.GetThreadSpec()->SetTID(thread_id);
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
 }
 
 lldb::tid_t
@@ -247,6 +271,8 @@ Breakpoint::SetThreadIndex (uint32_t index)
         
     m_options.GetThreadSpec()->SetIndex(index);
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
 }
 
 uint32_t
@@ -267,6 +293,8 @@ Breakpoint::SetThreadName (const char *thread_name)
         
     m_options.GetThreadSpec()->SetName (thread_name);
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
 }
 
 const char *
@@ -287,6 +315,8 @@ Breakpoint::SetQueueName (const char *queue_name)
         
     m_options.GetThreadSpec()->SetQueueName (queue_name);
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
 }
 
 const char *
@@ -303,6 +333,8 @@ Breakpoint::SetCondition (const char *condition)
 {
     m_options.SetCondition (condition);
     SendBreakpointChangedEvent (eBreakpointEventTypeConditionChanged);
+    for (size_t i = 0; i < m_locations.GetSize(); ++i)
+        m_locations.GetByIndex(i)->NotifySiteConditionsChanged();
 }
 
 const char *
@@ -352,7 +384,13 @@ void
 Breakpoint::ResolveBreakpoint ()
 {
     if (m_resolver_sp)
+    {
+        // Insert the sites of all the new locations at once.
+        IntervalTimer resolve_timer;
+        Process::BreakpointSiteBatch batch (m_target.GetProcessSP());
         m_resolver_sp->ResolveBreakpoint(*m_filter_sp);
+        m_resolve_time += resolve_timer.GetElapsedNanoSeconds();
+    }
 }
 
 void
@@ -360,7 +398,12 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, BreakpointLocat
 {
     m_locations.StartRecordingNewLocations(new_locations);
     
-    m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+    {
+        IntervalTimer resolve_timer;
+        Process::BreakpointSiteBatch batch (m_target.GetProcessSP());
+        m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+        m_resolve_time += resolve_timer.GetElapsedNanoSeconds();
+    }
 
     m_locations.StopRecordingNewLocations();
 }
@@ -388,7 +431,10 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, bool send_event
         }
         else
         {
+            IntervalTimer resolve_timer;
+            Process::BreakpointSiteBatch batch (m_target.GetProcessSP());
             m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+            m_resolve_time += resolve_timer.GetElapsedNanoSeconds();
         }
     }
 }
@@ -396,6 +442,7 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, bool send_event
 void
 Breakpoint::ClearAllBreakpointSites ()
 {
+    Process::BreakpointSiteBatch batch (m_target.GetProcessSP());
     m_locations.ClearAllBreakpointSites();
 }
 
@@ -585,6 +632,19 @@ Breakpoint::ModuleReplaced (ModuleSP old_module_sp, ModuleSP new_module_sp)
     }
     
     size_t num_old_locations = old_break_locs.GetSize();
+
+    // If the file was replaced by the same binary the resolver would find
+    // the same file addresses again, so just move the locations over.
+    const UUID &old_uuid = old_module_sp->GetUUID();
+    if (num_old_locations > 0 && old_uuid.IsValid() && old_uuid == new_module_sp->GetUUID() &&
+        RemapLocationsToModule(old_break_locs, new_module_sp))
+    {
+        if (log)
+            log->Printf ("Breakpoint::ModulesReplaced moved %" PRIu64 " locations to the module with the same UUID\n",
+                         (uint64_t)num_old_locations);
+        m_locations.Compact();
+        return;
+    }
     
     if (num_old_locations == 0)
     {
@@ -760,6 +820,28 @@ Breakpoint::ModuleReplaced (ModuleSP old_module_sp, ModuleSP new_module_sp)
     }
 }
 
+bool
+Breakpoint::RemapLocationsToModule (BreakpointLocationCollection &old_break_locs, const ModuleSP &new_module_sp)
+{
+    const size_t num_old_locations = old_break_locs.GetSize();
+    std::vector<Address> new_addrs (num_old_locations);
+    for (size_t idx = 0; idx < num_old_locations; idx++)
+    {
+        const addr_t file_addr = old_break_locs.GetByIndex(idx)->GetAddress().GetFileAddress();
+        if (file_addr == LLDB_INVALID_ADDRESS || !new_module_sp->ResolveFileAddress(file_addr, new_addrs[idx]))
+            return false;
+    }
+
+    // Swapping keeps the IDs, options and hit counts of the old locations.
+    for (size_t idx = 0; idx < num_old_locations; idx++)
+    {
+        BreakpointLocationSP new_loc_sp = m_locations.AddLocation(new_addrs[idx], m_resolve_indirect_symbols);
+        if (new_loc_sp)
+            m_locations.SwapLocation(old_break_locs.GetByIndex(idx), new_loc_sp);
+    }
+    return true;
+}
+
 void
 Breakpoint::Dump (Stream *)
 {
@@ -833,6 +915,8 @@ Breakpoint::GetDescription (Stream *s, lldb::DescriptionLevel level, bool show_l
             s->Printf(", locations = %" PRIu64, (uint64_t)num_locations);
             if (num_resolved_locations > 0)
                 s->Printf(", resolved = %" PRIu64 ", hit count = %d", (uint64_t)num_resolved_locations, GetHitCount());
+            if (m_counting)
+                s->PutCString(", counting");
         }
         else
         {
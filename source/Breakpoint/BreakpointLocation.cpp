@@ -127,6 +127,7 @@ BreakpointLocation::SetThreadID (lldb::tid_t thread_id)
             m_options_ap->SetThreadID (thread_id);
     }
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
+    NotifySiteConditionsChanged ();
 }
 
 lldb::tid_t
@@ -151,6 +152,7 @@ BreakpointLocation::SetThreadIndex (uint32_t index)
             m_options_ap->GetThreadSpec()->SetIndex(index);
     }
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
+    NotifySiteConditionsChanged ();
 }
 
 uint32_t
@@ -175,6 +177,7 @@ BreakpointLocation::SetThreadName (const char *thread_name)
             m_options_ap->GetThreadSpec()->SetName(thread_name);
     }
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
+    NotifySiteConditionsChanged ();
 }
 
 const char *
@@ -199,6 +202,7 @@ BreakpointLocation::SetQueueName (const char *queue_name)
             m_options_ap->GetThreadSpec()->SetQueueName(queue_name);
     }
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
+    NotifySiteConditionsChanged ();
 }
 
 const char *
@@ -248,6 +252,7 @@ BreakpointLocation::SetCondition (const char *condition)
 {
     GetLocationOptions()->SetCondition (condition);
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeConditionChanged);
+    NotifySiteConditionsChanged ();
 }
 
 const char *
@@ -384,6 +389,7 @@ BreakpointLocation::SetIgnoreCount (uint32_t n)
 {
     GetLocationOptions()->SetIgnoreCount(n);
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeIgnoreChanged);
+    NotifySiteConditionsChanged ();
 }
 
 void
@@ -456,6 +462,10 @@ BreakpointLocation::ShouldStop (StoppointCallbackContext *context)
     if (!IsEnabled())
         return false;
 
+    // Counting breakpoints only count, the hit count was already bumped.
+    if (m_owner.IsCounting())
+        return false;
+
     if (!IgnoreCountShouldStop())
         return false;
     
@@ -477,13 +487,13 @@ BreakpointLocation::ShouldStop (StoppointCallbackContext *context)
 }
 
 void
-BreakpointLocation::BumpHitCount()
+BreakpointLocation::BumpHitCount(uint32_t count)
 {
     if (IsEnabled())
     {
         // Step our hit count, and also step the hit count of the owner.
-        IncrementHitCount();
-        m_owner.IncrementHitCount();
+        IncrementHitCount(count);
+        m_owner.IncrementHitCount(count);
     }
 }
 
@@ -743,6 +753,17 @@ BreakpointLocation::SendBreakpointLocationChangedEvent (lldb::BreakpointEventTyp
     }
 }
 
+void
+BreakpointLocation::NotifySiteConditionsChanged ()
+{
+    if (!m_bp_site_sp)
+        return;
+
+    ProcessSP process_sp (m_owner.GetTarget().GetProcessSP());
+    if (process_sp && process_sp->IsAlive())
+        process_sp->BreakpointSiteConditionsChanged (m_bp_site_sp.get());
+}
+
 void
 BreakpointLocation::SwapLocation (BreakpointLocationSP swap_from)
 {
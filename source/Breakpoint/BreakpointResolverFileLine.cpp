@@ -74,10 +74,17 @@ BreakpointResolverFileLine::SearchCallback
     // So we go through the match list and pull out the sets that have the same file spec in their line_entry
     // and treat each set separately.
     
-    const size_t num_comp_units = context.module_sp->GetNumCompileUnits();
+    // Only the compile units that mention a file with our name can have
+    // matches, the module keeps an index of them.
+    std::vector<uint32_t> cu_indexes;
+    const bool use_cu_index = m_file_spec.GetFilename() && m_file_spec.IsCaseSensitive() &&
+                              context.module_sp->FindCompileUnitIndexesForFilename(m_file_spec.GetFilename(),
+                                                                                   m_inlines, cu_indexes);
+
+    const size_t num_comp_units = use_cu_index ? cu_indexes.size() : context.module_sp->GetNumCompileUnits();
     for (size_t i = 0; i < num_comp_units; i++)
     {
-        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (i));
+        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (use_cu_index ? cu_indexes[i] : i));
         if (cu_sp)
         {
             if (filter.CompUnitPasses(*cu_sp))
@@ -11,14 +11,18 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Core/SourceManager.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -55,60 +59,120 @@ BreakpointResolverFileRegex::SearchCallback
 {
 
     assert (m_breakpoint != NULL);
-    if (!context.target_sp)
+    if (!context.target_sp || !context.module_sp)
         return eCallbackReturnContinue;
 
-    CompileUnit *cu = context.comp_unit;
-    FileSpec cu_file_spec = *(static_cast<FileSpec *>(cu));
-    std::vector<uint32_t> line_matches;
-    context.target_sp->GetSourceManager().FindLinesMatchingRegex(cu_file_spec, m_regex, 1, UINT32_MAX, line_matches);
-    
-    uint32_t num_matches = line_matches.size();
-    for (uint32_t i = 0; i < num_matches; i++)
+    // Many compile units can share a source file, gather the files first so
+    // each of them is scanned once.
+    struct SourceFile
+    {
+        FileSpec file_spec;
+        std::vector<CompUnitSP> comp_units;
+        std::vector<uint32_t> line_matches;
+        bool scanned;
+    };
+    std::vector<SourceFile> source_files;
+    std::map<FileSpec, size_t> source_file_indexes;
+
+    ModuleSP module_sp (context.module_sp);
+    const size_t num_cus = module_sp->GetNumCompileUnits();
+    for (size_t cu_idx = 0; cu_idx < num_cus; ++cu_idx)
+    {
+        CompUnitSP cu_sp (module_sp->GetCompileUnitAtIndex (cu_idx));
+        if (!cu_sp || !filter.CompUnitPasses (*cu_sp))
+            continue;
+
+        FileSpec cu_file_spec = *(static_cast<FileSpec *>(cu_sp.get()));
+        auto pos = source_file_indexes.find (cu_file_spec);
+        if (pos == source_file_indexes.end())
+        {
+            pos = source_file_indexes.insert (std::make_pair (cu_file_spec, source_files.size())).first;
+            SourceFile source_file;
+            source_file.file_spec = cu_file_spec;
+            source_file.scanned = false;
+            source_files.push_back (source_file);
+        }
+        source_files[pos->second].comp_units.push_back (cu_sp);
+    }
+
+    // Files that are where the debug info says can be mapped and scanned
+    // in parallel. The matching is all that is needed from them, so they
+    // don't have to go into the source cache.
+    TaskRunner<void> task_runner;
+    const RegularExpression &regex = m_regex;
+    for (SourceFile &source_file : source_files)
+    {
+        if (!source_file.file_spec.Exists())
+            continue;
+        task_runner.AddTask ([&source_file, &regex]() {
+            source_file.scanned = SourceManager::FindLinesMatchingRegexInFile (source_file.file_spec,
+                                                                               regex,
+                                                                               source_file.line_matches);
+        });
+    }
+    task_runner.WaitForAllTasks();
+
+    for (SourceFile &source_file : source_files)
+    {
+        // The source manager knows how to find files through the target's
+        // source path mappings.
+        if (!source_file.scanned)
+            context.target_sp->GetSourceManager().FindLinesMatchingRegex (source_file.file_spec, m_regex, 1, UINT32_MAX,
+                                                                          source_file.line_matches);
+
+        for (const CompUnitSP &cu_sp : source_file.comp_units)
+        {
+            for (uint32_t line : source_file.line_matches)
+                SetMatchesForLine (filter, *cu_sp, source_file.file_spec, line);
+        }
+    }
+    assert (m_breakpoint != NULL);        
+
+    return Searcher::eCallbackReturnContinue;
+}
+
+void
+BreakpointResolverFileRegex::SetMatchesForLine (SearchFilter &filter, CompileUnit &cu, FileSpec &file_spec, uint32_t line)
+{
+    SymbolContextList sc_list;
+    const bool search_inlines = false;
+
+    cu.ResolveSymbolContext (file_spec, line, search_inlines, m_exact_match, eSymbolContextEverything, sc_list);
+    // Find all the function names:
+    if (!m_function_names.empty())
     {
-        SymbolContextList sc_list;
-        const bool search_inlines = false;
-        
-        cu->ResolveSymbolContext (cu_file_spec, line_matches[i], search_inlines, m_exact_match, eSymbolContextEverything, sc_list);
-        // Find all the function names:
-        if (!m_function_names.empty())
+        std::vector<size_t> sc_to_remove;
+        for (size_t i = 0; i < sc_list.GetSize(); i++)
         {
-            std::vector<size_t> sc_to_remove;
-            for (size_t i = 0; i < sc_list.GetSize(); i++)
+            SymbolContext sc_ctx;
+            sc_list.GetContextAtIndex(i, sc_ctx);
+            std::string name(sc_ctx.GetFunctionName(Mangled::NamePreference::ePreferDemangledWithoutArguments).AsCString());
+            if (!m_function_names.count(name))
             {
-                SymbolContext sc_ctx;
-                sc_list.GetContextAtIndex(i, sc_ctx);
-                std::string name(sc_ctx.GetFunctionName(Mangled::NamePreference::ePreferDemangledWithoutArguments).AsCString());
-                if (!m_function_names.count(name))
-                {
-                    sc_to_remove.push_back(i);
-                }
+                sc_to_remove.push_back(i);
             }
-            
-            if (!sc_to_remove.empty())
+        }
+
+        if (!sc_to_remove.empty())
+        {
+            std::vector<size_t>::reverse_iterator iter;
+            std::vector<size_t>::reverse_iterator rend = sc_to_remove.rend();
+            for (iter = sc_to_remove.rbegin(); iter != rend; iter++)
             {
-                std::vector<size_t>::reverse_iterator iter;
-                std::vector<size_t>::reverse_iterator rend = sc_to_remove.rend();
-                for (iter = sc_to_remove.rbegin(); iter != rend; iter++)
-                {
-                    sc_list.RemoveContextAtIndex(*iter);
-                }
+                sc_list.RemoveContextAtIndex(*iter);
             }
         }
-        
-        const bool skip_prologue = true;
-        
-        BreakpointResolver::SetSCMatchesByLine (filter, sc_list, skip_prologue, m_regex.GetText());
     }
-    assert (m_breakpoint != NULL);        
 
-    return Searcher::eCallbackReturnContinue;
+    const bool skip_prologue = true;
+
+    BreakpointResolver::SetSCMatchesByLine (filter, sc_list, skip_prologue, m_regex.GetText());
 }
 
 Searcher::Depth
 BreakpointResolverFileRegex::GetDepth()
 {
-    return Searcher::eDepthCompUnit;
+    return Searcher::eDepthModule;
 }
 
 void
@@ -207,6 +207,17 @@ BreakpointSite::BumpHitCounts()
     }
 }
 
+void
+BreakpointSite::AddCountedHits (uint32_t count)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_owners_mutex);
+    IncrementHitCount (count);
+    for (BreakpointLocationSP loc_sp : m_owners.BreakpointLocations())
+    {
+        loc_sp->BumpHitCount (count);
+    }
+}
+
 bool
 BreakpointSite::IntersectsRange(lldb::addr_t addr, size_t size, lldb::addr_t *intersect_addr, size_t *intersect_size, size_t *opcode_offset) const
 {
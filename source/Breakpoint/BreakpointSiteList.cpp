@@ -19,7 +19,12 @@
 using namespace lldb;
 using namespace lldb_private;
 
-BreakpointSiteList::BreakpointSiteList() : m_mutex(), m_bp_site_list()
+BreakpointSiteList::BreakpointSiteList() :
+    m_mutex(),
+    m_bp_site_list(),
+    m_generation(0),
+    m_snapshot(),
+    m_stale_snapshot_generation(UINT32_MAX)
 {
 }
 
@@ -27,6 +32,83 @@ BreakpointSiteList::~BreakpointSiteList()
 {
 }
 
+namespace
+{
+    bool
+    LoadAddressLessThan (const BreakpointSiteSP &bp_site_sp, lldb::addr_t addr)
+    {
+        return bp_site_sp->GetLoadAddress() < addr;
+    }
+}
+
+size_t
+BreakpointSiteList::FindIndexByAddress (const collection &sites, lldb::addr_t addr)
+{
+    collection::const_iterator pos = std::lower_bound (sites.begin(), sites.end(), addr, LoadAddressLessThan);
+    if (pos != sites.end() && (*pos)->GetLoadAddress() == addr)
+        return pos - sites.begin();
+    return sites.size();
+}
+
+size_t
+BreakpointSiteList::FindIndexByID (const collection &sites, lldb::break_id_t break_id)
+{
+    for (size_t idx = 0; idx < sites.size(); ++idx)
+    {
+        if (sites[idx]->GetID() == break_id)
+            return idx;
+    }
+    return sites.size();
+}
+
+size_t
+BreakpointSiteList::FindFirstInRange (const collection &sites, lldb::addr_t lower_bound, lldb::addr_t upper_bound)
+{
+    size_t idx = std::lower_bound (sites.begin(), sites.end(), lower_bound, LoadAddressLessThan) - sites.begin();
+
+    // A site below the range can still reach into it, but no site is longer
+    // than its trap opcode buffer and the sites have distinct addresses, so
+    // this only ever looks at a few of them.
+    while (idx > 0 && sites[idx - 1]->GetLoadAddress() + sites[idx - 1]->GetTrapOpcodeMaxByteSize() > lower_bound)
+        --idx;
+    return idx;
+}
+
+void
+BreakpointSiteList::Changed ()
+{
+    // Called with m_mutex held. Readers compare the generation of the
+    // snapshot against this, so the old snapshot is stale from now on.
+    m_generation.fetch_add (1, std::memory_order_release);
+}
+
+BreakpointSiteList::SnapshotSP
+BreakpointSiteList::GetSnapshot (bool force) const
+{
+    SnapshotSP snapshot_sp (std::atomic_load (&m_snapshot));
+    if (snapshot_sp && snapshot_sp->generation == m_generation.load (std::memory_order_acquire))
+        return snapshot_sp;
+
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    const uint32_t generation = m_generation.load (std::memory_order_relaxed);
+    snapshot_sp = std::atomic_load (&m_snapshot);
+    if (snapshot_sp && snapshot_sp->generation == generation)
+        return snapshot_sp;
+
+    if (!force && m_stale_snapshot_generation != generation)
+    {
+        m_stale_snapshot_generation = generation;
+        return SnapshotSP();
+    }
+
+    std::shared_ptr<Snapshot> new_snapshot_sp (new Snapshot);
+    new_snapshot_sp->sites = m_bp_site_list;
+    new_snapshot_sp->generation = generation;
+    snapshot_sp = new_snapshot_sp;
+    std::atomic_store (&m_snapshot, snapshot_sp);
+    return snapshot_sp;
+}
+
 // Add breakpoint site to the list.  However, if the element already exists in the
 // list, then we don't add it, and return LLDB_INVALID_BREAK_ID.
 
@@ -35,11 +117,12 @@ BreakpointSiteList::Add(const BreakpointSiteSP &bp)
 {
     lldb::addr_t bp_site_load_addr = bp->GetLoadAddress();
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    collection::iterator iter = m_bp_site_list.find (bp_site_load_addr);
+    collection::iterator iter = std::lower_bound (m_bp_site_list.begin(), m_bp_site_list.end(), bp_site_load_addr, LoadAddressLessThan);
 
-    if (iter == m_bp_site_list.end())
+    if (iter == m_bp_site_list.end() || (*iter)->GetLoadAddress() != bp_site_load_addr)
     {
-        m_bp_site_list.insert (iter, collection::value_type (bp_site_load_addr, bp));
+        m_bp_site_list.insert (iter, bp);
+        Changed ();
         return bp->GetID();
     }
     else
@@ -80,10 +163,11 @@ bool
 BreakpointSiteList::Remove (lldb::break_id_t break_id)
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    collection::iterator pos = GetIDIterator(break_id);    // Predicate
-    if (pos != m_bp_site_list.end())
+    const size_t idx = FindIndexByID (m_bp_site_list, break_id);
+    if (idx < m_bp_site_list.size())
     {
-        m_bp_site_list.erase(pos);
+        m_bp_site_list.erase(m_bp_site_list.begin() + idx);
+        Changed ();
         return true;
     }
     return false;
@@ -93,68 +177,39 @@ bool
 BreakpointSiteList::RemoveByAddress (lldb::addr_t address)
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    collection::iterator pos =  m_bp_site_list.find(address);
-    if (pos != m_bp_site_list.end())
+    const size_t idx = FindIndexByAddress (m_bp_site_list, address);
+    if (idx < m_bp_site_list.size())
     {
-        m_bp_site_list.erase(pos);
+        m_bp_site_list.erase(m_bp_site_list.begin() + idx);
+        Changed ();
         return true;
     }
     return false;
 }
 
-class BreakpointSiteIDMatches
-{
-public:
-    BreakpointSiteIDMatches (lldb::break_id_t break_id) :
-        m_break_id(break_id)
-    {
-    }
-
-    bool operator() (std::pair <lldb::addr_t, BreakpointSiteSP> val_pair) const
-    {
-        return m_break_id == val_pair.second.get()->GetID();
-    }
-
-private:
-   const lldb::break_id_t m_break_id;
-};
-
-BreakpointSiteList::collection::iterator
-BreakpointSiteList::GetIDIterator (lldb::break_id_t break_id)
-{
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    return std::find_if(m_bp_site_list.begin(), m_bp_site_list.end(),   // Search full range
-                        BreakpointSiteIDMatches(break_id));             // Predicate
-}
-
-BreakpointSiteList::collection::const_iterator
-BreakpointSiteList::GetIDConstIterator (lldb::break_id_t break_id) const
-{
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    return std::find_if(m_bp_site_list.begin(), m_bp_site_list.end(),   // Search full range
-                        BreakpointSiteIDMatches(break_id));             // Predicate
-}
-
 BreakpointSiteSP
 BreakpointSiteList::FindByID (lldb::break_id_t break_id)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    BreakpointSiteSP stop_sp;
-    collection::iterator pos = GetIDIterator(break_id);
-    if (pos != m_bp_site_list.end())
-        stop_sp = pos->second;
-
-    return stop_sp;
+    return static_cast<const BreakpointSiteList *>(this)->FindByID (break_id);
 }
 
 const BreakpointSiteSP
 BreakpointSiteList::FindByID (lldb::break_id_t break_id) const
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
     BreakpointSiteSP stop_sp;
-    collection::const_iterator pos = GetIDConstIterator(break_id);
-    if (pos != m_bp_site_list.end())
-        stop_sp = pos->second;
+    SnapshotSP snapshot_sp (GetSnapshot (false));
+    if (snapshot_sp)
+    {
+        const size_t idx = FindIndexByID (snapshot_sp->sites, break_id);
+        if (idx < snapshot_sp->sites.size())
+            stop_sp = snapshot_sp->sites[idx];
+        return stop_sp;
+    }
+
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    const size_t idx = FindIndexByID (m_bp_site_list, break_id);
+    if (idx < m_bp_site_list.size())
+        stop_sp = m_bp_site_list[idx];
 
     return stop_sp;
 }
@@ -163,20 +218,28 @@ BreakpointSiteSP
 BreakpointSiteList::FindByAddress (lldb::addr_t addr)
 {
     BreakpointSiteSP found_sp;
+    SnapshotSP snapshot_sp (GetSnapshot (false));
+    if (snapshot_sp)
+    {
+        const size_t idx = FindIndexByAddress (snapshot_sp->sites, addr);
+        if (idx < snapshot_sp->sites.size())
+            found_sp = snapshot_sp->sites[idx];
+        return found_sp;
+    }
+
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    collection::iterator iter =  m_bp_site_list.find(addr);
-    if (iter != m_bp_site_list.end())
-        found_sp = iter->second;
+    const size_t idx = FindIndexByAddress (m_bp_site_list, addr);
+    if (idx < m_bp_site_list.size())
+        found_sp = m_bp_site_list[idx];
     return found_sp;
 }
 
 bool
 BreakpointSiteList::BreakpointSiteContainsBreakpoint (lldb::break_id_t bp_site_id, lldb::break_id_t bp_id)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    collection::const_iterator pos = GetIDConstIterator(bp_site_id);
-    if (pos != m_bp_site_list.end())
-        return pos->second->IsBreakpointAtThisSite (bp_id);
+    BreakpointSiteSP bp_site_sp (FindByID (bp_site_id));
+    if (bp_site_sp)
+        return bp_site_sp->IsBreakpointAtThisSite (bp_id);
 
     return false;
 }
@@ -184,55 +247,33 @@ BreakpointSiteList::BreakpointSiteContainsBreakpoint (lldb::break_id_t bp_site_i
 void
 BreakpointSiteList::Dump (Stream *s) const
 {
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
     s->Printf("%p: ", static_cast<const void*>(this));
     //s->Indent();
     s->Printf("BreakpointSiteList with %u BreakpointSites:\n", (uint32_t)m_bp_site_list.size());
     s->IndentMore();
-    collection::const_iterator pos;
-    collection::const_iterator end = m_bp_site_list.end();
-    for (pos = m_bp_site_list.begin(); pos != end; ++pos)
-        pos->second.get()->Dump(s);
+    for (const BreakpointSiteSP &bp_site_sp : m_bp_site_list)
+        bp_site_sp->Dump(s);
     s->IndentLess();
 }
 
 void
 BreakpointSiteList::ForEach (std::function <void(BreakpointSite *)> const &callback)
 {
+    // Walk a snapshot so that the callback can remove sites.
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    for (auto pair : m_bp_site_list)
-        callback (pair.second.get());
+    SnapshotSP snapshot_sp (GetSnapshot (true));
+    for (const BreakpointSiteSP &bp_site_sp : snapshot_sp->sites)
+        callback (bp_site_sp.get());
 }
 
 bool
 BreakpointSiteList::FindInRange (lldb::addr_t lower_bound, lldb::addr_t upper_bound, BreakpointSiteList &bp_site_list) const
 {
-    if (lower_bound > upper_bound)
-        return false;
-
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    collection::const_iterator lower, upper, pos;
-    lower = m_bp_site_list.lower_bound(lower_bound);
-    if (lower == m_bp_site_list.end()
-            || (*lower).first >= upper_bound)
-        return false;
-    
-    // This is one tricky bit.  The breakpoint might overlap the bottom end of the range.  So we grab the
-    // breakpoint prior to the lower bound, and check that that + its byte size isn't in our range.
-    if (lower != m_bp_site_list.begin())
-    {
-        collection::const_iterator prev_pos = lower;
-        prev_pos--;
-        const BreakpointSiteSP &prev_bp = (*prev_pos).second;
-        if (prev_bp->GetLoadAddress() + prev_bp->GetByteSize() > lower_bound)
-            bp_site_list.Add (prev_bp);
-        
-    }
-    
-    upper = m_bp_site_list.upper_bound(upper_bound);
-        
-    for (pos = lower; pos != upper; pos++)
-    {
-        bp_site_list.Add ((*pos).second);
-    }
-    return true;
+    bool found = false;
+    ForEachInRange (lower_bound, upper_bound, [&bp_site_list, &found](const BreakpointSiteSP &bp_site_sp) {
+        bp_site_list.Add (bp_site_sp);
+        found = true;
+    });
+    return found;
 }
@@ -503,7 +503,7 @@ CommandCompletions::SourceFileCompleter::SourceFileCompleter(CommandInterpreter
 Searcher::Depth
 CommandCompletions::SourceFileCompleter::GetDepth()
 {
-    return eDepthCompUnit;
+    return eDepthModule;
 }
 
 Searcher::CallbackReturn
@@ -512,48 +512,40 @@ CommandCompletions::SourceFileCompleter::SearchCallback(SearchFilter &filter,
                                                         Address *addr,
                                                         bool complete)
 {
-    if (context.comp_unit != nullptr)
+    if (context.module_sp)
     {
+        llvm::StringRef file_prefix (m_file_name ? m_file_name : "");
+        llvm::StringRef dir_prefix (m_dir_name ? m_dir_name : "");
+
+        // The module keeps its compile units sorted by file name, only the
+        // ones that start with the completion string have to be checked.
+        // The support files of every compile unit have to be looked at.
+        std::vector<lldb::CompUnitSP> comp_units;
         if (m_include_support_files)
+            context.module_sp->FindCompileUnitsWithFilePrefix ("", "", SIZE_MAX, comp_units);
+        else
+            context.module_sp->FindCompileUnitsWithFilePrefix (file_prefix, dir_prefix, SIZE_MAX, comp_units);
+
+        for (const lldb::CompUnitSP &comp_unit_sp : comp_units)
         {
-            FileSpecList supporting_files = context.comp_unit->GetSupportFiles();
-            for (size_t sfiles = 0; sfiles < supporting_files.GetSize(); sfiles++)
+            if (!filter.CompUnitPasses (*comp_unit_sp))
+                continue;
+            if (m_include_support_files)
             {
-                const FileSpec &sfile_spec = supporting_files.GetFileSpecAtIndex(sfiles);
-                const char *sfile_file_name = sfile_spec.GetFilename().GetCString();
-                const char *sfile_dir_name = sfile_spec.GetFilename().GetCString();
-                bool match = false;
-                if (m_file_name && sfile_file_name
-                    && strstr (sfile_file_name, m_file_name) == sfile_file_name)
-                    match = true;
-                if (match && m_dir_name && sfile_dir_name
-                    && strstr (sfile_dir_name, m_dir_name) != sfile_dir_name)
-                    match = false;
-
-                if (match)
+                FileSpecList supporting_files = comp_unit_sp->GetSupportFiles();
+                for (size_t sfiles = 0; sfiles < supporting_files.GetSize(); sfiles++)
                 {
-                    m_matching_files.AppendIfUnique(sfile_spec);
+                    const FileSpec &sfile_spec = supporting_files.GetFileSpecAtIndex(sfiles);
+                    if (sfile_spec.GetFilename().GetStringRef().startswith(file_prefix) &&
+                        sfile_spec.GetDirectory().GetStringRef().startswith(dir_prefix))
+                        m_matching_files.AppendIfUnique(sfile_spec);
                 }
             }
-        }
-        else
-        {
-            const char *cur_file_name = context.comp_unit->GetFilename().GetCString();
-            const char *cur_dir_name = context.comp_unit->GetDirectory().GetCString();
-
-            bool match = false;
-            if (m_file_name && cur_file_name
-                && strstr (cur_file_name, m_file_name) == cur_file_name)
-                match = true;
-
-            if (match && m_dir_name && cur_dir_name
-                && strstr (cur_dir_name, m_dir_name) != cur_dir_name)
-                match = false;
+            else
+                m_matching_files.AppendIfUnique(*comp_unit_sp);
 
-            if (match)
-            {
-                m_matching_files.AppendIfUnique(context.comp_unit);
-            }
+            if (m_max_return_elements >= 0 && m_matching_files.GetSize() >= (size_t)m_max_return_elements)
+                return Searcher::eCallbackReturnStop;
         }
     }
     return Searcher::eCallbackReturnContinue;
@@ -575,47 +567,14 @@ CommandCompletions::SourceFileCompleter::DoCompletion (SearchFilter *filter)
 // SymbolCompleter
 //----------------------------------------------------------------------
 
-static bool
-regex_chars (const char comp)
-{
-    return (comp == '[' || comp == ']' ||
-            comp == '(' || comp == ')' ||
-            comp == '{' || comp == '}' ||
-            comp == '+' ||
-            comp == '.' ||
-            comp == '*' ||
-            comp == '|' ||
-            comp == '^' ||
-            comp == '$' ||
-            comp == '\\' ||
-            comp == '?');
-}
-
 CommandCompletions::SymbolCompleter::SymbolCompleter(CommandInterpreter &interpreter,
                                                      const char *completion_str,
                                                      int match_start_point,
                                                      int max_return_elements,
                                                      StringList &matches) :
-    CommandCompletions::Completer (interpreter, completion_str, match_start_point, max_return_elements, matches)
+    CommandCompletions::Completer (interpreter, completion_str, match_start_point, max_return_elements, matches),
+    m_match_set()
 {
-    std::string regex_str;
-    if (completion_str && completion_str[0])
-    {
-        regex_str.append("^");
-        regex_str.append(completion_str);
-    }
-    else
-    {
-        // Match anything since the completion string is empty
-        regex_str.append(".");
-    }
-    std::string::iterator pos = find_if(regex_str.begin() + 1, regex_str.end(), regex_chars);
-    while (pos < regex_str.end())
-    {
-        pos = regex_str.insert(pos, '\\');
-        pos = find_if(pos + 2, regex_str.end(), regex_chars);
-    }
-    m_regex.Compile(regex_str.c_str());
 }
 
 Searcher::Depth
@@ -632,23 +591,19 @@ CommandCompletions::SymbolCompleter::SearchCallback(SearchFilter &filter,
 {
     if (context.module_sp)
     {
-        SymbolContextList sc_list;        
-        const bool include_symbols = true;
-        const bool include_inlines = true;
-        const bool append = true;
-        context.module_sp->FindFunctions (m_regex, include_symbols, include_inlines, append, sc_list);
-
-        SymbolContext sc;
-        // Now add the functions & symbols to the list - only add if unique:
-        for (uint32_t i = 0; i < sc_list.GetSize(); i++)
+        // The module sorts the function names into an index the first time
+        // they are completed, every later Tab is a binary search.
+        size_t max_matches = SIZE_MAX;
+        if (m_max_return_elements >= 0)
         {
-            if (sc_list.GetContextAtIndex(i, sc))
-            {
-                ConstString func_name = sc.GetFunctionName(Mangled::ePreferDemangled);
-                if (!func_name.IsEmpty())
-                    m_match_set.insert (func_name);
-            }
+            if (m_match_set.size() >= (size_t)m_max_return_elements)
+                return Searcher::eCallbackReturnStop;
+            max_matches = m_max_return_elements - m_match_set.size();
         }
+
+        std::vector<ConstString> names;
+        context.module_sp->FindFunctionNamesWithPrefix (m_completion_str, max_matches, names);
+        m_match_set.insert (names.begin(), names.end());
     }
     return Searcher::eCallbackReturnContinue;
 }
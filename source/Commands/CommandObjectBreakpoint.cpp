@@ -28,6 +28,7 @@
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Interpreter/CommandCompletions.h"
 #include "lldb/Target/StackFrame.h"
@@ -108,6 +109,7 @@ public:
             m_language (lldb::eLanguageTypeUnknown),
             m_skip_prologue (eLazyBoolCalculate),
             m_one_shot (false),
+            m_count_only (false),
             m_all_files (false),
             m_move_to_nearest_code (eLazyBoolCalculate)
         {
@@ -291,6 +293,10 @@ public:
                     m_one_shot = true;
                     break;
 
+                case 'u':
+                    m_count_only = true;
+                    break;
+
                 case 'O':
                     m_exception_extra_args.AppendArgument ("-O");
                     m_exception_extra_args.AppendArgument (option_arg);
@@ -380,6 +386,7 @@ public:
             m_language = lldb::eLanguageTypeUnknown;
             m_skip_prologue = eLazyBoolCalculate;
             m_one_shot = false;
+            m_count_only = false;
             m_use_dummy = false;
             m_breakpoint_names.clear();
             m_all_files = false;
@@ -424,6 +431,7 @@ public:
         lldb::LanguageType m_language;
         LazyBool m_skip_prologue;
         bool m_one_shot;
+        bool m_count_only;
         bool m_use_dummy;
         bool m_all_files;
         Args m_exception_extra_args;
@@ -673,6 +681,9 @@ protected:
             }
             
             bp->SetOneShot (m_options.m_one_shot);
+
+            if (m_options.m_count_only)
+                bp->SetCounting (true);
         }
         
         if (bp)
@@ -782,6 +793,9 @@ CommandObjectBreakpointSet::CommandOptions::g_option_table[] =
     { LLDB_OPT_SET_ALL, false, "hardware", 'H', OptionParser::eNoArgument, nullptr, nullptr, 0, eArgTypeNone,
         "Require the breakpoint to use hardware breakpoints."},
 
+    { LLDB_OPT_SET_ALL, false, "count-only", 'u', OptionParser::eNoArgument, nullptr, nullptr, 0, eArgTypeNone,
+        "The breakpoint never stops and only counts its hits.  Remote stubs that support it count the hits without stopping the process."},
+
     { LLDB_OPT_SET_ALL, false, "queue-name", 'q', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeQueueName,
         "The breakpoint stops only for threads in the queue whose name is given by this argument."},
 
@@ -928,6 +942,8 @@ public:
             m_queue_passed (false),
             m_condition_passed (false),
             m_one_shot_passed (false),
+            m_count_only (false),
+            m_count_only_passed (false),
             m_use_dummy (false)
         {
         }
@@ -978,6 +994,16 @@ public:
                         error.SetErrorStringWithFormat("invalid boolean value '%s' passed for -o option", option_arg);
                 }
                 break;
+                case 'u':
+                {
+                    bool success;
+                    m_count_only = Args::StringToBoolean(option_arg, false, &success);
+                    if (success)
+                        m_count_only_passed = true;
+                    else
+                        error.SetErrorStringWithFormat("invalid boolean value '%s' passed for -u option", option_arg);
+                }
+                break;
                 case 't' :
                     if (option_arg[0] == '\0')
                     {
@@ -1047,6 +1073,8 @@ public:
             m_name_passed = false;
             m_condition_passed = false;
             m_one_shot_passed = false;
+            m_count_only = false;
+            m_count_only_passed = false;
             m_use_dummy = false;
         }
         
@@ -1077,6 +1105,8 @@ public:
         bool m_queue_passed;
         bool m_condition_passed;
         bool m_one_shot_passed;
+        bool m_count_only;
+        bool m_count_only_passed;
         bool m_use_dummy;
     };
 
@@ -1158,6 +1188,9 @@ protected:
                             
                         if (m_options.m_condition_passed)
                             bp->SetCondition (m_options.m_condition.c_str());
+
+                        if (m_options.m_count_only_passed)
+                            bp->SetCounting (m_options.m_count_only);
                     }
                 }
             }
@@ -1181,6 +1214,7 @@ CommandObjectBreakpointModify::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_ALL, false, "thread-name",  'T', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeThreadName, "The breakpoint stops only for the thread whose thread name matches this argument."},
 { LLDB_OPT_SET_ALL, false, "queue-name",   'q', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeQueueName, "The breakpoint stops only for threads in the queue whose name is given by this argument."},
 { LLDB_OPT_SET_ALL, false, "condition",    'c', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeExpression, "The breakpoint stops only if this condition expression evaluates to true."},
+{ LLDB_OPT_SET_ALL, false, "count-only",   'u', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeBoolean, "If true, the breakpoint never stops and only counts its hits.  Applies to whole breakpoints only."},
 { LLDB_OPT_SET_1,   false, "enable",       'e', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone, "Enable the breakpoint."},
 { LLDB_OPT_SET_2,   false, "disable",      'd', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone, "Disable the breakpoint."},
 { LLDB_OPT_SET_ALL, false, "dummy-breakpoints", 'D', OptionParser::eNoArgument,  nullptr, nullptr, 0, eArgTypeNone, "Sets Dummy breakpoints - i.e. breakpoints set before a file is provided, which prime new targets."},
@@ -1535,6 +1569,11 @@ protected:
             return true;
         }
 
+        // Pick up the hits of counting breakpoints that didn't stop.
+        ProcessSP process_sp (target->GetProcessSP());
+        if (process_sp)
+            process_sp->UpdateBreakpointHitCounts();
+
         Stream &output_stream = result.GetOutputStream();
 
         if (command.GetArgumentCount() == 0)
@@ -21,6 +21,7 @@
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StreamLogBuffer.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/StringConvert.h"
@@ -131,6 +132,8 @@ public:
             case 'n':  log_options |= LLDB_LOG_OPTION_PREPEND_THREAD_NAME;    break;
             case 'S':  log_options |= LLDB_LOG_OPTION_BACKTRACE;              break;
             case 'a':  log_options |= LLDB_LOG_OPTION_APPEND;                 break;
+            case 'A':  log_options |= LLDB_LOG_OPTION_ASYNC;                  break;
+            case 'F':  log_options |= LLDB_LOG_OPTION_FLIGHT_RECORDER;        break;
             default:
                 error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
                 break;
@@ -209,6 +212,8 @@ CommandObjectLogEnable::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_1, false, "thread-name",'n', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,       "Prepend all log lines with the thread name for the thread that generates the log line." },
 { LLDB_OPT_SET_1, false, "stack",      'S', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,       "Append a stack backtrace to each log line." },
 { LLDB_OPT_SET_1, false, "append",     'a', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,       "Append to the log file instead of overwriting." },
+{ LLDB_OPT_SET_1, false, "async",      'A', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone,       "Queue log lines in memory and write them from a background thread, so logging doesn't slow down the threads that log." },
+{ LLDB_OPT_SET_1, false, "flight-recorder", 'F', OptionParser::eNoArgument,  nullptr, nullptr, 0, eArgTypeNone,       "Keep only the most recent log lines in memory and write them out on \"log dump\" or when lldb crashes." },
 { 0, false, nullptr,                       0,  0,                 nullptr, nullptr, 0, eArgTypeNone,       nullptr }
 };
 
@@ -362,6 +367,43 @@ protected:
     }
 };
 
+class CommandObjectLogDump : public CommandObjectParsed
+{
+public:
+    CommandObjectLogDump(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "log dump",
+                             "Write out the log lines kept by the logs enabled with --flight-recorder.",
+                             nullptr)
+    {
+    }
+
+    ~CommandObjectLogDump() override = default;
+
+protected:
+    bool
+    DoExecute (Args& args,
+             CommandReturnObject &result) override
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        if (StreamLogBuffer::DrainFlightRecorders() == 0)
+        {
+            result.AppendError("no logs are enabled with --flight-recorder");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        result.SetStatus(eReturnStatusSuccessFinishNoResult);
+        return result.Succeeded();
+    }
+};
+
 class CommandObjectLogTimer : public CommandObjectParsed
 {
 public:
@@ -372,13 +414,113 @@ public:
         CommandObjectParsed (interpreter,
                            "log timers",
                            "Enable, disable, dump, and reset LLDB internal performance timers.",
-                           "log timers < enable <depth> | disable | dump | increment <bool> | reset >")
+                           "log timers < enable <depth> | disable | dump [--format <text|chrome-trace>] [--outfile <file>] | increment <bool> | reset >"),
+        m_options (interpreter)
     {
     }
 
     ~CommandObjectLogTimer() override = default;
 
+    Options *
+    GetOptions () override
+    {
+        return &m_options;
+    }
+
+    enum DumpFormat
+    {
+        eDumpFormatText,
+        eDumpFormatChromeTrace
+    };
+
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            dump_format (eDumpFormatText),
+            outfile ()
+        {
+        }
+
+        ~CommandOptions () override = default;
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg) override
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+            case 'f':
+                dump_format = (DumpFormat) Args::StringToOptionEnum (option_arg,
+                                                                     g_option_table[option_idx].enum_values,
+                                                                     eDumpFormatText,
+                                                                     error);
+                break;
+            case 'o':
+                outfile.SetFile(option_arg, true);
+                break;
+            default:
+                error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                break;
+            }
+
+            return error;
+        }
+
+        void
+        OptionParsingStarting () override
+        {
+            dump_format = eDumpFormatText;
+            outfile.Clear();
+        }
+
+        const OptionDefinition*
+        GetDefinitions () override
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+
+        DumpFormat dump_format;
+        FileSpec outfile;
+    };
+
 protected:
+    void
+    DumpTimers (CommandReturnObject &result)
+    {
+        Stream *strm = &result.GetOutputStream();
+        std::unique_ptr<StreamFile> file_strm;
+        if (m_options.outfile)
+        {
+            char path[PATH_MAX];
+            m_options.outfile.GetPath(path, sizeof(path));
+            file_strm.reset(new StreamFile(path, File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec,
+                                           lldb::eFilePermissionsFileDefault));
+            if (!file_strm->GetFile().IsValid())
+            {
+                result.AppendErrorWithFormat("Couldn't open '%s' for writing.\n", path);
+                return;
+            }
+            strm = file_strm.get();
+        }
+
+        if (m_options.dump_format == eDumpFormatChromeTrace)
+            Timer::DumpChromeTrace (strm);
+        else
+            Timer::DumpCategoryTimes (strm);
+        strm->Flush();
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+    }
+
     bool
     DoExecute (Args& args,
              CommandReturnObject &result) override
@@ -403,8 +545,7 @@ protected:
             }
             else if (strcasecmp(sub_command, "dump") == 0)
             {
-                Timer::DumpCategoryTimes (&result.GetOutputStream());
-                result.SetStatus(eReturnStatusSuccessFinishResult);
+                DumpTimers (result);
             }
             else if (strcasecmp(sub_command, "reset") == 0)
             {
@@ -449,6 +590,24 @@ protected:
         }
         return result.Succeeded();
     }
+
+    CommandOptions m_options;
+};
+
+static OptionEnumValueElement
+g_timer_dump_format_enumeration[] =
+{
+    { CommandObjectLogTimer::eDumpFormatText,        "text",         "The total time of each timer category."},
+    { CommandObjectLogTimer::eDumpFormatChromeTrace, "chrome-trace", "Every timer of every thread as a Chrome trace event JSON file."},
+    { 0,                                             nullptr,        nullptr }
+};
+
+OptionDefinition
+CommandObjectLogTimer::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "format",  'f', OptionParser::eRequiredArgument, nullptr, g_timer_dump_format_enumeration, 0, eArgTypeNone,     "The format for \"log timers dump\"."},
+{ LLDB_OPT_SET_1, false, "outfile", 'o', OptionParser::eRequiredArgument, nullptr, nullptr,                         0, eArgTypeFilename, "Write \"log timers dump\" to this file instead of the command output."},
+{ 0, false, nullptr,                    0,  0,                 nullptr, nullptr,                         0, eArgTypeNone,     nullptr }
 };
 
 CommandObjectLog::CommandObjectLog(CommandInterpreter &interpreter) :
@@ -461,6 +620,7 @@ CommandObjectLog::CommandObjectLog(CommandInterpreter &interpreter) :
     LoadSubCommand ("disable", CommandObjectSP (new CommandObjectLogDisable (interpreter)));
     LoadSubCommand ("list",    CommandObjectSP (new CommandObjectLogList (interpreter)));
     LoadSubCommand ("timers",  CommandObjectSP (new CommandObjectLogTimer (interpreter)));
+    LoadSubCommand ("dump",    CommandObjectSP (new CommandObjectLogDump (interpreter)));
 }
 
 CommandObjectLog::~CommandObjectLog() = default;
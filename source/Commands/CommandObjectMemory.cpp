@@ -11,6 +11,9 @@
 #include <inttypes.h>
 
 // C++ Includes
+#include <deque>
+#include <vector>
+
 // Other libraries and framework includes
 #include "clang/AST/Decl.h"
 
@@ -20,26 +23,31 @@
 #include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/State.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/ValueObjectMemory.h"
 #include "lldb/DataFormatters/ValueObjectPrinter.h"
 #include "Plugins/ExpressionParser/Clang/ClangPersistentVariables.h"
 #include "lldb/Host/StringConvert.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Interpreter/OptionGroupFormat.h"
 #include "lldb/Interpreter/OptionGroupOutputFile.h"
+#include "lldb/Interpreter/OptionGroupUInt64.h"
 #include "lldb/Interpreter/OptionGroupValueObjectDisplay.h"
 #include "lldb/Interpreter/OptionValueString.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/TypeList.h"
 #include "lldb/Symbol/SymbolFile.h"
 #include "lldb/Target/MemoryHistory.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Thread.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "lldb/lldb-private.h"
 
@@ -56,6 +64,7 @@ g_option_table[] =
     { LLDB_OPT_SET_1|
       LLDB_OPT_SET_2|
       LLDB_OPT_SET_3, false, "force"        ,'r', OptionParser::eNoArgument,       nullptr, nullptr, 0, eArgTypeNone          ,"Necessary if reading over target.max-memory-read-size bytes."},
+    { LLDB_OPT_SET_2, false, "stream"       ,'w', OptionParser::eNoArgument      , nullptr, nullptr, 0, eArgTypeNone          ,"Used with --binary and --outfile. Read the memory in chunks and write each one to the file as it arrives, so the size isn't limited by target.max-memory-read-size. Pages that can't be read are written as zeros and listed."},
 };
 
 class OptionGroupReadMemory : public OptionGroup
@@ -65,7 +74,8 @@ public:
         m_num_per_line (1,1),
         m_output_as_binary (false),
         m_view_as_type(),
-        m_offset(0,0)
+        m_offset(0,0),
+        m_stream (false)
     {
     }
 
@@ -114,6 +124,10 @@ public:
             case 'E':
                 error = m_offset.SetValueFromString(option_arg);
                 break;
+
+            case 'w':
+                m_stream = true;
+                break;
                 
             default:
                 error.SetErrorStringWithFormat("unrecognized short option '%c'", short_option);
@@ -130,6 +144,7 @@ public:
         m_view_as_type.Clear();
         m_force = false;
         m_offset.Clear();
+        m_stream = false;
     }
     
     Error
@@ -300,7 +315,8 @@ public:
         return m_num_per_line.OptionWasSet() ||
                m_output_as_binary ||
                m_view_as_type.OptionWasSet() ||
-               m_offset.OptionWasSet();
+               m_offset.OptionWasSet() ||
+               m_stream;
     }
     
     OptionValueUInt64 m_num_per_line;
@@ -308,8 +324,154 @@ public:
     OptionValueString m_view_as_type;
     bool m_force;
     OptionValueUInt64 m_offset;
+    bool m_stream;
 };
 
+namespace {
+
+// A chunk of a streamed memory read and the ranges in it that couldn't
+// be read, which are zero in the buffer.
+struct StreamedMemoryChunk
+{
+    lldb::addr_t addr;
+    std::vector<uint8_t> bytes;
+    std::vector<std::pair<lldb::addr_t, lldb::addr_t>> unreadable;
+};
+
+} // anonymous namespace
+
+static StreamedMemoryChunk
+ReadStreamedMemoryChunk (Process *process, lldb::addr_t addr, size_t size)
+{
+    // Unreadable memory is skipped a page at a time, or up to the end of
+    // the region when the process knows it isn't readable.
+    const lldb::addr_t page_size = 0x1000;
+
+    StreamedMemoryChunk chunk;
+    chunk.addr = addr;
+    chunk.bytes.resize (size, 0);
+    const lldb::addr_t end_addr = addr + size;
+    lldb::addr_t curr_addr = addr;
+    while (curr_addr < end_addr)
+    {
+        Error error;
+        curr_addr += process->ReadMemoryFromInferior (curr_addr, &chunk.bytes[curr_addr - addr], end_addr - curr_addr, error);
+        if (curr_addr >= end_addr)
+            break;
+
+        lldb::addr_t skip_end = (curr_addr + page_size) & ~(page_size - 1);
+        MemoryRegionInfo region_info;
+        if (process->GetMemoryRegionInfo (curr_addr, region_info).Success() &&
+            region_info.GetReadable() == MemoryRegionInfo::eNo &&
+            region_info.GetRange().GetRangeEnd() > skip_end)
+            skip_end = region_info.GetRange().GetRangeEnd();
+        if (skip_end > end_addr)
+            skip_end = end_addr;
+
+        if (!chunk.unreadable.empty() && chunk.unreadable.back().second == curr_addr)
+            chunk.unreadable.back().second = skip_end;
+        else
+            chunk.unreadable.push_back (std::make_pair (curr_addr, skip_end));
+        curr_addr = skip_end;
+    }
+    return chunk;
+}
+
+//----------------------------------------------------------------------
+// Read [addr, addr + size) and write it to file without holding more than
+// a few chunks of it in memory. The process gets up to
+// GetMaxConcurrentMemoryReads() chunk reads at the same time, so a remote
+// connection can have several memory packets in flight.
+//----------------------------------------------------------------------
+static bool
+StreamMemoryToFile (Process *process,
+                    lldb::addr_t addr,
+                    size_t size,
+                    File &file,
+                    const char *path,
+                    bool append,
+                    CommandReturnObject &result)
+{
+    const size_t chunk_size = 1024 * 1024;
+    const size_t max_chunks_in_flight = std::max<uint32_t> (process->GetMaxConcurrentMemoryReads(), 1);
+
+    const TimeValue start_time = TimeValue::Now();
+    const lldb::addr_t end_addr = addr + size;
+    lldb::addr_t next_chunk_addr = addr;
+    std::deque<std::future<StreamedMemoryChunk>> chunks_in_flight;
+    std::vector<std::pair<lldb::addr_t, lldb::addr_t>> unreadable;
+    uint64_t bytes_written = 0;
+    uint64_t bytes_unreadable = 0;
+    Error error;
+
+    while (next_chunk_addr < end_addr || !chunks_in_flight.empty())
+    {
+        while (error.Success() && next_chunk_addr < end_addr && chunks_in_flight.size() < max_chunks_in_flight)
+        {
+            const size_t curr_size = std::min<lldb::addr_t> (chunk_size, end_addr - next_chunk_addr);
+            chunks_in_flight.push_back (TaskPool::AddTask (ReadStreamedMemoryChunk, process, next_chunk_addr, curr_size));
+            next_chunk_addr += curr_size;
+        }
+        if (chunks_in_flight.empty())
+            break;
+
+        // The chunks are written in order, the ones after the first one keep
+        // being read meanwhile.
+        StreamedMemoryChunk chunk = chunks_in_flight.front().get();
+        chunks_in_flight.pop_front();
+        if (error.Fail())
+            continue;
+
+        for (const auto &range : chunk.unreadable)
+        {
+            bytes_unreadable += range.second - range.first;
+            if (!unreadable.empty() && unreadable.back().second == range.first)
+                unreadable.back().second = range.second;
+            else
+                unreadable.push_back (range);
+        }
+
+        size_t num_bytes = chunk.bytes.size();
+        error = file.Write (chunk.bytes.data(), num_bytes);
+        bytes_written += num_bytes;
+        if (error.Success() && num_bytes != chunk.bytes.size())
+            error.SetErrorString ("the file is full");
+    }
+
+    const double elapsed_sec = (double)(TimeValue::Now() - start_time) / TimeValue::NanoSecPerSec;
+
+    if (error.Fail())
+    {
+        result.AppendErrorWithFormat ("Failed to write to '%s' after %" PRIu64 " bytes: %s\n", path, bytes_written, error.AsCString());
+        result.SetStatus (eReturnStatusFailed);
+        return false;
+    }
+    if (bytes_unreadable == size)
+    {
+        result.AppendErrorWithFormat ("failed to read memory from 0x%" PRIx64 ".\n", addr);
+        result.SetStatus (eReturnStatusFailed);
+        return false;
+    }
+
+    Stream &strm = result.GetOutputStream();
+    strm.Printf ("%" PRIu64 " bytes %s to '%s' in %.3f seconds (%.1f MB/sec)\n",
+                 bytes_written,
+                 append ? "appended" : "written",
+                 path,
+                 elapsed_sec,
+                 elapsed_sec > 0 ? bytes_written / elapsed_sec / (1024 * 1024) : 0.0);
+    if (!unreadable.empty())
+    {
+        result.AppendWarningWithFormat ("%" PRIu64 " bytes in %" PRIu64 " ranges couldn't be read and were written as zeros:\n",
+                                        bytes_unreadable, (uint64_t)unreadable.size());
+        for (const auto &range : unreadable)
+            strm.Printf ("  [0x%" PRIx64 "-0x%" PRIx64 ") at file offset 0x%" PRIx64 "\n",
+                         range.first, range.second, range.first - addr);
+    }
+    result.SetStatus (eReturnStatusSuccessFinishResult);
+    return true;
+}
+
 //----------------------------------------------------------------------
 // Read memory from the inferior process
 //----------------------------------------------------------------------
@@ -687,9 +849,25 @@ protected:
             item_count = total_byte_size / item_byte_size;
         }
 
+        const bool stream_to_file = m_memory_options.m_stream;
+        if (stream_to_file && (!m_memory_options.m_output_as_binary || !m_outfile_options.GetFile().OptionWasSet()))
+        {
+            result.AppendError("--stream needs --binary and --outfile.\n");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        Process *process = m_exe_ctx.GetProcessPtr();
+        if (stream_to_file && (process == nullptr || !process->IsAlive()))
+        {
+            result.AppendError("--stream needs a live process.\n");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
         uint32_t max_unforced_size = target->GetMaximumMemReadSize();
         
-        if (total_byte_size > max_unforced_size && !m_memory_options.m_force)
+        if (total_byte_size > max_unforced_size && !m_memory_options.m_force && !stream_to_file)
         {
             result.AppendErrorWithFormat("Normally, \'memory read\' will not read over %" PRIu32 " bytes of data.\n",max_unforced_size);
             result.AppendErrorWithFormat("Please use --force to override this restriction just once.\n");
@@ -697,6 +875,34 @@ protected:
             return false;
         }
         
+        if (stream_to_file)
+        {
+            char path[PATH_MAX];
+            m_outfile_options.GetFile().GetCurrentValue().GetPath (path, sizeof(path));
+
+            uint32_t open_options = File::eOpenOptionWrite | File::eOpenOptionCanCreate;
+            const bool append = m_outfile_options.GetAppend().GetCurrentValue();
+            if (append)
+                open_options |= File::eOpenOptionAppend;
+
+            File outfile;
+            if (outfile.Open (path, open_options).Fail())
+            {
+                result.AppendErrorWithFormat("Failed to open file '%s' for %s.\n", path, append ? "append" : "write");
+                result.SetStatus(eReturnStatusFailed);
+                return false;
+            }
+
+            m_next_addr = addr + total_byte_size;
+            m_prev_byte_size = total_byte_size;
+            m_prev_format_options = m_format_options;
+            m_prev_memory_options = m_memory_options;
+            m_prev_outfile_options = m_outfile_options;
+            m_prev_varobj_options = m_varobj_options;
+            m_prev_clang_ast_type = clang_ast_type;
+            return StreamMemoryToFile (process, addr, total_byte_size, outfile, path, append, result);
+        }
+
         DataBufferSP data_sp;
         size_t bytes_read = 0;
         if (clang_ast_type.GetOpaqueQualType())
@@ -1220,20 +1426,10 @@ protected:
             uint8_t* buffer,
             size_t buffer_size)
     {
+        // The process reads the memory in large chunks, or has the remote
+        // stub do the search.
         Process *process = m_exe_ctx.GetProcessPtr();
-        DataBufferHeap heap(buffer_size, 0);
-        for (auto ptr = low;
-             ptr < high;
-             ptr++)
-        {
-            Error error;
-            process->ReadMemory(ptr, heap.GetBytes(), buffer_size, error);
-            if (error.Fail())
-                return LLDB_INVALID_ADDRESS;
-            if (memcmp(heap.GetBytes(), buffer, buffer_size) == 0)
-                return ptr;
-        }
-        return LLDB_INVALID_ADDRESS;
+        return process->FindInMemory(low, high, buffer, buffer_size);
     }
   
     OptionGroupOptions m_option_group;
@@ -1766,6 +1962,175 @@ protected:
     }
 };
 
+//----------------------------------------------------------------------
+// Find the pointers to an address in the writable memory of the process.
+//----------------------------------------------------------------------
+class CommandObjectMemoryFindRefs : public CommandObjectParsed
+{
+public:
+    CommandObjectMemoryFindRefs (CommandInterpreter &interpreter) :
+        CommandObjectParsed(interpreter,
+                            "memory find-refs",
+                            "Find the pointer sized values in the writable memory of the process that point to an address, and show where each of them lives.",
+                            nullptr,
+                            eCommandRequiresTarget | eCommandRequiresProcess | eCommandProcessMustBePaused |
+                            eCommandProcessMustBeLaunched),
+        m_option_group (interpreter),
+        m_count_option (LLDB_OPT_SET_1, false, "count", 'c', 0, eArgTypeCount,
+                        "The maximum number of references to show.", 1000)
+    {
+        CommandArgumentEntry arg1;
+        CommandArgumentData addr_arg;
+
+        // Define the first (and only) variant of this arg.
+        addr_arg.arg_type = eArgTypeAddressOrExpression;
+        addr_arg.arg_repetition = eArgRepeatPlain;
+
+        // There is only one variant this argument could be; put it into the argument entry.
+        arg1.push_back (addr_arg);
+
+        // Push the data for the first argument into the m_arguments vector.
+        m_arguments.push_back (arg1);
+
+        m_option_group.Append (&m_count_option, LLDB_OPT_SET_ALL, LLDB_OPT_SET_1);
+        m_option_group.Finalize();
+    }
+
+    ~CommandObjectMemoryFindRefs() override = default;
+
+    Options *
+    GetOptions () override
+    {
+        return &m_option_group;
+    }
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        if (command.GetArgumentCount() != 1)
+        {
+            result.AppendErrorWithFormat ("%s takes an address expression", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        Error error;
+        lldb::addr_t addr = Args::StringToAddress (&m_exe_ctx,
+                                                   command.GetArgumentAtIndex(0),
+                                                   LLDB_INVALID_ADDRESS,
+                                                   &error);
+        if (addr == LLDB_INVALID_ADDRESS)
+        {
+            result.AppendError("invalid address expression");
+            result.AppendError(error.AsCString());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        Process &process = m_exe_ctx.GetProcessRef();
+        std::vector<lldb::addr_t> matches;
+        error = process.FindReferences (addr, m_count_option.GetOptionValue().GetCurrentValue(), matches);
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("failed to scan the memory of the process: %s", error.AsCString());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        Stream &strm = result.GetOutputStream();
+        if (matches.empty())
+        {
+            strm.Printf ("No references to 0x%" PRIx64 " found.\n", addr);
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+            return true;
+        }
+
+        std::vector<std::string> descriptions;
+        process.DescribeMemoryLocations (matches, descriptions);
+        for (size_t i = 0; i < matches.size(); ++i)
+        {
+            if (descriptions[i].empty())
+                strm.Printf ("0x%16.16" PRIx64 "\n", matches[i]);
+            else
+                strm.Printf ("0x%16.16" PRIx64 " %s\n", matches[i], descriptions[i].c_str());
+        }
+        strm.Printf ("%" PRIu64 " reference%s to 0x%" PRIx64 " found.\n", (uint64_t)matches.size(),
+                     matches.size() == 1 ? "" : "s", addr);
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    OptionGroupOptions m_option_group;
+    OptionGroupUInt64 m_count_option;
+};
+
+//----------------------------------------------------------------------
+// Show the memory lldb allocated in the process for expressions
+//----------------------------------------------------------------------
+class CommandObjectMemoryStats : public CommandObjectParsed
+{
+public:
+    CommandObjectMemoryStats (CommandInterpreter &interpreter) :
+        CommandObjectParsed(interpreter,
+                            "memory stats",
+                            "Show the memory lldb has allocated in the current process for expressions and how much of it is in use.",
+                            nullptr,
+                            eCommandRequiresProcess | eCommandProcessMustBeLaunched)
+    {
+    }
+
+    ~CommandObjectMemoryStats() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        AllocatedMemoryCache::Statistics stats = m_exe_ctx.GetProcessRef().GetAllocatedMemoryStatistics();
+        Stream &strm = result.GetOutputStream();
+        strm.Printf("Allocations: %" PRIu64 "\n", stats.num_allocations);
+        strm.Printf("Deallocations: %" PRIu64 "\n", stats.num_deallocations);
+        strm.Printf("Blocks allocated in the process: %" PRIu64 "\n", stats.num_process_allocations);
+        strm.Printf("Bytes reserved: %" PRIu64 "\n", stats.bytes_reserved);
+        strm.Printf("Bytes in use: %" PRIu64 "\n", stats.bytes_in_use);
+        for (const AllocatedMemoryCache::BlockStatistics &block : stats.blocks)
+        {
+            strm.Printf("    [0x%16.16" PRIx64 "-0x%16.16" PRIx64 ") %s %u of %u bytes in use\n",
+                        block.addr,
+                        block.addr + block.byte_size,
+                        GetPermissionsAsCString(block.permissions),
+                        block.bytes_in_use,
+                        block.byte_size);
+        }
+
+        MemoryCache::Statistics cache_stats = m_exe_ctx.GetProcessRef().GetMemoryCacheStatistics();
+        const uint64_t num_cache_reads = cache_stats.num_L1_hits + cache_stats.num_L2_hits + cache_stats.num_misses;
+        strm.Printf("Memory cache reads: %" PRIu64 "\n", num_cache_reads);
+        strm.Printf("    L1 hits: %" PRIu64 "\n", cache_stats.num_L1_hits);
+        strm.Printf("    L2 hits: %" PRIu64 "\n", cache_stats.num_L2_hits);
+        strm.Printf("    Misses: %" PRIu64 "\n", cache_stats.num_misses);
+        if (num_cache_reads > 0)
+            strm.Printf("    Hit rate: %.1f%%\n", 100.0 * (num_cache_reads - cache_stats.num_misses) / num_cache_reads);
+        strm.Printf("Memory cache prefetches: %" PRIu64 "\n", cache_stats.num_prefetches);
+        strm.Printf("Memory cache reads from the process: %" PRIu64 " (%" PRIu64 " bytes)\n",
+                    cache_stats.num_inferior_reads, cache_stats.inferior_bytes_read);
+        strm.Printf("Memory cache reads from module files: %" PRIu64 " (%" PRIu64 " file backed ranges)\n",
+                    cache_stats.num_file_reads, cache_stats.num_file_backed_ranges);
+        strm.Printf("Memory cache lines: %" PRIu64 " (%" PRIu64 " bytes, %" PRIu64 " evicted)\n",
+                    cache_stats.num_cached_lines, cache_stats.cached_bytes, cache_stats.num_evictions);
+
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return result.Succeeded();
+    }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectMemory
 //-------------------------------------------------------------------------
@@ -1777,9 +2142,11 @@ CommandObjectMemory::CommandObjectMemory (CommandInterpreter &interpreter) :
                             "memory <subcommand> [<subcommand-options>]")
 {
     LoadSubCommand ("find", CommandObjectSP (new CommandObjectMemoryFind (interpreter)));
+    LoadSubCommand ("find-refs", CommandObjectSP (new CommandObjectMemoryFindRefs (interpreter)));
     LoadSubCommand ("read",  CommandObjectSP (new CommandObjectMemoryRead (interpreter)));
     LoadSubCommand ("write", CommandObjectSP (new CommandObjectMemoryWrite (interpreter)));
     LoadSubCommand ("history", CommandObjectSP (new CommandObjectMemoryHistory (interpreter)));
+    LoadSubCommand ("stats", CommandObjectSP (new CommandObjectMemoryStats (interpreter)));
 }
 
 CommandObjectMemory::~CommandObjectMemory() = default;
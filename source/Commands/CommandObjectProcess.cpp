@@ -24,8 +24,11 @@
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/FastTracepoint.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -807,6 +810,225 @@ CommandObjectProcessContinue::CommandOptions::g_option_table[] =
 { 0, false, nullptr, 0, 0, nullptr, nullptr, 0, eArgTypeNone, nullptr }
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectProcessSample
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessSample
+
+class CommandObjectProcessSample : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessSample (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process sample",
+                             "Let the process run for a while and sample the stacks of all its threads. "
+                             "The stacks are printed in the folded format flame graph tools read, "
+                             "one line per distinct stack with the number of samples that hit it.",
+                             "process sample [-d <milliseconds>] [-f <frequency>]",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   ),
+        m_options(interpreter)
+    {
+    }
+
+    ~CommandObjectProcessSample() override = default;
+
+    Options *
+    GetOptions () override
+    {
+        return &m_options;
+    }
+
+protected:
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options(interpreter)
+        {
+            // Keep default values of all options in one place: OptionParsingStarting ()
+            OptionParsingStarting ();
+        }
+
+        ~CommandOptions() override = default;
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg) override
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+            bool success = false;
+            switch (short_option)
+            {
+                case 'd':
+                    m_duration_ms = StringConvert::ToUInt32 (option_arg, 0, 0, &success);
+                    if (!success || m_duration_ms == 0)
+                        error.SetErrorStringWithFormat ("invalid duration: \"%s\", should be a number of milliseconds.", option_arg);
+                    break;
+
+                case 'f':
+                    m_frequency = StringConvert::ToUInt32 (option_arg, 0, 0, &success);
+                    if (!success || m_frequency == 0 || m_frequency > 10000)
+                        error.SetErrorStringWithFormat ("invalid frequency: \"%s\", should be between 1 and 10000.", option_arg);
+                    break;
+
+                default:
+                    error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
+                    break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting () override
+        {
+            m_duration_ms = 1000;
+            m_frequency = 100;
+        }
+
+        const OptionDefinition*
+        GetDefinitions () override
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        uint32_t m_duration_ms;
+        uint32_t m_frequency;
+    };
+
+    // The name of the function containing \a load_addr, or the address
+    // itself if there are no symbols for it.
+    static std::string
+    GetFrameName (Target &target, lldb::addr_t load_addr)
+    {
+        Address so_addr;
+        if (target.GetSectionLoadList().ResolveLoadAddress (load_addr, so_addr))
+        {
+            SymbolContext sc;
+            so_addr.CalculateSymbolContext (&sc, eSymbolContextFunction | eSymbolContextSymbol);
+            ConstString name (sc.GetFunctionName ());
+            if (name)
+                return name.GetCString ();
+
+            ModuleSP module_sp (so_addr.GetModule ());
+            if (module_sp)
+            {
+                StreamString strm;
+                strm.Printf ("%s`0x%" PRIx64, module_sp->GetFileSpec().GetFilename().AsCString("<unknown>"), so_addr.GetFileAddress ());
+                return strm.GetString ();
+            }
+        }
+
+        StreamString strm;
+        strm.Printf ("0x%" PRIx64, load_addr);
+        return strm.GetString ();
+    }
+
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+        Target &target = process->GetTarget();
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("The '%s' command does not take any arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error = process->SampleNextResume (m_options.m_duration_ms, m_options.m_frequency);
+        if (error.Fail ())
+        {
+            result.AppendErrorWithFormat ("Failed to start sampling: %s.\n", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        {  // Scope for thread list mutex:
+            std::lock_guard<std::recursive_mutex> guard(process->GetThreadList().GetMutex());
+            const uint32_t num_threads = process->GetThreadList().GetSize();
+            for (uint32_t idx=0; idx<num_threads; ++idx)
+            {
+                const bool override_suspend = false;
+                process->GetThreadList().GetThreadAtIndex(idx)->SetResumeState (eStateRunning, override_suspend);
+            }
+        }
+
+        // The samples are only complete once the process stopped again.
+        StreamString stream;
+        error = process->ResumeSynchronous (&stream);
+        result.SetDidChangeProcessState (true);
+        if (error.Fail ())
+        {
+            result.AppendErrorWithFormat ("Failed to resume process: %s.\n", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        if (stream.GetData())
+            result.AppendMessage(stream.GetData());
+
+        std::vector<std::pair<lldb::tid_t, std::vector<lldb::addr_t>>> samples;
+        error = process->GetSamples (samples);
+        if (error.Fail ())
+        {
+            result.AppendErrorWithFormat ("Failed to read the samples: %s.\n", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        // Fold the samples into one line per stack, outermost frame first.
+        std::map<lldb::addr_t, std::string> frame_names;
+        std::map<std::string, uint64_t> stack_counts;
+        for (const auto &sample : samples)
+        {
+            std::string stack;
+            for (size_t i = sample.second.size(); i-- > 0;)
+            {
+                // Every frame but the innermost one is a return address,
+                // look up the call before it.
+                lldb::addr_t addr = sample.second[i];
+                if (i > 0 && addr > 0)
+                    --addr;
+
+                auto pos = frame_names.find (addr);
+                if (pos == frame_names.end ())
+                    pos = frame_names.insert (std::make_pair (addr, GetFrameName (target, addr))).first;
+
+                if (!stack.empty ())
+                    stack.push_back (';');
+                stack.append (pos->second);
+            }
+            ++stack_counts[stack];
+        }
+
+        Stream &output = result.GetOutputStream();
+        for (const auto &entry : stack_counts)
+            output.Printf ("%s %" PRIu64 "\n", entry.first.c_str(), entry.second);
+        result.AppendMessageWithFormat ("%" PRIu64 " samples, %" PRIu64 " distinct stacks\n",
+                                        static_cast<uint64_t>(samples.size()), static_cast<uint64_t>(stack_counts.size()));
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectProcessSample::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_ALL, false, "duration", 'd', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeUnsignedInteger,
+                           "How long to sample for in milliseconds, 1000 by default."},
+{ LLDB_OPT_SET_ALL, false, "frequency", 'f', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeUnsignedInteger,
+                           "How many samples to take per second, 100 by default."},
+{ 0, false, nullptr, 0, 0, nullptr, nullptr, 0, eArgTypeNone, nullptr }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectProcessDetach
 //-------------------------------------------------------------------------
@@ -1485,6 +1707,70 @@ protected:
     }
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectProcessSaveTriage
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessSaveTriage
+
+class CommandObjectProcessSaveTriage : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessSaveTriage (CommandInterpreter &interpreter) :
+    CommandObjectParsed (interpreter,
+                         "process save-triage",
+                         "Save the loaded modules and the symbolicated backtraces of all threads as a compact crash triage record.",
+                         "process save-triage FILE [MAX-FRAMES]",
+                         eCommandRequiresProcess      |
+                         eCommandTryTargetAPILock     |
+                         eCommandProcessMustBeLaunched |
+                         eCommandProcessMustBePaused)
+    {
+    }
+
+    ~CommandObjectProcessSaveTriage() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command,
+               CommandReturnObject &result) override
+    {
+        ProcessSP process_sp = m_exe_ctx.GetProcessSP();
+        const size_t argc = command.GetArgumentCount();
+        if (argc != 1 && argc != 2)
+        {
+            result.AppendErrorWithFormat ("'%s' takes one or two arguments:\nUsage: %s\n",
+                                          m_cmd_name.c_str(),
+                                          m_cmd_syntax.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        uint32_t max_frames = UINT32_MAX;
+        if (argc == 2)
+        {
+            bool success = false;
+            max_frames = StringConvert::ToUInt32 (command.GetArgumentAtIndex(1), 0, 0, &success);
+            if (!success || max_frames == 0)
+            {
+                result.AppendErrorWithFormat ("invalid frame count '%s'\n", command.GetArgumentAtIndex(1));
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+        }
+
+        FileSpec output_file(command.GetArgumentAtIndex(0), true);
+        Error error = process_sp->SaveTriageRecord (output_file, max_frames);
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("Failed to save triage record for process: %s\n", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectProcessSaveCore
 //-------------------------------------------------------------------------
@@ -1885,6 +2171,404 @@ CommandObjectProcessHandle::CommandOptions::g_option_table[] =
 { 0, false, nullptr, 0, 0, nullptr, nullptr, 0, eArgTypeNone, nullptr }
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectProcessFastTracepointAdd
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessFastTracepointAdd
+
+class CommandObjectProcessFastTracepointAdd : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessFastTracepointAdd (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process fast-tracepoint add",
+                             "Record the registers each time an address is executed, without stopping the process.  "
+                             "The instructions at the address are replaced by a jump to a trampoline in the process "
+                             "that saves the registers into a ring buffer of <capacity> samples (default 1024).",
+                             "process fast-tracepoint add <address> [<capacity>]",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   )
+    {
+    }
+
+    ~CommandObjectProcessFastTracepointAdd() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+
+        const size_t argc = command.GetArgumentCount();
+        if (argc < 1 || argc > 2)
+        {
+            result.AppendErrorWithFormat ("'%s' takes an address and an optional capacity", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error;
+        const addr_t addr = Args::StringToAddress (&m_exe_ctx, command.GetArgumentAtIndex(0), LLDB_INVALID_ADDRESS, &error);
+        if (addr == LLDB_INVALID_ADDRESS)
+        {
+            result.AppendErrorWithFormat ("invalid address argument '%s'", command.GetArgumentAtIndex(0));
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        uint32_t capacity = 1024;
+        if (argc == 2)
+        {
+            bool success = false;
+            capacity = StringConvert::ToUInt32 (command.GetArgumentAtIndex(1), 0, 0, &success);
+            if (!success || capacity == 0)
+            {
+                result.AppendErrorWithFormat ("invalid capacity argument '%s'", command.GetArgumentAtIndex(1));
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+        }
+
+        const user_id_t id = process->CreateFastTracepoint (addr, capacity, error);
+        if (id == LLDB_INVALID_UID)
+        {
+            result.AppendErrorWithFormat ("failed to install fast tracepoint: %s", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        FastTracepointSP tracepoint_sp (process->GetFastTracepointByID (id));
+        result.AppendMessageWithFormat ("Fast tracepoint %" PRIu64 " at 0x%" PRIx64 ", %u samples\n",
+                                        id, addr, tracepoint_sp->GetCapacity());
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessFastTracepointDelete
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessFastTracepointDelete
+
+class CommandObjectProcessFastTracepointDelete : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessFastTracepointDelete (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process fast-tracepoint delete",
+                             "Restore the instructions patched by fast tracepoints.",
+                             "process fast-tracepoint delete <id> [<id> [...]]",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   )
+    {
+    }
+
+    ~CommandObjectProcessFastTracepointDelete() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+
+        const size_t argc = command.GetArgumentCount();
+        if (argc == 0)
+        {
+            result.AppendErrorWithFormat ("'%s' takes one or more fast tracepoint IDs", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        for (size_t i = 0; i < argc; ++i)
+        {
+            const char *id_cstr = command.GetArgumentAtIndex(i);
+            const user_id_t id = StringConvert::ToUInt64 (id_cstr, LLDB_INVALID_UID, 0);
+            Error error (process->RemoveFastTracepoint (id));
+            if (error.Fail())
+            {
+                result.AppendErrorWithFormat ("failed to delete fast tracepoint '%s': %s", id_cstr, error.AsCString());
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
+            result.AppendMessageWithFormat ("Fast tracepoint %" PRIu64 " deleted\n", id);
+        }
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessFastTracepointList
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessFastTracepointList
+
+class CommandObjectProcessFastTracepointList : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessFastTracepointList (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process fast-tracepoint list",
+                             "List the fast tracepoints and how many times they were hit.",
+                             "process fast-tracepoint list",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   )
+    {
+    }
+
+    ~CommandObjectProcessFastTracepointList() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+        Stream &strm = result.GetOutputStream();
+
+        const size_t num_tracepoints = process->GetNumFastTracepoints();
+        if (num_tracepoints == 0)
+            strm.PutCString ("No fast tracepoints.\n");
+
+        for (size_t i = 0; i < num_tracepoints; ++i)
+        {
+            FastTracepointSP tracepoint_sp (process->GetFastTracepointAtIndex (i));
+            std::vector<FastTracepoint::Sample> samples;
+            uint64_t total_hits = 0;
+            Error error (tracepoint_sp->ReadSamples (samples, total_hits));
+            strm.Printf ("%" PRIu64 ": address = 0x%" PRIx64 ", capacity = %u, hits = ",
+                         tracepoint_sp->GetID(), tracepoint_sp->GetLoadAddress(), tracepoint_sp->GetCapacity());
+            if (error.Success())
+                strm.Printf ("%" PRIu64 "\n", total_hits);
+            else
+                strm.Printf ("<%s>\n", error.AsCString());
+        }
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessFastTracepointDump
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessFastTracepointDump
+
+class CommandObjectProcessFastTracepointDump : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessFastTracepointDump (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process fast-tracepoint dump",
+                             "Show the registers recorded by a fast tracepoint, oldest first.",
+                             "process fast-tracepoint dump <id>",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   )
+    {
+    }
+
+    ~CommandObjectProcessFastTracepointDump() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+
+        if (command.GetArgumentCount() != 1)
+        {
+            result.AppendErrorWithFormat ("'%s' takes a fast tracepoint ID", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        const user_id_t id = StringConvert::ToUInt64 (command.GetArgumentAtIndex(0), LLDB_INVALID_UID, 0);
+        FastTracepointSP tracepoint_sp (process->GetFastTracepointByID (id));
+        if (!tracepoint_sp)
+        {
+            result.AppendErrorWithFormat ("invalid fast tracepoint ID '%s'", command.GetArgumentAtIndex(0));
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        std::vector<FastTracepoint::Sample> samples;
+        uint64_t total_hits = 0;
+        Error error (tracepoint_sp->ReadSamples (samples, total_hits));
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("failed to read the samples: %s", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Stream &strm = result.GetOutputStream();
+        strm.Printf ("%" PRIu64 " hits, showing the last %" PRIu64 "\n", total_hits, (uint64_t)samples.size());
+        for (const FastTracepoint::Sample &sample : samples)
+        {
+            strm.Printf ("sample %" PRIu64 ":\n", sample.sequence);
+            for (uint32_t reg = 0; reg < FastTracepoint::kNumRegisters; ++reg)
+                strm.Printf ("    %6s = 0x%16.16" PRIx64 "\n", FastTracepoint::GetRegisterName (reg), sample.registers[reg]);
+        }
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessFastTracepoint
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessFastTracepoint
+
+class CommandObjectProcessFastTracepoint : public CommandObjectMultiword
+{
+public:
+    CommandObjectProcessFastTracepoint (CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process fast-tracepoint",
+                                "A set of commands for fast tracepoints, which record registers without stopping the process (x86_64 only).",
+                                "process fast-tracepoint <subcommand> [<subcommand-options>]")
+    {
+        LoadSubCommand ("add",    CommandObjectSP (new CommandObjectProcessFastTracepointAdd    (interpreter)));
+        LoadSubCommand ("delete", CommandObjectSP (new CommandObjectProcessFastTracepointDelete (interpreter)));
+        LoadSubCommand ("list",   CommandObjectSP (new CommandObjectProcessFastTracepointList   (interpreter)));
+        LoadSubCommand ("dump",   CommandObjectSP (new CommandObjectProcessFastTracepointDump   (interpreter)));
+    }
+
+    ~CommandObjectProcessFastTracepoint() override = default;
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessCheckpointSave
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessCheckpointSave
+
+class CommandObjectProcessCheckpointSave : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessCheckpointSave (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process checkpoint save",
+                             "Save the state of the current process, so it can be restored without running up to here again.",
+                             "process checkpoint save",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   )
+    {
+    }
+
+    ~CommandObjectProcessCheckpointSave() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("'%s' takes no arguments", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        uint32_t checkpoint_id = 0;
+        Error error (process->SaveCheckpoint (checkpoint_id));
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("failed to save a checkpoint: %s", error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.AppendMessageWithFormat ("Checkpoint %" PRIu32 " saved\n", checkpoint_id);
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessCheckpointRestore
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessCheckpointRestore
+
+class CommandObjectProcessCheckpointRestore : public CommandObjectParsed
+{
+public:
+    CommandObjectProcessCheckpointRestore (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "process checkpoint restore",
+                             "Go back to a checkpoint. The process stops where the checkpoint was saved and can get a new process ID.",
+                             "process checkpoint restore <id>",
+                             eCommandRequiresProcess       |
+                             eCommandTryTargetAPILock      |
+                             eCommandProcessMustBeLaunched |
+                             eCommandProcessMustBePaused   )
+    {
+    }
+
+    ~CommandObjectProcessCheckpointRestore() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Process *process = m_exe_ctx.GetProcessPtr();
+
+        if (command.GetArgumentCount() != 1)
+        {
+            result.AppendErrorWithFormat ("'%s' takes a checkpoint ID", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        const char *id_cstr = command.GetArgumentAtIndex(0);
+        const uint32_t checkpoint_id = StringConvert::ToUInt32 (id_cstr, 0, 0);
+        if (checkpoint_id == 0)
+        {
+            result.AppendErrorWithFormat ("invalid checkpoint ID '%s'", id_cstr);
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error (process->RestoreCheckpoint (checkpoint_id));
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("failed to restore checkpoint %" PRIu32 ": %s", checkpoint_id, error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.AppendMessageWithFormat ("Process %" PRIu64 " restored to checkpoint %" PRIu32 "\n", process->GetID(), checkpoint_id);
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectProcessCheckpoint
+//-------------------------------------------------------------------------
+#pragma mark CommandObjectProcessCheckpoint
+
+class CommandObjectProcessCheckpoint : public CommandObjectMultiword
+{
+public:
+    CommandObjectProcessCheckpoint (CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "process checkpoint",
+                                "A set of commands for checkpoints, which save the state of a stopped process to go back to it later (Linux x86_64 only).",
+                                "process checkpoint <subcommand> [<subcommand-options>]")
+    {
+        LoadSubCommand ("save",    CommandObjectSP (new CommandObjectProcessCheckpointSave    (interpreter)));
+        LoadSubCommand ("restore", CommandObjectSP (new CommandObjectProcessCheckpointRestore (interpreter)));
+    }
+
+    ~CommandObjectProcessCheckpoint() override = default;
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectMultiwordProcess
 //-------------------------------------------------------------------------
@@ -1908,7 +2592,11 @@ CommandObjectMultiwordProcess::CommandObjectMultiwordProcess (CommandInterpreter
     LoadSubCommand ("interrupt",   CommandObjectSP (new CommandObjectProcessInterrupt (interpreter)));
     LoadSubCommand ("kill",        CommandObjectSP (new CommandObjectProcessKill      (interpreter)));
     LoadSubCommand ("plugin",      CommandObjectSP (new CommandObjectProcessPlugin    (interpreter)));
+    LoadSubCommand ("sample",      CommandObjectSP (new CommandObjectProcessSample    (interpreter)));
     LoadSubCommand ("save-core",   CommandObjectSP (new CommandObjectProcessSaveCore  (interpreter)));
+    LoadSubCommand ("save-triage", CommandObjectSP (new CommandObjectProcessSaveTriage (interpreter)));
+    LoadSubCommand ("fast-tracepoint", CommandObjectSP (new CommandObjectProcessFastTracepoint (interpreter)));
+    LoadSubCommand ("checkpoint",  CommandObjectSP (new CommandObjectProcessCheckpoint (interpreter)));
 }
 
 CommandObjectMultiwordProcess::~CommandObjectMultiwordProcess() = default;
@@ -0,0 +1,69 @@
+//===-- CommandObjectStats.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "CommandObjectStats.h"
+#include "lldb/Core/StructuredData.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Target/Target.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+class CommandObjectStatsDump : public CommandObjectParsed
+{
+public:
+    CommandObjectStatsDump (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "statistics dump",
+                             "Show where the time and memory of the current target went as JSON: symbol table and debug info "
+                             "parsing per module, expression evaluations, breakpoint resolving and the gdb-remote "
+                             "connection.",
+                             nullptr,
+                             eCommandRequiresTarget)
+    {
+    }
+
+    ~CommandObjectStatsDump() override = default;
+
+protected:
+    bool
+    DoExecute (Args& args, CommandReturnObject &result) override
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Target *target = m_exe_ctx.GetTargetPtr();
+        StructuredData::ObjectSP stats_sp = target->GetStatistics();
+        Stream &strm = result.GetOutputStream();
+        stats_sp->Dump (strm);
+        strm.EOL();
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return result.Succeeded();
+    }
+};
+
+CommandObjectStats::CommandObjectStats(CommandInterpreter &interpreter) :
+    CommandObjectMultiword (interpreter,
+                            "statistics",
+                            "A set of commands for showing where the time and memory of a debug session went.",
+                            "statistics <subcommand> [<subcommand-options>]")
+{
+    LoadSubCommand ("dump", CommandObjectSP (new CommandObjectStatsDump (interpreter)));
+}
+
+CommandObjectStats::~CommandObjectStats() = default;
@@ -269,7 +269,8 @@ protected:
             }
 
             const char *file_path = command.GetArgumentAtIndex(0);
-            Timer scoped_timer(__PRETTY_FUNCTION__, "(lldb) target create '%s'", file_path);
+            static Timer::Category func_cat(__PRETTY_FUNCTION__);
+            Timer scoped_timer(func_cat, "(lldb) target create '%s'", file_path);
             FileSpec file_spec;
 
             if (file_path)
@@ -580,6 +581,78 @@ protected:
     }
 };
 
+#pragma mark CommandObjectTargetExpressionStats
+
+//----------------------------------------------------------------------
+// "target expression-stats"
+//----------------------------------------------------------------------
+
+class CommandObjectTargetExpressionStats : public CommandObjectParsed
+{
+public:
+    CommandObjectTargetExpressionStats (CommandInterpreter &interpreter) :
+        CommandObjectParsed(interpreter,
+                            "target expression-stats",
+                            "Show how many expressions were interpreted and how many had to be JIT compiled and run in the process.",
+                            nullptr,
+                            eCommandRequiresTarget),
+        m_option_group(interpreter),
+        m_clear_option(LLDB_OPT_SET_1, false, "clear", 'c', "Reset the counters after showing them.", false, true)
+    {
+        m_option_group.Append(&m_clear_option, LLDB_OPT_SET_ALL, LLDB_OPT_SET_1);
+        m_option_group.Finalize();
+    }
+
+    ~CommandObjectTargetExpressionStats() override = default;
+
+    Options *
+    GetOptions () override
+    {
+        return &m_option_group;
+    }
+
+protected:
+    bool
+    DoExecute (Args& args, CommandReturnObject &result) override
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Target *target = m_exe_ctx.GetTargetPtr();
+        Target::ExpressionStatistics stats = target->GetExpressionStatistics();
+        if (m_clear_option.GetOptionValue())
+            target->ClearExpressionStatistics();
+
+        const uint64_t total = stats.num_interpreted + stats.num_jitted;
+        Stream &strm = result.GetOutputStream();
+        strm.Printf("Interpreted: %" PRIu64 "\n", stats.num_interpreted);
+        strm.Printf("JIT compiled: %" PRIu64 "\n", stats.num_jitted);
+        if (total > 0)
+            strm.Printf("Interpreted ratio: %.1f%%\n", 100.0 * stats.num_interpreted / total);
+        strm.Printf("Evaluated: %" PRIu64 " (%" PRIu64 " failed)\n", stats.num_evaluations, stats.num_failed_evaluations);
+        if (stats.num_evaluations > 0)
+            strm.Printf("Evaluation time: %.6f sec average, %.6f sec max\n",
+                        stats.total_evaluation_nanos / 1000000000.0 / stats.num_evaluations,
+                        stats.max_evaluation_nanos / 1000000000.0);
+        if (!stats.jit_reasons.empty())
+        {
+            strm.PutCString("Reasons for JIT compiling:\n");
+            for (const auto &reason : stats.jit_reasons)
+                strm.Printf("  %8" PRIu64 "  %s\n", reason.second, reason.first.c_str());
+        }
+
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return result.Succeeded();
+    }
+
+    OptionGroupOptions m_option_group;
+    OptionGroupBoolean m_clear_option;
+};
+
 #pragma mark CommandObjectTargetSelect
 
 //----------------------------------------------------------------------
@@ -2587,6 +2660,105 @@ protected:
     }
 };
 
+#pragma mark CommandObjectTargetModulesDumpMemory
+
+//----------------------------------------------------------------------
+// Image debug info memory dumping command
+//----------------------------------------------------------------------
+
+static void
+DumpMemoryUsage (Stream &strm, const SymbolVendor::MemoryUsage &usage, const char *name)
+{
+    strm.Printf ("%12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %s\n",
+                 (uint64_t)usage.symbol_file,
+                 (uint64_t)usage.types,
+                 (uint64_t)usage.functions,
+                 (uint64_t)usage.line_tables,
+                 (uint64_t)usage.type_systems,
+                 (uint64_t)usage.GetTotal(),
+                 name);
+}
+
+class CommandObjectTargetModulesDumpMemory : public CommandObjectTargetModulesModuleAutoComplete
+{
+public:
+    CommandObjectTargetModulesDumpMemory (CommandInterpreter &interpreter) :
+        CommandObjectTargetModulesModuleAutoComplete(interpreter,
+                                                     "target modules dump memory",
+                                                     "Dump the number of bytes the parsed debug info of one or more target modules uses, "
+                                                     "without parsing any more of it.",
+                                                     nullptr)
+    {
+    }
+
+    ~CommandObjectTargetModulesDumpMemory() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        Target *target = m_interpreter.GetDebugger().GetSelectedTarget().get();
+        if (target == nullptr)
+        {
+            result.AppendError ("invalid target, create a debug target using the 'target create' command");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        ModuleList module_list;
+        if (command.GetArgumentCount() == 0)
+        {
+            module_list = target->GetImages();
+        }
+        else
+        {
+            const char *arg_cstr;
+            for (int arg_idx = 0; (arg_cstr = command.GetArgumentAtIndex(arg_idx)) != nullptr; ++arg_idx)
+            {
+                if (FindModulesByName (target, arg_cstr, module_list, false) == 0)
+                    result.AppendWarningWithFormat("Unable to find an image that matches '%s'.\n", arg_cstr);
+            }
+        }
+
+        const size_t num_modules = module_list.GetSize();
+        if (num_modules == 0)
+        {
+            result.AppendError ("no matching executable images found");
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Stream &strm = result.GetOutputStream();
+        strm.Printf ("%12s %12s %12s %12s %12s %12s %s\n", "Symbol file", "Types", "Functions", "Line tables", "ASTs", "Total", "Module");
+        strm.Printf ("------------ ------------ ------------ ------------ ------------ ------------ ------\n");
+        SymbolVendor::MemoryUsage total_usage;
+        for (size_t i = 0; i < num_modules; ++i)
+        {
+            ModuleSP module_sp (module_list.GetModuleAtIndex(i));
+            SymbolVendor::MemoryUsage usage;
+            SymbolVendor *symbol_vendor = module_sp->GetSymbolVendor(false);
+            if (symbol_vendor)
+                symbol_vendor->GetMemoryUsage (usage);
+            DumpMemoryUsage (strm, usage, module_sp->GetFileSpec().GetPath().c_str());
+
+            total_usage.symbol_file += usage.symbol_file;
+            total_usage.types += usage.types;
+            total_usage.functions += usage.functions;
+            total_usage.line_tables += usage.line_tables;
+            total_usage.type_systems += usage.type_systems;
+        }
+        if (num_modules > 1)
+            DumpMemoryUsage (strm, total_usage, "total");
+
+        const uint64_t budget = target->GetDebugInfoMemoryBudget();
+        if (budget > 0)
+            strm.Printf ("target.debug-info-memory-budget is %" PRIu64 " bytes.\n", budget);
+
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
 #pragma mark CommandObjectTargetModulesDumpLineTable
 
 //----------------------------------------------------------------------
@@ -2682,13 +2854,14 @@ public:
         : CommandObjectMultiword(
               interpreter, "target modules dump",
               "A set of commands for dumping information about one or more target modules.",
-              "target modules dump [headers|symtab|sections|symfile|line-table] [<file1> <file2> ...]")
+              "target modules dump [headers|symtab|sections|symfile|line-table|memory] [<file1> <file2> ...]")
     {
         LoadSubCommand("objfile", CommandObjectSP(new CommandObjectTargetModulesDumpObjfile(interpreter)));
         LoadSubCommand ("symtab",      CommandObjectSP (new CommandObjectTargetModulesDumpSymtab (interpreter)));
         LoadSubCommand ("sections",    CommandObjectSP (new CommandObjectTargetModulesDumpSections (interpreter)));
         LoadSubCommand ("symfile",     CommandObjectSP (new CommandObjectTargetModulesDumpSymfile (interpreter)));
         LoadSubCommand ("line-table",  CommandObjectSP (new CommandObjectTargetModulesDumpLineTable (interpreter)));
+        LoadSubCommand ("memory",      CommandObjectSP (new CommandObjectTargetModulesDumpMemory (interpreter)));
     }
 
     ~CommandObjectTargetModulesDump() override = default;
@@ -5442,6 +5615,7 @@ CommandObjectMultiwordTarget::CommandObjectMultiwordTarget (CommandInterpreter &
     LoadSubCommand ("modules",   CommandObjectSP (new CommandObjectTargetModules (interpreter)));
     LoadSubCommand ("symbols",   CommandObjectSP (new CommandObjectTargetSymbols (interpreter)));
     LoadSubCommand ("variable",  CommandObjectSP (new CommandObjectTargetVariable (interpreter)));
+    LoadSubCommand ("expression-stats", CommandObjectSP (new CommandObjectTargetExpressionStats (interpreter)));
 }
 
 CommandObjectMultiwordTarget::~CommandObjectMultiwordTarget() = default;
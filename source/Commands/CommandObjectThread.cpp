@@ -14,6 +14,7 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/SourceManager.h"
 #include "lldb/Core/ValueObject.h"
@@ -28,6 +29,7 @@
 #include "lldb/Symbol/LineEntry.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
@@ -252,6 +254,21 @@ public:
     }
 
 protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        // Core files can unwind all of their threads in parallel before the
+        // backtraces are printed one by one.
+        if (command.GetArgumentCount() == 1 && ::strcmp (command.GetArgumentAtIndex(0), "all") == 0)
+        {
+            uint32_t num_frames = UINT32_MAX;
+            if (m_options.m_count != UINT32_MAX && m_options.m_start < UINT32_MAX - m_options.m_count)
+                num_frames = m_options.m_start + m_options.m_count;
+            m_exe_ctx.GetProcessPtr()->UnwindAllThreads (num_frames);
+        }
+        return CommandObjectIterateOverThreads::DoExecute (command, result);
+    }
+
     void
     DoExtendedBacktrace (Thread *thread, CommandReturnObject &result)
     {
@@ -2196,6 +2213,402 @@ public:
     ~CommandObjectMultiwordThreadPlan() override = default;
 };
 
+//-------------------------------------------------------------------------
+// CommandObjectThreadTraceStart
+//-------------------------------------------------------------------------
+
+class CommandObjectThreadTraceStart : public CommandObjectIterateOverThreads
+{
+public:
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options(interpreter)
+        {
+            // Keep default values of all options in one place: OptionParsingStarting ()
+            OptionParsingStarting ();
+        }
+
+        ~CommandOptions() override = default;
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg) override
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+                case 's':
+                {
+                    bool success;
+                    m_buffer_size = StringConvert::ToUInt64(option_arg, 0, 0, &success);
+                    if (!success || m_buffer_size == 0)
+                        error.SetErrorStringWithFormat("invalid buffer size '%s'", option_arg);
+                    break;
+                }
+                default:
+                    error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
+                    break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting () override
+        {
+            m_buffer_size = 1024 * 1024;
+        }
+
+        const OptionDefinition*
+        GetDefinitions () override
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+        uint64_t m_buffer_size;
+    };
+
+    CommandObjectThreadTraceStart (CommandInterpreter &interpreter) :
+        CommandObjectIterateOverThreads(interpreter,
+                                        "thread trace start",
+                                        "Start recording the branches one or more threads take while they run.  If no threads are "
+                                        "specified, trace the currently selected thread.  Use the thread-index \"all\" to trace all threads.",
+                                        nullptr,
+                                        eCommandRequiresProcess       |
+                                        eCommandRequiresThread        |
+                                        eCommandTryTargetAPILock      |
+                                        eCommandProcessMustBeLaunched |
+                                        eCommandProcessMustBePaused   ),
+        m_options(interpreter)
+    {
+        m_add_return = false;
+    }
+
+    ~CommandObjectThreadTraceStart() override = default;
+
+    Options *
+    GetOptions () override
+    {
+        return &m_options;
+    }
+
+protected:
+    bool
+    HandleOneThread (lldb::tid_t tid, CommandReturnObject &result) override
+    {
+        ThreadSP thread_sp = m_exe_ctx.GetProcessPtr()->GetThreadList().FindThreadByID(tid);
+        if (!thread_sp)
+        {
+            result.AppendErrorWithFormat ("thread no longer exists: 0x%" PRIx64 "\n", tid);
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error = m_exe_ctx.GetProcessPtr()->StartBranchTrace(thread_sp->GetProtocolID(), m_options.m_buffer_size);
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("thread %u: %s\n", thread_sp->GetIndexID(), error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.SetStatus (eReturnStatusSuccessFinishNoResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectThreadTraceStart::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "buffer-size", 's', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeByteSize, "How many bytes of trace to keep for each thread, only the most recent branches are kept."},
+{ 0, false, nullptr, 0, 0, nullptr, nullptr, 0, eArgTypeNone, nullptr }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectThreadTraceStop
+//-------------------------------------------------------------------------
+
+class CommandObjectThreadTraceStop : public CommandObjectIterateOverThreads
+{
+public:
+    CommandObjectThreadTraceStop (CommandInterpreter &interpreter) :
+        CommandObjectIterateOverThreads(interpreter,
+                                        "thread trace stop",
+                                        "Stop recording the branches of one or more threads and discard their trace.  If no threads are "
+                                        "specified, stop tracing the currently selected thread.  Use the thread-index \"all\" to stop "
+                                        "tracing all threads.",
+                                        nullptr,
+                                        eCommandRequiresProcess       |
+                                        eCommandRequiresThread        |
+                                        eCommandTryTargetAPILock      |
+                                        eCommandProcessMustBeLaunched |
+                                        eCommandProcessMustBePaused   )
+    {
+        m_add_return = false;
+    }
+
+    ~CommandObjectThreadTraceStop() override = default;
+
+protected:
+    bool
+    HandleOneThread (lldb::tid_t tid, CommandReturnObject &result) override
+    {
+        ThreadSP thread_sp = m_exe_ctx.GetProcessPtr()->GetThreadList().FindThreadByID(tid);
+        if (!thread_sp)
+        {
+            result.AppendErrorWithFormat ("thread no longer exists: 0x%" PRIx64 "\n", tid);
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Error error = m_exe_ctx.GetProcessPtr()->StopBranchTrace(thread_sp->GetProtocolID());
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("thread %u: %s\n", thread_sp->GetIndexID(), error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+        result.SetStatus (eReturnStatusSuccessFinishNoResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectThreadTraceDump
+//-------------------------------------------------------------------------
+
+class CommandObjectThreadTraceDump : public CommandObjectIterateOverThreads
+{
+public:
+    class CommandOptions : public Options
+    {
+    public:
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options(interpreter)
+        {
+            // Keep default values of all options in one place: OptionParsingStarting ()
+            OptionParsingStarting ();
+        }
+
+        ~CommandOptions() override = default;
+
+        Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg) override
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+                case 'c':
+                {
+                    bool success;
+                    m_count = StringConvert::ToUInt32(option_arg, 0, 0, &success);
+                    if (!success)
+                        error.SetErrorStringWithFormat("invalid branch count '%s'", option_arg);
+                    break;
+                }
+                case 'i':
+                    m_instructions = true;
+                    break;
+                default:
+                    error.SetErrorStringWithFormat("invalid short option character '%c'", short_option);
+                    break;
+            }
+            return error;
+        }
+
+        void
+        OptionParsingStarting () override
+        {
+            m_count = 32;
+            m_instructions = false;
+        }
+
+        const OptionDefinition*
+        GetDefinitions () override
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+        uint32_t m_count;
+        bool m_instructions;
+    };
+
+    CommandObjectThreadTraceDump (CommandInterpreter &interpreter) :
+        CommandObjectIterateOverThreads(interpreter,
+                                        "thread trace dump",
+                                        "Show the most recent branches one or more traced threads took, the last one is the most "
+                                        "recent.  If no threads are specified, show the currently selected thread.  Use the "
+                                        "thread-index \"all\" to see all threads.",
+                                        nullptr,
+                                        eCommandRequiresProcess       |
+                                        eCommandRequiresThread        |
+                                        eCommandTryTargetAPILock      |
+                                        eCommandProcessMustBeLaunched |
+                                        eCommandProcessMustBePaused   ),
+        m_options(interpreter)
+    {
+    }
+
+    ~CommandObjectThreadTraceDump() override = default;
+
+    Options *
+    GetOptions () override
+    {
+        return &m_options;
+    }
+
+protected:
+    void
+    DumpAddress (Stream &strm, lldb::addr_t load_addr)
+    {
+        strm.Printf ("0x%16.16" PRIx64, load_addr);
+        Address so_addr;
+        Target *target = m_exe_ctx.GetTargetPtr();
+        if (target->GetSectionLoadList().ResolveLoadAddress(load_addr, so_addr))
+        {
+            strm.PutChar(' ');
+            so_addr.Dump(&strm, m_exe_ctx.GetBestExecutionContextScope(), Address::DumpStyleResolvedDescription);
+        }
+    }
+
+    // Show the instructions the thread ran from the destination of one
+    // branch up to and including the next branch.
+    void
+    DumpInstructions (Stream &strm, lldb::addr_t start, lldb::addr_t branch)
+    {
+        // A backwards or very long block means the trace has a gap.
+        const lldb::addr_t max_block_size = 4096;
+        if (branch < start || branch - start > max_block_size)
+        {
+            strm.Printf ("    ...\n");
+            return;
+        }
+
+        Target *target = m_exe_ctx.GetTargetPtr();
+        const ArchSpec &arch = target->GetArchitecture();
+        AddressRange range;
+        range.GetBaseAddress().SetLoadAddress(start, target);
+        // Leave room for the whole branch instruction.
+        range.SetByteSize(branch - start + 16);
+
+        const bool prefer_file_cache = true;
+        DisassemblerSP disassembler_sp = Disassembler::DisassembleRange(arch, nullptr, nullptr, m_exe_ctx, range, prefer_file_cache);
+        if (!disassembler_sp)
+            return;
+
+        InstructionList &instructions = disassembler_sp->GetInstructionList();
+        InstructionList block;
+        for (size_t i = 0; i < instructions.GetSize(); ++i)
+        {
+            InstructionSP inst_sp = instructions.GetInstructionAtIndex(i);
+            const lldb::addr_t inst_addr = inst_sp->GetAddress().GetLoadAddress(target);
+            if (inst_addr > branch)
+                break;
+            block.Append(inst_sp);
+        }
+
+        const bool show_address = true;
+        const bool show_bytes = false;
+        block.Dump(&strm, show_address, show_bytes, &m_exe_ctx);
+        strm.EOL();
+    }
+
+    bool
+    HandleOneThread (lldb::tid_t tid, CommandReturnObject &result) override
+    {
+        ThreadSP thread_sp = m_exe_ctx.GetProcessPtr()->GetThreadList().FindThreadByID(tid);
+        if (!thread_sp)
+        {
+            result.AppendErrorWithFormat ("thread no longer exists: 0x%" PRIx64 "\n", tid);
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        std::vector<std::pair<lldb::addr_t, lldb::addr_t>> branches;
+        Error error = m_exe_ctx.GetProcessPtr()->GetBranchTrace(thread_sp->GetProtocolID(), branches);
+        if (error.Fail())
+        {
+            result.AppendErrorWithFormat ("thread %u: %s\n", thread_sp->GetIndexID(), error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Stream &strm = result.GetOutputStream();
+        strm.Printf ("thread #%u: tid = 0x%" PRIx64 ", %zu branches recorded\n", thread_sp->GetIndexID(), thread_sp->GetID(), branches.size());
+
+        // Branches are numbered backwards from the most recent one, -1.
+        const size_t count = m_options.m_count ? std::min<size_t>(m_options.m_count, branches.size()) : branches.size();
+        const size_t first = branches.size() - count;
+        for (size_t i = first; i < branches.size(); ++i)
+        {
+            if (m_options.m_instructions && i > 0)
+                DumpInstructions (strm, branches[i - 1].second, branches[i].first);
+
+            strm.Printf ("[%6" PRId64 "] ", static_cast<int64_t>(i) - static_cast<int64_t>(branches.size()));
+            DumpAddress (strm, branches[i].first);
+            strm.Printf ("\n      -> ");
+            DumpAddress (strm, branches[i].second);
+            strm.EOL();
+        }
+
+        // After the last branch the thread ran up to where it is now.
+        if (m_options.m_instructions && !branches.empty())
+        {
+            RegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext();
+            if (reg_ctx_sp)
+                DumpInstructions (strm, branches.back().second, reg_ctx_sp->GetPC());
+        }
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectThreadTraceDump::CommandOptions::g_option_table[] =
+{
+{ LLDB_OPT_SET_1, false, "count", 'c', OptionParser::eRequiredArgument, nullptr, nullptr, 0, eArgTypeCount, "How many of the most recent branches to show, 0 shows all of them."},
+{ LLDB_OPT_SET_1, false, "instructions", 'i', OptionParser::eNoArgument, nullptr, nullptr, 0, eArgTypeNone, "Also disassemble the instructions the thread ran between the branches."},
+{ 0, false, nullptr, 0, 0, nullptr, nullptr, 0, eArgTypeNone, nullptr }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectMultiwordThreadTrace
+//-------------------------------------------------------------------------
+
+class CommandObjectMultiwordThreadTrace : public CommandObjectMultiword
+{
+public:
+    CommandObjectMultiwordThreadTrace(CommandInterpreter &interpreter) :
+        CommandObjectMultiword (interpreter,
+                                "trace",
+                                "A set of subcommands for recording the branches threads take, to see how execution reached "
+                                "a stop without single stepping.",
+                                "thread trace <subcommand> [<subcommand objects]")
+    {
+        LoadSubCommand ("start", CommandObjectSP (new CommandObjectThreadTraceStart (interpreter)));
+        LoadSubCommand ("stop", CommandObjectSP (new CommandObjectThreadTraceStop (interpreter)));
+        LoadSubCommand ("dump", CommandObjectSP (new CommandObjectThreadTraceDump (interpreter)));
+    }
+
+    ~CommandObjectMultiwordThreadTrace() override = default;
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectMultiwordThread
 //-------------------------------------------------------------------------
@@ -2263,6 +2676,7 @@ CommandObjectMultiwordThread::CommandObjectMultiwordThread (CommandInterpreter &
                                                     eStepScopeSource)));
 
     LoadSubCommand ("plan", CommandObjectSP (new CommandObjectMultiwordThreadPlan(interpreter)));
+    LoadSubCommand ("trace", CommandObjectSP (new CommandObjectMultiwordThreadTrace(interpreter)));
 }
 
 CommandObjectMultiwordThread::~CommandObjectMultiwordThread() = default;
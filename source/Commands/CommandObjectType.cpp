@@ -3618,6 +3618,65 @@ public:
 
 #endif // LLDB_DISABLE_PYTHON
 
+//-------------------------------------------------------------------------
+// CommandObjectTypeCacheStats
+//-------------------------------------------------------------------------
+
+class CommandObjectTypeCacheStats : public CommandObjectParsed
+{
+public:
+    CommandObjectTypeCacheStats (CommandInterpreter &interpreter) :
+        CommandObjectParsed(interpreter,
+                            "type cache stats",
+                            "Show how often the formatters for a type were found in the cache.",
+                            nullptr)
+    {
+    }
+
+    ~CommandObjectTypeCacheStats() override = default;
+
+protected:
+    bool
+    DoExecute (Args& command, CommandReturnObject &result) override
+    {
+        if (command.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        FormatCache::Statistics stats = DataVisualization::GetCacheStatistics();
+        const uint64_t lookups = stats.cache_hits + stats.cache_misses;
+        Stream &strm = result.GetOutputStream();
+        strm.Printf("Cache hits: %" PRIu64 "\n", stats.cache_hits);
+        strm.Printf("Cache misses: %" PRIu64 "\n", stats.cache_misses);
+        if (lookups > 0)
+            strm.Printf("Hit rate: %.1f%%\n", 100.0 * stats.cache_hits / lookups);
+        strm.Printf("Cached types: %" PRIu64 "\n", (uint64_t)stats.num_types);
+        strm.Printf("Cached \"no formatter\" results: %" PRIu64 "\n", (uint64_t)stats.num_negative_entries);
+        strm.Printf("Generation: %u\n", stats.generation);
+
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return result.Succeeded();
+    }
+};
+
+class CommandObjectTypeCache : public CommandObjectMultiword
+{
+public:
+    CommandObjectTypeCache (CommandInterpreter &interpreter) :
+    CommandObjectMultiword (interpreter,
+                            "type cache",
+                            "A set of commands for inspecting the cache of formatters found for types",
+                            "type cache [<sub-command-options>] ")
+    {
+        LoadSubCommand ("stats",         CommandObjectSP (new CommandObjectTypeCacheStats (interpreter)));
+    }
+
+    ~CommandObjectTypeCache() override = default;
+};
+
 class CommandObjectTypeFilter : public CommandObjectMultiword
 {
 public:
@@ -3688,6 +3747,7 @@ CommandObjectType::CommandObjectType (CommandInterpreter &interpreter) :
                             "A set of commands for operating on the type system",
                             "type [<sub-command-options>]")
 {
+    LoadSubCommand ("cache",     CommandObjectSP (new CommandObjectTypeCache (interpreter)));
     LoadSubCommand ("category",  CommandObjectSP (new CommandObjectTypeCategory (interpreter)));
     LoadSubCommand ("filter",    CommandObjectSP (new CommandObjectTypeFilter (interpreter)));
     LoadSubCommand ("format",    CommandObjectSP (new CommandObjectTypeFormat (interpreter)));
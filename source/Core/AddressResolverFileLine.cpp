@@ -92,6 +92,14 @@ AddressResolverFileLine::GetDepth()
     return Searcher::eDepthCompUnit;
 }
 
+bool
+AddressResolverFileLine::GetSourceFileFilter (FileSpec &file_spec, bool &check_inlines)
+{
+    file_spec = m_file_spec;
+    check_inlines = m_inlines;
+    return true;
+}
+
 void
 AddressResolverFileLine::GetDescription (Stream *s)
 {
@@ -56,8 +56,9 @@ Broadcaster::CheckInWithManager ()
     }
 }
 
+template <typename Callback>
 void
-Broadcaster::BroadcasterImpl::ListenerIterator (std::function <bool (const lldb::ListenerSP &listener_sp, uint32_t &event_mask)> const &callback)
+Broadcaster::BroadcasterImpl::ListenerIterator (Callback const &callback)
 {
     // Private iterator that should be used by everyone except BroadcasterImpl::RemoveListener().
     // We have weak pointers to our listeners which means that at any point the listener can
@@ -318,21 +319,21 @@ Broadcaster::BroadcasterImpl::PrivateBroadcastEvent (EventSP &event_sp, bool uni
 void
 Broadcaster::BroadcasterImpl::BroadcastEvent (uint32_t event_type, EventData *event_data)
 {
-    EventSP event_sp (new Event (event_type, event_data));
+    EventSP event_sp = std::make_shared<Event>(event_type, event_data);
     PrivateBroadcastEvent (event_sp, false);
 }
 
 void
 Broadcaster::BroadcasterImpl::BroadcastEvent (uint32_t event_type, const lldb::EventDataSP &event_data_sp)
 {
-    EventSP event_sp (new Event (event_type, event_data_sp));
+    EventSP event_sp = std::make_shared<Event>(event_type, event_data_sp);
     PrivateBroadcastEvent (event_sp, false);
 }
 
 void
 Broadcaster::BroadcasterImpl::BroadcastEventIfUnique (uint32_t event_type, EventData *event_data)
 {
-    EventSP event_sp (new Event (event_type, event_data));
+    EventSP event_sp = std::make_shared<Event>(event_type, event_data);
     PrivateBroadcastEvent (event_sp, true);
 }
 
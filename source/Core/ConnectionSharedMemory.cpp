@@ -80,17 +80,25 @@ ConnectionStatus
 ConnectionSharedMemory::Disconnect (Error *error_ptr)
 {
     m_mmap.Clear();
-    if (!m_name.empty())
+    Unlink();
+    if (m_fd >= 0)
     {
-#ifdef _WIN32
         close(m_fd);
         m_fd = -1;
-#else
+    }
+    return eConnectionStatusSuccess;
+}
+
+void
+ConnectionSharedMemory::Unlink ()
+{
+    if (!m_name.empty())
+    {
+#ifndef _WIN32
         shm_unlink (m_name.c_str());
 #endif
         m_name.clear();
     }
-    return eConnectionStatusSuccess;
 }
 
 size_t
@@ -118,6 +126,13 @@ ConnectionSharedMemory::GetURI()
     return "";
 }
 
+bool
+ConnectionSharedMemory::InterruptRead()
+{
+    // Read() never blocks
+    return true;
+}
+
 ConnectionStatus
 ConnectionSharedMemory::BytesAvailable (uint32_t timeout_usec, Error *error_ptr)
 {
@@ -155,15 +170,35 @@ ConnectionSharedMemory::Open (bool create, const char *name, size_t size, Error
     int oflag = O_RDWR;
     if (create)
         oflag |= O_CREAT;
+    if (create)
+        oflag |= O_EXCL;
     m_fd = ::shm_open (m_name.c_str(), oflag, S_IRUSR|S_IWUSR);
 
-    if (create)
-        ::ftruncate (m_fd, size);
+    if (m_fd >= 0 && create && ::ftruncate (m_fd, size) != 0)
+    {
+        if (error_ptr)
+            error_ptr->SetErrorToErrno();
+        Disconnect(nullptr);
+        return eConnectionStatusError;
+    }
 #endif
 
+    if (m_fd < 0)
+    {
+        if (error_ptr)
+            error_ptr->SetErrorStringWithFormat("unable to open shared memory '%s'", name);
+        // Don't unlink memory that someone else created
+        m_name.clear();
+        return eConnectionStatusError;
+    }
+
     if (m_mmap.MemoryMapFromFileDescriptor(m_fd, 0, size, true, false) == size)
         return eConnectionStatusSuccess;
 
+    if (error_ptr)
+        error_ptr->SetErrorStringWithFormat("unable to map shared memory '%s'", name);
+    if (!create)
+        m_name.clear();
     Disconnect(nullptr);
     return eConnectionStatusError;
 }
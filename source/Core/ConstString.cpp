@@ -43,8 +43,9 @@ public:
     {
         if (ccstr != nullptr)
         {
-            const uint8_t h = hash (llvm::StringRef(ccstr));
-            llvm::sys::SmartScopedReader<false> rlock(m_string_pools[h].m_mutex);
+            // The length of a string map entry never changes after it has been
+            // inserted and entries are never removed from the pool, so there is
+            // no need to hash the string and take the pool lock here.
             const StringPoolEntryType& entry = GetStringMapEntryFromKeyData (ccstr);
             return entry.getKey().size();
         }
@@ -9,6 +9,7 @@
 
 // C Includes
 #include <fcntl.h>
+#include <string.h>
 #include <sys/stat.h>
 #ifdef _WIN32
 #include "lldb/Host/windows/windows.h"
@@ -83,6 +84,42 @@ DataBufferMemoryMap::GetByteSize() const
     return m_size;
 }
 
+//----------------------------------------------------------------------
+// Pass an access pattern hint for some of the mapped bytes on to the
+// kernel. madvise() wants a page aligned start, so the range is
+// extended down to the page that holds its first byte.
+//----------------------------------------------------------------------
+void
+DataBufferMemoryMap::Advise (lldb::offset_t offset, lldb::offset_t length, AccessPattern pattern)
+{
+#ifndef _WIN32
+    if (m_data == nullptr || offset >= m_size || length == 0)
+        return;
+    if (length > m_size - offset)
+        length = m_size - offset;
+
+    int advice = MADV_NORMAL;
+    switch (pattern)
+    {
+        case eAccessPatternNormal:      advice = MADV_NORMAL; break;
+        case eAccessPatternSequential:  advice = MADV_SEQUENTIAL; break;
+        case eAccessPatternRandom:      advice = MADV_RANDOM; break;
+        case eAccessPatternWillNeed:    advice = MADV_WILLNEED; break;
+    }
+
+    const uintptr_t page_size = HostInfo::GetPageSize();
+    const uintptr_t start = (uintptr_t)(m_data + offset);
+    const uintptr_t aligned_start = start & ~(page_size - 1);
+    if (::madvise ((void *)aligned_start, length + (start - aligned_start), advice) != 0)
+    {
+        Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_MMAP));
+        if (log)
+            log->Printf("DataBufferMemoryMap::Advise(offset=0x%" PRIx64 ", length=0x%" PRIx64 ", pattern=%i) failed: %s",
+                        (uint64_t)offset, (uint64_t)length, pattern, strerror(errno));
+    }
+#endif
+}
+
 //----------------------------------------------------------------------
 // Reverts this object to an empty state by unmapping any memory
 // that is currently owned.
@@ -136,12 +173,10 @@ DataBufferMemoryMap::MemoryMapFromFileSpec (const FileSpec* filespec,
         char path[PATH_MAX];
         if (filespec->GetPath(path, sizeof(path)))
         {
-            uint32_t options = File::eOpenOptionRead;
-            if (writeable)
-                options |= File::eOpenOptionWrite;
-
+            // Writeable file mappings are copy on write, the writes never
+            // reach the file, so the file only needs to be readable.
             File file;
-            Error error (file.Open(path, options));
+            Error error (file.Open(path, File::eOpenOptionRead));
             if (error.Success())
             {
                 const bool fd_is_file = true;
@@ -211,7 +246,9 @@ DataBufferMemoryMap::MemoryMapFromFileDescriptor (int fd,
 
         if (length > 0)
         {
-            HANDLE fileMapping = CreateFileMapping(handle, nullptr, writeable ? PAGE_READWRITE : PAGE_READONLY, file_size_high, file_size_low, nullptr);
+            const bool copy_on_write = writeable && fd_is_file;
+            DWORD protect = writeable ? (copy_on_write ? PAGE_WRITECOPY : PAGE_READWRITE) : PAGE_READONLY;
+            HANDLE fileMapping = CreateFileMapping(handle, nullptr, protect, file_size_high, file_size_low, nullptr);
             if (fileMapping != nullptr)
             {
                 if (win32memmapalignment == 0) LoadWin32MemMapAlignment();
@@ -222,7 +259,8 @@ DataBufferMemoryMap::MemoryMapFromFileDescriptor (int fd,
                   delta = offset - realoffset;
 	            }
 
-                LPVOID data = MapViewOfFile(fileMapping, writeable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, realoffset, length + delta);
+                DWORD access = writeable ? (copy_on_write ? FILE_MAP_COPY : FILE_MAP_WRITE) : FILE_MAP_READ;
+                LPVOID data = MapViewOfFile(fileMapping, access, 0, realoffset, length + delta);
                 m_mmap_addr = (uint8_t *)data;
                 if (!data) {
                   Error error; 
@@ -258,7 +296,9 @@ DataBufferMemoryMap::MemoryMapFromFileDescriptor (int fd,
                     if (writeable)
                         prot |= PROT_WRITE;
 
-                    int flags = MAP_PRIVATE;
+                    // Like on Windows, writes to files are copy on write
+                    // and writes to anything else are shared.
+                    int flags = (writeable && !fd_is_file) ? MAP_SHARED : MAP_PRIVATE;
                     if (fd_is_file)
                         flags |= MAP_FILE;
 
@@ -21,11 +21,16 @@
 #include "llvm/ADT/APInt.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MD5.h"
 
 #include "clang/AST/ASTContext.h"
 
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/DataExtractor.h"
@@ -273,6 +278,17 @@ DataExtractor::GetSharedDataOffset () const
     return 0;
 }
 
+//------------------------------------------------------------------
+// Pass the access pattern for our bytes on to the shared data buffer,
+// which can hand it to the kernel if the bytes are memory mapped.
+//------------------------------------------------------------------
+void
+DataExtractor::Advise (DataBuffer::AccessPattern pattern) const
+{
+    if (m_data_sp && m_start != nullptr && m_end > m_start)
+        m_data_sp->Advise (GetSharedDataOffset(), GetByteSize(), pattern);
+}
+
 //----------------------------------------------------------------------
 // Set the data with which this object will extract from to data
 // starting at BYTES and set the length of the data to LENGTH bytes
@@ -1210,6 +1226,33 @@ DataExtractor::PeekCStr (offset_t offset) const
     return (const char *)PeekData (offset, 1);
 }
 
+//----------------------------------------------------------------------
+// Decode a LEB128 number of up to 8 bytes from the 8 bytes at "src" at
+// once: the first byte without the continuation bit ends the number, the
+// 7 bit groups of the bytes before it are then packed together. Returns
+// the number of bytes of the number, or 0 if it is longer than 8 bytes
+// and has to be decoded byte by byte.
+//----------------------------------------------------------------------
+static inline uint32_t
+DecodeLEB128Word (const uint8_t *src, uint64_t &value)
+{
+    const uint64_t word = llvm::support::endian::read64le(src);
+    const uint64_t last_bytes = ~word & 0x8080808080808080ULL;
+    if (last_bytes == 0)
+        return 0;
+    const uint32_t length = llvm::countTrailingZeros(last_bytes) / 8 + 1;
+    const uint64_t bytes = length == 8 ? word : word & ((1ULL << (8 * length)) - 1);
+#if defined(__BMI2__)
+    value = _pext_u64(bytes, 0x7f7f7f7f7f7f7f7fULL);
+#else
+    uint64_t groups = bytes & 0x7f7f7f7f7f7f7f7fULL;
+    groups = (groups & 0x007f007f007f007fULL) | ((groups & 0x7f007f007f007f00ULL) >> 1);
+    groups = (groups & 0x00003fff00003fffULL) | ((groups & 0x3fff00003fff0000ULL) >> 2);
+    value = (groups & 0x000000000fffffffULL) | ((groups & 0x0fffffff00000000ULL) >> 4);
+#endif
+    return length;
+}
+
 //----------------------------------------------------------------------
 // Extracts an unsigned LEB128 number from this object's data
 // starting at the offset pointed to by "offset_ptr". The offset
@@ -1226,6 +1269,18 @@ DataExtractor::GetULEB128 (offset_t *offset_ptr) const
         return 0;
     
     const uint8_t *end = m_end;
+
+    // Take 8 bytes at once when there are that many left.
+    if (end - src >= 8)
+    {
+        uint64_t result;
+        const uint32_t length = DecodeLEB128Word (src, result);
+        if (length)
+        {
+            *offset_ptr += length;
+            return result;
+        }
+    }
     
     if (src < end)
     {
@@ -1237,7 +1292,8 @@ DataExtractor::GetULEB128 (offset_t *offset_ptr) const
             while (src < end)
             {
                 uint8_t byte = *src++;
-                result |= (byte & 0x7f) << shift;
+                if (shift < 64)
+                    result |= (uint64_t)(byte & 0x7f) << shift;
                 if ((byte & 0x80) == 0)
                     break;
                 shift += 7;
@@ -1266,6 +1322,19 @@ DataExtractor::GetSLEB128 (offset_t *offset_ptr) const
         return 0;
     
     const uint8_t *end = m_end;
+
+    if (end - src >= 8)
+    {
+        uint64_t result;
+        const uint32_t length = DecodeLEB128Word (src, result);
+        if (length)
+        {
+            // Sign extend from the top bit of the last 7 bit group.
+            const uint32_t shift = 64 - 7 * length;
+            *offset_ptr += length;
+            return (int64_t)(result << shift) >> shift;
+        }
+    }
     
     if (src < end)
     {
@@ -1280,7 +1349,8 @@ DataExtractor::GetSLEB128 (offset_t *offset_ptr) const
         {
             bytecount++;
             byte = *src++;
-            result |= (byte & 0x7f) << shift;
+            if (shift < size)
+                result |= (uint64_t)(byte & 0x7f) << shift;
             shift += 7;
             if ((byte & 0x80) == 0)
                 break;
@@ -1288,7 +1358,7 @@ DataExtractor::GetSLEB128 (offset_t *offset_ptr) const
 
         // Sign bit of byte is 2nd high order bit (0x40)
         if (shift < size && (byte & 0x40))
-            result |= - (1 << shift);
+            result |= - (1LL << shift);
 
         *offset_ptr += bytecount;
         return result;
@@ -1313,6 +1383,19 @@ DataExtractor::Skip_LEB128 (offset_t *offset_ptr) const
         return 0;
         
     const uint8_t *end = m_end;
+
+    // Find the last byte of the number in 8 bytes at once, bytes_consumed
+    // doesn't count it.
+    if (end - src >= 8)
+    {
+        const uint64_t last_bytes = ~llvm::support::endian::read64le(src) & 0x8080808080808080ULL;
+        if (last_bytes)
+        {
+            bytes_consumed = llvm::countTrailingZeros(last_bytes) / 8;
+            *offset_ptr += bytes_consumed + 1;
+            return bytes_consumed;
+        }
+    }
     
     if (src < end)
     {
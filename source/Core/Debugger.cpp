@@ -11,10 +11,12 @@
 
 // C Includes
 // C++ Includes
+#include <chrono>
 #include <map>
 #include <mutex>
 
 // Other libraries and framework includes
+#include "llvm/ADT/Hashing.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DynamicLibrary.h"
 
@@ -29,6 +31,7 @@
 #include "lldb/Core/StreamAsynchronousIO.h"
 #include "lldb/Core/StreamCallback.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StreamLogBuffer.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/StructuredData.h"
 #include "lldb/Core/Timer.h"
@@ -65,6 +68,10 @@ using namespace lldb_private;
 
 static lldb::user_id_t g_unique_id = 1;
 static size_t g_debugger_event_thread_stack_bytes = 8 * 1024 * 1024;
+// Queued inferior output is printed at most this often...
+static const std::chrono::milliseconds g_process_output_interval (20);
+// ...unless this much of it is waiting.
+static const size_t g_process_output_max_pending_bytes = 4 * 1024 * 1024;
 
 #pragma mark Static Functions
 
@@ -165,6 +172,7 @@ g_properties[] =
 {   "print-decls",              OptionValue::eTypeBoolean     , true, true , nullptr, nullptr, "If true, LLDB will print the values of variables declared in an expression. Currently only supported in the REPL (default: true)." },
 {   "tab-size",                 OptionValue::eTypeUInt64      , true, 4    , nullptr, nullptr, "The tab size to use when indenting code in multi-line input mode (default: 4)." },
 {   "escape-non-printables",    OptionValue::eTypeBoolean     , true, true, nullptr, nullptr, "If true, LLDB will automatically escape non-printable and escape characters when formatting strings." },
+{   "event-handler-threads",    OptionValue::eTypeUInt64      , true, 0    , nullptr, nullptr, "The number of threads that handle the process, thread and breakpoint events of the targets. The events of a target are always handled in order by the same thread. If zero, the events of all targets are handled by the debugger's event handler thread. Takes effect the next time that thread is started (default: 0)." },
 {   nullptr,                       OptionValue::eTypeInvalid     , true, 0    , nullptr, nullptr, nullptr }
 };
 
@@ -188,7 +196,8 @@ enum
     ePropertyAutoIndent,
     ePropertyPrintDecls,
     ePropertyTabSize,
-    ePropertyEscapeNonPrintables
+    ePropertyEscapeNonPrintables,
+    ePropertyEventHandlerThreads
 };
 
 LoadPluginCallbackType Debugger::g_load_plugin_callback = nullptr;
@@ -716,6 +725,13 @@ Debugger::Debugger(lldb::LogOutputCallback log_callback, void *baton) :
     m_loaded_plugins(),
     m_event_handler_thread(),
     m_io_handler_thread(),
+    m_process_output_thread(),
+    m_process_output_mutex(),
+    m_process_output_write_mutex(),
+    m_process_output_cond(),
+    m_process_output(),
+    m_process_output_size(0),
+    m_process_output_stopped(false),
     m_sync_broadcaster(nullptr, "lldb.debugger.sync"),
     m_forward_listener_sp(),
     m_clear_once()
@@ -780,6 +796,7 @@ Debugger::Clear()
         ClearIOHandlers();
         StopIOHandlerThread();
         StopEventHandlerThread();
+        StopProcessOutputThread();
         m_listener_sp->Clear();
         int num_targets = m_target_list.GetNumTargets();
         for (int i = 0; i < num_targets; i++)
@@ -1340,6 +1357,21 @@ Debugger::SetLoggingCallback (lldb::LogOutputCallback log_callback, void *baton)
     m_log_callback_stream_sp.reset (new StreamCallback (log_callback, baton));
 }
 
+//----------------------------------------------------------------------
+// Put a ring buffer in front of a log stream for "log enable --async"
+// and "log enable --flight-recorder". A log file that is already open
+// keeps the stream it was first opened with.
+//----------------------------------------------------------------------
+static StreamSP
+WrapLogStream (const StreamSP &stream_sp, uint32_t log_options)
+{
+    if (log_options & LLDB_LOG_OPTION_FLIGHT_RECORDER)
+        return StreamSP(new StreamLogBuffer(stream_sp, StreamLogBuffer::eModeFlightRecorder));
+    if (log_options & LLDB_LOG_OPTION_ASYNC)
+        return StreamSP(new StreamLogBuffer(stream_sp, StreamLogBuffer::eModeAsync));
+    return stream_sp;
+}
+
 bool
 Debugger::EnableLog (const char *channel, const char **categories, const char *log_file, uint32_t log_options, Stream &error_stream)
 {
@@ -1352,7 +1384,7 @@ Debugger::EnableLog (const char *channel, const char **categories, const char *l
     }
     else if (log_file == nullptr || *log_file == '\0')
     {
-        log_stream_sp = GetOutputFile();
+        log_stream_sp = WrapLogStream(GetOutputFile(), log_options);
     }
     else
     {
@@ -1367,6 +1399,7 @@ Debugger::EnableLog (const char *channel, const char **categories, const char *l
                 options |= File::eOpenOptionTruncate;
 
             log_stream_sp.reset (new StreamFile (log_file, options));
+            log_stream_sp = WrapLogStream(log_stream_sp, log_options);
             m_log_streams[log_file] = log_stream_sp;
         }
     }
@@ -1496,6 +1529,115 @@ Debugger::GetProcessSTDERR (Process *process, Stream *stream)
     return total_bytes;
 }
 
+size_t
+Debugger::QueueProcessSTDIO (Process *process, bool is_stdout)
+{
+    size_t total_bytes = 0;
+    if (process)
+    {
+        Error error;
+        size_t len;
+        char stdio_buffer[64 * 1024];
+        std::string data;
+        while ((len = (is_stdout ? process->GetSTDOUT (stdio_buffer, sizeof (stdio_buffer), error)
+                                 : process->GetSTDERR (stdio_buffer, sizeof (stdio_buffer), error))) > 0)
+        {
+            data.append (stdio_buffer, len);
+            total_bytes += len;
+        }
+        if (!data.empty())
+            QueueProcessOutput (data.data(), data.size(), is_stdout);
+    }
+    return total_bytes;
+}
+
+void
+Debugger::QueueProcessOutput (const char *s, size_t len, bool is_stdout)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_process_output_mutex);
+        if (!m_process_output_stopped)
+        {
+            if (!m_process_output_thread.IsJoinable())
+                m_process_output_thread = ThreadLauncher::LaunchThread("lldb.debugger.process-output",
+                                                                       ProcessOutputThread,
+                                                                       this,
+                                                                       nullptr);
+            if (m_process_output_thread.IsJoinable())
+            {
+                // Append to the last chunk if it is for the same stream so
+                // the output is written with as few calls as possible.
+                if (m_process_output.empty() || m_process_output.back().is_stdout != is_stdout)
+                    m_process_output.push_back(ProcessOutputChunk{is_stdout, std::string()});
+                m_process_output.back().data.append(s, len);
+                m_process_output_size += len;
+                m_process_output_cond.notify_one();
+                return;
+            }
+        }
+    }
+
+    // No thread to hand the output to, print it right away.
+    FlushProcessOutput();
+    PrintAsync(s, len, is_stdout);
+}
+
+void
+Debugger::FlushProcessOutput ()
+{
+    std::lock_guard<std::mutex> write_guard(m_process_output_write_mutex);
+    ProcessOutputChunks chunks;
+    {
+        std::lock_guard<std::mutex> guard(m_process_output_mutex);
+        chunks.swap(m_process_output);
+        m_process_output_size = 0;
+    }
+    for (const ProcessOutputChunk &chunk : chunks)
+        PrintAsync(chunk.data.data(), chunk.data.size(), chunk.is_stdout);
+}
+
+void
+Debugger::StopProcessOutputThread ()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_process_output_mutex);
+        m_process_output_stopped = true;
+        m_process_output_cond.notify_one();
+    }
+    if (m_process_output_thread.IsJoinable())
+        m_process_output_thread.Join(nullptr);
+    FlushProcessOutput();
+}
+
+lldb::thread_result_t
+Debugger::ProcessOutputThread (lldb::thread_arg_t arg)
+{
+    ((Debugger *)arg)->ProcessOutputThreadLoop();
+    return NULL;
+}
+
+void
+Debugger::ProcessOutputThreadLoop ()
+{
+    std::unique_lock<std::mutex> lock(m_process_output_mutex);
+    while (true)
+    {
+        m_process_output_cond.wait(lock, [this]() { return m_process_output_stopped || !m_process_output.empty(); });
+        if (m_process_output_stopped)
+            break;
+
+        // Let the output of a burst pile up so it gets written, and the
+        // prompt redrawn, once per interval instead of once per chunk.
+        m_process_output_cond.wait_for(lock, g_process_output_interval, [this]() {
+            return m_process_output_stopped || m_process_output_size >= g_process_output_max_pending_bytes;
+        });
+
+        lock.unlock();
+        FlushProcessOutput();
+        lock.lock();
+    }
+}
+
 
 // This function handles events that were broadcast by the process.
 void
@@ -1522,6 +1664,10 @@ Debugger::HandleProcessEvent (const EventSP &event_sp)
         {
             StateType event_state = Process::ProcessEventData::GetStateFromEvent (event_sp.get());
             state_is_stopped = StateIsStoppedState(event_state, false);
+
+            // Output queued by earlier events has to come out before the
+            // state change is displayed.
+            FlushProcessOutput();
         }
 
         // Display running state changes first before any STDIO
@@ -1531,16 +1677,24 @@ Debugger::HandleProcessEvent (const EventSP &event_sp)
         }
 
         // Now display and STDOUT
-        if (got_stdout || got_state_changed)
+        if (got_state_changed)
         {
             GetProcessSTDOUT (process_sp.get(), output_stream_sp.get());
         }
+        else if (got_stdout)
+        {
+            QueueProcessSTDIO (process_sp.get(), true);
+        }
 
         // Now display and STDERR
-        if (got_stderr || got_state_changed)
+        if (got_state_changed)
         {
             GetProcessSTDERR (process_sp.get(), error_stream_sp.get());
         }
+        else if (got_stderr)
+        {
+            QueueProcessSTDIO (process_sp.get(), false);
+        }
 
         // Now display any stopped state changes after any STDIO
         if (got_state_changed && state_is_stopped)
@@ -1593,6 +1747,108 @@ Debugger::CancelForwardEvents (const ListenerSP &listener_sp)
 }
 
 
+uint32_t
+Debugger::GetEventHandlerThreads () const
+{
+    const uint32_t idx = ePropertyEventHandlerThreads;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(nullptr, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+Debugger::SetEventHandlerThreads (uint32_t num_threads)
+{
+    const uint32_t idx = ePropertyEventHandlerThreads;
+    return m_collection_sp->SetPropertyAtIndexAsUInt64(nullptr, idx, num_threads);
+}
+
+void
+Debugger::HandleTargetEvent (const EventSP &event_sp)
+{
+    Broadcaster *broadcaster = event_sp->GetBroadcaster();
+    if (broadcaster == nullptr)
+        return;
+
+    ConstString broadcaster_class (broadcaster->GetBroadcasterClass());
+    if (broadcaster_class == Process::GetStaticBroadcasterClass())
+    {
+        HandleProcessEvent (event_sp);
+    }
+    else if (broadcaster_class == Target::GetStaticBroadcasterClass())
+    {
+        if (Breakpoint::BreakpointEventData::GetEventDataFromEvent(event_sp.get()))
+        {
+            HandleBreakpointEvent (event_sp);
+        }
+    }
+    else if (broadcaster_class == Thread::GetStaticBroadcasterClass())
+    {
+        HandleThreadEvent (event_sp);
+    }
+}
+
+bool
+Debugger::QueueTargetEvent (const EventSP &event_sp, TargetEventQueues &queues)
+{
+    Broadcaster *broadcaster = event_sp->GetBroadcaster();
+    if (queues.empty() || broadcaster == nullptr)
+        return false;
+
+    Target *target = nullptr;
+    ConstString broadcaster_class (broadcaster->GetBroadcasterClass());
+    if (broadcaster_class == Process::GetStaticBroadcasterClass())
+    {
+        ProcessSP process_sp (Process::ProcessEventData::GetProcessFromEvent(event_sp.get()));
+        if (process_sp)
+            target = &process_sp->GetTarget();
+    }
+    else if (broadcaster_class == Target::GetStaticBroadcasterClass())
+    {
+        BreakpointSP breakpoint_sp (Breakpoint::BreakpointEventData::GetBreakpointFromEvent(event_sp));
+        if (breakpoint_sp)
+            target = &breakpoint_sp->GetTarget();
+    }
+    else if (broadcaster_class == Thread::GetStaticBroadcasterClass())
+    {
+        ThreadSP thread_sp (Thread::ThreadEventData::GetThreadFromEvent(event_sp.get()));
+        ProcessSP process_sp (thread_sp ? thread_sp->GetProcess() : ProcessSP());
+        if (process_sp)
+            target = &process_sp->GetTarget();
+    }
+    if (target == nullptr)
+        return false;
+
+    TargetEventQueue &queue = *queues[llvm::hash_value(target) % queues.size()];
+    std::lock_guard<std::mutex> guard(queue.mutex);
+    queue.events.push_back(event_sp);
+    queue.cond.notify_one();
+    return true;
+}
+
+lldb::thread_result_t
+Debugger::TargetEventThread (lldb::thread_arg_t arg)
+{
+    TargetEventQueue &queue = *(TargetEventQueue *)arg;
+    std::unique_lock<std::mutex> lock(queue.mutex);
+    while (true)
+    {
+        // Handle everything that was queued before we were stopped so no
+        // output gets lost.
+        queue.cond.wait(lock, [&queue]() { return queue.stopped || !queue.events.empty(); });
+        if (queue.events.empty())
+            break;
+
+        EventSP event_sp (queue.events.front());
+        queue.events.pop_front();
+        lock.unlock();
+        // The event handler thread deferred the removal actions, e.g. the
+        // stop hooks, so they are run by this thread too.
+        Listener::DoDeferredRemovalActions (event_sp);
+        queue.debugger.HandleTargetEvent (event_sp);
+        lock.lock();
+    }
+    return NULL;
+}
+
 void
 Debugger::DefaultEventHandler()
 {
@@ -1620,6 +1876,28 @@ Debugger::DefaultEventHandler()
                                       CommandInterpreter::eBroadcastBitAsynchronousOutputData   |
                                       CommandInterpreter::eBroadcastBitAsynchronousErrorData    );
 
+    TargetEventQueues target_event_queues;
+    const uint32_t num_target_event_threads = GetEventHandlerThreads();
+    for (uint32_t i = 0; i < num_target_event_threads; ++i)
+    {
+        std::unique_ptr<TargetEventQueue> queue_ap (new TargetEventQueue (*this));
+        char thread_name[64];
+        ::snprintf (thread_name, sizeof(thread_name), "lldb.debugger.event-handler.%u", i);
+        queue_ap->thread = ThreadLauncher::LaunchThread(thread_name,
+                                                        TargetEventThread,
+                                                        queue_ap.get(),
+                                                        nullptr,
+                                                        g_debugger_event_thread_stack_bytes);
+        if (!queue_ap->thread.IsJoinable())
+            break;
+        target_event_queues.push_back (std::move (queue_ap));
+    }
+    // The events are taken off the queue by this thread but their removal
+    // actions have to run on the thread that handles them.
+    const bool defer_removal_actions = !target_event_queues.empty();
+    if (defer_removal_actions)
+        listener_sp->SetDeferRemovalActions (true);
+
     // Let the thread that spawned us know that we have started up and
     // that we are now listening to all required events so no events get missed
     m_sync_broadcaster.BroadcastEvent(eBroadcastBitEventThreadIsListening);
@@ -1630,27 +1908,23 @@ Debugger::DefaultEventHandler()
         EventSP event_sp;
         if (listener_sp->WaitForEvent(nullptr, event_sp))
         {
-            if (event_sp)
+            // Events that are forwarded have to be fully handled before
+            // they are passed on.
+            if (event_sp && (m_forward_listener_sp || !QueueTargetEvent (event_sp, target_event_queues)))
             {
+                if (defer_removal_actions)
+                    Listener::DoDeferredRemovalActions (event_sp);
+
                 Broadcaster *broadcaster = event_sp->GetBroadcaster();
                 if (broadcaster)
                 {
                     uint32_t event_type = event_sp->GetType();
                     ConstString broadcaster_class (broadcaster->GetBroadcasterClass());
-                    if (broadcaster_class == broadcaster_class_process)
+                    if (broadcaster_class == broadcaster_class_process ||
+                        broadcaster_class == broadcaster_class_target ||
+                        broadcaster_class == broadcaster_class_thread)
                     {
-                        HandleProcessEvent (event_sp);
-                    }
-                    else if (broadcaster_class == broadcaster_class_target)
-                    {
-                        if (Breakpoint::BreakpointEventData::GetEventDataFromEvent(event_sp.get()))
-                        {
-                            HandleBreakpointEvent (event_sp);
-                        }
-                    }
-                    else if (broadcaster_class == broadcaster_class_thread)
-                    {
-                        HandleThreadEvent (event_sp);
+                        HandleTargetEvent (event_sp);
                     }
                     else if (broadcaster == m_command_interpreter_ap.get())
                     {
@@ -1692,6 +1966,18 @@ Debugger::DefaultEventHandler()
             }
         }
     }
+
+    if (defer_removal_actions)
+        listener_sp->SetDeferRemovalActions (false);
+    for (auto &queue_ap : target_event_queues)
+    {
+        {
+            std::lock_guard<std::mutex> guard(queue_ap->mutex);
+            queue_ap->stopped = true;
+            queue_ap->cond.notify_one();
+        }
+        queue_ap->thread.Join(nullptr);
+    }
 }
 
 lldb::thread_result_t
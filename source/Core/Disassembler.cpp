@@ -48,7 +48,8 @@ using namespace lldb_private;
 DisassemblerSP
 Disassembler::FindPlugin (const ArchSpec &arch, const char *flavor, const char *plugin_name)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "Disassembler::FindPlugin (arch = %s, plugin_name = %s)",
                         arch.GetArchitectureName(),
                         plugin_name);
@@ -948,6 +949,45 @@ Instruction::GetData (DataExtractor &data)
     return m_opcode.GetData(data);
 }
 
+bool
+Instruction::SetOpcode (const DataExtractor &data, const DecodedInstruction &decoded)
+{
+    lldb::offset_t offset = decoded.offset;
+    if (!data.ValidOffsetForDataOfSize(offset, decoded.byte_size))
+        return false;
+
+    const ByteOrder byte_order = data.GetByteOrder();
+    switch (decoded.opcode_type)
+    {
+        case Opcode::eType8:
+            m_opcode.SetOpcode8 (data.GetU8 (&offset), byte_order);
+            break;
+        case Opcode::eType16:
+            m_opcode.SetOpcode16 (data.GetU16 (&offset), byte_order);
+            break;
+        case Opcode::eType16_2:
+            {
+                uint32_t thumb_opcode = data.GetU16 (&offset);
+                thumb_opcode <<= 16;
+                thumb_opcode |= data.GetU16 (&offset);
+                m_opcode.SetOpcode16_2 (thumb_opcode, byte_order);
+            }
+            break;
+        case Opcode::eType32:
+            m_opcode.SetOpcode32 (data.GetU32 (&offset), byte_order);
+            break;
+        case Opcode::eType64:
+            m_opcode.SetOpcode64 (data.GetU64 (&offset), byte_order);
+            break;
+        case Opcode::eTypeBytes:
+            m_opcode.SetOpcodeBytes (data.PeekData (offset, decoded.byte_size), decoded.byte_size);
+            break;
+        default:
+            return false;
+    }
+    return m_opcode.GetByteSize() == decoded.byte_size;
+}
+
 InstructionList::InstructionList() :
     m_instructions()
 {
@@ -1118,6 +1158,30 @@ InstructionList::GetIndexOfInstructionAtLoadAddress (lldb::addr_t load_addr, Tar
     return GetIndexOfInstructionAtAddress(address);
 }
 
+DisassemblyCache::EntrySP
+Disassembler::CreateCacheEntry (const Address &base_addr, const DataBufferSP &data_sp)
+{
+    std::shared_ptr<DisassemblyCache::Entry> entry_sp (new DisassemblyCache::Entry());
+    entry_sp->data_sp = data_sp;
+
+    const lldb::addr_t base_file_addr = base_addr.GetFileAddress();
+    const size_t num_instructions = m_instruction_list.GetSize();
+    entry_sp->instructions.reserve(num_instructions);
+    for (size_t i = 0; i < num_instructions; ++i)
+    {
+        InstructionSP inst_sp (m_instruction_list.GetInstructionAtIndex(i));
+        const Opcode &opcode = inst_sp->GetOpcode();
+        DecodedInstruction decoded;
+        decoded.offset = inst_sp->GetAddress().GetFileAddress() - base_file_addr;
+        decoded.byte_size = opcode.GetByteSize();
+        decoded.opcode_type = opcode.GetType();
+        decoded.address_class = inst_sp->GetAddressClass();
+        decoded.reserved = 0;
+        entry_sp->instructions.push_back(decoded);
+    }
+    return entry_sp;
+}
+
 size_t
 Disassembler::ParseInstructions (const ExecutionContext *exe_ctx,
                                  const AddressRange &range,
@@ -1131,6 +1195,33 @@ Disassembler::ParseInstructions (const ExecutionContext *exe_ctx,
         if (target == nullptr || byte_size == 0 || !range.GetBaseAddress().IsValid())
             return 0;
 
+        // Code that comes from the object file can't change, so decoding
+        // it once per module is enough.
+        DisassemblyCache *cache = nullptr;
+        DisassemblyCache::Key cache_key;
+        ModuleSP module_sp (range.GetBaseAddress().GetModule());
+        if (module_sp)
+        {
+            cache = &module_sp->GetDisassemblyCache();
+            cache_key.file_addr = range.GetBaseAddress().GetFileAddress();
+            cache_key.byte_size = byte_size;
+            cache_key.triple.SetCString(m_arch.GetTriple().getTriple().c_str());
+            cache_key.plugin_name = GetPluginName();
+            cache_key.flavor.SetCString(m_flavor.c_str());
+            if (prefer_file_cache)
+            {
+                DisassemblyCache::EntrySP entry_sp (cache->Find(cache_key));
+                if (entry_sp)
+                {
+                    DataExtractor data (entry_sp->data_sp,
+                                        m_arch.GetByteOrder(),
+                                        m_arch.GetAddressByteSize());
+                    if (CreateCachedInstructions(range.GetBaseAddress(), data, entry_sp->instructions))
+                        return entry_sp->data_sp->GetByteSize();
+                }
+            }
+        }
+
         DataBufferHeap *heap_buffer = new DataBufferHeap (byte_size, '\0');
         DataBufferSP data_sp(heap_buffer);
 
@@ -1151,8 +1242,11 @@ Disassembler::ParseInstructions (const ExecutionContext *exe_ctx,
                                 m_arch.GetByteOrder(),
                                 m_arch.GetAddressByteSize());
             const bool data_from_file = load_addr == LLDB_INVALID_ADDRESS;
-            return DecodeInstructions(range.GetBaseAddress(), data, 0, UINT32_MAX, false,
-                                      data_from_file);
+            const size_t bytes_decoded = DecodeInstructions(range.GetBaseAddress(), data, 0, UINT32_MAX, false,
+                                                            data_from_file);
+            if (cache && data_from_file && bytes_decoded == bytes_read)
+                cache->Add(cache_key, CreateCacheEntry(range.GetBaseAddress(), data_sp));
+            return bytes_decoded;
         }
         else if (error_strm_ptr)
         {
@@ -1340,3 +1434,68 @@ PseudoInstruction::SetDescription (const char *description)
     if (description && strlen (description) > 0)
         m_description = description;
 }
+
+bool
+DisassemblyCache::Key::operator < (const Key &rhs) const
+{
+    if (file_addr != rhs.file_addr)
+        return file_addr < rhs.file_addr;
+    if (byte_size != rhs.byte_size)
+        return byte_size < rhs.byte_size;
+    if (triple != rhs.triple)
+        return triple < rhs.triple;
+    if (plugin_name != rhs.plugin_name)
+        return plugin_name < rhs.plugin_name;
+    return flavor < rhs.flavor;
+}
+
+DisassemblyCache::DisassemblyCache () :
+    m_mutex (),
+    m_entries (),
+    m_memory_size (0)
+{
+}
+
+DisassemblyCache::~DisassemblyCache () = default;
+
+DisassemblyCache::EntrySP
+DisassemblyCache::Find (const Key &key)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    collection::const_iterator pos = m_entries.find(key);
+    if (pos != m_entries.end())
+        return pos->second;
+    return EntrySP();
+}
+
+void
+DisassemblyCache::Add (const Key &key, const EntrySP &entry_sp)
+{
+    if (!entry_sp || !entry_sp->data_sp)
+        return;
+
+    const size_t entry_size = entry_sp->data_sp->GetByteSize() + entry_sp->instructions.size() * sizeof(DecodedInstruction);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_memory_size + entry_size > kMaxMemorySize)
+    {
+        m_entries.clear();
+        m_memory_size = 0;
+    }
+    if (m_entries.insert(std::make_pair(key, entry_sp)).second)
+        m_memory_size += entry_size;
+}
+
+void
+DisassemblyCache::Clear ()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_entries.clear();
+    m_memory_size = 0;
+}
+
+size_t
+DisassemblyCache::GetMemorySize () const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_memory_size;
+}
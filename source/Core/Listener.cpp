@@ -12,6 +12,7 @@
 // C Includes
 // C++ Includes
 #include <algorithm>
+#include <chrono>
 
 // Other libraries and framework includes
 // Project includes
@@ -41,7 +42,8 @@ namespace
 } // anonymous namespace
 
 Listener::Listener(const char *name)
-    : m_name(name), m_broadcasters(), m_broadcasters_mutex(), m_events(), m_events_mutex(Mutex::eMutexTypeNormal)
+    : m_name(name), m_broadcasters(), m_broadcasters_mutex(), m_events(), m_events_mutex(), m_events_condition(), m_events_waiters(0),
+      m_defer_removal_actions(false)
 {
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
     if (log != nullptr)
@@ -73,7 +75,7 @@ Listener::Clear()
     }
     m_broadcasters.clear();
 
-    Mutex::Locker event_locker(m_events_mutex);
+    std::lock_guard<std::mutex> event_guard(m_events_mutex);
     m_events.clear();
     size_t num_managers = m_broadcaster_managers.size();
 
@@ -177,7 +179,7 @@ Listener::BroadcasterWillDestruct (Broadcaster *broadcaster)
 
     // Scope for "event_locker"
     {
-        Mutex::Locker event_locker(m_events_mutex);
+        std::lock_guard<std::mutex> event_guard(m_events_mutex);
         // Remove all events for this broadcaster object.
         event_collection::iterator pos = m_events.begin();
         while (pos != m_events.end())
@@ -212,9 +214,16 @@ Listener::AddEvent (EventSP &event_sp)
                      static_cast<void*>(this), m_name.c_str(),
                      static_cast<void*>(event_sp.get()));
 
-    Mutex::Locker locker(m_events_mutex);
+    std::unique_lock<std::mutex> lock(m_events_mutex);
     m_events.push_back (event_sp);
-    m_events_condition.Broadcast();
+
+    // Most events are picked up with GetNextEvent() or by a thread that
+    // isn't waiting yet, only signal the condition if someone waits on it,
+    // and do it without the lock so the woken thread doesn't block on it.
+    const bool has_waiters = m_events_waiters > 0;
+    lock.unlock();
+    if (has_waiters)
+        m_events_condition.notify_all();
 }
 
 class EventBroadcasterMatches
@@ -281,7 +290,7 @@ private:
 bool
 Listener::FindNextEventInternal
 (
-    Mutex::Locker& lock,
+    std::unique_lock<std::mutex> &lock,
     Broadcaster *broadcaster,   // nullptr for any broadcaster
     const ConstString *broadcaster_names, // nullptr for any event
     uint32_t num_broadcaster_names,
@@ -289,8 +298,8 @@ Listener::FindNextEventInternal
     EventSP &event_sp,
     bool remove)
 {
-    // NOTE: callers of this function must lock m_events_mutex using a Mutex::Locker
-    // and pass the locker as the first argument. m_events_mutex is no longer recursive.
+    // NOTE: callers of this function must lock m_events_mutex using a std::unique_lock
+    // and pass the lock as the first argument. m_events_mutex is not recursive.
     Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS));
 
     if (m_events.empty())
@@ -325,8 +334,9 @@ Listener::FindNextEventInternal
             // Unlock the event queue here.  We've removed this event and are about to return
             // it so it should be okay to get the next event off the queue here - and it might
             // be useful to do that in the "DoOnRemoval".
-            lock.Unlock();
-            event_sp->DoOnRemoval();
+            lock.unlock();
+            if (!m_defer_removal_actions)
+                event_sp->DoOnRemoval();
         }
         return true;
     }
@@ -335,10 +345,17 @@ Listener::FindNextEventInternal
     return false;
 }
 
+void
+Listener::DoDeferredRemovalActions (const EventSP &event_sp)
+{
+    if (event_sp)
+        event_sp->DoOnRemoval();
+}
+
 Event *
 Listener::PeekAtNextEvent ()
 {
-    Mutex::Locker lock(m_events_mutex);
+    std::unique_lock<std::mutex> lock(m_events_mutex);
     EventSP event_sp;
     if (FindNextEventInternal(lock, nullptr, nullptr, 0, 0, event_sp, false))
         return event_sp.get();
@@ -348,7 +365,7 @@ Listener::PeekAtNextEvent ()
 Event *
 Listener::PeekAtNextEventForBroadcaster (Broadcaster *broadcaster)
 {
-    Mutex::Locker lock(m_events_mutex);
+    std::unique_lock<std::mutex> lock(m_events_mutex);
     EventSP event_sp;
     if (FindNextEventInternal(lock, broadcaster, nullptr, 0, 0, event_sp, false))
         return event_sp.get();
@@ -358,7 +375,7 @@ Listener::PeekAtNextEventForBroadcaster (Broadcaster *broadcaster)
 Event *
 Listener::PeekAtNextEventForBroadcasterWithType (Broadcaster *broadcaster, uint32_t event_type_mask)
 {
-    Mutex::Locker lock(m_events_mutex);
+    std::unique_lock<std::mutex> lock(m_events_mutex);
     EventSP event_sp;
     if (FindNextEventInternal(lock, broadcaster, nullptr, 0, event_type_mask, event_sp, false))
         return event_sp.get();
@@ -372,7 +389,7 @@ Listener::GetNextEventInternal(Broadcaster *broadcaster,             // nullptr
                                uint32_t event_type_mask,
                                EventSP &event_sp)
 {
-    Mutex::Locker lock(m_events_mutex);
+    std::unique_lock<std::mutex> lock(m_events_mutex);
     return FindNextEventInternal (lock, broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask, event_sp, true);
 }
 
@@ -408,7 +425,14 @@ Listener::WaitForEventsInternal(const TimeValue *timeout,
                      static_cast<void*>(this), static_cast<const void*>(timeout),
                      m_name.c_str());
 
-    Mutex::Locker lock(m_events_mutex);
+    std::unique_lock<std::mutex> lock(m_events_mutex);
+
+    // The timeout is an absolute time since the epoch
+    std::chrono::system_clock::time_point deadline;
+    const bool has_deadline = timeout && timeout->IsValid();
+    if (has_deadline)
+        deadline = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::nanoseconds(timeout->GetAsNanoSecondsSinceJan1_1970())));
 
     while (true)
     {
@@ -418,25 +442,27 @@ Listener::WaitForEventsInternal(const TimeValue *timeout,
         }
         else
         {
-            bool timed_out = false;
-            if (m_events_condition.Wait(m_events_mutex, timeout, &timed_out) != 0)
+            ++m_events_waiters;
+            if (has_deadline)
             {
-                if (timed_out)
+                if (m_events_condition.wait_until(lock, deadline) == std::cv_status::timeout)
                 {
+                    --m_events_waiters;
+                    // An event might have come in right at the deadline
+                    if (FindNextEventInternal (lock, broadcaster, broadcaster_names, num_broadcaster_names, event_type_mask, event_sp, true))
+                        return true;
                     log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS);
                     if (log != nullptr)
                         log->Printf ("%p Listener::WaitForEventsInternal() timed out for %s",
                                      static_cast<void*>(this), m_name.c_str());
+                    return false;
                 }
-                else
-                {
-                    log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EVENTS);
-                    if (log != nullptr)
-                        log->Printf ("%p Listener::WaitForEventsInternal() unknown error for %s",
-                                     static_cast<void*>(this), m_name.c_str());
-                }
-                return false;
             }
+            else
+            {
+                m_events_condition.wait(lock);
+            }
+            --m_events_waiters;
         }
     }
 
@@ -145,7 +145,9 @@ Log::VAPrintf(const char *format, va_list args)
             header.PutCString(back_trace.c_str());
         }
 
-        if (m_options.Test(LLDB_LOG_OPTION_THREADSAFE))
+        // Buffered log streams take care of concurrent writers themselves.
+        if (m_options.Test(LLDB_LOG_OPTION_THREADSAFE) &&
+            !m_options.AnySet(LLDB_LOG_OPTION_ASYNC | LLDB_LOG_OPTION_FLIGHT_RECORDER))
         {
             static std::recursive_mutex g_LogThreadedMutex;
             std::lock_guard<std::recursive_mutex> guard(g_LogThreadedMutex);
@@ -267,7 +267,8 @@ Mangled::GetDemangledName (lldb::LanguageType language) const
     if (m_mangled && !m_demangled)
     {
         // We need to generate and cache the demangled name.
-        Timer scoped_timer (__PRETTY_FUNCTION__,
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer (func_cat,
                             "Mangled::GetDemangledName (m_mangled = %s)",
                             m_mangled.GetCString());
 
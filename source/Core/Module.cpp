@@ -11,6 +11,8 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+#include <thread>
 // Other libraries and framework includes
 #include "llvm/Support/raw_os_ostream.h"
 #include "llvm/Support/Signals.h"
@@ -20,6 +22,7 @@
 #include "lldb/Core/Error.h"
 #include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -32,11 +35,14 @@
 #include "lldb/Host/Symbols.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/ScriptInterpreter.h"
+#include "lldb/Symbol/Block.h"
 #include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/SymbolFile.h"
 #include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Symbol/Symtab.h"
 #include "lldb/Symbol/TypeSystem.h"
 #include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
@@ -51,6 +57,9 @@
 using namespace lldb;
 using namespace lldb_private;
 
+// Bumped whenever a module's file spec changes, see GetFileSpecGeneration().
+static std::atomic<uint32_t> g_file_spec_generation(0);
+
 // Shared pointers to modules track module lifetimes in
 // targets and in the global module, but this collection
 // will track all module objects that are still alive
@@ -157,11 +166,21 @@ Module::Module(const ModuleSpec &module_spec)
       m_type_system_map(),
       m_source_mappings(),
       m_sections_ap(),
+      m_disassembly_cache_ap(),
+      m_inlined_call_chains(),
+      m_completion_function_names(),
+      m_completion_comp_units(),
+      m_comp_unit_filename_index(),
+      m_support_file_filename_index(),
       m_did_load_objfile(false),
       m_did_load_symbol_vendor(false),
       m_did_parse_uuid(false),
       m_file_has_changed(false),
-      m_first_file_changed_log(false)
+      m_first_file_changed_log(false),
+      m_completion_function_names_indexed(false),
+      m_completion_comp_units_indexed(false),
+      m_comp_unit_filenames_indexed(false),
+      m_support_file_filenames_indexed(false)
 {
     // Scope for locker below...
     {
@@ -254,11 +273,21 @@ Module::Module(const FileSpec &file_spec, const ArchSpec &arch, const ConstStrin
       m_type_system_map(),
       m_source_mappings(),
       m_sections_ap(),
+      m_disassembly_cache_ap(),
+      m_inlined_call_chains(),
+      m_completion_function_names(),
+      m_completion_comp_units(),
+      m_comp_unit_filename_index(),
+      m_support_file_filename_index(),
       m_did_load_objfile(false),
       m_did_load_symbol_vendor(false),
       m_did_parse_uuid(false),
       m_file_has_changed(false),
-      m_first_file_changed_log(false)
+      m_first_file_changed_log(false),
+      m_completion_function_names_indexed(false),
+      m_completion_comp_units_indexed(false),
+      m_comp_unit_filenames_indexed(false),
+      m_support_file_filenames_indexed(false)
 {
     // Scope for locker below...
     {
@@ -296,11 +325,21 @@ Module::Module()
       m_type_system_map(),
       m_source_mappings(),
       m_sections_ap(),
+      m_disassembly_cache_ap(),
+      m_inlined_call_chains(),
+      m_completion_function_names(),
+      m_completion_comp_units(),
+      m_comp_unit_filename_index(),
+      m_support_file_filename_index(),
       m_did_load_objfile(false),
       m_did_load_symbol_vendor(false),
       m_did_parse_uuid(false),
       m_file_has_changed(false),
-      m_first_file_changed_log(false)
+      m_first_file_changed_log(false),
+      m_completion_function_names_indexed(false),
+      m_completion_comp_units_indexed(false),
+      m_comp_unit_filenames_indexed(false),
+      m_support_file_filenames_indexed(false)
 {
     std::lock_guard<std::recursive_mutex> guard(GetAllocationModuleCollectionMutex());
     GetModuleCollection().push_back(this);
@@ -417,6 +456,12 @@ Module::GetTypeSystemForLanguage (LanguageType language)
     return m_type_system_map.GetTypeSystemForLanguage(language, this, true);
 }
 
+void
+Module::ForEachTypeSystem (std::function<bool(TypeSystem *)> const &callback)
+{
+    m_type_system_map.ForEach(callback);
+}
+
 void
 Module::ParseAllDebugSymbols()
 {
@@ -454,6 +499,44 @@ Module::ParseAllDebugSymbols()
     }
 }
 
+void
+Module::PreloadSymbols (bool index_debug_info)
+{
+    SymbolVendor *symbols = GetSymbolVendor ();
+    if (symbols == nullptr)
+        return;
+
+    Symtab *symtab = symbols->GetSymtab();
+    if (symtab)
+        symtab->PreloadSymbols();
+
+    if (!index_debug_info)
+        return;
+
+    SymbolFile *sym_file = symbols->GetSymbolFile();
+    if (sym_file)
+        sym_file->PreloadSymbols();
+}
+
+void
+Module::PreloadSymbolsInBackground ()
+{
+    while (true)
+    {
+        {
+            // Look the symbol file up again every step, it can be replaced
+            // while we don't hold the lock.
+            std::lock_guard<std::recursive_mutex> guard(m_mutex);
+            SymbolVendor *symbols = GetSymbolVendor ();
+            SymbolFile *sym_file = symbols ? symbols->GetSymbolFile() : nullptr;
+            if (sym_file == nullptr || !sym_file->PreloadSymbolsStep())
+                return;
+        }
+        // Let lookups that are waiting for the module go first.
+        std::this_thread::yield();
+    }
+}
+
 void
 Module::CalculateSymbolContext(SymbolContext* sc)
 {
@@ -476,7 +559,8 @@ size_t
 Module::GetNumCompileUnits()
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "Module::GetNumCompileUnits (module = %p)",
                        static_cast<void*>(this));
     SymbolVendor *symbols = GetSymbolVendor ();
@@ -505,7 +589,8 @@ bool
 Module::ResolveFileAddress (lldb::addr_t vm_addr, Address& so_addr)
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    Timer scoped_timer(__PRETTY_FUNCTION__, "Module::ResolveFileAddress (vm_addr = 0x%" PRIx64 ")", vm_addr);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat, "Module::ResolveFileAddress (vm_addr = 0x%" PRIx64 ")", vm_addr);
     SectionList *section_list = GetSectionList();
     if (section_list)
         return so_addr.ResolveAddressUsingFileSections(vm_addr, section_list);
@@ -667,7 +752,8 @@ uint32_t
 Module::ResolveSymbolContextsForFileSpec (const FileSpec &file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, SymbolContextList& sc_list)
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "Module::ResolveSymbolContextForFilePath (%s:%u, check_inlines = %s, resolve_scope = 0x%8.8x)",
                        file_spec.GetPath().c_str(),
                        line,
@@ -929,7 +1015,8 @@ Module::FindTypes_Impl (const SymbolContext& sc,
                         llvm::DenseSet<lldb_private::SymbolFile *> &searched_symbol_files,
                         TypeMap& types)
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat, __PRETTY_FUNCTION__);
     if (!sc.module_sp || sc.module_sp.get() == this)
     {
         SymbolVendor *symbols = GetSymbolVendor ();
@@ -1034,7 +1121,8 @@ Module::GetSymbolVendor (bool can_create, lldb_private::Stream *feedback_strm)
             ObjectFile *obj_file = GetObjectFile ();
             if (obj_file != nullptr)
             {
-                Timer scoped_timer(__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+                static Timer::Category func_cat(__PRETTY_FUNCTION__);
+                Timer scoped_timer(func_cat, __PRETTY_FUNCTION__);
                 m_symfile_ap.reset(SymbolVendor::FindPlugin(shared_from_this(), feedback_strm));
                 m_did_load_symbol_vendor = true;
             }
@@ -1051,6 +1139,20 @@ Module::SetFileSpecAndObjectName (const FileSpec &file, const ConstString &objec
     m_file = file;
     m_mod_time = file.GetModificationTime();
     m_object_name = object_name;
+    ++g_file_spec_generation;
+}
+
+void
+Module::SetPlatformFileSpec (const FileSpec &file)
+{
+    m_platform_file = file;
+    ++g_file_spec_generation;
+}
+
+uint32_t
+Module::GetFileSpecGeneration ()
+{
+    return g_file_spec_generation.load();
 }
 
 const ArchSpec&
@@ -1281,7 +1383,8 @@ Module::GetObjectFile()
         std::lock_guard<std::recursive_mutex> guard(m_mutex);
         if (!m_did_load_objfile.load())
         {
-            Timer scoped_timer(__PRETTY_FUNCTION__,
+            static Timer::Category func_cat(__PRETTY_FUNCTION__);
+            Timer scoped_timer(func_cat,
                                "Module::GetObjectFile () module = %s", GetFileSpec().GetFilename().AsCString(""));
             DataBufferSP data_sp;
             lldb::offset_t data_offset = 0;
@@ -1316,6 +1419,213 @@ Module::GetObjectFile()
     return m_objfile_sp.get();
 }
 
+DisassemblyCache &
+Module::GetDisassemblyCache ()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    if (!m_disassembly_cache_ap)
+        m_disassembly_cache_ap.reset(new DisassemblyCache());
+    return *m_disassembly_cache_ap;
+}
+
+static void
+CalculateInlinedCallChain (Block *block, const Address &addr, Module::InlinedCallChain &chain)
+{
+    Address curr_addr (addr);
+    for (Block *inlined_block = block ? block->GetContainingInlinedBlock() : nullptr;
+         inlined_block != nullptr;
+         inlined_block = inlined_block->GetInlinedParent())
+    {
+        AddressRange range;
+        if (!inlined_block->GetRangeContainingAddress (curr_addr, range))
+            break;
+        Module::InlinedCallSite caller;
+        caller.block = inlined_block->GetParent();
+        caller.call_address = range.GetBaseAddress();
+        caller.call_site = inlined_block->GetInlinedFunctionInfo()->GetCallSite();
+        chain.push_back(caller);
+        curr_addr = caller.call_address;
+    }
+}
+
+bool
+Module::GetInlinedCallChain (Block *block, const Address &addr, InlinedCallChain &chain)
+{
+    chain.clear();
+    if (block == nullptr)
+        return false;
+
+    // All the addresses of a range of the deepest block have the same
+    // chain since the ranges of the parents contain it.
+    AddressRange block_range;
+    if (!block->GetRangeContainingAddress (addr, block_range))
+    {
+        CalculateInlinedCallChain (block, addr, chain);
+        return !chain.empty();
+    }
+
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    auto key = std::make_pair(block, block_range.GetBaseAddress().GetFileAddress());
+    auto pos = m_inlined_call_chains.find(key);
+    if (pos == m_inlined_call_chains.end())
+    {
+        InlinedCallChain new_chain;
+        CalculateInlinedCallChain (block, addr, new_chain);
+        pos = m_inlined_call_chains.insert(std::make_pair(key, std::move(new_chain))).first;
+    }
+    chain = pos->second;
+    return !chain.empty();
+}
+
+size_t
+Module::FindFunctionNamesWithPrefix (llvm::StringRef prefix, size_t max_matches, std::vector<ConstString> &names)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    if (!m_completion_function_names_indexed)
+    {
+        m_completion_function_names_indexed = true;
+        SymbolVendor *symbols = GetSymbolVendor ();
+        if (symbols)
+        {
+            Symtab *symtab = symbols->GetSymtab();
+            if (symtab)
+            {
+                std::lock_guard<std::recursive_mutex> symtab_guard(symtab->GetMutex());
+                const size_t num_symbols = symtab->GetNumSymbols();
+                for (size_t i = 0; i < num_symbols; ++i)
+                {
+                    const Symbol *symbol = symtab->SymbolAtIndex(i);
+                    const SymbolType sym_type = symbol->GetType();
+                    if (sym_type != eSymbolTypeCode && sym_type != eSymbolTypeResolver)
+                        continue;
+                    ConstString name = symbol->GetMangled().GetName(symbol->GetLanguage(), Mangled::ePreferDemangled);
+                    if (name)
+                        m_completion_function_names.push_back(name);
+                }
+            }
+
+            SymbolFile *symbol_file = symbols->GetSymbolFile();
+            if (symbol_file)
+                symbol_file->GetFunctionNames(m_completion_function_names);
+        }
+
+        // Sort by the strings, ConstString's operator < only compares the
+        // pointers.
+        std::sort(m_completion_function_names.begin(), m_completion_function_names.end(),
+                  [](const ConstString &lhs, const ConstString &rhs) {
+                      return lhs.GetStringRef() < rhs.GetStringRef();
+                  });
+        m_completion_function_names.erase(std::unique(m_completion_function_names.begin(),
+                                                      m_completion_function_names.end()),
+                                          m_completion_function_names.end());
+    }
+
+    size_t num_matches = 0;
+    std::vector<ConstString>::const_iterator pos =
+        std::lower_bound(m_completion_function_names.begin(), m_completion_function_names.end(), prefix,
+                         [](const ConstString &name, llvm::StringRef prefix) {
+                             return name.GetStringRef() < prefix;
+                         });
+    for (; pos != m_completion_function_names.end() && num_matches < max_matches; ++pos, ++num_matches)
+    {
+        if (!pos->GetStringRef().startswith(prefix))
+            break;
+        names.push_back(*pos);
+    }
+    return num_matches;
+}
+
+size_t
+Module::FindCompileUnitsWithFilePrefix (llvm::StringRef file_prefix,
+                                        llvm::StringRef dir_prefix,
+                                        size_t max_matches,
+                                        std::vector<CompUnitSP> &comp_units)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    if (!m_completion_comp_units_indexed)
+    {
+        m_completion_comp_units_indexed = true;
+        const size_t num_comp_units = GetNumCompileUnits();
+        for (size_t i = 0; i < num_comp_units; ++i)
+        {
+            CompUnitSP comp_unit_sp (GetCompileUnitAtIndex(i));
+            if (comp_unit_sp && comp_unit_sp->GetFilename())
+                m_completion_comp_units.push_back(comp_unit_sp);
+        }
+        std::stable_sort(m_completion_comp_units.begin(), m_completion_comp_units.end(),
+                         [](const CompUnitSP &lhs, const CompUnitSP &rhs) {
+                             return lhs->GetFilename().GetStringRef() < rhs->GetFilename().GetStringRef();
+                         });
+    }
+
+    size_t num_matches = 0;
+    std::vector<CompUnitSP>::const_iterator pos =
+        std::lower_bound(m_completion_comp_units.begin(), m_completion_comp_units.end(), file_prefix,
+                         [](const CompUnitSP &comp_unit_sp, llvm::StringRef prefix) {
+                             return comp_unit_sp->GetFilename().GetStringRef() < prefix;
+                         });
+    for (; pos != m_completion_comp_units.end() && num_matches < max_matches; ++pos)
+    {
+        if (!(*pos)->GetFilename().GetStringRef().startswith(file_prefix))
+            break;
+        if (!(*pos)->GetDirectory().GetStringRef().startswith(dir_prefix))
+            continue;
+        comp_units.push_back(*pos);
+        ++num_matches;
+    }
+    return num_matches;
+}
+
+bool
+Module::FindCompileUnitIndexesForFilename (const ConstString &filename,
+                                           bool check_inlines,
+                                           std::vector<uint32_t> &cu_indexes)
+{
+    cu_indexes.clear();
+    // The file specs of Windows modules compare without case.
+    if (m_arch.GetTriple().isOSWindows())
+        return false;
+
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    FilenameToCompUnitIndexes &index = check_inlines ? m_support_file_filename_index : m_comp_unit_filename_index;
+    const bool indexed = check_inlines ? m_support_file_filenames_indexed : m_comp_unit_filenames_indexed;
+    if (!indexed)
+    {
+        if (check_inlines)
+            m_support_file_filenames_indexed = true;
+        else
+            m_comp_unit_filenames_indexed = true;
+
+        const uint32_t num_comp_units = GetNumCompileUnits();
+        for (uint32_t cu_idx = 0; cu_idx < num_comp_units; ++cu_idx)
+        {
+            CompUnitSP comp_unit_sp (GetCompileUnitAtIndex(cu_idx));
+            if (!comp_unit_sp)
+                continue;
+            if (comp_unit_sp->GetFilename())
+                index[comp_unit_sp->GetFilename().GetCString()].push_back(cu_idx);
+            if (!check_inlines)
+                continue;
+            const FileSpecList &support_files = comp_unit_sp->GetSupportFiles();
+            const size_t num_support_files = support_files.GetSize();
+            for (size_t file_idx = 0; file_idx < num_support_files; ++file_idx)
+            {
+                const char *support_filename = support_files.GetFileSpecAtIndex(file_idx).GetFilename().GetCString();
+                if (support_filename == nullptr)
+                    continue;
+                std::vector<uint32_t> &file_cu_indexes = index[support_filename];
+                if (file_cu_indexes.empty() || file_cu_indexes.back() != cu_idx)
+                    file_cu_indexes.push_back(cu_idx);
+            }
+        }
+    }
+
+    FilenameToCompUnitIndexes::const_iterator pos = index.find(filename.GetCString());
+    if (pos != index.end())
+        cu_indexes = pos->second;
+    return true;
+}
+
 SectionList *
 Module::GetSectionList()
 {
@@ -1352,7 +1662,8 @@ Module::GetUnifiedSectionList()
 const Symbol *
 Module::FindFirstSymbolWithNameAndType (const ConstString &name, SymbolType symbol_type)
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "Module::FindFirstSymbolWithNameAndType (name = %s, type = %i)",
                        name.AsCString(),
                        symbol_type);
@@ -1390,7 +1701,8 @@ Module::FindFunctionSymbols (const ConstString &name,
                              uint32_t name_type_mask,
                              SymbolContextList& sc_list)
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "Module::FindSymbolsFunctions (name = %s, mask = 0x%8.8x)",
                        name.AsCString(),
                        name_type_mask);
@@ -1410,7 +1722,8 @@ Module::FindSymbolsWithNameAndType (const ConstString &name, SymbolType symbol_t
     // No need to protect this call using m_mutex all other method calls are
     // already thread safe.
 
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "Module::FindSymbolsWithNameAndType (name = %s, type = %i)",
                        name.AsCString(),
                        symbol_type);
@@ -1435,7 +1748,8 @@ Module::FindSymbolsMatchingRegExAndType (const RegularExpression &regex, SymbolT
     // No need to protect this call using m_mutex all other method calls are
     // already thread safe.
 
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "Module::FindSymbolsMatchingRegExAndType (regex = %s, type = %i)",
                        regex.GetText(),
                        symbol_type);
@@ -1518,6 +1832,17 @@ Module::SetSymbolFileFileSpec (const FileSpec &file)
     m_symfile_spec = file;
     m_symfile_ap.reset();
     m_did_load_symbol_vendor = false;
+
+    // The names, compile units and blocks come from the symbol file.
+    m_inlined_call_chains.clear();
+    m_completion_function_names.clear();
+    m_completion_comp_units.clear();
+    m_completion_function_names_indexed = false;
+    m_completion_comp_units_indexed = false;
+    m_comp_unit_filename_index.clear();
+    m_support_file_filename_index.clear();
+    m_comp_unit_filenames_indexed = false;
+    m_support_file_filenames_indexed = false;
 }
 
 bool
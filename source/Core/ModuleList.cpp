@@ -11,10 +11,14 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <cstdint>
 #include <mutex>
+#include <unordered_set>
 
 // Other libraries and framework includes
+#include "llvm/ADT/Hashing.h"
+
 // Project includes
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
@@ -23,23 +27,84 @@
 #include "lldb/Host/Symbols.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/TypeList.h"
 #include "lldb/Symbol/VariableList.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
-ModuleList::ModuleList() : m_modules(), m_modules_mutex(), m_notifier(nullptr)
+namespace
+{
+    // Lists with fewer modules than this are searched without building
+    // the indexes.
+    const size_t kMinIndexedModules = 32;
+
+    std::string
+    GetUUIDIndexKey (const UUID &uuid)
+    {
+        return std::string (static_cast<const char *>(uuid.GetBytes()), uuid.GetByteSize());
+    }
+
+    // Removes the first entry of "module" under "key". A module that is in
+    // the list more than once has an entry for each time.
+    template <typename Index, typename Key>
+    void
+    RemoveFromIndex (Index &index, const Key &key, const Module *module)
+    {
+        auto range = index.equal_range (key);
+        auto first = index.end();
+        for (auto pos = range.first; pos != range.second; ++pos)
+        {
+            if (pos->second.module_sp.get() == module &&
+                (first == index.end() || pos->second.order < first->second.order))
+                first = pos;
+        }
+        if (first != index.end())
+            index.erase (first);
+    }
+}
+
+ModuleList::ModuleList() :
+    m_modules(),
+    m_modules_mutex(),
+    m_notifier(nullptr),
+      m_indexes_valid(false),
+      m_indexes_generation(0),
+      m_next_index_order(0),
+      m_uuid_index(),
+      m_name_index(),
+      m_unparsed_uuid_modules()
 {
 }
 
-ModuleList::ModuleList(const ModuleList &rhs) : m_modules(), m_modules_mutex(), m_notifier(nullptr)
+ModuleList::ModuleList(const ModuleList &rhs) :
+    m_modules(),
+    m_modules_mutex(),
+    m_notifier(nullptr),
+      m_indexes_valid(false),
+      m_indexes_generation(0),
+      m_next_index_order(0),
+      m_uuid_index(),
+      m_name_index(),
+      m_unparsed_uuid_modules()
 {
     std::lock_guard<std::recursive_mutex> lhs_guard(m_modules_mutex);
     std::lock_guard<std::recursive_mutex> rhs_guard(rhs.m_modules_mutex);
     m_modules = rhs.m_modules;
 }
 
-ModuleList::ModuleList(ModuleList::Notifier *notifier) : m_modules(), m_modules_mutex(), m_notifier(notifier)
+ModuleList::ModuleList(ModuleList::Notifier *notifier) :
+    m_modules(),
+    m_modules_mutex(),
+    m_notifier(notifier),
+      m_indexes_valid(false),
+      m_indexes_generation(0),
+      m_next_index_order(0),
+      m_uuid_index(),
+      m_name_index(),
+      m_unparsed_uuid_modules()
 {
 }
 
@@ -63,12 +128,14 @@ ModuleList::operator= (const ModuleList& rhs)
             std::lock_guard<std::recursive_mutex> lhs_guard(m_modules_mutex);
             std::lock_guard<std::recursive_mutex> rhs_guard(rhs.m_modules_mutex);
             m_modules = rhs.m_modules;
+            ClearIndexes();
         }
         else
         {
             std::lock_guard<std::recursive_mutex> lhs_guard(m_modules_mutex);
             std::lock_guard<std::recursive_mutex> rhs_guard(rhs.m_modules_mutex);
             m_modules = rhs.m_modules;
+            ClearIndexes();
         }
     }
     return *this;
@@ -83,6 +150,8 @@ ModuleList::AppendImpl (const ModuleSP &module_sp, bool use_notifier)
     {
         std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
         m_modules.push_back(module_sp);
+        if (m_indexes_valid)
+            AddToIndexes(module_sp);
         if (use_notifier && m_notifier)
             m_notifier->ModuleAdded(*this, module_sp);
     }
@@ -106,14 +175,26 @@ ModuleList::ReplaceEquivalent (const ModuleSP &module_sp)
         ModuleSpec equivalent_module_spec (module_sp->GetFileSpec(), module_sp->GetArchitecture());
         equivalent_module_spec.GetPlatformFileSpec() = module_sp->GetPlatformFileSpec();
 
-        size_t idx = 0;
-        while (idx < m_modules.size())
+        std::vector<ModuleSP> candidates;
+        if (GetIndexCandidates (equivalent_module_spec, candidates))
         {
-            ModuleSP module_sp (m_modules[idx]);
-            if (module_sp->MatchesModuleSpec (equivalent_module_spec))
-                RemoveImpl(m_modules.begin() + idx);
-            else
-                ++idx;
+            for (const ModuleSP &candidate_sp : candidates)
+            {
+                if (candidate_sp->MatchesModuleSpec (equivalent_module_spec))
+                    RemoveImpl(candidate_sp);
+            }
+        }
+        else
+        {
+            size_t idx = 0;
+            while (idx < m_modules.size())
+            {
+                ModuleSP module_sp (m_modules[idx]);
+                if (module_sp->MatchesModuleSpec (equivalent_module_spec))
+                    RemoveImpl(m_modules.begin() + idx);
+                else
+                    ++idx;
+            }
         }
         // Now add the new module to the list
         Append(module_sp);
@@ -170,6 +251,7 @@ ModuleList::RemoveImpl (const ModuleSP &module_sp, bool use_notifier)
             if (pos->get() == module_sp.get())
             {
                 m_modules.erase (pos);
+                RemoveFromIndexes (module_sp);
                 if (use_notifier && m_notifier)
                     m_notifier->ModuleRemoved(*this, module_sp);
                 return true;
@@ -184,6 +266,7 @@ ModuleList::RemoveImpl (ModuleList::collection::iterator pos, bool use_notifier)
 {
     ModuleSP module_sp(*pos);
     collection::iterator retval = m_modules.erase(pos);
+    RemoveFromIndexes (module_sp);
     if (use_notifier && m_notifier)
         m_notifier->ModuleRemoved(*this, module_sp);
     return retval;
@@ -296,6 +379,142 @@ ModuleList::ClearImpl (bool use_notifier)
     if (use_notifier && m_notifier)
         m_notifier->WillClearList(*this);
     m_modules.clear();
+    ClearIndexes();
+}
+
+bool
+ModuleList::GetIndexCandidates (const ModuleSpec &module_spec, std::vector<ModuleSP> &candidates) const
+{
+    candidates.clear();
+    if (!m_indexes_valid && m_modules.size() < kMinIndexedModules)
+        return false;
+
+    std::vector<IndexedModule> matches;
+    const UUID &uuid = module_spec.GetUUID();
+    if (uuid.IsValid())
+    {
+        UpdateIndexes();
+        IndexParsedUUIDs();
+        auto range = m_uuid_index.equal_range (GetUUIDIndexKey (uuid));
+        for (auto pos = range.first; pos != range.second; ++pos)
+            matches.push_back (pos->second);
+
+        // These don't have an object file yet, check them the slow way.
+        matches.insert (matches.end(), m_unparsed_uuid_modules.begin(), m_unparsed_uuid_modules.end());
+    }
+    else
+    {
+        // Module::MatchesModuleSpec() compares basenames unless the spec has
+        // a directory, so any module that matches is in the name index.
+        const FileSpec &file_spec = module_spec.GetFileSpec() ? module_spec.GetFileSpec() : module_spec.GetPlatformFileSpec();
+        if (!file_spec.GetFilename() || !file_spec.IsCaseSensitive())
+            return false;
+
+        UpdateIndexes();
+        auto range = m_name_index.equal_range (file_spec.GetFilename().GetCString());
+        for (auto pos = range.first; pos != range.second; ++pos)
+            matches.push_back (pos->second);
+    }
+
+    std::sort (matches.begin(), matches.end(), [](const IndexedModule &lhs, const IndexedModule &rhs) {
+        return lhs.order < rhs.order;
+    });
+    candidates.reserve (matches.size());
+    for (const IndexedModule &match : matches)
+        candidates.push_back (match.module_sp);
+    return true;
+}
+
+void
+ModuleList::UpdateIndexes () const
+{
+    // Changing the path of a module that is already in the list changes
+    // which names it should be indexed under.
+    const uint32_t generation = Module::GetFileSpecGeneration();
+    if (m_indexes_valid && m_indexes_generation == generation)
+        return;
+
+    ClearIndexes();
+    m_indexes_valid = true;
+    m_indexes_generation = generation;
+    for (const ModuleSP &module_sp : m_modules)
+        AddToIndexes (module_sp);
+}
+
+void
+ModuleList::ClearIndexes () const
+{
+    m_indexes_valid = false;
+    m_next_index_order = 0;
+    m_uuid_index.clear();
+    m_name_index.clear();
+    m_unparsed_uuid_modules.clear();
+}
+
+void
+ModuleList::AddToIndexes (const ModuleSP &module_sp) const
+{
+    IndexedModule indexed_module = { module_sp, m_next_index_order++ };
+
+    // Don't make the module read its object file just to index it.
+    if (!module_sp->HasParsedUUID())
+        m_unparsed_uuid_modules.push_back (indexed_module);
+    else if (module_sp->GetUUID().IsValid())
+        m_uuid_index.insert (std::make_pair (GetUUIDIndexKey (module_sp->GetUUID()), indexed_module));
+
+    const char *file_name = module_sp->GetFileSpec().GetFilename().GetCString();
+    const char *platform_file_name = module_sp->GetPlatformFileSpec().GetFilename().GetCString();
+    if (file_name)
+        m_name_index.insert (std::make_pair (file_name, indexed_module));
+    if (platform_file_name && platform_file_name != file_name)
+        m_name_index.insert (std::make_pair (platform_file_name, indexed_module));
+}
+
+void
+ModuleList::RemoveFromIndexes (const ModuleSP &module_sp) const
+{
+    if (!m_indexes_valid)
+        return;
+
+    if (m_indexes_generation != Module::GetFileSpecGeneration())
+    {
+        ClearIndexes();
+        return;
+    }
+
+    Module *module = module_sp.get();
+    auto unparsed_pos = std::find_if (m_unparsed_uuid_modules.begin(), m_unparsed_uuid_modules.end(),
+                                      [module](const IndexedModule &indexed_module) {
+                                          return indexed_module.module_sp.get() == module;
+                                      });
+    if (unparsed_pos != m_unparsed_uuid_modules.end())
+        m_unparsed_uuid_modules.erase (unparsed_pos);
+    else if (module->HasParsedUUID() && module->GetUUID().IsValid())
+        RemoveFromIndex (m_uuid_index, GetUUIDIndexKey (module->GetUUID()), module);
+
+    const char *file_name = module->GetFileSpec().GetFilename().GetCString();
+    const char *platform_file_name = module->GetPlatformFileSpec().GetFilename().GetCString();
+    if (file_name)
+        RemoveFromIndex (m_name_index, file_name, module);
+    if (platform_file_name && platform_file_name != file_name)
+        RemoveFromIndex (m_name_index, platform_file_name, module);
+}
+
+void
+ModuleList::IndexParsedUUIDs () const
+{
+    // A UUID lookup has to parse the UUIDs of the modules that don't have
+    // one yet, the same as checking every module would.
+    size_t num_unparsed = 0;
+    for (IndexedModule &indexed_module : m_unparsed_uuid_modules)
+    {
+        const UUID &uuid = indexed_module.module_sp->GetUUID();
+        if (!indexed_module.module_sp->HasParsedUUID())
+            m_unparsed_uuid_modules[num_unparsed++] = indexed_module;
+        else if (uuid.IsValid())
+            m_uuid_index.insert (std::make_pair (GetUUIDIndexKey (uuid), indexed_module));
+    }
+    m_unparsed_uuid_modules.resize (num_unparsed);
 }
 
 Module*
@@ -467,15 +686,36 @@ ModuleList::FindFunctions(const RegularExpression &name,
                           bool append,
                           SymbolContextList& sc_list)
 {
+    if (!append)
+        sc_list.Clear();
     const size_t old_size = sc_list.GetSize();
 
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
+    if (m_modules.size() <= 1)
+    {
+        collection::const_iterator pos, end = m_modules.end();
+        for (pos = m_modules.begin(); pos != end; ++pos)
+            (*pos)->FindFunctions (name, include_symbols, include_inlines, true, sc_list);
+        return sc_list.GetSize() - old_size;
+    }
+
+    // Matching every name of every module against the expression is
+    // independent work, search the modules in parallel and append their
+    // results in module order. Every task compiles its own copy of the
+    // expression, regexec serializes the callers of a shared one.
+    std::vector<SymbolContextList> module_sc_lists (m_modules.size());
+    TaskRunner<void> task_runner;
+    for (size_t i = 0; i < m_modules.size(); ++i)
     {
-        (*pos)->FindFunctions (name, include_symbols, include_inlines, append, sc_list);
+        task_runner.AddTask([this, &name, &module_sc_lists, include_symbols, include_inlines, i]() {
+            RegularExpression module_regex (name);
+            m_modules[i]->FindFunctions (module_regex, include_symbols, include_inlines, true, module_sc_lists[i]);
+        });
     }
+    task_runner.WaitForAllTasks();
 
+    for (const SymbolContextList &module_sc_list : module_sc_lists)
+        sc_list.Append (module_sc_list);
     return sc_list.GetSize() - old_size;
 }
 
@@ -557,9 +797,28 @@ ModuleList::FindSymbolsMatchingRegExAndType (const RegularExpression &regex,
         sc_list.Clear();
     size_t initial_size = sc_list.GetSize();
     
-    collection::const_iterator pos, end = m_modules.end();
-    for (pos = m_modules.begin(); pos != end; ++pos)
-        (*pos)->FindSymbolsMatchingRegExAndType (regex, symbol_type, sc_list);
+    if (m_modules.size() <= 1)
+    {
+        collection::const_iterator pos, end = m_modules.end();
+        for (pos = m_modules.begin(); pos != end; ++pos)
+            (*pos)->FindSymbolsMatchingRegExAndType (regex, symbol_type, sc_list);
+        return sc_list.GetSize() - initial_size;
+    }
+
+    // Like FindFunctions(), search the symbol tables in parallel.
+    std::vector<SymbolContextList> module_sc_lists (m_modules.size());
+    TaskRunner<void> task_runner;
+    for (size_t i = 0; i < m_modules.size(); ++i)
+    {
+        task_runner.AddTask([this, &regex, &module_sc_lists, symbol_type, i]() {
+            RegularExpression module_regex (regex);
+            m_modules[i]->FindSymbolsMatchingRegExAndType (module_regex, symbol_type, module_sc_lists[i]);
+        });
+    }
+    task_runner.WaitForAllTasks();
+
+    for (const SymbolContextList &module_sc_list : module_sc_lists)
+        sc_list.Append (module_sc_list);
     return sc_list.GetSize() - initial_size;
 }
 
@@ -569,6 +828,17 @@ ModuleList::FindModules (const ModuleSpec &module_spec, ModuleList& matching_mod
     size_t existing_matches = matching_module_list.GetSize();
 
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    std::vector<ModuleSP> candidates;
+    if (GetIndexCandidates (module_spec, candidates))
+    {
+        for (const ModuleSP &module_sp : candidates)
+        {
+            if (module_sp->MatchesModuleSpec (module_spec))
+                matching_module_list.Append(module_sp);
+        }
+        return matching_module_list.GetSize() - existing_matches;
+    }
+
     collection::const_iterator pos, end = m_modules.end();
     for (pos = m_modules.begin(); pos != end; ++pos)
     {
@@ -609,6 +879,19 @@ ModuleList::FindModule (const UUID &uuid) const
     if (uuid.IsValid())
     {
         std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+        ModuleSpec module_spec;
+        module_spec.GetUUID() = uuid;
+        std::vector<ModuleSP> candidates;
+        if (GetIndexCandidates (module_spec, candidates))
+        {
+            for (const ModuleSP &candidate_sp : candidates)
+            {
+                if (candidate_sp->GetUUID() == uuid)
+                    return candidate_sp;
+            }
+            return module_sp;
+        }
+
         collection::const_iterator pos, end = m_modules.end();
         
         for (pos = m_modules.begin(); pos != end; ++pos)
@@ -623,11 +906,95 @@ ModuleList::FindModule (const UUID &uuid) const
     return module_sp;
 }
 
+namespace {
+
+// Every module that includes a header has its own copy of the types in
+// it, e.g. std::string in each shared library linked against libc++.
+// Types with the same name and size that were declared at the same place
+// are the same type, only the first one found is returned.
+struct TypeSignature
+{
+    const char *name;
+    uint64_t byte_size;
+    const char *decl_directory;
+    const char *decl_filename;
+    uint32_t decl_line;
+
+    explicit TypeSignature (Type &type)
+    {
+        const Declaration &decl = type.GetDeclaration();
+        name = type.GetQualifiedName().GetCString();
+        byte_size = type.GetByteSize();
+        decl_directory = decl.GetFile().GetDirectory().GetCString();
+        decl_filename = decl.GetFile().GetFilename().GetCString();
+        decl_line = decl.GetLine();
+    }
+
+    bool
+    operator == (const TypeSignature &rhs) const
+    {
+        // The strings are all ConstStrings, so comparing pointers is enough
+        return name == rhs.name && byte_size == rhs.byte_size && decl_directory == rhs.decl_directory &&
+               decl_filename == rhs.decl_filename && decl_line == rhs.decl_line;
+    }
+};
+
+struct TypeSignatureHash
+{
+    size_t
+    operator () (const TypeSignature &signature) const
+    {
+        return llvm::hash_combine (signature.name, signature.byte_size, signature.decl_directory,
+                                   signature.decl_filename, signature.decl_line);
+    }
+};
+
+typedef std::unordered_set<TypeSignature, TypeSignatureHash> TypeSignatureSet;
+
+// Search "module" for at most the remaining number of types and add the
+// ones with a signature that hasn't been seen yet to "types".
+size_t
+FindUniqueTypesInModule (Module &module,
+                         const SymbolContext &sc,
+                         const ConstString &name,
+                         bool name_is_fully_qualified,
+                         size_t max_matches,
+                         llvm::DenseSet<SymbolFile *> &searched_symbol_files,
+                         TypeSignatureSet &signatures,
+                         TypeList &types)
+{
+    TypeList module_types;
+    module.FindTypes (sc, name, name_is_fully_qualified, max_matches, searched_symbol_files, module_types);
+
+    size_t num_matches = 0;
+    const uint32_t num_types = module_types.GetSize();
+    for (uint32_t i = 0; i < num_types && num_matches < max_matches; ++i)
+    {
+        TypeSP type_sp (module_types.GetTypeAtIndex (i));
+        if (type_sp && signatures.insert (TypeSignature (*type_sp)).second)
+        {
+            types.Insert (type_sp);
+            ++num_matches;
+        }
+    }
+    return num_matches;
+}
+
+} // anonymous namespace
+
 size_t
 ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool name_is_fully_qualified, size_t max_matches, llvm::DenseSet<SymbolFile *> &searched_symbol_files, TypeList& types) const
 {
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
 
+    // Types that are already in the list aren't returned again
+    TypeSignatureSet signatures;
+    types.ForEach ([&signatures](const TypeSP &type_sp) -> bool {
+        if (type_sp)
+            signatures.insert (TypeSignature (*type_sp));
+        return true;
+    });
+
     size_t total_matches = 0;
     collection::const_iterator pos, end = m_modules.end();
     if (sc.module_sp)
@@ -638,7 +1005,9 @@ ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool na
         {
             if (sc.module_sp.get() == (*pos).get())
             {
-                total_matches += (*pos)->FindTypes (sc, name, name_is_fully_qualified, max_matches, searched_symbol_files, types);
+                total_matches += FindUniqueTypesInModule (**pos, sc, name, name_is_fully_qualified,
+                                                          max_matches - total_matches,
+                                                          searched_symbol_files, signatures, types);
 
                 if (total_matches >= max_matches)
                     break;
@@ -655,7 +1024,9 @@ ModuleList::FindTypes (const SymbolContext& sc, const ConstString &name, bool na
             // context "sc". If "sc" contains a empty module shared pointer, then
             // the comparison will always be true (valid_module_ptr != nullptr).
             if (sc.module_sp.get() != (*pos).get())
-                total_matches += (*pos)->FindTypes (world_sc, name, name_is_fully_qualified, max_matches, searched_symbol_files, types);
+                total_matches += FindUniqueTypesInModule (**pos, world_sc, name, name_is_fully_qualified,
+                                                          max_matches - total_matches,
+                                                          searched_symbol_files, signatures, types);
             
             if (total_matches >= max_matches)
                 break;
@@ -697,6 +1068,17 @@ ModuleList::FindFirstModule (const ModuleSpec &module_spec) const
 {
     ModuleSP module_sp;
     std::lock_guard<std::recursive_mutex> guard(m_modules_mutex);
+    std::vector<ModuleSP> candidates;
+    if (GetIndexCandidates (module_spec, candidates))
+    {
+        for (const ModuleSP &candidate_sp : candidates)
+        {
+            if (candidate_sp->MatchesModuleSpec (module_spec))
+                return candidate_sp;
+        }
+        return module_sp;
+    }
+
     collection::const_iterator pos, end = m_modules.end();
     for (pos = m_modules.begin(); pos != end; ++pos)
     {
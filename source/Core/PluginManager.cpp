@@ -11,9 +11,12 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <climits>
+#include <map>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -1162,7 +1165,8 @@ struct ObjectFileInstance
         create_callback(nullptr),
         create_memory_callback(nullptr),
         get_module_specifications(nullptr),
-        save_core(nullptr)
+        save_core(nullptr),
+        magics()
     {
     }
 
@@ -1172,10 +1176,40 @@ struct ObjectFileInstance
     ObjectFileCreateMemoryInstance create_memory_callback;
     ObjectFileGetModuleSpecifications get_module_specifications;
     ObjectFileSaveCore save_core;
+    std::vector<std::string> magics;
 };
 
 typedef std::vector<ObjectFileInstance> ObjectFileInstances;
 
+// The object file plug-ins by the first two bytes of their magics, built
+// when it is first needed after the plug-ins changed.
+struct ObjectFileMagicIndex
+{
+    ObjectFileMagicIndex() :
+        valid(false),
+        by_prefix(),
+        without_magic()
+    {
+    }
+
+    bool valid;
+    std::unordered_map<uint16_t, std::vector<uint32_t>> by_prefix;
+    std::vector<uint32_t> without_magic;
+};
+
+static ObjectFileMagicIndex &
+GetObjectFileMagicIndex ()
+{
+    static ObjectFileMagicIndex g_index;
+    return g_index;
+}
+
+static uint16_t
+GetMagicPrefix (const uint8_t *bytes)
+{
+    return (uint16_t)bytes[0] << 8 | bytes[1];
+}
+
 static std::recursive_mutex &
 GetObjectFileMutex()
 {
@@ -1211,6 +1245,7 @@ PluginManager::RegisterPlugin (const ConstString &name,
         instance.get_module_specifications = get_module_specifications;
         std::lock_guard<std::recursive_mutex> guard(GetObjectFileMutex());
         GetObjectFileInstances ().push_back (instance);
+        GetObjectFileMagicIndex ().valid = false;
     }
     return false;
 }
@@ -1229,6 +1264,7 @@ PluginManager::UnregisterPlugin (ObjectFileCreateInstance create_callback)
             if (pos->create_callback == create_callback)
             {
                 instances.erase(pos);
+                GetObjectFileMagicIndex ().valid = false;
                 return true;
             }
         }
@@ -1302,6 +1338,84 @@ PluginManager::GetObjectFileCreateMemoryCallbackForPluginName (const ConstString
     return nullptr;
 }
 
+bool
+PluginManager::AddObjectFileMagic (ObjectFileCreateInstance create_callback, const void *magic, size_t magic_size)
+{
+    if (create_callback && magic && magic_size > 0)
+    {
+        std::lock_guard<std::recursive_mutex> guard(GetObjectFileMutex());
+        ObjectFileInstances &instances = GetObjectFileInstances ();
+
+        ObjectFileInstances::iterator pos, end = instances.end();
+        for (pos = instances.begin(); pos != end; ++ pos)
+        {
+            if (pos->create_callback == create_callback)
+            {
+                pos->magics.push_back (std::string ((const char *)magic, magic_size));
+                GetObjectFileMagicIndex ().valid = false;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void
+PluginManager::GetObjectFilePluginIndexesForData (const uint8_t *data, size_t data_size, std::vector<uint32_t> &indexes)
+{
+    indexes.clear();
+
+    std::lock_guard<std::recursive_mutex> guard(GetObjectFileMutex());
+    ObjectFileInstances &instances = GetObjectFileInstances ();
+    ObjectFileMagicIndex &index = GetObjectFileMagicIndex ();
+    if (!index.valid)
+    {
+        index.by_prefix.clear();
+        index.without_magic.clear();
+        for (uint32_t idx = 0; idx < instances.size(); ++idx)
+        {
+            // Plug-ins with magics too short to index get every file
+            const std::vector<std::string> &magics = instances[idx].magics;
+            const bool indexable = !magics.empty() &&
+                                   std::all_of (magics.begin(), magics.end(),
+                                                [](const std::string &magic) { return magic.size() >= 2; });
+            if (!indexable)
+            {
+                index.without_magic.push_back (idx);
+                continue;
+            }
+            for (const std::string &magic : magics)
+            {
+                std::vector<uint32_t> &prefix_indexes = index.by_prefix[GetMagicPrefix ((const uint8_t *)magic.data())];
+                if (prefix_indexes.empty() || prefix_indexes.back() != idx)
+                    prefix_indexes.push_back (idx);
+            }
+        }
+        index.valid = true;
+    }
+
+    if (data && data_size >= 2)
+    {
+        auto pos = index.by_prefix.find (GetMagicPrefix (data));
+        if (pos != index.by_prefix.end())
+        {
+            for (uint32_t idx : pos->second)
+            {
+                for (const std::string &magic : instances[idx].magics)
+                {
+                    if (magic.size() <= data_size && memcmp (magic.data(), data, magic.size()) == 0)
+                    {
+                        indexes.push_back (idx);
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    indexes.insert (indexes.end(), index.without_magic.begin(), index.without_magic.end());
+    std::sort (indexes.begin(), indexes.end());
+}
+
 Error
 PluginManager::SaveCore (const lldb::ProcessSP &process_sp, const FileSpec &outfile)
 {
@@ -1925,7 +2039,8 @@ struct SymbolFileInstance
         name(),
         description(),
         create_callback(nullptr),
-        debugger_init_callback(nullptr)
+        debugger_init_callback(nullptr),
+        object_file_plugin_name()
     {
     }
 
@@ -1933,10 +2048,22 @@ struct SymbolFileInstance
     std::string description;
     SymbolFileCreateInstance create_callback;
     DebuggerInitializeCallback debugger_init_callback;
+    ConstString object_file_plugin_name; // Only create for these object files if set
 };
 
 typedef std::vector<SymbolFileInstance> SymbolFileInstances;
 
+// The symbol file plug-ins to try for each object file plug-in, cleared
+// whenever the symbol file plug-ins change.
+typedef std::map<ConstString, std::vector<SymbolFileCreateInstance>> SymbolFileCallbacksByObjectFile;
+
+static SymbolFileCallbacksByObjectFile &
+GetSymbolFileCallbacksByObjectFile ()
+{
+    static SymbolFileCallbacksByObjectFile g_callbacks;
+    return g_callbacks;
+}
+
 static std::recursive_mutex &
 GetSymbolFileMutex()
 {
@@ -1968,6 +2095,7 @@ PluginManager::RegisterPlugin(const ConstString &name,
         instance.debugger_init_callback = debugger_init_callback;
         std::lock_guard<std::recursive_mutex> guard(GetSymbolFileMutex());
         GetSymbolFileInstances ().push_back (instance);
+        GetSymbolFileCallbacksByObjectFile ().clear();
     }
     return false;
 }
@@ -1986,6 +2114,7 @@ PluginManager::UnregisterPlugin (SymbolFileCreateInstance create_callback)
             if (pos->create_callback == create_callback)
             {
                 instances.erase(pos);
+                GetSymbolFileCallbacksByObjectFile ().clear();
                 return true;
             }
         }
@@ -2021,6 +2150,49 @@ PluginManager::GetSymbolFileCreateCallbackForPluginName (const ConstString &name
     return nullptr;
 }
 
+bool
+PluginManager::SetSymbolFileObjectFilePluginName (SymbolFileCreateInstance create_callback,
+                                                  const ConstString &object_file_plugin_name)
+{
+    if (create_callback)
+    {
+        std::lock_guard<std::recursive_mutex> guard(GetSymbolFileMutex());
+        SymbolFileInstances &instances = GetSymbolFileInstances ();
+
+        SymbolFileInstances::iterator pos, end = instances.end();
+        for (pos = instances.begin(); pos != end; ++ pos)
+        {
+            if (pos->create_callback == create_callback)
+            {
+                pos->object_file_plugin_name = object_file_plugin_name;
+                GetSymbolFileCallbacksByObjectFile ().clear();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void
+PluginManager::GetSymbolFileCreateCallbacksForObjectFile (const ConstString &object_file_plugin_name,
+                                                          std::vector<SymbolFileCreateInstance> &create_callbacks)
+{
+    std::lock_guard<std::recursive_mutex> guard(GetSymbolFileMutex());
+    SymbolFileCallbacksByObjectFile &callbacks_by_object_file = GetSymbolFileCallbacksByObjectFile ();
+    SymbolFileCallbacksByObjectFile::iterator pos = callbacks_by_object_file.find (object_file_plugin_name);
+    if (pos == callbacks_by_object_file.end())
+    {
+        std::vector<SymbolFileCreateInstance> callbacks;
+        for (const SymbolFileInstance &instance : GetSymbolFileInstances ())
+        {
+            if (!instance.object_file_plugin_name || instance.object_file_plugin_name == object_file_plugin_name)
+                callbacks.push_back (instance.create_callback);
+        }
+        pos = callbacks_by_object_file.insert (std::make_pair (object_file_plugin_name, callbacks)).first;
+    }
+    create_callbacks = pos->second;
+}
+
 #pragma mark SymbolVendor
 
 struct SymbolVendorInstance
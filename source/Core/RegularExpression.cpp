@@ -11,6 +11,7 @@
 
 // C Includes
 // C++ Includes
+#include <cctype>
 #include <cstring>
 
 // Other libraries and framework includes
@@ -35,7 +36,9 @@ using namespace lldb_private;
 RegularExpression::RegularExpression() :
     m_re(),
     m_comp_err (1),
-    m_preg()
+    m_preg(),
+    m_literal_prefix(),
+    m_required_literal()
 {
     memset(&m_preg, 0, sizeof(m_preg));
 }
@@ -47,7 +50,9 @@ RegularExpression::RegularExpression() :
 RegularExpression::RegularExpression(const char* re) :
     m_re(),
     m_comp_err (1),
-    m_preg()
+    m_preg(),
+    m_literal_prefix(),
+    m_required_literal()
 {
     memset(&m_preg,0,sizeof(m_preg));
     Compile(re);
@@ -99,6 +104,8 @@ RegularExpression::Compile(const char* re)
     {
         m_re = re;
         m_comp_err = ::regcomp (&m_preg, re, DEFAULT_COMPILE_FLAGS);
+        if (m_comp_err == 0)
+            ExtractLiterals ();
     }
     else
     {
@@ -123,7 +130,15 @@ RegularExpression::Execute (const char* s, Match *match) const
     int err = 1;
     if (s != nullptr && m_comp_err == 0)
     {
-        if (match)
+        // Most of the strings a symbol lookup tries don't contain the
+        // literal parts of the expression, comparing strings is much
+        // cheaper than regexec.
+        if (!m_literal_prefix.empty() && ::strncmp (s, m_literal_prefix.c_str(), m_literal_prefix.size()) != 0)
+            err = REG_NOMATCH;
+        else if (m_required_literal.size() > m_literal_prefix.size() &&
+                 ::strstr (s, m_required_literal.c_str()) == nullptr)
+            err = REG_NOMATCH;
+        else if (match)
         {
             err = ::regexec (&m_preg,
                              s,
@@ -206,6 +221,121 @@ RegularExpression::Match::GetMatchSpanningIndices (const char* s, uint32_t idx1,
     return false;
 }
 
+//----------------------------------------------------------------------
+// Find the runs of literal characters every match has to contain. Only
+// the top level of the expression is looked at: a run ends at anything
+// that isn't a plain character, and a character followed by a
+// quantifier that allows zero repetitions isn't part of it. Expressions
+// with alternatives have no required literals.
+//----------------------------------------------------------------------
+void
+RegularExpression::ExtractLiterals ()
+{
+    m_literal_prefix.clear();
+    m_required_literal.clear();
+    if (m_re.find('|') != std::string::npos)
+        return;
+
+    const char *p = m_re.c_str();
+    bool in_prefix = false;
+    if (*p == '^')
+    {
+        in_prefix = true;
+        ++p;
+    }
+
+    int depth = 0;
+    std::string run;
+    auto end_run = [this, &run, &in_prefix]() {
+        if (in_prefix)
+            m_literal_prefix = run;
+        in_prefix = false;
+        if (run.size() > m_required_literal.size())
+            m_required_literal = run;
+        run.clear();
+    };
+
+    while (*p)
+    {
+        const char c = *p;
+        if (c == '\\')
+        {
+            // Escaped punctuation is literal, escaped letters and digits
+            // are classes, anchors or back references.
+            const char escaped = p[1];
+            if (escaped == '\0')
+                break;
+            if (depth == 0 && !isalnum(escaped) && escaped != '<' && escaped != '>' &&
+                escaped != '`' && escaped != '\'')
+                run.push_back(escaped);
+            else
+                end_run();
+            p += 2;
+        }
+        else if (c == '[')
+        {
+            // Skip the bracket expression, a ']' right after the "[" or
+            // "[^" is part of it.
+            end_run();
+            ++p;
+            if (*p == '^')
+                ++p;
+            if (*p == ']')
+                ++p;
+            while (*p && *p != ']')
+            {
+                if (*p == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+                {
+                    const char delimiter = p[1];
+                    p += 2;
+                    while (*p && !(p[0] == delimiter && p[1] == ']'))
+                        ++p;
+                    if (*p)
+                        p += 2;
+                }
+                else
+                    ++p;
+            }
+            if (*p)
+                ++p;
+        }
+        else if (c == '*' || c == '?' || c == '{')
+        {
+            // The previous character might not be there at all.
+            if (!run.empty())
+                run.pop_back();
+            end_run();
+            if (c == '{')
+            {
+                while (*p && *p != '}')
+                    ++p;
+            }
+            if (*p)
+                ++p;
+        }
+        else if (c == '+' || c == '.' || c == '^' || c == '$' || c == '(' || c == ')')
+        {
+            if (c == '(')
+                ++depth;
+            else if (c == ')')
+                --depth;
+            end_run();
+            ++p;
+        }
+        else
+        {
+            // Characters in a group aren't required, the group might be
+            // optional.
+            if (depth == 0)
+                run.push_back(c);
+            else
+                end_run();
+            ++p;
+        }
+    }
+    end_run();
+}
+
 //----------------------------------------------------------------------
 // Returns true if the regular expression compiled and is ready
 // for execution.
@@ -235,6 +365,8 @@ RegularExpression::Free()
     if (m_comp_err == 0)
     {
         m_re.clear();
+        m_literal_prefix.clear();
+        m_required_literal.clear();
         regfree(&m_preg);
         // Set a compile error since we no longer have a valid regex
         m_comp_err = 1;
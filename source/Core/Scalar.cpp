@@ -11,9 +11,11 @@
 
 // C Includes
 // C++ Includes
+#include <cfloat>
 #include <cinttypes>
 #include <cmath>
 #include <cstdio>
+#include <functional>
 
 // Other libraries and framework includes
 #include "llvm/ADT/SmallString.h"
@@ -45,7 +47,6 @@ PromoteToMaxType
     const Scalar* &promoted_rhs_ptr // Pointer to the resulting possibly promoted value of rhs (at most one of lhs/rhs will get promoted)
 )
 {
-    Scalar result;
     // Initialize the promoted values for both the right and left hand side values
     // to be the objects themselves. If no promotion is needed (both right and left
     // have the same type), then the temp_value will not get used.
@@ -78,6 +79,38 @@ PromoteToMaxType
     return Scalar::e_void;
 }
 
+//----------------------------------------------------------------------
+// APFloat does its arithmetic in software. For single and double
+// precision values the host's floating point gives the same results, as
+// both round to nearest even, and is much faster. Returns false if the
+// operation has to be done with APFloat.
+//----------------------------------------------------------------------
+template <template <typename> class Operation>
+static bool
+NativeFloatOperation (const llvm::APFloat &lhs, const llvm::APFloat &rhs, llvm::APFloat &result)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    // Scalar types don't always match the semantics of m_float, look at
+    // the semantics themselves.
+    const llvm::fltSemantics &semantics = lhs.getSemantics();
+    if (&semantics != &rhs.getSemantics())
+        return false;
+    if (&semantics == &llvm::APFloat::IEEEsingle)
+    {
+        result = llvm::APFloat(Operation<float>()(lhs.convertToFloat(), rhs.convertToFloat()));
+        return true;
+    }
+    if (&semantics == &llvm::APFloat::IEEEdouble)
+    {
+        result = llvm::APFloat(Operation<double>()(lhs.convertToDouble(), rhs.convertToDouble()));
+        return true;
+    }
+#endif
+    // Hosts that evaluate float expressions with excess precision could
+    // round differently.
+    return false;
+}
+
 Scalar::Scalar() :
     m_type(e_void),
     m_float((float)0)
@@ -1856,7 +1889,8 @@ Scalar::operator+= (const Scalar& rhs)
              case e_float:
              case e_double:
              case e_long_double:
-                 m_float = a->m_float + b->m_float;
+                 if (!NativeFloatOperation<std::plus>(a->m_float, b->m_float, m_float))
+                     m_float = a->m_float + b->m_float;
                  break;
         }
     }
@@ -2163,7 +2197,9 @@ lldb_private::operator+ (const Scalar& lhs, const Scalar& rhs)
         case Scalar::e_float:
         case Scalar::e_double:
         case Scalar::e_long_double:
-            result.m_float = a->m_float + b->m_float; break;
+            if (!NativeFloatOperation<std::plus>(a->m_float, b->m_float, result.m_float))
+                result.m_float = a->m_float + b->m_float;
+            break;
         }
     }
     return result;
@@ -2195,7 +2231,9 @@ lldb_private::operator- (const Scalar& lhs, const Scalar& rhs)
         case Scalar::e_float:
         case Scalar::e_double:
         case Scalar::e_long_double:
-            result.m_float = a->m_float - b->m_float; break;
+            if (!NativeFloatOperation<std::minus>(a->m_float, b->m_float, result.m_float))
+                result.m_float = a->m_float - b->m_float;
+            break;
         }
     }
     return result;
@@ -2238,9 +2276,10 @@ lldb_private::operator/ (const Scalar& lhs, const Scalar& rhs)
         case Scalar::e_float:
         case Scalar::e_double:
         case Scalar::e_long_double:
-            if (b->m_float.isZero())
+            if (!b->m_float.isZero())
             {
-                result.m_float = a->m_float / b->m_float;
+                if (!NativeFloatOperation<std::divides>(a->m_float, b->m_float, result.m_float))
+                    result.m_float = a->m_float / b->m_float;
                 return result;
             }
             break;
@@ -2278,7 +2317,9 @@ lldb_private::operator* (const Scalar& lhs, const Scalar& rhs)
         case Scalar::e_float:
         case Scalar::e_double:
         case Scalar::e_long_double:
-            result.m_float = a->m_float * b->m_float; break;
+            if (!NativeFloatOperation<std::multiplies>(a->m_float, b->m_float, result.m_float))
+                result.m_float = a->m_float * b->m_float;
+            break;
         }
     }
     return result;
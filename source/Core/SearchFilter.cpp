@@ -212,10 +212,20 @@ SearchFilter::DoCUIteration (const ModuleSP &module_sp, const SymbolContext &con
     Searcher::CallbackReturn shouldContinue;
     if (context.comp_unit == nullptr)
     {
-        const size_t num_comp_units = module_sp->GetNumCompileUnits();
+        // If the searcher only wants the compile units of one source file
+        // let the module's file name index pick them.
+        FileSpec source_file;
+        bool check_inlines = false;
+        std::vector<uint32_t> cu_indexes;
+        const bool use_cu_index = searcher.GetSourceFileFilter(source_file, check_inlines) &&
+                                  source_file.GetFilename() && source_file.IsCaseSensitive() &&
+                                  module_sp->FindCompileUnitIndexesForFilename(source_file.GetFilename(),
+                                                                               check_inlines, cu_indexes);
+
+        const size_t num_comp_units = use_cu_index ? cu_indexes.size() : module_sp->GetNumCompileUnits();
         for (size_t i = 0; i < num_comp_units; i++)
         {
-            CompUnitSP cu_sp (module_sp->GetCompileUnitAtIndex (i));
+            CompUnitSP cu_sp (module_sp->GetCompileUnitAtIndex (use_cu_index ? cu_indexes[i] : i));
             if (cu_sp)
             {
                 if (!CompUnitPasses (*(cu_sp.get())))
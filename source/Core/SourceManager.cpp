@@ -22,6 +22,7 @@
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -97,6 +98,35 @@ SourceManager::GetFile (const FileSpec &file_spec)
     return file_sp;
 }
 
+void
+SourceManager::PrefetchFile (const FileSpec &file_spec)
+{
+    DebuggerSP debugger_sp (m_debugger_wp.lock());
+    if (!debugger_sp || !file_spec)
+        return;
+
+    if (m_last_file_sp && m_last_file_sp->FileSpecMatches (file_spec))
+        return;
+    if (debugger_sp->GetSourceFileCache().FindSourceFile (file_spec))
+        return;
+
+    // Finding files that aren't at their build location needs the target,
+    // leave those to GetFile.
+    if (!file_spec.Exists())
+        return;
+
+    DebuggerWP debugger_wp (debugger_sp);
+    TaskPool::AddTaskWithPriority (TaskPool::ePriorityLow, [debugger_wp, file_spec]()
+    {
+        FileSP file_sp (new File (file_spec, nullptr));
+        file_sp->GetNumLines();
+
+        DebuggerSP debugger_sp (debugger_wp.lock());
+        if (debugger_sp)
+            debugger_sp->GetSourceFileCache().AddSourceFile (file_sp);
+    });
+}
+
 size_t
 SourceManager::DisplaySourceLinesWithLineNumbersUsingLastFile (uint32_t start_line,
                                                                uint32_t count,
@@ -334,13 +364,58 @@ SourceManager::FindLinesMatchingRegex (FileSpec &file_spec,
     return file_sp->FindLinesMatchingRegex (regex, start_line, end_line, match_lines);
 }
 
+bool
+SourceManager::FindLinesMatchingRegexInFile (const FileSpec &file_spec,
+                                             const RegularExpression &regex,
+                                             std::vector<uint32_t> &match_lines)
+{
+    match_lines.clear();
+    DataBufferSP data_sp (file_spec.MemoryMapFileContents());
+    if (!data_sp || data_sp->GetBytes() == NULL)
+        return false;
+
+    // Split the lines the way File::CalculateLineOffsets does, each line
+    // is matched together with its end of line characters.
+    const char *start = (const char *)data_sp->GetBytes();
+    const char *end = start + data_sp->GetByteSize();
+    const char *line_start = start;
+    uint32_t line_no = 1;
+    std::string buffer;
+    for (const char *s = start; s < end; ++s)
+    {
+        char curr_ch = *s;
+        if (!is_newline_char (curr_ch))
+            continue;
+        if (s + 1 < end)
+        {
+            char next_ch = s[1];
+            if (is_newline_char (next_ch) && curr_ch != next_ch)
+                ++s;
+        }
+        buffer.assign (line_start, s + 1 - line_start);
+        if (regex.Execute (buffer.c_str()))
+            match_lines.push_back (line_no);
+        line_start = s + 1;
+        ++line_no;
+    }
+    if (line_start < end)
+    {
+        buffer.assign (line_start, end - line_start);
+        if (regex.Execute (buffer.c_str()))
+            match_lines.push_back (line_no);
+    }
+    return true;
+}
+
 SourceManager::File::File(const FileSpec &file_spec, Target *target) :
     m_file_spec_orig (file_spec),
     m_file_spec(file_spec),
     m_mod_time (file_spec.GetModificationTime()),
     m_source_map_mod_id (0),
     m_data_sp(),
-    m_offsets()
+    m_offsets(),
+    m_offsets_complete (false),
+    m_offsets_scanned (0)
 {
     if (!m_mod_time.IsValid())
     {
@@ -410,13 +485,35 @@ SourceManager::File::File(const FileSpec &file_spec, Target *target) :
     }
     
     if (m_mod_time.IsValid())
-        m_data_sp = m_file_spec.ReadFileContents ();
+        ReadFileData ();
 }
 
 SourceManager::File::~File()
 {
 }
 
+void
+SourceManager::File::ReadFileData ()
+{
+    // Map the file rather than copying it, only the lines that get shown
+    // are ever paged in.
+    m_data_sp = m_file_spec.MemoryMapFileContents ();
+    if (!m_data_sp || m_data_sp->GetBytes() == nullptr)
+        m_data_sp = m_file_spec.ReadFileContents ();
+    m_offsets.clear();
+    m_offsets_complete = false;
+    m_offsets_scanned = 0;
+}
+
+size_t
+SourceManager::File::GetMemoryUsage () const
+{
+    size_t byte_size = m_offsets.capacity() * sizeof(uint32_t);
+    if (m_data_sp)
+        byte_size += m_data_sp->GetByteSize();
+    return byte_size;
+}
+
 uint32_t
 SourceManager::File::GetLineOffset (uint32_t line)
 {
@@ -506,8 +603,7 @@ SourceManager::File::UpdateIfNeeded ()
     if (curr_mod_time.IsValid() && m_mod_time != curr_mod_time)
     {
         m_mod_time = curr_mod_time;
-        m_data_sp = m_file_spec.ReadFileContents ();
-        m_offsets.clear();
+        ReadFileData ();
     }
 }
 
@@ -594,66 +690,53 @@ lldb_private::operator== (const SourceManager::File &lhs, const SourceManager::F
 bool
 SourceManager::File::CalculateLineOffsets (uint32_t line)
 {
-    line = UINT32_MAX;  // TODO: take this line out when we support partial indexing
-    if (line == UINT32_MAX)
-    {
-        // Already done?
-        if (!m_offsets.empty() && m_offsets[0] == UINT32_MAX)
-            return true;
+    // Already done?
+    if (m_offsets_complete)
+        return true;
 
-        if (m_offsets.empty())
-        {
-            if (m_data_sp.get() == NULL)
-                return false;
+    if (m_data_sp.get() == NULL)
+        return false;
 
-            const char *start = (char *)m_data_sp->GetBytes();
-            if (start)
-            {
-                const char *end = start + m_data_sp->GetByteSize();
+    const char *start = (char *)m_data_sp->GetBytes();
+    if (start == NULL)
+        return false;
 
-                // Calculate all line offsets from scratch
+    const char *end = start + m_data_sp->GetByteSize();
 
-                // Push a 1 at index zero to indicate the file has been completely indexed.
-                m_offsets.push_back(UINT32_MAX);
-                const char *s;
-                for (s = start; s < end; ++s)
-                {
-                    char curr_ch = *s;
-                    if (is_newline_char (curr_ch))
-                    {
-                        if (s + 1 < end)
-                        {
-                            char next_ch = s[1];
-                            if (is_newline_char (next_ch))
-                            {
-                                if (curr_ch != next_ch)
-                                    ++s;
-                            }
-                        }
-                        m_offsets.push_back(s + 1 - start);
-                    }
-                }
-                if (!m_offsets.empty())
+    // Index zero is a placeholder, m_offsets[n] is the offset of line n + 1.
+    if (m_offsets.empty())
+        m_offsets.push_back(UINT32_MAX);
+
+    // Continue where we last left off and stop once "line" and the line
+    // after it have offsets, so looking at the top of a big file doesn't
+    // index all of it.
+    const char *s;
+    for (s = start + m_offsets_scanned; s < end && m_offsets.size() <= line; ++s)
+    {
+        char curr_ch = *s;
+        if (is_newline_char (curr_ch))
+        {
+            if (s + 1 < end)
+            {
+                char next_ch = s[1];
+                if (is_newline_char (next_ch))
                 {
-                    if (m_offsets.back() < end - start)
-                        m_offsets.push_back(end - start);
+                    if (curr_ch != next_ch)
+                        ++s;
                 }
-                return true;
             }
+            m_offsets.push_back(s + 1 - start);
         }
-        else
-        {
-            // Some lines have been populated, start where we last left off
-            assert("Not implemented yet" && false);
-        }
-
     }
-    else
+    m_offsets_scanned = s - start;
+
+    if (s >= end)
     {
-        // Calculate all line offsets up to "line"
-        assert("Not implemented yet" && false);
+        if (m_offsets.back() < end - start)
+            m_offsets.push_back(end - start);
+        m_offsets_complete = true;
     }
-    return false;
+    return true;
 }
 
 bool
@@ -673,27 +756,88 @@ SourceManager::File::GetLine (uint32_t line_no, std::string &buffer)
     return true;
 }
 
+SourceManager::SourceFileCache::SourceFileCache () :
+    m_mutex (),
+    m_file_cache (),
+    m_lru (),
+    m_byte_size (0),
+    m_max_byte_size (64 * 1024 * 1024)
+{
+}
+
 void 
 SourceManager::SourceFileCache::AddSourceFile (const FileSP &file_sp)
 {
-    FileSpec file_spec;
+    if (!file_sp)
+        return;
+
+    const FileSpec &file_spec = file_sp->GetFileSpec();
+    const size_t byte_size = file_sp->GetMemoryUsage();
+
+    std::lock_guard<std::mutex> guard(m_mutex);
     FileCache::iterator pos = m_file_cache.find(file_spec);
-    if (pos == m_file_cache.end())
-        m_file_cache[file_spec] = file_sp;
-    else
+    if (pos != m_file_cache.end())
     {
-        if (file_sp != pos->second)
-            m_file_cache[file_spec] = file_sp;
+        m_byte_size -= pos->second.byte_size;
+        m_lru.erase (pos->second.lru_pos);
+        m_file_cache.erase (pos);
     }
+
+    m_lru.push_front (file_spec);
+    CacheEntry entry = { file_sp, byte_size, m_lru.begin() };
+    m_file_cache[file_spec] = entry;
+    m_byte_size += byte_size;
+    RemoveLeastRecentlyUsed ();
 }
 
 SourceManager::FileSP 
-SourceManager::SourceFileCache::FindSourceFile (const FileSpec &file_spec) const
+SourceManager::SourceFileCache::FindSourceFile (const FileSpec &file_spec)
 {
     FileSP file_sp;
-    FileCache::const_iterator pos = m_file_cache.find(file_spec);
+    std::lock_guard<std::mutex> guard(m_mutex);
+    FileCache::iterator pos = m_file_cache.find(file_spec);
     if (pos != m_file_cache.end())
-        file_sp = pos->second;
+    {
+        file_sp = pos->second.file_sp;
+        m_lru.splice (m_lru.begin(), m_lru, pos->second.lru_pos);
+
+        // The line table grows as more of the file is looked at.
+        const size_t byte_size = file_sp->GetMemoryUsage();
+        m_byte_size = m_byte_size - pos->second.byte_size + byte_size;
+        pos->second.byte_size = byte_size;
+        RemoveLeastRecentlyUsed ();
+    }
     return file_sp;
 }
 
+void
+SourceManager::SourceFileCache::SetMaxByteSize (size_t max_byte_size)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_max_byte_size = max_byte_size;
+    RemoveLeastRecentlyUsed ();
+}
+
+size_t
+SourceManager::SourceFileCache::GetByteSize ()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_byte_size;
+}
+
+// The caller must hold m_mutex.  The most recently used file is always
+// kept, even if it alone is over the limit.
+void
+SourceManager::SourceFileCache::RemoveLeastRecentlyUsed ()
+{
+    while (m_byte_size > m_max_byte_size && m_lru.size() > 1)
+    {
+        FileCache::iterator pos = m_file_cache.find (m_lru.back());
+        if (pos != m_file_cache.end())
+        {
+            m_byte_size -= pos->second.byte_size;
+            m_file_cache.erase (pos);
+        }
+        m_lru.pop_back();
+    }
+}
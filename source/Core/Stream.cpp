@@ -9,6 +9,7 @@
 
 #include "lldb/Core/Stream.h"
 #include "lldb/Host/Endian.h"
+#include "lldb/Utility/HexEncoding.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <string.h>
@@ -16,6 +17,8 @@
 
 #include <inttypes.h>
 
+#include <algorithm>
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -707,8 +710,16 @@ Stream::PutBytesAsRawHex8 (const void *s, size_t src_len, ByteOrder src_byte_ord
     m_flags.Clear(eBinary);
     if (src_byte_order == dst_byte_order)
     {
-        for (size_t i = 0; i < src_len; ++i)
-            bytes_written += _PutHex8 (src[i], false);
+        // Memory and register contents go through here, encode them a
+        // buffer at a time.
+        char hex_chars[512];
+        const size_t max_chunk_len = sizeof(hex_chars) / 2;
+        for (size_t i = 0; i < src_len; i += max_chunk_len)
+        {
+            const size_t chunk_len = std::min(src_len - i, max_chunk_len);
+            HexEncode (src + i, chunk_len, hex_chars);
+            bytes_written += Write (hex_chars, chunk_len * 2);
+        }
     }
     else
     {
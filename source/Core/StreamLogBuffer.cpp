@@ -0,0 +1,237 @@
+//===-- StreamLogBuffer.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <inttypes.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/Support/Signals.h"
+
+// Project includes
+#include "lldb/Core/StreamLogBuffer.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+const size_t StreamLogBuffer::kRecordSize;
+const uint32_t StreamLogBuffer::kDefaultNumRecords;
+
+namespace
+{
+    std::mutex &
+    GetFlightRecordersMutex ()
+    {
+        static std::mutex g_mutex;
+        return g_mutex;
+    }
+
+    std::vector<StreamLogBuffer *> &
+    GetFlightRecorders ()
+    {
+        static std::vector<StreamLogBuffer *> g_flight_recorders;
+        return g_flight_recorders;
+    }
+
+    void
+    DrainFlightRecordersOnCrash (void *)
+    {
+        StreamLogBuffer::DrainFlightRecorders();
+    }
+}
+
+StreamLogBuffer::StreamLogBuffer (const StreamSP &stream_sp, Mode mode, uint32_t num_records) :
+    Stream (),
+    m_stream_sp (stream_sp),
+    m_mode (mode),
+    m_num_records (std::max<uint32_t>(num_records, 1)),
+    m_records (new Record[m_num_records]),
+    m_next_seq (0),
+    m_drain_mutex (),
+    m_drained_seq (0),
+    m_num_dropped (0),
+    m_thread_mutex (),
+    m_thread_cond (),
+    m_stop_thread (false),
+    m_thread ()
+{
+    for (uint32_t i = 0; i < m_num_records; ++i)
+    {
+        m_records[i].state.store(0, std::memory_order_relaxed);
+        m_records[i].length = 0;
+    }
+
+    if (m_mode == eModeAsync)
+    {
+        m_thread = std::thread(&StreamLogBuffer::DrainThread, this);
+    }
+    else
+    {
+        std::lock_guard<std::mutex> guard(GetFlightRecordersMutex());
+        static bool g_installed_signal_handler = false;
+        if (!g_installed_signal_handler)
+        {
+            llvm::sys::AddSignalHandler(DrainFlightRecordersOnCrash, nullptr);
+            g_installed_signal_handler = true;
+        }
+        GetFlightRecorders().push_back(this);
+    }
+}
+
+StreamLogBuffer::~StreamLogBuffer ()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_thread_mutex);
+            m_stop_thread = true;
+        }
+        m_thread_cond.notify_one();
+        m_thread.join();
+        Drain();
+    }
+    else
+    {
+        // Flight recorder records are only written when asked for.
+        std::lock_guard<std::mutex> guard(GetFlightRecordersMutex());
+        std::vector<StreamLogBuffer *> &flight_recorders = GetFlightRecorders();
+        flight_recorders.erase(std::remove(flight_recorders.begin(), flight_recorders.end(), this), flight_recorders.end());
+    }
+}
+
+void
+StreamLogBuffer::Flush ()
+{
+}
+
+size_t
+StreamLogBuffer::Write (const void *src, size_t src_len)
+{
+    const uint64_t seq = m_next_seq.fetch_add(1, std::memory_order_relaxed);
+    Record &record = m_records[seq % m_num_records];
+
+    // Claim the record. It can still be in use by a writer one lap ahead
+    // of us, and if a writer one lap behind us got it first our message is
+    // stale already.
+    uint64_t state = record.state.load(std::memory_order_relaxed);
+    while (true)
+    {
+        if (state > WritingState(seq))
+            return src_len;
+        if (state & 1)
+        {
+            std::this_thread::yield();
+            state = record.state.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (record.state.compare_exchange_weak(state, WritingState(seq), std::memory_order_acquire))
+            break;
+    }
+
+    size_t length = std::min(src_len, kRecordSize);
+    ::memcpy(record.text, src, length);
+    if (src_len > kRecordSize)
+    {
+        static const char g_truncated[] = "...\n";
+        ::memcpy(record.text + kRecordSize - (sizeof(g_truncated) - 1), g_truncated, sizeof(g_truncated) - 1);
+    }
+    record.length = length;
+    record.state.store(CompleteState(seq), std::memory_order_release);
+    return src_len;
+}
+
+void
+StreamLogBuffer::Drain ()
+{
+    std::lock_guard<std::mutex> guard(m_drain_mutex);
+
+    if (!m_stream_sp)
+        return;
+
+    const uint64_t end = m_next_seq.load(std::memory_order_acquire);
+    uint64_t seq = m_drained_seq;
+    uint64_t num_dropped = 0;
+    if (end - seq > m_num_records)
+    {
+        num_dropped += end - m_num_records - seq;
+        seq = end - m_num_records;
+    }
+
+    std::string text;
+    while (seq < end)
+    {
+        Record &record = m_records[seq % m_num_records];
+        const uint64_t state = record.state.load(std::memory_order_acquire);
+        if (state == CompleteState(seq))
+        {
+            text.assign(record.text, std::min<size_t>(record.length, kRecordSize));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // Make sure the record wasn't overwritten while we copied it.
+            if (record.state.load(std::memory_order_relaxed) == state)
+                m_stream_sp->Write(text.data(), text.size());
+            else
+                ++num_dropped;
+        }
+        else if (state < CompleteState(seq))
+        {
+            // The message is still being written. Wait for it, unless this
+            // is a flight recorder dump, which might be done from a crash
+            // in the middle of the write.
+            if (m_mode == eModeAsync)
+                break;
+        }
+        else
+        {
+            ++num_dropped;
+        }
+        ++seq;
+    }
+    m_drained_seq = seq;
+
+    if (num_dropped > 0)
+    {
+        m_num_dropped += num_dropped;
+        m_stream_sp->Printf("warning: %" PRIu64 " log messages were dropped\n", num_dropped);
+    }
+    m_stream_sp->Flush();
+}
+
+size_t
+StreamLogBuffer::DrainFlightRecorders ()
+{
+    // This can be called from a signal handler of a crash that happened
+    // while the lock was held.
+    std::unique_lock<std::mutex> lock(GetFlightRecordersMutex(), std::try_to_lock);
+    if (!lock.owns_lock())
+        return 0;
+
+    std::vector<StreamLogBuffer *> &flight_recorders = GetFlightRecorders();
+    for (StreamLogBuffer *flight_recorder : flight_recorders)
+        flight_recorder->Drain();
+    return flight_recorders.size();
+}
+
+void
+StreamLogBuffer::DrainThread ()
+{
+    std::unique_lock<std::mutex> lock(m_thread_mutex);
+    while (!m_stop_thread)
+    {
+        m_thread_cond.wait_for(lock, std::chrono::milliseconds(20));
+        lock.unlock();
+        Drain();
+        lock.lock();
+    }
+}
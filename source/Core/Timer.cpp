@@ -9,13 +9,15 @@
 #include "lldb/Core/Timer.h"
 
 #include <algorithm>
-#include <map>
 #include <mutex>
+#include <set>
 #include <vector>
 
 #include "lldb/Core/Stream.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Utility/JSON.h"
 
+#include <inttypes.h>
 #include <stdio.h>
 
 using namespace lldb_private;
@@ -24,16 +26,29 @@ using namespace lldb_private;
 
 namespace
 {
-    typedef std::map<const char*, uint64_t> TimerCategoryMap;
+    // Keep the trace of a long session from using up all the memory.
+    const size_t kMaxTraceEventsPerThread = 1024 * 1024;
+
+    struct TraceEvent
+    {
+        Timer::Category *m_category;
+        uint64_t m_start;       // nanoseconds since Jan 1, 1970
+        uint64_t m_duration;    // nanoseconds
+    };
 
     struct TimerStack
     {
         TimerStack() :
-            m_depth(0)
+            m_depth(0),
+            m_tid(Host::GetCurrentThreadID())
         {}
 
         uint32_t m_depth;
         std::vector<Timer*> m_stack;
+        lldb::tid_t m_tid;
+        // Only contended while the events are dumped or reset.
+        std::mutex m_events_mutex;
+        std::vector<TraceEvent> m_events;
     };
 } // end of anonymous namespace
 
@@ -52,24 +67,46 @@ GetFileMutex()
     return *g_file_mutex_ptr;
 }
 
+static std::atomic<Timer::Category *> &
+GetCategories()
+{
+    static std::atomic<Timer::Category *> g_categories(nullptr);
+    return g_categories;
+}
+
+// The timer stacks of all threads, including the ones of threads that
+// exited and still have trace events.
 static std::mutex &
-GetCategoryMutex()
+GetTimerStacksMutex()
 {
-    static std::mutex g_category_mutex;
-    return g_category_mutex;
+    static std::mutex g_timer_stacks_mutex;
+    return g_timer_stacks_mutex;
 }
 
-static TimerCategoryMap &
-GetCategoryMap()
+static std::set<TimerStack *> &
+GetTimerStacks()
 {
-    static TimerCategoryMap g_category_map;
-    return g_category_map;
+    static std::set<TimerStack *> g_timer_stacks;
+    return g_timer_stacks;
+}
+
+static std::vector<TimerStack *> &
+GetExitedTimerStacks()
+{
+    static std::vector<TimerStack *> g_exited_timer_stacks;
+    return g_exited_timer_stacks;
 }
 
 static void
 ThreadSpecificCleanup(void *p)
 {
-    delete static_cast<TimerStack *>(p);
+    TimerStack *stack = static_cast<TimerStack *>(p);
+    std::lock_guard<std::mutex> guard(GetTimerStacksMutex());
+    GetTimerStacks().erase(stack);
+    if (stack->m_events.empty())
+        delete stack;
+    else
+        GetExitedTimerStacks().push_back(stack);
 }
 
 static TimerStack *
@@ -80,29 +117,53 @@ GetTimerStackForCurrentThread ()
     void *timer_stack = Host::ThreadLocalStorageGet(g_key);
     if (timer_stack == NULL)
     {
-        Host::ThreadLocalStorageSet(g_key, new TimerStack);
+        TimerStack *new_stack = new TimerStack;
+        {
+            std::lock_guard<std::mutex> guard(GetTimerStacksMutex());
+            GetTimerStacks().insert(new_stack);
+        }
+        Host::ThreadLocalStorageSet(g_key, new_stack);
         timer_stack = Host::ThreadLocalStorageGet(g_key);
     }
     return (TimerStack *)timer_stack;
 }
 
+Timer::Category::Category (const char *category_name) :
+    m_name (category_name),
+    m_nanos (0),
+    m_count (0),
+    m_next (nullptr)
+{
+    std::atomic<Category *> &categories = GetCategories();
+    m_next = categories.load();
+    while (!categories.compare_exchange_weak(m_next, this))
+        ;
+}
+
 void
 Timer::SetQuiet (bool value)
 {
     g_quiet = value;
 }
 
-Timer::Timer (const char *category, const char *format, ...) :
+Timer::Timer (Category &category, const char *format, ...) :
     m_category (category),
     m_total_start (),
     m_timer_start (),
     m_total_ticks (0),
-    m_timer_ticks (0)
+    m_timer_ticks (0),
+    m_counted (false)
 {
+    // Timers are everywhere, so don't even look up the timer stack
+    // while they are disabled.
+    if (g_display_depth == 0)
+        return;
+
     TimerStack *stack = GetTimerStackForCurrentThread ();
     if (!stack)
         return;
 
+    m_counted = true;
     if (stack->m_depth++ < g_display_depth)
     {
         if (g_quiet == false)
@@ -132,6 +193,9 @@ Timer::Timer (const char *category, const char *format, ...) :
 
 Timer::~Timer()
 {
+    if (!m_counted)
+        return;
+
     TimerStack *stack = GetTimerStackForCurrentThread ();
     if (!stack)
         return;
@@ -139,6 +203,7 @@ Timer::~Timer()
     if (m_total_start.IsValid())
     {
         TimeValue stop_time = TimeValue::Now();
+        const uint64_t start_nsec = m_total_start.GetAsNanoSecondsSinceJan1_1970();
         if (m_total_start.IsValid())
         {
             m_total_ticks += (stop_time - m_total_start);
@@ -168,9 +233,15 @@ Timer::~Timer()
         }
 
         // Keep total results for each category so we can dump results.
-        std::lock_guard<std::mutex> guard(GetCategoryMutex());
-        TimerCategoryMap &category_map = GetCategoryMap();
-        category_map[m_category] += timer_nsec_uint;
+        m_category.m_nanos.fetch_add(timer_nsec_uint, std::memory_order_relaxed);
+        m_category.m_count.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> guard(stack->m_events_mutex);
+        if (stack->m_events.size() < kMaxTraceEventsPerThread)
+        {
+            TraceEvent event = { &m_category, start_nsec, total_nsec_uint };
+            stack->m_events.push_back(event);
+        }
     }
     if (stack->m_depth > 0)
         --stack->m_depth;
@@ -226,41 +297,91 @@ Timer::SetDisplayDepth (uint32_t depth)
 }
 
 
+typedef std::pair<const char *, uint64_t> CategoryTime;
+
 /* binary function predicate:
- * - returns whether a person is less than another person
+ * - returns whether a category took longer than another category
  */
 static bool
-CategoryMapIteratorSortCriterion (const TimerCategoryMap::const_iterator& lhs, const TimerCategoryMap::const_iterator& rhs)
+CategoryTimeSortCriterion (const CategoryTime& lhs, const CategoryTime& rhs)
 {
-    return lhs->second > rhs->second;
+    return lhs.second > rhs.second;
 }
 
 
 void
 Timer::ResetCategoryTimes ()
 {
-    std::lock_guard<std::mutex> guard(GetCategoryMutex());
-    TimerCategoryMap &category_map = GetCategoryMap();
-    category_map.clear();
+    for (Category *category = GetCategories().load(); category; category = category->m_next)
+    {
+        category->m_nanos = 0;
+        category->m_count = 0;
+    }
+
+    std::lock_guard<std::mutex> guard(GetTimerStacksMutex());
+    for (TimerStack *stack : GetTimerStacks())
+    {
+        std::lock_guard<std::mutex> events_guard(stack->m_events_mutex);
+        stack->m_events.clear();
+    }
+    std::vector<TimerStack *> &exited_stacks = GetExitedTimerStacks();
+    for (TimerStack *stack : exited_stacks)
+        delete stack;
+    exited_stacks.clear();
 }
 
 void
 Timer::DumpCategoryTimes (Stream *s)
 {
-    std::lock_guard<std::mutex> guard(GetCategoryMutex());
-    TimerCategoryMap &category_map = GetCategoryMap();
-    std::vector<TimerCategoryMap::const_iterator> sorted_iterators;
-    TimerCategoryMap::const_iterator pos, end = category_map.end();
-    for (pos = category_map.begin(); pos != end; ++pos)
+    std::vector<CategoryTime> sorted_times;
+    for (Category *category = GetCategories().load(); category; category = category->m_next)
     {
-        sorted_iterators.push_back (pos);
+        const uint64_t nanos = category->m_nanos;
+        if (nanos > 0)
+            sorted_times.push_back (CategoryTime(category->m_name, nanos));
     }
-    std::sort (sorted_iterators.begin(), sorted_iterators.end(), CategoryMapIteratorSortCriterion);
+    std::sort (sorted_times.begin(), sorted_times.end(), CategoryTimeSortCriterion);
 
-    const size_t count = sorted_iterators.size();
+    const size_t count = sorted_times.size();
     for (size_t i=0; i<count; ++i)
     {
-        const double timer_nsec = sorted_iterators[i]->second;
-        s->Printf("%.9f sec for %s\n", timer_nsec / 1000000000.0, sorted_iterators[i]->first);
+        const double timer_nsec = sorted_times[i].second;
+        s->Printf("%.9f sec for %s\n", timer_nsec / 1000000000.0, sorted_times[i].first);
+    }
+}
+
+static void
+DumpTraceEvents (Stream *s, const TimerStack &stack, lldb::pid_t pid, bool &first)
+{
+    for (const TraceEvent &event : stack.m_events)
+    {
+        s->PutCString(first ? "\n" : ",\n");
+        first = false;
+        s->PutCString("{\"name\":");
+        JSONString(event.m_category->GetName()).Write(*s);
+        s->Printf(",\"cat\":\"lldb\",\"ph\":\"X\",\"pid\":%" PRIu64 ",\"tid\":%" PRIu64 ",\"ts\":%" PRIu64 ".%03" PRIu64 ",\"dur\":%" PRIu64 ".%03" PRIu64 "}",
+                  (uint64_t)pid, (uint64_t)stack.m_tid,
+                  event.m_start / 1000, event.m_start % 1000,
+                  event.m_duration / 1000, event.m_duration % 1000);
+    }
+}
+
+void
+Timer::DumpChromeTrace (Stream *s)
+{
+    const lldb::pid_t pid = Host::GetCurrentProcessID();
+    bool first = true;
+
+    // Times are in microseconds. Every timer is a complete ("X") event,
+    // the viewer nests the events of a thread by their times.
+    s->PutCString("{\"traceEvents\":[");
+    std::lock_guard<std::mutex> guard(GetTimerStacksMutex());
+    for (TimerStack *stack : GetTimerStacks())
+    {
+        std::lock_guard<std::mutex> events_guard(stack->m_events_mutex);
+        DumpTraceEvents(s, *stack, pid, first);
     }
+    for (TimerStack *stack : GetExitedTimerStacks())
+        DumpTraceEvents(s, *stack, pid, first);
+    s->PutCString("\n],\"displayTimeUnit\":\"ns\"}\n");
 }
@@ -13,6 +13,8 @@
 #include <stdlib.h>
 
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 #include "llvm/Support/raw_ostream.h"
 
@@ -199,6 +201,9 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
     
     if (NeedsUpdating())
     {
+        if (!first_update && m_parent == nullptr)
+            PrefetchCachedValueMemory();
+
         m_update_point.SetUpdated();
         
         // Save the old value using swap to avoid a string copy which
@@ -239,9 +244,9 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
             
             SetValueIsValid (success);
             
+            const uint64_t max_checksum_size = 128;
             if (success)
             {
-                const uint64_t max_checksum_size = 128;
                 m_data.Checksum(m_value_checksum,
                                 max_checksum_size);
             }
@@ -264,6 +269,13 @@ ValueObject::UpdateValueIfNeeded (bool update_format)
             else if (need_compare_checksums)
             {
                 SetValueDidChange(memcmp(&old_checksum[0], &m_value_checksum[0], m_value_checksum.size()));
+
+                // The value string only depends on the bytes and the format,
+                // keep it if neither changed. The checksum covers the whole
+                // value only up to max_checksum_size bytes.
+                if (!m_value_did_change && !did_change_formats && m_old_value_valid &&
+                    m_data.GetByteSize() <= max_checksum_size)
+                    m_value_str = m_old_value_str;
             }
             
         }
@@ -587,6 +599,7 @@ ValueObject::GetChildAtIndex (size_t idx, bool can_create)
         {
             // No we haven't created the child at this index, so lets have our
             // subclass do it and cache the result for quick future access.
+            PrefetchChildMemory (idx);
             m_children.SetChildAtIndex(idx,CreateChildAtIndex (idx, false, 0));
         }
         
@@ -597,6 +610,25 @@ ValueObject::GetChildAtIndex (size_t idx, bool can_create)
     return child_sp;
 }
 
+size_t
+ValueObject::GetChildrenInRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+{
+    const size_t num_children = GetNumChildren();
+    if (start_idx >= num_children)
+        return 0;
+    const size_t end_idx = start_idx + std::min(count, num_children - start_idx);
+    size_t num_appended = 0;
+    for (size_t idx = start_idx; idx < end_idx; ++idx)
+    {
+        ValueObjectSP child_sp = GetChildAtIndex(idx, true);
+        if (!child_sp)
+            break;
+        children.push_back(child_sp);
+        ++num_appended;
+    }
+    return num_appended;
+}
+
 ValueObjectSP
 ValueObject::GetChildAtIndexPath (const std::initializer_list<size_t>& idxs,
                                   size_t* index_of_error)
@@ -813,6 +845,86 @@ ValueObject::SetName (const ConstString &name)
     m_name = name;
 }
 
+void
+ValueObject::PrefetchCachedValueMemory ()
+{
+    ProcessSP process_sp (GetProcessSP());
+    if (!process_sp)
+        return;
+
+    // Collect where the values of the hierarchy were read from the last
+    // time they were updated, their m_value still says so.
+    typedef std::pair<addr_t, addr_t> AddrRange; // base, size
+    static const size_t g_max_ranges = 4096;
+    std::vector<AddrRange> ranges;
+    std::vector<ValueObject *> pending (1, this);
+    while (!pending.empty() && ranges.size() < g_max_ranges)
+    {
+        ValueObject *valobj = pending.back();
+        pending.pop_back();
+        if (valobj->m_value.GetValueType() == Value::eValueTypeLoadAddress && valobj->m_data.GetByteSize() > 0)
+        {
+            const addr_t addr = valobj->m_value.GetScalar().ULongLong(LLDB_INVALID_ADDRESS);
+            if (addr != LLDB_INVALID_ADDRESS)
+                ranges.push_back(AddrRange(addr, valobj->m_data.GetByteSize()));
+        }
+        valobj->m_children.GetChildren(pending);
+    }
+    if (ranges.size() < 2)
+        return; // The value reads itself with one read anyway.
+
+    // Values closer than this are read together, reading the gap costs
+    // less than another round trip to the process.
+    static const addr_t g_max_gap = 256;
+    std::sort(ranges.begin(), ranges.end());
+    addr_t base = ranges[0].first;
+    addr_t end = base + ranges[0].second;
+    for (size_t i = 1; i < ranges.size(); ++i)
+    {
+        if (ranges[i].first > end + g_max_gap)
+        {
+            process_sp->PrefetchMemory (base, end - base);
+            base = ranges[i].first;
+        }
+        end = std::max<addr_t>(end, ranges[i].first + ranges[i].second);
+    }
+    process_sp->PrefetchMemory (base, end - base);
+}
+
+void
+ValueObject::PrefetchChildMemory (size_t idx)
+{
+    ProcessSP process_sp (GetProcessSP());
+    if (!process_sp)
+        return;
+
+    CompilerType compiler_type (GetCompilerType());
+    AddressType address_type = eAddressTypeInvalid;
+    if (compiler_type.IsArrayType (nullptr, nullptr, nullptr))
+    {
+        // The elements are read one by one, read the ones after this one
+        // with it.
+        uint64_t stride = 0;
+        compiler_type.GetArrayElementType (&stride);
+        const addr_t addr = GetAddressOf (true, &address_type);
+        if (stride == 0 || addr == LLDB_INVALID_ADDRESS || address_type != eAddressTypeLoad)
+            return;
+        process_sp->PrefetchMemory (addr + idx * stride, (GetNumChildren() - idx) * stride);
+    }
+    else if (idx == 0 && compiler_type.IsPointerType ())
+    {
+        // The children of a pointer are the members of what it points to,
+        // like the "next" of a list node, read the whole object at once.
+        const addr_t addr = GetPointerValue (&address_type);
+        if (addr == 0 || addr == LLDB_INVALID_ADDRESS || address_type != eAddressTypeLoad)
+            return;
+        ExecutionContext exe_ctx (GetExecutionContextRef());
+        const uint64_t pointee_size = compiler_type.GetPointeeType().GetByteSize (exe_ctx.GetBestExecutionContextScope());
+        if (pointee_size > 0)
+            process_sp->PrefetchMemory (addr, pointee_size);
+    }
+}
+
 ValueObject *
 ValueObject::CreateChildAtIndex (size_t idx, bool synthetic_array_member, int32_t synthetic_index)
 {
@@ -236,6 +236,57 @@ ValueObjectSynthetic::GetChildAtIndex (size_t idx, bool can_create)
         return valobj->GetSP();
 }
 
+size_t
+ValueObjectSynthetic::GetChildrenInRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+{
+    UpdateValueIfNeeded();
+
+    if (m_synth_filter_ap.get() == nullptr || count == 0)
+        return 0;
+
+    // Only ask the front end for the part of the window that isn't cached
+    // yet, in one call so it can read the memory in one go.
+    const size_t end_idx = start_idx + count;
+    size_t first_missing = end_idx;
+    size_t last_missing = start_idx;
+    ValueObject *valobj;
+    for (size_t idx = start_idx; idx < end_idx; ++idx)
+    {
+        if (m_children_byindex.GetValueForKey(idx, valobj) == false)
+        {
+            if (first_missing == end_idx)
+                first_missing = idx;
+            last_missing = idx;
+        }
+    }
+
+    std::vector<lldb::ValueObjectSP> fetched;
+    if (first_missing != end_idx)
+        m_synth_filter_ap->GetChildrenInRange (first_missing, last_missing - first_missing + 1, fetched);
+
+    size_t num_appended = 0;
+    for (size_t idx = start_idx; idx < end_idx; ++idx)
+    {
+        lldb::ValueObjectSP child_sp;
+        if (m_children_byindex.GetValueForKey(idx, valobj))
+            child_sp = valobj->GetSP();
+        else if (idx >= first_missing && idx - first_missing < fetched.size())
+        {
+            child_sp = fetched[idx - first_missing];
+            if (child_sp)
+            {
+                m_children_byindex.SetValueForKey(idx, child_sp.get());
+                child_sp->SetPreferredDisplayLanguageIfNeeded(GetPreferredDisplayLanguage());
+            }
+        }
+        if (!child_sp)
+            break;
+        children.push_back(child_sp);
+        ++num_appended;
+    }
+    return num_appended;
+}
+
 lldb::ValueObjectSP
 ValueObjectSynthetic::GetChildMemberWithName (const ConstString &name, bool can_create)
 {
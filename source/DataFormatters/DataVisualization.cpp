@@ -36,6 +36,12 @@ DataVisualization::GetCurrentRevision ()
     return GetFormatManager().GetCurrentRevision();
 }
 
+FormatCache::Statistics
+DataVisualization::GetCacheStatistics ()
+{
+    return GetFormatManager().GetCacheStatistics();
+}
+
 bool
 DataVisualization::ShouldPrintAsOneLiner (ValueObject& valobj)
 {
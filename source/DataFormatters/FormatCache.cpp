@@ -83,49 +83,49 @@ FormatCache::Entry::Entry (lldb::TypeFormatImplSP format_sp, lldb::TypeSummaryIm
 }
 
 bool
-FormatCache::Entry::IsFormatCached ()
+FormatCache::Entry::IsFormatCached () const
 {
     return m_format_cached;
 }
 
 bool
-FormatCache::Entry::IsSummaryCached ()
+FormatCache::Entry::IsSummaryCached () const
 {
     return m_summary_cached;
 }
 
 bool
-FormatCache::Entry::IsSyntheticCached ()
+FormatCache::Entry::IsSyntheticCached () const
 {
     return m_synthetic_cached;
 }
 
 bool
-FormatCache::Entry::IsValidatorCached ()
+FormatCache::Entry::IsValidatorCached () const
 {
     return m_validator_cached;
 }
 
 lldb::TypeFormatImplSP
-FormatCache::Entry::GetFormat ()
+FormatCache::Entry::GetFormat () const
 {
     return m_format_sp;
 }
 
 lldb::TypeSummaryImplSP
-FormatCache::Entry::GetSummary ()
+FormatCache::Entry::GetSummary () const
 {
     return m_summary_sp;
 }
 
 lldb::SyntheticChildrenSP
-FormatCache::Entry::GetSynthetic ()
+FormatCache::Entry::GetSynthetic () const
 {
     return m_synthetic_sp;
 }
 
 lldb::TypeValidatorImplSP
-FormatCache::Entry::GetValidator ()
+FormatCache::Entry::GetValidator () const
 {
     return m_validator_sp;
 }
@@ -158,44 +158,58 @@ FormatCache::Entry::SetValidator (lldb::TypeValidatorImplSP validator_sp)
     m_validator_sp = validator_sp;
 }
 
-FormatCache::FormatCache()
-    : m_map(),
-      m_mutex()
-#ifdef LLDB_CONFIGURATION_DEBUG
-      ,
-      m_cache_hits(0),
-      m_cache_misses(0)
-#endif
+FormatCache::Shard::Shard () :
+    m_mutex(),
+    m_map(),
+    m_generation(0),
+    m_cache_hits(0),
+    m_cache_misses(0)
 {
 }
 
+FormatCache::FormatCache() :
+    m_generation(0)
+{
+}
+
+FormatCache::Shard &
+FormatCache::GetShard (const ConstString& type)
+{
+    // ConstStrings are unique, hash the pointer rather than the name.
+    const uintptr_t key = reinterpret_cast<uintptr_t>(type.GetCString());
+    return m_shards[(key ^ (key >> 7)) % kNumShards];
+}
+
 FormatCache::Entry&
-FormatCache::GetEntry (const ConstString& type)
+FormatCache::GetEntry (Shard &shard, const ConstString& type)
 {
-    auto i = m_map.find(type),
-    e = m_map.end();
-    if (i != e)
-        return i->second;
-    m_map[type] = FormatCache::Entry();
-    return m_map[type];
+    const uint32_t generation = m_generation;
+    if (shard.m_generation != generation)
+    {
+        shard.m_map.clear();
+        shard.m_generation = generation;
+    }
+    return shard.m_map[type.GetCString()];
 }
 
 bool
 FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsFormatCached())
+    Shard &shard = GetShard(type);
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        format_sp = entry.GetFormat();
-        return true;
+        llvm::sys::SmartScopedReader<false> guard(shard.m_mutex);
+        if (shard.m_generation == m_generation)
+        {
+            auto pos = shard.m_map.find(type.GetCString());
+            if (pos != shard.m_map.end() && pos->second.IsFormatCached())
+            {
+                ++shard.m_cache_hits;
+                format_sp = pos->second.GetFormat();
+                return true;
+            }
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    ++shard.m_cache_misses;
     format_sp.reset();
     return false;
 }
@@ -203,19 +217,21 @@ FormatCache::GetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_s
 bool
 FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSummaryCached())
+    Shard &shard = GetShard(type);
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        summary_sp = entry.GetSummary();
-        return true;
+        llvm::sys::SmartScopedReader<false> guard(shard.m_mutex);
+        if (shard.m_generation == m_generation)
+        {
+            auto pos = shard.m_map.find(type.GetCString());
+            if (pos != shard.m_map.end() && pos->second.IsSummaryCached())
+            {
+                ++shard.m_cache_hits;
+                summary_sp = pos->second.GetSummary();
+                return true;
+            }
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    ++shard.m_cache_misses;
     summary_sp.reset();
     return false;
 }
@@ -223,19 +239,21 @@ FormatCache::GetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summar
 bool
 FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsSyntheticCached())
+    Shard &shard = GetShard(type);
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        synthetic_sp = entry.GetSynthetic();
-        return true;
+        llvm::sys::SmartScopedReader<false> guard(shard.m_mutex);
+        if (shard.m_generation == m_generation)
+        {
+            auto pos = shard.m_map.find(type.GetCString());
+            if (pos != shard.m_map.end() && pos->second.IsSyntheticCached())
+            {
+                ++shard.m_cache_hits;
+                synthetic_sp = pos->second.GetSynthetic();
+                return true;
+            }
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    ++shard.m_cache_misses;
     synthetic_sp.reset();
     return false;
 }
@@ -243,19 +261,21 @@ FormatCache::GetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& sy
 bool
 FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    auto entry = GetEntry(type);
-    if (entry.IsValidatorCached())
+    Shard &shard = GetShard(type);
     {
-#ifdef LLDB_CONFIGURATION_DEBUG
-        m_cache_hits++;
-#endif
-        validator_sp = entry.GetValidator();
-        return true;
+        llvm::sys::SmartScopedReader<false> guard(shard.m_mutex);
+        if (shard.m_generation == m_generation)
+        {
+            auto pos = shard.m_map.find(type.GetCString());
+            if (pos != shard.m_map.end() && pos->second.IsValidatorCached())
+            {
+                ++shard.m_cache_hits;
+                validator_sp = pos->second.GetValidator();
+                return true;
+            }
+        }
     }
-#ifdef LLDB_CONFIGURATION_DEBUG
-    m_cache_misses++;
-#endif
+    ++shard.m_cache_misses;
     validator_sp.reset();
     return false;
 }
@@ -263,35 +283,86 @@ FormatCache::GetValidator (const ConstString& type,lldb::TypeValidatorImplSP& va
 void
 FormatCache::SetFormat (const ConstString& type,lldb::TypeFormatImplSP& format_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    GetEntry(type).SetFormat(format_sp);
+    Shard &shard = GetShard(type);
+    llvm::sys::SmartScopedWriter<false> guard(shard.m_mutex);
+    GetEntry(shard, type).SetFormat(format_sp);
 }
 
 void
 FormatCache::SetSummary (const ConstString& type,lldb::TypeSummaryImplSP& summary_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    GetEntry(type).SetSummary(summary_sp);
+    Shard &shard = GetShard(type);
+    llvm::sys::SmartScopedWriter<false> guard(shard.m_mutex);
+    GetEntry(shard, type).SetSummary(summary_sp);
 }
 
 void
 FormatCache::SetSynthetic (const ConstString& type,lldb::SyntheticChildrenSP& synthetic_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    GetEntry(type).SetSynthetic(synthetic_sp);
+    Shard &shard = GetShard(type);
+    llvm::sys::SmartScopedWriter<false> guard(shard.m_mutex);
+    GetEntry(shard, type).SetSynthetic(synthetic_sp);
 }
 
 void
 FormatCache::SetValidator (const ConstString& type,lldb::TypeValidatorImplSP& validator_sp)
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    GetEntry(type).SetValidator(validator_sp);
+    Shard &shard = GetShard(type);
+    llvm::sys::SmartScopedWriter<false> guard(shard.m_mutex);
+    GetEntry(shard, type).SetValidator(validator_sp);
 }
 
 void
 FormatCache::Clear ()
 {
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    m_map.clear();
+    ++m_generation;
+}
+
+uint64_t
+FormatCache::GetCacheHits ()
+{
+    uint64_t hits = 0;
+    for (Shard &shard : m_shards)
+        hits += shard.m_cache_hits;
+    return hits;
+}
+
+uint64_t
+FormatCache::GetCacheMisses ()
+{
+    uint64_t misses = 0;
+    for (Shard &shard : m_shards)
+        misses += shard.m_cache_misses;
+    return misses;
 }
 
+FormatCache::Statistics
+FormatCache::GetStatistics ()
+{
+    Statistics stats;
+    stats.cache_hits = GetCacheHits();
+    stats.cache_misses = GetCacheMisses();
+    stats.num_types = 0;
+    stats.num_negative_entries = 0;
+    stats.generation = m_generation;
+    for (Shard &shard : m_shards)
+    {
+        llvm::sys::SmartScopedReader<false> guard(shard.m_mutex);
+        if (shard.m_generation != stats.generation)
+            continue;
+        stats.num_types += shard.m_map.size();
+        for (const auto &pos : shard.m_map)
+        {
+            const Entry &entry = pos.second;
+            if (entry.IsFormatCached() && !entry.GetFormat())
+                ++stats.num_negative_entries;
+            if (entry.IsSummaryCached() && !entry.GetSummary())
+                ++stats.num_negative_entries;
+            if (entry.IsSyntheticCached() && !entry.GetSynthetic())
+                ++stats.num_negative_entries;
+            if (entry.IsValidatorCached() && !entry.GetValidator())
+                ++stats.num_negative_entries;
+        }
+    }
+    return stats;
+}
@@ -19,8 +19,15 @@
 #include "llvm/Support/ConvertUTF.h"
 
 #include <ctype.h>
+#include <string.h>
 #include <locale>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::formatters;
@@ -260,6 +267,219 @@ StringPrinter::GetDefaultEscapingHelper (GetPrintableElementType elem_type)
     llvm_unreachable("bad element type");
 }
 
+// Blocks of 16 characters are checked and converted at once. A block that
+// doesn't qualify is redone one character at a time.
+#if defined(__SSE2__)
+
+// Printable ASCII other than '"' and '\\', which all the escaping prints as
+// it is.
+static inline bool
+IsPlainASCIIBlock (const uint8_t *src)
+{
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    // Signed compares, the bytes with the high bit set are below ' '.
+    const __m128i printable = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(0x1f)),
+                                            _mm_cmplt_epi8(chars, _mm_set1_epi8(0x7f)));
+    const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')),
+                                         _mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')));
+    return _mm_movemask_epi8(_mm_andnot_si128(special, printable)) == 0xffff;
+}
+
+static inline bool
+NarrowASCIIBlock (const UTF16 *src, UTF8 *dst)
+{
+    const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8));
+    const __m128i non_ascii = _mm_and_si128(_mm_or_si128(lo, hi), _mm_set1_epi16(static_cast<short>(0xff80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, _mm_setzero_si128())) != 0xffff)
+        return false;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(lo, hi));
+    return true;
+}
+
+static inline bool
+NarrowASCIIBlock (const UTF32 *src, UTF8 *dst)
+{
+    const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 4));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 8));
+    const __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 12));
+    const __m128i non_ascii = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)),
+                                            _mm_set1_epi32(static_cast<int>(0xffffff80)));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(non_ascii, _mm_setzero_si128())) != 0xffff)
+        return false;
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    return true;
+}
+
+#define STRING_PRINTER_HAS_BLOCKS 1
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+static inline bool
+IsPlainASCIIBlock (const uint8_t *src)
+{
+    const uint8x16_t chars = vld1q_u8(src);
+    const uint8x16_t printable = vandq_u8(vcgeq_u8(chars, vdupq_n_u8(0x20)), vcltq_u8(chars, vdupq_n_u8(0x7f)));
+    const uint8x16_t special = vorrq_u8(vceqq_u8(chars, vdupq_n_u8('"')), vceqq_u8(chars, vdupq_n_u8('\\')));
+    return vminvq_u8(vbicq_u8(printable, special)) != 0;
+}
+
+static inline bool
+NarrowASCIIBlock (const UTF16 *src, UTF8 *dst)
+{
+    const uint16x8_t lo = vld1q_u16(src);
+    const uint16x8_t hi = vld1q_u16(src + 8);
+    if (vmaxvq_u16(vorrq_u16(lo, hi)) >= 0x80)
+        return false;
+    vst1q_u8(dst, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    return true;
+}
+
+static inline bool
+NarrowASCIIBlock (const UTF32 *src, UTF8 *dst)
+{
+    const uint32x4_t a = vld1q_u32(src);
+    const uint32x4_t b = vld1q_u32(src + 4);
+    const uint32x4_t c = vld1q_u32(src + 8);
+    const uint32x4_t d = vld1q_u32(src + 12);
+    if (vmaxvq_u32(vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d))) >= 0x80)
+        return false;
+    const uint16x8_t lo = vcombine_u16(vmovn_u32(a), vmovn_u32(b));
+    const uint16x8_t hi = vcombine_u16(vmovn_u32(c), vmovn_u32(d));
+    vst1q_u8(dst, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+    return true;
+}
+
+#define STRING_PRINTER_HAS_BLOCKS 1
+
+#endif
+
+#if defined(STRING_PRINTER_HAS_BLOCKS)
+// UTF-8 is printed as it is and never converted.
+static inline bool
+NarrowASCIIBlock (const UTF8 *src, UTF8 *dst)
+{
+    return false;
+}
+#endif
+
+// Returns how many characters from data on are printable ASCII that isn't
+// '"' or '\\'. Every escaping helper prints those as they are, so they are
+// written out without asking it.
+static size_t
+GetPlainASCIILength (const uint8_t *data, const uint8_t *data_end)
+{
+    const uint8_t *pos = data;
+#if defined(STRING_PRINTER_HAS_BLOCKS)
+    while (data_end - pos >= 16 && IsPlainASCIIBlock(pos))
+        pos += 16;
+#endif
+    while (pos < data_end && *pos >= 0x20 && *pos < 0x7f && *pos != '"' && *pos != '\\')
+        ++pos;
+    return pos - data;
+}
+
+// Converts the code units from src up to src_end to UTF-8 at dst. Runs of
+// ASCII are copied directly, ConvertFunction converts the rest. src is set
+// to where the conversion stopped, the end of the UTF-8 is returned.
+template<typename SourceDataType>
+static UTF8 *
+ConvertBufferToUTF8 (ConversionResult (*ConvertFunction) (const SourceDataType**,
+                                                          const SourceDataType*,
+                                                          UTF8**,
+                                                          UTF8*,
+                                                          ConversionFlags),
+                     const SourceDataType *&src,
+                     const SourceDataType *src_end,
+                     UTF8 *dst,
+                     UTF8 *dst_end)
+{
+    while (src < src_end)
+    {
+#if defined(STRING_PRINTER_HAS_BLOCKS)
+        while (src_end - src >= 16 && dst_end - dst >= 16 && NarrowASCIIBlock(src, dst))
+        {
+            src += 16;
+            dst += 16;
+        }
+#endif
+        while (src < src_end && dst < dst_end && *src < 0x80)
+            *dst++ = static_cast<UTF8>(*src++);
+        if (src == src_end || dst == dst_end)
+            break;
+
+        const SourceDataType *run_end = src;
+        while (run_end < src_end && *run_end >= 0x80)
+            ++run_end;
+        // A high surrogate is converted with the unit after it, even when
+        // that one is ASCII and doesn't pair with it.
+        if (sizeof(SourceDataType) == 2 && run_end < src_end && (run_end[-1] & 0xfc00) == 0xd800)
+            ++run_end;
+
+        ConvertFunction(&src, run_end, &dst, dst_end, lenientConversion);
+        if (src != run_end)
+            break;
+    }
+    return dst;
+}
+
+// Writes the characters from data up to data_end to the stream, escaped by
+// escaping_callback if it is set. Returns where it stopped, at the first NULL
+// if zero_is_terminator.
+static uint8_t *
+DumpCharactersToStream (Stream &stream,
+                        uint8_t *data,
+                        uint8_t *data_end,
+                        bool zero_is_terminator,
+                        const StringPrinter::EscapingHelper &escaping_callback)
+{
+    if (!escaping_callback)
+    {
+        uint8_t *end = data_end;
+        if (zero_is_terminator)
+        {
+            if (uint8_t *zero = static_cast<uint8_t *>(::memchr(data, 0, data_end - data)))
+                end = zero;
+        }
+        stream.Write(data, end - data);
+        return end;
+    }
+
+    // since we tend to accept partial data (and even partially malformed data)
+    // we might end up with no NULL terminator before the end_ptr
+    // hence we need to take a slower route and ensure we stay within boundaries
+    while (data < data_end)
+    {
+        if (zero_is_terminator && !*data)
+            break;
+
+        const size_t plain_length = GetPlainASCIILength(data, data_end);
+        if (plain_length > 0)
+        {
+            stream.Write(data, plain_length);
+            data += plain_length;
+            continue;
+        }
+
+        uint8_t* next_data = nullptr;
+        auto printable = escaping_callback(data, data_end, next_data);
+        auto printable_bytes = printable.GetBytes();
+        auto printable_size = printable.GetSize();
+        if (!printable_bytes || !next_data)
+        {
+            // GetPrintable() failed on us - print one byte in a desperate resync attempt
+            printable_bytes = data;
+            printable_size = 1;
+            next_data = data+1;
+        }
+        stream.Write(printable_bytes, printable_size);
+        data = (uint8_t*)next_data;
+    }
+    return data;
+}
+
 // use this call if you already have an LLDB-side buffer for the data
 template<typename SourceDataType>
 static bool
@@ -312,13 +532,11 @@ DumpUTFBufferToStream (ConversionResult (*ConvertFunction) (const SourceDataType
         
         if (ConvertFunction)
         {
-            utf8_data_buffer_sp.reset(new DataBufferHeap(4*bufferSPSize,0));
+            // A UTF-16 code unit takes at most 3 bytes of UTF-8, a UTF-32 one 4.
+            const size_t max_utf8_size = (data_end_ptr - data_ptr) * (sizeof(SourceDataType) == 2 ? 3 : 4);
+            utf8_data_buffer_sp.reset(new DataBufferHeap(max_utf8_size,0));
             utf8_data_ptr = (UTF8*)utf8_data_buffer_sp->GetBytes();
-            utf8_data_end_ptr = utf8_data_ptr + utf8_data_buffer_sp->GetByteSize();
-            ConvertFunction ( &data_ptr, data_end_ptr, &utf8_data_ptr, utf8_data_end_ptr, lenientConversion );
-            if (false == zero_is_terminator)
-                utf8_data_end_ptr = utf8_data_ptr;
-            utf8_data_ptr = (UTF8*)utf8_data_buffer_sp->GetBytes(); // needed because the ConvertFunction will change the value of the data_ptr
+            utf8_data_end_ptr = ConvertBufferToUTF8 (ConvertFunction, data_ptr, data_end_ptr, utf8_data_ptr, utf8_data_ptr + max_utf8_size);
         }
         else
         {
@@ -338,37 +556,7 @@ DumpUTFBufferToStream (ConversionResult (*ConvertFunction) (const SourceDataType
                 escaping_callback = lldb_private::formatters::StringPrinter::GetDefaultEscapingHelper(lldb_private::formatters::StringPrinter::GetPrintableElementType::UTF8);
         }
         
-        // since we tend to accept partial data (and even partially malformed data)
-        // we might end up with no NULL terminator before the end_ptr
-        // hence we need to take a slower route and ensure we stay within boundaries
-        for (;utf8_data_ptr < utf8_data_end_ptr;)
-        {
-            if (zero_is_terminator && !*utf8_data_ptr)
-                break;
-            
-            if (escape_non_printables)
-            {
-                uint8_t* next_data = nullptr;
-                auto printable = escaping_callback(utf8_data_ptr, utf8_data_end_ptr, next_data);
-                auto printable_bytes = printable.GetBytes();
-                auto printable_size = printable.GetSize();
-                if (!printable_bytes || !next_data)
-                {
-                    // GetPrintable() failed on us - print one byte in a desperate resync attempt
-                    printable_bytes = utf8_data_ptr;
-                    printable_size = 1;
-                    next_data = utf8_data_ptr+1;
-                }
-                for (unsigned c = 0; c < printable_size; c++)
-                    stream.Printf("%c", *(printable_bytes+c));
-                utf8_data_ptr = (uint8_t*)next_data;
-            }
-            else
-            {
-                stream.Printf("%c",*utf8_data_ptr);
-                utf8_data_ptr++;
-            }
-        }
+        DumpCharactersToStream (stream, utf8_data_ptr, utf8_data_end_ptr, zero_is_terminator, escaping_callback);
     }
     if (dump_options.GetQuote() != 0)
         stream.Printf("%c",dump_options.GetQuote());
@@ -467,34 +655,7 @@ StringPrinter::ReadStringAndDumpToStream<StringPrinter::StringElementType::ASCII
             escaping_callback = lldb_private::formatters::StringPrinter::GetDefaultEscapingHelper(lldb_private::formatters::StringPrinter::GetPrintableElementType::ASCII);
     }
     
-    // since we tend to accept partial data (and even partially malformed data)
-    // we might end up with no NULL terminator before the end_ptr
-    // hence we need to take a slower route and ensure we stay within boundaries
-    for (uint8_t* data = buffer_sp->GetBytes(); *data && (data < data_end);)
-    {
-        if (escape_non_printables)
-        {
-            uint8_t* next_data = nullptr;
-            auto printable = escaping_callback(data, data_end, next_data);
-            auto printable_bytes = printable.GetBytes();
-            auto printable_size = printable.GetSize();
-            if (!printable_bytes || !next_data)
-            {
-                // GetPrintable() failed on us - print one byte in a desperate resync attempt
-                printable_bytes = data;
-                printable_size = 1;
-                next_data = data+1;
-            }
-            for (unsigned c = 0; c < printable_size; c++)
-                options.GetStream()->Printf("%c", *(printable_bytes+c));
-            data = (uint8_t*)next_data;
-        }
-        else
-        {
-            options.GetStream()->Printf("%c",*data);
-            data++;
-        }
-    }
+    DumpCharactersToStream (*options.GetStream(), buffer_sp->GetBytes(), data_end, true, escaping_callback);
     
     const char* suffix_token = options.GetSuffixToken();
     
@@ -119,6 +119,25 @@ CXXSyntheticChildren::GetDescription()
     return sstr.GetString();
 }
 
+size_t
+SyntheticChildrenFrontEnd::GetChildrenInRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+{
+    const size_t num_children = CalculateNumChildren();
+    if (start_idx >= num_children)
+        return 0;
+    const size_t end_idx = start_idx + std::min(count, num_children - start_idx);
+    size_t num_appended = 0;
+    for (size_t idx = start_idx; idx < end_idx; ++idx)
+    {
+        lldb::ValueObjectSP child_sp = GetChildAtIndex(idx);
+        if (!child_sp)
+            break;
+        children.push_back(child_sp);
+        ++num_appended;
+    }
+    return num_appended;
+}
+
 lldb::ValueObjectSP
 SyntheticChildrenFrontEnd::CreateValueObjectFromExpression (const char* name,
                                                             const char* expression,
@@ -160,7 +179,10 @@ ScriptedSyntheticChildren::FrontEnd::FrontEnd(std::string pclass, ValueObject &b
 SyntheticChildrenFrontEnd(backend),
 m_python_class(pclass),
 m_wrapper_sp(),
-m_interpreter(NULL)
+m_interpreter(NULL),
+m_batch_children(),
+m_batch_start(0),
+m_supports_batch(eLazyBoolCalculate)
 {
     if (backend == LLDB_INVALID_UID)
         return;
@@ -185,7 +207,27 @@ ScriptedSyntheticChildren::FrontEnd::GetChildAtIndex (size_t idx)
 {
     if (!m_wrapper_sp || !m_interpreter)
         return lldb::ValueObjectSP();
-    
+
+    // Fetching the children in batches saves a round trip into the script
+    // interpreter for each of them.
+    if (m_supports_batch != eLazyBoolNo)
+    {
+        if (idx >= m_batch_start && idx - m_batch_start < m_batch_children.size())
+            return m_batch_children[idx - m_batch_start];
+
+        static const uint32_t g_child_batch_size = 256;
+        if (idx < UINT32_MAX && m_interpreter->GetChildrenAtIndex(m_wrapper_sp, idx, g_child_batch_size, m_batch_children))
+        {
+            m_supports_batch = eLazyBoolYes;
+            m_batch_start = idx;
+            if (m_batch_children.empty())
+                return lldb::ValueObjectSP();
+            return m_batch_children.front();
+        }
+        if (m_supports_batch == eLazyBoolCalculate)
+            m_supports_batch = eLazyBoolNo;
+    }
+
     return m_interpreter->GetChildAtIndex(m_wrapper_sp, idx);
 }
 
@@ -216,7 +258,9 @@ ScriptedSyntheticChildren::FrontEnd::Update ()
 {
     if (!m_wrapper_sp || m_interpreter == NULL)
         return false;
-    
+
+    m_batch_children.clear();
+    m_batch_start = 0;
     return m_interpreter->UpdateSynthProviderInstance(m_wrapper_sp);
 }
 
@@ -783,10 +783,17 @@ ValueObjectPrinter::PrintChildren (bool value_printed,
     if (num_children)
     {
         bool any_children_printed = false;
+
+        // Ask for the children as one range, so synthetic providers for
+        // contiguous containers can read them all in one go.
+        std::vector<ValueObjectSP> prefetched_children;
+        if (m_options.m_element_count == 0)
+            synth_m_valobj->GetChildrenInRange(0, num_children, prefetched_children);
         
         for (size_t idx=0; idx<num_children; ++idx)
         {
-            if (ValueObjectSP child_sp = GenerateChild(synth_m_valobj, idx))
+            ValueObjectSP child_sp = idx < prefetched_children.size() ? prefetched_children[idx] : GenerateChild(synth_m_valobj, idx);
+            if (child_sp)
             {
                 if (!any_children_printed)
                 {
@@ -13,6 +13,7 @@
 #include <inttypes.h>
 
 // C++ Includes
+#include <algorithm>
 #include <vector>
 
 #include "lldb/Core/DataEncoder.h"
@@ -60,7 +61,8 @@ DWARFExpression::DWARFExpression(DWARFCompileUnit* dwarf_cu) :
     m_data(),
     m_dwarf_cu(dwarf_cu),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide (LLDB_INVALID_ADDRESS)
+    m_loclist_slide (LLDB_INVALID_ADDRESS),
+    m_loclist_index_sp()
 {
 }
 
@@ -69,7 +71,8 @@ DWARFExpression::DWARFExpression(const DWARFExpression& rhs) :
     m_data(rhs.m_data),
     m_dwarf_cu(rhs.m_dwarf_cu),
     m_reg_kind (rhs.m_reg_kind),
-    m_loclist_slide(rhs.m_loclist_slide)
+    m_loclist_slide(rhs.m_loclist_slide),
+    m_loclist_index_sp(std::atomic_load(&rhs.m_loclist_index_sp))
 {
 }
 
@@ -83,7 +86,8 @@ DWARFExpression::DWARFExpression(lldb::ModuleSP module_sp,
     m_data(data, data_offset, data_length),
     m_dwarf_cu(dwarf_cu),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide(LLDB_INVALID_ADDRESS)
+    m_loclist_slide(LLDB_INVALID_ADDRESS),
+    m_loclist_index_sp()
 {
     if (module_sp)
         m_module_wp = module_sp;
@@ -107,6 +111,7 @@ void
 DWARFExpression::SetOpcodeData (const DataExtractor& data)
 {
     m_data = data;
+    m_loclist_index_sp.reset();
 }
 
 void
@@ -116,6 +121,7 @@ DWARFExpression::CopyOpcodeData (lldb::ModuleSP module_sp, const DataExtractor&
     if (bytes)
     {
         m_module_wp = module_sp;
+        m_loclist_index_sp.reset();
         m_data.SetData(DataBufferSP(new DataBufferHeap(bytes, data_length)));
         m_data.SetByteOrder(data.GetByteOrder());
         m_data.SetAddressByteSize(data.GetAddressByteSize());
@@ -130,6 +136,7 @@ DWARFExpression::CopyOpcodeData (const void *data,
 {
     if (data && data_length)
     {
+        m_loclist_index_sp.reset();
         m_data.SetData(DataBufferSP(new DataBufferHeap(data, data_length)));
         m_data.SetByteOrder(byte_order);
         m_data.SetAddressByteSize(addr_byte_size);
@@ -143,6 +150,7 @@ DWARFExpression::CopyOpcodeData (uint64_t const_value,
 {
     if (const_value_byte_size)
     {
+        m_loclist_index_sp.reset();
         m_data.SetData(DataBufferSP(new DataBufferHeap(&const_value, const_value_byte_size)));
         m_data.SetByteOrder(endian::InlHostByteOrder());
         m_data.SetAddressByteSize(addr_byte_size);
@@ -154,6 +162,7 @@ DWARFExpression::SetOpcodeData (lldb::ModuleSP module_sp, const DataExtractor& d
 {
     m_module_wp = module_sp;
     m_data.SetData(data, data_offset, data_length);
+    m_loclist_index_sp.reset();
 }
 
 void
@@ -1048,35 +1057,111 @@ DWARFExpression::GetLocation (addr_t base_addr, addr_t pc, lldb::offset_t &offse
         return true;
     }
 
-    if (base_addr != LLDB_INVALID_ADDRESS && pc != LLDB_INVALID_ADDRESS)
+    LocationListEntry entry;
+    if (FindLocationListEntry (base_addr, pc, entry))
     {
-        addr_t curr_base_addr = base_addr;
+        offset = entry.offset;
+        length = entry.length;
+        return true;
+    }
+    offset = LLDB_INVALID_OFFSET;
+    length = 0;
+    return false;
+}
 
-        while (m_data.ValidOffset(offset))
-        {
-            // We need to figure out what the value is for the location.
-            addr_t lo_pc = LLDB_INVALID_ADDRESS;
-            addr_t hi_pc = LLDB_INVALID_ADDRESS;
-            if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc, hi_pc))
-                break;
+std::shared_ptr<const DWARFExpression::LocationListIndex>
+DWARFExpression::GetLocationListIndex () const
+{
+    std::shared_ptr<const LocationListIndex> index_sp = std::atomic_load (&m_loclist_index_sp);
+    if (index_sp)
+        return index_sp;
 
-            if (lo_pc == 0 && hi_pc == 0)
-                break;
+    // Threads that get here at the same time decode the list more than
+    // once, one of the identical indexes wins.
+    std::shared_ptr<LocationListIndex> new_index_sp (new LocationListIndex());
+    lldb::offset_t offset = 0;
+    while (m_data.ValidOffset(offset))
+    {
+        LocationListEntry entry;
+        if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, entry.lo_pc, entry.hi_pc))
+            break;
 
-            lo_pc += curr_base_addr - m_loclist_slide;
-            hi_pc += curr_base_addr - m_loclist_slide;
-            
-            length = m_data.GetU16(&offset);
-            
-            if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                return true;
+        if (entry.lo_pc == 0 && entry.hi_pc == 0)
+            break;
+
+        entry.length = m_data.GetU16(&offset);
+        entry.offset = offset;
+        if (entry.length > 0 && entry.lo_pc < entry.hi_pc)
+            new_index_sp->entries.push_back(entry);
+        offset += entry.length;
+    }
+
+    // Lists whose ranges don't overlap can be binary searched in any
+    // order, otherwise the first entry in list order has to win.
+    std::vector<LocationListEntry> sorted_entries (new_index_sp->entries);
+    std::stable_sort (sorted_entries.begin(), sorted_entries.end(),
+                      [](const LocationListEntry &lhs, const LocationListEntry &rhs) {
+                          return lhs.lo_pc < rhs.lo_pc;
+                      });
+    bool overlaps = false;
+    for (size_t i = 1; i < sorted_entries.size() && !overlaps; ++i)
+        overlaps = sorted_entries[i].lo_pc < sorted_entries[i - 1].hi_pc;
+    if (!overlaps)
+    {
+        new_index_sp->entries.swap(sorted_entries);
+        new_index_sp->sorted = true;
+    }
+
+    index_sp = new_index_sp;
+    std::atomic_store (&m_loclist_index_sp, index_sp);
+    return index_sp;
+}
+
+bool
+DWARFExpression::FindLocationListEntry (addr_t loclist_base_addr, addr_t pc, LocationListEntry &entry) const
+{
+    if (loclist_base_addr == LLDB_INVALID_ADDRESS || pc == LLDB_INVALID_ADDRESS)
+        return false;
+
+    std::shared_ptr<const LocationListIndex> index_sp = GetLocationListIndex();
+    const std::vector<LocationListEntry> &entries = index_sp->entries;
 
-            offset += length;
+    // The entries are relative to the base of the list.
+    const addr_t list_pc = pc - (loclist_base_addr - m_loclist_slide);
+    if (!index_sp->sorted)
+    {
+        for (const LocationListEntry &list_entry : entries)
+        {
+            if (list_entry.lo_pc <= list_pc && list_pc < list_entry.hi_pc)
+            {
+                entry = list_entry;
+                return true;
+            }
         }
+        return false;
     }
-    offset = LLDB_INVALID_OFFSET;
-    length = 0;
-    return false;
+
+    const size_t last_match = index_sp->last_match.load(std::memory_order_relaxed);
+    if (last_match < entries.size() &&
+        entries[last_match].lo_pc <= list_pc && list_pc < entries[last_match].hi_pc)
+    {
+        entry = entries[last_match];
+        return true;
+    }
+
+    std::vector<LocationListEntry>::const_iterator pos =
+        std::upper_bound (entries.begin(), entries.end(), list_pc,
+                          [](addr_t addr, const LocationListEntry &list_entry) {
+                              return addr < list_entry.lo_pc;
+                          });
+    if (pos == entries.begin())
+        return false;
+    --pos;
+    if (list_pc >= pos->hi_pc)
+        return false;
+    index_sp->last_match.store(pos - entries.begin(), std::memory_order_relaxed);
+    entry = *pos;
+    return true;
 }
 
 bool
@@ -1143,7 +1228,6 @@ DWARFExpression::Evaluate
 
     if (IsLocationList())
     {
-        lldb::offset_t offset = 0;
         addr_t pc;
         StackFrame *frame = NULL;
         if (reg_ctx)
@@ -1168,42 +1252,23 @@ DWARFExpression::Evaluate
                 return false;
             }
 
-            addr_t curr_loclist_base_load_addr = loclist_base_load_addr;
-
-            while (m_data.ValidOffset(offset))
-            {
-                // We need to figure out what the value is for the location.
-                addr_t lo_pc = LLDB_INVALID_ADDRESS;
-                addr_t hi_pc = LLDB_INVALID_ADDRESS;
-                if (!AddressRangeForLocationListEntry(m_dwarf_cu, m_data, &offset, lo_pc, hi_pc))
-                    break;
-
-                if (lo_pc == 0 && hi_pc == 0)
-                    break;
-
-                lo_pc += curr_loclist_base_load_addr - m_loclist_slide;
-                hi_pc += curr_loclist_base_load_addr - m_loclist_slide;
-
-                uint16_t length = m_data.GetU16(&offset);
-
-                if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                {
-                    return DWARFExpression::Evaluate (exe_ctx,
-                                                      expr_locals,
-                                                      decl_map,
-                                                      reg_ctx,
-                                                      module_sp,
-                                                      m_data,
-                                                      m_dwarf_cu,
-                                                      offset,
-                                                      length,
-                                                      m_reg_kind,
-                                                      initial_value_ptr,
-                                                      object_address_ptr,
-                                                      result,
-                                                      error_ptr);
-                }
-                offset += length;
+            LocationListEntry entry;
+            if (FindLocationListEntry (loclist_base_load_addr, pc, entry))
+            {
+                return DWARFExpression::Evaluate (exe_ctx,
+                                                  expr_locals,
+                                                  decl_map,
+                                                  reg_ctx,
+                                                  module_sp,
+                                                  m_data,
+                                                  m_dwarf_cu,
+                                                  entry.offset,
+                                                  entry.length,
+                                                  m_reg_kind,
+                                                  initial_value_ptr,
+                                                  object_address_ptr,
+                                                  result,
+                                                  error_ptr);
             }
         }
         if (error_ptr)
@@ -249,11 +249,7 @@ bool ExpressionSourceCode::GetText (std::string &text, lldb::LanguageType wrappi
                 }
             }
             
-            decl_vendor->ForEachMacro(modules_for_macros, [&module_macros] (const std::string &expansion) -> bool {
-                module_macros.append(expansion);
-                module_macros.append("\n");
-                return false;
-            });
+            module_macros = decl_vendor->GetMacroDefinitions(modules_for_macros);
         }
 
     }
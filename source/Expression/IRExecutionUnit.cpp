@@ -30,6 +30,7 @@
 #include "lldb/Target/Target.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/LLVMTargets.h"
 
 #include "lldb/../../source/Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
 
@@ -259,6 +260,8 @@ IRExecutionUnit::GetRunnableInfo(Error &error,
         return;
     }
 
+    InitializeLLVMTargets();
+
     if (m_did_jit)
     {
         func_addr = m_function_load_addr;
@@ -33,13 +33,17 @@
 #include "llvm/IR/DataLayout.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Operator.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <cmath>
 #include <map>
+#include <vector>
 
 using namespace llvm;
 
@@ -90,6 +94,8 @@ CanIgnoreCall (const CallInst *call)
             break;
         case llvm::Intrinsic::dbg_declare:
         case llvm::Intrinsic::dbg_value:
+        case llvm::Intrinsic::lifetime_start:
+        case llvm::Intrinsic::lifetime_end:
             return true;
         }
     }
@@ -97,6 +103,282 @@ CanIgnoreCall (const CallInst *call)
     return false;
 }
 
+// memcpy, memmove and memset are done by the interpreter itself
+static bool
+IsSupportedMemIntrinsic (const CallInst *call)
+{
+    return isa<MemIntrinsic>(call);
+}
+
+// Integers are evaluated as Scalars, which hold at most 64 bits.
+static bool
+IsSupportedIntegerType (Type *type)
+{
+    return type->isIntegerTy() && type->getIntegerBitWidth() <= 64;
+}
+
+// Floating point values are computed as host doubles, which represent
+// every float and double exactly.
+static bool
+IsSupportedFloatType (Type *type)
+{
+    return type->isFloatTy() || type->isDoubleTy();
+}
+
+// Vectors are handled an element at a time, and the elements have to be
+// whole bytes.
+static bool
+IsSupportedVectorType (Type *type)
+{
+    VectorType *vector_type = dyn_cast<VectorType>(type);
+
+    if (!vector_type)
+        return false;
+
+    Type *element_type = vector_type->getElementType();
+
+    if (element_type->isIntegerTy())
+    {
+        switch (element_type->getIntegerBitWidth())
+        {
+        default:
+            return false;
+        case 8:
+        case 16:
+        case 32:
+        case 64:
+            return true;
+        }
+    }
+
+    return IsSupportedFloatType(element_type);
+}
+
+// The instructions that take or produce vectors.
+static bool
+CanInterpretVectors (unsigned opcode)
+{
+    switch (opcode)
+    {
+    default:
+        return false;
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Mul:
+    case Instruction::SDiv:
+    case Instruction::UDiv:
+    case Instruction::SRem:
+    case Instruction::URem:
+    case Instruction::Shl:
+    case Instruction::LShr:
+    case Instruction::AShr:
+    case Instruction::And:
+    case Instruction::Or:
+    case Instruction::Xor:
+    case Instruction::FAdd:
+    case Instruction::FSub:
+    case Instruction::FMul:
+    case Instruction::FDiv:
+    case Instruction::FRem:
+    case Instruction::BitCast:
+    case Instruction::ExtractElement:
+    case Instruction::InsertElement:
+    case Instruction::ShuffleVector:
+    case Instruction::Load:
+    case Instruction::Store:
+    case Instruction::Select:
+        return true;
+    }
+}
+
+static bool
+CanInterpretFloatingPoint (const Instruction &inst)
+{
+    Type *source_type = inst.getOperand(0)->getType()->getScalarType();
+    Type *result_type = inst.getType()->getScalarType();
+
+    switch (inst.getOpcode())
+    {
+    case Instruction::SIToFP:
+    case Instruction::UIToFP:
+        return IsSupportedIntegerType(source_type) && IsSupportedFloatType(result_type);
+    case Instruction::FPToSI:
+    case Instruction::FPToUI:
+        return IsSupportedFloatType(source_type) && IsSupportedIntegerType(result_type);
+    case Instruction::FCmp:
+        return IsSupportedFloatType(source_type);
+    default:
+        return IsSupportedFloatType(source_type) && IsSupportedFloatType(result_type);
+    }
+}
+
+static double
+BitsToHostDouble (uint64_t bits, Type *type)
+{
+    if (type->isFloatTy())
+        return BitsToFloat((uint32_t)bits);
+    return BitsToDouble(bits);
+}
+
+static uint64_t
+HostDoubleToBits (double value, Type *type)
+{
+    if (type->isFloatTy())
+        return FloatToBits((float)value);
+    return DoubleToBits(value);
+}
+
+static bool
+ComputeIntegerBinaryOp (unsigned opcode, lldb_private::Scalar L, lldb_private::Scalar R, lldb_private::Scalar &result)
+{
+    switch (opcode)
+    {
+        default:
+            return false;
+        case Instruction::Add:
+            result = L + R;
+            break;
+        case Instruction::Mul:
+            result = L * R;
+            break;
+        case Instruction::Sub:
+            result = L - R;
+            break;
+        case Instruction::SDiv:
+            L.MakeSigned();
+            R.MakeSigned();
+            result = L / R;
+            break;
+        case Instruction::UDiv:
+            L.MakeUnsigned();
+            R.MakeUnsigned();
+            result = L / R;
+            break;
+        case Instruction::SRem:
+            L.MakeSigned();
+            R.MakeSigned();
+            result = L % R;
+            break;
+        case Instruction::URem:
+            L.MakeUnsigned();
+            R.MakeUnsigned();
+            result = L % R;
+            break;
+        case Instruction::Shl:
+            result = L << R;
+            break;
+        case Instruction::AShr:
+            result = L >> R;
+            break;
+        case Instruction::LShr:
+            result = L;
+            result.ShiftRightLogical(R);
+            break;
+        case Instruction::And:
+            result = L & R;
+            break;
+        case Instruction::Or:
+            result = L | R;
+            break;
+        case Instruction::Xor:
+            result = L ^ R;
+            break;
+    }
+
+    return true;
+}
+
+// Operations on floats are done in double precision and rounded once when
+// the result is stored, which gives the same results as float arithmetic.
+static bool
+ComputeFloatBinaryOp (unsigned opcode, double L, double R, double &result)
+{
+    switch (opcode)
+    {
+        default:
+            return false;
+        case Instruction::FAdd:
+            result = L + R;
+            break;
+        case Instruction::FSub:
+            result = L - R;
+            break;
+        case Instruction::FMul:
+            result = L * R;
+            break;
+        case Instruction::FDiv:
+            result = L / R;
+            break;
+        case Instruction::FRem:
+            result = std::fmod(L, R);
+            break;
+    }
+
+    return true;
+}
+
+static bool
+ComputeFloatCompare (CmpInst::Predicate predicate, double L, double R, bool &result)
+{
+    const bool unordered = std::isnan(L) || std::isnan(R);
+
+    switch (predicate)
+    {
+        default:
+            return false;
+        case CmpInst::FCMP_FALSE:
+            result = false;
+            break;
+        case CmpInst::FCMP_OEQ:
+            result = !unordered && L == R;
+            break;
+        case CmpInst::FCMP_OGT:
+            result = !unordered && L > R;
+            break;
+        case CmpInst::FCMP_OGE:
+            result = !unordered && L >= R;
+            break;
+        case CmpInst::FCMP_OLT:
+            result = !unordered && L < R;
+            break;
+        case CmpInst::FCMP_OLE:
+            result = !unordered && L <= R;
+            break;
+        case CmpInst::FCMP_ONE:
+            result = !unordered && L != R;
+            break;
+        case CmpInst::FCMP_ORD:
+            result = !unordered;
+            break;
+        case CmpInst::FCMP_UNO:
+            result = unordered;
+            break;
+        case CmpInst::FCMP_UEQ:
+            result = unordered || L == R;
+            break;
+        case CmpInst::FCMP_UGT:
+            result = unordered || L > R;
+            break;
+        case CmpInst::FCMP_UGE:
+            result = unordered || L >= R;
+            break;
+        case CmpInst::FCMP_ULT:
+            result = unordered || L < R;
+            break;
+        case CmpInst::FCMP_ULE:
+            result = unordered || L <= R;
+            break;
+        case CmpInst::FCMP_UNE:
+            result = unordered || L != R;
+            break;
+        case CmpInst::FCMP_TRUE:
+            result = true;
+            break;
+    }
+
+    return true;
+}
+
 class InterpreterStackFrame
 {
 public:
@@ -254,6 +536,180 @@ public:
         return write_error.Success();
     }
 
+    bool EvaluateFloat (double &result, const Value *value, Module &module)
+    {
+        Type *type = value->getType();
+
+        if (!IsSupportedFloatType(type))
+            return false;
+
+        lldb_private::Scalar bits;
+
+        if (!EvaluateValue(bits, value, module))
+            return false;
+
+        result = BitsToHostDouble(bits.ULongLong(), type);
+        return true;
+    }
+
+    bool AssignFloat (const Value *value, double result, Module &module)
+    {
+        Type *type = value->getType();
+
+        if (!IsSupportedFloatType(type))
+            return false;
+
+        lldb_private::Scalar bits((unsigned long long)HostDoubleToBits(result, type));
+
+        return AssignValue(value, bits, module);
+    }
+
+    // Values that don't fit in a Scalar, like vectors and structs, are
+    // moved around as bytes.
+    bool ReadValueBytes (const Value *value, Module &module, std::vector<uint8_t> &bytes)
+    {
+        lldb::addr_t process_address = ResolveValue(value, module);
+
+        if (process_address == LLDB_INVALID_ADDRESS)
+            return false;
+
+        bytes.assign(m_target_data.getTypeStoreSize(value->getType()), 0);
+
+        if (bytes.empty())
+            return true;
+
+        lldb_private::Error read_error;
+
+        m_execution_unit.ReadMemory(bytes.data(), process_address, bytes.size(), read_error);
+
+        return read_error.Success();
+    }
+
+    bool WriteValueBytes (const Value *value, Module &module, const std::vector<uint8_t> &bytes)
+    {
+        lldb::addr_t process_address = ResolveValue(value, module);
+
+        if (process_address == LLDB_INVALID_ADDRESS)
+            return false;
+
+        if (bytes.size() != m_target_data.getTypeStoreSize(value->getType()))
+            return false;
+
+        if (bytes.empty())
+            return true;
+
+        lldb_private::Error write_error;
+
+        m_execution_unit.WriteMemory(process_address, bytes.data(), bytes.size(), write_error);
+
+        return write_error.Success();
+    }
+
+    uint64_t GetElement (const std::vector<uint8_t> &bytes, size_t offset, size_t size)
+    {
+        lldb_private::DataExtractor extractor(bytes.data(), bytes.size(), m_byte_order, m_addr_byte_size);
+        lldb::offset_t data_offset = offset;
+
+        return extractor.GetMaxU64(&data_offset, size);
+    }
+
+    void SetElement (std::vector<uint8_t> &bytes, size_t offset, size_t size, uint64_t value)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const size_t byte_index = (m_byte_order == lldb::eByteOrderLittle) ? i : size - 1 - i;
+            bytes[offset + byte_index] = (uint8_t)(value >> (8 * i));
+        }
+    }
+
+    // Applies a binary operator to each element of two vectors.
+    bool EvaluateVectorBinaryOp (const BinaryOperator *bin_op, Module &module)
+    {
+        VectorType *vector_type = dyn_cast<VectorType>(bin_op->getType());
+
+        if (!vector_type)
+            return false;
+
+        Type *element_type = vector_type->getElementType();
+        const size_t element_size = m_target_data.getTypeStoreSize(element_type);
+
+        std::vector<uint8_t> lhs_bytes;
+        std::vector<uint8_t> rhs_bytes;
+
+        if (!ReadValueBytes(bin_op->getOperand(0), module, lhs_bytes) ||
+            !ReadValueBytes(bin_op->getOperand(1), module, rhs_bytes))
+            return false;
+
+        std::vector<uint8_t> result_bytes(lhs_bytes.size(), 0);
+
+        for (unsigned i = 0, e = vector_type->getNumElements(); i != e; ++i)
+        {
+            const size_t offset = i * element_size;
+            const uint64_t lhs = GetElement(lhs_bytes, offset, element_size);
+            const uint64_t rhs = GetElement(rhs_bytes, offset, element_size);
+            uint64_t result_element;
+
+            if (element_type->isFloatingPointTy())
+            {
+                double result;
+
+                if (!ComputeFloatBinaryOp(bin_op->getOpcode(),
+                                          BitsToHostDouble(lhs, element_type),
+                                          BitsToHostDouble(rhs, element_type),
+                                          result))
+                    return false;
+
+                result_element = HostDoubleToBits(result, element_type);
+            }
+            else
+            {
+                lldb_private::Scalar L;
+                lldb_private::Scalar R;
+                lldb_private::Scalar result;
+
+                if (!AssignToMatchType(L, lhs, element_type) ||
+                    !AssignToMatchType(R, rhs, element_type) ||
+                    !ComputeIntegerBinaryOp(bin_op->getOpcode(), L, R, result))
+                    return false;
+
+                result_element = result.ULongLong();
+            }
+
+            SetElement(result_bytes, offset, element_size, result_element);
+        }
+
+        return WriteValueBytes(bin_op, module, result_bytes);
+    }
+
+    // The offset of a member of a struct or an array, given the indices of
+    // an ExtractValue or an InsertValue.
+    bool GetAggregateOffset (Type *type, ArrayRef<unsigned> indices, uint64_t &offset)
+    {
+        offset = 0;
+
+        for (unsigned index : indices)
+        {
+            if (StructType *struct_type = dyn_cast<StructType>(type))
+            {
+                if (index >= struct_type->getNumElements())
+                    return false;
+                offset += m_target_data.getStructLayout(struct_type)->getElementOffset(index);
+                type = struct_type->getElementType(index);
+            }
+            else if (ArrayType *array_type = dyn_cast<ArrayType>(type))
+            {
+                type = array_type->getElementType();
+                offset += index * m_target_data.getTypeAllocSize(type);
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     bool ResolveConstantValue (APInt &value, const Constant *constant)
     {
         switch (constant->getValueID())
@@ -334,6 +790,13 @@ public:
                 return true;
             }
             break;
+        case Value::UndefValueVal:
+            if (const uint64_t bit_size = m_target_data.getTypeSizeInBits(constant->getType()))
+            {
+                value = APInt(bit_size, 0);
+                return true;
+            }
+            break;
         }
         return false;
     }
@@ -372,6 +835,37 @@ public:
 
     bool ResolveConstant (lldb::addr_t process_address, const Constant *constant)
     {
+        // Undefined values and zeroinitializers are all zeros, vectors are
+        // resolved an element at a time.
+        if (isa<UndefValue>(constant) || isa<ConstantAggregateZero>(constant))
+        {
+            lldb_private::DataBufferHeap buf(m_target_data.getTypeStoreSize(constant->getType()), 0);
+
+            if (buf.GetByteSize() == 0)
+                return true;
+
+            lldb_private::Error write_error;
+
+            m_execution_unit.WriteMemory(process_address, buf.GetBytes(), buf.GetByteSize(), write_error);
+
+            return write_error.Success();
+        }
+
+        if (VectorType *vector_type = dyn_cast<VectorType>(constant->getType()))
+        {
+            const size_t element_size = m_target_data.getTypeStoreSize(vector_type->getElementType());
+
+            for (unsigned i = 0, e = vector_type->getNumElements(); i != e; ++i)
+            {
+                const Constant *element = constant->getAggregateElement(i);
+
+                if (!element || !ResolveConstant(process_address + i * element_size, element))
+                    return false;
+            }
+
+            return true;
+        }
+
         APInt resolved_value;
 
         if (!ResolveConstantValue(resolved_value, constant))
@@ -483,6 +977,9 @@ static const char *infinite_loop_error              = "Interpreter ran for too m
 //static const char *bad_result_error                 = "Result of expression is in bad memory";
 static const char *too_many_functions_error = "Interpreter doesn't handle modules with multiple function bodies.";
 
+// memcpy and memset lengths the interpreter buffers at most
+static const uint64_t max_mem_intrinsic_length = 16 * 1024 * 1024;
+
 static bool
 CanResolveConstant (llvm::Constant *constant)
 {
@@ -519,7 +1016,22 @@ CanResolveConstant (llvm::Constant *constant)
             return false;
         }
     case Value::ConstantPointerNullVal:
+    case Value::UndefValueVal:
+    case Value::ConstantAggregateZeroVal:
         return true;
+    case Value::ConstantDataVectorVal:
+    case Value::ConstantVectorVal:
+        if (VectorType *vector_type = dyn_cast<VectorType>(constant->getType()))
+        {
+            for (unsigned i = 0, e = vector_type->getNumElements(); i != e; ++i)
+            {
+                Constant *element = constant->getAggregateElement(i);
+                if (!element || !CanResolveConstant(element))
+                    return false;
+            }
+            return true;
+        }
+        return false;
     }
 }
 
@@ -566,7 +1078,7 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                     if (log)
                         log->Printf("Unsupported instruction: %s", PrintValue(&*ii).c_str());
                     error.SetErrorToGenericError();
-                    error.SetErrorString(unsupported_opcode_error);
+                    error.SetErrorStringWithFormat("%s (%s)", unsupported_opcode_error, ii->getOpcodeName());
                     return false;
                 }
             case Instruction::Add:
@@ -574,24 +1086,70 @@ IRInterpreter::CanInterpret (llvm::Module &module,
             case Instruction::BitCast:
             case Instruction::Br:
             case Instruction::PHI:
+            case Instruction::ExtractElement:
+            case Instruction::InsertElement:
+            case Instruction::ShuffleVector:
+            case Instruction::ExtractValue:
+            case Instruction::InsertValue:
                 break;
-            case Instruction::Call:
+            case Instruction::Select:
+                if (ii->getOperand(0)->getType()->isVectorTy())
                 {
-                    CallInst *call_inst = dyn_cast<CallInst>(ii);
-
-                    if (!call_inst)
-                    {
-                        error.SetErrorToGenericError();
-                        error.SetErrorString(interpreter_internal_error);
+                    if (log)
+                        log->Printf("Unsupported vector condition: %s", PrintValue(&*ii).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorStringWithFormat("%s (%s)", unsupported_operand_error, ii->getOpcodeName());
+                    return false;
+                }
+                break;
+            case Instruction::Switch:
+                if (!IsSupportedIntegerType(ii->getOperand(0)->getType()))
+                {
+                    if (log)
+                        log->Printf("Unsupported switch condition: %s", PrintValue(&*ii).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorStringWithFormat("%s (%s)", unsupported_operand_error, ii->getOpcodeName());
+                    return false;
+                }
+                break;
+            case Instruction::FAdd:
+            case Instruction::FSub:
+            case Instruction::FMul:
+            case Instruction::FDiv:
+            case Instruction::FRem:
+            case Instruction::FCmp:
+            case Instruction::FPExt:
+            case Instruction::FPTrunc:
+            case Instruction::FPToSI:
+            case Instruction::FPToUI:
+            case Instruction::SIToFP:
+            case Instruction::UIToFP:
+                if (!CanInterpretFloatingPoint(*ii))
+                {
+                    if (log)
+                        log->Printf("Unsupported floating point type: %s", PrintValue(&*ii).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorStringWithFormat("%s (%s)", unsupported_operand_error, ii->getOpcodeName());
+                    return false;
+                }
+                break;
+            case Instruction::Call:
+                {
+                    CallInst *call_inst = dyn_cast<CallInst>(ii);
+
+                    if (!call_inst)
+                    {
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(interpreter_internal_error);
                         return false;
                     }
 
-                    if (!CanIgnoreCall(call_inst) && !support_function_calls)
+                    if (!CanIgnoreCall(call_inst) && !IsSupportedMemIntrinsic(call_inst) && !support_function_calls)
                     {
                         if (log)
                             log->Printf("Unsupported instruction: %s", PrintValue(&*ii).c_str());
                         error.SetErrorToGenericError();
-                        error.SetErrorString(unsupported_opcode_error);
+                        error.SetErrorStringWithFormat("%s (%s)", unsupported_opcode_error, ii->getOpcodeName());
                         return false;
                     }
                 }
@@ -617,7 +1175,7 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                             log->Printf("Unsupported ICmp predicate: %s", PrintValue(&*ii).c_str());
 
                         error.SetErrorToGenericError();
-                        error.SetErrorString(unsupported_opcode_error);
+                        error.SetErrorStringWithFormat("%s (%s)", unsupported_opcode_error, ii->getOpcodeName());
                         return false;
                     }
                     case CmpInst::ICMP_EQ:
@@ -669,12 +1227,14 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                 default:
                     break;
                 case Type::VectorTyID:
+                    if (!CanInterpretVectors(ii->getOpcode()) || !IsSupportedVectorType(operand_type))
                     {
                         if (log)
                             log->Printf("Unsupported operand type: %s", PrintType(operand_type).c_str());
-                        error.SetErrorString(unsupported_operand_error);
+                        error.SetErrorStringWithFormat("%s (%s)", unsupported_operand_error, ii->getOpcodeName());
                         return false;
                     }
+                    break;
                 }
 
                 if (Constant *constant = llvm::dyn_cast<Constant>(operand))
@@ -688,6 +1248,15 @@ IRInterpreter::CanInterpret (llvm::Module &module,
                     }
                 }
             }
+
+            if (ii->getType()->isVectorTy() &&
+                (!CanInterpretVectors(ii->getOpcode()) || !IsSupportedVectorType(ii->getType())))
+            {
+                if (log)
+                    log->Printf("Unsupported result type: %s", PrintType(ii->getType()).c_str());
+                error.SetErrorStringWithFormat("%s (%s)", unsupported_operand_error, ii->getOpcodeName());
+                return false;
+            }
         }
 
     }
@@ -774,6 +1343,11 @@ IRInterpreter::Interpret (llvm::Module &module,
             case Instruction::And:
             case Instruction::Or:
             case Instruction::Xor:
+            case Instruction::FAdd:
+            case Instruction::FSub:
+            case Instruction::FMul:
+            case Instruction::FDiv:
+            case Instruction::FRem:
             {
                 const BinaryOperator *bin_op = dyn_cast<BinaryOperator>(inst);
 
@@ -789,6 +1363,71 @@ IRInterpreter::Interpret (llvm::Module &module,
                 Value *lhs = inst->getOperand(0);
                 Value *rhs = inst->getOperand(1);
 
+                if (inst->getType()->isVectorTy())
+                {
+                    if (!frame.EvaluateVectorBinaryOp(bin_op, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    if (log)
+                    {
+                        log->Printf("Interpreted a vector %s", inst->getOpcodeName());
+                        log->Printf("  L : %s", frame.SummarizeValue(lhs).c_str());
+                        log->Printf("  R : %s", frame.SummarizeValue(rhs).c_str());
+                        log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                    }
+                    break;
+                }
+
+                if (inst->getType()->isFloatingPointTy())
+                {
+                    double L;
+                    double R;
+                    double result;
+
+                    if (!frame.EvaluateFloat(L, lhs, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    if (!frame.EvaluateFloat(R, rhs, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    if (!ComputeFloatBinaryOp(inst->getOpcode(), L, R, result) ||
+                        !frame.AssignFloat(inst, result, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't assign the result of %s", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    if (log)
+                    {
+                        log->Printf("Interpreted a %s", inst->getOpcodeName());
+                        log->Printf("  L : %g", L);
+                        log->Printf("  R : %g", R);
+                        log->Printf("  = : %g", result);
+                    }
+                    break;
+                }
+
                 lldb_private::Scalar L;
                 lldb_private::Scalar R;
 
@@ -812,59 +1451,7 @@ IRInterpreter::Interpret (llvm::Module &module,
 
                 lldb_private::Scalar result;
 
-                switch (inst->getOpcode())
-                {
-                    default:
-                        break;
-                    case Instruction::Add:
-                        result = L + R;
-                        break;
-                    case Instruction::Mul:
-                        result = L * R;
-                        break;
-                    case Instruction::Sub:
-                        result = L - R;
-                        break;
-                    case Instruction::SDiv:
-                        L.MakeSigned();
-                        R.MakeSigned();
-                        result = L / R;
-                        break;
-                    case Instruction::UDiv:
-                        L.MakeUnsigned();
-                        R.MakeUnsigned();
-                        result = L / R;
-                        break;
-                    case Instruction::SRem:
-                        L.MakeSigned();
-                        R.MakeSigned();
-                        result = L % R;
-                        break;
-                    case Instruction::URem:
-                        L.MakeUnsigned();
-                        R.MakeUnsigned();
-                        result = L % R;
-                        break;
-                    case Instruction::Shl:
-                        result = L << R;
-                        break;
-                    case Instruction::AShr:
-                        result = L >> R;
-                        break;
-                    case Instruction::LShr:
-                        result = L;
-                        result.ShiftRightLogical(R);
-                        break;
-                    case Instruction::And:
-                        result = L & R;
-                        break;
-                    case Instruction::Or:
-                        result = L | R;
-                        break;
-                    case Instruction::Xor:
-                        result = L ^ R;
-                        break;
-                }
+                ComputeIntegerBinaryOp(inst->getOpcode(), L, R, result);
 
                 frame.AssignValue(inst, result, module);
 
@@ -971,6 +1558,22 @@ IRInterpreter::Interpret (llvm::Module &module,
 
                 Value *source = cast_inst->getOperand(0);
 
+                if (inst->getType()->isVectorTy() || source->getType()->isVectorTy())
+                {
+                    std::vector<uint8_t> bytes;
+
+                    if (!frame.ReadValueBytes(source, module, bytes) ||
+                        !frame.WriteValueBytes(inst, module, bytes))
+                    {
+                        if (log)
+                            log->Printf("Couldn't copy %s", PrintValue(source).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+                    break;
+                }
+
                 lldb_private::Scalar S;
 
                 if (!frame.EvaluateValue(S, source, module))
@@ -1598,6 +2201,494 @@ IRInterpreter::Interpret (llvm::Module &module,
                 }
             }
                 break;
+            case Instruction::FCmp:
+            {
+                const FCmpInst *fcmp_inst = dyn_cast<FCmpInst>(inst);
+
+                if (!fcmp_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns FCmp, but instruction is not an FCmpInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                Value *lhs = inst->getOperand(0);
+                Value *rhs = inst->getOperand(1);
+
+                double L;
+                double R;
+
+                if (!frame.EvaluateFloat(L, lhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(lhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (!frame.EvaluateFloat(R, rhs, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(rhs).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                bool compare_result;
+
+                if (!ComputeFloatCompare(fcmp_inst->getPredicate(), L, R, compare_result))
+                {
+                    if (log)
+                        log->Printf("Unsupported FCmp predicate: %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(unsupported_opcode_error);
+                    return false;
+                }
+
+                lldb_private::Scalar result(compare_result ? 1 : 0);
+
+                frame.AssignValue(inst, result, module);
+
+                if (log)
+                {
+                    log->Printf("Interpreted an FCmpInst");
+                    log->Printf("  L : %g", L);
+                    log->Printf("  R : %g", R);
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::FPExt:
+            case Instruction::FPTrunc:
+            case Instruction::FPToSI:
+            case Instruction::FPToUI:
+            case Instruction::SIToFP:
+            case Instruction::UIToFP:
+            {
+                const CastInst *cast_inst = dyn_cast<CastInst>(inst);
+
+                if (!cast_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns %s, but instruction is not a CastInst", inst->getOpcodeName());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                Value *source = cast_inst->getOperand(0);
+                Type *source_type = source->getType();
+                Type *dest_type = cast_inst->getType();
+
+                bool assigned = false;
+
+                if (source_type->isFloatingPointTy())
+                {
+                    double F;
+
+                    if (!frame.EvaluateFloat(F, source, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    if (dest_type->isFloatingPointTy())
+                    {
+                        assigned = frame.AssignFloat(inst, F, module);
+                    }
+                    else
+                    {
+                        // Out of range conversions are undefined in IR, they
+                        // must not be undefined here.
+                        uint64_t I = 0;
+                        if (inst->getOpcode() == Instruction::FPToSI)
+                        {
+                            if (F > -9223372036854775808.0 && F < 9223372036854775808.0)
+                                I = (uint64_t)(int64_t)F;
+                        }
+                        else
+                        {
+                            if (F > -1.0 && F < 18446744073709551616.0)
+                                I = (uint64_t)F;
+                        }
+
+                        lldb_private::Scalar S((unsigned long long)I);
+                        assigned = frame.AssignValue(inst, S, module);
+                    }
+                }
+                else
+                {
+                    lldb_private::Scalar S;
+
+                    if (!frame.EvaluateValue(S, source, module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate %s", PrintValue(source).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    const unsigned bit_width = source_type->getIntegerBitWidth();
+                    const uint64_t bits = S.ULongLong() & (bit_width < 64 ? (1ull << bit_width) - 1 : UINT64_MAX);
+
+                    // Convert straight to float when the result is a float,
+                    // going through double could round twice.
+                    double F;
+                    if (inst->getOpcode() == Instruction::SIToFP)
+                    {
+                        const int64_t I = SignExtend64(bits, bit_width);
+                        F = dest_type->isFloatTy() ? (double)(float)I : (double)I;
+                    }
+                    else
+                    {
+                        F = dest_type->isFloatTy() ? (double)(float)bits : (double)bits;
+                    }
+
+                    assigned = frame.AssignFloat(inst, F, module);
+                }
+
+                if (!assigned)
+                {
+                    if (log)
+                        log->Printf("Couldn't assign the result of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Src : %s", frame.SummarizeValue(source).c_str());
+                    log->Printf("  =   : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::Select:
+            {
+                const SelectInst *select_inst = dyn_cast<SelectInst>(inst);
+
+                if (!select_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns Select, but instruction is not a SelectInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                const Value *condition = select_inst->getCondition();
+
+                lldb_private::Scalar C;
+
+                if (!frame.EvaluateValue(C, condition, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(condition).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const Value *selected = C.IsZero() ? select_inst->getFalseValue() : select_inst->getTrueValue();
+
+                std::vector<uint8_t> bytes;
+
+                if (!frame.ReadValueBytes(selected, module, bytes) ||
+                    !frame.WriteValueBytes(inst, module, bytes))
+                {
+                    if (log)
+                        log->Printf("Couldn't copy %s", PrintValue(selected).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (log)
+                {
+                    log->Printf("Interpreted a SelectInst");
+                    log->Printf("  cond : %s", frame.SummarizeValue(condition).c_str());
+                    log->Printf("  =    : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::Switch:
+            {
+                const SwitchInst *switch_inst = dyn_cast<SwitchInst>(inst);
+
+                if (!switch_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns Switch, but instruction is not a SwitchInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                Value *condition = switch_inst->getCondition();
+
+                lldb_private::Scalar C;
+
+                if (!frame.EvaluateValue(C, condition, module))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate %s", PrintValue(condition).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const APInt condition_value(condition->getType()->getIntegerBitWidth(), C.ULongLong());
+                const BasicBlock *destination = switch_inst->getDefaultDest();
+
+                for (auto switch_case : switch_inst->cases())
+                {
+                    if (switch_case.getCaseValue()->getValue() == condition_value)
+                    {
+                        destination = switch_case.getCaseSuccessor();
+                        break;
+                    }
+                }
+
+                frame.Jump(destination);
+
+                if (log)
+                {
+                    log->Printf("Interpreted a SwitchInst");
+                    log->Printf("  cond : %s", frame.SummarizeValue(condition).c_str());
+                }
+            }
+                continue;
+            case Instruction::ExtractElement:
+            case Instruction::InsertElement:
+            {
+                // The vector is operand 0 of both, the index the last operand.
+                const Value *vector_operand = inst->getOperand(0);
+                const Value *index_operand = inst->getOperand(inst->getNumOperands() - 1);
+                VectorType *vector_type = dyn_cast<VectorType>(vector_operand->getType());
+
+                if (!vector_type)
+                {
+                    if (log)
+                        log->Printf("The vector operand of %s is not a vector", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                lldb_private::Scalar I;
+                std::vector<uint8_t> vector_bytes;
+
+                if (!frame.EvaluateValue(I, index_operand, module) ||
+                    !frame.ReadValueBytes(vector_operand, module, vector_bytes))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate the operands of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const uint64_t index = I.ULongLong();
+
+                if (index >= vector_type->getNumElements())
+                {
+                    if (log)
+                        log->Printf("The index of %s is out of range", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const size_t element_size = data_layout.getTypeStoreSize(vector_type->getElementType());
+                const size_t offset = index * element_size;
+
+                bool copied;
+                if (inst->getOpcode() == Instruction::ExtractElement)
+                {
+                    std::vector<uint8_t> element_bytes(vector_bytes.begin() + offset,
+                                                       vector_bytes.begin() + offset + element_size);
+                    copied = frame.WriteValueBytes(inst, module, element_bytes);
+                }
+                else
+                {
+                    std::vector<uint8_t> element_bytes;
+                    copied = frame.ReadValueBytes(inst->getOperand(1), module, element_bytes) &&
+                             element_bytes.size() == element_size;
+                    if (copied)
+                    {
+                        std::copy(element_bytes.begin(), element_bytes.end(), vector_bytes.begin() + offset);
+                        copied = frame.WriteValueBytes(inst, module, vector_bytes);
+                    }
+                }
+
+                if (!copied)
+                {
+                    if (log)
+                        log->Printf("Couldn't copy the element of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Vector : %s", frame.SummarizeValue(vector_operand).c_str());
+                    log->Printf("  Index  : %" PRIu64, index);
+                    log->Printf("  =      : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::ShuffleVector:
+            {
+                const ShuffleVectorInst *shuffle_inst = dyn_cast<ShuffleVectorInst>(inst);
+
+                if (!shuffle_inst)
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns ShuffleVector, but instruction is not a ShuffleVectorInst");
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                VectorType *source_type = dyn_cast<VectorType>(shuffle_inst->getOperand(0)->getType());
+                VectorType *result_type = shuffle_inst->getType();
+
+                std::vector<uint8_t> lhs_bytes;
+                std::vector<uint8_t> rhs_bytes;
+
+                if (!source_type ||
+                    !frame.ReadValueBytes(shuffle_inst->getOperand(0), module, lhs_bytes) ||
+                    !frame.ReadValueBytes(shuffle_inst->getOperand(1), module, rhs_bytes))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate the operands of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                const unsigned num_source_elements = source_type->getNumElements();
+                const size_t element_size = data_layout.getTypeStoreSize(result_type->getElementType());
+
+                // Undefined elements of the mask (-1) leave zeros.
+                std::vector<uint8_t> result_bytes(data_layout.getTypeStoreSize(result_type), 0);
+
+                for (unsigned i = 0, e = result_type->getNumElements(); i != e; ++i)
+                {
+                    const int mask_value = shuffle_inst->getMaskValue(i);
+
+                    if (mask_value < 0)
+                        continue;
+
+                    const std::vector<uint8_t> &source_bytes = ((unsigned)mask_value < num_source_elements) ? lhs_bytes : rhs_bytes;
+                    const size_t source_offset = (mask_value % num_source_elements) * element_size;
+
+                    std::copy(source_bytes.begin() + source_offset,
+                              source_bytes.begin() + source_offset + element_size,
+                              result_bytes.begin() + i * element_size);
+                }
+
+                if (!frame.WriteValueBytes(inst, module, result_bytes))
+                {
+                    if (log)
+                        log->Printf("Couldn't write the result of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(memory_write_error);
+                    return false;
+                }
+
+                if (log)
+                {
+                    log->Printf("Interpreted a ShuffleVectorInst");
+                    log->Printf("  = : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
+            case Instruction::ExtractValue:
+            case Instruction::InsertValue:
+            {
+                // The aggregate is operand 0 of both.
+                const Value *aggregate_operand = inst->getOperand(0);
+
+                ArrayRef<unsigned> indices;
+                if (const ExtractValueInst *extract_inst = dyn_cast<ExtractValueInst>(inst))
+                    indices = extract_inst->getIndices();
+                else if (const InsertValueInst *insert_inst = dyn_cast<InsertValueInst>(inst))
+                    indices = insert_inst->getIndices();
+                else
+                {
+                    if (log)
+                        log->Printf("getOpcode() returns %s, but instruction has no indices", inst->getOpcodeName());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(interpreter_internal_error);
+                    return false;
+                }
+
+                uint64_t offset;
+                std::vector<uint8_t> aggregate_bytes;
+
+                if (!frame.GetAggregateOffset(aggregate_operand->getType(), indices, offset) ||
+                    !frame.ReadValueBytes(aggregate_operand, module, aggregate_bytes))
+                {
+                    if (log)
+                        log->Printf("Couldn't evaluate the operands of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                bool copied;
+                if (inst->getOpcode() == Instruction::ExtractValue)
+                {
+                    const size_t member_size = data_layout.getTypeStoreSize(inst->getType());
+                    copied = offset + member_size <= aggregate_bytes.size();
+                    if (copied)
+                    {
+                        std::vector<uint8_t> member_bytes(aggregate_bytes.begin() + offset,
+                                                          aggregate_bytes.begin() + offset + member_size);
+                        copied = frame.WriteValueBytes(inst, module, member_bytes);
+                    }
+                }
+                else
+                {
+                    std::vector<uint8_t> member_bytes;
+                    copied = frame.ReadValueBytes(inst->getOperand(1), module, member_bytes) &&
+                             offset + member_bytes.size() <= aggregate_bytes.size();
+                    if (copied)
+                    {
+                        std::copy(member_bytes.begin(), member_bytes.end(), aggregate_bytes.begin() + offset);
+                        copied = frame.WriteValueBytes(inst, module, aggregate_bytes);
+                    }
+                }
+
+                if (!copied)
+                {
+                    if (log)
+                        log->Printf("Couldn't copy the member of %s", PrintValue(inst).c_str());
+                    error.SetErrorToGenericError();
+                    error.SetErrorString(bad_value_error);
+                    return false;
+                }
+
+                if (log)
+                {
+                    log->Printf("Interpreted a %s", inst->getOpcodeName());
+                    log->Printf("  Offset : %" PRIu64, offset);
+                    log->Printf("  =      : %s", frame.SummarizeValue(inst).c_str());
+                }
+            }
+                break;
             case Instruction::Call:
             {
                 const CallInst *call_inst = dyn_cast<CallInst>(inst);
@@ -1614,6 +2705,103 @@ IRInterpreter::Interpret (llvm::Module &module,
                 if (CanIgnoreCall(call_inst))
                     break;
 
+                if (const MemIntrinsic *mem_intrinsic = dyn_cast<MemIntrinsic>(call_inst))
+                {
+                    lldb_private::Scalar D;
+                    lldb_private::Scalar L;
+
+                    if (!frame.EvaluateValue(D, mem_intrinsic->getRawDest(), module) ||
+                        !frame.EvaluateValue(L, mem_intrinsic->getLength(), module))
+                    {
+                        if (log)
+                            log->Printf("Couldn't evaluate the operands of %s", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(bad_value_error);
+                        return false;
+                    }
+
+                    const lldb::addr_t dest = D.ULongLong(LLDB_INVALID_ADDRESS);
+                    const uint64_t length = L.ULongLong();
+
+                    if (length > max_mem_intrinsic_length)
+                    {
+                        if (log)
+                            log->Printf("%s is too large to interpret", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(memory_allocation_error);
+                        return false;
+                    }
+
+                    if (length == 0)
+                        break;
+
+                    // Read all of the source first so overlapping memmoves
+                    // work as well.
+                    lldb_private::DataBufferHeap buffer(length, 0);
+
+                    if (const MemSetInst *memset_inst = dyn_cast<MemSetInst>(mem_intrinsic))
+                    {
+                        lldb_private::Scalar V;
+
+                        if (!frame.EvaluateValue(V, memset_inst->getValue(), module))
+                        {
+                            if (log)
+                                log->Printf("Couldn't evaluate %s", PrintValue(memset_inst->getValue()).c_str());
+                            error.SetErrorToGenericError();
+                            error.SetErrorString(bad_value_error);
+                            return false;
+                        }
+
+                        ::memset(buffer.GetBytes(), (uint8_t)V.UInt(), length);
+                    }
+                    else
+                    {
+                        const MemTransferInst *transfer_inst = cast<MemTransferInst>(mem_intrinsic);
+                        lldb_private::Scalar S;
+
+                        if (!frame.EvaluateValue(S, transfer_inst->getRawSource(), module))
+                        {
+                            if (log)
+                                log->Printf("Couldn't evaluate %s", PrintValue(transfer_inst->getRawSource()).c_str());
+                            error.SetErrorToGenericError();
+                            error.SetErrorString(bad_value_error);
+                            return false;
+                        }
+
+                        lldb_private::Error read_error;
+                        execution_unit.ReadMemory(buffer.GetBytes(), S.ULongLong(LLDB_INVALID_ADDRESS), length, read_error);
+
+                        if (!read_error.Success())
+                        {
+                            if (log)
+                                log->Printf("Couldn't read the source of %s", PrintValue(inst).c_str());
+                            error.SetErrorToGenericError();
+                            error.SetErrorString(memory_read_error);
+                            return false;
+                        }
+                    }
+
+                    lldb_private::Error write_error;
+                    execution_unit.WriteMemory(dest, buffer.GetBytes(), length, write_error);
+
+                    if (!write_error.Success())
+                    {
+                        if (log)
+                            log->Printf("Couldn't write the destination of %s", PrintValue(inst).c_str());
+                        error.SetErrorToGenericError();
+                        error.SetErrorString(memory_write_error);
+                        return false;
+                    }
+
+                    if (log)
+                    {
+                        log->Printf("Interpreted a %s", PrintValue(call_inst->getCalledValue()).c_str());
+                        log->Printf("  D : 0x%" PRIx64, dest);
+                        log->Printf("  L : %" PRIu64, length);
+                    }
+                    break;
+                }
+
                 // Get the return type
                 llvm::Type *returnType = call_inst->getType();
                 if (returnType == nullptr)
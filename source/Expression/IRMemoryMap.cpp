@@ -16,6 +16,8 @@
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 
+#include <algorithm>
+
 using namespace lldb_private;
 
 IRMemoryMap::IRMemoryMap (lldb::TargetSP target_sp) :
@@ -208,7 +210,10 @@ IRMemoryMap::Allocation::Allocation (lldb::addr_t process_alloc,
     m_permissions (permissions),
     m_alignment (alignment),
     m_policy (policy),
-    m_leak (false)
+    m_leak (false),
+    m_batched (false),
+    m_dirty_start (0),
+    m_dirty_end (0)
 {
     switch (policy)
     {
@@ -506,6 +511,20 @@ IRMemoryMap::WriteMemory (lldb::addr_t process_address, const uint8_t *bytes, si
             return;
         }
         ::memcpy (allocation.m_data.GetBytes() + offset, bytes, size);
+        if (allocation.m_batched)
+        {
+            if (allocation.m_dirty_start == allocation.m_dirty_end)
+            {
+                allocation.m_dirty_start = offset;
+                allocation.m_dirty_end = offset + size;
+            }
+            else
+            {
+                allocation.m_dirty_start = std::min<size_t>(allocation.m_dirty_start, offset);
+                allocation.m_dirty_end = std::max<size_t>(allocation.m_dirty_end, offset + size);
+            }
+            break;
+        }
         process_sp = m_process_wp.lock();
         if (process_sp)
         {
@@ -644,7 +663,7 @@ IRMemoryMap::ReadMemory (uint8_t *bytes, lldb::addr_t process_address, size_t si
         break;
     case eAllocationPolicyMirror:
         process_sp = m_process_wp.lock();
-        if (process_sp)
+        if (process_sp && !allocation.m_batched)
         {
             process_sp->ReadMemory(process_address, bytes, size, error);
             if (!error.Success())
@@ -776,7 +795,10 @@ IRMemoryMap::GetMemoryData (DataExtractor &extractor, lldb::addr_t process_addre
                 }
                 if (process_sp)
                 {
-                    process_sp->ReadMemory(allocation.m_process_start, allocation.m_data.GetBytes(), allocation.m_data.GetByteSize(), error);
+                    // While batched the host copy is current and may have
+                    // writes the process doesn't have yet.
+                    if (!allocation.m_batched)
+                        process_sp->ReadMemory(allocation.m_process_start, allocation.m_data.GetBytes(), allocation.m_data.GetByteSize(), error);
                     if (!error.Success())
                         return;
                     uint64_t offset = process_address - allocation.m_process_start;
@@ -804,3 +826,68 @@ IRMemoryMap::GetMemoryData (DataExtractor &extractor, lldb::addr_t process_addre
         return;
     }
 }
+
+bool
+IRMemoryMap::BeginBatchedAccess (lldb::addr_t process_address)
+{
+    AllocationMap::iterator iter = FindAllocation(process_address, 1);
+
+    if (iter == m_allocations.end())
+        return false;
+
+    Allocation &allocation = iter->second;
+
+    if (allocation.m_policy != eAllocationPolicyMirror || allocation.m_batched || !allocation.m_data.GetByteSize())
+        return false;
+
+    lldb::ProcessSP process_sp = m_process_wp.lock();
+
+    if (process_sp)
+    {
+        Error read_error;
+        process_sp->ReadMemory(allocation.m_process_start, allocation.m_data.GetBytes(), allocation.m_data.GetByteSize(), read_error);
+        if (!read_error.Success())
+            return false;
+    }
+
+    allocation.m_batched = true;
+    allocation.m_dirty_start = 0;
+    allocation.m_dirty_end = 0;
+    return true;
+}
+
+void
+IRMemoryMap::EndBatchedAccess (lldb::addr_t process_address, Error &error)
+{
+    error.Clear();
+
+    AllocationMap::iterator iter = FindAllocation(process_address, 1);
+
+    if (iter == m_allocations.end() || !iter->second.m_batched)
+        return;
+
+    Allocation &allocation = iter->second;
+    allocation.m_batched = false;
+
+    if (allocation.m_dirty_start == allocation.m_dirty_end)
+        return;
+
+    lldb::ProcessSP process_sp = m_process_wp.lock();
+
+    if (process_sp)
+        process_sp->WriteMemory(allocation.m_process_start + allocation.m_dirty_start,
+                                allocation.m_data.GetBytes() + allocation.m_dirty_start,
+                                allocation.m_dirty_end - allocation.m_dirty_start,
+                                error);
+
+    if (lldb_private::Log *log = lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS))
+    {
+        log->Printf("IRMemoryMap::EndBatchedAccess (0x%" PRIx64 ") wrote [0x%" PRIx64 "..0x%" PRIx64 ")",
+                    (uint64_t)process_address,
+                    (uint64_t)allocation.m_process_start + allocation.m_dirty_start,
+                    (uint64_t)allocation.m_process_start + allocation.m_dirty_end);
+    }
+
+    allocation.m_dirty_start = 0;
+    allocation.m_dirty_end = 0;
+}
@@ -1435,10 +1435,28 @@ Materializer::Materialize (lldb::StackFrameSP &frame_sp, IRMemoryMap &map, lldb:
         error.SetErrorString("Couldn't materialize: target doesn't exist");
     }
 
+    // The entities write their members of the struct one by one, build the
+    // struct in the host and write it to the process at the end.
+    const bool batched = map.BeginBatchedAccess(process_address);
+
     for (EntityUP &entity_up : m_entities)
     {
         entity_up->Materialize(frame_sp, map, process_address, error);
 
+        if (!error.Success())
+        {
+            if (batched)
+            {
+                Error end_error;
+                map.EndBatchedAccess(process_address, end_error);
+            }
+            return DematerializerSP();
+        }
+    }
+
+    if (batched)
+    {
+        map.EndBatchedAccess(process_address, error);
         if (!error.Success())
             return DematerializerSP();
     }
@@ -1490,6 +1508,10 @@ Materializer::Dematerializer::Dematerialize (Error &error,
                 entity_up->DumpToLog(*m_map, m_process_address, log);
         }
 
+        // Read the struct the expression filled in once rather than member
+        // by member.
+        const bool batched = m_map->BeginBatchedAccess(m_process_address);
+
         for (EntityUP &entity_up : m_materializer->m_entities)
         {
             entity_up->Dematerialize (frame_sp, *m_map, m_process_address, frame_top, frame_bottom, error);
@@ -1497,6 +1519,14 @@ Materializer::Dematerializer::Dematerialize (Error &error,
             if (!error.Success())
                 break;
         }
+
+        if (batched)
+        {
+            Error end_error;
+            m_map->EndBatchedAccess(m_process_address, end_error);
+            if (error.Success())
+                error = end_error;
+        }
     }
 
     Wipe();
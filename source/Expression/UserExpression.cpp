@@ -22,6 +22,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/Expression/DiagnosticManager.h"
 #include "lldb/Expression/ExpressionSourceCode.h"
@@ -53,6 +54,7 @@ UserExpression::UserExpression (ExecutionContextScope &exe_scope,
                                 ResultType desired_type,
                                 const EvaluateExpressionOptions &options) :
       Expression(exe_scope),
+      m_block(nullptr),
       m_expr_text(expr),
       m_expr_prefix(expr_prefix ? expr_prefix : ""),
       m_language(language),
@@ -73,7 +75,10 @@ UserExpression::InstallContext (ExecutionContext &exe_ctx)
     lldb::StackFrameSP frame_sp = exe_ctx.GetFrameSP();
 
     if (frame_sp)
+    {
         m_address = frame_sp->GetFrameCodeAddress();
+        m_block = frame_sp->GetSymbolContext(lldb::eSymbolContextBlock).block;
+    }
 }
 
 bool
@@ -96,8 +101,17 @@ UserExpression::LockAndCheckContext (ExecutionContext &exe_ctx,
     {
         if (!frame_sp)
             return false;
-        else
-            return (0 == Address::CompareLoadAddress(m_address, frame_sp->GetFrameCodeAddress(), target_sp.get()));
+
+        if (0 == Address::CompareLoadAddress(m_address, frame_sp->GetFrameCodeAddress(), target_sp.get()))
+            return true;
+
+        // The variables the expression uses are looked up in the frame
+        // again each time it runs, so any pc in the block it was parsed
+        // in will do.
+        if (m_block == nullptr || !m_address.GetModule())
+            return false;
+
+        return frame_sp->GetSymbolContext(lldb::eSymbolContextBlock).block == m_block;
     }
 
     return true;
@@ -110,7 +124,11 @@ UserExpression::MatchesContext (ExecutionContext &exe_ctx)
     lldb::ProcessSP process_sp;
     lldb::StackFrameSP frame_sp;
 
-    return LockAndCheckContext(exe_ctx, target_sp, process_sp, frame_sp);
+    if (!LockAndCheckContext(exe_ctx, target_sp, process_sp, frame_sp))
+        return false;
+
+    // An expression parsed without a frame didn't see any local variables.
+    return m_address.IsValid() || !frame_sp;
 }
 
 lldb::addr_t
@@ -162,6 +180,34 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
                                uint32_t line_offset,
                                std::string *fixed_expression,
                                lldb::ModuleSP *jit_module_sp_ptr)
+{
+    IntervalTimer evaluate_timer;
+    const lldb::ExpressionResults execution_results = DoEvaluate (exe_ctx,
+                                                                  options,
+                                                                  expr_cstr,
+                                                                  expr_prefix,
+                                                                  result_valobj_sp,
+                                                                  error,
+                                                                  line_offset,
+                                                                  fixed_expression,
+                                                                  jit_module_sp_ptr);
+    Target *target = exe_ctx.GetTargetPtr();
+    if (target)
+        target->RecordExpressionEvaluation (execution_results == lldb::eExpressionCompleted,
+                                            evaluate_timer.GetElapsedNanoSeconds());
+    return execution_results;
+}
+
+lldb::ExpressionResults
+UserExpression::DoEvaluate (ExecutionContext &exe_ctx,
+                            const EvaluateExpressionOptions& options,
+                            const char *expr_cstr,
+                            const char *expr_prefix,
+                            lldb::ValueObjectSP &result_valobj_sp,
+                            Error &error,
+                            uint32_t line_offset,
+                            std::string *fixed_expression,
+                            lldb::ModuleSP *jit_module_sp_ptr)
 {
     Log *log(lldb_private::GetLogIfAnyCategoriesSet (LIBLLDB_LOG_EXPRESSIONS | LIBLLDB_LOG_STEP));
 
@@ -227,24 +273,58 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
             language = frame->GetLanguage();
     }
 
-    lldb::UserExpressionSP user_expression_sp(target->GetUserExpressionForLanguage (expr_cstr,
-                                                                                    full_prefix,
-                                                                                    language,
-                                                                                    desired_type,
-                                                                                    options,
-                                                                                    error));
-    if (error.Fail())
+    const bool keep_expression_in_memory = true;
+    const bool generate_debug_info = options.GetGenerateDebugInfo();
+
+    // Expressions that are evaluated again in the same block reuse the
+    // parsed and JITted code. Expressions that use persistent variables
+    // ($foo) aren't cached since what those refer to can change, nor are
+    // ones that define anything.
+    const bool use_cache = execution_policy != eExecutionPolicyTopLevel &&
+                           !generate_debug_info &&
+                           !options.GetREPLEnabled() &&
+                           ::strchr(expr_cstr, '$') == nullptr;
+    std::string cache_key;
+    lldb::UserExpressionSP user_expression_sp;
+
+    if (use_cache)
+    {
+        StreamString key_strm;
+        key_strm.Printf("%u %u %u ", language, desired_type, execution_policy);
+        cache_key.assign(key_strm.GetString());
+        if (full_prefix)
+            cache_key.append(full_prefix);
+        cache_key.push_back('\0');
+        cache_key.append(expr_cstr);
+
+        user_expression_sp = target->FindCachedUserExpression(cache_key, exe_ctx);
+    }
+
+    const bool is_cached = (bool)user_expression_sp;
+
+    if (is_cached)
     {
         if (log)
-            log->Printf ("== [UserExpression::Evaluate] Getting expression: %s ==", error.AsCString());
-        return lldb::eExpressionSetupError;
+            log->Printf("== [UserExpression::Evaluate] Reusing the parsed expression %s ==", expr_cstr);
     }
+    else
+    {
+        user_expression_sp.reset(target->GetUserExpressionForLanguage (expr_cstr,
+                                                                       full_prefix,
+                                                                       language,
+                                                                       desired_type,
+                                                                       options,
+                                                                       error));
+        if (error.Fail())
+        {
+            if (log)
+                log->Printf ("== [UserExpression::Evaluate] Getting expression: %s ==", error.AsCString());
+            return lldb::eExpressionSetupError;
+        }
 
-    if (log)
-        log->Printf("== [UserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
-
-    const bool keep_expression_in_memory = true;
-    const bool generate_debug_info = options.GetGenerateDebugInfo();
+        if (log)
+            log->Printf("== [UserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+    }
 
     if (options.InvokeCancelCallback (lldb::eExpressionEvaluationParse))
     {
@@ -255,11 +335,11 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
 
     DiagnosticManager diagnostic_manager;
 
-    bool parse_success = user_expression_sp->Parse(diagnostic_manager,
-                                                   exe_ctx,
-                                                   execution_policy,
-                                                   keep_expression_in_memory,
-                                                   generate_debug_info);
+    bool parse_success = is_cached || user_expression_sp->Parse(diagnostic_manager,
+                                                                exe_ctx,
+                                                                execution_policy,
+                                                                keep_expression_in_memory,
+                                                                generate_debug_info);
     
     // Calculate the fixed expression always, since we need it for errors.
     std::string tmp_fixed_expression;
@@ -317,6 +397,9 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
         }
     }
     
+    if (parse_success && use_cache && !is_cached && fixed_expression->empty())
+        target->CacheUserExpression(cache_key, user_expression_sp);
+
     if (parse_success)
     {
         // If a pointer to a lldb::ModuleSP was passed in, return the JIT'ed module if one was created
@@ -336,6 +419,9 @@ UserExpression::Evaluate (ExecutionContext &exe_ctx,
         }
         else if (execution_policy == eExecutionPolicyTopLevel)
         {
+            // The new definitions may change what cached expressions
+            // refer to.
+            target->ClearUserExpressionCache();
             error.SetError(UserExpression::kNoResult, lldb::eErrorTypeGeneric);
             return lldb::eExpressionCompleted;
         }
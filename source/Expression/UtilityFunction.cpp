@@ -14,10 +14,12 @@
 #endif
 
 // C++ Includes
+#include <algorithm>
 
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Expression/DiagnosticManager.h"
@@ -26,6 +28,8 @@
 #include "lldb/Expression/IRExecutionUnit.h"
 #include "lldb/Expression/UtilityFunction.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
@@ -67,6 +71,62 @@ UtilityFunction::~UtilityFunction ()
     
 }
 
+bool
+UtilityFunction::FindPrecompiledFunction (ExecutionContext &exe_ctx)
+{
+    Process *process = exe_ctx.GetProcessPtr();
+    if (!process || m_function_name.empty())
+        return false;
+
+    process->LoadExpressionHelperLibrary();
+
+    Target &target = process->GetTarget();
+    SymbolContextList sc_list;
+    const bool include_symbols = true;
+    const bool include_inlines = false;
+    const bool append = false;
+    target.GetImages().FindFunctions(ConstString(m_function_name.c_str()),
+                                     eFunctionNameTypeFull,
+                                     include_symbols,
+                                     include_inlines,
+                                     append,
+                                     sc_list);
+
+    SymbolContext sc;
+    for (size_t i = 0; i < sc_list.GetSize(); ++i)
+    {
+        if (!sc_list.GetContextAtIndex(i, sc) || !sc.module_sp)
+            continue;
+
+        // Skip the modules of functions lldb itself JIT compiled, the code
+        // goes away with them.
+        ObjectFile *object_file = sc.module_sp->GetObjectFile();
+        if (object_file == nullptr || object_file->GetType() == ObjectFile::eTypeJIT)
+            continue;
+
+        AddressRange range;
+        if (!sc.GetAddressRange(eSymbolContextFunction | eSymbolContextSymbol, 0, false, range))
+            continue;
+
+        const addr_t load_addr = range.GetBaseAddress().GetCallableLoadAddress(&target);
+        if (load_addr == LLDB_INVALID_ADDRESS)
+            continue;
+
+        m_jit_start_addr = load_addr;
+        m_jit_end_addr = load_addr + std::max<addr_t>(range.GetByteSize(), 1);
+        m_jit_process_wp = process->shared_from_this();
+
+        Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+        if (log)
+            log->Printf("Using the precompiled %s at 0x%" PRIx64 " in %s",
+                        m_function_name.c_str(),
+                        load_addr,
+                        sc.module_sp->GetFileSpec().GetPath().c_str());
+        return true;
+    }
+    return false;
+}
+
 // FIXME: We should check that every time this is called it is called with the same return type & arguments...
 
 FunctionCaller *
@@ -0,0 +1,445 @@
+//===-- DebugFileIndex.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <inttypes.h>
+
+// C++ Includes
+// Other libraries and framework includes
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/FileSystem.h"
+
+#if defined (HAVE_LIBCURL)
+#include <curl/curl.h>
+#endif
+
+// Project includes
+#include "lldb/Host/DebugFileIndex.h"
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/FileSpecList.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/Timer.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/Host.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    const char *g_index_magic = "lldb-debug-file-index 1";
+
+    uint64_t
+    GetModificationTime (const FileSpec &file_spec)
+    {
+        return file_spec.GetModificationTime().GetAsSecondsSinceJan1_1970();
+    }
+
+    // Writes to a temporary file that is renamed into place, so other
+    // sessions never see a partially written file.
+    Error
+    WriteFileAtomically (const FileSpec &file_spec, const void *bytes, size_t length)
+    {
+        FileSpec dir_spec (file_spec.GetDirectory().GetCString(), false);
+        if (!dir_spec.Exists())
+        {
+            Error error = FileSystem::MakeDirectory (dir_spec, eFilePermissionsDirectoryDefault);
+            if (error.Fail())
+                return error;
+        }
+
+        const std::string path = file_spec.GetPath();
+        StreamString tmp_path;
+        tmp_path.Printf ("%s.%" PRIu64 ".temp", path.c_str(), (uint64_t)Host::GetCurrentProcessID());
+        Error error;
+        {
+            File file (tmp_path.GetData(),
+                       File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec);
+            size_t num_bytes = length;
+            if (file.IsValid())
+                error = file.Write (bytes, num_bytes);
+            else
+                error.SetErrorToErrno();
+            if (error.Success() && num_bytes != length)
+                error.SetErrorString ("short write");
+        }
+
+        if (error.Success())
+        {
+            const auto err_code = llvm::sys::fs::rename (tmp_path.GetData(), path.c_str());
+            if (err_code)
+                error.SetErrorString (err_code.message().c_str());
+        }
+        if (error.Fail())
+            llvm::sys::fs::remove (tmp_path.GetData());
+        return error;
+    }
+
+    bool
+    IsHexString (llvm::StringRef str)
+    {
+        return !str.empty() && str.find_first_not_of ("0123456789abcdef") == llvm::StringRef::npos;
+    }
+
+    // Adds the build IDs of the xx/yyyy.debug files of a .build-id
+    // subdirectory.
+    void
+    IndexBuildIDDirectory (const std::string &dir_path, const std::string &dir_name, std::set<std::string> &build_ids)
+    {
+        FileSpec::ForEachItemInDirectory (dir_path.c_str(),
+                                          [&dir_name, &build_ids](FileSpec::FileType file_type, const FileSpec &spec)
+                                          {
+                                              if (file_type == FileSpec::eFileTypeRegular || file_type == FileSpec::eFileTypeSymbolicLink)
+                                              {
+                                                  llvm::StringRef name (spec.GetFilename().GetStringRef());
+                                                  if (name.endswith (".debug"))
+                                                  {
+                                                      std::string build_id = dir_name + name.drop_back (strlen (".debug")).lower();
+                                                      if (IsHexString (build_id))
+                                                          build_ids.insert (build_id);
+                                                  }
+                                              }
+                                              return FileSpec::eEnumerateDirectoryResultNext;
+                                          });
+    }
+
+#if defined (HAVE_LIBCURL)
+    size_t
+    CurlWriteCallback (char *ptr, size_t size, size_t nmemb, void *baton)
+    {
+        File *file = static_cast<File *>(baton);
+        size_t num_bytes = size * nmemb;
+        Error error = file->Write (ptr, num_bytes);
+        return error.Success() ? num_bytes : 0;
+    }
+#endif
+}
+
+DebugFileIndex &
+DebugFileIndex::GetInstance ()
+{
+    static DebugFileIndex *g_instance = new DebugFileIndex();
+    return *g_instance;
+}
+
+DebugFileIndex::DebugFileIndex () :
+    m_mutex (),
+    m_roots (),
+    m_missing_build_ids ()
+{
+}
+
+std::string
+DebugFileIndex::GetBuildIDString (const UUID &build_id)
+{
+    return llvm::StringRef (build_id.GetAsString("")).lower();
+}
+
+FileSpec
+DebugFileIndex::FindDebugFile (const UUID &build_id, const FileSpecList &debug_roots, const FileSpec &cache_dir)
+{
+    if (!build_id.IsValid())
+        return FileSpec();
+
+    const std::string build_id_str = GetBuildIDString (build_id);
+
+    std::lock_guard<std::mutex> guard (m_mutex);
+    const size_t num_roots = debug_roots.GetSize();
+    for (size_t idx = 0; idx < num_roots; ++idx)
+    {
+        FileSpec root_spec = debug_roots.GetFileSpecAtIndex (idx);
+        root_spec.ResolvePath();
+        root_spec.AppendPathComponent (".build-id");
+        const std::string build_id_dir = root_spec.GetPath();
+
+        auto pos = m_roots.find (build_id_dir);
+        if (pos == m_roots.end())
+        {
+            pos = m_roots.emplace (build_id_dir, RootIndex()).first;
+            UpdateRootIndex (build_id_dir, cache_dir, pos->second);
+        }
+
+        if (pos->second.build_ids.count (build_id_str))
+        {
+            StreamString path;
+            path.Printf ("%s/%s/%s.debug", build_id_dir.c_str(), build_id_str.substr (0, 2).c_str(), build_id_str.substr (2).c_str());
+            return FileSpec (path.GetData(), false);
+        }
+    }
+    return FileSpec();
+}
+
+bool
+DebugFileIndex::UpdateRootIndex (const std::string &build_id_dir, const FileSpec &cache_dir, RootIndex &index)
+{
+    FileSpec build_id_dir_spec (build_id_dir.c_str(), false);
+    if (!build_id_dir_spec.IsDirectory())
+        return false;
+
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "DebugFileIndex::UpdateRootIndex (%s)", build_id_dir.c_str());
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_HOST));
+
+    const FileSpec index_file_spec (GetIndexFileSpec (build_id_dir, cache_dir));
+    RootIndex saved_index;
+    const bool loaded = index_file_spec && LoadRootIndex (index_file_spec, saved_index);
+
+    // The modification time of the .build-id directory tells whether
+    // subdirectories were added or removed, those of the subdirectories
+    // whether debug files were.
+    bool changed = !loaded;
+    index.mod_time = GetModificationTime (build_id_dir_spec);
+    if (loaded && saved_index.mod_time == index.mod_time)
+    {
+        for (const auto &entry : saved_index.dir_mod_times)
+            index.dir_mod_times[entry.first] = 0;
+    }
+    else
+    {
+        changed = true;
+        FileSpec::ForEachItemInDirectory (build_id_dir.c_str(),
+                                          [&index](FileSpec::FileType file_type, const FileSpec &spec)
+                                          {
+                                              llvm::StringRef name (spec.GetFilename().GetStringRef());
+                                              if (file_type == FileSpec::eFileTypeDirectory && name.size() == 2 && IsHexString (name.lower()))
+                                                  index.dir_mod_times[name.lower()] = 0;
+                                              return FileSpec::eEnumerateDirectoryResultNext;
+                                          });
+    }
+
+    uint32_t num_dirs_read = 0;
+    for (auto &entry : index.dir_mod_times)
+    {
+        const std::string dir_path = build_id_dir + "/" + entry.first;
+        entry.second = GetModificationTime (FileSpec (dir_path.c_str(), false));
+
+        auto saved_pos = saved_index.dir_mod_times.find (entry.first);
+        if (loaded && saved_pos != saved_index.dir_mod_times.end() && saved_pos->second == entry.second)
+        {
+            // Build IDs are sorted, so those of a subdirectory are next to
+            // each other.
+            auto begin = saved_index.build_ids.lower_bound (entry.first);
+            auto end = begin;
+            while (end != saved_index.build_ids.end() && end->compare (0, 2, entry.first) == 0)
+                ++end;
+            index.build_ids.insert (begin, end);
+        }
+        else
+        {
+            changed = true;
+            ++num_dirs_read;
+            IndexBuildIDDirectory (dir_path, entry.first, index.build_ids);
+        }
+    }
+
+    if (log)
+        log->Printf ("DebugFileIndex::UpdateRootIndex (%s) %" PRIu64 " debug files, read %u of %" PRIu64 " directories",
+                     build_id_dir.c_str(), (uint64_t)index.build_ids.size(), num_dirs_read, (uint64_t)index.dir_mod_times.size());
+
+    if (changed && index_file_spec)
+    {
+        Error error = SaveRootIndex (index_file_spec, index);
+        if (error.Fail() && log)
+            log->Printf ("DebugFileIndex::UpdateRootIndex failed to save '%s': %s",
+                         index_file_spec.GetPath().c_str(), error.AsCString());
+    }
+    return true;
+}
+
+FileSpec
+DebugFileIndex::GetIndexFileSpec (const std::string &build_id_dir, const FileSpec &cache_dir)
+{
+    if (!cache_dir)
+        return FileSpec();
+
+    std::string file_name (build_id_dir);
+    for (char &c : file_name)
+    {
+        if (c == '/' || c == '\\' || c == ':')
+            c = '_';
+    }
+    file_name += ".index";
+
+    FileSpec index_file_spec (cache_dir);
+    index_file_spec.AppendPathComponent (file_name.c_str());
+    return index_file_spec;
+}
+
+bool
+DebugFileIndex::LoadRootIndex (const FileSpec &index_file_spec, RootIndex &index)
+{
+    if (!index_file_spec.Exists())
+        return false;
+
+    DataBufferSP data_sp (index_file_spec.ReadFileContents());
+    if (!data_sp)
+        return false;
+
+    // The format is a line with the magic, a line with the modification
+    // time of the .build-id directory, and then one line per subdirectory
+    // ("d <name> <mod time>") and per debug file ("f <build id>").
+    llvm::StringRef contents ((const char *)data_sp->GetBytes(), data_sp->GetByteSize());
+    llvm::StringRef line;
+    std::tie (line, contents) = contents.split ('\n');
+    if (line != g_index_magic)
+        return false;
+    std::tie (line, contents) = contents.split ('\n');
+    if (line.getAsInteger (10, index.mod_time))
+        return false;
+
+    while (!contents.empty())
+    {
+        std::tie (line, contents) = contents.split ('\n');
+        if (line.startswith ("d "))
+        {
+            llvm::StringRef name, mod_time_str;
+            std::tie (name, mod_time_str) = line.drop_front (2).split (' ');
+            uint64_t mod_time = 0;
+            if (name.size() != 2 || mod_time_str.getAsInteger (10, mod_time))
+                return false;
+            index.dir_mod_times[name.str()] = mod_time;
+        }
+        else if (line.startswith ("f "))
+        {
+            llvm::StringRef build_id (line.drop_front (2));
+            if (build_id.size() < 3 || !IsHexString (build_id))
+                return false;
+            index.build_ids.insert (build_id.str());
+        }
+        else if (!line.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+Error
+DebugFileIndex::SaveRootIndex (const FileSpec &index_file_spec, const RootIndex &index)
+{
+    StreamString strm;
+    strm.Printf ("%s\n%" PRIu64 "\n", g_index_magic, index.mod_time);
+    for (const auto &entry : index.dir_mod_times)
+        strm.Printf ("d %s %" PRIu64 "\n", entry.first.c_str(), entry.second);
+    for (const std::string &build_id : index.build_ids)
+        strm.Printf ("f %s\n", build_id.c_str());
+    return WriteFileAtomically (index_file_spec, strm.GetData(), strm.GetSize());
+}
+
+FileSpec
+DebugFileIndex::DownloadDebugFile (const UUID &build_id,
+                                   const std::vector<std::string> &server_urls,
+                                   const FileSpec &cache_dir,
+                                   Error &error)
+{
+    error.Clear();
+    if (!build_id.IsValid() || !cache_dir)
+    {
+        error.SetErrorString ("a build ID and a cache directory are needed to download debug files");
+        return FileSpec();
+    }
+
+    // The cache is content addressed, whatever is stored under a build ID
+    // is the debug file for it.
+    const std::string build_id_str = GetBuildIDString (build_id);
+    FileSpec cached_file_spec (cache_dir);
+    cached_file_spec.AppendPathComponent (build_id_str.c_str());
+    cached_file_spec.AppendPathComponent ("debuginfo");
+    if (cached_file_spec.Exists())
+        return cached_file_spec;
+
+    if (server_urls.empty())
+    {
+        error.SetErrorString ("no symbol servers");
+        return FileSpec();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard (m_mutex);
+        if (m_missing_build_ids.count (build_id_str))
+        {
+            error.SetErrorStringWithFormat ("no symbol server has build ID %s", build_id_str.c_str());
+            return FileSpec();
+        }
+    }
+
+#if defined (HAVE_LIBCURL)
+    static std::once_flag g_curl_once_flag;
+    std::call_once (g_curl_once_flag, []() { curl_global_init (CURL_GLOBAL_DEFAULT); });
+
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "DebugFileIndex::DownloadDebugFile (%s)", build_id_str.c_str());
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_HOST));
+
+    FileSpec dir_spec (cached_file_spec.GetDirectory().GetCString(), false);
+    if (!dir_spec.Exists())
+    {
+        error = FileSystem::MakeDirectory (dir_spec, eFilePermissionsDirectoryDefault);
+        if (error.Fail())
+            return FileSpec();
+    }
+
+    const std::string cached_path = cached_file_spec.GetPath();
+    StreamString tmp_path;
+    tmp_path.Printf ("%s.%" PRIu64 ".temp", cached_path.c_str(), (uint64_t)Host::GetCurrentProcessID());
+
+    for (const std::string &server_url : server_urls)
+    {
+        llvm::StringRef base_url (server_url);
+        while (base_url.endswith ("/"))
+            base_url = base_url.drop_back();
+        const std::string url = base_url.str() + "/buildid/" + build_id_str + "/debuginfo";
+
+        CURLcode result = CURLE_FAILED_INIT;
+        {
+            File file (tmp_path.GetData(),
+                       File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec);
+            CURL *curl = curl_easy_init();
+            if (file.IsValid() && curl)
+            {
+                curl_easy_setopt (curl, CURLOPT_URL, url.c_str());
+                curl_easy_setopt (curl, CURLOPT_FAILONERROR, 1L);
+                curl_easy_setopt (curl, CURLOPT_FOLLOWLOCATION, 1L);
+                curl_easy_setopt (curl, CURLOPT_CONNECTTIMEOUT, 10L);
+                curl_easy_setopt (curl, CURLOPT_NOSIGNAL, 1L);
+                curl_easy_setopt (curl, CURLOPT_WRITEFUNCTION, CurlWriteCallback);
+                curl_easy_setopt (curl, CURLOPT_WRITEDATA, &file);
+                result = curl_easy_perform (curl);
+            }
+            if (curl)
+                curl_easy_cleanup (curl);
+        }
+
+        if (log)
+            log->Printf ("DebugFileIndex::DownloadDebugFile %s: %s", url.c_str(), curl_easy_strerror (result));
+
+        if (result == CURLE_OK)
+        {
+            const auto err_code = llvm::sys::fs::rename (tmp_path.GetData(), cached_path.c_str());
+            if (!err_code)
+                return cached_file_spec;
+            error.SetErrorString (err_code.message().c_str());
+        }
+        else
+        {
+            error.SetErrorStringWithFormat ("%s: %s", url.c_str(), curl_easy_strerror (result));
+        }
+        llvm::sys::fs::remove (tmp_path.GetData());
+    }
+
+    std::lock_guard<std::mutex> guard (m_mutex);
+    m_missing_build_ids.insert (build_id_str);
+#else
+    error.SetErrorString ("lldb was built without libcurl, can't download debug files");
+#endif
+    return FileSpec();
+}
@@ -17,6 +17,7 @@
 #ifndef _MSC_VER
 #include <libgen.h>
 #endif
+#include <mutex>
 #include <set>
 #include <string.h>
 #include <fstream>
@@ -38,6 +39,7 @@
 #include "lldb/Host/Host.h"
 #include "lldb/Utility/CleanUp.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/FileSystem.h"
@@ -665,6 +667,35 @@ FileSpec::RemoveBackupDots (const ConstString &input_const_str, ConstString &res
     if (!input || input[0] == '\0')
         return;
 
+    // Most directories have no backup dots, and the ones that do are
+    // compared over and over when matching support files, so remember the
+    // result for each uniqued directory instead of building it again.
+    if (strstr(input, "..") == nullptr)
+    {
+        result_const_str = input_const_str;
+        return;
+    }
+    static std::mutex g_without_backup_dots_mutex;
+    static llvm::DenseMap<const char *, ConstString> g_without_backup_dots;
+    {
+        std::lock_guard<std::mutex> guard(g_without_backup_dots_mutex);
+        auto pos = g_without_backup_dots.find(input);
+        if (pos != g_without_backup_dots.end())
+        {
+            result_const_str = pos->second;
+            return;
+        }
+    }
+    RemoveBackupDotsUncached(input_const_str, result_const_str);
+    std::lock_guard<std::mutex> guard(g_without_backup_dots_mutex);
+    g_without_backup_dots[input] = result_const_str;
+}
+
+void
+FileSpec::RemoveBackupDotsUncached (const ConstString &input_const_str, ConstString &result_const_str)
+{
+    const char *input = input_const_str.GetCString();
+
     const char win_sep = '\\';
     const char unix_sep = '/';
     char found_sep;
@@ -1054,13 +1085,13 @@ FileSpec::GetFileNameStrippingExtension () const
 // verified using the DataBuffer::GetByteSize() function.
 //------------------------------------------------------------------
 DataBufferSP
-FileSpec::MemoryMapFileContents(off_t file_offset, size_t file_size) const
+FileSpec::MemoryMapFileContents(off_t file_offset, size_t file_size, bool writeable) const
 {
     DataBufferSP data_sp;
     std::unique_ptr<DataBufferMemoryMap> mmap_data(new DataBufferMemoryMap());
     if (mmap_data.get())
     {
-        const size_t mapped_length = mmap_data->MemoryMapFromFileSpec (this, file_offset, file_size);
+        const size_t mapped_length = mmap_data->MemoryMapFromFileSpec (this, file_offset, file_size, writeable);
         if (((file_size == SIZE_MAX) && (mapped_length > 0)) || (mapped_length >= file_size))
             data_sp.reset(mmap_data.release());
     }
@@ -1068,10 +1099,10 @@ FileSpec::MemoryMapFileContents(off_t file_offset, size_t file_size) const
 }
 
 DataBufferSP
-FileSpec::MemoryMapFileContentsIfLocal(off_t file_offset, size_t file_size) const
+FileSpec::MemoryMapFileContentsIfLocal(off_t file_offset, size_t file_size, bool writeable) const
 {
     if (FileSystem::IsLocal(*this))
-        return MemoryMapFileContents(file_offset, file_size);
+        return MemoryMapFileContents(file_offset, file_size, writeable);
     else
         return ReadFileContents(file_offset, file_size, NULL);
 }
@@ -9,16 +9,26 @@
 
 #include "lldb/Host/common/NativeBreakpoint.h"
 
+#include <algorithm>
+
 #include "lldb/lldb-defines.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Host/common/NativeProcessProtocol.h"
+#include "lldb/Host/common/NativeRegisterContext.h"
+#include "lldb/Host/common/NativeThreadProtocol.h"
 
 using namespace lldb_private;
 
 NativeBreakpoint::NativeBreakpoint (lldb::addr_t addr) :
     m_addr (addr),
     m_ref_count (1),
-    m_enabled (true)
+    m_enabled (true),
+    m_conditions (),
+    m_counting (false),
+    m_hit_count (0),
+    m_thread_ids ()
 {
     assert (addr != LLDB_INVALID_ADDRESS && "breakpoint set for invalid address");
 }
@@ -114,3 +124,78 @@ NativeBreakpoint::Disable ()
 
     return error;
 }
+
+bool
+NativeBreakpoint::IsForThread (lldb::tid_t tid) const
+{
+    return m_thread_ids.empty () || std::find (m_thread_ids.begin (), m_thread_ids.end (), tid) != m_thread_ids.end ();
+}
+
+bool
+NativeBreakpoint::ShouldStop (NativeThreadProtocol &thread)
+{
+    if (m_conditions.empty ())
+        return true;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
+    NativeProcessProtocolSP process_sp = thread.GetProcess ();
+    lldb::ByteOrder byte_order = lldb::eByteOrderInvalid;
+    if (!reg_ctx_sp || !process_sp || !process_sp->GetByteOrder (byte_order))
+        return true;
+
+    // The register numbers of the expressions are the register indexes we
+    // hand out in qRegisterInfo and the p/P packets.
+    AgentExpression::ReadRegisterCallback read_register =
+        [&reg_ctx_sp](uint32_t reg_num, uint64_t &value) -> bool
+        {
+            const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (reg_num);
+            if (!reg_info)
+                return false;
+            RegisterValue reg_value;
+            if (reg_ctx_sp->ReadRegister (reg_info, reg_value).Fail ())
+                return false;
+            bool success = false;
+            value = reg_value.GetAsUInt64 (0, &success);
+            return success;
+        };
+
+    AgentExpression::ReadMemoryCallback read_memory =
+        [&process_sp, byte_order](lldb::addr_t addr, size_t size, uint64_t &value) -> bool
+        {
+            uint8_t bytes[8];
+            size_t bytes_read = 0;
+            if (size > sizeof (bytes) ||
+                process_sp->ReadMemoryWithoutTrap (addr, bytes, size, bytes_read).Fail () ||
+                bytes_read != size)
+                return false;
+            value = 0;
+            for (size_t i = 0; i < size; ++i)
+            {
+                const size_t idx = byte_order == lldb::eByteOrderLittle ? size - 1 - i : i;
+                value = (value << 8) | bytes[idx];
+            }
+            return true;
+        };
+
+    for (const AgentExpression &condition : m_conditions)
+    {
+        uint64_t result = 0;
+        Error error = condition.Evaluate (read_register, read_memory, result);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " tid %" PRIu64 " condition failed to evaluate, stopping: %s",
+                             __FUNCTION__, m_addr, thread.GetID (), error.AsCString ());
+            return true;
+        }
+        if (result != 0)
+            return true;
+    }
+
+    if (log)
+        log->Printf ("NativeBreakpoint::%s addr = 0x%" PRIx64 " tid %" PRIu64 " conditions false, not stopping",
+                     __FUNCTION__, m_addr, thread.GetID ());
+    return false;
+}
@@ -218,3 +218,11 @@ NativeBreakpointList::RemoveTrapsFromBuffer(lldb::addr_t addr, void *buf, size_t
     }
     return Error();
 }
+
+void
+NativeBreakpointList::ForEach (std::function<void (const NativeBreakpointSP &breakpoint_sp)> const &callback)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    for (const auto &map : m_breakpoints)
+        callback (map.second);
+}
@@ -41,7 +41,9 @@ NativeProcessProtocol::NativeProcessProtocol(lldb::pid_t pid)
       m_breakpoint_list(),
       m_watchpoint_list(),
       m_terminal_fd(-1),
-      m_stop_id(0)
+      m_stop_id(0),
+      m_non_stop_mode(false),
+      m_signals_to_ignore()
 {
 }
 
@@ -57,6 +59,25 @@ NativeProcessProtocol::Interrupt ()
 #endif
 }
 
+lldb_private::Error
+NativeProcessProtocol::SetNonStopMode (bool enable)
+{
+    // Default: only all-stop mode is supported.
+    if (enable)
+        return Error ("non-stop mode is not supported");
+    m_non_stop_mode = false;
+    return Error ();
+}
+
+lldb_private::Error
+NativeProcessProtocol::IgnoreSignals (llvm::ArrayRef<int> signals)
+{
+    m_signals_to_ignore.clear ();
+    for (int signo : signals)
+        m_signals_to_ignore.insert (signo);
+    return Error ();
+}
+
 lldb_private::Error
 NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
 {
@@ -64,6 +85,44 @@ NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegion
     return Error ("not implemented");
 }
 
+lldb_private::Error
+NativeProcessProtocol::ReadMemoryRanges (std::vector<MemoryReadRange> &ranges)
+{
+    for (MemoryReadRange &range : ranges)
+    {
+        range.bytes_read = 0;
+        if (range.size > 0)
+            ReadMemory (range.addr, range.buf, range.size, range.bytes_read);
+    }
+    return Error ();
+}
+
+lldb_private::Error
+NativeProcessProtocol::ReadMemoryRangesWithoutTrap (std::vector<MemoryReadRange> &ranges)
+{
+    Error error = ReadMemoryRanges (ranges);
+    if (error.Fail ())
+        return error;
+
+    for (const MemoryReadRange &range : ranges)
+    {
+        if (range.bytes_read == 0)
+            continue;
+        error = m_breakpoint_list.RemoveTrapsFromBuffer (range.addr, range.buf, range.bytes_read);
+        if (error.Fail ())
+            return error;
+    }
+    return error;
+}
+
+lldb_private::Error
+NativeProcessProtocol::GetLoadedSVR4Libraries (std::vector<SVR4LibraryInfo> &library_list, lldb::addr_t &main_link_map)
+{
+    library_list.clear ();
+    main_link_map = LLDB_INVALID_ADDRESS;
+    return Error ("SVR4 library lists are not supported by this process");
+}
+
 bool
 NativeProcessProtocol::GetExitStatus (ExitType *exit_type, int *status, std::string &exit_description)
 {
@@ -297,6 +356,38 @@ NativeProcessProtocol::RemoveWatchpoint (lldb::addr_t addr)
     return overall_error.Fail() ? overall_error : error;
 }
 
+Error
+NativeProcessProtocol::StartBranchTrace (lldb::tid_t tid, size_t buffer_size)
+{
+    return Error ("branch tracing is not supported by this process");
+}
+
+Error
+NativeProcessProtocol::StopBranchTrace (lldb::tid_t tid)
+{
+    return Error ("branch tracing is not supported by this process");
+}
+
+Error
+NativeProcessProtocol::GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches)
+{
+    branches.clear ();
+    return Error ("branch tracing is not supported by this process");
+}
+
+Error
+NativeProcessProtocol::SaveCheckpoint (uint32_t &checkpoint_id)
+{
+    checkpoint_id = 0;
+    return Error ("checkpoints are not supported by this process");
+}
+
+Error
+NativeProcessProtocol::RestoreCheckpoint (uint32_t checkpoint_id)
+{
+    return Error ("checkpoints are not supported by this process");
+}
+
 bool
 NativeProcessProtocol::RegisterNativeDelegate (NativeDelegate &native_delegate)
 {
@@ -360,6 +451,18 @@ NativeProcessProtocol::NotifyDidExec ()
     }
 }
 
+void
+NativeProcessProtocol::NotifyThreadStopped (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s - pid %" PRIu64 " tid %" PRIu64 " stopped", __FUNCTION__, GetID (), tid);
+
+    std::lock_guard<std::recursive_mutex> guard(m_delegates_mutex);
+    for (auto native_delegate: m_delegates)
+        native_delegate->ThreadStopped (this, tid);
+}
+
 
 Error
 NativeProcessProtocol::SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_hint)
@@ -379,6 +482,24 @@ NativeProcessProtocol::RemoveBreakpoint (lldb::addr_t addr)
     return m_breakpoint_list.DecRef (addr);
 }
 
+void
+NativeProcessProtocol::SetBreakpoints (const std::vector<std::pair<lldb::addr_t, uint32_t>> &breakpoints, std::vector<Error> &errors)
+{
+    errors.clear ();
+    errors.reserve (breakpoints.size ());
+    for (const auto &breakpoint : breakpoints)
+        errors.push_back (SetBreakpoint (breakpoint.first, breakpoint.second, false));
+}
+
+void
+NativeProcessProtocol::RemoveBreakpoints (const std::vector<std::pair<lldb::addr_t, uint32_t>> &breakpoints, std::vector<Error> &errors)
+{
+    errors.clear ();
+    errors.reserve (breakpoints.size ());
+    for (const auto &breakpoint : breakpoints)
+        errors.push_back (RemoveBreakpoint (breakpoint.first));
+}
+
 Error
 NativeProcessProtocol::EnableBreakpoint (lldb::addr_t addr)
 {
@@ -391,6 +512,58 @@ NativeProcessProtocol::DisableBreakpoint (lldb::addr_t addr)
     return m_breakpoint_list.DisableBreakpoint (addr);
 }
 
+Error
+NativeProcessProtocol::SetBreakpointConditions (lldb::addr_t addr, const std::vector<AgentExpression> &conditions)
+{
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Fail ())
+        return error;
+    if (!breakpoint_sp->IsSoftwareBreakpoint ())
+        return Error ("conditions are only supported on software breakpoints");
+
+    breakpoint_sp->SetConditions (conditions);
+    return Error ();
+}
+
+Error
+NativeProcessProtocol::SetBreakpointCounting (lldb::addr_t addr, bool counting)
+{
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Fail ())
+        return error;
+    if (!breakpoint_sp->IsSoftwareBreakpoint ())
+        return Error ("only software breakpoints can count hits");
+
+    breakpoint_sp->SetCounting (counting);
+    return Error ();
+}
+
+Error
+NativeProcessProtocol::SetBreakpointThreads (lldb::addr_t addr, const std::vector<lldb::tid_t> &thread_ids)
+{
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Fail ())
+        return error;
+    if (!breakpoint_sp->IsSoftwareBreakpoint ())
+        return Error ("only software breakpoints can be limited to threads");
+
+    breakpoint_sp->SetThreadIDs (thread_ids);
+    return Error ();
+}
+
+void
+NativeProcessProtocol::GetBreakpointHitCounts (std::vector<std::pair<lldb::addr_t, uint64_t>> &hit_counts)
+{
+    hit_counts.clear ();
+    m_breakpoint_list.ForEach ([&hit_counts](const NativeBreakpointSP &breakpoint_sp) {
+        if (breakpoint_sp->IsCounting ())
+            hit_counts.push_back (std::make_pair (breakpoint_sp->GetAddress (), breakpoint_sp->GetHitCount ()));
+    });
+}
+
 lldb::StateType
 NativeProcessProtocol::GetState () const
 {
@@ -307,6 +307,32 @@ NativeRegisterContext::ClearAllHardwareWatchpoints ()
     return Error ("not implemented");
 }
 
+Error
+NativeRegisterContext::SetHardwareWatchpoints (const std::vector<NativeWatchpoint> &watchpoints, std::vector<uint32_t> &wp_indexes)
+{
+    wp_indexes.clear();
+    if (watchpoints.size() > NumSupportedHardwareWatchpoints())
+        return Error ("not enough hardware watchpoints for %" PRIu64 " watchpoints", (uint64_t)watchpoints.size());
+
+    Error error = ClearAllHardwareWatchpoints ();
+    if (error.Fail())
+        return error;
+
+    for (const NativeWatchpoint &wp : watchpoints)
+    {
+        const uint32_t wp_index = SetHardwareWatchpoint (wp.m_addr, wp.m_size, wp.m_watch_flags);
+        if (wp_index == LLDB_INVALID_INDEX32)
+        {
+            error.SetErrorStringWithFormat ("setting the hardware watchpoint at 0x%" PRIx64 " failed", wp.m_addr);
+            ClearAllHardwareWatchpoints ();
+            wp_indexes.clear();
+            return error;
+        }
+        wp_indexes.push_back (wp_index);
+    }
+    return error;
+}
+
 Error
 NativeRegisterContext::IsWatchpointHit(uint32_t wp_index, bool &is_hit)
 {
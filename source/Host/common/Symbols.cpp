@@ -17,7 +17,10 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/UUID.h"
+#include "lldb/Host/DebugFileIndex.h"
+#include "lldb/Interpreter/Args.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Platform.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/SafeMachO.h"
 
@@ -169,7 +172,8 @@ LocateExecutableSymbolFileDsym (const ModuleSpec &module_spec)
     const ArchSpec *arch = module_spec.GetArchitecturePtr();
     const UUID *uuid = module_spec.GetUUIDPtr();
 
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "LocateExecutableSymbolFileDsym (file = %s, arch = %s, uuid = %p)",
                         exec_fspec ? exec_fspec->GetFilename().AsCString ("<NULL>") : "<NULL>",
                         arch ? arch->GetArchitectureName() : "<NULL>",
@@ -198,7 +202,8 @@ Symbols::LocateExecutableObjectFile (const ModuleSpec &module_spec)
     const FileSpec *exec_fspec = module_spec.GetFileSpecPtr();
     const ArchSpec *arch = module_spec.GetArchitecturePtr();
     const UUID *uuid = module_spec.GetUUIDPtr();
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "LocateExecutableObjectFile (file = %s, arch = %s, uuid = %p)",
                         exec_fspec ? exec_fspec->GetFilename().AsCString ("<NULL>") : "<NULL>",
                         arch ? arch->GetArchitectureName() : "<NULL>",
@@ -219,6 +224,37 @@ Symbols::LocateExecutableObjectFile (const ModuleSpec &module_spec)
     return result;
 }
 
+// Returns true if file_spec is a separate debug file for the module.
+static bool
+IsDebugFileForModule (const FileSpec &file_spec, const ModuleSpec &module_spec)
+{
+    if (llvm::sys::fs::equivalent (file_spec.GetPath(), module_spec.GetFileSpec().GetPath()))
+        return false;
+
+    if (!file_spec.Exists())
+        return false;
+
+    lldb_private::ModuleSpecList specs;
+    const size_t num_specs = ObjectFile::GetModuleSpecifications (file_spec, 0, 0, specs);
+    assert (num_specs <= 1 && "Symbol Vendor supports only a single architecture");
+    if (num_specs == 1)
+    {
+        ModuleSpec mspec;
+        if (specs.GetModuleSpecAtIndex (0, mspec))
+            return mspec.GetUUID() == module_spec.GetUUID();
+    }
+    return false;
+}
+
+static FileSpec
+GetModuleCacheSubdirectory (const char *name)
+{
+    FileSpec dir_spec (Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory());
+    if (dir_spec)
+        dir_spec.AppendPathComponent (name);
+    return dir_spec;
+}
+
 FileSpec
 Symbols::LocateExecutableSymbolFile (const ModuleSpec &module_spec)
 {
@@ -226,6 +262,25 @@ Symbols::LocateExecutableSymbolFile (const ModuleSpec &module_spec)
     if (symbol_file_spec.IsAbsolute() && symbol_file_spec.Exists())
         return symbol_file_spec;
 
+    TargetPropertiesSP target_properties_sp (Target::GetGlobalProperties());
+    const UUID &module_uuid = module_spec.GetUUID();
+    const bool use_debug_file_index = target_properties_sp && target_properties_sp->GetUseDebugFileIndex();
+
+    // Looking up the build ID in the index of the .build-id directories
+    // saves probing them for every module.
+    if (use_debug_file_index && module_uuid.IsValid())
+    {
+        FileSpecList debug_roots (Target::GetDefaultDebugFileSearchPaths());
+#ifndef LLVM_ON_WIN32
+        debug_roots.AppendIfUnique (FileSpec("/usr/lib/debug", true));
+#endif // LLVM_ON_WIN32
+
+        FileSpec file_spec = DebugFileIndex::GetInstance().FindDebugFile (module_uuid, debug_roots,
+                                                                          GetModuleCacheSubdirectory ("debug_file_index"));
+        if (file_spec && IsDebugFileForModule (file_spec, module_spec))
+            return file_spec;
+    }
+
     const char *symbol_filename = symbol_file_spec.GetFilename().AsCString();
     if (symbol_filename && symbol_filename[0])
     {
@@ -244,12 +299,11 @@ Symbols::LocateExecutableSymbolFile (const ModuleSpec &module_spec)
 #endif // LLVM_ON_WIN32
 
         std::string uuid_str;
-        const UUID &module_uuid = module_spec.GetUUID();
-        if (module_uuid.IsValid())
+        if (module_uuid.IsValid() && !use_debug_file_index)
         {
             // Some debug files are stored in the .build-id directory like this:
             //   /usr/lib/debug/.build-id/ff/e7fe727889ad82bb153de2ad065b2189693315.debug
-            uuid_str = module_uuid.GetAsString("");
+            uuid_str = DebugFileIndex::GetBuildIDString (module_uuid);
             uuid_str.insert (2, 1, '/');
             uuid_str = uuid_str + ".debug";
         }
@@ -267,7 +321,8 @@ Symbols::LocateExecutableSymbolFile (const ModuleSpec &module_spec)
 
             files.push_back (dirname + "/" + symbol_filename);
             files.push_back (dirname + "/.debug/" + symbol_filename);
-            files.push_back (dirname + "/.build-id/" + uuid_str);
+            if (!uuid_str.empty())
+                files.push_back (dirname + "/.build-id/" + uuid_str);
 
             // Some debug files may stored in the module directory like this:
             //   /usr/lib/debug/usr/lib/library.so.debug
@@ -279,29 +334,34 @@ Symbols::LocateExecutableSymbolFile (const ModuleSpec &module_spec)
             {
                 const std::string &filename = files[idx_file];
                 FileSpec file_spec (filename.c_str(), true);
-
-                if (llvm::sys::fs::equivalent (file_spec.GetPath(), module_spec.GetFileSpec().GetPath()))
-                    continue;
-
-                if (file_spec.Exists())
-                {
-                    lldb_private::ModuleSpecList specs;
-                    const size_t num_specs = ObjectFile::GetModuleSpecifications (file_spec, 0, 0, specs);
-                    assert (num_specs <= 1 && "Symbol Vendor supports only a single architecture");
-                    if (num_specs == 1)
-                    {
-                        ModuleSpec mspec;
-                        if (specs.GetModuleSpecAtIndex (0, mspec))
-                        {
-                            if (mspec.GetUUID() == module_uuid)
-                                return file_spec;
-                        }
-                    }
-                }
+                if (IsDebugFileForModule (file_spec, module_spec))
+                    return file_spec;
             }
         }
     }
 
+    // Last, ask the symbol servers.
+    Args server_urls;
+    if (module_uuid.IsValid() && target_properties_sp && target_properties_sp->GetSymbolServerURLs (server_urls) &&
+        server_urls.GetArgumentCount() > 0)
+    {
+        std::vector<std::string> urls;
+        for (size_t idx = 0; idx < server_urls.GetArgumentCount(); ++idx)
+            urls.push_back (server_urls.GetArgumentAtIndex (idx));
+
+        Error error;
+        FileSpec file_spec = DebugFileIndex::GetInstance().DownloadDebugFile (module_uuid, urls,
+                                                                              GetModuleCacheSubdirectory ("symbol_server"),
+                                                                              error);
+        if (file_spec && IsDebugFileForModule (file_spec, module_spec))
+            return file_spec;
+
+        Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_HOST));
+        if (log && error.Fail())
+            log->Printf ("Symbols::LocateExecutableSymbolFile (uuid = %s): %s",
+                         module_uuid.GetAsString().c_str(), error.AsCString());
+    }
+
     return LocateExecutableSymbolFileDsym(module_spec);
 }
 
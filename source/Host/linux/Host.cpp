@@ -16,11 +16,18 @@
 #include <fcntl.h>
 
 // C++ Includes
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "lldb/Host/Host.h"
 #include "lldb/Host/HostInfo.h"
@@ -55,6 +62,9 @@ typedef struct ProcessStatInfo
 
 // Get the process info with additional information from /proc/$PID/stat (like process state, and tracer pid).
 static bool GetProcessAndStatInfo (lldb::pid_t pid, ProcessInstanceInfo &process_info, ProcessStatInfo &stat_info, lldb::pid_t &tracerpid);
+static bool GetProcessExecutable (lldb::pid_t pid, ProcessInstanceInfo &process_info, bool &deleted);
+static void GetProcessArguments (lldb::pid_t pid, ProcessInstanceInfo &process_info);
+static void GetELFProcessCPUType (lldb::pid_t pid, ProcessInstanceInfo &process_info);
 
 static bool
 ReadProcPseudoFileStat (lldb::pid_t pid, ProcessStatInfo& stat_info)
@@ -173,6 +183,52 @@ IsDirNumeric(const char *dname)
     return true;
 }
 
+// Fill in the info of a process for FindProcesses. The cheap fields that
+// most processes are rejected on are read first, the arguments and the
+// architecture only for the processes that are kept.
+static bool
+GetMatchingProcessInfo (lldb::pid_t pid, const ProcessInstanceInfoMatch &match_info, bool all_users, uid_t our_uid,
+                        ProcessInstanceInfo &process_info)
+{
+    ProcessStatInfo stat_info;
+    ::memset (&stat_info, 0, sizeof(stat_info));
+    stat_info.ppid = LLDB_INVALID_PROCESS_ID;
+
+    // Skip zombies.
+    if (!ReadProcPseudoFileStat (pid, stat_info) || (stat_info.fProcessState & eProcessStateZombie))
+        return false;
+
+    // Skip if process is being debugged.
+    lldb::pid_t tracerpid;
+    GetLinuxProcessUserAndGroup (pid, process_info, tracerpid);
+    if (tracerpid != 0)
+        return false;
+
+    // Check for user match if we're not matching all users and not running as root.
+    if (!all_users && (our_uid != 0) && (process_info.GetUserID() != our_uid))
+        return false;
+
+    bool deleted = false;
+    if (!GetProcessExecutable (pid, process_info, deleted))
+        return false;
+    process_info.SetProcessID (pid);
+    process_info.SetParentProcessID (stat_info.ppid);
+
+    // The architecture is only needed up front if it is part of the match.
+    const bool match_arch = match_info.GetProcessInfo().GetArchitecture().IsValid();
+    if (!match_arch && !match_info.Matches (process_info))
+        return false;
+
+    if (!deleted)
+        GetELFProcessCPUType (pid, process_info);
+    process_info.GetArchitecture().MergeFrom(HostInfo::GetArchitecture());
+    if (match_arch && !match_info.Matches (process_info))
+        return false;
+
+    GetProcessArguments (pid, process_info);
+    return true;
+}
+
 uint32_t
 Host::FindProcesses (const ProcessInstanceInfoMatch &match_info, ProcessInstanceInfoList &process_infos)
 {
@@ -186,6 +242,7 @@ Host::FindProcesses (const ProcessInstanceInfoMatch &match_info, ProcessInstance
         const lldb::pid_t our_pid = getpid();
         bool all_users = match_info.GetMatchAllUsers();
 
+        std::vector<lldb::pid_t> pids;
         while ((direntry = readdir (dirproc)) != NULL)
         {
             if (direntry->d_type != DT_DIR || !IsDirNumeric (direntry->d_name))
@@ -197,32 +254,36 @@ Host::FindProcesses (const ProcessInstanceInfoMatch &match_info, ProcessInstance
             if (pid == our_pid)
                 continue;
 
-            lldb::pid_t tracerpid;
-            ProcessStatInfo stat_info;
-            ProcessInstanceInfo process_info;
-
-            if (!GetProcessAndStatInfo (pid, process_info, stat_info, tracerpid))
-                continue;
-
-            // Skip if process is being debugged.
-            if (tracerpid != 0)
-                continue;
+            pids.push_back (pid);
+        }
 
-            // Skip zombies.
-            if (stat_info.fProcessState & eProcessStateZombie)
-                continue;
+        closedir (dirproc);
 
-            // Check for user match if we're not matching all users and not running as root.
-            if (!all_users && (our_uid != 0) && (process_info.GetUserID() != our_uid))
-                continue;
+        // Reading /proc is mostly waiting on syscalls, scan it in batches
+        // on the task pool and append the results in /proc order.
+        static const size_t k_pids_per_task = 256;
+        const size_t num_batches = (pids.size() + k_pids_per_task - 1) / k_pids_per_task;
+        std::vector<std::vector<ProcessInstanceInfo>> batch_infos (num_batches);
+        TaskRunner<void> task_runner;
+        for (size_t batch = 0; batch < num_batches; ++batch)
+        {
+            task_runner.AddTask ([&, batch]() {
+                const size_t end = std::min (pids.size(), (batch + 1) * k_pids_per_task);
+                for (size_t i = batch * k_pids_per_task; i < end; ++i)
+                {
+                    ProcessInstanceInfo process_info;
+                    if (GetMatchingProcessInfo (pids[i], match_info, all_users, our_uid, process_info))
+                        batch_infos[batch].push_back (process_info);
+                }
+            });
+        }
+        task_runner.WaitForAllTasks();
 
-            if (match_info.Matches (process_info))
-            {
+        for (const auto &infos : batch_infos)
+        {
+            for (const ProcessInstanceInfo &process_info : infos)
                 process_infos.Append (process_info);
-            }
         }
-
-        closedir (dirproc);
     }
 
     return process_infos.GetSize();
@@ -259,14 +320,41 @@ Host::FindProcessThreads (const lldb::pid_t pid, TidMap &tids_to_attach)
     return tids_changed;
 }
 
-static bool
-GetELFProcessCPUType (const char *exe_path, ProcessInstanceInfo &process_info)
+// The architecture of the executables that have already been looked at,
+// by device, inode and modification time. Most processes on a host share
+// a handful of executables and parsing the ELF header of each of them is
+// the expensive part of listing processes.
+typedef std::tuple<dev_t, ino_t, time_t, long> ExecutableKey;
+static std::mutex g_exe_arch_mutex;
+static std::map<ExecutableKey, ArchSpec> g_exe_arch_cache;
+
+static void
+GetELFProcessCPUType (lldb::pid_t pid, ProcessInstanceInfo &process_info)
 {
     // Clear the architecture.
     process_info.GetArchitecture().Clear();
 
+    // Stat through the /proc link so that the key is the one of the file
+    // the process runs, whatever its path resolves to for us.
+    char link_path[PATH_MAX];
+    struct stat exe_stat;
+    const bool have_key = snprintf (link_path, PATH_MAX, "/proc/%" PRIu64 "/exe", pid) > 0 &&
+                          ::stat (link_path, &exe_stat) == 0;
+    ExecutableKey key;
+    if (have_key)
+    {
+        key = ExecutableKey (exe_stat.st_dev, exe_stat.st_ino, exe_stat.st_mtim.tv_sec, exe_stat.st_mtim.tv_nsec);
+        std::lock_guard<std::mutex> guard (g_exe_arch_mutex);
+        auto pos = g_exe_arch_cache.find (key);
+        if (pos != g_exe_arch_cache.end())
+        {
+            process_info.GetArchitecture () = pos->second;
+            return;
+        }
+    }
+
     ModuleSpecList specs;
-    FileSpec filespec (exe_path, false);
+    const FileSpec &filespec = process_info.GetExecutableFile();
     const size_t num_specs = ObjectFile::GetModuleSpecifications (filespec, 0, 0, specs);
     // GetModuleSpecifications() could fail if the executable has been deleted or is locked.
     // But it shouldn't return more than 1 architecture.
@@ -275,22 +363,21 @@ GetELFProcessCPUType (const char *exe_path, ProcessInstanceInfo &process_info)
     {
         ModuleSpec module_spec;
         if (specs.GetModuleSpecAtIndex (0, module_spec) && module_spec.GetArchitecture().IsValid())
-        {
             process_info.GetArchitecture () = module_spec.GetArchitecture();
-            return true;
-        }
     }
-    return false;
+
+    if (have_key)
+    {
+        std::lock_guard<std::mutex> guard (g_exe_arch_mutex);
+        g_exe_arch_cache[key] = process_info.GetArchitecture ();
+    }
 }
 
+// Resolve the /proc/$PID/exe link into the executable file of the process.
+// deleted is set if the binary has been deleted since the process started.
 static bool
-GetProcessAndStatInfo (lldb::pid_t pid, ProcessInstanceInfo &process_info, ProcessStatInfo &stat_info, lldb::pid_t &tracerpid)
+GetProcessExecutable (lldb::pid_t pid, ProcessInstanceInfo &process_info, bool &deleted)
 {
-    tracerpid = 0;
-    process_info.Clear();
-    ::memset (&stat_info, 0, sizeof(stat_info));
-    stat_info.ppid = LLDB_INVALID_PROCESS_ID;
-
     // Use special code here because proc/[pid]/exe is a symbolic link.
     char link_path[PATH_MAX];
     char exe_path[PATH_MAX] = "";
@@ -307,35 +394,19 @@ GetProcessAndStatInfo (lldb::pid_t pid, ProcessInstanceInfo &process_info, Proce
     // If the binary has been deleted, the link name has " (deleted)" appended.
     //  Remove if there.
     static const ssize_t deleted_len = strlen(" (deleted)");
-    if (len > deleted_len &&
-        !strcmp(exe_path + len - deleted_len, " (deleted)"))
-    {
+    deleted = len > deleted_len && !strcmp(exe_path + len - deleted_len, " (deleted)");
+    if (deleted)
         exe_path[len - deleted_len] = 0;
-    }
-    else
-    {
-        GetELFProcessCPUType (exe_path, process_info);
-    }
 
-    process_info.SetProcessID(pid);
     process_info.GetExecutableFile().SetFile(exe_path, false);
-    process_info.GetArchitecture().MergeFrom(HostInfo::GetArchitecture());
-
-    lldb::DataBufferSP buf_sp;
-
-    // Get the process environment.
-    buf_sp = process_linux::ProcFileReader::ReadIntoDataBuffer(pid, "environ");
-    Args &info_env = process_info.GetEnvironmentEntries();
-    char *next_var = (char *)buf_sp->GetBytes();
-    char *end_buf = next_var + buf_sp->GetByteSize();
-    while (next_var < end_buf && 0 != *next_var)
-    {
-        info_env.AppendArgument(next_var);
-        next_var += strlen(next_var) + 1;
-    }
+    return true;
+}
 
+static void
+GetProcessArguments (lldb::pid_t pid, ProcessInstanceInfo &process_info)
+{
     // Get the command line used to start the process.
-    buf_sp = process_linux::ProcFileReader::ReadIntoDataBuffer(pid, "cmdline");
+    lldb::DataBufferSP buf_sp = process_linux::ProcFileReader::ReadIntoDataBuffer(pid, "cmdline");
 
     // Grab Arg0 first, if there is one.
     char *cmd = (char *)buf_sp->GetBytes();
@@ -346,13 +417,44 @@ GetProcessAndStatInfo (lldb::pid_t pid, ProcessInstanceInfo &process_info, Proce
         // Now process any remaining arguments.
         Args &info_args = process_info.GetArguments();
         char *next_arg = cmd + strlen(cmd) + 1;
-        end_buf = cmd + buf_sp->GetByteSize();
+        char *end_buf = cmd + buf_sp->GetByteSize();
         while (next_arg < end_buf && 0 != *next_arg)
         {
             info_args.AppendArgument(next_arg);
             next_arg += strlen(next_arg) + 1;
         }
     }
+}
+
+static bool
+GetProcessAndStatInfo (lldb::pid_t pid, ProcessInstanceInfo &process_info, ProcessStatInfo &stat_info, lldb::pid_t &tracerpid)
+{
+    tracerpid = 0;
+    process_info.Clear();
+    ::memset (&stat_info, 0, sizeof(stat_info));
+    stat_info.ppid = LLDB_INVALID_PROCESS_ID;
+
+    bool deleted = false;
+    if (!GetProcessExecutable (pid, process_info, deleted))
+        return false;
+    if (!deleted)
+        GetELFProcessCPUType (pid, process_info);
+
+    process_info.SetProcessID(pid);
+    process_info.GetArchitecture().MergeFrom(HostInfo::GetArchitecture());
+
+    // Get the process environment.
+    lldb::DataBufferSP buf_sp = process_linux::ProcFileReader::ReadIntoDataBuffer(pid, "environ");
+    Args &info_env = process_info.GetEnvironmentEntries();
+    char *next_var = (char *)buf_sp->GetBytes();
+    char *end_buf = next_var + buf_sp->GetByteSize();
+    while (next_var < end_buf && 0 != *next_var)
+    {
+        info_env.AppendArgument(next_var);
+        next_var += strlen(next_var) + 1;
+    }
+
+    GetProcessArguments (pid, process_info);
 
     // Read /proc/$PID/stat to get our parent pid.
     if (ReadProcPseudoFileStat (pid, stat_info))
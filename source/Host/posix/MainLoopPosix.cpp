@@ -9,6 +9,12 @@
 
 #include "lldb/Host/posix/MainLoopPosix.h"
 
+#include <errno.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#endif
+
 #include <vector>
 
 #include "lldb/Core/Error.h"
@@ -26,10 +32,26 @@ SignalHandler(int signo, siginfo_t *info, void *)
 }
 
 
+MainLoopPosix::MainLoopPosix() :
+    MainLoopBase(),
+    m_read_fds(),
+    m_signals(),
+#if defined(__linux__)
+    m_epoll_fd(epoll_create1(EPOLL_CLOEXEC)),
+#endif
+    m_terminate_request(false)
+{
+    // If we can't get an epoll instance we use pselect.
+}
+
 MainLoopPosix::~MainLoopPosix()
 {
     assert(m_read_fds.size() == 0);
     assert(m_signals.size() == 0);
+#if defined(__linux__)
+    if (m_epoll_fd != -1)
+        close(m_epoll_fd);
+#endif
 }
 
 MainLoopPosix::ReadHandleUP
@@ -49,6 +71,24 @@ MainLoopPosix::RegisterReadObject(const IOObjectSP &object_sp, const Callback &c
         return nullptr;
     }
 
+#if defined(__linux__)
+    if (m_epoll_fd != -1)
+    {
+        // Level triggered like pselect: callbacks don't have to drain the
+        // file descriptor.
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = object_sp->GetWaitableHandle();
+        if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, event.data.fd, &event) == -1 &&
+            (errno != EEXIST || epoll_ctl(m_epoll_fd, EPOLL_CTL_MOD, event.data.fd, &event) == -1))
+        {
+            error.SetErrorToErrno();
+            m_read_fds.erase(event.data.fd);
+            return nullptr;
+        }
+    }
+#endif
+
     return CreateReadHandle(object_sp);
 }
 
@@ -99,6 +139,13 @@ MainLoopPosix::UnregisterReadObject(IOObject::WaitableHandle handle)
     bool erased = m_read_fds.erase(handle);
     UNUSED_IF_ASSERT_DISABLED(erased);
     assert(erased);
+
+#if defined(__linux__)
+    // The descriptor may be closed already, in which case the kernel has
+    // removed it from the epoll set.
+    if (m_epoll_fd != -1)
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, handle, nullptr);
+#endif
 }
 
 void
@@ -125,6 +172,9 @@ MainLoopPosix::Run()
     sigset_t sigmask;
     std::vector<int> read_fds;
     fd_set read_fd_set;
+#if defined(__linux__)
+    std::vector<struct epoll_event> events;
+#endif
     m_terminate_request = false;
 
     // run until termination or until we run out of things to listen to
@@ -134,27 +184,47 @@ MainLoopPosix::Run()
         // will store the *real* list of events separately.
         signals.clear();
         read_fds.clear();
-        FD_ZERO(&read_fd_set);
-        int nfds = 0;
 
         if (int ret = pthread_sigmask(SIG_SETMASK, nullptr, &sigmask))
             return Error("pthread_sigmask failed with error %d\n", ret);
 
-        for (const auto &fd: m_read_fds)
-        {
-            read_fds.push_back(fd.first);
-            FD_SET(fd.first, &read_fd_set);
-            nfds = std::max(nfds, fd.first+1);
-        }
-
         for (const auto &sig: m_signals)
         {
             signals.push_back(sig.first);
             sigdelset(&sigmask, sig.first);
         }
 
-        if (pselect(nfds, &read_fd_set, nullptr, nullptr, nullptr, &sigmask) == -1 && errno != EINTR)
-            return Error(errno, eErrorTypePOSIX);
+#if defined(__linux__)
+        if (m_epoll_fd != -1)
+        {
+            // Unblocks the signals while waiting, the same way pselect does.
+            events.resize(std::max<size_t>(m_read_fds.size(), 1));
+            int num_events = epoll_pwait(m_epoll_fd, events.data(), events.size(), -1, &sigmask);
+            if (num_events == -1 && errno != EINTR)
+                return Error(errno, eErrorTypePOSIX);
+            for (int i = 0; i < num_events; ++i)
+                read_fds.push_back(events[i].data.fd);
+        }
+        else
+#endif
+        {
+            FD_ZERO(&read_fd_set);
+            int nfds = 0;
+            for (const auto &fd: m_read_fds)
+            {
+                FD_SET(fd.first, &read_fd_set);
+                nfds = std::max(nfds, fd.first+1);
+            }
+
+            if (pselect(nfds, &read_fd_set, nullptr, nullptr, nullptr, &sigmask) == -1 && errno != EINTR)
+                return Error(errno, eErrorTypePOSIX);
+
+            for (const auto &fd: m_read_fds)
+            {
+                if (FD_ISSET(fd.first, &read_fd_set))
+                    read_fds.push_back(fd.first);
+            }
+        }
 
         for (int sig: signals)
         {
@@ -174,9 +244,6 @@ MainLoopPosix::Run()
 
         for (int fd: read_fds)
         {
-            if (!FD_ISSET(fd, &read_fd_set))
-                continue; // Not ready
-
             auto it = m_read_fds.find(fd);
             if (it == m_read_fds.end())
                 continue; // File descriptor must have gotten unregistered in the meantime
@@ -89,7 +89,8 @@ SystemInitializerCommon::Initialize()
 
     Log::Initialize();
     HostInfo::Initialize();
-    Timer scoped_timer(__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat, __PRETTY_FUNCTION__);
 
     llvm::install_fatal_error_handler(fatal_error_handler, 0);
 
@@ -135,7 +136,8 @@ SystemInitializerCommon::Initialize()
 void
 SystemInitializerCommon::Terminate()
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat, __PRETTY_FUNCTION__);
     ObjectContainerBSDArchive::Terminate();
     ObjectFileELF::Terminate();
     ObjectFilePECOFF::Terminate();
@@ -32,6 +32,7 @@
 #include "../Commands/CommandObjectRegister.h"
 #include "../Commands/CommandObjectSettings.h"
 #include "../Commands/CommandObjectSource.h"
+#include "../Commands/CommandObjectStats.h"
 #include "../Commands/CommandObjectCommands.h"
 #include "../Commands/CommandObjectSyntax.h"
 #include "../Commands/CommandObjectTarget.h"
@@ -179,7 +180,8 @@ CommandInterpreter::GetSpaceReplPrompts () const
 void
 CommandInterpreter::Initialize ()
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, __PRETTY_FUNCTION__);
 
     CommandReturnObject result;
 
@@ -423,7 +425,8 @@ CommandInterpreter::ProcessEmbeddedScriptCommands (const char *arg)
 void
 CommandInterpreter::LoadCommandDictionary ()
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, __PRETTY_FUNCTION__);
 
     lldb::ScriptLanguage script_language = m_debugger.GetScriptLanguage();
     
@@ -446,6 +449,7 @@ CommandInterpreter::LoadCommandDictionary ()
     m_command_dict["script"]    = CommandObjectSP (new CommandObjectScript (*this, script_language));
     m_command_dict["settings"]  = CommandObjectSP (new CommandObjectMultiwordSettings (*this));
     m_command_dict["source"]    = CommandObjectSP (new CommandObjectMultiwordSource (*this));
+    m_command_dict["statistics"]= CommandObjectSP (new CommandObjectStats (*this));
     m_command_dict["target"]    = CommandObjectSP (new CommandObjectMultiwordTarget (*this));
     m_command_dict["thread"]    = CommandObjectSP (new CommandObjectMultiwordThread (*this));
     m_command_dict["type"]      = CommandObjectSP (new CommandObjectType (*this));
@@ -1581,7 +1585,8 @@ CommandInterpreter::HandleCommand (const char *command_line,
     if (log)
         log->Printf ("Processing command: %s", command_line);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "Handling command: %s.", command_line);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "Handling command: %s.", command_line);
     
     if (!no_context_switching)
         UpdateExecutionContext (override_context);
@@ -24,7 +24,6 @@
 #include "llvm/MC/MCSubtargetInfo.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/TargetRegistry.h"
-#include "llvm/Support/TargetSelect.h"
 
 // Other libraries and framework includes
 #include "DisassemblerLLVMC.h"
@@ -40,6 +39,7 @@
 #include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/StackFrame.h"
+#include "lldb/Utility/LLVMTargets.h"
 
 #include "lldb/Core/RegularExpression.h"
 
@@ -260,6 +260,16 @@ public:
         return m_opcode.GetByteSize();
     }
 
+    // Sets the opcode from a cached decode of the same bytes instead of
+    // asking the MC disassembler for the instruction size again.
+    bool
+    DecodeCached (const lldb_private::DataExtractor &data,
+                  const lldb_private::DecodedInstruction &decoded)
+    {
+        m_is_valid = SetOpcode (data, decoded);
+        return m_is_valid;
+    }
+
     void
     AppendComment (std::string &description)
     {
@@ -753,6 +763,8 @@ DisassemblerLLVMC::CreateInstance (const ArchSpec &arch, const char *flavor)
 {
     if (arch.GetTriple().getArch() != llvm::Triple::UnknownArch)
     {
+        InitializeLLVMTargets();
+
         std::unique_ptr<DisassemblerLLVMC> disasm_ap (new DisassemblerLLVMC(arch, flavor));
 
         if (disasm_ap.get() && disasm_ap->IsValid())
@@ -810,17 +822,42 @@ DisassemblerLLVMC::DecodeInstructions (const Address &base_addr,
     return data_cursor - data_offset;
 }
 
+bool
+DisassemblerLLVMC::CreateCachedInstructions (const Address &base_addr,
+                                             const DataExtractor &data,
+                                             const std::vector<DecodedInstruction> &decoded)
+{
+    m_instruction_list.Clear();
+
+    if (!IsValid())
+        return false;
+
+    // Only code that was read from the object file is cached.
+    m_data_from_file = true;
+    for (const DecodedInstruction &decoded_inst : decoded)
+    {
+        Address inst_addr(base_addr);
+        inst_addr.Slide(decoded_inst.offset);
+        InstructionLLVMC *inst = new InstructionLLVMC(*this,
+                                                      inst_addr,
+                                                      (AddressClass)decoded_inst.address_class);
+        InstructionSP inst_sp(inst);
+        if (!inst->DecodeCached(data, decoded_inst))
+        {
+            m_instruction_list.Clear();
+            return false;
+        }
+        m_instruction_list.Append(inst_sp);
+    }
+    return true;
+}
+
 void
 DisassemblerLLVMC::Initialize()
 {
     PluginManager::RegisterPlugin (GetPluginNameStatic(),
                                    "Disassembler that uses LLVM MC to disassemble i386, x86_64, ARM, and ARM64.",
                                    CreateInstance);
-
-    llvm::InitializeAllTargetInfos();
-    llvm::InitializeAllTargetMCs();
-    llvm::InitializeAllAsmParsers();
-    llvm::InitializeAllDisassemblers();
 }
 
 void
@@ -99,6 +99,11 @@ public:
                        bool append,
                        bool data_from_file) override;
 
+    bool
+    CreateCachedInstructions(const lldb_private::Address &base_addr,
+                             const lldb_private::DataExtractor &data,
+                             const std::vector<lldb_private::DecodedInstruction> &decoded) override;
+
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
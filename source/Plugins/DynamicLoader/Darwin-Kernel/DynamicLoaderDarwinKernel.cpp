@@ -28,6 +28,7 @@
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadPlanRunToAddress.h"
+#include "lldb/Utility/TaskPool.h"
 #include "Plugins/Platform/MacOSX/PlatformDarwinKernel.h"
 
 #include "DynamicLoaderDarwinKernel.h"
@@ -662,17 +663,33 @@ DynamicLoaderDarwinKernel::KextImageInfo::GetUUID () const
 bool
 DynamicLoaderDarwinKernel::KextImageInfo::ReadMemoryModule (Process *process)
 {
-    Log *log = lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_HOST);
     if (m_memory_module_sp.get() != NULL)
         return true;
     if (m_load_address == LLDB_INVALID_ADDRESS)
         return false;
 
+    return SetMemoryModule (process, ReadModuleFromMemory (process));
+}
+
+ModuleSP
+DynamicLoaderDarwinKernel::KextImageInfo::ReadModuleFromMemory (Process *process) const
+{
+    if (m_load_address == LLDB_INVALID_ADDRESS)
+        return ModuleSP();
+
     FileSpec file_spec;
     file_spec.SetFile (m_name.c_str(), false);
 
-    ModuleSP memory_module_sp = process->ReadModuleFromMemory (file_spec, m_load_address);
+    // Images start on a page boundary, reading the first page usually gets
+    // the header and all of the load commands with one read instead of two.
+    const size_t size_to_read = m_size >= 0x1000 ? 0x1000 : 512;
+    return process->ReadModuleFromMemory (file_spec, m_load_address, size_to_read);
+}
 
+bool
+DynamicLoaderDarwinKernel::KextImageInfo::SetMemoryModule (Process *process, const ModuleSP &memory_module_sp)
+{
+    Log *log = lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_HOST);
     if (memory_module_sp.get() == NULL)
         return false;
 
@@ -1322,6 +1339,33 @@ DynamicLoaderDarwinKernel::ParseKextSummaries (const Address &kext_summary_addr,
         ModuleList loaded_module_list;
 
         const uint32_t num_of_new_kexts = kext_summaries.size();
+
+        // Read the headers of all the new kexts first, on several threads.
+        // The reads don't depend on each other, gdb-remote pipelines reads
+        // from several threads so they share round trips.
+        if (load_kexts)
+        {
+            std::vector<uint32_t> memory_module_kexts;
+            for (uint32_t new_kext = 0; new_kext < num_of_new_kexts; new_kext++)
+            {
+                if (to_be_added[new_kext] && !kext_summaries[new_kext].IsLoaded())
+                    memory_module_kexts.push_back (new_kext);
+            }
+
+            std::vector<ModuleSP> memory_modules (memory_module_kexts.size());
+            TaskRunner<void> task_runner;
+            for (size_t i = 0; i < memory_module_kexts.size(); ++i)
+            {
+                task_runner.AddTask([this, &kext_summaries, &memory_module_kexts, &memory_modules, i]() {
+                    memory_modules[i] = kext_summaries[memory_module_kexts[i]].ReadModuleFromMemory (m_process);
+                });
+            }
+            task_runner.WaitForAllTasks();
+
+            for (size_t i = 0; i < memory_module_kexts.size(); ++i)
+                kext_summaries[memory_module_kexts[i]].SetMemoryModule (m_process, memory_modules[i]);
+        }
+
         for (uint32_t new_kext = 0; new_kext < num_of_new_kexts; new_kext++)
         {
             if (to_be_added[new_kext] == true)
@@ -218,6 +218,17 @@ protected:
         bool
         ReadMemoryModule (lldb_private::Process *process); 
 
+        // Read the Mach-O header and load commands at m_load_address into a
+        // new module. This only reads memory, so it can be done for several
+        // images at once.
+        lldb::ModuleSP
+        ReadModuleFromMemory (lldb_private::Process *process) const;
+
+        // Check a module returned by ReadModuleFromMemory() and make it the
+        // memory module; true if m_memory_module_sp is now set.
+        bool
+        SetMemoryModule (lldb_private::Process *process, const lldb::ModuleSP &memory_module_sp);
+
         bool
         IsKernel () const;            // true if this is the mach_kernel; false if this is a kext
 
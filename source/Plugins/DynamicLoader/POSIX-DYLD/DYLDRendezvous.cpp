@@ -9,8 +9,11 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+
 // Other libraries and framework includes
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
@@ -102,6 +105,17 @@ ResolveRendezvousAddress(Process *process)
     return info_addr;
 }
 
+// Returns true if two SOEntries were read from the same link_map entry of the same
+// shared object. A link_map that is reused for another shared object has a
+// different path and dynamic section.
+static bool
+IsSameLinkMapEntry(const DYLDRendezvous::SOEntry &lhs, const DYLDRendezvous::SOEntry &rhs)
+{
+    return lhs.link_addr == rhs.link_addr &&
+           lhs.path_addr == rhs.path_addr &&
+           lhs.dyn_addr == rhs.dyn_addr;
+}
+
 DYLDRendezvous::DYLDRendezvous(Process *process)
     : m_process(process),
       m_rendezvous_addr(LLDB_INVALID_ADDRESS),
@@ -110,7 +124,8 @@ DYLDRendezvous::DYLDRendezvous(Process *process)
       m_loaded_modules(),
       m_soentries(),
       m_added_soentries(),
-      m_removed_soentries()
+      m_removed_soentries(),
+      m_tail_entry()
 {
     Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_DYNAMIC_LOADER));
 
@@ -200,8 +215,10 @@ DYLDRendezvous::UpdateSOEntries(bool fromRemote)
     SOEntry entry;
     LoadedModuleInfoList module_list;
 
-    // If we can't get the SO info from the remote, return failure.
-    if (fromRemote && m_process->LoadModules (module_list) == 0)
+    // If we can't get the SO info from the remote, return failure. The
+    // modules aren't loaded here, the dynamic loader loads the ones that
+    // were added since the last update.
+    if (fromRemote && (m_process->GetLoadedModuleList (module_list).Fail () || module_list.m_list.empty ()))
         return false;
 
     if (!fromRemote && m_current.map_addr == 0)
@@ -223,12 +240,21 @@ DYLDRendezvous::UpdateSOEntries(bool fromRemote)
         if (!(m_previous.state == eConsistent || (m_previous.state == eAdd && m_current.state == eDelete)))
             return false;
 
-        m_soentries.clear();
+        m_added_soentries.clear();
+        m_removed_soentries.clear();
         if (fromRemote)
+        {
+            m_soentries.clear();
             return SaveSOEntriesFromRemote(module_list);
+        }
+
+        // The runtime linker didn't change the link map yet, so unless we
+        // missed an update it still is the one we read at the last
+        // consistent state. Processes that dlopen a lot hit this for every
+        // library, so don't read the whole list again.
+        if (ReadTailEntry(entry) && entry.next == 0)
+            return true;
 
-        m_added_soentries.clear();
-        m_removed_soentries.clear();
         return TakeSnapshot(m_soentries);
     }
     assert(m_current.state == eConsistent);
@@ -289,6 +315,7 @@ DYLDRendezvous::SaveSOEntriesFromRemote(LoadedModuleInfoList &module_list)
     }
 
     m_loaded_modules = module_list;
+    m_tail_entry.clear();
     return true;
 
 }
@@ -296,28 +323,36 @@ DYLDRendezvous::SaveSOEntriesFromRemote(LoadedModuleInfoList &module_list)
 bool
 DYLDRendezvous::AddSOEntriesFromRemote(LoadedModuleInfoList &module_list)
 {
+    // Index the previous list by link map address so that a rendezvous
+    // with many libraries loaded doesn't compare every pair of modules.
+    std::map<addr_t, const LoadedModuleInfoList::LoadedModuleInfo *> existing_modules;
+    for (auto const & existing : m_loaded_modules.m_list)
+    {
+        addr_t link_map_addr;
+        if (existing.get_link_map (link_map_addr))
+            existing_modules[link_map_addr] = &existing;
+    }
+
     for (auto const & modInfo : module_list.m_list)
     {
-        bool found = false;
-        for (auto const & existing : m_loaded_modules.m_list)
+        addr_t link_map_addr;
+        if (modInfo.get_link_map (link_map_addr))
         {
-            if (modInfo == existing)
-            {
-                found = true;
-                break;
-            }
+            auto pos = existing_modules.find(link_map_addr);
+            if (pos != existing_modules.end() && *pos->second == modInfo)
+                continue;
         }
 
-        if (found)
-            continue;
-
         SOEntry entry;
         if (!FillSOEntryFromModuleInfo(modInfo, entry))
             return false;
 
         // Only add shared libraries and not the executable.
         if (!SOEntryIsMainExecutable(entry))
+        {
             m_soentries.push_back(entry);
+            m_added_soentries.push_back(entry);
+        }
     }
 
     m_loaded_modules = module_list;
@@ -327,21 +362,24 @@ DYLDRendezvous::AddSOEntriesFromRemote(LoadedModuleInfoList &module_list)
 bool
 DYLDRendezvous::RemoveSOEntriesFromRemote(LoadedModuleInfoList &module_list)
 {
+    std::map<addr_t, const LoadedModuleInfoList::LoadedModuleInfo *> current_modules;
+    for (auto const & modInfo : module_list.m_list)
+    {
+        addr_t link_map_addr;
+        if (modInfo.get_link_map (link_map_addr))
+            current_modules[link_map_addr] = &modInfo;
+    }
+
     for (auto const & existing : m_loaded_modules.m_list)
     {
-        bool found = false;
-        for (auto const & modInfo : module_list.m_list)
+        addr_t link_map_addr;
+        if (existing.get_link_map (link_map_addr))
         {
-            if (modInfo == existing)
-            {
-                found = true;
-                break;
-            }
+            auto pos = current_modules.find(link_map_addr);
+            if (pos != current_modules.end() && *pos->second == existing)
+                continue;
         }
 
-        if (found)
-            continue;
-
         SOEntry entry;
         if (!FillSOEntryFromModuleInfo(existing, entry))
             return false;
@@ -354,6 +392,7 @@ DYLDRendezvous::RemoveSOEntriesFromRemote(LoadedModuleInfoList &module_list)
                 return false;
 
             m_soentries.erase(pos);
+            m_removed_soentries.push_back(entry);
         }
     }
 
@@ -365,28 +404,51 @@ bool
 DYLDRendezvous::AddSOEntries()
 {
     SOEntry entry;
-    iterator pos;
 
     assert(m_previous.state == eAdd);
 
     if (m_current.map_addr == 0)
         return false;
 
-    for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next)
+    // The runtime linker links new shared objects in after the last entry,
+    // so only the entries after the tail we saw last time need to be read.
+    // If the tail changed, read the whole list and compare.
+    if (!ReadTailEntry(entry))
+    {
+        std::map<addr_t, const SOEntry *> old_entries;
+        for (const SOEntry &old_entry : m_soentries)
+            old_entries[old_entry.link_addr] = &old_entry;
+
+        SOEntryList entry_list;
+        if (!TakeSnapshot(entry_list))
+            return false;
+
+        for (const SOEntry &new_entry : entry_list)
+        {
+            auto pos = old_entries.find(new_entry.link_addr);
+            if (pos == old_entries.end() || !IsSameLinkMapEntry(*pos->second, new_entry))
+                m_added_soentries.push_back(new_entry);
+        }
+
+        m_soentries.swap(entry_list);
+        return true;
+    }
+
+    for (addr_t cursor = entry.next; cursor != 0; cursor = entry.next)
     {
         if (!ReadSOEntryFromMemory(cursor, entry))
+        {
+            m_tail_entry.clear();
             return false;
+        }
+        m_tail_entry = entry;
 
         // Only add shared libraries and not the executable.
         if (SOEntryIsMainExecutable(entry))
             continue;
 
-        pos = std::find(m_soentries.begin(), m_soentries.end(), entry);
-        if (pos == m_soentries.end())
-        {
-            m_soentries.push_back(entry);
-            m_added_soentries.push_back(entry);
-        }
+        m_soentries.push_back(entry);
+        m_added_soentries.push_back(entry);
     }
 
     return true;
@@ -396,21 +458,24 @@ bool
 DYLDRendezvous::RemoveSOEntries()
 {
     SOEntryList entry_list;
-    iterator pos;
 
     assert(m_previous.state == eDelete);
 
     if (!TakeSnapshot(entry_list))
         return false;
 
+    std::map<addr_t, const SOEntry *> current_entries;
+    for (const SOEntry &current_entry : entry_list)
+        current_entries[current_entry.link_addr] = &current_entry;
+
     for (iterator I = begin(); I != end(); ++I)
     {
-        pos = std::find(entry_list.begin(), entry_list.end(), *I);
-        if (pos == entry_list.end())
+        auto pos = current_entries.find(I->link_addr);
+        if (pos == current_entries.end() || !IsSameLinkMapEntry(*pos->second, *I))
             m_removed_soentries.push_back(*I);
     }
 
-    m_soentries = entry_list;
+    m_soentries.swap(entry_list);
     return true;
 }
 
@@ -439,24 +504,53 @@ DYLDRendezvous::TakeSnapshot(SOEntryList &entry_list)
 {
     SOEntry entry;
 
+    // Clear previous entries since we are about to obtain an up to date list.
+    m_tail_entry.clear();
     if (m_current.map_addr == 0)
+    {
+        entry_list.clear();
         return false;
+    }
 
-    // Clear previous entries since we are about to obtain an up to date list.
-    entry_list.clear();
+    // Most entries are still the ones we read last time, don't read their
+    // paths again.
+    std::map<addr_t, const SOEntry *> known_entries;
+    for (const SOEntry &known_entry : m_soentries)
+        known_entries[known_entry.link_addr] = &known_entry;
 
+    SOEntryList new_entries;
     for (addr_t cursor = m_current.map_addr; cursor != 0; cursor = entry.next)
     {
-        if (!ReadSOEntryFromMemory(cursor, entry))
+        auto pos = known_entries.find(cursor);
+        if (!ReadSOEntryFromMemory(cursor, entry, pos != known_entries.end() ? pos->second : nullptr))
+        {
+            m_tail_entry.clear();
+            entry_list.clear();
             return false;
+        }
+        m_tail_entry = entry;
 
         // Only add shared libraries and not the executable.
         if (SOEntryIsMainExecutable(entry))
             continue;
 
-        entry_list.push_back(entry);
+        new_entries.push_back(entry);
     }
 
+    entry_list.swap(new_entries);
+    return true;
+}
+
+bool
+DYLDRendezvous::ReadTailEntry(SOEntry &entry)
+{
+    if (m_tail_entry.link_addr == 0 || m_current.map_addr != m_previous.map_addr)
+        return false;
+
+    if (!ReadSOEntryFromMemory(m_tail_entry.link_addr, entry, &m_tail_entry) ||
+        !IsSameLinkMapEntry(entry, m_tail_entry))
+        return false;
+
     return true;
 }
 
@@ -533,42 +627,52 @@ DYLDRendezvous::UpdateBaseAddrIfNecessary(SOEntry &entry, std::string const &fil
 }
 
 bool
-DYLDRendezvous::ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry)
+DYLDRendezvous::ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry, const SOEntry *known_entry)
 {
     entry.clear();
 
     entry.link_addr = addr;
-    
-    if (!(addr = ReadPointer(addr, &entry.base_addr)))
-        return false;
 
     // mips adds an extra load offset field to the link map struct on
     // FreeBSD and NetBSD (need to validate other OSes).
     // http://svnweb.freebsd.org/base/head/sys/sys/link_elf.h?revision=217153&view=markup#l57
     const ArchSpec &arch = m_process->GetTarget().GetArchitecture();
-    if ((arch.GetTriple().getOS() == llvm::Triple::FreeBSD 
+    const bool has_mips_l_offs = (arch.GetTriple().getOS() == llvm::Triple::FreeBSD
         || arch.GetTriple().getOS() == llvm::Triple::NetBSD) && 
         (arch.GetMachine() == llvm::Triple::mips || arch.GetMachine() == llvm::Triple::mipsel
-        || arch.GetMachine() == llvm::Triple::mips64 || arch.GetMachine() == llvm::Triple::mips64el))
+        || arch.GetMachine() == llvm::Triple::mips64 || arch.GetMachine() == llvm::Triple::mips64el);
+
+    // Read the whole entry at once rather than one field at a time.
+    const uint32_t addr_size = m_process->GetAddressByteSize();
+    const size_t entry_size = (has_mips_l_offs ? 6 : 5) * addr_size;
+    uint8_t buf[6 * sizeof(uint64_t)];
+    if (addr_size > sizeof(uint64_t))
+        return false;
+
+    Error error;
+    if (m_process->ReadMemory(addr, buf, entry_size, error) != entry_size)
+        return false;
+
+    DataExtractor data(buf, entry_size, m_process->GetByteOrder(), addr_size);
+    lldb::offset_t offset = 0;
+    entry.base_addr = data.GetAddress(&offset);
+    if (has_mips_l_offs)
     {
-        addr_t mips_l_offs;
-        if (!(addr = ReadPointer(addr, &mips_l_offs)))
-            return false;
+        addr_t mips_l_offs = data.GetAddress(&offset);
         if (mips_l_offs != 0 && mips_l_offs != entry.base_addr)
             return false;
     }
-    
-    if (!(addr = ReadPointer(addr, &entry.path_addr)))
-        return false;
-    
-    if (!(addr = ReadPointer(addr, &entry.dyn_addr)))
-        return false;
-    
-    if (!(addr = ReadPointer(addr, &entry.next)))
-        return false;
-    
-    if (!(addr = ReadPointer(addr, &entry.prev)))
-        return false;
+    entry.path_addr = data.GetAddress(&offset);
+    entry.dyn_addr = data.GetAddress(&offset);
+    entry.next = data.GetAddress(&offset);
+    entry.prev = data.GetAddress(&offset);
+
+    if (known_entry && IsSameLinkMapEntry(*known_entry, entry))
+    {
+        entry.file_spec = known_entry->file_spec;
+        entry.base_addr = known_entry->base_addr;
+        return true;
+    }
 
     std::string file_path = ReadStringFromMemory(entry.path_addr);
     entry.file_spec.SetFile(file_path, false);
@@ -218,6 +218,10 @@ protected:
     /// Resolve().
     SOEntryList m_removed_soentries;
 
+    /// The last entry of the link map the last time it was read, which can
+    /// be the executable. New shared objects are linked in after it.
+    SOEntry m_tail_entry;
+
     /// Threading metadata read from the inferior.
     ThreadInfo  m_thread_info;
 
@@ -241,8 +245,18 @@ protected:
     ReadStringFromMemory(lldb::addr_t addr);
 
     /// Reads an SOEntry starting at @p addr.
+    ///
+    /// If @p known_entry is the same link map entry, its file spec is used
+    /// instead of reading the path from memory again.
+    bool
+    ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry, const SOEntry *known_entry = nullptr);
+
+    /// Reads the entry the link map ended with the last time it was read.
+    ///
+    /// @returns false if that entry changed, in which case the whole link
+    /// map has to be read again.
     bool
-    ReadSOEntryFromMemory(lldb::addr_t addr, SOEntry &entry);
+    ReadTailEntry(SOEntry &entry);
 
     /// Updates the current set of SOEntries, the set of added entries, and the
     /// set of removed entries.
@@ -400,6 +400,10 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
     {
         ModuleList new_modules;
 
+        // Tell the target about all the new modules at once, not as each
+        // one is added to the image list.
+        Target &target = m_process->GetTarget();
+        const bool old_defer = target.SetDeferModuleLoadNotifications(true);
         E = m_rendezvous.loaded_end();
         for (I = m_rendezvous.loaded_begin(); I != E; ++I)
         {
@@ -410,7 +414,8 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
                 new_modules.Append(module_sp);
             }
         }
-        m_process->GetTarget().ModulesDidLoad(new_modules);
+        target.SetDeferModuleLoadNotifications(old_defer);
+        target.ModulesDidLoad(new_modules);
     }
     
     if (m_rendezvous.ModulesDidUnload())
@@ -507,6 +512,10 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
     // that ourselves here.
     ModuleSP executable = GetTargetExecutable();
     m_loaded_modules[executable] = m_rendezvous.GetLinkMapAddress();
+
+    // The modules are announced together below.
+    Target &target = m_process->GetTarget();
+    const bool old_defer = target.SetDeferModuleLoadNotifications(true);
     if (m_vdso_base != LLDB_INVALID_ADDRESS)
     {
         FileSpec file_spec("[vdso]", false);
@@ -532,7 +541,8 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
         }
     }
 
-    m_process->GetTarget().ModulesDidLoad(module_list);
+    target.SetDeferModuleLoadNotifications(old_defer);
+    target.ModulesDidLoad(module_list);
 }
 
 addr_t
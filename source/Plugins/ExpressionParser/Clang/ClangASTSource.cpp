@@ -745,12 +745,10 @@ ClangASTSource::FindExternalVisibleDecls (NameSearchContext &context,
     {
         TypeList types;
         SymbolContext null_sc;
-        const bool exact_match = false;
-        llvm::DenseSet<lldb_private::SymbolFile *> searched_symbol_files;
         if (module_sp && namespace_decl)
             module_sp->FindTypesInNamespace(null_sc, name, &namespace_decl, 1, types);
         else
-            m_target->GetImages().FindTypes(null_sc, name, exact_match, 1, searched_symbol_files, types);
+            m_target->FindFirstTypeForExpressions(name, types);
 
         bool found_a_type = false;
         
@@ -744,7 +744,7 @@ ClangExpressionDeclMap::FindGlobalVariable
     if (module && namespace_decl)
         module->FindGlobalVariables (name, namespace_decl, true, -1, vars);
     else
-        target.GetImages().FindGlobalVariables(name, true, -1, vars);
+        target.FindGlobalVariablesForExpressions(name, vars);
 
     if (vars.GetSize())
     {
@@ -1248,9 +1248,15 @@ ClangExpressionDeclMap::FindExternalVisibleDecls (NameSearchContext &context,
             if (compiler_decl_context)
             {
                 // Make sure that the variables are parsed so that we have the declarations.
-                VariableListSP vars = frame->GetInScopeVariableList(true);
-                for (size_t i = 0; i < vars->GetSize(); i++)
-                    vars->GetVariableAtIndex(i)->GetDecl();
+                // The frame keeps its variable list until the process runs, so this only
+                // needs to be done for the first name of the expression.
+                if (!m_parser_vars->m_frame_var_decls_parsed)
+                {
+                    VariableListSP vars = frame->GetInScopeVariableList(true);
+                    for (size_t i = 0; i < vars->GetSize(); i++)
+                        vars->GetVariableAtIndex(i)->GetDecl();
+                    m_parser_vars->m_frame_var_decls_parsed = true;
+                }
 
                 // Search for declarations matching the name. Do not include imported decls
                 // in the search if we are looking for decls in the artificial namespace
@@ -1319,17 +1325,10 @@ ClangExpressionDeclMap::FindExternalVisibleDecls (NameSearchContext &context,
             }
             else if (target && !namespace_decl)
             {
-                const bool include_symbols = true;
-
                 // TODO Fix FindFunctions so that it doesn't return
                 //   instance methods for eFunctionNameTypeBase.
 
-                target->GetImages().FindFunctions(name,
-                                                  eFunctionNameTypeFull,
-                                                  include_symbols,
-                                                  include_inlines,
-                                                  append,
-                                                  sc_list);
+                target->FindFunctionsForExpressions(name, sc_list);
             }
 
             // If we found more than one function, see if we can use the
@@ -407,6 +407,7 @@ private:
         TargetInfo                  m_target_info;                  ///< Basic information about the target.
         Materializer               *m_materializer = nullptr;       ///< If non-NULL, the materializer to use when reporting used variables.
         clang::ASTConsumer         *m_code_gen = nullptr;           ///< If non-NULL, a code generator that receives new top-level functions.
+        bool                        m_frame_var_decls_parsed = false; ///< True once the decls of the frame's in-scope variables were created.
     private:
         ClangExpressionDeclMap     &m_decl_map;
         DISALLOW_COPY_AND_ASSIGN (ParserVars);
@@ -9,6 +9,9 @@
 
 // C Includes
 // C++ Includes
+#include <mutex>
+#include <set>
+
 // Other libraries and framework includes
 #include "clang/AST/ASTContext.h"
 #include "clang/AST/ASTDiagnostic.h"
@@ -91,6 +94,7 @@
 #include "lldb/Target/Target.h"
 #include "lldb/Target/ThreadPlanCallFunction.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/LLVMTargets.h"
 
 using namespace clang;
 using namespace llvm;
@@ -252,6 +256,116 @@ private:
 // Implementation of ClangExpressionParser
 //===----------------------------------------------------------------------===//
 
+static void
+SetupTargetOptions (clang::TargetOptions &target_opts, const ArchSpec &target_arch, Log *log)
+{
+    if (target_arch.IsValid())
+    {
+        target_opts.Triple = target_arch.GetTriple().str();
+        if (log)
+            log->Printf("Using %s as the target triple", target_opts.Triple.c_str());
+    }
+    else
+    {
+        // If we get here we don't have a valid target and just have to guess.
+        // Sometimes this will be ok to just use the host target triple (when we evaluate say "2+3", but other
+        // expressions like breakpoint conditions and other things that _are_ target specific really shouldn't just be
+        // using the host triple. In such a case the language runtime should expose an overridden options set (3),
+        // below.
+        target_opts.Triple = llvm::sys::getDefaultTargetTriple();
+        if (log)
+            log->Printf("Using default target triple of %s", target_opts.Triple.c_str());
+    }
+    // Now add some special fixes for known architectures:
+    // Any arm32 iOS environment, but not on arm64
+    if (target_opts.Triple.find("arm64") == std::string::npos &&
+        target_opts.Triple.find("arm") != std::string::npos &&
+        target_opts.Triple.find("ios") != std::string::npos)
+    {
+        target_opts.ABI = "apcs-gnu";
+    }
+    // Supported subsets of x86
+    const auto target_machine = target_arch.GetMachine();
+    if (target_machine == llvm::Triple::x86 ||
+        target_machine == llvm::Triple::x86_64)
+    {
+        target_opts.Features.push_back("+sse");
+        target_opts.Features.push_back("+sse2");
+    }
+
+    // Set the target CPU to generate code for.
+    // This will be empty for any CPU that doesn't really need to make a special CPU string.
+    target_opts.CPU = target_arch.GetClangTargetCPU();
+
+    // Set the target ABI
+    std::string abi = ClangExpressionParser::GetClangTargetABI(target_arch);
+    if (!abi.empty())
+        target_opts.ABI = abi;
+}
+
+void
+ClangExpressionParser::WarmUp (const ArchSpec &target_arch)
+{
+    // What is left to pay for is shared by all the parsers for a triple,
+    // so each triple is only warmed up once.
+    static std::mutex s_warmed_up_triples_mutex;
+    static std::set<std::string> s_warmed_up_triples;
+
+    std::string triple = target_arch.IsValid() ? target_arch.GetTriple().str() : llvm::sys::getDefaultTargetTriple();
+    {
+        std::lock_guard<std::mutex> guard(s_warmed_up_triples_mutex);
+        if (!s_warmed_up_triples.insert(triple).second)
+            return;
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    if (log)
+        log->Printf("Warming up the expression parser for %s", triple.c_str());
+
+    // The LLVM targets are registered on first use and expressions are
+    // JIT compiled with them.
+    InitializeLLVMTargets();
+
+    // Go through the same steps as the constructor, without an expression
+    // to parse. This brings in the parts of Clang that are only touched
+    // when a compiler and code generator are first set up.
+    std::unique_ptr<CompilerInstance> compiler(new CompilerInstance());
+    SetupTargetOptions(compiler->getTargetOpts(), target_arch, nullptr);
+    compiler->createDiagnostics(new clang::IgnoringDiagConsumer());
+    compiler->setTarget(TargetInfo::CreateTargetInfo(compiler->getDiagnostics(), compiler->getInvocation().TargetOpts));
+    if (!compiler->hasTarget())
+        return;
+
+    compiler->getLangOpts().ObjC1 = true;
+    compiler->getLangOpts().ObjC2 = true;
+    compiler->getLangOpts().CPlusPlus = true;
+    compiler->getLangOpts().CPlusPlus11 = true;
+    compiler->getLangOpts().DebuggerSupport = true;
+    compiler->getTarget().adjust(compiler->getLangOpts());
+
+    compiler->createFileManager();
+    compiler->createSourceManager(compiler->getFileManager());
+    compiler->createPreprocessor(TU_Complete);
+
+    SelectorTable selector_table;
+    Builtin::Context builtin_context;
+    ASTContext ast_context(compiler->getLangOpts(),
+                           compiler->getSourceManager(),
+                           compiler->getPreprocessor().getIdentifierTable(),
+                           selector_table,
+                           builtin_context);
+    ast_context.InitBuiltinTypes(compiler->getTarget());
+
+    LLVMContext llvm_context;
+    std::unique_ptr<CodeGenerator> code_generator(CreateLLVMCodeGen(compiler->getDiagnostics(),
+                                                                    "$__lldb_warm_up",
+                                                                    compiler->getHeaderSearchOpts(),
+                                                                    compiler->getPreprocessorOpts(),
+                                                                    compiler->getCodeGenOpts(),
+                                                                    llvm_context));
+    code_generator->Initialize(ast_context);
+}
+
 ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
                                               Expression &expr,
                                               bool generate_debug_info) :
@@ -287,12 +401,9 @@ ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
     bool overridden_target_opts = false;
     lldb_private::LanguageRuntime *lang_rt = nullptr;
 
-    std::string abi;
     ArchSpec target_arch;
     target_arch = target_sp->GetArchitecture();
 
-    const auto target_machine = target_arch.GetMachine();
-
     // If the expression is being evaluated in the context of an existing
     // stack frame, we introspect to see if the language runtime is available.
     
@@ -313,48 +424,7 @@ ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
 
     // 2. Configure the compiler with a set of default options that are appropriate
     // for most situations.
-    if (target_arch.IsValid())
-    {
-        std::string triple = target_arch.GetTriple().str();
-        m_compiler->getTargetOpts().Triple = triple;
-        if (log)
-            log->Printf("Using %s as the target triple", m_compiler->getTargetOpts().Triple.c_str());
-    }
-    else
-    {
-        // If we get here we don't have a valid target and just have to guess.
-        // Sometimes this will be ok to just use the host target triple (when we evaluate say "2+3", but other
-        // expressions like breakpoint conditions and other things that _are_ target specific really shouldn't just be
-        // using the host triple. In such a case the language runtime should expose an overridden options set (3),
-        // below.
-        m_compiler->getTargetOpts().Triple = llvm::sys::getDefaultTargetTriple();
-        if (log)
-            log->Printf("Using default target triple of %s", m_compiler->getTargetOpts().Triple.c_str());
-    }
-    // Now add some special fixes for known architectures:
-    // Any arm32 iOS environment, but not on arm64
-    if (m_compiler->getTargetOpts().Triple.find("arm64") == std::string::npos &&
-        m_compiler->getTargetOpts().Triple.find("arm") != std::string::npos &&
-        m_compiler->getTargetOpts().Triple.find("ios") != std::string::npos)
-    {
-        m_compiler->getTargetOpts().ABI = "apcs-gnu";
-    }
-    // Supported subsets of x86
-    if (target_machine == llvm::Triple::x86 ||
-        target_machine == llvm::Triple::x86_64)
-    {
-        m_compiler->getTargetOpts().Features.push_back("+sse");
-        m_compiler->getTargetOpts().Features.push_back("+sse2");
-    }
-
-    // Set the target CPU to generate code for.
-    // This will be empty for any CPU that doesn't really need to make a special CPU string.
-    m_compiler->getTargetOpts().CPU = target_arch.GetClangTargetCPU();
-
-    // Set the target ABI
-    abi = GetClangTargetABI(target_arch);
-    if (!abi.empty())
-        m_compiler->getTargetOpts().ABI = abi;
+    SetupTargetOptions(m_compiler->getTargetOpts(), target_arch, log);
 
     // 3. Now allow the runtime to provide custom configuration options for the target.
     // In this case, a specialized language runtime is available and we can query it for extra options.
@@ -875,6 +945,18 @@ ClangExpressionParser::PrepareForExecution (lldb::addr_t &func_addr,
                 err.SetErrorStringWithFormat("Can't run the expression locally: %s", interpret_error.AsCString());
                 return err;
             }
+
+            if (target)
+            {
+                if (can_interpret)
+                    target->RecordExpressionInterpreted();
+                else
+                    target->RecordExpressionJITed(interpret_error.AsCString());
+            }
+        }
+        else if (target && execution_policy == eExecutionPolicyAlways)
+        {
+            target->RecordExpressionJITed("the expression was required to run in the target");
         }
 
         if (!ir_can_run)
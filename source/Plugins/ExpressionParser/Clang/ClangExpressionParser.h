@@ -147,8 +147,23 @@ public:
     /// @return
     ///     A string representing target ABI for the current architecture.
     //-------------------------------------------------------------------
-    std::string
+    static std::string
     GetClangTargetABI (const ArchSpec &target_arch);
+
+    //------------------------------------------------------------------
+    /// Pay the one-time costs of the first expression for a target
+    /// architecture ahead of time.
+    ///
+    /// Registers the LLVM targets and sets up and discards a compiler
+    /// instance and code generator for the triple. Only the first call
+    /// for a triple does any work. This doesn't touch any target state
+    /// and can be called on any thread.
+    ///
+    /// @param[in] target_arch
+    ///     The architecture of the target expressions will run in.
+    //------------------------------------------------------------------
+    static void
+    WarmUp (const ArchSpec &target_arch);
  
 private:
     std::unique_ptr<llvm::LLVMContext>       m_llvm_context;         ///< The LLVM context to generate IR into
@@ -13,12 +13,14 @@
 
 // Other libraries and framework includes
 #include "clang/Basic/TargetInfo.h"
+#include "clang/Basic/Version.h"
 #include "clang/Frontend/CompilerInstance.h"
 #include "clang/Frontend/FrontendActions.h"
 #include "clang/Lex/Preprocessor.h"
 #include "clang/Parse/Parser.h"
 #include "clang/Sema/Lookup.h"
 #include "clang/Serialization/ASTReader.h"
+#include "llvm/Support/MD5.h"
 
 // Project includes
 #include "ClangModulesDeclVendor.h"
@@ -29,6 +31,7 @@
 #include "lldb/Host/Host.h"
 #include "lldb/Host/HostInfo.h"
 #include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Target/Platform.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Utility/LLDBAssert.h"
 
@@ -89,6 +92,9 @@ namespace {
         void
         ForEachMacro(const ModuleVector &modules,
                      std::function<bool (const std::string &)> handler) override;
+
+        const std::string &
+        GetMacroDefinitions(const ModuleVector &modules) override;
         
     private:
         void
@@ -115,6 +121,11 @@ namespace {
         typedef std::set<ModuleID>                          ImportedModuleSet;
         ImportedModuleMap                                   m_imported_modules;
         ImportedModuleSet                                   m_user_imported_modules;
+
+        // Importing a module can change which definition of a macro wins,
+        // so this is cleared whenever a module is imported.
+        typedef std::map<ModuleVector, std::string>         MacroDefinitionsMap;
+        MacroDefinitionsMap                                 m_macro_definitions;
     };
 } // anonymous namespace
 
@@ -314,6 +325,7 @@ ClangModulesDeclVendorImpl::AddModule(ModulePath &path,
         }
 
         m_imported_modules[imported_module] = requested_module;
+        m_macro_definitions.clear();
         
         m_enabled = true;
         
@@ -602,6 +614,30 @@ ClangModulesDeclVendorImpl::ForEachMacro(const ClangModulesDeclVendor::ModuleVec
     }
 }
 
+const std::string &
+ClangModulesDeclVendorImpl::GetMacroDefinitions(const ClangModulesDeclVendor::ModuleVector &modules)
+{
+    MacroDefinitionsMap::iterator pos = m_macro_definitions.find(modules);
+    
+    if (pos != m_macro_definitions.end())
+        return pos->second;
+    
+    std::string &definitions = m_macro_definitions[modules];
+    
+    ForEachMacro(modules, [&definitions] (const std::string &expansion) -> bool {
+        definitions.append(expansion);
+        definitions.append("\n");
+        return false;
+    });
+    
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    if (log)
+        log->Printf("Computed %" PRIu64 " bytes of macro definitions for %" PRIu64 " modules",
+                    (uint64_t)definitions.size(), (uint64_t)modules.size());
+    
+    return definitions;
+}
+
 clang::ModuleLoadResult
 ClangModulesDeclVendorImpl::DoGetModule(clang::ModuleIdPath path,
                                         bool make_visible)
@@ -615,6 +651,60 @@ ClangModulesDeclVendorImpl::DoGetModule(clang::ModuleIdPath path,
 
 static const char *ModuleImportBufferName = "LLDBModulesMemoryBuffer";
 
+//----------------------------------------------------------------------
+// Clang writes the modules it builds to the module cache, and uses the
+// copies there as long as the headers they came from didn't change. The
+// cache is kept with lldb's other caches in the module cache directory so
+// that it outlives the session and the temporary directory, and debuggers
+// running at the same time share it. Clang takes a lock while building a
+// module, so they don't build the same one twice.
+//
+// Modules built by another clang, or for other SDK and search paths or
+// flags can't be used. They go to a directory of their own, named after
+// a hash of the clang version and the arguments, so that they don't
+// replace each other's modules.
+//----------------------------------------------------------------------
+static std::string
+GetModuleCacheArgument (const std::vector<std::string> &compiler_invocation_arguments)
+{
+    llvm::SmallString<128> module_cache_path;
+
+    FileSpec dir_spec = Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory();
+    if (dir_spec)
+    {
+        llvm::MD5 hash;
+        hash.update(clang::getClangFullRepositoryVersion());
+        for (const std::string &arg : compiler_invocation_arguments)
+        {
+            // Include the terminator so that "-I" "a" and "-Ia" differ.
+            hash.update(llvm::StringRef(arg.c_str(), arg.size() + 1));
+        }
+        llvm::MD5::MD5Result hash_result;
+        hash.final(hash_result);
+        llvm::SmallString<32> hash_string;
+        llvm::MD5::stringifyResult(hash_result, hash_string);
+
+        dir_spec.AppendPathComponent("clang_modules");
+        dir_spec.AppendPathComponent(hash_string.c_str());
+        module_cache_path = dir_spec.GetPath();
+    }
+    else
+    {
+        const bool erased_on_reboot = false;
+        llvm::sys::path::system_temp_directory(erased_on_reboot, module_cache_path);
+        llvm::sys::path::append(module_cache_path, "org.llvm.clang");
+        llvm::sys::path::append(module_cache_path, "ModuleCache");
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    if (log)
+        log->Printf("Using clang module cache %s", module_cache_path.c_str());
+
+    std::string module_cache_argument("-fmodules-cache-path=");
+    module_cache_argument.append(module_cache_path.str().str());
+    return module_cache_argument;
+}
+
 lldb_private::ClangModulesDeclVendor *
 ClangModulesDeclVendor::Create(Target &target)
 {
@@ -645,17 +735,6 @@ ClangModulesDeclVendor::Create(Target &target)
 
     // Add additional search paths with { "-I", path } or { "-F", path } here.
    
-    {
-        llvm::SmallString<128> DefaultModuleCache;
-        const bool erased_on_reboot = false;
-        llvm::sys::path::system_temp_directory(erased_on_reboot, DefaultModuleCache);
-        llvm::sys::path::append(DefaultModuleCache, "org.llvm.clang");
-        llvm::sys::path::append(DefaultModuleCache, "ModuleCache");
-        std::string module_cache_argument("-fmodules-cache-path=");
-        module_cache_argument.append(DefaultModuleCache.str().str());
-        compiler_invocation_arguments.push_back(module_cache_argument);
-    }
-    
     FileSpecList &module_search_paths = target.GetClangModuleSearchPaths();
     
     for (size_t spi = 0, spe = module_search_paths.GetSize(); spi < spe; ++spi)
@@ -678,6 +757,8 @@ ClangModulesDeclVendor::Create(Target &target)
         }
     }
     
+    compiler_invocation_arguments.push_back(GetModuleCacheArgument(compiler_invocation_arguments));
+    
     llvm::IntrusiveRefCntPtr<clang::DiagnosticsEngine> diagnostics_engine = clang::CompilerInstance::createDiagnostics(new clang::DiagnosticOptions,
                                                                                                                        new StoringDiagnosticConsumer);
     
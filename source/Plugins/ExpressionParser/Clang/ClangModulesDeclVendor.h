@@ -107,6 +107,23 @@ public:
     virtual void
     ForEachMacro(const ModuleVector &modules,
                  std::function<bool (const std::string &)> handler) = 0;
+
+    //------------------------------------------------------------------
+    /// Get the text of all the #defines for a given set of modules, one
+    /// per line, as ForEachMacro would enumerate them.
+    ///
+    /// Walking the macros of every loaded module is expensive and every
+    /// expression needs the result, so the text is computed once for a
+    /// set of modules and reused until another module is imported.
+    ///
+    /// @param[in] modules
+    ///     The unique IDs for all modules to query, in priority order.
+    ///
+    /// @return
+    ///     The #define directives, or an empty string if there are none.
+    //------------------------------------------------------------------
+    virtual const std::string &
+    GetMacroDefinitions(const ModuleVector &modules) = 0;
     
     //------------------------------------------------------------------
     /// Query whether Clang supports modules for a particular language.
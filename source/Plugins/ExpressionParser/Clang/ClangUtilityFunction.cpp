@@ -93,6 +93,9 @@ ClangUtilityFunction::Install(DiagnosticManager &diagnostic_manager, ExecutionCo
         return false;
     }
 
+    if (FindPrecompiledFunction(exe_ctx))
+        return true;
+
     //////////////////////////
     // Parse the expression
     //
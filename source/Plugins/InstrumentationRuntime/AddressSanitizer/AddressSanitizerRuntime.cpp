@@ -19,10 +19,14 @@
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/ValueObject.h"
+#include "lldb/Core/ValueObjectVariable.h"
 #include "lldb/Expression/UserExpression.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/InstrumentationRuntimeStopInfo.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/Target.h"
@@ -167,6 +171,72 @@ t.description = __asan_get_report_description();
 t
 )";
 
+static StructuredData::ObjectSP
+CreateReportDictionary(addr_t pc, addr_t address, addr_t access_type, addr_t access_size, const std::string &description)
+{
+    return CreateReportDictionary(pc, address, access_type, access_size, description);
+}
+
+// Find a static variable of the runtime by its name and the qualified name
+// of its type, the runtime's statics have common names.
+static VariableSP
+FindRuntimeVariable(const ModuleSP &module_sp, const char *name, const char *type_name)
+{
+    VariableList variables;
+    module_sp->FindGlobalVariables(ConstString(name), nullptr, false, UINT32_MAX, variables);
+    const ConstString type_const_name(type_name);
+    for (size_t i = 0; i < variables.GetSize(); ++i)
+    {
+        VariableSP var_sp = variables.GetVariableAtIndex(i);
+        Type *type = var_sp ? var_sp->GetType() : nullptr;
+        if (type && type->GetQualifiedName() == type_const_name)
+            return var_sp;
+    }
+    return VariableSP();
+}
+
+StructuredData::ObjectSP
+AddressSanitizerRuntime::RetrieveReportDataFromMemory(const ProcessSP &process_sp, const StackFrameSP &frame_sp)
+{
+    // The __asan_get_report_* functions return the members of the
+    // runtime's "static ReportData report_data", which are set before
+    // __asan::AsanDie() is called.
+    VariableSP report_happened_var_sp = FindRuntimeVariable(m_runtime_module, "report_happened", "bool");
+    VariableSP report_data_var_sp = FindRuntimeVariable(m_runtime_module, "report_data", "__asan::ReportData");
+    if (!report_happened_var_sp || !report_data_var_sp)
+        return StructuredData::ObjectSP();
+
+    ValueObjectSP report_happened_sp = ValueObjectVariable::Create(frame_sp.get(), report_happened_var_sp);
+    ValueObjectSP report_data_sp = ValueObjectVariable::Create(frame_sp.get(), report_data_var_sp);
+    if (!report_happened_sp || !report_data_sp)
+        return StructuredData::ObjectSP();
+
+    bool success = false;
+    const uint64_t present = report_happened_sp->GetValueAsUnsigned(0, &success);
+    if (!success)
+        return StructuredData::ObjectSP();
+    if (present != 1)
+        return StructuredData::ObjectSP();
+
+    static const char *g_report_data_members[] = { "pc", "addr", "is_write", "access_size", "description" };
+    uint64_t values[llvm::array_lengthof(g_report_data_members)];
+    for (size_t i = 0; i < llvm::array_lengthof(g_report_data_members); ++i)
+    {
+        ValueObjectSP member_sp = report_data_sp->GetChildMemberWithName(ConstString(g_report_data_members[i]), true);
+        if (!member_sp)
+            return StructuredData::ObjectSP();
+        values[i] = member_sp->GetValueAsUnsigned(0, &success);
+        if (!success)
+            return StructuredData::ObjectSP();
+    }
+
+    std::string description;
+    Error error;
+    process_sp->ReadCStringFromMemory(values[4], description, error);
+
+    return CreateReportDictionary(values[0], values[1], values[2] ? 1 : 0, values[3], description);
+}
+
 StructuredData::ObjectSP
 AddressSanitizerRuntime::RetrieveReportData()
 {
@@ -179,6 +249,12 @@ AddressSanitizerRuntime::RetrieveReportData()
     
     if (!frame_sp)
         return StructuredData::ObjectSP();
+
+    // Reading the report directly is much faster than the expression, but
+    // needs the debug info of the runtime.
+    StructuredData::ObjectSP report = RetrieveReportDataFromMemory(process_sp, frame_sp);
+    if (report)
+        return report;
     
     EvaluateExpressionOptions options;
     options.SetUnwindOnError(true);
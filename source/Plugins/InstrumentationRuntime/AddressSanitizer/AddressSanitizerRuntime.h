@@ -83,6 +83,11 @@ private:
     
     StructuredData::ObjectSP
     RetrieveReportData();
+
+    // Read the report from the runtime's globals with the types of its
+    // debug info, without running an expression.
+    StructuredData::ObjectSP
+    RetrieveReportDataFromMemory(const lldb::ProcessSP &process_sp, const lldb::StackFrameSP &frame_sp);
     
     std::string
     FormatDescription(StructuredData::ObjectSP report);
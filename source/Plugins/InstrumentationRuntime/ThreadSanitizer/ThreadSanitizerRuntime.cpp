@@ -22,9 +22,11 @@
 #include "lldb/Expression/UserExpression.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
 #include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/Type.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/Variable.h"
 #include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/ABI.h"
 #include "lldb/Target/InstrumentationRuntimeStopInfo.h"
 #include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/StopInfo.h"
@@ -72,7 +74,9 @@ ThreadSanitizerRuntime::ThreadSanitizerRuntime(const ProcessSP &process_sp) :
 m_is_active(false),
 m_runtime_module_wp(),
 m_process_wp(),
-m_breakpoint_id(0)
+m_breakpoint_id(0),
+m_report_desc_type(),
+m_report_desc_type_searched(false)
 {
     if (process_sp)
         m_process_wp = process_sp;
@@ -312,25 +316,26 @@ RetrieveString(ValueObjectSP return_value_sp, ProcessSP process_sp, std::string
     return str;
 }
 
+static user_id_t
+GetThreadIndexID(ProcessSP process_sp, uint64_t thread_os_id)
+{
+    bool can_update = true;
+    ThreadSP lldb_thread = process_sp->GetThreadList().FindThreadByID(thread_os_id, can_update);
+    if (lldb_thread)
+        return lldb_thread->GetIndexID();
+
+    // This isn't a live thread anymore.  Ask process to assign a new Index ID (or return an old one if we've already seen this thread_os_id).
+    // It will also make sure that no new threads are assigned this Index ID.
+    return process_sp->AssignIndexIDToThread(thread_os_id);
+}
+
 static void
 GetRenumberedThreadIds(ProcessSP process_sp, ValueObjectSP data, std::map<uint64_t, user_id_t> &thread_id_map)
 {
     ConvertToStructuredArray(data, ".threads", ".thread_count", [process_sp, &thread_id_map] (ValueObjectSP o, StructuredData::Dictionary *dict) {
         uint64_t thread_id = o->GetValueForExpressionPath(".tid")->GetValueAsUnsigned(0);
         uint64_t thread_os_id = o->GetValueForExpressionPath(".os_id")->GetValueAsUnsigned(0);
-        user_id_t lldb_user_id = 0;
-        
-        bool can_update = true;
-        ThreadSP lldb_thread = process_sp->GetThreadList().FindThreadByID(thread_os_id, can_update);
-        if (lldb_thread) {
-            lldb_user_id = lldb_thread->GetIndexID();
-        } else {
-            // This isn't a live thread anymore.  Ask process to assign a new Index ID (or return an old one if we've already seen this thread_os_id).
-            // It will also make sure that no new threads are assigned this Index ID.
-            lldb_user_id = process_sp->AssignIndexIDToThread(thread_os_id);
-        }
-        
-        thread_id_map[thread_id] = lldb_user_id;
+        thread_id_map[thread_id] = GetThreadIndexID(process_sp, thread_os_id);
     });
 }
 
@@ -341,6 +346,324 @@ static user_id_t Renumber(uint64_t id, std::map<uint64_t, user_id_t> &thread_id_
     return thread_id_map[id];
 }
 
+//------------------------------------------------------------------
+// Reading the report without an expression. The __tsan_get_report_*
+// functions copy the members of the runtime's ReportDesc, with the types
+// of the runtime's debug info the same members can be read directly.
+// Like the expression, at most REPORT_ARRAY_SIZE elements of the arrays of
+// the report are read and CreateStackTrace only keeps 8 frames.
+//------------------------------------------------------------------
+static const size_t g_max_report_array_size = 4;
+static const size_t g_max_report_trace_size = 8;
+
+static ValueObjectSP
+GetMember(const ValueObjectSP &valobj_sp, const char *name)
+{
+    if (!valobj_sp)
+        return ValueObjectSP();
+    return valobj_sp->GetChildMemberWithName(ConstString(name), true);
+}
+
+static uint64_t
+GetMemberValue(const ValueObjectSP &valobj_sp, const char *name)
+{
+    ValueObjectSP member_sp = GetMember(valobj_sp, name);
+    return member_sp ? member_sp->GetValueAsUnsigned(0) : 0;
+}
+
+static std::string
+GetMemberString(const ValueObjectSP &valobj_sp, ProcessSP process_sp, const char *name)
+{
+    std::string str;
+    const addr_t ptr = GetMemberValue(valobj_sp, name);
+    if (ptr != 0)
+    {
+        Error error;
+        process_sp->ReadCStringFromMemory(ptr, str, error);
+    }
+    return str;
+}
+
+static ValueObjectSP
+GetPointee(const ValueObjectSP &pointer_sp)
+{
+    if (!pointer_sp || pointer_sp->GetValueAsUnsigned(0) == 0)
+        return ValueObjectSP();
+    Error error;
+    ValueObjectSP pointee_sp = pointer_sp->Dereference(error);
+    if (error.Fail())
+        return ValueObjectSP();
+    return pointee_sp;
+}
+
+// The runtime's Vector keeps its elements between its begin_ and end_
+// pointers.
+static std::vector<ValueObjectSP>
+GetVectorElements(const ValueObjectSP &vector_sp)
+{
+    std::vector<ValueObjectSP> elements;
+    ValueObjectSP begin_sp = GetMember(vector_sp, "begin_");
+    if (!begin_sp)
+        return elements;
+
+    const addr_t begin = begin_sp->GetValueAsUnsigned(0);
+    const addr_t end = GetMemberValue(vector_sp, "end_");
+    const uint64_t element_size = begin_sp->GetCompilerType().GetPointeeType().GetByteSize(nullptr);
+    if (begin == 0 || end <= begin || element_size == 0)
+        return elements;
+
+    const size_t count = std::min<size_t>((end - begin) / element_size, g_max_report_array_size);
+    for (size_t i = 0; i < count; i++)
+    {
+        ValueObjectSP element_sp = begin_sp->GetSyntheticArrayMember(i, true);
+        if (!element_sp)
+            break;
+        elements.push_back(element_sp);
+    }
+    return elements;
+}
+
+// A ReportStack has a list of SymbolizedStack frames.
+static StructuredData::Array *
+CreateStackTraceFromReportStack(const ValueObjectSP &stack_pointer_sp)
+{
+    StructuredData::Array *trace = new StructuredData::Array();
+    ValueObjectSP frame_sp = GetPointee(GetMember(GetPointee(stack_pointer_sp), "frames"));
+    for (size_t j = 0; frame_sp && j < g_max_report_trace_size; j++)
+    {
+        addr_t trace_addr = GetMemberValue(GetMember(frame_sp, "info"), "address");
+        if (trace_addr == 0)
+            break;
+        trace->AddItem(StructuredData::ObjectSP(new StructuredData::Integer(trace_addr)));
+        frame_sp = GetPointee(GetMember(frame_sp, "next"));
+    }
+    return trace;
+}
+
+// The issue types __tsan_get_report_data returns for the ReportType
+// enumerators.
+static const char *
+GetReportTypeDescription(const char *report_type)
+{
+    static const char *g_report_types[][2] =
+    {
+        { "ReportTypeRace",                 "data-race" },
+        { "ReportTypeVptrRace",             "data-race-vptr" },
+        { "ReportTypeUseAfterFree",         "heap-use-after-free" },
+        { "ReportTypeVptrUseAfterFree",     "heap-use-after-free-vptr" },
+        { "ReportTypeThreadLeak",           "thread-leak" },
+        { "ReportTypeMutexDestroyLocked",   "locked-mutex-destroy" },
+        { "ReportTypeMutexDoubleLock",      "mutex-double-lock" },
+        { "ReportTypeMutexInvalidAccess",   "mutex-invalid-access" },
+        { "ReportTypeMutexBadUnlock",       "mutex-bad-unlock" },
+        { "ReportTypeMutexBadReadLock",     "mutex-bad-read-lock" },
+        { "ReportTypeMutexBadReadUnlock",   "mutex-bad-read-unlock" },
+        { "ReportTypeSignalUnsafe",         "signal-unsafe-call" },
+        { "ReportTypeErrnoInSignal",        "errno-in-signal-handler" },
+        { "ReportTypeDeadlock",             "lock-order-inversion" }
+    };
+
+    if (report_type == nullptr)
+        return nullptr;
+    for (size_t i = 0; i < llvm::array_lengthof(g_report_types); i++)
+    {
+        if (::strcmp(report_type, g_report_types[i][0]) == 0)
+            return g_report_types[i][1];
+    }
+    return nullptr;
+}
+
+static const char *
+GetLocationTypeDescription(const char *location_type)
+{
+    static const char *g_location_types[][2] =
+    {
+        { "ReportLocationGlobal",   "global" },
+        { "ReportLocationHeap",     "heap" },
+        { "ReportLocationStack",    "stack" },
+        { "ReportLocationTLS",      "tls" },
+        { "ReportLocationFD",       "fd" }
+    };
+
+    if (location_type == nullptr)
+        return nullptr;
+    for (size_t i = 0; i < llvm::array_lengthof(g_location_types); i++)
+    {
+        if (::strcmp(location_type, g_location_types[i][0]) == 0)
+            return g_location_types[i][1];
+    }
+    return nullptr;
+}
+
+CompilerType
+ThreadSanitizerRuntime::GetReportDescType()
+{
+    if (!m_report_desc_type_searched)
+    {
+        m_report_desc_type_searched = true;
+        ModuleSP runtime_module_sp = GetRuntimeModuleSP();
+        if (runtime_module_sp)
+        {
+            SymbolContext sc;
+            TypeSP type_sp = runtime_module_sp->FindFirstType(sc, ConstString("__tsan::ReportDesc"), true);
+            if (type_sp)
+                m_report_desc_type = type_sp->GetFullCompilerType();
+        }
+    }
+    return m_report_desc_type;
+}
+
+StructuredData::ObjectSP
+ThreadSanitizerRuntime::RetrieveReportDataFromMemory(ExecutionContextRef exe_ctx_ref)
+{
+    ProcessSP process_sp = GetProcessSP();
+    ThreadSP thread_sp = exe_ctx_ref.GetThreadSP();
+    if (!process_sp || !thread_sp)
+        return StructuredData::ObjectSP();
+
+    CompilerType report_desc_type = GetReportDescType();
+    const ABISP &abi_sp = process_sp->GetABI();
+    if (!report_desc_type.IsValid() || !abi_sp)
+        return StructuredData::ObjectSP();
+
+    // The breakpoint is on the first instruction of
+    // __tsan_on_report(const ReportDesc *rep).
+    ValueList argument_values;
+    Value input_value;
+    input_value.SetValueType(Value::eValueTypeScalar);
+    input_value.SetCompilerType(report_desc_type.GetPointerType());
+    argument_values.PushValue(input_value);
+    if (!abi_sp->GetArgumentValues(*thread_sp, argument_values))
+        return StructuredData::ObjectSP();
+    const addr_t report_addr = argument_values.GetValueAtIndex(0)->GetScalar().ULongLong(0);
+    if (report_addr == 0)
+        return StructuredData::ObjectSP();
+
+    ExecutionContext exe_ctx(exe_ctx_ref);
+    ValueObjectSP report_sp = ValueObject::CreateValueObjectFromAddress("report", report_addr, exe_ctx, report_desc_type);
+    if (!report_sp)
+        return StructuredData::ObjectSP();
+
+    // Let the expression handle runtimes whose reports look different.
+    static const char *g_report_members[] = { "count", "sleep", "stacks", "mops", "locs", "mutexes", "threads", "unique_tids" };
+    for (size_t i = 0; i < llvm::array_lengthof(g_report_members); i++)
+    {
+        if (!GetMember(report_sp, g_report_members[i]))
+            return StructuredData::ObjectSP();
+    }
+    ValueObjectSP type_sp = GetMember(report_sp, "typ");
+    const char *issue_type = type_sp ? GetReportTypeDescription(type_sp->GetValueAsCString()) : nullptr;
+    if (issue_type == nullptr)
+        return StructuredData::ObjectSP();
+
+    std::vector<ValueObjectSP> threads = GetVectorElements(GetMember(report_sp, "threads"));
+    std::map<uint64_t, user_id_t> thread_id_map;
+    for (const ValueObjectSP &thread_pointer_sp : threads)
+    {
+        ValueObjectSP thread_sp = GetPointee(thread_pointer_sp);
+        thread_id_map[GetMemberValue(thread_sp, "id")] = GetThreadIndexID(process_sp, GetMemberValue(thread_sp, "os_id"));
+    }
+
+    StructuredData::Dictionary *dict = new StructuredData::Dictionary();
+    dict->AddStringItem("instrumentation_class", "ThreadSanitizer");
+    dict->AddStringItem("issue_type", issue_type);
+    dict->AddIntegerItem("report_count", GetMemberValue(report_sp, "count"));
+    dict->AddItem("sleep_trace", StructuredData::ObjectSP(CreateStackTraceFromReportStack(GetMember(report_sp, "sleep"))));
+
+    StructuredData::Array *stacks = new StructuredData::Array();
+    std::vector<ValueObjectSP> stack_elements = GetVectorElements(GetMember(report_sp, "stacks"));
+    for (size_t i = 0; i < stack_elements.size(); i++)
+    {
+        StructuredData::Dictionary *stack_dict = new StructuredData::Dictionary();
+        stack_dict->AddIntegerItem("index", i);
+        stack_dict->AddItem("trace", StructuredData::ObjectSP(CreateStackTraceFromReportStack(stack_elements[i])));
+        stacks->AddItem(StructuredData::ObjectSP(stack_dict));
+    }
+    dict->AddItem("stacks", StructuredData::ObjectSP(stacks));
+
+    StructuredData::Array *mops = new StructuredData::Array();
+    std::vector<ValueObjectSP> mop_elements = GetVectorElements(GetMember(report_sp, "mops"));
+    for (size_t i = 0; i < mop_elements.size(); i++)
+    {
+        ValueObjectSP mop_sp = GetPointee(mop_elements[i]);
+        StructuredData::Dictionary *mop_dict = new StructuredData::Dictionary();
+        mop_dict->AddIntegerItem("index", i);
+        mop_dict->AddIntegerItem("thread_id", Renumber(GetMemberValue(mop_sp, "tid"), thread_id_map));
+        mop_dict->AddIntegerItem("size", GetMemberValue(mop_sp, "size"));
+        mop_dict->AddBooleanItem("is_write", GetMemberValue(mop_sp, "write"));
+        mop_dict->AddBooleanItem("is_atomic", GetMemberValue(mop_sp, "atomic"));
+        mop_dict->AddIntegerItem("address", GetMemberValue(mop_sp, "addr"));
+        mop_dict->AddItem("trace", StructuredData::ObjectSP(CreateStackTraceFromReportStack(GetMember(mop_sp, "stack"))));
+        mops->AddItem(StructuredData::ObjectSP(mop_dict));
+    }
+    dict->AddItem("mops", StructuredData::ObjectSP(mops));
+
+    StructuredData::Array *locs = new StructuredData::Array();
+    std::vector<ValueObjectSP> loc_elements = GetVectorElements(GetMember(report_sp, "locs"));
+    for (size_t i = 0; i < loc_elements.size(); i++)
+    {
+        ValueObjectSP loc_sp = GetPointee(loc_elements[i]);
+        ValueObjectSP loc_type_sp = GetMember(loc_sp, "type");
+        const char *loc_type = loc_type_sp ? GetLocationTypeDescription(loc_type_sp->GetValueAsCString()) : nullptr;
+        StructuredData::Dictionary *loc_dict = new StructuredData::Dictionary();
+        loc_dict->AddIntegerItem("index", i);
+        loc_dict->AddStringItem("type", loc_type ? loc_type : "");
+        loc_dict->AddIntegerItem("address", GetMemberValue(GetMember(loc_sp, "global"), "start"));
+        loc_dict->AddIntegerItem("start", GetMemberValue(loc_sp, "heap_chunk_start"));
+        loc_dict->AddIntegerItem("size", GetMemberValue(loc_sp, "heap_chunk_size"));
+        loc_dict->AddIntegerItem("thread_id", Renumber(GetMemberValue(loc_sp, "tid"), thread_id_map));
+        loc_dict->AddIntegerItem("file_descriptor", GetMemberValue(loc_sp, "fd"));
+        loc_dict->AddIntegerItem("suppressable", GetMemberValue(loc_sp, "suppressable"));
+        loc_dict->AddItem("trace", StructuredData::ObjectSP(CreateStackTraceFromReportStack(GetMember(loc_sp, "stack"))));
+        locs->AddItem(StructuredData::ObjectSP(loc_dict));
+    }
+    dict->AddItem("locs", StructuredData::ObjectSP(locs));
+
+    StructuredData::Array *mutexes = new StructuredData::Array();
+    std::vector<ValueObjectSP> mutex_elements = GetVectorElements(GetMember(report_sp, "mutexes"));
+    for (size_t i = 0; i < mutex_elements.size(); i++)
+    {
+        ValueObjectSP mutex_sp = GetPointee(mutex_elements[i]);
+        StructuredData::Dictionary *mutex_dict = new StructuredData::Dictionary();
+        mutex_dict->AddIntegerItem("index", i);
+        mutex_dict->AddIntegerItem("mutex_id", GetMemberValue(mutex_sp, "id"));
+        mutex_dict->AddIntegerItem("address", GetMemberValue(mutex_sp, "addr"));
+        mutex_dict->AddIntegerItem("destroyed", GetMemberValue(mutex_sp, "destroyed"));
+        mutex_dict->AddItem("trace", StructuredData::ObjectSP(CreateStackTraceFromReportStack(GetMember(mutex_sp, "stack"))));
+        mutexes->AddItem(StructuredData::ObjectSP(mutex_dict));
+    }
+    dict->AddItem("mutexes", StructuredData::ObjectSP(mutexes));
+
+    StructuredData::Array *threads_array = new StructuredData::Array();
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        ValueObjectSP thread_sp = GetPointee(threads[i]);
+        StructuredData::Dictionary *thread_dict = new StructuredData::Dictionary();
+        thread_dict->AddIntegerItem("index", i);
+        thread_dict->AddIntegerItem("thread_id", Renumber(GetMemberValue(thread_sp, "id"), thread_id_map));
+        thread_dict->AddIntegerItem("thread_os_id", GetMemberValue(thread_sp, "os_id"));
+        thread_dict->AddIntegerItem("running", GetMemberValue(thread_sp, "running"));
+        thread_dict->AddStringItem("name", GetMemberString(thread_sp, process_sp, "name"));
+        thread_dict->AddIntegerItem("parent_thread_id", Renumber(GetMemberValue(thread_sp, "parent_tid"), thread_id_map));
+        thread_dict->AddItem("trace", StructuredData::ObjectSP(CreateStackTraceFromReportStack(GetMember(thread_sp, "stack"))));
+        threads_array->AddItem(StructuredData::ObjectSP(thread_dict));
+    }
+    dict->AddItem("threads", StructuredData::ObjectSP(threads_array));
+
+    StructuredData::Array *unique_tids = new StructuredData::Array();
+    std::vector<ValueObjectSP> unique_tid_elements = GetVectorElements(GetMember(report_sp, "unique_tids"));
+    for (size_t i = 0; i < unique_tid_elements.size(); i++)
+    {
+        StructuredData::Dictionary *unique_tid_dict = new StructuredData::Dictionary();
+        unique_tid_dict->AddIntegerItem("index", i);
+        unique_tid_dict->AddIntegerItem("tid", Renumber(unique_tid_elements[i]->GetValueAsUnsigned(0), thread_id_map));
+        unique_tids->AddItem(StructuredData::ObjectSP(unique_tid_dict));
+    }
+    dict->AddItem("unique_tids", StructuredData::ObjectSP(unique_tids));
+
+    return StructuredData::ObjectSP(dict);
+}
+
 StructuredData::ObjectSP
 ThreadSanitizerRuntime::RetrieveReportData(ExecutionContextRef exe_ctx_ref)
 {
@@ -353,6 +676,12 @@ ThreadSanitizerRuntime::RetrieveReportData(ExecutionContextRef exe_ctx_ref)
     
     if (!frame_sp)
         return StructuredData::ObjectSP();
+
+    // Reading the report directly is much faster than the expression, but
+    // needs the debug info of the runtime.
+    StructuredData::ObjectSP report = RetrieveReportDataFromMemory(exe_ctx_ref);
+    if (report)
+        return report;
     
     EvaluateExpressionOptions options;
     options.SetUnwindOnError(true);
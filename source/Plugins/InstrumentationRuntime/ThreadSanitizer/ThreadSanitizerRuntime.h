@@ -19,6 +19,7 @@
 #include "lldb/Target/InstrumentationRuntime.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Core/StructuredData.h"
+#include "lldb/Symbol/CompilerType.h"
 
 namespace lldb_private {
     
@@ -92,6 +93,14 @@ private:
     
     StructuredData::ObjectSP
     RetrieveReportData(ExecutionContextRef exe_ctx_ref);
+
+    // Read the report from the runtime's ReportDesc with the types of its
+    // debug info, without running an expression.
+    StructuredData::ObjectSP
+    RetrieveReportDataFromMemory(ExecutionContextRef exe_ctx_ref);
+
+    CompilerType
+    GetReportDescType();
     
     std::string
     FormatDescription(StructuredData::ObjectSP report);
@@ -112,6 +121,8 @@ private:
     lldb::ModuleWP m_runtime_module_wp;
     lldb::ProcessWP m_process_wp;
     lldb::user_id_t m_breakpoint_id;
+    CompilerType m_report_desc_type;
+    bool m_report_desc_type_searched;
 };
     
 } // namespace lldb_private
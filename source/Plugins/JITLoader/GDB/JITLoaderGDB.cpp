@@ -8,6 +8,9 @@
 //===----------------------------------------------------------------------===//
 
 // C Includes
+// C++ Includes
+#include <algorithm>
+#include <vector>
 
 #include "llvm/Support/MathExtras.h"
 
@@ -137,6 +140,56 @@ namespace {
         return true;
     }
 
+    //------------------------------------------------------------------
+    // Read the images of many JIT entries with as few memory reads as
+    // possible. JIT memory managers usually allocate the objects next to
+    // each other, so the images are read in spans that cover several of
+    // them. The spans end up in the L1 memory cache, where reading the
+    // images one by one finds them.
+    //------------------------------------------------------------------
+    template <typename ptr_t>
+    void PrefetchJITImages(Process *process, const std::vector<jit_code_entry<ptr_t>> &entries)
+    {
+        if (entries.size() < 2 || process->GetDisableMemoryCache())
+            return;
+
+        typedef std::pair<addr_t, addr_t> ImageRange;
+        std::vector<ImageRange> image_ranges;
+        image_ranges.reserve(entries.size());
+        for (const jit_code_entry<ptr_t> &entry : entries)
+        {
+            if (entry.symfile_addr != 0 && entry.symfile_size != 0)
+                image_ranges.push_back(ImageRange(entry.symfile_addr, entry.symfile_addr + entry.symfile_size));
+        }
+        std::sort(image_ranges.begin(), image_ranges.end());
+
+        const addr_t max_gap = 4096;
+        const addr_t max_read_size = 16 * 1024 * 1024;
+        size_t idx = 0;
+        while (idx < image_ranges.size())
+        {
+            const addr_t base = image_ranges[idx].first;
+            addr_t end = image_ranges[idx].second;
+            size_t next_idx = idx + 1;
+            while (next_idx < image_ranges.size() &&
+                   image_ranges[next_idx].first <= end + max_gap &&
+                   std::max(end, image_ranges[next_idx].second) - base <= max_read_size)
+            {
+                end = std::max(end, image_ranges[next_idx].second);
+                ++next_idx;
+            }
+
+            // A single image is read when its module is created.
+            if (next_idx - idx > 1)
+            {
+                Error error;
+                DataBufferHeap data(end - base, 0);
+                process->ReadMemory(base, data.GetBytes(), data.GetByteSize(), error);
+            }
+            idx = next_idx;
+        }
+    }
+
 }  // anonymous namespace end
 
 JITLoaderGDB::JITLoaderGDB (lldb_private::Process *process) :
@@ -338,6 +391,9 @@ JITLoaderGDB::ReadJITDescriptorImpl(bool all_entries)
         jit_relevant_entry = (addr_t)jit_desc.first_entry;
     }
 
+    // Read all the entries before the images so that the images of the
+    // entries can be read together.
+    std::vector<jit_code_entry<ptr_t>> jit_entries;
     while (jit_relevant_entry != 0)
     {
         jit_code_entry<ptr_t> jit_entry;
@@ -347,9 +403,28 @@ JITLoaderGDB::ReadJITDescriptorImpl(bool all_entries)
                 log->Printf(
                     "JITLoaderGDB::%s failed to read JIT entry at 0x%" PRIx64,
                     __FUNCTION__, jit_relevant_entry);
-            return false;
+            break;
         }
 
+        // Objects that are loaded already don't need to be read again.
+        if (jit_action != JIT_REGISTER_FN ||
+            m_jit_objects.find((addr_t)jit_entry.symfile_addr) == m_jit_objects.end())
+            jit_entries.push_back(jit_entry);
+
+        if (all_entries)
+            jit_relevant_entry = (addr_t)jit_entry.next_entry;
+        else
+            jit_relevant_entry = 0;
+    }
+
+    if (jit_action == JIT_REGISTER_FN)
+        PrefetchJITImages(m_process, jit_entries);
+
+    // The target is told about all the new modules at once, each call
+    // resolves the breakpoints and loads the scripts of the modules.
+    ModuleList loaded_module_list;
+    for (const jit_code_entry<ptr_t> &jit_entry : jit_entries)
+    {
         const addr_t &symbolfile_addr = (addr_t)jit_entry.symfile_addr;
         const size_t &symbolfile_size = (size_t)jit_entry.symfile_size;
         ModuleSP module_sp;
@@ -396,10 +471,7 @@ JITLoaderGDB::ReadJITDescriptorImpl(bool all_entries)
                 }
 
                 module_list.AppendIfNeeded(module_sp);
-
-                ModuleList module_list;
-                module_list.Append(module_sp);
-                target.ModulesDidLoad(module_list);
+                loaded_module_list.Append(module_sp);
             }
             else
             {
@@ -449,13 +521,11 @@ JITLoaderGDB::ReadJITDescriptorImpl(bool all_entries)
         {
             assert(false && "Unknown jit action");
         }
-
-        if (all_entries)
-            jit_relevant_entry = (addr_t)jit_entry.next_entry;
-        else
-            jit_relevant_entry = 0;
     }
 
+    if (loaded_module_list.GetSize() > 0)
+        target.ModulesDidLoad(loaded_module_list);
+
     return false; // Continue Running.
 }
 
@@ -15,6 +15,7 @@
 #include <cctype>
 #include <functional>
 #include <mutex>
+#include <vector>
 
 // Other libraries and framework includes
 #include "llvm/ADT/StringRef.h"
@@ -342,6 +343,122 @@ CPlusPlusLanguage::ExtractContextAndIdentifier (const char *name, llvm::StringRe
     return false;
 }
 
+// Consume an Itanium <source-name> ("<length><identifier>") from the start of "name"
+static bool
+ConsumeMangledSourceName (llvm::StringRef &name, std::string &source_name)
+{
+    size_t length = 0;
+    size_t num_digits = 0;
+    while (num_digits < name.size() && isdigit(name[num_digits]))
+    {
+        length = length * 10 + (name[num_digits] - '0');
+        if (++num_digits > 8)
+            return false;
+    }
+    if (num_digits == 0 || length == 0 || length > name.size() - num_digits)
+        return false;
+
+    llvm::StringRef identifier = name.substr(num_digits, length);
+    name = name.drop_front(num_digits + length);
+
+    // The demangler spells the anonymous namespace like this
+    if (identifier.startswith("_GLOBAL__N"))
+        source_name = "(anonymous namespace)";
+    else
+        source_name = identifier.str();
+    return true;
+}
+
+bool
+CPlusPlusLanguage::ExtractContextAndIdentifierFromMangledName (const char *mangled_name,
+                                                               std::string &context,
+                                                               std::string &identifier,
+                                                               bool &has_qualifiers)
+{
+    if (!IsCPPMangledName (mangled_name))
+        return false;
+
+    llvm::StringRef name (mangled_name + 2);
+    std::vector<std::string> components;
+    std::string source_name;
+    bool qualifiers = false;
+
+    if (name.startswith("N"))
+    {
+        name = name.drop_front(1);
+
+        // CV and ref qualifiers of a member function
+        while (!name.empty() && (name[0] == 'r' || name[0] == 'V' || name[0] == 'K' || name[0] == 'R' || name[0] == 'O'))
+        {
+            qualifiers = true;
+            name = name.drop_front(1);
+        }
+
+        if (name.startswith("St"))
+        {
+            components.push_back("std");
+            name = name.drop_front(2);
+        }
+
+        while (!name.startswith("E"))
+        {
+            if (name.size() >= 2 && name[0] == 'C' && name[1] >= '1' && name[1] <= '5')
+            {
+                // Constructors are named after their class
+                if (components.empty())
+                    return false;
+                components.push_back(components.back());
+                name = name.drop_front(2);
+            }
+            else if (name.size() >= 2 && name[0] == 'D' && name[1] >= '0' && name[1] <= '5' && name[1] != '3')
+            {
+                if (components.empty())
+                    return false;
+                components.push_back("~" + components.back());
+                name = name.drop_front(2);
+            }
+            else if (ConsumeMangledSourceName (name, source_name))
+                components.push_back(source_name);
+            else
+                return false; // Template arguments, substitutions, operators, ABI tags, ...
+        }
+    }
+    else
+    {
+        // Internal linkage
+        if (name.startswith("L"))
+            name = name.drop_front(1);
+
+        if (name.startswith("St"))
+        {
+            components.push_back("std");
+            name = name.drop_front(2);
+        }
+
+        if (!ConsumeMangledSourceName (name, source_name))
+            return false;
+        components.push_back(source_name);
+
+        // Template arguments and ABI tags show up in the demangled basename
+        if (name.startswith("I") || name.startswith("B"))
+            return false;
+    }
+
+    if (components.empty())
+        return false;
+
+    identifier = components.back();
+    context.clear();
+    for (size_t i = 0; i + 1 < components.size(); ++i)
+    {
+        if (i > 0)
+            context.append("::");
+        context.append(components[i]);
+    }
+    has_qualifiers = qualifiers;
+    return true;
+}
+
 class CPPRuntimeEquivalents
 {
 public:
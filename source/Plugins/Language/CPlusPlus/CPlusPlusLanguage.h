@@ -165,6 +165,18 @@ public:
 
     static bool
     ExtractContextAndIdentifier (const char *name, llvm::StringRef &context, llvm::StringRef &identifier);
+
+    // Extract the C++ context and identifier directly from an Itanium mangled function name without
+    // demangling it (e.g. "_ZNK4lldb8SBTarget20GetBreakpointAtIndexEj" gives "lldb::SBTarget" and
+    // "GetBreakpointAtIndex"). has_qualifiers is set if the mangled name is a cv or ref qualified member
+    // function. Only plain (possibly nested) names, constructors and destructors are handled; if the name
+    // contains template arguments, substitutions, operators or anything else that needs the full demangler
+    // this returns false and leaves the arguments unchanged.
+    static bool
+    ExtractContextAndIdentifierFromMangledName (const char *mangled_name,
+                                                std::string &context,
+                                                std::string &identifier,
+                                                bool &has_qualifiers);
     
     // in some cases, compilers will output different names for one same type. when that happens, it might be impossible
     // to construct SBType objects for a valid type, because the name that is available is not the same as the name that
@@ -9,13 +9,18 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 // Project includes
 #include "LibCxx.h"
 
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/ValueObject.h"
+#include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/DataFormatters/FormattersHelpers.h"
+#include "lldb/Target/Process.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -35,6 +40,9 @@ namespace lldb_private {
             
             lldb::ValueObjectSP
             GetChildAtIndex(size_t idx) override;
+
+            size_t
+            GetChildrenInRange(size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children) override;
             
             bool
             Update() override;
@@ -46,6 +54,10 @@ namespace lldb_private {
             GetIndexOfChildWithName(const ConstString &name) override;
 
         private:
+            // Create the children one by one, each reading its own memory.
+            size_t
+            GetChildrenFromAddress (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children);
+
             ValueObject* m_start;
             ValueObject* m_finish;
             CompilerType m_element_type;
@@ -103,14 +115,93 @@ lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::GetChildAtIndex (siz
     auto cached = m_children.find(idx);
     if (cached != m_children.end())
         return cached->second;
-    
-    uint64_t offset = idx * m_element_size;
-    offset = offset + m_start->GetValueAsUnsigned(0);
-    StreamString name;
-    name.Printf("[%" PRIu64 "]", (uint64_t)idx);
-    ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), offset, m_backend.GetExecutionContextRef(), m_element_type);
-    m_children[idx] = child_sp;
-    return child_sp;
+
+    // Whoever asks for one element usually goes on to ask for the ones after
+    // it, read them along with it.
+    static const size_t g_read_ahead_count = 256;
+    std::vector<lldb::ValueObjectSP> children;
+    if (GetChildrenInRange(idx, g_read_ahead_count, children) == 0 &&
+        GetChildrenFromAddress(idx, 1, children) == 0)
+        return lldb::ValueObjectSP();
+    return children.front();
+}
+
+size_t
+lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::GetChildrenFromAddress (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+{
+    const lldb::addr_t start_addr = m_start->GetValueAsUnsigned(0);
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t idx = start_idx + i;
+        auto cached = m_children.find(idx);
+        if (cached == m_children.end())
+        {
+            StreamString name;
+            name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+            ValueObjectSP child_sp = CreateValueObjectFromAddress(name.GetData(), start_addr + idx * m_element_size, m_backend.GetExecutionContextRef(), m_element_type);
+            if (!child_sp)
+                return i;
+            cached = m_children.insert(std::make_pair(idx, child_sp)).first;
+        }
+        children.push_back(cached->second);
+    }
+    return count;
+}
+
+size_t
+lldb_private::formatters::LibcxxStdVectorSyntheticFrontEnd::GetChildrenInRange (size_t start_idx, size_t count, std::vector<lldb::ValueObjectSP> &children)
+{
+    const size_t num_children = CalculateNumChildren();
+    if (start_idx >= num_children)
+        return 0;
+    count = std::min(count, num_children - start_idx);
+
+    ProcessSP process_sp(m_backend.GetProcessSP());
+    if (!process_sp || count == 1)
+        return GetChildrenFromAddress(start_idx, count, children);
+
+    // The elements are contiguous, so read the window in large chunks and
+    // create each child from its slice of the data instead of letting every
+    // child read its own memory.
+    static const size_t g_max_read_size = 1024 * 1024;
+    const size_t elements_per_read = std::max<size_t>(1, g_max_read_size / m_element_size);
+    const lldb::addr_t start_addr = m_start->GetValueAsUnsigned(0);
+    ExecutionContext exe_ctx(m_backend.GetExecutionContextRef());
+    size_t num_appended = 0;
+    while (num_appended < count)
+    {
+        const size_t chunk_idx = start_idx + num_appended;
+        const size_t chunk_count = std::min(elements_per_read, count - num_appended);
+        const lldb::addr_t chunk_addr = start_addr + chunk_idx * m_element_size;
+        const size_t chunk_size = chunk_count * m_element_size;
+
+        DataBufferSP buffer_sp(new DataBufferHeap(chunk_size, 0));
+        Error error;
+        if (process_sp->ReadMemory(chunk_addr, buffer_sp->GetBytes(), chunk_size, error) != chunk_size)
+            return num_appended + GetChildrenFromAddress(chunk_idx, count - num_appended, children);
+        DataExtractor data(buffer_sp, process_sp->GetByteOrder(), process_sp->GetAddressByteSize());
+
+        for (size_t i = 0; i < chunk_count; ++i)
+        {
+            const size_t idx = chunk_idx + i;
+            auto cached = m_children.find(idx);
+            if (cached == m_children.end())
+            {
+                StreamString name;
+                name.Printf("[%" PRIu64 "]", (uint64_t)idx);
+                DataExtractor element_data(data, i * m_element_size, m_element_size);
+                ValueObjectSP child_sp = ValueObjectConstResult::Create(exe_ctx.GetBestExecutionContextScope(),
+                                                                        m_element_type,
+                                                                        ConstString(name.GetData()),
+                                                                        element_data,
+                                                                        chunk_addr + i * m_element_size);
+                cached = m_children.insert(std::make_pair(idx, child_sp)).first;
+            }
+            children.push_back(cached->second);
+        }
+        num_appended += chunk_count;
+    }
+    return num_appended;
 }
 
 bool
@@ -35,10 +35,12 @@
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Core/UUID.h"
 #include "lldb/Core/ValueObjectVariable.h"
 #include "lldb/Expression/DiagnosticManager.h"
 #include "lldb/Expression/FunctionCaller.h"
 #include "lldb/Expression/UtilityFunction.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/StringConvert.h"
 #include "lldb/Interpreter/CommandObject.h"
 #include "lldb/Interpreter/CommandObjectMultiword.h"
@@ -55,6 +57,7 @@
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
+#include "Utility/ModuleCache.h"
 
 #include "AppleObjCRuntimeV2.h"
 #include "AppleObjCClassDescriptorV2.h"
@@ -1646,6 +1649,9 @@ AppleObjCRuntimeV2::UpdateISAToDescriptorMapSharedCache()
     
     if (objc_opt_ptr == LLDB_INVALID_ADDRESS)
         return DescriptorMapUpdateResult::Fail();
+
+    if (LoadSharedCacheClassInfos (objc_opt_ptr))
+        return DescriptorMapUpdateResult(true, true);
     
     // Read the total number of classes from the hash table
     const uint32_t num_classes = 128*1024;
@@ -1808,6 +1814,8 @@ AppleObjCRuntimeV2::UpdateISAToDescriptorMapSharedCache()
                                                     addr_size);
 
                     any_found = (ParseClassInfoArray (class_infos_data, num_class_infos) > 0);
+                    if (success && any_found)
+                        SaveSharedCacheClassInfos (objc_opt_ptr, class_infos_data, num_class_infos);
                 }
             }
             else
@@ -1911,10 +1919,171 @@ AppleObjCRuntimeV2::GetSharedCacheReadOnlyAddress()
     return LLDB_INVALID_ADDRESS;
 }
 
+namespace
+{
+    const char *g_shared_cache_class_info_magic = "LLDBOBJC";
+    const uint32_t g_shared_cache_class_info_version = 1;
+
+    UUID
+    GetProcessSharedCacheUUID (Process *process)
+    {
+        UUID uuid;
+        const addr_t all_image_infos = process->GetImageInfoAddress();
+        if (all_image_infos == LLDB_INVALID_ADDRESS)
+            return uuid;
+
+        // The image info address is either the address of dyld or of the
+        // dyld_all_image_infos structure, only the latter starts with a
+        // version. Version 13 added the sharedCacheUUID field.
+        Error error;
+        const uint32_t version_or_magic = process->ReadUnsignedIntegerFromMemory (all_image_infos, 4, UINT32_MAX, error);
+        if (version_or_magic == UINT32_MAX ||
+            version_or_magic == 0xfeedface || version_or_magic == 0xcefaedfe ||
+            version_or_magic == 0xfeedfacf || version_or_magic == 0xcffaedfe ||
+            version_or_magic < 13)
+            return uuid;
+
+        addr_t uuid_addr = LLDB_INVALID_ADDRESS;
+        const uint32_t addr_size = process->GetAddressByteSize();
+        if (addr_size == 8)
+            uuid_addr = all_image_infos + 160;  // sharedCacheUUID <mach-o/dyld_images.h>
+        else if (addr_size == 4)
+            uuid_addr = all_image_infos + 84;   // sharedCacheUUID <mach-o/dyld_images.h>
+        if (uuid_addr == LLDB_INVALID_ADDRESS)
+            return uuid;
+
+        uint8_t uuid_bytes[16];
+        if (process->ReadMemory (uuid_addr, uuid_bytes, sizeof(uuid_bytes), error) == sizeof(uuid_bytes))
+            uuid.SetBytes (uuid_bytes);
+        return uuid;
+    }
+}
+
+bool
+AppleObjCRuntimeV2::GetSharedCacheClassInfoFileSpec (FileSpec &cache_file_spec)
+{
+    PlatformProperties *properties = Platform::GetGlobalPlatformProperties().get();
+    Process *process = GetProcess();
+    if (!properties->GetUseObjCClassCache() || process == NULL)
+        return false;
+
+    const UUID shared_cache_uuid = GetProcessSharedCacheUUID (process);
+    if (!shared_cache_uuid.IsValid())
+        return false;
+
+    FileSpec dir_spec = properties->GetModuleCacheDirectory();
+    if (!dir_spec)
+        return false;
+
+    StreamString file_name;
+    file_name.Printf ("%s-%u.classes",
+                      shared_cache_uuid.GetAsString().c_str(),
+                      process->GetAddressByteSize());
+    cache_file_spec = dir_spec;
+    cache_file_spec.AppendPathComponent ("objc_classes");
+    cache_file_spec.AppendPathComponent (file_name.GetData());
+    return true;
+}
+
+bool
+AppleObjCRuntimeV2::LoadSharedCacheClassInfos (lldb::addr_t objc_opt_ptr)
+{
+    FileSpec cache_file_spec;
+    if (!GetSharedCacheClassInfoFileSpec (cache_file_spec) || !cache_file_spec.Exists())
+        return false;
+
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+    DataBufferSP data_sp = ModuleCache::MapDataFile (cache_file_spec);
+    if (!data_sp)
+        return false;
+
+    // Each class is a 64 bit isa offset from the objc_opt_ro section and a
+    // 32 bit name hash.
+    DataExtractor data (data_sp, endian::InlHostByteOrder(), 4);
+    lldb::offset_t offset = 0;
+    const size_t magic_len = strlen (g_shared_cache_class_info_magic);
+    const char *magic = (const char *)data.GetData (&offset, magic_len);
+    const uint32_t version = data.GetU32 (&offset);
+    const uint32_t count = data.GetU32 (&offset);
+    if (magic == nullptr ||
+        ::memcmp (magic, g_shared_cache_class_info_magic, magic_len) != 0 ||
+        version != g_shared_cache_class_info_version ||
+        count == 0 ||
+        count > data.BytesLeft (offset) / 12)
+    {
+        if (log)
+            log->Printf ("AppleObjCRuntimeV2::LoadSharedCacheClassInfos() ignoring invalid cache file '%s'",
+                         cache_file_spec.GetPath().c_str());
+        return false;
+    }
+
+    // The whole shared cache slides as one unit, so the offsets stay the
+    // same from one process to the next.
+    uint32_t num_parsed = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const int64_t isa_offset = (int64_t)data.GetU64 (&offset);
+        const uint32_t name_hash = data.GetU32 (&offset);
+        const ObjCISA isa = objc_opt_ptr + isa_offset;
+        if (ISAIsCached(isa))
+            continue;
+        AddClass (isa, ClassDescriptorSP(new ClassDescriptorV2(*this, isa, NULL)), name_hash);
+        num_parsed++;
+    }
+
+    if (log)
+        log->Printf ("AppleObjCRuntimeV2::LoadSharedCacheClassInfos() added %u of %u classes from '%s'",
+                     num_parsed, count, cache_file_spec.GetPath().c_str());
+    return true;
+}
+
+void
+AppleObjCRuntimeV2::SaveSharedCacheClassInfos (lldb::addr_t objc_opt_ptr,
+                                               const DataExtractor &data,
+                                               uint32_t num_class_infos)
+{
+    FileSpec cache_file_spec;
+    if (!GetSharedCacheClassInfoFileSpec (cache_file_spec))
+        return;
+
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+    StreamString classes (Stream::eBinary, 4, endian::InlHostByteOrder());
+    uint32_t count = 0;
+    lldb::offset_t offset = 0;
+    for (uint32_t i = 0; i < num_class_infos; ++i)
+    {
+        const ObjCISA isa = data.GetPointer (&offset);
+        const uint32_t name_hash = data.GetU32 (&offset);
+        if (isa == 0)
+            continue;
+        classes.PutHex64 ((uint64_t)(isa - objc_opt_ptr));
+        classes.PutHex32 (name_hash);
+        ++count;
+    }
+
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    strm.Write (g_shared_cache_class_info_magic, strlen (g_shared_cache_class_info_magic));
+    strm.PutHex32 (g_shared_cache_class_info_version);
+    strm.PutHex32 (count);
+    strm.Write (classes.GetData(), classes.GetSize());
+
+    const std::string cache_path = cache_file_spec.GetPath();
+    Error error = ModuleCache::WriteDataFile (cache_file_spec, strm.GetData(), strm.GetSize());
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf ("AppleObjCRuntimeV2::SaveSharedCacheClassInfos() failed to write '%s': %s",
+                         cache_path.c_str(), error.AsCString());
+    }
+    else if (log)
+        log->Printf ("AppleObjCRuntimeV2::SaveSharedCacheClassInfos() saved %u classes to '%s'", count, cache_path.c_str());
+}
+
 void
 AppleObjCRuntimeV2::UpdateISAToDescriptorMapIfNeeded()
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, __PRETTY_FUNCTION__);
     
     // Else we need to check with our process to see when the map was updated.
     Process *process = GetProcess();
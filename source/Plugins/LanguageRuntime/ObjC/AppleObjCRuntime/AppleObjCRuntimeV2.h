@@ -349,6 +349,21 @@ private:
 
     lldb::addr_t
     GetSharedCacheReadOnlyAddress();
+
+    // The classes in the shared cache only depend on the shared cache, so
+    // they can be saved to the module cache directory keyed by its UUID
+    // and reused by later processes instead of running the utility
+    // function again.
+    bool
+    GetSharedCacheClassInfoFileSpec (lldb_private::FileSpec &cache_file_spec);
+
+    bool
+    LoadSharedCacheClassInfos (lldb::addr_t objc_opt_ptr);
+
+    void
+    SaveSharedCacheClassInfos (lldb::addr_t objc_opt_ptr,
+                               const lldb_private::DataExtractor &data,
+                               uint32_t num_class_infos);
     
     friend class ClassDescriptorV2;
 
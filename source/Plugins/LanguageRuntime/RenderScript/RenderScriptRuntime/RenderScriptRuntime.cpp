@@ -20,6 +20,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/RegularExpression.h"
+#include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/Core/ValueObjectVariable.h"
 #include "lldb/DataFormatters/DumpValueObjectOptions.h"
 #include "lldb/Expression/UserExpression.h"
@@ -1517,6 +1518,45 @@ RenderScriptRuntime::EvalRSExpression(const char *expression, StackFrame *frame_
     return true;
 }
 
+bool
+RenderScriptRuntime::EvalRSExpression(const char *expression, StackFrame *frame_ptr, DataExtractor &data)
+{
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_LANGUAGE));
+    if (log)
+        log->Printf("%s(%s)", __FUNCTION__, expression);
+
+    ValueObjectSP expr_result;
+    EvaluateExpressionOptions options;
+    options.SetLanguage(lldb::eLanguageTypeC_plus_plus);
+    GetProcess()->GetTarget().EvaluateExpression(expression, frame_ptr, expr_result, options);
+
+    if (!expr_result)
+    {
+        if (log)
+            log->Printf("%s: couldn't evaluate expression.", __FUNCTION__);
+        return false;
+    }
+
+    if (!expr_result->GetError().Success())
+    {
+        if (log)
+            log->Printf("%s - error evaluating expression result: %s", __FUNCTION__,
+                        expr_result->GetError().AsCString());
+        return false;
+    }
+
+    Error error;
+    expr_result->GetData(data, error);
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf("%s - couldn't get the data of the expression result: %s", __FUNCTION__, error.AsCString());
+        return false;
+    }
+
+    return true;
+}
+
 namespace
 {
 // Used to index expression format strings
@@ -1524,17 +1564,9 @@ enum ExpressionStrings
 {
    eExprGetOffsetPtr = 0,
    eExprAllocGetType,
-   eExprTypeDimX,
-   eExprTypeDimY,
-   eExprTypeDimZ,
-   eExprTypeElemPtr,
-   eExprElementType,
-   eExprElementKind,
-   eExprElementVec,
-   eExprElementFieldCount,
-   eExprSubelementsId,
-   eExprSubelementsName,
-   eExprSubelementsArrSize,
+   eExprTypePacked,
+   eExprElementPacked,
+   eExprSubelements,
 
    _eExprLast // keep at the end, implicit size of the array runtimeExpressions
 };
@@ -1559,32 +1591,21 @@ JITTemplate(ExpressionStrings e)
      // Pack the data in the following way mHal.state.dimX; mHal.state.dimY; mHal.state.dimZ;
      // mHal.state.lodCount; mHal.state.faces; mElement; into typeData
      // Need to specify 32 or 64 bit for uint_t since this differs between devices
-     "uint%" PRIu32 "_t data[6]; (void*)rsaTypeGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 6); data[0]", // X dim
-     "uint%" PRIu32 "_t data[6]; (void*)rsaTypeGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 6); data[1]", // Y dim
-     "uint%" PRIu32 "_t data[6]; (void*)rsaTypeGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 6); data[2]", // Z dim
-     "uint%" PRIu32 "_t data[6]; (void*)rsaTypeGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 6); data[5]", // Element ptr
+     // The whole array is the result so a single evaluation gets all of the fields.
+     "uint%" PRIu32 "_t data[6]; (void*)rsaTypeGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 6); data",
 
      // rsaElementGetNativeData(Context*, Element*, uint32_t* elemData,size)
      // Pack mType; mKind; mNormalized; mVectorSize; NumSubElements into elemData
-     "uint32_t data[5]; (void*)rsaElementGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 5); data[0]", // Type
-     "uint32_t data[5]; (void*)rsaElementGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 5); data[1]", // Kind
-     "uint32_t data[5]; (void*)rsaElementGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 5); data[3]", // Vector Size
-     "uint32_t data[5]; (void*)rsaElementGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 5); data[4]", // Field Count
+     "uint32_t data[5]; (void*)rsaElementGetNativeData(0x%" PRIx64 ", 0x%" PRIx64 ", data, 5); data",
 
      // rsaElementGetSubElements(RsContext con, RsElement elem, uintptr_t *ids, const char **names,
      // size_t *arraySizes, uint32_t dataSize)
      // Needed for Allocations of structs to gather details about fields/Subelements
-     // Element* of field
-     "void* ids[%" PRIu32 "]; const char* names[%" PRIu32 "]; size_t arr_size[%" PRIu32 "];"
-     "(void*)rsaElementGetSubElements(0x%" PRIx64 ", 0x%" PRIx64 ", ids, names, arr_size, %" PRIu32 "); ids[%" PRIu32 "]",
-
-     // Name of field
-     "void* ids[%" PRIu32 "]; const char* names[%" PRIu32 "]; size_t arr_size[%" PRIu32 "];"
-     "(void*)rsaElementGetSubElements(0x%" PRIx64 ", 0x%" PRIx64 ", ids, names, arr_size, %" PRIu32 "); names[%" PRIu32 "]",
-
-     // Array size of field
-     "void* ids[%" PRIu32 "]; const char* names[%" PRIu32 "]; size_t arr_size[%" PRIu32 "];"
-     "(void*)rsaElementGetSubElements(0x%" PRIx64 ", 0x%" PRIx64 ", ids, names, arr_size, %" PRIu32 "); arr_size[%" PRIu32 "]"
+     // The ids, names and array sizes are all pointer sized, they are returned back to back in one
+     // array: the Element* of every field, then their names, then their array sizes.
+     "uintptr_t fields[%" PRIu32 "];"
+     "(void*)rsaElementGetSubElements(0x%" PRIx64 ", 0x%" PRIx64 ", fields, (const char **)(fields + %" PRIu32 "),"
+     " (size_t *)(fields + %" PRIu32 "), %" PRIu32 "); fields"
     }};
 
     return runtimeExpressions[e];
@@ -1698,35 +1719,34 @@ RenderScriptRuntime::JITTypePacked(AllocationDetails *allocation, StackFrame *fr
     uint32_t archByteSize = GetProcess()->GetTarget().GetArchitecture().GetAddressByteSize();
     const uint32_t bits = archByteSize == 4 ? 32 : 64;
 
-    // We want 4 elements from packed data
-    const uint32_t num_exprs = 4;
-    assert(num_exprs == (eExprTypeElemPtr - eExprTypeDimX + 1) && "Invalid number of expressions");
-
-    char buffer[num_exprs][jit_max_expr_size];
-    uint64_t results[num_exprs];
+    const char *expr_cstr = JITTemplate(eExprTypePacked);
+    char buffer[jit_max_expr_size];
 
-    for (uint32_t i = 0; i < num_exprs; ++i)
+    int chars_written = snprintf(buffer, jit_max_expr_size, expr_cstr, bits, *allocation->context.get(),
+                                 *allocation->type_ptr.get());
+    if (chars_written < 0)
     {
-        const char *expr_cstr = JITTemplate(ExpressionStrings(eExprTypeDimX + i));
-        int chars_written = snprintf(buffer[i], jit_max_expr_size, expr_cstr, bits, *allocation->context.get(),
-                                     *allocation->type_ptr.get());
-        if (chars_written < 0)
-        {
-            if (log)
-                log->Printf("%s - encoding error in snprintf().", __FUNCTION__);
-            return false;
-        }
-        else if (chars_written >= jit_max_expr_size)
-        {
-            if (log)
-                log->Printf("%s - expression too long.", __FUNCTION__);
-            return false;
-        }
-
-        // Perform expression evaluation
-        if (!EvalRSExpression(buffer[i], frame_ptr, &results[i]))
-            return false;
+        if (log)
+            log->Printf("%s - encoding error in snprintf().", __FUNCTION__);
+        return false;
     }
+    else if (chars_written >= jit_max_expr_size)
+    {
+        if (log)
+            log->Printf("%s - expression too long.", __FUNCTION__);
+        return false;
+    }
+
+    // Get all of the packed data with one evaluation
+    DataExtractor data;
+    const uint32_t num_fields = 6;
+    if (!EvalRSExpression(buffer, frame_ptr, data) || data.GetByteSize() < num_fields * archByteSize)
+        return false;
+
+    uint64_t results[num_fields];
+    lldb::offset_t offset = 0;
+    for (uint32_t i = 0; i < num_fields; ++i)
+        results[i] = data.GetMaxU64(&offset, archByteSize);
 
     // Assign results to allocation members
     AllocationDetails::Dimension dims;
@@ -1735,7 +1755,7 @@ RenderScriptRuntime::JITTypePacked(AllocationDetails *allocation, StackFrame *fr
     dims.dim_3 = static_cast<uint32_t>(results[2]);
     allocation->dimension = dims;
 
-    addr_t elem_ptr = static_cast<lldb::addr_t>(results[3]);
+    addr_t elem_ptr = static_cast<lldb::addr_t>(results[5]);
     allocation->element.element_ptr = elem_ptr;
 
     if (log)
@@ -1760,40 +1780,39 @@ RenderScriptRuntime::JITElementPacked(Element &elem, const lldb::addr_t context,
         return false;
     }
 
-    // We want 4 elements from packed data
-    const uint32_t num_exprs = 4;
-    assert(num_exprs == (eExprElementFieldCount - eExprElementType + 1) && "Invalid number of expressions");
-
-    char buffer[num_exprs][jit_max_expr_size];
-    uint64_t results[num_exprs];
+    const char *expr_cstr = JITTemplate(eExprElementPacked);
+    char buffer[jit_max_expr_size];
 
-    for (uint32_t i = 0; i < num_exprs; i++)
+    int chars_written = snprintf(buffer, jit_max_expr_size, expr_cstr, context, *elem.element_ptr.get());
+    if (chars_written < 0)
     {
-        const char *expr_cstr = JITTemplate(ExpressionStrings(eExprElementType + i));
-        int chars_written = snprintf(buffer[i], jit_max_expr_size, expr_cstr, context, *elem.element_ptr.get());
-        if (chars_written < 0)
-        {
-            if (log)
-                log->Printf("%s - encoding error in snprintf().", __FUNCTION__);
-            return false;
-        }
-        else if (chars_written >= jit_max_expr_size)
-        {
-            if (log)
-                log->Printf("%s - expression too long.", __FUNCTION__);
-            return false;
-        }
-
-        // Perform expression evaluation
-        if (!EvalRSExpression(buffer[i], frame_ptr, &results[i]))
-            return false;
+        if (log)
+            log->Printf("%s - encoding error in snprintf().", __FUNCTION__);
+        return false;
+    }
+    else if (chars_written >= jit_max_expr_size)
+    {
+        if (log)
+            log->Printf("%s - expression too long.", __FUNCTION__);
+        return false;
     }
 
+    // Get all of the packed data with one evaluation
+    DataExtractor data;
+    const uint32_t num_fields = 5;
+    if (!EvalRSExpression(buffer, frame_ptr, data) || data.GetByteSize() < num_fields * sizeof(uint32_t))
+        return false;
+
+    uint32_t results[num_fields];
+    lldb::offset_t offset = 0;
+    for (uint32_t i = 0; i < num_fields; ++i)
+        results[i] = data.GetU32(&offset);
+
     // Assign results to allocation members
     elem.type = static_cast<RenderScriptRuntime::Element::DataType>(results[0]);
     elem.type_kind = static_cast<RenderScriptRuntime::Element::DataKind>(results[1]);
-    elem.type_vec_size = static_cast<uint32_t>(results[2]);
-    elem.field_count = static_cast<uint32_t>(results[3]);
+    elem.type_vec_size = results[3];
+    elem.field_count = results[4];
 
     if (log)
         log->Printf("%s - data type %" PRIu32 ", pixel type %" PRIu32 ", vector size %" PRIu32 ", field count %" PRIu32,
@@ -1821,69 +1840,63 @@ RenderScriptRuntime::JITSubelements(Element &elem, const lldb::addr_t context, S
         return false;
     }
 
-    const short num_exprs = 3;
-    assert(num_exprs == (eExprSubelementsArrSize - eExprSubelementsId + 1) && "Invalid number of expressions");
-
+    const char *expr_cstr = JITTemplate(eExprSubelements);
     char expr_buffer[jit_max_expr_size];
-    uint64_t results;
 
-    // Iterate over struct fields.
     const uint32_t field_count = *elem.field_count.get();
+    int chars_written = snprintf(expr_buffer, jit_max_expr_size, expr_cstr, field_count * 3, context,
+                                 *elem.element_ptr.get(), field_count, field_count * 2, field_count);
+    if (chars_written < 0)
+    {
+        if (log)
+            log->Printf("%s - encoding error in snprintf().", __FUNCTION__);
+        return false;
+    }
+    else if (chars_written >= jit_max_expr_size)
+    {
+        if (log)
+            log->Printf("%s - expression too long.", __FUNCTION__);
+        return false;
+    }
+
+    // Get the details of all the fields with one evaluation
+    DataExtractor data;
+    const uint32_t archByteSize = GetProcess()->GetTarget().GetArchitecture().GetAddressByteSize();
+    if (!EvalRSExpression(expr_buffer, frame_ptr, data) || data.GetByteSize() < field_count * 3 * archByteSize)
+        return false;
+
+    // Iterate over struct fields.
     for (uint32_t field_index = 0; field_index < field_count; ++field_index)
     {
         Element child;
-        for (uint32_t expr_index = 0; expr_index < num_exprs; ++expr_index)
-        {
-            const char *expr_cstr = JITTemplate(ExpressionStrings(eExprSubelementsId + expr_index));
-            int chars_written = snprintf(expr_buffer, jit_max_expr_size, expr_cstr,
-                                         field_count, field_count, field_count,
-                                         context, *elem.element_ptr.get(), field_count, field_index);
-            if (chars_written < 0)
-            {
-                if (log)
-                    log->Printf("%s - encoding error in snprintf().", __FUNCTION__);
-                return false;
-            }
-            else if (chars_written >= jit_max_expr_size)
-            {
-                if (log)
-                    log->Printf("%s - expression too long.", __FUNCTION__);
-                return false;
-            }
-
-            // Perform expression evaluation
-            if (!EvalRSExpression(expr_buffer, frame_ptr, &results))
-                return false;
 
+        // Element* of child
+        lldb::offset_t offset = field_index * archByteSize;
+        child.element_ptr = static_cast<addr_t>(data.GetMaxU64(&offset, archByteSize));
+
+        // Name of child
+        offset = (field_count + field_index) * archByteSize;
+        lldb::addr_t address = static_cast<addr_t>(data.GetMaxU64(&offset, archByteSize));
+        Error err;
+        std::string name;
+        GetProcess()->ReadCStringFromMemory(address, name, err);
+        if (!err.Fail())
+            child.type_name = ConstString(name);
+        else
+        {
             if (log)
-                log->Printf("%s - expr result 0x%" PRIx64 ".", __FUNCTION__, results);
-
-            switch (expr_index)
-            {
-                case 0: // Element* of child
-                    child.element_ptr = static_cast<addr_t>(results);
-                    break;
-                case 1: // Name of child
-                {
-                    lldb::addr_t address = static_cast<addr_t>(results);
-                    Error err;
-                    std::string name;
-                    GetProcess()->ReadCStringFromMemory(address, name, err);
-                    if (!err.Fail())
-                        child.type_name = ConstString(name);
-                    else
-                    {
-                        if (log)
-                            log->Printf("%s - warning: Couldn't read field name.", __FUNCTION__);
-                    }
-                    break;
-                }
-                case 2: // Array size of child
-                    child.array_size = static_cast<uint32_t>(results);
-                    break;
-            }
+                log->Printf("%s - warning: Couldn't read field name.", __FUNCTION__);
         }
 
+        // Array size of child
+        offset = (field_count * 2 + field_index) * archByteSize;
+        child.array_size = static_cast<uint32_t>(data.GetMaxU64(&offset, archByteSize));
+
+        if (log)
+            log->Printf("%s - field %" PRIu32 " Element*: 0x%" PRIx64 ", name: %s, array size %" PRIu32 ".",
+                        __FUNCTION__, field_index, *child.element_ptr.get(), child.type_name.AsCString(""),
+                        *child.array_size.get());
+
         // We need to recursively JIT each Element field of the struct since
         // structs can be nested inside structs.
         if (!JITElementPacked(child, context, frame_ptr))
@@ -2974,6 +2987,34 @@ RenderScriptRuntime::DumpAllocation(Stream &strm, StackFrame *frame_ptr, const u
     uint32_t offset = 0;   // Offset in buffer to next element to be printed
     uint32_t prev_row = 0; // Offset to the start of the previous row
 
+    // Elements of struct type are printed as values of the struct. Look the
+    // type up once with an expression on the first element, the elements
+    // are then made from the data we've already read.
+    CompilerType struct_type;
+    if ((type == Element::RS_TYPE_NONE) && (alloc->element.children.size() > 0) &&
+        (alloc->element.type_name != Element::GetFallbackStructName()))
+    {
+        char expr_char_buffer[jit_max_expr_size];
+        int chars_written = snprintf(expr_char_buffer, jit_max_expr_size, "*(%s*) 0x%" PRIx64,
+                                     alloc->element.type_name.AsCString(), *alloc->data_ptr.get());
+        if (chars_written < 0 || chars_written >= jit_max_expr_size)
+        {
+            if (log)
+                log->Printf("%s - error in snprintf().", __FUNCTION__);
+        }
+        else
+        {
+            ValueObjectSP expr_result;
+            GetProcess()->GetTarget().EvaluateExpression(expr_char_buffer, frame_ptr, expr_result);
+            if (expr_result && expr_result->GetError().Success())
+                struct_type = expr_result->GetCompilerType();
+        }
+    }
+
+    // Don't print the name of the struct values, there is none
+    DumpValueObjectOptions expr_options;
+    expr_options.SetHideName(true);
+
     // Iterate over allocation dimensions, printing results to user
     strm.Printf("Data (X, Y, Z):");
     for (uint32_t z = 0; z < dim_z; ++z)
@@ -2989,34 +3030,14 @@ RenderScriptRuntime::DumpAllocation(Stream &strm, StackFrame *frame_ptr, const u
             for (uint32_t x = 0; x < dim_x; ++x)
             {
                 strm.Printf("\n(%" PRIu32 ", %" PRIu32 ", %" PRIu32 ") = ", x, y, z);
-                if ((type == Element::RS_TYPE_NONE) && (alloc->element.children.size() > 0) &&
-                    (alloc->element.type_name != Element::GetFallbackStructName()))
+                if (struct_type.IsValid())
                 {
-                    // Here we are dumping an Element of struct type.
-                    // This is done using expression evaluation with the name of the struct type and pointer to element.
-
-                    // Don't print the name of the resulting expression, since this will be '$[0-9]+'
-                    DumpValueObjectOptions expr_options;
-                    expr_options.SetHideName(true);
-
-                    // Setup expression as derefrencing a pointer cast to element address.
-                    char expr_char_buffer[jit_max_expr_size];
-                    int chars_written = snprintf(expr_char_buffer, jit_max_expr_size, "*(%s*) 0x%" PRIx64,
-                                                 alloc->element.type_name.AsCString(), *alloc->data_ptr.get() + offset);
-
-                    if (chars_written < 0 || chars_written >= jit_max_expr_size)
-                    {
-                        if (log)
-                            log->Printf("%s - error in snprintf().", __FUNCTION__);
-                        continue;
-                    }
-
-                    // Evaluate expression
-                    ValueObjectSP expr_result;
-                    GetProcess()->GetTarget().EvaluateExpression(expr_char_buffer, frame_ptr, expr_result);
-
-                    // Print the results to our stream.
-                    expr_result->Dump(strm, expr_options);
+                    // Here we are dumping an Element of struct type, made from its bytes in the buffer.
+                    DataExtractor element_data(alloc_data, offset, data_size);
+                    ValueObjectSP element_sp = ValueObjectConstResult::Create(frame_ptr, struct_type, ConstString(),
+                                                                              element_data,
+                                                                              *alloc->data_ptr.get() + offset);
+                    element_sp->Dump(strm, expr_options);
                 }
                 else
                 {
@@ -273,6 +273,11 @@ protected:
     bool
     EvalRSExpression(const char *expression, StackFrame *frame_ptr, uint64_t *result);
 
+    // Evaluate an expression whose result is an array filled in by the
+    // runtime and copy out its contents.
+    bool
+    EvalRSExpression(const char *expression, StackFrame *frame_ptr, DataExtractor &data);
+
     lldb::BreakpointSP
     CreateKernelBreakpoint(const ConstString &name);
 
@@ -357,7 +357,8 @@ ObjectContainerBSDArchive::CreateInstance
             data.SetData (data_sp, data_offset, length);
             if (file && data_sp && ObjectContainerBSDArchive::MagicBytesMatch(data))
             {
-                Timer scoped_timer (__PRETTY_FUNCTION__,
+                static Timer::Category func_cat(__PRETTY_FUNCTION__);
+                Timer scoped_timer (func_cat,
                                     "ObjectContainerBSDArchive::CreateInstance (module = %s, file = %p, file_offset = 0x%8.8" PRIx64 ", file_size = 0x%8.8" PRIx64 ")",
                                     module_sp->GetFileSpec().GetPath().c_str(),
                                     static_cast<const void*>(file),
@@ -0,0 +1,431 @@
+//===-- ELFCoreWriter.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ELFCoreWriter.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/Support/ELF.h"
+
+// Project includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/State.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Target/MemoryRegionInfo.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+#include "lldb/Utility/TaskPool.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Memory is read from the process in chunks this big, the chunks that
+    // were read before are written to the core file on the task pool
+    // meanwhile.
+    const size_t g_read_chunk_size = 4 * 1024 * 1024;
+    const size_t g_max_pending_writes = 4;
+    const size_t g_page_size = 4096;
+
+    const uint8_t g_zero_page[g_page_size] = {};
+
+    // The Linux user_regs_struct of x86_64, which is the pr_reg of
+    // NT_PRSTATUS.
+    const char *g_x86_64_gpr_names[] = {
+        "r15", "r14", "r13", "r12", "rbp", "rbx", "r11", "r10", "r9", "r8", "rax", "rcx", "rdx", "rsi",
+        "rdi", "orig_rax", "rip", "cs", "rflags", "rsp", "ss", "fs_base", "gs_base", "ds", "es", "fs", "gs"
+    };
+
+    struct CoreSegment
+    {
+        addr_t vaddr;
+        addr_t size;
+        uint32_t flags;
+        uint64_t file_offset;
+    };
+
+    void
+    PutZeros (Stream &strm, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+            strm.PutHex8(0);
+    }
+
+    void
+    PutString (Stream &strm, const std::string &str, size_t size)
+    {
+        const size_t len = std::min(str.size(), size - 1);
+        strm.Write(str.data(), len);
+        PutZeros(strm, size - len);
+    }
+
+    void
+    AddNote (Stream &notes, uint32_t type, const void *desc, size_t desc_size)
+    {
+        notes.PutHex32(5); // "CORE" and its terminator
+        notes.PutHex32(desc_size);
+        notes.PutHex32(type);
+        notes.Write("CORE\0\0\0", 8);
+        notes.Write(desc, desc_size);
+        PutZeros(notes, ((desc_size + 3) & ~3) - desc_size);
+    }
+
+    void
+    AddPrStatus (Stream &notes, Thread &thread, const ProcessInstanceInfo &info)
+    {
+        int signo = 0;
+        StopInfoSP stop_info_sp = thread.GetStopInfo();
+        if (stop_info_sp && stop_info_sp->GetStopReason() == eStopReasonSignal)
+            signo = stop_info_sp->GetValue();
+
+        StreamString desc(Stream::eBinary, 8, eByteOrderLittle);
+        desc.PutHex32(signo); // si_signo
+        desc.PutHex32(0);     // si_code
+        desc.PutHex32(0);     // si_errno
+        desc.PutHex16(signo); // pr_cursig
+        PutZeros(desc, 2);
+        desc.PutHex64(0);     // pr_sigpend
+        desc.PutHex64(0);     // pr_sighold
+        desc.PutHex32(thread.GetProtocolID());
+        desc.PutHex32(info.ParentProcessIDIsValid() ? info.GetParentProcessID() : 0);
+        desc.PutHex32(info.GetProcessID()); // pr_pgrp
+        desc.PutHex32(0);                   // pr_sid
+        PutZeros(desc, 4 * 16);             // pr_utime, pr_stime, pr_cutime and pr_cstime
+
+        RegisterContextSP reg_ctx_sp = thread.GetRegisterContext();
+        for (const char *name : g_x86_64_gpr_names)
+        {
+            // orig_rax is -1 when the thread isn't in a system call
+            uint64_t value = strcmp(name, "orig_rax") == 0 ? UINT64_MAX : 0;
+            const RegisterInfo *reg_info = reg_ctx_sp ? reg_ctx_sp->GetRegisterInfoByName(name) : nullptr;
+            if (reg_info)
+                value = reg_ctx_sp->ReadRegisterAsUnsigned(reg_info, value);
+            desc.PutHex64(value);
+        }
+        desc.PutHex32(0); // pr_fpvalid
+        PutZeros(desc, 4);
+
+        AddNote(notes, llvm::ELF::NT_PRSTATUS, desc.GetData(), desc.GetSize());
+    }
+
+    void
+    AddPrPsInfo (Stream &notes, const ProcessInstanceInfo &info)
+    {
+        std::string args;
+        info.GetArguments().GetCommandString(args);
+
+        StreamString desc(Stream::eBinary, 8, eByteOrderLittle);
+        desc.PutHex8(3);   // pr_state, stopped
+        desc.PutHex8('T'); // pr_sname
+        desc.PutHex8(0);   // pr_zomb
+        desc.PutHex8(0);   // pr_nice
+        PutZeros(desc, 4);
+        desc.PutHex64(0);  // pr_flag
+        desc.PutHex32(info.UserIDIsValid() ? info.GetUserID() : 0);
+        desc.PutHex32(info.GroupIDIsValid() ? info.GetGroupID() : 0);
+        desc.PutHex32(info.GetProcessID());
+        desc.PutHex32(info.ParentProcessIDIsValid() ? info.GetParentProcessID() : 0);
+        desc.PutHex32(info.GetProcessID()); // pr_pgrp
+        desc.PutHex32(0);                   // pr_sid
+        PutString(desc, info.GetExecutableFile().GetFilename().AsCString(""), 16);
+        PutString(desc, args, 80);
+
+        AddNote(notes, llvm::ELF::NT_PRPSINFO, desc.GetData(), desc.GetSize());
+    }
+
+    bool
+    IsZeroPage (const uint8_t *data, size_t size)
+    {
+        return memcmp(data, g_zero_page, size) == 0;
+    }
+
+    // Write the pages of the data that aren't all zeros, the file was
+    // truncated so the others read back as zeros.
+    Error
+    WriteNonZeroPages (File &file, const uint8_t *data, size_t length, uint64_t file_offset)
+    {
+        Error error;
+        size_t pos = 0;
+        while (pos < length && error.Success())
+        {
+            while (pos < length && IsZeroPage(data + pos, std::min(g_page_size, length - pos)))
+                pos += std::min(g_page_size, length - pos);
+
+            size_t end = pos;
+            while (end < length && !IsZeroPage(data + end, std::min(g_page_size, length - end)))
+                end += std::min(g_page_size, length - end);
+
+            off_t offset = file_offset + pos;
+            while (pos < end && error.Success())
+            {
+                size_t bytes_written = end - pos;
+                error = file.Write(data + pos, bytes_written, offset);
+                if (error.Success() && bytes_written == 0)
+                    error.SetErrorString("short write");
+                pos += bytes_written;
+            }
+        }
+        return error;
+    }
+
+    // Read memory of the process into data, the pages that can't be read
+    // are zeros.
+    void
+    ReadMemoryChunk (Process &process, addr_t addr, uint8_t *data, size_t length)
+    {
+        Error error;
+        size_t bytes_read = process.ReadMemoryFromInferior(addr, data, length, error);
+        if (bytes_read == length)
+            return;
+
+        // Find the readable pages after the one that stopped the read.
+        memset(data + bytes_read, 0, length - bytes_read);
+        for (size_t pos = (bytes_read + g_page_size) & ~(g_page_size - 1); pos < length; pos += g_page_size)
+        {
+            const size_t page_length = std::min(g_page_size, length - pos);
+            if (process.ReadMemoryFromInferior(addr + pos, data + pos, page_length, error) != page_length)
+                memset(data + pos, 0, page_length);
+        }
+    }
+}
+
+namespace lldb_private {
+
+bool
+SaveELFCore(const lldb::ProcessSP &process_sp,
+            const lldb_private::FileSpec &outfile,
+            lldb_private::Error &error)
+{
+    if (!process_sp)
+        return false;
+
+    const ArchSpec &target_arch = process_sp->GetTarget().GetArchitecture();
+    const llvm::Triple &target_triple = target_arch.GetTriple();
+    if (target_triple.getOS() != llvm::Triple::Linux)
+        return false;
+
+    // The registers are written in the NT_PRSTATUS layout of x86_64, which
+    // is also the only one ProcessElfCore reads.
+    if (target_arch.GetMachine() != llvm::Triple::x86_64)
+    {
+        error.SetErrorStringWithFormat("unsupported core architecture: %s", target_triple.str().c_str());
+        return true;
+    }
+
+    if (!StateIsStoppedState(process_sp->GetState(), true))
+    {
+        error.SetErrorString("the process must be stopped to save a core file");
+        return true;
+    }
+
+    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Find the readable memory regions
+    std::vector<CoreSegment> segments;
+    MemoryRegionInfo range_info;
+    Error range_error = process_sp->GetMemoryRegionInfo(0, range_info);
+    if (range_error.Fail())
+    {
+        error.SetErrorString("process doesn't support getting memory region info");
+        return true;
+    }
+    while (range_error.Success() && range_info.GetRange().GetRangeBase() != LLDB_INVALID_ADDRESS)
+    {
+        const addr_t addr = range_info.GetRange().GetRangeBase();
+        const addr_t size = range_info.GetRange().GetByteSize();
+        if (size == 0)
+            break;
+
+        uint32_t flags = 0;
+        if (range_info.GetReadable() == MemoryRegionInfo::eYes)
+            flags |= llvm::ELF::PF_R;
+        if (range_info.GetWritable() == MemoryRegionInfo::eYes)
+            flags |= llvm::ELF::PF_W;
+        if (range_info.GetExecutable() == MemoryRegionInfo::eYes)
+            flags |= llvm::ELF::PF_X;
+
+        if (flags & llvm::ELF::PF_R)
+            segments.push_back(CoreSegment{addr, size, flags, 0});
+        else if (flags == 0 && size == 1)
+            break; // Old debugservers mark the end of the regions this way
+
+        const addr_t next_addr = range_info.GetRange().GetRangeEnd();
+        if (next_addr <= addr)
+            break;
+        range_error = process_sp->GetMemoryRegionInfo(next_addr, range_info);
+    }
+
+    // One PT_NOTE and a PT_LOAD per segment
+    const size_t num_program_headers = segments.size() + 1;
+    if (num_program_headers >= 0xffff) // PN_XNUM
+    {
+        error.SetErrorStringWithFormat("too many memory regions (%" PRIu64 ")", (uint64_t)segments.size());
+        return true;
+    }
+
+    // The notes
+    ProcessInstanceInfo info;
+    if (!process_sp->GetProcessInfo(info))
+        info.SetProcessID(process_sp->GetID());
+
+    StreamString notes(Stream::eBinary, 8, eByteOrderLittle);
+    AddPrPsInfo(notes, info);
+
+    DataBufferSP auxv_sp = process_sp->GetAuxvData();
+    if (auxv_sp && auxv_sp->GetByteSize() > 0)
+        AddNote(notes, llvm::ELF::NT_AUXV, auxv_sp->GetBytes(), auxv_sp->GetByteSize());
+
+    // The selected thread goes first, that is the one a debugger will show
+    // when it opens the core.
+    ThreadList &thread_list = process_sp->GetThreadList();
+    ThreadSP selected_thread_sp = thread_list.GetSelectedThread();
+    if (selected_thread_sp)
+        AddPrStatus(notes, *selected_thread_sp, info);
+    const uint32_t num_threads = thread_list.GetSize();
+    for (uint32_t thread_idx = 0; thread_idx < num_threads; ++thread_idx)
+    {
+        ThreadSP thread_sp = thread_list.GetThreadAtIndex(thread_idx);
+        if (thread_sp && thread_sp != selected_thread_sp)
+            AddPrStatus(notes, *thread_sp, info);
+    }
+
+    // The headers and notes come first, the memory of the segments starts
+    // at the next page.
+    const uint64_t notes_offset = sizeof(llvm::ELF::Elf64_Ehdr) + num_program_headers * sizeof(llvm::ELF::Elf64_Phdr);
+    uint64_t file_offset = (notes_offset + notes.GetSize() + g_page_size - 1) & ~(uint64_t)(g_page_size - 1);
+    for (CoreSegment &segment : segments)
+    {
+        segment.file_offset = file_offset;
+        file_offset += segment.size;
+    }
+    const uint64_t file_end = file_offset;
+
+    StreamString header(Stream::eBinary, 8, eByteOrderLittle);
+    header.Write(llvm::ELF::ElfMagic, 4);
+    header.PutHex8(llvm::ELF::ELFCLASS64);
+    header.PutHex8(llvm::ELF::ELFDATA2LSB);
+    header.PutHex8(llvm::ELF::EV_CURRENT);
+    header.PutHex8(llvm::ELF::ELFOSABI_NONE);
+    PutZeros(header, llvm::ELF::EI_NIDENT - 8);
+    header.PutHex16(llvm::ELF::ET_CORE);
+    header.PutHex16(llvm::ELF::EM_X86_64);
+    header.PutHex32(llvm::ELF::EV_CURRENT);
+    header.PutHex64(0);                                     // e_entry
+    header.PutHex64(sizeof(llvm::ELF::Elf64_Ehdr));         // e_phoff
+    header.PutHex64(0);                                     // e_shoff
+    header.PutHex32(0);                                     // e_flags
+    header.PutHex16(sizeof(llvm::ELF::Elf64_Ehdr));         // e_ehsize
+    header.PutHex16(sizeof(llvm::ELF::Elf64_Phdr));         // e_phentsize
+    header.PutHex16(num_program_headers);                   // e_phnum
+    header.PutHex16(0);                                     // e_shentsize
+    header.PutHex16(0);                                     // e_shnum
+    header.PutHex16(0);                                     // e_shstrndx
+
+    header.PutHex32(llvm::ELF::PT_NOTE);
+    header.PutHex32(0);
+    header.PutHex64(notes_offset);
+    header.PutHex64(0);
+    header.PutHex64(0);
+    header.PutHex64(notes.GetSize());
+    header.PutHex64(0);
+    header.PutHex64(4);
+    for (const CoreSegment &segment : segments)
+    {
+        header.PutHex32(llvm::ELF::PT_LOAD);
+        header.PutHex32(segment.flags);
+        header.PutHex64(segment.file_offset);
+        header.PutHex64(segment.vaddr);
+        header.PutHex64(0);
+        header.PutHex64(segment.size);
+        header.PutHex64(segment.size);
+        header.PutHex64(g_page_size);
+    }
+    header.Write(notes.GetData(), notes.GetSize());
+
+    File core_file;
+    std::string core_file_path(outfile.GetPath());
+    error = core_file.Open(core_file_path.c_str(),
+                           File::eOpenOptionWrite |
+                           File::eOpenOptionTruncate |
+                           File::eOpenOptionCanCreate);
+    if (error.Fail())
+        return true;
+
+    error = WriteNonZeroPages(core_file, reinterpret_cast<const uint8_t *>(header.GetData()), header.GetSize(), 0);
+
+    // Read the memory in large chunks. While the next chunk is read, the
+    // ones before it are written by the task pool, skipping zero pages.
+    std::deque<std::future<Error>> pending_writes;
+    uint8_t last_byte = 0;
+    for (const CoreSegment &segment : segments)
+    {
+        if (error.Fail())
+            break;
+
+        if (log)
+            log->Printf("SaveELFCore saving %" PRIu64 " bytes of the memory region at 0x%" PRIx64,
+                        segment.size, segment.vaddr);
+
+        for (addr_t pos = 0; pos < segment.size && error.Success(); pos += g_read_chunk_size)
+        {
+            const size_t length = std::min<addr_t>(g_read_chunk_size, segment.size - pos);
+            std::shared_ptr<std::vector<uint8_t>> chunk_sp(new std::vector<uint8_t>(length));
+            ReadMemoryChunk(*process_sp, segment.vaddr + pos, chunk_sp->data(), length);
+            last_byte = chunk_sp->back();
+
+            if (pending_writes.size() >= g_max_pending_writes)
+            {
+                error = pending_writes.front().get();
+                pending_writes.pop_front();
+            }
+
+            const uint64_t chunk_offset = segment.file_offset + pos;
+            pending_writes.push_back(TaskPool::AddTask([&core_file, chunk_sp, chunk_offset]() {
+                return WriteNonZeroPages(core_file, chunk_sp->data(), chunk_sp->size(), chunk_offset);
+            }));
+        }
+    }
+
+    while (!pending_writes.empty())
+    {
+        Error write_error = pending_writes.front().get();
+        if (error.Success())
+            error = write_error;
+        pending_writes.pop_front();
+    }
+
+    // Make the file as long as the last segment even if that ends with pages
+    // of zeros that weren't written.
+    if (error.Success() && !segments.empty())
+    {
+        size_t bytes_written = 1;
+        off_t offset = file_end - 1;
+        error = core_file.Write(&last_byte, bytes_written, offset);
+    }
+
+    return true;
+}
+
+}  // namespace lldb_private
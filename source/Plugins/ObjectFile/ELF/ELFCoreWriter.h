@@ -0,0 +1,36 @@
+//===-- ELFCoreWriter.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ELFCoreWriter_h_
+#define liblldb_ELFCoreWriter_h_
+
+#include "lldb/Target/Process.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// Write an ELF core file of a stopped Linux process.
+///
+/// The file has the NT_PRPSINFO, NT_AUXV and one NT_PRSTATUS note per
+/// thread that ProcessElfCore reads, and a PT_LOAD segment for every
+/// readable memory region. Pages that are all zeros are left as holes
+/// in the file.
+///
+/// @return
+///     \b false if the process isn't one this writer handles, otherwise
+///     \b true with \a error telling whether the core was written.
+//----------------------------------------------------------------------
+bool
+SaveELFCore(const lldb::ProcessSP &process_sp,
+            const lldb_private::FileSpec &outfile,
+            lldb_private::Error &error);
+
+}  // namespace lldb_private
+
+#endif
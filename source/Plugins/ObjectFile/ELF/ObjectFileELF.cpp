@@ -8,6 +8,7 @@
 //===----------------------------------------------------------------------===//
 
 #include "ObjectFileELF.h"
+#include "ELFCoreWriter.h"
 
 #include <cassert>
 #include <algorithm>
@@ -15,6 +16,7 @@
 
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Log.h"
@@ -23,17 +25,32 @@
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/Platform.h"
 #include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Utility/CRC32.h"
+#include "lldb/Utility/TaskPool.h"
+#include "Utility/ModuleCache.h"
 
 #include "llvm/ADT/PointerUnion.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/ARMBuildAttributes.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MathExtras.h"
 
+#if defined (HAVE_LIBZ)
+#include <zlib.h>
+#endif
+#if defined (HAVE_LIBLZMA)
+#include <lzma.h>
+#endif
+
 #define CASE_AND_STREAM(s, def, width)                  \
     case def: s->Printf("%-*s", width, #def); break;
 
@@ -394,6 +411,22 @@ kalimbaSectionType(
     return eSectionTypeOther;
 }
 
+//! Checks the e_type of the ELF header in \a bytes for ET_REL without
+//! parsing the whole header.
+static bool
+IsRelocatableObject(const uint8_t *bytes, size_t size)
+{
+    // e_type is the first field after e_ident in both ELF32 and ELF64.
+    if (size < EI_NIDENT + 2)
+        return false;
+    uint16_t e_type;
+    if (bytes[EI_DATA] == llvm::ELF::ELFDATA2MSB)
+        e_type = (bytes[EI_NIDENT] << 8) | bytes[EI_NIDENT + 1];
+    else
+        e_type = bytes[EI_NIDENT] | (bytes[EI_NIDENT + 1] << 8);
+    return e_type == llvm::ELF::ET_REL;
+}
+
 // Arbitrary constant used as UUID prefix for core files.
 const uint32_t
 ObjectFileELF::g_core_uuid_magic(0xE210C);
@@ -408,7 +441,9 @@ ObjectFileELF::Initialize()
                                   GetPluginDescriptionStatic(),
                                   CreateInstance,
                                   CreateMemoryInstance,
-                                  GetModuleSpecifications);
+                                  GetModuleSpecifications,
+                                  SaveCore);
+    PluginManager::AddObjectFileMagic(CreateInstance, llvm::ELF::ElfMagic, strlen(llvm::ELF::ElfMagic));
 }
 
 void
@@ -449,9 +484,18 @@ ObjectFileELF::CreateInstance (const lldb::ModuleSP &module_sp,
         const uint8_t *magic = data_sp->GetBytes() + data_offset;
         if (ELFHeader::MagicBytesMatch(magic))
         {
+            // Relocatable files get their debug info sections relocated in
+            // place (see RelocateSection), so they need a mapping that can be
+            // written to. It is copy on write, only the relocated pages are
+            // copied.
+            const bool writeable = IsRelocatableObject(data_sp->GetBytes() + data_offset,
+                                                       data_sp->GetByteSize() - data_offset);
+
             // Update the data to contain the entire file if it doesn't already
-            if (data_sp->GetByteSize() < length) {
-                data_sp = file->MemoryMapFileContentsIfLocal(file_offset, length);
+            if (data_sp->GetByteSize() < length || writeable) {
+                data_sp = file->MemoryMapFileContentsIfLocal(file_offset, length, writeable);
+                if (!data_sp)
+                    return NULL;
                 data_offset = 0;
                 magic = data_sp->GetBytes();
             }
@@ -495,6 +539,14 @@ ObjectFileELF::CreateMemoryInstance (const lldb::ModuleSP &module_sp,
     return NULL;
 }
 
+bool
+ObjectFileELF::SaveCore (const lldb::ProcessSP &process_sp,
+                         const lldb_private::FileSpec &outfile,
+                         lldb_private::Error &error)
+{
+    return SaveELFCore(process_sp, outfile, error);
+}
+
 bool
 ObjectFileELF::MagicBytesMatch (DataBufferSP& data_sp,
                                   lldb::addr_t data_offset,
@@ -508,73 +560,69 @@ ObjectFileELF::MagicBytesMatch (DataBufferSP& data_sp,
     return false;
 }
 
-/*
- * crc function from http://svnweb.freebsd.org/base/head/sys/libkern/crc32.c
- *
- *   COPYRIGHT (C) 1986 Gary S. Brown. You may use this program, or
- *   code or tables extracted from it, as desired without restriction.
- */
-static uint32_t
-calc_crc32(uint32_t crc, const void *buf, size_t size)
-{
-    static const uint32_t g_crc32_tab[] =
-    {
-        0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f,
-        0xe963a535, 0x9e6495a3, 0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
-        0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91, 0x1db71064, 0x6ab020f2,
-        0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-        0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9,
-        0xfa0f3d63, 0x8d080df5, 0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-        0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b, 0x35b5a8fa, 0x42b2986c,
-        0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-        0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423,
-        0xcfba9599, 0xb8bda50f, 0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
-        0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d, 0x76dc4190, 0x01db7106,
-        0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-        0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d,
-        0x91646c97, 0xe6635c01, 0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
-        0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457, 0x65b0d9c6, 0x12b7e950,
-        0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-        0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7,
-        0xa4d1c46d, 0xd3d6f4fb, 0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-        0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9, 0x5005713c, 0x270241aa,
-        0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-        0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81,
-        0xb7bd5c3b, 0xc0ba6cad, 0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
-        0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683, 0xe3630b12, 0x94643b84,
-        0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-        0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb,
-        0x196c3671, 0x6e6b06e7, 0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
-        0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5, 0xd6d6a3e8, 0xa1d1937e,
-        0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-        0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55,
-        0x316e8eef, 0x4669be79, 0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-        0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f, 0xc5ba3bbe, 0xb2bd0b28,
-        0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-        0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f,
-        0x72076785, 0x05005713, 0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
-        0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21, 0x86d3d2d4, 0xf1d4e242,
-        0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-        0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69,
-        0x616bffd3, 0x166ccf45, 0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
-        0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db, 0xaed16a4a, 0xd9d65adc,
-        0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-        0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693,
-        0x54de5729, 0x23d967bf, 0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-        0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
-    };
-    const uint8_t *p = (const uint8_t *)buf;
-
-    crc = crc ^ ~0U;
-    while (size--)
-        crc = g_crc32_tab[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
-    return crc ^ ~0U;
+//----------------------------------------------------------------------
+// The crc of the whole file is what identifies files without a build id,
+// that is a lot to read for large files. When the module cache is in use
+// the crc is kept there under the path, offset, size and modification
+// time of the file, so each version of a file is only read once.
+//----------------------------------------------------------------------
+static FileSpec
+GetGNUDebugLinkCRC32CacheFile(const FileSpec &file, lldb::offset_t file_offset, size_t size)
+{
+    PlatformProperties *properties = Platform::GetGlobalPlatformProperties().get();
+    FileSpec dir_spec = properties->GetModuleCacheDirectory();
+    const TimeValue mod_time = file.GetModificationTime();
+    if (!file || !properties->GetUseModuleCache() || !dir_spec || !mod_time.IsValid())
+        return FileSpec();
+
+    const std::string path = file.GetPath();
+    StreamString name;
+    name.Printf("%s-%8.8x-%" PRIx64 "-%" PRIu64 "-%" PRIu64,
+                file.GetFilename().AsCString("<Unknown>"),
+                CRC32(0, path.data(), path.size()),
+                (uint64_t)file_offset, (uint64_t)size,
+                mod_time.GetAsSecondsSinceJan1_1970());
+    dir_spec.AppendPathComponent("elf_crc32");
+    dir_spec.AppendPathComponent(name.GetData());
+    return dir_spec;
 }
 
 static uint32_t
-calc_gnu_debuglink_crc32(const void *buf, size_t size)
+calc_gnu_debuglink_crc32(const FileSpec &file, lldb::offset_t file_offset, const DataExtractor &data)
 {
-    return calc_crc32(0U, buf, size);
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
+
+    const FileSpec cache_file_spec = GetGNUDebugLinkCRC32CacheFile(file, file_offset, data.GetByteSize());
+    if (cache_file_spec && cache_file_spec.Exists())
+    {
+        DataBufferSP cache_data_sp = cache_file_spec.ReadFileContents(0, 8);
+        if (cache_data_sp && cache_data_sp->GetByteSize() == 8)
+        {
+            std::string crc_str((const char *)cache_data_sp->GetBytes(), 8);
+            uint32_t crc;
+            if (!llvm::StringRef(crc_str).getAsInteger(16, crc))
+                return crc;
+        }
+    }
+
+    static lldb_private::Timer::Category func_cat(__PRETTY_FUNCTION__);
+    lldb_private::Timer scoped_timer (func_cat,
+                                      "Calculating module crc32 %s with size %" PRIu64 " KiB",
+                                      file.GetFilename().AsCString("<Unknown>"),
+                                      data.GetByteSize()/1024);
+
+    const uint32_t crc = CRC32Parallel(0, data.GetDataStart(), data.GetByteSize());
+
+    if (cache_file_spec)
+    {
+        char crc_str[16];
+        snprintf(crc_str, sizeof(crc_str), "%8.8x", crc);
+        Error error = ModuleCache::WriteDataFile (cache_file_spec, crc_str, 8);
+        if (log && error.Fail())
+            log->Printf ("ObjectFileELF::%s failed to write '%s': %s", __FUNCTION__,
+                         cache_file_spec.GetPath().c_str(), error.AsCString());
+    }
+    return crc;
 }
 
 uint32_t
@@ -600,9 +648,9 @@ ObjectFileELF::CalculateELFNotesSegmentsCRC32 (const ProgramHeaderColl& program_
                 break;
             }
 
-            core_notes_crc = calc_crc32(core_notes_crc,
-                                        segment_data.GetDataStart(),
-                                        segment_data.GetByteSize());
+            core_notes_crc = CRC32(core_notes_crc,
+                                   segment_data.GetDataStart(),
+                                   segment_data.GetByteSize());
         }
     }
 
@@ -746,11 +794,6 @@ ObjectFileELF::GetModuleSpecifications (const lldb_private::FileSpec& file,
 
                         if (!gnu_debuglink_crc)
                         {
-                            lldb_private::Timer scoped_timer (__PRETTY_FUNCTION__,
-                                                              "Calculating module crc32 %s with size %" PRIu64 " KiB",
-                                                              file.GetLastPathComponent().AsCString(),
-                                                              (file.GetByteSize()-file_offset)/1024);
-
                             // For core files - which usually don't happen to have a gnu_debuglink,
                             // and are pretty bulky - calculating whole contents crc32 would be too much of luxury.
                             // Thus we will need to fallback to something simpler.
@@ -785,7 +828,7 @@ ObjectFileELF::GetModuleSpecifications (const lldb_private::FileSpec& file,
                                 // Need to map entire file into memory to calculate the crc.
                                 data_sp = file.MemoryMapFileContentsIfLocal (file_offset, SIZE_MAX);
                                 data.SetData(data_sp);
-                                gnu_debuglink_crc = calc_gnu_debuglink_crc32 (data.GetDataStart(), data.GetByteSize());
+                                gnu_debuglink_crc = calc_gnu_debuglink_crc32 (file, file_offset, data);
                             }
                         }
                         if (gnu_debuglink_crc)
@@ -846,7 +889,14 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_dynamic_symbols(),
     m_filespec_ap(),
     m_entry_point_address(),
-    m_arch_spec()
+    m_arch_spec(),
+    m_address_class_map(),
+    m_compressed_sections(),
+    m_decompress_once_flag(),
+    m_decompress_futures(),
+    m_decompressed_section_cache_prefix(),
+    m_gnu_debug_data_object_file(),
+    m_gnu_debug_data_parsed(false)
 {
     if (file)
         m_file = *file;
@@ -867,13 +917,23 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_dynamic_symbols(),
     m_filespec_ap(),
     m_entry_point_address(),
-    m_arch_spec()
+    m_arch_spec(),
+    m_address_class_map(),
+    m_compressed_sections(),
+    m_decompress_once_flag(),
+    m_decompress_futures(),
+    m_decompressed_section_cache_prefix(),
+    m_gnu_debug_data_object_file(),
+    m_gnu_debug_data_parsed(false)
 {
     ::memset(&m_header, 0, sizeof(m_header));
 }
 
 ObjectFileELF::~ObjectFileELF()
 {
+    // Decompression tasks that are still running refer to this object.
+    for (std::future<void> &future : m_decompress_futures)
+        future.wait();
 }
 
 bool
@@ -1067,7 +1127,7 @@ ObjectFileELF::GetUUID(lldb_private::UUID* uuid)
     else
     {
         if (!m_gnu_debuglink_crc)
-            m_gnu_debuglink_crc = calc_gnu_debuglink_crc32 (m_data.GetDataStart(), m_data.GetByteSize());
+            m_gnu_debuglink_crc = calc_gnu_debuglink_crc32 (m_file, m_file_offset, m_data);
         if (m_gnu_debuglink_crc)
         {
             // Use 4 bytes of crc from the .gnu_debuglink section.
@@ -1908,10 +1968,27 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
         {
             const ELFSectionHeaderInfo &header = *I;
 
-            ConstString& name = I->section_name;
+            ConstString name = I->section_name;
             const uint64_t file_size = header.sh_type == SHT_NOBITS ? 0 : header.sh_size;
             const uint64_t vm_size = header.sh_flags & SHF_ALLOC ? header.sh_size : 0;
 
+            // .zdebug_* sections are the old style of compressed .debug_*
+            // sections, name them after what they hold.
+            static const char *g_zdebug_prefix = ".zdebug_";
+            const bool is_zdebug = ::strncmp(name.AsCString(""), g_zdebug_prefix, strlen(g_zdebug_prefix)) == 0;
+            if (is_zdebug)
+                name.SetCString((std::string(".debug_") + (name.GetCString() + strlen(g_zdebug_prefix))).c_str());
+
+            if (!IsInMemory() && (is_zdebug || (header.sh_flags & SHF_COMPRESSED)))
+            {
+                std::unique_ptr<CompressedSection> compressed (new CompressedSection());
+                if (ParseCompressedSectionHeader(header, is_zdebug, *compressed))
+                {
+                    compressed->name = name;
+                    m_compressed_sections[SectionIndex(I)] = std::move(compressed);
+                }
+            }
+
             static ConstString g_sect_name_text (".text");
             static ConstString g_sect_name_data (".data");
             static ConstString g_sect_name_bss (".bss");
@@ -1938,6 +2015,10 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             static ConstString g_sect_name_dwarf_debug_loc_dwo (".debug_loc.dwo");
             static ConstString g_sect_name_dwarf_debug_str_dwo (".debug_str.dwo");
             static ConstString g_sect_name_dwarf_debug_str_offsets_dwo (".debug_str_offsets.dwo");
+            static ConstString g_sect_name_dwarf_apple_names (".apple_names");
+            static ConstString g_sect_name_dwarf_apple_types (".apple_types");
+            static ConstString g_sect_name_dwarf_apple_namespaces (".apple_namespaces");
+            static ConstString g_sect_name_dwarf_apple_objc (".apple_objc");
             static ConstString g_sect_name_eh_frame (".eh_frame");
             static ConstString g_sect_name_arm_exidx (".ARM.exidx");
             static ConstString g_sect_name_arm_extab (".ARM.extab");
@@ -1971,7 +2052,8 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             // .debug_pubtypes – Lookup table for mapping type names to compilation units
             // .debug_ranges – Address ranges used in DW_AT_ranges attributes
             // .debug_str – String table used in .debug_info
-            // MISSING? .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
+            // .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
+            //     read by GetGnuDebugDataObjectFile()
             // MISSING? .debug-index - http://src.chromium.org/viewvc/chrome/trunk/src/build/gdb-add-index?pathrev=144644
             // MISSING? .debug_types - Type descriptions from DWARF 4? See http://gcc.gnu.org/wiki/DwarfSeparateTypeInfo
             else if (name == g_sect_name_dwarf_debug_abbrev)          sect_type = eSectionTypeDWARFDebugAbbrev;
@@ -1995,6 +2077,12 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             else if (name == g_sect_name_dwarf_debug_loc_dwo)         sect_type = eSectionTypeDWARFDebugLoc;
             else if (name == g_sect_name_dwarf_debug_str_dwo)         sect_type = eSectionTypeDWARFDebugStr;
             else if (name == g_sect_name_dwarf_debug_str_offsets_dwo) sect_type = eSectionTypeDWARFDebugStrOffsets;
+            // Accelerator tables emitted by clang when -glldb or
+            // -mllvm -dwarf-accel-tables=Enable is used on ELF targets
+            else if (name == g_sect_name_dwarf_apple_names)           sect_type = eSectionTypeDWARFAppleNames;
+            else if (name == g_sect_name_dwarf_apple_types)           sect_type = eSectionTypeDWARFAppleTypes;
+            else if (name == g_sect_name_dwarf_apple_namespaces)      sect_type = eSectionTypeDWARFAppleNamespaces;
+            else if (name == g_sect_name_dwarf_apple_objc)            sect_type = eSectionTypeDWARFAppleObjC;
             else if (name == g_sect_name_eh_frame)                    sect_type = eSectionTypeEHFrame;
             else if (name == g_sect_name_arm_exidx)                   sect_type = eSectionTypeARMexidx;
             else if (name == g_sect_name_arm_extab)                   sect_type = eSectionTypeARMextab;
@@ -2076,6 +2164,10 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
                 eSectionTypeDWARFDebugRanges,
                 eSectionTypeDWARFDebugStr,
                 eSectionTypeDWARFDebugStrOffsets,
+                eSectionTypeDWARFAppleNames,
+                eSectionTypeDWARFAppleTypes,
+                eSectionTypeDWARFAppleNamespaces,
+                eSectionTypeDWARFAppleObjC,
                 eSectionTypeELFSymbolTable,
             };
             SectionList *elf_section_list = m_sections_ap.get();
@@ -2100,6 +2192,327 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
     }
 }
 
+bool
+ObjectFileELF::ParseCompressedSectionHeader(const ELFSectionHeaderInfo &header,
+                                            bool is_zdebug,
+                                            CompressedSection &compressed) const
+{
+    if (header.sh_type == SHT_NOBITS)
+        return false;
+
+    DataExtractor data (m_data, header.sh_offset, header.sh_size);
+    if (data.GetByteSize() != header.sh_size)
+        return false;
+
+    lldb::offset_t offset = 0;
+    if (header.sh_flags & SHF_COMPRESSED)
+    {
+        // An Elf32_Chdr or Elf64_Chdr in the byte order of the file.
+        const uint32_t header_size = m_header.Is64Bit() ? 24 : 12;
+        if (!data.ValidOffsetForDataOfSize(0, header_size))
+            return false;
+        const uint32_t ch_type = data.GetU32(&offset);
+        if (m_header.Is64Bit())
+        {
+            offset += 4;        // ch_reserved
+            compressed.uncompressed_size = data.GetU64(&offset);
+        }
+        else
+        {
+            compressed.uncompressed_size = data.GetU32(&offset);
+        }
+        offset = header_size;
+        if (ch_type != ELFCOMPRESS_ZLIB)
+            return false;
+    }
+    else if (is_zdebug)
+    {
+        // "ZLIB" followed by the uncompressed size as a big endian 64 bit
+        // value.
+        const char *magic = (const char *)data.GetData(&offset, 4);
+        if (magic == nullptr || ::memcmp(magic, "ZLIB", 4) != 0 || !data.ValidOffsetForDataOfSize(offset, 8))
+            return false;
+        data.SetByteOrder(eByteOrderBig);
+        compressed.uncompressed_size = data.GetU64(&offset);
+    }
+    else
+    {
+        return false;
+    }
+
+    compressed.compressed_offset = header.sh_offset + offset;
+    compressed.compressed_size = header.sh_size - offset;
+    compressed.decompressed = false;
+    return compressed.uncompressed_size > 0;
+}
+
+namespace {
+
+    // Sections at least this big are decompressed on the task pool as soon
+    // as the first compressed section is read.
+    const uint64_t g_min_parallel_decompression_size = 1024 * 1024;
+
+    // zlib can't do better than about 1032:1. Anything claiming more is
+    // corrupt and would only make us allocate way too much memory.
+    const uint64_t g_max_zlib_ratio = 1032;
+
+} // anonymous namespace
+
+void
+ObjectFileELF::DecompressSection(CompressedSection &compressed) const
+{
+    compressed.decompressed = true;
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_OBJECT));
+
+    FileSpec cache_file_spec;
+    if (!m_decompressed_section_cache_prefix.empty())
+    {
+        cache_file_spec.SetFile ((m_decompressed_section_cache_prefix + compressed.name.GetCString()).c_str(), false);
+        if (cache_file_spec.Exists() && cache_file_spec.GetByteSize() == compressed.uncompressed_size)
+        {
+            // Relocatable files get their debug info sections relocated in
+            // place, so map those copy on write.
+            const bool writeable = m_header.e_type == ET_REL;
+            DataBufferSP data_sp (cache_file_spec.MemoryMapFileContentsIfLocal (0, compressed.uncompressed_size, writeable));
+            if (data_sp && data_sp->GetByteSize() == compressed.uncompressed_size)
+            {
+                if (log)
+                    log->Printf ("ObjectFileELF::DecompressSection() mapped %s from '%s'",
+                                 compressed.name.GetCString(), cache_file_spec.GetPath().c_str());
+                compressed.data_sp = data_sp;
+                return;
+            }
+        }
+    }
+
+#if defined (HAVE_LIBZ)
+    static lldb_private::Timer::Category func_cat(__PRETTY_FUNCTION__);
+    lldb_private::Timer scoped_timer (func_cat,
+                                      "Decompressing %s of %s (%" PRIu64 " KiB)",
+                                      compressed.name.GetCString(),
+                                      m_file.GetFilename().AsCString("<Unknown>"),
+                                      compressed.uncompressed_size / 1024);
+
+    const uint8_t *src = m_data.PeekData (compressed.compressed_offset, compressed.compressed_size);
+    if (src == nullptr ||
+        compressed.uncompressed_size / g_max_zlib_ratio > compressed.compressed_size ||
+        compressed.uncompressed_size > SIZE_MAX)
+    {
+        if (log)
+            log->Printf ("ObjectFileELF::DecompressSection() %s has an invalid compression header",
+                         compressed.name.GetCString());
+        return;
+    }
+
+    std::unique_ptr<DataBufferHeap> data_ap (new DataBufferHeap (compressed.uncompressed_size, 0));
+    uLongf dst_len = compressed.uncompressed_size;
+    const int status = ::uncompress (data_ap->GetBytes(), &dst_len, src, compressed.compressed_size);
+    if (status != Z_OK || dst_len != compressed.uncompressed_size)
+    {
+        if (log)
+            log->Printf ("ObjectFileELF::DecompressSection() failed to decompress %s: %s",
+                         compressed.name.GetCString(),
+                         status != Z_OK ? zError(status) : "short output");
+        return;
+    }
+    compressed.data_sp.reset (data_ap.release());
+
+    if (cache_file_spec)
+    {
+        Error error = ModuleCache::WriteDataFile (cache_file_spec, compressed.data_sp->GetBytes(), compressed.data_sp->GetByteSize());
+        if (log)
+        {
+            if (error.Fail())
+                log->Printf ("ObjectFileELF::DecompressSection() failed to write '%s': %s",
+                             cache_file_spec.GetPath().c_str(), error.AsCString());
+            else
+                log->Printf ("ObjectFileELF::DecompressSection() wrote %s to '%s'",
+                             compressed.name.GetCString(), cache_file_spec.GetPath().c_str());
+        }
+    }
+#else
+    if (log)
+        log->Printf ("ObjectFileELF::DecompressSection() can't decompress %s, lldb was built without zlib",
+                     compressed.name.GetCString());
+#endif
+}
+
+bool
+ObjectFileELF::GetDecompressedSectionData(const Section *section, DataBufferSP &data_sp) const
+{
+    auto pos = m_compressed_sections.find (section->GetID());
+    if (pos == m_compressed_sections.end())
+        return false;
+
+    std::call_once (m_decompress_once_flag, [this, &pos]()
+    {
+        PlatformProperties *properties = Platform::GetGlobalPlatformProperties().get();
+        ModuleSP module_sp (GetModule());
+        const TimeValue mod_time = m_file.GetModificationTime();
+        FileSpec dir_spec = properties->GetModuleCacheDirectory();
+        if (properties->GetUseDecompressedSectionCache() && module_sp && module_sp->GetUUID().IsValid() &&
+            mod_time.IsValid() && dir_spec)
+        {
+            StreamString prefix;
+            prefix.Printf ("%s-%s-%" PRIu64 "-",
+                           module_sp->GetUUID().GetAsString().c_str(),
+                           m_file.GetFilename().AsCString("<Unknown>"),
+                           mod_time.GetAsSecondsSinceJan1_1970());
+            dir_spec.AppendPathComponent ("decompressed_sections");
+            dir_spec.AppendPathComponent (prefix.GetData());
+            m_decompressed_section_cache_prefix = dir_spec.GetPath();
+        }
+
+        // Whoever reads one debug info section is going to read most of
+        // the others, so get going on the big ones in parallel.
+        for (auto &entry : m_compressed_sections)
+        {
+            CompressedSection *compressed = entry.second.get();
+            if (entry.first == pos->first || compressed->uncompressed_size < g_min_parallel_decompression_size)
+                continue;
+            m_decompress_futures.push_back (TaskPool::AddTask ([this, compressed]()
+            {
+                std::lock_guard<std::mutex> guard (compressed->mutex);
+                if (!compressed->decompressed)
+                    DecompressSection (*compressed);
+            }));
+        }
+    });
+
+    CompressedSection &compressed = *pos->second;
+    std::lock_guard<std::mutex> guard (compressed.mutex);
+    if (!compressed.decompressed)
+        DecompressSection (compressed);
+    data_sp = compressed.data_sp;
+    return true;
+}
+
+size_t
+ObjectFileELF::ReadSectionData(const Section *section,
+                               lldb::offset_t section_offset,
+                               void *dst,
+                               size_t dst_len) const
+{
+    DataBufferSP data_sp;
+    if (section->GetObjectFile() != this || !GetDecompressedSectionData (section, data_sp))
+        return ObjectFile::ReadSectionData (section, section_offset, dst, dst_len);
+
+    if (!data_sp || section_offset >= data_sp->GetByteSize())
+        return 0;
+    const size_t bytes_to_copy = std::min<uint64_t> (dst_len, data_sp->GetByteSize() - section_offset);
+    ::memcpy (dst, data_sp->GetBytes() + section_offset, bytes_to_copy);
+    return bytes_to_copy;
+}
+
+size_t
+ObjectFileELF::ReadSectionData(const Section *section, DataExtractor& section_data) const
+{
+    DataBufferSP data_sp;
+    if (section->GetObjectFile() != this || !GetDecompressedSectionData (section, data_sp))
+        return ObjectFile::ReadSectionData (section, section_data);
+
+    if (!data_sp)
+    {
+        section_data.Clear();
+        return 0;
+    }
+    section_data.SetData (data_sp, 0, data_sp->GetByteSize());
+    section_data.SetByteOrder (GetByteOrder());
+    section_data.SetAddressByteSize (GetAddressByteSize());
+    return section_data.GetByteSize();
+}
+
+#if defined (HAVE_LIBLZMA)
+namespace {
+
+    // Decodes an xz stream whose uncompressed size isn't known up front.
+    bool
+    DecompressXZ (const uint8_t *src, size_t src_len, std::vector<uint8_t> &dst)
+    {
+        static lldb_private::Timer::Category func_cat(__PRETTY_FUNCTION__);
+        lldb_private::Timer scoped_timer (func_cat, "%" PRIu64 " bytes", (uint64_t)src_len);
+
+        lzma_stream stream = LZMA_STREAM_INIT;
+        if (lzma_stream_decoder (&stream, UINT64_MAX, 0) != LZMA_OK)
+            return false;
+
+        dst.resize (std::max<size_t> (src_len * 4, 4096));
+        stream.next_in = src;
+        stream.avail_in = src_len;
+        stream.next_out = dst.data();
+        stream.avail_out = dst.size();
+
+        lzma_ret ret;
+        while ((ret = lzma_code (&stream, LZMA_FINISH)) == LZMA_OK)
+        {
+            if (stream.avail_out == 0)
+            {
+                const size_t used = dst.size();
+                dst.resize (used * 2);
+                stream.next_out = dst.data() + used;
+                stream.avail_out = dst.size() - used;
+            }
+        }
+        dst.resize (stream.total_out);
+        lzma_end (&stream);
+        return ret == LZMA_STREAM_END;
+    }
+
+} // anonymous namespace
+#endif
+
+ObjectFileELF *
+ObjectFileELF::GetGnuDebugDataObjectFile()
+{
+    if (m_gnu_debug_data_parsed)
+        return m_gnu_debug_data_object_file.get();
+    m_gnu_debug_data_parsed = true;
+
+    static ConstString g_gnu_debugdata_name (".gnu_debugdata");
+    SectionList *section_list = GetSectionList();
+    SectionSP section_sp (section_list ? section_list->FindSectionByName (g_gnu_debugdata_name) : SectionSP());
+    if (!section_sp)
+        return nullptr;
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+
+#if defined (HAVE_LIBLZMA)
+    DataExtractor section_data;
+    if (ReadSectionData (section_sp.get(), section_data) == 0)
+        return nullptr;
+
+    std::vector<uint8_t> bytes;
+    if (!DecompressXZ (section_data.GetDataStart(), section_data.GetByteSize(), bytes))
+    {
+        if (log)
+            log->Printf ("ObjectFileELF::GetGnuDebugDataObjectFile() failed to decompress .gnu_debugdata of '%s'",
+                         m_file.GetPath().c_str());
+        return nullptr;
+    }
+
+    DataBufferSP data_sp (new DataBufferHeap (bytes.data(), bytes.size()));
+    if (!MagicBytesMatch (data_sp, 0, data_sp->GetByteSize()))
+        return nullptr;
+
+    std::unique_ptr<ObjectFileELF> objfile_ap (new ObjectFileELF (GetModule(), data_sp, 0, &m_file, 0, data_sp->GetByteSize()));
+    ArchSpec arch;
+    ArchSpec gdd_arch;
+    if (!GetArchitecture (arch) || !objfile_ap->GetArchitecture (gdd_arch) || !gdd_arch.IsCompatibleMatch (arch))
+        return nullptr;
+
+    if (log)
+        log->Printf ("ObjectFileELF::GetGnuDebugDataObjectFile() found %" PRIu64 " bytes of MiniDebugInfo in '%s'",
+                     (uint64_t)data_sp->GetByteSize(), m_file.GetPath().c_str());
+    m_gnu_debug_data_object_file = std::move (objfile_ap);
+#else
+    if (log)
+        log->Printf ("ObjectFileELF::GetGnuDebugDataObjectFile() can't read .gnu_debugdata of '%s', lldb was built without liblzma",
+                     m_file.GetPath().c_str());
+#endif
+    return m_gnu_debug_data_object_file.get();
+}
+
 // Find the arm/aarch64 mapping symbol character in the given symbol name. Mapping symbols have the
 // form of "$<char>[.<any>]*". Additionally we recognize cases when the mapping symbol prefixed by
 // an arbitrary string because if a symbol prefix added to each symbol in the object file with
@@ -2514,6 +2927,11 @@ ObjectFileELF::ParseSymbolTable(Symtab *symbol_table,
         if (ReadSectionData(symtab, symtab_data) &&
             ReadSectionData(strtab, strtab_data))
         {
+            // The symbols are parsed in order, but their names are all
+            // over the string table, so read ahead there doesn't help.
+            symtab_data.Advise(DataBuffer::eAccessPatternSequential);
+            strtab_data.Advise(DataBuffer::eAccessPatternRandom);
+
             size_t num_symbols = symtab_data.GetByteSize() / symtab_hdr->sh_entsize;
 
             return ParseSymbols(symbol_table, start_id, section_list,
@@ -2836,7 +3254,7 @@ ObjectFileELF::RelocateSection(Symtab* symtab, const ELFHeader *hdr, const ELFSe
                 {
                     addr_t value = symbol->GetAddressRef().GetFileAddress();
                     DataBufferSP& data_buffer_sp = debug_data.GetSharedDataBuffer();
-                    uint64_t* dst = reinterpret_cast<uint64_t*>(data_buffer_sp->GetBytes() + rel_section->GetFileOffset() + ELFRelocation::RelocOffset64(rel));
+                    uint64_t* dst = reinterpret_cast<uint64_t*>(data_buffer_sp->GetBytes() + debug_data.GetSharedDataOffset() + ELFRelocation::RelocOffset64(rel));
                     *dst = value + ELFRelocation::RelocAddend64(rel);
                 }
                 break;
@@ -2854,7 +3272,7 @@ ObjectFileELF::RelocateSection(Symtab* symtab, const ELFHeader *hdr, const ELFSe
                             ((int64_t)value <= INT32_MAX && (int64_t)value >= INT32_MIN)));
                     uint32_t truncated_addr = (value & 0xFFFFFFFF);
                     DataBufferSP& data_buffer_sp = debug_data.GetSharedDataBuffer();
-                    uint32_t* dst = reinterpret_cast<uint32_t*>(data_buffer_sp->GetBytes() + rel_section->GetFileOffset() + ELFRelocation::RelocOffset32(rel));
+                    uint32_t* dst = reinterpret_cast<uint32_t*>(data_buffer_sp->GetBytes() + debug_data.GetSharedDataOffset() + ELFRelocation::RelocOffset32(rel));
                     *dst = truncated_addr;
                 }
                 break;
@@ -2918,6 +3336,121 @@ ObjectFileELF::RelocateDebugSections(const ELFSectionHeader *rel_hdr, user_id_t
     return 0;
 }
 
+namespace {
+
+    // Bump this whenever the encoding of the symbol table cache changes
+    const char *g_symtab_cache_magic = "LLDBSYMT";
+    const uint32_t g_symtab_cache_version = 1;
+
+} // anonymous namespace
+
+bool
+ObjectFileELF::GetSymtabCacheFileSpec(const Section *symtab, FileSpec &cache_file_spec)
+{
+    PlatformProperties *properties = Platform::GetGlobalPlatformProperties().get();
+    if (!properties->GetUseSymbolTableCache())
+        return false;
+
+    ModuleSP module_sp(GetModule());
+    if (!module_sp || !module_sp->GetUUID().IsValid())
+        return false;
+
+    // The symbols can come from a separate debug file, which can be added
+    // or replaced without the module changing.
+    const FileSpec &symtab_file_spec = symtab ? symtab->GetObjectFile()->GetFileSpec() : m_file;
+    const TimeValue mod_time = symtab_file_spec.GetModificationTime();
+    if (!mod_time.IsValid())
+        return false;
+
+    FileSpec dir_spec = properties->GetModuleCacheDirectory();
+    if (!dir_spec)
+        return false;
+
+    StreamString file_name;
+    file_name.Printf ("%s-%s-%" PRIu64 ".symtab",
+                      module_sp->GetUUID().GetAsString().c_str(),
+                      symtab_file_spec.GetFilename().AsCString("<Unknown>"),
+                      mod_time.GetAsSecondsSinceJan1_1970());
+    cache_file_spec = dir_spec;
+    cache_file_spec.AppendPathComponent ("symtabs");
+    cache_file_spec.AppendPathComponent (file_name.GetData());
+    return true;
+}
+
+bool
+ObjectFileELF::LoadSymtabCache(const FileSpec &cache_file_spec, ObjectFile *symtab_obj_file)
+{
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    DataBufferSP data_sp = ModuleCache::MapDataFile (cache_file_spec);
+    if (!data_sp)
+        return false;
+
+    DataExtractor data (data_sp, endian::InlHostByteOrder(), 4);
+    lldb::offset_t offset = 0;
+    const size_t magic_len = strlen (g_symtab_cache_magic);
+    const char *magic = (const char *)data.GetData (&offset, magic_len);
+    const uint32_t version = data.GetU32 (&offset);
+
+    std::unique_ptr<Symtab> symtab_ap(new Symtab(symtab_obj_file));
+    FileAddressToAddressClassMap address_class_map;
+    bool success = magic != nullptr &&
+                   ::memcmp (magic, g_symtab_cache_magic, magic_len) == 0 &&
+                   version == g_symtab_cache_version &&
+                   symtab_ap->Decode (data, &offset, GetModule()->GetSectionList());
+    if (success)
+    {
+        const uint32_t num_address_classes = data.GetU32 (&offset);
+        success = data.ValidOffsetForDataOfSize (offset, (uint64_t)num_address_classes * 12);
+        for (uint32_t i = 0; success && i < num_address_classes; ++i)
+        {
+            const addr_t file_addr = data.GetU64 (&offset);
+            address_class_map[file_addr] = (AddressClass)data.GetU32 (&offset);
+        }
+    }
+
+    if (!success)
+    {
+        if (log)
+            log->Printf ("ObjectFileELF::LoadSymtabCache() ignoring invalid cache file '%s'",
+                         cache_file_spec.GetPath().c_str());
+        return false;
+    }
+
+    m_symtab_ap.swap (symtab_ap);
+    m_address_class_map.swap (address_class_map);
+    if (log)
+        log->Printf ("ObjectFileELF::LoadSymtabCache() loaded %" PRIu64 " symbols from '%s'",
+                     (uint64_t)m_symtab_ap->GetNumSymbols(), cache_file_spec.GetPath().c_str());
+    return true;
+}
+
+void
+ObjectFileELF::SaveSymtabCache(const FileSpec &cache_file_spec)
+{
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    strm.Write (g_symtab_cache_magic, strlen (g_symtab_cache_magic));
+    strm.PutHex32 (g_symtab_cache_version);
+    m_symtab_ap->Encode (strm);
+    strm.PutHex32 (m_address_class_map.size());
+    for (const auto &entry : m_address_class_map)
+    {
+        strm.PutHex64 (entry.first);
+        strm.PutHex32 (entry.second);
+    }
+
+    Error error = ModuleCache::WriteDataFile (cache_file_spec, strm.GetData(), strm.GetSize());
+    if (log)
+    {
+        if (error.Fail())
+            log->Printf ("ObjectFileELF::SaveSymtabCache() failed to write '%s': %s",
+                         cache_file_spec.GetPath().c_str(), error.AsCString());
+        else
+            log->Printf ("ObjectFileELF::SaveSymtabCache() saved %" PRIu64 " symbols to '%s'",
+                         (uint64_t)m_symtab_ap->GetNumSymbols(), cache_file_spec.GetPath().c_str());
+    }
+}
+
 Symtab *
 ObjectFileELF::GetSymtab()
 {
@@ -2939,6 +3472,7 @@ ObjectFileELF::GetSymtab()
 
         uint64_t symbol_id = 0;
         std::lock_guard<std::recursive_mutex> guard(module_sp->GetMutex());
+        IntervalTimer parse_timer;
 
         // Sharable objects and dynamic executables usually have 2 distinct symbol
         // tables, one named ".symtab", and the other ".dynsym". The dynsym is a smaller
@@ -2952,52 +3486,81 @@ ObjectFileELF::GetSymtab()
             // then use the dynsym section which should always be there.
             symtab = section_list->FindSectionByType (eSectionTypeELFDynamicSymbols, true).get();
         }
-        if (symtab)
-        {
-            m_symtab_ap.reset(new Symtab(symtab->GetObjectFile()));
-            symbol_id += ParseSymbolTable (m_symtab_ap.get(), symbol_id, symtab);
-        }
 
-        // DT_JMPREL
-        //      If present, this entry's d_ptr member holds the address of relocation
-        //      entries associated solely with the procedure linkage table. Separating
-        //      these relocation entries lets the dynamic linker ignore them during
-        //      process initialization, if lazy binding is enabled. If this entry is
-        //      present, the related entries of types DT_PLTRELSZ and DT_PLTREL must
-        //      also be present.
-        const ELFDynamic *symbol = FindDynamicSymbol(DT_JMPREL);
-        if (symbol)
+        // The parsed symbols can be shared with other debug sessions through
+        // the module cache directory.
+        FileSpec cache_file_spec;
+        const bool use_symtab_cache = GetSymtabCacheFileSpec (symtab, cache_file_spec);
+        if (!use_symtab_cache || !LoadSymtabCache (cache_file_spec, symtab ? symtab->GetObjectFile() : this))
         {
-            // Synthesize trampoline symbols to help navigate the PLT.
-            addr_t addr = symbol->d_ptr;
-            Section *reloc_section = section_list->FindSectionContainingFileAddress(addr).get();
-            if (reloc_section)
+            if (symtab)
             {
-                user_id_t reloc_id = reloc_section->GetID();
-                const ELFSectionHeaderInfo *reloc_header = GetSectionHeaderByIndex(reloc_id);
-                assert(reloc_header);
+                m_symtab_ap.reset(new Symtab(symtab->GetObjectFile()));
+                symbol_id += ParseSymbolTable (m_symtab_ap.get(), symbol_id, symtab);
+            }
 
-                if (m_symtab_ap == nullptr)
-                    m_symtab_ap.reset(new Symtab(reloc_section->GetObjectFile()));
+            // Stripped distribution binaries often carry a MiniDebugInfo symbol
+            // table with the local and static functions that aren't in the
+            // dynsym. Without them every frame in those functions is unnamed.
+            if (symtab == nullptr || symtab->GetType() != eSectionTypeELFSymbolTable)
+            {
+                ObjectFileELF *gdd_obj_file = GetGnuDebugDataObjectFile();
+                SectionList *gdd_section_list = gdd_obj_file ? gdd_obj_file->GetSectionList(false) : nullptr;
+                Section *gdd_symtab = gdd_section_list ? gdd_section_list->FindSectionByType (eSectionTypeELFSymbolTable, true).get() : nullptr;
+                if (gdd_symtab)
+                {
+                    if (m_symtab_ap == nullptr)
+                        m_symtab_ap.reset(new Symtab(this));
+                    symbol_id += gdd_obj_file->ParseSymbolTable (m_symtab_ap.get(), symbol_id, gdd_symtab);
+                    m_address_class_map.insert (gdd_obj_file->m_address_class_map.begin(),
+                                                gdd_obj_file->m_address_class_map.end());
+                }
+            }
 
-                ParseTrampolineSymbols (m_symtab_ap.get(), symbol_id, reloc_header, reloc_id);
+            // DT_JMPREL
+            //      If present, this entry's d_ptr member holds the address of relocation
+            //      entries associated solely with the procedure linkage table. Separating
+            //      these relocation entries lets the dynamic linker ignore them during
+            //      process initialization, if lazy binding is enabled. If this entry is
+            //      present, the related entries of types DT_PLTRELSZ and DT_PLTREL must
+            //      also be present.
+            const ELFDynamic *symbol = FindDynamicSymbol(DT_JMPREL);
+            if (symbol)
+            {
+                // Synthesize trampoline symbols to help navigate the PLT.
+                addr_t addr = symbol->d_ptr;
+                Section *reloc_section = section_list->FindSectionContainingFileAddress(addr).get();
+                if (reloc_section)
+                {
+                    user_id_t reloc_id = reloc_section->GetID();
+                    const ELFSectionHeaderInfo *reloc_header = GetSectionHeaderByIndex(reloc_id);
+                    assert(reloc_header);
+
+                    if (m_symtab_ap == nullptr)
+                        m_symtab_ap.reset(new Symtab(reloc_section->GetObjectFile()));
+
+                    ParseTrampolineSymbols (m_symtab_ap.get(), symbol_id, reloc_header, reloc_id);
+                }
             }
-        }
 
-        DWARFCallFrameInfo* eh_frame = GetUnwindTable().GetEHFrameInfo();
-        if (eh_frame)
-        {
+            DWARFCallFrameInfo* eh_frame = GetUnwindTable().GetEHFrameInfo();
+            if (eh_frame)
+            {
+                if (m_symtab_ap == nullptr)
+                    m_symtab_ap.reset(new Symtab(this));
+                ParseUnwindSymbols (m_symtab_ap.get(), eh_frame);
+            }
+
+            // If we still don't have any symtab then create an empty instance to avoid do the section
+            // lookup next time.
             if (m_symtab_ap == nullptr)
                 m_symtab_ap.reset(new Symtab(this));
-            ParseUnwindSymbols (m_symtab_ap.get(), eh_frame);
-        }
-
-        // If we still don't have any symtab then create an empty instance to avoid do the section
-        // lookup next time.
-        if (m_symtab_ap == nullptr)
-            m_symtab_ap.reset(new Symtab(this));
 
-        m_symtab_ap->CalculateSymbolSizes();
+            m_symtab_ap->CalculateSymbolSizes();
+            if (use_symtab_cache)
+                SaveSymtabCache (cache_file_spec);
+        }
+        m_symtab_ap->SetParseTime(parse_timer.GetElapsedNanoSeconds());
     }
 
     for (SectionHeaderCollIter I = m_section_headers.begin();
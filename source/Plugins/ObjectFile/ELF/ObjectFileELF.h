@@ -15,6 +15,10 @@
 
 // C++ Includes
 #include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 // Other libraries and framework includes
@@ -110,6 +114,11 @@ public:
                              lldb::offset_t length,
                              lldb_private::ModuleSpecList &specs);
 
+    static bool
+    SaveCore (const lldb::ProcessSP &process_sp,
+              const lldb_private::FileSpec &outfile,
+              lldb_private::Error &error);
+
     static bool
     MagicBytesMatch (lldb::DataBufferSP& data_sp,
                      lldb::addr_t offset, 
@@ -198,6 +207,18 @@ public:
     std::string
     StripLinkerSymbolAnnotations(llvm::StringRef symbol_name) const override;
 
+    // Compressed debug info sections (SHF_COMPRESSED or .zdebug_*) are
+    // decompressed the first time they are read.
+    size_t
+    ReadSectionData(const lldb_private::Section *section,
+                    lldb::offset_t section_offset,
+                    void *dst,
+                    size_t dst_len) const override;
+
+    size_t
+    ReadSectionData(const lldb_private::Section *section,
+                    lldb_private::DataExtractor& section_data) const override;
+
 private:
     ObjectFileELF(const lldb::ModuleSP &module_sp,
                   lldb::DataBufferSP& data_sp,
@@ -228,6 +249,20 @@ private:
     typedef DynamicSymbolColl::iterator         DynamicSymbolCollIter;
     typedef DynamicSymbolColl::const_iterator   DynamicSymbolCollConstIter;
 
+    /// A compressed section and, once it was read, its decompressed bytes.
+    struct CompressedSection
+    {
+        lldb_private::ConstString name;
+        lldb::offset_t compressed_offset;   // file offset of the zlib stream
+        lldb::offset_t compressed_size;
+        uint64_t uncompressed_size;
+        std::mutex mutex;                   // held while decompressing
+        bool decompressed;
+        lldb::DataBufferSP data_sp;         // NULL if decompression failed
+    };
+
+    typedef std::map<lldb::user_id_t, std::unique_ptr<CompressedSection>> CompressedSectionMap;
+
     typedef std::map<lldb::addr_t, lldb::AddressClass> FileAddressToAddressClassMap;
     typedef std::function<lldb::offset_t (lldb_private::DataExtractor &, lldb::offset_t, lldb::offset_t)> SetDataFunction;
 
@@ -267,6 +302,22 @@ private:
     /// The address class for each symbol in the elf file
     FileAddressToAddressClassMap m_address_class_map;
 
+    /// The compressed sections by section ID, filled in by CreateSections.
+    CompressedSectionMap m_compressed_sections;
+
+    /// The first read of a compressed section starts decompressing the
+    /// other large ones on the task pool.
+    mutable std::once_flag m_decompress_once_flag;
+    mutable std::vector<std::future<void>> m_decompress_futures;
+
+    /// Where decompressed sections are cached on disk, empty if they
+    /// aren't.
+    mutable std::string m_decompressed_section_cache_prefix;
+
+    /// The ELF file embedded in the .gnu_debugdata section, if any.
+    std::unique_ptr<ObjectFileELF> m_gnu_debug_data_object_file;
+    bool m_gnu_debug_data_parsed;
+
     /// Returns a 1 based index of the given section header.
     size_t
     SectionIndex(const SectionHeaderCollIter &I);
@@ -275,6 +326,31 @@ private:
     size_t
     SectionIndex(const SectionHeaderCollConstIter &I) const;
 
+    /// Reads the compression header of a SHF_COMPRESSED or .zdebug
+    /// section. Returns false if the section isn't compressed with zlib.
+    bool
+    ParseCompressedSectionHeader(const ELFSectionHeaderInfo &header,
+                                 bool is_zdebug,
+                                 CompressedSection &compressed) const;
+
+    /// Gets the decompressed bytes of a section, decompressing it if it
+    /// wasn't yet. Returns false if the section isn't compressed,
+    /// \a data_sp is NULL if it couldn't be decompressed.
+    bool
+    GetDecompressedSectionData(const lldb_private::Section *section,
+                               lldb::DataBufferSP &data_sp) const;
+
+    /// Decompresses the section, or maps it from the cache on disk. The
+    /// caller has to hold compressed.mutex.
+    void
+    DecompressSection(CompressedSection &compressed) const;
+
+    /// Decompresses the .gnu_debugdata section (MiniDebugInfo) and returns
+    /// the ELF file it holds. Returns NULL if there is no such section or it
+    /// can't be decompressed.
+    ObjectFileELF *
+    GetGnuDebugDataObjectFile();
+
     // Parses the ELF program headers.
     static size_t
     GetProgramHeaderInfo(ProgramHeaderColl &program_headers,
@@ -332,6 +408,24 @@ private:
                      lldb::user_id_t start_id,
                      lldb_private::Section *symtab);
 
+    /// The file in the module cache directory that holds the parsed symbol
+    /// table (see "platform.use-symbol-table-cache"), keyed by the UUID and
+    /// the file the symbols are read from. Returns false if the symbol table
+    /// isn't cached.
+    bool
+    GetSymtabCacheFileSpec(const lldb_private::Section *symtab,
+                           lldb_private::FileSpec &cache_file_spec);
+
+    /// Replaces m_symtab_ap and m_address_class_map with the ones in a
+    /// symbol table cache file. Returns false if the file doesn't exist or
+    /// doesn't match this module.
+    bool
+    LoadSymtabCache(const lldb_private::FileSpec &cache_file_spec,
+                    lldb_private::ObjectFile *symtab_obj_file);
+
+    void
+    SaveSymtabCache(const lldb_private::FileSpec &cache_file_spec);
+
     /// Helper routine for ParseSymbolTable().
     unsigned
     ParseSymbols(lldb_private::Symtab *symbol_table, 
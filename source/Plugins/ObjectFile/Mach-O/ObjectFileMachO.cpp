@@ -28,6 +28,7 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/UUID.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
@@ -54,6 +55,7 @@
 #endif
 
 #ifndef __APPLE__
+#include "Utility/ModuleCache.h"
 #include "Utility/UuidCompatibility.h"
 #endif
 
@@ -948,6 +950,16 @@ ObjectFileMachO::Initialize()
                                    CreateMemoryInstance,
                                    GetModuleSpecifications,
                                    SaveCore);
+
+    // MH_MAGIC, MH_MAGIC_64 and their byte swapped versions
+    static const uint8_t g_magics[][4] = {
+        { 0xfe, 0xed, 0xfa, 0xce },
+        { 0xce, 0xfa, 0xed, 0xfe },
+        { 0xfe, 0xed, 0xfa, 0xcf },
+        { 0xcf, 0xfa, 0xed, 0xfe }
+    };
+    for (const uint8_t *magic : g_magics)
+        PluginManager::AddObjectFileMagic (CreateInstance, magic, sizeof(g_magics[0]));
 }
 
 void
@@ -1460,15 +1472,167 @@ ObjectFileMachO::GetSymtab()
         std::lock_guard<std::recursive_mutex> guard(module_sp->GetMutex());
         if (m_symtab_ap.get() == NULL)
         {
+            IntervalTimer parse_timer;
             m_symtab_ap.reset(new Symtab(this));
             std::lock_guard<std::recursive_mutex> symtab_guard(m_symtab_ap->GetMutex());
-            ParseSymtab ();
+
+            // The parsed symbols can be shared with other debug sessions
+            // through the module cache directory.
+            FileSpec cache_file_spec;
+            const bool use_symtab_cache = GetSymtabCacheFileSpec (cache_file_spec);
+            if (!use_symtab_cache || !LoadSymtabCache (cache_file_spec))
+            {
+                ParseSymtab ();
+                if (use_symtab_cache)
+                    SaveSymtabCache (cache_file_spec);
+            }
             m_symtab_ap->Finalize ();
+            m_symtab_ap->SetParseTime(parse_timer.GetElapsedNanoSeconds());
         }
     }
     return m_symtab_ap.get();
 }
 
+namespace {
+
+    // Bump this whenever the encoding of the symbol table cache changes
+    const char *g_symtab_cache_magic = "LLDBSYMM";
+    const uint32_t g_symtab_cache_version = 1;
+
+} // anonymous namespace
+
+bool
+ObjectFileMachO::GetSymtabCacheFileSpec (FileSpec &cache_file_spec)
+{
+    PlatformProperties *properties = Platform::GetGlobalPlatformProperties().get();
+    if (!properties->GetUseSymbolTableCache())
+        return false;
+
+    ModuleSP module_sp(GetModule());
+    if (!module_sp || !module_sp->GetUUID().IsValid())
+        return false;
+
+    // Images read from memory only have all of their symbols if the whole
+    // symbol table was read.
+    ProcessSP process_sp (m_process_wp.lock());
+    if (process_sp && IsInMemory() &&
+        process_sp->GetTarget().GetMemoryModuleLoadLevel() != eMemoryModuleLoadLevelComplete)
+        return false;
+
+    FileSpec dir_spec = properties->GetModuleCacheDirectory();
+    if (!dir_spec)
+        return false;
+
+    StreamString file_name;
+    if (m_header.flags & 0x80000000u)
+    {
+        // The local symbols of images in the dyld shared cache are read from
+        // the shared cache file, which only matches the process if their
+        // UUIDs match.
+        const UUID shared_cache_uuid = GetProcessSharedCacheUUID (process_sp.get());
+        if (!shared_cache_uuid.IsValid())
+            return false;
+        file_name.Printf ("%s-%s.symtab",
+                          module_sp->GetUUID().GetAsString().c_str(),
+                          shared_cache_uuid.GetAsString().c_str());
+    }
+    else
+    {
+        const TimeValue mod_time = m_file.GetModificationTime();
+        if (!mod_time.IsValid())
+            return false;
+        file_name.Printf ("%s-%s-%" PRIu64 ".symtab",
+                          module_sp->GetUUID().GetAsString().c_str(),
+                          m_file.GetFilename().AsCString("<Unknown>"),
+                          mod_time.GetAsSecondsSinceJan1_1970());
+    }
+    cache_file_spec = dir_spec;
+    cache_file_spec.AppendPathComponent ("symtabs");
+    cache_file_spec.AppendPathComponent (file_name.GetData());
+    return true;
+}
+
+bool
+ObjectFileMachO::LoadSymtabCache (const FileSpec &cache_file_spec)
+{
+    if (!cache_file_spec.Exists())
+        return false;
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    DataBufferSP data_sp = ModuleCache::MapDataFile (cache_file_spec);
+    if (!data_sp)
+        return false;
+
+    DataExtractor data (data_sp, endian::InlHostByteOrder(), 4);
+    lldb::offset_t offset = 0;
+    const size_t magic_len = strlen (g_symtab_cache_magic);
+    const char *magic = (const char *)data.GetData (&offset, magic_len);
+    const uint32_t version = data.GetU32 (&offset);
+
+    bool success = magic != nullptr &&
+                   ::memcmp (magic, g_symtab_cache_magic, magic_len) == 0 &&
+                   version == g_symtab_cache_version &&
+                   m_symtab_ap->Decode (data, &offset, GetModule()->GetSectionList());
+
+    // ParseSymtab() also collects the re-exported dylibs from the load
+    // commands.
+    FileSpecList reexported_dylibs;
+    if (success)
+    {
+        const uint32_t num_reexported_dylibs = data.GetU32 (&offset);
+        for (uint32_t i = 0; success && i < num_reexported_dylibs; ++i)
+        {
+            const char *path = data.GetCStr (&offset);
+            if (path == nullptr)
+                success = false;
+            else
+                reexported_dylibs.Append (FileSpec (path, false));
+        }
+    }
+
+    if (!success)
+    {
+        if (log)
+            log->Printf ("ObjectFileMachO::LoadSymtabCache() ignoring invalid cache file '%s'",
+                         cache_file_spec.GetPath().c_str());
+        return false;
+    }
+
+    for (size_t i = 0; i < reexported_dylibs.GetSize(); ++i)
+        m_reexported_dylibs.AppendIfUnique (reexported_dylibs.GetFileSpecAtIndex(i));
+    if (log)
+        log->Printf ("ObjectFileMachO::LoadSymtabCache() loaded %" PRIu64 " symbols from '%s'",
+                     (uint64_t)m_symtab_ap->GetNumSymbols(), cache_file_spec.GetPath().c_str());
+    return true;
+}
+
+void
+ObjectFileMachO::SaveSymtabCache (const FileSpec &cache_file_spec)
+{
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    strm.Write (g_symtab_cache_magic, strlen (g_symtab_cache_magic));
+    strm.PutHex32 (g_symtab_cache_version);
+    m_symtab_ap->Encode (strm);
+    strm.PutHex32 (m_reexported_dylibs.GetSize());
+    for (size_t i = 0; i < m_reexported_dylibs.GetSize(); ++i)
+    {
+        const std::string path = m_reexported_dylibs.GetFileSpecAtIndex(i).GetPath();
+        strm.Write (path.c_str(), path.size() + 1);
+    }
+
+    Error error = ModuleCache::WriteDataFile (cache_file_spec, strm.GetData(), strm.GetSize());
+    if (log)
+    {
+        if (error.Fail())
+            log->Printf ("ObjectFileMachO::SaveSymtabCache() failed to write '%s': %s",
+                         cache_file_spec.GetPath().c_str(), error.AsCString());
+        else
+            log->Printf ("ObjectFileMachO::SaveSymtabCache() saved %" PRIu64 " symbols to '%s'",
+                         (uint64_t)m_symtab_ap->GetNumSymbols(), cache_file_spec.GetPath().c_str());
+    }
+}
+
 bool
 ObjectFileMachO::IsStripped ()
 {
@@ -2231,7 +2395,8 @@ ObjectFileMachO::GetSharedCacheUUID (FileSpec dyld_shared_cache, const ByteOrder
 size_t
 ObjectFileMachO::ParseSymtab ()
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "ObjectFileMachO::ParseSymtab () module = %s",
                        m_file.GetFilename().AsCString(""));
     ModuleSP module_sp (GetModule());
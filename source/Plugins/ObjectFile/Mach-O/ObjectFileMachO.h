@@ -230,6 +230,21 @@ protected:
     size_t
     ParseSymtab();
 
+    // The file in the module cache directory that holds the parsed symbol
+    // table (see "platform.use-symbol-table-cache"). Images in the dyld
+    // shared cache are keyed by the shared cache UUID of the process since
+    // their local symbols come from the shared cache, other images by the
+    // file the symbols are read from. Returns false if the symbol table
+    // isn't cached.
+    bool
+    GetSymtabCacheFileSpec (lldb_private::FileSpec &cache_file_spec);
+
+    bool
+    LoadSymtabCache (const lldb_private::FileSpec &cache_file_spec);
+
+    void
+    SaveSymtabCache (const lldb_private::FileSpec &cache_file_spec);
+
     llvm::MachO::mach_header m_header;
     static const lldb_private::ConstString &GetSegmentNameTEXT();
     static const lldb_private::ConstString &GetSegmentNameDATA();
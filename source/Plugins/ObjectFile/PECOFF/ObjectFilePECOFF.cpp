@@ -46,6 +46,9 @@ ObjectFilePECOFF::Initialize()
                                    CreateMemoryInstance,
                                    GetModuleSpecifications,
                                    SaveCore);
+
+    // IMAGE_DOS_SIGNATURE in the DOS stub of every PE/COFF file
+    PluginManager::AddObjectFileMagic (CreateInstance, "MZ", 2);
 }
 
 void
@@ -9,6 +9,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <unordered_map>
 
 // Other libraries and framework includes
@@ -16,6 +17,7 @@
 #include "OperatingSystemGo.h"
 
 #include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
@@ -163,6 +165,50 @@ struct OperatingSystemGo::Goroutine
     uint32_t m_status;
 };
 
+// Where the fields we need live in a runtime.g, so a goroutine can be decoded
+// from raw memory instead of through ValueObjects.
+struct OperatingSystemGo::GoroutineLayout
+{
+    uint64_t m_goid_offset;
+    uint64_t m_goid_size;
+    uint64_t m_status_offset;
+    uint64_t m_status_size;
+    uint64_t m_sched_offset;
+    uint64_t m_lostack_offset;
+    uint64_t m_histack_offset;
+    uint64_t m_stack_size;
+    uint64_t m_read_size; // The bytes of a g that cover all the fields above.
+};
+
+namespace
+{
+
+// Goroutines are allocated next to each other, so the g structs are read in
+// runs that span neighbouring goroutines rather than one at a time.
+const uint64_t g_max_goroutine_read_size = 256 * 1024;
+const uint64_t g_max_goroutine_read_gap = 4096;
+
+bool
+FindField(const CompilerType &type, const char *name, uint64_t &byte_offset, CompilerType &field_type)
+{
+    const uint32_t num_fields = type.GetNumFields();
+    for (uint32_t idx = 0; idx < num_fields; ++idx)
+    {
+        std::string field_name;
+        uint64_t bit_offset = 0;
+        CompilerType child_type = type.GetFieldAtIndex(idx, field_name, &bit_offset, nullptr, nullptr);
+        if (field_name == name)
+        {
+            byte_offset = bit_offset / 8;
+            field_type = child_type;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // anonymous namespace
+
 void
 OperatingSystemGo::Initialize()
 {
@@ -324,6 +370,52 @@ OperatingSystemGo::Init(ThreadList &threads)
         ConstString alt_name(reg.alt_name);
         m_reginfo->AddRegister(reg, name, alt_name, register_sets[idx]);
     }
+    // Without the layout we can still list goroutines, just more slowly.
+    InitGoroutineLayout(target_sp);
+    return true;
+}
+
+bool
+OperatingSystemGo::InitGoroutineLayout(TargetSP target_sp)
+{
+    m_goroutine_layout_ap.reset();
+    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_OS));
+
+    TypeSP g_sp = FindType(target_sp, "runtime.g");
+    if (!g_sp)
+        return false;
+    CompilerType g_type(g_sp->GetLayoutCompilerType());
+
+    std::unique_ptr<GoroutineLayout> layout(new GoroutineLayout());
+    CompilerType goid_type, status_type, sched_type, stack_type, lo_type, hi_type;
+    uint64_t stack_offset = 0;
+    uint64_t lo_offset = 0;
+    uint64_t hi_offset = 0;
+    if (!FindField(g_type, "goid", layout->m_goid_offset, goid_type) ||
+        !FindField(g_type, "atomicstatus", layout->m_status_offset, status_type) ||
+        !FindField(g_type, "sched", layout->m_sched_offset, sched_type) ||
+        !FindField(g_type, "stack", stack_offset, stack_type) || !FindField(stack_type, "lo", lo_offset, lo_type) ||
+        !FindField(stack_type, "hi", hi_offset, hi_type))
+    {
+        if (log)
+            log->Printf("OperatingSystemGo unable to find the fields of struct g, reading goroutines one by one");
+        return false;
+    }
+    layout->m_goid_size = goid_type.GetByteSize(nullptr);
+    layout->m_status_size = status_type.GetByteSize(nullptr);
+    layout->m_stack_size = lo_type.GetByteSize(nullptr);
+    layout->m_lostack_offset = stack_offset + lo_offset;
+    layout->m_histack_offset = stack_offset + hi_offset;
+    if (layout->m_goid_size == 0 || layout->m_goid_size > 8 || layout->m_status_size == 0 ||
+        layout->m_status_size > 8 || layout->m_stack_size == 0 || layout->m_stack_size > 8 ||
+        hi_type.GetByteSize(nullptr) != layout->m_stack_size)
+        return false;
+
+    layout->m_read_size = std::max({layout->m_goid_offset + layout->m_goid_size,
+                                    layout->m_status_offset + layout->m_status_size,
+                                    layout->m_lostack_offset + layout->m_stack_size,
+                                    layout->m_histack_offset + layout->m_stack_size});
+    m_goroutine_layout_ap = std::move(layout);
     return true;
 }
 
@@ -369,15 +461,27 @@ OperatingSystemGo::UpdateThreadList(ThreadList &old_thread_list, ThreadList &rea
     // lldb_private::Process subclass, no memory threads will be in this list.
 
     Error err;
-    for (uint64_t i = 0; i < allglen; ++i)
+    if (m_goroutine_layout_ap)
     {
-        goroutines.push_back(CreateGoroutineAtIndex(i, err));
-        if (err.Fail())
+        addr_t allg_addr = m_allg_sp->GetValueAsUnsigned(LLDB_INVALID_ADDRESS);
+        if (allg_addr == LLDB_INVALID_ADDRESS || !ReadGoroutines(allg_addr, allglen, goroutines, err))
         {
             err.PutToLog(log, "OperatingSystemGo::UpdateThreadList");
             return new_thread_list.GetSize(false) > 0;
         }
     }
+    else
+    {
+        for (uint64_t i = 0; i < allglen; ++i)
+        {
+            goroutines.push_back(CreateGoroutineAtIndex(i, err));
+            if (err.Fail())
+            {
+                err.PutToLog(log, "OperatingSystemGo::UpdateThreadList");
+                return new_thread_list.GetSize(false) > 0;
+            }
+        }
+    }
     // Make a map so we can match goroutines with backing threads.
     std::map<uint64_t, ThreadSP> stack_map;
     for (uint32_t i = 0; i < real_thread_list.GetSize(false); ++i)
@@ -455,11 +559,35 @@ OperatingSystemGo::CreateThread(lldb::tid_t tid, addr_t context)
 {
     Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_OS));
 
-    if (log)
-        log->Printf("OperatingSystemGo::CreateThread (tid = 0x%" PRIx64 ", context = 0x%" PRIx64 ") not implemented",
-                    tid, context);
+    // The context is the address of the runtime.g of the goroutine.
+    if (!m_goroutine_layout_ap || context == LLDB_INVALID_ADDRESS)
+    {
+        if (log)
+            log->Printf("OperatingSystemGo::CreateThread (tid = 0x%" PRIx64 ", context = 0x%" PRIx64
+                        ") needs the address of a goroutine",
+                        tid, context);
+        return ThreadSP();
+    }
 
-    return ThreadSP();
+    DataBufferHeap g_data(m_goroutine_layout_ap->m_read_size, 0);
+    Error err;
+    if (m_process->ReadMemory(context, g_data.GetBytes(), g_data.GetByteSize(), err) != g_data.GetByteSize())
+    {
+        err.PutToLog(log, "OperatingSystemGo::CreateThread");
+        return ThreadSP();
+    }
+    DataExtractor data(g_data.GetBytes(), g_data.GetByteSize(), m_process->GetByteOrder(),
+                       m_process->GetAddressByteSize());
+    Goroutine goroutine = ParseGoroutine(data, 0, context);
+    if (tid != LLDB_INVALID_THREAD_ID && tid != goroutine.m_goid)
+    {
+        if (log)
+            log->Printf("OperatingSystemGo::CreateThread (tid = 0x%" PRIx64 ", context = 0x%" PRIx64
+                        ") found goroutine %" PRIu64,
+                        tid, context, goroutine.m_goid);
+        return ThreadSP();
+    }
+    return ThreadSP(new ThreadMemory(*m_process, goroutine.m_goid, nullptr, nullptr, goroutine.m_gobuf));
 }
 
 ValueObjectSP
@@ -568,3 +696,81 @@ OperatingSystemGo::CreateGoroutineAtIndex(uint64_t idx, Error &err)
     }
     return result;
 }
+
+OperatingSystemGo::Goroutine
+OperatingSystemGo::ParseGoroutine(const DataExtractor &data, lldb::offset_t g_offset, addr_t g_addr)
+{
+    const GoroutineLayout &layout = *m_goroutine_layout_ap;
+    Goroutine result = {};
+    lldb::offset_t offset = g_offset + layout.m_goid_offset;
+    result.m_goid = data.GetMaxU64(&offset, layout.m_goid_size);
+    offset = g_offset + layout.m_status_offset;
+    result.m_status = (uint32_t)data.GetMaxU64(&offset, layout.m_status_size);
+    offset = g_offset + layout.m_lostack_offset;
+    result.m_lostack = data.GetMaxU64(&offset, layout.m_stack_size);
+    offset = g_offset + layout.m_histack_offset;
+    result.m_histack = data.GetMaxU64(&offset, layout.m_stack_size);
+    result.m_gobuf = g_addr + layout.m_sched_offset;
+    return result;
+}
+
+bool
+OperatingSystemGo::ReadGoroutines(addr_t allg_addr, uint64_t allglen, std::vector<Goroutine> &goroutines, Error &err)
+{
+    const GoroutineLayout &layout = *m_goroutine_layout_ap;
+    const uint32_t addr_size = m_process->GetAddressByteSize();
+    const ByteOrder byte_order = m_process->GetByteOrder();
+
+    // Read the whole array of g pointers at once.
+    DataBufferHeap allg_data(allglen * addr_size, 0);
+    if (m_process->ReadMemory(allg_addr, allg_data.GetBytes(), allg_data.GetByteSize(), err) !=
+        allg_data.GetByteSize())
+    {
+        if (err.Success())
+            err.SetErrorString("unable to read runtime.allgs");
+        return false;
+    }
+    DataExtractor allg_extractor(allg_data.GetBytes(), allg_data.GetByteSize(), byte_order, addr_size);
+    std::vector<std::pair<addr_t, uint64_t>> g_addrs; // The g address and its index in allgs.
+    g_addrs.reserve(allglen);
+    lldb::offset_t offset = 0;
+    for (uint64_t i = 0; i < allglen; ++i)
+        g_addrs.push_back(std::make_pair(allg_extractor.GetPointer(&offset), i));
+    std::sort(g_addrs.begin(), g_addrs.end());
+
+    // Then read the g structs in runs of neighbouring goroutines, keeping the
+    // order of allgs in the result.
+    goroutines.assign(allglen, Goroutine());
+    DataBufferHeap run_data;
+    size_t run_start = 0;
+    while (run_start < g_addrs.size())
+    {
+        const addr_t run_addr = g_addrs[run_start].first;
+        size_t run_end = run_start + 1;
+        while (run_end < g_addrs.size())
+        {
+            const addr_t prev_end = g_addrs[run_end - 1].first + layout.m_read_size;
+            const addr_t next_addr = g_addrs[run_end].first;
+            if (next_addr > prev_end + g_max_goroutine_read_gap ||
+                next_addr + layout.m_read_size - run_addr > g_max_goroutine_read_size)
+                break;
+            ++run_end;
+        }
+        const uint64_t run_size = g_addrs[run_end - 1].first + layout.m_read_size - run_addr;
+        run_data.SetByteSize(run_size);
+        if (m_process->ReadMemory(run_addr, run_data.GetBytes(), run_size, err) != run_size)
+        {
+            if (err.Success())
+                err.SetErrorStringWithFormat("unable to read goroutine at 0x%" PRIx64, run_addr);
+            return false;
+        }
+        DataExtractor run_extractor(run_data.GetBytes(), run_size, byte_order, addr_size);
+        for (size_t i = run_start; i < run_end; ++i)
+        {
+            const addr_t g_addr = g_addrs[i].first;
+            goroutines[g_addrs[i].second] = ParseGoroutine(run_extractor, g_addr - run_addr, g_addr);
+        }
+        run_start = run_end;
+    }
+    return true;
+}
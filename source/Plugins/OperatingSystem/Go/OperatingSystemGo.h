@@ -13,6 +13,7 @@
 // C Includes
 // C++ Includes
 #include <memory>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -70,6 +71,7 @@ public:
 
 private:
     struct Goroutine;
+    struct GoroutineLayout;
 
     static lldb::ValueObjectSP FindGlobal(lldb::TargetSP target, const char *name);
 
@@ -79,7 +81,15 @@ private:
 
     Goroutine CreateGoroutineAtIndex(uint64_t idx, lldb_private::Error &err);
 
+    bool InitGoroutineLayout(lldb::TargetSP target_sp);
+
+    Goroutine ParseGoroutine(const lldb_private::DataExtractor &data, lldb::offset_t g_offset, lldb::addr_t g_addr);
+
+    bool ReadGoroutines(lldb::addr_t allg_addr, uint64_t allglen, std::vector<Goroutine> &goroutines,
+                        lldb_private::Error &err);
+
     std::unique_ptr<DynamicRegisterInfo> m_reginfo;
+    std::unique_ptr<GoroutineLayout> m_goroutine_layout_ap; // Null if runtime.g has to be read through ValueObjects
     lldb::ValueObjectSP m_allg_sp;
     lldb::ValueObjectSP m_allglen_sp;
 };
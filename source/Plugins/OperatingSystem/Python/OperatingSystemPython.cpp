@@ -85,7 +85,11 @@ OperatingSystemPython::OperatingSystemPython (lldb_private::Process *process, co
     m_thread_list_valobj_sp (),
     m_register_info_ap (),
     m_interpreter (NULL),
-    m_python_object_sp ()
+    m_python_object_sp (),
+    m_register_contexts (),
+    m_thread_info_tids (),
+    m_all_threads_register_data (),
+    m_fetched_all_threads_register_data (false)
 {
     if (!process)
         return;
@@ -201,6 +205,23 @@ OperatingSystemPython::UpdateThreadList (ThreadList &old_thread_list,
     // core_thread list. Any real threads/cores that weren't used should
     // later be put back into the "new_thread_list".
     std::vector<bool> core_used_map(num_cores, false);
+
+    // The register data from get_all_register_data() is for the threads of
+    // this get_thread_info() call, it is fetched when the first thread needs
+    // it.
+    m_thread_info_tids.clear();
+    m_all_threads_register_data.clear();
+    m_fetched_all_threads_register_data = false;
+
+    // Forget the register contexts of the threads that are gone.
+    for (RegisterContextMap::iterator pos = m_register_contexts.begin(); pos != m_register_contexts.end();)
+    {
+        if (pos->second.thread_wp.expired())
+            pos = m_register_contexts.erase(pos);
+        else
+            ++pos;
+    }
+
     if (threads_list)
     {
         if (log)
@@ -211,11 +232,15 @@ OperatingSystemPython::UpdateThreadList (ThreadList &old_thread_list,
         }
 
         const uint32_t num_threads = threads_list->GetSize();
+        m_thread_info_tids.resize(num_threads, LLDB_INVALID_THREAD_ID);
         for (uint32_t i = 0; i < num_threads; ++i)
         {
             StructuredData::ObjectSP thread_dict_obj = threads_list->GetItemAtIndex(i);
             if (auto thread_dict = thread_dict_obj->GetAsDictionary())
             {
+                tid_t tid = LLDB_INVALID_THREAD_ID;
+                if (thread_dict->GetValueForKeyAsInteger("tid", tid))
+                    m_thread_info_tids[i] = tid;
                 ThreadSP thread_sp(CreateThreadFromThreadInfo(*thread_dict, core_thread_list, old_thread_list, core_used_map, NULL));
                 if (thread_sp)
                     new_thread_list.AddThread(thread_sp);
@@ -310,6 +335,48 @@ OperatingSystemPython::ThreadWasSelected (Thread *thread)
 {
 }
 
+//------------------------------------------------------------------
+// Plug-ins can return the register data of all the threads from their
+// last get_thread_info() in one get_all_register_data() call, as a single
+// bytes object with the register data of each thread in turn. This is
+// much faster than a get_register_data() call for each thread when there
+// are many threads.
+//------------------------------------------------------------------
+DataBufferSP
+OperatingSystemPython::GetRegisterDataFromAllThreadsData (tid_t tid)
+{
+    if (!m_fetched_all_threads_register_data)
+    {
+        m_fetched_all_threads_register_data = true;
+
+        Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
+        DynamicRegisterInfo *register_info = GetDynamicRegisterInfo ();
+        StructuredData::StringSP all_reg_data = m_interpreter->OSPlugin_AllRegisterContextData(m_python_object_sp);
+        if (register_info && all_reg_data)
+        {
+            const size_t reg_data_size = register_info->GetRegisterDataByteSize();
+            const std::string &data = all_reg_data->GetValue();
+            if (reg_data_size > 0 && data.size() == reg_data_size * m_thread_info_tids.size())
+            {
+                for (size_t i = 0; i < m_thread_info_tids.size(); ++i)
+                {
+                    if (m_thread_info_tids[i] != LLDB_INVALID_THREAD_ID)
+                        m_all_threads_register_data[m_thread_info_tids[i]].reset(new DataBufferHeap(data.data() + i * reg_data_size, reg_data_size));
+                }
+            }
+            else if (log)
+                log->Printf ("OperatingSystemPython::GetRegisterDataFromAllThreadsData() ignoring %" PRIu64 " bytes of register data for %" PRIu64 " threads",
+                             (uint64_t)data.size(),
+                             (uint64_t)m_thread_info_tids.size());
+        }
+    }
+
+    RegisterDataMap::iterator pos = m_all_threads_register_data.find(tid);
+    if (pos != m_all_threads_register_data.end())
+        return pos->second;
+    return DataBufferSP();
+}
+
 RegisterContextSP
 OperatingSystemPython::CreateRegisterContextForThread (Thread *thread, addr_t reg_data_addr)
 {
@@ -317,17 +384,35 @@ OperatingSystemPython::CreateRegisterContextForThread (Thread *thread, addr_t re
     if (!m_interpreter || !m_python_object_sp || !thread)
         return reg_ctx_sp;
 
-    if (!IsOperatingSystemPluginThread(thread->shared_from_this()))
+    ThreadSP thread_sp (thread->shared_from_this());
+    if (!IsOperatingSystemPluginThread(thread_sp))
         return reg_ctx_sp;
-    
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
+
     // First thing we have to do is get the API lock, and the run lock.  We're going to change the thread
     // content of the process, and we're going to use python, which requires the API lock to do it.
     // So get & hold that.  This is a recursive lock so we can grant it to any Python code called on the stack below us.
     Target &target = m_process->GetTarget();
     std::lock_guard<std::recursive_mutex> guard(target.GetAPIMutex());
 
-    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD));
-
+    // A register context that reads the registers from memory can be used
+    // again as long as the registers stay at the same address, it only
+    // needs to read them again.
+    RegisterContextMap::iterator cached_pos = m_register_contexts.find(thread->GetID());
+    if (cached_pos != m_register_contexts.end())
+    {
+        if (reg_data_addr != LLDB_INVALID_ADDRESS &&
+            cached_pos->second.reg_data_addr == reg_data_addr &&
+            cached_pos->second.thread_wp.lock() == thread_sp)
+        {
+            reg_ctx_sp = cached_pos->second.reg_ctx_sp;
+            reg_ctx_sp->InvalidateAllRegisters();
+            return reg_ctx_sp;
+        }
+        m_register_contexts.erase(cached_pos);
+    }
+    
     auto lock = m_interpreter->AcquireInterpreterLock(); // to make sure python objects stays alive
     if (reg_data_addr != LLDB_INVALID_ADDRESS)
     {
@@ -339,21 +424,33 @@ OperatingSystemPython::CreateRegisterContextForThread (Thread *thread, addr_t re
                          thread->GetProtocolID(),
                          reg_data_addr);
         reg_ctx_sp.reset (new RegisterContextMemory (*thread, 0, *GetDynamicRegisterInfo (), reg_data_addr));
+
+        CachedRegisterContext &cached_reg_ctx = m_register_contexts[thread->GetID()];
+        cached_reg_ctx.thread_wp = thread_sp;
+        cached_reg_ctx.reg_data_addr = reg_data_addr;
+        cached_reg_ctx.reg_ctx_sp = reg_ctx_sp;
     }
     else
     {
         // No register data address is provided, query the python plug-in to let
         // it make up the data as it sees fit
-        if (log)
-            log->Printf ("OperatingSystemPython::CreateRegisterContextForThread (tid = 0x%" PRIx64 ", 0x%" PRIx64 ") fetching register data from python",
-                         thread->GetID(),
-                         thread->GetProtocolID());
+        DataBufferSP data_sp (GetRegisterDataFromAllThreadsData (thread->GetID()));
+        if (!data_sp)
+        {
+            if (log)
+                log->Printf ("OperatingSystemPython::CreateRegisterContextForThread (tid = 0x%" PRIx64 ", 0x%" PRIx64 ") fetching register data from python",
+                             thread->GetID(),
+                             thread->GetProtocolID());
 
-        StructuredData::StringSP reg_context_data = m_interpreter->OSPlugin_RegisterContextData(m_python_object_sp, thread->GetID());
-        if (reg_context_data)
+            StructuredData::StringSP reg_context_data = m_interpreter->OSPlugin_RegisterContextData(m_python_object_sp, thread->GetID());
+            if (reg_context_data)
+            {
+                std::string value = reg_context_data->GetValue();
+                data_sp.reset(new DataBufferHeap(value.c_str(), value.length()));
+            }
+        }
+        if (data_sp)
         {
-            std::string value = reg_context_data->GetValue();
-            DataBufferSP data_sp(new DataBufferHeap(value.c_str(), value.length()));
             if (data_sp->GetByteSize())
             {
                 RegisterContextMemory *reg_ctx_memory = new RegisterContextMemory (*thread, 0, *GetDynamicRegisterInfo (), LLDB_INVALID_ADDRESS);
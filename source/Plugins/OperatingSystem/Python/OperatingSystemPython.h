@@ -14,6 +14,9 @@
 
 // C Includes
 // C++ Includes
+#include <map>
+#include <vector>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/StructuredData.h"
@@ -98,10 +101,28 @@ protected:
     DynamicRegisterInfo *
     GetDynamicRegisterInfo ();
 
+    lldb::DataBufferSP
+    GetRegisterDataFromAllThreadsData (lldb::tid_t tid);
+
+    // A register context that is handed out again while its thread and
+    // the thread's register data address stay the same.
+    struct CachedRegisterContext
+    {
+        lldb::ThreadWP thread_wp;
+        lldb::addr_t reg_data_addr;
+        lldb::RegisterContextSP reg_ctx_sp;
+    };
+    typedef std::map<lldb::tid_t, CachedRegisterContext> RegisterContextMap;
+    typedef std::map<lldb::tid_t, lldb::DataBufferSP> RegisterDataMap;
+
     lldb::ValueObjectSP m_thread_list_valobj_sp;
     std::unique_ptr<DynamicRegisterInfo> m_register_info_ap;
     lldb_private::ScriptInterpreter *m_interpreter;
     lldb_private::StructuredData::ObjectSP m_python_object_sp;
+    RegisterContextMap m_register_contexts;
+    std::vector<lldb::tid_t> m_thread_info_tids; // The threads of the last get_thread_info() in order
+    RegisterDataMap m_all_threads_register_data;
+    bool m_fetched_all_threads_register_data;
 };
 
 #endif // LLDB_DISABLE_PYTHON
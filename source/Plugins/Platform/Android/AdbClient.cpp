@@ -45,8 +45,8 @@ const char * kRECV = "RECV";
 const char * kSTAT = "STAT";
 
 const size_t kSyncPacketLen = 8;
-// Maximum size of a filesync DATA packet.
-const size_t kMaxPushData = 2*1024;
+// Maximum size of a filesync DATA packet, adbd rejects anything larger.
+const size_t kMaxPushData = 64*1024;
 // Default mode for pushed files.
 const uint32_t kDefaultMode = 0100770; // S_IFREG | S_IRWXU | S_IRWXG
 
@@ -356,11 +356,11 @@ AdbClient::PushFile (const FileSpec &local_file, const FileSpec &remote_file)
     if (error.Fail ())
         return error;
 
-    char chunk[kMaxPushData];
-    while (!src.eof() && !src.read(chunk, kMaxPushData).bad())
+    std::vector<char> chunk (kMaxPushData);
+    while (!src.eof() && !src.read(&chunk[0], kMaxPushData).bad())
     {
         size_t chunk_size = src.gcount();
-        error = SendSyncRequest(kDATA, chunk_size, chunk);
+        error = SendSyncRequest(kDATA, chunk_size, &chunk[0]);
         if (error.Fail ())
             return Error ("Failed to send file chunk: %s", error.AsCString ());
     }
@@ -418,23 +418,27 @@ AdbClient::Sync ()
 Error
 AdbClient::PullFileChunk (std::vector<char> &buffer, bool &eof)
 {
-    buffer.clear ();
-
     std::string response_id;
     uint32_t data_len;
     auto error = ReadSyncHeader (response_id, data_len);
     if (error.Fail ())
+    {
+        buffer.clear ();
         return error;
+    }
 
     if (response_id == kDATA)
     {
-        buffer.resize (data_len, 0);
+        // The buffer is reused for every chunk of a file, resizing it only
+        // grows the allocation until it holds the largest chunk.
+        buffer.resize (data_len);
         error = ReadAllBytes (&buffer[0], data_len);
         if (error.Fail ())
             buffer.clear ();
     }
     else if (response_id == kDONE)
     {
+        buffer.clear ();
         eof = true;
     }
     else if (response_id == kFAIL)
@@ -454,19 +458,20 @@ AdbClient::PullFileChunk (std::vector<char> &buffer, bool &eof)
 Error
 AdbClient::SendSyncRequest (const char *request_id, const uint32_t data_len, const void *data)
 {
-    const DataBufferSP data_sp (new DataBufferHeap (kSyncPacketLen, 0));
+    // Send the header and the payload with a single write, writing them
+    // separately makes every DATA packet of a push wait for the ack of its
+    // header when Nagle's algorithm is on.
+    const size_t payload_len = data ? data_len : 0;
+    const DataBufferSP data_sp (new DataBufferHeap (kSyncPacketLen + payload_len, 0));
     DataEncoder encoder (data_sp, eByteOrderLittle, sizeof (void*));
     auto offset = encoder.PutData (0, request_id, strlen(request_id));
-    encoder.PutU32 (offset, data_len);
+    offset = encoder.PutU32 (offset, data_len);
+    if (payload_len > 0)
+        encoder.PutData (offset, data, payload_len);
 
     Error error;
     ConnectionStatus status;
-    m_conn.Write (data_sp->GetBytes (), kSyncPacketLen, status, &error);
-    if (error.Fail ())
-        return error;
-
-    if (data)
-        m_conn.Write (data, data_len, status, &error);
+    m_conn.Write (data_sp->GetBytes (), data_sp->GetByteSize (), status, &error);
     return error;
 }
 
@@ -428,6 +428,18 @@ PlatformPOSIX::GetFile(const lldb_private::FileSpec &source,      // remote file
                 return Error();
             // If we are here, rsync has failed - let's try the slow way before giving up
         }
+        // Don't fetch the file again if we have the same one already.
+        uint64_t src_low = 0, src_high = 0, dst_low = 0, dst_high = 0;
+        if (destination.Exists() &&
+            FileSystem::CalculateMD5(destination, dst_low, dst_high) &&
+            m_remote_platform_sp->CalculateMD5(source, src_low, src_high) &&
+            src_low == dst_low && src_high == dst_high)
+        {
+            if (log)
+                log->Printf("[GetFile] %s is up to date, skipping the transfer\n", destination.GetPath().c_str());
+            return Error();
+        }
+
         // open src and dst
         // read/write, read/write, read/write, ...
         // close src
@@ -461,7 +473,8 @@ PlatformPOSIX::GetFile(const lldb_private::FileSpec &source,      // remote file
 
         if (error.Success())
         {
-            lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024, 0));
+            // Big blocks let the remote side pipeline the transfer.
+            lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024 * 1024, 0));
             uint64_t offset = 0;
             error.Clear();
             while (error.Success())
@@ -375,6 +375,9 @@ PlatformRemoteGDBServer::ConnectRemote (Args& args)
                 if (m_gdb_client.HandshakeWithServer(&error))
                 {
                     m_gdb_client.GetHostInfo();
+                    // Let the server know what we support, this enables
+                    // compression of file transfers if the server allows it.
+                    m_gdb_client.GetRemoteQSupported();
                     // If a working directory was set prior to connecting, send it down now
                     if (m_working_dir)
                         m_gdb_client.SetWorkingDir(m_working_dir);
@@ -794,6 +797,14 @@ PlatformRemoteGDBServer::GetFileSize (const FileSpec& file_spec)
     return m_gdb_client.GetFileSize(file_spec);
 }
 
+bool
+PlatformRemoteGDBServer::CalculateMD5 (const FileSpec& file_spec,
+                                       uint64_t &low,
+                                       uint64_t &high)
+{
+    return m_gdb_client.CalculateMD5(file_spec, high, low);
+}
+
 uint64_t
 PlatformRemoteGDBServer::ReadFile (lldb::user_id_t fd,
                                    uint64_t offset,
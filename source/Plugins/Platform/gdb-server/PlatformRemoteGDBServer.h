@@ -188,6 +188,11 @@ public:
     lldb::user_id_t
     GetFileSize (const FileSpec& file_spec) override;
 
+    bool
+    CalculateMD5 (const FileSpec& file_spec,
+                  uint64_t &low,
+                  uint64_t &high) override;
+
     Error
     PutFile (const FileSpec& source,
              const FileSpec& destination,
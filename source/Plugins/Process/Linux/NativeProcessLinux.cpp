@@ -11,11 +11,13 @@
 
 // C Includes
 #include <errno.h>
+#include <limits.h>
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
 #include <fstream>
 #include <mutex>
 #include <sstream>
@@ -23,6 +25,10 @@
 #include <unordered_map>
 
 // Other libraries and framework includes
+#include "llvm/Support/ELF.h"
+
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/EmulateInstruction.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Module.h"
@@ -49,6 +55,7 @@
 // System includes - They have to be included after framework includes because they define some
 // macros which collide with variable names in other modules
 #include <linux/unistd.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 
 #include <sys/syscall.h>
@@ -110,6 +117,20 @@ static bool ProcessVmReadvSupported()
 
 namespace
 {
+    // The SIGCHLD handler shared by the processes being debugged.
+    struct SigchldMonitor
+    {
+        MainLoop::SignalHandleUP handle;
+        std::vector<NativeProcessLinux *> processes;
+    };
+
+    SigchldMonitor &
+    GetSigchldMonitor ()
+    {
+        static SigchldMonitor g_monitor;
+        return g_monitor;
+    }
+
     Error
     ResolveProcessArchitecture (lldb::pid_t pid, Platform &platform, ArchSpec &arch)
     {
@@ -213,6 +234,9 @@ namespace
 
     static constexpr unsigned k_ptrace_word_size = sizeof(void*);
     static_assert(sizeof(long) >= k_ptrace_word_size, "Size of long must be larger than ptrace word size");
+
+    // Maximum number of iovecs the kernel accepts in a single process_vm_readv call (UIO_MAXIOV)
+    static constexpr size_t k_max_iov_count = 1024;
 } // end of anonymous namespace
 
 // Simple helper function to ensure flags are enabled on the given file
@@ -424,11 +448,27 @@ NativeProcessProtocol::Attach (
 
 NativeProcessLinux::NativeProcessLinux () :
     NativeProcessProtocol (LLDB_INVALID_PROCESS_ID),
+    m_monitoring_sigchld (false),
+    m_mainloop (nullptr),
     m_arch (),
     m_supports_mem_region (eLazyBoolCalculate),
     m_mem_region_cache (),
-    m_pending_notification_tid(LLDB_INVALID_THREAD_ID)
+    m_pending_notification_tid(LLDB_INVALID_THREAD_ID),
+    m_threads_pending_stop (),
+    m_stop_request_time (),
+    m_seized (false),
+    m_shared_library_info_addr (LLDB_INVALID_ADDRESS),
+    m_checkpoints (),
+    m_next_checkpoint_id (1),
+    m_hardware_watchpoints_generation (0)
 {
+    memset(m_stop_latency_histogram, 0, sizeof(m_stop_latency_histogram));
+}
+
+NativeProcessLinux::~NativeProcessLinux ()
+{
+    StopMonitoringSigchld ();
+    KillCheckpoints ();
 }
 
 void
@@ -444,10 +484,9 @@ NativeProcessLinux::LaunchInferior (
     const ProcessLaunchInfo &launch_info,
     Error &error)
 {
-    m_sigchld_handle = mainloop.RegisterSignal(SIGCHLD,
-            [this] (MainLoopBase &) { SigchldHandler(); }, error);
-    if (! m_sigchld_handle)
+    if (!StartMonitoringSigchld (mainloop, error))
         return;
+    m_mainloop = &mainloop;
 
     if (module)
         m_arch = module->GetArchitecture ();
@@ -472,10 +511,9 @@ NativeProcessLinux::AttachToInferior (MainLoop &mainloop, lldb::pid_t pid, Error
     if (log)
         log->Printf ("NativeProcessLinux::%s (pid = %" PRIi64 ")", __FUNCTION__, pid);
 
-    m_sigchld_handle = mainloop.RegisterSignal(SIGCHLD,
-            [this] (MainLoopBase &) { SigchldHandler(); }, error);
-    if (! m_sigchld_handle)
+    if (!StartMonitoringSigchld (mainloop, error))
         return;
+    m_mainloop = &mainloop;
 
     // We can use the Host for everything except the ResolveExecutable portion.
     PlatformSP platform_sp = Platform::GetHostPlatform ();
@@ -797,6 +835,10 @@ NativeProcessLinux::Attach(lldb::pid_t pid, Error &error)
         return -1;
     }
 
+    // Prefer PTRACE_SEIZE, it lets us stop running threads with
+    // PTRACE_INTERRUPT later. Kernels older than 3.4 don't have it.
+    m_seized = true;
+
     while (Host::FindProcessThreads(pid, tids_to_attach))
     {
         for (Host::TidMap::iterator it = tids_to_attach.begin();
@@ -806,9 +848,23 @@ NativeProcessLinux::Attach(lldb::pid_t pid, Error &error)
             {
                 lldb::tid_t tid = it->first;
 
-                // Attach to the requested process.
-                // An attach will cause the thread to stop with a SIGSTOP.
-                error = PtraceWrapper(PTRACE_ATTACH, tid);
+                // Attach to the requested process. A seized thread keeps running
+                // until it is interrupted, an attach will cause the thread to stop
+                // with a SIGSTOP.
+                if (m_seized)
+                {
+                    error = PtraceWrapper(PTRACE_SEIZE, tid, nullptr, (void*)GetDefaultPtraceOpts());
+                    if (error.Fail() && error.GetError() == EIO && m_threads.empty())
+                    {
+                        if (log)
+                            log->Printf ("NativeProcessLinux::%s() PTRACE_SEIZE not supported, using PTRACE_ATTACH", __FUNCTION__);
+                        m_seized = false;
+                    }
+                    else if (error.Success())
+                        error = PtraceWrapper(PTRACE_INTERRUPT, tid);
+                }
+                if (!m_seized)
+                    error = PtraceWrapper(PTRACE_ATTACH, tid);
                 if (error.Fail())
                 {
                     // No such thread. The thread may have exited.
@@ -841,9 +897,12 @@ NativeProcessLinux::Attach(lldb::pid_t pid, Error &error)
                     }
                 }
 
-                error = SetDefaultPtraceOpts(tid);
-                if (error.Fail())
-                    return -1;
+                if (!m_seized)
+                {
+                    error = SetDefaultPtraceOpts(tid);
+                    if (error.Fail())
+                        return -1;
+                }
 
                 if (log)
                     log->Printf ("NativeProcessLinux::%s() adding tid = %" PRIu64, __FUNCTION__, tid);
@@ -881,8 +940,8 @@ NativeProcessLinux::Attach(lldb::pid_t pid, Error &error)
     return pid;
 }
 
-Error
-NativeProcessLinux::SetDefaultPtraceOpts(lldb::pid_t pid)
+long
+NativeProcessLinux::GetDefaultPtraceOpts()
 {
     long ptrace_opts = 0;
 
@@ -899,7 +958,13 @@ NativeProcessLinux::SetDefaultPtraceOpts(lldb::pid_t pid)
     // (needed to disable legacy SIGTRAP generation)
     ptrace_opts |= PTRACE_O_TRACEEXEC;
 
-    return PtraceWrapper(PTRACE_SETOPTIONS, pid, nullptr, (void*)ptrace_opts);
+    return ptrace_opts;
+}
+
+Error
+NativeProcessLinux::SetDefaultPtraceOpts(lldb::pid_t pid)
+{
+    return PtraceWrapper(PTRACE_SETOPTIONS, pid, nullptr, (void*)GetDefaultPtraceOpts());
 }
 
 static ExitType convert_pid_status_to_exit_type (int status)
@@ -1015,8 +1080,13 @@ NativeProcessLinux::MonitorCallback(lldb::pid_t pid,
         return;
     }
 
+    // A seized thread reports group stops as a PTRACE_EVENT_STOP of the stop
+    // signal, instead of failing PTRACE_GETSIGINFO.
+    const bool group_stop = info_err.Success() && info.si_signo != SIGTRAP &&
+                            (info.si_code >> 8) == PTRACE_EVENT_STOP;
+
     // Get details on the signal raised.
-    if (info_err.Success())
+    if (info_err.Success() && !group_stop)
     {
         // We have retrieved the signal info.  Dispatch appropriately.
         if (info.si_signo == SIGTRAP)
@@ -1026,7 +1096,7 @@ NativeProcessLinux::MonitorCallback(lldb::pid_t pid,
     }
     else
     {
-        if (info_err.GetError() == EINVAL)
+        if (group_stop || info_err.GetError() == EINVAL)
         {
             // This is a group stop reception for this tid.
             // We can reach here if we reinject SIGSTOP, SIGSTP, SIGTTIN or SIGTTOU into the
@@ -1122,7 +1192,9 @@ NativeProcessLinux::WaitForNewThread(::pid_t tid)
         return;
     }
 
-    if (((info.si_pid != 0) || (info.si_code != SI_USER)) && log)
+    // Threads created by a seized thread start with a PTRACE_EVENT_STOP.
+    const bool seized_start = info.si_code == (SIGTRAP | (PTRACE_EVENT_STOP << 8));
+    if (((info.si_pid != 0) || (info.si_code != SI_USER)) && !seized_start && log)
     {
         // We should be getting a thread creation signal here, but we received something
         // else. There isn't much we can do about it now, so we will just log that. Since the
@@ -1182,6 +1254,15 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
 
         // Exec clears any pending notifications.
         m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
+        m_threads_pending_stop.clear();
+
+        // The new executable has its own dynamic section.
+        m_shared_library_info_addr = LLDB_INVALID_ADDRESS;
+
+        // And none of the pages we protected.
+        m_software_watchpoints.clear();
+        m_watched_pages.clear();
+        m_threads_stepping_over_watched_page.clear();
 
         // Remove all but the main thread here.  Linux fork creates a new process which only copies the main thread.
         if (log)
@@ -1221,6 +1302,9 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
         // Tell coordinator about about the "new" (since exec) stopped main thread.
         ThreadWasCreated(*main_thread_sp);
 
+        // The process has new code now.
+        m_single_step_opcode_cache.clear ();
+
         // Let our delegate know we have just exec'd.
         NotifyDidExec ();
 
@@ -1233,6 +1317,14 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t &info, NativeThreadLinux &thr
         break;
     }
 
+    case (SIGTRAP | (PTRACE_EVENT_STOP << 8)):
+        // A seized thread stopped for a PTRACE_INTERRUPT we sent it.
+        if (log)
+            log->Printf ("NativeProcessLinux::%s() pid %" PRIu64 " tid %" PRIu64 ", thread interrupted",
+                         __FUNCTION__, GetID (), thread.GetID());
+        MonitorRequestedStop(thread, nullptr);
+        break;
+
     case (SIGTRAP | (PTRACE_EVENT_EXIT << 8)):
     {
         // The inferior process or one of its threads is about to exit.
@@ -1347,6 +1439,74 @@ NativeProcessLinux::MonitorTrace(NativeThreadLinux &thread)
         log->Printf("NativeProcessLinux::%s() received trace event, pid = %" PRIu64 " (single stepping)",
                 __FUNCTION__, thread.GetID());
 
+    // Finish stepping over a breakpoint whose condition was false.
+    auto condition_it = m_threads_stepping_over_condition.find(thread.GetID());
+    if (condition_it != m_threads_stepping_over_condition.end())
+    {
+        FinishSteppingOverCondition(thread.GetID(), condition_it->second);
+        m_threads_stepping_over_condition.erase(condition_it);
+
+        // Somebody asked for all threads to stop while we were stepping, so
+        // stay stopped for it without reporting a reason of our own.
+        if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        {
+            thread.SetStoppedWithNoReason();
+            SignalIfAllThreadsStopped();
+        }
+        else
+            ResumeThread(thread, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+        return;
+    }
+
+    // Finish stepping over an access to a page of a software watchpoint.
+    auto watched_page_it = m_threads_stepping_over_watched_page.find(thread.GetID());
+    if (watched_page_it != m_threads_stepping_over_watched_page.end())
+    {
+        const WatchedPageStep step = watched_page_it->second;
+        m_threads_stepping_over_watched_page.erase(watched_page_it);
+
+        const lldb::addr_t wp_addr = FinishSteppingOverWatchedPage(thread, step);
+        if (wp_addr != LLDB_INVALID_ADDRESS)
+        {
+            thread.SetStoppedBySoftwareWatchpoint(wp_addr);
+            StopRunningThreads(thread.GetID());
+            return;
+        }
+
+        // The access missed the watched ranges. A thread the client asked to
+        // step is done with its step, the others go on running.
+        if (!step.was_stepping)
+        {
+            if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+            {
+                thread.SetStoppedWithNoReason();
+                SignalIfAllThreadsStopped();
+            }
+            else
+                ResumeThread(thread, eStateRunning, LLDB_INVALID_SIGNAL_NUMBER);
+            return;
+        }
+    }
+
+    // Keep stepping while the thread is in the range it was asked to step
+    // through, instead of reporting every instruction to the client.
+    auto range_it = m_threads_range_stepping.find(thread.GetID());
+    if (range_it != m_threads_range_stepping.end())
+    {
+        const lldb::addr_t pc = thread.GetRegisterContext()->GetPC();
+        if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID &&
+            pc >= range_it->second.first && pc < range_it->second.second)
+        {
+            Error error = ResumeThread(thread, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+            if (error.Success())
+                return;
+            if (log)
+                log->Printf("NativeProcessLinux::%s() tid %" PRIu64 " failed to continue range stepping: %s",
+                        __FUNCTION__, thread.GetID(), error.AsCString());
+        }
+        m_threads_range_stepping.erase(range_it);
+    }
+
     // This thread is currently stopped.
     thread.SetStoppedByTrace();
 
@@ -1361,6 +1521,8 @@ NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread)
         log->Printf("NativeProcessLinux::%s() received breakpoint event, pid = %" PRIu64,
                 __FUNCTION__, thread.GetID());
 
+    const bool was_running = thread.GetState() == eStateRunning;
+
     // Mark the thread as stopped at breakpoint.
     thread.SetStoppedByBreakpoint();
     Error error = FixupBreakpointPCAsNeeded(thread);
@@ -1371,10 +1533,93 @@ NativeProcessLinux::MonitorBreakpoint(NativeThreadLinux &thread)
 
     if (m_threads_stepping_with_breakpoint.find(thread.GetID()) != m_threads_stepping_with_breakpoint.end())
         thread.SetStoppedByTrace();
+    else if (was_running && error.Success() && StepOverFalseCondition(thread))
+        return;
 
     StopRunningThreads(thread.GetID());
 }
 
+bool
+NativeProcessLinux::StepOverFalseCondition(NativeThreadLinux &thread)
+{
+    // Stepping over the breakpoint needs a hardware single step, otherwise we
+    // report the stop and let the client evaluate the condition.
+    if (!SupportHardwareSingleStepping())
+        return false;
+
+    // Don't resume anything while we are waiting for all threads to stop.
+    if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        return false;
+
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext();
+    if (!reg_ctx_sp)
+        return false;
+
+    const lldb::addr_t pc = reg_ctx_sp->GetPC();
+    NativeBreakpointSP breakpoint_sp;
+    if (m_breakpoint_list.GetBreakpoint(pc, breakpoint_sp).Fail() ||
+        !breakpoint_sp->IsSoftwareBreakpoint())
+        return false;
+
+    // Counting breakpoints never stop, they count the hits we don't report.
+    // Hits of threads the breakpoint isn't for are neither reported nor
+    // counted.
+    const bool is_for_thread = breakpoint_sp->IsForThread(thread.GetID());
+    if (is_for_thread && !breakpoint_sp->IsCounting() &&
+        (!breakpoint_sp->HasConditions() || breakpoint_sp->ShouldStop(thread)))
+        return false;
+
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " stepping over breakpoint at 0x%" PRIx64,
+                __FUNCTION__, thread.GetID(), pc);
+
+    // Other threads run through the breakpoint unnoticed for the duration of
+    // the single step.
+    Error error = breakpoint_sp->Disable();
+    if (error.Success())
+    {
+        m_threads_stepping_over_condition[thread.GetID()] = pc;
+        error = ResumeThread(thread, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+        if (error.Success())
+        {
+            if (is_for_thread && breakpoint_sp->IsCounting())
+                breakpoint_sp->IncrementHitCount();
+            return true;
+        }
+        m_threads_stepping_over_condition.erase(thread.GetID());
+        breakpoint_sp->Enable();
+    }
+
+    if (log)
+        log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " failed to step over breakpoint: %s",
+                __FUNCTION__, thread.GetID(), error.AsCString());
+    thread.SetStoppedByBreakpoint();
+    return false;
+}
+
+void
+NativeProcessLinux::FinishSteppingOverCondition(lldb::tid_t tid, lldb::addr_t addr)
+{
+    // The breakpoint may have been removed or may be in use by another thread
+    // that is stepping over it.
+    for (const auto &thread_info: m_threads_stepping_over_condition)
+    {
+        if (thread_info.first != tid && thread_info.second == addr)
+            return;
+    }
+
+    NativeBreakpointSP breakpoint_sp;
+    if (m_breakpoint_list.GetBreakpoint(addr, breakpoint_sp).Success())
+    {
+        Error error = breakpoint_sp->Enable();
+        Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+        if (error.Fail() && log)
+            log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " failed to re-enable breakpoint at 0x%" PRIx64 ": %s",
+                    __FUNCTION__, tid, addr, error.AsCString());
+    }
+}
+
 void
 NativeProcessLinux::MonitorWatchpoint(NativeThreadLinux &thread, uint32_t wp_index)
 {
@@ -1392,165 +1637,818 @@ NativeProcessLinux::MonitorWatchpoint(NativeThreadLinux &thread, uint32_t wp_ind
     StopRunningThreads(thread.GetID());
 }
 
-void
-NativeProcessLinux::MonitorSignal(const siginfo_t &info, NativeThreadLinux &thread, bool exited)
+namespace
 {
-    const int signo = info.si_signo;
-    const bool is_from_llgs = info.si_pid == getpid ();
+    lldb::addr_t
+    GetPageSize()
+    {
+        static const lldb::addr_t page_size = static_cast<lldb::addr_t>(::sysconf(_SC_PAGESIZE));
+        return page_size;
+    }
 
-    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    bool
+    RangesOverlap(lldb::addr_t addr1, size_t size1, lldb::addr_t addr2, size_t size2)
+    {
+        return addr1 < addr2 + size2 && addr2 < addr1 + size1;
+    }
+}
 
-    // POSIX says that process behaviour is undefined after it ignores a SIGFPE,
-    // SIGILL, SIGSEGV, or SIGBUS *unless* that signal was generated by a
-    // kill(2) or raise(3).  Similarly for tgkill(2) on Linux.
-    //
-    // IOW, user generated signals never generate what we consider to be a
-    // "crash".
-    //
-    // Similarly, ACK signals generated by this monitor.
+Error
+NativeProcessLinux::InferiorMprotect(NativeThreadLinux &thread, lldb::addr_t addr, size_t length, uint32_t permissions)
+{
+#if defined(__x86_64__)
+    const lldb::tid_t tid = thread.GetID();
 
-    // Handle the signal.
-    if (info.si_code == SI_TKILL || info.si_code == SI_USER)
+    int prot = PROT_NONE;
+    if (permissions & lldb::ePermissionsReadable)
+        prot |= PROT_READ;
+    if (permissions & lldb::ePermissionsWritable)
+        prot |= PROT_WRITE;
+    if (permissions & lldb::ePermissionsExecutable)
+        prot |= PROT_EXEC;
+
+    struct user_regs_struct saved_regs;
+    Error error = PtraceWrapper(PTRACE_GETREGS, tid, nullptr, &saved_regs, sizeof(saved_regs));
+    if (error.Fail())
+        return error;
+
+    // Put a system call instruction at the pc and step over it, the original
+    // code and registers are put back afterwards.
+    long saved_code = 0;
+    error = PtraceWrapper(PTRACE_PEEKTEXT, tid, reinterpret_cast<void *>(saved_regs.rip), nullptr, 0, &saved_code);
+    if (error.Fail())
+        return error;
+
+    struct user_regs_struct regs = saved_regs;
+    regs.orig_rax = -1; // Don't let the kernel restart an interrupted system call
+    long code = saved_code;
+    if (m_arch.GetMachine() == llvm::Triple::x86_64)
     {
-        if (log)
-            log->Printf ("NativeProcessLinux::%s() received signal %s (%d) with code %s, (siginfo pid = %d (%s), waitpid pid = %" PRIu64 ")",
-                            __FUNCTION__,
-                            Host::GetSignalAsCString(signo),
-                            signo,
-                            (info.si_code == SI_TKILL ? "SI_TKILL" : "SI_USER"),
-                            info.si_pid,
-                            is_from_llgs ? "from llgs" : "not from llgs",
-                            thread.GetID());
+        static const uint8_t syscall_opcode[] = { 0x0f, 0x05 }; // syscall
+        ::memcpy(&code, syscall_opcode, sizeof(syscall_opcode));
+        regs.rax = 10; // __NR_mprotect
+        regs.rdi = addr;
+        regs.rsi = length;
+        regs.rdx = prot;
     }
-
-    // Check for thread stop notification.
-    if (is_from_llgs && (info.si_code == SI_TKILL) && (signo == SIGSTOP))
+    else
     {
-        // This is a tgkill()-based stop.
-        if (log)
-            log->Printf ("NativeProcessLinux::%s() pid %" PRIu64 " tid %" PRIu64 ", thread stopped",
-                         __FUNCTION__,
-                         GetID (),
-                         thread.GetID());
+        static const uint8_t int80_opcode[] = { 0xcd, 0x80 }; // int $0x80
+        ::memcpy(&code, int80_opcode, sizeof(int80_opcode));
+        regs.rax = 125; // __NR_mprotect of i386
+        regs.rbx = addr;
+        regs.rcx = length;
+        regs.rdx = prot;
+    }
 
-        // Check that we're not already marked with a stop reason.
-        // Note this thread really shouldn't already be marked as stopped - if we were, that would imply that
-        // the kernel signaled us with the thread stopping which we handled and marked as stopped,
-        // and that, without an intervening resume, we received another stop.  It is more likely
-        // that we are missing the marking of a run state somewhere if we find that the thread was
-        // marked as stopped.
-        const StateType thread_state = thread.GetState();
-        if (!StateIsStoppedState (thread_state, false))
-        {
-            // An inferior thread has stopped because of a SIGSTOP we have sent it.
-            // Generally, these are not important stops and we don't want to report them as
-            // they are just used to stop other threads when one thread (the one with the
-            // *real* stop reason) hits a breakpoint (watchpoint, etc...). However, in the
-            // case of an asynchronous Interrupt(), this *is* the real stop reason, so we
-            // leave the signal intact if this is the thread that was chosen as the
-            // triggering thread.
-            if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
-            {
-                if (m_pending_notification_tid == thread.GetID())
-                    thread.SetStoppedBySignal(SIGSTOP, &info);
-                else
-                    thread.SetStoppedWithNoReason();
+    error = PtraceWrapper(PTRACE_POKETEXT, tid, reinterpret_cast<void *>(saved_regs.rip), reinterpret_cast<void *>(code));
+    if (error.Success())
+        error = PtraceWrapper(PTRACE_SETREGS, tid, nullptr, &regs, sizeof(regs));
 
-                SetCurrentThreadID (thread.GetID ());
-                SignalIfAllThreadsStopped();
-            }
-            else
-            {
-                // We can end up here if stop was initiated by LLGS but by this time a
-                // thread stop has occurred - maybe initiated by another event.
-                Error error = ResumeThread(thread, thread.GetState(), 0);
-                if (error.Fail() && log)
-                {
-                    log->Printf("NativeProcessLinux::%s failed to resume thread tid  %" PRIu64 ": %s",
-                            __FUNCTION__, thread.GetID(), error.AsCString());
-                }
-            }
-        }
-        else
+    // Signals that arrive before the step are sent again once the thread is
+    // back where it was.
+    std::vector<int> pending_signals;
+    while (error.Success())
+    {
+        error = PtraceWrapper(PTRACE_SINGLESTEP, tid);
+        if (error.Fail())
+            break;
+
+        int status = 0;
+        if (::waitpid(tid, &status, __WALL) != static_cast< ::pid_t>(tid))
         {
-            if (log)
-            {
-                // Retrieve the signal name if the thread was stopped by a signal.
-                int stop_signo = 0;
-                const bool stopped_by_signal = thread.IsStopped(&stop_signo);
-                const char *signal_name = stopped_by_signal ? Host::GetSignalAsCString(stop_signo) : "<not stopped by signal>";
-                if (!signal_name)
-                    signal_name = "<no-signal-name>";
-
-                log->Printf ("NativeProcessLinux::%s() pid %" PRIu64 " tid %" PRIu64 ", thread was already marked as a stopped state (state=%s, signal=%d (%s)), leaving stop signal as is",
-                             __FUNCTION__,
-                             GetID (),
-                             thread.GetID(),
-                             StateAsCString (thread_state),
-                             stop_signo,
-                             signal_name);
-            }
-            SignalIfAllThreadsStopped();
+            error.SetErrorToErrno();
+            break;
         }
-
-        // Done handling.
-        return;
+        if (!WIFSTOPPED(status))
+            return Error("thread %" PRIu64 " exited while calling mprotect", tid);
+        if (WSTOPSIG(status) == SIGTRAP)
+            break;
+        pending_signals.push_back(WSTOPSIG(status));
     }
 
-    if (log)
-        log->Printf ("NativeProcessLinux::%s() received signal %s", __FUNCTION__, Host::GetSignalAsCString(signo));
+    long result = 0;
+    if (error.Success())
+    {
+        error = PtraceWrapper(PTRACE_GETREGS, tid, nullptr, &regs, sizeof(regs));
+        result = static_cast<long>(regs.rax);
+    }
 
-    // This thread is stopped.
-    thread.SetStoppedBySignal(signo, &info);
+    PtraceWrapper(PTRACE_POKETEXT, tid, reinterpret_cast<void *>(saved_regs.rip), reinterpret_cast<void *>(saved_code));
+    PtraceWrapper(PTRACE_SETREGS, tid, nullptr, &saved_regs, sizeof(saved_regs));
+    for (int signo : pending_signals)
+        ::syscall(__NR_tgkill, static_cast< ::pid_t>(GetID()), static_cast< ::pid_t>(tid), signo);
 
-    // Send a stop to the debugger after we get all other threads to stop.
-    StopRunningThreads(thread.GetID());
+    if (error.Success() && result < 0 && result > -4096)
+        error.SetErrorStringWithFormat("mprotect(0x%" PRIx64 ", %zu) failed: %s", addr, length, ::strerror(-result));
+    return error;
+#else
+    return Error("calling mprotect in the inferior is not supported on this architecture");
+#endif
 }
 
-namespace {
-
-struct EmulatorBaton
+Error
+NativeProcessLinux::InferiorFork(lldb::pid_t pid, lldb::tid_t tid, lldb::pid_t &child_pid)
 {
-    NativeProcessLinux* m_process;
-    NativeRegisterContext* m_reg_context;
+    child_pid = LLDB_INVALID_PROCESS_ID;
+#if defined(__x86_64__)
+    struct user_regs_struct saved_regs;
+    Error error = PtraceWrapper(PTRACE_GETREGS, tid, nullptr, &saved_regs, sizeof(saved_regs));
+    if (error.Fail())
+        return error;
 
-    // eRegisterKindDWARF -> RegsiterValue
-    std::unordered_map<uint32_t, RegisterValue> m_register_values;
+    // Put a system call instruction at the pc and step over it like
+    // InferiorMprotect() does.
+    long saved_code = 0;
+    error = PtraceWrapper(PTRACE_PEEKTEXT, tid, reinterpret_cast<void *>(saved_regs.rip), nullptr, 0, &saved_code);
+    if (error.Fail())
+        return error;
 
-    EmulatorBaton(NativeProcessLinux* process, NativeRegisterContext* reg_context) :
-            m_process(process), m_reg_context(reg_context) {}
-};
+    struct user_regs_struct regs = saved_regs;
+    regs.orig_rax = -1; // Don't let the kernel restart an interrupted system call
+    long code = saved_code;
+    if (m_arch.GetMachine() == llvm::Triple::x86_64)
+    {
+        static const uint8_t syscall_opcode[] = { 0x0f, 0x05 }; // syscall
+        ::memcpy(&code, syscall_opcode, sizeof(syscall_opcode));
+        regs.rax = 57; // __NR_fork
+    }
+    else
+    {
+        static const uint8_t int80_opcode[] = { 0xcd, 0x80 }; // int $0x80
+        ::memcpy(&code, int80_opcode, sizeof(int80_opcode));
+        regs.rax = 2; // __NR_fork of i386
+    }
 
-} // anonymous namespace
+    // Trace the child, so it stops before it runs.
+    error = PtraceWrapper(PTRACE_SETOPTIONS, tid, nullptr, reinterpret_cast<void *>(GetDefaultPtraceOpts() | PTRACE_O_TRACEFORK));
+    if (error.Success())
+        error = PtraceWrapper(PTRACE_POKETEXT, tid, reinterpret_cast<void *>(saved_regs.rip), reinterpret_cast<void *>(code));
+    if (error.Success())
+        error = PtraceWrapper(PTRACE_SETREGS, tid, nullptr, &regs, sizeof(regs));
 
-static size_t
-ReadMemoryCallback (EmulateInstruction *instruction,
-                    void *baton,
-                    const EmulateInstruction::Context &context, 
-                    lldb::addr_t addr, 
-                    void *dst,
-                    size_t length)
-{
-    EmulatorBaton* emulator_baton = static_cast<EmulatorBaton*>(baton);
+    std::vector<int> pending_signals;
+    while (error.Success())
+    {
+        error = PtraceWrapper(PTRACE_SINGLESTEP, tid);
+        if (error.Fail())
+            break;
 
-    size_t bytes_read;
-    emulator_baton->m_process->ReadMemory(addr, dst, length, bytes_read);
-    return bytes_read;
-}
+        int status = 0;
+        if (::waitpid(tid, &status, __WALL) != static_cast< ::pid_t>(tid))
+        {
+            error.SetErrorToErrno();
+            break;
+        }
+        if (!WIFSTOPPED(status))
+            return Error("thread %" PRIu64 " exited while calling fork", tid);
+        if (WSTOPSIG(status) != SIGTRAP)
+        {
+            pending_signals.push_back(WSTOPSIG(status));
+            continue;
+        }
+        if ((status >> 16) != PTRACE_EVENT_FORK)
+            break;
 
-static bool
-ReadRegisterCallback (EmulateInstruction *instruction,
-                      void *baton,
-                      const RegisterInfo *reg_info,
-                      RegisterValue &reg_value)
-{
-    EmulatorBaton* emulator_baton = static_cast<EmulatorBaton*>(baton);
+        // The fork event comes before the system call returns, step on to
+        // the end of it.
+        unsigned long message = 0;
+        error = GetEventMessage(tid, &message);
+        child_pid = message;
+    }
 
-    auto it = emulator_baton->m_register_values.find(reg_info->kinds[eRegisterKindDWARF]);
-    if (it != emulator_baton->m_register_values.end())
+    long result = 0;
+    if (error.Success())
     {
-        reg_value = it->second;
-        return true;
+        error = PtraceWrapper(PTRACE_GETREGS, tid, nullptr, &regs, sizeof(regs));
+        result = static_cast<long>(regs.rax);
+    }
+
+    PtraceWrapper(PTRACE_POKETEXT, tid, reinterpret_cast<void *>(saved_regs.rip), reinterpret_cast<void *>(saved_code));
+    PtraceWrapper(PTRACE_SETREGS, tid, nullptr, &saved_regs, sizeof(saved_regs));
+    SetDefaultPtraceOpts(tid);
+    for (int signo : pending_signals)
+        ::syscall(__NR_tgkill, static_cast< ::pid_t>(pid), static_cast< ::pid_t>(tid), signo);
+
+    if (error.Success() && result < 0 && result > -4096)
+        error.SetErrorStringWithFormat("fork failed: %s", ::strerror(-result));
+    if (error.Success() && child_pid == LLDB_INVALID_PROCESS_ID)
+        error.SetErrorString("fork didn't report the child");
+    if (child_pid == LLDB_INVALID_PROCESS_ID)
+        return error;
+
+    // The child starts with a stop, it is a copy of the thread in the
+    // system call with the system call instruction in its code.
+    int status = 0;
+    ::pid_t wait_pid;
+    do
+        wait_pid = ::waitpid(child_pid, &status, __WALL);
+    while (wait_pid == -1 && errno == EINTR);
+
+    if (wait_pid != static_cast< ::pid_t>(child_pid) || !WIFSTOPPED(status))
+    {
+        child_pid = LLDB_INVALID_PROCESS_ID;
+        return Error("the child of fork didn't stop");
+    }
+
+    Error child_error = PtraceWrapper(PTRACE_POKETEXT, child_pid, reinterpret_cast<void *>(saved_regs.rip), reinterpret_cast<void *>(saved_code));
+    if (child_error.Success())
+        child_error = PtraceWrapper(PTRACE_SETREGS, child_pid, nullptr, &saved_regs, sizeof(saved_regs));
+    if (child_error.Success())
+        child_error = SetDefaultPtraceOpts(child_pid);
+    if (error.Success() && child_error.Fail())
+        error = child_error;
+    if (error.Fail())
+    {
+        ::kill(child_pid, SIGKILL);
+        ::waitpid(child_pid, &status, __WALL);
+        child_pid = LLDB_INVALID_PROCESS_ID;
+    }
+    return error;
+#else
+    return Error("calling fork in the inferior is not supported on this architecture");
+#endif
+}
+
+std::vector<lldb::addr_t>
+NativeProcessLinux::DisableSoftwareBreakpoints()
+{
+    std::vector<lldb::addr_t> addrs;
+    m_breakpoint_list.ForEach([&addrs] (const NativeBreakpointSP &breakpoint_sp)
+    {
+        if (breakpoint_sp->IsSoftwareBreakpoint() && breakpoint_sp->IsEnabled() && breakpoint_sp->Disable().Success())
+            addrs.push_back(breakpoint_sp->GetAddress());
+    });
+    return addrs;
+}
+
+void
+NativeProcessLinux::EnableSoftwareBreakpoints(const std::vector<lldb::addr_t> &addrs)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    for (lldb::addr_t addr : addrs)
+    {
+        Error error = m_breakpoint_list.EnableBreakpoint(addr);
+        if (error.Fail() && log)
+            log->Printf("NativeProcessLinux::%s failed to enable the breakpoint at 0x%" PRIx64 ": %s",
+                        __FUNCTION__, addr, error.AsCString());
+    }
+}
+
+void
+NativeProcessLinux::KillCheckpoints()
+{
+    for (const auto &checkpoint : m_checkpoints)
+    {
+        int status = 0;
+        ::kill(checkpoint.second, SIGKILL);
+        while (::waitpid(checkpoint.second, &status, __WALL) == -1 && errno == EINTR)
+            ;
+    }
+    m_checkpoints.clear();
+}
+
+Error
+NativeProcessLinux::UpdateWatchedPage(NativeThreadLinux &thread, lldb::addr_t page)
+{
+    auto page_it = m_watched_pages.find(page);
+    if (page_it == m_watched_pages.end())
+        return Error();
+
+    // Reads only fault without any access, writes fault without write access.
+    // The watch_flags are 0x1 for writes and 0x2 for reads, as in Z packets.
+    const lldb::addr_t page_size = GetPageSize();
+    uint32_t permissions = page_it->second;
+    bool watched = false;
+    for (const auto &wp : m_software_watchpoints)
+    {
+        if (!RangesOverlap(wp.second.addr, wp.second.size, page, page_size))
+            continue;
+        watched = true;
+        if (wp.second.watch_flags & 0x2)
+            permissions = 0;
+        else
+            permissions &= ~lldb::ePermissionsWritable;
+    }
+
+    if (!watched)
+    {
+        permissions = page_it->second;
+        m_watched_pages.erase(page_it);
+    }
+    return InferiorMprotect(thread, page, page_size, permissions);
+}
+
+NativeThreadLinuxSP
+NativeProcessLinux::GetStoppedThread()
+{
+    NativeThreadLinuxSP thread_sp = GetThreadByID(GetCurrentThreadID());
+    if (thread_sp && StateIsStoppedState(thread_sp->GetState(), false))
+        return thread_sp;
+
+    for (const auto &thread : m_threads)
+    {
+        if (StateIsStoppedState(thread->GetState(), false))
+            return std::static_pointer_cast<NativeThreadLinux>(thread);
+    }
+    return NativeThreadLinuxSP();
+}
+
+Error
+NativeProcessLinux::SetWatchpoint(lldb::addr_t addr, size_t size, uint32_t watch_flags, bool hardware)
+{
+    Error error;
+    if (hardware)
+    {
+        std::vector<NativeWatchpoint> watchpoints = GetHardwareWatchpoints(addr);
+        watchpoints.push_back({addr, size, watch_flags, true});
+        error = SetHardwareWatchpoints(watchpoints);
+        if (error.Success())
+            return m_watchpoint_list.Add(addr, size, watch_flags, true);
+    }
+    else
+        error.SetErrorString("not implemented");
+
+    // The debug registers are used up, or can't watch a range this size.
+    Error software_error = SetSoftwareWatchpoint(addr, size, watch_flags);
+    if (software_error.Success())
+        return software_error;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s() no software watchpoint at 0x%" PRIx64 " either: %s",
+                __FUNCTION__, addr, software_error.AsCString());
+    return error;
+}
+
+Error
+NativeProcessLinux::RemoveWatchpoint(lldb::addr_t addr)
+{
+    if (m_software_watchpoints.count(addr))
+        return RemoveSoftwareWatchpoint(addr);
+    if (m_watchpoint_list.GetWatchpointMap().count(addr) == 0)
+        return Error();
+
+    Error error = SetHardwareWatchpoints(GetHardwareWatchpoints(addr));
+    if (error.Fail())
+        return error;
+    return m_watchpoint_list.Remove(addr);
+}
+
+std::vector<NativeWatchpoint>
+NativeProcessLinux::GetHardwareWatchpoints(lldb::addr_t except_addr) const
+{
+    std::vector<NativeWatchpoint> watchpoints;
+    for (const auto &pair : m_watchpoint_list.GetWatchpointMap())
+    {
+        if (pair.second.m_hardware && pair.first != except_addr)
+            watchpoints.push_back(pair.second);
+    }
+    return watchpoints;
+}
+
+Error
+NativeProcessLinux::SetHardwareWatchpoints(const std::vector<NativeWatchpoint> &watchpoints)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+
+    // The threads that are stopped get the watchpoints now, writing only the
+    // debug registers that change. The others get them when they resume, we
+    // can't write their registers while they run. All ptrace requests have
+    // to come from this thread, so the stopped threads are done one after
+    // the other.
+    std::lock_guard<std::recursive_mutex> guard(m_threads_mutex);
+    const uint32_t generation = m_hardware_watchpoints_generation + 1;
+    Error error;
+    for (const auto &thread_sp : m_threads)
+    {
+        NativeThreadLinux &thread = static_cast<NativeThreadLinux &>(*thread_sp);
+        if (!StateIsStoppedState(thread.GetState(), false))
+            continue;
+        error = thread.SetHardwareWatchpoints(watchpoints, generation);
+        if (error.Fail())
+        {
+            if (log)
+                log->Printf("NativeProcessLinux::%s() tid %" PRIu64 " failed to set %" PRIu64 " hardware watchpoints: %s",
+                        __FUNCTION__, thread.GetID(), (uint64_t)watchpoints.size(), error.AsCString());
+            break;
+        }
+    }
+
+    if (error.Fail())
+    {
+        // Give the threads we already changed the old watchpoints back.
+        const std::vector<NativeWatchpoint> old_watchpoints = GetHardwareWatchpoints();
+        for (const auto &thread_sp : m_threads)
+        {
+            NativeThreadLinux &thread = static_cast<NativeThreadLinux &>(*thread_sp);
+            if (thread.m_hardware_watchpoints_generation == generation)
+                thread.SetHardwareWatchpoints(old_watchpoints, m_hardware_watchpoints_generation);
+        }
+        return error;
+    }
+
+    m_hardware_watchpoints_generation = generation;
+    return error;
+}
+
+Error
+NativeProcessLinux::SetSoftwareWatchpoint(lldb::addr_t addr, size_t size, uint32_t watch_flags)
+{
+    if (size == 0)
+        return Error("can't watch an empty range");
+
+    // Stepping over the faulting access needs a hardware single step.
+    if (!SupportHardwareSingleStepping())
+        return Error("software watchpoints need hardware single stepping");
+
+    NativeThreadLinuxSP thread_sp = GetStoppedThread();
+    if (!thread_sp)
+        return Error("software watchpoints can only be set while a thread is stopped");
+
+    if (m_software_watchpoints.count(addr))
+        RemoveSoftwareWatchpoint(addr);
+
+    // Remember the protection of the pages before we change it.
+    const lldb::addr_t page_size = GetPageSize();
+    const lldb::addr_t first_page = addr & ~(page_size - 1);
+    std::vector<lldb::addr_t> pages;
+    std::map<lldb::addr_t, uint32_t> new_pages;
+    for (lldb::addr_t page = first_page; page < addr + size; page += page_size)
+    {
+        pages.push_back(page);
+        if (m_watched_pages.count(page))
+            continue;
+
+        MemoryRegionInfo region_info;
+        Error error = GetMemoryRegionInfo(page, region_info);
+        if (error.Fail())
+            return error;
+
+        uint32_t permissions = 0;
+        if (region_info.GetReadable() == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsReadable;
+        if (region_info.GetWritable() == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsWritable;
+        if (region_info.GetExecutable() == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsExecutable;
+        if (permissions == 0)
+            return Error("0x%" PRIx64 " is not accessible", page);
+        new_pages[page] = permissions;
+    }
+    m_watched_pages.insert(new_pages.begin(), new_pages.end());
+
+    SoftwareWatchpoint wp = { addr, size, watch_flags };
+    m_software_watchpoints[addr] = wp;
+    for (lldb::addr_t page : pages)
+    {
+        Error error = UpdateWatchedPage(*thread_sp, page);
+        if (error.Fail())
+        {
+            RemoveSoftwareWatchpoint(addr);
+            return error;
+        }
+    }
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s() watching 0x%" PRIx64 "-0x%" PRIx64 " with %zu protected pages",
+                __FUNCTION__, addr, addr + size, m_watched_pages.size());
+    return Error();
+}
+
+Error
+NativeProcessLinux::RemoveSoftwareWatchpoint(lldb::addr_t addr)
+{
+    auto wp_it = m_software_watchpoints.find(addr);
+    if (wp_it == m_software_watchpoints.end())
+        return Error();
+    NativeThreadLinuxSP thread_sp = GetStoppedThread();
+    if (!thread_sp)
+        return Error("software watchpoints can only be removed while a thread is stopped");
+
+    const SoftwareWatchpoint wp = wp_it->second;
+    m_software_watchpoints.erase(wp_it);
+
+    // The pages keep the protection the other watchpoints on them need.
+    Error error;
+    const lldb::addr_t page_size = GetPageSize();
+    for (lldb::addr_t page = wp.addr & ~(page_size - 1); page < wp.addr + wp.size; page += page_size)
+    {
+        Error page_error = UpdateWatchedPage(*thread_sp, page);
+        if (page_error.Fail() && error.Success())
+            error = page_error;
+    }
+    return error;
+}
+
+bool
+NativeProcessLinux::MonitorWatchedPageFault(NativeThreadLinux &thread, const siginfo_t &info)
+{
+    const lldb::addr_t fault_addr = reinterpret_cast<lldb::addr_t>(info.si_addr);
+    const lldb::addr_t page_size = GetPageSize();
+    const lldb::addr_t page = fault_addr & ~(page_size - 1);
+    auto page_it = m_watched_pages.find(page);
+    if (page_it == m_watched_pages.end())
+        return false;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " accessed watched page at 0x%" PRIx64,
+                __FUNCTION__, thread.GetID(), fault_addr);
+
+    // Somebody asked for all threads to stop. Stay stopped without a reason,
+    // the access faults again when the thread is resumed.
+    if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+    {
+        thread.SetStoppedWithNoReason();
+        SignalIfAllThreadsStopped();
+        return true;
+    }
+
+    WatchedPageStep step;
+    step.page = page;
+    step.fault_addr = fault_addr;
+    step.was_stepping = thread.GetState() == eStateStepping;
+
+    // Writes are told apart from reads by whether the watched bytes change.
+    for (const auto &wp : m_software_watchpoints)
+    {
+        if (!(wp.second.watch_flags & 0x1) || !RangesOverlap(wp.second.addr, wp.second.size, page, page_size))
+            continue;
+        std::vector<uint8_t> &contents = step.old_contents[wp.first];
+        contents.resize(wp.second.size);
+        size_t bytes_read = 0;
+        ReadMemory(wp.second.addr, contents.data(), contents.size(), bytes_read);
+        contents.resize(bytes_read);
+    }
+
+    // Other threads run through the page unnoticed for the duration of the
+    // single step.
+    Error error = InferiorMprotect(thread, page, page_size, page_it->second);
+    if (error.Success())
+    {
+        m_threads_stepping_over_watched_page[thread.GetID()] = step;
+        error = ResumeThread(thread, eStateStepping, LLDB_INVALID_SIGNAL_NUMBER);
+        if (error.Success())
+            return true;
+        m_threads_stepping_over_watched_page.erase(thread.GetID());
+        UpdateWatchedPage(thread, page);
+    }
+
+    if (log)
+        log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " failed to step over the access: %s",
+                __FUNCTION__, thread.GetID(), error.AsCString());
+    return false;
+}
+
+lldb::addr_t
+NativeProcessLinux::FinishSteppingOverWatchedPage(NativeThreadLinux &thread, const WatchedPageStep &step)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    Error error = UpdateWatchedPage(thread, step.page);
+    if (error.Fail() && log)
+        log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " failed to protect 0x%" PRIx64 " again: %s",
+                __FUNCTION__, thread.GetID(), step.page, error.AsCString());
+
+    // A page without read watchpoints only faults on writes.
+    bool page_faults_on_reads = false;
+    for (const auto &wp : m_software_watchpoints)
+    {
+        if ((wp.second.watch_flags & 0x2) && RangesOverlap(wp.second.addr, wp.second.size, step.page, GetPageSize()))
+            page_faults_on_reads = true;
+    }
+
+    for (const auto &wp : m_software_watchpoints)
+    {
+        const SoftwareWatchpoint &watchpoint = wp.second;
+        auto contents_it = step.old_contents.find(watchpoint.addr);
+        if (contents_it != step.old_contents.end() && !contents_it->second.empty())
+        {
+            std::vector<uint8_t> contents(contents_it->second.size());
+            size_t bytes_read = 0;
+            ReadMemory(watchpoint.addr, contents.data(), contents.size(), bytes_read);
+            if (bytes_read == contents.size() && contents != contents_it->second)
+                return watchpoint.addr;
+        }
+
+        if (step.fault_addr < watchpoint.addr || step.fault_addr >= watchpoint.addr + watchpoint.size)
+            continue;
+        if (watchpoint.watch_flags & 0x2)
+            return watchpoint.addr;
+        // A write of the value that was already there.
+        if ((watchpoint.watch_flags & 0x1) && !page_faults_on_reads)
+            return watchpoint.addr;
+    }
+    return LLDB_INVALID_ADDRESS;
+}
+
+void
+NativeProcessLinux::MonitorRequestedStop(NativeThreadLinux &thread, const siginfo_t *info)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // Check that we're not already marked with a stop reason.
+    // Note this thread really shouldn't already be marked as stopped - if we were, that would imply that
+    // the kernel signaled us with the thread stopping which we handled and marked as stopped,
+    // and that, without an intervening resume, we received another stop.  It is more likely
+    // that we are missing the marking of a run state somewhere if we find that the thread was
+    // marked as stopped.
+    const StateType thread_state = thread.GetState();
+    if (!StateIsStoppedState (thread_state, false))
+    {
+        // An inferior thread has stopped because of a SIGSTOP or PTRACE_INTERRUPT we have sent it.
+        // Generally, these are not important stops and we don't want to report them as
+        // they are just used to stop other threads when one thread (the one with the
+        // *real* stop reason) hits a breakpoint (watchpoint, etc...). However, in the
+        // case of an asynchronous Interrupt(), this *is* the real stop reason, so we
+        // leave the signal intact if this is the thread that was chosen as the
+        // triggering thread.
+        if (m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+        {
+            if (m_pending_notification_tid == thread.GetID())
+                thread.SetStoppedBySignal(SIGSTOP, info);
+            else
+                thread.SetStoppedWithNoReason();
+
+            SetCurrentThreadID (thread.GetID ());
+            SignalIfAllThreadsStopped();
+        }
+        else
+        {
+            // We can end up here if stop was initiated by LLGS but by this time a
+            // thread stop has occurred - maybe initiated by another event.
+            Error error = ResumeThread(thread, thread.GetState(), 0);
+            if (error.Fail() && log)
+            {
+                log->Printf("NativeProcessLinux::%s failed to resume thread tid  %" PRIu64 ": %s",
+                        __FUNCTION__, thread.GetID(), error.AsCString());
+            }
+        }
+    }
+    else
+    {
+        if (log)
+        {
+            // Retrieve the signal name if the thread was stopped by a signal.
+            int stop_signo = 0;
+            const bool stopped_by_signal = thread.IsStopped(&stop_signo);
+            const char *signal_name = stopped_by_signal ? Host::GetSignalAsCString(stop_signo) : "<not stopped by signal>";
+            if (!signal_name)
+                signal_name = "<no-signal-name>";
+
+            log->Printf ("NativeProcessLinux::%s() pid %" PRIu64 " tid %" PRIu64 ", thread was already marked as a stopped state (state=%s, signal=%d (%s)), leaving stop signal as is",
+                         __FUNCTION__,
+                         GetID (),
+                         thread.GetID(),
+                         StateAsCString (thread_state),
+                         stop_signo,
+                         signal_name);
+        }
+        SignalIfAllThreadsStopped();
+    }
+}
+
+void
+NativeProcessLinux::MonitorSignal(const siginfo_t &info, NativeThreadLinux &thread, bool exited)
+{
+    const int signo = info.si_signo;
+    const bool is_from_llgs = info.si_pid == getpid ();
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // POSIX says that process behaviour is undefined after it ignores a SIGFPE,
+    // SIGILL, SIGSEGV, or SIGBUS *unless* that signal was generated by a
+    // kill(2) or raise(3).  Similarly for tgkill(2) on Linux.
+    //
+    // IOW, user generated signals never generate what we consider to be a
+    // "crash".
+    //
+    // Similarly, ACK signals generated by this monitor.
+
+    // Handle the signal.
+    if (info.si_code == SI_TKILL || info.si_code == SI_USER)
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s() received signal %s (%d) with code %s, (siginfo pid = %d (%s), waitpid pid = %" PRIu64 ")",
+                            __FUNCTION__,
+                            Host::GetSignalAsCString(signo),
+                            signo,
+                            (info.si_code == SI_TKILL ? "SI_TKILL" : "SI_USER"),
+                            info.si_pid,
+                            is_from_llgs ? "from llgs" : "not from llgs",
+                            thread.GetID());
+    }
+
+    // Check for thread stop notification.
+    if (is_from_llgs && (info.si_code == SI_TKILL) && (signo == SIGSTOP))
+    {
+        // This is a tgkill()-based stop.
+        if (log)
+            log->Printf ("NativeProcessLinux::%s() pid %" PRIu64 " tid %" PRIu64 ", thread stopped",
+                         __FUNCTION__,
+                         GetID (),
+                         thread.GetID());
+
+        MonitorRequestedStop(thread, &info);
+
+        // Done handling.
+        return;
+    }
+
+    // An access to a page we protected for a software watchpoint.
+    if (signo == SIGSEGV && info.si_code == SEGV_ACCERR && MonitorWatchedPageFault(thread, info))
+        return;
+
+    // The debugger asked for this signal to be passed to the process without
+    // a stop. Don't do it while the other threads are being stopped, the
+    // stop notification is waiting for this thread too.
+    if (m_signals_to_ignore.find(signo) != m_signals_to_ignore.end() &&
+        m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s() passing signal %s to tid %" PRIu64,
+                         __FUNCTION__, Host::GetSignalAsCString(signo), thread.GetID());
+        ResumeThread(thread, thread.GetState(), signo);
+        return;
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s() received signal %s", __FUNCTION__, Host::GetSignalAsCString(signo));
+
+    // This thread is stopped.
+    thread.SetStoppedBySignal(signo, &info);
+
+    // Send a stop to the debugger after we get all other threads to stop.
+    StopRunningThreads(thread.GetID());
+}
+
+namespace {
+
+struct EmulatorBaton
+{
+    NativeProcessLinux* m_process;
+    NativeRegisterContext* m_reg_context;
+
+    // eRegisterKindDWARF -> RegsiterValue
+    std::unordered_map<uint32_t, RegisterValue> m_register_values;
+
+    // The instruction bytes read by earlier steps, by address
+    std::map<lldb::addr_t, std::vector<uint8_t>> *m_opcode_cache;
+
+    EmulatorBaton(NativeProcessLinux* process, NativeRegisterContext* reg_context,
+                  std::map<lldb::addr_t, std::vector<uint8_t>> *opcode_cache) :
+            m_process(process), m_reg_context(reg_context), m_opcode_cache(opcode_cache) {}
+};
+
+} // anonymous namespace
+
+static size_t
+ReadMemoryCallback (EmulateInstruction *instruction,
+                    void *baton,
+                    const EmulateInstruction::Context &context, 
+                    lldb::addr_t addr, 
+                    void *dst,
+                    size_t length)
+{
+    EmulatorBaton* emulator_baton = static_cast<EmulatorBaton*>(baton);
+
+    // Only the instructions are cached, the data an instruction reads (e.g.
+    // the return address it pops) changes from one step to the next.
+    const bool is_opcode = context.type == EmulateInstruction::eContextReadOpcode && emulator_baton->m_opcode_cache;
+    if (is_opcode)
+    {
+        auto pos = emulator_baton->m_opcode_cache->find(addr);
+        if (pos != emulator_baton->m_opcode_cache->end() && pos->second.size() >= length)
+        {
+            memcpy(dst, pos->second.data(), length);
+            return length;
+        }
+    }
+
+    size_t bytes_read;
+    emulator_baton->m_process->ReadMemory(addr, dst, length, bytes_read);
+    if (is_opcode && bytes_read == length)
+    {
+        const uint8_t *bytes = static_cast<const uint8_t *>(dst);
+        (*emulator_baton->m_opcode_cache)[addr].assign(bytes, bytes + length);
+    }
+    return bytes_read;
+}
+
+static bool
+ReadRegisterCallback (EmulateInstruction *instruction,
+                      void *baton,
+                      const RegisterInfo *reg_info,
+                      RegisterValue &reg_value)
+{
+    EmulatorBaton* emulator_baton = static_cast<EmulatorBaton*>(baton);
+
+    auto it = emulator_baton->m_register_values.find(reg_info->kinds[eRegisterKindDWARF]);
+    if (it != emulator_baton->m_register_values.end())
+    {
+        reg_value = it->second;
+        return true;
     }
 
     // The emulator only fill in the dwarf regsiter numbers (and in some case
@@ -1598,9 +2496,8 @@ ReadFlags (NativeRegisterContext* regsiter_context)
 }
 
 Error
-NativeProcessLinux::SetupSoftwareSingleStepping(NativeThreadLinux &thread)
+NativeProcessLinux::GetSoftwareSingleStepTarget(NativeThreadLinux &thread, lldb::addr_t &next_pc, uint32_t &size_hint)
 {
-    Error error;
     NativeRegisterContextSP register_context_sp = thread.GetRegisterContext();
 
     std::unique_ptr<EmulateInstruction> emulator_ap(
@@ -1609,7 +2506,11 @@ NativeProcessLinux::SetupSoftwareSingleStepping(NativeThreadLinux &thread)
     if (emulator_ap == nullptr)
         return Error("Instruction emulator not found!");
 
-    EmulatorBaton baton(this, register_context_sp.get());
+    // Stepping through a source line decodes the same instructions again
+    // and again, keep them from being read from the inferior every time.
+    if (m_single_step_opcode_cache.size() > 4096)
+        m_single_step_opcode_cache.clear();
+    EmulatorBaton baton(this, register_context_sp.get(), &m_single_step_opcode_cache);
     emulator_ap->SetBaton(&baton);
     emulator_ap->SetReadMemCallback(&ReadMemoryCallback);
     emulator_ap->SetReadRegCallback(&ReadRegisterCallback);
@@ -1627,7 +2528,6 @@ NativeProcessLinux::SetupSoftwareSingleStepping(NativeThreadLinux &thread)
     auto pc_it = baton.m_register_values.find(reg_info_pc->kinds[eRegisterKindDWARF]);
     auto flags_it = baton.m_register_values.find(reg_info_flags->kinds[eRegisterKindDWARF]);
 
-    lldb::addr_t next_pc;
     lldb::addr_t next_flags;
     if (emulation_result)
     {
@@ -1661,31 +2561,83 @@ NativeProcessLinux::SetupSoftwareSingleStepping(NativeThreadLinux &thread)
         if (next_flags & 0x20)
         {
             // Thumb mode
-            error = SetSoftwareBreakpoint(next_pc, 2);
+            size_hint = 2;
         }
         else
         {
             // Arm mode
-            error = SetSoftwareBreakpoint(next_pc, 4);
+            size_hint = 4;
         }
     }
     else if (m_arch.GetMachine() == llvm::Triple::mips64
             || m_arch.GetMachine() == llvm::Triple::mips64el
             || m_arch.GetMachine() == llvm::Triple::mips
             || m_arch.GetMachine() == llvm::Triple::mipsel)
-        error = SetSoftwareBreakpoint(next_pc, 4);
+        size_hint = 4;
     else
     {
-        // No size hint is given for the next breakpoint
-        error = SetSoftwareBreakpoint(next_pc, 0);
+        // No size hint is given for the next breakpoint
+        size_hint = 0;
+    }
+
+    return Error();
+}
+
+Error
+NativeProcessLinux::SetupSoftwareSingleStepping(const ResumeActionList &resume_actions)
+{
+    // Find where every stepping thread goes first and then insert all of the
+    // breakpoints together, threads stepping to the same address share one.
+    std::vector<std::pair<lldb::addr_t, uint32_t>> breakpoints;
+    std::vector<lldb::tid_t> tids;
+    for (auto thread_sp : m_threads)
+    {
+        assert (thread_sp && "thread list should not contain NULL threads");
+
+        const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
+        if (action == nullptr || action->state != eStateStepping)
+            continue;
+
+        lldb::addr_t next_pc = LLDB_INVALID_ADDRESS;
+        uint32_t size_hint = 0;
+        Error error = GetSoftwareSingleStepTarget(static_cast<NativeThreadLinux &>(*thread_sp), next_pc, size_hint);
+        if (error.Fail())
+            return error;
+
+        tids.push_back (thread_sp->GetID ());
+        breakpoints.push_back (std::make_pair (next_pc, size_hint));
+    }
+
+    // The process may have changed its code while it ran freely.
+    if (tids.empty ())
+    {
+        m_single_step_opcode_cache.clear ();
+        return Error ();
+    }
+
+    std::vector<Error> errors;
+    SetBreakpoints (breakpoints, errors);
+    for (size_t i = 0; i < tids.size (); ++i)
+    {
+        if (errors[i].Fail ())
+            return errors[i];
+        m_threads_stepping_with_breakpoint.insert ({tids[i], breakpoints[i].first});
+    }
+    return Error ();
+}
+
+void
+NativeProcessLinux::InvalidateSingleStepOpcodes(lldb::addr_t addr, size_t size)
+{
+    // The cached instructions are at most 4 bytes long
+    auto pos = m_single_step_opcode_cache.lower_bound(addr > 4 ? addr - 4 : 0);
+    while (pos != m_single_step_opcode_cache.end() && pos->first < addr + size)
+    {
+        if (pos->first + pos->second.size() > addr)
+            pos = m_single_step_opcode_cache.erase(pos);
+        else
+            ++pos;
     }
-
-    if (error.Fail())
-        return error;
-
-    m_threads_stepping_with_breakpoint.insert({thread.GetID(), next_pc});
-
-    return Error();
 }
 
 bool
@@ -1709,27 +2661,20 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
 
     if (software_single_step)
     {
-        for (auto thread_sp : m_threads)
-        {
-            assert (thread_sp && "thread list should not contain NULL threads");
-
-            const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
-            if (action == nullptr)
-                continue;
-
-            if (action->state == eStateStepping)
-            {
-                Error error = SetupSoftwareSingleStepping(static_cast<NativeThreadLinux &>(*thread_sp));
-                if (error.Fail())
-                    return error;
-            }
-        }
+        Error error = SetupSoftwareSingleStepping(resume_actions);
+        if (error.Fail())
+            return error;
     }
 
     for (auto thread_sp : m_threads)
     {
         assert (thread_sp && "thread list should not contain NULL threads");
 
+        // In non-stop mode the default action does not apply to the threads that are
+        // still running.
+        if (m_non_stop_mode && StateIsRunningState (thread_sp->GetState ()))
+            continue;
+
         const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
 
         if (action == nullptr)
@@ -1746,6 +2691,14 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
                     __FUNCTION__, StateAsCString (action->state), GetID (), thread_sp->GetID ());
         }
 
+        // Range stepping is done with hardware single steps, without it we
+        // report every step and let the client decide.
+        if (action->state == eStateStepping && action->step_range_start < action->step_range_end &&
+            !software_single_step)
+            m_threads_range_stepping[thread_sp->GetID ()] = std::make_pair (action->step_range_start, action->step_range_end);
+        else
+            m_threads_range_stepping.erase (thread_sp->GetID ());
+
         switch (action->state)
         {
         case eStateRunning:
@@ -1786,8 +2739,23 @@ NativeProcessLinux::Detach ()
 {
     Error error;
 
+    // Give the pages of the software watchpoints their protection back.
+    NativeThreadLinuxSP stopped_thread_sp = GetStoppedThread ();
+    for (const auto &page : m_watched_pages)
+    {
+        if (stopped_thread_sp)
+            InferiorMprotect (*stopped_thread_sp, page.first, GetPageSize (), page.second);
+    }
+    m_software_watchpoints.clear ();
+    m_watched_pages.clear ();
+    m_threads_stepping_over_watched_page.clear ();
+
     // Stop monitoring the inferior.
-    m_sigchld_handle.reset();
+    StopMonitoringSigchld ();
+    m_branch_traces.clear ();
+
+    // The checkpoints would run on their own once detached.
+    KillCheckpoints ();
 
     // Tell ptrace to detach from the process.
     if (GetID () == LLDB_INVALID_PROCESS_ID)
@@ -1872,8 +2840,19 @@ NativeProcessLinux::Interrupt ()
                      running_thread_sp ? "running" : "stopped",
                      deferred_signal_thread_sp->GetID ());
 
-    StopRunningThreads(deferred_signal_thread_sp->GetID());
+    StopAllRunningThreads(deferred_signal_thread_sp->GetID());
+
+    return Error();
+}
+
+Error
+NativeProcessLinux::SetNonStopMode (bool enable)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("NativeProcessLinux::%s pid %" PRIu64 " %s non-stop mode", __FUNCTION__, GetID (), enable ? "enabling" : "disabling");
 
+    m_non_stop_mode = enable;
     return Error();
 }
 
@@ -2162,52 +3141,385 @@ NativeProcessLinux::DeallocateMemory (lldb::addr_t addr)
     return Error ("not implemented");
 }
 
+namespace
+{
+    // Auxiliary vector entry types, see <elf.h>.
+    const uint64_t kAuxvNull = 0;
+    const uint64_t kAuxvPhdr = 3;
+    const uint64_t kAuxvPhent = 4;
+    const uint64_t kAuxvPhnum = 5;
+
+    // Link map lists longer than this are assumed to be corrupt.
+    const size_t kMaxSVR4Libraries = 65536;
+}
+
 lldb::addr_t
 NativeProcessLinux::GetSharedLibraryInfoAddress ()
 {
-#if 1
-    // punt on this for now
+    // Return the address of the d_ptr of the DT_DEBUG entry in the
+    // executable's dynamic section, the same as
+    // ObjectFile::GetImageInfoAddress. The dynamic linker stores the
+    // address of its r_debug structure there.
+    if (m_shared_library_info_addr != LLDB_INVALID_ADDRESS)
+        return m_shared_library_info_addr;
+
+    const uint32_t addr_size = m_arch.GetAddressByteSize ();
+    const ByteOrder byte_order = m_arch.GetByteOrder ();
+    if (addr_size != 4 && addr_size != 8)
+        return LLDB_INVALID_ADDRESS;
+
+    // Find the program headers of the executable through the auxv.
+    DataBufferSP auxv_sp (Host::GetAuxvData (GetID ()));
+    if (!auxv_sp)
+        return LLDB_INVALID_ADDRESS;
+
+    DataExtractor auxv (auxv_sp, byte_order, addr_size);
+    lldb::offset_t offset = 0;
+    addr_t phdr_addr = LLDB_INVALID_ADDRESS;
+    uint64_t phent = 0;
+    uint64_t phnum = 0;
+    while (auxv.ValidOffsetForDataOfSize (offset, 2 * addr_size))
+    {
+        const uint64_t type = auxv.GetAddress (&offset);
+        const uint64_t value = auxv.GetAddress (&offset);
+        if (type == kAuxvNull)
+            break;
+        if (type == kAuxvPhdr)
+            phdr_addr = value;
+        else if (type == kAuxvPhent)
+            phent = value;
+        else if (type == kAuxvPhnum)
+            phnum = value;
+    }
+
+    const uint64_t min_phent = addr_size == 8 ? 56 : 32;
+    if (phdr_addr == LLDB_INVALID_ADDRESS || phent < min_phent || phnum == 0 || phnum > 0xffff)
+        return LLDB_INVALID_ADDRESS;
+
+    DataBufferSP phdrs_sp (new DataBufferHeap (phent * phnum, 0));
+    size_t bytes_read = 0;
+    Error error = ReadMemory (phdr_addr, phdrs_sp->GetBytes (), phdrs_sp->GetByteSize (), bytes_read);
+    if (error.Fail () || bytes_read != phdrs_sp->GetByteSize ())
+        return LLDB_INVALID_ADDRESS;
+
+    DataExtractor phdrs (phdrs_sp, byte_order, addr_size);
+    addr_t load_bias = 0;
+    addr_t dynamic_vaddr = LLDB_INVALID_ADDRESS;
+    uint64_t dynamic_size = 0;
+    for (uint64_t i = 0; i < phnum; ++i)
+    {
+        // Elf32_Phdr and Elf64_Phdr order p_flags differently, but the
+        // fields we need are all address sized after p_type.
+        offset = i * phent;
+        const uint32_t p_type = phdrs.GetU32 (&offset);
+        if (addr_size == 8)
+            offset += 4;    // p_flags
+        phdrs.GetAddress (&offset);     // p_offset
+        const addr_t p_vaddr = phdrs.GetAddress (&offset);
+        phdrs.GetAddress (&offset);     // p_paddr
+        phdrs.GetAddress (&offset);     // p_filesz
+        const uint64_t p_memsz = phdrs.GetAddress (&offset);
+
+        if (p_type == llvm::ELF::PT_PHDR)
+            load_bias = phdr_addr - p_vaddr;
+        else if (p_type == llvm::ELF::PT_DYNAMIC)
+        {
+            dynamic_vaddr = p_vaddr;
+            dynamic_size = p_memsz;
+        }
+    }
+
+    // A statically linked executable doesn't have a dynamic linker.
+    if (dynamic_vaddr == LLDB_INVALID_ADDRESS || dynamic_size == 0 || dynamic_size > 0x100000)
+        return LLDB_INVALID_ADDRESS;
+
+    const addr_t dynamic_addr = dynamic_vaddr + load_bias;
+    DataBufferSP dynamic_sp (new DataBufferHeap (dynamic_size, 0));
+    error = ReadMemory (dynamic_addr, dynamic_sp->GetBytes (), dynamic_sp->GetByteSize (), bytes_read);
+    if (error.Fail ())
+        return LLDB_INVALID_ADDRESS;
+
+    DataExtractor dynamic (dynamic_sp->GetBytes (), bytes_read, byte_order, addr_size);
+    offset = 0;
+    while (dynamic.ValidOffsetForDataOfSize (offset, 2 * addr_size))
+    {
+        const uint64_t d_tag = dynamic.GetAddress (&offset);
+        if (d_tag == llvm::ELF::DT_NULL)
+            break;
+        if (d_tag == llvm::ELF::DT_DEBUG)
+        {
+            m_shared_library_info_addr = dynamic_addr + offset;
+            return m_shared_library_info_addr;
+        }
+        dynamic.GetAddress (&offset);   // d_val
+    }
     return LLDB_INVALID_ADDRESS;
-#else
-    // Return the image info address for the exe module
-#if 1
+}
+
+Error
+NativeProcessLinux::StartBranchTrace (lldb::tid_t tid, size_t buffer_size)
+{
+    if (!GetThreadByID (tid))
+        return Error ("no thread with tid %" PRIu64, tid);
+    if (!m_mainloop)
+        return Error ("the process is not being monitored");
+
+    // Starting again restarts the trace with the new buffer size.
+    m_branch_traces.erase (tid);
+
+    Error error;
+    PerfBranchTrace::UP trace_up = PerfBranchTrace::Create (tid, buffer_size, *m_mainloop, error);
+    if (!trace_up)
+        return error;
+    m_branch_traces[tid] = std::move (trace_up);
+    return Error ();
+}
+
+Error
+NativeProcessLinux::StopBranchTrace (lldb::tid_t tid)
+{
+    if (m_branch_traces.erase (tid) == 0)
+        return Error ("tid %" PRIu64 " is not being traced", tid);
+    return Error ();
+}
+
+Error
+NativeProcessLinux::GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches)
+{
+    branches.clear ();
+    auto pos = m_branch_traces.find (tid);
+    if (pos == m_branch_traces.end ())
+        return Error ("tid %" PRIu64 " is not being traced", tid);
+
+    pos->second->GetBranches (branches);
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log && pos->second->GetLostBranchCount () > 0)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 ": %" PRIu64 " branches were lost", __FUNCTION__, tid,
+                     pos->second->GetLostBranchCount ());
+    return Error ();
+}
+
+Error
+NativeProcessLinux::SaveCheckpoint (uint32_t &checkpoint_id)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    checkpoint_id = 0;
+    if (GetState () != eStateStopped)
+        return Error ("the process must be stopped to save a checkpoint");
+    // The protection of the watched pages would be saved with the checkpoint.
+    if (!m_watched_pages.empty ())
+        return Error ("checkpoints can't be saved with software watchpoints");
+
+    // The forked checkpoint only has the thread that called fork.
+    NativeThreadLinuxSP thread_sp = GetThreadByID (GetCurrentThreadID ());
+    if (!thread_sp)
+        return Error ("no current thread to fork");
+
+    // Fork with the original code, so restoring puts in the breakpoints of
+    // the time it is restored instead of the ones of this time.
+    const std::vector<lldb::addr_t> breakpoint_addrs = DisableSoftwareBreakpoints ();
+    lldb::pid_t checkpoint_pid = LLDB_INVALID_PROCESS_ID;
+    Error error = InferiorFork (GetID (), thread_sp->GetID (), checkpoint_pid);
+    EnableSoftwareBreakpoints (breakpoint_addrs);
+    if (error.Fail ())
+        return error;
+
+    checkpoint_id = m_next_checkpoint_id++;
+    m_checkpoints[checkpoint_id] = checkpoint_pid;
+    if (log)
+        log->Printf ("NativeProcessLinux::%s pid %" PRIu64 ": saved checkpoint %" PRIu32 " as pid %" PRIu64,
+                     __FUNCTION__, GetID (), checkpoint_id, checkpoint_pid);
+    return error;
+}
+
+Error
+NativeProcessLinux::RestoreCheckpoint (uint32_t checkpoint_id)
+{
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
 
-    ModuleSP module_sp;
-    Error error = GetExeModuleSP (module_sp);
+    auto pos = m_checkpoints.find (checkpoint_id);
+    if (pos == m_checkpoints.end ())
+        return Error ("no checkpoint %" PRIu32, checkpoint_id);
+    if (GetState () != eStateStopped)
+        return Error ("the process must be stopped to restore a checkpoint");
+    if (!m_watched_pages.empty ())
+        return Error ("checkpoints can't be restored with software watchpoints");
+
+    // Fork the checkpoint again, so it can be restored again later.
+    const lldb::pid_t checkpoint_pid = pos->second;
+    lldb::pid_t new_pid = LLDB_INVALID_PROCESS_ID;
+    Error error = InferiorFork (checkpoint_pid, checkpoint_pid, new_pid);
     if (error.Fail ())
+        return error;
+
+    // The new process has the original code, the breakpoints are put into
+    // it once it is the debugged process.
+    const std::vector<lldb::addr_t> breakpoint_addrs = DisableSoftwareBreakpoints ();
+
+    // Wait for all the threads of the current process to go away, so none of
+    // their events are left for the monitor. The main thread is reported
+    // last.
+    const lldb::pid_t old_pid = GetID ();
+    ::kill (old_pid, SIGKILL);
+    std::vector<lldb::tid_t> tids;
+    for (const auto &thread_sp : m_threads)
     {
-         if (log)
-            log->Warning ("NativeProcessLinux::%s failed to retrieve exe module: %s", __FUNCTION__, error.AsCString ());
-        return LLDB_INVALID_ADDRESS;
+        if (thread_sp->GetID () != old_pid)
+            tids.push_back (thread_sp->GetID ());
+    }
+    tids.push_back (old_pid);
+    for (lldb::tid_t tid : tids)
+    {
+        int status = 0;
+        for (;;)
+        {
+            const ::pid_t wait_pid = ::waitpid (tid, &status, __WALL);
+            if (wait_pid == -1 && errno == EINTR)
+                continue;
+            if (wait_pid == -1 || !WIFSTOPPED (status))
+                break;
+            // The exit event stop.
+            PtraceWrapper (PTRACE_CONT, tid);
+        }
     }
 
-    if (module_sp == nullptr)
+    m_threads.clear ();
+    m_threads_pending_stop.clear ();
+    m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
+    m_threads_stepping_with_breakpoint.clear ();
+    m_threads_stepping_over_condition.clear ();
+    m_threads_range_stepping.clear ();
+    m_branch_traces.clear ();
+    m_single_step_opcode_cache.clear ();
+    m_mem_region_cache.clear ();
+
+    m_pid = new_pid;
+    NativeThreadLinuxSP thread_sp = AddThread (new_pid);
+    thread_sp->SetStoppedBySignal (SIGSTOP);
+    SetCurrentThreadID (new_pid);
+    EnableSoftwareBreakpoints (breakpoint_addrs);
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s restored checkpoint %" PRIu32 ": pid %" PRIu64 " replaces pid %" PRIu64,
+                     __FUNCTION__, checkpoint_id, new_pid, old_pid);
+    return error;
+}
+
+Error
+NativeProcessLinux::GetLoadedSVR4Libraries (std::vector<SVR4LibraryInfo> &library_list, lldb::addr_t &main_link_map)
+{
+    library_list.clear ();
+    main_link_map = LLDB_INVALID_ADDRESS;
+
+    const addr_t info_addr = GetSharedLibraryInfoAddress ();
+    if (info_addr == LLDB_INVALID_ADDRESS)
+        return Error ("the executable has no DT_DEBUG entry");
+
+    const uint32_t addr_size = m_arch.GetAddressByteSize ();
+    const ByteOrder byte_order = m_arch.GetByteOrder ();
+    auto read_pointers = [this, addr_size, byte_order](addr_t addr, addr_t *values, size_t count) -> bool
+    {
+        uint8_t buf[8 * 5];
+        assert (count <= 5);
+        size_t bytes_read = 0;
+        Error error = ReadMemory (addr, buf, addr_size * count, bytes_read);
+        if (error.Fail () || bytes_read != addr_size * count)
+            return false;
+        DataExtractor data (buf, bytes_read, byte_order, addr_size);
+        lldb::offset_t offset = 0;
+        for (size_t i = 0; i < count; ++i)
+            values[i] = data.GetAddress (&offset);
+        return true;
+    };
+
+    // struct r_debug { int r_version; struct link_map *r_map; ... }
+    addr_t r_debug_addr = 0;
+    if (!read_pointers (info_addr, &r_debug_addr, 1))
+        return Error ("failed to read DT_DEBUG");
+    if (r_debug_addr == 0)
+        return Error ("the dynamic linker didn't set up r_debug yet");
+
+    addr_t r_map = 0;
+    if (!read_pointers (r_debug_addr + addr_size, &r_map, 1))
+        return Error ("failed to read r_debug");
+
+    // struct link_map { l_addr, l_name, l_ld, l_next, l_prev }
+    //
+    // The first entry is the main executable, report it as the main
+    // link map like gdbserver does.
+    std::vector<addr_t> name_addrs;
+    addr_t prev = 0;
+    for (addr_t link_map = r_map; link_map != 0;)
     {
-         if (log)
-            log->Warning ("NativeProcessLinux::%s exe module returned was NULL", __FUNCTION__);
-         return LLDB_INVALID_ADDRESS;
+        if (library_list.size () >= kMaxSVR4Libraries)
+            return Error ("the link_map list is corrupt");
+
+        addr_t fields[5];
+        if (!read_pointers (link_map, fields, 5))
+            return Error ("failed to read link_map at 0x%" PRIx64, link_map);
+        if (fields[4] != prev)
+            return Error ("the link_map list is corrupt at 0x%" PRIx64, link_map);
+
+        if (prev == 0)
+        {
+            main_link_map = link_map;
+        }
+        else
+        {
+            SVR4LibraryInfo info;
+            info.link_map = link_map;
+            info.base_addr = fields[0];
+            info.ld_addr = fields[2];
+            library_list.push_back (info);
+            name_addrs.push_back (fields[1]);
+        }
+        prev = link_map;
+        link_map = fields[3];
     }
 
-    ObjectFileSP object_file_sp = module_sp->GetObjectFile ();
-    if (object_file_sp == nullptr)
+    // Read the names with one batch of reads. Names that don't fit are
+    // read again one by one.
+    const size_t kNameChunkSize = 256;
+    std::vector<char> names (name_addrs.size () * kNameChunkSize, 0);
+    std::vector<MemoryReadRange> ranges (name_addrs.size ());
+    for (size_t i = 0; i < name_addrs.size (); ++i)
     {
-         if (log)
-            log->Warning ("NativeProcessLinux::%s exe module returned a NULL object file", __FUNCTION__);
-         return LLDB_INVALID_ADDRESS;
+        ranges[i].addr = name_addrs[i];
+        ranges[i].buf = names.data () + i * kNameChunkSize;
+        ranges[i].size = name_addrs[i] ? kNameChunkSize : 0;
+        ranges[i].bytes_read = 0;
     }
+    Error error = ReadMemoryRanges (ranges);
+    if (error.Fail ())
+        return error;
 
-    return obj_file_sp->GetImageInfoAddress();
-#else
-    Target *target = &GetTarget();
-    ObjectFile *obj_file = target->GetExecutableModule()->GetObjectFile();
-    Address addr = obj_file->GetImageInfoAddress(target);
+    for (size_t i = 0; i < library_list.size (); ++i)
+    {
+        const char *chunk = static_cast<const char *> (ranges[i].buf);
+        const char *end = static_cast<const char *> (::memchr (chunk, '\0', ranges[i].bytes_read));
+        if (end)
+        {
+            library_list[i].name.assign (chunk, end);
+            continue;
+        }
 
-    if (addr.IsValid())
-        return addr.GetLoadAddress(target);
-    return LLDB_INVALID_ADDRESS;
-#endif
-#endif // punt on this for now
+        std::string &name = library_list[i].name;
+        name.assign (chunk, ranges[i].bytes_read);
+        char buf[kNameChunkSize];
+        while (ranges[i].bytes_read == kNameChunkSize && name.size () < PATH_MAX)
+        {
+            size_t bytes_read = 0;
+            ReadMemory (name_addrs[i] + name.size (), buf, sizeof (buf), bytes_read);
+            end = static_cast<const char *> (::memchr (buf, '\0', bytes_read));
+            name.append (buf, end ? end - buf : bytes_read);
+            if (end || bytes_read == 0)
+                break;
+        }
+    }
+
+    return Error ();
 }
 
 size_t
@@ -2566,6 +3878,71 @@ NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_
     return Error();
 }
 
+Error
+NativeProcessLinux::ReadMemoryRanges (std::vector<MemoryReadRange> &ranges)
+{
+    if (!ProcessVmReadvSupported())
+        return NativeProcessProtocol::ReadMemoryRanges (ranges);
+
+    Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    const ::pid_t pid = GetID();
+    std::vector<struct iovec> local_iov;
+    std::vector<struct iovec> remote_iov;
+    local_iov.reserve(std::min(ranges.size(), k_max_iov_count));
+    remote_iov.reserve(std::min(ranges.size(), k_max_iov_count));
+
+    size_t range_idx = 0;
+    while (range_idx < ranges.size())
+    {
+        // Read as many ranges as the kernel accepts with a single call
+        const size_t batch_end = std::min(ranges.size(), range_idx + k_max_iov_count);
+        local_iov.clear();
+        remote_iov.clear();
+        for (size_t i = range_idx; i < batch_end; ++i)
+        {
+            MemoryReadRange &range = ranges[i];
+            range.bytes_read = 0;
+
+            struct iovec iov;
+            iov.iov_base = range.buf;
+            iov.iov_len = range.size;
+            local_iov.push_back(iov);
+            iov.iov_base = reinterpret_cast<void *>(range.addr);
+            remote_iov.push_back(iov);
+        }
+
+        const ssize_t result = process_vm_readv(pid, local_iov.data(), local_iov.size(),
+                                                remote_iov.data(), remote_iov.size(), 0);
+
+        // process_vm_readv stops at the first range it can't read completely, so the
+        // bytes that were read belong to the ranges in order.
+        size_t bytes_left = result < 0 ? 0 : result;
+        size_t i = range_idx;
+        for (; i < batch_end && bytes_left >= ranges[i].size; ++i)
+        {
+            ranges[i].bytes_read = ranges[i].size;
+            bytes_left -= ranges[i].size;
+        }
+
+        if (log)
+            log->Printf ("NativeProcessLinux::%s using process_vm_readv to read %zu ranges: %zu succeeded",
+                    __FUNCTION__, batch_end - range_idx, i - range_idx);
+
+        if (i == batch_end)
+        {
+            range_idx = batch_end;
+            continue;
+        }
+
+        // Retry the range that failed on its own, ReadMemory falls back to the ptrace api
+        // and tells us how much of it can be read. Then continue with the ranges after it.
+        MemoryReadRange &failed_range = ranges[i];
+        ReadMemory (failed_range.addr, failed_range.buf, failed_range.size, failed_range.bytes_read);
+        range_idx = i + 1;
+    }
+    return Error();
+}
+
 Error
 NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read)
 {
@@ -2587,6 +3964,8 @@ NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
     if (log && ProcessPOSIXLog::AtTopNestLevel() && log->GetMask().Test(POSIX_LOG_MEMORY))
         log->Printf ("NativeProcessLinux::%s(0x%" PRIx64 ", %p, %zu)", __FUNCTION__, addr, buf, size);
 
+    InvalidateSingleStepOpcodes(addr, size);
+
     for (bytes_written = 0; bytes_written < size; bytes_written += remainder)
     {
         remainder = size - bytes_written;
@@ -2722,6 +4101,9 @@ NativeProcessLinux::StopTrackingThread (lldb::tid_t thread_id)
             break;
         }
     }
+    m_threads_range_stepping.erase (thread_id);
+    m_threads_stepping_over_watched_page.erase (thread_id);
+    m_branch_traces.erase (thread_id);
 
     SignalIfAllThreadsStopped();
 
@@ -2960,6 +4342,55 @@ NativeProcessLinux::ResumeThread(NativeThreadLinux &thread, lldb::StateType stat
 
 void
 NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid)
+{
+    // Fall back to stopping everything if we are already waiting for all threads to stop,
+    // e.g. because of an interrupt.
+    if (!m_non_stop_mode || m_pending_notification_tid != LLDB_INVALID_THREAD_ID)
+    {
+        StopAllRunningThreads(triggering_tid);
+        return;
+    }
+
+    Log *const log = GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD);
+    if (log)
+        log->Printf("NativeProcessLinux::%s reporting non-stop event: (triggering_tid: %" PRIu64 ")",
+                __FUNCTION__, triggering_tid);
+
+    // Clear the temporary breakpoint we used to implement software single stepping of this thread.
+    auto stepping_it = m_threads_stepping_with_breakpoint.find(triggering_tid);
+    if (stepping_it != m_threads_stepping_with_breakpoint.end())
+    {
+        Error error = RemoveBreakpoint (stepping_it->second);
+        if (error.Fail() && log)
+            log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " remove stepping breakpoint: %s",
+                    __FUNCTION__, triggering_tid, error.AsCString());
+        m_threads_stepping_with_breakpoint.erase(stepping_it);
+    }
+
+    // The thread was interrupted while stepping over a false condition.
+    auto condition_it = m_threads_stepping_over_condition.find(triggering_tid);
+    if (condition_it != m_threads_stepping_over_condition.end())
+    {
+        FinishSteppingOverCondition(triggering_tid, condition_it->second);
+        m_threads_stepping_over_condition.erase(condition_it);
+    }
+
+    // Or while stepping over an access to a watched page.
+    auto watched_page_it = m_threads_stepping_over_watched_page.find(triggering_tid);
+    if (watched_page_it != m_threads_stepping_over_watched_page.end())
+    {
+        NativeThreadLinuxSP thread_sp = GetThreadByID(triggering_tid);
+        if (thread_sp)
+            UpdateWatchedPage(*thread_sp, watched_page_it->second.page);
+        m_threads_stepping_over_watched_page.erase(watched_page_it);
+    }
+
+    SetCurrentThreadID(triggering_tid);
+    NotifyThreadStopped(triggering_tid);
+}
+
+void
+NativeProcessLinux::StopAllRunningThreads(const lldb::tid_t triggering_tid)
 {
     Log *const log = GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD);
 
@@ -2969,14 +4400,25 @@ NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid)
                 __FUNCTION__, triggering_tid);
     }
 
+    // Time the whole stop, unless we are already waiting for one.
+    if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
+    {
+        m_stop_request_time = std::chrono::steady_clock::now();
+        m_threads_pending_stop.clear();
+    }
     m_pending_notification_tid = triggering_tid;
 
     // Request a stop for all the thread stops that need to be stopped
-    // and are not already known to be stopped.
+    // and are not already known to be stopped. All the requests go out
+    // before we wait for any of the stops.
     for (const auto &thread_sp: m_threads)
     {
         if (StateIsRunningState(thread_sp->GetState()))
-            static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
+        {
+            NativeThreadLinuxSP linux_thread_sp = static_pointer_cast<NativeThreadLinux>(thread_sp);
+            linux_thread_sp->RequestStop();
+            m_threads_pending_stop.push_back(linux_thread_sp);
+        }
     }
 
     SignalIfAllThreadsStopped();
@@ -2993,15 +4435,31 @@ NativeProcessLinux::SignalIfAllThreadsStopped()
     if (m_pending_notification_tid == LLDB_INVALID_THREAD_ID)
         return; // No pending notification. Nothing to do.
 
+    // Drop the threads that stopped since the last call. Every thread is
+    // dropped once, so stopping N threads costs O(N) checks overall rather
+    // than a scan of all the threads for each of the N stop events.
+    while (!m_threads_pending_stop.empty())
+    {
+        if (StateIsRunningState(m_threads_pending_stop.back()->GetState()))
+            return; // Some threads are still running. Don't signal yet.
+        m_threads_pending_stop.pop_back();
+    }
+
+    // Catch any thread that was resumed after we asked it to stop.
     for (const auto &thread_sp: m_threads)
     {
         if (StateIsRunningState(thread_sp->GetState()))
+        {
+            m_threads_pending_stop.push_back(static_pointer_cast<NativeThreadLinux>(thread_sp));
             return; // Some threads are still running. Don't signal yet.
+        }
     }
 
     // We have a pending notification and all threads have stopped.
     Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
 
+    LogStopLatency();
+
     // Clear any temporary breakpoints we used to implement software single stepping.
     for (const auto &thread_info: m_threads_stepping_with_breakpoint)
     {
@@ -3013,12 +4471,62 @@ NativeProcessLinux::SignalIfAllThreadsStopped()
     }
     m_threads_stepping_with_breakpoint.clear();
 
+    // Re-enable the breakpoints of threads that were stopped before they
+    // finished stepping over a false condition.
+    for (const auto &thread_info: m_threads_stepping_over_condition)
+    {
+        NativeBreakpointSP breakpoint_sp;
+        if (m_breakpoint_list.GetBreakpoint(thread_info.second, breakpoint_sp).Success())
+        {
+            Error error = breakpoint_sp->Enable();
+            if (error.Fail() && log)
+                log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " re-enable breakpoint: %s",
+                        __FUNCTION__, thread_info.first, error.AsCString());
+        }
+    }
+    m_threads_stepping_over_condition.clear();
+
+    // Protect the pages of threads that were stopped before they finished
+    // stepping over an access to them.
+    for (const auto &thread_info: m_threads_stepping_over_watched_page)
+    {
+        NativeThreadLinuxSP thread_sp = GetThreadByID(thread_info.first);
+        if (!thread_sp)
+            continue;
+        Error error = UpdateWatchedPage(*thread_sp, thread_info.second.page);
+        if (error.Fail() && log)
+            log->Printf("NativeProcessLinux::%s() tid = %" PRIu64 " protect watched page: %s",
+                    __FUNCTION__, thread_info.first, error.AsCString());
+    }
+    m_threads_stepping_over_watched_page.clear();
+
     // Notify the delegate about the stop
     SetCurrentThreadID(m_pending_notification_tid);
     SetState(StateType::eStateStopped, true);
     m_pending_notification_tid = LLDB_INVALID_THREAD_ID;
 }
 
+void
+NativeProcessLinux::LogStopLatency()
+{
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_stop_request_time).count();
+
+    size_t bucket = 0;
+    for (long long limit = 100; bucket < 4 && latency >= limit; limit *= 10)
+        ++bucket;
+    ++m_stop_latency_histogram[bucket];
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf("NativeProcessLinux::%s pid %" PRIu64 ": stopping %zu threads took %lld us (%s), "
+                    "stops taking <100us: %" PRIu32 ", <1ms: %" PRIu32 ", <10ms: %" PRIu32 ", <100ms: %" PRIu32 ", longer: %" PRIu32,
+                    __FUNCTION__, GetID(), m_threads.size(), static_cast<long long>(latency),
+                    m_seized ? "PTRACE_INTERRUPT" : "SIGSTOP",
+                    m_stop_latency_histogram[0], m_stop_latency_histogram[1], m_stop_latency_histogram[2],
+                    m_stop_latency_histogram[3], m_stop_latency_histogram[4]);
+}
+
 void
 NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread)
 {
@@ -3032,7 +4540,70 @@ NativeProcessLinux::ThreadWasCreated(NativeThreadLinux &thread)
         // We will need to wait for this new thread to stop as well before firing the
         // notification.
         thread.RequestStop();
+        m_threads_pending_stop.push_back(static_pointer_cast<NativeThreadLinux>(thread.shared_from_this()));
+    }
+}
+
+bool
+NativeProcessLinux::StartMonitoringSigchld (MainLoop &mainloop, Error &error)
+{
+    SigchldMonitor &monitor = GetSigchldMonitor();
+    if (!monitor.handle)
+    {
+        monitor.handle = mainloop.RegisterSignal(SIGCHLD,
+                [] (MainLoopBase &) { SigchldHandler(); }, error);
+        if (!monitor.handle)
+            return false;
+    }
+    monitor.processes.push_back(this);
+    m_monitoring_sigchld = true;
+    return true;
+}
+
+void
+NativeProcessLinux::StopMonitoringSigchld ()
+{
+    if (!m_monitoring_sigchld)
+        return;
+    m_monitoring_sigchld = false;
+
+    SigchldMonitor &monitor = GetSigchldMonitor();
+    monitor.processes.erase(std::remove(monitor.processes.begin(), monitor.processes.end(), this),
+                            monitor.processes.end());
+    if (monitor.processes.empty())
+        monitor.handle.reset();
+}
+
+NativeProcessLinux *
+NativeProcessLinux::GetProcessForThread (::pid_t tid)
+{
+    std::vector<NativeProcessLinux *> &processes = GetSigchldMonitor().processes;
+    if (processes.size() == 1)
+        return processes.front();
+
+    for (NativeProcessLinux *process : processes)
+    {
+        if (process->GetID() == static_cast<lldb::pid_t>(tid) || process->GetThreadByID(tid))
+            return process;
     }
+
+    // A thread we haven't been told about yet, look up which process it
+    // belongs to.
+    lldb::pid_t tgid = LLDB_INVALID_PROCESS_ID;
+    ProcFileReader::ProcessLineByLine(tid, "status",
+        [&] (const std::string &line)
+        {
+            if (line.compare(0, strlen("Tgid:"), "Tgid:") != 0)
+                return true;
+            tgid = ::strtoull(line.c_str() + strlen("Tgid:"), nullptr, 10);
+            return false;
+        });
+    for (NativeProcessLinux *process : processes)
+    {
+        if (process->GetID() == tgid)
+            return process;
+    }
+    return processes.empty() ? nullptr : processes.front();
 }
 
 void
@@ -3060,6 +4631,8 @@ NativeProcessLinux::SigchldHandler()
             break;
         }
 
+        NativeProcessLinux *process = GetProcessForThread (wait_pid);
+
         bool exited = false;
         int signal = 0;
         int exit_status = 0;
@@ -3079,7 +4652,7 @@ NativeProcessLinux::SigchldHandler()
         {
             signal = WTERMSIG(status);
             status_cstr = "SIGNALED";
-            if (wait_pid == static_cast< ::pid_t>(GetID())) {
+            if (process && wait_pid == static_cast< ::pid_t>(process->GetID())) {
                 exited = true;
                 exit_status = -1;
             }
@@ -3092,7 +4665,8 @@ NativeProcessLinux::SigchldHandler()
                 "=> pid = %" PRIi32 ", status = 0x%8.8x (%s), signal = %i, exit_state = %i",
                 __FUNCTION__, wait_pid, status, status_cstr, signal, exit_status);
 
-        MonitorCallback (wait_pid, exited, signal, exit_status);
+        if (process)
+            process->MonitorCallback (wait_pid, exited, signal, exit_status);
     }
 }
 
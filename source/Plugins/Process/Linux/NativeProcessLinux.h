@@ -11,7 +11,10 @@
 #define liblldb_NativeProcessLinux_H_
 
 // C++ Includes
+#include <chrono>
+#include <map>
 #include <unordered_set>
+#include <vector>
 
 // Other libraries and framework includes
 #include "lldb/Core/ArchSpec.h"
@@ -23,6 +26,7 @@
 
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "NativeThreadLinux.h"
+#include "PerfBranchTrace.h"
 
 namespace lldb_private {
     class Error;
@@ -52,6 +56,8 @@ namespace process_linux {
                 NativeProcessProtocolSP &process_sp);
 
     public:
+        ~NativeProcessLinux () override;
+
         // ---------------------------------------------------------------------
         // NativeProcessProtocol Interface
         // ---------------------------------------------------------------------
@@ -70,6 +76,9 @@ namespace process_linux {
         Error
         Interrupt () override;
 
+        Error
+        SetNonStopMode (bool enable) override;
+
         Error
         Kill () override;
 
@@ -82,6 +91,9 @@ namespace process_linux {
         Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) override;
 
+        Error
+        ReadMemoryRanges (std::vector<MemoryReadRange> &ranges) override;
+
         Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) override;
 
@@ -94,6 +106,24 @@ namespace process_linux {
         lldb::addr_t
         GetSharedLibraryInfoAddress () override;
 
+        Error
+        GetLoadedSVR4Libraries (std::vector<SVR4LibraryInfo> &library_list, lldb::addr_t &main_link_map) override;
+
+        Error
+        StartBranchTrace (lldb::tid_t tid, size_t buffer_size) override;
+
+        Error
+        StopBranchTrace (lldb::tid_t tid) override;
+
+        Error
+        GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches) override;
+
+        Error
+        SaveCheckpoint (uint32_t &checkpoint_id) override;
+
+        Error
+        RestoreCheckpoint (uint32_t checkpoint_id) override;
+
         size_t
         UpdateThreads () override;
 
@@ -103,6 +133,25 @@ namespace process_linux {
         Error
         SetBreakpoint (lldb::addr_t addr, uint32_t size, bool hardware) override;
 
+        Error
+        SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags, bool hardware) override;
+
+        Error
+        RemoveWatchpoint (lldb::addr_t addr) override;
+
+        // The hardware watchpoints of the process, without the one at
+        // except_addr.
+        std::vector<NativeWatchpoint>
+        GetHardwareWatchpoints (lldb::addr_t except_addr = LLDB_INVALID_ADDRESS) const;
+
+        // Bumped whenever the hardware watchpoints change. The threads that
+        // weren't stopped then get them when they resume.
+        uint32_t
+        GetHardwareWatchpointsGeneration () const
+        {
+            return m_hardware_watchpoints_generation;
+        }
+
         void
         DoStopIDBumped (uint32_t newBumpId) override;
 
@@ -129,6 +178,14 @@ namespace process_linux {
         bool
         SupportHardwareSingleStepping() const;
 
+        // True if the threads were attached with PTRACE_SEIZE, so they can be
+        // stopped with PTRACE_INTERRUPT instead of a SIGSTOP.
+        bool
+        IsSeized() const
+        {
+            return m_seized;
+        }
+
     protected:
         // ---------------------------------------------------------------------
         // NativeProcessProtocol protected interface
@@ -138,7 +195,8 @@ namespace process_linux {
 
     private:
 
-        MainLoop::SignalHandleUP m_sigchld_handle;
+        bool m_monitoring_sigchld;
+        MainLoop *m_mainloop;
         ArchSpec m_arch;
 
         LazyBool m_supports_mem_region;
@@ -146,10 +204,73 @@ namespace process_linux {
 
         lldb::tid_t m_pending_notification_tid;
 
+        // The threads we asked to stop for the pending notification, and
+        // when we asked. SignalIfAllThreadsStopped() drops them as they stop
+        // instead of looking at every thread for every stop event.
+        std::vector<NativeThreadLinuxSP> m_threads_pending_stop;
+        std::chrono::steady_clock::time_point m_stop_request_time;
+
+        // How long stopping all the threads took: < 100us, < 1ms, < 10ms,
+        // < 100ms and longer.
+        uint32_t m_stop_latency_histogram[5];
+
+        bool m_seized;
+
+        // Where the dynamic linker stores the address of r_debug, see
+        // GetSharedLibraryInfoAddress().
+        lldb::addr_t m_shared_library_info_addr;
+
         // List of thread ids stepping with a breakpoint with the address of
         // the relevan breakpoint
         std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+        // The instruction bytes software single stepping read, by address.
+        // Writes to the memory and exec invalidate them.
+        std::map<lldb::addr_t, std::vector<uint8_t>> m_single_step_opcode_cache;
+
+        // Threads single stepping over a disabled breakpoint whose condition
+        // was false, with the address of the breakpoint to re-enable.
+        std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_over_condition;
+
+        // Threads that keep single stepping until their pc leaves the
+        // [start, end) range, see ResumeAction::step_range_start.
+        std::map<lldb::tid_t, std::pair<lldb::addr_t, lldb::addr_t>> m_threads_range_stepping;
+
+        // The branch traces of the threads that are traced.
+        std::map<lldb::tid_t, PerfBranchTrace::UP> m_branch_traces;
+
+        // Watchpoints that don't fit in the debug registers. The pages they
+        // are on lose the access the watchpoint is for, and the faults are
+        // filtered to the watched ranges.
+        struct SoftwareWatchpoint
+        {
+            lldb::addr_t addr;
+            size_t size;
+            uint32_t watch_flags;
+        };
+        std::map<lldb::addr_t, SoftwareWatchpoint> m_software_watchpoints;
+
+        uint32_t m_hardware_watchpoints_generation;
+
+        // The protected pages with their original ePermissions* flags.
+        std::map<lldb::addr_t, uint32_t> m_watched_pages;
+
+        // A thread single stepping over an access to a watched page that we
+        // gave its original protection back for the step.
+        struct WatchedPageStep
+        {
+            lldb::addr_t page;
+            lldb::addr_t fault_addr;
+            bool was_stepping; // The client asked the thread to step
+            std::map<lldb::addr_t, std::vector<uint8_t>> old_contents; // Of the write watchpoints on the page
+        };
+        std::map<lldb::tid_t, WatchedPageStep> m_threads_stepping_over_watched_page;
+
+        // The checkpoints by ID. Each one is a stopped fork of the process
+        // that is forked again to restore it.
+        std::map<uint32_t, lldb::pid_t> m_checkpoints;
+        uint32_t m_next_checkpoint_id;
+
         /// @class LauchArgs
         ///
         /// @brief Simple structure to pass data to the thread responsible for
@@ -210,6 +331,9 @@ namespace process_linux {
         ::pid_t
         Attach(lldb::pid_t pid, Error &error);
 
+        static long
+        GetDefaultPtraceOpts();
+
         static Error
         SetDefaultPtraceOpts(const lldb::pid_t);
 
@@ -234,14 +358,82 @@ namespace process_linux {
         void
         MonitorBreakpoint(NativeThreadLinux &thread);
 
+        bool
+        StepOverFalseCondition(NativeThreadLinux &thread);
+
+        void
+        FinishSteppingOverCondition(lldb::tid_t tid, lldb::addr_t addr);
+
         void
         MonitorWatchpoint(NativeThreadLinux &thread, uint32_t wp_index);
 
+        // Runs mprotect() in the inferior on the stopped thread. permissions
+        // are ePermissions* flags.
+        Error
+        InferiorMprotect(NativeThreadLinux &thread, lldb::addr_t addr, size_t length, uint32_t permissions);
+
+        // Runs fork() in the inferior on the stopped thread tid of process
+        // pid. The child stops before it runs any code and gets the code and
+        // the registers the thread had before the call.
+        Error
+        InferiorFork(lldb::pid_t pid, lldb::tid_t tid, lldb::pid_t &child_pid);
+
+        // Takes the traps of the enabled software breakpoints out of the
+        // code and returns their addresses.
+        std::vector<lldb::addr_t>
+        DisableSoftwareBreakpoints();
+
+        void
+        EnableSoftwareBreakpoints(const std::vector<lldb::addr_t> &addrs);
+
+        void
+        KillCheckpoints();
+
+        // Gives page the protection its software watchpoints need, or its
+        // original one back if it has none left.
+        Error
+        UpdateWatchedPage(NativeThreadLinux &thread, lldb::addr_t page);
+
+        // Makes watchpoints the hardware watchpoints of the process.
+        Error
+        SetHardwareWatchpoints(const std::vector<NativeWatchpoint> &watchpoints);
+
+        Error
+        SetSoftwareWatchpoint(lldb::addr_t addr, size_t size, uint32_t watch_flags);
+
+        Error
+        RemoveSoftwareWatchpoint(lldb::addr_t addr);
+
+        // Returns true if the SIGSEGV in info was an access to a watched
+        // page, which the thread now single steps over.
+        bool
+        MonitorWatchedPageFault(NativeThreadLinux &thread, const siginfo_t &info);
+
+        // Protects the page again after the step and returns the address of
+        // the software watchpoint the access hit, or LLDB_INVALID_ADDRESS.
+        lldb::addr_t
+        FinishSteppingOverWatchedPage(NativeThreadLinux &thread, const WatchedPageStep &step);
+
+        // Finds a thread that can run the system calls InferiorMprotect()
+        // needs, the current thread if it is stopped.
+        NativeThreadLinuxSP
+        GetStoppedThread();
+
         void
         MonitorSignal(const siginfo_t &info, NativeThreadLinux &thread, bool exited);
 
+        // Emulate the instruction at the pc of the thread to find the
+        // address of the next one and the size of the breakpoint for it.
+        Error
+        GetSoftwareSingleStepTarget(NativeThreadLinux &thread, lldb::addr_t &next_pc, uint32_t &size_hint);
+
+        // Insert the breakpoints that stop the threads the actions step.
         Error
-        SetupSoftwareSingleStepping(NativeThreadLinux &thread);
+        SetupSoftwareSingleStepping(const ResumeActionList &resume_actions);
+
+        // Forget the cached instructions that overlap a write.
+        void
+        InvalidateSingleStepOpcodes(lldb::addr_t addr, size_t size);
 
 #if 0
         static ::ProcessMessage::CrashReason
@@ -293,12 +485,25 @@ namespace process_linux {
         // This method is requests a stop on all threads which are still running. It sets up a
         // deferred delegate notification, which will fire once threads report as stopped. The
         // triggerring_tid will be set as the current thread (main stop reason).
+        // In non-stop mode only the triggering thread is reported and the others keep running.
         void
         StopRunningThreads(lldb::tid_t triggering_tid);
 
+        // Same as StopRunningThreads(), but always stops all the threads, even in non-stop mode.
+        void
+        StopAllRunningThreads(lldb::tid_t triggering_tid);
+
         // Notify the delegate if all threads have stopped.
         void SignalIfAllThreadsStopped();
 
+        // A thread stopped because we asked it to, with a SIGSTOP or a
+        // PTRACE_INTERRUPT. info is the siginfo of the SIGSTOP, or nullptr.
+        void
+        MonitorRequestedStop(NativeThreadLinux &thread, const siginfo_t *info);
+
+        void
+        LogStopLatency();
+
         // Resume the given thread, optionally passing it the given signal. The type of resume
         // operation (continue, single-step) depends on the state parameter.
         Error
@@ -307,7 +512,18 @@ namespace process_linux {
         void
         ThreadWasCreated(NativeThreadLinux &thread);
 
+        // All processes debugged on a main loop share one SIGCHLD handler,
+        // waitpid(-1) reports the threads of any of them.
+        bool
+        StartMonitoringSigchld (MainLoop &mainloop, Error &error);
+
         void
+        StopMonitoringSigchld ();
+
+        static NativeProcessLinux *
+        GetProcessForThread (::pid_t tid);
+
+        static void
         SigchldHandler();
     };
 
@@ -22,9 +22,18 @@ using namespace lldb_private::process_linux;
 NativeRegisterContextLinux::NativeRegisterContextLinux(NativeThreadProtocol &native_thread,
                                                        uint32_t concrete_frame_idx,
                                                        RegisterInfoInterface *reg_info_interface_p) :
-    NativeRegisterContextRegisterInfo(native_thread, concrete_frame_idx, reg_info_interface_p)
+    NativeRegisterContextRegisterInfo(native_thread, concrete_frame_idx, reg_info_interface_p),
+    m_gpr_valid(false),
+    m_fpr_valid(false)
 {}
 
+void
+NativeRegisterContextLinux::InvalidateAllRegisters()
+{
+    m_gpr_valid = false;
+    m_fpr_valid = false;
+}
+
 lldb::ByteOrder
 NativeRegisterContextLinux::GetByteOrder() const
 {
@@ -106,18 +115,26 @@ NativeRegisterContextLinux::WriteRegisterRaw(uint32_t reg_index, const RegisterV
     if (!register_to_write_info_p)
         return Error("NativeRegisterContextLinux::%s failed to get RegisterInfo for write register index %" PRIu32, __FUNCTION__, reg_to_write);
 
+    // The write goes around the cached register sets.
+    InvalidateAllRegisters();
+
     return DoWriteRegisterValue(reg_info->byte_offset, reg_info->name, reg_value);
 }
 
 Error
 NativeRegisterContextLinux::ReadGPR()
 {
+    if (m_gpr_valid)
+        return Error();
+
     void* buf = GetGPRBuffer();
     if (!buf)
         return Error("GPR buffer is NULL");
     size_t buf_size = GetGPRSize();
 
-    return DoReadGPR(buf, buf_size);
+    Error error = DoReadGPR(buf, buf_size);
+    m_gpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -128,18 +145,26 @@ NativeRegisterContextLinux::WriteGPR()
         return Error("GPR buffer is NULL");
     size_t buf_size = GetGPRSize();
 
-    return DoWriteGPR(buf, buf_size);
+    // After a successful write the buffer is what the thread has.
+    Error error = DoWriteGPR(buf, buf_size);
+    m_gpr_valid = error.Success();
+    return error;
 }
 
 Error
 NativeRegisterContextLinux::ReadFPR()
 {
+    if (m_fpr_valid)
+        return Error();
+
     void* buf = GetFPRBuffer();
     if (!buf)
         return Error("FPR buffer is NULL");
     size_t buf_size = GetFPRSize();
 
-    return DoReadFPR(buf, buf_size);
+    Error error = DoReadFPR(buf, buf_size);
+    m_fpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -150,7 +175,9 @@ NativeRegisterContextLinux::WriteFPR()
         return Error("FPR buffer is NULL");
     size_t buf_size = GetFPRSize();
 
-    return DoWriteFPR(buf, buf_size);
+    Error error = DoWriteFPR(buf, buf_size);
+    m_fpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -34,6 +34,11 @@ public:
                                          NativeThreadProtocol &native_thread,
                                          uint32_t concrete_frame_idx);
 
+    // The GPR and FPR buffers are read once per stop. Call this when the
+    // thread is resumed.
+    virtual void
+    InvalidateAllRegisters();
+
 protected:
     lldb::ByteOrder
     GetByteOrder() const;
@@ -99,6 +104,9 @@ protected:
 
     virtual Error
     DoWriteFPR(void *buf, size_t buf_size);
+
+    bool m_gpr_valid; // GetGPRBuffer() holds the thread's registers
+    bool m_fpr_valid; // GetFPRBuffer() holds the thread's registers
 };
 
 } // namespace process_linux
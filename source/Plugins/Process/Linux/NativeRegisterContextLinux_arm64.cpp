@@ -248,7 +248,19 @@ NativeRegisterContextLinux_arm64::ReadRegister (const RegisterInfo *reg_info, Re
             full_reg = reg_info->invalidate_regs[0];
         }
 
-        error = ReadRegisterRaw(full_reg, reg_value);
+        // Take the register from the GPR set read once per stop.
+        const RegisterInfo *full_reg_info = GetRegisterInfoAtIndex(full_reg);
+        if (!full_reg_info)
+            return Error("register %" PRIu32 " not found", full_reg);
+        error = ReadGPR();
+        if (error.Fail())
+            return error;
+        assert (full_reg_info->byte_offset + full_reg_info->byte_size <= GetGPRSize());
+        const uint8_t *src = (const uint8_t *)&m_gpr_arm64 + full_reg_info->byte_offset;
+        if (full_reg_info->byte_size == 8)
+            reg_value.SetUInt64(*(const uint64_t *)src);
+        else
+            reg_value.SetUInt32(*(const uint32_t *)src);
 
         if (error.Success ())
         {
@@ -284,10 +296,36 @@ NativeRegisterContextLinux_arm64::WriteRegister (const RegisterInfo *reg_info, c
         return Error ("no lldb regnum for %s", reg_info && reg_info->name ? reg_info->name : "<unknown register>");
 
     if (IsGPR(reg_index))
-        return WriteRegisterRaw(reg_index, reg_value);
+    {
+        // Update the register in the GPR set and write the set back.
+        Error error = ReadGPR();
+        if (error.Fail())
+            return error;
+
+        assert (reg_info->byte_offset + reg_info->byte_size <= GetGPRSize());
+        uint8_t *dst = (uint8_t *)&m_gpr_arm64 + reg_info->byte_offset;
+        switch (reg_info->byte_size)
+        {
+            case 4:
+                *(uint32_t *)dst = reg_value.GetAsUInt32();
+                break;
+            case 8:
+                *(uint64_t *)dst = reg_value.GetAsUInt64();
+                break;
+            default:
+                assert(false && "Unhandled data size.");
+                return Error ("unhandled register data size %" PRIu32, reg_info->byte_size);
+        }
+        return WriteGPR();
+    }
 
     if (IsFPR(reg_index))
     {
+        // Only one register changes, the others are written back as they are.
+        Error error = ReadFPR();
+        if (error.Fail())
+            return error;
+
         // Get pointer to m_fpr variable and set the data to it.
         uint32_t fpr_offset = CalculateFprOffset(reg_info);
         assert (fpr_offset < sizeof m_fpr);
@@ -308,7 +346,7 @@ NativeRegisterContextLinux_arm64::WriteRegister (const RegisterInfo *reg_info, c
                 return Error ("unhandled register data size %" PRIu32, reg_info->byte_size);
         }
 
-        Error error = WriteFPR();
+        error = WriteFPR();
         if (error.Fail())
             return error;
 
@@ -549,24 +587,10 @@ NativeRegisterContextLinux_arm64::NumSupportedHardwareWatchpoints ()
     return m_max_hwp_supported;
 }
 
-uint32_t
-NativeRegisterContextLinux_arm64::SetHardwareWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags)
+// Returns false if the hardware can't watch this range and access.
+static bool
+GetWatchpointControlValue (lldb::addr_t addr, size_t size, uint32_t watch_flags, uint32_t &control_value)
 {
-    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_WATCHPOINTS));
-
-    if (log)
-        log->Printf ("NativeRegisterContextLinux_arm64::%s()", __FUNCTION__);
-    
-    Error error;
-
-    // Read hardware breakpoint and watchpoint information.
-    error = ReadHardwareDebugInfo ();
-
-    if (error.Fail())
-        return LLDB_INVALID_INDEX32;
-		
-    uint32_t control_value = 0, wp_index = 0;
-
     // Check if we are setting watchpoint other than read/write/access
     // Also update watchpoint flag to match AArch64 write-read bit configuration.
     switch (watch_flags)
@@ -580,22 +604,45 @@ NativeRegisterContextLinux_arm64::SetHardwareWatchpoint (lldb::addr_t addr, size
         case 3:
             break;
         default:
-            return LLDB_INVALID_INDEX32;
+            return false;
     }
 
     // Check if size has a valid hardware watchpoint length.
     if (size != 1 && size != 2 && size != 4 && size != 8)
-        return LLDB_INVALID_INDEX32;
+        return false;
 
     // Check 8-byte alignment for hardware watchpoint target address.
     // TODO: Add support for watching un-aligned addresses
     if (addr & 0x07)
-        return LLDB_INVALID_INDEX32;
+        return false;
 
     // Setup control value
     control_value = watch_flags << 3;
     control_value |= ((1 << size) - 1) << 5;
     control_value |= (2 << 1) | 1;
+    return true;
+}
+
+uint32_t
+NativeRegisterContextLinux_arm64::SetHardwareWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_WATCHPOINTS));
+
+    if (log)
+        log->Printf ("NativeRegisterContextLinux_arm64::%s()", __FUNCTION__);
+    
+    Error error;
+
+    // Read hardware breakpoint and watchpoint information.
+    error = ReadHardwareDebugInfo ();
+
+    if (error.Fail())
+        return LLDB_INVALID_INDEX32;
+		
+    uint32_t control_value = 0, wp_index = 0;
+
+    if (!GetWatchpointControlValue (addr, size, watch_flags, control_value))
+        return LLDB_INVALID_INDEX32;
 
     // Iterate over stored watchpoints
     // Find a free wp_index or update reference count if duplicate.
@@ -747,6 +794,111 @@ NativeRegisterContextLinux_arm64::ClearAllHardwareWatchpoints ()
     return Error();
 }
 
+Error
+NativeRegisterContextLinux_arm64::SetHardwareWatchpoints (const std::vector<NativeWatchpoint> &watchpoints, std::vector<uint32_t> &wp_indexes)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_WATCHPOINTS));
+
+    if (log)
+        log->Printf ("NativeRegisterContextLinux_arm64::%s() %" PRIu64 " watchpoints", __FUNCTION__, (uint64_t)watchpoints.size());
+
+    wp_indexes.assign (watchpoints.size(), LLDB_INVALID_INDEX32);
+
+    // Read hardware breakpoint and watchpoint information.
+    Error error = ReadHardwareDebugInfo ();
+
+    if (error.Fail())
+        return error;
+
+    if (watchpoints.size() > m_max_hwp_supported)
+        return Error ("not enough hardware watchpoints for %" PRIu64 " watchpoints", (uint64_t)watchpoints.size());
+
+    std::vector<uint32_t> control_values (watchpoints.size());
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        if (!GetWatchpointControlValue (watchpoints[i].m_addr, watchpoints[i].m_size, watchpoints[i].m_watch_flags, control_values[i]))
+            return Error ("can't watch %" PRIu64 " bytes at 0x%" PRIx64, (uint64_t)watchpoints[i].m_size, watchpoints[i].m_addr);
+    }
+
+    // All of the watchpoint registers are written with one PTRACE_SETREGSET.
+    // The watchpoints the thread already has keep their index, so nothing is
+    // written when nothing changed.
+    struct DREG new_regs[16];
+    ::memcpy (new_regs, m_hwp_regs, sizeof (new_regs));
+    bool used[16] = { false };
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        for (uint32_t wp_index = 0; wp_index < m_max_hwp_supported; wp_index++)
+        {
+            if (!used[wp_index] && (m_hwp_regs[wp_index].control & 1) &&
+                m_hwp_regs[wp_index].address == watchpoints[i].m_addr &&
+                m_hwp_regs[wp_index].control == control_values[i])
+            {
+                used[wp_index] = true;
+                wp_indexes[i] = wp_index;
+                new_regs[wp_index].refcount = 1;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        if (wp_indexes[i] != LLDB_INVALID_INDEX32)
+            continue;
+        // Prefer the registers that aren't in use.
+        for (uint32_t n = 0; n < 2 * m_max_hwp_supported; n++)
+        {
+            const uint32_t wp_index = n % m_max_hwp_supported;
+            if (!used[wp_index] && (n >= m_max_hwp_supported || (m_hwp_regs[wp_index].control & 1) == 0))
+            {
+                used[wp_index] = true;
+                wp_indexes[i] = wp_index;
+                new_regs[wp_index].address = watchpoints[i].m_addr;
+                new_regs[wp_index].control = control_values[i];
+                new_regs[wp_index].refcount = 1;
+                break;
+            }
+        }
+    }
+
+    bool changed = false;
+    for (uint32_t wp_index = 0; wp_index < m_max_hwp_supported; wp_index++)
+    {
+        if (!used[wp_index] && (new_regs[wp_index].control & 1))
+        {
+            new_regs[wp_index].control &= ~1;
+            new_regs[wp_index].address = 0;
+            new_regs[wp_index].refcount = 0;
+        }
+        if (new_regs[wp_index].address != m_hwp_regs[wp_index].address ||
+            new_regs[wp_index].control != m_hwp_regs[wp_index].control)
+            changed = true;
+    }
+
+    // Reference counts of watchpoints that are already set aren't kept
+    // in the registers.
+    if (!changed)
+    {
+        ::memcpy (m_hwp_regs, new_regs, sizeof (new_regs));
+        return error;
+    }
+
+    // Create a backup we can revert to in case of failure.
+    struct DREG old_regs[16];
+    ::memcpy (old_regs, m_hwp_regs, sizeof (old_regs));
+    ::memcpy (m_hwp_regs, new_regs, sizeof (new_regs));
+
+    // Ptrace call to update hardware debug registers
+    error = WriteHardwareDebugRegs(eDREGTypeWATCH);
+
+    if (error.Fail())
+    {
+        ::memcpy (m_hwp_regs, old_regs, sizeof (old_regs));
+        wp_indexes.assign (watchpoints.size(), LLDB_INVALID_INDEX32);
+    }
+    return error;
+}
+
 uint32_t
 NativeRegisterContextLinux_arm64::GetWatchpointSize(uint32_t wp_index)
 {
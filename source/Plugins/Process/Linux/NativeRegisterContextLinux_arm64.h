@@ -70,6 +70,9 @@ namespace process_linux {
         Error
         ClearAllHardwareWatchpoints () override;
 
+        Error
+        SetHardwareWatchpoints (const std::vector<NativeWatchpoint> &watchpoints, std::vector<uint32_t> &wp_indexes) override;
+
         Error
         GetWatchpointHitIndex(uint32_t &wp_index, lldb::addr_t trap_addr) override;
 
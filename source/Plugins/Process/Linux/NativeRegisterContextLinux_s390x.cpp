@@ -177,6 +177,9 @@ NativeRegisterContextLinux_s390x::NativeRegisterContextLinux_s390x(const ArchSpe
 
     // Clear out the watchpoint state.
     m_watchpoint_addr = LLDB_INVALID_ADDRESS;
+
+    ::memset(&m_regs, 0, sizeof(m_regs));
+    ::memset(&m_fp_regs, 0, sizeof(m_fp_regs));
 }
 
 uint32_t
@@ -254,13 +257,12 @@ NativeRegisterContextLinux_s390x::ReadRegister(const RegisterInfo *reg_info, Reg
 
     if (IsGPR(reg))
     {
-        s390_regs regs;
-        Error error = DoReadGPR(&regs, sizeof(regs));
+        Error error = ReadGPR();
         if (error.Fail())
             return error;
 
-        uint8_t *src = (uint8_t *)&regs + reg_info->byte_offset;
-        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(regs));
+        uint8_t *src = (uint8_t *)&m_regs + reg_info->byte_offset;
+        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(m_regs));
         switch (reg_info->byte_size)
         {
             case 4:
@@ -278,14 +280,13 @@ NativeRegisterContextLinux_s390x::ReadRegister(const RegisterInfo *reg_info, Reg
 
     if (IsFPR(reg))
     {
-        s390_fp_regs fp_regs;
-        Error error = DoReadFPR(&fp_regs, sizeof(fp_regs));
+        Error error = ReadFPR();
         if (error.Fail())
             return error;
 
         // byte_offset is just the offset within FPR, not the whole user area.
-        uint8_t *src = (uint8_t *)&fp_regs + reg_info->byte_offset;
-        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(fp_regs));
+        uint8_t *src = (uint8_t *)&m_fp_regs + reg_info->byte_offset;
+        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(m_fp_regs));
         switch (reg_info->byte_size)
         {
             case 4:
@@ -338,13 +339,12 @@ NativeRegisterContextLinux_s390x::WriteRegister(const RegisterInfo *reg_info, co
 
     if (IsGPR(reg))
     {
-        s390_regs regs;
-        Error error = DoReadGPR(&regs, sizeof(regs));
+        Error error = ReadGPR();
         if (error.Fail())
             return error;
 
-        uint8_t *dst = (uint8_t *)&regs + reg_info->byte_offset;
-        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(regs));
+        uint8_t *dst = (uint8_t *)&m_regs + reg_info->byte_offset;
+        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(m_regs));
         switch (reg_info->byte_size)
         {
             case 4:
@@ -357,19 +357,18 @@ NativeRegisterContextLinux_s390x::WriteRegister(const RegisterInfo *reg_info, co
                 assert(false && "Unhandled data size.");
                 return Error("unhandled byte size: %" PRIu32, reg_info->byte_size);
         }
-        return DoWriteGPR(&regs, sizeof(regs));
+        return WriteGPR();
     }
 
     if (IsFPR(reg))
     {
-        s390_fp_regs fp_regs;
-        Error error = DoReadFPR(&fp_regs, sizeof(fp_regs));
+        Error error = ReadFPR();
         if (error.Fail())
             return error;
 
         // byte_offset is just the offset within fp_regs, not the whole user area.
-        uint8_t *dst = (uint8_t *)&fp_regs + reg_info->byte_offset;
-        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(fp_regs));
+        uint8_t *dst = (uint8_t *)&m_fp_regs + reg_info->byte_offset;
+        assert(reg_info->byte_offset + reg_info->byte_size <= sizeof(m_fp_regs));
         switch (reg_info->byte_size)
         {
             case 4:
@@ -382,7 +381,7 @@ NativeRegisterContextLinux_s390x::WriteRegister(const RegisterInfo *reg_info, co
                 assert(false && "Unhandled data size.");
                 return Error("unhandled byte size: %" PRIu32, reg_info->byte_size);
         }
-        return DoWriteFPR(&fp_regs, sizeof(fp_regs));
+        return WriteFPR();
     }
 
     if (reg == lldb_last_break_s390x)
@@ -419,15 +418,17 @@ NativeRegisterContextLinux_s390x::ReadAllRegisterValues(lldb::DataBufferSP &data
         return error;
     }
 
-    error = DoReadGPR(dst, sizeof(s390_regs));
-    dst += sizeof(s390_regs);
+    error = ReadGPR();
     if (error.Fail())
         return error;
+    ::memcpy(dst, &m_regs, sizeof(s390_regs));
+    dst += sizeof(s390_regs);
 
-    error = DoReadFPR(dst, sizeof(s390_fp_regs));
-    dst += sizeof(s390_fp_regs);
+    error = ReadFPR();
     if (error.Fail())
         return error;
+    ::memcpy(dst, &m_fp_regs, sizeof(s390_fp_regs));
+    dst += sizeof(s390_fp_regs);
 
     // Ignore errors if the regset is unsupported (happens on older kernels).
     DoReadRegisterSet(NT_S390_SYSTEM_CALL, dst, 4);
@@ -471,12 +472,14 @@ NativeRegisterContextLinux_s390x::WriteAllRegisterValues(const lldb::DataBufferS
         return error;
     }
 
-    error = DoWriteGPR(src, sizeof(s390_regs));
+    ::memcpy(&m_regs, src, sizeof(s390_regs));
+    error = WriteGPR();
     src += sizeof(s390_regs);
     if (error.Fail())
         return error;
 
-    error = DoWriteFPR(src, sizeof(s390_fp_regs));
+    ::memcpy(&m_fp_regs, src, sizeof(s390_fp_regs));
+    error = WriteFPR();
     src += sizeof(s390_fp_regs);
     if (error.Fail())
         return error;
@@ -12,6 +12,8 @@
 #ifndef lldb_NativeRegisterContextLinux_s390x_h
 #define lldb_NativeRegisterContextLinux_s390x_h
 
+#include <asm/ptrace.h>
+
 #include "Plugins/Process/Linux/NativeRegisterContextLinux.h"
 #include "Plugins/Process/Utility/RegisterContext_s390x.h"
 #include "Plugins/Process/Utility/lldb-s390x-register-enums.h"
@@ -93,6 +95,18 @@ protected:
     Error
     DoWriteFPR(void *buf, size_t buf_size) override;
 
+    void *
+    GetGPRBuffer() override { return &m_regs; }
+
+    size_t
+    GetGPRSize() override { return sizeof(m_regs); }
+
+    void *
+    GetFPRBuffer() override { return &m_fp_regs; }
+
+    size_t
+    GetFPRSize() override { return sizeof(m_fp_regs); }
+
 private:
     // Info about register ranges.
     struct RegInfo
@@ -109,6 +123,8 @@ private:
     // Private member variables.
     RegInfo m_reg_info;
     lldb::addr_t m_watchpoint_addr;
+    s390_regs m_regs;
+    s390_fp_regs m_fp_regs;
 
     // Private member methods.
     bool
@@ -515,7 +515,24 @@ NativeRegisterContextLinux_x86_64::ReadRegister (const RegisterInfo *reg_info, R
             full_reg = reg_info->invalidate_regs[0];
         }
 
-        error = ReadRegisterRaw(full_reg, reg_value);
+        // General purpose registers come from the register set we read once
+        // per stop, the others (debug registers) are peeked one at a time.
+        const RegisterInfo *full_reg_info = GetRegisterInfoAtIndex(full_reg);
+        if (IsGPR(full_reg) && full_reg_info &&
+            full_reg_info->byte_offset + full_reg_info->byte_size <= GetGPRSize())
+        {
+            error = ReadGPR();
+            if (error.Fail())
+                return error;
+
+            const uint8_t *src = (const uint8_t *)&m_gpr_x86_64 + full_reg_info->byte_offset;
+            if (full_reg_info->byte_size == 8)
+                reg_value.SetUInt64(*(const uint64_t *)src);
+            else
+                reg_value.SetUInt32(*(const uint32_t *)src);
+        }
+        else
+            error = ReadRegisterRaw(full_reg, reg_value);
 
         if (error.Success ())
         {
@@ -613,6 +630,11 @@ NativeRegisterContextLinux_x86_64::WriteRegister (const RegisterInfo *reg_info,
 
     if (IsFPR(reg_index, GetFPRType()))
     {
+        // Only one register changes, the others are written back as they are.
+        Error error = ReadFPR();
+        if (error.Fail())
+            return error;
+
         if (reg_info->encoding == lldb::eEncodingVector)
         {
             if (reg_index >= m_reg_info.first_st && reg_index <= m_reg_info.last_st)
@@ -668,7 +690,7 @@ NativeRegisterContextLinux_x86_64::WriteRegister (const RegisterInfo *reg_info,
             }
         }
 
-        Error error = WriteFPR();
+        error = WriteFPR();
         if (error.Fail())
             return error;
 
@@ -877,6 +899,7 @@ NativeRegisterContextLinux_x86_64::IsFPR(uint32_t reg_index, FPRType fpr_type) c
 Error
 NativeRegisterContextLinux_x86_64::WriteFPR()
 {
+    Error error;
     const FPRType fpr_type = GetFPRType ();
     const lldb_private::ArchSpec& target_arch = GetRegisterInfoInterface().GetTargetArchitecture();
     switch (fpr_type)
@@ -889,18 +912,24 @@ NativeRegisterContextLinux_x86_64::WriteFPR()
         switch (target_arch.GetMachine ())
         {
             case llvm::Triple::x86:
-                return WriteRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_PRXFPREG);
+                error = WriteRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_PRXFPREG);
+                break;
             case llvm::Triple::x86_64:
                 return NativeRegisterContextLinux::WriteFPR();
             default:
                 assert(false && "Unhandled target architecture.");
-                break;
+                return Error("Unhandled target architecture");
         }
+        break;
     case FPRType::eFPRTypeXSAVE:
-        return WriteRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
+        error = WriteRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
+        break;
     default:
         return Error("Unrecognized FPR type");
     }
+
+    m_fpr_valid = error.Success();
+    return error;
 }
 
 bool
@@ -1003,6 +1032,11 @@ NativeRegisterContextLinux_x86_64::GetFPRSize()
 Error
 NativeRegisterContextLinux_x86_64::ReadFPR ()
 {
+    // The whole FXSAVE/XSAVE area is read once per stop.
+    if (m_fpr_valid)
+        return Error();
+
+    Error error;
     const FPRType fpr_type = GetFPRType ();
     const lldb_private::ArchSpec& target_arch = GetRegisterInfoInterface().GetTargetArchitecture();
     switch (fpr_type)
@@ -1015,18 +1049,24 @@ NativeRegisterContextLinux_x86_64::ReadFPR ()
         switch (target_arch.GetMachine ())
         {
             case llvm::Triple::x86:
-                return ReadRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_PRXFPREG);
+                error = ReadRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_PRXFPREG);
+                break;
             case llvm::Triple::x86_64:
                 return NativeRegisterContextLinux::ReadFPR();
             default:
                 assert(false && "Unhandled target architecture.");
-                break;
+                return Error("Unhandled target architecture");
         }
+        break;
     case FPRType::eFPRTypeXSAVE:
-        return ReadRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
+        error = ReadRegisterSet(&m_iovec, sizeof(m_fpr.xstate.xsave), NT_X86_XSTATE);
+        break;
     default:
         return Error("Unrecognized FPR type");
     }
+
+    m_fpr_valid = error.Success();
+    return error;
 }
 
 Error
@@ -1089,13 +1129,11 @@ NativeRegisterContextLinux_x86_64::IsWatchpointVacant(uint32_t wp_index, bool &i
     return error;
 }
 
-Error
-NativeRegisterContextLinux_x86_64::SetHardwareWatchpointWithIndex(
-        lldb::addr_t addr, size_t size, uint32_t watch_flags, uint32_t wp_index) {
-
-    if (wp_index >= NumSupportedHardwareWatchpoints())
-        return Error ("Watchpoint index out of range");
-
+// Returns the 4 bits of the debug control register (DR7) for a watchpoint,
+// the access type in the low 2 bits and the length in the high 2 bits.
+static Error
+GetWatchpointControlBits(size_t size, uint32_t watch_flags, uint64_t &control_bits)
+{
     // Read only watchpoints aren't supported on x86_64. Fall back to read/write waitchpoints instead.
     // TODO: Add logic to detect when a write happens and ignore that watchpoint hit.
     if (watch_flags == 0x2)
@@ -1107,8 +1145,25 @@ NativeRegisterContextLinux_x86_64::SetHardwareWatchpointWithIndex(
     if (size != 1 && size != 2 && size != 4 && size != 8)
         return Error ("Invalid size for watchpoint");
 
+    // 0b01 for write, and 0b11 for read/write, then
+    // 0b00, 0b01, 0b10, or 0b11 for 1, 2, 8 (if supported), or 4 bytes
+    control_bits = watch_flags | ((size == 8 ? 0x2 : size - 1) << 2);
+    return Error();
+}
+
+Error
+NativeRegisterContextLinux_x86_64::SetHardwareWatchpointWithIndex(
+        lldb::addr_t addr, size_t size, uint32_t watch_flags, uint32_t wp_index) {
+
+    if (wp_index >= NumSupportedHardwareWatchpoints())
+        return Error ("Watchpoint index out of range");
+
+    uint64_t wp_control_bits;
+    Error error = GetWatchpointControlBits(size, watch_flags, wp_control_bits);
+    if (error.Fail()) return error;
+
     bool is_vacant;
-    Error error = IsWatchpointVacant (wp_index, is_vacant);
+    error = IsWatchpointVacant (wp_index, is_vacant);
     if (error.Fail()) return error;
     if (!is_vacant) return Error("Watchpoint index not vacant");
 
@@ -1120,20 +1175,15 @@ NativeRegisterContextLinux_x86_64::SetHardwareWatchpointWithIndex(
     // set bits 1, 3, 5, or 7
     uint64_t enable_bit = 1 << (2 * wp_index);
 
-    // set bits 16-17, 20-21, 24-25, or 28-29
-    // with 0b01 for write, and 0b11 for read/write
-    uint64_t rw_bits = watch_flags << (16 + 4 * wp_index);
-
-    // set bits 18-19, 22-23, 26-27, or 30-31
-    // with 0b00, 0b01, 0b10, or 0b11
-    // for 1, 2, 8 (if supported), or 4 bytes, respectively
-    uint64_t size_bits = (size == 8 ? 0x2 : size - 1) << (18 + 4 * wp_index);
+    // set bits 16-19, 20-23, 24-27, or 28-31
+    // with the access type and the length
+    uint64_t rw_size_bits = wp_control_bits << (16 + 4 * wp_index);
 
     uint64_t bit_mask = (0x3 << (2 * wp_index)) | (0xF << (16 + 4 * wp_index));
 
     uint64_t control_bits = reg_value.GetAsUInt64() & ~bit_mask;
 
-    control_bits |= enable_bit | rw_bits | size_bits;
+    control_bits |= enable_bit | rw_size_bits;
 
     error = WriteRegisterRaw(m_reg_info.first_dr + wp_index, RegisterValue(addr));
     if (error.Fail()) return error;
@@ -1218,6 +1268,145 @@ NativeRegisterContextLinux_x86_64::SetHardwareWatchpoint(
     return LLDB_INVALID_INDEX32;
 }
 
+Error
+NativeRegisterContextLinux_x86_64::SetHardwareWatchpoints(
+        const std::vector<NativeWatchpoint> &watchpoints, std::vector<uint32_t> &wp_indexes)
+{
+    const uint32_t num_hw_watchpoints = NumSupportedHardwareWatchpoints();
+    wp_indexes.assign(watchpoints.size(), LLDB_INVALID_INDEX32);
+    if (watchpoints.size() > num_hw_watchpoints)
+        return Error ("Not enough debug registers for %" PRIu64 " watchpoints", (uint64_t)watchpoints.size());
+
+    std::vector<uint64_t> wp_control_bits(watchpoints.size());
+    Error error;
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        error = GetWatchpointControlBits(watchpoints[i].m_size, watchpoints[i].m_watch_flags, wp_control_bits[i]);
+        if (error.Fail()) return error;
+    }
+
+    // Every write of a debug register goes through the kernel's breakpoint
+    // code, so only the registers that change are written. The watchpoints
+    // the thread has already keep their index.
+    RegisterValue reg_value;
+    error = ReadRegisterRaw(m_reg_info.first_dr + 7, reg_value);
+    if (error.Fail()) return error;
+    const uint64_t old_control_bits = reg_value.GetAsUInt64();
+
+    lldb::addr_t old_addrs[4] = { 0, 0, 0, 0 };
+    bool old_enabled[4] = { false, false, false, false };
+    for (uint32_t wp_index = 0; wp_index < num_hw_watchpoints; ++wp_index)
+    {
+        old_enabled[wp_index] = old_control_bits & (1 << (2 * wp_index));
+        if (!old_enabled[wp_index])
+            continue;
+        error = ReadRegisterRaw(m_reg_info.first_dr + wp_index, reg_value);
+        if (error.Fail()) return error;
+        old_addrs[wp_index] = reg_value.GetAsUInt64();
+    }
+
+    uint32_t slot_wps[4] = { LLDB_INVALID_INDEX32, LLDB_INVALID_INDEX32, LLDB_INVALID_INDEX32, LLDB_INVALID_INDEX32 };
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        for (uint32_t wp_index = 0; wp_index < num_hw_watchpoints; ++wp_index)
+        {
+            if (old_enabled[wp_index] && slot_wps[wp_index] == LLDB_INVALID_INDEX32 &&
+                old_addrs[wp_index] == watchpoints[i].m_addr &&
+                ((old_control_bits >> (16 + 4 * wp_index)) & 0xF) == wp_control_bits[i])
+            {
+                slot_wps[wp_index] = i;
+                wp_indexes[i] = wp_index;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+    {
+        if (wp_indexes[i] != LLDB_INVALID_INDEX32)
+            continue;
+        // Prefer the debug registers that aren't in use.
+        for (uint32_t wp_index = 0; wp_index < 2 * num_hw_watchpoints; ++wp_index)
+        {
+            const uint32_t slot = wp_index % num_hw_watchpoints;
+            if (slot_wps[slot] == LLDB_INVALID_INDEX32 && (wp_index >= num_hw_watchpoints || !old_enabled[slot]))
+            {
+                slot_wps[slot] = i;
+                wp_indexes[i] = slot;
+                break;
+            }
+        }
+    }
+
+    // for watchpoints 0, 1, 2, or 3, respectively,
+    // bits {0-1,16-19}, {2-3,20-23}, {4-5,24-27}, or {6-7,28-31}
+    // of the debug control register (DR7)
+    uint64_t new_control_bits = old_control_bits & ~(0xFFULL | (0xFFFFULL << 16));
+    uint64_t control_bits = old_control_bits;
+    uint64_t changed_status_bits = 0;
+    for (uint32_t wp_index = 0; wp_index < num_hw_watchpoints; ++wp_index)
+    {
+        const uint64_t bit_mask = (0x3ULL << (2 * wp_index)) | (0xFULL << (16 + 4 * wp_index));
+        const uint32_t i = slot_wps[wp_index];
+        if (i == LLDB_INVALID_INDEX32)
+        {
+            if (old_enabled[wp_index])
+                changed_status_bits |= 1 << wp_index;
+            continue;
+        }
+
+        new_control_bits |= (1ULL << (2 * wp_index)) | (wp_control_bits[i] << (16 + 4 * wp_index));
+        if ((old_control_bits & bit_mask) != (new_control_bits & bit_mask) || old_addrs[wp_index] != watchpoints[i].m_addr)
+            changed_status_bits |= 1 << wp_index;
+        // An enabled watchpoint has to be disabled before its address
+        // changes, the kernel checks the address against the length.
+        if (old_enabled[wp_index] && old_addrs[wp_index] != watchpoints[i].m_addr)
+            control_bits &= ~bit_mask;
+    }
+
+    if (control_bits != old_control_bits)
+    {
+        error = WriteRegisterRaw(m_reg_info.first_dr + 7, RegisterValue(control_bits));
+        if (error.Fail()) return error;
+    }
+
+    for (uint32_t wp_index = 0; wp_index < num_hw_watchpoints; ++wp_index)
+    {
+        const uint32_t i = slot_wps[wp_index];
+        if (i == LLDB_INVALID_INDEX32)
+            continue;
+        lldb::addr_t addr = old_addrs[wp_index];
+        if (!old_enabled[wp_index])
+        {
+            // A disabled register may still hold the address.
+            error = ReadRegisterRaw(m_reg_info.first_dr + wp_index, reg_value);
+            if (error.Fail()) return error;
+            addr = reg_value.GetAsUInt64();
+        }
+        if (addr == watchpoints[i].m_addr)
+            continue;
+        error = WriteRegisterRaw(m_reg_info.first_dr + wp_index, RegisterValue(watchpoints[i].m_addr));
+        if (error.Fail()) return error;
+    }
+
+    // Hits of the watchpoints that were in the changed registers before
+    // are cleared from the debug status register (DR6).
+    if (changed_status_bits)
+    {
+        error = ReadRegisterRaw(m_reg_info.first_dr + 6, reg_value);
+        if (error.Fail()) return error;
+        const uint64_t status_bits = reg_value.GetAsUInt64();
+        if (status_bits & changed_status_bits)
+        {
+            error = WriteRegisterRaw(m_reg_info.first_dr + 6, RegisterValue(status_bits & ~changed_status_bits));
+            if (error.Fail()) return error;
+        }
+    }
+
+    if (new_control_bits != control_bits)
+        error = WriteRegisterRaw(m_reg_info.first_dr + 7, RegisterValue(new_control_bits));
+    return error;
+}
+
 lldb::addr_t
 NativeRegisterContextLinux_x86_64::GetWatchpointAddress(uint32_t wp_index)
 {
@@ -72,6 +72,10 @@ namespace process_linux {
         SetHardwareWatchpoint(lldb::addr_t addr, size_t size,
                 uint32_t watch_flags) override;
 
+        Error
+        SetHardwareWatchpoints(const std::vector<NativeWatchpoint> &watchpoints,
+                std::vector<uint32_t> &wp_indexes) override;
+
         lldb::addr_t
         GetWatchpointAddress(uint32_t wp_index) override;
 
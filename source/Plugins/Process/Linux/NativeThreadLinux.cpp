@@ -83,7 +83,9 @@ NativeThreadLinux::NativeThreadLinux (NativeProcessLinux *process, lldb::tid_t t
     m_state (StateType::eStateInvalid),
     m_stop_info (),
     m_reg_context_sp (),
-    m_stop_description ()
+    m_stop_description (),
+    m_watchpoint_index_map (),
+    m_hardware_watchpoints_generation (0)
 {
 }
 
@@ -201,6 +203,41 @@ NativeThreadLinux::RemoveWatchpoint (lldb::addr_t addr)
     return Error ("Clearing hardware watchpoint failed.");
 }
 
+Error
+NativeThreadLinux::SetHardwareWatchpoints (const std::vector<NativeWatchpoint> &watchpoints, uint32_t generation)
+{
+    std::vector<uint32_t> wp_indexes;
+    Error error = GetRegisterContext()->SetHardwareWatchpoints(watchpoints, wp_indexes);
+    if (error.Fail())
+        return error;
+
+    m_watchpoint_index_map.clear();
+    for (size_t i = 0; i < watchpoints.size(); ++i)
+        m_watchpoint_index_map.insert({watchpoints[i].m_addr, wp_indexes[i]});
+    m_hardware_watchpoints_generation = generation;
+    return error;
+}
+
+void
+NativeThreadLinux::MaybeUpdateHardwareWatchpoints ()
+{
+    NativeProcessLinux &process = GetProcess();
+    const uint32_t generation = process.GetHardwareWatchpointsGeneration();
+    if (m_hardware_watchpoints_generation == generation)
+        return;
+
+    Error error = SetHardwareWatchpoints(process.GetHardwareWatchpoints(), generation);
+    if (error.Fail())
+    {
+        Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_WATCHPOINTS));
+        if (log)
+            log->Printf ("NativeThreadLinux::%s tid %" PRIu64 " failed to set the hardware watchpoints: %s",
+                         __FUNCTION__, GetID (), error.AsCString ());
+        // Don't retry on every resume.
+        m_hardware_watchpoints_generation = generation;
+    }
+}
+
 Error
 NativeThreadLinux::Resume(uint32_t signo)
 {
@@ -210,21 +247,11 @@ NativeThreadLinux::Resume(uint32_t signo)
 
     m_stop_info.reason = StopReason::eStopReasonNone;
     m_stop_description.clear();
+    InvalidateRegisterCache();
 
-    // If watchpoints have been set, but none on this thread,
-    // then this is a new thread. So set all existing watchpoints.
-    if (m_watchpoint_index_map.empty())
-    {
-        NativeProcessLinux &process = GetProcess();
-
-        const auto &watchpoint_map = process.GetWatchpointMap();
-        GetRegisterContext()->ClearAllHardwareWatchpoints();
-        for (const auto &pair : watchpoint_map)
-        {
-            const auto &wp = pair.second;
-            SetWatchpoint(wp.m_addr, wp.m_size, wp.m_watch_flags, wp.m_hardware);
-        }
-    }
+    // New threads and the ones that weren't stopped when the watchpoints
+    // changed get them now.
+    MaybeUpdateHardwareWatchpoints();
 
     intptr_t data = 0;
 
@@ -234,6 +261,13 @@ NativeThreadLinux::Resume(uint32_t signo)
     return NativeProcessLinux::PtraceWrapper(PTRACE_CONT, GetID(), nullptr, reinterpret_cast<void *>(data));
 }
 
+void
+NativeThreadLinux::InvalidateRegisterCache()
+{
+    if (m_reg_context_sp)
+        std::static_pointer_cast<NativeRegisterContextLinux>(m_reg_context_sp)->InvalidateAllRegisters();
+}
+
 void
 NativeThreadLinux::MaybePrepareSingleStepWorkaround()
 {
@@ -289,7 +323,9 @@ NativeThreadLinux::SingleStep(uint32_t signo)
     MaybeLogStateChange (new_state);
     m_state = new_state;
     m_stop_info.reason = StopReason::eStopReasonNone;
+    InvalidateRegisterCache();
 
+    MaybeUpdateHardwareWatchpoints();
     MaybePrepareSingleStepWorkaround();
 
     intptr_t data = 0;
@@ -413,6 +449,20 @@ NativeThreadLinux::SetStoppedByWatchpoint (uint32_t wp_index)
     m_stop_info.details.signal.signo = SIGTRAP;
 }
 
+void
+NativeThreadLinux::SetStoppedBySoftwareWatchpoint (lldb::addr_t wp_addr)
+{
+    SetStopped();
+
+    // Same format as above, the client finds the watchpoint by its address.
+    std::ostringstream ostr;
+    ostr << wp_addr << " " << LLDB_INVALID_INDEX32 << " " << LLDB_INVALID_ADDRESS;
+    m_stop_description = ostr.str();
+
+    m_stop_info.reason = StopReason::eStopReasonWatchpoint;
+    m_stop_info.details.signal.signo = SIGTRAP;
+}
+
 bool
 NativeThreadLinux::IsStoppedAtBreakpoint ()
 {
@@ -468,6 +518,16 @@ NativeThreadLinux::RequestStop ()
     if (log)
         log->Printf ("NativeThreadLinux::%s requesting thread stop(pid: %" PRIu64 ", tid: %" PRIu64 ")", __FUNCTION__, pid, tid);
 
+    // A seized thread stops with a PTRACE_EVENT_STOP, without a signal
+    // that would have to be told apart from one sent by somebody else.
+    if (process.IsSeized())
+    {
+        Error err = NativeProcessLinux::PtraceWrapper(PTRACE_INTERRUPT, tid);
+        if (err.Fail() && log)
+            log->Printf ("NativeThreadLinux::%s PTRACE_INTERRUPT(%" PRIu64 ") failed: %s", __FUNCTION__, tid, err.AsCString ());
+        return err;
+    }
+
     Error err;
     errno = 0;
     if (::tgkill (pid, tid, SIGSTOP) != 0)
@@ -12,12 +12,14 @@
 
 #include "lldb/lldb-private-forward.h"
 #include "lldb/Host/common/NativeThreadProtocol.h"
+#include "lldb/Host/common/NativeWatchpointList.h"
 
 #include <sched.h>
 
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace lldb_private {
 namespace process_linux {
@@ -85,6 +87,11 @@ namespace process_linux {
         void
         SetStoppedByWatchpoint (uint32_t wp_index);
 
+        // Stopped by a software watchpoint of the process, which has no
+        // debug register index.
+        void
+        SetStoppedBySoftwareWatchpoint (lldb::addr_t wp_addr);
+
         bool
         IsStoppedAtBreakpoint ();
 
@@ -103,6 +110,17 @@ namespace process_linux {
         Error
         RequestStop ();
 
+        // Makes watchpoints the hardware watchpoints of the thread, which
+        // must be stopped. generation is the watchpoint generation of the
+        // process they are from.
+        Error
+        SetHardwareWatchpoints (const std::vector<NativeWatchpoint> &watchpoints, uint32_t generation);
+
+        // Gives the thread the hardware watchpoints of the process if they
+        // changed since it got them, before it runs again.
+        void
+        MaybeUpdateHardwareWatchpoints ();
+
         // ---------------------------------------------------------------------
         // Private interface
         // ---------------------------------------------------------------------
@@ -115,6 +133,10 @@ namespace process_linux {
         void
         SetStopped();
 
+        // Drops the registers read at the last stop.
+        void
+        InvalidateRegisterCache();
+
         inline void
         MaybePrepareSingleStepWorkaround();
 
@@ -130,6 +152,7 @@ namespace process_linux {
         std::string m_stop_description;
         using WatchpointIndexMap = std::map<lldb::addr_t, uint32_t>;
         WatchpointIndexMap m_watchpoint_index_map;
+        uint32_t m_hardware_watchpoints_generation; // Zero until the thread got the watchpoints of the process.
         cpu_set_t m_original_cpu_set; // For single-step workaround.
     };
 
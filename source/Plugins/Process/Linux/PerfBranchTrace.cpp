@@ -0,0 +1,177 @@
+//===-- PerfBranchTrace.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "PerfBranchTrace.h"
+
+// C Includes
+#include <fcntl.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+#include "lldb/Core/Log.h"
+#include "lldb/Host/File.h"
+
+#include "Plugins/Process/POSIX/ProcessPOSIXLog.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_linux;
+
+namespace
+{
+    // A PERF_RECORD_SAMPLE with PERF_SAMPLE_IP | PERF_SAMPLE_ADDR.
+    struct BranchSample
+    {
+        struct perf_event_header header;
+        uint64_t from;
+        uint64_t to;
+    };
+}
+
+PerfBranchTrace::UP
+PerfBranchTrace::Create (lldb::tid_t tid, size_t buffer_size, MainLoop &mainloop, Error &error)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // The ring buffer is a power of two number of pages, the mapping has
+    // one more page in front of it for the control page.
+    const size_t page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t data_pages = 1;
+    while (data_pages * page_size < buffer_size)
+        data_pages <<= 1;
+    const size_t data_size = data_pages * page_size;
+
+    // A sample period of one branch instruction records every taken branch
+    // with its source (the ip) and destination (the addr).
+    struct perf_event_attr attr;
+    ::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_BRANCH_INSTRUCTIONS;
+    attr.sample_period = 1;
+    attr.sample_type = PERF_SAMPLE_IP | PERF_SAMPLE_ADDR;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.watermark = 1;
+    attr.wakeup_watermark = data_size / 2;
+
+    const int fd = static_cast<int>(::syscall(__NR_perf_event_open, &attr, static_cast<pid_t>(tid), -1, -1, 0));
+    if (fd == -1)
+    {
+        error.SetErrorStringWithFormat("perf_event_open failed for tid %" PRIu64 ": %s", tid, ::strerror(errno));
+        return UP();
+    }
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    const size_t mmap_size = data_size + page_size;
+    void *mmap_base = ::mmap(nullptr, mmap_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mmap_base == MAP_FAILED)
+    {
+        error.SetErrorStringWithFormat("mapping the perf ring buffer of tid %" PRIu64 " failed: %s", tid, ::strerror(errno));
+        ::close(fd);
+        return UP();
+    }
+
+    UP trace_up (new PerfBranchTrace (fd, mmap_base, mmap_size, page_size));
+
+    PerfBranchTrace *trace = trace_up.get();
+    trace->m_read_handle = mainloop.RegisterReadObject(IOObjectSP(new File(fd, false)),
+            [trace] (MainLoopBase &) { trace->Drain(); }, error);
+    if (!trace->m_read_handle)
+        return UP();
+
+    if (log)
+        log->Printf ("PerfBranchTrace::%s tracing tid %" PRIu64 " with a %zu byte ring buffer", __FUNCTION__, tid, data_size);
+    return trace_up;
+}
+
+PerfBranchTrace::PerfBranchTrace (int fd, void *mmap_base, size_t mmap_size, size_t page_size) :
+    m_fd (fd),
+    m_mmap_base (mmap_base),
+    m_mmap_size (mmap_size),
+    m_page_size (page_size),
+    m_max_branches ((mmap_size - page_size) / sizeof(BranchSample)),
+    m_branches (),
+    m_lost_count (0),
+    m_read_handle ()
+{
+}
+
+PerfBranchTrace::~PerfBranchTrace ()
+{
+    m_read_handle.reset();
+    ::munmap(m_mmap_base, m_mmap_size);
+    ::close(m_fd);
+}
+
+void
+PerfBranchTrace::GetBranches (std::vector<Branch> &branches)
+{
+    Drain();
+    branches.assign(m_branches.begin(), m_branches.end());
+}
+
+void
+PerfBranchTrace::CopyFromRing (uint64_t offset, void *dst, size_t size) const
+{
+    const uint8_t *data = static_cast<const uint8_t *>(m_mmap_base) + m_page_size;
+    const size_t data_size = m_mmap_size - m_page_size;
+
+    // Records can wrap around the end of the ring buffer.
+    const size_t start = offset % data_size;
+    const size_t first = std::min(size, data_size - start);
+    ::memcpy(dst, data + start, first);
+    ::memcpy(static_cast<uint8_t *>(dst) + first, data, size - first);
+}
+
+void
+PerfBranchTrace::Drain ()
+{
+    struct perf_event_mmap_page *control = static_cast<struct perf_event_mmap_page *>(m_mmap_base);
+
+    // The kernel updates data_head after the records, read it before them.
+    const uint64_t head = control->data_head;
+    __sync_synchronize();
+
+    uint64_t tail = control->data_tail;
+    while (tail + sizeof(struct perf_event_header) <= head)
+    {
+        BranchSample sample;
+        CopyFromRing(tail, &sample.header, sizeof(sample.header));
+        if (sample.header.size < sizeof(sample.header))
+            break;
+
+        if (sample.header.type == PERF_RECORD_SAMPLE && sample.header.size >= sizeof(sample))
+        {
+            CopyFromRing(tail + sizeof(sample.header), &sample.from, sizeof(sample.from) + sizeof(sample.to));
+            m_branches.push_back(Branch(sample.from, sample.to));
+            if (m_branches.size() > m_max_branches)
+                m_branches.pop_front();
+        }
+        else if (sample.header.type == PERF_RECORD_LOST)
+        {
+            // Followed by the event id and the number of lost records.
+            uint64_t lost[2];
+            CopyFromRing(tail + sizeof(sample.header), lost, sizeof(lost));
+            m_lost_count += lost[1];
+        }
+        tail += sample.header.size;
+    }
+
+    // Let the kernel reuse the space once we are done reading it.
+    __sync_synchronize();
+    control->data_tail = tail;
+}
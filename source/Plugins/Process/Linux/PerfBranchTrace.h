@@ -0,0 +1,102 @@
+//===-- PerfBranchTrace.h --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_PerfBranchTrace_H_
+#define liblldb_PerfBranchTrace_H_
+
+// C++ Includes
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Other libraries and framework includes
+#include "lldb/Core/Error.h"
+#include "lldb/Host/MainLoop.h"
+#include "lldb/lldb-types.h"
+
+namespace lldb_private {
+namespace process_linux {
+
+    //------------------------------------------------------------------
+    /// @class PerfBranchTrace
+    /// @brief Records the branches a thread takes with perf_event_open.
+    ///
+    /// Every taken branch of the thread is sampled with its source and
+    /// destination address. On Intel CPUs the kernel implements this with
+    /// the Branch Trace Store, which writes the records without stopping
+    /// the thread. The kernel writes the samples to a ring buffer and wakes
+    /// the main loop when it is half full, the records are then moved to a
+    /// history that keeps the most recent ones.
+    //------------------------------------------------------------------
+    class PerfBranchTrace
+    {
+    public:
+        typedef std::unique_ptr<PerfBranchTrace> UP;
+        typedef std::pair<lldb::addr_t, lldb::addr_t> Branch; // from, to
+
+        //------------------------------------------------------------------
+        /// Start tracing a thread.
+        ///
+        /// @param[in] tid
+        ///     The thread to trace.
+        ///
+        /// @param[in] buffer_size
+        ///     The size of the kernel ring buffer in bytes, rounded up to a
+        ///     power of two number of pages. The history keeps as many
+        ///     branches as fit in the ring buffer.
+        ///
+        /// @param[in] mainloop
+        ///     The loop that drains the ring buffer while the thread runs.
+        //------------------------------------------------------------------
+        static UP
+        Create (lldb::tid_t tid, size_t buffer_size, MainLoop &mainloop, Error &error);
+
+        ~PerfBranchTrace ();
+
+        //------------------------------------------------------------------
+        /// Get the recorded branches, the oldest one first.
+        //------------------------------------------------------------------
+        void
+        GetBranches (std::vector<Branch> &branches);
+
+        // The number of branches the kernel couldn't record because the
+        // ring buffer was full.
+        uint64_t
+        GetLostBranchCount () const
+        {
+            return m_lost_count;
+        }
+
+    private:
+        PerfBranchTrace (int fd, void *mmap_base, size_t mmap_size, size_t page_size);
+
+        // Move the records from the ring buffer to the history.
+        void
+        Drain ();
+
+        void
+        CopyFromRing (uint64_t offset, void *dst, size_t size) const;
+
+        int m_fd;
+        void *m_mmap_base;
+        size_t m_mmap_size;
+        size_t m_page_size;
+        size_t m_max_branches;
+        std::deque<Branch> m_branches;
+        uint64_t m_lost_count;
+        MainLoop::ReadHandleUP m_read_handle;
+
+        DISALLOW_COPY_AND_ASSIGN (PerfBranchTrace);
+    };
+
+} // namespace process_linux
+} // namespace lldb_private
+
+#endif // #ifndef liblldb_PerfBranchTrace_H_
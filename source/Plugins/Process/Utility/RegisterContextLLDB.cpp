@@ -588,17 +588,36 @@ RegisterContextLLDB::InitializeNonZerothFrame()
         }
     }
 
-    // We've set m_frame_type and m_sym_ctx before this call.
-    m_fast_unwind_plan_sp = GetFastUnwindPlanForFrame ();
-
     UnwindPlan::RowSP active_row;
     RegisterKind row_register_kind = eRegisterKindGeneric;
 
+    // The plan selection below depends on nothing but the pc when both this
+    // and the next frame are normal frames, reuse its result if we've been
+    // at this pc before.
+    const bool use_row_cache = m_frame_type == eNormalFrame && GetNextFrame()->m_frame_type == eNormalFrame;
+    const bool used_cached_row = use_row_cache && UseCachedUnwindRow (active_row, row_register_kind);
+    bool row_from_fast_plan = false;
+
+    // We've set m_frame_type and m_sym_ctx before this call.
+    if (!used_cached_row)
+        m_fast_unwind_plan_sp = GetFastUnwindPlanForFrame ();
+
     // Try to get by with just the fast UnwindPlan if possible - the full UnwindPlan may be expensive to get
     // (e.g. if we have to parse the entire eh_frame section of an ObjectFile for the first time.)
 
-    if (m_fast_unwind_plan_sp && m_fast_unwind_plan_sp->PlanValidAtAddress (m_current_pc))
+    if (used_cached_row)
     {
+        if (log)
+        {
+            StreamString active_row_strm;
+            active_row->Dump(active_row_strm, m_full_unwind_plan_sp ? m_full_unwind_plan_sp.get() : m_fast_unwind_plan_sp.get(),
+                             &m_thread, m_start_pc.GetLoadAddress(exe_ctx.GetTargetPtr()));
+            UnwindLogMsg ("active row (cached): %s", active_row_strm.GetString().c_str());
+        }
+    }
+    else if (m_fast_unwind_plan_sp && m_fast_unwind_plan_sp->PlanValidAtAddress (m_current_pc))
+    {
+        row_from_fast_plan = true;
         active_row = m_fast_unwind_plan_sp->GetRowForFunctionOffset (m_current_offset);
         row_register_kind = m_fast_unwind_plan_sp->GetRegisterKind ();
         if (active_row.get() && log)
@@ -641,6 +660,9 @@ RegisterContextLLDB::InitializeNonZerothFrame()
 
     UnwindLogMsg ("m_cfa = 0x%" PRIx64, m_cfa);
 
+    if (use_row_cache && !used_cached_row)
+        CacheUnwindRow (row_from_fast_plan ? m_fast_unwind_plan_sp : m_full_unwind_plan_sp, active_row, row_from_fast_plan);
+
     if (CheckIfLoopingStack ())
     {
         TryFallbackUnwindPlan();
@@ -656,6 +678,97 @@ RegisterContextLLDB::InitializeNonZerothFrame()
             (uint64_t) m_current_pc.GetLoadAddress (exe_ctx.GetTargetPtr()), (uint64_t) m_cfa);
 }
 
+bool
+RegisterContextLLDB::UseCachedUnwindRow (UnwindPlan::RowSP &active_row, RegisterKind &row_register_kind)
+{
+    ModuleSP pc_module_sp (m_current_pc.GetModule());
+    if (!pc_module_sp || pc_module_sp->GetObjectFile() == NULL)
+        return false;
+
+    UnwindTable::CachedUnwindRow cached_row;
+    if (!pc_module_sp->GetObjectFile()->GetUnwindTable().LookupCachedUnwindRow (m_current_pc.GetFileAddress(), cached_row)
+        || cached_row.function_offset != m_current_offset)
+        return false;
+
+    UnwindPlanSP unwind_plan_sp (new UnwindPlan (cached_row.register_kind));
+    UnwindPlan::RowSP row_sp (new UnwindPlan::Row);
+    row_sp->GetCFAValue().SetIsRegisterPlusOffset (cached_row.cfa_reg, cached_row.cfa_offset);
+    for (uint32_t i = 0; i < cached_row.num_saved_registers; ++i)
+        row_sp->SetRegisterLocationToAtCFAPlusOffset (cached_row.saved_regs[i], cached_row.saved_offsets[i], true);
+    unwind_plan_sp->AppendRow (row_sp);
+    unwind_plan_sp->SetSourceName ("cached unwind row");
+    unwind_plan_sp->SetSourcedFromCompiler (cached_row.sourced_from_compiler);
+    unwind_plan_sp->SetUnwindPlanValidAtAllInstructions (cached_row.valid_at_all_instructions);
+
+    // Install the plan where the original one was so that the remaining
+    // lookups (e.g. falling through to the full UnwindPlan) are unchanged.
+    if (cached_row.from_fast_plan)
+    {
+        m_fast_unwind_plan_sp = unwind_plan_sp;
+    }
+    else
+    {
+        m_fast_unwind_plan_sp.reset();
+        m_full_unwind_plan_sp = unwind_plan_sp;
+    }
+    active_row = row_sp;
+    row_register_kind = cached_row.register_kind;
+    return true;
+}
+
+void
+RegisterContextLLDB::CacheUnwindRow (const UnwindPlanSP &unwind_plan_sp, const UnwindPlan::RowSP &active_row, bool from_fast_plan)
+{
+    if (!unwind_plan_sp || !active_row)
+        return;
+
+    // Plans with a fallback or a return address register take code paths
+    // a one row plan can't reproduce.
+    if (m_fallback_unwind_plan_sp || unwind_plan_sp->GetReturnAddressRegister() != LLDB_INVALID_REGNUM)
+        return;
+
+    // Later register lookups use the row for m_current_offset, which may
+    // differ from the row found for the backed up pc.
+    if (unwind_plan_sp->GetRowForFunctionOffset (m_current_offset) != active_row)
+        return;
+
+    ModuleSP pc_module_sp (m_current_pc.GetModule());
+    if (!pc_module_sp || pc_module_sp->GetObjectFile() == NULL)
+        return;
+
+    UnwindPlan::Row::CFAValue &cfa_value = active_row->GetCFAValue();
+    if (cfa_value.GetValueType() != UnwindPlan::Row::CFAValue::isRegisterPlusOffset ||
+        active_row->GetRegisterInfoCount() > UnwindTable::CachedUnwindRow::kMaxSavedRegisters)
+        return;
+
+    UnwindTable::CachedUnwindRow cached_row;
+    cached_row.from_fast_plan = from_fast_plan;
+    cached_row.register_kind = unwind_plan_sp->GetRegisterKind();
+    cached_row.sourced_from_compiler = unwind_plan_sp->GetSourcedFromCompiler();
+    cached_row.valid_at_all_instructions = unwind_plan_sp->GetUnwindPlanValidAtAllInstructions();
+    cached_row.function_offset = m_current_offset;
+    cached_row.cfa_reg = cfa_value.GetRegisterNumber();
+    cached_row.cfa_offset = cfa_value.GetOffset();
+    cached_row.num_saved_registers = 0;
+
+    bool simple = true;
+    active_row->ForEachRegisterInfo ([&cached_row, &simple](uint32_t reg_num, const UnwindPlan::Row::RegisterLocation &location) -> bool
+    {
+        if (!location.IsAtCFAPlusOffset())
+        {
+            simple = false;
+            return false;
+        }
+        cached_row.saved_regs[cached_row.num_saved_registers] = reg_num;
+        cached_row.saved_offsets[cached_row.num_saved_registers] = location.GetOffset();
+        ++cached_row.num_saved_registers;
+        return true;
+    });
+
+    if (simple)
+        pc_module_sp->GetObjectFile()->GetUnwindTable().AddCachedUnwindRow (m_current_pc.GetFileAddress(), cached_row);
+}
+
 bool
 RegisterContextLLDB::CheckIfLoopingStack ()
 {
@@ -211,6 +211,15 @@ private:
     lldb::UnwindPlanSP
     GetFullUnwindPlanForFrame ();
 
+    // Look up the unwind row picked the last time a frame had this pc and
+    // install it as the frame's UnwindPlan.
+    bool
+    UseCachedUnwindRow (UnwindPlan::RowSP &active_row, lldb::RegisterKind &row_register_kind);
+
+    // Remember the unwind row picked for this pc if it is simple enough.
+    void
+    CacheUnwindRow (const lldb::UnwindPlanSP &unwind_plan_sp, const UnwindPlan::RowSP &active_row, bool from_fast_plan);
+
     void
     UnwindLogMsg (const char *fmt, ...) __attribute__ ((format (printf, 2, 3)));
 
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 
 // C++ Includes
+#include <algorithm>
 #include <mutex>
 
 // Other libraries and framework includes
@@ -24,6 +25,7 @@
 #include "lldb/Target/Target.h"
 #include "lldb/Target/DynamicLoader.h"
 #include "lldb/Target/UnixSignals.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "llvm/Support/ELF.h"
 
@@ -113,7 +115,8 @@ ProcessElfCore::ProcessElfCore(lldb::TargetSP target_sp, lldb::ListenerSP listen
     m_os(llvm::Triple::UnknownOS),
     m_thread_data_valid(false),
     m_thread_data(),
-    m_core_aranges ()
+    m_core_aranges (),
+    m_core_data_sp ()
 {
 }
 
@@ -198,6 +201,11 @@ ProcessElfCore::DoLoadCore ()
 
     SetCanJIT(false);
 
+    // Map the whole core once, memory reads are copied straight out of the
+    // mapping. The object file may only hold a heap copy of the core when it
+    // isn't on a local file system.
+    m_core_data_sp = m_core_file.MemoryMapFileContents();
+
     m_thread_data_valid = true;
 
     bool ranges_are_sorted = true;
@@ -355,7 +363,16 @@ ProcessElfCore::DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &
 
     // If there is data available on the core file read it
     if (bytes_to_read)
-        bytes_copied = core_objfile->CopyData(offset + file_start, bytes_to_read, buf);
+    {
+        const lldb::offset_t file_offset = file_start + offset;
+        if (m_core_data_sp && file_offset + bytes_to_read <= m_core_data_sp->GetByteSize())
+        {
+            ::memcpy(buf, m_core_data_sp->GetBytes() + file_offset, bytes_to_read);
+            bytes_copied = bytes_to_read;
+        }
+        else
+            bytes_copied = core_objfile->CopyData(file_offset, bytes_to_read, buf);
+    }
 
     assert(zero_fill_size <= size);
     // Pad remaining bytes
@@ -370,6 +387,7 @@ ProcessElfCore::Clear()
 {
     m_thread_list.Clear();
     m_os = llvm::Triple::UnknownOS;
+    m_core_data_sp.reset();
 
     SetUnixSignals(std::make_shared<UnixSignals>());
 }
@@ -462,6 +480,74 @@ ParseFreeBSDThrMisc(ThreadData &thread_data, DataExtractor &data)
     thread_data.name = data.GetCStr(&offset, 20);
 }
 
+namespace
+{
+    // The NOTE entries of one thread, in the order they were found.
+    struct ThreadNotes
+    {
+        std::vector<std::pair<ELFNote, DataExtractor>> notes;
+        std::string name;
+    };
+
+    // Don't bother the task pool for the usual handful of threads.
+    const size_t k_threads_per_task = 64;
+}
+
+// Parse the per thread NOTE entries of one thread. This only looks at the
+// notes, so the threads can be parsed in parallel.
+static void
+ParseThreadNotes(const ThreadNotes &thread_notes, ArchSpec &arch, ThreadData &thread_data)
+{
+    thread_data.name = thread_notes.name;
+    for (const auto &entry : thread_notes.notes)
+    {
+        const ELFNote &note = entry.first;
+        DataExtractor note_data = entry.second;
+        if (note.n_name == "FreeBSD")
+        {
+            switch (note.n_type)
+            {
+                case FREEBSD::NT_PRSTATUS:
+                    ParseFreeBSDPrStatus(thread_data, note_data, arch);
+                    break;
+                case FREEBSD::NT_FPREGSET:
+                    thread_data.fpregset = note_data;
+                    break;
+                case FREEBSD::NT_THRMISC:
+                    ParseFreeBSDThrMisc(thread_data, note_data);
+                    break;
+                case FREEBSD::NT_PPC_VMX:
+                    thread_data.vregset = note_data;
+                    break;
+                default:
+                    break;
+            }
+        }
+        else
+        {
+            switch (note.n_type)
+            {
+                case NT_PRSTATUS:
+                {
+                    ELFLinuxPrStatus prstatus;
+                    prstatus.Parse(note_data, arch);
+                    thread_data.signo = prstatus.pr_cursig;
+                    thread_data.tid = prstatus.pr_pid;
+                    const size_t header_size = ELFLinuxPrStatus::GetSize(arch);
+                    const size_t len = note_data.GetByteSize() - header_size;
+                    thread_data.gpregset = DataExtractor(note_data, header_size, len);
+                    break;
+                }
+                case NT_FPREGSET:
+                    thread_data.fpregset = note_data;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
 /// Parse Thread context from PT_NOTE segment and store it in the thread list
 /// Notes:
 /// 1) A PT_NOTE segment is composed of one or more NOTE entries.
@@ -480,6 +566,9 @@ ParseFreeBSDThrMisc(ThreadData &thread_data, DataExtractor &data)
 ///        new thread when it finds NT_PRSTATUS or NT_PRPSINFO NOTE entry.
 ///    For case (b) there may be either one NT_PRPSINFO per thread, or a single
 ///    one that applies to all threads (depending on the platform type).
+/// 6) The NOTE entries are walked in order to split them into threads and to
+///    handle the process wide ones, the per thread entries are then parsed in
+///    parallel for cores with many threads.
 void
 ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *segment_header,
                                                    DataExtractor segment_data)
@@ -487,15 +576,12 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
     assert(segment_header && segment_header->p_type == llvm::ELF::PT_NOTE);
 
     lldb::offset_t offset = 0;
-    std::unique_ptr<ThreadData> thread_data(new ThreadData);
+    std::vector<ThreadNotes> threads(1);
     bool have_prstatus = false;
     bool have_prpsinfo = false;
 
     ArchSpec arch = GetArchitecture();
     ELFLinuxPrPsInfo prpsinfo;
-    ELFLinuxPrStatus prstatus;
-    size_t header_size;
-    size_t len;
 
     // Loop through the NOTE entires in the segment
     while (offset < segment_header->p_filesz)
@@ -507,10 +593,7 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
         if ((note.n_type == NT_PRSTATUS && have_prstatus) ||
             (note.n_type == NT_PRPSINFO && have_prpsinfo))
         {
-            assert(thread_data->gpregset.GetByteSize() > 0);
-            // Add the new thread to thread list
-            m_thread_data.push_back(*thread_data);
-            *thread_data = ThreadData();
+            threads.emplace_back();
             have_prstatus = false;
             have_prpsinfo = false;
         }
@@ -522,6 +605,7 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
         // Store the NOTE information in the current thread
         DataExtractor note_data (segment_data, note_start, note_size);
         note_data.SetAddressByteSize(m_core_module_sp->GetArchitecture().GetAddressByteSize());
+        ThreadNotes &thread_notes = threads.back();
         if (note.n_name == "FreeBSD")
         {
             m_os = llvm::Triple::FreeBSD;
@@ -529,24 +613,20 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
             {
                 case FREEBSD::NT_PRSTATUS:
                     have_prstatus = true;
-                    ParseFreeBSDPrStatus(*thread_data, note_data, arch);
+                    thread_notes.notes.push_back(std::make_pair(note, note_data));
                     break;
                 case FREEBSD::NT_FPREGSET:
-                    thread_data->fpregset = note_data;
+                case FREEBSD::NT_THRMISC:
+                case FREEBSD::NT_PPC_VMX:
+                    thread_notes.notes.push_back(std::make_pair(note, note_data));
                     break;
                 case FREEBSD::NT_PRPSINFO:
                     have_prpsinfo = true;
                     break;
-                case FREEBSD::NT_THRMISC:
-                    ParseFreeBSDThrMisc(*thread_data, note_data);
-                    break;
                 case FREEBSD::NT_PROCSTAT_AUXV:
                     // FIXME: FreeBSD sticks an int at the beginning of the note
                     m_auxv = DataExtractor(segment_data, note_start + 4, note_size - 4);
                     break;
-                case FREEBSD::NT_PPC_VMX:
-                    thread_data->vregset = note_data;
-                    break;
                 default:
                     break;
             }
@@ -557,20 +637,15 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
             {
                 case NT_PRSTATUS:
                     have_prstatus = true;
-                    prstatus.Parse(note_data, arch);
-                    thread_data->signo = prstatus.pr_cursig;
-                    thread_data->tid = prstatus.pr_pid;
-                    header_size = ELFLinuxPrStatus::GetSize(arch);
-                    len = note_data.GetByteSize() - header_size;
-                    thread_data->gpregset = DataExtractor(note_data, header_size, len);
+                    thread_notes.notes.push_back(std::make_pair(note, note_data));
                     break;
                 case NT_FPREGSET:
-                    thread_data->fpregset = note_data;
+                    thread_notes.notes.push_back(std::make_pair(note, note_data));
                     break;
                 case NT_PRPSINFO:
                     have_prpsinfo = true;
                     prpsinfo.Parse(note_data, arch);
-                    thread_data->name = prpsinfo.pr_fname;
+                    thread_notes.name = prpsinfo.pr_fname;
                     SetID(prpsinfo.pr_pid);
                     break;
                 case NT_AUXV:
@@ -605,10 +680,33 @@ ProcessElfCore::ParseThreadContextsFromNoteSegment(const elf::ELFProgramHeader *
 
         offset += note_size;
     }
-    // Add last entry in the note section
-    if (thread_data && thread_data->gpregset.GetByteSize() > 0)
+
+    const size_t num_threads = threads.size();
+    std::vector<ThreadData> thread_data(num_threads);
+    auto parse_fn = [&threads, &thread_data, &arch, num_threads](size_t start_idx)
+    {
+        // The note parsers take a non-const ArchSpec, give each task its own.
+        ArchSpec task_arch(arch);
+        const size_t end_idx = std::min(start_idx + k_threads_per_task, num_threads);
+        for (size_t idx = start_idx; idx < end_idx; ++idx)
+            ParseThreadNotes(threads[idx], task_arch, thread_data[idx]);
+    };
+
+    if (num_threads <= k_threads_per_task)
+        parse_fn(0);
+    else
+    {
+        TaskRunner<void> task_runner;
+        for (size_t start_idx = 0; start_idx < num_threads; start_idx += k_threads_per_task)
+            task_runner.AddTask(parse_fn, start_idx);
+        task_runner.WaitForAllTasks();
+    }
+
+    // Keep the order of the notes, threads without registers are skipped.
+    for (ThreadData &td : thread_data)
     {
-        m_thread_data.push_back(*thread_data);
+        if (td.gpregset.GetByteSize() > 0)
+            m_thread_data.push_back(std::move(td));
     }
 }
 
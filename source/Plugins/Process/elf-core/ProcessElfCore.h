@@ -95,6 +95,8 @@ public:
     //------------------------------------------------------------------
     bool IsAlive() override;
 
+    bool IsLiveDebugSession() const override { return false; }
+
     //------------------------------------------------------------------
     // Process Memory
     //------------------------------------------------------------------
@@ -155,6 +157,10 @@ private:
     // Address ranges found in the core
     VMRangeToFileOffset m_core_aranges;
 
+    // The whole core file, memory mapped once so that reads don't go
+    // through the object file
+    lldb::DataBufferSP m_core_data_sp;
+
     // NT_FILE entries found from the NOTE segment
     std::vector<NT_FILE_Entry> m_nt_file_entries;
 
@@ -20,6 +20,7 @@
 #include "lldb/Core/Log.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/StreamGDBRemote.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/FileSpec.h"
@@ -51,10 +52,18 @@
 #include <zlib.h>
 #endif
 
+#if defined (HAVE_LIBLZ4)
+#include <lz4.h>
+#endif
+
 using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
 
+// Binary frames are "!<kind><payload length as 8 hex digits><payload>" where
+// the kind is 'e' for escaped payloads and 'r' for raw ones.
+static const size_t kBinaryFrameHeaderSize = 10;
+
 GDBRemoteCommunication::History::History (uint32_t size) :
     m_packets(),
     m_curr_idx (0),
@@ -166,9 +175,16 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_public_is_running (false),
     m_private_is_running (false),
     m_history (512),
+    m_packet_stats (),
     m_send_acks (true),
     m_compression_type (CompressionType::None),
-    m_listen_url ()
+    m_send_compression_type (CompressionType::None),
+    m_send_compression_minsize (384),
+    m_binary_framing (false),
+    m_listen_url (),
+    m_recording_mutex (Mutex::eMutexTypeNormal),
+    m_recording_ap (),
+    m_recording_start ()
 {
 }
 
@@ -238,75 +254,166 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
 {
     if (IsConnected())
     {
-        StreamString packet(0, 4, eByteOrderBig);
+        const char *original_payload = payload;
+        const size_t original_payload_length = payload_length;
+        std::string compressed_payload;
+        if (m_send_compression_type != CompressionType::None)
+        {
+            CompressPacket (payload, payload_length, compressed_payload);
+            payload = compressed_payload.data();
+            payload_length = compressed_payload.size();
+        }
 
-        packet.PutChar('$');
-        packet.Write (payload, payload_length);
-        packet.PutChar('#');
-        packet.PutHex8(CalculcateChecksum (payload, payload_length));
+        StreamString packet(0, 4, eByteOrderBig);
 
-        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
-        ConnectionStatus status = eConnectionStatusSuccess;
-        const char *packet_data = packet.GetData();
-        const size_t packet_length = packet.GetSize();
-        size_t bytes_written = Write (packet_data, packet_length, status, NULL);
-        if (log)
+        if (m_binary_framing)
         {
-            size_t binary_start_offset = 0;
-            if (strncmp(packet_data, "$vFile:pwrite:", strlen("$vFile:pwrite:")) == 0)
-            {
-                const char *first_comma = strchr(packet_data, ',');
-                if (first_comma)
-                {
-                    const char *second_comma = strchr(first_comma + 1, ',');
-                    if (second_comma)
-                        binary_start_offset = second_comma - packet_data + 1;
-                }
-            }
+            // The payload is still escaped, but there is no checksum and the
+            // receiver doesn't have to look for the end of the packet.
+            packet.Printf("!e%8.8" PRIx64, (uint64_t)payload_length);
+            packet.Write (payload, payload_length);
+        }
+        else
+        {
+            packet.PutChar('$');
+            packet.Write (payload, payload_length);
+            packet.PutChar('#');
+            packet.PutHex8(CalculcateChecksum (payload, payload_length));
+        }
+
+        RecordPacket ("send", original_payload, original_payload_length, packet.GetSize(), true);
+        return SendFrameNoLock (packet.GetString());
+    }
+    return PacketResult::ErrorSendFailed;
+}
 
-            // If logging was just enabled and we have history, then dump out what
-            // we have to the log so we get the historical context. The Dump() call that
-            // logs all of the packet will set a boolean so that we don't dump this more
-            // than once
-            if (!m_history.DidDumpToLog ())
-                m_history.Dump (log);
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendBinaryPacketNoLock (const char *payload, size_t payload_length)
+{
+    if (!m_binary_framing)
+    {
+        StreamGDBRemote escaped_payload;
+        escaped_payload.PutEscapedBytes (payload, payload_length);
+        return SendPacketNoLock (escaped_payload.GetData(), escaped_payload.GetSize());
+    }
 
-            if (binary_start_offset)
+    if (!IsConnected())
+        return PacketResult::ErrorSendFailed;
+
+    std::string packet;
+    packet.reserve (kBinaryFrameHeaderSize + payload_length);
+    char header[kBinaryFrameHeaderSize + 1];
+    ::snprintf (header, sizeof(header), "!r%8.8" PRIx64, (uint64_t)payload_length);
+    packet.append (header, kBinaryFrameHeaderSize);
+    packet.append (payload, payload_length);
+    RecordPacket ("send", payload, payload_length, packet.size(), false);
+    return SendFrameNoLock (packet);
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendFrameNoLock (const std::string &packet)
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    ConnectionStatus status = eConnectionStatusSuccess;
+    const char *packet_data = packet.data();
+    const size_t packet_length = packet.size();
+    size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+    if (log)
+    {
+        size_t binary_start_offset = 0;
+        size_t binary_end_offset = packet_length;
+        if (strncmp(packet_data, "$vFile:pwrite:", strlen("$vFile:pwrite:")) == 0)
+        {
+            const char *first_comma = strchr(packet_data, ',');
+            if (first_comma)
             {
-                StreamString strm;
-                // Print non binary data header
-                strm.Printf("<%4" PRIu64 "> send packet: %.*s", (uint64_t)bytes_written, (int)binary_start_offset, packet_data);
-                const uint8_t *p;
-                // Print binary data exactly as sent
-                for (p = (const uint8_t*)packet_data + binary_start_offset; *p != '#'; ++p)
-                    strm.Printf("\\x%2.2x", *p);
-                // Print the checksum
-                strm.Printf("%*s", (int)3, p);
-                log->PutCString(strm.GetString().c_str());
+                const char *second_comma = strchr(first_comma + 1, ',');
+                if (second_comma)
+                    binary_start_offset = second_comma - packet_data + 1;
             }
-            else
-                log->Printf("<%4" PRIu64 "> send packet: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+            // Leave out the checksum
+            binary_end_offset = packet_length - 3;
+        }
+        else if (strncmp(packet_data, "!r", 2) == 0)
+        {
+            binary_start_offset = kBinaryFrameHeaderSize;
         }
 
-        m_history.AddPacket (packet.GetString(), packet_length, History::ePacketTypeSend, bytes_written);
-
+        // If logging was just enabled and we have history, then dump out what
+        // we have to the log so we get the historical context. The Dump() call that
+        // logs all of the packet will set a boolean so that we don't dump this more
+        // than once
+        if (!m_history.DidDumpToLog ())
+            m_history.Dump (log);
 
-        if (bytes_written == packet_length)
+        if (binary_start_offset && binary_start_offset <= binary_end_offset)
         {
-            if (GetSendAcks ())
-                return GetAck ();
-            else
-                return PacketResult::Success;
+            StreamString strm;
+            // Print non binary data header
+            strm.Printf("<%4" PRIu64 "> send packet: %.*s", (uint64_t)bytes_written, (int)binary_start_offset, packet_data);
+            const uint8_t *p;
+            // Print binary data exactly as sent
+            for (p = (const uint8_t*)packet_data + binary_start_offset; p < (const uint8_t*)packet_data + binary_end_offset; ++p)
+                strm.Printf("\\x%2.2x", *p);
+            // Print the checksum
+            strm.Printf("%.*s", (int)(packet_length - binary_end_offset), (const char *)p);
+            log->PutCString(strm.GetString().c_str());
         }
         else
-        {
-            if (log)
-                log->Printf ("error: failed to send packet: %.*s", (int)packet_length, packet_data);
-        }
+            log->Printf("<%4" PRIu64 "> send packet: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+    }
+
+    m_history.AddPacket (packet, packet_length, History::ePacketTypeSend, bytes_written);
+    ++m_packet_stats.packets_sent;
+    m_packet_stats.bytes_sent += bytes_written;
+
+    if (bytes_written == packet_length)
+    {
+        if (GetSendAcks ())
+            return GetAck ();
+        else
+            return PacketResult::Success;
+    }
+    else
+    {
+        if (log)
+            log->Printf ("error: failed to send packet: %.*s", (int)packet_length, packet_data);
     }
     return PacketResult::ErrorSendFailed;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock (const char *payload, size_t payload_length)
+{
+    if (!IsConnected())
+        return PacketResult::ErrorSendFailed;
+
+    StreamString packet(0, 4, eByteOrderBig);
+
+    packet.PutChar('%');
+    packet.Write (payload, payload_length);
+    packet.PutChar('#');
+    packet.PutHex8(CalculcateChecksum (payload, payload_length));
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    ConnectionStatus status = eConnectionStatusSuccess;
+    const char *packet_data = packet.GetData();
+    const size_t packet_length = packet.GetSize();
+    size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+    if (log)
+        log->Printf("<%4" PRIu64 "> send notification: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+
+    m_history.AddPacket (packet.GetString(), packet_length, History::ePacketTypeSend, bytes_written);
+
+    if (bytes_written != packet_length)
+    {
+        if (log)
+            log->Printf ("error: failed to send notification: %.*s", (int)packet_length, packet_data);
+        return PacketResult::ErrorSendFailed;
+    }
+    return PacketResult::Success;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::GetAck ()
 {
@@ -757,6 +864,21 @@ GDBRemoteCommunication::DecompressPacket ()
     }
 #endif
 
+#if defined (HAVE_LIBLZ4)
+    if (decompressed_bytes == 0
+        && decompressed_bufsize != ULONG_MAX
+        && decompressed_buffer != nullptr
+        && m_compression_type == CompressionType::LZ4)
+    {
+        const int status = LZ4_decompress_safe ((const char *) unescaped_content.data(),
+                                                (char *) decompressed_buffer,
+                                                (int) unescaped_content.size(),
+                                                (int) decompressed_bufsize);
+        if (status > 0)
+            decompressed_bytes = status;
+    }
+#endif
+
     if (decompressed_bytes == 0 || decompressed_buffer == nullptr)
     {
         if (decompressed_buffer)
@@ -789,6 +911,81 @@ GDBRemoteCommunication::DecompressPacket ()
     return true;
 }
 
+void
+GDBRemoteCommunication::CompressPacket (const char *payload, size_t payload_length, std::string &compressed_payload)
+{
+    size_t compressed_size = 0;
+    std::vector<uint8_t> encoded_data;
+
+    if (payload_length > m_send_compression_minsize)
+    {
+#if defined (HAVE_LIBZ)
+        if (m_send_compression_type == CompressionType::ZlibDeflate)
+        {
+            encoded_data.resize (payload_length + 128);
+
+            z_stream stream;
+            memset (&stream, 0, sizeof (z_stream));
+            stream.next_in = (Bytef *) payload;
+            stream.avail_in = (uInt) payload_length;
+            stream.next_out = (Bytef *) encoded_data.data();
+            stream.avail_out = (uInt) encoded_data.size();
+            stream.zalloc = Z_NULL;
+            stream.zfree = Z_NULL;
+            stream.opaque = Z_NULL;
+            if (deflateInit2 (&stream, 5, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+            {
+                int status = deflate (&stream, Z_FINISH);
+                deflateEnd (&stream);
+                if (status == Z_STREAM_END)
+                    compressed_size = stream.total_out;
+            }
+        }
+#endif
+
+#if defined (HAVE_LIBLZ4)
+        if (m_send_compression_type == CompressionType::LZ4)
+        {
+            encoded_data.resize (LZ4_compressBound ((int) payload_length));
+            const int status = LZ4_compress_default (payload,
+                                                     (char *) encoded_data.data(),
+                                                     (int) payload_length,
+                                                     (int) encoded_data.size());
+            if (status > 0)
+                compressed_size = status;
+        }
+#endif
+    }
+
+    // Don't bother sending compressed data that is bigger than the original
+    if (compressed_size == 0 || compressed_size >= payload_length)
+    {
+        compressed_payload.reserve (payload_length + 1);
+        compressed_payload.assign ("N");
+        compressed_payload.append (payload, payload_length);
+        return;
+    }
+
+    char size_str[32];
+    snprintf (size_str, sizeof (size_str), "C%" PRIu64 ":", (uint64_t) payload_length);
+    compressed_payload.reserve (compressed_size + compressed_size / 8 + sizeof (size_str));
+    compressed_payload.assign (size_str);
+
+    // The compressed data is binary so escape the characters that have a
+    // meaning in the gdb-remote protocol.
+    for (size_t i = 0; i < compressed_size; ++i)
+    {
+        const uint8_t byte = encoded_data[i];
+        if (byte == '#' || byte == '$' || byte == '}' || byte == '*' || byte == '\0')
+        {
+            compressed_payload.push_back ('}');
+            compressed_payload.push_back (byte ^ 0x20);
+        }
+        else
+            compressed_payload.push_back (byte);
+    }
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, StringExtractorGDBRemote &packet)
 {
@@ -797,6 +994,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
 
     Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
 
+    size_t consumed = 0;
     if (src && src_len > 0)
     {
         if (log && log->GetVerbose())
@@ -808,13 +1006,54 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                          (uint32_t)src_len, 
                          src);
         }
+
+        // Most reads end with a complete packet. If nothing is buffered,
+        // parse it straight from the bytes that were read and only keep
+        // what is left of them. Compressed packets are decompressed in
+        // m_bytes, so those always go through it.
+        if (m_bytes.empty() && !CompressionIsEnabled())
+        {
+            const PacketType packet_type = ParsePacket ((const char *)src, src_len, src_len, packet, consumed);
+            if (consumed < src_len)
+                m_bytes.append ((const char *)src + consumed, src_len - consumed);
+            return packet_type;
+        }
         m_bytes.append ((const char *)src, src_len);
     }
 
+    if (m_bytes.empty())
+    {
+        packet.Clear();
+        return GDBRemoteCommunication::PacketType::Invalid;
+    }
+
+    // Size of packet before it is decompressed, for logging purposes
+    const size_t original_packet_size = m_bytes.size();
+    if (CompressionIsEnabled())
+    {
+        if (DecompressPacket() == false)
+        {
+            packet.Clear();
+            return GDBRemoteCommunication::PacketType::Standard;
+        }
+    }
+
+    const PacketType packet_type = ParsePacket (m_bytes.data(), m_bytes.size(), original_packet_size, packet, consumed);
+    m_bytes.erase (0, consumed);
+    return packet_type;
+}
+
+GDBRemoteCommunication::PacketType
+GDBRemoteCommunication::ParsePacket (const char *bytes, size_t bytes_len, size_t original_packet_size,
+                                     StringExtractorGDBRemote &packet, size_t &consumed)
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+
+    consumed = 0;
     bool isNotifyPacket = false;
 
     // Parse up the packets into gdb remote packets
-    if (!m_bytes.empty())
+    if (bytes_len > 0)
     {
         // end_idx must be one past the last valid packet byte. Start
         // it off with an invalid value that is the same as the current
@@ -824,18 +1063,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
         size_t total_length = 0;
         size_t checksum_idx = std::string::npos;
 
-        // Size of packet before it is decompressed, for logging purposes
-        size_t original_packet_size = m_bytes.size();
-        if (CompressionIsEnabled())
-        {
-            if (DecompressPacket() == false)
-            {
-                packet.Clear();
-                return GDBRemoteCommunication::PacketType::Standard;
-            }
-        }
-
-        switch (m_bytes[0])
+        switch (bytes[0])
         {
             case '+':       // Look for ack
             case '-':       // Look for cancel
@@ -850,10 +1078,11 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
             case '$':
                 // Look for a standard gdb packet?
                 {
-                    size_t hash_pos = m_bytes.find('#');
-                    if (hash_pos != std::string::npos)
+                    const char *hash_mark = (const char *)::memchr (bytes, '#', bytes_len);
+                    if (hash_mark != nullptr)
                     {
-                        if (hash_pos + 2 < m_bytes.size())
+                        const size_t hash_pos = hash_mark - bytes;
+                        if (hash_pos + 2 < bytes_len)
                         {
                             checksum_idx = hash_pos + 1;
                             // Skip the dollar sign
@@ -872,19 +1101,56 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 }
                 break;
 
+            case '!':
+                // Look for a binary frame, these are only used once both
+                // sides agreed to.
+                if (m_binary_framing)
+                {
+                    if (bytes_len >= kBinaryFrameHeaderSize)
+                    {
+                        const std::string length_str (bytes + 2, kBinaryFrameHeaderSize - 2);
+                        const uint64_t frame_length = StringConvert::ToUInt64 (length_str.c_str(), UINT64_MAX, 16);
+                        if (frame_length == UINT64_MAX)
+                        {
+                            if (log)
+                                log->Printf ("error: invalid binary frame header: '%s'", length_str.c_str());
+                            consumed = bytes_len;
+                            packet.Clear();
+                            return GDBRemoteCommunication::PacketType::Invalid;
+                        }
+                        if (bytes_len >= kBinaryFrameHeaderSize + frame_length)
+                        {
+                            content_start = kBinaryFrameHeaderSize;
+                            content_length = frame_length;
+                            total_length = kBinaryFrameHeaderSize + frame_length;
+                        }
+                        else
+                        {
+                            // The rest of the frame isn't here yet
+                            content_length = std::string::npos;
+                        }
+                    }
+                    else
+                    {
+                        // The frame header isn't all here yet
+                        content_length = std::string::npos;
+                    }
+                    break;
+                }
+                LLVM_FALLTHROUGH;
+
             default:
                 {
                     // We have an unexpected byte and we need to flush all bad 
-                    // data that is in m_bytes, so we need to find the first
+                    // data that is in the buffer, so we need to find the first
                     // byte that is a '+' (ACK), '-' (NACK), \x03 (CTRL+C interrupt),
                     // or '$' character (start of packet header) or of course,
-                    // the end of the data in m_bytes...
-                    const size_t bytes_len = m_bytes.size();
+                    // the end of the data in the buffer...
                     bool done = false;
                     uint32_t idx;
                     for (idx = 1; !done && idx < bytes_len; ++idx)
                     {
-                        switch (m_bytes[idx])
+                        switch (bytes[idx])
                         {
                         case '+':
                         case '-':
@@ -900,8 +1166,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                     }
                     if (log)
                         log->Printf ("GDBRemoteCommunication::%s tossing %u junk bytes: '%.*s'",
-                                     __FUNCTION__, idx - 1, idx - 1, m_bytes.c_str());
-                    m_bytes.erase(0, idx - 1);
+                                     __FUNCTION__, idx - 1, idx - 1, bytes);
+                    consumed = idx - 1;
                 }
                 break;
         }
@@ -915,8 +1181,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
         {
 
             // We have a valid packet...
-            assert (content_length <= m_bytes.size());
-            assert (total_length <= m_bytes.size());
+            assert (content_length <= bytes_len);
+            assert (total_length <= bytes_len);
             assert (content_length <= total_length);
             size_t content_end = content_start + content_length;
 
@@ -933,33 +1199,41 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 
                 bool binary = false;
                 // Only detect binary for packets that start with a '$' and have a '#CC' checksum
-                if (m_bytes[0] == '$' && total_length > 4)
+                if (bytes[0] == '$' && total_length > 4)
                 {
                     for (size_t i=0; !binary && i<total_length; ++i)
                     {
-                        if (isprint (m_bytes[i]) == 0 && isspace (m_bytes[i]) == 0)
+                        if (isprint (bytes[i]) == 0 && isspace (bytes[i]) == 0)
                         {
                             binary = true;
                         }
                     }
                 }
-                if (binary)
+                if (bytes[0] == '!' && total_length > 1 && bytes[1] == 'r')
+                {
+                    StreamString strm;
+                    strm.Printf("<%4" PRIu64 "> read packet: %.*s", (uint64_t)total_length, (int)kBinaryFrameHeaderSize, bytes);
+                    for (size_t i=content_start; i<content_end; ++i)
+                        strm.Printf("%2.2x", (uint8_t)bytes[i]);
+                    log->PutCString(strm.GetString().c_str());
+                }
+                else if (binary)
                 {
                     StreamString strm;
                     // Packet header...
                     if (CompressionIsEnabled())
-                        strm.Printf("<%4" PRIu64 ":%" PRIu64 "> read packet: %c", (uint64_t) original_packet_size, (uint64_t)total_length, m_bytes[0]);
+                        strm.Printf("<%4" PRIu64 ":%" PRIu64 "> read packet: %c", (uint64_t) original_packet_size, (uint64_t)total_length, bytes[0]);
                     else
-                        strm.Printf("<%4" PRIu64 "> read packet: %c", (uint64_t)total_length, m_bytes[0]);
+                        strm.Printf("<%4" PRIu64 "> read packet: %c", (uint64_t)total_length, bytes[0]);
                     for (size_t i=content_start; i<content_end; ++i)
                     {
                         // Remove binary escaped bytes when displaying the packet...
-                        const char ch = m_bytes[i];
+                        const char ch = bytes[i];
                         if (ch == 0x7d)
                         {
                             // 0x7d is the escape character.  The next character is to
                             // be XOR'd with 0x20.
-                            const char escapee = m_bytes[++i] ^ 0x20;
+                            const char escapee = bytes[++i] ^ 0x20;
                             strm.Printf("%2.2x", escapee);
                         }
                         else
@@ -968,63 +1242,86 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                         }
                     }
                     // Packet footer...
-                    strm.Printf("%c%c%c", m_bytes[total_length-3], m_bytes[total_length-2], m_bytes[total_length-1]);
+                    strm.Printf("%c%c%c", bytes[total_length-3], bytes[total_length-2], bytes[total_length-1]);
                     log->PutCString(strm.GetString().c_str());
                 }
                 else
                 {
                     if (CompressionIsEnabled())
-                        log->Printf("<%4" PRIu64 ":%" PRIu64 "> read packet: %.*s", (uint64_t) original_packet_size, (uint64_t)total_length, (int)(total_length), m_bytes.c_str());
+                        log->Printf("<%4" PRIu64 ":%" PRIu64 "> read packet: %.*s", (uint64_t) original_packet_size, (uint64_t)total_length, (int)(total_length), bytes);
                     else
-                        log->Printf("<%4" PRIu64 "> read packet: %.*s", (uint64_t)total_length, (int)(total_length), m_bytes.c_str());
+                        log->Printf("<%4" PRIu64 "> read packet: %.*s", (uint64_t)total_length, (int)(total_length), bytes);
                 }
             }
 
-            m_history.AddPacket (m_bytes.c_str(), total_length, History::ePacketTypeRecv, total_length);
+            m_history.AddPacket (bytes, total_length, History::ePacketTypeRecv, total_length);
+            ++m_packet_stats.packets_received;
+            m_packet_stats.bytes_received += total_length;
 
             // Clear packet_str in case there is some existing data in it.
             packet_str.clear();
-            // Copy the packet from m_bytes to packet_str expanding the
-            // run-length encoding in the process.
-            // Reserve enough byte for the most common case (no RLE used)
-            packet_str.reserve(m_bytes.length());
-            for (std::string::const_iterator c = m_bytes.begin() + content_start; c != m_bytes.begin() + content_end; ++c)
+            if (bytes[0] == '!' && total_length > 1 && bytes[1] == 'r')
             {
-                if (*c == '*')
-                {
-                    // '*' indicates RLE. Next character will give us the
-                    // repeat count and previous character is what is to be
-                    // repeated.
-                    char char_to_repeat = packet_str.back();
-                    // Number of time the previous character is repeated
-                    int repeat_count = *++c + 3 - ' ';
-                    // We have the char_to_repeat and repeat_count. Now push
-                    // it in the packet.
-                    for (int i = 0; i < repeat_count; ++i)
-                        packet_str.push_back(char_to_repeat);
-                }
-                else if (*c == 0x7d)
-                {
-                    // 0x7d is the escape character.  The next character is to
-                    // be XOR'd with 0x20.
-                    char escapee = *++c ^ 0x20;
-                    packet_str.push_back(escapee);
-                }
-                else
+                // Raw binary frames are used as is
+                packet_str.assign(bytes + content_start, content_length);
+            }
+            else
+            {
+                // Copy the packet from the buffer to packet_str expanding the
+                // run-length encoding in the process. The runs of bytes between
+                // the RLE and escape characters are copied as a whole.
+                // Reserve enough byte for the most common case (no RLE used)
+                packet_str.reserve(content_length);
+                const char *c = bytes + content_start;
+                const char *content_end_ptr = bytes + content_end;
+                while (c < content_end_ptr)
                 {
-                    packet_str.push_back(*c);
+                    const char *run_end = c;
+                    while (run_end < content_end_ptr && *run_end != '*' && *run_end != 0x7d)
+                        ++run_end;
+                    packet_str.append(c, run_end - c);
+                    c = run_end;
+                    if (c + 1 >= content_end_ptr)
+                    {
+                        // A trailing RLE or escape character without its operand
+                        if (c < content_end_ptr)
+                            packet_str.push_back(*c++);
+                        break;
+                    }
+
+                    if (*c == '*')
+                    {
+                        // '*' indicates RLE. Next character will give us the
+                        // repeat count and previous character is what is to be
+                        // repeated.
+                        const char char_to_repeat = packet_str.empty() ? 0 : packet_str.back();
+                        // Number of time the previous character is repeated
+                        const int repeat_count = c[1] + 3 - ' ';
+                        // We have the char_to_repeat and repeat_count. Now push
+                        // it in the packet.
+                        if (repeat_count > 0)
+                            packet_str.append(repeat_count, char_to_repeat);
+                    }
+                    else
+                    {
+                        // 0x7d is the escape character.  The next character is to
+                        // be XOR'd with 0x20.
+                        packet_str.push_back(c[1] ^ 0x20);
+                    }
+                    c += 2;
                 }
             }
 
-            if (m_bytes[0] == '$' || m_bytes[0] == '%')
+            if (bytes[0] == '$' || bytes[0] == '%')
             {
-                assert (checksum_idx < m_bytes.size());
-                if (::isxdigit (m_bytes[checksum_idx+0]) || 
-                    ::isxdigit (m_bytes[checksum_idx+1]))
+                assert (checksum_idx < bytes_len);
+                if (::isxdigit (bytes[checksum_idx+0]) || 
+                    ::isxdigit (bytes[checksum_idx+1]))
                 {
                     if (GetSendAcks ())
                     {
-                        const char *packet_checksum_cstr = &m_bytes[checksum_idx];
+                        // The bytes after the checksum may not be terminated
+                        const char packet_checksum_cstr[3] = { bytes[checksum_idx], bytes[checksum_idx + 1], '\0' };
                         char packet_checksum = strtol (packet_checksum_cstr, NULL, 16);
                         char actual_checksum = CalculcateChecksum (packet_str.c_str(), packet_str.size());
                         success = packet_checksum == actual_checksum;
@@ -1033,7 +1330,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                             if (log)
                                 log->Printf ("error: checksum mismatch: %.*s expected 0x%2.2x, got 0x%2.2x", 
                                              (int)(total_length), 
-                                             m_bytes.c_str(),
+                                             bytes,
                                              (uint8_t)packet_checksum,
                                              (uint8_t)actual_checksum);
                         }
@@ -1048,11 +1345,21 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 {
                     success = false;
                     if (log)
-                        log->Printf ("error: invalid checksum in packet: '%s'\n", m_bytes.c_str());
+                        log->Printf ("error: invalid checksum in packet: '%.*s'\n", (int)total_length, bytes);
                 }
             }
             
-            m_bytes.erase(0, total_length);
+            // Acks are handled by the connection, they aren't part of the
+            // recording. Compressed packets were decompressed in place, the
+            // size before that is the one that was read.
+            if (bytes[0] != '+' && bytes[0] != '-')
+                RecordPacket (isNotifyPacket ? "notify" : "recv",
+                              packet_str.data(),
+                              packet_str.size(),
+                              CompressionIsEnabled() ? original_packet_size : total_length,
+                              false);
+
+            consumed = total_length;
             packet.SetFilePos(0);
 
             if (isNotifyPacket)
@@ -1433,6 +1740,93 @@ GDBRemoteCommunication::DumpHistory(Stream &strm)
     m_history.Dump (strm);
 }
 
+Error
+GDBRemoteCommunication::StartRecording (const char *path)
+{
+    std::unique_ptr<StreamFile> recording_ap (new StreamFile());
+    Error error = recording_ap->GetFile().Open (path,
+                                                File::eOpenOptionWrite | File::eOpenOptionCanCreate |
+                                                File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec,
+                                                lldb::eFilePermissionsFileDefault);
+    if (error.Fail())
+        return error;
+
+    recording_ap->PutCString ("# gdb-remote packet recording: <usec> <send|recv|notify> <bytes> <hex payload>\n");
+
+    Mutex::Locker locker (m_recording_mutex);
+    m_recording_ap = std::move (recording_ap);
+    m_recording_start = TimeValue::Now();
+    return error;
+}
+
+void
+GDBRemoteCommunication::StopRecording ()
+{
+    Mutex::Locker locker (m_recording_mutex);
+    m_recording_ap.reset();
+}
+
+bool
+GDBRemoteCommunication::IsRecording ()
+{
+    Mutex::Locker locker (m_recording_mutex);
+    return m_recording_ap.get() != nullptr;
+}
+
+void
+GDBRemoteCommunication::RecordPacket (const char *kind,
+                                      const char *payload,
+                                      size_t payload_length,
+                                      size_t wire_length,
+                                      bool escaped)
+{
+    Mutex::Locker locker (m_recording_mutex);
+    if (!m_recording_ap)
+        return;
+
+    const uint64_t usec = TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() -
+                          m_recording_start.GetAsMicroSecondsSinceJan1_1970();
+
+    // Write each packet with a single write so the recording of a session
+    // that crashes ends with a whole line.
+    StreamString line;
+    line.Printf ("%" PRIu64 " %s %" PRIu64 " ", usec, kind, (uint64_t)wire_length);
+    for (size_t i = 0; i < payload_length; ++i)
+    {
+        uint8_t byte = payload[i];
+        if (escaped && byte == 0x7d && i + 1 < payload_length)
+            byte = payload[++i] ^ 0x20;
+        line.PutHex8 (byte);
+    }
+    line.PutChar ('\n');
+    m_recording_ap->Write (line.GetData(), line.GetSize());
+}
+
+const size_t GDBRemoteCommunication::PacketStatistics::kNumRoundTripBuckets;
+
+GDBRemoteCommunication::PacketStatistics::PacketStatistics () :
+    packets_sent (0),
+    bytes_sent (0),
+    packets_received (0),
+    bytes_received (0),
+    round_trips (0),
+    round_trip_nanos (0)
+{
+    ::memset (round_trip_histogram, 0, sizeof(round_trip_histogram));
+}
+
+void
+GDBRemoteCommunication::PacketStatistics::AddRoundTrip (uint64_t nanos)
+{
+    ++round_trips;
+    round_trip_nanos += nanos;
+
+    size_t bucket = 0;
+    for (uint64_t usec = nanos / 1000; usec > 1 && bucket + 1 < kNumRoundTripBuckets; usec >>= 1)
+        ++bucket;
+    ++round_trip_histogram[bucket];
+}
+
 GDBRemoteCommunication::ScopedTimeout::ScopedTimeout (GDBRemoteCommunication& gdb_comm,
                                                       uint32_t timeout) :
     m_gdb_comm (gdb_comm)
@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <memory>
 #include <string>
 #include <queue>
 #include <vector>
@@ -82,6 +83,30 @@ public:
         ErrorNoSequenceLock // We couldn't get the sequence lock for a multi-packet request
     };
 
+    //------------------------------------------------------------------
+    // Packet counters for "statistics dump". Round trips are timed by
+    // the client, which is the side that waits for responses. Bucket i
+    // of the histogram counts the round trips that took less than
+    // 2^(i+1) microseconds, the last bucket also counts all slower ones.
+    //------------------------------------------------------------------
+    struct PacketStatistics
+    {
+        static const size_t kNumRoundTripBuckets = 24;
+
+        PacketStatistics ();
+
+        void
+        AddRoundTrip (uint64_t nanos);
+
+        uint64_t packets_sent;
+        uint64_t bytes_sent;
+        uint64_t packets_received;
+        uint64_t bytes_received;
+        uint64_t round_trips;
+        uint64_t round_trip_nanos;
+        uint64_t round_trip_histogram[kNumRoundTripBuckets];
+    };
+
     // Class to change the timeout for a given scope and restore it to the original value when the
     // created ScopedTimeout object got out of scope
     class ScopedTimeout
@@ -121,6 +146,25 @@ public:
                     size_t src_len, 
                     StringExtractorGDBRemote &packet);
 
+    //------------------------------------------------------------------
+    /// Parse the first packet in \a bytes into \a packet.
+    ///
+    /// @param[in] original_packet_size
+    ///     The size of the bytes before they were decompressed, for
+    ///     logging.
+    ///
+    /// @param[out] consumed
+    ///     The number of leading bytes the caller has to drop: the packet
+    ///     or the junk in front of the next one. Zero if the packet isn't
+    ///     complete yet.
+    //------------------------------------------------------------------
+    PacketType
+    ParsePacket (const char *bytes,
+                 size_t bytes_len,
+                 size_t original_packet_size,
+                 StringExtractorGDBRemote &packet,
+                 size_t &consumed);
+
     bool
     IsRunning() const
     {
@@ -133,6 +177,14 @@ public:
         return m_send_acks;
     }
 
+    // True once both sides switched to binary frames, see
+    // SendBinaryPacketNoLock().
+    bool
+    GetBinaryFramingEnabled () const
+    {
+        return m_binary_framing;
+    }
+
     //------------------------------------------------------------------
     // Client and server must implement these pure virtual functions
     //------------------------------------------------------------------
@@ -174,6 +226,36 @@ public:
 
     void
     DumpHistory(Stream &strm);
+
+    // Only updated with the sequence mutex held, reading it without the
+    // lock can give slightly stale numbers.
+    const PacketStatistics &
+    GetPacketStatistics () const
+    {
+        return m_packet_stats;
+    }
+
+    //------------------------------------------------------------------
+    /// Write all the packets sent and received from now on to a file.
+    ///
+    /// Each line of the recording is one packet: the microseconds since
+    /// the recording started, "send", "recv" or "notify", the number of
+    /// bytes the packet took on the connection and its payload as hex.
+    /// The payloads are the ones the other side decoded, acks, framing,
+    /// escapes and compression are left out. "lldb-server replay" serves
+    /// a recording to a client.
+    ///
+    /// @param[in] path
+    ///     The file to write, an existing file is truncated.
+    //------------------------------------------------------------------
+    Error
+    StartRecording (const char *path);
+
+    void
+    StopRecording ();
+
+    bool
+    IsRecording ();
     
 protected:
     class History
@@ -292,12 +374,16 @@ protected:
     Predicate<bool> m_public_is_running;
     Predicate<bool> m_private_is_running;
     History m_history;
+    PacketStatistics m_packet_stats;
     bool m_send_acks;
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
                         // a single process
     
-    CompressionType m_compression_type;
+    CompressionType m_compression_type;      // The compression used by packets we receive
+    CompressionType m_send_compression_type; // The compression used by packets we send
+    size_t m_send_compression_minsize;       // Only packets larger than this are compressed when sending
+    bool m_binary_framing;                   // Packets are sent as length prefixed "!" frames instead of "$...#cs"
 
     PacketResult
     SendPacket (const char *payload,
@@ -307,6 +393,24 @@ protected:
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    // Send a payload that can contain any byte value. With binary framing
+    // it is sent as is, without escaping it or computing a checksum.
+    // Otherwise it is escaped and sent as a normal packet.
+    PacketResult
+    SendBinaryPacketNoLock (const char *payload,
+                            size_t payload_length);
+
+    // Write a framed packet to the connection, log it and wait for the ack
+    // if acks are enabled.
+    PacketResult
+    SendFrameNoLock (const std::string &packet);
+
+    // Send an asynchronous '%' notification packet. Notifications are never
+    // acknowledged, even when the connection is in ack mode.
+    PacketResult
+    SendNotificationPacketNoLock (const char *payload,
+                                  size_t payload_length);
+
     PacketResult
     ReadPacket (StringExtractorGDBRemote &response, uint32_t timeout_usec, bool sync_on_timeout);
 
@@ -322,6 +426,15 @@ protected:
     bool
     WaitForNotRunningPrivate (const TimeValue *timeout_ptr);
 
+    // Add a packet to the recording if there is one, see StartRecording().
+    // If escaped is true, the '}' escapes of the payload are undone first.
+    void
+    RecordPacket (const char *kind,
+                  const char *payload,
+                  size_t payload_length,
+                  size_t wire_length,
+                  bool escaped);
+
     bool
     CompressionIsEnabled ()
     {
@@ -338,6 +451,15 @@ protected:
     bool
     DecompressPacket ();
 
+    // Compress the payload of an outgoing packet with m_send_compression_type.
+    // The resulting payload is either "N<payload>" when the payload is too
+    // small to be worth compressing or couldn't be compressed, or
+    // "C<payload size in base10>:<escaped compressed payload>".
+    void
+    CompressPacket (const char *payload,
+                    size_t payload_length,
+                    std::string &compressed_payload);
+
     Error
     StartListenThread (const char *hostname = "127.0.0.1", uint16_t port = 0);
 
@@ -370,6 +492,10 @@ private:
     HostThread m_listen_thread;
     std::string m_listen_url;
 
+    Mutex m_recording_mutex;
+    std::unique_ptr<StreamFile> m_recording_ap;
+    TimeValue m_recording_start;
+
     DISALLOW_COPY_AND_ASSIGN (GDBRemoteCommunication);
 };
 
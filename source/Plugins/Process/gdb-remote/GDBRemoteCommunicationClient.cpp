@@ -15,6 +15,8 @@
 #include <sys/stat.h>
 
 // C++ Includes
+#include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <numeric>
 
@@ -27,6 +29,7 @@
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamGDBRemote.h"
 #include "lldb/Core/StreamString.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/Endian.h"
 #include "lldb/Host/Host.h"
@@ -66,6 +69,7 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_vCont_C(eLazyBoolCalculate),
       m_supports_vCont_s(eLazyBoolCalculate),
       m_supports_vCont_S(eLazyBoolCalculate),
+      m_supports_vCont_r(eLazyBoolCalculate),
       m_qHostInfo_is_valid(eLazyBoolCalculate),
       m_curr_pid_is_valid(eLazyBoolCalculate),
       m_qProcessInfo_is_valid(eLazyBoolCalculate),
@@ -86,8 +90,16 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_supports_qXfer_libraries_svr4_read(eLazyBoolCalculate),
       m_supports_qXfer_features_read(eLazyBoolCalculate),
       m_supports_augmented_libraries_svr4_read(eLazyBoolCalculate),
+      m_supports_conditional_breakpoints(eLazyBoolCalculate),
+      m_supports_multi_breakpoint(eLazyBoolCalculate),
+      m_supports_counting_breakpoints(eLazyBoolCalculate),
+      m_supports_QPassSignals(eLazyBoolCalculate),
+      m_supports_thread_specific_breakpoints(eLazyBoolCalculate),
       m_supports_jThreadExtendedInfo(eLazyBoolCalculate),
       m_supports_jLoadedDynamicLibrariesInfos(eLazyBoolCalculate),
+      m_supports_jSample(eLazyBoolCalculate),
+      m_supports_qSearch_memory(eLazyBoolCalculate),
+      m_supports_qFindReferences(eLazyBoolCalculate),
       m_supports_qProcessInfoPID(true),
       m_supports_qfProcessInfo(true),
       m_supports_qUserName(true),
@@ -116,6 +128,8 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_async_signal(-1),
       m_interrupt_sent(false),
       m_thread_id_to_used_usec_map(),
+      m_pipeline_queue(),
+      m_pipeline_sender_active(false),
       m_host_arch(),
       m_process_arch(),
       m_os_version_major(UINT32_MAX),
@@ -127,7 +141,9 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient()
       m_gdb_server_name(),
       m_gdb_server_version(UINT32_MAX),
       m_default_packet_timeout(0),
-      m_max_packet_size(0)
+      m_max_packet_size(0),
+      m_binary_framing_max_packet_size(0),
+      m_shared_memory_up()
 {
 }
 
@@ -200,6 +216,56 @@ GDBRemoteCommunicationClient::GetAugmentedLibrariesSVR4ReadSupported ()
     return m_supports_augmented_libraries_svr4_read == eLazyBoolYes;
 }
 
+bool
+GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported ()
+{
+    if (m_supports_conditional_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_conditional_breakpoints == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetMultiBreakpointSupported ()
+{
+    if (m_supports_multi_breakpoint == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_multi_breakpoint == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetCountingBreakpointsSupported ()
+{
+    if (m_supports_counting_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_counting_breakpoints == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetThreadSpecificBreakpointsSupported ()
+{
+    if (m_supports_thread_specific_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_thread_specific_breakpoints == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetQPassSignalsSupported ()
+{
+    if (m_supports_QPassSignals == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_QPassSignals == eLazyBoolYes;
+}
+
 bool
 GDBRemoteCommunicationClient::GetQXferLibrariesSVR4ReadSupported ()
 {
@@ -349,6 +415,7 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_vCont_C = eLazyBoolCalculate;
         m_supports_vCont_s = eLazyBoolCalculate;
         m_supports_vCont_S = eLazyBoolCalculate;
+        m_supports_vCont_r = eLazyBoolCalculate;
         m_supports_p = eLazyBoolCalculate;
         m_supports_x = eLazyBoolCalculate;
         m_supports_QSaveRegisterState = eLazyBoolCalculate;
@@ -365,6 +432,13 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
         m_supports_qXfer_features_read = eLazyBoolCalculate;
         m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+        m_supports_conditional_breakpoints = eLazyBoolCalculate;
+        m_supports_multi_breakpoint = eLazyBoolCalculate;
+        m_supports_counting_breakpoints = eLazyBoolCalculate;
+        m_supports_QPassSignals = eLazyBoolCalculate;
+        m_supports_thread_specific_breakpoints = eLazyBoolCalculate;
+        m_supports_qSearch_memory = eLazyBoolCalculate;
+        m_supports_qFindReferences = eLazyBoolCalculate;
         m_supports_qProcessInfoPID = true;
         m_supports_qfProcessInfo = true;
         m_supports_qUserName = true;
@@ -391,6 +465,7 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings (bool did_exec)
         m_gdb_server_version = UINT32_MAX;
         m_default_packet_timeout = 0;
         m_max_packet_size = 0;
+        m_binary_framing_max_packet_size = 0;
     }
 
     // These flags should be reset when we first connect to a GDB server
@@ -408,7 +483,13 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
     m_supports_qXfer_features_read = eLazyBoolNo;
+    m_supports_conditional_breakpoints = eLazyBoolNo;
+    m_supports_multi_breakpoint = eLazyBoolNo;
+    m_supports_counting_breakpoints = eLazyBoolNo;
+    m_supports_QPassSignals = eLazyBoolNo;
+    m_supports_thread_specific_breakpoints = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
+    m_binary_framing_max_packet_size = 0;
 
     // build the qSupported packet
     std::vector<std::string> features = {"xmlRegisters=i386,arm,mips"};
@@ -439,58 +520,65 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
             m_supports_qXfer_libraries_read = eLazyBoolYes;
         if (::strstr (response_cstr, "qXfer:features:read+"))
             m_supports_qXfer_features_read = eLazyBoolYes;
+        if (::strstr (response_cstr, "ConditionalBreakpoints+"))
+            m_supports_conditional_breakpoints = eLazyBoolYes;
+        if (::strstr (response_cstr, "MultiBreakpoint+"))
+            m_supports_multi_breakpoint = eLazyBoolYes;
+        if (::strstr (response_cstr, "CountingBreakpoints+"))
+            m_supports_counting_breakpoints = eLazyBoolYes;
+        if (::strstr (response_cstr, "QPassSignals+"))
+            m_supports_QPassSignals = eLazyBoolYes;
+        if (::strstr (response_cstr, "ThreadSpecificBreakpoints+"))
+            m_supports_thread_specific_breakpoints = eLazyBoolYes;
 
 
         // Look for a list of compressions in the features list e.g.
         // qXfer:features:read+;PacketSize=20000;qEcho+;SupportedCompressions=zlib-deflate,lzma
-        const char *features_list = ::strstr (response_cstr, "qXfer:features:");
-        if (features_list)
+        // lldb-server doesn't support qXfer:features: so look in the whole reply.
+        const char *compressions = ::strstr (response_cstr, "SupportedCompressions=");
+        if (compressions)
         {
-            const char *compressions = ::strstr (features_list, "SupportedCompressions=");
-            if (compressions)
+            std::vector<std::string> supported_compressions;
+            compressions += sizeof ("SupportedCompressions=") - 1;
+            const char *end_of_compressions = strchr (compressions, ';');
+            if (end_of_compressions == NULL)
             {
-                std::vector<std::string> supported_compressions;
-                compressions += sizeof ("SupportedCompressions=") - 1;
-                const char *end_of_compressions = strchr (compressions, ';');
-                if (end_of_compressions == NULL)
+                end_of_compressions = strchr (compressions, '\0');
+            }
+            const char *current_compression = compressions;
+            while (current_compression < end_of_compressions)
+            {
+                const char *next_compression_name = strchr (current_compression, ',');
+                const char *end_of_this_word = next_compression_name;
+                if (next_compression_name == NULL || end_of_compressions < next_compression_name)
                 {
-                    end_of_compressions = strchr (compressions, '\0');
+                    end_of_this_word = end_of_compressions;
                 }
-                const char *current_compression = compressions;
-                while (current_compression < end_of_compressions)
-                {
-                    const char *next_compression_name = strchr (current_compression, ',');
-                    const char *end_of_this_word = next_compression_name;
-                    if (next_compression_name == NULL || end_of_compressions < next_compression_name)
-                    {
-                        end_of_this_word = end_of_compressions;
-                    }
 
-                    if (end_of_this_word)
+                if (end_of_this_word)
+                {
+                    if (end_of_this_word == current_compression)
                     {
-                        if (end_of_this_word == current_compression)
-                        {
-                            current_compression++;
-                        }
-                        else
-                        {
-                            std::string this_compression (current_compression, end_of_this_word - current_compression);
-                            supported_compressions.push_back (this_compression);
-                            current_compression = end_of_this_word + 1;
-                        }
+                        current_compression++;
                     }
                     else
                     {
-                        supported_compressions.push_back (current_compression);
-                        current_compression = end_of_compressions;
+                        std::string this_compression (current_compression, end_of_this_word - current_compression);
+                        supported_compressions.push_back (this_compression);
+                        current_compression = end_of_this_word + 1;
                     }
                 }
-
-                if (supported_compressions.size() > 0)
+                else
                 {
-                    MaybeEnableCompression (supported_compressions);
+                    supported_compressions.push_back (current_compression);
+                    current_compression = end_of_compressions;
                 }
             }
+
+            if (supported_compressions.size() > 0)
+            {
+                MaybeEnableCompression (supported_compressions);
+            }
         }
 
         if (::strstr (response_cstr, "qEcho"))
@@ -511,6 +599,17 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
                     log->Printf ("Garbled PacketSize spec in qSupported response");
             }
         }
+
+        const char *binary_framing_str = ::strstr (response_cstr, "BinaryFraming=");
+        if (binary_framing_str)
+        {
+            StringExtractorGDBRemote packet_response(binary_framing_str + strlen("BinaryFraming="));
+            m_binary_framing_max_packet_size = packet_response.GetHexMaxU64(/*little_endian=*/false, 0);
+        }
+
+        // Once binary framing is on, the bigger packets are the limit.
+        if (GetBinaryFramingEnabled() && m_binary_framing_max_packet_size > 0)
+            m_max_packet_size = m_binary_framing_max_packet_size;
     }
 }
 
@@ -541,6 +640,7 @@ GDBRemoteCommunicationClient::GetVContSupported (char flavor)
         m_supports_vCont_C = eLazyBoolNo;
         m_supports_vCont_s = eLazyBoolNo;
         m_supports_vCont_S = eLazyBoolNo;
+        m_supports_vCont_r = eLazyBoolNo;
         if (SendPacketAndWaitForResponse("vCont?", response, false) == PacketResult::Success)
         {
             const char *response_cstr = response.GetStringRef().c_str();
@@ -556,6 +656,9 @@ GDBRemoteCommunicationClient::GetVContSupported (char flavor)
             if (::strstr (response_cstr, ";S"))
                 m_supports_vCont_S = eLazyBoolYes;
 
+            if (::strstr (response_cstr, ";r"))
+                m_supports_vCont_r = eLazyBoolYes;
+
             if (m_supports_vCont_c == eLazyBoolYes &&
                 m_supports_vCont_C == eLazyBoolYes &&
                 m_supports_vCont_s == eLazyBoolYes &&
@@ -582,6 +685,7 @@ GDBRemoteCommunicationClient::GetVContSupported (char flavor)
     case 'C': return m_supports_vCont_C;
     case 's': return m_supports_vCont_s;
     case 'S': return m_supports_vCont_S;
+    case 'r': return m_supports_vCont_r;
     default: break;
     }
     return false;
@@ -614,11 +718,11 @@ GDBRemoteCommunicationClient::GetpPacketSupported (lldb::tid_t tid)
     return m_supports_p;
 }
 
-StructuredData::ObjectSP
-GDBRemoteCommunicationClient::GetThreadsInfo()
+bool
+GDBRemoteCommunicationClient::GetThreadsInfo (std::string &json)
 {
     // Get information on all threads at one using the "jThreadsInfo" packet
-    StructuredData::ObjectSP object_sp;
+    json.clear();
 
     if (m_supports_jThreadsInfo)
     {
@@ -632,11 +736,11 @@ GDBRemoteCommunicationClient::GetThreadsInfo()
             }
             else if (!response.Empty())
             {
-                object_sp = StructuredData::ParseJSON (response.GetStringRef());
+                json.swap(response.GetStringRef());
             }
         }
     }
-    return object_sp;
+    return !json.empty();
 }
 
 
@@ -676,6 +780,23 @@ GDBRemoteCommunicationClient::GetLoadedDynamicLibrariesInfosSupported ()
     return m_supports_jLoadedDynamicLibrariesInfos;
 }
 
+bool
+GDBRemoteCommunicationClient::GetSamplingSupported ()
+{
+    if (m_supports_jSample == eLazyBoolCalculate)
+    {
+        // Reading works without a sampling run and replies with no samples.
+        StringExtractorGDBRemote response;
+        m_supports_jSample = eLazyBoolNo;
+        if (SendPacketAndWaitForResponse("jSampleRead:0,1", response, false) == PacketResult::Success)
+        {
+            if (response.IsNormalResponse())
+                m_supports_jSample = eLazyBoolYes;
+        }
+    }
+    return m_supports_jSample;
+}
+
 bool
 GDBRemoteCommunicationClient::GetxPacketSupported ()
 {
@@ -761,11 +882,219 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
                                          send_async);
 }
 
+GDBRemoteCommunicationClient::PacketResult
+GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                                              std::vector<StringExtractorGDBRemote> &responses)
+{
+    // Limit the number of packets in flight so that the responses we haven't read yet can't
+    // fill up the connection buffers while we are still sending.
+    const size_t max_packets_in_flight = 32;
+
+    responses.clear();
+    responses.reserve(payloads.size());
+
+    Mutex::Locker locker;
+    if (!GetSequenceMutex(locker,
+                          "GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses() failed due to not getting the sequence mutex"))
+    {
+        Log *log (ProcessGDBRemoteLog::GetLogIfAnyCategoryIsSet (GDBR_LOG_PROCESS | GDBR_LOG_PACKETS));
+        if (log)
+            log->Printf("error: failed to get packet sequence mutex, not sending %" PRIu64 " packets",
+                        (uint64_t)payloads.size());
+        return PacketResult::ErrorNoSequenceLock;
+    }
+
+    m_prefetched_responses.clear();
+
+    // Hold async notifications back until we have all the responses like
+    // SendPacketAndWaitForResponse() does.
+    static ListenerSP hijack_listener_sp(Listener::MakeListener("lldb.NotifyHijacker"));
+    HijackBroadcaster(hijack_listener_sp, eBroadcastBitGdbReadThreadGotNotify);
+
+    PacketResult packet_result = PacketResult::Success;
+    if (GetSendAcks())
+    {
+        for (const std::string &payload : payloads)
+        {
+            StringExtractorGDBRemote response;
+            packet_result = SendPacketAndWaitForResponseNoLock(payload.data(), payload.size(), response);
+            if (packet_result != PacketResult::Success)
+                break;
+            responses.push_back(std::move(response));
+        }
+    }
+    else
+    {
+        size_t num_sent = 0;
+        while (responses.size() < payloads.size())
+        {
+            while (num_sent < payloads.size() && num_sent - responses.size() < max_packets_in_flight)
+            {
+                packet_result = SendPacketNoLock(payloads[num_sent].data(), payloads[num_sent].size());
+                if (packet_result != PacketResult::Success)
+                    break;
+                ++num_sent;
+            }
+            if (packet_result != PacketResult::Success)
+                break;
+
+            StringExtractorGDBRemote response;
+            packet_result = ReadPacket(response, GetPacketTimeoutInMicroSeconds (), true);
+            if (packet_result != PacketResult::Success)
+                break;
+            responses.push_back(std::move(response));
+        }
+    }
+
+    RestoreBroadcaster();
+
+    EventSP event_sp;
+    if (hijack_listener_sp->GetNextEvent(event_sp))
+        BroadcastEvent(event_sp);
+
+    return packet_result;
+}
+
+void
+GDBRemoteCommunicationClient::PrefetchResponses (const std::vector<std::string> &payloads)
+{
+    std::vector<StringExtractorGDBRemote> responses;
+    SendPacketsAndWaitForResponses(payloads, responses);
+
+    Mutex::Locker locker;
+    if (!GetSequenceMutex(locker))
+        return;
+    for (size_t i = 0; i < responses.size(); ++i)
+        m_prefetched_responses.push_back(std::make_pair(payloads[i], std::move(responses[i])));
+}
+
+GDBRemoteCommunicationClient::PacketResult
+GDBRemoteCommunicationClient::SendPipelinedPacketAndWaitForResponse (const char *payload,
+                                                                     size_t payload_length,
+                                                                     StringExtractorGDBRemote &response)
+{
+    // Each packet would have to be acked before the next one can be sent.
+    if (GetSendAcks())
+        return SendPacketAndWaitForResponse(payload, payload_length, response, false);
+
+    // Same limit as SendPacketsAndWaitForResponses().
+    const size_t max_packets_in_flight = 32;
+
+    PipelinedRequest request = { payload, payload_length, &response, PacketResult::Success, false };
+
+    std::unique_lock<std::mutex> pipeline_lock(m_pipeline_mutex);
+    m_pipeline_queue.push_back(&request);
+    if (m_pipeline_sender_active)
+    {
+        // The sending thread holds the sequence mutex while it has packets
+        // in flight. If we can get the mutex it is still waiting for it,
+        // possibly for us if we hold it already, so we send our packet
+        // ourselves.
+        Mutex::Locker locker;
+        if (locker.TryLock(m_sequence_mutex))
+        {
+            m_pipeline_queue.erase(std::find(m_pipeline_queue.begin(), m_pipeline_queue.end(), &request));
+            pipeline_lock.unlock();
+            return SendPacketAndWaitForResponseNoLock(payload, payload_length, response);
+        }
+
+        // Otherwise it sends our packet and hands us the response.
+        m_pipeline_condition.wait(pipeline_lock, [&request] { return request.done; });
+        return request.result;
+    }
+    m_pipeline_sender_active = true;
+    pipeline_lock.unlock();
+
+    Mutex::Locker locker;
+    const bool got_sequence_mutex = GetSequenceMutex(locker,
+            "GDBRemoteCommunicationClient::SendPipelinedPacketAndWaitForResponse() failed due to not getting the sequence mutex");
+
+    static ListenerSP hijack_listener_sp(Listener::MakeListener("lldb.NotifyHijacker"));
+    if (got_sequence_mutex)
+    {
+        m_prefetched_responses.clear();
+        HijackBroadcaster(hijack_listener_sp, eBroadcastBitGdbReadThreadGotNotify);
+    }
+
+    // Keep going as long as somebody has a packet in the pipeline, the
+    // packets that show up while we wait for a response go out right after.
+    std::deque<PipelinedRequest *> in_flight;
+    pipeline_lock.lock();
+    while (!m_pipeline_queue.empty() || !in_flight.empty())
+    {
+        while (!m_pipeline_queue.empty() && in_flight.size() < max_packets_in_flight)
+        {
+            PipelinedRequest *next = m_pipeline_queue.front();
+            m_pipeline_queue.pop_front();
+            pipeline_lock.unlock();
+            next->result = got_sequence_mutex ? SendPacketNoLock(next->payload, next->payload_length)
+                                              : PacketResult::ErrorNoSequenceLock;
+            pipeline_lock.lock();
+            if (next->result == PacketResult::Success)
+                in_flight.push_back(next);
+            else
+            {
+                next->done = true;
+                m_pipeline_condition.notify_all();
+            }
+        }
+        if (in_flight.empty())
+            continue;
+
+        PipelinedRequest *oldest = in_flight.front();
+        in_flight.pop_front();
+        pipeline_lock.unlock();
+        oldest->result = ReadPacket(*oldest->response, GetPacketTimeoutInMicroSeconds (), true);
+        pipeline_lock.lock();
+        oldest->done = true;
+
+        // Without its response we can't tell which response belongs to
+        // which packet anymore.
+        if (oldest->result != PacketResult::Success)
+        {
+            for (PipelinedRequest *pending : in_flight)
+            {
+                pending->result = oldest->result;
+                pending->done = true;
+            }
+            in_flight.clear();
+        }
+        m_pipeline_condition.notify_all();
+    }
+    m_pipeline_sender_active = false;
+    pipeline_lock.unlock();
+
+    if (got_sequence_mutex)
+    {
+        RestoreBroadcaster();
+        EventSP event_sp;
+        if (hijack_listener_sp->GetNextEvent(event_sp))
+            BroadcastEvent(event_sp);
+    }
+    return request.result;
+}
+
 GDBRemoteCommunicationClient::PacketResult
 GDBRemoteCommunicationClient::SendPacketAndWaitForResponseNoLock (const char *payload,
                                                                   size_t payload_length,
                                                                   StringExtractorGDBRemote &response)
 {
+    // Use the response we prefetched for this packet if it is the next one we expect. If it
+    // isn't, the following prefetched responses may be out of date after this packet, so we
+    // discard all of them.
+    if (!m_prefetched_responses.empty())
+    {
+        if (m_prefetched_responses.front().first.compare(0, std::string::npos, payload, payload_length) == 0)
+        {
+            response.GetStringRef().swap(m_prefetched_responses.front().second.GetStringRef());
+            response.SetFilePos(0);
+            m_prefetched_responses.pop_front();
+            return PacketResult::Success;
+        }
+        m_prefetched_responses.clear();
+    }
+
+    IntervalTimer round_trip_timer;
     PacketResult packet_result = SendPacketNoLock(payload, payload_length);
     if (packet_result == PacketResult::Success)
     {
@@ -778,7 +1107,10 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponseNoLock (const char *pa
                 return packet_result;
             // Make sure our response is valid for the payload that was sent
             if (response.ValidateResponse())
+            {
+                m_packet_stats.AddRoundTrip (round_trip_timer.GetElapsedNanoSeconds());
                 return packet_result;
+            }
             // Response says it wasn't valid
             Log *log = ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PACKETS);
             if (log)
@@ -1042,6 +1374,9 @@ GDBRemoteCommunicationClient::SendvContPacket
     if (log)
         log->Printf("GDBRemoteCommunicationClient::%s () sending vCont packet: %s", __FUNCTION__, continue_packet.c_str());
 
+    // Anything we prefetched is out of date once the process runs.
+    m_prefetched_responses.clear();
+
     if (SendPacketNoLock(continue_packet.c_str(), continue_packet.size()) != PacketResult::Success)
          return false;
 
@@ -1420,6 +1755,7 @@ GDBRemoteCommunicationClient::SendInterrupt
             size_t bytes_written = Write (&ctrl_c, 1, status, NULL);
             if (log)
                 log->PutCString("send packet: \\x03");
+            RecordPacket ("send", &ctrl_c, 1, bytes_written, false);
             if (bytes_written > 0)
             {
                 m_interrupt_sent = true;
@@ -1918,6 +2254,21 @@ GDBRemoteCommunicationClient::MaybeEnableCompression (std::vector<std::string> s
     }
 #endif
 
+#if defined (HAVE_LIBLZ4)
+    if (avail_type == CompressionType::None)
+    {
+        for (auto compression : supported_compressions)
+        {
+            if (compression == "lz4")
+            {
+                avail_type = CompressionType::LZ4;
+                avail_name = compression;
+                break;
+            }
+        }
+    }
+#endif
+
 #if defined (HAVE_LIBCOMPRESSION)
     // libcompression is weak linked so test if compression_decode_buffer() is available
     if (compression_decode_buffer != NULL && avail_type == CompressionType::None)
@@ -1932,20 +2283,246 @@ GDBRemoteCommunicationClient::MaybeEnableCompression (std::vector<std::string> s
             }
         }
     }
-#endif
+#endif
+
+    if (avail_type != CompressionType::None)
+    {
+        StringExtractorGDBRemote response;
+        std::string packet = "QEnableCompression:type:" + avail_name + ";";
+        if (SendPacketAndWaitForResponse (packet.c_str(), response, false) !=  PacketResult::Success)
+            return;
+    
+        if (response.IsOKResponse())
+        {
+            m_compression_type = avail_type;
+        }
+    }
+}
+
+bool
+GDBRemoteCommunicationClient::EnableBinaryFraming ()
+{
+    if (GetBinaryFramingEnabled())
+        return true;
+
+    // Binary frames have no checksum, so only use them on connections that
+    // are reliable enough to not need acks. They also replace compression,
+    // which is meant for slow connections.
+    if (GetSendAcks() || CompressionIsEnabled())
+        return false;
+
+    GetRemoteMaxPacketSize(); // May send qSupported packet
+    if (m_binary_framing_max_packet_size == 0)
+        return false;
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse("QEnableBinaryFraming", response, false) != PacketResult::Success)
+        return false;
+
+    if (!response.IsOKResponse())
+        return false;
+
+    m_binary_framing = true;
+    m_max_packet_size = m_binary_framing_max_packet_size;
+    return true;
+}
+
+bool
+GDBRemoteCommunicationClient::EnableSharedMemory (size_t size)
+{
+#if defined(__ANDROID_NDK__)
+    return false;
+#else
+    if (m_shared_memory_up)
+        return true;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+
+    static std::atomic<uint32_t> g_shared_memory_id(0);
+    StreamString name;
+    name.Printf ("/lldb-%" PRIu64 "-%u", (uint64_t)Host::GetCurrentProcessID(), g_shared_memory_id++);
+
+    std::unique_ptr<ConnectionSharedMemory> shared_memory_up (new ConnectionSharedMemory ());
+    Error error;
+    if (shared_memory_up->Open (true, name.GetData(), size, &error) != eConnectionStatusSuccess)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationClient::%s failed to create %s: %s", __FUNCTION__, name.GetData(), error.AsCString());
+        return false;
+    }
+
+    StreamString packet;
+    packet.PutCString ("QSetSharedMemory:name:");
+    packet.PutCStringAsRawHex8 (name.GetData());
+    packet.Printf (";size:%" PRIx64 ";", (uint64_t)size);
+    StringExtractorGDBRemote response;
+    const bool success = SendPacketAndWaitForResponse (packet.GetData(), response, false) == PacketResult::Success &&
+                         response.IsOKResponse();
+
+    // The server mapped it or never will, either way the name isn't
+    // needed anymore.
+    shared_memory_up->Unlink ();
+    if (!success)
+        return false;
+
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s using %" PRIu64 " bytes of shared memory for memory reads", __FUNCTION__, (uint64_t)size);
+    m_shared_memory_up = std::move (shared_memory_up);
+    return true;
+#endif
+}
+
+size_t
+GDBRemoteCommunicationClient::ReadMemoryShared (lldb::addr_t addr, void *dst, size_t dst_len, Error &error)
+{
+    const size_t shared_size = GetSharedMemoryReadSize();
+    if (shared_size == 0)
+    {
+        error.SetErrorString ("no shared memory");
+        return 0;
+    }
+    dst_len = std::min (dst_len, shared_size);
+
+    char packet[64];
+    const int packet_len = ::snprintf (packet, sizeof(packet), "qReadMemoryShared:%" PRIx64 ",%" PRIx64, (uint64_t)addr, (uint64_t)dst_len);
+    assert (packet_len + 1 < (int)sizeof(packet));
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet, packet_len, response, true) != PacketResult::Success)
+    {
+        error.SetErrorStringWithFormat ("failed to send packet: '%s'", packet);
+        return 0;
+    }
+    if (response.IsErrorResponse())
+    {
+        error.SetErrorStringWithFormat ("memory read failed for 0x%" PRIx64, addr);
+        return 0;
+    }
+
+    const uint64_t offset = response.GetHexMaxU64 (false, UINT64_MAX);
+    const uint64_t bytes_read = (response.GetChar() == ',') ? response.GetHexMaxU64 (false, 0) : 0;
+    if (offset > shared_size || bytes_read == 0 || bytes_read > dst_len || bytes_read > shared_size - offset)
+    {
+        error.SetErrorStringWithFormat ("unexpected response to qReadMemoryShared packet: '%s'", response.GetStringRef().c_str());
+        return 0;
+    }
+
+    error.Clear();
+    memcpy (dst, m_shared_memory_up->GetBytes() + offset, bytes_read);
+    return bytes_read;
+}
+
+bool
+GDBRemoteCommunicationClient::SearchMemory (lldb::addr_t addr,
+                                            uint64_t length,
+                                            const uint8_t *pattern,
+                                            size_t pattern_size,
+                                            lldb::addr_t &found_addr)
+{
+    found_addr = LLDB_INVALID_ADDRESS;
+    if (m_supports_qSearch_memory == eLazyBoolNo)
+        return false;
+
+    // qSearch:memory:<addr>;<length>;<escaped pattern>
+    StreamGDBRemote packet;
+    packet.Printf ("qSearch:memory:%" PRIx64 ";%" PRIx64 ";", (uint64_t)addr, length);
+    packet.PutEscapedBytes (pattern, pattern_size);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return false;
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_qSearch_memory = eLazyBoolNo;
+        return false;
+    }
+    if (response.IsErrorResponse())
+        return false;
+    m_supports_qSearch_memory = eLazyBoolYes;
+
+    // "0" for no match, "1,<addr>" for a match
+    switch (response.GetChar())
+    {
+        case '0':
+            return true;
+        case '1':
+            if (response.GetChar() != ',')
+                return false;
+            found_addr = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+            return found_addr != LLDB_INVALID_ADDRESS;
+        default:
+            return false;
+    }
+}
+
+Error
+GDBRemoteCommunicationClient::FindReferences (uint64_t value, size_t max_matches, std::vector<lldb::addr_t> &matches)
+{
+    Error error;
+    matches.clear();
+    if (m_supports_qFindReferences == eLazyBoolNo)
+    {
+        error.SetErrorString ("qFindReferences is not supported");
+        return error;
+    }
 
-    if (avail_type != CompressionType::None)
+    lldb::addr_t start_addr = 0;
+    while (matches.size() < max_matches)
     {
+        // qFindReferences:<value>,<start addr>,<max matches>
+        StreamString packet;
+        packet.Printf ("qFindReferences:%" PRIx64 ",%" PRIx64 ",%" PRIx64, value, (uint64_t)start_addr,
+                       (uint64_t)(max_matches - matches.size()));
+
         StringExtractorGDBRemote response;
-        std::string packet = "QEnableCompression:type:" + avail_name + ";";
-        if (SendPacketAndWaitForResponse (packet.c_str(), response, false) !=  PacketResult::Success)
-            return;
-    
-        if (response.IsOKResponse())
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
         {
-            m_compression_type = avail_type;
+            error.SetErrorString ("failed to send qFindReferences packet");
+            return error;
+        }
+        if (response.IsUnsupportedResponse())
+        {
+            m_supports_qFindReferences = eLazyBoolNo;
+            error.SetErrorString ("qFindReferences is not supported");
+            return error;
+        }
+        if (response.IsErrorResponse())
+        {
+            error.SetErrorStringWithFormat ("qFindReferences failed with error 0x%2.2x", response.GetError());
+            return error;
+        }
+        m_supports_qFindReferences = eLazyBoolYes;
+
+        // 'm' if the stub capped the reply, 'l' for the last one, followed
+        // by the comma separated match addresses.
+        const char more = response.GetChar();
+        if (more != 'm' && more != 'l')
+        {
+            error.SetErrorString ("invalid qFindReferences response");
+            return error;
+        }
+        while (response.GetBytesLeft() > 0)
+        {
+            const lldb::addr_t match_addr = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+            if (match_addr == LLDB_INVALID_ADDRESS)
+            {
+                error.SetErrorString ("invalid qFindReferences response");
+                return error;
+            }
+            matches.push_back (match_addr);
+            if (response.GetBytesLeft() > 0 && response.GetChar() != ',')
+            {
+                error.SetErrorString ("invalid qFindReferences response");
+                return error;
+            }
         }
+        if (more == 'l' || matches.empty() || matches.back() + 1 <= start_addr)
+            break;
+        // The stub aligns the start address up to the next pointer
+        start_addr = matches.back() + 1;
     }
+    if (matches.size() > max_matches)
+        matches.resize (max_matches);
+    return error;
 }
 
 const char *
@@ -3138,6 +3715,158 @@ GDBRemoteCommunicationClient::GetGroupName (uint32_t gid, std::string &name)
     return false;
 }
 
+Error
+GDBRemoteCommunicationClient::StartBranchTrace (lldb::tid_t tid, size_t buffer_size)
+{
+    StreamString packet;
+    packet.Printf ("jTraceStart:%" PRIx64 ",%" PRIx64, tid, static_cast<uint64_t>(buffer_size));
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return Error ("failed to send the jTraceStart packet");
+    if (response.IsUnsupportedResponse ())
+        return Error ("the remote stub doesn't support branch tracing");
+    if (!response.IsOKResponse ())
+        return Error ("the remote stub failed to start tracing thread 0x%" PRIx64, tid);
+    return Error ();
+}
+
+Error
+GDBRemoteCommunicationClient::StopBranchTrace (lldb::tid_t tid)
+{
+    StreamString packet;
+    packet.Printf ("jTraceStop:%" PRIx64, tid);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return Error ("failed to send the jTraceStop packet");
+    if (response.IsUnsupportedResponse ())
+        return Error ("the remote stub doesn't support branch tracing");
+    if (!response.IsOKResponse ())
+        return Error ("thread 0x%" PRIx64 " is not being traced", tid);
+    return Error ();
+}
+
+Error
+GDBRemoteCommunicationClient::GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches)
+{
+    branches.clear ();
+    for (;;)
+    {
+        StreamString packet;
+        packet.Printf ("jTraceRead:%" PRIx64 ",%" PRIx64 ",800", tid, static_cast<uint64_t>(branches.size ()));
+
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+            return Error ("failed to send the jTraceRead packet");
+        if (response.IsUnsupportedResponse ())
+            return Error ("the remote stub doesn't support branch tracing");
+
+        // 'm' is followed by more replies, 'l' is the last one.
+        const char more = response.GetChar ();
+        if (more != 'm' && more != 'l')
+            return Error ("thread 0x%" PRIx64 " is not being traced", tid);
+
+        while (response.GetBytesLeft () > 0)
+        {
+            const lldb::addr_t from = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+            if (response.GetChar () != ',')
+                return Error ("invalid jTraceRead reply");
+            const lldb::addr_t to = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+            branches.push_back (std::make_pair (from, to));
+            if (response.GetBytesLeft () > 0 && response.GetChar () != ';')
+                return Error ("invalid jTraceRead reply");
+        }
+
+        if (more == 'l')
+            return Error ();
+    }
+}
+
+Error
+GDBRemoteCommunicationClient::GetSamples (std::vector<std::pair<lldb::tid_t, std::vector<lldb::addr_t>>> &samples)
+{
+    samples.clear ();
+    for (;;)
+    {
+        StreamString packet;
+        packet.Printf ("jSampleRead:%" PRIx64 ",40", static_cast<uint64_t>(samples.size ()));
+
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+            return Error ("failed to send the jSampleRead packet");
+        if (response.IsUnsupportedResponse ())
+            return Error ("the remote stub doesn't support sampling");
+
+        // 'm' is followed by more replies, 'l' is the last one.
+        const char more = response.GetChar ();
+        if (more != 'm' && more != 'l')
+            return Error ("invalid jSampleRead reply");
+
+        // <tid>:<pc>,<return address>,...;
+        while (response.GetBytesLeft () > 0)
+        {
+            const lldb::tid_t tid = response.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+            if (response.GetChar () != ':')
+                return Error ("invalid jSampleRead reply");
+
+            std::vector<lldb::addr_t> pcs;
+            for (;;)
+            {
+                pcs.push_back (response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS));
+                const char separator = response.GetChar ();
+                if (separator == ';')
+                    break;
+                if (separator != ',')
+                    return Error ("invalid jSampleRead reply");
+            }
+            samples.push_back (std::make_pair (tid, std::move (pcs)));
+        }
+
+        if (more == 'l')
+            return Error ();
+    }
+}
+
+Error
+GDBRemoteCommunicationClient::SaveCheckpoint (uint32_t &checkpoint_id)
+{
+    checkpoint_id = 0;
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse ("QSaveCheckpoint", response, false) != PacketResult::Success)
+        return Error ("failed to send the QSaveCheckpoint packet");
+    if (response.IsUnsupportedResponse ())
+        return Error ("the remote stub doesn't support checkpoints");
+    if (response.IsErrorResponse ())
+        return Error ("the remote stub failed to save a checkpoint");
+
+    checkpoint_id = response.GetU32 (0);
+    if (checkpoint_id == 0)
+        return Error ("invalid QSaveCheckpoint reply");
+    return Error ();
+}
+
+Error
+GDBRemoteCommunicationClient::RestoreCheckpoint (uint32_t checkpoint_id, StringExtractorGDBRemote &stop_reply)
+{
+    StreamString packet;
+    packet.Printf ("QRestoreCheckpoint:%" PRIu32, checkpoint_id);
+
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), stop_reply, false) != PacketResult::Success)
+        return Error ("failed to send the QRestoreCheckpoint packet");
+    if (stop_reply.IsUnsupportedResponse ())
+        return Error ("the remote stub doesn't support checkpoints");
+    if (stop_reply.GetResponseType () != StringExtractorGDBRemote::eResponse)
+        return Error ("the remote stub failed to restore checkpoint %" PRIu32, checkpoint_id);
+
+    // The threads and maybe the process are new.
+    m_curr_tid = LLDB_INVALID_THREAD_ID;
+    m_curr_tid_run = LLDB_INVALID_THREAD_ID;
+    m_curr_pid_is_valid = eLazyBoolCalculate;
+    return Error ();
+}
+
 bool
 GDBRemoteCommunicationClient::SetNonStopMode (const bool enable)
 {
@@ -3157,6 +3886,24 @@ GDBRemoteCommunicationClient::SetNonStopMode (const bool enable)
 
 }
 
+bool
+GDBRemoteCommunicationClient::SendSignalsToIgnore (const std::vector<int32_t> &signals)
+{
+    StreamString packet;
+    packet.PutCString ("QPassSignals:");
+    for (size_t i = 0; i < signals.size(); ++i)
+    {
+        if (i > 0)
+            packet.PutChar (';');
+        packet.Printf ("%x", signals[i]);
+    }
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, false) == PacketResult::Success)
+        return response.IsOKResponse();
+    return false;
+}
+
 static void
 MakeSpeedTestPacket(StreamString &packet, uint32_t send_size, uint32_t recv_size)
 {
@@ -3565,7 +4312,9 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (lldb::tid_t tid, StringExtracto
 
 
 uint8_t
-GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
+GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length,
+                                                          const std::vector<AgentExpression> *conditions, bool counting,
+                                                          const std::vector<lldb::tid_t> *thread_ids)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
     if (log)
@@ -3576,21 +4325,30 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     if (!SupportsGDBStoppointPacket(type))
         return UINT8_MAX;
     // Construct the breakpoint packet
-    char packet[64];
-    const int packet_len = ::snprintf (packet, 
-                                       sizeof(packet), 
-                                       "%c%i,%" PRIx64 ",%x",
-                                       insert ? 'Z' : 'z', 
-                                       type, 
-                                       addr, 
-                                       length);
-    // Check we haven't overwritten the end of the packet buffer
-    assert (packet_len + 1 < (int)sizeof(packet));
+    StreamString packet;
+    packet.Printf ("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr, length);
+    if (insert && conditions)
+    {
+        for (const AgentExpression &condition : *conditions)
+        {
+            const std::vector<uint8_t> &bytes = condition.GetBytes();
+            packet.Printf (";X%" PRIx64 ",", (uint64_t)bytes.size());
+            packet.PutBytesAsRawHex8 (bytes.data(), bytes.size());
+        }
+    }
+    if (insert && counting)
+        packet.PutCString (";counting");
+    if (insert && thread_ids && !thread_ids->empty())
+    {
+        packet.PutCString (";threads:");
+        for (size_t i = 0; i < thread_ids->size(); ++i)
+            packet.Printf ("%s%" PRIx64, i > 0 ? "," : "", (*thread_ids)[i]);
+    }
     StringExtractorGDBRemote response;
     // Make sure the response is either "OK", "EXX" where XX are two hex digits, or "" (unsupported)
     response.SetResponseValidatorToOKErrorNotSupported();
     // Try to send the breakpoint packet, and check that it was correctly sent
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, true) == PacketResult::Success)
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) == PacketResult::Success)
     {
         // Receive and OK packet when the breakpoint successfully placed
         if (response.IsOKResponse())
@@ -3619,6 +4377,117 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     return UINT8_MAX;
 }
 
+bool
+GDBRemoteCommunicationClient::GetBreakpointHitCounts (std::vector<std::pair<lldb::addr_t, uint64_t>> &hit_counts)
+{
+    hit_counts.clear();
+    if (!GetCountingBreakpointsSupported())
+        return false;
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse("qBreakpointHitCounts", response, false) != PacketResult::Success ||
+        response.IsErrorResponse() || response.IsUnsupportedResponse())
+        return false;
+
+    // "<addr>:<count>;" for each breakpoint, in hex, or "OK" if there are none.
+    if (response.IsOKResponse())
+        return true;
+    while (response.GetBytesLeft() > 0)
+    {
+        const addr_t addr = response.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (addr == LLDB_INVALID_ADDRESS || response.GetChar() != ':')
+            return false;
+        const uint64_t count = response.GetHexMaxU64(false, 0);
+        if (response.GetChar() != ';')
+            return false;
+        hit_counts.push_back(std::make_pair(addr, count));
+    }
+    return true;
+}
+
+void
+GDBRemoteCommunicationClient::SendSoftwareBreakpointPackets (bool insert,
+                                                             const std::vector<std::pair<lldb::addr_t, uint32_t>> &breakpoints,
+                                                             std::vector<uint8_t> &error_nos)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s() %s %" PRIu64 " breakpoints",
+                     __FUNCTION__, insert ? "add" : "remove", (uint64_t)breakpoints.size());
+
+    error_nos.assign (breakpoints.size(), UINT8_MAX);
+    if (!SupportsGDBStoppointPacket(eBreakpointSoftware))
+        return;
+
+    size_t next_idx = 0;
+    if (GetMultiBreakpointSupported())
+    {
+        // Stay well within the packet size the stub can handle.
+        const uint64_t max_packet_size = std::min<uint64_t>(GetRemoteMaxPacketSize(), 16 * 1024) - 64;
+        while (next_idx < breakpoints.size())
+        {
+            const size_t first_idx = next_idx;
+            StreamString packet;
+            packet.Printf ("MultiBreakpoint:%s:", insert ? "insert" : "remove");
+            while (next_idx < breakpoints.size() && (next_idx == first_idx || packet.GetSize() < max_packet_size))
+            {
+                packet.Printf ("%s%" PRIx64 ",%x", next_idx > first_idx ? "," : "",
+                               breakpoints[next_idx].first, breakpoints[next_idx].second);
+                ++next_idx;
+            }
+            packet.PutChar (';');
+
+            StringExtractorGDBRemote response;
+            if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+                return;
+            if (response.IsUnsupportedResponse())
+            {
+                // Fall back to one packet per breakpoint
+                m_supports_multi_breakpoint = eLazyBoolNo;
+                next_idx = first_idx;
+                break;
+            }
+
+            for (size_t idx = first_idx; idx < next_idx; ++idx)
+            {
+                const char ch = response.GetChar();
+                if (ch == 'O' && response.GetChar() == 'K')
+                    error_nos[idx] = 0;
+                else if (ch == 'E')
+                    error_nos[idx] = response.GetHexU8(UINT8_MAX);
+                else
+                    break;
+                if (response.GetBytesLeft() > 0 && response.GetChar() != ',')
+                    break;
+            }
+        }
+        if (next_idx == breakpoints.size())
+            return;
+    }
+
+    std::vector<std::string> payloads;
+    for (size_t idx = next_idx; idx < breakpoints.size(); ++idx)
+    {
+        StreamString packet;
+        packet.Printf ("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', eBreakpointSoftware,
+                       breakpoints[idx].first, breakpoints[idx].second);
+        payloads.push_back (packet.GetString());
+    }
+
+    std::vector<StringExtractorGDBRemote> responses;
+    SendPacketsAndWaitForResponses (payloads, responses);
+    for (size_t i = 0; i < responses.size(); ++i)
+    {
+        StringExtractorGDBRemote &response = responses[i];
+        if (response.IsOKResponse())
+            error_nos[next_idx + i] = 0;
+        else if (response.IsErrorResponse())
+            error_nos[next_idx + i] = response.GetError();
+        else if (response.IsUnsupportedResponse())
+            m_supports_z0 = false;
+    }
+}
+
 size_t
 GDBRemoteCommunicationClient::GetCurrentThreadIDs (std::vector<lldb::tid_t> &thread_ids, 
                                                    bool &sequence_mutex_unavailable)
@@ -3922,25 +4791,23 @@ GDBRemoteCommunicationClient::GetFilePermissions(const FileSpec &file_spec,
     return error;
 }
 
-uint64_t
-GDBRemoteCommunicationClient::ReadFile (lldb::user_id_t fd,
-                                        uint64_t offset,
-                                        void *dst,
-                                        uint64_t dst_len,
-                                        Error &error)
+namespace
 {
-    lldb_private::StreamString stream;
-    stream.Printf("vFile:pread:%i,%" PRId64 ",%" PRId64, (int)fd, dst_len, offset);
-    const char* packet = stream.GetData();
-    int packet_len = stream.GetSize();
-    StringExtractorGDBRemote response;
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, false) == PacketResult::Success)
+    // vFile:pread and vFile:pwrite transfer at most this many bytes per
+    // packet. Bigger transfers are split into several packets that are
+    // pipelined.
+    const uint64_t g_file_transfer_chunk_size = 64 * 1024;
+
+    // Parses the response to a vFile:pread packet into dst. Returns the
+    // number of bytes read, 0 at the end of the file or on errors.
+    uint64_t
+    ParseReadFileResponse (StringExtractorGDBRemote &response, void *dst, uint64_t dst_len, Error &error)
     {
         if (response.GetChar() != 'F')
             return 0;
         uint32_t retcode = response.GetHexMaxU32(false, UINT32_MAX);
         if (retcode == UINT32_MAX)
-            return retcode;
+            return 0;
         const char next = (response.Peek() ? *response.Peek() : 0);
         if (next == ',')
             return 0;
@@ -3956,24 +4823,13 @@ GDBRemoteCommunicationClient::ReadFile (lldb::user_id_t fd,
                 return data_to_write;
             }
         }
+        return 0;
     }
-    return 0;
-}
 
-uint64_t
-GDBRemoteCommunicationClient::WriteFile (lldb::user_id_t fd,
-                                         uint64_t offset,
-                                         const void* src,
-                                         uint64_t src_len,
-                                         Error &error)
-{
-    lldb_private::StreamGDBRemote stream;
-    stream.Printf("vFile:pwrite:%i,%" PRId64 ",", (int)fd, offset);
-    stream.PutEscapedBytes(src, src_len);
-    const char* packet = stream.GetData();
-    int packet_len = stream.GetSize();
-    StringExtractorGDBRemote response;
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, false) == PacketResult::Success)
+    // Parses the response to a vFile:pwrite packet. Returns the number of
+    // bytes written, 0 on errors.
+    uint64_t
+    ParseWriteFileResponse (StringExtractorGDBRemote &response, Error &error)
     {
         if (response.GetChar() != 'F')
         {
@@ -3994,11 +4850,113 @@ GDBRemoteCommunicationClient::WriteFile (lldb::user_id_t fd,
         }
         return bytes_written;
     }
+}
+
+uint64_t
+GDBRemoteCommunicationClient::ReadFile (lldb::user_id_t fd,
+                                        uint64_t offset,
+                                        void *dst,
+                                        uint64_t dst_len,
+                                        Error &error)
+{
+    // Ask for all of the chunks at once and have a window of them in flight
+    // so the transfer isn't bound by the round trip time.
+    std::vector<std::string> payloads;
+    for (uint64_t chunk_offset = 0; chunk_offset < dst_len; chunk_offset += g_file_transfer_chunk_size)
+    {
+        const uint64_t chunk_size = std::min (g_file_transfer_chunk_size, dst_len - chunk_offset);
+        lldb_private::StreamString stream;
+        stream.Printf("vFile:pread:%i,%" PRId64 ",%" PRId64, (int)fd, chunk_size, offset + chunk_offset);
+        payloads.push_back (stream.GetString());
+    }
+    if (payloads.empty())
+        return 0;
+
+    std::vector<StringExtractorGDBRemote> responses;
+    if (payloads.size() == 1)
+    {
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse(payloads[0].data(), payloads[0].size(), response, false) != PacketResult::Success)
+            return 0;
+        responses.push_back (response);
+    }
     else
     {
-        error.SetErrorString ("failed to send vFile:pwrite packet");
+        // Use the chunks we got even if a later one failed.
+        SendPacketsAndWaitForResponses (payloads, responses);
     }
-    return 0;
+
+    uint8_t *dst_bytes = static_cast<uint8_t *>(dst);
+    uint64_t total_bytes_read = 0;
+    for (StringExtractorGDBRemote &response : responses)
+    {
+        const uint64_t chunk_size = std::min (g_file_transfer_chunk_size, dst_len - total_bytes_read);
+        const uint64_t bytes_read = ParseReadFileResponse (response, dst_bytes + total_bytes_read, chunk_size, error);
+        total_bytes_read += bytes_read;
+        // A short read is the end of the file, the rest of the chunks are
+        // empty.
+        if (bytes_read < chunk_size)
+            break;
+    }
+    return total_bytes_read;
+}
+
+uint64_t
+GDBRemoteCommunicationClient::WriteFile (lldb::user_id_t fd,
+                                         uint64_t offset,
+                                         const void* src,
+                                         uint64_t src_len,
+                                         Error &error)
+{
+    // The escaped data can be up to twice as big as the data, and every
+    // packet has to fit in what the remote side accepts.
+    uint64_t max_chunk_size = g_file_transfer_chunk_size;
+    const uint64_t max_packet_size = GetRemoteMaxPacketSize();
+    if (max_packet_size > 128)
+        max_chunk_size = std::min<uint64_t> (max_chunk_size, (max_packet_size - 64) / 2);
+
+    const uint8_t *src_bytes = static_cast<const uint8_t *>(src);
+    std::vector<std::string> payloads;
+    for (uint64_t chunk_offset = 0; chunk_offset < src_len; chunk_offset += max_chunk_size)
+    {
+        const uint64_t chunk_size = std::min (max_chunk_size, src_len - chunk_offset);
+        lldb_private::StreamGDBRemote stream;
+        stream.Printf("vFile:pwrite:%i,%" PRId64 ",", (int)fd, offset + chunk_offset);
+        stream.PutEscapedBytes(src_bytes + chunk_offset, chunk_size);
+        payloads.push_back (stream.GetString());
+    }
+    if (payloads.empty())
+        return 0;
+
+    std::vector<StringExtractorGDBRemote> responses;
+    PacketResult packet_result;
+    if (payloads.size() == 1)
+    {
+        StringExtractorGDBRemote response;
+        packet_result = SendPacketAndWaitForResponse(payloads[0].data(), payloads[0].size(), response, false);
+        if (packet_result == PacketResult::Success)
+            responses.push_back (response);
+    }
+    else
+    {
+        packet_result = SendPacketsAndWaitForResponses (payloads, responses);
+    }
+
+    uint64_t total_bytes_written = 0;
+    for (StringExtractorGDBRemote &response : responses)
+    {
+        const uint64_t chunk_size = std::min (max_chunk_size, src_len - total_bytes_written);
+        const uint64_t bytes_written = ParseWriteFileResponse (response, error);
+        total_bytes_written += bytes_written;
+        // The caller writes whatever is left over again, which can't be
+        // done past a gap.
+        if (bytes_written < chunk_size)
+            return total_bytes_written;
+    }
+
+    if (packet_result != PacketResult::Success && error.Success())
+        error.SetErrorString ("failed to send vFile:pwrite packet");
+    return total_bytes_written;
 }
 
 Error
@@ -4173,6 +5131,16 @@ GDBRemoteCommunicationClient::AvoidGPackets (ProcessGDBRemote *process)
 bool
 GDBRemoteCommunicationClient::ReadRegister(lldb::tid_t tid, uint32_t reg, StringExtractorGDBRemote &response)
 {
+    // With the thread suffix the packet doesn't depend on the selected
+    // thread and can go out together with the packets of other threads.
+    if (GetThreadSuffixSupported())
+    {
+        char packet[64];
+        int packet_len = ::snprintf (packet, sizeof(packet), "p%x;thread:%4.4" PRIx64 ";", reg, tid);
+        assert (packet_len < ((int)sizeof(packet) - 1));
+        return SendPipelinedPacketAndWaitForResponse(packet, packet_len, response) == PacketResult::Success;
+    }
+
     Mutex::Locker locker;
     if (GetSequenceMutex (locker, "Didn't get sequence mutex for p packet."))
     {
@@ -4198,6 +5166,14 @@ GDBRemoteCommunicationClient::ReadRegister(lldb::tid_t tid, uint32_t reg, String
 bool
 GDBRemoteCommunicationClient::ReadAllRegisters (lldb::tid_t tid, StringExtractorGDBRemote &response)
 {
+    if (GetThreadSuffixSupported())
+    {
+        char packet[64];
+        int packet_len = ::snprintf (packet, sizeof(packet), "g;thread:%4.4" PRIx64 ";", tid);
+        assert (packet_len < ((int)sizeof(packet) - 1));
+        return SendPipelinedPacketAndWaitForResponse(packet, packet_len, response) == PacketResult::Success;
+    }
+
     Mutex::Locker locker;
     if (GetSequenceMutex (locker, "Didn't get sequence mutex for g packet."))
     {
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <condition_variable>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <string>
@@ -20,8 +22,10 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/ConnectionSharedMemory.h"
 #include "lldb/Core/StructuredData.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Utility/AgentExpression.h"
 
 #include "GDBRemoteCommunication.h"
 
@@ -74,6 +78,64 @@ public:
     SendPacketsAndConcatenateResponses (const char *send_payload_prefix,
                                         std::string &response_string);
 
+    //------------------------------------------------------------------
+    /// Send a batch of independent packets and collect their responses.
+    ///
+    /// The packets are sent without waiting for the response to the
+    /// previous one, so the whole batch costs about one round trip
+    /// instead of one per packet. Responses are returned in the order
+    /// of the packets. When acks are enabled each packet has to be acked
+    /// before the next one can be sent, so the packets are sent one at a
+    /// time.
+    ///
+    /// @param[in] payloads
+    ///     The payloads of the packets to send. None of them may depend
+    ///     on the response of another one in the batch.
+    ///
+    /// @param[out] responses
+    ///     The responses to the packets. If a packet fails, this only
+    ///     contains the responses to the packets before it.
+    ///
+    /// @return
+    ///     PacketResult::Success if all responses were received,
+    ///     otherwise the result of the first packet that failed.
+    //------------------------------------------------------------------
+    PacketResult
+    SendPacketsAndWaitForResponses (const std::vector<std::string> &payloads,
+                                    std::vector<StringExtractorGDBRemote> &responses);
+
+    //------------------------------------------------------------------
+    /// Send a batch of packets with SendPacketsAndWaitForResponses() and
+    /// keep their responses for the SendPacketAndWaitForResponse() calls
+    /// that send the same packets, in the same order, later on.
+    ///
+    /// This lets code made of lazy one packet queries, like the startup
+    /// handshake, be pipelined without restructuring it. Sending any
+    /// other packet discards the responses that weren't used yet.
+    //------------------------------------------------------------------
+    void
+    PrefetchResponses (const std::vector<std::string> &payloads);
+
+    //------------------------------------------------------------------
+    /// Send a packet that other threads may be sending packets at the
+    /// same time as, and wait for its response.
+    ///
+    /// The first caller takes the sequence mutex and sends the packets of
+    /// the callers that show up while it waits for responses, without
+    /// waiting for the previous responses. The responses come back in the
+    /// order of the packets and are handed to their callers. Concurrent
+    /// requests, like the memory reads of several views of a stopped
+    /// process, then cost about one round trip together.
+    ///
+    /// The packet must not depend on state that other packets change,
+    /// like the thread selected with "Hg". Without no-ack mode this is
+    /// the same as SendPacketAndWaitForResponse().
+    //------------------------------------------------------------------
+    PacketResult
+    SendPipelinedPacketAndWaitForResponse (const char *payload,
+                                           size_t payload_length,
+                                           StringExtractorGDBRemote &response);
+
     lldb::StateType
     SendContinuePacketAndWaitForResponse (ProcessGDBRemote *process,
                                           const char *packet_payload,
@@ -407,11 +469,91 @@ public:
     SendGDBStoppointTypePacket (GDBStoppointType type,   // Type of breakpoint or watchpoint
                                 bool insert,              // Insert or remove?
                                 lldb::addr_t addr,        // Address of breakpoint or watchpoint
-                                uint32_t length);         // Byte Size of breakpoint or watchpoint
+                                uint32_t length,          // Byte Size of breakpoint or watchpoint
+                                const std::vector<AgentExpression> *conditions = nullptr, // Optional software breakpoint conditions
+                                bool counting = false,    // Count the hits of a software breakpoint instead of stopping
+                                const std::vector<lldb::tid_t> *thread_ids = nullptr); // Threads a software breakpoint is for
+
+    //------------------------------------------------------------------
+    /// Get the number of hits the stub counted for each of its counting
+    /// breakpoints.
+    ///
+    /// @param[out] hit_counts
+    ///     The address and the hit count of each counting breakpoint.
+    ///
+    /// @return
+    ///     False if the packet failed or the stub doesn't count hits.
+    //------------------------------------------------------------------
+    bool
+    GetBreakpointHitCounts (std::vector<std::pair<lldb::addr_t, uint64_t>> &hit_counts);
+
+    //------------------------------------------------------------------
+    /// Insert or remove a batch of software breakpoints.
+    ///
+    /// Uses "MultiBreakpoint" packets if the stub supports them and
+    /// otherwise pipelines one "Z0" or "z0" packet per breakpoint.
+    ///
+    /// @param[in] breakpoints
+    ///     The address and opcode size of each breakpoint.
+    ///
+    /// @param[out] error_nos
+    ///     The result for each breakpoint, like the return value of
+    ///     SendGDBStoppointTypePacket().
+    //------------------------------------------------------------------
+    void
+    SendSoftwareBreakpointPackets (bool insert,
+                                   const std::vector<std::pair<lldb::addr_t, uint32_t>> &breakpoints,
+                                   std::vector<uint8_t> &error_nos);
 
     bool
     SetNonStopMode (const bool enable);
 
+    //------------------------------------------------------------------
+    /// Tell the stub which signals it should deliver to the process
+    /// right away instead of stopping. The list replaces the one that
+    /// was sent before.
+    //------------------------------------------------------------------
+    bool
+    SendSignalsToIgnore (const std::vector<int32_t> &signals);
+
+    //------------------------------------------------------------------
+    /// Start or stop recording the branches a thread takes with the
+    /// "jTraceStart" and "jTraceStop" packets.
+    //------------------------------------------------------------------
+    Error
+    StartBranchTrace (lldb::tid_t tid, size_t buffer_size);
+
+    Error
+    StopBranchTrace (lldb::tid_t tid);
+
+    //------------------------------------------------------------------
+    /// Read the branches a traced thread took with "jTraceRead" packets,
+    /// the oldest one first.
+    //------------------------------------------------------------------
+    Error
+    GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches);
+
+    //------------------------------------------------------------------
+    /// Save a checkpoint of the process with "QSaveCheckpoint".
+    //------------------------------------------------------------------
+    Error
+    SaveCheckpoint (uint32_t &checkpoint_id);
+
+    //------------------------------------------------------------------
+    /// Restore a checkpoint with "QRestoreCheckpoint". The reply is the
+    /// stop reply of the process, which can be a new one.
+    //------------------------------------------------------------------
+    Error
+    RestoreCheckpoint (uint32_t checkpoint_id, StringExtractorGDBRemote &stop_reply);
+
+    //------------------------------------------------------------------
+    /// Read the samples of the last "jSample" run with "jSampleRead"
+    /// packets. Each sample is a thread and its pc followed by the return
+    /// addresses of its frames.
+    //------------------------------------------------------------------
+    Error
+    GetSamples (std::vector<std::pair<lldb::tid_t, std::vector<lldb::addr_t>>> &samples);
+
     void
     TestPacketSpeed (const uint32_t num_packets, uint32_t max_send, uint32_t max_recv, bool json, Stream &strm);
 
@@ -445,9 +587,120 @@ public:
     bool
     GetEchoSupported ();
 
+    //------------------------------------------------------------------
+    /// Switch to binary frames if the server supports them.
+    ///
+    /// Binary frames carry their length up front, have no checksum and
+    /// let the server send data like memory reads without escaping it,
+    /// which makes big transfers much cheaper on fast local connections.
+    /// They are only used in no ack mode and without compression.
+    ///
+    /// @return
+    ///     True if binary framing is enabled.
+    //------------------------------------------------------------------
+    bool
+    EnableBinaryFraming ();
+
+    //------------------------------------------------------------------
+    /// Create shared memory for memory reads and hand it to the server.
+    ///
+    /// This only works when the server runs on the same host, other
+    /// servers can't open the shared memory and refuse it.
+    ///
+    /// @param[in] size
+    ///     The size of the shared memory, which is also the largest
+    ///     memory read that can use it.
+    ///
+    /// @return
+    ///     True if ReadMemoryShared() can be used.
+    //------------------------------------------------------------------
+    bool
+    EnableSharedMemory (size_t size);
+
+    // The largest read ReadMemoryShared() accepts, 0 if there is no shared
+    // memory.
+    size_t
+    GetSharedMemoryReadSize () const
+    {
+        return m_shared_memory_up ? m_shared_memory_up->GetByteSize() : 0;
+    }
+
+    //------------------------------------------------------------------
+    /// Read memory with a qReadMemoryShared packet, the server puts the
+    /// data in the shared memory from EnableSharedMemory() instead of
+    /// sending it in the reply.
+    ///
+    /// @return
+    ///     The number of bytes read into \a dst.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryShared (lldb::addr_t addr, void *dst, size_t dst_len, Error &error);
+
+    //------------------------------------------------------------------
+    /// Have the stub search its memory with a "qSearch:memory" packet.
+    ///
+    /// @param[in] length
+    ///     The number of bytes to search, the whole match has to be in
+    ///     [addr, addr + length).
+    ///
+    /// @param[out] found_addr
+    ///     The address of the match or LLDB_INVALID_ADDRESS if there is
+    ///     no match.
+    ///
+    /// @return
+    ///     False if the stub doesn't support the packet or couldn't do the
+    ///     search, the memory has to be searched some other way then.
+    //------------------------------------------------------------------
+    bool
+    SearchMemory (lldb::addr_t addr,
+                  uint64_t length,
+                  const uint8_t *pattern,
+                  size_t pattern_size,
+                  lldb::addr_t &found_addr);
+
+    //------------------------------------------------------------------
+    /// Have the stub find the pointers to \a value in the writable
+    /// memory with "qFindReferences" packets.
+    ///
+    /// @return
+    ///     An error if the stub doesn't support the packet, check
+    ///     GetFindReferencesSupported() to scan some other way then.
+    //------------------------------------------------------------------
+    Error
+    FindReferences (uint64_t value, size_t max_matches, std::vector<lldb::addr_t> &matches);
+
+    bool
+    GetFindReferencesSupported ()
+    {
+        return m_supports_qFindReferences != eLazyBoolNo;
+    }
+
     bool
     GetAugmentedLibrariesSVR4ReadSupported ();
 
+    // Returns true if the stub accepts ";X" agent expression conditions in
+    // software breakpoint "Z0" packets.
+    bool
+    GetConditionalBreakpointsSupported ();
+
+    bool
+    GetMultiBreakpointSupported ();
+
+    // Returns true if the stub accepts ";counting" in software breakpoint
+    // "Z0" packets and the "qBreakpointHitCounts" packet.
+    bool
+    GetCountingBreakpointsSupported ();
+
+    // Returns true if the stub accepts ";threads:" in software breakpoint
+    // "Z0" packets.
+    bool
+    GetThreadSpecificBreakpointsSupported ();
+
+    // Returns true if the stub can pass the signals of a "QPassSignals"
+    // packet to the process without stopping it.
+    bool
+    GetQPassSignalsSupported ();
+
     bool
     GetQXferFeaturesReadSupported ();
 
@@ -550,8 +803,10 @@ public:
     bool
     AvoidGPackets(ProcessGDBRemote *process);
 
-    StructuredData::ObjectSP
-    GetThreadsInfo();
+    // Get the JSON array of the "jThreadsInfo" reply without parsing it,
+    // false if the packet isn't supported.
+    bool
+    GetThreadsInfo (std::string &json);
 
     bool
     GetThreadExtendedInfoSupported();
@@ -559,6 +814,9 @@ public:
     bool
     GetLoadedDynamicLibrariesInfosSupported();
 
+    bool
+    GetSamplingSupported();
+
     bool
     GetModuleInfo (const FileSpec& module_file_spec,
                    const ArchSpec& arch_spec,
@@ -583,6 +841,7 @@ protected:
     LazyBool m_supports_vCont_C;
     LazyBool m_supports_vCont_s;
     LazyBool m_supports_vCont_S;
+    LazyBool m_supports_vCont_r;
     LazyBool m_qHostInfo_is_valid;
     LazyBool m_curr_pid_is_valid;
     LazyBool m_qProcessInfo_is_valid;
@@ -603,8 +862,16 @@ protected:
     LazyBool m_supports_qXfer_libraries_svr4_read;
     LazyBool m_supports_qXfer_features_read;
     LazyBool m_supports_augmented_libraries_svr4_read;
+    LazyBool m_supports_conditional_breakpoints;
+    LazyBool m_supports_multi_breakpoint;
+    LazyBool m_supports_counting_breakpoints;
+    LazyBool m_supports_QPassSignals;
+    LazyBool m_supports_thread_specific_breakpoints;
     LazyBool m_supports_jThreadExtendedInfo;
     LazyBool m_supports_jLoadedDynamicLibrariesInfos;
+    LazyBool m_supports_jSample;
+    LazyBool m_supports_qSearch_memory;
+    LazyBool m_supports_qFindReferences;
 
     bool
         m_supports_qProcessInfoPID:1,
@@ -641,6 +908,22 @@ protected:
     bool m_interrupt_sent;
     std::string m_partial_profile_data;
     std::map<uint64_t, uint32_t> m_thread_id_to_used_usec_map;
+    std::deque<std::pair<std::string, StringExtractorGDBRemote>> m_prefetched_responses;
+
+    // The packets of SendPipelinedPacketAndWaitForResponse() callers that
+    // the thread sending them hasn't sent yet.
+    struct PipelinedRequest
+    {
+        const char *payload;
+        size_t payload_length;
+        StringExtractorGDBRemote *response;
+        PacketResult result;
+        bool done;
+    };
+    std::mutex m_pipeline_mutex;
+    std::condition_variable m_pipeline_condition;
+    std::deque<PipelinedRequest *> m_pipeline_queue;
+    bool m_pipeline_sender_active;
     
     ArchSpec m_host_arch;
     ArchSpec m_process_arch;
@@ -654,6 +937,8 @@ protected:
     uint32_t m_gdb_server_version; // from reply to qGDBServerVersion, zero if qGDBServerVersion is not supported
     uint32_t m_default_packet_timeout;
     uint64_t m_max_packet_size;  // as returned by qSupported
+    uint64_t m_binary_framing_max_packet_size;  // as returned by qSupported, 0 if binary framing isn't supported
+    std::unique_ptr<ConnectionSharedMemory> m_shared_memory_up; // The server puts qReadMemoryShared results here
 
     PacketResult
     SendPacketAndWaitForResponseNoLock (const char *payload,
@@ -0,0 +1,265 @@
+//===-- GDBRemoteCommunicationReplayServer.cpp ------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/Config.h"
+
+#include "GDBRemoteCommunicationReplayServer.h"
+
+// C Includes
+// C++ Includes
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+// Other libraries and framework includes
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+
+// Project includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/StringConvert.h"
+#include "lldb/Host/TimeValue.h"
+#include "ProcessGDBRemoteLog.h"
+#include "Utility/StringExtractorGDBRemote.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::process_gdb_remote;
+
+GDBRemoteCommunicationReplayServer::GDBRemoteCommunicationReplayServer() :
+    GDBRemoteCommunicationServer ("gdb-remote.server", "gdb-remote.server.rx_packet"),
+    m_packets (),
+    m_next_packet_idx (0),
+    m_round_trip_usec (0),
+    m_bytes_per_second (0),
+    m_use_recorded_timing (false)
+{
+}
+
+GDBRemoteCommunicationReplayServer::~GDBRemoteCommunicationReplayServer()
+{
+}
+
+Error
+GDBRemoteCommunicationReplayServer::LoadRecording (const char *path)
+{
+    Error error;
+    FileSpec recording_spec (path, true);
+    DataBufferSP data_sp = recording_spec.ReadFileContents (0, SIZE_MAX, &error);
+    if (error.Fail())
+        return error;
+    if (!data_sp)
+    {
+        error.SetErrorStringWithFormat ("unable to read %s", path);
+        return error;
+    }
+
+    m_packets.clear();
+    m_next_packet_idx = 0;
+
+    // <usec> <send|recv|notify> <bytes> <hex payload>
+    llvm::StringRef contents ((const char *)data_sp->GetBytes(), data_sp->GetByteSize());
+    uint32_t line_number = 0;
+    while (!contents.empty())
+    {
+        llvm::StringRef line;
+        std::tie (line, contents) = contents.split ('\n');
+        ++line_number;
+        line = line.trim();
+        if (line.empty() || line.startswith ("#"))
+            continue;
+
+        llvm::SmallVector<llvm::StringRef, 4> fields;
+        line.split (fields, ' ', 3, false);
+
+        RecordedPacket packet;
+        bool valid = fields.size() >= 3 &&
+                     !fields[0].getAsInteger (10, packet.usec) &&
+                     !fields[2].getAsInteger (10, packet.wire_length);
+        if (valid)
+        {
+            if (fields[1] == "send")
+                packet.kind = RecordedPacketKind::Send;
+            else if (fields[1] == "recv")
+                packet.kind = RecordedPacketKind::Recv;
+            else if (fields[1] == "notify")
+                packet.kind = RecordedPacketKind::Notify;
+            else
+                valid = false;
+        }
+        if (valid && fields.size() == 4)
+        {
+            StringExtractor hex_payload (fields[3].str().c_str());
+            valid = hex_payload.GetHexByteString (packet.payload) * 2 == fields[3].size();
+        }
+        if (!valid)
+        {
+            error.SetErrorStringWithFormat ("%s:%u: invalid recorded packet", path, line_number);
+            m_packets.clear();
+            return error;
+        }
+        m_packets.push_back (std::move (packet));
+    }
+
+    if (m_packets.empty())
+        error.SetErrorStringWithFormat ("%s doesn't contain any packets", path);
+    return error;
+}
+
+size_t
+GDBRemoteCommunicationReplayServer::FindRequest (const std::string &payload) const
+{
+    const size_t num_packets = m_packets.size();
+    for (size_t i = 0; i < num_packets; ++i)
+    {
+        const size_t idx = (m_next_packet_idx + i) % num_packets;
+        if (m_packets[idx].kind == RecordedPacketKind::Send && m_packets[idx].payload == payload)
+            return idx;
+    }
+    return std::string::npos;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationReplayServer::ReplayPacket (uint32_t timeout_usec, Error &error, bool &quit)
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+
+    StringExtractorGDBRemote packet;
+    PacketResult packet_result = WaitForPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec, false);
+    if (packet_result != PacketResult::Success)
+    {
+        if (!IsConnected())
+        {
+            error.SetErrorString("lost connection");
+            quit = true;
+        }
+        else
+        {
+            error.SetErrorString("timeout");
+        }
+        return packet_result;
+    }
+
+    const TimeValue request_time = TimeValue::Now();
+    const std::string &request = packet.GetStringRef();
+    if (request == "+" || request == "-")
+        return PacketResult::Success;
+
+    const size_t request_idx = FindRequest (request);
+    if (request_idx == std::string::npos)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationReplayServer::%s packet isn't in the recording: '%s'",
+                         __FUNCTION__, request.c_str());
+        // Interrupts don't get a response of their own.
+        if (request == "\x03")
+            return PacketResult::Success;
+        return SendUnimplementedResponse (request.c_str());
+    }
+
+    // Everything the recorded client read up to its next request is the
+    // response to this one.
+    const RecordedPacket &recorded_request = m_packets[request_idx];
+    uint64_t wire_length = recorded_request.wire_length;
+    m_next_packet_idx = request_idx + 1;
+    while (m_next_packet_idx < m_packets.size() && m_packets[m_next_packet_idx].kind != RecordedPacketKind::Send)
+    {
+        const RecordedPacket &response = m_packets[m_next_packet_idx++];
+        wire_length += response.wire_length;
+
+        uint64_t delay_usec = 0;
+        if (m_use_recorded_timing)
+        {
+            if (response.usec > recorded_request.usec)
+                delay_usec = response.usec - recorded_request.usec;
+        }
+        else
+        {
+            delay_usec = m_round_trip_usec;
+            if (m_bytes_per_second > 0)
+                delay_usec += wire_length * TimeValue::MicroSecPerSec / m_bytes_per_second;
+        }
+
+        const uint64_t send_usec = request_time.GetAsMicroSecondsSinceJan1_1970() + delay_usec;
+        const uint64_t now_usec = TimeValue::Now().GetAsMicroSecondsSinceJan1_1970();
+        if (send_usec > now_usec)
+            std::this_thread::sleep_for (std::chrono::microseconds (send_usec - now_usec));
+
+        // The payloads are the decoded ones, binary data in them has to be
+        // escaped again unless binary frames are used.
+        if (response.kind == RecordedPacketKind::Notify)
+            packet_result = SendNotificationPacketNoLock (response.payload.data(), response.payload.size());
+        else
+            packet_result = SendBinaryPacketNoLock (response.payload.data(), response.payload.size());
+        if (packet_result != PacketResult::Success)
+            return packet_result;
+
+        UpdateConnectionState (request, response.payload);
+    }
+
+    if (m_exit_now)
+        quit = true;
+
+    return packet_result;
+}
+
+void
+GDBRemoteCommunicationReplayServer::UpdateConnectionState (const std::string &request, const std::string &response)
+{
+    if (response != "OK")
+        return;
+
+    llvm::StringRef request_ref (request);
+    if (request_ref == "QStartNoAckMode")
+    {
+        m_send_acks = false;
+    }
+    else if (request_ref == "QEnableBinaryFraming")
+    {
+        m_binary_framing = true;
+    }
+    else if (request_ref.startswith ("QEnableCompression:"))
+    {
+        // QEnableCompression:type:<COMPRESSION-TYPE>;minsize:<MINIMUM PACKET SIZE TO COMPRESS>;
+        StringExtractorGDBRemote packet (request.c_str());
+        packet.SetFilePos (::strlen ("QEnableCompression:"));
+
+        CompressionType compression_type = CompressionType::None;
+        size_t minsize = m_send_compression_minsize;
+        std::string name;
+        std::string value;
+        while (packet.GetNameColonValue (name, value))
+        {
+            if (name == "type")
+            {
+#if defined(HAVE_LIBZ)
+                if (value == "zlib-deflate")
+                    compression_type = CompressionType::ZlibDeflate;
+#endif
+#if defined(HAVE_LIBLZ4)
+                if (value == "lz4")
+                    compression_type = CompressionType::LZ4;
+#endif
+            }
+            else if (name == "minsize")
+            {
+                minsize = StringConvert::ToUInt64 (value.c_str(), minsize, 10);
+            }
+        }
+
+        Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+        if (compression_type == CompressionType::None && log)
+            log->Printf ("GDBRemoteCommunicationReplayServer::%s can't compress packets like the recorded server: '%s'",
+                         __FUNCTION__, request.c_str());
+        m_send_compression_type = compression_type;
+        m_send_compression_minsize = minsize;
+    }
+}
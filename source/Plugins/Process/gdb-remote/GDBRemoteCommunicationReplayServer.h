@@ -0,0 +1,126 @@
+//===-- GDBRemoteCommunicationReplayServer.h --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_GDBRemoteCommunicationReplayServer_h_
+#define liblldb_GDBRemoteCommunicationReplayServer_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "GDBRemoteCommunicationServer.h"
+
+namespace lldb_private {
+namespace process_gdb_remote {
+
+//----------------------------------------------------------------------
+/// @class GDBRemoteCommunicationReplayServer
+/// @brief Answers a client with the packets of a recorded session.
+///
+/// The recording is the one GDBRemoteCommunication::StartRecording()
+/// writes on the client side. Each packet the client sends is looked up
+/// in the packets the client sent in the recording and answered with the
+/// packets it received after it, after a delay that simulates the link.
+/// No process is debugged, so this measures the client and the protocol
+/// on their own, e.g. how attaching or stepping behave with a slower
+/// link.
+//----------------------------------------------------------------------
+class GDBRemoteCommunicationReplayServer : public GDBRemoteCommunicationServer
+{
+public:
+    GDBRemoteCommunicationReplayServer();
+
+    ~GDBRemoteCommunicationReplayServer() override;
+
+    Error
+    LoadRecording (const char *path);
+
+    // Simulate a link with this round trip time. Each response is sent
+    // this long after the request was read.
+    void
+    SetRoundTripTime (uint64_t usec)
+    {
+        m_round_trip_usec = usec;
+    }
+
+    // Simulate a link with this many bytes per second, zero for no limit.
+    // The sizes of the packets in the recording are used, so a recording
+    // with compressed or binary frames keeps its sizes.
+    void
+    SetBandwidth (uint64_t bytes_per_second)
+    {
+        m_bytes_per_second = bytes_per_second;
+    }
+
+    // Wait as long for each response as the recorded session did, instead
+    // of simulating a link.
+    void
+    SetUseRecordedTiming (bool use_recorded_timing)
+    {
+        m_use_recorded_timing = use_recorded_timing;
+    }
+
+    //------------------------------------------------------------------
+    /// Read a packet and send the recorded responses to it.
+    ///
+    /// Packets are matched in the order of the recording. If the client
+    /// sends a packet the recording doesn't have next, the rest of the
+    /// recording is searched and then the start of it. Packets that can't
+    /// be found at all get an empty, unsupported, response.
+    //------------------------------------------------------------------
+    PacketResult
+    ReplayPacket (uint32_t timeout_usec, Error &error, bool &quit);
+
+    bool
+    GetThreadSuffixSupported () override
+    {
+        return false;
+    }
+
+protected:
+    enum class RecordedPacketKind
+    {
+        Send,  // sent by the recorded client
+        Recv,  // a response the recorded client read
+        Notify // an asynchronous notification the recorded client read
+    };
+
+    struct RecordedPacket
+    {
+        uint64_t usec;
+        RecordedPacketKind kind;
+        uint64_t wire_length;
+        std::string payload;
+    };
+
+    size_t
+    FindRequest (const std::string &payload) const;
+
+    // Switch the connection to what the recorded server switched to after
+    // answering a request, e.g. no acks after QStartNoAckMode.
+    void
+    UpdateConnectionState (const std::string &request, const std::string &response);
+
+    std::vector<RecordedPacket> m_packets;
+    size_t m_next_packet_idx;
+    uint64_t m_round_trip_usec;
+    uint64_t m_bytes_per_second;
+    bool m_use_recorded_timing;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (GDBRemoteCommunicationReplayServer);
+};
+
+} // namespace process_gdb_remote
+} // namespace lldb_private
+
+#endif // liblldb_GDBRemoteCommunicationReplayServer_h_
@@ -63,7 +63,8 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(const cha
     m_proc_infos (),
     m_proc_infos_index (0),
     m_thread_suffix_supported (false),
-    m_list_threads_in_stop_reply (false)
+    m_list_threads_in_stop_reply (false),
+    m_compression_allowed (false)
 {
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_A,
                                   &GDBRemoteCommunicationServerCommon::Handle_A);
@@ -97,6 +98,10 @@ GDBRemoteCommunicationServerCommon::GDBRemoteCommunicationServerCommon(const cha
                                   &GDBRemoteCommunicationServerCommon::Handle_qProcessInfoPID);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetDetachOnError,
                                   &GDBRemoteCommunicationServerCommon::Handle_QSetDetachOnError);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnableCompression,
+                                  &GDBRemoteCommunicationServerCommon::Handle_QEnableCompression);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QEnableBinaryFraming,
+                                  &GDBRemoteCommunicationServerCommon::Handle_QEnableBinaryFraming);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetSTDERR,
                                   &GDBRemoteCommunicationServerCommon::Handle_QSetSTDERR);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetSTDIN,
@@ -570,13 +575,18 @@ GDBRemoteCommunicationServerCommon::Handle_vFile_pRead (StringExtractorGDBRemote
             response.PutChar('F');
             response.Printf("%zi", bytes_read);
             if (save_errno)
+            {
                 response.Printf(",%i", save_errno);
-            else
+                return SendPacketNoLock(response.GetData(), response.GetSize());
+            }
+            response.PutChar(';');
+            if (!GetBinaryFramingEnabled())
             {
-                response.PutChar(';');
                 response.PutEscapedBytes(&buffer[0], bytes_read);
+                return SendPacketNoLock(response.GetData(), response.GetSize());
             }
-            return SendPacketNoLock(response.GetData(), response.GetSize());
+            response.Write(&buffer[0], bytes_read);
+            return SendBinaryPacketNoLock(response.GetData(), response.GetSize());
         }
     }
     return SendErrorResponse(21);
@@ -836,13 +846,49 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported (StringExtractorGDBRemote
     response.PutCString (";QThreadSuffixSupported+");
     response.PutCString (";QListThreadsInStopReply+");
     response.PutCString (";qEcho+");
+    // Binary frames aren't escaped or checksummed, so they can be much bigger.
+    uint32_t binary_framing_max_packet_size = 4 * 1024 * 1024;
+    response.Printf (";BinaryFraming=%x", binary_framing_max_packet_size);
 #if defined(__linux__)
     response.PutCString (";qXfer:auxv:read+");
+    response.PutCString (";QPassSignals+");
+    response.PutCString (";qXfer:libraries-svr4:read+");
+    response.PutCString (";ConditionalBreakpoints+");
+    response.PutCString (";MultiBreakpoint+");
+    response.PutCString (";CountingBreakpoints+");
+    response.PutCString (";ThreadSpecificBreakpoints+");
+#endif
+
+#if defined(HAVE_LIBZ) || defined(HAVE_LIBLZ4)
+    if (m_compression_allowed)
+    {
+        std::string compressions;
+#if defined(HAVE_LIBZ)
+        compressions += "zlib-deflate,";
+#endif
+#if defined(HAVE_LIBLZ4)
+        compressions += "lz4,";
+#endif
+        compressions.pop_back ();
+        response.Printf (";SupportedCompressions=%s", compressions.c_str ());
+        response.Printf (";DefaultCompressionMinSize=%" PRIu64, (uint64_t)m_send_compression_minsize);
+    }
 #endif
 
+    std::string client_features;
+    packet.SetFilePos (strlen ("qSupported"));
+    if (packet.GetBytesLeft () && packet.GetChar () == ':')
+        client_features = packet.Peek () ? packet.Peek () : "";
+    HandleClientFeatures (client_features, response);
+
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+void
+GDBRemoteCommunicationServerCommon::HandleClientFeatures (const std::string &client_features, Stream &response)
+{
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet)
 {
@@ -868,6 +914,67 @@ GDBRemoteCommunicationServerCommon::Handle_QSetDetachOnError (StringExtractorGDB
     return SendOKResponse ();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableCompression (StringExtractorGDBRemote &packet)
+{
+    // QEnableCompression:type:<COMPRESSION-TYPE>;minsize:<MINIMUM PACKET SIZE TO COMPRESS>;
+    if (!m_compression_allowed)
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
+    packet.SetFilePos(::strlen ("QEnableCompression:"));
+
+    CompressionType compression_type = CompressionType::None;
+    size_t minsize = m_send_compression_minsize;
+    std::string name;
+    std::string value;
+    while (packet.GetNameColonValue(name, value))
+    {
+        if (name == "type")
+        {
+#if defined(HAVE_LIBZ)
+            if (value == "zlib-deflate")
+                compression_type = CompressionType::ZlibDeflate;
+#endif
+#if defined(HAVE_LIBLZ4)
+            if (value == "lz4")
+                compression_type = CompressionType::LZ4;
+#endif
+        }
+        else if (name == "minsize")
+        {
+            bool success = false;
+            const uint64_t new_minsize = StringConvert::ToUInt64 (value.c_str(), 0, 10, &success);
+            if (!success)
+                return SendIllFormedResponse (packet, "QEnableCompression has an invalid minsize");
+            minsize = new_minsize;
+        }
+    }
+
+    if (compression_type == CompressionType::None)
+        return SendErrorResponse (88);
+
+    // The reply to this packet is the last one we send uncompressed.
+    PacketResult result = SendOKResponse ();
+    m_send_compression_type = compression_type;
+    m_send_compression_minsize = minsize;
+    return result;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerCommon::Handle_QEnableBinaryFraming (StringExtractorGDBRemote &packet)
+{
+    // Binary frames have no checksum, so they are only safe on reliable
+    // connections, which is what no ack mode is for.
+    if (GetSendAcks () || m_send_compression_type != CompressionType::None)
+        return SendErrorResponse (89);
+
+    // The reply to this packet is the last one we send with the normal
+    // framing.
+    PacketResult result = SendOKResponse ();
+    m_binary_framing = true;
+    return result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QStartNoAckMode (StringExtractorGDBRemote &packet)
 {
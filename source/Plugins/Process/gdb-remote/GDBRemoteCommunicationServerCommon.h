@@ -37,6 +37,22 @@ public:
 
     ~GDBRemoteCommunicationServerCommon() override;
 
+    //------------------------------------------------------------------
+    /// Allow the client to enable compression of the packets we send.
+    ///
+    /// Compression is only worth it on slow connections, so we don't
+    /// advertise it in the qSupported reply unless asked to.
+    ///
+    /// @param[in] enabled
+    ///     If true, the compression types we were built with are
+    ///     advertised and the QEnableCompression packet is accepted.
+    //------------------------------------------------------------------
+    void
+    SetCompressionAllowed (bool enabled)
+    {
+        m_compression_allowed = enabled;
+    }
+
 protected:
     ProcessLaunchInfo m_process_launch_info;
     Error m_process_launch_error;
@@ -44,6 +60,7 @@ protected:
     uint32_t m_proc_infos_index;
     bool m_thread_suffix_supported;
     bool m_list_threads_in_stop_reply;
+    bool m_compression_allowed;
 
     PacketResult
     Handle_A (StringExtractorGDBRemote &packet);
@@ -129,6 +146,12 @@ protected:
     PacketResult
     Handle_QSetDetachOnError (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QEnableCompression (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QEnableBinaryFraming (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_QStartNoAckMode (StringExtractorGDBRemote &packet);
 
@@ -198,6 +221,19 @@ protected:
 
     virtual FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch);
+
+    //------------------------------------------------------------------
+    /// Called by Handle_qSupported so subclasses can look at the
+    /// features the client sent and advertise additional ones.
+    ///
+    /// @param[in] client_features
+    ///     The ';' separated features after "qSupported:", may be empty.
+    ///
+    /// @param[in] response
+    ///     The qSupported response, features are appended as ";name+".
+    //------------------------------------------------------------------
+    virtual void
+    HandleClientFeatures (const std::string &client_features, Stream &response);
 };
 
 } // namespace process_gdb_remote
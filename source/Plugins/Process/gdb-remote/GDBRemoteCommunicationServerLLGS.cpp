@@ -15,7 +15,14 @@
 #include "lldb/Core/StreamGDBRemote.h"
 
 // C Includes
+#include <signal.h>
+#if defined(__linux__)
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
 // C++ Includes
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 #include <thread>
@@ -24,6 +31,8 @@
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/State.h"
@@ -45,6 +54,8 @@
 #include "lldb/Host/common/NativeThreadProtocol.h"
 #include "lldb/Utility/JSON.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/MemorySearch.h"
+#include "lldb/Utility/XXHash.h"
 
 // Project includes
 #include "Utility/StringExtractorGDBRemote.h"
@@ -85,13 +96,27 @@ GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(const lldb::P
       m_continue_tid(LLDB_INVALID_THREAD_ID),
       m_debugged_process_mutex(),
       m_debugged_process_sp(),
+      m_debugged_processes(),
       m_stdio_communication("process.stdio"),
       m_inferior_prev_state(StateType::eStateInvalid),
       m_active_auxv_buffer_sp(),
+      m_active_libraries_svr4_buffer_sp(),
       m_saved_registers_mutex(),
       m_saved_registers_map(),
       m_next_saved_registers_id(1),
-      m_handshake_completed(false)
+      m_expedited_registers(),
+      m_pending_stop_notifications(),
+      m_shared_memory_up(),
+      m_shared_memory_offset(0),
+      m_samples(),
+      m_sample_end_time(),
+      m_sample_period_ns(0),
+      m_sample_timer_sp(),
+      m_sample_timer_handle_up(),
+      m_handshake_completed(false),
+      m_non_stop_mode(false),
+      m_multiprocess(false),
+      m_sampling(false)
 {
     assert(platform_sp);
     RegisterPacketHandlers();
@@ -106,6 +131,10 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_c);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_D,
                                   &GDBRemoteCommunicationServerLLGS::Handle_D);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_g,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_g);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_G,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_G);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_H,
                                   &GDBRemoteCommunicationServerLLGS::Handle_H);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_I,
@@ -116,6 +145,20 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_M,
                                   &GDBRemoteCommunicationServerLLGS::Handle_M);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetSharedMemory,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QSetSharedMemory);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qReadMemoryShared,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qReadMemoryShared);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qSearch_memory,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qSearch_memory);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qFindReferences,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qFindReferences);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_MultiMemRead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_MultiMemHash,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_MultiMemHash);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_MultiBreakpoint,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_MultiBreakpoint);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_p,
                                   &GDBRemoteCommunicationServerLLGS::Handle_p);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
@@ -140,8 +183,18 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_QRestoreRegisterState);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSaveRegisterState,
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSaveRegisterState);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSaveCheckpoint,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QSaveCheckpoint);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QRestoreCheckpoint,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QRestoreCheckpoint);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetDisableASLR,
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetDisableASLR);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetExpeditedRegisters,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QSetExpeditedRegisters);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QNonStop,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QPassSignals,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QPassSignals);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QSetWorkingDir,
                                   &GDBRemoteCommunicationServerLLGS::Handle_QSetWorkingDir);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qsThreadInfo,
@@ -150,10 +203,24 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_qThreadStopInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jThreadsInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jSample,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jSample);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jSampleRead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jSampleRead);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jTraceStart,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jTraceStart);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jTraceStop,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jTraceStop);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_jTraceRead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_jTraceRead);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_libraries_svr4_read,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qShlibInfoAddr,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qShlibInfoAddr);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_s,
                                   &GDBRemoteCommunicationServerLLGS::Handle_s);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_stop_reason,
@@ -164,12 +231,16 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vCont_actions,
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont_actions);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vStopped,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_x,
                                   &GDBRemoteCommunicationServerLLGS::Handle_memory_read);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
                                   &GDBRemoteCommunicationServerLLGS::Handle_Z);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_z,
                                   &GDBRemoteCommunicationServerLLGS::Handle_z);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qBreakpointHitCounts,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qBreakpointHitCounts);
 
     RegisterPacketHandler(StringExtractorGDBRemote::eServerPacketType_k,
                           [this](StringExtractorGDBRemote packet,
@@ -216,6 +287,8 @@ GDBRemoteCommunicationServerLLGS::LaunchProcess ()
             *this,
             m_mainloop,
             m_debugged_process_sp);
+        if (error.Success ())
+            m_debugged_processes[m_debugged_process_sp->GetID ()] = m_debugged_process_sp;
     }
 
     if (!error.Success ())
@@ -224,6 +297,13 @@ GDBRemoteCommunicationServerLLGS::LaunchProcess ()
         return error;
     }
 
+    if (m_non_stop_mode)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
+
     // Handle mirroring of inferior stdout/stderr over the gdb-remote protocol
     // as needed.
     // llgs local-process debugging may specify PTY paths, which will make these
@@ -278,17 +358,30 @@ GDBRemoteCommunicationServerLLGS::AttachToProcess (lldb::pid_t pid)
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64, __FUNCTION__, pid);
 
-    // Before we try to attach, make sure we aren't already monitoring something else.
-    if (m_debugged_process_sp  && m_debugged_process_sp->GetID() != LLDB_INVALID_PROCESS_ID)
+    // Before we try to attach, make sure we aren't already monitoring something else,
+    // unless the client can tell the processes apart.
+    if (!m_multiprocess && m_debugged_process_sp && m_debugged_process_sp->GetID() != LLDB_INVALID_PROCESS_ID)
         return Error("cannot attach to a process %" PRIu64 " when another process with pid %" PRIu64 " is being debugged.", pid, m_debugged_process_sp->GetID());
+    if (m_debugged_processes.find (pid) != m_debugged_processes.end ())
+        return Error("already attached to process %" PRIu64, pid);
 
     // Try to attach.
-    error = NativeProcessProtocol::Attach(pid, *this, m_mainloop, m_debugged_process_sp);
+    NativeProcessProtocolSP process_sp;
+    error = NativeProcessProtocol::Attach(pid, *this, m_mainloop, process_sp);
     if (!error.Success ())
     {
         fprintf (stderr, "%s: failed to attach to process %" PRIu64 ": %s", __FUNCTION__, pid, error.AsCString ());
         return error;
     }
+    m_debugged_processes[pid] = process_sp;
+    SetCurrentProcess (process_sp);
+
+    if (m_non_stop_mode)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
 
     // Setup stdout/stderr mapping from inferior.
     auto terminal_fd = m_debugged_process_sp->GetTerminalFileDescriptor ();
@@ -375,6 +468,9 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
         // POSIX exit status limited to unsigned 8 bits.
         response.PutHex8 (return_code);
 
+        if (m_multiprocess)
+            response.Printf (";process:%" PRIx64, process->GetID ());
+
         return SendPacketNoLock(response.GetData(), response.GetSize());
     }
 }
@@ -390,8 +486,7 @@ AppendHexValue (StreamString &response, const uint8_t* buf, uint32_t buf_size, b
     }
     else
     {
-        for (i = 0; i < buf_size; i++)
-            response.PutHex8 (buf[i]);
+        response.PutBytesAsRawHex8 (buf, buf_size);
     }
 }
 
@@ -523,6 +618,84 @@ GetStopReasonString(StopReason stop_reason)
     return nullptr;
 }
 
+namespace
+{
+    // The number of pointer sized words at the stack pointer and the number of frames of the
+    // frame pointer chain that are expedited in stop replies and jThreadsInfo.
+    const uint32_t k_expedited_stack_word_count = 8;
+    const uint32_t k_expedited_frame_count = 32;
+
+    struct ExpeditedMemory
+    {
+        lldb::addr_t         addr;
+        std::vector<uint8_t> bytes;
+    };
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------
+// Collect the regions of stack memory the client is going to read when
+// it backtraces the thread: the words at the stack pointer and the
+// [saved frame pointer, return address] pair of each frame we can find
+// by walking the frame pointer chain. This only works for code built
+// with frame pointers, but the walk stops as soon as the chain looks
+// bogus so nothing is lost when it doesn't.
+//----------------------------------------------------------------------
+static std::vector<ExpeditedMemory>
+GetExpeditedStackMemory (NativeProcessProtocol &process, NativeThreadProtocol &thread)
+{
+    std::vector<ExpeditedMemory> memory;
+
+    NativeRegisterContextSP reg_ctx_sp = thread.GetRegisterContext ();
+    ArchSpec arch;
+    if (!reg_ctx_sp || !process.GetArchitecture (arch))
+        return memory;
+
+    const uint32_t addr_size = arch.GetAddressByteSize ();
+    if (addr_size != 4 && addr_size != 8)
+        return memory;
+
+    auto read_memory = [&] (lldb::addr_t addr, size_t size) -> const ExpeditedMemory *
+    {
+        ExpeditedMemory region;
+        region.addr = addr;
+        region.bytes.resize (size);
+        size_t bytes_read = 0;
+        Error error = process.ReadMemoryWithoutTrap (addr, region.bytes.data (), size, bytes_read);
+        if (error.Fail () || bytes_read != size)
+            return nullptr;
+        memory.push_back (std::move (region));
+        return &memory.back ();
+    };
+
+    const lldb::addr_t sp = reg_ctx_sp->GetSP ();
+    if (sp != LLDB_INVALID_ADDRESS && sp != 0)
+        read_memory (sp, k_expedited_stack_word_count * addr_size);
+
+    const lldb::ByteOrder byte_order = arch.GetByteOrder ();
+    lldb::addr_t fp = reg_ctx_sp->GetFP ();
+    for (uint32_t frame_idx = 0; frame_idx < k_expedited_frame_count; ++frame_idx)
+    {
+        if (fp == LLDB_INVALID_ADDRESS || fp == 0 || (fp % addr_size) != 0)
+            break;
+
+        const ExpeditedMemory *frame = read_memory (fp, 2 * addr_size);
+        if (frame == nullptr)
+            break;
+
+        DataExtractor frame_data (frame->bytes.data (), frame->bytes.size (), byte_order, addr_size);
+        lldb::offset_t offset = 0;
+        const lldb::addr_t next_fp = frame_data.GetPointer (&offset);
+
+        // The stack grows down, so the caller's frame must be above ours.
+        if (next_fp <= fp)
+            break;
+        fp = next_fp;
+    }
+
+    return memory;
+}
+
 static JSONArray::SP
 GetJSONThreadsInfo(NativeProcessProtocol &process, bool abridged)
 {
@@ -591,7 +764,24 @@ GetJSONThreadsInfo(NativeProcessProtocol &process, bool abridged)
             thread_obj_sp->SetObject("medata", medata_array_sp);
         }
 
-        // TODO: Expedite interesting regions of inferior memory
+        // Expedite the stack memory the client needs to backtrace the thread. This is skipped for
+        // the abridged info sent in the "jstopinfo" key of stop replies to keep them small.
+        if (!abridged)
+        {
+            JSONArray::SP memory_array_sp = std::make_shared<JSONArray>();
+            for (const ExpeditedMemory &region : GetExpeditedStackMemory (process, *thread_sp))
+            {
+                StreamString bytes;
+                bytes.PutBytesAsRawHex8 (region.bytes.data (), region.bytes.size ());
+
+                JSONObject::SP memory_obj_sp = std::make_shared<JSONObject>();
+                memory_obj_sp->SetObject("address", std::make_shared<JSONNumber>(region.addr));
+                memory_obj_sp->SetObject("bytes", std::make_shared<JSONString>(bytes.GetString()));
+                memory_array_sp->AppendObject(memory_obj_sp);
+            }
+            if (memory_array_sp->GetNumElements() > 0)
+                thread_obj_sp->SetObject("memory", memory_array_sp);
+        }
     }
 
     return threads_array_sp;
@@ -599,12 +789,42 @@ GetJSONThreadsInfo(NativeProcessProtocol &process, bool abridged)
 
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
+{
+    StreamString response;
+    const uint8_t error_code = PrepareStopReplyPacketForThread (tid, response);
+    if (error_code)
+        return SendErrorResponse (error_code);
+
+    return SendPacketNoLock (response.GetData(), response.GetSize());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendStopNotificationForThread (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    StreamString response;
+    response.PutCString ("Stop:");
+    const uint8_t error_code = PrepareStopReplyPacketForThread (tid, response);
+    if (error_code)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to prepare stop notification for tid %" PRIu64 ", error %u",
+                         __FUNCTION__, tid, error_code);
+        return PacketResult::ErrorReplyInvalid;
+    }
+
+    return SendNotificationPacketNoLock (response.GetData(), response.GetSize());
+}
+
+uint8_t
+GDBRemoteCommunicationServerLLGS::PrepareStopReplyPacketForThread (lldb::tid_t tid, StreamString &response)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
     // Ensure we have a debugged process.
     if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
-        return SendErrorResponse (50);
+        return 50;
 
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s preparing packet for pid %" PRIu64 " tid %" PRIu64,
@@ -613,13 +833,13 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     // Ensure we can get info on the given thread.
     NativeThreadProtocolSP thread_sp (m_debugged_process_sp->GetThreadByID (tid));
     if (!thread_sp)
-        return SendErrorResponse (51);
+        return 51;
 
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
     if (!thread_sp->GetStopReason (tid_stop_info, description))
-        return SendErrorResponse (52);
+        return 52;
 
     // FIXME implement register handling for exec'd inferiors.
     // if (tid_stop_info.reason == eStopReasonExec)
@@ -628,7 +848,6 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //     InitializeRegisters(force);
     // }
 
-    StreamString response;
     // Output the T packet with the thread
     response.PutChar ('T');
     int signum = tid_stop_info.details.signal.signo;
@@ -647,7 +866,9 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     response.PutHex8 (signum & 0xff);
 
     // Include the tid.
-    response.Printf ("thread:%" PRIx64 ";", tid);
+    response.PutCString ("thread:");
+    AppendThreadID (response, *m_debugged_process_sp, tid);
+    response.PutChar (';');
 
     // Include the thread name if there is one.
     const std::string thread_name = thread_sp->GetName ();
@@ -725,43 +946,58 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
     if (reg_ctx_sp)
     {
-        // Expedite all registers in the first register set (i.e. should be GPRs) that are not contained in other registers.
+        // Expedite the registers the client asked for with QSetExpeditedRegisters, or all registers
+        // in the first register set (i.e. should be GPRs) if it didn't.
+        std::vector<uint32_t> expedited_registers (m_expedited_registers);
         const RegisterSet *reg_set_p;
-        if (reg_ctx_sp->GetRegisterSetCount () > 0 && ((reg_set_p = reg_ctx_sp->GetRegisterSet (0)) != nullptr))
+        if (expedited_registers.empty () &&
+            reg_ctx_sp->GetRegisterSetCount () > 0 && ((reg_set_p = reg_ctx_sp->GetRegisterSet (0)) != nullptr))
         {
             if (log)
                 log->Printf ("GDBRemoteCommunicationServerLLGS::%s expediting registers from set '%s' (registers set count: %zu)", __FUNCTION__, reg_set_p->name ? reg_set_p->name : "<unnamed-set>", reg_set_p->num_registers);
 
             for (const uint32_t *reg_num_p = reg_set_p->registers; *reg_num_p != LLDB_INVALID_REGNUM; ++reg_num_p)
+                expedited_registers.push_back (*reg_num_p);
+        }
+
+        for (const uint32_t reg_num : expedited_registers)
+        {
+            const RegisterInfo *const reg_info_p = reg_ctx_sp->GetRegisterInfoAtIndex (reg_num);
+            if (reg_info_p == nullptr)
+            {
+                if (log)
+                    log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to get register info for register index %" PRIu32, __FUNCTION__, reg_num);
+            }
+            else if (reg_info_p->value_regs == nullptr)
             {
-                const RegisterInfo *const reg_info_p = reg_ctx_sp->GetRegisterInfoAtIndex (*reg_num_p);
-                if (reg_info_p == nullptr)
+                // Only expediate registers that are not contained in other registers.
+                RegisterValue reg_value;
+                Error error = reg_ctx_sp->ReadRegister (reg_info_p, reg_value);
+                if (error.Success ())
                 {
-                    if (log)
-                        log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to get register info for register set '%s', register index %" PRIu32, __FUNCTION__, reg_set_p->name ? reg_set_p->name : "<unnamed-set>", *reg_num_p);
+                    response.Printf ("%.02x:", reg_num);
+                    WriteRegisterValueInHexFixedWidth(response, reg_ctx_sp, *reg_info_p, &reg_value);
+                    response.PutChar (';');
                 }
-                else if (reg_info_p->value_regs == nullptr)
+                else
                 {
-                    // Only expediate registers that are not contained in other registers.
-                    RegisterValue reg_value;
-                    Error error = reg_ctx_sp->ReadRegister (reg_info_p, reg_value);
-                    if (error.Success ())
-                    {
-                        response.Printf ("%.02x:", *reg_num_p);
-                        WriteRegisterValueInHexFixedWidth(response, reg_ctx_sp, *reg_info_p, &reg_value);
-                        response.PutChar (';');
-                    }
-                    else
-                    {
-                        if (log)
-                            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to read register '%s' index %" PRIu32 ": %s", __FUNCTION__, reg_info_p->name ? reg_info_p->name : "<unnamed-register>", *reg_num_p, error.AsCString ());
-
-                    }
+                    if (log)
+                        log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to read register '%s' index %" PRIu32 ": %s", __FUNCTION__, reg_info_p->name ? reg_info_p->name : "<unnamed-register>", reg_num, error.AsCString ());
+
                 }
             }
         }
     }
 
+    // Expedite the stack memory of the stopping thread so the client can
+    // backtrace it without reading memory.
+    for (const ExpeditedMemory &region : GetExpeditedStackMemory (*m_debugged_process_sp, *thread_sp))
+    {
+        response.Printf ("memory:0x%" PRIx64 "=", region.addr);
+        response.PutBytesAsRawHex8 (region.bytes.data (), region.bytes.size ());
+        response.PutChar (';');
+    }
+
     const char* reason_str = GetStopReasonString(tid_stop_info.reason);
     if (reason_str != nullptr)
     {
@@ -791,7 +1027,23 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
         }
     }
 
-    return SendPacketNoLock (response.GetData(), response.GetSize());
+    return 0;
+}
+
+void
+GDBRemoteCommunicationServerLLGS::QueueStopNotification (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    // Only the first pending stop is sent as a notification, the client
+    // fetches the rest with vStopped.
+    m_pending_stop_notifications.push_back (tid);
+    if (m_pending_stop_notifications.size () > 1)
+        return;
+
+    PacketResult result = SendStopNotificationForThread (tid);
+    if (result != PacketResult::Success && log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification for tid %" PRIu64, __FUNCTION__, tid);
 }
 
 void
@@ -803,13 +1055,27 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited (NativeProcessProto
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s called", __FUNCTION__);
 
-    PacketResult result = SendStopReasonForState(StateType::eStateExited);
+    StopSampling ();
+
+    PacketResult result = SendWResponse (process);
     if (result != PacketResult::Success)
     {
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to send stop notification for PID %" PRIu64 ", state: eStateExited", __FUNCTION__, process->GetID ());
     }
 
+    // Keep debugging the other processes, if there are any. The exited
+    // process stays in the list, it may be the one calling us.
+    for (const auto &entry : m_debugged_processes)
+    {
+        if (StateIsRunningState (entry.second->GetState ()) || entry.second->GetState () == eStateStopped)
+        {
+            if (m_debugged_process_sp.get () == process)
+                SetCurrentProcess (entry.second);
+            return;
+        }
+    }
+
     // Close the pipe to the inferior terminal i/o if we launched it
     // and set one up.
     MaybeCloseInferiorTerminalConnection ();
@@ -836,6 +1102,27 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped (NativeProcessProt
             // Don't send anything per debugserver behavior.
             break;
         default:
+            // The packets that follow the stop are about this process.
+            for (const auto &entry : m_debugged_processes)
+            {
+                if (entry.second.get () == process)
+                    SetCurrentProcess (entry.second);
+            }
+
+            // While sampling, the stops we cause ourselves are recorded and
+            // the process resumed without telling the client about them.
+            if (m_sampling && TakeSample (process))
+                break;
+
+            // In non-stop mode the stop is reported asynchronously.
+            if (m_non_stop_mode)
+            {
+                lldb::tid_t tid = process->GetCurrentThreadID ();
+                SetCurrentThreadID (tid);
+                QueueStopNotification (tid);
+                break;
+            }
+
             // In all other cases, send the stop reason.
             PacketResult result = SendStopReasonForState(StateType::eStateStopped);
             if (result != PacketResult::Success)
@@ -847,6 +1134,155 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Stopped (NativeProcessProt
     }
 }
 
+bool
+GDBRemoteCommunicationServerLLGS::ArmSampleTimer (uint64_t delay_ns)
+{
+#if defined(__linux__)
+    if (!m_sample_timer_sp)
+        return false;
+
+    struct itimerspec spec;
+    ::memset (&spec, 0, sizeof (spec));
+    spec.it_value.tv_sec = delay_ns / 1000000000;
+    spec.it_value.tv_nsec = delay_ns % 1000000000;
+    return ::timerfd_settime (m_sample_timer_sp->GetWaitableHandle (), 0, &spec, nullptr) == 0;
+#else
+    return false;
+#endif
+}
+
+void
+GDBRemoteCommunicationServerLLGS::HandleSampleTimer ()
+{
+#if defined(__linux__)
+    uint64_t expirations = 0;
+    if (::read (m_sample_timer_sp->GetWaitableHandle (), &expirations, sizeof (expirations)) != sizeof (expirations))
+        return;
+#endif
+
+    if (!m_sampling || !m_debugged_process_sp)
+        return;
+
+    const StateType state = m_debugged_process_sp->GetState ();
+    if (state == eStateRunning)
+    {
+        // Time for the next sample, the stop comes back through
+        // HandleInferiorState_Stopped.
+        Error error = m_debugged_process_sp->Interrupt ();
+        if (error.Fail ())
+        {
+            Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS));
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to interrupt: %s", __FUNCTION__, error.AsCString ());
+            ArmSampleTimer (m_sample_period_ns);
+        }
+    }
+    else if (StateIsStoppedState (state, false))
+    {
+        // The last sample is recorded, run until the next one. Resuming from
+        // here rather than from the stop notification keeps the process
+        // plugin out of a resume in the middle of its own stop handling.
+        ResumeActionList actions (StateType::eStateRunning, 0);
+        Error error = m_debugged_process_sp->Resume (actions);
+        if (error.Fail ())
+        {
+            StopSampling ();
+            SendStopReasonForState (StateType::eStateStopped);
+            return;
+        }
+        ArmSampleTimer (m_sample_period_ns);
+    }
+}
+
+bool
+GDBRemoteCommunicationServerLLGS::TakeSample (NativeProcessProtocol *process)
+{
+    // Each sample is a pc and up to this many return addresses.
+    const size_t max_depth = 64;
+    // Keep a long run from using an unbounded amount of memory.
+    const size_t max_samples = 1000000;
+
+    ArchSpec arch;
+    process->GetArchitecture (arch);
+    const uint32_t addr_size = arch.GetAddressByteSize ();
+
+    bool stopped_for_sample = true;
+    NativeThreadProtocolSP thread_sp;
+    for (uint32_t i = 0; (thread_sp = process->GetThreadAtIndex (i)); ++i)
+    {
+        // Anything but our interrupt means the stop is real.
+        ThreadStopInfo stop_info;
+        std::string description;
+        if (thread_sp->GetStopReason (stop_info, description))
+        {
+            if (stop_info.reason == eStopReasonSignal)
+            {
+                if (stop_info.details.signal.signo != SIGSTOP)
+                    stopped_for_sample = false;
+            }
+            else if (stop_info.reason != eStopReasonNone && stop_info.reason != eStopReasonInvalid)
+                stopped_for_sample = false;
+        }
+
+        NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+        if (!reg_ctx_sp)
+            continue;
+
+        ThreadSample sample;
+        sample.tid = thread_sp->GetID ();
+        sample.pcs.push_back (reg_ctx_sp->GetPC (0));
+
+        // A frame record holds the caller's frame pointer followed by the
+        // return address. Code built without frame pointers ends the chain
+        // early, or makes it point at garbage that fails the checks below.
+        lldb::addr_t fp = reg_ctx_sp->GetFP (0);
+        while (fp != 0 && sample.pcs.size () < max_depth)
+        {
+            uint8_t record[16];
+            size_t bytes_read = 0;
+            Error error = process->ReadMemoryWithoutTrap (fp, record, 2 * addr_size, bytes_read);
+            if (error.Fail () || bytes_read != 2 * addr_size)
+                break;
+
+            DataExtractor data (record, 2 * addr_size, arch.GetByteOrder (), addr_size);
+            lldb::offset_t offset = 0;
+            const lldb::addr_t caller_fp = data.GetAddress (&offset);
+            const lldb::addr_t return_address = data.GetAddress (&offset);
+            if (return_address == 0)
+                break;
+            sample.pcs.push_back (return_address);
+
+            // The stack grows down, the caller's frame is above ours.
+            if (caller_fp <= fp)
+                break;
+            fp = caller_fp;
+        }
+        m_samples.push_back (std::move (sample));
+    }
+
+    if (stopped_for_sample &&
+            m_samples.size () < max_samples &&
+            std::chrono::steady_clock::now () < m_sample_end_time &&
+            ArmSampleTimer (1))
+        return true;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s sampling done with %zu samples, %s",
+                __FUNCTION__, m_samples.size (), stopped_for_sample ? "time is up" : "the process stopped");
+    StopSampling ();
+    return false;
+}
+
+void
+GDBRemoteCommunicationServerLLGS::StopSampling ()
+{
+    if (!m_sampling)
+        return;
+    m_sampling = false;
+    ArmSampleTimer (0);
+}
+
 void
 GDBRemoteCommunicationServerLLGS::ProcessStateChanged (NativeProcessProtocol *process, lldb::StateType state)
 {
@@ -905,6 +1341,20 @@ GDBRemoteCommunicationServerLLGS::DidExec (NativeProcessProtocol *process)
     ClearProcessSpecificData ();
 }
 
+void
+GDBRemoteCommunicationServerLLGS::ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+{
+    assert (process && "process cannot be NULL");
+
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64, __FUNCTION__, process->GetID (), tid);
+
+    // Flush the inferior output so it shows up before the stop.
+    SendProcessOutput();
+    QueueStopNotification (tid);
+}
+
 void
 GDBRemoteCommunicationServerLLGS::DataAvailableCallback ()
 {
@@ -1099,7 +1549,8 @@ GDBRemoteCommunicationServerLLGS::Handle_qC (StringExtractorGDBRemote &packet)
         return SendErrorResponse (69);
 
     StreamString response;
-    response.Printf ("QC%" PRIx64, thread_sp->GetID ());
+    response.PutCString ("QC");
+    AppendThreadID (response, *m_debugged_process_sp, thread_sp->GetID ());
 
     return SendPacketNoLock (response.GetData(), response.GetSize());
 }
@@ -1118,10 +1569,15 @@ GDBRemoteCommunicationServerLLGS::Handle_k (StringExtractorGDBRemote &packet)
         return PacketResult::Success;
     }
 
-    Error error = m_debugged_process_sp->Kill();
-    if (error.Fail() && log)
-        log->Printf("GDBRemoteCommunicationServerLLGS::%s Failed to kill debugged process %" PRIu64 ": %s",
-                __FUNCTION__, m_debugged_process_sp->GetID(), error.AsCString());
+    for (const auto &entry : m_debugged_processes)
+    {
+        if (!StateIsRunningState (entry.second->GetState ()) && entry.second->GetState () != eStateStopped)
+            continue;
+        Error error = entry.second->Kill();
+        if (error.Fail() && log)
+            log->Printf("GDBRemoteCommunicationServerLLGS::%s Failed to kill debugged process %" PRIu64 ": %s",
+                    __FUNCTION__, entry.first, error.AsCString());
+    }
 
     // No OK response for kill packet.
     // return SendOKResponse ();
@@ -1303,7 +1759,7 @@ GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_vCont_actions (StringExtractorGDBRemote &packet)
 {
     StreamString response;
-    response.Printf("vCont;c;C;s;S");
+    response.Printf("vCont;c;C;s;S;r");
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
@@ -1324,14 +1780,15 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
         return SendIllFormedResponse (packet, "Missing action from vCont package");
     }
 
-    // Check if this is all continue (no options or ";c").
-    if (::strcmp (packet.Peek (), ";c") == 0)
+    // Check if this is all continue (no options or ";c").  In non-stop mode
+    // vCont needs an OK reply, so don't hand it off to 'c' or 's'.
+    if (!m_non_stop_mode && ::strcmp (packet.Peek (), ";c") == 0)
     {
         // Move past the ';', then do a simple 'c'.
         packet.SetFilePos (packet.GetFilePos () + 1);
         return Handle_c (packet);
     }
-    else if (::strcmp (packet.Peek (), ";s") == 0)
+    else if (!m_non_stop_mode && ::strcmp (packet.Peek (), ";s") == 0)
     {
         // Move past the ';', then do a simple 's'.
         packet.SetFilePos (packet.GetFilePos () + 1);
@@ -1346,7 +1803,10 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
         return SendErrorResponse (0x36);
     }
 
-    ResumeActionList thread_actions;
+    // With the multiprocess extensions the actions can be for threads of
+    // different processes, actions without a thread are for the current one.
+    std::map<NativeProcessProtocolSP, ResumeActionList> process_actions;
+    ResumeActionList &thread_actions = process_actions[m_debugged_process_sp];
 
     while (packet.GetBytesLeft () && *packet.Peek () == ';')
     {
@@ -1358,6 +1818,8 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
         thread_action.tid = LLDB_INVALID_THREAD_ID;
         thread_action.state = eStateInvalid;
         thread_action.signal = 0;
+        thread_action.step_range_start = 0;
+        thread_action.step_range_end = 0;
 
         const char action = packet.GetChar ();
         switch (action)
@@ -1384,6 +1846,17 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
                 thread_action.state = eStateStepping;
                 break;
 
+            case 'r':
+                // Step until the pc leaves [start, end)
+                thread_action.state = eStateStepping;
+                thread_action.step_range_start = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+                if (thread_action.step_range_start == LLDB_INVALID_ADDRESS || packet.GetChar () != ',')
+                    return SendIllFormedResponse (packet, "Could not parse range start in vCont packet r action");
+                thread_action.step_range_end = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+                if (thread_action.step_range_end == LLDB_INVALID_ADDRESS)
+                    return SendIllFormedResponse (packet, "Could not parse range end in vCont packet r action");
+                break;
+
             default:
                 return SendIllFormedResponse (packet, "Unsupported vCont action");
                 break;
@@ -1395,34 +1868,126 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
             // Consume the separator.
             packet.GetChar ();
 
-            thread_action.tid = packet.GetHexMaxU32 (false, LLDB_INVALID_THREAD_ID);
-            if (thread_action.tid == LLDB_INVALID_THREAD_ID)
+            NativeProcessProtocolSP process_sp = ReadThreadID (packet, LLDB_INVALID_THREAD_ID, thread_action.tid);
+            if (!process_sp || thread_action.tid == LLDB_INVALID_THREAD_ID)
                 return SendIllFormedResponse (packet, "Could not parse thread number in vCont packet");
+            process_actions[process_sp].Append (thread_action);
+            continue;
         }
 
         thread_actions.Append (thread_action);
     }
 
-    Error error = m_debugged_process_sp->Resume (thread_actions);
-    if (error.Fail ())
+    for (auto &entry : process_actions)
     {
-        if (log)
+        if (entry.second.IsEmpty () && process_actions.size () > 1)
+            continue;
+
+        Error error = entry.first->Resume (entry.second);
+        if (error.Fail ())
         {
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s vCont failed for process %" PRIu64 ": %s",
-                         __FUNCTION__,
-                         m_debugged_process_sp->GetID (),
-                         error.AsCString ());
+            if (log)
+            {
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s vCont failed for process %" PRIu64 ": %s",
+                             __FUNCTION__,
+                             entry.first->GetID (),
+                             error.AsCString ());
+            }
+            return SendErrorResponse (GDBRemoteServerError::eErrorResume);
         }
-        return SendErrorResponse (GDBRemoteServerError::eErrorResume);
+
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, entry.first->GetID ());
     }
 
-    if (log)
-        log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
+    // In non-stop mode the stops are reported with notifications, so we
+    // acknowledge the resume right away.
+    if (m_non_stop_mode)
+        return SendOKResponse ();
 
     // No response required from vCont.
     return PacketResult::Success;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped (StringExtractorGDBRemote &packet)
+{
+    if (!m_non_stop_mode)
+        return SendUnimplementedResponse (packet.GetStringRef ().c_str ());
+
+    // The client has seen the stop we reported last, move on to the next one.
+    if (!m_pending_stop_notifications.empty ())
+        m_pending_stop_notifications.pop_front ();
+
+    if (m_pending_stop_notifications.empty ())
+        return SendOKResponse ();
+
+    return SendStopReplyPacketForThread (m_pending_stop_notifications.front ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    packet.SetFilePos (::strlen ("QNonStop:"));
+    const char mode = packet.GetChar ();
+    if ((mode != '0' && mode != '1') || packet.GetBytesLeft ())
+        return SendIllFormedResponse (packet, "QNonStop expects 0 or 1");
+
+    const bool enable = (mode == '1');
+    if (m_debugged_process_sp)
+    {
+        Error error = m_debugged_process_sp->SetNonStopMode (enable);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to %s non-stop mode: %s",
+                             __FUNCTION__, enable ? "enable" : "disable", error.AsCString ());
+            return SendErrorResponse (0x4e);
+        }
+    }
+
+    m_non_stop_mode = enable;
+    m_pending_stop_notifications.clear ();
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QPassSignals (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+        return SendErrorResponse (68);
+
+    // QPassSignals:<signal>[;<signal>]..., the signal numbers are hex. An
+    // empty list stops passing signals.
+    std::vector<int> signals;
+    packet.SetFilePos (::strlen ("QPassSignals:"));
+    while (packet.GetBytesLeft () > 0)
+    {
+        const uint32_t signo = packet.GetHexMaxU32 (false, std::numeric_limits<uint32_t>::max ());
+        if (signo == std::numeric_limits<uint32_t>::max ())
+            return SendIllFormedResponse (packet, "failed to parse signal number");
+        signals.push_back (signo);
+
+        if (packet.GetBytesLeft () > 0 && packet.GetChar () != ';')
+            return SendIllFormedResponse (packet, "expected ; between signal numbers");
+    }
+
+    Error error = m_debugged_process_sp->IgnoreSignals (signals);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to set the signals to pass: %s",
+                         __FUNCTION__, error.AsCString ());
+        return SendErrorResponse (0x50);
+    }
+    return SendOKResponse ();
+}
+
 void
 GDBRemoteCommunicationServerLLGS::SetCurrentThreadID (lldb::tid_t tid)
 {
@@ -1454,6 +2019,15 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason (StringExtractorGDBRemote &
     if (!m_debugged_process_sp)
         return SendErrorResponse (02);
 
+    // In non-stop mode report the pending stops, the rest of them are
+    // retrieved with vStopped.
+    if (m_non_stop_mode && StateIsRunningState (m_debugged_process_sp->GetState ()))
+    {
+        if (m_pending_stop_notifications.empty ())
+            return SendOKResponse ();
+        return SendStopReplyPacketForThread (m_pending_stop_notifications.front ());
+    }
+
     return SendStopReasonForState (m_debugged_process_sp->GetState());
 }
 
@@ -1656,22 +2230,37 @@ GDBRemoteCommunicationServerLLGS::Handle_qfThreadInfo (StringExtractorGDBRemote
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s() starting thread iteration", __FUNCTION__);
 
-    NativeThreadProtocolSP thread_sp;
-    uint32_t thread_index;
-    for (thread_index = 0, thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index);
-         thread_sp;
-         ++thread_index, thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index))
+    // With the multiprocess extensions the threads of all processes are listed.
+    std::vector<NativeProcessProtocolSP> processes;
+    if (m_multiprocess)
     {
-        if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s() iterated thread %" PRIu32 "(%s, tid=0x%" PRIx64 ")", __FUNCTION__, thread_index, thread_sp ? "is not null" : "null", thread_sp ? thread_sp->GetID () : LLDB_INVALID_THREAD_ID);
-        if (thread_index > 0)
-            response.PutChar(',');
-        response.Printf ("%" PRIx64, thread_sp->GetID ());
+        for (const auto &entry : m_debugged_processes)
+            processes.push_back (entry.second);
     }
+    else
+        processes.push_back (m_debugged_process_sp);
+
+    bool first_thread = true;
+    for (const NativeProcessProtocolSP &process_sp : processes)
+    {
+        NativeThreadProtocolSP thread_sp;
+        uint32_t thread_index;
+        for (thread_index = 0, thread_sp = process_sp->GetThreadAtIndex (thread_index);
+             thread_sp;
+             ++thread_index, thread_sp = process_sp->GetThreadAtIndex (thread_index))
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s() iterated thread %" PRIu32 "(%s, tid=0x%" PRIx64 ")", __FUNCTION__, thread_index, thread_sp ? "is not null" : "null", thread_sp ? thread_sp->GetID () : LLDB_INVALID_THREAD_ID);
+            if (!first_thread)
+                response.PutChar(',');
+            AppendThreadID (response, *process_sp, thread_sp->GetID ());
+            first_thread = false;
+        }
+    }
+
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s() finished thread iteration", __FUNCTION__);
 
-    if (log)
-        log->Printf ("GDBRemoteCommunicationServerLLGS::%s() finished thread iteration", __FUNCTION__);
-
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
@@ -1753,8 +2342,7 @@ GDBRemoteCommunicationServerLLGS::Handle_p (StringExtractorGDBRemote &packet)
     }
 
     // FIXME flip as needed to get data in big/little endian format for this host.
-    for (uint32_t i = 0; i < reg_value.GetByteSize (); ++i)
-        response.PutHex8 (data[i]);
+    response.PutBytesAsRawHex8 (data, reg_value.GetByteSize ());
 
     return SendPacketNoLock (response.GetData (), response.GetSize ());
 }
@@ -1849,6 +2437,150 @@ GDBRemoteCommunicationServerLLGS::Handle_P (StringExtractorGDBRemote &packet)
     return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_g (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
+
+    // Get the thread to use.
+    packet.SetFilePos (strlen("g"));
+    NativeThreadProtocolSP thread_sp = GetThreadFromSuffix (packet);
+    if (!thread_sp)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no thread available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Get the thread's register context.
+    NativeRegisterContextSP reg_context_sp (thread_sp->GetRegisterContext ());
+    if (!reg_context_sp)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64 " failed, no register context available for the thread", __FUNCTION__, m_debugged_process_sp->GetID (), thread_sp->GetID ());
+        return SendErrorResponse (0x15);
+    }
+
+    // The registers are laid out at the offsets we report in qRegisterInfo. Registers that
+    // are contained in other registers are covered by their containing register.
+    const uint32_t reg_count = reg_context_sp->GetUserRegisterCount ();
+    std::vector<uint8_t> regs_buffer;
+    for (uint32_t reg_index = 0; reg_index < reg_count; ++reg_index)
+    {
+        const RegisterInfo *reg_info = reg_context_sp->GetRegisterInfoAtIndex (reg_index);
+        if (!reg_info || reg_info->value_regs != nullptr)
+            continue;
+
+        const size_t reg_end = reg_info->byte_offset + reg_info->byte_size;
+        if (regs_buffer.size () < reg_end)
+            regs_buffer.resize (reg_end, 0);
+
+        // Unreadable registers are left as zeros like in the stop reply packets.
+        RegisterValue reg_value;
+        Error error = reg_context_sp->ReadRegister (reg_info, reg_value);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to read register %" PRIu32 " (%s): %s", __FUNCTION__, reg_index, reg_info->name, error.AsCString ());
+            continue;
+        }
+
+        const uint8_t *const data = reinterpret_cast<const uint8_t*> (reg_value.GetBytes ());
+        if (data)
+            memcpy (&regs_buffer[reg_info->byte_offset], data, std::min<size_t> (reg_value.GetByteSize (), reg_info->byte_size));
+    }
+
+    StreamGDBRemote response;
+    response.PutBytesAsRawHex8 (regs_buffer.data (), regs_buffer.size ());
+
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_G (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_THREAD));
+
+    // Get process architecture.
+    ArchSpec process_arch;
+    if (!m_debugged_process_sp || !m_debugged_process_sp->GetArchitecture (process_arch))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to retrieve inferior architecture", __FUNCTION__);
+        return SendErrorResponse (0x49);
+    }
+
+    // Parse out the register data, it is followed by the optional thread suffix.
+    packet.SetFilePos (strlen("G"));
+    std::vector<uint8_t> regs_buffer (packet.GetBytesLeft () / 2);
+    regs_buffer.resize (packet.GetHexBytesAvail (regs_buffer.data (), regs_buffer.size ()));
+    if (regs_buffer.empty ())
+        return SendIllFormedResponse (packet, "G packet missing register data");
+
+    // Get the thread to use.
+    NativeThreadProtocolSP thread_sp = GetThreadFromSuffix (packet);
+    if (!thread_sp)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no thread available", __FUNCTION__);
+        return SendErrorResponse (0x28);
+    }
+
+    // Get the thread's register context.
+    NativeRegisterContextSP reg_context_sp (thread_sp->GetRegisterContext ());
+    if (!reg_context_sp)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64 " failed, no register context available for the thread", __FUNCTION__, m_debugged_process_sp->GetID (), thread_sp->GetID ());
+        return SendErrorResponse (0x15);
+    }
+
+    const uint32_t reg_count = reg_context_sp->GetUserRegisterCount ();
+    for (uint32_t reg_index = 0; reg_index < reg_count; ++reg_index)
+    {
+        const RegisterInfo *reg_info = reg_context_sp->GetRegisterInfoAtIndex (reg_index);
+        if (!reg_info || reg_info->value_regs != nullptr)
+            continue;
+
+        // Registers past the end of the data the client sent are left alone.
+        if (reg_info->byte_offset + reg_info->byte_size > regs_buffer.size ())
+            continue;
+
+        RegisterValue reg_value (&regs_buffer[reg_info->byte_offset], reg_info->byte_size, process_arch.GetByteOrder ());
+        Error error = reg_context_sp->WriteRegister (reg_info, reg_value);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, write of register %" PRIu32 " (%s) failed: %s", __FUNCTION__, reg_index, reg_info->name, error.AsCString ());
+            return SendErrorResponse (0x32);
+        }
+    }
+
+    return SendOKResponse();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QSetExpeditedRegisters (StringExtractorGDBRemote &packet)
+{
+    // A comma separated list of register numbers, an empty list restores the default of
+    // expediting the first register set.
+    packet.SetFilePos (strlen("QSetExpeditedRegisters:"));
+    std::vector<uint32_t> expedited_registers;
+    while (packet.GetBytesLeft () > 0)
+    {
+        const uint32_t reg_num = packet.GetHexMaxU32 (false, LLDB_INVALID_REGNUM);
+        if (reg_num == LLDB_INVALID_REGNUM)
+            return SendIllFormedResponse (packet, "Invalid register number in QSetExpeditedRegisters packet");
+        expedited_registers.push_back (reg_num);
+
+        if (packet.GetBytesLeft () > 0 && packet.GetChar () != ',')
+            return SendIllFormedResponse (packet, "Comma sep missing in QSetExpeditedRegisters packet");
+    }
+
+    m_expedited_registers.swap (expedited_registers);
+    return SendOKResponse ();
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_H (StringExtractorGDBRemote &packet)
 {
@@ -1888,7 +2620,15 @@ GDBRemoteCommunicationServerLLGS::Handle_H (StringExtractorGDBRemote &packet)
 
     // Parse out the thread number.
     // FIXME return a parse success/fail value.  All values are valid here.
-    const lldb::tid_t tid = packet.GetHexMaxU64 (false, std::numeric_limits<lldb::tid_t>::max ());
+    lldb::tid_t tid;
+    NativeProcessProtocolSP process_sp = ReadThreadID (packet, std::numeric_limits<lldb::tid_t>::max (), tid);
+    if (!process_sp)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, unknown pid", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+    SetCurrentProcess (process_sp);
 
     // Ensure we have the given thread when not specifying -1 (all threads) or 0 (any thread).
     if (tid != LLDB_INVALID_THREAD_ID && tid != 0)
@@ -1970,6 +2710,9 @@ GDBRemoteCommunicationServerLLGS::Handle_interrupt (StringExtractorGDBRemote &pa
         return SendErrorResponse (0x15);
     }
 
+    // The client wants this stop reported, even in the middle of a jSample.
+    StopSampling ();
+
     // Interrupt the process.
     Error error = m_debugged_process_sp->Interrupt ();
     if (error.Fail ())
@@ -2055,104 +2798,194 @@ GDBRemoteCommunicationServerLLGS::Handle_memory_read(StringExtractorGDBRemote &p
     packet.SetFilePos(0);
     char kind = packet.GetChar('?');
     if (kind == 'x')
-        response.PutEscapedBytes(buf.data(), byte_count);
+        return SendBinaryPacketNoLock(buf.data(), bytes_read);
     else
     {
         assert(kind == 'm');
-        for (size_t i = 0; i < bytes_read; ++i)
-            response.PutHex8(buf[i]);
+        response.PutBytesAsRawHex8(buf.data(), bytes_read);
     }
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
 GDBRemoteCommunication::PacketResult
-GDBRemoteCommunicationServerLLGS::Handle_M (StringExtractorGDBRemote &packet)
+GDBRemoteCommunicationServerLLGS::Handle_QSetSharedMemory (StringExtractorGDBRemote &packet)
 {
+    // QSetSharedMemory:name:<hex encoded name>;size:<size in hex>;
+    //
+    // A client on the same host created shared memory with this name for
+    // qReadMemoryShared results. Clients on other hosts get an error,
+    // because the name doesn't exist here.
+#if defined(__ANDROID_NDK__)
+    return SendUnimplementedResponse ("shared memory is not supported");
+#else
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    packet.SetFilePos (strlen ("QSetSharedMemory:"));
+    std::string name;
+    uint64_t size = 0;
+    std::string key;
+    std::string value;
+    while (packet.GetNameColonValue (key, value))
     {
-        if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
-        return SendErrorResponse (0x15);
+        if (key.compare ("name") == 0)
+        {
+            StringExtractor extractor (value.c_str ());
+            extractor.GetHexByteString (name);
+        }
+        else if (key.compare ("size") == 0)
+        {
+            bool success = false;
+            size = StringConvert::ToUInt64 (value.c_str (), 0, 16, &success);
+            if (!success)
+                return SendIllFormedResponse (packet, "QSetSharedMemory has an invalid size");
+        }
     }
+    if (name.empty () || size == 0)
+        return SendIllFormedResponse (packet, "QSetSharedMemory needs a name and a size");
 
-    // Parse out the memory address.
-    packet.SetFilePos (strlen("M"));
-    if (packet.GetBytesLeft() < 1)
-        return SendIllFormedResponse(packet, "Too short M packet");
+    m_shared_memory_up.reset ();
+    m_shared_memory_offset = 0;
 
-    // Read the address.  Punting on validation.
-    // FIXME replace with Hex U64 read with no default value that fails on failed read.
-    const lldb::addr_t write_addr = packet.GetHexMaxU64(false, 0);
+    std::unique_ptr<ConnectionSharedMemory> shared_memory_up (new ConnectionSharedMemory ());
+    Error error;
+    if (shared_memory_up->Open (false, name.c_str (), size, &error) != eConnectionStatusSuccess)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to open %s: %s", __FUNCTION__, name.c_str (), error.AsCString ());
+        return SendErrorResponse (0x53);
+    }
+    // The client owns the name and removes it, don't remove it when we're
+    // done with the memory.
+    shared_memory_up->Unlink ();
 
-    // Validate comma.
-    if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ','))
-        return SendIllFormedResponse(packet, "Comma sep missing in M packet");
+    m_shared_memory_up = std::move (shared_memory_up);
+    return SendOKResponse ();
+#endif
+}
 
-    // Get # bytes to read.
-    if (packet.GetBytesLeft() < 1)
-        return SendIllFormedResponse(packet, "Length missing in M packet");
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qReadMemoryShared (StringExtractorGDBRemote &packet)
+{
+    // qReadMemoryShared:<addr>,<length>
+    //
+    // Like x, but the memory is read into the shared memory from
+    // QSetSharedMemory and the reply is "<offset>,<bytes read>" in hex. The
+    // data at the offset stays valid until the results of later requests
+    // wrap around the shared memory.
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    const uint64_t byte_count = packet.GetHexMaxU64(false, 0);
-    if (byte_count == 0)
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
     {
         if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s nothing to write: zero-length packet", __FUNCTION__);
-        return PacketResult::Success;
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
     }
 
-    // Validate colon.
-    if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ':'))
-        return SendIllFormedResponse(packet, "Comma sep missing in M packet after byte length");
+    if (!m_shared_memory_up)
+        return SendErrorResponse (0x53);
 
-    // Allocate the conversion buffer.
-    std::vector<uint8_t> buf(byte_count, 0);
-    if (buf.empty())
-        return SendErrorResponse (0x78);
+    packet.SetFilePos (strlen ("qReadMemoryShared:"));
+    const lldb::addr_t read_addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (read_addr == LLDB_INVALID_ADDRESS || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "qReadMemoryShared needs an address and a length");
+    const uint64_t byte_count = packet.GetHexMaxU64 (false, 0);
 
-    // Convert the hex memory write contents to bytes.
-    StreamGDBRemote response;
-    const uint64_t convert_count = packet.GetHexBytes(&buf[0], byte_count, 0);
-    if (convert_count != byte_count)
+    const size_t shared_size = m_shared_memory_up->GetByteSize ();
+    if (byte_count == 0 || byte_count > shared_size)
+        return SendIllFormedResponse (packet, "qReadMemoryShared has an invalid length");
+
+    if (m_shared_memory_offset + byte_count > shared_size)
+        m_shared_memory_offset = 0;
+    const size_t offset = m_shared_memory_offset;
+
+    size_t bytes_read = 0;
+    Error error = m_debugged_process_sp->ReadMemoryWithoutTrap (read_addr, m_shared_memory_up->GetBytes () + offset, byte_count, bytes_read);
+    if (error.Fail () || bytes_read == 0)
     {
         if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": asked to write %" PRIu64 " bytes, but only found %" PRIu64 " to convert.", __FUNCTION__, m_debugged_process_sp->GetID (), write_addr, byte_count, convert_count);
-        return SendIllFormedResponse (packet, "M content byte length specified did not match hex-encoded content length");
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": failed to read. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), read_addr, error.AsCString ());
+        return SendErrorResponse (0x08);
     }
+    m_shared_memory_offset = offset + bytes_read;
 
-    // Write the process memory.
-    size_t bytes_written = 0;
-    Error error = m_debugged_process_sp->WriteMemory (write_addr, &buf[0], byte_count, bytes_written);
-    if (error.Fail ())
+    StreamGDBRemote response;
+    response.Printf ("%" PRIx64 ",%" PRIx64, (uint64_t)offset, (uint64_t)bytes_read);
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qSearch_memory (StringExtractorGDBRemote &packet)
+{
+    // qSearch:memory:<addr>;<length>;<escaped pattern>
+    //
+    // The reply is "1,<addr>" for the first match that lies completely in
+    // [addr, addr + length) or "0" if there is none.
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
     {
         if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": failed to write. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), write_addr, error.AsCString ());
-        return SendErrorResponse (0x09);
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
     }
 
-    if (bytes_written == 0)
-    {
-        if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": wrote 0 of %" PRIu64 " requested bytes", __FUNCTION__, m_debugged_process_sp->GetID (), write_addr, byte_count);
-        return SendErrorResponse (0x09);
+    packet.SetFilePos (strlen ("qSearch:memory:"));
+    const lldb::addr_t search_addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (search_addr == LLDB_INVALID_ADDRESS || packet.GetChar () != ';')
+        return SendIllFormedResponse (packet, "qSearch:memory needs an address");
+    const uint64_t length = packet.GetHexMaxU64 (false, 0);
+    if (packet.GetChar () != ';')
+        return SendIllFormedResponse (packet, "qSearch:memory needs a length");
+    std::string pattern;
+    if (packet.GetEscapedBinaryData (pattern) == 0)
+        return SendIllFormedResponse (packet, "qSearch:memory needs a pattern");
+
+    lldb::addr_t found_addr = LLDB_INVALID_ADDRESS;
+    if (length >= pattern.size ())
+    {
+        NativeProcessProtocolSP process_sp = m_debugged_process_sp;
+        auto read_memory = [process_sp](lldb::addr_t addr, void *buf, size_t size) -> size_t {
+            size_t bytes_read = 0;
+            process_sp->ReadMemoryWithoutTrap (addr, buf, size, bytes_read);
+            return bytes_read;
+        };
+        auto region_info = [process_sp](lldb::addr_t addr, lldb::addr_t &region_end, bool &readable) -> bool {
+            MemoryRegionInfo info;
+            if (process_sp->GetMemoryRegionInfo (addr, info).Fail ())
+                return false;
+            region_end = info.GetRange ().GetRangeEnd ();
+            readable = info.GetReadable () != MemoryRegionInfo::eNo;
+            return true;
+        };
+        // Only matches that end within the searched bytes count.
+        lldb::addr_t high = search_addr + (length - pattern.size ()) + 1;
+        if (high < search_addr)
+            high = LLDB_INVALID_ADDRESS;
+        found_addr = MemorySearch::Find (search_addr, high, reinterpret_cast<const uint8_t *>(pattern.data ()),
+                                         pattern.size (), read_memory, region_info);
     }
 
-    return SendOKResponse ();
+    StreamGDBRemote response;
+    if (found_addr == LLDB_INVALID_ADDRESS)
+        response.PutChar ('0');
+    else
+        response.Printf ("1,%" PRIx64, found_addr);
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
 }
 
 GDBRemoteCommunication::PacketResult
-GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported (StringExtractorGDBRemote &packet)
+GDBRemoteCommunicationServerLLGS::Handle_qFindReferences (StringExtractorGDBRemote &packet)
 {
+    // qFindReferences:<value>,<start addr>,<max matches>
+    //
+    // Scans the pointer aligned words of the readable and writable regions
+    // at or after the start address for the value. The reply is 'm' or 'l'
+    // followed by the comma separated addresses of the matches. 'm' means
+    // the reply was capped and the client should ask again, starting after
+    // the last match.
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    // Currently only the NativeProcessProtocol knows if it can handle a qMemoryRegionInfoSupported
-    // request, but we're not guaranteed to be attached to a process.  For now we'll assume the
-    // client only asks this when a process is being debugged.
-
-    // Ensure we have a process running; otherwise, we can't figure this out
-    // since we won't have a NativeProcessProtocol.
     if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
     {
         if (log)
@@ -2160,24 +2993,68 @@ GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported (StringExtra
         return SendErrorResponse (0x15);
     }
 
-    // Test if we can get any region back when asking for the region around NULL.
-    MemoryRegionInfo region_info;
-    const Error error = m_debugged_process_sp->GetMemoryRegionInfo (0, region_info);
-    if (error.Fail ())
+    packet.SetFilePos (strlen ("qFindReferences:"));
+    const uint64_t value = packet.GetHexMaxU64 (false, 0);
+    if (packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "qFindReferences needs a value");
+    lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "qFindReferences needs a start address");
+    const uint64_t max_matches = packet.GetHexMaxU64 (false, 0);
+    if (max_matches == 0)
+        return SendIllFormedResponse (packet, "qFindReferences needs a match count");
+
+    ArchSpec arch;
+    if (!m_debugged_process_sp->GetArchitecture (arch) || arch.GetAddressByteSize () == 0)
+        return SendErrorResponse (0x16);
+
+    // Keep the reply well within the packet size we advertise.
+    const size_t max_reply_matches = std::min<uint64_t> (max_matches, 512);
+
+    NativeProcessProtocolSP process_sp = m_debugged_process_sp;
+    auto read_memory = [process_sp](lldb::addr_t addr, void *buf, size_t size) -> size_t {
+        size_t bytes_read = 0;
+        process_sp->ReadMemoryWithoutTrap (addr, buf, size, bytes_read);
+        return bytes_read;
+    };
+
+    std::vector<lldb::addr_t> matches;
+    bool more = false;
+    while (true)
     {
-        // We don't support memory region info collection for this NativeProcessProtocol.
-        return SendUnimplementedResponse ("");
+        MemoryRegionInfo info;
+        if (m_debugged_process_sp->GetMemoryRegionInfo (addr, info).Fail ())
+            break;
+        const lldb::addr_t region_end = info.GetRange ().GetRangeEnd ();
+        if (region_end <= addr)
+            break;
+        if (info.GetReadable () == MemoryRegionInfo::eYes && info.GetWritable () == MemoryRegionInfo::eYes)
+        {
+            MemorySearch::FindPointers (std::max (addr, info.GetRange ().GetRangeBase ()), region_end, value,
+                                        arch.GetAddressByteSize (), arch.GetByteOrder (), read_memory,
+                                        max_reply_matches, matches);
+            if (matches.size () >= max_reply_matches)
+            {
+                // There may be more matches after the last one.
+                more = true;
+                break;
+            }
+        }
+        addr = region_end;
     }
 
-    return SendOKResponse();
+    StreamGDBRemote response;
+    response.PutChar (more ? 'm' : 'l');
+    for (size_t i = 0; i < matches.size (); ++i)
+        response.Printf ("%s%" PRIx64, i > 0 ? "," : "", matches[i]);
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
 }
 
 GDBRemoteCommunication::PacketResult
-GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo (StringExtractorGDBRemote &packet)
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemRead (StringExtractorGDBRemote &packet)
 {
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    // Ensure we have a process.
     if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
     {
         if (log)
@@ -2185,39 +3062,328 @@ GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo (StringExtractorGDBRe
         return SendErrorResponse (0x15);
     }
 
-    // Parse out the memory address.
-    packet.SetFilePos (strlen("qMemoryRegionInfo:"));
-    if (packet.GetBytesLeft() < 1)
-        return SendIllFormedResponse(packet, "Too short qMemoryRegionInfo: packet");
-
-    // Read the address.  Punting on validation.
-    const lldb::addr_t read_addr = packet.GetHexMaxU64(false, 0);
+    packet.SetFilePos (strlen("MultiMemRead:"));
+    std::string key;
+    std::string value;
+    std::string ranges_str;
+    while (packet.GetNameColonValue(key, value))
+    {
+        if (key == "ranges")
+            ranges_str = value;
+    }
+    if (ranges_str.empty())
+        return SendIllFormedResponse(packet, "No ranges in MultiMemRead packet");
 
-    StreamGDBRemote response;
+    // Keep the response within the packet size we advertise in qSupported
+    const uint64_t max_total_size = 128 * 1024;
 
-    // Get the memory region info for the target address.
-    MemoryRegionInfo region_info;
-    const Error error = m_debugged_process_sp->GetMemoryRegionInfo (read_addr, region_info);
-    if (error.Fail ())
+    std::vector<NativeProcessProtocol::MemoryReadRange> ranges;
+    uint64_t total_size = 0;
+    StringExtractor ranges_extractor (ranges_str.c_str());
+    while (ranges_extractor.GetBytesLeft() > 0)
     {
-        // Return the error message.
+        NativeProcessProtocol::MemoryReadRange range;
+        range.addr = ranges_extractor.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (range.addr == LLDB_INVALID_ADDRESS || ranges_extractor.GetChar() != ',')
+            return SendIllFormedResponse(packet, "Invalid address in MultiMemRead packet");
+        const uint64_t size = ranges_extractor.GetHexMaxU64(false, UINT64_MAX);
+        if (size == UINT64_MAX)
+            return SendIllFormedResponse(packet, "Invalid length in MultiMemRead packet");
+        if (ranges_extractor.GetBytesLeft() > 0 && ranges_extractor.GetChar() != ',')
+            return SendIllFormedResponse(packet, "Comma sep missing in MultiMemRead packet");
 
-        response.PutCString ("error:");
-        response.PutCStringAsRawHex8 (error.AsCString ());
-        response.PutChar (';');
+        total_size += size;
+        if (total_size > max_total_size)
+            return SendErrorResponse (0x78);
+        range.size = size;
+        range.buf = nullptr;
+        range.bytes_read = 0;
+        ranges.push_back(range);
     }
-    else
+
+    // Read all of the ranges into a single buffer
+    std::string buf(total_size, '\0');
+    size_t buf_offset = 0;
+    for (NativeProcessProtocol::MemoryReadRange &range : ranges)
     {
-        // Range start and size.
-        response.Printf ("start:%" PRIx64 ";size:%" PRIx64 ";", region_info.GetRange ().GetRangeBase (), region_info.GetRange ().GetByteSize ());
+        range.buf = &buf[buf_offset];
+        buf_offset += range.size;
+    }
 
-        // Permissions.
-        if (region_info.GetReadable () ||
-            region_info.GetWritable () ||
-            region_info.GetExecutable ())
-        {
-            // Write permissions info.
-            response.PutCString ("permissions:");
+    Error error = m_debugged_process_sp->ReadMemoryRangesWithoutTrap(ranges);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to read %zu ranges. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), ranges.size(), error.AsCString ());
+        return SendErrorResponse (0x08);
+    }
+
+    // The response is the number of bytes read for every range followed by the
+    // bytes that were read, in the same order as the requested ranges.
+    StreamGDBRemote response;
+    for (size_t i = 0; i < ranges.size(); ++i)
+        response.Printf ("%s%" PRIx64, i > 0 ? "," : "", (uint64_t)ranges[i].bytes_read);
+    response.PutChar (';');
+    for (const NativeProcessProtocol::MemoryReadRange &range : ranges)
+        response.PutEscapedBytes(range.buf, range.bytes_read);
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiMemHash (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    packet.SetFilePos (strlen("MultiMemHash:"));
+    std::string key;
+    std::string value;
+    std::string ranges_str;
+    uint64_t block_size = 0x1000;
+    while (packet.GetNameColonValue(key, value))
+    {
+        if (key == "ranges")
+            ranges_str = value;
+        else if (key == "block")
+            block_size = StringConvert::ToUInt64(value.c_str(), 0, 16);
+    }
+    if (ranges_str.empty())
+        return SendIllFormedResponse(packet, "No ranges in MultiMemHash packet");
+    if (block_size == 0 || block_size > 0x100000)
+        return SendIllFormedResponse(packet, "Invalid block size in MultiMemHash packet");
+
+    // Keep the response within the packet size we advertise in qSupported,
+    // every hash takes 17 characters.
+    const uint64_t max_total_blocks = 4096;
+
+    std::vector<std::pair<lldb::addr_t, uint64_t>> ranges;
+    uint64_t total_blocks = 0;
+    StringExtractor ranges_extractor (ranges_str.c_str());
+    while (ranges_extractor.GetBytesLeft() > 0)
+    {
+        const lldb::addr_t addr = ranges_extractor.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (addr == LLDB_INVALID_ADDRESS || ranges_extractor.GetChar() != ',')
+            return SendIllFormedResponse(packet, "Invalid address in MultiMemHash packet");
+        const uint64_t size = ranges_extractor.GetHexMaxU64(false, UINT64_MAX);
+        if (size == UINT64_MAX)
+            return SendIllFormedResponse(packet, "Invalid length in MultiMemHash packet");
+        if (ranges_extractor.GetBytesLeft() > 0 && ranges_extractor.GetChar() != ',')
+            return SendIllFormedResponse(packet, "Comma sep missing in MultiMemHash packet");
+
+        total_blocks += (size + block_size - 1) / block_size;
+        if (total_blocks > max_total_blocks)
+            return SendErrorResponse (0x78);
+        ranges.push_back(std::make_pair(addr, size));
+    }
+
+    // Read the blocks of a range a batch at a time, with a read range per
+    // block so a block that can't be read doesn't affect the others.
+    const uint64_t max_batch_size = std::max<uint64_t>(block_size, 0x100000);
+    std::string buf(max_batch_size, '\0');
+    StreamGDBRemote response;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        if (i > 0)
+            response.PutChar (';');
+
+        const lldb::addr_t range_end = ranges[i].first + ranges[i].second;
+        lldb::addr_t addr = ranges[i].first;
+        bool first_block = true;
+        while (addr < range_end)
+        {
+            std::vector<NativeProcessProtocol::MemoryReadRange> blocks;
+            size_t buf_offset = 0;
+            while (addr < range_end && buf_offset + block_size <= max_batch_size)
+            {
+                NativeProcessProtocol::MemoryReadRange block;
+                block.addr = addr;
+                block.size = std::min<uint64_t>(block_size, range_end - addr);
+                block.buf = &buf[buf_offset];
+                block.bytes_read = 0;
+                blocks.push_back(block);
+                buf_offset += block.size;
+                addr += block.size;
+            }
+
+            Error error = m_debugged_process_sp->ReadMemoryRangesWithoutTrap(blocks);
+            if (error.Fail () && log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to read %zu blocks. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), blocks.size(), error.AsCString ());
+
+            for (const NativeProcessProtocol::MemoryReadRange &block : blocks)
+            {
+                if (!first_block)
+                    response.PutChar (',');
+                first_block = false;
+                if (error.Success () && block.bytes_read == block.size)
+                    response.Printf ("%16.16" PRIx64, XXHash64(block.buf, block.size));
+                else
+                    response.PutChar ('-');
+            }
+        }
+    }
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_M (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the memory address.
+    packet.SetFilePos (strlen("M"));
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "Too short M packet");
+
+    // Read the address.  Punting on validation.
+    // FIXME replace with Hex U64 read with no default value that fails on failed read.
+    const lldb::addr_t write_addr = packet.GetHexMaxU64(false, 0);
+
+    // Validate comma.
+    if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ','))
+        return SendIllFormedResponse(packet, "Comma sep missing in M packet");
+
+    // Get # bytes to read.
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "Length missing in M packet");
+
+    const uint64_t byte_count = packet.GetHexMaxU64(false, 0);
+    if (byte_count == 0)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s nothing to write: zero-length packet", __FUNCTION__);
+        return PacketResult::Success;
+    }
+
+    // Validate colon.
+    if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ':'))
+        return SendIllFormedResponse(packet, "Comma sep missing in M packet after byte length");
+
+    // Allocate the conversion buffer.
+    std::vector<uint8_t> buf(byte_count, 0);
+    if (buf.empty())
+        return SendErrorResponse (0x78);
+
+    // Convert the hex memory write contents to bytes.
+    StreamGDBRemote response;
+    const uint64_t convert_count = packet.GetHexBytes(&buf[0], byte_count, 0);
+    if (convert_count != byte_count)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": asked to write %" PRIu64 " bytes, but only found %" PRIu64 " to convert.", __FUNCTION__, m_debugged_process_sp->GetID (), write_addr, byte_count, convert_count);
+        return SendIllFormedResponse (packet, "M content byte length specified did not match hex-encoded content length");
+    }
+
+    // Write the process memory.
+    size_t bytes_written = 0;
+    Error error = m_debugged_process_sp->WriteMemory (write_addr, &buf[0], byte_count, bytes_written);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": failed to write. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), write_addr, error.AsCString ());
+        return SendErrorResponse (0x09);
+    }
+
+    if (bytes_written == 0)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": wrote 0 of %" PRIu64 " requested bytes", __FUNCTION__, m_debugged_process_sp->GetID (), write_addr, byte_count);
+        return SendErrorResponse (0x09);
+    }
+
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Currently only the NativeProcessProtocol knows if it can handle a qMemoryRegionInfoSupported
+    // request, but we're not guaranteed to be attached to a process.  For now we'll assume the
+    // client only asks this when a process is being debugged.
+
+    // Ensure we have a process running; otherwise, we can't figure this out
+    // since we won't have a NativeProcessProtocol.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Test if we can get any region back when asking for the region around NULL.
+    MemoryRegionInfo region_info;
+    const Error error = m_debugged_process_sp->GetMemoryRegionInfo (0, region_info);
+    if (error.Fail ())
+    {
+        // We don't support memory region info collection for this NativeProcessProtocol.
+        return SendUnimplementedResponse ("");
+    }
+
+    return SendOKResponse();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Ensure we have a process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the memory address.
+    packet.SetFilePos (strlen("qMemoryRegionInfo:"));
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "Too short qMemoryRegionInfo: packet");
+
+    // Read the address.  Punting on validation.
+    const lldb::addr_t read_addr = packet.GetHexMaxU64(false, 0);
+
+    StreamGDBRemote response;
+
+    // Get the memory region info for the target address.
+    MemoryRegionInfo region_info;
+    const Error error = m_debugged_process_sp->GetMemoryRegionInfo (read_addr, region_info);
+    if (error.Fail ())
+    {
+        // Return the error message.
+
+        response.PutCString ("error:");
+        response.PutCStringAsRawHex8 (error.AsCString ());
+        response.PutChar (';');
+    }
+    else
+    {
+        // Range start and size.
+        response.Printf ("start:%" PRIx64 ";size:%" PRIx64 ";", region_info.GetRange ().GetRangeBase (), region_info.GetRange ().GetByteSize ());
+
+        // Permissions.
+        if (region_info.GetReadable () ||
+            region_info.GetWritable () ||
+            region_info.GetExecutable ())
+        {
+            // Write permissions info.
+            response.PutCString ("permissions:");
 
             if (region_info.GetReadable ())
                 response.PutChar ('r');
@@ -2292,10 +3458,57 @@ GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
     if (size == std::numeric_limits<uint32_t>::max ())
         return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse size argument");
 
+    // Parse out the optional breakpoint conditions, each one given as
+    // ";X<length>,<agent expression bytes>", the ";counting" flag and the
+    // ";threads:<tid>,<tid>..." the breakpoint is for. Breakpoint commands
+    // are not supported and ignored.
+    std::vector<AgentExpression> conditions;
+    bool counting = false;
+    std::vector<lldb::tid_t> thread_ids;
+    while (packet.GetBytesLeft() > 0 && packet.GetChar () == ';')
+    {
+        if (::strncmp (packet.Peek (), "counting", strlen ("counting")) == 0)
+        {
+            packet.SetFilePos (packet.GetFilePos () + strlen ("counting"));
+            counting = true;
+            continue;
+        }
+        if (::strncmp (packet.Peek (), "threads:", strlen ("threads:")) == 0)
+        {
+            packet.SetFilePos (packet.GetFilePos () + strlen ("threads:"));
+            do
+            {
+                const lldb::tid_t tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+                if (tid == LLDB_INVALID_THREAD_ID)
+                    return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse thread id");
+                thread_ids.push_back (tid);
+            } while (packet.GetBytesLeft () > 0 && packet.PeekChar () == ',' && packet.GetChar () == ',');
+            continue;
+        }
+        if (packet.PeekChar () != 'X')
+            break;
+        packet.GetChar ();
+
+        const uint32_t length = packet.GetHexMaxU32 (false, 0);
+        if (length == 0 || packet.GetChar () != ',' || packet.GetBytesLeft () < length * 2)
+            return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse breakpoint condition");
+
+        std::vector<uint8_t> bytes (length);
+        if (packet.GetHexBytes (&bytes[0], length, 0) != length)
+            return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse breakpoint condition");
+        conditions.push_back (AgentExpression (&bytes[0], length));
+    }
+
     if (want_breakpoint)
     {
         // Try to set the breakpoint.
-        const Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
+        Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
+        if (error.Success () && !want_hardware)
+            error = m_debugged_process_sp->SetBreakpointConditions (addr, conditions);
+        if (error.Success () && !want_hardware)
+            error = m_debugged_process_sp->SetBreakpointCounting (addr, counting);
+        if (error.Success () && !want_hardware)
+            error = m_debugged_process_sp->SetBreakpointThreads (addr, thread_ids);
         if (error.Success ())
             return SendOKResponse ();
         Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -2325,6 +3538,70 @@ GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
     }
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_MultiBreakpoint (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    packet.SetFilePos (strlen("MultiBreakpoint:"));
+    std::string key;
+    std::string value;
+    std::string breakpoints_str;
+    bool insert = true;
+    while (packet.GetNameColonValue(key, value))
+    {
+        if (key == "insert" || key == "remove")
+        {
+            insert = key == "insert";
+            breakpoints_str = value;
+        }
+    }
+    if (breakpoints_str.empty())
+        return SendIllFormedResponse(packet, "No breakpoints in MultiBreakpoint packet");
+
+    std::vector<std::pair<lldb::addr_t, uint32_t>> breakpoints;
+    StringExtractor breakpoints_extractor (breakpoints_str.c_str());
+    while (breakpoints_extractor.GetBytesLeft() > 0)
+    {
+        const lldb::addr_t addr = breakpoints_extractor.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (addr == LLDB_INVALID_ADDRESS || breakpoints_extractor.GetChar() != ',')
+            return SendIllFormedResponse(packet, "Invalid address in MultiBreakpoint packet");
+        const uint32_t size = breakpoints_extractor.GetHexMaxU32(false, UINT32_MAX);
+        if (size == UINT32_MAX)
+            return SendIllFormedResponse(packet, "Invalid size in MultiBreakpoint packet");
+        if (breakpoints_extractor.GetBytesLeft() > 0 && breakpoints_extractor.GetChar() != ',')
+            return SendIllFormedResponse(packet, "Comma sep missing in MultiBreakpoint packet");
+        breakpoints.push_back(std::make_pair(addr, size));
+    }
+
+    std::vector<Error> errors;
+    if (insert)
+        m_debugged_process_sp->SetBreakpoints(breakpoints, errors);
+    else
+        m_debugged_process_sp->RemoveBreakpoints(breakpoints, errors);
+
+    // One "OK" or "E09" per breakpoint, in the order they were requested.
+    StreamGDBRemote response;
+    for (size_t i = 0; i < breakpoints.size(); ++i)
+    {
+        const bool success = i < errors.size() && errors[i].Success();
+        if (!success && log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " failed to %s breakpoint at 0x%" PRIx64 ": %s",
+                         __FUNCTION__, m_debugged_process_sp->GetID (), insert ? "set" : "remove",
+                         breakpoints[i].first, i < errors.size() ? errors[i].AsCString () : "no result");
+        response.PutCString (i > 0 ? "," : "");
+        response.PutCString (success ? "OK" : "E09");
+    }
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_z (StringExtractorGDBRemote &packet)
 {
@@ -2408,6 +3685,30 @@ GDBRemoteCommunicationServerLLGS::Handle_z (StringExtractorGDBRemote &packet)
     }
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qBreakpointHitCounts (StringExtractorGDBRemote &packet)
+{
+    // Ensure we have a process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    std::vector<std::pair<lldb::addr_t, uint64_t>> hit_counts;
+    m_debugged_process_sp->GetBreakpointHitCounts (hit_counts);
+
+    // "<addr>:<count>;" for each counting breakpoint, in hex.
+    StreamGDBRemote response;
+    for (const auto &hit_count : hit_counts)
+        response.Printf ("%" PRIx64 ":%" PRIx64 ";", hit_count.first, hit_count.second);
+    if (response.GetSize () == 0)
+        return SendOKResponse ();
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
 {
@@ -2438,22 +3739,85 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
     // Create the step action for the given thread.
     ResumeAction action = { tid, eStateStepping, 0 };
 
-    // Setup the actions list.
-    ResumeActionList actions;
-    actions.Append (action);
+    // Setup the actions list.
+    ResumeActionList actions;
+    actions.Append (action);
+
+    // All other threads stop while we're single stepping a thread.
+    actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
+    Error error = m_debugged_process_sp->Resume (actions);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64 " Resume() failed with error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), tid, error.AsCString ());
+        return SendErrorResponse(0x49);
+    }
+
+    // No response here - the stop or exit will come from the resulting action.
+    return PacketResult::Success;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendXferResponse (StringExtractorGDBRemote &packet, const char *packet_prefix, lldb::DataBufferSP &buffer_sp)
+{
+    // Parse out the offset.
+    packet.SetFilePos (strlen(packet_prefix));
+    if (packet.GetBytesLeft () < 1)
+        return SendIllFormedResponse (packet, "qXfer read packet missing offset");
+
+    const uint64_t xfer_offset = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
+    if (xfer_offset == std::numeric_limits<uint64_t>::max ())
+        return SendIllFormedResponse (packet, "qXfer read packet missing offset");
+
+    // Parse out comma.
+    if (packet.GetBytesLeft () < 1 || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "qXfer read packet missing comma after offset");
+
+    // Parse out the length.
+    const uint64_t xfer_length = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
+    if (xfer_length == std::numeric_limits<uint64_t>::max ())
+        return SendIllFormedResponse (packet, "qXfer read packet missing length");
+
+    // FIXME find out if/how I lock the stream here.
+
+    StreamGDBRemote response;
+    bool done_with_buffer = false;
+
+    if (xfer_offset >= buffer_sp->GetByteSize ())
+    {
+        // We have nothing left to send.  Mark the buffer as complete.
+        response.PutChar ('l');
+        done_with_buffer = true;
+    }
+    else
+    {
+        // Figure out how many bytes are available starting at the given offset.
+        const uint64_t bytes_remaining = buffer_sp->GetByteSize () - xfer_offset;
+
+        // Figure out how many bytes we're going to read.
+        const uint64_t bytes_to_read = (xfer_length > bytes_remaining) ? bytes_remaining : xfer_length;
 
-    // All other threads stop while we're single stepping a thread.
-    actions.SetDefaultThreadActionIfNeeded(eStateStopped, 0);
-    Error error = m_debugged_process_sp->Resume (actions);
-    if (error.Fail ())
-    {
-        if (log)
-            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64 " Resume() failed with error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), tid, error.AsCString ());
-        return SendErrorResponse(0x49);
+        // Mark the response type according to whether we're reading the remainder of the data.
+        if (bytes_to_read >= bytes_remaining)
+        {
+            // There will be nothing left to read after this
+            response.PutChar ('l');
+            done_with_buffer = true;
+        }
+        else
+        {
+            // There will still be bytes to read after this request.
+            response.PutChar ('m');
+        }
+
+        // Now write the data in encoded binary form.
+        response.PutEscapedBytes (buffer_sp->GetBytes () + xfer_offset, bytes_to_read);
     }
 
-    // No response here - the stop or exit will come from the resulting action.
-    return PacketResult::Success;
+    if (done_with_buffer)
+        buffer_sp.reset ();
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
 GDBRemoteCommunication::PacketResult
@@ -2463,24 +3827,6 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read (StringExtractorGDBRemo
 #if defined(__linux__)
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    // Parse out the offset.
-    packet.SetFilePos (strlen("qXfer:auxv:read::"));
-    if (packet.GetBytesLeft () < 1)
-        return SendIllFormedResponse (packet, "qXfer:auxv:read:: packet missing offset");
-
-    const uint64_t auxv_offset = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
-    if (auxv_offset == std::numeric_limits<uint64_t>::max ())
-        return SendIllFormedResponse (packet, "qXfer:auxv:read:: packet missing offset");
-
-    // Parse out comma.
-    if (packet.GetBytesLeft () < 1 || packet.GetChar () != ',')
-        return SendIllFormedResponse (packet, "qXfer:auxv:read:: packet missing comma after offset");
-
-    // Parse out the length.
-    const uint64_t auxv_length = packet.GetHexMaxU64 (false, std::numeric_limits<uint64_t>::max ());
-    if (auxv_length == std::numeric_limits<uint64_t>::max ())
-        return SendIllFormedResponse (packet, "qXfer:auxv:read:: packet missing length");
-
     // Grab the auxv data if we need it.
     if (!m_active_auxv_buffer_sp)
     {
@@ -2504,51 +3850,93 @@ GDBRemoteCommunicationServerLLGS::Handle_qXfer_auxv_read (StringExtractorGDBRemo
         }
     }
 
-    // FIXME find out if/how I lock the stream here.
+    return SendXferResponse (packet, "qXfer:auxv:read::", m_active_auxv_buffer_sp);
+#else
+    return SendUnimplementedResponse ("not implemented on this platform");
+#endif
+}
 
-    StreamGDBRemote response;
-    bool done_with_buffer = false;
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qXfer_libraries_svr4_read (StringExtractorGDBRemote &packet)
+{
+#if defined(__linux__)
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    if (auxv_offset >= m_active_auxv_buffer_sp->GetByteSize ())
+    // Make sure we have a valid process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
     {
-        // We have nothing left to send.  Mark the buffer as complete.
-        response.PutChar ('l');
-        done_with_buffer = true;
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x10);
     }
-    else
-    {
-        // Figure out how many bytes are available starting at the given offset.
-        const uint64_t bytes_remaining = m_active_auxv_buffer_sp->GetByteSize () - auxv_offset;
-
-        // Figure out how many bytes we're going to read.
-        const uint64_t bytes_to_read = (auxv_length > bytes_remaining) ? bytes_remaining : auxv_length;
 
-        // Mark the response type according to whether we're reading the remainder of the auxv data.
-        if (bytes_to_read >= bytes_remaining)
+    // The library list changes, so build a new one at the start of every
+    // transfer. The client walks the list once per shared library event
+    // instead of reading every link_map entry itself.
+    packet.SetFilePos (strlen("qXfer:libraries-svr4:read::"));
+    if (!m_active_libraries_svr4_buffer_sp || packet.GetHexMaxU64 (false, 0) == 0)
+    {
+        std::vector<NativeProcessProtocol::SVR4LibraryInfo> library_list;
+        lldb::addr_t main_link_map = LLDB_INVALID_ADDRESS;
+        Error error = m_debugged_process_sp->GetLoadedSVR4Libraries (library_list, main_link_map);
+        if (error.Fail ())
         {
-            // There will be nothing left to read after this
-            response.PutChar ('l');
-            done_with_buffer = true;
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to get the library list: %s", __FUNCTION__, error.AsCString ());
+            m_active_libraries_svr4_buffer_sp.reset ();
+            return SendErrorResponse (0x11);
         }
-        else
+
+        StreamString xml;
+        xml.PutCString ("<library-list-svr4 version=\"1.0\"");
+        if (main_link_map != LLDB_INVALID_ADDRESS)
+            xml.Printf (" main-lm=\"0x%" PRIx64 "\"", main_link_map);
+        xml.PutChar ('>');
+        for (const auto &library : library_list)
         {
-            // There will still be bytes to read after this request.
-            response.PutChar ('m');
+            xml.PutCString ("<library name=\"");
+            for (char ch : library.name)
+            {
+                switch (ch)
+                {
+                    case '&':  xml.PutCString ("&amp;"); break;
+                    case '<':  xml.PutCString ("&lt;"); break;
+                    case '>':  xml.PutCString ("&gt;"); break;
+                    case '"':  xml.PutCString ("&quot;"); break;
+                    case '\'': xml.PutCString ("&apos;"); break;
+                    default:   xml.PutChar (ch); break;
+                }
+            }
+            xml.Printf ("\" lm=\"0x%" PRIx64 "\" l_addr=\"0x%" PRIx64 "\" l_ld=\"0x%" PRIx64 "\"/>",
+                        library.link_map, library.base_addr, library.ld_addr);
         }
+        xml.PutCString ("</library-list-svr4>");
 
-        // Now write the data in encoded binary form.
-        response.PutEscapedBytes (m_active_auxv_buffer_sp->GetBytes () + auxv_offset, bytes_to_read);
+        m_active_libraries_svr4_buffer_sp.reset (new DataBufferHeap (xml.GetData (), xml.GetSize ()));
     }
 
-    if (done_with_buffer)
-        m_active_auxv_buffer_sp.reset ();
-
-    return SendPacketNoLock(response.GetData(), response.GetSize());
+    return SendXferResponse (packet, "qXfer:libraries-svr4:read::", m_active_libraries_svr4_buffer_sp);
 #else
     return SendUnimplementedResponse ("not implemented on this platform");
 #endif
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qShlibInfoAddr (StringExtractorGDBRemote &packet)
+{
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+        return SendErrorResponse (0x10);
+
+    const lldb::addr_t info_addr = m_debugged_process_sp->GetSharedLibraryInfoAddress ();
+    if (info_addr == LLDB_INVALID_ADDRESS)
+        return SendErrorResponse (0x11);
+
+    StreamGDBRemote response;
+    response.Printf ("%" PRIx64, info_addr);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_QSaveRegisterState (StringExtractorGDBRemote &packet)
 {
@@ -2669,6 +4057,66 @@ GDBRemoteCommunicationServerLLGS::Handle_QRestoreRegisterState (StringExtractorG
     return SendOKResponse();
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QSaveCheckpoint (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (0x15);
+
+    uint32_t checkpoint_id = 0;
+    Error error = m_debugged_process_sp->SaveCheckpoint (checkpoint_id);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " failed to save a checkpoint: %s", __FUNCTION__, m_debugged_process_sp->GetID (), error.AsCString ());
+        return SendErrorResponse (0x78);
+    }
+
+    StreamGDBRemote response;
+    response.Printf ("%" PRIu32, checkpoint_id);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QRestoreCheckpoint (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (0x15);
+
+    packet.SetFilePos (strlen ("QRestoreCheckpoint:"));
+    const uint32_t checkpoint_id = packet.GetU32 (0);
+    if (checkpoint_id == 0)
+        return SendIllFormedResponse (packet, "QRestoreCheckpoint packet has a malformed checkpoint id");
+
+    const lldb::pid_t old_pid = m_debugged_process_sp->GetID ();
+    Error error = m_debugged_process_sp->RestoreCheckpoint (checkpoint_id);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " failed to restore checkpoint %" PRIu32 ": %s", __FUNCTION__, old_pid, checkpoint_id, error.AsCString ());
+        return SendErrorResponse (0x79);
+    }
+
+    // The process can have a new pid and new threads now.
+    auto pos = m_debugged_processes.find (old_pid);
+    if (pos != m_debugged_processes.end ())
+    {
+        m_debugged_processes.erase (pos);
+        m_debugged_processes[m_debugged_process_sp->GetID ()] = m_debugged_process_sp;
+    }
+    SetContinueThreadID (LLDB_INVALID_THREAD_ID);
+
+    return SendStopReasonForState (m_debugged_process_sp->GetState ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_vAttach (StringExtractorGDBRemote &packet)
 {
@@ -2731,21 +4179,32 @@ GDBRemoteCommunicationServerLLGS::Handle_D (StringExtractorGDBRemote &packet)
             return SendIllFormedResponse (packet, "D failed to parse the process id");
     }
 
-    if (pid != LLDB_INVALID_PROCESS_ID &&
-        m_debugged_process_sp->GetID () != pid)
+    NativeProcessProtocolSP process_sp = m_debugged_process_sp;
+    if (pid != LLDB_INVALID_PROCESS_ID)
     {
-        return SendIllFormedResponse (packet, "Invalid pid");
+        auto pos = m_debugged_processes.find (pid);
+        if (pos == m_debugged_processes.end ())
+            return SendIllFormedResponse (packet, "Invalid pid");
+        process_sp = pos->second;
     }
 
-    const Error error = m_debugged_process_sp->Detach ();
+    const Error error = process_sp->Detach ();
     if (error.Fail ())
     {
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to detach from pid %" PRIu64 ": %s\n",
-                         __FUNCTION__, m_debugged_process_sp->GetID (), error.AsCString ());
+                         __FUNCTION__, process_sp->GetID (), error.AsCString ());
         return SendErrorResponse (0x01);
     }
 
+    // With several processes the others stay attached.
+    if (m_debugged_processes.size () > 1)
+    {
+        m_debugged_processes.erase (process_sp->GetID ());
+        if (process_sp == m_debugged_process_sp)
+            SetCurrentProcess (m_debugged_processes.begin ()->second);
+    }
+
     return SendOKResponse ();
 }
 
@@ -2797,6 +4256,193 @@ GDBRemoteCommunicationServerLLGS::Handle_jThreadsInfo (StringExtractorGDBRemote
     return SendPacketNoLock (escaped_response.GetData(), escaped_response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jSample (StringExtractorGDBRemote &packet)
+{
+#if defined(__linux__)
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (0x90);
+
+    // The samples are taken from all-stop stops.
+    if (m_non_stop_mode)
+        return SendErrorResponse (0x93);
+
+    // jSample:<duration in ms>,<frequency in Hz>
+    packet.SetFilePos (strlen("jSample:"));
+    const uint64_t duration_ms = packet.GetHexMaxU64 (false, 0);
+    if (duration_ms == 0 || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "Invalid duration in jSample packet");
+    const uint64_t frequency = packet.GetHexMaxU64 (false, 0);
+    if (frequency == 0 || frequency > 10000)
+        return SendIllFormedResponse (packet, "Invalid frequency in jSample packet");
+
+    if (!m_sample_timer_sp)
+    {
+        const int fd = ::timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (fd == -1)
+            return SendErrorResponse (0x93);
+
+        Error error;
+        m_sample_timer_sp.reset (new File (fd, true));
+        m_sample_timer_handle_up = m_mainloop.RegisterReadObject (m_sample_timer_sp,
+                [this] (MainLoopBase &) { HandleSampleTimer (); }, error);
+        if (!m_sample_timer_handle_up)
+        {
+            m_sample_timer_sp.reset ();
+            return SendErrorResponse (0x93);
+        }
+    }
+
+    m_samples.clear ();
+    m_sample_period_ns = 1000000000 / frequency;
+    m_sample_end_time = std::chrono::steady_clock::now () + std::chrono::milliseconds (duration_ms);
+    m_sampling = true;
+
+    // Run like 'c', the stop reply is sent once the sampling is done.
+    ResumeActionList actions (StateType::eStateRunning, 0);
+    Error error = m_debugged_process_sp->Resume (actions);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to resume process %" PRIu64 ": %s",
+                    __FUNCTION__, m_debugged_process_sp->GetID (), error.AsCString ());
+        StopSampling ();
+        return SendErrorResponse (GDBRemoteServerError::eErrorResume);
+    }
+    ArmSampleTimer (m_sample_period_ns);
+
+    // No response required, like continue.
+    return PacketResult::Success;
+#else
+    return SendUnimplementedResponse ("not implemented on this platform");
+#endif
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jSampleRead (StringExtractorGDBRemote &packet)
+{
+    // jSampleRead:<first sample>,<sample count>
+    packet.SetFilePos (strlen("jSampleRead:"));
+    const uint64_t first = packet.GetHexMaxU64 (false, UINT64_MAX);
+    if (first == UINT64_MAX || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "Invalid first sample in jSampleRead packet");
+    const uint64_t count = packet.GetHexMaxU64 (false, 0);
+    if (count == 0)
+        return SendIllFormedResponse (packet, "Invalid sample count in jSampleRead packet");
+
+    // Like jTraceRead, 'm' says there are more samples after these and 'l'
+    // that these are the last ones. A sample can be about 64 addresses.
+    const uint64_t max_count = 64;
+    const uint64_t end = std::min<uint64_t> (m_samples.size (), first + std::min (count, max_count));
+
+    StreamString response;
+    response.PutChar (end < m_samples.size () ? 'm' : 'l');
+    for (uint64_t i = first; i < end; ++i)
+    {
+        const ThreadSample &sample = m_samples[i];
+        response.Printf ("%" PRIx64 ":", sample.tid);
+        for (size_t j = 0; j < sample.pcs.size (); ++j)
+            response.Printf ("%s%" PRIx64, j > 0 ? "," : "", sample.pcs[j]);
+        response.PutChar (';');
+    }
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jTraceStart (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (0x90);
+
+    // jTraceStart:<tid>[,<buffer size>]
+    packet.SetFilePos (strlen("jTraceStart:"));
+    const lldb::tid_t tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+    if (tid == LLDB_INVALID_THREAD_ID)
+        return SendIllFormedResponse (packet, "Invalid thread id in jTraceStart packet");
+
+    uint64_t buffer_size = 1024 * 1024;
+    if (packet.GetBytesLeft () > 0)
+    {
+        if (packet.GetChar () != ',')
+            return SendIllFormedResponse (packet, "Comma sep missing in jTraceStart packet");
+        buffer_size = packet.GetHexMaxU64 (false, 0);
+        if (buffer_size == 0)
+            return SendIllFormedResponse (packet, "Invalid buffer size in jTraceStart packet");
+    }
+
+    Error error = m_debugged_process_sp->StartBranchTrace (tid, buffer_size);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " tid %" PRIu64 ": %s",
+                    __FUNCTION__, m_debugged_process_sp->GetID (), tid, error.AsCString ());
+        return SendErrorResponse (0x91);
+    }
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jTraceStop (StringExtractorGDBRemote &packet)
+{
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (0x90);
+
+    packet.SetFilePos (strlen("jTraceStop:"));
+    const lldb::tid_t tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+    if (tid == LLDB_INVALID_THREAD_ID)
+        return SendIllFormedResponse (packet, "Invalid thread id in jTraceStop packet");
+
+    if (m_debugged_process_sp->StopBranchTrace (tid).Fail ())
+        return SendErrorResponse (0x92);
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_jTraceRead (StringExtractorGDBRemote &packet)
+{
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (0x90);
+
+    // jTraceRead:<tid>,<first branch>,<branch count>
+    packet.SetFilePos (strlen("jTraceRead:"));
+    const lldb::tid_t tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+    if (tid == LLDB_INVALID_THREAD_ID || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "Invalid thread id in jTraceRead packet");
+    const uint64_t first = packet.GetHexMaxU64 (false, UINT64_MAX);
+    if (first == UINT64_MAX || packet.GetChar () != ',')
+        return SendIllFormedResponse (packet, "Invalid first branch in jTraceRead packet");
+    const uint64_t count = packet.GetHexMaxU64 (false, 0);
+    if (count == 0)
+        return SendIllFormedResponse (packet, "Invalid branch count in jTraceRead packet");
+
+    std::vector<std::pair<lldb::addr_t, lldb::addr_t>> branches;
+    if (m_debugged_process_sp->GetBranchTrace (tid, branches).Fail ())
+        return SendErrorResponse (0x92);
+
+    // Like qXfer, 'm' says there are more branches after these and 'l' that
+    // these are the last ones. Keep each reply well below the packet size.
+    const uint64_t max_count = 2048;
+    const uint64_t end = std::min<uint64_t> (branches.size (), first + std::min (count, max_count));
+
+    StreamString response;
+    response.PutChar (end < branches.size () ? 'm' : 'l');
+    for (uint64_t i = first; i < end; ++i)
+        response.Printf ("%s%" PRIx64 ",%" PRIx64, i > first ? ";" : "", branches[i].first, branches[i].second);
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo (StringExtractorGDBRemote &packet)
 {
@@ -2920,13 +4566,85 @@ GDBRemoteCommunicationServerLLGS::GetThreadFromSuffix (StringExtractorGDBRemote
         return thread_sp;
     }
     packet.SetFilePos (packet.GetFilePos () + strlen("thread:"));
-    const lldb::tid_t tid = packet.GetHexMaxU64(false, 0);
-    if (tid != 0)
-        return m_debugged_process_sp->GetThreadByID (tid);
+    lldb::tid_t tid;
+    NativeProcessProtocolSP process_sp = ReadThreadID (packet, 0, tid);
+    if (process_sp && tid != 0)
+        return process_sp->GetThreadByID (tid);
 
     return thread_sp;
 }
 
+void
+GDBRemoteCommunicationServerLLGS::HandleClientFeatures (const std::string &client_features, Stream &response)
+{
+    const std::string features = ";" + client_features + ";";
+    m_multiprocess = features.find (";multiprocess+;") != std::string::npos;
+
+    response.PutCString (";multiprocess+");
+}
+
+void
+GDBRemoteCommunicationServerLLGS::SetCurrentProcess (const NativeProcessProtocolSP &process_sp)
+{
+    if (process_sp == m_debugged_process_sp)
+        return;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationServerLLGS::%s switching to pid %" PRIu64, __FUNCTION__, process_sp->GetID ());
+
+    // The thread selections were for threads of the previous process.
+    m_debugged_process_sp = process_sp;
+    m_current_tid = LLDB_INVALID_THREAD_ID;
+    m_continue_tid = LLDB_INVALID_THREAD_ID;
+}
+
+NativeProcessProtocolSP
+GDBRemoteCommunicationServerLLGS::ReadThreadID (StringExtractorGDBRemote &packet, lldb::tid_t fail_value, lldb::tid_t &tid)
+{
+    NativeProcessProtocolSP process_sp = m_debugged_process_sp;
+    if (m_multiprocess && packet.GetBytesLeft () && *packet.Peek () == 'p')
+    {
+        packet.GetChar ();
+        if (packet.GetBytesLeft () >= 2 && ::strncmp (packet.Peek (), "-1", 2) == 0)
+        {
+            // All processes, which we leave to the current one.
+            packet.SetFilePos (packet.GetFilePos () + 2);
+        }
+        else
+        {
+            const lldb::pid_t pid = packet.GetHexMaxU64 (false, LLDB_INVALID_PROCESS_ID);
+            auto pos = m_debugged_processes.find (pid);
+            if (pos == m_debugged_processes.end ())
+            {
+                tid = fail_value;
+                return NativeProcessProtocolSP ();
+            }
+            process_sp = pos->second;
+        }
+
+        // "p<pid>" alone means any thread of the process.
+        if (!packet.GetBytesLeft () || *packet.Peek () != '.')
+        {
+            tid = 0;
+            return process_sp;
+        }
+        packet.GetChar ();
+    }
+
+    tid = packet.GetHexMaxU64 (false, fail_value);
+    return process_sp;
+}
+
+void
+GDBRemoteCommunicationServerLLGS::AppendThreadID (Stream &response, const NativeProcessProtocol &process, lldb::tid_t tid) const
+{
+    if (m_multiprocess)
+        response.Printf ("p%" PRIx64 ".%" PRIx64, process.GetID (), tid);
+    else
+        response.Printf ("%" PRIx64, tid);
+}
+
 lldb::tid_t
 GDBRemoteCommunicationServerLLGS::GetCurrentThreadID () const
 {
@@ -2965,6 +4683,7 @@ GDBRemoteCommunicationServerLLGS::ClearProcessSpecificData ()
                      __FUNCTION__,
                      m_active_auxv_buffer_sp ? "was set" : "was not set");
     m_active_auxv_buffer_sp.reset ();
+    m_active_libraries_svr4_buffer_sp.reset ();
 #endif
 }
 
@@ -12,12 +12,17 @@
 
 // C Includes
 // C++ Includes
+#include <chrono>
+#include <deque>
+#include <map>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 // Other libraries and framework includes
 #include "lldb/lldb-private-forward.h"
 #include "lldb/Core/Communication.h"
+#include "lldb/Core/ConnectionSharedMemory.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "lldb/Host/MainLoop.h"
 
@@ -110,6 +115,9 @@ public:
     void
     DidExec (NativeProcessProtocol *process) override;
 
+    void
+    ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) override;
+
     Error
     InitializeConnection (std::unique_ptr<Connection> &&connection);
 
@@ -120,17 +128,40 @@ protected:
     lldb::tid_t m_current_tid;
     lldb::tid_t m_continue_tid;
     std::recursive_mutex m_debugged_process_mutex;
-    NativeProcessProtocolSP m_debugged_process_sp;
+    NativeProcessProtocolSP m_debugged_process_sp; // The current process
+    std::map<lldb::pid_t, NativeProcessProtocolSP> m_debugged_processes; // All processes, with multiprocess+ there can be several
 
     Communication m_stdio_communication;
     MainLoop::ReadHandleUP m_stdio_handle_up;
 
     lldb::StateType m_inferior_prev_state;
     lldb::DataBufferSP m_active_auxv_buffer_sp;
+    lldb::DataBufferSP m_active_libraries_svr4_buffer_sp;
     std::mutex m_saved_registers_mutex;
     std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
     uint32_t m_next_saved_registers_id;
+    std::vector<uint32_t> m_expedited_registers; // Registers to send in stop replies, empty for the first register set
+    std::deque<lldb::tid_t> m_pending_stop_notifications; // Non-stop mode stops not yet acknowledged with vStopped
+    std::unique_ptr<ConnectionSharedMemory> m_shared_memory_up; // Set up by a local client with QSetSharedMemory
+    size_t m_shared_memory_offset; // Where the next qReadMemoryShared result goes
+
+    // A jSample sample of one thread: its pc followed by the return
+    // addresses found by walking the frame pointer chain.
+    struct ThreadSample
+    {
+        lldb::tid_t tid;
+        std::vector<lldb::addr_t> pcs;
+    };
+    std::vector<ThreadSample> m_samples; // Read by the client with jSampleRead
+    std::chrono::steady_clock::time_point m_sample_end_time;
+    uint64_t m_sample_period_ns;
+    lldb::IOObjectSP m_sample_timer_sp;
+    MainLoop::ReadHandleUP m_sample_timer_handle_up;
+
     bool m_handshake_completed : 1;
+    bool m_non_stop_mode : 1;
+    bool m_multiprocess : 1; // The client uses p<pid>.<tid> thread ids
+    bool m_sampling : 1; // A jSample run is in progress
 
     PacketResult
     SendONotification (const char *buffer, uint32_t len);
@@ -141,6 +172,17 @@ protected:
     PacketResult
     SendStopReplyPacketForThread (lldb::tid_t tid);
 
+    PacketResult
+    SendStopNotificationForThread (lldb::tid_t tid);
+
+    // Appends the stop reply for \a tid to \a response. Returns 0 on
+    // success, or the error code to send back otherwise.
+    uint8_t
+    PrepareStopReplyPacketForThread (lldb::tid_t tid, StreamString &response);
+
+    void
+    QueueStopNotification (lldb::tid_t tid);
+
     PacketResult
     SendStopReasonForState (lldb::StateType process_state);
 
@@ -174,6 +216,15 @@ protected:
     PacketResult
     Handle_vCont_actions (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_vStopped (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QNonStop (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QPassSignals (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_stop_reason (StringExtractorGDBRemote &packet);
 
@@ -192,6 +243,15 @@ protected:
     PacketResult
     Handle_P (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_g (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_G (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QSetExpeditedRegisters (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_H (StringExtractorGDBRemote &packet);
 
@@ -208,6 +268,27 @@ protected:
     PacketResult
     Handle_M (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_MultiMemRead (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_MultiMemHash (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QSetSharedMemory (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qReadMemoryShared (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qSearch_memory (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qFindReferences (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_MultiBreakpoint (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qMemoryRegionInfoSupported (StringExtractorGDBRemote &packet);
 
@@ -220,18 +301,43 @@ protected:
     PacketResult
     Handle_z (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qBreakpointHitCounts (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_s (StringExtractorGDBRemote &packet);
 
     PacketResult
     Handle_qXfer_auxv_read (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qXfer_libraries_svr4_read (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qShlibInfoAddr (StringExtractorGDBRemote &packet);
+
+    //------------------------------------------------------------------
+    /// Send the part of a qXfer object that a "qXfer:<object>:read::
+    /// <offset>,<length>" packet asks for.
+    ///
+    /// The buffer is reset once its last byte was sent, so the next
+    /// transfer starts with a fresh copy of the object.
+    //------------------------------------------------------------------
+    PacketResult
+    SendXferResponse (StringExtractorGDBRemote &packet, const char *packet_prefix, lldb::DataBufferSP &buffer_sp);
+
     PacketResult
     Handle_QSaveRegisterState (StringExtractorGDBRemote &packet);
 
     PacketResult
     Handle_QRestoreRegisterState (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QSaveCheckpoint (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QRestoreCheckpoint (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_vAttach (StringExtractorGDBRemote &packet);
 
@@ -244,6 +350,21 @@ protected:
     PacketResult
     Handle_jThreadsInfo (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_jSample (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_jSampleRead (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_jTraceStart (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_jTraceStop (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_jTraceRead (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qWatchpointSupportInfo (StringExtractorGDBRemote &packet);
 
@@ -268,6 +389,23 @@ protected:
     FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch) override;
 
+    void
+    HandleClientFeatures (const std::string &client_features, Stream &response) override;
+
+    // Makes \a process_sp the process that packets without a process id
+    // refer to.
+    void
+    SetCurrentProcess (const NativeProcessProtocolSP &process_sp);
+
+    // Reads a thread id, "p<pid>.<tid>" if the client uses the multiprocess
+    // extensions. Returns the process the thread belongs to, the current
+    // process if no pid was given, or an empty pointer for an unknown pid.
+    NativeProcessProtocolSP
+    ReadThreadID (StringExtractorGDBRemote &packet, lldb::tid_t fail_value, lldb::tid_t &tid);
+
+    void
+    AppendThreadID (Stream &response, const NativeProcessProtocol &process, lldb::tid_t tid) const;
+
 private:
     void
     HandleInferiorState_Exited (NativeProcessProtocol *process);
@@ -275,6 +413,24 @@ private:
     void
     HandleInferiorState_Stopped (NativeProcessProtocol *process);
 
+    // Arms the jSample timer to fire once after \a delay_ns nanoseconds,
+    // zero disarms it.
+    bool
+    ArmSampleTimer (uint64_t delay_ns);
+
+    // Interrupts the running process, or resumes it after a sample.
+    void
+    HandleSampleTimer ();
+
+    // Records a sample of every thread of the stopped \a process. Returns
+    // true if the stop only happened for the sample and the process will
+    // be resumed, false if the stop must be reported.
+    bool
+    TakeSample (NativeProcessProtocol *process);
+
+    void
+    StopSampling ();
+
     NativeThreadProtocolSP
     GetThreadFromSuffix (StringExtractorGDBRemote &packet);
 
@@ -13,6 +13,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <cstring>
 #include <chrono>
 #include <mutex>
@@ -55,7 +56,11 @@ GDBRemoteCommunicationServerPlatform::GDBRemoteCommunicationServerPlatform(const
       m_spawned_pids_mutex(),
       m_platform_sp(Platform::GetHostPlatform()),
       m_port_map(),
-      m_port_offset(0)
+      m_port_offset(0),
+      m_gdb_server_pool_size(0),
+      m_gdb_server_pool(),
+      m_gdb_server_pool_thread(),
+      m_gdb_server_pool_filling(false)
 {
     m_pending_gdb_server.pid = LLDB_INVALID_PROCESS_ID;
     m_pending_gdb_server.port = 0;
@@ -90,6 +95,18 @@ GDBRemoteCommunicationServerPlatform::GDBRemoteCommunicationServerPlatform(const
 //----------------------------------------------------------------------
 GDBRemoteCommunicationServerPlatform::~GDBRemoteCommunicationServerPlatform()
 {
+    {
+        std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+        m_gdb_server_pool_size = 0;
+    }
+    if (m_gdb_server_pool_thread.joinable())
+        m_gdb_server_pool_thread.join();
+
+    // Nobody connected to the gdbservers left in the pool.
+    std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+    for (const PooledGDBServer &server : m_gdb_server_pool)
+        Host::Kill (server.pid, SIGTERM);
+    m_gdb_server_pool.clear();
 }
 
 Error
@@ -100,7 +117,11 @@ GDBRemoteCommunicationServerPlatform::LaunchGDBServer(const lldb_private::Args&
                                                       std::string& socket_name)
 {
     if (port == UINT16_MAX)
+    {
+        // The pool fills up on another thread.
+        std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
         port = GetNextAvailablePort();
+    }
     
     // Spawn a new thread to accept the port that gets bound after
     // binding to port 0 (zero).
@@ -194,7 +215,14 @@ GDBRemoteCommunicationServerPlatform::Handle_qLaunchGDBServer (StringExtractorGD
 
     lldb::pid_t debugserver_pid = LLDB_INVALID_PROCESS_ID;
     std::string socket_name;
-    Error error = LaunchGDBServer(Args(), hostname, debugserver_pid, port, socket_name);
+    Error error;
+    if ((port == 0 || port == UINT16_MAX) && TakePooledGDBServer(debugserver_pid, port, socket_name))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerPlatform::%s() using pooled debugserver pid %" PRIu64, __FUNCTION__, debugserver_pid);
+    }
+    else
+        error = LaunchGDBServer(Args(), hostname, debugserver_pid, port, socket_name);
     if (error.Fail())
     {
         if (log)
@@ -220,6 +248,9 @@ GDBRemoteCommunicationServerPlatform::Handle_qLaunchGDBServer (StringExtractorGD
         if (debugserver_pid != LLDB_INVALID_PROCESS_ID)
             ::kill (debugserver_pid, SIGINT);
     }
+
+    // Replace the gdbserver while the client connects to this one.
+    FillGDBServerPool();
     return packet_result;
 #endif
 }
@@ -443,6 +474,79 @@ GDBRemoteCommunicationServerPlatform::DebugserverProcessReaped (lldb::pid_t pid)
     std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
     FreePortForProcess(pid);
     m_spawned_pids.erase(pid);
+    m_gdb_server_pool.erase(std::remove_if(m_gdb_server_pool.begin(), m_gdb_server_pool.end(),
+                                           [pid](const PooledGDBServer &server) { return server.pid == pid; }),
+                            m_gdb_server_pool.end());
+    return true;
+}
+
+void
+GDBRemoteCommunicationServerPlatform::SetGDBServerPoolSize (uint32_t pool_size)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+    m_gdb_server_pool_size = pool_size;
+}
+
+void
+GDBRemoteCommunicationServerPlatform::FillGDBServerPool ()
+{
+#ifndef _WIN32
+    {
+        std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+        if (m_gdb_server_pool.size() >= m_gdb_server_pool_size)
+            return;
+    }
+
+    // One thread at a time fills the pool, the previous one is done once
+    // it cleared the flag.
+    if (m_gdb_server_pool_filling.exchange(true))
+        return;
+    if (m_gdb_server_pool_thread.joinable())
+        m_gdb_server_pool_thread.join();
+
+    m_gdb_server_pool_thread = std::thread([this]() {
+        Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PLATFORM));
+        while (true)
+        {
+            {
+                std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+                if (m_gdb_server_pool.size() >= m_gdb_server_pool_size)
+                    break;
+            }
+
+            PooledGDBServer server;
+            server.pid = LLDB_INVALID_PROCESS_ID;
+            server.port = UINT16_MAX;
+            Error error = LaunchGDBServer(Args(), "", server.pid, server.port, server.socket_name);
+            if (error.Fail() || server.pid == LLDB_INVALID_PROCESS_ID)
+            {
+                if (log)
+                    log->Printf("GDBRemoteCommunicationServerPlatform::%s() debugserver launch failed: %s",
+                                __FUNCTION__, error.AsCString("no process"));
+                break;
+            }
+
+            std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+            if (m_spawned_pids.find(server.pid) != m_spawned_pids.end())
+                m_gdb_server_pool.push_back(server);
+        }
+        m_gdb_server_pool_filling = false;
+    });
+#endif
+}
+
+bool
+GDBRemoteCommunicationServerPlatform::TakePooledGDBServer (lldb::pid_t &pid, uint16_t &port, std::string &socket_name)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_spawned_pids_mutex);
+    if (m_gdb_server_pool.empty())
+        return false;
+
+    const PooledGDBServer &server = m_gdb_server_pool.front();
+    pid = server.pid;
+    port = server.port;
+    socket_name = server.socket_name;
+    m_gdb_server_pool.erase(m_gdb_server_pool.begin());
     return true;
 }
 
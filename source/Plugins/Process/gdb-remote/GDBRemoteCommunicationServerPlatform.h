@@ -12,9 +12,13 @@
 
 // C Includes
 // C++ Includes
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <set>
+#include <string>
+#include <thread>
+#include <vector>
 
 // Other libraries and framework includes
 // Project includes
@@ -80,6 +84,19 @@ public:
     void
     SetPendingGdbServer(lldb::pid_t pid, uint16_t port, const std::string& socket_name);
 
+    //----------------------------------------------------------------------
+    // Keep this many gdbservers started and listening, so that a
+    // qLaunchGDBServer that doesn't ask for a specific port can hand one
+    // out without waiting for it to start. Zero, the default, disables the
+    // pool.
+    //----------------------------------------------------------------------
+    void
+    SetGDBServerPoolSize (uint32_t pool_size);
+
+    // Start gdbservers in the background until the pool is full again.
+    void
+    FillGDBServerPool ();
+
 protected:
     const Socket::SocketProtocol m_socket_protocol;
     const std::string m_socket_scheme;
@@ -91,6 +108,17 @@ protected:
     uint16_t m_port_offset;
     struct { lldb::pid_t pid; uint16_t port; std::string socket_name; } m_pending_gdb_server;
 
+    struct PooledGDBServer
+    {
+        lldb::pid_t pid;
+        uint16_t port;
+        std::string socket_name;
+    };
+    uint32_t m_gdb_server_pool_size;
+    std::vector<PooledGDBServer> m_gdb_server_pool; // Guarded by m_spawned_pids_mutex
+    std::thread m_gdb_server_pool_thread;
+    std::atomic<bool> m_gdb_server_pool_filling;
+
     PacketResult
     Handle_qLaunchGDBServer (StringExtractorGDBRemote &packet);
 
@@ -122,6 +150,9 @@ private:
     bool
     DebugserverProcessReaped (lldb::pid_t pid);
 
+    bool
+    TakePooledGDBServer (lldb::pid_t &pid, uint16_t &port, std::string &socket_name);
+
     static const FileSpec&
     GetDomainSocketDir();
 
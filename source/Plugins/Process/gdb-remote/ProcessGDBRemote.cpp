@@ -25,11 +25,14 @@
 #include <map>
 #include <mutex>
 
+#include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -39,6 +42,7 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
 #include "lldb/Core/Value.h"
+#include "lldb/Core/dwarf.h"
 #include "lldb/DataFormatters/FormatManager.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/HostThread.h"
@@ -56,14 +60,24 @@
 #include "lldb/Interpreter/OptionGroupBoolean.h"
 #include "lldb/Interpreter/OptionGroupUInt64.h"
 #include "lldb/Interpreter/Property.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/DynamicLoader.h"
+#include "lldb/Target/Platform.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/TargetList.h"
 #include "lldb/Target/ThreadPlanCallFunction.h"
+#include "lldb/Target/ThreadSpec.h"
 #include "lldb/Target/SystemRuntime.h"
+#include "lldb/Utility/HexEncoding.h"
 #include "lldb/Utility/PseudoTerminal.h"
+#include "llvm/Support/FileSystem.h"
 
 // Project includes
 #include "lldb/Host/Host.h"
@@ -71,6 +85,7 @@
 #include "Plugins/Process/Utility/InferiorCallPOSIX.h"
 #include "Plugins/Process/Utility/StopInfoMachException.h"
 #include "Plugins/Platform/MacOSX/PlatformRemoteiOS.h"
+#include "Utility/ModuleCache.h"
 #include "Utility/StringExtractorGDBRemote.h"
 #include "GDBRemoteRegisterContext.h"
 #include "ProcessGDBRemote.h"
@@ -107,13 +122,23 @@ namespace {
     {
         { "packet-timeout" , OptionValue::eTypeUInt64 , true , 1, NULL, NULL, "Specify the default packet timeout in seconds." },
         { "target-definition-file" , OptionValue::eTypeFileSpec , true, 0 , NULL, NULL, "The file that provides the description for remote target registers." },
+        { "use-register-info-cache" , OptionValue::eTypeBoolean , true, false , NULL, NULL, "If true, the register descriptions a stub sends with qRegisterInfo packets are cached in the platform module cache directory and reused when connecting to the same kind of stub again." },
+        { "use-binary-framing" , OptionValue::eTypeBoolean , true, true , NULL, NULL, "If true, switch to length prefixed binary packets without escaping and checksums when the stub supports them and the connection doesn't need acks." },
+        { "use-shared-memory" , OptionValue::eTypeBoolean , true, true , NULL, NULL, "If true, memory reads from an lldb-server on the same host are passed through shared memory instead of the connection." },
+        { "use-range-stepping" , OptionValue::eTypeBoolean , true, true , NULL, NULL, "If true, source line steps ask stubs that support it to single step through the line's address range on their own and only stop when the pc leaves it." },
+        { "packet-record-file" , OptionValue::eTypeFileSpec , true, 0 , NULL, NULL, "If set, the packets of the connections to remote gdb servers are written to this file with their timing. \"lldb-server replay\" can serve the recording to benchmark the client against a simulated link." },
         {  NULL            , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
     };
 
     enum
     {
         ePropertyPacketTimeout,
-        ePropertyTargetDefinitionFile
+        ePropertyTargetDefinitionFile,
+        ePropertyUseRegisterInfoCache,
+        ePropertyUseBinaryFraming,
+        ePropertyUseSharedMemory,
+        ePropertyUseRangeStepping,
+        ePropertyPacketRecordFile
     };
 
     class PluginProperties : public Properties
@@ -158,6 +183,41 @@ namespace {
             const uint32_t idx = ePropertyTargetDefinitionFile;
             return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
         }
+
+        bool
+        GetUseRegisterInfoCache () const
+        {
+            const uint32_t idx = ePropertyUseRegisterInfoCache;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+        }
+
+        bool
+        GetUseBinaryFraming () const
+        {
+            const uint32_t idx = ePropertyUseBinaryFraming;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+        }
+
+        bool
+        GetUseSharedMemory () const
+        {
+            const uint32_t idx = ePropertyUseSharedMemory;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+        }
+
+        bool
+        GetUseRangeStepping () const
+        {
+            const uint32_t idx = ePropertyUseRangeStepping;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean (NULL, idx, g_properties[idx].default_uint_value != 0);
+        }
+
+        FileSpec
+        GetPacketRecordFile () const
+        {
+            const uint32_t idx = ePropertyPacketRecordFile;
+            return m_collection_sp->GetPropertyAtIndexAsFileSpec (NULL, idx);
+        }
     };
 
     typedef std::shared_ptr<PluginProperties> ProcessKDPPropertiesSP;
@@ -279,21 +339,28 @@ ProcessGDBRemote::ProcessGDBRemote(lldb::TargetSP target_sp, ListenerSP listener
       m_async_thread_state_mutex(),
       m_thread_ids(),
       m_thread_pcs(),
-      m_jstopinfo_sp(),
-      m_jthreadsinfo_sp(),
+      m_jstopinfo(),
+      m_jstopinfo_map(),
+      m_jthreadsinfo(),
+      m_jthreadsinfo_map(),
       m_continue_c_tids(),
       m_continue_C_tids(),
       m_continue_s_tids(),
       m_continue_S_tids(),
+      m_continue_step_ranges(),
+      m_next_resume_sample_duration_ms(0),
+      m_next_resume_sample_frequency(0),
       m_max_memory_size(0),
       m_remote_stub_max_memory_size(0),
       m_addr_to_mmap_size(),
+      m_counted_hits(),
       m_thread_create_bp_sp(),
       m_waiting_for_attach(false),
       m_destroy_tried_resuming(false),
       m_command_sp(),
       m_breakpoint_pc_offset(0),
-      m_initial_tid(LLDB_INVALID_THREAD_ID)
+      m_initial_tid(LLDB_INVALID_THREAD_ID),
+      m_last_signals_version(UINT64_MAX)
 {
     m_async_broadcaster.SetEventName(eBroadcastBitAsyncThreadShouldExit, "async thread should exit");
     m_async_broadcaster.SetEventName(eBroadcastBitAsyncContinue, "async thread continue");
@@ -458,6 +525,252 @@ SplitCommaSeparatedRegisterNumberString(const llvm::StringRef &comma_separated_r
 }
 
 
+void
+ProcessGDBRemote::AddRegisterFromRegisterInfoResponse (StringExtractorGDBRemote &response,
+                                                       uint32_t reg_num,
+                                                       uint32_t &reg_offset,
+                                                       const ArchSpec &arch_to_use)
+{
+    std::string name;
+    std::string value;
+    ConstString reg_name;
+    ConstString alt_name;
+    ConstString set_name;
+    std::vector<uint32_t> value_regs;
+    std::vector<uint32_t> invalidate_regs;
+    RegisterInfo reg_info = { NULL,                 // Name
+        NULL,                 // Alt name
+        0,                    // byte size
+        reg_offset,           // offset
+        eEncodingUint,        // encoding
+        eFormatHex,           // format
+        {
+            LLDB_INVALID_REGNUM, // eh_frame reg num
+            LLDB_INVALID_REGNUM, // DWARF reg num
+            LLDB_INVALID_REGNUM, // generic reg num
+            reg_num,             // process plugin reg num
+            reg_num           // native register number
+        },
+        NULL,
+        NULL
+    };
+
+    while (response.GetNameColonValue(name, value))
+    {
+        if (name.compare("name") == 0)
+        {
+            reg_name.SetCString(value.c_str());
+        }
+        else if (name.compare("alt-name") == 0)
+        {
+            alt_name.SetCString(value.c_str());
+        }
+        else if (name.compare("bitsize") == 0)
+        {
+            reg_info.byte_size = StringConvert::ToUInt32(value.c_str(), 0, 0) / CHAR_BIT;
+        }
+        else if (name.compare("offset") == 0)
+        {
+            uint32_t offset = StringConvert::ToUInt32(value.c_str(), UINT32_MAX, 0);
+            if (reg_offset != offset)
+            {
+                reg_offset = offset;
+            }
+        }
+        else if (name.compare("encoding") == 0)
+        {
+            const Encoding encoding = Args::StringToEncoding (value.c_str());
+            if (encoding != eEncodingInvalid)
+                reg_info.encoding = encoding;
+        }
+        else if (name.compare("format") == 0)
+        {
+            Format format = eFormatInvalid;
+            if (Args::StringToFormat (value.c_str(), format, NULL).Success())
+                reg_info.format = format;
+            else if (value.compare("binary") == 0)
+                reg_info.format = eFormatBinary;
+            else if (value.compare("decimal") == 0)
+                reg_info.format = eFormatDecimal;
+            else if (value.compare("hex") == 0)
+                reg_info.format = eFormatHex;
+            else if (value.compare("float") == 0)
+                reg_info.format = eFormatFloat;
+            else if (value.compare("vector-sint8") == 0)
+                reg_info.format = eFormatVectorOfSInt8;
+            else if (value.compare("vector-uint8") == 0)
+                reg_info.format = eFormatVectorOfUInt8;
+            else if (value.compare("vector-sint16") == 0)
+                reg_info.format = eFormatVectorOfSInt16;
+            else if (value.compare("vector-uint16") == 0)
+                reg_info.format = eFormatVectorOfUInt16;
+            else if (value.compare("vector-sint32") == 0)
+                reg_info.format = eFormatVectorOfSInt32;
+            else if (value.compare("vector-uint32") == 0)
+                reg_info.format = eFormatVectorOfUInt32;
+            else if (value.compare("vector-float32") == 0)
+                reg_info.format = eFormatVectorOfFloat32;
+            else if (value.compare("vector-uint128") == 0)
+                reg_info.format = eFormatVectorOfUInt128;
+        }
+        else if (name.compare("set") == 0)
+        {
+            set_name.SetCString(value.c_str());
+        }
+        else if (name.compare("gcc") == 0 || name.compare("ehframe") == 0)
+        {
+            reg_info.kinds[eRegisterKindEHFrame] = StringConvert::ToUInt32(value.c_str(), LLDB_INVALID_REGNUM, 0);
+        }
+        else if (name.compare("dwarf") == 0)
+        {
+            reg_info.kinds[eRegisterKindDWARF] = StringConvert::ToUInt32(value.c_str(), LLDB_INVALID_REGNUM, 0);
+        }
+        else if (name.compare("generic") == 0)
+        {
+            reg_info.kinds[eRegisterKindGeneric] = Args::StringToGenericRegister (value.c_str());
+        }
+        else if (name.compare("container-regs") == 0)
+        {
+            SplitCommaSeparatedRegisterNumberString(value, value_regs, 16);
+        }
+        else if (name.compare("invalidate-regs") == 0)
+        {
+            SplitCommaSeparatedRegisterNumberString(value, invalidate_regs, 16);
+        }
+    }
+
+    reg_info.byte_offset = reg_offset;
+    assert (reg_info.byte_size != 0);
+    reg_offset += reg_info.byte_size;
+    if (!value_regs.empty())
+    {
+        value_regs.push_back(LLDB_INVALID_REGNUM);
+        reg_info.value_regs = value_regs.data();
+    }
+    if (!invalidate_regs.empty())
+    {
+        invalidate_regs.push_back(LLDB_INVALID_REGNUM);
+        reg_info.invalidate_regs = invalidate_regs.data();
+    }
+
+    // We have to make a temporary ABI here, and not use the GetABI because this code
+    // gets called in DidAttach, when the target architecture (and consequently the ABI we'll get from
+    // the process) may be wrong.
+    ABISP abi_to_use = ABI::FindPlugin(arch_to_use);
+
+    AugmentRegisterInfoViaABI (reg_info, reg_name, abi_to_use);
+
+    m_register_info.AddRegister(reg_info, reg_name, alt_name, set_name);
+}
+
+bool
+ProcessGDBRemote::GetRegisterInfoCacheFileSpec (const ArchSpec &arch, FileSpec &cache_file_spec)
+{
+    if (!GetGlobalPluginProperties()->GetUseRegisterInfoCache())
+        return false;
+
+    // The register layout only depends on the stub and the architecture of the
+    // process it is debugging, so that's what identifies a cache entry.
+    const ArchSpec &host_arch = m_gdb_comm.GetHostArchitecture();
+    if (!arch.IsValid() || !host_arch.IsValid())
+        return false;
+
+    FileSpec dir_spec = Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory();
+    if (!dir_spec)
+        return false;
+
+    StreamString file_name;
+    if (const char *server_name = m_gdb_comm.GetGDBServerProgramName())
+        file_name.Printf ("%s-%u-", server_name, m_gdb_comm.GetGDBServerProgramVersion());
+    file_name.Printf ("%s-%s.regs", host_arch.GetTriple().getTriple().c_str(), arch.GetTriple().getTriple().c_str());
+
+    // Keep the file name a single path component.
+    std::string file_name_str = file_name.GetString();
+    std::replace (file_name_str.begin(), file_name_str.end(), '/', '_');
+
+    cache_file_spec = dir_spec;
+    cache_file_spec.AppendPathComponent ("gdb-remote-register-info");
+    cache_file_spec.AppendPathComponent (file_name_str.c_str());
+    return true;
+}
+
+bool
+ProcessGDBRemote::LoadRegisterInfoCache (const FileSpec &cache_file_spec, const ArchSpec &arch_to_use)
+{
+    if (!cache_file_spec.Exists())
+        return false;
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    DataBufferSP data_sp = cache_file_spec.ReadFileContents();
+    if (!data_sp)
+        return false;
+
+    // The cache holds the qRegisterInfo responses, one per line.
+    std::vector<std::string> cached_responses;
+    llvm::StringRef contents ((const char *)data_sp->GetBytes(), data_sp->GetByteSize());
+    while (!contents.empty())
+    {
+        std::pair<llvm::StringRef, llvm::StringRef> line = contents.split('\n');
+        if (!line.first.empty())
+            cached_responses.push_back (line.first.str());
+        contents = line.second;
+    }
+    if (cached_responses.empty())
+        return false;
+
+    // Make sure the stub still describes the same registers: the first and the
+    // last registers must match and there must be no register after the last
+    // one. That costs a single round trip instead of one per register.
+    const uint32_t num_regs = cached_responses.size();
+    char packet[128];
+    std::vector<std::string> packets;
+    for (const uint32_t reg_num : { 0u, num_regs - 1, num_regs })
+    {
+        ::snprintf (packet, sizeof(packet), "qRegisterInfo%x", reg_num);
+        packets.push_back (packet);
+    }
+    std::vector<StringExtractorGDBRemote> responses;
+    if (m_gdb_comm.SendPacketsAndWaitForResponses (packets, responses) != GDBRemoteCommunication::PacketResult::Success ||
+        responses[0].GetStringRef() != cached_responses.front() ||
+        responses[1].GetStringRef() != cached_responses.back() ||
+        responses[2].GetResponseType() == StringExtractorGDBRemote::eResponse)
+    {
+        if (log)
+            log->Printf ("ProcessGDBRemote::%s ignoring out of date register info cache '%s'",
+                         __FUNCTION__, cache_file_spec.GetPath().c_str());
+        return false;
+    }
+
+    uint32_t reg_offset = 0;
+    for (uint32_t reg_num = 0; reg_num < num_regs; ++reg_num)
+    {
+        StringExtractorGDBRemote response (cached_responses[reg_num].c_str());
+        AddRegisterFromRegisterInfoResponse (response, reg_num, reg_offset, arch_to_use);
+    }
+
+    if (log)
+        log->Printf ("ProcessGDBRemote::%s loaded %u registers from '%s'",
+                     __FUNCTION__, num_regs, cache_file_spec.GetPath().c_str());
+    return true;
+}
+
+void
+ProcessGDBRemote::SaveRegisterInfoCache (const FileSpec &cache_file_spec, const std::vector<std::string> &responses)
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    StreamString strm;
+    for (const std::string &response : responses)
+    {
+        strm.PutCString (response.c_str());
+        strm.EOL();
+    }
+
+    Error error = ModuleCache::WriteDataFile (cache_file_spec, strm.GetData(), strm.GetSize());
+    if (error.Fail() && log)
+        log->Printf ("ProcessGDBRemote::%s failed to write '%s': %s",
+                     __FUNCTION__, cache_file_spec.GetPath().c_str(), error.AsCString());
+}
+
 void
 ProcessGDBRemote::BuildDynamicRegisterInfo (bool force)
 {
@@ -517,151 +830,48 @@ ProcessGDBRemote::BuildDynamicRegisterInfo (bool force)
     if (GetGDBServerRegisterInfo (arch_to_use))
         return;
 
+    FileSpec cache_file_spec;
+    const bool use_register_info_cache = GetRegisterInfoCacheFileSpec (arch_to_use, cache_file_spec);
+    if (use_register_info_cache && LoadRegisterInfoCache (cache_file_spec, arch_to_use))
+    {
+        m_register_info.Finalize(GetTarget().GetArchitecture());
+        return;
+    }
+
+    // We don't know how many registers there are, so we ask for them in
+    // batches and ignore the error replies we get past the last register.
+    const uint32_t register_info_batch_size = 16;
     char packet[128];
     uint32_t reg_offset = 0;
     uint32_t reg_num = 0;
+    std::vector<StringExtractorGDBRemote> responses;
+    std::vector<std::string> register_info_responses;
+    size_t response_idx = 0;
     for (StringExtractorGDBRemote::ResponseType response_type = StringExtractorGDBRemote::eResponse;
          response_type == StringExtractorGDBRemote::eResponse;
          ++reg_num)
     {
-        const int packet_len = ::snprintf (packet, sizeof(packet), "qRegisterInfo%x", reg_num);
-        assert (packet_len < (int)sizeof(packet));
-        StringExtractorGDBRemote response;
-        if (m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, false) == GDBRemoteCommunication::PacketResult::Success)
+        if (response_idx == responses.size())
+        {
+            std::vector<std::string> packets;
+            for (uint32_t i = 0; i < register_info_batch_size; ++i)
+            {
+                const int packet_len = ::snprintf (packet, sizeof(packet), "qRegisterInfo%x", reg_num + i);
+                assert (packet_len < (int)sizeof(packet));
+                packets.push_back (std::string (packet, packet_len));
+            }
+            m_gdb_comm.SendPacketsAndWaitForResponses (packets, responses);
+            response_idx = 0;
+        }
+
+        if (response_idx < responses.size())
         {
+            StringExtractorGDBRemote &response = responses[response_idx++];
             response_type = response.GetResponseType();
             if (response_type == StringExtractorGDBRemote::eResponse)
             {
-                std::string name;
-                std::string value;
-                ConstString reg_name;
-                ConstString alt_name;
-                ConstString set_name;
-                std::vector<uint32_t> value_regs;
-                std::vector<uint32_t> invalidate_regs;
-                RegisterInfo reg_info = { NULL,                 // Name
-                    NULL,                 // Alt name
-                    0,                    // byte size
-                    reg_offset,           // offset
-                    eEncodingUint,        // encoding
-                    eFormatHex,           // format
-                    {
-                        LLDB_INVALID_REGNUM, // eh_frame reg num
-                        LLDB_INVALID_REGNUM, // DWARF reg num
-                        LLDB_INVALID_REGNUM, // generic reg num
-                        reg_num,             // process plugin reg num
-                        reg_num           // native register number
-                    },
-                    NULL,
-                    NULL
-                };
-
-                while (response.GetNameColonValue(name, value))
-                {
-                    if (name.compare("name") == 0)
-                    {
-                        reg_name.SetCString(value.c_str());
-                    }
-                    else if (name.compare("alt-name") == 0)
-                    {
-                        alt_name.SetCString(value.c_str());
-                    }
-                    else if (name.compare("bitsize") == 0)
-                    {
-                        reg_info.byte_size = StringConvert::ToUInt32(value.c_str(), 0, 0) / CHAR_BIT;
-                    }
-                    else if (name.compare("offset") == 0)
-                    {
-                        uint32_t offset = StringConvert::ToUInt32(value.c_str(), UINT32_MAX, 0);
-                        if (reg_offset != offset)
-                        {
-                            reg_offset = offset;
-                        }
-                    }
-                    else if (name.compare("encoding") == 0)
-                    {
-                        const Encoding encoding = Args::StringToEncoding (value.c_str());
-                        if (encoding != eEncodingInvalid)
-                            reg_info.encoding = encoding;
-                    }
-                    else if (name.compare("format") == 0)
-                    {
-                        Format format = eFormatInvalid;
-                        if (Args::StringToFormat (value.c_str(), format, NULL).Success())
-                            reg_info.format = format;
-                        else if (value.compare("binary") == 0)
-                            reg_info.format = eFormatBinary;
-                        else if (value.compare("decimal") == 0)
-                            reg_info.format = eFormatDecimal;
-                        else if (value.compare("hex") == 0)
-                            reg_info.format = eFormatHex;
-                        else if (value.compare("float") == 0)
-                            reg_info.format = eFormatFloat;
-                        else if (value.compare("vector-sint8") == 0)
-                            reg_info.format = eFormatVectorOfSInt8;
-                        else if (value.compare("vector-uint8") == 0)
-                            reg_info.format = eFormatVectorOfUInt8;
-                        else if (value.compare("vector-sint16") == 0)
-                            reg_info.format = eFormatVectorOfSInt16;
-                        else if (value.compare("vector-uint16") == 0)
-                            reg_info.format = eFormatVectorOfUInt16;
-                        else if (value.compare("vector-sint32") == 0)
-                            reg_info.format = eFormatVectorOfSInt32;
-                        else if (value.compare("vector-uint32") == 0)
-                            reg_info.format = eFormatVectorOfUInt32;
-                        else if (value.compare("vector-float32") == 0)
-                            reg_info.format = eFormatVectorOfFloat32;
-                        else if (value.compare("vector-uint128") == 0)
-                            reg_info.format = eFormatVectorOfUInt128;
-                    }
-                    else if (name.compare("set") == 0)
-                    {
-                        set_name.SetCString(value.c_str());
-                    }
-                    else if (name.compare("gcc") == 0 || name.compare("ehframe") == 0)
-                    {
-                        reg_info.kinds[eRegisterKindEHFrame] = StringConvert::ToUInt32(value.c_str(), LLDB_INVALID_REGNUM, 0);
-                    }
-                    else if (name.compare("dwarf") == 0)
-                    {
-                        reg_info.kinds[eRegisterKindDWARF] = StringConvert::ToUInt32(value.c_str(), LLDB_INVALID_REGNUM, 0);
-                    }
-                    else if (name.compare("generic") == 0)
-                    {
-                        reg_info.kinds[eRegisterKindGeneric] = Args::StringToGenericRegister (value.c_str());
-                    }
-                    else if (name.compare("container-regs") == 0)
-                    {
-                        SplitCommaSeparatedRegisterNumberString(value, value_regs, 16);
-                    }
-                    else if (name.compare("invalidate-regs") == 0)
-                    {
-                        SplitCommaSeparatedRegisterNumberString(value, invalidate_regs, 16);
-                    }
-                }
-
-                reg_info.byte_offset = reg_offset;
-                assert (reg_info.byte_size != 0);
-                reg_offset += reg_info.byte_size;
-                if (!value_regs.empty())
-                {
-                    value_regs.push_back(LLDB_INVALID_REGNUM);
-                    reg_info.value_regs = value_regs.data();
-                }
-                if (!invalidate_regs.empty())
-                {
-                    invalidate_regs.push_back(LLDB_INVALID_REGNUM);
-                    reg_info.invalidate_regs = invalidate_regs.data();
-                }
-
-                // We have to make a temporary ABI here, and not use the GetABI because this code
-                // gets called in DidAttach, when the target architecture (and consequently the ABI we'll get from
-                // the process) may be wrong.
-                ABISP abi_to_use = ABI::FindPlugin(arch_to_use);
-
-                AugmentRegisterInfoViaABI (reg_info, reg_name, abi_to_use);
-
-                m_register_info.AddRegister(reg_info, reg_name, alt_name, set_name);
+                register_info_responses.push_back (response.GetStringRef());
+                AddRegisterFromRegisterInfoResponse (response, reg_num, reg_offset, arch_to_use);
             }
             else
             {
@@ -676,6 +886,8 @@ ProcessGDBRemote::BuildDynamicRegisterInfo (bool force)
 
     if (m_register_info.GetNumRegisters() > 0)
     {
+        if (use_register_info_cache)
+            SaveRegisterInfoCache (cache_file_spec, register_info_responses);
         m_register_info.Finalize(GetTarget().GetArchitecture());
         return;
     }
@@ -1103,6 +1315,15 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
         return error;
     }
 
+    // Record the session from the handshake on so it can be replayed.
+    FileSpec record_file = GetGlobalPluginProperties()->GetPacketRecordFile();
+    if (record_file)
+    {
+        Error record_error = m_gdb_comm.StartRecording (record_file.GetPath().c_str());
+        if (record_error.Fail() && log)
+            log->Printf("ProcessGDBRemote::%s failed to record packets to %s: %s", __FUNCTION__,
+                        record_file.GetPath().c_str(), record_error.AsCString());
+    }
 
     // Start the communications read thread so all incoming data can be
     // parsed into packets and queued as they arrive.
@@ -1127,6 +1348,27 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
         GetTarget().SetNonStopModeEnabled (m_gdb_comm.SetNonStopMode(true));
 
     m_gdb_comm.GetEchoSupported ();
+
+    if (GetGlobalPluginProperties()->GetUseBinaryFraming())
+        m_gdb_comm.EnableBinaryFraming ();
+
+    // A server on the same host can put memory reads straight into shared
+    // memory, other servers just refuse it. Those reads would be missing
+    // from a recording.
+    if (GetGlobalPluginProperties()->GetUseSharedMemory() && !m_gdb_comm.IsRecording())
+        m_gdb_comm.EnableSharedMemory (16 * 1024 * 1024);
+
+    // The queries below are independent of each other, so send them all at
+    // once and let each of them pick up its response.
+    std::vector<std::string> startup_packets = {
+        "QThreadSuffixSupported",
+        "QListThreadsInStopReply",
+        "qHostInfo",
+        "vCont?",
+        "qVAttachOrWaitSupported"
+    };
+    m_gdb_comm.PrefetchResponses (startup_packets);
+
     m_gdb_comm.GetThreadSuffixSupported ();
     m_gdb_comm.GetListThreadsInStopReplySupported ();
     m_gdb_comm.GetHostInfo ();
@@ -1355,11 +1597,36 @@ ProcessGDBRemote::WillResume ()
     m_continue_C_tids.clear();
     m_continue_s_tids.clear();
     m_continue_S_tids.clear();
-    m_jstopinfo_sp.reset();
-    m_jthreadsinfo_sp.reset();
+    m_continue_step_ranges.clear();
+    m_jstopinfo.clear();
+    m_jstopinfo_map.clear();
+    m_jthreadsinfo.clear();
+    m_jthreadsinfo_map.clear();
+    UpdateAutomaticSignalFiltering();
     return Error();
 }
 
+void
+ProcessGDBRemote::UpdateAutomaticSignalFiltering ()
+{
+    const UnixSignalsSP &signals_sp = GetUnixSignals();
+    if (!signals_sp || signals_sp->GetVersion() == m_last_signals_version)
+        return;
+    if (!m_gdb_comm.GetQPassSignalsSupported())
+        return;
+
+    // The stub delivers these signals to the process as soon as they
+    // arrive, we'd only resume the process with them anyway.
+    std::vector<int32_t> signals_to_pass = signals_sp->GetFilteredSignals(false, false, false);
+
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_PROCESS));
+    if (m_gdb_comm.SendSignalsToIgnore(signals_to_pass))
+        m_last_signals_version = signals_sp->GetVersion();
+    else if (log)
+        log->Printf("ProcessGDBRemote::%s failed to send %" PRIu64 " signals to pass to the stub", __FUNCTION__,
+                    (uint64_t)signals_to_pass.size());
+}
+
 Error
 ProcessGDBRemote::DoResume ()
 {
@@ -1419,8 +1686,18 @@ ProcessGDBRemote::DoResume ()
                 {
                     if (m_gdb_comm.GetVContSupported ('s'))
                     {
+                        const bool range_stepping = !m_continue_step_ranges.empty() &&
+                                                    GetGlobalPluginProperties()->GetUseRangeStepping() &&
+                                                    m_gdb_comm.GetVContSupported ('r');
                         for (tid_collection::const_iterator t_pos = m_continue_s_tids.begin(), t_end = m_continue_s_tids.end(); t_pos != t_end; ++t_pos)
-                            continue_packet.Printf(";s:%4.4" PRIx64, *t_pos);
+                        {
+                            auto range_pos = m_continue_step_ranges.find(*t_pos);
+                            if (range_stepping && range_pos != m_continue_step_ranges.end())
+                                continue_packet.Printf(";r%" PRIx64 ",%" PRIx64 ":%4.4" PRIx64,
+                                                       range_pos->second.first, range_pos->second.second, *t_pos);
+                            else
+                                continue_packet.Printf(";s:%4.4" PRIx64, *t_pos);
+                        }
                     }
                     else
                         continue_packet_error = true;
@@ -1583,6 +1860,17 @@ ProcessGDBRemote::DoResume ()
             }
         }
 
+        // A sampling run replaces the resume the threads asked for, all of
+        // them run until the samples are taken.
+        if (m_next_resume_sample_duration_ms != 0)
+        {
+            continue_packet.Clear();
+            continue_packet.Printf("jSample:%" PRIx32 ",%" PRIx32, m_next_resume_sample_duration_ms, m_next_resume_sample_frequency);
+            continue_packet_error = false;
+            m_next_resume_sample_duration_ms = 0;
+            m_next_resume_sample_frequency = 0;
+        }
+
         if (continue_packet_error)
         {
             error.SetErrorString ("can't make continue packet for this resume");
@@ -1651,6 +1939,85 @@ ProcessGDBRemote::ClearThreadIDList ()
     m_thread_pcs.clear();
 }
 
+//----------------------------------------------------------------------
+// Helpers to read the JSON arrays of thread infos of the "jThreadsInfo"
+// packet and the "jstopinfo" stop reply key without building a tree.
+//----------------------------------------------------------------------
+
+// Call "callback" for each object in the array, right after the parser
+// returned its ObjectStart event. The callback has to consume the object.
+// Returns false if the JSON isn't valid or the callback returns false.
+template <typename Callback>
+static bool
+ForEachThreadInfo (JSONPullParser &parser, Callback callback)
+{
+    if (parser.Next() != JSONPullParser::Event::ArrayStart)
+        return false;
+    while (1)
+    {
+        const JSONPullParser::Event event = parser.Next();
+        if (event == JSONPullParser::Event::ArrayEnd)
+            return true;
+        if (event == JSONPullParser::Event::ObjectStart)
+        {
+            if (!callback())
+                return false;
+        }
+        else if (!parser.SkipValue())
+            return false;
+    }
+}
+
+// Read the next value as an integer, other values are skipped.
+static uint64_t
+GetJSONInteger (JSONPullParser &parser, uint64_t fail_value)
+{
+    if (parser.Next() == JSONPullParser::Event::Integer)
+        return parser.GetValueAsUnsigned(fail_value);
+    parser.SkipValue();
+    return fail_value;
+}
+
+static std::string
+GetJSONString (JSONPullParser &parser)
+{
+    if (parser.Next() == JSONPullParser::Event::String)
+        return parser.GetValue().str();
+    parser.SkipValue();
+    return std::string();
+}
+
+static bool
+GetJSONBoolean (JSONPullParser &parser)
+{
+    const JSONPullParser::Event event = parser.Next();
+    if (event == JSONPullParser::Event::True || event == JSONPullParser::Event::False)
+        return event == JSONPullParser::Event::True;
+    parser.SkipValue();
+    return false;
+}
+
+// Consume a thread info object and return its "tid".
+static lldb::tid_t
+GetThreadInfoTID (JSONPullParser &parser)
+{
+    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    JSONPullParser::Event event;
+    while ((event = parser.Next()) == JSONPullParser::Event::Key)
+    {
+        if (parser.GetValue() == "tid")
+        {
+            tid = GetJSONInteger(parser, LLDB_INVALID_THREAD_ID);
+        }
+        else
+        {
+            parser.Next();
+            parser.SkipValue();
+        }
+    }
+    return event == JSONPullParser::Event::ObjectEnd ? tid : LLDB_INVALID_THREAD_ID;
+}
+
 size_t
 ProcessGDBRemote::UpdateThreadIDsFromStopReplyThreadsValue (std::string &value)
 {
@@ -1698,27 +2065,20 @@ ProcessGDBRemote::UpdateThreadIDList ()
 {
     std::lock_guard<std::recursive_mutex> guard(m_thread_list_real.GetMutex());
 
-    if (m_jthreadsinfo_sp)
+    if (!m_jthreadsinfo.empty())
     {
         // If we have the JSON threads info, we can get the thread list from that
-        StructuredData::Array *thread_infos = m_jthreadsinfo_sp->GetAsArray();
-        if (thread_infos && thread_infos->GetSize() > 0)
-        {
-            m_thread_ids.clear();
-            m_thread_pcs.clear();
-            thread_infos->ForEach([this](StructuredData::Object* object) -> bool {
-                StructuredData::Dictionary *thread_dict = object->GetAsDictionary();
-                if (thread_dict)
-                {
-                    // Set the thread stop info from the JSON dictionary
-                    SetThreadStopInfo (thread_dict);
-                    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
-                    if (thread_dict->GetValueForKeyAsInteger<lldb::tid_t>("tid", tid))
-                        m_thread_ids.push_back(tid);
-                }
-                return true; // Keep iterating through all thread_info objects
-            });
-        }
+        m_thread_ids.clear();
+        m_thread_pcs.clear();
+        JSONPullParser parser(m_jthreadsinfo);
+        ForEachThreadInfo(parser, [this, &parser]() -> bool {
+            // Set the thread stop info from the JSON object
+            lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+            SetThreadStopInfo (parser, tid);
+            if (tid != LLDB_INVALID_THREAD_ID)
+                m_thread_ids.push_back(tid);
+            return true; // Keep iterating through all thread_info objects
+        });
         if (!m_thread_ids.empty())
             return true;
     }
@@ -1826,19 +2186,11 @@ ProcessGDBRemote::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new
             // Early in the process startup, we may not yet have set the process ByteOrder so we ignore these;
             // they are a performance improvement over fetching thread register values individually, the
             // method we will fall back to if needed.
+            // The register context is only created once somebody looks at the thread.
             if (m_thread_ids.size() == m_thread_pcs.size() && thread_sp.get() && GetByteOrder() != eByteOrderInvalid)
             {
                 ThreadGDBRemote *gdb_thread = static_cast<ThreadGDBRemote *> (thread_sp.get());
-                RegisterContextSP reg_ctx_sp (thread_sp->GetRegisterContext());
-                if (reg_ctx_sp)
-                {
-                    uint32_t pc_regnum = reg_ctx_sp->ConvertRegisterKindToRegisterNumber
-                                                                   (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC);
-                    if (pc_regnum != LLDB_INVALID_REGNUM)
-                    {
-                        gdb_thread->PrivateSetRegisterValue (pc_regnum, m_thread_pcs[i]);
-                    }
-                }
+                gdb_thread->SetPendingPC (m_thread_pcs[i]);
             }
             new_thread_list.AddThread(thread_sp);
         }
@@ -1862,28 +2214,36 @@ ProcessGDBRemote::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new
 
 
 bool
-ProcessGDBRemote::GetThreadStopInfoFromJSON (ThreadGDBRemote *thread, const StructuredData::ObjectSP &thread_infos_sp)
+ProcessGDBRemote::GetThreadStopInfoFromJSON (ThreadGDBRemote *thread,
+                                             const std::string &thread_infos,
+                                             ThreadInfoMap &thread_info_map)
 {
     // See if we got thread stop infos for all threads via the "jThreadsInfo" packet
-    if (thread_infos_sp)
+    if (!thread_infos.empty())
     {
-        StructuredData::Array *thread_infos = thread_infos_sp->GetAsArray();
-        if (thread_infos)
+        // Index the thread infos by thread ID the first time around so looking
+        // up each of the threads doesn't rescan the whole array. Only the
+        // "tid" values are read, the thread infos are parsed when used.
+        if (thread_info_map.empty())
+        {
+            JSONPullParser parser(thread_infos);
+            ForEachThreadInfo(parser, [&parser, &thread_info_map]() -> bool {
+                const size_t offset = parser.GetEventOffset();
+                const lldb::tid_t tid = GetThreadInfoTID(parser);
+                if (tid != LLDB_INVALID_THREAD_ID)
+                    thread_info_map[tid] = offset;
+                return true;
+            });
+        }
+
+        ThreadInfoMap::const_iterator pos = thread_info_map.find(thread->GetID());
+        if (pos != thread_info_map.end())
         {
+            JSONPullParser parser(thread_infos);
+            parser.SetOffset(pos->second);
             lldb::tid_t tid;
-            const size_t n = thread_infos->GetSize();
-            for (size_t i=0; i<n; ++i)
-            {
-                StructuredData::Dictionary *thread_dict = thread_infos->GetItemAtIndex(i)->GetAsDictionary();
-                if (thread_dict)
-                {
-                    if (thread_dict->GetValueForKeyAsInteger<lldb::tid_t>("tid", tid, LLDB_INVALID_THREAD_ID))
-                    {
-                        if (tid == thread->GetID())
-                            return (bool)SetThreadStopInfo(thread_dict);
-                    }
-                }
-            }
+            if (parser.Next() == JSONPullParser::Event::ObjectStart)
+                return (bool)SetThreadStopInfo(parser, tid);
         }
     }
     return false;
@@ -1893,18 +2253,18 @@ bool
 ProcessGDBRemote::CalculateThreadStopInfo (ThreadGDBRemote *thread)
 {
     // See if we got thread stop infos for all threads via the "jThreadsInfo" packet
-    if (GetThreadStopInfoFromJSON (thread, m_jthreadsinfo_sp))
+    if (GetThreadStopInfoFromJSON (thread, m_jthreadsinfo, m_jthreadsinfo_map))
         return true;
 
     // See if we got thread stop info for any threads valid stop info reasons threads
     // via the "jstopinfo" packet stop reply packet key/value pair?
-    if (m_jstopinfo_sp)
+    if (!m_jstopinfo.empty())
     {
         // If we have "jstopinfo" then we have stop descriptions for all threads
         // that have stop reasons, and if there is no entry for a thread, then
         // it has no stop reason.
-        thread->GetRegisterContext()->InvalidateIfNeeded(true);
-        if (!GetThreadStopInfoFromJSON (thread, m_jstopinfo_sp))
+        thread->InvalidateRegisterContextIfNeeded(true);
+        if (!GetThreadStopInfoFromJSON (thread, m_jstopinfo, m_jstopinfo_map))
         {
             thread->SetStopInfo (StopInfoSP());
         }
@@ -2171,30 +2531,12 @@ ProcessGDBRemote::SetThreadStopInfo (lldb::tid_t tid,
 }
 
 lldb::ThreadSP
-ProcessGDBRemote::SetThreadStopInfo (StructuredData::Dictionary *thread_dict)
-{
-    static ConstString g_key_tid("tid");
-    static ConstString g_key_name("name");
-    static ConstString g_key_reason("reason");
-    static ConstString g_key_metype("metype");
-    static ConstString g_key_medata("medata");
-    static ConstString g_key_qaddr("qaddr");
-    static ConstString g_key_dispatch_queue_t("dispatch_queue_t");
-    static ConstString g_key_associated_with_dispatch_queue("associated_with_dispatch_queue");
-    static ConstString g_key_queue_name("qname");
-    static ConstString g_key_queue_kind("qkind");
-    static ConstString g_key_queue_serial_number("qserialnum");
-    static ConstString g_key_registers("registers");
-    static ConstString g_key_memory("memory");
-    static ConstString g_key_address("address");
-    static ConstString g_key_bytes("bytes");
-    static ConstString g_key_description("description");
-    static ConstString g_key_signal("signal");
-
+ProcessGDBRemote::SetThreadStopInfo (JSONPullParser &parser, lldb::tid_t &tid)
+{
     // Stop with signal and thread info
-    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    tid = LLDB_INVALID_THREAD_ID;
+    lldb::tid_t thread_tid = LLDB_INVALID_THREAD_ID;
     uint8_t signo = 0;
-    std::string value;
     std::string thread_name;
     std::string reason;
     std::string description;
@@ -2208,64 +2550,54 @@ ProcessGDBRemote::SetThreadStopInfo (StructuredData::Dictionary *thread_dict)
     std::string queue_name;
     QueueKind queue_kind = eQueueKindUnknown;
     uint64_t queue_serial_number = 0;
-    // Iterate through all of the thread dictionary key/value pairs from the structured data dictionary
-
-    thread_dict->ForEach([this,
-                          &tid,
-                          &expedited_register_map,
-                          &thread_name,
-                          &signo,
-                          &reason,
-                          &description,
-                          &exc_type,
-                          &exc_data,
-                          &thread_dispatch_qaddr,
-                          &queue_vars_valid,
-                          &associated_with_dispatch_queue,
-                          &dispatch_queue_t,
-                          &queue_name,
-                          &queue_kind,
-                          &queue_serial_number]
-                          (ConstString key, StructuredData::Object* object) -> bool
-    {
-        if (key == g_key_tid)
+
+    // Iterate through all of the thread info key/value pairs straight from
+    // the JSON text. A key is only valid until the parser reads its value.
+    JSONPullParser::Event event;
+    while ((event = parser.Next()) == JSONPullParser::Event::Key)
+    {
+        const llvm::StringRef key = parser.GetValue();
+        if (key == "tid")
         {
             // thread in big endian hex
-            tid = object->GetIntegerValue(LLDB_INVALID_THREAD_ID);
+            thread_tid = GetJSONInteger(parser, LLDB_INVALID_THREAD_ID);
         }
-        else if (key == g_key_metype)
+        else if (key == "metype")
         {
             // exception type in big endian hex
-            exc_type = object->GetIntegerValue(0);
+            exc_type = GetJSONInteger(parser, 0);
         }
-        else if (key == g_key_medata)
+        else if (key == "medata")
         {
             // exception data in big endian hex
-            StructuredData::Array *array = object->GetAsArray();
-            if (array)
+            if (parser.Next() == JSONPullParser::Event::ArrayStart)
             {
-                array->ForEach([&exc_data](StructuredData::Object* object) -> bool {
-                    exc_data.push_back(object->GetIntegerValue());
-                    return true; // Keep iterating through all array items
-                });
+                while (parser.Next() != JSONPullParser::Event::ArrayEnd)
+                {
+                    exc_data.push_back(parser.GetValueAsUnsigned(0));
+                    if (!parser.SkipValue())
+                        break;
+                }
             }
+            else
+                parser.SkipValue();
         }
-        else if (key == g_key_name)
+        else if (key == "name")
         {
-            thread_name = object->GetStringValue();
+            thread_name = GetJSONString(parser);
         }
-        else if (key == g_key_qaddr)
+        else if (key == "qaddr")
         {
-            thread_dispatch_qaddr = object->GetIntegerValue(LLDB_INVALID_ADDRESS);
+            thread_dispatch_qaddr = GetJSONInteger(parser, LLDB_INVALID_ADDRESS);
         }
-        else if (key == g_key_queue_name)
+        else if (key == "qname")
         {
             queue_vars_valid = true;
-            queue_name = object->GetStringValue();
+            queue_name = GetJSONString(parser);
         }
-        else if (key == g_key_queue_kind)
+        else if (key == "qkind")
         {
-            std::string queue_kind_str = object->GetStringValue();
+            std::string queue_kind_str = GetJSONString(parser);
             if (queue_kind_str == "serial")
             {
                 queue_vars_valid = true;
@@ -2277,87 +2609,112 @@ ProcessGDBRemote::SetThreadStopInfo (StructuredData::Dictionary *thread_dict)
                 queue_kind = eQueueKindConcurrent;
             }
         }
-        else if (key == g_key_queue_serial_number)
+        else if (key == "qserialnum")
         {
-            queue_serial_number = object->GetIntegerValue(0);
+            queue_serial_number = GetJSONInteger(parser, 0);
             if (queue_serial_number != 0)
                 queue_vars_valid = true;
         }
-        else if (key == g_key_dispatch_queue_t)
+        else if (key == "dispatch_queue_t")
         {
-            dispatch_queue_t = object->GetIntegerValue(0);
+            dispatch_queue_t = GetJSONInteger(parser, 0);
             if (dispatch_queue_t != 0 && dispatch_queue_t != LLDB_INVALID_ADDRESS)
                 queue_vars_valid = true;
         }
-        else if (key == g_key_associated_with_dispatch_queue)
+        else if (key == "associated_with_dispatch_queue")
         {
             queue_vars_valid = true;
-            bool associated = object->GetBooleanValue ();
+            bool associated = GetJSONBoolean(parser);
             if (associated)
                 associated_with_dispatch_queue = eLazyBoolYes;
             else
                 associated_with_dispatch_queue = eLazyBoolNo;
         }
-        else if (key == g_key_reason)
+        else if (key == "reason")
         {
-            reason = object->GetStringValue();
+            reason = GetJSONString(parser);
         }
-        else if (key == g_key_description)
+        else if (key == "description")
         {
-            description = object->GetStringValue();
+            description = GetJSONString(parser);
         }
-        else if (key == g_key_registers)
+        else if (key == "registers")
         {
-            StructuredData::Dictionary *registers_dict = object->GetAsDictionary();
-
-            if (registers_dict)
+            if (parser.Next() == JSONPullParser::Event::ObjectStart)
             {
-                registers_dict->ForEach([&expedited_register_map](ConstString key, StructuredData::Object* object) -> bool {
-                    const uint32_t reg = StringConvert::ToUInt32 (key.GetCString(), UINT32_MAX, 10);
-                    if (reg != UINT32_MAX)
-                        expedited_register_map[reg] = object->GetStringValue();
-                    return true; // Keep iterating through all array items
-                });
+                while (parser.Next() == JSONPullParser::Event::Key)
+                {
+                    uint32_t reg;
+                    if (parser.GetValue().getAsInteger(10, reg))
+                        reg = UINT32_MAX;
+                    if (parser.Next() == JSONPullParser::Event::String && reg != UINT32_MAX)
+                        expedited_register_map[reg] = parser.GetValue().str();
+                    else
+                        parser.SkipValue();
+                }
             }
+            else
+                parser.SkipValue();
         }
-        else if (key == g_key_memory)
+        else if (key == "memory")
         {
-            StructuredData::Array *array = object->GetAsArray();
-            if (array)
+            if (parser.Next() == JSONPullParser::Event::ArrayStart)
             {
-                array->ForEach([this](StructuredData::Object* object) -> bool {
-                    StructuredData::Dictionary *mem_cache_dict = object->GetAsDictionary();
-                    if (mem_cache_dict)
+                JSONPullParser::Event mem_event;
+                while ((mem_event = parser.Next()) == JSONPullParser::Event::ObjectStart)
+                {
+                    lldb::addr_t mem_cache_addr = LLDB_INVALID_ADDRESS;
+                    DataBufferSP data_buffer_sp;
+                    while ((mem_event = parser.Next()) == JSONPullParser::Event::Key)
                     {
-                        lldb::addr_t mem_cache_addr = LLDB_INVALID_ADDRESS;
-                        if (mem_cache_dict->GetValueForKeyAsInteger<lldb::addr_t>("address", mem_cache_addr))
+                        if (parser.GetValue() == "address")
                         {
-                            if (mem_cache_addr != LLDB_INVALID_ADDRESS)
+                            mem_cache_addr = GetJSONInteger(parser, LLDB_INVALID_ADDRESS);
+                        }
+                        else if (parser.GetValue() == "bytes")
+                        {
+                            if (parser.Next() == JSONPullParser::Event::String)
                             {
-                                StringExtractor bytes;
-                                if (mem_cache_dict->GetValueForKeyAsString("bytes", bytes.GetStringRef()))
-                                {
-                                    bytes.SetFilePos(0);
-
-                                    const size_t byte_size = bytes.GetStringRef().size()/2;
-                                    DataBufferSP data_buffer_sp(new DataBufferHeap(byte_size, 0));
-                                    const size_t bytes_copied = bytes.GetHexBytes (data_buffer_sp->GetBytes(), byte_size, 0);
-                                    if (bytes_copied == byte_size)
-                                        m_memory_cache.AddL1CacheData(mem_cache_addr, data_buffer_sp);
-                                }
+                                // Decode the bytes right away, the string may
+                                // not outlive the next key.
+                                const llvm::StringRef bytes = parser.GetValue();
+                                const size_t byte_size = bytes.size()/2;
+                                data_buffer_sp.reset(new DataBufferHeap(byte_size, 0));
+                                if (HexDecode(bytes.data(), byte_size, data_buffer_sp->GetBytes()) != byte_size)
+                                    data_buffer_sp.reset();
                             }
+                            else
+                                parser.SkipValue();
+                        }
+                        else
+                        {
+                            parser.Next();
+                            parser.SkipValue();
                         }
                     }
-                    return true; // Keep iterating through all array items
-                });
+                    if (mem_event == JSONPullParser::Event::ObjectEnd && mem_cache_addr != LLDB_INVALID_ADDRESS && data_buffer_sp)
+                        m_memory_cache.AddL1CacheData(mem_cache_addr, data_buffer_sp);
+                }
             }
-
+            else
+                parser.SkipValue();
         }
-        else if (key == g_key_signal)
-            signo = object->GetIntegerValue(LLDB_INVALID_SIGNAL_NUMBER);
-        return true; // Keep iterating through all dictionary key/value pairs
-    });
+        else if (key == "signal")
+        {
+            signo = GetJSONInteger(parser, LLDB_INVALID_SIGNAL_NUMBER);
+        }
+        else
+        {
+            parser.Next();
+            parser.SkipValue();
+        }
+    }
+
+    // Don't use a thread info that isn't valid JSON
+    if (event != JSONPullParser::Event::ObjectEnd)
+        return ThreadSP();
 
+    tid = thread_tid;
     return SetThreadStopInfo (tid,
                               expedited_register_map,
                               signo,
@@ -2492,7 +2849,8 @@ ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
 
                     // This JSON contains thread IDs and thread stop info for all threads.
                     // It doesn't contain expedited registers, memory or queue info.
-                    m_jstopinfo_sp = StructuredData::ParseJSON (value);
+                    m_jstopinfo.swap(value);
+                    m_jstopinfo_map.clear();
                 }
                 else if (key.compare("hexname") == 0)
                 {
@@ -2995,6 +3353,7 @@ void
 ProcessGDBRemote::SetUnixSignals(const UnixSignalsSP &signals_sp)
 {
     Process::SetUnixSignals(std::make_shared<GDBRemoteSignals>(signals_sp));
+    m_last_signals_version = UINT64_MAX;
 }
 
 //------------------------------------------------------------------
@@ -3033,23 +3392,23 @@ ProcessGDBRemote::WillPublicStop ()
     // and more. Expediting memory will help stack backtracing be much
     // faster. Expediting registers will make sure we don't have to read
     // the thread registers for GPRs.
-    m_jthreadsinfo_sp = m_gdb_comm.GetThreadsInfo();
+    m_jthreadsinfo_map.clear();
 
-    if (m_jthreadsinfo_sp)
+    if (m_gdb_comm.GetThreadsInfo(m_jthreadsinfo))
     {
         // Now set the stop info for each thread and also expedite any registers
-        // and memory that was in the jThreadsInfo response.
-        StructuredData::Array *thread_infos = m_jthreadsinfo_sp->GetAsArray();
-        if (thread_infos)
-        {
-            const size_t n = thread_infos->GetSize();
-            for (size_t i=0; i<n; ++i)
-            {
-                StructuredData::Dictionary *thread_dict = thread_infos->GetItemAtIndex(i)->GetAsDictionary();
-                if (thread_dict)
-                    SetThreadStopInfo(thread_dict);
-            }
-        }
+        // and memory that was in the jThreadsInfo response. The reply is read
+        // in place, and the offset of each thread info is kept so the later
+        // lookups by thread ID don't have to scan the reply again.
+        JSONPullParser parser(m_jthreadsinfo);
+        ForEachThreadInfo(parser, [this, &parser]() -> bool {
+            const size_t offset = parser.GetEventOffset();
+            lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+            SetThreadStopInfo(parser, tid);
+            if (tid != LLDB_INVALID_THREAD_ID)
+                m_jthreadsinfo_map[tid] = offset;
+            return true; // Keep iterating through all thread_info objects
+        });
     }
 }
 
@@ -3059,6 +3418,11 @@ ProcessGDBRemote::WillPublicStop ()
 size_t
 ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
 {
+    // Shared memory reads can be as big as the shared memory, they don't
+    // go through the connection.
+    if (m_gdb_comm.GetSharedMemoryReadSize() > 0)
+        return m_gdb_comm.ReadMemoryShared (addr, buf, size, error);
+
     GetMaxMemorySize ();
     if (size > m_max_memory_size)
     {
@@ -3075,7 +3439,14 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
                             binary_memory_read ? 'x' : 'm', (uint64_t)addr, (uint64_t)size);
     assert (packet_len + 1 < (int)sizeof(packet));
     StringExtractorGDBRemote response;
-    if (m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, true) == GDBRemoteCommunication::PacketResult::Success)
+    // Reads of a stopped process from several threads share the round
+    // trips, a running process has to be interrupted first.
+    GDBRemoteCommunication::PacketResult packet_result;
+    if (m_gdb_comm.IsRunning())
+        packet_result = m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, true);
+    else
+        packet_result = m_gdb_comm.SendPipelinedPacketAndWaitForResponse(packet, packet_len, response);
+    if (packet_result == GDBRemoteCommunication::PacketResult::Success)
     {
         if (response.IsNormalResponse())
         {
@@ -3193,6 +3564,51 @@ ProcessGDBRemote::DoAllocateMemory (size_t size, uint32_t permissions, Error &er
     return allocated_addr;
 }
 
+lldb::addr_t
+ProcessGDBRemote::FindInMemory (addr_t low, addr_t high, const uint8_t *pattern, size_t pattern_size)
+{
+    // The stub only knows about the breakpoint opcodes it inserted itself,
+    // the ones we wrote into memory would be searched as is.
+    const addr_t search_end = high + pattern_size - 1;
+    bool has_software_sites = false;
+    m_breakpoint_site_list.ForEachInRange (low, search_end, [&has_software_sites](const BreakpointSiteSP &site_sp) {
+        if (site_sp->GetType() == BreakpointSite::eSoftware)
+            has_software_sites = true;
+    });
+
+    if (!has_software_sites && search_end > low)
+    {
+        addr_t found_addr = LLDB_INVALID_ADDRESS;
+        if (m_gdb_comm.SearchMemory (low, search_end - low, pattern, pattern_size, found_addr))
+            return found_addr;
+    }
+    return Process::FindInMemory (low, high, pattern, pattern_size);
+}
+
+Error
+ProcessGDBRemote::FindReferences (addr_t value, size_t max_matches, std::vector<addr_t> &matches)
+{
+    // Scanning in the stub saves reading all of the writable memory over
+    // the connection.
+    if (m_gdb_comm.GetFindReferencesSupported())
+    {
+        Error error (m_gdb_comm.FindReferences (value, max_matches, matches));
+        if (error.Success() || m_gdb_comm.GetFindReferencesSupported())
+            return error;
+    }
+    return Process::FindReferences (value, max_matches, matches);
+}
+
+uint32_t
+ProcessGDBRemote::GetMaxConcurrentMemoryReads ()
+{
+    // Reads from several threads are pipelined, which needs no-ack mode.
+    // Shared memory reads don't use the connection at all.
+    if (m_gdb_comm.GetSendAcks() || m_gdb_comm.GetSharedMemoryReadSize() > 0)
+        return 1;
+    return 8;
+}
+
 Error
 ProcessGDBRemote::GetMemoryRegionInfo (addr_t load_addr,
                                        MemoryRegionInfo &region_info)
@@ -3217,6 +3633,73 @@ ProcessGDBRemote::GetWatchpointSupportInfo (uint32_t &num, bool& after)
     return error;
 }
 
+Error
+ProcessGDBRemote::StartBranchTrace (lldb::tid_t tid, size_t buffer_size)
+{
+    return m_gdb_comm.StartBranchTrace (tid, buffer_size);
+}
+
+Error
+ProcessGDBRemote::StopBranchTrace (lldb::tid_t tid)
+{
+    return m_gdb_comm.StopBranchTrace (tid);
+}
+
+Error
+ProcessGDBRemote::GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches)
+{
+    return m_gdb_comm.GetBranchTrace (tid, branches);
+}
+
+Error
+ProcessGDBRemote::SaveCheckpoint (uint32_t &checkpoint_id)
+{
+    return m_gdb_comm.SaveCheckpoint (checkpoint_id);
+}
+
+Error
+ProcessGDBRemote::RestoreCheckpoint (uint32_t checkpoint_id)
+{
+    StringExtractorGDBRemote response;
+    Error error = m_gdb_comm.RestoreCheckpoint (checkpoint_id, response);
+    if (error.Fail())
+        return error;
+
+    // The stub debugs a copy of the checkpoint now, forget the threads of
+    // the process that went away.
+    const lldb::pid_t pid = m_gdb_comm.GetCurrentProcessID (false);
+    if (pid != LLDB_INVALID_PROCESS_ID)
+        SetID (pid);
+    m_thread_list_real.Clear();
+    m_thread_list.Clear();
+    ClearThreadIDList ();
+    SetLastStopPacket (response);
+
+    // Go through a stop again, like HandleNotifyPacket() does, so the
+    // threads, registers and memory are read from the new process.
+    SetPrivateState (eStateRunning);
+    SetPrivateState (eStateStopped);
+    return error;
+}
+
+Error
+ProcessGDBRemote::SampleNextResume (uint32_t duration_ms, uint32_t frequency)
+{
+    if (!m_gdb_comm.GetSamplingSupported ())
+        return Error ("the remote stub doesn't support sampling");
+    if (GetTarget().GetNonStopModeEnabled())
+        return Error ("sampling is not supported in non-stop mode");
+    m_next_resume_sample_duration_ms = duration_ms;
+    m_next_resume_sample_frequency = frequency;
+    return Error ();
+}
+
+Error
+ProcessGDBRemote::GetSamples (std::vector<std::pair<lldb::tid_t, std::vector<lldb::addr_t>>> &samples)
+{
+    return m_gdb_comm.GetSamples (samples);
+}
+
 Error
 ProcessGDBRemote::DoDeallocateMemory (lldb::addr_t addr)
 {
@@ -3271,6 +3754,401 @@ ProcessGDBRemote::PutSTDIN (const char *src, size_t src_len, Error &error)
     return 0;
 }
 
+namespace {
+
+enum ConditionComparison
+{
+    eComparisonEqual,
+    eComparisonNotEqual,
+    eComparisonLess,
+    eComparisonLessEqual,
+    eComparisonGreater,
+    eComparisonGreaterEqual
+};
+
+// Parses breakpoint conditions of the form "<identifier> <op> <integer>"
+// where <op> is one of the C comparison operators. Anything else is left to
+// the expression parser.
+bool
+ParseSimpleCondition (const char *text, std::string &name, ConditionComparison &comparison, int64_t &value)
+{
+    llvm::StringRef str = llvm::StringRef(text).trim();
+
+    size_t name_len = 0;
+    while (name_len < str.size() &&
+           (isalpha(str[name_len]) || str[name_len] == '_' || (name_len > 0 && isdigit(str[name_len]))))
+        ++name_len;
+    if (name_len == 0)
+        return false;
+    name = str.substr(0, name_len).str();
+    str = str.substr(name_len).ltrim();
+
+    static const struct
+    {
+        const char *text;
+        ConditionComparison comparison;
+    } g_comparisons[] = {
+        { "==", eComparisonEqual },
+        { "!=", eComparisonNotEqual },
+        { "<=", eComparisonLessEqual },
+        { ">=", eComparisonGreaterEqual },
+        { "<",  eComparisonLess },
+        { ">",  eComparisonGreater }
+    };
+    bool found = false;
+    for (const auto &entry : g_comparisons)
+    {
+        if (str.startswith(entry.text))
+        {
+            comparison = entry.comparison;
+            str = str.substr(strlen(entry.text)).ltrim();
+            found = true;
+            break;
+        }
+    }
+    if (!found)
+        return false;
+
+    // Integer literals only, with an optional sign and the usual C base
+    // prefixes but no suffixes.
+    return !str.empty() && !str.getAsInteger(0, value);
+}
+
+} // anonymous namespace
+
+bool
+ProcessGDBRemote::AppendDWARFRegister (uint32_t reg_kind, uint32_t reg_num, AgentExpression &expr)
+{
+    // The stub numbers registers the way it described them in qRegisterInfo.
+    const uint32_t lldb_reg = m_register_info.ConvertRegisterKindToRegisterNumber(reg_kind, reg_num);
+    if (lldb_reg == LLDB_INVALID_REGNUM)
+        return false;
+    const RegisterInfo *reg_info = m_register_info.GetRegisterInfoAtIndex(lldb_reg);
+    if (!reg_info || reg_info->kinds[eRegisterKindProcessPlugin] > UINT16_MAX)
+        return false;
+    expr.AppendRegister(reg_info->kinds[eRegisterKindProcessPlugin]);
+    return true;
+}
+
+bool
+ProcessGDBRemote::AppendDWARFLocation (DWARFExpression &location, Function *function, Module &module,
+                                       AgentExpression &expr, bool &in_register)
+{
+    in_register = false;
+
+    DataExtractor data;
+    if (location.IsLocationList() || !location.GetExpressionData(data))
+        return false;
+
+    const int reg_kind = location.GetRegisterKind();
+    lldb::offset_t offset = 0;
+    const uint8_t op = data.GetU8(&offset);
+    switch (op)
+    {
+        case DW_OP_addr:
+        {
+            Address so_addr;
+            if (!module.ResolveFileAddress(data.GetAddress(&offset), so_addr))
+                return false;
+            const addr_t load_addr = so_addr.GetLoadAddress(&GetTarget());
+            if (load_addr == LLDB_INVALID_ADDRESS)
+                return false;
+            expr.AppendConstant(load_addr);
+            break;
+        }
+
+        case DW_OP_bregx:
+        {
+            const uint32_t reg_num = data.GetULEB128(&offset);
+            if (!AppendDWARFRegister(reg_kind, reg_num, expr))
+                return false;
+            expr.AppendConstant(data.GetSLEB128(&offset));
+            expr.AppendOpcode(AgentExpression::eOpcodeAdd);
+            break;
+        }
+
+        case DW_OP_regx:
+            if (!AppendDWARFRegister(reg_kind, data.GetULEB128(&offset), expr))
+                return false;
+            in_register = true;
+            break;
+
+        case DW_OP_fbreg:
+        {
+            // Only frame bases that are a plain register or a register plus
+            // an offset.
+            if (!function)
+                return false;
+            DWARFExpression &frame_base = function->GetFrameBaseExpression();
+            DataExtractor frame_base_data;
+            if (frame_base.IsLocationList() || !frame_base.GetExpressionData(frame_base_data))
+                return false;
+
+            lldb::offset_t frame_base_offset = 0;
+            const uint8_t frame_base_op = frame_base_data.GetU8(&frame_base_offset);
+            int64_t frame_base_adjust = 0;
+            uint32_t reg_num;
+            if (frame_base_op >= DW_OP_breg0 && frame_base_op <= DW_OP_breg31)
+            {
+                reg_num = frame_base_op - DW_OP_breg0;
+                frame_base_adjust = frame_base_data.GetSLEB128(&frame_base_offset);
+            }
+            else if (frame_base_op >= DW_OP_reg0 && frame_base_op <= DW_OP_reg31)
+                reg_num = frame_base_op - DW_OP_reg0;
+            else
+                return false;
+            if (frame_base_offset != frame_base_data.GetByteSize() ||
+                !AppendDWARFRegister(frame_base.GetRegisterKind(), reg_num, expr))
+                return false;
+            expr.AppendConstant(frame_base_adjust + data.GetSLEB128(&offset));
+            expr.AppendOpcode(AgentExpression::eOpcodeAdd);
+            break;
+        }
+
+        default:
+            if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+            {
+                if (!AppendDWARFRegister(reg_kind, op - DW_OP_breg0, expr))
+                    return false;
+                expr.AppendConstant(data.GetSLEB128(&offset));
+                expr.AppendOpcode(AgentExpression::eOpcodeAdd);
+            }
+            else if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+            {
+                if (!AppendDWARFRegister(reg_kind, op - DW_OP_reg0, expr))
+                    return false;
+                in_register = true;
+            }
+            else
+                return false;
+            break;
+    }
+
+    // Locations made of more than one operation are not supported.
+    return offset == data.GetByteSize();
+}
+
+bool
+ProcessGDBRemote::CompileBreakpointCondition (BreakpointLocation &location, AgentExpression &expr)
+{
+    const char *condition_text = location.GetConditionText();
+    std::string name;
+    ConditionComparison comparison;
+    int64_t value;
+    if (!condition_text || !ParseSimpleCondition(condition_text, name, comparison, value))
+        return false;
+
+    // Look the variable up the way the expression parser would: the
+    // innermost block first, then the enclosing blocks and finally the
+    // globals of the compile unit.
+    SymbolContext sc;
+    location.GetAddress().CalculateSymbolContext(&sc, eSymbolContextModule | eSymbolContextCompUnit |
+                                                      eSymbolContextFunction | eSymbolContextBlock);
+    if (!sc.module_sp)
+        return false;
+
+    const ConstString var_name(name.c_str());
+    VariableSP var_sp;
+    for (Block *block = sc.block; block && !var_sp; block = block->GetParent())
+    {
+        VariableListSP variables = block->GetBlockVariableList(true);
+        if (variables)
+            var_sp = variables->FindVariable(var_name);
+    }
+    if (!var_sp && sc.comp_unit)
+    {
+        VariableListSP variables = sc.comp_unit->GetVariableList(true);
+        if (variables)
+            var_sp = variables->FindVariable(var_name);
+    }
+    if (!var_sp)
+        return false;
+
+    Type *type = var_sp->GetType();
+    bool is_signed = false;
+    if (!type || !type->GetForwardCompilerType().IsIntegerType(is_signed))
+        return false;
+    const uint64_t byte_size = type->GetByteSize();
+    if (byte_size != 1 && byte_size != 2 && byte_size != 4 && byte_size != 8)
+        return false;
+
+    // Values are compared as 64 bit integers, which matches C as long as a
+    // negative literal is not converted to an unsigned int or wider.
+    if (!is_signed && byte_size >= 4 && value < 0)
+        return false;
+
+    bool in_register = false;
+    if (!AppendDWARFLocation(var_sp->LocationExpression(), sc.function, *sc.module_sp, expr, in_register))
+        return false;
+
+    if (!in_register)
+    {
+        switch (byte_size)
+        {
+            case 1: expr.AppendOpcode(AgentExpression::eOpcodeRef8); break;
+            case 2: expr.AppendOpcode(AgentExpression::eOpcodeRef16); break;
+            case 4: expr.AppendOpcode(AgentExpression::eOpcodeRef32); break;
+            case 8: expr.AppendOpcode(AgentExpression::eOpcodeRef64); break;
+        }
+    }
+    if (byte_size < 8)
+        expr.AppendOpcode(is_signed ? AgentExpression::eOpcodeExt : AgentExpression::eOpcodeZeroExt, byte_size * 8);
+    expr.AppendConstant(value);
+
+    const AgentExpression::Opcode less = (!is_signed && byte_size == 8) ? AgentExpression::eOpcodeLessUnsigned
+                                                                        : AgentExpression::eOpcodeLessSigned;
+    switch (comparison)
+    {
+        case eComparisonEqual:
+            expr.AppendOpcode(AgentExpression::eOpcodeEqual);
+            break;
+        case eComparisonNotEqual:
+            expr.AppendOpcode(AgentExpression::eOpcodeEqual);
+            expr.AppendOpcode(AgentExpression::eOpcodeLogNot);
+            break;
+        case eComparisonLess:
+            expr.AppendOpcode(less);
+            break;
+        case eComparisonGreaterEqual:
+            expr.AppendOpcode(less);
+            expr.AppendOpcode(AgentExpression::eOpcodeLogNot);
+            break;
+        case eComparisonGreater:
+            expr.AppendOpcode(AgentExpression::eOpcodeSwap);
+            expr.AppendOpcode(less);
+            break;
+        case eComparisonLessEqual:
+            expr.AppendOpcode(AgentExpression::eOpcodeSwap);
+            expr.AppendOpcode(less);
+            expr.AppendOpcode(AgentExpression::eOpcodeLogNot);
+            break;
+    }
+    expr.AppendOpcode(AgentExpression::eOpcodeEnd);
+    return true;
+}
+
+bool
+ProcessGDBRemote::GetBreakpointSiteConditions (BreakpointSite *bp_site, std::vector<AgentExpression> &conditions)
+{
+    conditions.clear();
+    if (!m_gdb_comm.GetConditionalBreakpointsSupported())
+        return false;
+
+    // The stub may only skip a hit when no owner of the site would stop for
+    // it, so every owner needs a condition we can compile and no ignore
+    // count, which the stub knows nothing about.
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP location_sp = bp_site->GetOwnerAtIndex(i);
+        AgentExpression condition;
+        if (!location_sp ||
+            location_sp->GetIgnoreCount() != 0 ||
+            location_sp->GetBreakpoint().GetIgnoreCount() != 0 ||
+            !CompileBreakpointCondition(*location_sp, condition))
+        {
+            conditions.clear();
+            return false;
+        }
+        conditions.push_back(condition);
+    }
+    return !conditions.empty();
+}
+
+bool
+ProcessGDBRemote::IsCountingBreakpointSite (BreakpointSite *bp_site)
+{
+    if (!m_gdb_comm.GetCountingBreakpointsSupported())
+        return false;
+
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP location_sp = bp_site->GetOwnerAtIndex(i);
+        if (!location_sp || !location_sp->GetBreakpoint().IsCounting())
+            return false;
+    }
+    return num_owners > 0;
+}
+
+bool
+ProcessGDBRemote::GetBreakpointSiteThreads (BreakpointSite *bp_site, std::vector<lldb::tid_t> &thread_ids)
+{
+    thread_ids.clear();
+    if (!m_gdb_comm.GetThreadSpecificBreakpointsSupported())
+        return false;
+
+    // Thread IDs and indexes are resolved to the IDs the stub uses, names
+    // and queues can change while the process runs so only we can check
+    // them.
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP location_sp = bp_site->GetOwnerAtIndex(i);
+        const ThreadSpec *thread_spec = location_sp ? location_sp->GetOptionsNoCreate()->GetThreadSpecNoCreate() : nullptr;
+        if (!thread_spec || !thread_spec->HasSpecification() || thread_spec->GetName() ||
+            thread_spec->GetQueueName())
+        {
+            thread_ids.clear();
+            return false;
+        }
+
+        ThreadSP thread_sp;
+        if (thread_spec->GetIndex() != UINT32_MAX)
+            thread_sp = m_thread_list.FindThreadByIndexID(thread_spec->GetIndex(), false);
+        else
+            thread_sp = m_thread_list.FindThreadByID(thread_spec->GetTID(), false);
+        if (!thread_sp || !thread_spec->TIDMatches(*thread_sp))
+        {
+            // The thread doesn't exist (yet), an index may be given to a
+            // new thread.
+            if (thread_spec->GetIndex() != UINT32_MAX)
+            {
+                thread_ids.clear();
+                return false;
+            }
+            thread_ids.push_back(thread_spec->GetTID());
+        }
+        else
+            thread_ids.push_back(thread_sp->GetProtocolID());
+    }
+    return !thread_ids.empty();
+}
+
+void
+ProcessGDBRemote::SetCountingBreakpointSite (lldb::addr_t addr, bool counting)
+{
+    if (counting)
+        m_counted_hits[addr] = 0;
+    else
+        m_counted_hits.erase(addr);
+}
+
+void
+ProcessGDBRemote::UpdateBreakpointHitCounts ()
+{
+    // Only ask while stopped, so this never interrupts the process. Hits
+    // counted since the last stop are lost if a counting breakpoint is
+    // removed while the process runs.
+    if (m_counted_hits.empty() || !StateIsStoppedState(GetPrivateState(), true))
+        return;
+
+    std::vector<std::pair<addr_t, uint64_t>> hit_counts;
+    if (!m_gdb_comm.GetBreakpointHitCounts(hit_counts))
+        return;
+
+    for (const auto &hit_count : hit_counts)
+    {
+        auto pos = m_counted_hits.find(hit_count.first);
+        if (pos == m_counted_hits.end() || hit_count.second <= pos->second)
+            continue;
+        BreakpointSiteSP bp_site_sp = GetBreakpointSiteList().FindByAddress(hit_count.first);
+        if (bp_site_sp)
+            bp_site_sp->AddCountedHits((uint32_t)std::min<uint64_t>(hit_count.second - pos->second, UINT32_MAX));
+        pos->second = hit_count.second;
+    }
+}
+
 Error
 ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
 {
@@ -3308,13 +4186,22 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     // skip over software breakpoints.
     if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) && (!bp_site->HardwareRequired()))
     {
-        // Try to send off a software breakpoint packet ($Z0)
-        uint8_t error_no = m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size);
+        // Try to send off a software breakpoint packet ($Z0), letting the stub
+        // evaluate the conditions of the breakpoint if it can.
+        std::vector<AgentExpression> conditions;
+        GetBreakpointSiteConditions(bp_site, conditions);
+        const bool counting = IsCountingBreakpointSite(bp_site);
+        std::vector<lldb::tid_t> thread_ids;
+        GetBreakpointSiteThreads(bp_site, thread_ids);
+        uint8_t error_no = m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size,
+                                                                 conditions.empty() ? nullptr : &conditions, counting,
+                                                                 thread_ids.empty() ? nullptr : &thread_ids);
         if (error_no == 0)
         {
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
             bp_site->SetType(BreakpointSite::eExternal);
+            SetCountingBreakpointSite(addr, counting);
             return error;
         }
 
@@ -3391,6 +4278,142 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     return EnableSoftwareBreakpoint(bp_site);
 }
 
+void
+ProcessGDBRemote::EnableBreakpointSites (const std::vector<BreakpointSiteSP> &bp_sites, std::vector<Error> &errors)
+{
+    errors.assign (bp_sites.size(), Error());
+
+    // Plain software breakpoints are sent together, everything else, and
+    // any breakpoint the stub rejected, goes through EnableBreakpointSite().
+    std::vector<size_t> batched;
+    std::vector<std::pair<addr_t, uint32_t>> breakpoints;
+    if (StateIsStoppedState (GetPrivateState(), true) && m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware))
+    {
+        for (size_t i = 0; i < bp_sites.size(); ++i)
+        {
+            BreakpointSite *bp_site = bp_sites[i].get();
+            if (bp_site->IsEnabled() || bp_site->HardwareRequired() || IsCountingBreakpointSite(bp_site))
+                continue;
+            std::vector<AgentExpression> conditions;
+            std::vector<lldb::tid_t> thread_ids;
+            if (GetBreakpointSiteConditions(bp_site, conditions) || GetBreakpointSiteThreads(bp_site, thread_ids))
+                continue;
+            batched.push_back (i);
+            breakpoints.push_back (std::make_pair (bp_site->GetLoadAddress(), (uint32_t)GetSoftwareBreakpointTrapOpcode(bp_site)));
+        }
+    }
+
+    std::vector<bool> done (bp_sites.size(), false);
+    if (batched.size() > 1)
+    {
+        Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+        if (log)
+            log->Printf("ProcessGDBRemote::%s inserting %" PRIu64 " breakpoints", __FUNCTION__, (uint64_t)batched.size());
+
+        std::vector<uint8_t> error_nos;
+        m_gdb_comm.SendSoftwareBreakpointPackets(true, breakpoints, error_nos);
+        for (size_t i = 0; i < batched.size() && i < error_nos.size(); ++i)
+        {
+            if (error_nos[i] != 0)
+                continue;
+            BreakpointSite *bp_site = bp_sites[batched[i]].get();
+            bp_site->SetEnabled(true);
+            bp_site->SetType(BreakpointSite::eExternal);
+            done[batched[i]] = true;
+        }
+    }
+
+    for (size_t i = 0; i < bp_sites.size(); ++i)
+    {
+        if (!done[i])
+            errors[i] = EnableBreakpointSite(bp_sites[i].get());
+    }
+}
+
+void
+ProcessGDBRemote::DisableBreakpointSites (const std::vector<BreakpointSiteSP> &bp_sites)
+{
+    std::vector<BreakpointSite *> batched;
+    std::vector<std::pair<addr_t, uint32_t>> breakpoints;
+    for (const BreakpointSiteSP &bp_site_sp : bp_sites)
+    {
+        BreakpointSite *bp_site = bp_site_sp.get();
+        if (!bp_site->IsEnabled())
+            continue;
+        if (bp_site->GetType() == BreakpointSite::eExternal && !bp_site->IsHardware())
+        {
+            batched.push_back (bp_site);
+            breakpoints.push_back (std::make_pair (bp_site->GetLoadAddress(), (uint32_t)GetSoftwareBreakpointTrapOpcode(bp_site)));
+        }
+        else
+            DisableBreakpointSite(bp_site);
+    }
+
+    if (batched.size() == 1)
+    {
+        DisableBreakpointSite(batched[0]);
+        return;
+    }
+    if (batched.empty())
+        return;
+
+    // Collect what the stub counted before the counts go away.
+    UpdateBreakpointHitCounts();
+
+    std::vector<uint8_t> error_nos;
+    m_gdb_comm.SendSoftwareBreakpointPackets(false, breakpoints, error_nos);
+    for (size_t i = 0; i < batched.size(); ++i)
+    {
+        if (i < error_nos.size() && error_nos[i] == 0)
+        {
+            batched[i]->SetEnabled(false);
+            SetCountingBreakpointSite(batched[i]->GetLoadAddress(), false);
+        }
+        else
+            DisableBreakpointSite(batched[i]);
+    }
+}
+
+void
+ProcessGDBRemote::BreakpointSiteConditionsChanged (BreakpointSite *bp_site)
+{
+    if (!bp_site->IsEnabled() || bp_site->GetType() != BreakpointSite::eExternal || bp_site->IsHardware() ||
+        (!m_gdb_comm.GetConditionalBreakpointsSupported() && !m_gdb_comm.GetCountingBreakpointsSupported() &&
+         !m_gdb_comm.GetThreadSpecificBreakpointsSupported()))
+        return;
+
+    // Replace the breakpoint so the stub sees the new conditions and
+    // threads. The stub still reports every hit to us if we can't compile
+    // them.
+    std::vector<AgentExpression> conditions;
+    GetBreakpointSiteConditions(bp_site, conditions);
+    const bool counting = IsCountingBreakpointSite(bp_site);
+    std::vector<lldb::tid_t> thread_ids;
+    GetBreakpointSiteThreads(bp_site, thread_ids);
+
+    const addr_t addr = bp_site->GetLoadAddress();
+    if (m_counted_hits.count(addr))
+        UpdateBreakpointHitCounts();
+    const size_t bp_op_size = GetSoftwareBreakpointTrapOpcode(bp_site);
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf("ProcessGDBRemote::%s (site_id = %" PRIu64 ") address = 0x%" PRIx64 " now has %" PRIu64 " conditions",
+                    __FUNCTION__, bp_site->GetID(), (uint64_t)addr, (uint64_t)conditions.size());
+
+    SetCountingBreakpointSite(addr, false);
+    if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, false, addr, bp_op_size) != 0 ||
+        m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size,
+                                              conditions.empty() ? nullptr : &conditions, counting,
+                                              thread_ids.empty() ? nullptr : &thread_ids) != 0)
+    {
+        if (log)
+            log->Printf("ProcessGDBRemote::%s (site_id = %" PRIu64 ") failed to update the breakpoint",
+                        __FUNCTION__, bp_site->GetID());
+    }
+    else
+        SetCountingBreakpointSite(addr, counting);
+}
+
 Error
 ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
 {
@@ -3426,8 +4449,14 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
                 else
                     stoppoint_type = eBreakpointSoftware;
 
+                // Collect what the stub counted before the count goes away.
+                if (m_counted_hits.count(addr))
+                    UpdateBreakpointHitCounts();
+
                 if (m_gdb_comm.SendGDBStoppointTypePacket(stoppoint_type, false, addr, bp_op_size))
-                error.SetErrorToGenericError();
+                    error.SetErrorToGenericError();
+                else
+                    SetCountingBreakpointSite(addr, false);
             }
             break;
         }
@@ -4190,6 +5219,32 @@ ProcessGDBRemote::GetExtendedInfoForThread (lldb::tid_t tid)
     return object_sp;
 }
 
+void
+ProcessGDBRemote::GetStatistics (StructuredData::Dictionary &stats)
+{
+    const GDBRemoteCommunication::PacketStatistics &packet_stats = m_gdb_comm.GetPacketStatistics();
+
+    StructuredData::Dictionary *gdb_remote_stats = new StructuredData::Dictionary();
+    gdb_remote_stats->AddIntegerItem ("packets_sent", packet_stats.packets_sent);
+    gdb_remote_stats->AddIntegerItem ("bytes_sent", packet_stats.bytes_sent);
+    gdb_remote_stats->AddIntegerItem ("packets_received", packet_stats.packets_received);
+    gdb_remote_stats->AddIntegerItem ("bytes_received", packet_stats.bytes_received);
+    gdb_remote_stats->AddIntegerItem ("round_trips", packet_stats.round_trips);
+    gdb_remote_stats->AddFloatItem ("round_trip_time", packet_stats.round_trip_nanos / 1000000000.0);
+
+    // Only the buckets up to the slowest round trip, bucket i holds the
+    // round trips that took less than 2^(i+1) microseconds.
+    size_t num_buckets = GDBRemoteCommunication::PacketStatistics::kNumRoundTripBuckets;
+    while (num_buckets > 0 && packet_stats.round_trip_histogram[num_buckets - 1] == 0)
+        --num_buckets;
+    StructuredData::Array *histogram = new StructuredData::Array();
+    for (size_t i = 0; i < num_buckets; ++i)
+        histogram->AddItem (StructuredData::ObjectSP(new StructuredData::Integer(packet_stats.round_trip_histogram[i])));
+    gdb_remote_stats->AddItem ("round_trip_usec_log2_histogram", StructuredData::ObjectSP(histogram));
+
+    stats.AddItem ("gdb_remote", StructuredData::ObjectSP(gdb_remote_stats));
+}
+
 StructuredData::ObjectSP
 ProcessGDBRemote::GetLoadedDynamicLibrariesInfos (lldb::addr_t image_list_address, lldb::addr_t image_count)
 {
@@ -4244,7 +5299,9 @@ ProcessGDBRemote::GetLoadedDynamicLibrariesInfos (lldb::addr_t image_list_addres
 void
 ProcessGDBRemote::GetMaxMemorySize()
 {
-    const uint64_t reasonable_largeish_default = 128 * 1024;
+    // Binary frames aren't escaped, so much bigger transfers are cheap
+    // with them.
+    const uint64_t reasonable_largeish_default = m_gdb_comm.GetBinaryFramingEnabled() ? 4 * 1024 * 1024 : 128 * 1024;
     const uint64_t conservative_default = 512;
 
     if (m_max_memory_size == 0)
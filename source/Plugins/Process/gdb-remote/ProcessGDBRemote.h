@@ -16,6 +16,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -31,6 +32,7 @@
 #include "lldb/Core/LoadedModuleInfoList.h"
 #include "lldb/Host/HostThread.h"
 #include "lldb/lldb-private-forward.h"
+#include "lldb/Utility/JSON.h"
 #include "lldb/Utility/StringExtractor.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Thread.h"
@@ -178,6 +180,15 @@ public:
 
     Error
     GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &region_info) override;
+
+    lldb::addr_t
+    FindInMemory (lldb::addr_t low, lldb::addr_t high, const uint8_t *pattern, size_t pattern_size) override;
+
+    Error
+    FindReferences (lldb::addr_t value, size_t max_matches, std::vector<lldb::addr_t> &matches) override;
+
+    uint32_t
+    GetMaxConcurrentMemoryReads () override;
     
     Error
     DoDeallocateMemory (lldb::addr_t ptr) override;
@@ -197,6 +208,18 @@ public:
     Error
     DisableBreakpointSite (BreakpointSite *bp_site) override;
 
+    void
+    EnableBreakpointSites (const std::vector<lldb::BreakpointSiteSP> &bp_sites, std::vector<Error> &errors) override;
+
+    void
+    DisableBreakpointSites (const std::vector<lldb::BreakpointSiteSP> &bp_sites) override;
+
+    void
+    BreakpointSiteConditionsChanged (BreakpointSite *bp_site) override;
+
+    void
+    UpdateBreakpointHitCounts () override;
+
     //----------------------------------------------------------------------
     // Process Watchpoints
     //----------------------------------------------------------------------
@@ -211,6 +234,27 @@ public:
     
     Error
     GetWatchpointSupportInfo (uint32_t &num, bool& after) override;
+
+    Error
+    StartBranchTrace (lldb::tid_t tid, size_t buffer_size) override;
+
+    Error
+    StopBranchTrace (lldb::tid_t tid) override;
+
+    Error
+    GetBranchTrace (lldb::tid_t tid, std::vector<std::pair<lldb::addr_t, lldb::addr_t>> &branches) override;
+
+    Error
+    SaveCheckpoint (uint32_t &checkpoint_id) override;
+
+    Error
+    RestoreCheckpoint (uint32_t checkpoint_id) override;
+
+    Error
+    SampleNextResume (uint32_t duration_ms, uint32_t frequency) override;
+
+    Error
+    GetSamples (std::vector<std::pair<lldb::tid_t, std::vector<lldb::addr_t>>> &samples) override;
     
     bool
     StartNoticingNewThreads() override;
@@ -252,6 +296,10 @@ public:
     size_t
     LoadModules() override;
 
+    // Query remote GDBServer for a detailed loaded library list
+    Error
+    GetLoadedModuleList (LoadedModuleInfoList &list) override;
+
     Error
     GetFileLoadAddress(const FileSpec& file, bool& is_loaded, lldb::addr_t& load_addr) override;
 
@@ -261,6 +309,9 @@ public:
     StructuredData::ObjectSP
     GetLoadedDynamicLibrariesInfos (lldb::addr_t image_list_address, lldb::addr_t image_count) override;
 
+    void
+    GetStatistics (StructuredData::Dictionary &stats) override;
+
 protected:
     friend class ThreadGDBRemote;
     friend class GDBRemoteCommunicationClient;
@@ -290,23 +341,31 @@ protected:
     typedef std::vector< std::pair<lldb::tid_t,int> > tid_sig_collection;
     typedef std::map<lldb::addr_t, lldb::addr_t> MMapMap;
     typedef std::map<uint32_t, std::string> ExpeditedRegisterMap;
+    typedef std::unordered_map<lldb::tid_t, size_t> ThreadInfoMap; // Offsets of the thread info objects in a JSON array
     tid_collection m_thread_ids; // Thread IDs for all threads. This list gets updated after stopping
     std::vector<lldb::addr_t> m_thread_pcs; // PC values for all the threads.
-    StructuredData::ObjectSP m_jstopinfo_sp; // Stop info only for any threads that have valid stop infos
-    StructuredData::ObjectSP m_jthreadsinfo_sp; // Full stop info, expedited registers and memory for all threads if "jThreadsInfo" packet is supported
+    std::string m_jstopinfo; // JSON stop info only for any threads that have valid stop infos
+    ThreadInfoMap m_jstopinfo_map; // m_jstopinfo entries by thread ID, filled in on first use
+    std::string m_jthreadsinfo; // JSON full stop info, expedited registers and memory for all threads if "jThreadsInfo" packet is supported
+    ThreadInfoMap m_jthreadsinfo_map; // m_jthreadsinfo entries by thread ID, filled in on first use
     tid_collection m_continue_c_tids;                  // 'c' for continue
     tid_sig_collection m_continue_C_tids; // 'C' for continue with signal
     tid_collection m_continue_s_tids;                  // 's' for step
     tid_sig_collection m_continue_S_tids; // 'S' for step with signal
+    std::map<lldb::tid_t, std::pair<lldb::addr_t, lldb::addr_t>> m_continue_step_ranges; // 'r' for the 's' threads stepping through a range
+    uint32_t m_next_resume_sample_duration_ms; // Non-zero to make the next resume a jSample run
+    uint32_t m_next_resume_sample_frequency;
     uint64_t m_max_memory_size;       // The maximum number of bytes to read/write when reading and writing memory
     uint64_t m_remote_stub_max_memory_size;    // The maximum memory size the remote gdb stub can handle
     MMapMap m_addr_to_mmap_size;
+    std::map<lldb::addr_t, uint64_t> m_counted_hits;    // The hit count the stub last reported for each counting breakpoint
     lldb::BreakpointSP m_thread_create_bp_sp;
     bool m_waiting_for_attach;
     bool m_destroy_tried_resuming;
     lldb::CommandObjectSP m_command_sp;
     int64_t m_breakpoint_pc_offset;
     lldb::tid_t m_initial_tid; // The initial thread ID, given by stub on attach
+    uint64_t m_last_signals_version; // The UnixSignals version the stub last got the signals to pass from
 
     //----------------------------------------------------------------------
     // Accessors
@@ -369,6 +428,24 @@ protected:
     void
     BuildDynamicRegisterInfo (bool force);
 
+    // Parse a qRegisterInfo response for register "reg_num" and add it to
+    // m_register_info. "reg_offset" is the offset of the register unless the
+    // response specifies one, and is updated to the offset of the next one.
+    void
+    AddRegisterFromRegisterInfoResponse (StringExtractorGDBRemote &response,
+                                         uint32_t reg_num,
+                                         uint32_t &reg_offset,
+                                         const ArchSpec &arch_to_use);
+
+    bool
+    GetRegisterInfoCacheFileSpec (const ArchSpec &arch, FileSpec &cache_file_spec);
+
+    bool
+    LoadRegisterInfoCache (const FileSpec &cache_file_spec, const ArchSpec &arch_to_use);
+
+    void
+    SaveRegisterInfoCache (const FileSpec &cache_file_spec, const std::vector<std::string> &responses);
+
     void
     SetLastStopPacket (const StringExtractorGDBRemote &response);
 
@@ -413,10 +490,58 @@ protected:
     SetThreadStopInfo (StringExtractor& stop_packet);
 
     bool
-    GetThreadStopInfoFromJSON (ThreadGDBRemote *thread, const StructuredData::ObjectSP &thread_infos_sp);
+    GetThreadStopInfoFromJSON (ThreadGDBRemote *thread,
+                               const std::string &thread_infos,
+                               ThreadInfoMap &thread_info_map);
+
+    //------------------------------------------------------------------
+    // Compile the conditions of the owners of a breakpoint site into agent
+    // expressions for the stub. Returns false, with no conditions, if the
+    // stub must report every hit of the site.
+    //------------------------------------------------------------------
+    bool
+    GetBreakpointSiteConditions (BreakpointSite *bp_site, std::vector<AgentExpression> &conditions);
+
+    bool
+    CompileBreakpointCondition (BreakpointLocation &location, AgentExpression &expr);
+
+    // Returns true if the stub should count the hits of the site, which is
+    // the case when all of its owners are counting breakpoints.
+    bool
+    IsCountingBreakpointSite (BreakpointSite *bp_site);
+
+    // Get the stub thread IDs the site is for. Returns false, with no
+    // threads, if an owner is for all threads or for threads the stub
+    // can't tell apart, e.g. by name.
+    bool
+    GetBreakpointSiteThreads (BreakpointSite *bp_site, std::vector<lldb::tid_t> &thread_ids);
+
+    // Remembers that the site at addr is counting in the stub, or forgets
+    // about it when counting is false.
+    void
+    SetCountingBreakpointSite (lldb::addr_t addr, bool counting);
+
+    bool
+    AppendDWARFLocation (DWARFExpression &location, Function *function, Module &module,
+                         AgentExpression &expr, bool &in_register);
+
+    bool
+    AppendDWARFRegister (uint32_t reg_kind, uint32_t reg_num, AgentExpression &expr);
 
+    //------------------------------------------------------------------
+    /// Set the stop info of a thread from a JSON thread info object of a
+    /// "jThreadsInfo" reply or a "jstopinfo" stop reply key.
+    ///
+    /// @param[in] parser
+    ///     A parser that has just returned the ObjectStart event of the
+    ///     thread info. The object is consumed.
+    ///
+    /// @param[out] tid
+    ///     The "tid" of the thread info, or LLDB_INVALID_THREAD_ID if the
+    ///     object doesn't have one or isn't valid JSON.
+    //------------------------------------------------------------------
     lldb::ThreadSP
-    SetThreadStopInfo (StructuredData::Dictionary *thread_dict);
+    SetThreadStopInfo (JSONPullParser &parser, lldb::tid_t &tid);
 
     lldb::ThreadSP
     SetThreadStopInfo (lldb::tid_t tid,
@@ -461,10 +586,6 @@ protected:
     bool
     GetGDBServerRegisterInfo (ArchSpec &arch);
 
-    // Query remote GDBServer for a detailed loaded library list
-    Error
-    GetLoadedModuleList (LoadedModuleInfoList &);
-
     lldb::ModuleSP
     LoadModuleAtAddress (const FileSpec &file, lldb::addr_t link_map, lldb::addr_t base_addr,
                          bool value_is_offset);
@@ -479,6 +600,11 @@ private:
                          lldb::user_id_t break_id,
                          lldb::user_id_t break_loc_id);
 
+    // Send the signals that are neither stopped at nor printed to the stub
+    // when "process handle" changed them since the last resume.
+    void
+    UpdateAutomaticSignalFiltering ();
+
     DISALLOW_COPY_AND_ASSIGN (ProcessGDBRemote);
 };
 
@@ -21,6 +21,7 @@
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Target/ThreadPlanStepRange.h"
 #include "lldb/Target/UnixSignals.h"
 #include "lldb/Target/Unwind.h"
 
@@ -44,7 +45,8 @@ ThreadGDBRemote::ThreadGDBRemote (Process &process, lldb::tid_t tid) :
     m_dispatch_queue_t (LLDB_INVALID_ADDRESS),
     m_queue_kind (eQueueKindUnknown),
     m_queue_serial_number (LLDB_INVALID_QUEUE_ID),
-    m_associated_with_libdispatch_queue (eLazyBoolCalculate)
+    m_associated_with_libdispatch_queue (eLazyBoolCalculate),
+    m_pending_pc (LLDB_INVALID_ADDRESS)
 {
     ProcessGDBRemoteLog::LogIf(GDBR_LOG_THREAD, "%p: ThreadGDBRemote::ThreadGDBRemote (pid = %i, tid = 0x%4.4x)",
                                this, 
@@ -278,6 +280,8 @@ ThreadGDBRemote::WillResume (StateType resume_state)
     if (log)
         log->Printf ("Resuming thread: %4.4" PRIx64 " with state: %s.", tid, StateAsCString(resume_state));
 
+    m_pending_pc = LLDB_INVALID_ADDRESS;
+
     ProcessSP process_sp (GetProcess());
     if (process_sp)
     {
@@ -300,7 +304,18 @@ ThreadGDBRemote::WillResume (StateType resume_state)
             if (gdb_process->GetUnixSignals()->SignalIsValid(signo))
                 gdb_process->m_continue_S_tids.push_back(std::make_pair(tid, signo));
             else
+            {
                 gdb_process->m_continue_s_tids.push_back(tid);
+
+                // A step through a source line can be done by the stub
+                // without stopping for every instruction.
+                ThreadPlan *plan = GetCurrentPlan();
+                lldb::addr_t range_start, range_end;
+                if (plan && (plan->GetKind() == ThreadPlan::eKindStepOverRange ||
+                             plan->GetKind() == ThreadPlan::eKindStepInRange) &&
+                    static_cast<ThreadPlanStepRange *>(plan)->GetSteppingRange(range_start, range_end))
+                    gdb_process->m_continue_step_ranges[tid] = std::make_pair(range_start, range_end);
+            }
             break;
 
         default:
@@ -321,7 +336,30 @@ ThreadGDBRemote::RefreshStateAfterStop()
     // register supply functions where they check the process stop ID and do
     // the right thing.
     const bool force = false;
-    GetRegisterContext()->InvalidateIfNeeded (force);
+    InvalidateRegisterContextIfNeeded (force);
+}
+
+void
+ThreadGDBRemote::InvalidateRegisterContextIfNeeded (bool force)
+{
+    // A register context that hasn't been created yet has nothing cached.
+    if (m_reg_context_sp)
+        m_reg_context_sp->InvalidateIfNeeded (force);
+}
+
+void
+ThreadGDBRemote::SetPendingPC (lldb::addr_t pc)
+{
+    if (!m_reg_context_sp)
+    {
+        m_pending_pc = pc;
+        return;
+    }
+
+    m_pending_pc = LLDB_INVALID_ADDRESS;
+    uint32_t pc_regnum = m_reg_context_sp->ConvertRegisterKindToRegisterNumber (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC);
+    if (pc_regnum != LLDB_INVALID_REGNUM)
+        PrivateSetRegisterValue (pc_regnum, pc);
 }
 
 bool
@@ -345,7 +383,11 @@ lldb::RegisterContextSP
 ThreadGDBRemote::GetRegisterContext ()
 {
     if (m_reg_context_sp.get() == NULL)
+    {
         m_reg_context_sp = CreateRegisterContextForFrame (NULL);
+        if (m_reg_context_sp && m_pending_pc != LLDB_INVALID_ADDRESS)
+            SetPendingPC (m_pending_pc);
+    }
     return m_reg_context_sp;
 }
 
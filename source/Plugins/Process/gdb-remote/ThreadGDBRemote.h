@@ -128,6 +128,7 @@ protected:
     lldb::QueueKind m_queue_kind;     // Queue info from stop reply/stop info for thread
     uint64_t m_queue_serial_number;   // Queue info from stop reply/stop info for thread
     lldb_private::LazyBool m_associated_with_libdispatch_queue;
+    lldb::addr_t m_pending_pc;        // PC from the stop reply, stored until the register context is created
 
     bool
     PrivateSetRegisterValue (uint32_t reg, 
@@ -137,6 +138,15 @@ protected:
     PrivateSetRegisterValue (uint32_t reg, 
                              uint64_t regval);
 
+    // Threads that nobody looks at after a stop never need a register
+    // context, so the PC the stop reply gave us is only copied into the
+    // register context when something asks for it.
+    void
+    SetPendingPC (lldb::addr_t pc);
+
+    void
+    InvalidateRegisterContextIfNeeded (bool force);
+
     bool
     CachedQueueInfoIsValid() const
     {
@@ -92,6 +92,12 @@ public:
     bool
     IsAlive () override;
 
+    bool
+    IsLiveDebugSession () const override
+    {
+        return false;
+    }
+
     bool
     WarnBeforeDetach () const override;
 
@@ -0,0 +1,312 @@
+//===-- MinidumpParser.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MinidumpParser.h"
+
+// C Includes
+#include <stdlib.h>
+
+// C++ Includes
+// Other libraries and framework includes
+#include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Triple.h"
+
+// Project includes
+#include "lldb/Core/DataBuffer.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::minidump;
+
+MinidumpParser::UP
+MinidumpParser::Create (const lldb::DataBufferSP &data_sp, Error &error)
+{
+    if (!IsMinidump(data_sp))
+    {
+        error.SetErrorString("not a minidump file");
+        return UP();
+    }
+
+    llvm::ArrayRef<uint8_t> file_data (data_sp->GetBytes(), data_sp->GetByteSize());
+    llvm::ArrayRef<uint8_t> header_data = file_data;
+    const MinidumpHeader *header = ConsumeObject<MinidumpHeader>(header_data);
+
+    const uint32_t directory_rva = header->stream_directory_rva;
+    const uint32_t stream_count = header->stream_count;
+    if (directory_rva > file_data.size() ||
+        stream_count > (file_data.size() - directory_rva) / sizeof(MinidumpDirectory))
+    {
+        error.SetErrorString("the minidump stream directory is truncated");
+        return UP();
+    }
+
+    llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> directory_map;
+    llvm::ArrayRef<MinidumpDirectory> directory (
+        reinterpret_cast<const MinidumpDirectory *>(file_data.data() + directory_rva), stream_count);
+    for (const MinidumpDirectory &entry : directory)
+    {
+        // Unused entries are padding, a stream type can only occur once.
+        const uint32_t stream_type = entry.stream_type;
+        if (stream_type == MINIDUMP_STREAM_UNUSED)
+            continue;
+        const uint64_t stream_end = (uint64_t)entry.location.rva + entry.location.data_size;
+        if (stream_end > file_data.size())
+            continue;
+        directory_map.insert(std::make_pair(stream_type, entry.location));
+    }
+
+    return UP(new MinidumpParser(data_sp, std::move(directory_map)));
+}
+
+bool
+MinidumpParser::IsMinidump (const lldb::DataBufferSP &data_sp)
+{
+    if (!data_sp || data_sp->GetByteSize() < sizeof(MinidumpHeader))
+        return false;
+    const MinidumpHeader *header = reinterpret_cast<const MinidumpHeader *>(data_sp->GetBytes());
+
+    // The high 16 bits of the version are implementation specific.
+    return header->signature == MINIDUMP_SIGNATURE && (header->version & 0xffff) == MINIDUMP_VERSION;
+}
+
+MinidumpParser::MinidumpParser (const lldb::DataBufferSP &data_sp,
+                                llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> &&directory_map) :
+    m_data_sp (data_sp),
+    m_directory_map (std::move(directory_map)),
+    m_memory_ranges (),
+    m_memory_ranges_indexed (false)
+{
+}
+
+llvm::ArrayRef<uint8_t>
+MinidumpParser::GetData () const
+{
+    return llvm::ArrayRef<uint8_t>(m_data_sp->GetBytes(), m_data_sp->GetByteSize());
+}
+
+llvm::ArrayRef<uint8_t>
+MinidumpParser::GetLocation (const MinidumpLocationDescriptor &location) const
+{
+    const uint64_t end = (uint64_t)location.rva + location.data_size;
+    if (end > m_data_sp->GetByteSize())
+        return llvm::ArrayRef<uint8_t>();
+    return GetData().slice(location.rva, location.data_size);
+}
+
+llvm::ArrayRef<uint8_t>
+MinidumpParser::GetStream (MinidumpStreamType stream_type) const
+{
+    auto pos = m_directory_map.find(stream_type);
+    if (pos == m_directory_map.end())
+        return llvm::ArrayRef<uint8_t>();
+    return GetLocation(pos->second);
+}
+
+llvm::ArrayRef<MinidumpThread>
+MinidumpParser::GetThreads () const
+{
+    return ParseList<MinidumpThread>(GetStream(MINIDUMP_STREAM_THREAD_LIST));
+}
+
+llvm::ArrayRef<uint8_t>
+MinidumpParser::GetThreadContext (const MinidumpThread &thread) const
+{
+    return GetLocation(thread.thread_context);
+}
+
+llvm::ArrayRef<MinidumpModule>
+MinidumpParser::GetModuleList () const
+{
+    return ParseList<MinidumpModule>(GetStream(MINIDUMP_STREAM_MODULE_LIST));
+}
+
+std::string
+MinidumpParser::GetModuleName (const MinidumpModule &module) const
+{
+    std::string name;
+    ParseMinidumpString(GetData(), module.module_name_rva, name);
+    return name;
+}
+
+UUID
+MinidumpParser::GetModuleUUID (const MinidumpModule &module) const
+{
+    UUID uuid;
+    llvm::ArrayRef<uint8_t> cv_record = GetLocation(module.cv_record);
+    const md_u32 *signature = ConsumeObject<md_u32>(cv_record);
+    if (signature == nullptr)
+        return uuid;
+
+    if (*signature == MINIDUMP_CV_SIGNATURE_PDB70)
+    {
+        // The GUID of the PDB followed by its age
+        if (cv_record.size() >= 20)
+            uuid.SetBytes(cv_record.data(), 20);
+    }
+    else if (*signature == MINIDUMP_CV_SIGNATURE_ELF_BUILD_ID)
+    {
+        // The rest of the record is the build ID, which is usually a 20
+        // byte SHA-1.
+        if (cv_record.size() >= 20)
+            uuid.SetBytes(cv_record.data(), 20);
+        else if (cv_record.size() >= 16)
+            uuid.SetBytes(cv_record.data(), 16);
+    }
+    return uuid;
+}
+
+const MinidumpSystemInfo *
+MinidumpParser::GetSystemInfo () const
+{
+    llvm::ArrayRef<uint8_t> data = GetStream(MINIDUMP_STREAM_SYSTEM_INFO);
+    return ConsumeObject<MinidumpSystemInfo>(data);
+}
+
+ArchSpec
+MinidumpParser::GetArchitecture () const
+{
+    const MinidumpSystemInfo *system_info = GetSystemInfo();
+    if (system_info == nullptr)
+        return ArchSpec();
+
+    llvm::Triple triple;
+    triple.setVendor(llvm::Triple::UnknownVendor);
+    switch (system_info->processor_arch)
+    {
+        case MINIDUMP_CPU_ARCHITECTURE_X86:
+            triple.setArch(llvm::Triple::x86);
+            break;
+        case MINIDUMP_CPU_ARCHITECTURE_AMD64:
+            triple.setArch(llvm::Triple::x86_64);
+            break;
+        case MINIDUMP_CPU_ARCHITECTURE_ARM:
+            triple.setArch(llvm::Triple::arm);
+            break;
+        case MINIDUMP_CPU_ARCHITECTURE_ARM64:
+            triple.setArch(llvm::Triple::aarch64);
+            break;
+        default:
+            triple.setArch(llvm::Triple::UnknownArch);
+            break;
+    }
+
+    switch (system_info->platform_id)
+    {
+        case MINIDUMP_OS_WIN32_NT:
+            triple.setVendor(llvm::Triple::PC);
+            triple.setOS(llvm::Triple::Win32);
+            break;
+        case MINIDUMP_OS_LINUX:
+            triple.setOS(llvm::Triple::Linux);
+            break;
+        case MINIDUMP_OS_ANDROID:
+            triple.setOS(llvm::Triple::Linux);
+            triple.setEnvironment(llvm::Triple::Android);
+            break;
+        case MINIDUMP_OS_MAC_OS_X:
+            triple.setVendor(llvm::Triple::Apple);
+            triple.setOS(llvm::Triple::MacOSX);
+            break;
+        case MINIDUMP_OS_IOS:
+            triple.setVendor(llvm::Triple::Apple);
+            triple.setOS(llvm::Triple::IOS);
+            break;
+        default:
+            triple.setOS(llvm::Triple::UnknownOS);
+            break;
+    }
+    return ArchSpec(triple);
+}
+
+const MinidumpExceptionStream *
+MinidumpParser::GetExceptionStream () const
+{
+    llvm::ArrayRef<uint8_t> data = GetStream(MINIDUMP_STREAM_EXCEPTION);
+    return ConsumeObject<MinidumpExceptionStream>(data);
+}
+
+lldb::pid_t
+MinidumpParser::GetPid () const
+{
+    llvm::ArrayRef<uint8_t> misc_info_data = GetStream(MINIDUMP_STREAM_MISC_INFO);
+    const MinidumpMiscInfo *misc_info = ConsumeObject<MinidumpMiscInfo>(misc_info_data);
+    if (misc_info && (misc_info->flags1 & MINIDUMP_MISC1_PROCESS_ID))
+        return misc_info->process_id;
+
+    // Breakpad saves the /proc/<pid>/status file of the process.
+    llvm::ArrayRef<uint8_t> proc_status = GetStream(MINIDUMP_STREAM_LINUX_PROC_STATUS);
+    llvm::StringRef status (reinterpret_cast<const char *>(proc_status.data()), proc_status.size());
+    while (!status.empty())
+    {
+        std::pair<llvm::StringRef, llvm::StringRef> line_and_rest = status.split('\n');
+        llvm::StringRef line = line_and_rest.first;
+        if (line.startswith("Pid:"))
+        {
+            lldb::pid_t pid;
+            if (!line.drop_front(4).trim().getAsInteger(10, pid))
+                return pid;
+        }
+        status = line_and_rest.second;
+    }
+    return LLDB_INVALID_PROCESS_ID;
+}
+
+void
+MinidumpParser::BuildMemoryRangeIndex ()
+{
+    m_memory_ranges_indexed = true;
+
+    const uint8_t *file_bytes = m_data_sp->GetBytes();
+    for (const MinidumpMemoryDescriptor &descriptor : ParseList<MinidumpMemoryDescriptor>(GetStream(MINIDUMP_STREAM_MEMORY_LIST)))
+    {
+        llvm::ArrayRef<uint8_t> range_data = GetLocation(descriptor.memory);
+        if (range_data.empty())
+            continue;
+        m_memory_ranges.Append(MemoryRangeIndex::Entry(descriptor.start_of_memory_range, range_data.size(),
+                                                       range_data.data()));
+    }
+
+    // Full memory dumps store all of the memory in a Memory64List, the
+    // ranges follow each other from one base RVA.
+    llvm::ArrayRef<uint8_t> memory64_data = GetStream(MINIDUMP_STREAM_MEMORY64_LIST);
+    const md_u64 *count = ConsumeObject<md_u64>(memory64_data);
+    const md_u64 *base_rva = ConsumeObject<md_u64>(memory64_data);
+    if (count && base_rva && *count <= memory64_data.size() / sizeof(MinidumpMemoryDescriptor64))
+    {
+        const MinidumpMemoryDescriptor64 *descriptors =
+            reinterpret_cast<const MinidumpMemoryDescriptor64 *>(memory64_data.data());
+        uint64_t rva = *base_rva;
+        for (uint64_t i = 0; i < *count; ++i)
+        {
+            const uint64_t size = descriptors[i].data_size;
+            if (rva + size < rva || rva + size > m_data_sp->GetByteSize())
+                break;
+            if (size > 0)
+                m_memory_ranges.Append(MemoryRangeIndex::Entry(descriptors[i].start_of_memory_range, size,
+                                                               file_bytes + rva));
+            rva += size;
+        }
+    }
+
+    m_memory_ranges.Sort();
+}
+
+bool
+MinidumpParser::FindMemoryRange (lldb::addr_t addr, MemoryRange &range)
+{
+    if (!m_memory_ranges_indexed)
+        BuildMemoryRangeIndex();
+
+    const MemoryRangeIndex::Entry *entry = m_memory_ranges.FindEntryThatContains(addr);
+    if (entry == nullptr)
+        return false;
+    range.start = entry->GetRangeBase();
+    range.data = llvm::ArrayRef<uint8_t>(entry->data, entry->GetByteSize());
+    return true;
+}
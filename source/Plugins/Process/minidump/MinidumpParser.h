@@ -0,0 +1,140 @@
+//===-- MinidumpParser.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_MinidumpParser_h_
+#define liblldb_MinidumpParser_h_
+
+// C Includes
+// C++ Includes
+#include <memory>
+#include <string>
+
+// Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/DenseMap.h"
+
+// Project includes
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/RangeMap.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/lldb-types.h"
+
+#include "MinidumpTypes.h"
+
+namespace lldb_private {
+namespace minidump {
+
+    //------------------------------------------------------------------
+    /// @class MinidumpParser
+    /// @brief Finds the streams of a minidump file.
+    ///
+    /// The parser works on top of the data of the whole file, usually a
+    /// memory mapping of it. Streams, lists and memory ranges are handed
+    /// out as pointers into that data, nothing is copied.
+    //------------------------------------------------------------------
+    class MinidumpParser
+    {
+    public:
+        typedef std::unique_ptr<MinidumpParser> UP;
+
+        // A range of the process memory captured in the minidump.
+        struct MemoryRange
+        {
+            lldb::addr_t start;
+            llvm::ArrayRef<uint8_t> data;
+        };
+
+        //------------------------------------------------------------------
+        /// Check the header and read the stream directory.
+        ///
+        /// @param[in] data_sp
+        ///     The contents of the minidump file. The parser keeps a
+        ///     reference to it.
+        //------------------------------------------------------------------
+        static UP
+        Create (const lldb::DataBufferSP &data_sp, Error &error);
+
+        // Check whether the data starts with a minidump header.
+        static bool
+        IsMinidump (const lldb::DataBufferSP &data_sp);
+
+        llvm::ArrayRef<uint8_t>
+        GetData () const;
+
+        llvm::ArrayRef<uint8_t>
+        GetStream (MinidumpStreamType stream_type) const;
+
+        llvm::ArrayRef<MinidumpThread>
+        GetThreads () const;
+
+        llvm::ArrayRef<uint8_t>
+        GetThreadContext (const MinidumpThread &thread) const;
+
+        llvm::ArrayRef<MinidumpModule>
+        GetModuleList () const;
+
+        std::string
+        GetModuleName (const MinidumpModule &module) const;
+
+        // The GUID and age of the PDB of Windows modules or the build ID of
+        // ELF modules.
+        UUID
+        GetModuleUUID (const MinidumpModule &module) const;
+
+        const MinidumpSystemInfo *
+        GetSystemInfo () const;
+
+        ArchSpec
+        GetArchitecture () const;
+
+        const MinidumpExceptionStream *
+        GetExceptionStream () const;
+
+        // The process ID from the misc info stream of Windows minidumps or
+        // the /proc status stream of Breakpad minidumps.
+        lldb::pid_t
+        GetPid () const;
+
+        //------------------------------------------------------------------
+        /// Find the captured memory that contains an address.
+        ///
+        /// The ranges of the MemoryList and Memory64List streams are sorted
+        /// into an index the first time memory is looked up.
+        ///
+        /// @return
+        ///     False if no range contains \a addr.
+        //------------------------------------------------------------------
+        bool
+        FindMemoryRange (lldb::addr_t addr, MemoryRange &range);
+
+    private:
+        MinidumpParser (const lldb::DataBufferSP &data_sp,
+                        llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> &&directory_map);
+
+        void
+        BuildMemoryRangeIndex ();
+
+        llvm::ArrayRef<uint8_t>
+        GetLocation (const MinidumpLocationDescriptor &location) const;
+
+        typedef RangeDataVector<lldb::addr_t, lldb::addr_t, const uint8_t *> MemoryRangeIndex;
+
+        lldb::DataBufferSP m_data_sp;
+        llvm::DenseMap<uint32_t, MinidumpLocationDescriptor> m_directory_map;
+        MemoryRangeIndex m_memory_ranges;
+        bool m_memory_ranges_indexed;
+
+        DISALLOW_COPY_AND_ASSIGN (MinidumpParser);
+    };
+
+} // namespace minidump
+} // namespace lldb_private
+
+#endif // liblldb_MinidumpParser_h_
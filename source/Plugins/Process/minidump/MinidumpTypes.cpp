@@ -0,0 +1,42 @@
+//===-- MinidumpTypes.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MinidumpTypes.h"
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/Support/ConvertUTF.h"
+
+using namespace lldb_private;
+using namespace lldb_private::minidump;
+
+bool
+lldb_private::minidump::ParseMinidumpString (llvm::ArrayRef<uint8_t> file_data, uint32_t rva, std::string &str)
+{
+    str.clear();
+    if (rva >= file_data.size())
+        return false;
+
+    // The length is in bytes and doesn't include a terminator.
+    llvm::ArrayRef<uint8_t> data = file_data.drop_front(rva);
+    const md_u32 *length = ConsumeObject<md_u32>(data);
+    if (length == nullptr || *length % 2 != 0 || *length > data.size())
+        return false;
+
+    // The characters are little endian, the conversion wants them in host
+    // order.
+    const md_u16 *chars = reinterpret_cast<const md_u16 *>(data.data());
+    std::vector<uint16_t> utf16 (chars, chars + *length / 2);
+    return llvm::convertUTF16ToUTF8String (llvm::ArrayRef<char>(reinterpret_cast<const char *>(utf16.data()),
+                                                                 utf16.size() * 2),
+                                           str);
+}
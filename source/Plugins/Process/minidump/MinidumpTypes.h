@@ -0,0 +1,273 @@
+//===-- MinidumpTypes.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_MinidumpTypes_h_
+#define liblldb_MinidumpTypes_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+
+// Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/Endian.h"
+
+// The minidump format is documented in the Windows SDK (minidumpapiset.h)
+// and, for the streams added by Breakpad, in Breakpad's
+// minidump_format.h. All the fields are little endian and the structures
+// have no padding, the types below can be used on top of the mapped file
+// on any host.
+
+namespace lldb_private {
+namespace minidump {
+
+    typedef llvm::support::ulittle16_t md_u16;
+    typedef llvm::support::ulittle32_t md_u32;
+    typedef llvm::support::ulittle64_t md_u64;
+
+    enum
+    {
+        MINIDUMP_SIGNATURE = 0x504d444d, // 'MDMP'
+        MINIDUMP_VERSION = 0x0000a793
+    };
+
+    enum MinidumpStreamType
+    {
+        MINIDUMP_STREAM_UNUSED = 0,
+        MINIDUMP_STREAM_THREAD_LIST = 3,
+        MINIDUMP_STREAM_MODULE_LIST = 4,
+        MINIDUMP_STREAM_MEMORY_LIST = 5,
+        MINIDUMP_STREAM_EXCEPTION = 6,
+        MINIDUMP_STREAM_SYSTEM_INFO = 7,
+        MINIDUMP_STREAM_MEMORY64_LIST = 9,
+        MINIDUMP_STREAM_MISC_INFO = 15,
+        MINIDUMP_STREAM_MEMORY_INFO_LIST = 16,
+
+        // Breakpad extensions
+        MINIDUMP_STREAM_LINUX_PROC_STATUS = 0x47670003, // /proc/$x/status
+        MINIDUMP_STREAM_LINUX_MAPS = 0x47670009         // /proc/$x/maps
+    };
+
+    enum MinidumpCPUArchitecture
+    {
+        MINIDUMP_CPU_ARCHITECTURE_X86 = 0,
+        MINIDUMP_CPU_ARCHITECTURE_MIPS = 1,
+        MINIDUMP_CPU_ARCHITECTURE_PPC = 3,
+        MINIDUMP_CPU_ARCHITECTURE_ARM = 5,
+        MINIDUMP_CPU_ARCHITECTURE_AMD64 = 9,
+        MINIDUMP_CPU_ARCHITECTURE_ARM64 = 12,
+        MINIDUMP_CPU_ARCHITECTURE_UNKNOWN = 0xffff
+    };
+
+    enum MinidumpOSPlatform
+    {
+        MINIDUMP_OS_WIN32_NT = 2,
+        MINIDUMP_OS_MAC_OS_X = 0x8101,
+        MINIDUMP_OS_IOS = 0x8102,
+        MINIDUMP_OS_LINUX = 0x8201,
+        MINIDUMP_OS_SOLARIS = 0x8202,
+        MINIDUMP_OS_ANDROID = 0x8203
+    };
+
+    enum MinidumpMiscInfoFlags
+    {
+        MINIDUMP_MISC1_PROCESS_ID = 0x00000001
+    };
+
+    // The code view record signatures of the module build ids
+    enum MinidumpCodeViewSignature
+    {
+        MINIDUMP_CV_SIGNATURE_PDB70 = 0x53445352, // 'RSDS'
+        MINIDUMP_CV_SIGNATURE_ELF_BUILD_ID = 0x4270454c // 'BpEL'
+    };
+
+    struct MinidumpHeader
+    {
+        md_u32 signature;
+        md_u32 version;
+        md_u32 stream_count;
+        md_u32 stream_directory_rva; // offset of the MinidumpDirectory array
+        md_u32 checksum;
+        md_u32 time_date_stamp;
+        md_u64 flags;
+    };
+    static_assert(sizeof(MinidumpHeader) == 32, "sizeof MinidumpHeader is not correct!");
+
+    struct MinidumpLocationDescriptor
+    {
+        md_u32 data_size;
+        md_u32 rva;
+    };
+    static_assert(sizeof(MinidumpLocationDescriptor) == 8, "sizeof MinidumpLocationDescriptor is not correct!");
+
+    struct MinidumpMemoryDescriptor
+    {
+        md_u64 start_of_memory_range;
+        MinidumpLocationDescriptor memory;
+    };
+    static_assert(sizeof(MinidumpMemoryDescriptor) == 16, "sizeof MinidumpMemoryDescriptor is not correct!");
+
+    // The ranges of a Memory64List are stored back to back starting at
+    // base_rva.
+    struct MinidumpMemoryDescriptor64
+    {
+        md_u64 start_of_memory_range;
+        md_u64 data_size;
+    };
+    static_assert(sizeof(MinidumpMemoryDescriptor64) == 16, "sizeof MinidumpMemoryDescriptor64 is not correct!");
+
+    struct MinidumpDirectory
+    {
+        md_u32 stream_type;
+        MinidumpLocationDescriptor location;
+    };
+    static_assert(sizeof(MinidumpDirectory) == 12, "sizeof MinidumpDirectory is not correct!");
+
+    struct MinidumpThread
+    {
+        md_u32 thread_id;
+        md_u32 suspend_count;
+        md_u32 priority_class;
+        md_u32 priority;
+        md_u64 teb;
+        MinidumpMemoryDescriptor stack;
+        MinidumpLocationDescriptor thread_context;
+    };
+    static_assert(sizeof(MinidumpThread) == 48, "sizeof MinidumpThread is not correct!");
+
+    struct MinidumpVSFixedFileInfo
+    {
+        md_u32 signature;
+        md_u32 struct_version;
+        md_u32 file_version_hi;
+        md_u32 file_version_lo;
+        md_u32 product_version_hi;
+        md_u32 product_version_lo;
+        md_u32 file_flags_mask;
+        md_u32 file_flags;
+        md_u32 file_os;
+        md_u32 file_type;
+        md_u32 file_subtype;
+        md_u32 file_date_hi;
+        md_u32 file_date_lo;
+    };
+    static_assert(sizeof(MinidumpVSFixedFileInfo) == 52, "sizeof MinidumpVSFixedFileInfo is not correct!");
+
+    struct MinidumpModule
+    {
+        md_u64 base_of_image;
+        md_u32 size_of_image;
+        md_u32 checksum;
+        md_u32 time_date_stamp;
+        md_u32 module_name_rva; // a MinidumpString
+        MinidumpVSFixedFileInfo version_info;
+        MinidumpLocationDescriptor cv_record;
+        MinidumpLocationDescriptor misc_record;
+        md_u32 reserved0[2];
+        md_u32 reserved1[2];
+    };
+    static_assert(sizeof(MinidumpModule) == 108, "sizeof MinidumpModule is not correct!");
+
+    struct MinidumpSystemInfo
+    {
+        md_u16 processor_arch;
+        md_u16 processor_level;
+        md_u16 processor_revision;
+        uint8_t number_of_processors;
+        uint8_t product_type;
+        md_u32 major_version;
+        md_u32 minor_version;
+        md_u32 build_number;
+        md_u32 platform_id;
+        md_u32 csd_version_rva;
+        md_u16 suite_mask;
+        md_u16 reserved2;
+        uint8_t cpu[24];
+    };
+    static_assert(sizeof(MinidumpSystemInfo) == 56, "sizeof MinidumpSystemInfo is not correct!");
+
+    struct MinidumpException
+    {
+        enum
+        {
+            MaxParams = 15
+        };
+
+        md_u32 exception_code; // the signal number on POSIX systems
+        md_u32 exception_flags;
+        md_u64 exception_record;
+        md_u64 exception_address;
+        md_u32 number_parameters;
+        md_u32 unused_alignment;
+        md_u64 exception_information[MaxParams];
+    };
+    static_assert(sizeof(MinidumpException) == 152, "sizeof MinidumpException is not correct!");
+
+    struct MinidumpExceptionStream
+    {
+        md_u32 thread_id;
+        md_u32 alignment;
+        MinidumpException exception_record;
+        MinidumpLocationDescriptor thread_context;
+    };
+    static_assert(sizeof(MinidumpExceptionStream) == 168, "sizeof MinidumpExceptionStream is not correct!");
+
+    // Only the fields of the first version of MINIDUMP_MISC_INFO, later
+    // versions append to it.
+    struct MinidumpMiscInfo
+    {
+        md_u32 size;
+        md_u32 flags1;
+        md_u32 process_id;
+        md_u32 process_create_time;
+        md_u32 process_user_time;
+        md_u32 process_kernel_time;
+    };
+    static_assert(sizeof(MinidumpMiscInfo) == 24, "sizeof MinidumpMiscInfo is not correct!");
+
+    //------------------------------------------------------------------
+    // Helpers to get the structures out of the mapped file. They return
+    // nullptr or an empty array if the data is too small, and otherwise
+    // point into the data without copying it.
+    //------------------------------------------------------------------
+    template <typename T>
+    const T *
+    ConsumeObject (llvm::ArrayRef<uint8_t> &data)
+    {
+        if (data.size() < sizeof(T))
+            return nullptr;
+        const T *object = reinterpret_cast<const T *>(data.data());
+        data = data.drop_front(sizeof(T));
+        return object;
+    }
+
+    // A 32 bit count followed by that many entries, the layout of the
+    // thread, module and memory lists.
+    template <typename T>
+    llvm::ArrayRef<T>
+    ParseList (llvm::ArrayRef<uint8_t> data)
+    {
+        const md_u32 *count = ConsumeObject<md_u32>(data);
+        if (count == nullptr || *count > data.size() / sizeof(T))
+            return llvm::ArrayRef<T>();
+
+        // Some writers align the entries to 8 bytes after the count.
+        if (data.size() == *count * sizeof(T) + 4)
+            data = data.drop_front(4);
+        return llvm::ArrayRef<T>(reinterpret_cast<const T *>(data.data()), *count);
+    }
+
+    // Decode the UTF-16 MinidumpString at rva in the file.
+    bool
+    ParseMinidumpString (llvm::ArrayRef<uint8_t> file_data, uint32_t rva, std::string &str);
+
+} // namespace minidump
+} // namespace lldb_private
+
+#endif // liblldb_MinidumpTypes_h_
@@ -0,0 +1,294 @@
+//===-- ProcessMinidump.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <mutex>
+
+// Other libraries and framework includes
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Core/PluginManager.h"
+#include "lldb/Core/State.h"
+#include "lldb/Target/MemoryRegionInfo.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/UnixSignals.h"
+
+#include "llvm/Support/Format.h"
+#include "llvm/Support/raw_ostream.h"
+
+// Project includes
+#include "ProcessMinidump.h"
+#include "ThreadMinidump.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::minidump;
+
+ConstString
+ProcessMinidump::GetPluginNameStatic()
+{
+    static ConstString g_name("minidump");
+    return g_name;
+}
+
+const char *
+ProcessMinidump::GetPluginDescriptionStatic()
+{
+    return "Minidump plug-in.";
+}
+
+lldb::ProcessSP
+ProcessMinidump::CreateInstance (lldb::TargetSP target_sp, lldb::ListenerSP listener_sp, const FileSpec *crash_file)
+{
+    lldb::ProcessSP process_sp;
+    if (crash_file == nullptr)
+        return process_sp;
+
+    // Check the header before mapping the whole file
+    lldb::DataBufferSP header_sp (crash_file->ReadFileContents(0, sizeof(MinidumpHeader)));
+    if (!MinidumpParser::IsMinidump(header_sp))
+        return process_sp;
+
+    lldb::DataBufferSP data_sp (crash_file->MemoryMapFileContents());
+    Error error;
+    MinidumpParser::UP parser_up = MinidumpParser::Create(data_sp, error);
+    if (!parser_up)
+    {
+        Log *log (GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
+        if (log)
+            log->Printf ("ProcessMinidump::%s failed to parse %s: %s", __FUNCTION__,
+                         crash_file->GetPath().c_str(), error.AsCString());
+        return process_sp;
+    }
+
+    process_sp.reset(new ProcessMinidump (target_sp, listener_sp, *crash_file, std::move(parser_up)));
+    return process_sp;
+}
+
+bool
+ProcessMinidump::CanDebug (lldb::TargetSP target_sp, bool plugin_specified_by_name)
+{
+    return true;
+}
+
+ProcessMinidump::ProcessMinidump (lldb::TargetSP target_sp, lldb::ListenerSP listener_sp,
+                                  const FileSpec &core_file, MinidumpParser::UP parser_up) :
+    Process (target_sp, listener_sp),
+    m_core_file (core_file),
+    m_parser_up (std::move(parser_up)),
+    m_thread_list_entries (),
+    m_active_exception (nullptr)
+{
+}
+
+ProcessMinidump::~ProcessMinidump()
+{
+    Clear();
+    // We need to call finalize on the process before destroying ourselves
+    // to make sure all of the broadcaster cleanup goes as planned. If we
+    // destruct this class, then Process::~Process() might have problems
+    // trying to fully destroy the broadcaster.
+    Finalize();
+}
+
+void
+ProcessMinidump::Initialize()
+{
+    static std::once_flag g_once_flag;
+
+    std::call_once(g_once_flag, []()
+    {
+        PluginManager::RegisterPlugin (GetPluginNameStatic(),
+          GetPluginDescriptionStatic(), CreateInstance);
+    });
+}
+
+void
+ProcessMinidump::Terminate()
+{
+    PluginManager::UnregisterPlugin (ProcessMinidump::CreateInstance);
+}
+
+Error
+ProcessMinidump::DoLoadCore()
+{
+    Error error;
+
+    ArchSpec arch = m_parser_up->GetArchitecture();
+    if (!arch.IsValid())
+    {
+        error.SetErrorString ("the minidump has no valid system info stream");
+        return error;
+    }
+    GetTarget().SetArchitecture(arch);
+    SetUnixSignals(UnixSignals::Create(arch));
+    SetCanJIT(false);
+
+    m_thread_list_entries = m_parser_up->GetThreads();
+    m_active_exception = m_parser_up->GetExceptionStream();
+
+    const lldb::pid_t pid = m_parser_up->GetPid();
+    if (pid != LLDB_INVALID_PROCESS_ID)
+        SetID(pid);
+
+    ReadModuleList();
+    return error;
+}
+
+ConstString
+ProcessMinidump::GetPluginName()
+{
+    return GetPluginNameStatic();
+}
+
+uint32_t
+ProcessMinidump::GetPluginVersion()
+{
+    return 1;
+}
+
+Error
+ProcessMinidump::DoDestroy()
+{
+    return Error();
+}
+
+void
+ProcessMinidump::RefreshStateAfterStop()
+{
+    if (m_active_exception == nullptr)
+        return;
+
+    const uint32_t exception_code = m_active_exception->exception_record.exception_code;
+    m_thread_list.SetSelectedThreadByID(m_active_exception->thread_id);
+    lldb::ThreadSP stop_thread = m_thread_list.GetSelectedThread();
+    if (!stop_thread)
+        return;
+
+    // Breakpad stores the signal in the exception code of POSIX processes.
+    StopInfoSP stop_info;
+    if (GetArchitecture().GetTriple().getOS() == llvm::Triple::Win32)
+    {
+        std::string desc;
+        llvm::raw_string_ostream desc_stream(desc);
+        desc_stream << "Exception " << llvm::format_hex(exception_code, 8) << " encountered at address "
+                    << llvm::format_hex(m_active_exception->exception_record.exception_address, 8);
+        stop_info = StopInfo::CreateStopReasonWithException(*stop_thread, desc_stream.str().c_str());
+    }
+    else
+    {
+        stop_info = StopInfo::CreateStopReasonWithSignal(*stop_thread, exception_code);
+    }
+    stop_thread->SetStopInfo(stop_info);
+}
+
+bool
+ProcessMinidump::IsAlive()
+{
+    return true;
+}
+
+size_t
+ProcessMinidump::ReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &error)
+{
+    // The memory is already mapped, there is no point in going through the
+    // memory cache of Process::ReadMemory.
+    return DoReadMemory (addr, buf, size, error);
+}
+
+size_t
+ProcessMinidump::DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &error)
+{
+    MinidumpParser::MemoryRange range;
+    if (!m_parser_up->FindMemoryRange(addr, range))
+    {
+        error.SetErrorStringWithFormat ("minidump does not contain 0x%" PRIx64, addr);
+        return 0;
+    }
+
+    // The read may be truncated at the end of the range
+    const size_t offset = addr - range.start;
+    const size_t bytes_read = std::min(size, range.data.size() - offset);
+    ::memcpy(buf, range.data.data() + offset, bytes_read);
+    return bytes_read;
+}
+
+Error
+ProcessMinidump::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
+{
+    Error error;
+    MinidumpParser::MemoryRange range;
+    if (!m_parser_up->FindMemoryRange(load_addr, range))
+    {
+        error.SetErrorString("address is not in a known range");
+        return error;
+    }
+
+    // Only the captured memory is known, the dump doesn't say whether it
+    // was writable or executable.
+    range_info.Clear();
+    range_info.GetRange().SetRangeBase(range.start);
+    range_info.GetRange().SetByteSize(range.data.size());
+    range_info.SetReadable(MemoryRegionInfo::eYes);
+    return error;
+}
+
+ArchSpec
+ProcessMinidump::GetArchitecture()
+{
+    return GetTarget().GetArchitecture();
+}
+
+void
+ProcessMinidump::Clear()
+{
+    m_thread_list.Clear();
+}
+
+bool
+ProcessMinidump::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new_thread_list)
+{
+    // Only the thread objects are created here, their register contexts are
+    // decoded when a thread is first asked for them.
+    for (const MinidumpThread &thread : m_thread_list_entries)
+    {
+        lldb::ThreadSP thread_sp(new ThreadMinidump (*this, thread, m_parser_up->GetThreadContext(thread)));
+        new_thread_list.AddThread (thread_sp);
+    }
+    return new_thread_list.GetSize(false) > 0;
+}
+
+void
+ProcessMinidump::ReadModuleList()
+{
+    const ArchSpec &arch = GetTarget().GetArchitecture();
+    for (const MinidumpModule &module : m_parser_up->GetModuleList())
+    {
+        std::string name = m_parser_up->GetModuleName(module);
+        if (name.empty())
+            continue;
+
+        ModuleSpec module_spec (FileSpec(name.c_str(), true), arch);
+        module_spec.GetUUID() = m_parser_up->GetModuleUUID(module);
+
+        lldb::ModuleSP module_sp = GetTarget().GetSharedModule(module_spec);
+        if (!module_sp)
+            continue;
+
+        bool load_addr_changed = false;
+        module_sp->SetLoadAddress(GetTarget(), module.base_of_image, false, load_addr_changed);
+    }
+}
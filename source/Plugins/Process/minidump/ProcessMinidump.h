@@ -0,0 +1,108 @@
+//===-- ProcessMinidump.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ProcessMinidump_h_
+#define liblldb_ProcessMinidump_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Target/Process.h"
+
+#include "MinidumpParser.h"
+
+namespace lldb_private {
+namespace minidump {
+
+    //------------------------------------------------------------------
+    /// @class ProcessMinidump
+    /// @brief A process for Windows and Breakpad minidump files.
+    ///
+    /// Unlike ProcessWinMiniDump this doesn't need dbghelp, the file is
+    /// memory mapped and parsed directly so it works on every host.
+    //------------------------------------------------------------------
+    class ProcessMinidump : public Process
+    {
+    public:
+        static lldb::ProcessSP
+        CreateInstance (lldb::TargetSP target_sp,
+                        lldb::ListenerSP listener_sp,
+                        const FileSpec *crash_file_path);
+
+        static void
+        Initialize();
+
+        static void
+        Terminate();
+
+        static ConstString
+        GetPluginNameStatic();
+
+        static const char *
+        GetPluginDescriptionStatic();
+
+        ProcessMinidump (lldb::TargetSP target_sp,
+                         lldb::ListenerSP listener_sp,
+                         const FileSpec &core_file,
+                         MinidumpParser::UP parser_up);
+
+        ~ProcessMinidump() override;
+
+        bool CanDebug(lldb::TargetSP target_sp, bool plugin_specified_by_name) override;
+
+        Error DoLoadCore() override;
+
+        DynamicLoader *GetDynamicLoader() override { return nullptr; }
+
+        ConstString GetPluginName() override;
+
+        uint32_t GetPluginVersion() override;
+
+        Error DoDestroy() override;
+
+        void RefreshStateAfterStop() override;
+
+        bool IsAlive() override;
+
+        bool IsLiveDebugSession() const override { return false; }
+
+        size_t ReadMemory(lldb::addr_t addr, void *buf, size_t size, Error &error) override;
+
+        size_t DoReadMemory(lldb::addr_t addr, void *buf, size_t size, Error &error) override;
+
+        Error GetMemoryRegionInfo(lldb::addr_t load_addr, MemoryRegionInfo &range_info) override;
+
+        ArchSpec
+        GetArchitecture();
+
+    protected:
+        void
+        Clear();
+
+        bool UpdateThreadList(ThreadList &old_thread_list, ThreadList &new_thread_list) override;
+
+        void
+        ReadModuleList();
+
+    private:
+        FileSpec m_core_file;
+        MinidumpParser::UP m_parser_up;
+        llvm::ArrayRef<MinidumpThread> m_thread_list_entries;
+        const MinidumpExceptionStream *m_active_exception;
+
+        DISALLOW_COPY_AND_ASSIGN (ProcessMinidump);
+    };
+
+} // namespace minidump
+} // namespace lldb_private
+
+#endif // liblldb_ProcessMinidump_h_
@@ -0,0 +1,113 @@
+//===-- RegisterContextMinidump_x86_64.cpp ----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "RegisterContextMinidump_x86_64.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+// Other libraries and framework includes
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Endian.h"
+
+// Project includes
+#include "lldb/Core/DataBufferHeap.h"
+#include "Plugins/Process/Utility/lldb-x86-register-enums.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::minidump;
+
+namespace
+{
+    // Offsets of the registers in the AMD64 CONTEXT structure
+    enum
+    {
+        CONTEXT_FLAGS_OFFSET = 48,
+        SEGMENT_REGISTERS_OFFSET = 56,  // cs, ds, es, fs, gs, ss as 16 bit values
+        EFLAGS_OFFSET = 68,
+        INTEGER_REGISTERS_OFFSET = 120, // rax, rcx, rdx, rbx, rsp, rbp, rsi, rdi, r8-r15
+        RIP_OFFSET = 248
+    };
+
+    void
+    WriteRegister (const RegisterInfo *reg_info, uint64_t value, uint8_t *dst, size_t dst_size)
+    {
+        if (reg_info->byte_offset + reg_info->byte_size > dst_size)
+            return;
+        switch (reg_info->byte_size)
+        {
+            case 2:
+            {
+                uint16_t value16 = value;
+                memcpy (dst + reg_info->byte_offset, &value16, sizeof(value16));
+                break;
+            }
+            case 4:
+            {
+                uint32_t value32 = value;
+                memcpy (dst + reg_info->byte_offset, &value32, sizeof(value32));
+                break;
+            }
+            case 8:
+                memcpy (dst + reg_info->byte_offset, &value, sizeof(value));
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+lldb::DataBufferSP
+lldb_private::minidump::ConvertMinidumpContext_x86_64 (llvm::ArrayRef<uint8_t> source_data,
+                                                       RegisterInfoInterface *target_reg_interface)
+{
+    if (source_data.size() < RIP_OFFSET + 8)
+        return DataBufferSP();
+
+    using namespace llvm::support;
+    const uint8_t *src = source_data.data();
+    const uint32_t context_flags = endian::read<uint32_t, little, unaligned>(src + CONTEXT_FLAGS_OFFSET);
+    if ((context_flags & MINIDUMP_CONTEXT_AMD64) == 0)
+        return DataBufferSP();
+
+    const RegisterInfo *reg_info = target_reg_interface->GetRegisterInfo();
+    const size_t gpr_size = target_reg_interface->GetGPRSize();
+    DataBufferSP result_sp (new DataBufferHeap (gpr_size, 0));
+    uint8_t *dst = result_sp->GetBytes();
+
+    static const uint32_t segment_regnums[] = {
+        lldb_cs_x86_64, lldb_ds_x86_64, lldb_es_x86_64, lldb_fs_x86_64, lldb_gs_x86_64, lldb_ss_x86_64
+    };
+    for (size_t i = 0; i < llvm::array_lengthof(segment_regnums); ++i)
+        WriteRegister (&reg_info[segment_regnums[i]],
+                       endian::read<uint16_t, little, unaligned>(src + SEGMENT_REGISTERS_OFFSET + i * 2),
+                       dst, gpr_size);
+
+    WriteRegister (&reg_info[lldb_rflags_x86_64],
+                   endian::read<uint32_t, little, unaligned>(src + EFLAGS_OFFSET), dst, gpr_size);
+
+    // The integer registers are in the order of their x86 encoding.
+    static const uint32_t integer_regnums[] = {
+        lldb_rax_x86_64, lldb_rcx_x86_64, lldb_rdx_x86_64, lldb_rbx_x86_64,
+        lldb_rsp_x86_64, lldb_rbp_x86_64, lldb_rsi_x86_64, lldb_rdi_x86_64,
+        lldb_r8_x86_64,  lldb_r9_x86_64,  lldb_r10_x86_64, lldb_r11_x86_64,
+        lldb_r12_x86_64, lldb_r13_x86_64, lldb_r14_x86_64, lldb_r15_x86_64
+    };
+    for (size_t i = 0; i < llvm::array_lengthof(integer_regnums); ++i)
+        WriteRegister (&reg_info[integer_regnums[i]],
+                       endian::read<uint64_t, little, unaligned>(src + INTEGER_REGISTERS_OFFSET + i * 8),
+                       dst, gpr_size);
+
+    WriteRegister (&reg_info[lldb_rip_x86_64], endian::read<uint64_t, little, unaligned>(src + RIP_OFFSET),
+                   dst, gpr_size);
+
+    return result_sp;
+}
@@ -0,0 +1,47 @@
+//===-- RegisterContextMinidump_x86_64.h ------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_RegisterContextMinidump_x86_64_h_
+#define liblldb_RegisterContextMinidump_x86_64_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+#include "llvm/ADT/ArrayRef.h"
+
+// Project includes
+#include "lldb/lldb-types.h"
+#include "Plugins/Process/Utility/RegisterInfoInterface.h"
+
+namespace lldb_private {
+namespace minidump {
+
+    // The context_flags bit of the AMD64 CONTEXT structure, see winnt.h
+    // for its layout.
+    enum
+    {
+        MINIDUMP_CONTEXT_AMD64 = 0x00100000
+    };
+
+    //------------------------------------------------------------------
+    /// Convert the AMD64 CONTEXT of a minidump thread into the general
+    /// purpose register layout described by \a target_reg_interface.
+    ///
+    /// @return
+    ///     A buffer of GetGPRSize() bytes, or an empty shared pointer if
+    ///     \a source_data isn't an AMD64 context.
+    //------------------------------------------------------------------
+    lldb::DataBufferSP
+    ConvertMinidumpContext_x86_64 (llvm::ArrayRef<uint8_t> source_data,
+                                   RegisterInfoInterface *target_reg_interface);
+
+} // namespace minidump
+} // namespace lldb_private
+
+#endif // liblldb_RegisterContextMinidump_x86_64_h_
@@ -21,6 +21,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 
@@ -61,6 +62,7 @@ static ScriptInterpreterPython::SWIGPythonCreateSyntheticProvider g_swig_synthet
 static ScriptInterpreterPython::SWIGPythonCreateCommandObject g_swig_create_cmd = nullptr;
 static ScriptInterpreterPython::SWIGPythonCalculateNumChildren g_swig_calc_children = nullptr;
 static ScriptInterpreterPython::SWIGPythonGetChildAtIndex g_swig_get_child_index = nullptr;
+static ScriptInterpreterPython::SWIGPythonGetChildrenAtIndex g_swig_get_children_index = nullptr;
 static ScriptInterpreterPython::SWIGPythonGetIndexOfChildWithName g_swig_get_index_child = nullptr;
 static ScriptInterpreterPython::SWIGPythonCastPyObjectToSBValue g_swig_cast_to_sbvalue  = nullptr;
 static ScriptInterpreterPython::SWIGPythonGetValueObjectSPFromSBValue g_swig_get_valobj_sp_from_sbvalue = nullptr;
@@ -989,7 +991,8 @@ protected:
 void
 ScriptInterpreterPython::ExecuteInterpreterLoop ()
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, __PRETTY_FUNCTION__);
 
     Debugger &debugger = GetCommandInterpreter().GetDebugger();
 
@@ -1700,6 +1703,64 @@ ScriptInterpreterPython::OSPlugin_RegisterContextData(StructuredData::ObjectSP o
     return StructuredData::StringSP();
 }
 
+StructuredData::StringSP
+ScriptInterpreterPython::OSPlugin_AllRegisterContextData(StructuredData::ObjectSP os_plugin_object_sp)
+{
+    Locker py_lock (this,
+                    Locker::AcquireLock | Locker::NoSTDIN,
+                    Locker::FreeLock);
+
+    static char callee_name[] = "get_all_register_data";
+
+    if (!os_plugin_object_sp)
+        return StructuredData::StringSP();
+
+    StructuredData::Generic *generic = os_plugin_object_sp->GetAsGeneric();
+    if (!generic)
+        return nullptr;
+    PythonObject implementor(PyRefType::Borrowed, (PyObject *)generic->GetValue());
+
+    if (!implementor.IsAllocated())
+        return StructuredData::StringSP();
+
+    // This method is optional, plug-ins without it get get_register_data()
+    // calls for each thread instead.
+    PythonObject pmeth(PyRefType::Owned, PyObject_GetAttrString(implementor.get(), callee_name));
+
+    if (PyErr_Occurred())
+        PyErr_Clear();
+
+    if (!pmeth.IsAllocated())
+        return StructuredData::StringSP();
+
+    if (PyCallable_Check(pmeth.get()) == 0)
+    {
+        if (PyErr_Occurred())
+            PyErr_Clear();
+        return StructuredData::StringSP();
+    }
+
+    if (PyErr_Occurred())
+        PyErr_Clear();
+
+    // right now we know this function exists and is callable..
+    PythonObject py_return(PyRefType::Owned, PyObject_CallMethod(implementor.get(), callee_name, nullptr));
+
+    // if it fails, print the error but otherwise go on
+    if (PyErr_Occurred())
+    {
+        PyErr_Print();
+        PyErr_Clear();
+    }
+
+    if (py_return.get() && PythonBytes::Check(py_return.get()))
+    {
+        PythonBytes result(PyRefType::Borrowed, py_return.get());
+        return result.CreateStructuredString();
+    }
+    return StructuredData::StringSP();
+}
+
 StructuredData::DictionarySP
 ScriptInterpreterPython::OSPlugin_CreateThread(StructuredData::ObjectSP os_plugin_object_sp, lldb::tid_t tid, lldb::addr_t context)
 {
@@ -2008,7 +2069,8 @@ ScriptInterpreterPython::GetScriptedSummary(const char *python_function_name, ll
                                             std::string &retval)
 {
     
-    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, __PRETTY_FUNCTION__);
     
     if (!valobj.get())
     {
@@ -2034,7 +2096,8 @@ ScriptInterpreterPython::GetScriptedSummary(const char *python_function_name, ll
             {
                 TypeSummaryOptionsSP options_sp(new TypeSummaryOptions(options));
                 
-                Timer scoped_timer ("g_swig_typescript_callback","g_swig_typescript_callback");
+                static Timer::Category func_cat("g_swig_typescript_callback");
+                Timer scoped_timer (func_cat, "g_swig_typescript_callback");
                 ret_val = g_swig_typescript_callback (python_function_name,
                                                       GetSessionDictionary().get(),
                                                       valobj,
@@ -2241,6 +2304,48 @@ ScriptInterpreterPython::GetChildAtIndex(const StructuredData::ObjectSP &impleme
     return ret_val;
 }
 
+bool
+ScriptInterpreterPython::GetChildrenAtIndex(const StructuredData::ObjectSP &implementor_sp, uint32_t start, uint32_t count,
+                                            std::vector<lldb::ValueObjectSP> &children)
+{
+    children.clear();
+    if (!implementor_sp)
+        return false;
+
+    StructuredData::Generic *generic = implementor_sp->GetAsGeneric();
+    if (!generic)
+        return false;
+    void *implementor = generic->GetValue();
+    if (!implementor)
+        return false;
+
+    if (!g_swig_get_children_index || !g_swig_cast_to_sbvalue)
+        return false;
+
+    // Hold the lock for the whole batch, setting up the session is what
+    // makes fetching children one at a time slow.
+    Locker py_lock(this, Locker::AcquireLock | Locker::InitSession | Locker::NoSTDIN);
+    void *list_ptr = g_swig_get_children_index (implementor, start, count);
+    if (list_ptr == nullptr)
+        return false;
+
+    PythonList list(PyRefType::Owned, (PyObject *)list_ptr);
+    const uint32_t num_children = std::min(list.GetSize(), count);
+    children.reserve(num_children);
+    for (uint32_t i = 0; i < num_children; ++i)
+    {
+        PythonObject child = list.GetItemAtIndex(i);
+        lldb::SBValue *sb_value_ptr = nullptr;
+        if (child.IsAllocated() && !child.IsNone())
+            sb_value_ptr = (lldb::SBValue *)g_swig_cast_to_sbvalue(child.get());
+        if (sb_value_ptr)
+            children.push_back(g_swig_get_valobj_sp_from_sbvalue (sb_value_ptr));
+        else
+            children.push_back(lldb::ValueObjectSP());
+    }
+    return true;
+}
+
 int
 ScriptInterpreterPython::GetIndexOfChildWithName(const StructuredData::ObjectSP &implementor_sp, const char *child_name)
 {
@@ -3119,6 +3224,7 @@ ScriptInterpreterPython::InitializeInterpreter (SWIGInitCallback swig_init_callb
                                                 SWIGPythonCreateCommandObject swig_create_cmd,
                                                 SWIGPythonCalculateNumChildren swig_calc_children,
                                                 SWIGPythonGetChildAtIndex swig_get_child_index,
+                                                SWIGPythonGetChildrenAtIndex swig_get_children_index,
                                                 SWIGPythonGetIndexOfChildWithName swig_get_index_child,
                                                 SWIGPythonCastPyObjectToSBValue swig_cast_to_sbvalue ,
                                                 SWIGPythonGetValueObjectSPFromSBValue swig_get_valobj_sp_from_sbvalue,
@@ -3146,6 +3252,7 @@ ScriptInterpreterPython::InitializeInterpreter (SWIGInitCallback swig_init_callb
     g_swig_create_cmd = swig_create_cmd;
     g_swig_calc_children = swig_calc_children;
     g_swig_get_child_index = swig_get_child_index;
+    g_swig_get_children_index = swig_get_children_index;
     g_swig_get_index_child = swig_get_index_child;
     g_swig_cast_to_sbvalue = swig_cast_to_sbvalue;
     g_swig_get_valobj_sp_from_sbvalue = swig_get_valobj_sp_from_sbvalue;
@@ -3174,7 +3281,8 @@ ScriptInterpreterPython::InitializePrivate ()
 
     g_initialized = true;
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, __PRETTY_FUNCTION__);
 
     // RAII-based initialization which correctly handles multiple-initialization, version-
     // specific differences among Python 2 and Python 3, and saving and restoring various
@@ -83,6 +83,7 @@ public:
     typedef size_t          (*SWIGPythonCalculateNumChildren)                   (void *implementor, uint32_t max);
 
     typedef void*           (*SWIGPythonGetChildAtIndex)                        (void *implementor, uint32_t idx);
+    typedef void*           (*SWIGPythonGetChildrenAtIndex)                     (void *implementor, uint32_t start, uint32_t count);
 
     typedef int             (*SWIGPythonGetIndexOfChildWithName)                (void *implementor, const char* child_name);
 
@@ -208,6 +209,8 @@ public:
 
     StructuredData::StringSP OSPlugin_RegisterContextData(StructuredData::ObjectSP os_plugin_object_sp, lldb::tid_t thread_id) override;
 
+    StructuredData::StringSP OSPlugin_AllRegisterContextData(StructuredData::ObjectSP os_plugin_object_sp) override;
+
     StructuredData::DictionarySP OSPlugin_CreateThread(StructuredData::ObjectSP os_plugin_object_sp, lldb::tid_t tid,
                                                        lldb::addr_t context) override;
 
@@ -220,6 +223,9 @@ public:
 
     lldb::ValueObjectSP GetChildAtIndex(const StructuredData::ObjectSP &implementor, uint32_t idx) override;
 
+    bool GetChildrenAtIndex(const StructuredData::ObjectSP &implementor, uint32_t start, uint32_t count,
+                            std::vector<lldb::ValueObjectSP> &children) override;
+
     int GetIndexOfChildWithName(const StructuredData::ObjectSP &implementor, const char *child_name) override;
 
     bool UpdateSynthProviderInstance(const StructuredData::ObjectSP &implementor) override;
@@ -385,6 +391,7 @@ public:
                            SWIGPythonCreateCommandObject swig_create_cmd,
                            SWIGPythonCalculateNumChildren swig_calc_children,
                            SWIGPythonGetChildAtIndex swig_get_child_index,
+                           SWIGPythonGetChildrenAtIndex swig_get_children_index,
                            SWIGPythonGetIndexOfChildWithName swig_get_index_child,
                            SWIGPythonCastPyObjectToSBValue swig_cast_to_sbvalue ,
                            SWIGPythonGetValueObjectSPFromSBValue swig_get_valobj_sp_from_sbvalue,
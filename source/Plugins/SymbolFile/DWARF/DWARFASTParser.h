@@ -15,6 +15,7 @@
 #include "lldb/Symbol/CompilerDecl.h"
 #include "lldb/Symbol/CompilerDeclContext.h"
 
+class DWARFDebugInfoEntry;
 class DWARFDIE;
 
 class DWARFASTParser
@@ -48,6 +49,14 @@ public:
 
     virtual std::vector<DWARFDIE>
     GetDIEForDeclContext (lldb_private::CompilerDeclContext decl_context) = 0;
+
+    // Add the DIEs the parser keeps pointers to, the symbol file can't
+    // release them. Returns false if the parser can't tell.
+    virtual bool
+    GetDIEsInUse (std::vector<const DWARFDebugInfoEntry *> &dies)
+    {
+        return false;
+    }
 };
 
 #endif  // SymbolFileDWARF_DWARFASTParser_h_
@@ -40,6 +40,7 @@
 #include "clang/AST/DeclCXX.h"
 #include "clang/AST/DeclObjC.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -191,6 +192,145 @@ DWARFASTParserClang::ParseTypeFromDWO (const DWARFDIE &die, Log *log)
     return TypeSP();
 }
 
+// Classes with fewer methods are completed at once.
+static const size_t g_min_methods_to_defer = 64;
+
+// Returns true if adding the method to the class after it was completed
+// doesn't change its layout or how clang treats it. Virtual methods make
+// the class dynamic, constructors, destructors and assignment operators
+// decide whether it is trivial.
+static bool
+CanDeferMethod (const DWARFDIE &class_die, const DWARFDIE &method_die)
+{
+    if (method_die.GetAttributeValueAsUnsigned(DW_AT_virtuality, DW_VIRTUALITY_none) != DW_VIRTUALITY_none ||
+        method_die.GetAttributeValueAsUnsigned(DW_AT_artificial, 0) != 0)
+        return false;
+
+    const char *method_name = method_die.GetName();
+    const char *class_name = class_die.GetName();
+    if (method_name == nullptr || class_name == nullptr)
+        return false;
+    if (method_name[0] == '~' || ::strncmp(method_name, "operator", 8) == 0)
+        return false;
+
+    // Constructors are named after the class without its template
+    // arguments.
+    llvm::StringRef class_base_name (class_name);
+    class_base_name = class_base_name.substr(0, class_base_name.find('<'));
+    llvm::StringRef method_base_name (method_name);
+    method_base_name = method_base_name.substr(0, method_base_name.find('<'));
+    return method_base_name != class_base_name;
+}
+
+void
+DWARFASTParserClang::CompleteDeferredMethods (const clang::DeclContext *decl_ctx,
+                                              clang::DeclarationName name,
+                                              llvm::SmallVectorImpl<clang::NamedDecl *> *results)
+{
+    DeclContextToMethodDIEsMap::iterator pos = m_deferred_methods.find(decl_ctx);
+    if (pos == m_deferred_methods.end())
+        return;
+
+    // Only plain identifiers can match a deferred method, operators and
+    // special members are always added when the class is completed.
+    const bool all_methods = name.isEmpty();
+    if (!all_methods && !name.isIdentifier())
+        return;
+    const std::string method_name (all_methods ? std::string() : name.getAsString());
+
+    // Take the methods we parse out of the map first, parsing them can
+    // look up names in the class again.
+    std::vector<DWARFDIE> method_dies;
+    std::vector<DWARFDIE> &deferred_method_dies = pos->second;
+    if (all_methods)
+    {
+        method_dies.swap(deferred_method_dies);
+    }
+    else
+    {
+        std::vector<DWARFDIE>::iterator new_end =
+            std::partition(deferred_method_dies.begin(), deferred_method_dies.end(),
+                           [&method_name](const DWARFDIE &method_die) {
+                               const char *die_name = method_die.GetName();
+                               return die_name == nullptr || method_name != die_name;
+                           });
+        method_dies.assign(new_end, deferred_method_dies.end());
+        deferred_method_dies.erase(new_end, deferred_method_dies.end());
+    }
+    if (deferred_method_dies.empty())
+        m_deferred_methods.erase(pos);
+
+    if (method_dies.empty())
+        return;
+
+    SymbolFileDWARF *dwarf = method_dies.front().GetDWARF();
+    std::lock_guard<std::recursive_mutex> guard(dwarf->GetObjectFile()->GetModule()->GetMutex());
+    for (const DWARFDIE &method_die : method_dies)
+    {
+        method_die.ResolveType();
+        if (results)
+        {
+            clang::CXXMethodDecl *method_decl =
+                llvm::dyn_cast_or_null<clang::CXXMethodDecl>(GetCachedClangDeclContextForDIE(method_die));
+            if (method_decl)
+                results->push_back(method_decl);
+        }
+    }
+}
+
+TypeSP
+DWARFASTParserClang::FindUniqueType (const DWARFDIE &die,
+                                     const ConstString &type_name,
+                                     int32_t byte_size,
+                                     ConstString &unique_typename)
+{
+    unique_typename.Clear();
+    if (!type_name || !Language::LanguageIsCPlusPlus(die.GetLanguage()))
+        return TypeSP();
+
+    // Types in functions don't have a unique qualified name.
+    for (DWARFDIE parent_die = die.GetParent(); parent_die; parent_die = parent_die.GetParent())
+    {
+        switch (parent_die.Tag())
+        {
+            case DW_TAG_subprogram:
+            case DW_TAG_inlined_subroutine:
+            case DW_TAG_lexical_block:
+                return TypeSP();
+            default:
+                break;
+        }
+    }
+
+    std::string qualified_name;
+    if (!die.GetQualifiedName(qualified_name))
+        return TypeSP();
+    unique_typename.SetCString(qualified_name.c_str());
+
+    // UniqueDWARFASTType is large, keep it off the stack of this recursive
+    // parser like ParseTypeFromDWARF() does.
+    std::unique_ptr<UniqueDWARFASTType> unique_ast_entry_ap(new UniqueDWARFASTType());
+    if (die.GetDWARF()->GetUniqueDWARFASTTypeMap().Find(unique_typename, die, Declaration(), byte_size,
+                                                        *unique_ast_entry_ap))
+        return unique_ast_entry_ap->m_type_sp;
+    return TypeSP();
+}
+
+void
+DWARFASTParserClang::InsertUniqueType (const DWARFDIE &die,
+                                       const ConstString &unique_typename,
+                                       int32_t byte_size,
+                                       TypeSP &type_sp)
+{
+    if (!unique_typename || !type_sp)
+        return;
+
+    // For C++ the declaration is ignored, the same header can be included
+    // with different paths.
+    die.GetDWARF()->GetUniqueDWARFASTTypeMap().Insert(unique_typename,
+                                                      UniqueDWARFASTType(type_sp, die, Declaration(), byte_size));
+}
+
 TypeSP
 DWARFASTParserClang::ParseTypeFromDWARF (const SymbolContext& sc,
                                          const DWARFDIE &die,
@@ -334,6 +474,17 @@ DWARFASTParserClang::ParseTypeFromDWARF (const SymbolContext& sc,
 
                     DEBUG_PRINTF ("0x%8.8" PRIx64 ": %s (\"%s\") type => 0x%8.8lx\n", die.GetID(), DW_TAG_value_to_name(tag), type_name_cstr, encoding_uid.Reference());
 
+                    ConstString unique_typename;
+                    if (tag == DW_TAG_typedef)
+                    {
+                        type_sp = FindUniqueType(die, type_name_const_str, -1, unique_typename);
+                        if (type_sp)
+                        {
+                            dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+                            return type_sp;
+                        }
+                    }
+
                     switch (tag)
                     {
                         default:
@@ -498,6 +649,7 @@ DWARFASTParserClang::ParseTypeFromDWARF (const SymbolContext& sc,
                                              resolve_state));
 
                     dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+                    InsertUniqueType(die, unique_typename, -1, type_sp);
 
                     //                  Type* encoding_type = GetUniquedTypeForDIEOffset(encoding_uid, type_sp, NULL, 0, 0, false);
                     //                  if (encoding_type != NULL)
@@ -1037,6 +1189,16 @@ DWARFASTParserClang::ParseTypeFromDWARF (const SymbolContext& sc,
                         }
                         DEBUG_PRINTF ("0x%8.8" PRIx64 ": %s (\"%s\")\n", die.GetID(), DW_TAG_value_to_name(tag), type_name_cstr);
 
+                        const int32_t unique_byte_size = byte_size > 0 ? byte_size : -1;
+                        ConstString unique_typename;
+                        if (dwarf->GetForwardDeclDieToClangType().lookup (die.GetDIE()) == nullptr)
+                            type_sp = FindUniqueType(die, type_name_const_str, unique_byte_size, unique_typename);
+                        if (type_sp)
+                        {
+                            dwarf->GetDIEToType()[die.GetDIE()] = type_sp.get();
+                            return type_sp;
+                        }
+
                         CompilerType enumerator_clang_type;
                         clang_type.SetCompilerType (&m_ast, dwarf->GetForwardDeclDieToClangType().lookup (die.GetDIE()));
                         if (!clang_type)
@@ -1084,6 +1246,7 @@ DWARFASTParserClang::ParseTypeFromDWARF (const SymbolContext& sc,
                                                  &decl,
                                                  clang_type,
                                                  Type::eResolveStateForward));
+                        InsertUniqueType(die, unique_typename, unique_byte_size, type_sp);
 
                         ClangASTContext::StartTagDeclarationDefinition (clang_type);
                         if (die.HasChildren())
@@ -2096,6 +2259,7 @@ DWARFASTParserClang::CompleteTypeFromDWARF(const DWARFDIE &die, lldb_private::Ty
         case DW_TAG_class_type:
         {
             ClangASTImporter::LayoutInfo layout_info;
+            std::vector<DWARFDIE> deferred_method_dies;
 
             {
                 if (die.HasChildren())
@@ -2147,14 +2311,19 @@ DWARFASTParserClang::CompleteTypeFromDWARF(const DWARFDIE &die, lldb_private::Ty
                                        is_a_class,
                                        layout_info);
 
-                    // Now parse any methods if there were any...
+                    // Now parse any methods if there were any. The methods
+                    // of classes with many of them that don't matter for the
+                    // layout are only parsed when they are looked up.
                     size_t num_functions = member_function_dies.Size();
-                    if (num_functions > 0)
+                    const bool defer_methods = num_functions >= g_min_methods_to_defer &&
+                                               class_language != eLanguageTypeObjC;
+                    for (size_t i=0; i<num_functions; ++i)
                     {
-                        for (size_t i=0; i<num_functions; ++i)
-                        {
-                            dwarf->ResolveType(member_function_dies.GetDIEAtIndex(i));
-                        }
+                        DWARFDIE method_die = member_function_dies.GetDIEAtIndex(i);
+                        if (defer_methods && CanDeferMethod(die, method_die))
+                            deferred_method_dies.push_back(method_die);
+                        else
+                            dwarf->ResolveType(method_die);
                     }
 
                     if (class_language == eLanguageTypeObjC)
@@ -2262,6 +2431,24 @@ DWARFASTParserClang::CompleteTypeFromDWARF(const DWARFDIE &die, lldb_private::Ty
             ClangASTContext::BuildIndirectFields (clang_type);
             ClangASTContext::CompleteTagDeclarationDefinition (clang_type);
 
+            if (!deferred_method_dies.empty())
+            {
+                // Looking up a name in the class or walking all of its
+                // declarations adds the methods in CompleteDeferredMethods().
+                clang::CXXRecordDecl *record_decl = m_ast.GetAsCXXRecordDecl(clang_type.GetOpaqueQualType());
+                if (record_decl)
+                {
+                    m_deferred_methods[record_decl].swap(deferred_method_dies);
+                    record_decl->setHasExternalLexicalStorage(true);
+                    record_decl->setHasExternalVisibleStorage(true);
+                }
+                else
+                {
+                    for (const DWARFDIE &method_die : deferred_method_dies)
+                        dwarf->ResolveType(method_die);
+                }
+            }
+
             if (!layout_info.field_offsets.empty() ||
                 !layout_info.base_offsets.empty()  ||
                 !layout_info.vbase_offsets.empty() )
@@ -2394,6 +2581,25 @@ DWARFASTParserClang::GetDeclContextContainingUIDFromDWARF (const DWARFDIE &die)
     return CompilerDeclContext();
 }
 
+bool
+DWARFASTParserClang::GetDIEsInUse (std::vector<const DWARFDebugInfoEntry *> &dies)
+{
+    for (const auto &pair : m_die_to_decl)
+        dies.push_back(pair.first);
+    for (const auto &pair : m_decl_to_die)
+        dies.insert(dies.end(), pair.second.begin(), pair.second.end());
+    for (const auto &pair : m_die_to_decl_ctx)
+        dies.push_back(pair.first);
+    for (const auto &pair : m_decl_ctx_to_die)
+        dies.push_back(pair.second.GetDIE());
+    for (const auto &pair : m_deferred_methods)
+    {
+        for (const DWARFDIE &die : pair.second)
+            dies.push_back(die.GetDIE());
+    }
+    return true;
+}
+
 size_t
 DWARFASTParserClang::ParseChildEnumerators (const SymbolContext& sc,
                                             lldb_private::CompilerType &clang_type,
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/SmallPtrSet.h"
@@ -65,9 +67,36 @@ public:
     lldb_private::CompilerDeclContext
     GetDeclContextContainingUIDFromDWARF (const DWARFDIE &die) override;
 
+    bool
+    GetDIEsInUse (std::vector<const DWARFDebugInfoEntry *> &dies) override;
+
     lldb_private::ClangASTImporter &
     GetClangASTImporter();
 
+    //------------------------------------------------------------------
+    /// Add the methods of a class that CompleteTypeFromDWARF() left out.
+    ///
+    /// Completing a class with many methods only adds the ones that can
+    /// change its layout or semantics, like virtual methods, constructors
+    /// and destructors. The rest are added by this function when they are
+    /// looked up by name or when all declarations of the class are
+    /// wanted.
+    ///
+    /// @param[in] decl_ctx
+    ///     The class.
+    ///
+    /// @param[in] name
+    ///     Only add the methods with this name, or all of them if the
+    ///     name is empty.
+    ///
+    /// @param[out] results
+    ///     If not null, the added methods are appended to it.
+    //------------------------------------------------------------------
+    void
+    CompleteDeferredMethods (const clang::DeclContext *decl_ctx,
+                             clang::DeclarationName name,
+                             llvm::SmallVectorImpl<clang::NamedDecl *> *results);
+
 protected:
     class DelayedAddObjCClassProperty;
     typedef std::vector <DelayedAddObjCClassProperty> DelayedPropertyList;
@@ -152,6 +181,27 @@ protected:
     lldb::TypeSP
     ParseTypeFromDWO (const DWARFDIE &die, lldb_private::Log *log);
 
+    //----------------------------------------------------------------------
+    // The enums and typedefs of a header are in the debug info of every
+    // compile unit that includes the header. The one definition rule lets
+    // us parse each C++ one once per module: FindUniqueType() returns the
+    // type if another compile unit already parsed a type with the same
+    // qualified name and byte size, otherwise it sets unique_typename to
+    // the name InsertUniqueType() takes. unique_typename is left empty if
+    // the type can't be shared, like types in functions.
+    //----------------------------------------------------------------------
+    lldb::TypeSP
+    FindUniqueType (const DWARFDIE &die,
+                    const lldb_private::ConstString &type_name,
+                    int32_t byte_size,
+                    lldb_private::ConstString &unique_typename);
+
+    void
+    InsertUniqueType (const DWARFDIE &die,
+                      const lldb_private::ConstString &unique_typename,
+                      int32_t byte_size,
+                      lldb::TypeSP &type_sp);
+
     //----------------------------------------------------------------------
     // Return true if this type is a declaration to a type in an external
     // module.
@@ -165,12 +215,14 @@ protected:
     typedef std::multimap<const clang::DeclContext *, const DWARFDIE> DeclContextToDIEMap;
     typedef llvm::DenseMap<const DWARFDebugInfoEntry *, clang::Decl *> DIEToDeclMap;
     typedef llvm::DenseMap<const clang::Decl *, DIEPointerSet> DeclToDIEMap;
+    typedef llvm::DenseMap<const clang::DeclContext *, std::vector<DWARFDIE>> DeclContextToMethodDIEsMap;
 
     lldb_private::ClangASTContext &m_ast;
     DIEToDeclMap m_die_to_decl;
     DeclToDIEMap m_decl_to_die;
     DIEToDeclContextMap m_die_to_decl_ctx;
     DeclContextToDIEMap m_decl_ctx_to_die;
+    DeclContextToMethodDIEsMap m_deferred_methods;    // The methods CompleteTypeFromDWARF() left out of each class
     std::unique_ptr<lldb_private::ClangASTImporter> m_clang_ast_importer_ap;
 };
 
@@ -26,6 +26,7 @@ public:
     void            AddAttribute(const DWARFAttribute& attr)
                     {
                         m_attributes.push_back(attr);
+                        AddToFixedAttributesSize(attr.get_form());
                     }
 
     dw_uleb128_t    Code() const { return m_code; }
@@ -55,6 +56,11 @@ public:
                     {
                         return m_attributes[idx].get_form();
                     }
+                    // When every form of this abbreviation has a size that
+                    // doesn't depend on the data, get the size of the
+                    // attribute data of a DIE with it in \a cu so the DIE can
+                    // be skipped with a single add.
+    bool            GetFixedAttributesSize(const DWARFCompileUnit* cu, uint32_t& size) const;
     uint32_t        FindAttributeIndex(dw_attr_t attr) const;
     bool            Extract(const lldb_private::DWARFDataExtractor& data, lldb::offset_t *offset_ptr);
     bool            Extract(const lldb_private::DWARFDataExtractor& data, lldb::offset_t *offset_ptr, dw_uleb128_t code);
@@ -63,10 +69,21 @@ public:
     bool            operator == (const DWARFAbbreviationDeclaration& rhs) const;
     const DWARFAttribute::collection& Attributes() const { return m_attributes; }
 protected:
+    void            ClearFixedAttributesSize();
+    void            AddToFixedAttributesSize(dw_form_t form);
+
     dw_uleb128_t        m_code;
     dw_tag_t            m_tag;
     uint8_t             m_has_children;
     DWARFAttribute::collection m_attributes;
+
+    // The size of the attribute data is m_fixed_size plus the size of the
+    // forms whose size depends on the compile unit times their count.
+    bool                m_has_fixed_size;
+    uint32_t            m_fixed_size;
+    uint16_t            m_num_addr_forms;       // Address sized
+    uint16_t            m_num_offset_forms;     // 4 bytes, 8 in DWARF64
+    uint16_t            m_num_ref_addr_forms;   // Address sized in DWARF 2, offset sized after
 };
 
 #endif  // liblldb_DWARFAbbreviationDeclaration_h_
@@ -9,6 +9,9 @@
 
 #include "DWARFCompileUnit.h"
 
+#include <algorithm>
+#include <atomic>
+
 #include "lldb/Core/Mangled.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Stream.h"
@@ -18,6 +21,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/LineTable.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Language.h"
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 
 #include "DWARFDebugAbbrev.h"
@@ -43,6 +47,7 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
     m_abbrevs       (NULL),
     m_user_data     (NULL),
     m_die_array     (),
+    m_die_array_size_hint (0),
     m_func_aranges_ap (),
     m_base_addr     (0),
     m_offset        (DW_INVALID_OFFSET),
@@ -62,7 +67,9 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
 }
 
 DWARFCompileUnit::~DWARFCompileUnit()
-{}
+{
+    UpdateDIEArrayMemoryUsage (m_die_array.capacity(), 0);
+}
 
 void
 DWARFCompileUnit::Clear()
@@ -74,6 +81,7 @@ DWARFCompileUnit::Clear()
     m_addr_size     = DWARFCompileUnit::GetDefaultAddressSize();
     m_base_addr     = 0;
     m_die_array.clear();
+    m_die_array_size_hint = 0;
     m_func_aranges_ap.reset();
     m_user_data     = NULL;
     m_producer      = eProducerInvalid;
@@ -123,6 +131,7 @@ DWARFCompileUnit::Extract(const DWARFDataExtractor &debug_info, lldb::offset_t *
 void
 DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
 {
+    const size_t old_capacity = m_die_array.capacity();
     if (m_die_array.size() > 1)
     {
         // std::vectors never get any smaller when resized to a smaller size,
@@ -139,6 +148,7 @@ DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
         if (keep_compile_unit_die)
             m_die_array.push_back(tmp_array.front());
     }
+    UpdateDIEArrayMemoryUsage (old_capacity, m_die_array.capacity());
 
     if (m_dwo_symbol_file)
         m_dwo_symbol_file->GetCompileUnit()->ClearDIEs(keep_compile_unit_die);
@@ -156,8 +166,10 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
     const size_t initial_die_array_size = m_die_array.size();
     if ((cu_die_only && initial_die_array_size > 0) || initial_die_array_size > 1)
         return 0; // Already parsed
+    const size_t initial_die_array_capacity = m_die_array.capacity();
 
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "%8.8x: DWARFCompileUnit::ExtractDIEsIfNeeded( cu_die_only = %i )",
                         m_offset,
                         cu_die_only);
@@ -210,7 +222,14 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
                 base_addr = die.GetAttributeValueAsAddress(m_dwarf2Data, this, DW_AT_entry_pc, 0);
             SetBaseAddress (base_addr);
             if (cu_die_only)
+            {
+                UpdateDIEArrayMemoryUsage (initial_die_array_capacity, m_die_array.capacity());
                 return 1;
+            }
+            // The compile unit DIE might have been extracted on its own
+            // before, reserve the space for the rest of the DIEs.
+            if (m_die_array_size_hint > m_die_array.capacity())
+                m_die_array.reserve (m_die_array_size_hint);
         }
         else
         {
@@ -279,13 +298,16 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
     // Since std::vector objects will double their size, we really need to
     // make a new array with the perfect size so we don't end up wasting
     // space. So here we copy and swap to make sure we don't have any extra
-    // memory taken up.
+    // memory taken up. Remember the final size so that if these DIEs get
+    // cleared and extracted again we can allocate the array exactly once.
     
     if (m_die_array.size () < m_die_array.capacity())
     {
         DWARFDebugInfoEntry::collection exact_size_die_array (m_die_array.begin(), m_die_array.end());
         exact_size_die_array.swap (m_die_array);
     }
+    m_die_array_size_hint = m_die_array.size();
+    UpdateDIEArrayMemoryUsage (initial_die_array_capacity, m_die_array.capacity());
     Log *verbose_log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO | DWARF_LOG_VERBOSE));
     if (verbose_log)
     {
@@ -306,6 +328,51 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
     return m_die_array.size() + dwo_die_count - 1; // We have 2 CU die, but we waht to count it only as one
 }
 
+namespace
+{
+    std::atomic<size_t> g_die_array_bytes (0);
+    std::atomic<size_t> g_die_array_peak_bytes (0);
+}
+
+void
+DWARFCompileUnit::UpdateDIEArrayMemoryUsage (size_t old_capacity, size_t new_capacity)
+{
+    if (new_capacity > old_capacity)
+    {
+        const size_t bytes = g_die_array_bytes += (new_capacity - old_capacity) * sizeof(DWARFDebugInfoEntry);
+        size_t peak_bytes = g_die_array_peak_bytes;
+        while (bytes > peak_bytes && !g_die_array_peak_bytes.compare_exchange_weak (peak_bytes, bytes))
+            ;
+    }
+    else if (new_capacity < old_capacity)
+    {
+        g_die_array_bytes -= (old_capacity - new_capacity) * sizeof(DWARFDebugInfoEntry);
+    }
+}
+
+bool
+DWARFCompileUnit::ContainsAnyDIE (const std::vector<const DWARFDebugInfoEntry *> &sorted_dies) const
+{
+    if (m_die_array.empty())
+        return false;
+    const DWARFDebugInfoEntry *first_die = &m_die_array.front();
+    const DWARFDebugInfoEntry *last_die = &m_die_array.back();
+    auto pos = std::lower_bound (sorted_dies.begin(), sorted_dies.end(), first_die);
+    return pos != sorted_dies.end() && *pos <= last_die;
+}
+
+size_t
+DWARFCompileUnit::GetDIEArrayMemoryUsage ()
+{
+    return g_die_array_bytes;
+}
+
+size_t
+DWARFCompileUnit::GetDIEArrayPeakMemoryUsage ()
+{
+    return g_die_array_peak_bytes;
+}
+
 void
 DWARFCompileUnit::AddCompileUnitDIE(DWARFDebugInfoEntry& die)
 {
@@ -438,6 +505,21 @@ DWARFCompileUnit::GetID () const
         return local_id;
 }
 
+//----------------------------------------------------------------------
+// Get the DW_AT_ranges of the compile unit DIE. Only the compile unit DIE
+// is extracted, so this can be called for different compile units at the
+// same time once the .debug_ranges of the symbol file have been parsed.
+//----------------------------------------------------------------------
+size_t
+DWARFCompileUnit::GetCompileUnitDIERanges (SymbolFileDWARF* dwarf2Data,
+                                           DWARFRangeList &ranges)
+{
+    const DWARFDebugInfoEntry* die = GetCompileUnitDIEPtrOnly();
+    if (die)
+        return die->GetAttributeAddressRanges(dwarf2Data, this, ranges, false);
+    return 0;
+}
+
 void
 DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                           DWARFDebugAranges* debug_aranges)
@@ -449,27 +531,22 @@ DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
     size_t num_debug_aranges = debug_aranges->GetNumRanges();
     
     // First get the compile unit DIE only and check if it has a DW_AT_ranges
-    const DWARFDebugInfoEntry* die = GetCompileUnitDIEPtrOnly();
-    
     const dw_offset_t cu_offset = GetOffset();
-    if (die)
+    DWARFRangeList ranges;
+    const size_t num_ranges = GetCompileUnitDIERanges(dwarf2Data, ranges);
+    if (num_ranges > 0)
     {
-        DWARFRangeList ranges;
-        const size_t num_ranges = die->GetAttributeAddressRanges(dwarf2Data, this, ranges, false);
-        if (num_ranges > 0)
+        // This compile unit has DW_AT_ranges, assume this is correct if it
+        // is present since clang no longer makes .debug_aranges by default
+        // and it emits DW_AT_ranges for DW_TAG_compile_units. GCC also does
+        // this with recent GCC builds.
+        for (size_t i=0; i<num_ranges; ++i)
         {
-            // This compile unit has DW_AT_ranges, assume this is correct if it
-            // is present since clang no longer makes .debug_aranges by default
-            // and it emits DW_AT_ranges for DW_TAG_compile_units. GCC also does
-            // this with recent GCC builds.
-            for (size_t i=0; i<num_ranges; ++i)
-            {
-                const DWARFRangeList::Entry &range = ranges.GetEntryRef(i);
-                debug_aranges->AppendRange(cu_offset, range.GetRangeBase(), range.GetRangeEnd());
-            }
-            
-            return; // We got all of our ranges from the DW_AT_ranges attribute
+            const DWARFRangeList::Entry &range = ranges.GetEntryRef(i);
+            debug_aranges->AppendRange(cu_offset, range.GetRangeBase(), range.GetRangeEnd());
         }
+        
+        return; // We got all of our ranges from the DW_AT_ranges attribute
     }
     // We don't have a DW_AT_ranges attribute, so we need to parse the DWARF
     
@@ -478,7 +555,7 @@ DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
     // and then throwing them all away to keep memory usage down.
     const bool clear_dies = ExtractDIEsIfNeeded (false) > 1;
     
-    die = DIEPtr();
+    const DWARFDebugInfoEntry* die = DIEPtr();
     if (die)
         die->BuildAddressRangeTable(dwarf2Data, this, debug_aranges);
     
@@ -677,7 +754,8 @@ DWARFCompileUnit::AppendDIEsWithTag (const dw_tag_t tag, DWARFDIECollection& die
 
 
 void
-DWARFCompileUnit::Index (NameToDIE& func_basenames,
+DWARFCompileUnit::Index (uint32_t index_mask,
+                         NameToDIE& func_basenames,
                          NameToDIE& func_fullnames,
                          NameToDIE& func_methods,
                          NameToDIE& func_selectors,
@@ -700,6 +778,7 @@ DWARFCompileUnit::Index (NameToDIE& func_basenames,
         DWARFFormValue::GetFixedFormSizesForAddressSize (GetAddressByteSize(), m_is_dwarf64);
     
     IndexPrivate(this,
+                 index_mask,
                  cu_language,
                  fixed_form_sizes,
                  GetOffset(),
@@ -716,6 +795,7 @@ DWARFCompileUnit::Index (NameToDIE& func_basenames,
     if (dwo_symbol_file)
     {
         IndexPrivate(dwo_symbol_file->GetCompileUnit(),
+                     index_mask,
                      cu_language,
                      fixed_form_sizes,
                      GetOffset(),
@@ -732,6 +812,7 @@ DWARFCompileUnit::Index (NameToDIE& func_basenames,
 
 void
 DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
+                                uint32_t index_mask,
                                 const LanguageType cu_language,
                                 const DWARFFormValue::FixedFormSizes& fixed_form_sizes,
                                 const dw_offset_t cu_offset,
@@ -744,6 +825,15 @@ DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
                                 NameToDIE& types,
                                 NameToDIE& namespaces)
 {
+    const bool index_functions = (index_mask & SymbolFileDWARF::eIndexFunctions) != 0;
+    const bool index_globals = (index_mask & SymbolFileDWARF::eIndexGlobals) != 0;
+    const bool index_types = (index_mask & SymbolFileDWARF::eIndexTypes) != 0;
+    const bool index_namespaces = (index_mask & SymbolFileDWARF::eIndexNamespaces) != 0;
+
+    // Only compile units that might contain Objective C need to have their
+    // function names parsed as Objective C method names.
+    const bool check_objc_methods = cu_language == eLanguageTypeUnknown || Language::LanguageIsObjC(cu_language);
+
     DWARFDebugInfoEntry::const_iterator pos;
     DWARFDebugInfoEntry::const_iterator begin = dwarf_cu->m_die_array.begin();
     DWARFDebugInfoEntry::const_iterator end = dwarf_cu->m_die_array.end();
@@ -760,16 +850,30 @@ DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
         case DW_TAG_class_type:
         case DW_TAG_constant:
         case DW_TAG_enumeration_type:
-        case DW_TAG_inlined_subroutine:
-        case DW_TAG_namespace:
         case DW_TAG_string_type:
         case DW_TAG_structure_type:
-        case DW_TAG_subprogram:
         case DW_TAG_subroutine_type:
         case DW_TAG_typedef:
         case DW_TAG_union_type:
         case DW_TAG_unspecified_type:
+            if (!index_types)
+                continue;
+            break;
+
+        case DW_TAG_inlined_subroutine:
+        case DW_TAG_subprogram:
+            if (!index_functions)
+                continue;
+            break;
+
+        case DW_TAG_namespace:
+            if (!index_namespaces)
+                continue;
+            break;
+
         case DW_TAG_variable:
+            if (!index_globals)
+                continue;
             break;
             
         default:
@@ -890,8 +994,11 @@ DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
             {
                 if (name)
                 {
-                    ObjCLanguage::MethodName objc_method(name, true);
-                    if (objc_method.IsValid(true))
+                    ObjCLanguage::MethodName objc_method;
+                    if (check_objc_methods)
+                        objc_method.SetName(name, true);
+                    const bool is_objc_method = objc_method.IsValid(true);
+                    if (is_objc_method)
                     {
                         ConstString objc_class_name_with_category (objc_method.GetClassNameWithCategory());
                         ConstString objc_selector_name (objc_method.GetSelector());
@@ -935,7 +1042,7 @@ DWARFCompileUnit::IndexPrivate (DWARFCompileUnit* dwarf_cu,
                     else
                         func_basenames.Insert (ConstString(name), DIERef(cu_offset, die.GetOffset()));
 
-                    if (!is_method && !mangled_cstr && !objc_method.IsValid(true))
+                    if (!is_method && !mangled_cstr && !is_objc_method)
                         func_fullnames.Insert (ConstString(name), DIERef(cu_offset, die.GetOffset()));
                 }
                 if (mangled_cstr)
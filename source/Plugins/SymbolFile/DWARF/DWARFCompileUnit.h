@@ -56,6 +56,33 @@ public:
     dw_addr_t   GetAddrBase() const { return m_addr_base; }
     void        SetAddrBase(dw_addr_t addr_base, dw_offset_t base_obj_offset);
     void        ClearDIEs(bool keep_compile_unit_die);
+
+    //------------------------------------------------------------------
+    // Process wide gauge of the memory currently held by extracted DIE
+    // arrays of all compile units, and the high watermark of that value.
+    //------------------------------------------------------------------
+    static size_t
+    GetDIEArrayMemoryUsage ();
+
+    static size_t
+    GetDIEArrayPeakMemoryUsage ();
+
+    // The number of DIEs in this compile unit as far as they were ever
+    // extracted, and the memory the extracted DIEs use right now.
+    size_t
+    GetNumDIEs () const
+    {
+        return m_die_array.size() > m_die_array_size_hint ? m_die_array.size() : m_die_array_size_hint;
+    }
+
+    size_t
+    GetDIEArrayMemorySize () const
+    {
+        return m_die_array.capacity() * sizeof(DWARFDebugInfoEntry);
+    }
+
+    size_t      GetCompileUnitDIERanges (SymbolFileDWARF* dwarf2Data,
+                                         DWARFRangeList &ranges);
     void        BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                         DWARFDebugAranges* debug_aranges);
 
@@ -99,7 +126,14 @@ public:
         // the first compile unit child DIE and should reserve
         // the memory.
         if (m_die_array.empty())
-            m_die_array.reserve(GetDebugInfoSize() / 24);
+        {
+            // If we extracted the DIEs before and then cleared them we
+            // know exactly how many we will need.
+            if (m_die_array_size_hint > 0)
+                m_die_array.reserve(m_die_array_size_hint);
+            else
+                m_die_array.reserve(GetDebugInfoSize() / 24);
+        }
         m_die_array.push_back(die);
     }
     
@@ -112,6 +146,11 @@ public:
         return m_die_array.size() > 1;
     }
 
+    // Check whether any of the sorted DIE pointers points into the DIEs
+    // that are extracted right now.
+    bool
+    ContainsAnyDIE (const std::vector<const DWARFDebugInfoEntry *> &sorted_dies) const;
+
     DWARFDIE
     GetDIE (dw_offset_t die_offset);
 
@@ -145,8 +184,14 @@ public:
     bool
     Supports_unnamed_objc_bitfields ();
 
+    //------------------------------------------------------------------
+    // Add the names of the DIEs in this compile unit to the name tables.
+    // Only the tables selected by \a index_mask (a bitmask of
+    // SymbolFileDWARF::IndexMask values) are filled in.
+    //------------------------------------------------------------------
     void
-    Index (NameToDIE& func_basenames,
+    Index (uint32_t index_mask,
+           NameToDIE& func_basenames,
            NameToDIE& func_fullnames,
            NameToDIE& func_methods,
            NameToDIE& func_selectors,
@@ -206,6 +251,7 @@ protected:
     const DWARFAbbreviationDeclarationSet *m_abbrevs;
     void *              m_user_data;
     DWARFDebugInfoEntry::collection m_die_array;    // The compile unit debug information entry item
+    size_t              m_die_array_size_hint;     // Number of DIEs found the last time all DIEs were extracted
     std::unique_ptr<DWARFDebugAranges> m_func_aranges_ap;   // A table similar to the .debug_aranges table, but this one points to the exact DW_TAG_subprogram DIEs
     dw_addr_t           m_base_addr;
     dw_offset_t         m_offset;
@@ -226,8 +272,12 @@ protected:
     void
     ParseProducerInfo ();
 
+    static void
+    UpdateDIEArrayMemoryUsage (size_t old_capacity, size_t new_capacity);
+
     static void
     IndexPrivate (DWARFCompileUnit* dwarf_cu,
+                  uint32_t index_mask,
                   const lldb::LanguageType cu_language,
                   const DWARFFormValue::FixedFormSizes& fixed_form_sizes,
                   const dw_offset_t cu_offset,
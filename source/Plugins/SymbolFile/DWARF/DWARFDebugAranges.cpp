@@ -134,7 +134,8 @@ DWARFDebugAranges::AppendRange (dw_offset_t offset, dw_addr_t low_pc, dw_addr_t
 void
 DWARFDebugAranges::Sort (bool minimize)
 {    
-    Timer scoped_timer(__PRETTY_FUNCTION__, "%s this = %p",
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat, "%s this = %p",
                        __PRETTY_FUNCTION__, static_cast<void*>(this));
 
     Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_ARANGES));
@@ -15,6 +15,7 @@
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Utility/TaskPool.h"
 
 #include "DWARFDebugAranges.h"
 #include "DWARFDebugInfo.h"
@@ -77,23 +78,53 @@ DWARFDebugInfo::GetCompileUnitAranges ()
         }
 
         // Manually build arange data for everything that wasn't in the .debug_aranges table.
-        bool printed = false;
+        std::vector<DWARFCompileUnit*> cus_to_parse;
         const size_t num_compile_units = GetNumCompileUnits();
         for (size_t idx = 0; idx < num_compile_units; ++idx)
         {
             DWARFCompileUnit* cu = GetCompileUnitAtIndex(idx);
+            if (cus_with_data.find(cu->GetOffset()) == cus_with_data.end())
+                cus_to_parse.push_back(cu);
+        }
+
+        if (!cus_to_parse.empty())
+        {
+            if (log)
+                log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" by parsing",
+                             m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
 
-            dw_offset_t offset = cu->GetOffset();
-            if (cus_with_data.find(offset) == cus_with_data.end())
+            // Most compile units have a DW_AT_ranges on their compile unit
+            // DIE, get those on the TaskPool. Only the compile unit DIEs are
+            // extracted for this. The .debug_ranges object is created up
+            // front, its lookups are safe to do from the tasks.
+            m_dwarf2Data->DebugRanges();
+            std::vector<DWARFRangeList> cu_ranges(cus_to_parse.size());
+            TaskRunner<void> task_runner;
+            for (size_t i = 0; i < cus_to_parse.size(); ++i)
             {
-                if (log)
+                task_runner.AddTask([this, &cus_to_parse, &cu_ranges, i]() {
+                    cus_to_parse[i]->GetCompileUnitDIERanges(m_dwarf2Data, cu_ranges[i]);
+                });
+            }
+            task_runner.WaitForAllTasks();
+
+            // The compile units without them need their functions or line
+            // tables, which can't be parsed concurrently.
+            for (size_t i = 0; i < cus_to_parse.size(); ++i)
+            {
+                const DWARFRangeList &ranges = cu_ranges[i];
+                const size_t num_ranges = ranges.GetSize();
+                if (num_ranges > 0)
                 {
-                    if (!printed)
-                        log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" by parsing",
-                                     m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
-                    printed = true;
+                    const dw_offset_t cu_offset = cus_to_parse[i]->GetOffset();
+                    for (size_t j = 0; j < num_ranges; ++j)
+                    {
+                        const DWARFRangeList::Entry &range = ranges.GetEntryRef(j);
+                        m_cu_aranges_ap->AppendRange(cu_offset, range.GetRangeBase(), range.GetRangeEnd());
+                    }
                 }
-                cu->BuildAddressRangeTable (m_dwarf2Data, m_cu_aranges_ap.get());
+                else
+                    cus_to_parse[i]->BuildAddressRangeTable (m_dwarf2Data, m_cu_aranges_ap.get());
             }
         }
 
@@ -69,6 +69,16 @@ DWARFDebugInfoEntry::FastExtract
         }
         m_tag = abbrevDecl->Tag();
         m_has_children = abbrevDecl->HasChildren();
+
+        // Most abbreviations only have forms of a fixed size, skip all of
+        // their attribute data at once.
+        uint32_t fixed_attributes_size;
+        if (abbrevDecl->GetFixedAttributesSize(cu, fixed_attributes_size))
+        {
+            *offset_ptr = offset + fixed_attributes_size;
+            return true;
+        }
+
         // Skip all data in the .debug_info for the attributes
         const uint32_t numAttributes = abbrevDecl->NumAttributes();
         uint32_t i;
@@ -160,10 +170,7 @@ DWARFDebugInfoEntry::FastExtract
 
                     case DW_FORM_strp        :
                     case DW_FORM_sec_offset  :
-                        if (cu->IsDWARF64 ())
-                            debug_info_data.GetU64 (offset_ptr);
-                        else
-                            debug_info_data.GetU32 (offset_ptr);
+                        form_size = cu->IsDWARF64 () ? 8 : 4;
                         break;
 
                     default:
@@ -494,6 +494,22 @@ DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
         return false;
     }
 
+    ParseSupportFiles (module_sp, prologue, cu_comp_dir, support_files);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// ParseSupportFiles
+//
+// Append the files of an already parsed prologue, the directories are
+// relative to the compile unit's DW_AT_comp_dir.
+//----------------------------------------------------------------------
+void
+DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
+                                   const Prologue &prologue,
+                                   const char *cu_comp_dir,
+                                   FileSpecList &support_files)
+{
     FileSpec file_spec;
     std::string remapped_file;
 
@@ -504,7 +520,6 @@ DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
         support_files.Append(file_spec);
 
     }
-    return true;
 }
 
 //----------------------------------------------------------------------
@@ -529,7 +544,8 @@ DWARFDebugLine::ParseStatementTable
 
     const dw_offset_t debug_line_offset = *offset_ptr;
 
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
                         debug_line_offset);
 
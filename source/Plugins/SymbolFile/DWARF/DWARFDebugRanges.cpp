@@ -13,10 +13,14 @@
 #include <assert.h>
 
 using namespace lldb_private;
-using namespace std;
+
+// The number of decoded range lists to keep
+static const size_t g_max_cached_range_lists = 16;
 
 DWARFDebugRanges::DWARFDebugRanges() :
-    m_range_map()
+    m_debug_ranges_data(),
+    m_range_list_cache_mutex(),
+    m_range_list_cache()
 {
 }
 
@@ -27,24 +31,17 @@ DWARFDebugRanges::~DWARFDebugRanges()
 void
 DWARFDebugRanges::Extract(SymbolFileDWARF* dwarf2Data)
 {
-    DWARFRangeList range_list;
-    lldb::offset_t offset = 0;
-    dw_offset_t debug_ranges_offset = offset;
-    while (Extract(dwarf2Data, &offset, range_list))
-    {
-        range_list.Sort();
-        m_range_map[debug_ranges_offset] = range_list;
-        debug_ranges_offset = offset;
-    }
+    // Only keep a reference to the section data, the lists are decoded
+    // by FindRanges.
+    m_debug_ranges_data = dwarf2Data->get_debug_ranges_data();
 }
 
 bool
-DWARFDebugRanges::Extract(SymbolFileDWARF* dwarf2Data, lldb::offset_t *offset_ptr, DWARFRangeList &range_list)
+DWARFDebugRanges::Extract(const DWARFDataExtractor &debug_ranges_data, lldb::offset_t *offset_ptr, DWARFRangeList &range_list)
 {
     range_list.Clear();
 
     lldb::offset_t range_offset = *offset_ptr;
-    const DWARFDataExtractor& debug_ranges_data = dwarf2Data->get_debug_ranges_data();
     uint32_t addr_size = debug_ranges_data.GetAddressByteSize();
 
     while (debug_ranges_data.ValidOffsetForDataOfSize(*offset_ptr, 2 * addr_size))
@@ -136,13 +133,26 @@ DWARFDebugRanges::Dump(Stream &s, const DWARFDataExtractor& debug_ranges_data, l
 bool
 DWARFDebugRanges::FindRanges(dw_offset_t debug_ranges_offset, DWARFRangeList& range_list) const
 {
-    range_map_const_iterator pos = m_range_map.find(debug_ranges_offset);
-    if (pos != m_range_map.end())
+    std::lock_guard<std::mutex> guard(m_range_list_cache_mutex);
+    for (RangeListCache::iterator pos = m_range_list_cache.begin(), end = m_range_list_cache.end(); pos != end; ++pos)
     {
-        range_list = pos->second;
-        return true;
+        if (pos->first == debug_ranges_offset)
+        {
+            m_range_list_cache.splice(m_range_list_cache.begin(), m_range_list_cache, pos);
+            range_list = m_range_list_cache.front().second;
+            return true;
+        }
     }
-    return false;
+
+    lldb::offset_t offset = debug_ranges_offset;
+    if (!Extract(m_debug_ranges_data, &offset, range_list))
+        return false;
+    range_list.Sort();
+
+    m_range_list_cache.push_front(std::make_pair(debug_ranges_offset, range_list));
+    if (m_range_list_cache.size() > g_max_cached_range_lists)
+        m_range_list_cache.pop_back();
+    return true;
 }
 
 
@@ -13,8 +13,16 @@
 #include "SymbolFileDWARF.h"
 #include "DWARFDIE.h"
 
-#include <map>
-
+#include <list>
+#include <mutex>
+
+//----------------------------------------------------------------------
+// The range lists of .debug_ranges are decoded from the section data
+// when they are asked for, binaries built with -ffunction-sections can
+// have millions of them and most are never needed. The lists that were
+// decoded last are kept since the DIEs of a function usually ask for the
+// same one several times. FindRanges can be called from several threads.
+//----------------------------------------------------------------------
 class DWARFDebugRanges
 {
 public:
@@ -27,15 +35,17 @@ public:
 
 protected:
 
-    bool
-    Extract (SymbolFileDWARF* dwarf2Data, 
+    static bool
+    Extract (const lldb_private::DWARFDataExtractor &debug_ranges_data,
              lldb::offset_t *offset_ptr, 
              DWARFRangeList &range_list);
 
-    typedef std::map<dw_offset_t, DWARFRangeList>   range_map;
-    typedef range_map::iterator                     range_map_iterator;
-    typedef range_map::const_iterator               range_map_const_iterator;
-    range_map m_range_map;
+    // Most recently used first
+    typedef std::list<std::pair<dw_offset_t, DWARFRangeList>> RangeListCache;
+
+    lldb_private::DWARFDataExtractor m_debug_ranges_data;
+    mutable std::mutex m_range_list_cache_mutex;
+    mutable RangeListCache m_range_list_cache;
 };
 
 
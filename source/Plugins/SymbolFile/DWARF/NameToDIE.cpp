@@ -8,7 +8,11 @@
 //===----------------------------------------------------------------------===//
 
 #include "NameToDIE.h"
+
+#include <string.h>
+
 #include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/RegularExpression.h"
@@ -94,3 +98,40 @@ NameToDIE::Append (const NameToDIE& other)
                      other.m_map.GetValueAtIndexUnchecked (i));
     }
 }
+
+void
+NameToDIE::Encode (Stream &strm) const
+{
+    const uint32_t size = m_map.GetSize();
+    strm.PutHex32 (size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        const char *cstr = m_map.GetCStringAtIndexUnchecked (i);
+        const DIERef& die_ref = m_map.GetValueAtIndexUnchecked (i);
+        strm.Write (cstr, strlen (cstr) + 1);
+        strm.PutHex32 (die_ref.cu_offset);
+        strm.PutHex32 (die_ref.die_offset);
+    }
+}
+
+bool
+NameToDIE::Decode (const DataExtractor &data, lldb::offset_t *offset_ptr)
+{
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 4))
+        return false;
+    const uint32_t size = data.GetU32 (offset_ptr);
+    // Each entry is at least a NULL terminator and two 32 bit offsets
+    if (size > data.BytesLeft (*offset_ptr) / 9)
+        return false;
+    m_map.Reserve (m_map.GetSize() + size);
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        const char *cstr = data.GetCStr (offset_ptr);
+        if (cstr == nullptr || !data.ValidOffsetForDataOfSize (*offset_ptr, 8))
+            return false;
+        const dw_offset_t cu_offset = data.GetU32 (offset_ptr);
+        const dw_offset_t die_offset = data.GetU32 (offset_ptr);
+        m_map.Append (ConstString (cstr).GetCString(), DIERef (cu_offset, die_offset));
+    }
+    return true;
+}
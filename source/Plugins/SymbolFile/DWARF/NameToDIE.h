@@ -40,6 +40,18 @@ public:
     void
     Append (const NameToDIE& other);
 
+    size_t
+    GetSize () const
+    {
+        return m_map.GetSize();
+    }
+
+    void
+    Reserve (size_t n)
+    {
+        m_map.Reserve (n);
+    }
+
     void
     Finalize();
 
@@ -55,6 +67,17 @@ public:
     void
     ForEach (std::function <bool(const char *name, const DIERef& die_ref)> const &callback) const;
 
+    //------------------------------------------------------------------
+    // Serialize the name map into a binary stream so it can be saved
+    // in the on-disk index cache, and read it back. Decode appends to
+    // the current contents; call Finalize() once all entries are in.
+    //------------------------------------------------------------------
+    void
+    Encode (lldb_private::Stream &strm) const;
+
+    bool
+    Decode (const lldb_private::DataExtractor &data, lldb::offset_t *offset_ptr);
+
 protected:
     lldb_private::UniqueCStringMap<DIERef> m_map;
 };
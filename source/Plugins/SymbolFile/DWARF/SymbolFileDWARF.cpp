@@ -11,8 +11,10 @@
 
 // Other libraries and framework includes
 #include "llvm/Support/Casting.h"
+#include "llvm/Support/FileSystem.h"
 
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
@@ -27,6 +29,8 @@
 
 #include "Plugins/ExpressionParser/Clang/ClangModulesDeclVendor.h"
 
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
 
@@ -51,9 +55,12 @@
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 
 #include "lldb/Target/Language.h"
+#include "lldb/Target/Platform.h"
 
 #include "lldb/Utility/TaskPool.h"
 
+#include "Utility/ModuleCache.h"
+
 #include "DWARFASTParser.h"
 #include "DWARFASTParserClang.h"
 #include "DWARFCompileUnit.h"
@@ -70,8 +77,11 @@
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARFDebugMap.h"
 #include "SymbolFileDWARFDwo.h"
+#include "SymbolFileDWARFDwp.h"
 
+#include <algorithm>
 #include <map>
+#include <thread>
 
 #include <ctype.h>
 #include <string.h>
@@ -112,12 +122,18 @@ namespace {
     g_properties[] =
     {
         { "comp-dir-symlink-paths" , OptionValue::eTypeFileSpecList, true,  0 ,   nullptr, nullptr, "If the DW_AT_comp_dir matches any of these paths the symbolic links will be resolved at DWARF parse time." },
+        { "use-index-cache"        , OptionValue::eTypeBoolean     , true,  false, nullptr, nullptr, "Save the manual DWARF name index to disk and reuse it in later sessions for modules that have a UUID." },
+        { "index-cache-directory"  , OptionValue::eTypeFileSpec    , true,  0 ,   nullptr, nullptr, "Root directory for the cached DWARF name indexes. Defaults to a directory next to the platform module cache." },
+        { "index-line-tables"      , OptionValue::eTypeBoolean     , true,  false, nullptr, nullptr, "Decode the line tables of all compile units in parallel when a module's DWARF is first indexed." },
         {  nullptr                 , OptionValue::eTypeInvalid     , false, 0,    nullptr, nullptr, nullptr }
     };
 
     enum
     {
-        ePropertySymLinkPaths
+        ePropertySymLinkPaths,
+        ePropertyUseIndexCache,
+        ePropertyIndexCacheDirectory,
+        ePropertyIndexLineTables
     };
 
 
@@ -144,6 +160,32 @@ namespace {
             return option_value->GetCurrentValue();
         }
 
+        bool
+        GetUseIndexCache() const
+        {
+            const uint32_t idx = ePropertyUseIndexCache;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+        }
+
+        FileSpec
+        GetIndexCacheDirectory() const
+        {
+            FileSpec dir_spec = m_collection_sp->GetPropertyAtIndexAsFileSpec(nullptr, ePropertyIndexCacheDirectory);
+            if (dir_spec)
+                return dir_spec;
+
+            dir_spec = Platform::GetGlobalPlatformProperties()->GetModuleCacheDirectory();
+            if (dir_spec)
+                dir_spec.AppendPathComponent("dwarf_index");
+            return dir_spec;
+        }
+
+        bool
+        GetIndexLineTables() const
+        {
+            const uint32_t idx = ePropertyIndexLineTables;
+            return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+        }
     };
 
     typedef std::shared_ptr<PluginProperties> SymbolFileDWARFPropertiesSP;
@@ -464,9 +506,19 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_global_index(),
     m_type_index(),
     m_namespace_index(),
-    m_indexed (false),
+    m_indexed_mask (0),
+    m_index_time (0),
+    m_pending_index (),
+    m_file_name_to_cu_index (),
+    m_line_table_prologues (),
+    m_line_table_prologues_mutex (),
+    m_dwp_symfile (),
+    m_dwp_symfile_once_flag (),
     m_using_apple_tables (false),
     m_fetched_external_modules (false),
+    m_indexed_file_names (false),
+    m_indexed_line_tables (false),
+    m_opened_dwo_files (false),
     m_supports_DW_AT_APPLE_objc_complete_type (eLazyBoolCalculate),
     m_ranges(),
     m_unique_ast_type_map ()
@@ -677,6 +729,11 @@ SymbolFileDWARF::LoadSectionData (lldb::SectionType sect_type, DWARFDataExtracto
                 if (m_obj_file->ReadSectionData(section_sp.get(), data) == 0)
                     data.Clear();
             }
+
+            // Indexing walks .debug_info from start to end, let the kernel
+            // read ahead of it.
+            if (sect_type == eSectionTypeDWARFDebugInfo)
+                data.Advise(DataBuffer::eAccessPatternSequential);
         }
     }
 }
@@ -800,7 +857,8 @@ SymbolFileDWARF::DebugInfo()
 {
     if (m_info.get() == NULL)
     {
-        Timer scoped_timer(__PRETTY_FUNCTION__, "%s this = %p",
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer(func_cat, "%s this = %p",
                            __PRETTY_FUNCTION__, static_cast<void*>(this));
         if (get_debug_info_data().GetByteSize() > 0)
         {
@@ -846,7 +904,8 @@ SymbolFileDWARF::DebugRanges()
 {
     if (m_ranges.get() == NULL)
     {
-        Timer scoped_timer(__PRETTY_FUNCTION__, "%s this = %p",
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer(func_cat, "%s this = %p",
                            __PRETTY_FUNCTION__, static_cast<void*>(this));
         if (get_debug_ranges_data().GetByteSize() > 0)
         {
@@ -1058,11 +1117,15 @@ SymbolFileDWARF::ParseCompileUnitSupportFiles (const SymbolContext& sc, FileSpec
                 // All file indexes in DWARF are one based and a file of index zero is
                 // supposed to be the compile unit itself.
                 support_files.Append (*sc.comp_unit);
-                return DWARFDebugLine::ParseSupportFiles(sc.comp_unit->GetModule(),
-                                                         get_debug_line_data(),
-                                                         cu_comp_dir,
-                                                         stmt_list,
-                                                         support_files);
+
+                DWARFDebugLine::Prologue::shared_ptr prologue = GetLineTablePrologue (stmt_list);
+                if (!prologue)
+                    return false;
+                DWARFDebugLine::ParseSupportFiles(sc.comp_unit->GetModule(),
+                                                  *prologue,
+                                                  cu_comp_dir,
+                                                  support_files);
+                return true;
             }
         }
     }
@@ -1172,6 +1235,63 @@ ParseDWARFLineTableCallback(dw_offset_t offset, const DWARFDebugLine::State& sta
     }
 }
 
+lldb::addr_t
+SymbolFileDWARF::GetLineTableAddressMask ()
+{
+    /*
+     * MIPS:
+     * The SymbolContext may not have a valid target, thus we may not be able
+     * to call Address::GetOpcodeLoadAddress() which would clear the bit #0
+     * for MIPS. Use ArchSpec to clear the bit #0.
+    */
+    ArchSpec arch;
+    GetObjectFile()->GetArchitecture(arch);
+    switch (arch.GetMachine())
+    {
+    case llvm::Triple::mips:
+    case llvm::Triple::mipsel:
+    case llvm::Triple::mips64:
+    case llvm::Triple::mips64el:
+        return ~((lldb::addr_t)1);
+    default:
+        return ~((lldb::addr_t)0);
+    }
+}
+
+LineTable *
+SymbolFileDWARF::DecodeLineTable (const DWARFDataExtractor &debug_line_data,
+                                  CompileUnit *comp_unit,
+                                  dw_offset_t cu_line_offset,
+                                  lldb::addr_t addr_mask)
+{
+    std::unique_ptr<LineTable> line_table_ap(new LineTable(comp_unit));
+    ParseDWARFLineTableCallbackInfo info;
+    info.line_table = line_table_ap.get();
+    info.addr_mask = addr_mask;
+
+    lldb::offset_t offset = cu_line_offset;
+    DWARFDebugLine::ParseStatementTable(debug_line_data, &offset, ParseDWARFLineTableCallback, &info);
+    return line_table_ap.release();
+}
+
+bool
+SymbolFileDWARF::SetCompileUnitLineTable (CompileUnit *comp_unit, LineTable *line_table)
+{
+    std::unique_ptr<LineTable> line_table_ap(line_table);
+    SymbolFileDWARFDebugMap *debug_map_symfile = GetDebugMapSymfile();
+    if (debug_map_symfile)
+    {
+        // We have an object file that has a line table with addresses
+        // that are not linked. We need to link the line table and convert
+        // the addresses that are relative to the .o file into addresses
+        // for the main executable.
+        comp_unit->SetLineTable (debug_map_symfile->LinkOSOLineTable (this, line_table_ap.get()));
+        return false;
+    }
+    comp_unit->SetLineTable(line_table_ap.release());
+    return true;
+}
+
 bool
 SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
 {
@@ -1188,56 +1308,73 @@ SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
             const dw_offset_t cu_line_offset = dwarf_cu_die.GetAttributeValueAsUnsigned(DW_AT_stmt_list, DW_INVALID_OFFSET);
             if (cu_line_offset != DW_INVALID_OFFSET)
             {
-                std::unique_ptr<LineTable> line_table_ap(new LineTable(sc.comp_unit));
-                if (line_table_ap.get())
-                {
-                    ParseDWARFLineTableCallbackInfo info;
-                    info.line_table = line_table_ap.get();
-
-                    /*
-                     * MIPS:
-                     * The SymbolContext may not have a valid target, thus we may not be able
-                     * to call Address::GetOpcodeLoadAddress() which would clear the bit #0
-                     * for MIPS. Use ArchSpec to clear the bit #0.
-                    */
-                    ArchSpec arch;
-                    GetObjectFile()->GetArchitecture(arch);
-                    switch (arch.GetMachine())
-                    {
-                    case llvm::Triple::mips:
-                    case llvm::Triple::mipsel:
-                    case llvm::Triple::mips64:
-                    case llvm::Triple::mips64el:
-                        info.addr_mask = ~((lldb::addr_t)1);
-                        break;
-                    default:
-                        info.addr_mask = ~((lldb::addr_t)0);
-                        break;
-                    }
-
-                    lldb::offset_t offset = cu_line_offset;
-                    DWARFDebugLine::ParseStatementTable(get_debug_line_data(), &offset, ParseDWARFLineTableCallback, &info);
-                    SymbolFileDWARFDebugMap *debug_map_symfile = GetDebugMapSymfile();
-                    if (debug_map_symfile)
-                    {
-                        // We have an object file that has a line table with addresses
-                        // that are not linked. We need to link the line table and convert
-                        // the addresses that are relative to the .o file into addresses
-                        // for the main executable.
-                        sc.comp_unit->SetLineTable (debug_map_symfile->LinkOSOLineTable (this, line_table_ap.get()));
-                    }
-                    else
-                    {
-                        sc.comp_unit->SetLineTable(line_table_ap.release());
-                        return true;
-                    }
-                }
+                LineTable *line_table = DecodeLineTable (get_debug_line_data(), sc.comp_unit, cu_line_offset, GetLineTableAddressMask());
+                return SetCompileUnitLineTable (sc.comp_unit, line_table);
             }
         }
     }
     return false;
 }
 
+void
+SymbolFileDWARF::ParseAllLineTables ()
+{
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL)
+        return;
+
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
+                        "SymbolFileDWARF::ParseAllLineTables (%s)",
+                        GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    // Making the compile units and loading the line table data isn't
+    // thread safe, do that here and only decode the line programs on the
+    // TaskPool.
+    struct PendingLineTable
+    {
+        CompileUnit *comp_unit;
+        dw_offset_t cu_line_offset;
+        LineTable *line_table;
+    };
+    std::vector<PendingLineTable> pending;
+    OpenDwoFilesIfNeeded ();
+
+    const DWARFDataExtractor &debug_line_data = get_debug_line_data();
+    const lldb::addr_t addr_mask = GetLineTableAddressMask();
+    const size_t num_cus = debug_info->GetNumCompileUnits();
+    for (uint32_t cu_idx = 0; cu_idx < num_cus; ++cu_idx)
+    {
+        DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        CompileUnit *comp_unit = dwarf_cu ? GetCompUnitForDWARFCompUnit(dwarf_cu, cu_idx) : NULL;
+        if (comp_unit == NULL || comp_unit->HasParsedLineTable())
+            continue;
+
+        const DWARFDIE cu_die = dwarf_cu->GetCompileUnitDIEOnly();
+        const dw_offset_t cu_line_offset = cu_die ? cu_die.GetAttributeValueAsUnsigned(DW_AT_stmt_list, DW_INVALID_OFFSET)
+                                                  : DW_INVALID_OFFSET;
+        if (cu_line_offset == DW_INVALID_OFFSET)
+            continue;
+
+        PendingLineTable line_table = { comp_unit, cu_line_offset, NULL };
+        pending.push_back(line_table);
+    }
+
+    TaskRunner<void> task_runner;
+    for (PendingLineTable &line_table : pending)
+    {
+        task_runner.AddTask([&debug_line_data, addr_mask, &line_table]() {
+            line_table.line_table = DecodeLineTable (debug_line_data, line_table.comp_unit, line_table.cu_line_offset, addr_mask);
+        });
+    }
+    task_runner.WaitForAllTasks();
+
+    // Linking the line tables of a debug map goes through the debug map's
+    // shared state, hand the line tables over in order here.
+    for (PendingLineTable &line_table : pending)
+        SetCompileUnitLineTable (line_table.comp_unit, line_table.line_table);
+}
+
 lldb_private::DebugMacrosSP
 SymbolFileDWARF::ParseDebugMacros(lldb::offset_t *offset)
 {
@@ -1712,8 +1849,7 @@ SymbolFileDWARF::GetObjCMethodDIEOffsets (ConstString class_name, DIEArray &meth
     }
     else
     {
-        if (!m_indexed)
-            Index ();
+        Index (eIndexFunctions);
 
         m_objc_class_selectors_index.Find (class_name, method_die_offsets);
     }
@@ -1769,6 +1905,17 @@ SymbolFileDWARF::GetDIE (const DIERef &die_ref)
 std::unique_ptr<SymbolFileDWARFDwo>
 SymbolFileDWARF::GetDwoSymbolFileForCompileUnit(DWARFCompileUnit &dwarf_cu, const DWARFDebugInfoEntry &cu_die)
 {
+    // A DWARF package has the split units of all compile units in one file,
+    // prefer it over the .dwo files.
+    SymbolFileDWARFDwp *dwp_symfile = GetDwpSymbolFile();
+    if (dwp_symfile)
+    {
+        const uint64_t dwo_id = cu_die.GetAttributeValueAsUnsigned(this, &dwarf_cu, DW_AT_GNU_dwo_id, 0);
+        std::unique_ptr<SymbolFileDWARFDwo> dwo_symfile = dwp_symfile->GetSymbolFileForDwoId(dwarf_cu, dwo_id);
+        if (dwo_symfile)
+            return dwo_symfile;
+    }
+
     const char *dwo_name = cu_die.GetAttributeValueAsString(this, &dwarf_cu, DW_AT_GNU_dwo_name, nullptr);
     if (!dwo_name)
         return nullptr;
@@ -1798,13 +1945,65 @@ SymbolFileDWARF::GetDwoSymbolFileForCompileUnit(DWARFCompileUnit &dwarf_cu, cons
     return llvm::make_unique<SymbolFileDWARFDwo>(dwo_obj_file, &dwarf_cu);
 }
 
+SymbolFileDWARFDwp *
+SymbolFileDWARF::GetDwpSymbolFile ()
+{
+    // The .dwo files are opened on the TaskPool, so this can be called on
+    // many threads at once.
+    std::call_once(m_dwp_symfile_once_flag, [this]()
+    {
+        ModuleSP module_sp (m_obj_file->GetModule());
+        if (!module_sp)
+            return;
+
+        // The package is named after the executable, look next to it and
+        // next to the symbol file if that is a different file.
+        FileSpec dwp_file_specs[2] = { module_sp->GetFileSpec(), m_obj_file->GetFileSpec() };
+        for (uint32_t i = 0; i < 2 && !m_dwp_symfile; ++i)
+        {
+            if (i > 0 && dwp_file_specs[i] == dwp_file_specs[0])
+                break;
+
+            FileSpec dwp_file_spec (dwp_file_specs[i].GetPath() + ".dwp", false);
+            if (dwp_file_spec.Exists())
+                m_dwp_symfile = SymbolFileDWARFDwp::Create(module_sp, dwp_file_spec);
+        }
+    });
+    return m_dwp_symfile.get();
+}
+
+void
+SymbolFileDWARF::OpenDwoFilesIfNeeded ()
+{
+    if (m_opened_dwo_files)
+        return;
+    m_opened_dwo_files = true;
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL)
+        return;
+
+    // Extracting the compile unit DIE opens the .dwo file of the compile
+    // unit.
+    TaskRunner<void> task_runner;
+    const size_t num_cus = debug_info->GetNumCompileUnits();
+    for (uint32_t cu_idx = 0; cu_idx < num_cus; ++cu_idx)
+    {
+        DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        task_runner.AddTask([dwarf_cu]() { dwarf_cu->ExtractDIEsIfNeeded(true); });
+    }
+    task_runner.WaitForAllTasks();
+}
+
 void
 SymbolFileDWARF::UpdateExternalModuleListIfNeeded()
 {
     if (m_fetched_external_modules)
         return;
     m_fetched_external_modules = true;
-    
+
+    OpenDwoFilesIfNeeded ();
+
     DWARFDebugInfo * debug_info = DebugInfo();
 
     const uint32_t num_compile_units = GetNumCompileUnits();
@@ -1893,7 +2092,8 @@ SymbolFileDWARF::GetGlobalAranges()
 uint32_t
 SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_scope, SymbolContext& sc)
 {
-    Timer scoped_timer(__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer(func_cat,
                        "SymbolFileDWARF::ResolveSymbolContext (so_addr = { section = %p, offset = 0x%" PRIx64 " }, resolve_scope = 0x%8.8x)",
                        static_cast<void*>(so_addr.GetSection().get()),
                        so_addr.GetOffset(), resolve_scope);
@@ -2044,11 +2244,24 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
         DWARFDebugInfo* debug_info = DebugInfo();
         if (debug_info)
         {
-            uint32_t cu_idx;
-            DWARFCompileUnit* dwarf_cu = NULL;
+            // Only the compile units that list a file of this name can
+            // match. Source remappings and case insensitive paths can make
+            // other names match, search all compile units for those.
+            std::vector<uint32_t> cu_indexes;
+            const bool use_file_name_index = file_spec.GetFilename() &&
+                                             file_spec.IsCaseSensitive() &&
+                                             m_obj_file->GetModule()->GetSourceMappingList().IsEmpty();
+            if (use_file_name_index)
+                FindCompileUnitsForFileName (file_spec.GetFilename(), cu_indexes);
+            const size_t num_cus = use_file_name_index ? cu_indexes.size() : debug_info->GetNumCompileUnits();
 
-            for (cu_idx = 0; (dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
+            for (size_t i = 0; i < num_cus; ++i)
             {
+                const uint32_t cu_idx = use_file_name_index ? cu_indexes[i] : i;
+                DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+                if (dwarf_cu == NULL)
+                    break;
+
                 CompileUnit *dc_cu = GetCompUnitForDWARFCompUnit(dwarf_cu, cu_idx);
                 const bool full_match = (bool)file_spec.GetDirectory();
                 bool file_spec_matches_cu_file_spec = dc_cu != NULL && FileSpec::Equal(file_spec, *dc_cu, full_match);
@@ -2148,105 +2361,400 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
     return sc_list.GetSize() - prev_size;
 }
 
+// Returns the part of path after the last path separator.
+static const char *
+GetPathBaseName (const char *path)
+{
+    const char *base_name = path;
+    for (const char *p = path; *p; ++p)
+    {
+        if (*p == '/' || *p == '\\')
+            base_name = p + 1;
+    }
+    return base_name;
+}
+
 void
-SymbolFileDWARF::Index ()
+SymbolFileDWARF::FindCompileUnitsForFileName (const ConstString &file_name, std::vector<uint32_t> &cu_indexes)
 {
-    if (m_indexed)
-        return;
-    m_indexed = true;
-    Timer scoped_timer (__PRETTY_FUNCTION__,
-                        "SymbolFileDWARF::Index (%s)",
-                        GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+    cu_indexes.clear();
 
     DWARFDebugInfo* debug_info = DebugInfo();
-    if (debug_info)
+    if (debug_info == NULL)
+        return;
+
+    if (!m_indexed_file_names)
     {
-        const uint32_t num_compile_units = GetNumCompileUnits();
-        std::vector<NameToDIE> function_basename_index(num_compile_units);
-        std::vector<NameToDIE> function_fullname_index(num_compile_units);
-        std::vector<NameToDIE> function_method_index(num_compile_units);
-        std::vector<NameToDIE> function_selector_index(num_compile_units);
-        std::vector<NameToDIE> objc_class_selectors_index(num_compile_units);
-        std::vector<NameToDIE> global_index(num_compile_units);
-        std::vector<NameToDIE> type_index(num_compile_units);
-        std::vector<NameToDIE> namespace_index(num_compile_units);
-        
-        auto parser_fn = [this,
-                          debug_info,
-                          &function_basename_index,
-                          &function_fullname_index,
-                          &function_method_index,
-                          &function_selector_index,
-                          &objc_class_selectors_index,
-                          &global_index,
-                          &type_index,
-                          &namespace_index](uint32_t cu_idx)
+        m_indexed_file_names = true;
+        OpenDwoFilesIfNeeded ();
+
+        const size_t num_cus = debug_info->GetNumCompileUnits();
+        for (uint32_t cu_idx = 0; cu_idx < num_cus; ++cu_idx)
         {
             DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-            bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded(false) > 1;
-
-            dwarf_cu->Index(function_basename_index[cu_idx],
-                            function_fullname_index[cu_idx],
-                            function_method_index[cu_idx],
-                            function_selector_index[cu_idx],
-                            objc_class_selectors_index[cu_idx],
-                            global_index[cu_idx],
-                            type_index[cu_idx],
-                            namespace_index[cu_idx]);
-
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                dwarf_cu->ClearDIEs(true);
-
-            return cu_idx;
-        };
-
-        TaskRunner<uint32_t> task_runner;
-        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
-            task_runner.AddTask(parser_fn, cu_idx);
+            const DWARFDIE cu_die = dwarf_cu ? dwarf_cu->GetCompileUnitDIEOnly() : DWARFDIE();
+            if (!cu_die)
+                continue;
 
-        while (true)
+            const char *cu_name = cu_die.GetAttributeValueAsString(DW_AT_name, NULL);
+            if (cu_name && cu_name[0])
+                m_file_name_to_cu_index.Append (ConstString(GetPathBaseName(cu_name)).GetCString(), cu_idx);
+
+            const dw_offset_t stmt_list = cu_die.GetAttributeValueAsUnsigned(DW_AT_stmt_list, DW_INVALID_OFFSET);
+            if (stmt_list == DW_INVALID_OFFSET)
+                continue;
+
+            DWARFDebugLine::Prologue::shared_ptr prologue = GetLineTablePrologue (stmt_list);
+            if (!prologue)
+                continue;
+
+            for (const DWARFDebugLine::FileNameEntry &file_entry : prologue->file_names)
+                m_file_name_to_cu_index.Append (ConstString(GetPathBaseName(file_entry.name)).GetCString(), cu_idx);
+        }
+        m_file_name_to_cu_index.Sort();
+    }
+
+    // A compile unit is listed once for each of its files with the name.
+    m_file_name_to_cu_index.GetValues (file_name.GetCString(), cu_indexes);
+    std::sort (cu_indexes.begin(), cu_indexes.end());
+    cu_indexes.erase (std::unique (cu_indexes.begin(), cu_indexes.end()), cu_indexes.end());
+}
+
+DWARFDebugLine::Prologue::shared_ptr
+SymbolFileDWARF::GetLineTablePrologue (dw_offset_t stmt_list)
+{
+    std::lock_guard<std::mutex> guard(m_line_table_prologues_mutex);
+    LineTablePrologueMap::iterator pos = m_line_table_prologues.find(stmt_list);
+    if (pos != m_line_table_prologues.end())
+        return pos->second;
+
+    DWARFDebugLine::Prologue::shared_ptr prologue (new DWARFDebugLine::Prologue());
+    lldb::offset_t offset = stmt_list;
+    if (!DWARFDebugLine::ParsePrologue(get_debug_line_data(), &offset, prologue.get()))
+    {
+        Host::SystemLog (Host::eSystemLogError, "error: parsing line table prologue at 0x%8.8x (parsing ended around 0x%8.8" PRIx64 "\n", stmt_list, offset);
+        prologue.reset();
+    }
+    m_line_table_prologues[stmt_list] = prologue;
+    return prologue;
+}
+
+void
+SymbolFileDWARF::Index (uint32_t index_mask)
+{
+    // Finish an index that was being built in the background first, the
+    // compile units it already did don't have to be parsed again.
+    if (m_pending_index)
+    {
+        IntervalTimer index_timer;
+        FinishIndex (TaskPool::ePriorityHigh);
+        m_index_time += index_timer.GetElapsedNanoSeconds();
+    }
+
+    index_mask &= ~m_indexed_mask;
+    if (index_mask == 0)
+    {
+        IndexLineTablesIfNeeded ();
+        return;
+    }
+
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
+                        "SymbolFileDWARF::Index (%s, 0x%x)",
+                        GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"),
+                        index_mask);
+    IntervalTimer index_timer;
+    if (StartIndex (index_mask))
+        FinishIndex (TaskPool::ePriorityNormal);
+    m_index_time += index_timer.GetElapsedNanoSeconds();
+    IndexLineTablesIfNeeded ();
+}
+
+void
+SymbolFileDWARF::IndexLineTablesIfNeeded ()
+{
+    // Lookups that index the DWARF usually go on to the line tables, like
+    // file and line breakpoints and symbolication do.
+    if (m_indexed_line_tables || !GetGlobalPluginProperties()->GetIndexLineTables())
+        return;
+    m_indexed_line_tables = true;
+    ParseAllLineTables ();
+}
+
+bool
+SymbolFileDWARF::StartIndex (uint32_t index_mask)
+{
+    // The on-disk cache always holds the complete index, so when it is in use
+    // we load or build all of the tables at once.
+    FileSpec cache_file_spec;
+    const bool use_index_cache = m_indexed_mask == 0 && GetIndexCacheFileSpec (cache_file_spec);
+    if (use_index_cache)
+    {
+        m_indexed_mask = eIndexAll;
+        if (LoadIndexCache())
+            return false;
+        index_mask = eIndexAll;
+    }
+    m_indexed_mask |= index_mask;
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == nullptr)
+        return false;
+
+    m_pending_index.reset (new PendingIndex (index_mask, use_index_cache, GetNumCompileUnits()));
+    return true;
+}
+
+void
+SymbolFileDWARF::IndexCompileUnits (uint32_t end_cu_idx, TaskPool::Priority priority)
+{
+    PendingIndex &pending = *m_pending_index;
+    end_cu_idx = std::min<uint32_t> (end_cu_idx, pending.num_compile_units);
+    if (pending.next_cu_idx >= end_cu_idx)
+        return;
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    const uint32_t index_mask = pending.index_mask;
+    auto parser_fn = [debug_info, index_mask, &pending](uint32_t cu_idx)
+    {
+        DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        bool clear_dies = dwarf_cu->ExtractDIEsIfNeeded(false) > 1;
+
+        dwarf_cu->Index(index_mask,
+                        pending.function_basename_index[cu_idx],
+                        pending.function_fullname_index[cu_idx],
+                        pending.function_method_index[cu_idx],
+                        pending.function_selector_index[cu_idx],
+                        pending.objc_class_selectors_index[cu_idx],
+                        pending.global_index[cu_idx],
+                        pending.type_index[cu_idx],
+                        pending.namespace_index[cu_idx]);
+
+        // Keep memory down by clearing DIEs if this generate function
+        // caused them to be parsed
+        if (clear_dies)
+            dwarf_cu->ClearDIEs(true);
+
+        return cu_idx;
+    };
+
+    TaskRunner<uint32_t> task_runner(priority);
+    for (uint32_t cu_idx = pending.next_cu_idx; cu_idx < end_cu_idx; ++cu_idx)
+        task_runner.AddTask(parser_fn, cu_idx);
+    task_runner.WaitForAllTasks();
+    pending.next_cu_idx = end_cu_idx;
+}
+
+void
+SymbolFileDWARF::FinishIndex (TaskPool::Priority priority)
+{
+    IndexCompileUnits (m_pending_index->num_compile_units, priority);
+
+    // Anything the merge calls back into must see the index as done.
+    std::unique_ptr<PendingIndex> pending_ap (std::move (m_pending_index));
+    PendingIndex &pending = *pending_ap;
+    const uint32_t index_mask = pending.index_mask;
+    const uint32_t num_compile_units = pending.num_compile_units;
+
+    // Merge the per compile unit results into the final tables, one task
+    // per table. The compile units are appended in order so the contents
+    // of each table don't depend on the order the parser tasks finished.
+    auto merge_fn = [index_mask, num_compile_units](uint32_t mask, NameToDIE &index, std::vector<NameToDIE> &cu_indexes)
+    {
+        if ((index_mask & mask) == 0)
+            return;
+
+        size_t total_size = index.GetSize();
+        for (const NameToDIE &cu_index : cu_indexes)
+            total_size += cu_index.GetSize();
+        index.Reserve(total_size);
+
+        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
         {
-            std::future<uint32_t> f = task_runner.WaitForNextCompletedTask();
-            if (!f.valid())
-                break;
-            uint32_t cu_idx = f.get();
-
-            m_function_basename_index.Append(function_basename_index[cu_idx]);
-            m_function_fullname_index.Append(function_fullname_index[cu_idx]);
-            m_function_method_index.Append(function_method_index[cu_idx]);
-            m_function_selector_index.Append(function_selector_index[cu_idx]);
-            m_objc_class_selectors_index.Append(objc_class_selectors_index[cu_idx]);
-            m_global_index.Append(global_index[cu_idx]);
-            m_type_index.Append(type_index[cu_idx]);
-            m_namespace_index.Append(namespace_index[cu_idx]);
+            index.Append(cu_indexes[cu_idx]);
+            cu_indexes[cu_idx] = NameToDIE();
         }
+        index.Finalize();
+    };
+
+    TaskPool::RunTasks(
+        [&]() { merge_fn(eIndexFunctions, m_function_basename_index, pending.function_basename_index); },
+        [&]() { merge_fn(eIndexFunctions, m_function_fullname_index, pending.function_fullname_index); },
+        [&]() { merge_fn(eIndexFunctions, m_function_method_index, pending.function_method_index); },
+        [&]() { merge_fn(eIndexFunctions, m_function_selector_index, pending.function_selector_index); },
+        [&]() { merge_fn(eIndexFunctions, m_objc_class_selectors_index, pending.objc_class_selectors_index); },
+        [&]() { merge_fn(eIndexGlobals, m_global_index, pending.global_index); },
+        [&]() { merge_fn(eIndexTypes, m_type_index, pending.type_index); },
+        [&]() { merge_fn(eIndexNamespaces, m_namespace_index, pending.namespace_index); });
+
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+    if (log)
+        log->Printf ("SymbolFileDWARF::Index (%s) DIE arrays use %" PRIu64 " bytes (peak %" PRIu64 " bytes)",
+                     GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"),
+                     (uint64_t)DWARFCompileUnit::GetDIEArrayMemoryUsage(),
+                     (uint64_t)DWARFCompileUnit::GetDIEArrayPeakMemoryUsage());
 
-        TaskPool::RunTasks(
-            [&]() { m_function_basename_index.Finalize(); },
-            [&]() { m_function_fullname_index.Finalize(); },
-            [&]() { m_function_method_index.Finalize(); },
-            [&]() { m_function_selector_index.Finalize(); },
-            [&]() { m_objc_class_selectors_index.Finalize(); },
-            [&]() { m_global_index.Finalize(); },
-            [&]() { m_type_index.Finalize(); },
-            [&]() { m_namespace_index.Finalize(); });
+    if (pending.use_index_cache)
+        SaveIndexCache();
 
 #if defined (ENABLE_DEBUG_PRINTF)
-        StreamFile s(stdout, false);
-        s.Printf ("DWARF index for '%s':",
-                  GetObjectFile()->GetFileSpec().GetPath().c_str());
-        s.Printf("\nFunction basenames:\n");    m_function_basename_index.Dump (&s);
-        s.Printf("\nFunction fullnames:\n");    m_function_fullname_index.Dump (&s);
-        s.Printf("\nFunction methods:\n");      m_function_method_index.Dump (&s);
-        s.Printf("\nFunction selectors:\n");    m_function_selector_index.Dump (&s);
-        s.Printf("\nObjective C class selectors:\n");    m_objc_class_selectors_index.Dump (&s);
-        s.Printf("\nGlobals and statics:\n");   m_global_index.Dump (&s); 
-        s.Printf("\nTypes:\n");                 m_type_index.Dump (&s);
-        s.Printf("\nNamespaces:\n")             m_namespace_index.Dump (&s);
+    StreamFile s(stdout, false);
+    s.Printf ("DWARF index for '%s':",
+              GetObjectFile()->GetFileSpec().GetPath().c_str());
+    s.Printf("\nFunction basenames:\n");    m_function_basename_index.Dump (&s);
+    s.Printf("\nFunction fullnames:\n");    m_function_fullname_index.Dump (&s);
+    s.Printf("\nFunction methods:\n");      m_function_method_index.Dump (&s);
+    s.Printf("\nFunction selectors:\n");    m_function_selector_index.Dump (&s);
+    s.Printf("\nObjective C class selectors:\n");    m_objc_class_selectors_index.Dump (&s);
+    s.Printf("\nGlobals and statics:\n");   m_global_index.Dump (&s); 
+    s.Printf("\nTypes:\n");                 m_type_index.Dump (&s);
+    s.Printf("\nNamespaces:\n")             m_namespace_index.Dump (&s);
 #endif
+}
+
+namespace {
+
+    // Bump this whenever the contents of the index or the encoding changes
+    const char *g_index_cache_magic = "LLDBDWIX";
+    const uint32_t g_index_cache_version = 1;
+
+}  // anonymous namespace
+
+bool
+SymbolFileDWARF::GetIndexCacheFileSpec (FileSpec &cache_file_spec)
+{
+    if (!GetGlobalPluginProperties()->GetUseIndexCache())
+        return false;
+
+    // .o files in a debug map don't have a UUID of their own and are
+    // cheap to index anyway.
+    if (GetDebugMapSymfile())
+        return false;
+
+    ModuleSP module_sp (m_obj_file->GetModule());
+    if (!module_sp || !module_sp->GetUUID().IsValid())
+        return false;
+
+    const FileSpec &obj_file_spec = m_obj_file->GetFileSpec();
+    const TimeValue mod_time = obj_file_spec.GetModificationTime();
+    if (!mod_time.IsValid())
+        return false;
+
+    FileSpec dir_spec = GetGlobalPluginProperties()->GetIndexCacheDirectory();
+    if (!dir_spec)
+        return false;
+
+    // The DWARF can live in a separate file (dSYM, .debug, .dwo) so the
+    // file that contains it is part of the key along with the UUID.
+    StreamString file_name;
+    file_name.Printf ("%s-%s-%" PRIu64 ".index",
+                      module_sp->GetUUID().GetAsString().c_str(),
+                      obj_file_spec.GetFilename().AsCString("<Unknown>"),
+                      mod_time.GetAsSecondsSinceJan1_1970());
+    cache_file_spec = dir_spec;
+    cache_file_spec.AppendPathComponent (file_name.GetData());
+    return true;
+}
+
+bool
+SymbolFileDWARF::LoadIndexCache ()
+{
+    FileSpec cache_file_spec;
+    if (!GetIndexCacheFileSpec (cache_file_spec) || !cache_file_spec.Exists())
+        return false;
+
+    // The index is memory mapped so that concurrent debug sessions share
+    // the pages of the cache file.
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS));
+    DataBufferSP data_sp = ModuleCache::MapDataFile (cache_file_spec);
+    if (!data_sp)
+        return false;
+
+    DataExtractor data (data_sp, endian::InlHostByteOrder(), 4);
+    lldb::offset_t offset = 0;
+    const size_t magic_len = strlen (g_index_cache_magic);
+    const char *magic = (const char *)data.GetData (&offset, magic_len);
+    const uint32_t version = data.GetU32 (&offset);
+    const uint32_t num_compile_units = data.GetU32 (&offset);
+    bool success = magic != nullptr &&
+                   ::memcmp (magic, g_index_cache_magic, magic_len) == 0 &&
+                   version == g_index_cache_version &&
+                   num_compile_units == GetNumCompileUnits();
+
+    NameToDIE *indexes[] = { &m_function_basename_index,
+                             &m_function_fullname_index,
+                             &m_function_method_index,
+                             &m_function_selector_index,
+                             &m_objc_class_selectors_index,
+                             &m_global_index,
+                             &m_type_index,
+                             &m_namespace_index };
+    for (NameToDIE *index : indexes)
+    {
+        if (!success)
+            break;
+        success = index->Decode (data, &offset);
     }
+
+    if (!success)
+    {
+        // Don't leave a partially loaded index behind, Index() will
+        // rebuild everything from the DWARF.
+        for (NameToDIE *index : indexes)
+            *index = NameToDIE();
+        if (log)
+            log->Printf ("SymbolFileDWARF::LoadIndexCache() ignoring invalid cache file '%s'",
+                         cache_file_spec.GetPath().c_str());
+        return false;
+    }
+
+    TaskPool::RunTasks(
+        [&]() { m_function_basename_index.Finalize(); },
+        [&]() { m_function_fullname_index.Finalize(); },
+        [&]() { m_function_method_index.Finalize(); },
+        [&]() { m_function_selector_index.Finalize(); },
+        [&]() { m_objc_class_selectors_index.Finalize(); },
+        [&]() { m_global_index.Finalize(); },
+        [&]() { m_type_index.Finalize(); },
+        [&]() { m_namespace_index.Finalize(); });
+
+    if (log)
+        log->Printf ("SymbolFileDWARF::LoadIndexCache() loaded index from '%s'",
+                     cache_file_spec.GetPath().c_str());
+    return true;
+}
+
+void
+SymbolFileDWARF::SaveIndexCache ()
+{
+    FileSpec cache_file_spec;
+    if (!GetIndexCacheFileSpec (cache_file_spec))
+        return;
+
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_LOOKUPS));
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    strm.Write (g_index_cache_magic, strlen (g_index_cache_magic));
+    strm.PutHex32 (g_index_cache_version);
+    strm.PutHex32 (GetNumCompileUnits());
+    m_function_basename_index.Encode (strm);
+    m_function_fullname_index.Encode (strm);
+    m_function_method_index.Encode (strm);
+    m_function_selector_index.Encode (strm);
+    m_objc_class_selectors_index.Encode (strm);
+    m_global_index.Encode (strm);
+    m_type_index.Encode (strm);
+    m_namespace_index.Encode (strm);
+
+    const std::string cache_path = cache_file_spec.GetPath();
+    Error error = ModuleCache::WriteDataFile (cache_file_spec, strm.GetData(), strm.GetSize());
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf ("SymbolFileDWARF::SaveIndexCache() failed to write '%s': %s",
+                         cache_path.c_str(), error.AsCString());
+    }
+    else if (log)
+        log->Printf ("SymbolFileDWARF::SaveIndexCache() saved index to '%s'", cache_path.c_str());
 }
 
 bool
@@ -2320,8 +2828,7 @@ SymbolFileDWARF::FindGlobalVariables (const ConstString &name, const CompilerDec
     else
     {
         // Index the DWARF if we haven't already
-        if (!m_indexed)
-            Index ();
+        Index (eIndexGlobals);
 
         m_global_index.Find (name, die_offsets);
     }
@@ -2437,8 +2944,7 @@ SymbolFileDWARF::FindGlobalVariables(const RegularExpression& regex, bool append
     else
     {
         // Index the DWARF if we haven't already
-        if (!m_indexed)
-            Index ();
+        Index (eIndexGlobals);
         
         m_global_index.Find (regex, die_offsets);
     }
@@ -2640,7 +3146,8 @@ SymbolFileDWARF::FindFunctions (const ConstString &name,
                                 bool append, 
                                 SymbolContextList& sc_list)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolFileDWARF::FindFunctions (name = '%s')",
                         name.AsCString());
 
@@ -2837,8 +3344,7 @@ SymbolFileDWARF::FindFunctions (const ConstString &name,
     {
 
         // Index the DWARF if we haven't already
-        if (!m_indexed)
-            Index ();
+        Index (eIndexFunctions);
 
         if (name_type_mask & eFunctionNameTypeFull)
         {
@@ -2955,7 +3461,8 @@ SymbolFileDWARF::FindFunctions (const ConstString &name,
 uint32_t
 SymbolFileDWARF::FindFunctions(const RegularExpression& regex, bool include_inlines, bool append, SymbolContextList& sc_list)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolFileDWARF::FindFunctions (regex = '%s')",
                         regex.GetText());
 
@@ -2986,8 +3493,7 @@ SymbolFileDWARF::FindFunctions(const RegularExpression& regex, bool include_inli
     else
     {
         // Index the DWARF if we haven't already
-        if (!m_indexed)
-            Index ();
+        Index (eIndexFunctions);
 
         FindFunctions (regex, m_function_basename_index, include_inlines, sc_list);
 
@@ -2998,6 +3504,138 @@ SymbolFileDWARF::FindFunctions(const RegularExpression& regex, bool include_inli
     return sc_list.GetSize() - original_size;
 }
 
+void
+SymbolFileDWARF::PreloadSymbols ()
+{
+    std::lock_guard<std::recursive_mutex> guard(GetObjectFile()->GetModule()->GetMutex());
+    // The accelerator tables need no index. Otherwise only build the
+    // function tables, which is what resolving breakpoints looks at.
+    if (!m_using_apple_tables)
+        Index (eIndexFunctions);
+}
+
+bool
+SymbolFileDWARF::PreloadSymbolsStep ()
+{
+    std::lock_guard<std::recursive_mutex> guard(GetObjectFile()->GetModule()->GetMutex());
+    if (m_using_apple_tables)
+        return false;
+
+    IntervalTimer index_timer;
+    if (!m_pending_index && ((m_indexed_mask & eIndexFunctions) || !StartIndex (eIndexFunctions)))
+    {
+        m_index_time += index_timer.GetElapsedNanoSeconds();
+        return false;
+    }
+
+    // Do one compile unit per pool thread at a time, a lookup waiting for
+    // the module only has to wait for those. The lookup finishes the rest
+    // itself if it needs the index.
+    const uint32_t num_threads = std::max<uint32_t> (std::thread::hardware_concurrency(), 1);
+    IndexCompileUnits (m_pending_index->next_cu_idx + num_threads, TaskPool::ePriorityLow);
+    const bool more = m_pending_index->next_cu_idx < m_pending_index->num_compile_units;
+    if (!more)
+        FinishIndex (TaskPool::ePriorityLow);
+    m_index_time += index_timer.GetElapsedNanoSeconds();
+    return more;
+}
+
+void
+SymbolFileDWARF::GetStatistics (StructuredData::Dictionary &stats)
+{
+    std::lock_guard<std::recursive_mutex> guard(GetObjectFile()->GetModule()->GetMutex());
+
+    stats.AddFloatItem ("debug_info_index_time", m_index_time / 1000000000.0);
+    stats.AddBooleanItem ("debug_info_uses_accelerator_tables", m_using_apple_tables);
+
+    uint64_t num_dies = 0;
+    uint64_t die_memory = 0;
+    DWARFDebugInfo *debug_info = m_info.get();
+    if (debug_info)
+    {
+        const size_t num_compile_units = debug_info->GetNumCompileUnits();
+        for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+        {
+            DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+            num_dies += dwarf_cu->GetNumDIEs();
+            die_memory += dwarf_cu->GetDIEArrayMemorySize();
+        }
+    }
+    stats.AddIntegerItem ("dwarf_die_count", num_dies);
+    stats.AddIntegerItem ("dwarf_die_memory", die_memory);
+}
+
+size_t
+SymbolFileDWARF::GetCachedDataMemorySize ()
+{
+    std::lock_guard<std::recursive_mutex> guard(GetObjectFile()->GetModule()->GetMutex());
+
+    size_t die_memory = 0;
+    DWARFDebugInfo *debug_info = m_info.get();
+    if (debug_info)
+    {
+        const size_t num_compile_units = debug_info->GetNumCompileUnits();
+        for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+        {
+            DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+            die_memory += dwarf_cu->GetDIEArrayMemorySize();
+            SymbolFileDWARFDwo *dwo = dwarf_cu->GetDwoSymbolFile();
+            if (dwo)
+                die_memory += dwo->GetCompileUnit()->GetDIEArrayMemorySize();
+        }
+    }
+    return die_memory;
+}
+
+size_t
+SymbolFileDWARF::ReleaseCachedData ()
+{
+    ModuleSP module_sp (GetObjectFile()->GetModule());
+    std::lock_guard<std::recursive_mutex> guard(module_sp->GetMutex());
+
+    // The background index extracts and clears the DIEs itself.
+    DWARFDebugInfo *debug_info = m_info.get();
+    if (debug_info == nullptr || m_pending_index)
+        return 0;
+
+    // Types, variables and the declarations of the AST parsers point to
+    // their DIEs. Only the compile units none of them points into can
+    // let go of their DIEs, they are extracted again when they are needed.
+    std::vector<const DWARFDebugInfoEntry *> dies_in_use;
+    for (const auto &pair : m_die_to_type)
+        dies_in_use.push_back(pair.first);
+    for (const auto &pair : m_die_to_variable_sp)
+        dies_in_use.push_back(pair.first);
+    for (const auto &pair : m_forward_decl_die_to_clang_type)
+        dies_in_use.push_back(pair.first);
+
+    bool parsers_know_their_dies = true;
+    module_sp->ForEachTypeSystem ([&dies_in_use, &parsers_know_their_dies](TypeSystem *type_system) -> bool {
+        DWARFASTParser *dwarf_ast_parser = type_system->GetDWARFParser();
+        if (dwarf_ast_parser && !dwarf_ast_parser->GetDIEsInUse(dies_in_use))
+            parsers_know_their_dies = false;
+        return parsers_know_their_dies;
+    });
+    if (!parsers_know_their_dies)
+        return 0;
+    std::sort (dies_in_use.begin(), dies_in_use.end());
+
+    size_t released = 0;
+    const size_t num_compile_units = debug_info->GetNumCompileUnits();
+    for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+    {
+        DWARFCompileUnit *dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        // The DIEs of split DWARF units are looked up through the DWO
+        // file too, leave them alone.
+        if (!dwarf_cu->HasDIEsParsed() || dwarf_cu->GetDwoSymbolFile() || dwarf_cu->ContainsAnyDIE(dies_in_use))
+            continue;
+        const size_t die_memory = dwarf_cu->GetDIEArrayMemorySize();
+        dwarf_cu->ClearDIEs(true);
+        released += die_memory - dwarf_cu->GetDIEArrayMemorySize();
+    }
+    return released;
+}
+
 void
 SymbolFileDWARF::GetMangledNamesForFunction (const std::string &scope_qualified_name,
                                              std::vector<ConstString> &mangled_names)
@@ -3031,6 +3669,27 @@ SymbolFileDWARF::GetMangledNamesForFunction (const std::string &scope_qualified_
     }
 }
 
+void
+SymbolFileDWARF::GetFunctionNames (std::vector<ConstString> &names)
+{
+    // The accelerator tables can only be looked up by name, the functions
+    // they know about are in the symbol table already unless they were
+    // only inlined.
+    if (m_using_apple_tables)
+        return;
+
+    Index (eIndexFunctions);
+
+    // The full name index has both the mangled and the demangled names,
+    // only the demangled ones are useful to complete.
+    m_function_fullname_index.ForEach([&names](const char *name, const DIERef &die_ref) -> bool {
+        ConstString name_cs (name);
+        if (!Mangled(name_cs).GetMangledName())
+            names.push_back(name_cs);
+        return true;
+    });
+}
+
 
 uint32_t
 SymbolFileDWARF::FindTypes (const SymbolContext& sc, 
@@ -3088,8 +3747,7 @@ SymbolFileDWARF::FindTypes (const SymbolContext& sc,
     }
     else
     {
-        if (!m_indexed)
-            Index ();
+        Index (eIndexTypes);
 
         m_type_index.Find (name, die_offsets);
     }
@@ -3210,8 +3868,7 @@ SymbolFileDWARF::FindTypes (const std::vector<CompilerContext> &context,
     }
     else
     {
-        if (!m_indexed)
-            Index ();
+        Index (eIndexTypes);
 
         m_type_index.Find (name, die_offsets);
     }
@@ -3294,8 +3951,7 @@ SymbolFileDWARF::FindNamespace (const SymbolContext& sc,
         }
         else
         {
-            if (!m_indexed)
-                Index ();
+            Index (eIndexNamespaces);
 
             m_namespace_index.Find (name, die_offsets);
         }
@@ -3511,8 +4167,7 @@ SymbolFileDWARF::FindCompleteObjCDefinitionTypeForDIE (const DWARFDIE &die,
     }
     else
     {
-        if (!m_indexed)
-            Index ();
+        Index (eIndexTypes);
         
         m_type_index.Find (type_name, die_offsets);
     }
@@ -3733,8 +4388,7 @@ SymbolFileDWARF::FindDefinitionTypeForDWARFDeclContext (const DWARFDeclContext &
             }
             else
             {
-                if (!m_indexed)
-                    Index ();
+                Index (eIndexTypes);
                 
                 m_type_index.Find (type_name, die_offsets);
             }
@@ -4045,8 +4699,7 @@ SymbolFileDWARF::ParseVariablesForContext (const SymbolContext& sc)
                 {
                     // Index if we already haven't to make sure the compile units
                     // get indexed and make their global DIE index list
-                    if (!m_indexed)
-                        Index ();
+                    Index (eIndexGlobals);
 
                     m_global_index.FindAllEntriesForCompileUnit (dwarf_cu->GetOffset(), 
                                                                  die_offsets);
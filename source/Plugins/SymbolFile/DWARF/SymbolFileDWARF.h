@@ -32,10 +32,12 @@
 #include "lldb/Symbol/DebugMacros.h"
 #include "lldb/Symbol/SymbolFile.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Utility/TaskPool.h"
 
 // Project includes
 #include "DWARFDefines.h"
 #include "DWARFDataExtractor.h"
+#include "DWARFDebugLine.h"
 #include "HashedNameToDIE.h"
 #include "NameToDIE.h"
 #include "UniqueDWARFASTType.h"
@@ -59,6 +61,7 @@ class DWARFDIECollection;
 class DWARFFormValue;
 class SymbolFileDWARFDebugMap;
 class SymbolFileDWARFDwo;
+class SymbolFileDWARFDwp;
 
 #define DIE_IS_BEING_PARSED ((lldb_private::Type*)1)
 
@@ -222,6 +225,24 @@ public:
     GetMangledNamesForFunction (const std::string &scope_qualified_name,
                                 std::vector<lldb_private::ConstString> &mangled_names) override;
 
+    void
+    GetFunctionNames (std::vector<lldb_private::ConstString> &names) override;
+
+    void
+    PreloadSymbols () override;
+
+    bool
+    PreloadSymbolsStep () override;
+
+    void
+    GetStatistics (lldb_private::StructuredData::Dictionary &stats) override;
+
+    size_t
+    GetCachedDataMemorySize () override;
+
+    size_t
+    ReleaseCachedData () override;
+
     uint32_t
     FindTypes (const lldb_private::SymbolContext& sc,
                const lldb_private::ConstString &name,
@@ -471,8 +492,112 @@ protected:
     lldb::TypeSP
     GetTypeForDIE (const DWARFDIE &die, bool resolve_function_context = false);
 
+    //------------------------------------------------------------------
+    // The manual DWARF index is made up of independent groups of name
+    // tables that are only built once a lookup needs them.
+    //------------------------------------------------------------------
+    enum IndexMask
+    {
+        eIndexFunctions  = (1u << 0),   // Function basenames, fullnames, methods, selectors and ObjC class selectors
+        eIndexGlobals    = (1u << 1),   // Global and static variables
+        eIndexTypes      = (1u << 2),
+        eIndexNamespaces = (1u << 3),
+        eIndexAll        = eIndexFunctions | eIndexGlobals | eIndexTypes | eIndexNamespaces
+    };
+
+    void
+    Index (uint32_t index_mask);
+
+    //------------------------------------------------------------------
+    // An index that is being built a few compile units at a time, see
+    // PreloadSymbolsStep(). The per compile unit tables are merged into
+    // the final ones once all compile units are done.
+    //------------------------------------------------------------------
+    struct PendingIndex
+    {
+        PendingIndex (uint32_t mask, bool cache, uint32_t num_cus) :
+            index_mask (mask),
+            use_index_cache (cache),
+            num_compile_units (num_cus),
+            next_cu_idx (0),
+            function_basename_index (num_cus),
+            function_fullname_index (num_cus),
+            function_method_index (num_cus),
+            function_selector_index (num_cus),
+            objc_class_selectors_index (num_cus),
+            global_index (num_cus),
+            type_index (num_cus),
+            namespace_index (num_cus)
+        {
+        }
+
+        uint32_t index_mask;
+        bool use_index_cache;
+        uint32_t num_compile_units;
+        uint32_t next_cu_idx;        // The compile units before this one are indexed
+        std::vector<NameToDIE> function_basename_index;
+        std::vector<NameToDIE> function_fullname_index;
+        std::vector<NameToDIE> function_method_index;
+        std::vector<NameToDIE> function_selector_index;
+        std::vector<NameToDIE> objc_class_selectors_index;
+        std::vector<NameToDIE> global_index;
+        std::vector<NameToDIE> type_index;
+        std::vector<NameToDIE> namespace_index;
+    };
+
+    // Loads the index from the cache or sets up m_pending_index to build
+    // it. Returns true if the index has to be built.
+    bool
+    StartIndex (uint32_t index_mask);
+
+    // Indexes the pending compile units before end_cu_idx.
+    void
+    IndexCompileUnits (uint32_t end_cu_idx, TaskPool::Priority priority);
+
+    // Indexes the remaining compile units and merges the tables.
+    void
+    FinishIndex (TaskPool::Priority priority);
+
+    // Runs ParseAllLineTables() once if the
+    // "plugin.symbol-file.dwarf.index-line-tables" setting is on.
     void
-    Index();
+    IndexLineTablesIfNeeded ();
+
+    //------------------------------------------------------------------
+    // Line tables. The line programs of compile units are decoded with
+    // DecodeLineTable(), which only reads debug_line_data and can run on
+    // any thread. ParseAllLineTables() decodes the line tables of all
+    // compile units that don't have one yet on the TaskPool.
+    //------------------------------------------------------------------
+    lldb::addr_t
+    GetLineTableAddressMask ();
+
+    static lldb_private::LineTable *
+    DecodeLineTable (const lldb_private::DWARFDataExtractor &debug_line_data,
+                     lldb_private::CompileUnit *comp_unit,
+                     dw_offset_t cu_line_offset,
+                     lldb::addr_t addr_mask);
+
+    // Hands a decoded line table to the compile unit, linking it first
+    // for a debug map. Returns false if it was linked.
+    bool
+    SetCompileUnitLineTable (lldb_private::CompileUnit *comp_unit, lldb_private::LineTable *line_table);
+
+    void
+    ParseAllLineTables ();
+
+    //------------------------------------------------------------------
+    // Persistent on-disk cache for the manual DWARF index, enabled with
+    // the "plugin.symbol-file.dwarf.use-index-cache" setting.
+    //------------------------------------------------------------------
+    bool
+    GetIndexCacheFileSpec (lldb_private::FileSpec &cache_file_spec);
+
+    bool
+    LoadIndexCache ();
+
+    void
+    SaveIndexCache ();
     
     void
     DumpIndexes();
@@ -525,6 +650,53 @@ protected:
     void
     UpdateExternalModuleListIfNeeded();
 
+    //------------------------------------------------------------------
+    /// Open the .dwo files of all compile units on the TaskPool.
+    ///
+    /// The .dwo file of a compile unit is opened on first use of its
+    /// compile unit DIE. Code that walks the DIEs of all compile units
+    /// one by one calls this first so that the files aren't opened and
+    /// parsed one at a time.
+    //------------------------------------------------------------------
+    void
+    OpenDwoFilesIfNeeded ();
+
+    // Gets the DWARF package (.dwp) next to the module, if there is one.
+    SymbolFileDWARFDwp *
+    GetDwpSymbolFile ();
+
+    //------------------------------------------------------------------
+    /// Find the compile units that may have line table entries for a
+    /// file.
+    ///
+    /// The first call builds an index of the base names of the files in
+    /// each compile unit's DW_AT_name and line table file list. Only the
+    /// line table prologues are read, no lldb compile units or line
+    /// tables are made.
+    ///
+    /// @param[in] file_name
+    ///     The base name of the file.
+    ///
+    /// @param[out] cu_indexes
+    ///     The indexes of the compile units in increasing order.
+    //------------------------------------------------------------------
+    void
+    FindCompileUnitsForFileName (const lldb_private::ConstString &file_name, std::vector<uint32_t> &cu_indexes);
+
+    //------------------------------------------------------------------
+    /// Get the prologue of the line table at \a stmt_list.
+    ///
+    /// Only the header with the directories and file names is parsed,
+    /// not the line program. The prologue is parsed once and shared by
+    /// all compile units that use the same line table, like type units
+    /// and the compile units of LTO builds often do.
+    ///
+    /// @return
+    ///     The prologue, or an empty shared pointer if it isn't valid.
+    //------------------------------------------------------------------
+    DWARFDebugLine::Prologue::shared_ptr
+    GetLineTablePrologue (dw_offset_t stmt_list);
+
     virtual DIEToTypePtr&
     GetDIEToType() { return m_die_to_type; }
 
@@ -580,9 +752,20 @@ protected:
     NameToDIE                           m_global_index;             // Global and static variables
     NameToDIE                           m_type_index;               // All type DIE offsets
     NameToDIE                           m_namespace_index;          // All type DIE offsets
-    bool                                m_indexed:1,
-                                        m_using_apple_tables:1,
-                                        m_fetched_external_modules:1;
+    uint32_t                            m_indexed_mask;             // The IndexMask values for the tables that have been built
+    uint64_t                            m_index_time;               // Nanoseconds spent building or loading the index
+    std::unique_ptr<PendingIndex>       m_pending_index;            // The index being built in the background, if any
+    lldb_private::UniqueCStringMap<uint32_t> m_file_name_to_cu_index; // Base names of the files of each compile unit to the compile unit index
+    typedef std::unordered_map<dw_offset_t, DWARFDebugLine::Prologue::shared_ptr> LineTablePrologueMap;
+    LineTablePrologueMap                m_line_table_prologues;     // Parsed line table prologues by stmt_list offset, invalid ones are null
+    std::mutex                          m_line_table_prologues_mutex;
+    std::unique_ptr<SymbolFileDWARFDwp> m_dwp_symfile;
+    std::once_flag                      m_dwp_symfile_once_flag;
+    bool                                m_using_apple_tables:1,
+                                        m_fetched_external_modules:1,
+                                        m_indexed_file_names:1,
+                                        m_indexed_line_tables:1,
+                                        m_opened_dwo_files:1;
     lldb_private::LazyBool              m_supports_DW_AT_APPLE_objc_complete_type;
 
     typedef std::shared_ptr<std::set<DIERef> > DIERefSetSP;
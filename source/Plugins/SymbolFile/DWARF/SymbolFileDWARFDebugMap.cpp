@@ -249,6 +249,8 @@ SymbolFileDWARFDebugMap::Initialize()
     PluginManager::RegisterPlugin (GetPluginNameStatic(),
                                    GetPluginDescriptionStatic(),
                                    CreateInstance);
+    // The debug map is made of the N_OSO symbols, only Mach-O files have them.
+    PluginManager::SetSymbolFileObjectFilePluginName (CreateInstance, ConstString("mach-o"));
 }
 
 void
@@ -1094,7 +1096,8 @@ SymbolFileDWARFDebugMap::FindFunctions(const ConstString &name,
                                        bool append,
                                        SymbolContextList& sc_list)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolFileDWARFDebugMap::FindFunctions (name = %s)",
                         name.GetCString());
 
@@ -1119,7 +1122,8 @@ SymbolFileDWARFDebugMap::FindFunctions(const ConstString &name,
 uint32_t
 SymbolFileDWARFDebugMap::FindFunctions (const RegularExpression& regex, bool include_inlines, bool append, SymbolContextList& sc_list)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolFileDWARFDebugMap::FindFunctions (regex = '%s')",
                         regex.GetText());
 
@@ -1147,7 +1151,8 @@ SymbolFileDWARFDebugMap::GetTypes (SymbolContextScope *sc_scope,
                                    uint32_t type_mask,
                                    TypeList &type_list)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolFileDWARFDebugMap::GetTypes (type_mask = 0x%8.8x)",
                         type_mask);
 
@@ -0,0 +1,208 @@
+//===-- SymbolFileDWARFDwp.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SymbolFileDWARFDwp.h"
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/ADT/STLExtras.h"
+
+// Project includes
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Symbol/ObjectFile.h"
+
+#include "DWARFCompileUnit.h"
+#include "LogChannelDWARF.h"
+#include "SymbolFileDWARFDwoDwp.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// The columns of the unit index, from the DWARF package file format.
+enum
+{
+    DW_SECT_INFO = 1,
+    DW_SECT_TYPES = 2,
+    DW_SECT_ABBREV = 3,
+    DW_SECT_LINE = 4,
+    DW_SECT_LOC = 5,
+    DW_SECT_STR_OFFSETS = 6,
+    DW_SECT_MACINFO = 7,
+    DW_SECT_MACRO = 8
+};
+
+static SectionType
+GetSectionTypeForDW_SECT (uint32_t dw_sect)
+{
+    switch (dw_sect)
+    {
+        case DW_SECT_INFO:          return eSectionTypeDWARFDebugInfo;
+        case DW_SECT_ABBREV:        return eSectionTypeDWARFDebugAbbrev;
+        case DW_SECT_LINE:          return eSectionTypeDWARFDebugLine;
+        case DW_SECT_LOC:           return eSectionTypeDWARFDebugLoc;
+        case DW_SECT_STR_OFFSETS:   return eSectionTypeDWARFDebugStrOffsets;
+        case DW_SECT_MACINFO:       return eSectionTypeDWARFDebugMacInfo;
+        case DW_SECT_MACRO:         return eSectionTypeDWARFDebugMacro;
+        default:                    return eSectionTypeInvalid; // Type units aren't supported
+    }
+}
+
+std::unique_ptr<SymbolFileDWARFDwp>
+SymbolFileDWARFDwp::Create (lldb::ModuleSP module_sp, const FileSpec &file_spec)
+{
+    const lldb::offset_t file_offset = 0;
+    DataBufferSP dwp_file_data_sp;
+    lldb::offset_t dwp_file_data_offset = 0;
+    ObjectFileSP obj_file = ObjectFile::FindPlugin(module_sp, &file_spec, file_offset, file_spec.GetByteSize(),
+                                                   dwp_file_data_sp, dwp_file_data_offset);
+    if (!obj_file)
+        return nullptr;
+
+    // The split units are opened on many threads at once, make the section
+    // list now.
+    if (obj_file->GetSectionList(false /* update_module_section_list */) == nullptr)
+        return nullptr;
+
+    std::unique_ptr<SymbolFileDWARFDwp> dwp_symfile(new SymbolFileDWARFDwp(obj_file));
+    if (!dwp_symfile->ParseCUIndex())
+    {
+        Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_INFO));
+        if (log)
+            log->Printf ("SymbolFileDWARFDwp::Create() ignoring \"%s\", it doesn't have a valid .debug_cu_index",
+                         file_spec.GetPath().c_str());
+        return nullptr;
+    }
+    return dwp_symfile;
+}
+
+SymbolFileDWARFDwp::SymbolFileDWARFDwp (lldb::ObjectFileSP obj_file) :
+    m_obj_file (obj_file),
+    m_contributions (),
+    m_sections (),
+    m_sections_mutex ()
+{
+}
+
+bool
+SymbolFileDWARFDwp::ParseCUIndex ()
+{
+    const SectionList *section_list = m_obj_file->GetSectionList(false /* update_module_section_list */);
+    static ConstString g_sect_name_debug_cu_index (".debug_cu_index");
+    SectionSP section_sp (section_list->FindSectionByName(g_sect_name_debug_cu_index));
+    if (!section_sp)
+        return false;
+
+    DWARFDataExtractor index_data;
+    if (m_obj_file->ReadSectionData(section_sp.get(), index_data) == 0)
+        return false;
+
+    // The header is followed by a hash table of the unit signatures and
+    // their row numbers, a row with the DW_SECT of each column and then the
+    // table of the section offsets and the table of the section sizes.
+    lldb::offset_t offset = 0;
+    const uint32_t version = index_data.GetU32(&offset);
+    const uint32_t num_columns = index_data.GetU32(&offset);
+    const uint32_t num_units = index_data.GetU32(&offset);
+    const uint32_t num_slots = index_data.GetU32(&offset);
+    if (version != 2 || num_columns == 0)
+        return false;
+
+    const uint64_t index_size = 16 + num_slots * 12ull + num_columns * 4ull + num_units * num_columns * 8ull;
+    if (!index_data.ValidOffsetForDataOfSize(0, index_size))
+        return false;
+
+    const lldb::offset_t rows_offset = offset + num_slots * 8ull;
+    const lldb::offset_t columns_offset = rows_offset + num_slots * 4ull;
+    const lldb::offset_t offsets_offset = columns_offset + num_columns * 4ull;
+    const lldb::offset_t sizes_offset = offsets_offset + num_units * num_columns * 4ull;
+
+    std::vector<SectionType> columns(num_columns);
+    lldb::offset_t column_offset = columns_offset;
+    for (uint32_t column = 0; column < num_columns; ++column)
+        columns[column] = GetSectionTypeForDW_SECT(index_data.GetU32(&column_offset));
+
+    for (uint32_t slot = 0; slot < num_slots; ++slot)
+    {
+        lldb::offset_t signature_offset = offset + slot * 8ull;
+        lldb::offset_t row_offset = rows_offset + slot * 4ull;
+        const uint64_t dwo_id = index_data.GetU64(&signature_offset);
+        const uint32_t row = index_data.GetU32(&row_offset);
+
+        // Rows are one based, zero marks an empty slot.
+        if (row == 0 || row > num_units)
+            continue;
+
+        ContributionMap &contributions = m_contributions[dwo_id];
+        lldb::offset_t unit_offsets_offset = offsets_offset + (row - 1) * num_columns * 4ull;
+        lldb::offset_t unit_sizes_offset = sizes_offset + (row - 1) * num_columns * 4ull;
+        for (uint32_t column = 0; column < num_columns; ++column)
+        {
+            Contribution contribution;
+            contribution.offset = index_data.GetU32(&unit_offsets_offset);
+            contribution.size = index_data.GetU32(&unit_sizes_offset);
+            if (columns[column] != eSectionTypeInvalid)
+                contributions[columns[column]] = contribution;
+        }
+    }
+    return !m_contributions.empty();
+}
+
+std::unique_ptr<SymbolFileDWARFDwo>
+SymbolFileDWARFDwp::GetSymbolFileForDwoId (DWARFCompileUnit &dwarf_cu, uint64_t dwo_id)
+{
+    if (m_contributions.find(dwo_id) == m_contributions.end())
+        return nullptr;
+    return llvm::make_unique<SymbolFileDWARFDwoDwp>(this, m_obj_file, &dwarf_cu, dwo_id);
+}
+
+bool
+SymbolFileDWARFDwp::LoadSectionData (uint64_t dwo_id, lldb::SectionType sect_type, DWARFDataExtractor &data)
+{
+    const DWARFDataExtractor &section_data = GetSectionData(sect_type);
+    if (section_data.GetByteSize() == 0)
+        return false;
+
+    std::map<uint64_t, ContributionMap>::const_iterator unit_pos = m_contributions.find(dwo_id);
+    if (unit_pos == m_contributions.end())
+        return false;
+
+    ContributionMap::const_iterator pos = unit_pos->second.find(sect_type);
+    if (pos == unit_pos->second.end())
+    {
+        // The sections that don't have a column, like .debug_str.dwo, are
+        // shared by all units.
+        data = section_data;
+        return true;
+    }
+
+    data.SetData(section_data, pos->second.offset, pos->second.size);
+    return true;
+}
+
+const DWARFDataExtractor &
+SymbolFileDWARFDwp::GetSectionData (lldb::SectionType sect_type)
+{
+    std::lock_guard<std::mutex> guard(m_sections_mutex);
+    std::map<lldb::SectionType, DWARFDataExtractor>::iterator pos = m_sections.find(sect_type);
+    if (pos != m_sections.end())
+        return pos->second;
+
+    DWARFDataExtractor &data = m_sections[sect_type];
+    const SectionList *section_list = m_obj_file->GetSectionList(false /* update_module_section_list */);
+    SectionSP section_sp (section_list->FindSectionByType(sect_type, true));
+    if (section_sp && m_obj_file->ReadSectionData(section_sp.get(), data) == 0)
+        data.Clear();
+    return data;
+}
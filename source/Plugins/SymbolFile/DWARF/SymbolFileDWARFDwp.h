@@ -0,0 +1,73 @@
+//===-- SymbolFileDWARFDwp.h ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARFDwp_SymbolFileDWARFDwp_h_
+#define SymbolFileDWARFDwp_SymbolFileDWARFDwp_h_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+#include "DWARFDataExtractor.h"
+
+class DWARFCompileUnit;
+class SymbolFileDWARFDwo;
+
+//----------------------------------------------------------------------
+// A DWARF package (.dwp) holds the split units of all the .dwo files of a
+// module. All units share the sections of the package, the .debug_cu_index
+// section gives the part of each section that belongs to the unit with a
+// given DW_AT_GNU_dwo_id. The sections are read once and every unit gets a
+// slice of them.
+//----------------------------------------------------------------------
+class SymbolFileDWARFDwp
+{
+public:
+    static std::unique_ptr<SymbolFileDWARFDwp>
+    Create (lldb::ModuleSP module_sp, const lldb_private::FileSpec &file_spec);
+
+    std::unique_ptr<SymbolFileDWARFDwo>
+    GetSymbolFileForDwoId (DWARFCompileUnit &dwarf_cu, uint64_t dwo_id);
+
+    // Gets the part of a section that belongs to the unit with dwo_id.
+    // Returns false if the package doesn't have the section.
+    bool
+    LoadSectionData (uint64_t dwo_id, lldb::SectionType sect_type, lldb_private::DWARFDataExtractor &data);
+
+private:
+    SymbolFileDWARFDwp (lldb::ObjectFileSP obj_file);
+
+    bool
+    ParseCUIndex ();
+
+    const lldb_private::DWARFDataExtractor &
+    GetSectionData (lldb::SectionType sect_type);
+
+    struct Contribution
+    {
+        uint32_t offset;
+        uint32_t size;
+    };
+    typedef std::map<lldb::SectionType, Contribution> ContributionMap;
+
+    lldb::ObjectFileSP m_obj_file;
+    std::map<uint64_t, ContributionMap> m_contributions;  // The section contributions of each dwo id
+    std::map<lldb::SectionType, lldb_private::DWARFDataExtractor> m_sections;
+    std::mutex m_sections_mutex;
+
+    DISALLOW_COPY_AND_ASSIGN (SymbolFileDWARFDwp);
+};
+
+#endif // SymbolFileDWARFDwp_SymbolFileDWARFDwp_h_
@@ -22,6 +22,7 @@
 #include "llvm/DebugInfo/PDB/PDBSymbol.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolData.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolTypeArray.h"
+#include "llvm/DebugInfo/PDB/PDBSymbolTypeBaseClass.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolTypeBuiltin.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolTypeEnum.h"
 #include "llvm/DebugInfo/PDB/PDBSymbolTypeFunctionArg.h"
@@ -53,6 +54,21 @@ TranslateUdtKind(PDB_UdtType pdb_kind)
     return clang::TTK_Class;
 }
 
+lldb::AccessType
+TranslateMemberAccess(PDB_MemberAccess access)
+{
+    switch (access)
+    {
+        case PDB_MemberAccess::Private:
+            return lldb::eAccessPrivate;
+        case PDB_MemberAccess::Protected:
+            return lldb::eAccessProtected;
+        case PDB_MemberAccess::Public:
+            return lldb::eAccessPublic;
+    }
+    return lldb::eAccessNone;
+}
+
 lldb::Encoding
 TranslateBuiltinEncoding(PDB_BuiltinType type)
 {
@@ -121,16 +137,13 @@ PDBASTParser::CreateLLDBTypeFromPDBType(const PDBSymbol &type)
         CompilerType builtin_type = m_ast.GetBuiltinTypeForEncodingAndBitSize(encoding, bytes * 8);
 
         CompilerType ast_enum = m_ast.CreateEnumerationType(name.c_str(), tu_decl_ctx, decl, builtin_type);
-        auto enum_values = enum_type->findAllChildren<PDBSymbolData>();
-        while (auto enum_value = enum_values->getNext())
-        {
-            if (enum_value->getDataKind() != PDB_DataKind::Constant)
-                continue;
-            AddEnumValue(ast_enum, *enum_value);
-        }
+
+        // Large programs have enums with thousands of enumerators, they are
+        // added in CompleteTypeFromPDB().
+        m_ast.SetHasExternalStorage(ast_enum.GetOpaqueQualType(), true);
 
         return std::make_shared<Type>(type.getSymIndexId(), m_ast.GetSymbolFile(), ConstString(name), bytes, nullptr,
-                                      LLDB_INVALID_UID, Type::eEncodingIsUID, decl, ast_enum, Type::eResolveStateFull);
+                                      LLDB_INVALID_UID, Type::eEncodingIsUID, decl, ast_enum, Type::eResolveStateForward);
     }
     else if (auto type_def = llvm::dyn_cast<PDBSymbolTypeTypedef>(&type))
     {
@@ -194,6 +207,99 @@ PDBASTParser::CreateLLDBTypeFromPDBType(const PDBSymbol &type)
     return nullptr;
 }
 
+bool
+PDBASTParser::CompleteTypeFromPDB(const PDBSymbol &type, CompilerType &compiler_type)
+{
+    if (auto udt = llvm::dyn_cast<PDBSymbolTypeUDT>(&type))
+        return CompleteUDT(*udt, compiler_type);
+
+    if (auto enum_type = llvm::dyn_cast<PDBSymbolTypeEnum>(&type))
+    {
+        ClangASTContext::StartTagDeclarationDefinition(compiler_type);
+        auto enum_values = enum_type->findAllChildren<PDBSymbolData>();
+        while (auto enum_value = enum_values->getNext())
+        {
+            if (enum_value->getDataKind() != PDB_DataKind::Constant)
+                continue;
+            AddEnumValue(compiler_type, *enum_value);
+        }
+        ClangASTContext::CompleteTagDeclarationDefinition(compiler_type);
+        m_ast.SetHasExternalStorage(compiler_type.GetOpaqueQualType(), false);
+        return true;
+    }
+    return false;
+}
+
+bool
+PDBASTParser::CompleteUDT(const PDBSymbolTypeUDT &udt, CompilerType &compiler_type)
+{
+    SymbolFile *symbol_file = m_ast.GetSymbolFile();
+    ClangASTImporter::LayoutInfo layout_info;
+    layout_info.bit_size = udt.getLength() * 8;
+
+    ClangASTContext::StartTagDeclarationDefinition(compiler_type);
+
+    // The PDB records the offset of every base class and member, so the
+    // layout doesn't depend on clang matching the compiler's packing.
+    std::vector<clang::CXXBaseSpecifier *> base_classes;
+    auto bases = udt.findAllChildren<PDBSymbolTypeBaseClass>();
+    while (auto base = bases->getNext())
+    {
+        Type *base_type = symbol_file->ResolveTypeUID(base->getTypeId());
+        if (!base_type)
+            continue;
+        CompilerType base_ast_type = base_type->GetFullCompilerType();
+        if (!base_ast_type)
+            continue;
+        const bool is_virtual = base->isVirtualBaseClass();
+        base_classes.push_back(m_ast.CreateBaseClassSpecifier(base_ast_type.GetOpaqueQualType(),
+                                                              TranslateMemberAccess(base->getAccess()), is_virtual,
+                                                              udt.getUdtKind() == PDB_UdtType::Class));
+        if (!is_virtual)
+            layout_info.base_offsets.insert(std::make_pair(m_ast.GetAsCXXRecordDecl(base_ast_type.GetOpaqueQualType()),
+                                                           clang::CharUnits::fromQuantity(base->getOffset())));
+    }
+    if (!base_classes.empty())
+    {
+        m_ast.SetBaseClassesForClassType(compiler_type.GetOpaqueQualType(), &base_classes.front(),
+                                         base_classes.size());
+        ClangASTContext::DeleteBaseClassSpecifiers(&base_classes.front(), base_classes.size());
+    }
+
+    auto members = udt.findAllChildren<PDBSymbolData>();
+    while (auto member = members->getNext())
+    {
+        if (member->getDataKind() != PDB_DataKind::Member)
+            continue;
+        Type *member_type = symbol_file->ResolveTypeUID(member->getTypeId());
+        if (!member_type)
+            continue;
+
+        uint64_t bit_offset = member->getOffset() * 8;
+        uint32_t bitfield_bit_size = 0;
+        if (member->getLocationType() == PDB_LocType::BitField)
+        {
+            bit_offset += member->getBitPosition();
+            bitfield_bit_size = member->getLength();
+        }
+
+        std::string name = member->getName();
+        clang::FieldDecl *field_decl = ClangASTContext::AddFieldToRecordType(
+            compiler_type, name.c_str(), member_type->GetLayoutCompilerType(),
+            TranslateMemberAccess(member->getAccess()), bitfield_bit_size);
+        if (field_decl)
+            layout_info.field_offsets.insert(std::make_pair(field_decl, bit_offset));
+    }
+
+    ClangASTContext::BuildIndirectFields(compiler_type);
+    ClangASTContext::CompleteTagDeclarationDefinition(compiler_type);
+
+    clang::CXXRecordDecl *record_decl = m_ast.GetAsCXXRecordDecl(compiler_type.GetOpaqueQualType());
+    if (record_decl)
+        m_ast_importer.InsertRecordDecl(record_decl, layout_info);
+    return true;
+}
+
 bool
 PDBASTParser::AddEnumValue(CompilerType enum_type, const PDBSymbolData &enum_value) const
 {
@@ -35,6 +35,7 @@ namespace pdb
 class PDBSymbol;
 class PDBSymbolData;
 class PDBSymbolTypeBuiltin;
+class PDBSymbolTypeUDT;
 }
 }
 
@@ -47,7 +48,21 @@ public:
     lldb::TypeSP
     CreateLLDBTypeFromPDBType(const llvm::pdb::PDBSymbol &type);
 
+    // Classes and enums are created as forward declarations, their members
+    // are only added here when clang asks for the complete type.
+    bool
+    CompleteTypeFromPDB(const llvm::pdb::PDBSymbol &type, lldb_private::CompilerType &compiler_type);
+
+    lldb_private::ClangASTImporter &
+    GetClangASTImporter()
+    {
+        return m_ast_importer;
+    }
+
 private:
+    bool
+    CompleteUDT(const llvm::pdb::PDBSymbolTypeUDT &udt, lldb_private::CompilerType &compiler_type);
+
     bool
     AddEnumValue(lldb_private::CompilerType enum_type, const llvm::pdb::PDBSymbolData &data) const;
 
@@ -70,6 +70,8 @@ SymbolFilePDB::Initialize()
 {
     PluginManager::RegisterPlugin(GetPluginNameStatic(), GetPluginDescriptionStatic(), CreateInstance,
                                   DebuggerInitialize);
+    // The PDB is found through the debug directory of a PE/COFF image.
+    PluginManager::SetSymbolFileObjectFilePluginName(CreateInstance, ConstString("pe-coff"));
 }
 
 void
@@ -103,7 +105,7 @@ SymbolFilePDB::CreateInstance(lldb_private::ObjectFile *obj_file)
 }
 
 SymbolFilePDB::SymbolFilePDB(lldb_private::ObjectFile *object_file)
-    : SymbolFile(object_file), m_cached_compile_unit_count(0)
+    : SymbolFile(object_file), m_type_name_index_built(false), m_cached_compile_unit_count(0)
 {
 }
 
@@ -284,14 +286,31 @@ SymbolFilePDB::ResolveTypeUID(lldb::user_id_t type_uid)
 
     lldb::TypeSP result = pdb->CreateLLDBTypeFromPDBType(*pdb_type);
     m_types.insert(std::make_pair(type_uid, result));
+    if (result && (pdb_type->getSymTag() == PDB_SymType::UDT || pdb_type->getSymTag() == PDB_SymType::Enum))
+        m_forward_decl_to_uid[result->GetForwardCompilerType().GetOpaqueQualType()] = type_uid;
     return result.get();
 }
 
 bool
 SymbolFilePDB::CompleteType(lldb_private::CompilerType &compiler_type)
 {
-    // TODO: Implement this
-    return false;
+    auto pos = m_forward_decl_to_uid.find(compiler_type.GetOpaqueQualType());
+    if (pos == m_forward_decl_to_uid.end())
+        return false;
+    const uint32_t type_uid = pos->second;
+    m_forward_decl_to_uid.erase(pos);
+
+    ClangASTContext *clang_type_system = llvm::dyn_cast_or_null<ClangASTContext>(compiler_type.GetTypeSystem());
+    if (!clang_type_system)
+        return false;
+    PDBASTParser *pdb = llvm::dyn_cast<PDBASTParser>(clang_type_system->GetPDBParser());
+    if (!pdb)
+        return false;
+
+    auto pdb_type = m_session_up->getSymbolById(type_uid);
+    if (pdb_type == nullptr)
+        return false;
+    return pdb->CompleteTypeFromPDB(*pdb_type, compiler_type);
 }
 
 lldb_private::CompilerDecl
@@ -439,92 +458,86 @@ SymbolFilePDB::FindTypes(const lldb_private::SymbolContext &sc, const lldb_priva
 void
 SymbolFilePDB::FindTypesByRegex(const std::string &regex, uint32_t max_matches, lldb_private::TypeMap &types)
 {
-    // When searching by regex, we need to go out of our way to limit the search space as much as possible, since
-    // the way this is implemented is by searching EVERYTHING in the PDB and manually doing a regex compare.  PDB
-    // library isn't optimized for regex searches or searches across multiple symbol types at the same time, so the
-    // best we can do is to search enums, then typedefs, then classes one by one, and do a regex compare against all
-    // of them.
-    PDB_SymType tags_to_search[] = {PDB_SymType::Enum, PDB_SymType::Typedef, PDB_SymType::UDT};
-    auto global = m_session_up->getGlobalScope();
-    std::unique_ptr<IPDBEnumSymbols> results;
+    // The PDB library isn't optimized for regex searches, it would have to
+    // return every enum, typedef and class for us to compare, so match
+    // against the names in the index instead.
+    BuildTypeNameIndex();
 
     std::regex re(regex);
 
     uint32_t matches = 0;
-
-    for (auto tag : tags_to_search)
+    const size_t num_entries = m_type_name_index.GetSize();
+    for (size_t i = 0; i < num_entries; ++i)
     {
-        results = global->findAllChildren(tag);
-        while (auto result = results->getNext())
-        {
-            if (max_matches > 0 && matches >= max_matches)
-                break;
-
-            std::string type_name;
-            if (auto enum_type = llvm::dyn_cast<PDBSymbolTypeEnum>(result.get()))
-                type_name = enum_type->getName();
-            else if (auto typedef_type = llvm::dyn_cast<PDBSymbolTypeTypedef>(result.get()))
-                type_name = typedef_type->getName();
-            else if (auto class_type = llvm::dyn_cast<PDBSymbolTypeUDT>(result.get()))
-                type_name = class_type->getName();
-            else
-            {
-                // We're only looking for types that have names.  Skip symbols, as well as
-                // unnamed types such as arrays, pointers, etc.
-                continue;
-            }
-
-            if (!std::regex_match(type_name, re))
-                continue;
-
-            // This should cause the type to get cached and stored in the `m_types` lookup.
-            if (!ResolveTypeUID(result->getSymIndexId()))
-                continue;
-
-            auto iter = m_types.find(result->getSymIndexId());
-            if (iter == m_types.end())
-                continue;
-            types.Insert(iter->second);
-            ++matches;
-        }
+        if (max_matches > 0 && matches >= max_matches)
+            break;
+        if (!std::regex_match(m_type_name_index.GetCStringAtIndexUnchecked(i), re))
+            continue;
+        AddTypeForSymIndex(m_type_name_index.GetValueAtIndexUnchecked(i), max_matches, matches, types);
     }
 }
 
 void
 SymbolFilePDB::FindTypesByName(const std::string &name, uint32_t max_matches, lldb_private::TypeMap &types)
 {
-    auto global = m_session_up->getGlobalScope();
-    std::unique_ptr<IPDBEnumSymbols> results;
-    results = global->findChildren(PDB_SymType::None, name.c_str(), PDB_NameSearchFlags::NS_Default);
+    BuildTypeNameIndex();
+
+    std::vector<uint32_t> sym_index_ids;
+    m_type_name_index.GetValues(ConstString(name).GetCString(), sym_index_ids);
 
     uint32_t matches = 0;
+    for (uint32_t sym_index_id : sym_index_ids)
+        AddTypeForSymIndex(sym_index_id, max_matches, matches, types);
+}
+
+void
+SymbolFilePDB::AddTypeForSymIndex(uint32_t sym_index_id, uint32_t max_matches, uint32_t &matches,
+                                  lldb_private::TypeMap &types)
+{
+    if (max_matches > 0 && matches >= max_matches)
+        return;
+
+    // This should cause the type to get cached and stored in the `m_types` lookup.
+    if (!ResolveTypeUID(sym_index_id))
+        return;
+
+    auto iter = m_types.find(sym_index_id);
+    if (iter == m_types.end())
+        return;
+    types.Insert(iter->second);
+    ++matches;
+}
+
+void
+SymbolFilePDB::BuildTypeNameIndex()
+{
+    if (m_type_name_index_built)
+        return;
+    m_type_name_index_built = true;
 
-    while (auto result = results->getNext())
+    // We're only looking for types that have names.  Skip symbols, as well as
+    // unnamed types such as arrays, pointers, etc.  The types of a PDB are
+    // global, they live in one stream that the session enumerates in order.
+    PDB_SymType tags_to_index[] = {PDB_SymType::Enum, PDB_SymType::Typedef, PDB_SymType::UDT};
+    auto global = m_session_up->getGlobalScope();
+    for (auto tag : tags_to_index)
     {
-        if (max_matches > 0 && matches >= max_matches)
-            break;
-        switch (result->getSymTag())
+        auto results = global->findAllChildren(tag);
+        while (auto result = results->getNext())
         {
-            case PDB_SymType::Enum:
-            case PDB_SymType::UDT:
-            case PDB_SymType::Typedef:
-                break;
-            default:
-                // We're only looking for types that have names.  Skip symbols, as well as
-                // unnamed types such as arrays, pointers, etc.
+            std::string type_name;
+            if (auto enum_type = llvm::dyn_cast<PDBSymbolTypeEnum>(result.get()))
+                type_name = enum_type->getName();
+            else if (auto typedef_type = llvm::dyn_cast<PDBSymbolTypeTypedef>(result.get()))
+                type_name = typedef_type->getName();
+            else if (auto class_type = llvm::dyn_cast<PDBSymbolTypeUDT>(result.get()))
+                type_name = class_type->getName();
+            if (type_name.empty())
                 continue;
+            m_type_name_index.Append(ConstString(type_name).GetCString(), result->getSymIndexId());
         }
-
-        // This should cause the type to get cached and stored in the `m_types` lookup.
-        if (!ResolveTypeUID(result->getSymIndexId()))
-            continue;
-
-        auto iter = m_types.find(result->getSymIndexId());
-        if (iter == m_types.end())
-            continue;
-        types.Insert(iter->second);
-        ++matches;
     }
+    m_type_name_index.Sort();
 }
 
 size_t
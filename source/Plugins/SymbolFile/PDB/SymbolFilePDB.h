@@ -10,6 +10,7 @@
 #ifndef lldb_Plugins_SymbolFile_PDB_SymbolFilePDB_h_
 #define lldb_Plugins_SymbolFile_PDB_SymbolFilePDB_h_
 
+#include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Core/UserID.h"
 #include "lldb/Symbol/SymbolFile.h"
 
@@ -192,8 +193,20 @@ private:
     void
     FindTypesByName(const std::string &name, uint32_t max_matches, lldb_private::TypeMap &types);
 
+    // Every query through the session enumerates the PDB, so the names of
+    // all the named types are indexed once up front.
+    void
+    BuildTypeNameIndex();
+
+    void
+    AddTypeForSymIndex(uint32_t sym_index_id, uint32_t max_matches, uint32_t &matches, lldb_private::TypeMap &types);
+
     llvm::DenseMap<uint32_t, lldb::CompUnitSP> m_comp_units;
     llvm::DenseMap<uint32_t, lldb::TypeSP> m_types;
+    // Forward declared clang types to the PDB symbol that completes them.
+    llvm::DenseMap<lldb::opaque_compiler_type_t, uint32_t> m_forward_decl_to_uid;
+    lldb_private::UniqueCStringMap<uint32_t> m_type_name_index;
+    bool m_type_name_index_built;
 
     std::vector<lldb::TypeSP> m_builtin_types;
     std::unique_ptr<llvm::pdb::IPDBSession> m_session_up;
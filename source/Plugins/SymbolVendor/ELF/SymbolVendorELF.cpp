@@ -103,11 +103,13 @@ SymbolVendorELF::CreateInstance (const lldb::ModuleSP &module_sp, lldb_private::
     if (debug_symbol_fspec)
         file_spec_list.Insert (0, debug_symbol_fspec);
 
-    // If we have no debug symbol files, then nothing to do.
+    // Without a .gnu_debuglink, the debug file can still be found by its
+    // build ID.
     if (file_spec_list.IsEmpty())
-        return NULL;
+        file_spec_list.Append (FileSpec());
 
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolVendorELF::CreateInstance (module = %s)",
                         module_sp->GetFileSpec().GetPath().c_str());
 
@@ -155,6 +157,10 @@ SymbolVendorELF::CreateInstance (const lldb::ModuleSP &module_sp, lldb_private::
                         eSectionTypeDWARFDebugRanges,
                         eSectionTypeDWARFDebugStr,
                         eSectionTypeDWARFDebugStrOffsets,
+                        eSectionTypeDWARFAppleNames,
+                        eSectionTypeDWARFAppleTypes,
+                        eSectionTypeDWARFAppleNamespaces,
+                        eSectionTypeDWARFAppleObjC,
                         eSectionTypeELFSymbolTable,
                     };
                     for (size_t idx = 0; idx < sizeof(g_sections) / sizeof(g_sections[0]); ++idx)
@@ -132,7 +132,8 @@ SymbolVendorMacOSX::CreateInstance (const lldb::ModuleSP &module_sp, lldb_privat
     if (obj_name != obj_file_macho)
         return NULL;
 
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "SymbolVendorMacOSX::CreateInstance (module = %s)",
                         module_sp->GetFileSpec().GetPath().c_str());
     SymbolVendorMacOSX* symbol_vendor = new SymbolVendorMacOSX(module_sp);
@@ -142,7 +143,8 @@ SymbolVendorMacOSX::CreateInstance (const lldb::ModuleSP &module_sp, lldb_privat
         path[0] = '\0';
 
         // Try and locate the dSYM file on Mac OS X
-        Timer scoped_timer2 ("SymbolVendorMacOSX::CreateInstance () locate dSYM",
+        static Timer::Category func_cat2("SymbolVendorMacOSX::CreateInstance () locate dSYM");
+        Timer scoped_timer2 (func_cat2,
                              "SymbolVendorMacOSX::CreateInstance (module = %s) locate dSYM",
                              module_sp->GetFileSpec().GetPath().c_str());
 
@@ -9,6 +9,11 @@
 
 #include "UnwindAssembly-x86.h"
 
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "llvm-c/Disassembler.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/TargetSelect.h"
@@ -25,6 +30,7 @@
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/UnwindAssembly.h"
+#include "lldb/Utility/LLVMTargets.h"
 #include "lldb/Utility/RegisterNumber.h"
 
 using namespace lldb;
@@ -160,6 +166,8 @@ private:
     uint32_t extract_4 (uint8_t *b);
     bool machine_regno_to_lldb_regno (int machine_regno, uint32_t& lldb_regno);
     bool instruction_length (Address addr, int &length);
+    bool read_function_bytes (AddressRange &func);
+    bool read_next_instruction (int &length);
 
     const ExecutionContext m_exe_ctx;
 
@@ -168,6 +176,11 @@ private:
     Address m_cur_insn;
     uint8_t m_cur_insn_bytes[kMaxInstructionByteSize];
 
+    // The bytes of the function being scanned, read with one ReadMemory
+    // call instead of two per instruction.
+    Address m_func_bytes_addr;
+    std::vector<uint8_t> m_func_bytes;
+
     uint32_t m_machine_ip_regnum;
     uint32_t m_machine_sp_regnum;
     uint32_t m_machine_fp_regnum;
@@ -188,6 +201,8 @@ AssemblyParse_x86::AssemblyParse_x86 (const ExecutionContext &exe_ctx, int cpu,
     m_exe_ctx (exe_ctx),
     m_func_bounds(func),
     m_cur_insn (),
+    m_func_bytes_addr (),
+    m_func_bytes (),
     m_machine_ip_regnum (LLDB_INVALID_REGNUM),
     m_machine_sp_regnum (LLDB_INVALID_REGNUM),
     m_machine_fp_regnum (LLDB_INVALID_REGNUM),
@@ -261,6 +276,7 @@ AssemblyParse_x86::AssemblyParse_x86 (const ExecutionContext &exe_ctx, int cpu,
            m_lldb_ip_regnum = lldb_regno;
    }
 
+   InitializeLLVMTargets();
    m_disasm_context = ::LLVMCreateDisasm(m_arch.GetTriple().getTriple().c_str(),
                                           (void*)this,
                                           /*TagType=*/1,
@@ -651,6 +667,313 @@ AssemblyParse_x86::instruction_length (Address addr, int &length)
     return true;
 }
 
+//----------------------------------------------------------------------
+// Instruction length decoding for the instructions that show up in
+// prologues and epilogues: pushes, pops, movs, sub/add/lea of the stack
+// pointer, calls, jumps, rets and nops.  Working out their lengths from
+// the prefixes, the opcode, the ModRM/SIB bytes and the displacement is
+// much cheaper than running them through the llvm disassembler, which
+// formats the instruction text as well.  Anything not in the tables
+// returns 0 and is handed to llvm.
+//----------------------------------------------------------------------
+
+namespace
+{
+    enum
+    {
+        eOpInvalid  = 0,
+        eOpValid    = (1u << 0),
+        eOpModRM    = (1u << 1),
+        eOpImm8     = (1u << 2),
+        eOpImm16    = (1u << 3),
+        eOpImmZ     = (1u << 4),    // 4 bytes, or 2 with an operand size prefix
+        eOpRel32    = (1u << 5),    // 4 bytes, we leave 0x66 prefixed ones to llvm
+        eOpGroup3   = (1u << 6)     // f6/f7: "test" (/0 and /1) has an immediate
+    };
+
+    struct X86OpcodeTables
+    {
+        uint8_t one_byte[256];
+        uint8_t two_byte[256];
+
+        X86OpcodeTables ()
+        {
+            ::memset (one_byte, eOpInvalid, sizeof(one_byte));
+            ::memset (two_byte, eOpInvalid, sizeof(two_byte));
+
+            // add/or/adc/sbb/and/sub/xor/cmp in all their forms
+            for (int op = 0x00; op < 0x40; op += 8)
+            {
+                for (int i = 0; i < 4; ++i)
+                    one_byte[op + i] = eOpValid | eOpModRM;
+                one_byte[op + 4] = eOpValid | eOpImm8;
+                one_byte[op + 5] = eOpValid | eOpImmZ;
+            }
+            for (int op = 0x50; op <= 0x5f; ++op)       // push/pop reg
+                one_byte[op] = eOpValid;
+            one_byte[0x63] = eOpValid | eOpModRM;       // movsxd
+            one_byte[0x68] = eOpValid | eOpImmZ;        // push imm
+            one_byte[0x69] = eOpValid | eOpModRM | eOpImmZ;
+            one_byte[0x6a] = eOpValid | eOpImm8;        // push imm8
+            one_byte[0x6b] = eOpValid | eOpModRM | eOpImm8;
+            for (int op = 0x70; op <= 0x7f; ++op)       // jcc rel8
+                one_byte[op] = eOpValid | eOpImm8;
+            one_byte[0x80] = eOpValid | eOpModRM | eOpImm8;
+            one_byte[0x81] = eOpValid | eOpModRM | eOpImmZ;
+            one_byte[0x83] = eOpValid | eOpModRM | eOpImm8;
+            for (int op = 0x84; op <= 0x8f; ++op)       // test/xchg/mov/lea/pop r/m
+                one_byte[op] = eOpValid | eOpModRM;
+            for (int op = 0x90; op <= 0x99; ++op)       // nop/xchg/cwde/cdq
+                one_byte[op] = eOpValid;
+            one_byte[0xa8] = eOpValid | eOpImm8;
+            one_byte[0xa9] = eOpValid | eOpImmZ;
+            for (int op = 0xb0; op <= 0xb7; ++op)       // mov reg, imm8
+                one_byte[op] = eOpValid | eOpImm8;
+            for (int op = 0xb8; op <= 0xbf; ++op)       // mov reg, imm
+                one_byte[op] = eOpValid | eOpImmZ;
+            one_byte[0xc0] = eOpValid | eOpModRM | eOpImm8;
+            one_byte[0xc1] = eOpValid | eOpModRM | eOpImm8;
+            one_byte[0xc2] = eOpValid | eOpImm16;       // ret imm16
+            one_byte[0xc3] = eOpValid;                  // ret
+            one_byte[0xc6] = eOpValid | eOpModRM | eOpImm8;
+            one_byte[0xc7] = eOpValid | eOpModRM | eOpImmZ;
+            one_byte[0xc9] = eOpValid;                  // leave
+            one_byte[0xcc] = eOpValid;                  // int3
+            for (int op = 0xd0; op <= 0xd3; ++op)       // shifts
+                one_byte[op] = eOpValid | eOpModRM;
+            one_byte[0xe8] = eOpValid | eOpRel32;       // call
+            one_byte[0xe9] = eOpValid | eOpRel32;       // jmp
+            one_byte[0xeb] = eOpValid | eOpImm8;        // jmp rel8
+            one_byte[0xf4] = eOpValid;                  // hlt
+            one_byte[0xf6] = eOpValid | eOpModRM | eOpGroup3;
+            one_byte[0xf7] = eOpValid | eOpModRM | eOpGroup3;
+            one_byte[0xfe] = eOpValid | eOpModRM;
+            one_byte[0xff] = eOpValid | eOpModRM;       // inc/dec/call/jmp/push r/m
+
+            two_byte[0x05] = eOpValid;                  // syscall
+            two_byte[0x0b] = eOpValid;                  // ud2
+            two_byte[0x1e] = eOpValid | eOpModRM;       // endbr64/endbr32 and hint nops
+            two_byte[0x1f] = eOpValid | eOpModRM;       // nop r/m
+            static const uint8_t g_sse_moves[] = { 0x10, 0x11, 0x28, 0x29, 0x57, 0x6e, 0x6f, 0x7e, 0x7f, 0xd6, 0xef };
+            for (uint8_t op : g_sse_moves)
+                two_byte[op] = eOpValid | eOpModRM;
+            for (int op = 0x40; op <= 0x4f; ++op)       // cmovcc
+                two_byte[op] = eOpValid | eOpModRM;
+            for (int op = 0x80; op <= 0x8f; ++op)       // jcc rel32
+                two_byte[op] = eOpValid | eOpRel32;
+            for (int op = 0x90; op <= 0x9f; ++op)       // setcc
+                two_byte[op] = eOpValid | eOpModRM;
+            two_byte[0xa2] = eOpValid;                  // cpuid
+            two_byte[0xaf] = eOpValid | eOpModRM;       // imul
+            two_byte[0xb6] = eOpValid | eOpModRM;       // movzx
+            two_byte[0xb7] = eOpValid | eOpModRM;
+            two_byte[0xbe] = eOpValid | eOpModRM;       // movsx
+            two_byte[0xbf] = eOpValid | eOpModRM;
+        }
+    };
+
+    const X86OpcodeTables &
+    GetX86OpcodeTables ()
+    {
+        static X86OpcodeTables g_tables;
+        return g_tables;
+    }
+
+    // Returns the length of the instruction at "bytes", or 0 if it isn't
+    // one we know or isn't completely inside the "avail" bytes.
+    int
+    FastInstructionLength (const uint8_t *bytes, size_t avail, bool is_64bit)
+    {
+        const X86OpcodeTables &tables = GetX86OpcodeTables();
+        const size_t max_length = std::min<size_t> (avail, 15);
+        size_t pos = 0;
+        bool operand_size_prefix = false;
+        uint8_t rep_prefix = 0;
+        bool rex_w = false;
+
+        // Legacy prefixes.  The address size prefix (0x67) and lock are
+        // rare enough in prologues to leave to llvm.
+        for (; pos < max_length; ++pos)
+        {
+            const uint8_t b = bytes[pos];
+            if (b == 0x66)
+                operand_size_prefix = true;
+            else if (b == 0xf2 || b == 0xf3)
+                rep_prefix = b;
+            else if (b != 0x2e && b != 0x3e && b != 0x26 && b != 0x36 && b != 0x64 && b != 0x65)
+                break;
+        }
+        // A REX prefix has to come right before the opcode.
+        if (is_64bit && pos < max_length && (bytes[pos] & 0xf0) == 0x40)
+        {
+            rex_w = (bytes[pos] & 0x08) != 0;
+            ++pos;
+        }
+        if (pos >= max_length)
+            return 0;
+
+        uint8_t opcode = bytes[pos++];
+        const bool two_byte_opcode = (opcode == 0x0f);
+        uint8_t flags;
+        if (two_byte_opcode)
+        {
+            if (pos >= max_length)
+                return 0;
+            opcode = bytes[pos++];
+            flags = tables.two_byte[opcode];
+        }
+        else
+        {
+            flags = tables.one_byte[opcode];
+            // 0x40-0x4f are inc/dec outside of 64 bit mode.
+            if (!is_64bit && opcode >= 0x40 && opcode <= 0x4f)
+                flags = eOpValid;
+        }
+
+        if (flags == eOpInvalid)
+            return 0;
+        if ((flags & eOpRel32) && operand_size_prefix)
+            return 0;
+        // Outside of "rep ret", "pause", endbr and the SSE moves, f2/f3
+        // are xacquire/xrelease hints llvm may decode on their own.
+        if (rep_prefix && !two_byte_opcode && opcode != 0xc3 && !(opcode == 0x90 && rep_prefix == 0xf3))
+            return 0;
+
+        size_t immediate_size = 0;
+        if (flags & eOpImm8)
+            immediate_size = 1;
+        else if (flags & eOpImm16)
+            immediate_size = 2;
+        else if (flags & eOpRel32)
+            immediate_size = 4;
+        else if (flags & eOpImmZ)
+        {
+            if (rex_w && !two_byte_opcode && opcode >= 0xb8 && opcode <= 0xbf)
+                immediate_size = 8;     // movabs
+            else
+                immediate_size = operand_size_prefix && !rex_w ? 2 : 4;
+        }
+
+        if (flags & eOpModRM)
+        {
+            if (pos >= max_length)
+                return 0;
+            const uint8_t modrm = bytes[pos++];
+            const uint8_t mod = modrm >> 6;
+            const uint8_t reg = (modrm >> 3) & 7;
+            const uint8_t rm = modrm & 7;
+
+            // 0x8f is only "pop r/m" with /0, otherwise it's an XOP prefix.
+            if (!two_byte_opcode && opcode == 0x8f && reg != 0)
+                return 0;
+            if ((flags & eOpGroup3) && reg <= 1)
+                immediate_size = (opcode == 0xf6) ? 1 : (operand_size_prefix ? 2 : 4);
+
+            if (mod != 3)
+            {
+                size_t displacement_size = 0;
+                if (mod == 1)
+                    displacement_size = 1;
+                else if (mod == 2)
+                    displacement_size = 4;
+                if (rm == 4)
+                {
+                    if (pos >= max_length)
+                        return 0;
+                    const uint8_t sib = bytes[pos++];
+                    if (mod == 0 && (sib & 7) == 5)
+                        displacement_size = 4;
+                }
+                else if (mod == 0 && rm == 5)
+                {
+                    displacement_size = 4;  // disp32, rip relative in 64 bit mode
+                }
+                pos += displacement_size;
+            }
+        }
+
+        pos += immediate_size;
+        if (pos > max_length)
+            return 0;
+        return pos;
+    }
+}
+
+bool
+AssemblyParse_x86::read_function_bytes (AddressRange &func)
+{
+    m_func_bytes_addr = func.GetBaseAddress();
+    m_func_bytes.clear();
+    if (!m_func_bytes_addr.IsValid() || func.GetByteSize() == 0)
+        return false;
+
+    Target *target = m_exe_ctx.GetTargetPtr();
+    if (target == NULL)
+        return false;
+
+    const bool prefer_file_cache = true;
+    Error error;
+    m_func_bytes.resize (func.GetByteSize());
+    const size_t bytes_read = target->ReadMemory (m_func_bytes_addr, prefer_file_cache, m_func_bytes.data(),
+                                                  m_func_bytes.size(), error);
+    if (bytes_read == 0 || bytes_read == static_cast<size_t>(-1))
+    {
+        m_func_bytes.clear();
+        return false;
+    }
+    m_func_bytes.resize (bytes_read);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Find the length of the instruction at m_cur_insn and copy its bytes
+// into m_cur_insn_bytes.  Uses the bytes read by read_function_bytes()
+// when they cover m_cur_insn, and reads the memory otherwise.
+//----------------------------------------------------------------------
+bool
+AssemblyParse_x86::read_next_instruction (int &length)
+{
+    length = 0;
+    if (!m_cur_insn.IsValid())
+        return false;
+
+    const addr_t func_addr = m_func_bytes_addr.GetFileAddress();
+    const addr_t insn_addr = m_cur_insn.GetFileAddress();
+    if (!m_func_bytes.empty() && func_addr != LLDB_INVALID_ADDRESS && insn_addr != LLDB_INVALID_ADDRESS &&
+        insn_addr >= func_addr && insn_addr - func_addr < m_func_bytes.size())
+    {
+        const uint8_t *bytes = m_func_bytes.data() + (insn_addr - func_addr);
+        const size_t avail = m_func_bytes.size() - (insn_addr - func_addr);
+
+        length = FastInstructionLength (bytes, avail, m_cpu == k_x86_64);
+        if (length == 0)
+        {
+            char out_string[512];
+            length = ::LLVMDisasmInstruction (m_disasm_context,
+                                              const_cast<uint8_t *>(bytes),
+                                              avail,
+                                              insn_addr, // PC value
+                                              out_string,
+                                              sizeof(out_string));
+        }
+        if (length <= 0 || length > kMaxInstructionByteSize || static_cast<size_t>(length) > avail)
+            return false;
+        ::memcpy (m_cur_insn_bytes, bytes, length);
+        return true;
+    }
+
+    if (!instruction_length (m_cur_insn, length) || length <= 0 || length > kMaxInstructionByteSize)
+        return false;
+
+    const bool prefer_file_cache = true;
+    Error error;
+    Target *target = m_exe_ctx.GetTargetPtr();
+    if (target->ReadMemory (m_cur_insn, prefer_file_cache, m_cur_insn_bytes,
+                            length, error) == static_cast<size_t>(-1))
+        return false;
+    return true;
+}
+
 
 bool
 AssemblyParse_x86::get_non_call_site_unwind_plan (UnwindPlan &unwind_plan)
@@ -660,7 +983,6 @@ AssemblyParse_x86::get_non_call_site_unwind_plan (UnwindPlan &unwind_plan)
     addr_t current_func_text_offset = 0;
     int current_sp_bytes_offset_from_cfa = 0;
     UnwindPlan::Row::RegisterLocation initial_regloc;
-    Error error;
 
     if (!m_cur_insn.IsValid())
     {
@@ -696,8 +1018,6 @@ AssemblyParse_x86::get_non_call_site_unwind_plan (UnwindPlan &unwind_plan)
     // (i386_register_numbers, x86_64_register_numbers).
     std::vector<bool> saved_registers(32, false);
 
-    const bool prefer_file_cache = true;
-
     // Once the prologue has completed we'll save a copy of the unwind instructions
     // If there is an epilogue in the middle of the function, after that epilogue we'll reinstate
     // the unwind setup -- we assume that some code path jumps over the mid-function epilogue
@@ -706,7 +1026,7 @@ AssemblyParse_x86::get_non_call_site_unwind_plan (UnwindPlan &unwind_plan)
     int prologue_completed_sp_bytes_offset_from_cfa;   // The sp value before the epilogue started executed
     std::vector<bool> prologue_completed_saved_registers;
 
-    Target *target = m_exe_ctx.GetTargetPtr();
+    read_function_bytes (m_func_bounds);
     while (m_func_bounds.ContainsFileAddress (m_cur_insn))
     {
         int stack_offset, insn_len;
@@ -716,19 +1036,13 @@ AssemblyParse_x86::get_non_call_site_unwind_plan (UnwindPlan &unwind_plan)
         bool in_epilogue = false;                          // we're in the middle of an epilogue sequence
         bool row_updated = false;                          // The UnwindPlan::Row 'row' has been updated
 
-        if (!instruction_length (m_cur_insn, insn_len) || insn_len == 0 || insn_len > kMaxInstructionByteSize)
+        if (!read_next_instruction (insn_len))
         {
-            // An unrecognized/junk instruction
+            // An unrecognized/junk instruction, or an error reading it out
+            // of the file, stop scanning
             break;
         }
 
-        if (target->ReadMemory (m_cur_insn, prefer_file_cache, m_cur_insn_bytes,
-                                insn_len, error) == static_cast<size_t>(-1))
-        {
-           // Error reading the instruction out of the file, stop scanning
-           break;
-        }
-
         if (push_rbp_pattern_p ())
         {
             current_sp_bytes_offset_from_cfa += m_wordsize;
@@ -999,23 +1313,18 @@ AssemblyParse_x86::augment_unwind_plan_from_call_site (AddressRange& func, Unwin
     // on x86 but it is possible.
     bool reinstate_unwind_state = false;
 
+    read_function_bytes (func);
     while (func.ContainsFileAddress (m_cur_insn))
     {
         int insn_len;
-        if (!instruction_length (m_cur_insn, insn_len)
-            || insn_len == 0 || insn_len > kMaxInstructionByteSize)
+        if (!read_next_instruction (insn_len))
         {
-            // An unrecognized/junk instruction.
+            // An unrecognized/junk instruction, or an error reading it out
+            // of the file, stop scanning.
             break;
         }
         const bool prefer_file_cache = true;
         Error error;
-        if (target->ReadMemory (m_cur_insn, prefer_file_cache, m_cur_insn_bytes,
-                                insn_len, error) == static_cast<size_t>(-1))
-        {
-           // Error reading the instruction out of the file, stop scanning.
-           break;
-        }
 
         // Advance offsets.
         offset += insn_len;
@@ -1302,23 +1611,15 @@ AssemblyParse_x86::find_first_non_prologue_insn (Address &address)
         return false;
     }
 
-    const bool prefer_file_cache = true;
-    Target *target = m_exe_ctx.GetTargetPtr();
+    read_function_bytes (m_func_bounds);
     while (m_func_bounds.ContainsFileAddress (m_cur_insn))
     {
-        Error error;
         int insn_len, offset, regno;
-        if (!instruction_length (m_cur_insn, insn_len) || insn_len > kMaxInstructionByteSize || insn_len == 0)
+        if (!read_next_instruction (insn_len))
         {
-            // An error parsing the instruction, i.e. probably data/garbage - stop scanning
+            // An error parsing or reading the instruction, i.e. probably data/garbage - stop scanning
             break;
         }
-        if (target->ReadMemory (m_cur_insn, prefer_file_cache, m_cur_insn_bytes,
-                                insn_len, error) == static_cast<size_t>(-1))
-        {
-           // Error reading the instruction out of the file, stop scanning
-           break;
-        }
 
         if (push_rbp_pattern_p () || mov_rsp_rbp_pattern_p () || sub_rsp_pattern_p (offset)
             || push_reg_p (regno) || mov_reg_to_local_stack_frame_p (regno, offset)
@@ -9,6 +9,8 @@
 
 #include "lldb/Symbol/Block.h"
 
+#include <mutex>
+
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
@@ -27,6 +29,7 @@ Block::Block(lldb::user_id_t uid) :
     m_ranges (),
     m_inlineInfoSP (),
     m_variable_list_sp (),
+    m_in_scope_variables (),
     m_parsed_block_info (false),
     m_parsed_block_variables (false),
     m_parsed_child_blocks (false)
@@ -645,3 +648,36 @@ Block::GetSiblingForChild (const Block *child_block) const
     return nullptr;
 }
 
+// Blocks are small and numerous, share one mutex for their caches
+// rather than growing each of them.
+static std::mutex &
+GetInScopeVariablesMutex ()
+{
+    static std::mutex g_mutex;
+    return g_mutex;
+}
+
+// The number of addresses a block remembers the in scope variables for.
+static const size_t g_max_in_scope_variables = 4;
+
+VariableListSP
+Block::GetCachedInScopeVariables (addr_t file_addr, bool must_have_valid_location)
+{
+    std::lock_guard<std::mutex> guard(GetInScopeVariablesMutex());
+    for (const InScopeVariables &in_scope : m_in_scope_variables)
+    {
+        if (in_scope.file_addr == file_addr && in_scope.must_have_valid_location == must_have_valid_location)
+            return in_scope.variable_list_sp;
+    }
+    return VariableListSP();
+}
+
+void
+Block::CacheInScopeVariables (addr_t file_addr, bool must_have_valid_location, const VariableListSP &variable_list_sp)
+{
+    std::lock_guard<std::mutex> guard(GetInScopeVariablesMutex());
+    if (m_in_scope_variables.size() >= g_max_in_scope_variables)
+        m_in_scope_variables.erase(m_in_scope_variables.begin());
+    InScopeVariables in_scope = { file_addr, must_have_valid_location, variable_list_sp };
+    m_in_scope_variables.push_back(in_scope);
+}
@@ -486,6 +486,15 @@ ClangASTContext::Finalize()
     m_scratch_ast_source_ap.reset();
 }
 
+size_t
+ClangASTContext::MemorySize() const
+{
+    // Only the AST itself, not the clang objects around it.
+    if (!m_ast_ap)
+        return 0;
+    return m_ast_ap->getASTAllocatedMemory() + m_ast_ap->getSideTableAllocatedMemory();
+}
+
 void
 ClangASTContext::Clear()
 {
@@ -596,7 +605,7 @@ ClangASTContext::getASTContext()
 
         llvm::IntrusiveRefCntPtr<clang::ExternalASTSource> ast_source_ap (new ClangExternalASTSourceCallbacks (ClangASTContext::CompleteTagDecl,
                                                                                                                ClangASTContext::CompleteObjCInterfaceDecl,
-                                                                                                               nullptr,
+                                                                                                               ClangASTContext::FindExternalVisibleDeclsByName,
                                                                                                                ClangASTContext::LayoutRecordType,
                                                                                                                this));
         SetExternalSource (ast_source_ap);
@@ -9561,6 +9570,22 @@ ClangASTContext::CompleteObjCInterfaceDecl (void *baton, clang::ObjCInterfaceDec
     }
 }
 
+void
+ClangASTContext::FindExternalVisibleDeclsByName (void *baton,
+                                                 const clang::DeclContext *decl_ctx,
+                                                 clang::DeclarationName name,
+                                                 llvm::SmallVectorImpl<clang::NamedDecl *> *results)
+{
+    // The only declarations that are added on lookup are the methods of
+    // large classes, see DWARFASTParserClang::CompleteDeferredMethods().
+    ClangASTContext *ast = (ClangASTContext *)baton;
+    if (ast->m_dwarf_ast_parser_ap)
+    {
+        DWARFASTParserClang *dwarf_ast_parser = (DWARFASTParserClang *)ast->m_dwarf_ast_parser_ap.get();
+        dwarf_ast_parser->CompleteDeferredMethods(decl_ctx, name, results);
+    }
+}
+
 DWARFASTParser *
 ClangASTContext::GetDWARFParser()
 {
@@ -9588,8 +9613,16 @@ ClangASTContext::LayoutRecordType(void *baton,
 {
     ClangASTContext *ast = (ClangASTContext *)baton;
     DWARFASTParserClang *dwarf_ast_parser = (DWARFASTParserClang *)ast->GetDWARFParser();
-    return dwarf_ast_parser->GetClangASTImporter().LayoutRecordType(record_decl, bit_size, alignment, field_offsets,
-                                                                    base_offsets, vbase_offsets);
+    if (dwarf_ast_parser->GetClangASTImporter().LayoutRecordType(record_decl, bit_size, alignment, field_offsets,
+                                                                 base_offsets, vbase_offsets))
+        return true;
+
+    // Records completed from a PDB keep their layout in the PDB parser.
+    if (ast->m_pdb_ast_parser_ap)
+        return ast->m_pdb_ast_parser_ap->GetClangASTImporter().LayoutRecordType(record_decl, bit_size, alignment,
+                                                                                 field_offsets, base_offsets,
+                                                                                 vbase_offsets);
+    return false;
 }
 
 //----------------------------------------------------------------------
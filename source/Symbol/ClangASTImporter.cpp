@@ -22,8 +22,8 @@
 using namespace lldb_private;
 using namespace clang;
 
-ClangASTMetrics::Counters ClangASTMetrics::global_counters = { 0, 0, 0, 0, 0, 0 };
-ClangASTMetrics::Counters ClangASTMetrics::local_counters = { 0, 0, 0, 0, 0, 0 };
+ClangASTMetrics::Counters ClangASTMetrics::global_counters = { 0, 0, 0, 0, 0, 0, 0 };
+ClangASTMetrics::Counters ClangASTMetrics::local_counters = { 0, 0, 0, 0, 0, 0, 0 };
 
 void ClangASTMetrics::DumpCounters (Log *log, ClangASTMetrics::Counters &counters)
 {
@@ -31,6 +31,7 @@ void ClangASTMetrics::DumpCounters (Log *log, ClangASTMetrics::Counters &counter
     log->Printf("  Number of lexical Decl queries             : %" PRIu64, counters.m_lexical_query_count);
     log->Printf("  Number of imports initiated by LLDB        : %" PRIu64, counters.m_lldb_import_count);
     log->Printf("  Number of imports conducted by Clang       : %" PRIu64, counters.m_clang_import_count);
+    log->Printf("  Number of imports reused from earlier ASTs : %" PRIu64, counters.m_reused_import_count);
     log->Printf("  Number of Decls completed                  : %" PRIu64, counters.m_decls_completed_count);
     log->Printf("  Number of records laid out                 : %" PRIu64, counters.m_record_layout_count);
 }
@@ -291,6 +292,8 @@ ClangASTImporter::DeportType (clang::ASTContext *dst_ctx,
         decl_context_override.OverrideAllDeclsFromContainingFunction(tag_type->getDecl());
     }
     
+    ReuseImportedDecls(*minion_sp, dst_ctx, src_ctx);
+    
     minion_sp->InitDeportWorkQueues(&decls_to_deport,
                                     &decls_already_deported);
     
@@ -330,6 +333,8 @@ ClangASTImporter::DeportDecl (clang::ASTContext *dst_ctx,
     
     decl_context_override.OverrideAllDeclsFromContainingFunction(decl);
 
+    ReuseImportedDecls(*minion_sp, dst_ctx, src_ctx);
+
     minion_sp->InitDeportWorkQueues(&decls_to_deport,
                                     &decls_already_deported);
 
@@ -781,6 +786,49 @@ ClangASTImporter::GetDeclOrigin(const clang::Decl *decl)
         return DeclOrigin();
 }
 
+void
+ClangASTImporter::ReuseImportedDecls (Minion &minion, clang::ASTContext *dst_ctx, clang::ASTContext *src_ctx)
+{
+    ASTContextMetadataSP to_context_md = MaybeGetContextMetadata(dst_ctx);
+    ASTContextMetadataSP from_context_md = MaybeGetContextMetadata(src_ctx);
+    
+    if (!to_context_md || !from_context_md || to_context_md->m_imported_decls.empty())
+        return;
+    
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    
+    ImportedDeclMap &imported_decls = to_context_md->m_imported_decls;
+    
+    // Tell the minion about every Decl in the source that is a copy of
+    // something already imported into the destination, so it uses that
+    // instead of importing the Decl and checking it for structural
+    // equivalence against what is already there.
+    for (const OriginMap::value_type &origin : from_context_md->m_origins)
+    {
+        if (origin.second.ctx == dst_ctx || origin.second.decl == nullptr)
+            continue;
+        
+        ImportedDeclMap::iterator pos = imported_decls.find(OriginKey(origin.second.ctx, origin.second.decl));
+        
+        if (pos == imported_decls.end())
+            continue;
+        
+        clang::Decl *from = const_cast<clang::Decl *>(origin.first);
+        
+        if (from->getKind() != pos->second->getKind() || minion.GetAlreadyImportedOrNull(from))
+            continue;
+        
+        minion.ASTImporter::Imported(from, pos->second);
+        
+        ClangASTMetrics::RegisterReusedImport();
+        
+        if (log)
+            log->Printf("    [ClangASTImporter] Reusing (%sDecl*)%p for (Decl*)%p from (ASTContext*)%p",
+                        pos->second->getDeclKindName(), static_cast<void*>(pos->second),
+                        static_cast<void*>(from), static_cast<void*>(src_ctx));
+    }
+}
+
 void
 ClangASTImporter::SetDeclOrigin (const clang::Decl *decl, clang::Decl *original_decl)
 {
@@ -880,6 +928,16 @@ ClangASTImporter::ForgetSource (clang::ASTContext *dst_ast, clang::ASTContext *s
 
     md->m_minions.erase(src_ast);
 
+    for (ImportedDeclMap::iterator iter = md->m_imported_decls.begin();
+         iter != md->m_imported_decls.end();
+         )
+    {
+        if (iter->first.first == src_ast)
+            md->m_imported_decls.erase(iter++);
+        else
+            ++iter;
+    }
+
     for (OriginMap::iterator iter = md->m_origins.begin();
          iter != md->m_origins.end();
          )
@@ -1078,6 +1136,13 @@ ClangASTImporter::Minion::Imported (clang::Decl *from, clang::Decl *to)
                 if (origin_iter->second.ctx != &to->getASTContext())
                     to_context_md->m_origins[to] = origin_iter->second;
             }
+            
+            if (origin_iter->second.ctx != &to->getASTContext())
+            {
+                // Keep the first copy, later ones are only made when the
+                // minions didn't know about it.
+                to_context_md->m_imported_decls.insert(std::make_pair(OriginKey(origin_iter->second.ctx, origin_iter->second.decl), to));
+            }
                 
             MinionSP direct_completer = m_master.GetMinion(&to->getASTContext(), origin_iter->second.ctx);
 
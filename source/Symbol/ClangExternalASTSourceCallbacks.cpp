@@ -170,7 +170,15 @@ ClangExternalASTSourceCallbacks::FindExternalLexicalDecls (const clang::DeclCont
     {
         clang::TagDecl *tag_decl = llvm::dyn_cast<clang::TagDecl>(const_cast<clang::DeclContext *>(decl_ctx));
         if (tag_decl)
+        {
             CompleteType(tag_decl);
+
+            // Some methods of a class can be left out when it is completed.
+            // An empty name asks for all of them, but loading only the
+            // fields for the layout doesn't need them.
+            if (m_callback_find_by_name && IsKindWeWant(clang::Decl::CXXMethod))
+                m_callback_find_by_name (m_callback_baton, decl_ctx, clang::DeclarationName(), nullptr);
+        }
     }
 }
 
@@ -258,6 +258,37 @@ CompileUnit::GetLineTable()
     return m_line_table_ap.get();
 }
 
+size_t
+CompileUnit::GetFunctionsMemorySize () const
+{
+    size_t mem_size = m_functions.capacity() * sizeof(lldb::FunctionSP);
+    for (const lldb::FunctionSP &function_sp : m_functions)
+    {
+        if (function_sp)
+            mem_size += function_sp->MemorySize();
+    }
+    return mem_size;
+}
+
+size_t
+CompileUnit::GetLineTableMemorySize () const
+{
+    size_t mem_size = m_support_files.MemorySize();
+    if (m_line_table_ap)
+        mem_size += m_line_table_ap->MemorySize();
+    return mem_size;
+}
+
+size_t
+CompileUnit::ReleaseLineTable ()
+{
+    const size_t mem_size = GetLineTableMemorySize();
+    m_line_table_ap.reset();
+    m_support_files.Clear();
+    m_flags.Clear(flagsParsedLineTable | flagsParsedSupportFiles);
+    return mem_size;
+}
+
 void
 CompileUnit::SetLineTable(LineTable* line_table)
 {
@@ -10,6 +10,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <list>
 
 #include "lldb/Core/Log.h"
@@ -24,6 +25,7 @@
 #include "lldb/Symbol/UnwindPlan.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Thread.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -126,6 +128,10 @@ DWARFCallFrameInfo::GetFunctionAddressAndSizeVector (FunctionAddressAndSizeVecto
 const DWARFCallFrameInfo::CIE*
 DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 {
+    // ParseCIE needs the section data, read it before taking the lock.
+    GetCFIData();
+
+    std::lock_guard<std::mutex> guard(m_cie_map_mutex);
     cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
     if (pos != m_cie_map.end())
@@ -287,6 +293,10 @@ DWARFCallFrameInfo::ParseCIE (const dw_offset_t cie_offset)
 void
 DWARFCallFrameInfo::GetCFIData()
 {
+    if (m_cfi_data_initialized)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_cfi_data_mutex);
     if (m_cfi_data_initialized == false)
     {
         Log *log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
@@ -298,7 +308,8 @@ DWARFCallFrameInfo::GetCFIData()
 }
 // Scan through the eh_frame or debug_frame section looking for FDEs and noting the start/end addresses
 // of the functions and a pointer back to the function's FDE for later expansion.
-// Internalize CIEs as we come across them.
+// The FDEs are found through the .eh_frame_hdr search table when there is one, else by walking the
+// entry lengths; their headers are then decoded in parallel.  CIEs are internalized as they are needed.
 
 void
 DWARFCallFrameInfo::GetFDEIndex ()
@@ -314,11 +325,127 @@ DWARFCallFrameInfo::GetFDEIndex ()
     if (m_fde_index_initialized) // if two threads hit the locker
         return;
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "%s - %s", __PRETTY_FUNCTION__, m_objfile.GetFileSpec().GetFilename().AsCString(""));
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s - %s", __PRETTY_FUNCTION__, m_objfile.GetFileSpec().GetFilename().AsCString(""));
 
-    lldb::offset_t offset = 0;
     if (m_cfi_data_initialized == false)
         GetCFIData();
+
+    std::vector<dw_offset_t> fde_offsets;
+    if (!GetFDEOffsetsFromEHFrameHeader (fde_offsets) && !GetFDEOffsetsFromSection (fde_offsets))
+    {
+        // Don't trust anything in this eh_frame section if we find blatantly
+        // invalid data.
+        m_fde_index.Clear();
+        m_fde_index_initialized = true;
+        return;
+    }
+
+    const size_t k_fdes_per_task = 4096;
+    const size_t num_tasks = (fde_offsets.size() + k_fdes_per_task - 1) / k_fdes_per_task;
+    std::vector<std::vector<FDEEntryMap::Entry>> task_fdes (num_tasks);
+    auto parse_fdes = [this, &fde_offsets, &task_fdes, k_fdes_per_task](size_t task_idx)
+    {
+        const size_t begin = task_idx * k_fdes_per_task;
+        const size_t end = std::min (begin + k_fdes_per_task, fde_offsets.size());
+        std::vector<FDEEntryMap::Entry> &fdes = task_fdes[task_idx];
+        fdes.reserve (end - begin);
+        for (size_t i = begin; i < end; ++i)
+        {
+            FDEEntryMap::Entry fde;
+            if (ParseFDEEntry (fde_offsets[i], fde))
+                fdes.push_back (fde);
+        }
+    };
+
+    if (num_tasks > 1)
+    {
+        TaskRunner<void> task_runner;
+        for (size_t task_idx = 0; task_idx < num_tasks; ++task_idx)
+            task_runner.AddTask (parse_fdes, task_idx);
+        task_runner.WaitForAllTasks();
+    }
+    else if (num_tasks == 1)
+    {
+        parse_fdes (0);
+    }
+
+    m_fde_index.Clear();
+    m_fde_index.Reserve (fde_offsets.size());
+    for (const std::vector<FDEEntryMap::Entry> &fdes : task_fdes)
+    {
+        for (const FDEEntryMap::Entry &fde : fdes)
+            m_fde_index.Append (fde);
+    }
+    m_fde_index.Sort();
+    m_fde_index_initialized = true;
+}
+
+// The .eh_frame_hdr section holds a table of the FDEs sorted by function address for a binary search
+// at runtime; it also saves us from walking all of .eh_frame.
+
+bool
+DWARFCallFrameInfo::GetFDEOffsetsFromEHFrameHeader (std::vector<dw_offset_t> &fde_offsets)
+{
+    if (!m_is_eh_frame)
+        return false;
+
+    SectionList *section_list = m_objfile.GetSectionList();
+    if (section_list == nullptr)
+        return false;
+
+    static ConstString g_eh_frame_hdr_name (".eh_frame_hdr");
+    SectionSP hdr_section_sp (section_list->FindSectionByName (g_eh_frame_hdr_name));
+    if (!hdr_section_sp || hdr_section_sp->IsEncrypted())
+        return false;
+
+    DataExtractor hdr_data;
+    if (m_objfile.ReadSectionData (hdr_section_sp.get(), hdr_data) < 4)
+        return false;
+
+    lldb::offset_t offset = 0;
+    const uint8_t version = hdr_data.GetU8 (&offset);
+    const uint8_t eh_frame_ptr_enc = hdr_data.GetU8 (&offset);
+    const uint8_t fde_count_enc = hdr_data.GetU8 (&offset);
+    const uint8_t table_enc = hdr_data.GetU8 (&offset);
+    if (version != 1 || fde_count_enc == DW_EH_PE_omit || table_enc == DW_EH_PE_omit)
+        return false;
+
+    const lldb::addr_t hdr_addr = hdr_section_sp->GetFileAddress();
+    const lldb::addr_t eh_frame_addr = m_section_sp->GetFileAddress();
+    const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+    if (hdr_data.GetGNUEHPointer (&offset, eh_frame_ptr_enc, hdr_addr, text_addr, hdr_addr) != eh_frame_addr)
+        return false;
+    const uint64_t fde_count = hdr_data.GetGNUEHPointer (&offset, fde_count_enc, hdr_addr, text_addr, hdr_addr);
+    if (fde_count == 0 || fde_count > hdr_data.GetByteSize())
+        return false;
+
+    fde_offsets.reserve (fde_count);
+    for (uint64_t i = 0; i < fde_count; ++i)
+    {
+        if (!hdr_data.ValidOffset (offset))
+        {
+            fde_offsets.clear();
+            return false;
+        }
+        hdr_data.GetGNUEHPointer (&offset, table_enc, hdr_addr, text_addr, hdr_addr); // initial location
+        const lldb::addr_t fde_addr = hdr_data.GetGNUEHPointer (&offset, table_enc, hdr_addr, text_addr, hdr_addr);
+        if (fde_addr < eh_frame_addr || fde_addr - eh_frame_addr >= m_cfi_data.GetByteSize())
+        {
+            fde_offsets.clear();
+            return false;
+        }
+        fde_offsets.push_back (fde_addr - eh_frame_addr);
+    }
+    return true;
+}
+
+// Walk the entry lengths of the section.  Returns false if the section is corrupt.
+
+bool
+DWARFCallFrameInfo::GetFDEOffsetsFromSection (std::vector<dw_offset_t> &fde_offsets)
+{
+    lldb::offset_t offset = 0;
     while (m_cfi_data.ValidOffsetForDataOfSize (offset, 8))
     {
         const dw_offset_t current_entry = offset;
@@ -342,11 +469,8 @@ DWARFCallFrameInfo::GetFDEIndex ()
                     "error: Invalid fde/cie next entry offset of 0x%x found in cie/fde at 0x%x\n",
                     next_entry,
                     current_entry);
-            // Don't trust anything in this eh_frame section if we find blatantly
-            // invalid data.
-            m_fde_index.Clear();
-            m_fde_index_initialized = true;
-            return;
+            fde_offsets.clear();
+            return false;
         }
         if (cie_offset > m_cfi_data.GetByteSize())
         {
@@ -354,44 +478,59 @@ DWARFCallFrameInfo::GetFDEIndex ()
                     "error: Invalid cie offset of 0x%x found in cie/fde at 0x%x\n",
                     cie_offset,
                     current_entry);
-            // Don't trust anything in this eh_frame section if we find blatantly
-            // invalid data.
-            m_fde_index.Clear();
-            m_fde_index_initialized = true;
-            return;
+            fde_offsets.clear();
+            return false;
         }
 
-        if (cie_id == 0 || cie_id == UINT32_MAX || len == 0)
-        {
-            m_cie_map[current_entry] = ParseCIE (current_entry);
-            offset = next_entry;
-            continue;
-        }
-
-        const CIE *cie = GetCIE (cie_offset);
-        if (cie)
-        {
-            const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
-            const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
-            const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
-
-            lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, text_addr, data_addr);
-            lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
-            FDEEntryMap::Entry fde (addr, length, current_entry);
-            m_fde_index.Append(fde);
-        }
-        else
-        {
-            Host::SystemLog (Host::eSystemLogError, 
-                             "error: unable to find CIE at 0x%8.8x for cie_id = 0x%8.8x for entry at 0x%8.8x.\n", 
-                             cie_offset,
-                             cie_id,
-                             current_entry);
-        }
+        if (!(cie_id == 0 || cie_id == UINT32_MAX || len == 0))
+            fde_offsets.push_back (current_entry);
         offset = next_entry;
     }
-    m_fde_index.Sort();
-    m_fde_index_initialized = true;
+    return true;
+}
+
+// Decode the function range of the FDE at fde_offset.  Called from several threads at once.
+
+bool
+DWARFCallFrameInfo::ParseFDEEntry (dw_offset_t fde_offset, FDEEntryMap::Entry &fde)
+{
+    if (!m_cfi_data.ValidOffsetForDataOfSize (fde_offset, 8))
+        return false;
+
+    lldb::offset_t offset = fde_offset;
+    dw_offset_t cie_id, cie_offset;
+    uint32_t len = m_cfi_data.GetU32 (&offset);
+    if (len == UINT32_MAX) {
+        len = m_cfi_data.GetU64 (&offset);
+        cie_id = m_cfi_data.GetU64 (&offset);
+        cie_offset = fde_offset + 12 - cie_id;
+    } else {
+        cie_id = m_cfi_data.GetU32 (&offset);
+        cie_offset = fde_offset + 4 - cie_id;
+    }
+
+    if (cie_id == 0 || cie_id == UINT32_MAX || len == 0 || cie_offset > m_cfi_data.GetByteSize())
+        return false;
+
+    const CIE *cie = GetCIE (cie_offset);
+    if (cie == nullptr)
+    {
+        Host::SystemLog (Host::eSystemLogError, 
+                         "error: unable to find CIE at 0x%8.8x for cie_id = 0x%8.8x for entry at 0x%8.8x.\n", 
+                         cie_offset,
+                         cie_id,
+                         fde_offset);
+        return false;
+    }
+
+    const lldb::addr_t pc_rel_addr = m_section_sp->GetFileAddress();
+    const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+    const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+
+    lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, text_addr, data_addr);
+    lldb::addr_t length = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
+    fde = FDEEntryMap::Entry (addr, length, fde_offset);
+    return true;
 }
 
 bool
@@ -316,7 +316,14 @@ Function::GetBlock (bool can_create)
         CalculateSymbolContext(&sc);
         if (sc.module_sp)
         {
-            sc.module_sp->GetSymbolVendor()->ParseFunctionBlocks(sc);
+            // Threads can be unwound in parallel, check again once we hold
+            // the module lock so the blocks are only parsed once.
+            std::lock_guard<std::recursive_mutex> guard(sc.module_sp->GetMutex());
+            if (!m_block.BlockInfoHasBeenParsed())
+            {
+                sc.module_sp->GetSymbolVendor()->ParseFunctionBlocks(sc);
+                m_block.SetBlockInfoHasBeenParsed (true, true);
+            }
         }
         else
         {
@@ -324,8 +331,8 @@ Function::GetBlock (bool can_create)
                              "error: unable to find module shared pointer for function '%s' in %s\n", 
                              GetName().GetCString(),
                              m_comp_unit->GetPath().c_str());
+            m_block.SetBlockInfoHasBeenParsed (true, true);
         }
-        m_block.SetBlockInfoHasBeenParsed (true, true);
     }
     return m_block;
 }
@@ -23,7 +23,10 @@ using namespace lldb_private;
 //----------------------------------------------------------------------
 LineTable::LineTable(CompileUnit* comp_unit) :
     m_comp_unit(comp_unit),
-    m_entries()
+    m_entries(),
+    m_file_line_index(),
+    m_file_line_index_built(false),
+    m_file_line_index_mutex()
 {
 }
 
@@ -58,6 +61,7 @@ LineTable::InsertLineEntry
 //  Stream s(stdout);
 //  s << "\n\nBefore:\n";
 //  Dump (&s, Address::DumpStyleFileAddress);
+    ClearFileLineIndex();
     m_entries.insert(pos, entry);
 //  s << "After:\n";
 //  Dump (&s, Address::DumpStyleFileAddress);
@@ -127,6 +131,7 @@ LineTable::InsertSequence (LineSequence* sequence)
     if (seq->m_entries.empty())
         return;
     Entry& entry = seq->m_entries.front();
+    ClearFileLineIndex();
     
     // If the first entry address in this sequence is greater than or equal to
     // the address of the last item in our entry collection, just append.
@@ -195,6 +200,15 @@ LineTable::GetSize() const
     return m_entries.size();
 }
 
+size_t
+LineTable::MemorySize () const
+{
+    size_t mem_size = sizeof(LineTable) + m_entries.capacity() * sizeof(Entry);
+    for (const FileLineIndex &file_index : m_file_line_index)
+        mem_size += sizeof(FileLineIndex) + (file_index.lines.capacity() + file_index.rows.capacity()) * sizeof(uint32_t);
+    return mem_size;
+}
+
 bool
 LineTable::GetLineEntryAtIndex(uint32_t idx, LineEntry& line_entry)
 {
@@ -313,6 +327,83 @@ LineTable::ConvertEntryAtIndexToLineEntry (uint32_t idx, LineEntry &line_entry)
     return false;
 }
 
+void
+LineTable::ClearFileLineIndex ()
+{
+    std::lock_guard<std::mutex> guard(m_file_line_index_mutex);
+    m_file_line_index.clear();
+    m_file_line_index_built = false;
+}
+
+void
+LineTable::BuildFileLineIndex ()
+{
+    if (m_file_line_index_built)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_file_line_index_mutex);
+    if (m_file_line_index_built)
+        return;
+
+    // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
+    m_file_line_index.clear();
+    const size_t count = m_entries.size();
+    for (size_t idx = 0; idx < count; ++idx)
+    {
+        const Entry &entry = m_entries[idx];
+        if (entry.is_terminal_entry)
+            continue;
+        if (entry.file_idx >= m_file_line_index.size())
+            m_file_line_index.resize(entry.file_idx + 1);
+        m_file_line_index[entry.file_idx].rows.push_back(idx);
+    }
+
+    // The rows were added in order, a stable sort by line keeps the rows
+    // of each line in order too.
+    for (FileLineIndex &index : m_file_line_index)
+    {
+        std::stable_sort(index.rows.begin(), index.rows.end(), [this] (uint32_t lhs, uint32_t rhs) {
+            return m_entries[lhs].line < m_entries[rhs].line;
+        });
+        index.lines.reserve(index.rows.size());
+        for (uint32_t row : index.rows)
+            index.lines.push_back(m_entries[row].line);
+    }
+    m_file_line_index_built = true;
+}
+
+uint32_t
+LineTable::FindRowInFileLineIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact) const
+{
+    if (file_idx >= m_file_line_index.size())
+        return UINT32_MAX;
+
+    const FileLineIndex &index = m_file_line_index[file_idx];
+    const size_t line_begin = std::lower_bound(index.lines.begin(), index.lines.end(), line) - index.lines.begin();
+    const size_t line_end = std::upper_bound(index.lines.begin() + line_begin, index.lines.end(), line) - index.lines.begin();
+
+    // Exact match always wins.
+    std::vector<uint32_t>::const_iterator row_pos = std::lower_bound(index.rows.begin() + line_begin,
+                                                                     index.rows.begin() + line_end,
+                                                                     start_idx);
+    if (row_pos != index.rows.begin() + line_end)
+        return *row_pos;
+    if (exact)
+        return UINT32_MAX;
+
+    // Otherwise the closest line > the desired line. Rows before start_idx
+    // only need to be skipped when a search resumes part way through the
+    // table.
+    // FIXME: Maybe want to find the line closest before and the line closest after and
+    // if they're not in the same function, don't return a match.
+    for (size_t pos = line_end, count = index.rows.size(); pos < count; ++pos)
+    {
+        if (index.rows[pos] >= start_idx)
+            return index.rows[pos];
+    }
+    return UINT32_MAX;
+}
+
 uint32_t
 LineTable::FindLineEntryIndexByFileIndex 
 (
@@ -323,41 +414,28 @@ LineTable::FindLineEntryIndexByFileIndex
     LineEntry* line_entry_ptr
 )
 {
+    BuildFileLineIndex();
 
-    const size_t count = m_entries.size();
-    std::vector<uint32_t>::const_iterator begin_pos = file_indexes.begin();
-    std::vector<uint32_t>::const_iterator end_pos = file_indexes.end();
-    size_t best_match = UINT32_MAX;
-
-    for (size_t idx = start_idx; idx < count; ++idx)
+    // An exact match in any of the files wins over the closest line after
+    // it, and the first match in the table wins between the files.
+    uint32_t best_match = UINT32_MAX;
+    bool best_match_is_exact = false;
+    for (uint32_t file_idx : file_indexes)
     {
-        // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
+        const uint32_t idx = FindRowInFileLineIndex(start_idx, file_idx, line, exact);
+        if (idx == UINT32_MAX)
             continue;
 
-        if (find (begin_pos, end_pos, m_entries[idx].file_idx) == end_pos)
-            continue;
-
-        // Exact match always wins.  Otherwise try to find the closest line > the desired
-        // line.
-        // FIXME: Maybe want to find the line closest before and the line closest after and
-        // if they're not in the same function, don't return a match.
-
-        if (m_entries[idx].line < line)
+        const bool is_exact = m_entries[idx].line == line;
+        if (best_match == UINT32_MAX || (is_exact && !best_match_is_exact))
         {
-            continue;
+            best_match = idx;
+            best_match_is_exact = is_exact;
         }
-        else if (m_entries[idx].line == line)
+        else if (is_exact == best_match_is_exact)
         {
-            if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
-            return idx;
-        }
-        else if (!exact)
-        {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
+            const uint32_t best_line = m_entries[best_match].line;
+            if (m_entries[idx].line < best_line || (m_entries[idx].line == best_line && idx < best_match))
                 best_match = idx;
         }
     }
@@ -374,42 +452,9 @@ LineTable::FindLineEntryIndexByFileIndex
 uint32_t
 LineTable::FindLineEntryIndexByFileIndex (uint32_t start_idx, uint32_t file_idx, uint32_t line, bool exact, LineEntry* line_entry_ptr)
 {
-    const size_t count = m_entries.size();
-    size_t best_match = UINT32_MAX;
-
-    for (size_t idx = start_idx; idx < count; ++idx)
-    {
-        // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-        if (m_entries[idx].is_terminal_entry)
-            continue;
-
-        if (m_entries[idx].file_idx != file_idx)
-            continue;
-
-        // Exact match always wins.  Otherwise try to find the closest line > the desired
-        // line.
-        // FIXME: Maybe want to find the line closest before and the line closest after and
-        // if they're not in the same function, don't return a match.
-
-        if (m_entries[idx].line < line)
-        {
-            continue;
-        }
-        else if (m_entries[idx].line == line)
-        {
-            if (line_entry_ptr)
-                ConvertEntryAtIndexToLineEntry (idx, *line_entry_ptr);
-            return idx;
-        }
-        else if (!exact)
-        {
-            if (best_match == UINT32_MAX)
-                best_match = idx;
-            else if (m_entries[idx].line < m_entries[best_match].line)
-                best_match = idx;
-        }
-    }
+    BuildFileLineIndex();
 
+    const uint32_t best_match = FindRowInFileLineIndex(start_idx, file_idx, line, exact);
     if (best_match != UINT32_MAX)
     {
         if (line_entry_ptr)
@@ -428,26 +473,22 @@ LineTable::FineLineEntriesForFileIndex (uint32_t file_idx,
     if (!append)
         sc_list.Clear();
 
+    BuildFileLineIndex();
+    if (file_idx >= m_file_line_index.size())
+        return 0;
+
+    // The entries are returned in the order of the table.
+    std::vector<uint32_t> rows (m_file_line_index[file_idx].rows);
+    std::sort(rows.begin(), rows.end());
+
     size_t num_added = 0;
-    const size_t count = m_entries.size();
-    if (count > 0)
+    SymbolContext sc (m_comp_unit);
+    for (uint32_t idx : rows)
     {
-        SymbolContext sc (m_comp_unit);
-
-        for (size_t idx = 0; idx < count; ++idx)
+        if (ConvertEntryAtIndexToLineEntry (idx, sc.line_entry))
         {
-            // Skip line table rows that terminate the previous row (is_terminal_entry is non-zero)
-            if (m_entries[idx].is_terminal_entry)
-                continue;
-            
-            if (m_entries[idx].file_idx == file_idx)
-            {
-                if (ConvertEntryAtIndexToLineEntry (idx, sc.line_entry))
-                {
-                    ++num_added;
-                    sc_list.Append(sc);
-                }
-            }
+            ++num_added;
+            sc_list.Append(sc);
         }
     }
     return num_added;
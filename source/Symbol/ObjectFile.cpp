@@ -38,7 +38,8 @@ ObjectFile::FindPlugin (const lldb::ModuleSP &module_sp,
 
     if (module_sp)
     {
-        Timer scoped_timer (__PRETTY_FUNCTION__,
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer (func_cat,
                             "ObjectFile::FindPlugin (module = %s, file = %p, file_offset = 0x%8.8" PRIx64 ", file_size = 0x%8.8" PRIx64 ")",
                             module_sp->GetFileSpec().GetPath().c_str(),
                             static_cast<const void*>(file),
@@ -119,11 +120,20 @@ ObjectFile::FindPlugin (const lldb::ModuleSP &module_sp,
 
             if (data_sp && data_sp->GetByteSize() > 0)
             {
-                // Check if this is a normal object file by iterating through
-                // all object file plugin instances.
-                ObjectFileCreateInstance create_object_file_callback;
-                for (uint32_t idx = 0; (create_object_file_callback = PluginManager::GetObjectFileCreateCallbackAtIndex(idx)) != nullptr; ++idx)
+                // Check if this is a normal object file by trying the object
+                // file plugin instances that might recognize its magic.
+                std::vector<uint32_t> plugin_indexes;
+                if (data_offset < data_sp->GetByteSize())
+                    PluginManager::GetObjectFilePluginIndexesForData (data_sp->GetBytes() + data_offset,
+                                                                       data_sp->GetByteSize() - data_offset,
+                                                                       plugin_indexes);
+                else
+                    PluginManager::GetObjectFilePluginIndexesForData (nullptr, 0, plugin_indexes);
+                for (uint32_t idx : plugin_indexes)
                 {
+                    ObjectFileCreateInstance create_object_file_callback = PluginManager::GetObjectFileCreateCallbackAtIndex(idx);
+                    if (create_object_file_callback == nullptr)
+                        continue;
                     object_file_sp.reset (create_object_file_callback(module_sp, data_sp, data_offset, file, file_offset, file_size));
                     if (object_file_sp.get())
                         return object_file_sp;
@@ -161,7 +171,8 @@ ObjectFile::FindPlugin (const lldb::ModuleSP &module_sp,
 
     if (module_sp)
     {
-        Timer scoped_timer (__PRETTY_FUNCTION__,
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer (func_cat,
                             "ObjectFile::FindPlugin (module = %s, process = %p, header_addr = 0x%" PRIx64 ")",
                             module_sp->GetFileSpec().GetPath().c_str(),
                             static_cast<void*>(process_sp.get()), header_addr);
@@ -220,10 +231,18 @@ ObjectFile::GetModuleSpecifications (const lldb_private::FileSpec& file,
     const size_t initial_count = specs.GetSize();
     ObjectFileGetModuleSpecifications callback;
     uint32_t i;
-    // Try the ObjectFile plug-ins
-    for (i = 0; (callback = PluginManager::GetObjectFileGetModuleSpecificationsCallbackAtIndex(i)) != nullptr; ++i)
+    // Try the ObjectFile plug-ins that might recognize the magic
+    std::vector<uint32_t> plugin_indexes;
+    if (data_sp && data_offset < data_sp->GetByteSize())
+        PluginManager::GetObjectFilePluginIndexesForData (data_sp->GetBytes() + data_offset,
+                                                           data_sp->GetByteSize() - data_offset,
+                                                           plugin_indexes);
+    else
+        PluginManager::GetObjectFilePluginIndexesForData (nullptr, 0, plugin_indexes);
+    for (uint32_t idx : plugin_indexes)
     {
-        if (callback (file, data_sp, data_offset, file_offset, file_size, specs) > 0)
+        callback = PluginManager::GetObjectFileGetModuleSpecificationsCallbackAtIndex(idx);
+        if (callback && callback (file, data_sp, data_offset, file_offset, file_size, specs) > 0)
             return specs.GetSize() - initial_count;
     }
 
@@ -9,6 +9,7 @@
 
 #include "lldb/Symbol/Symbol.h"
 
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/Section.h"
@@ -445,6 +446,108 @@ Symbol::GetPrologueByteSize ()
     return 0;
 }
 
+namespace
+{
+    // The bit fields of a symbol in the symbol table cache
+    enum EncodedFlags
+    {
+        eEncodedIsSynthetic             = (1u << 0),
+        eEncodedIsDebug                 = (1u << 1),
+        eEncodedIsExternal              = (1u << 2),
+        eEncodedSizeIsSibling           = (1u << 3),
+        eEncodedSizeIsSynthesized       = (1u << 4),
+        eEncodedSizeIsValid             = (1u << 5),
+        eEncodedDemangledIsSynthesized  = (1u << 6),
+        eEncodedContainsLinkerAnnotations = (1u << 7),
+        eEncodedNameIsMangled           = (1u << 8)
+    };
+}
+
+void
+Symbol::Encode (Stream &strm) const
+{
+    // Only the mangled name is saved, the demangled one is computed again
+    // when needed. Names that aren't mangled are kept as the demangled name.
+    ConstString name = m_mangled.GetMangledName();
+    const bool name_is_mangled = (bool)name;
+    if (!name_is_mangled)
+        name = m_mangled.GetDemangledName(eLanguageTypeUnknown);
+
+    uint32_t flags = 0;
+    if (m_is_synthetic)                 flags |= eEncodedIsSynthetic;
+    if (m_is_debug)                     flags |= eEncodedIsDebug;
+    if (m_is_external)                  flags |= eEncodedIsExternal;
+    if (m_size_is_sibling)              flags |= eEncodedSizeIsSibling;
+    if (m_size_is_synthesized)          flags |= eEncodedSizeIsSynthesized;
+    if (m_size_is_valid)                flags |= eEncodedSizeIsValid;
+    if (m_demangled_is_synthesized)     flags |= eEncodedDemangledIsSynthesized;
+    if (m_contains_linker_annotations)  flags |= eEncodedContainsLinkerAnnotations;
+    if (name_is_mangled)                flags |= eEncodedNameIsMangled;
+
+    const Address &base_addr = m_addr_range.GetBaseAddress();
+    SectionSP section_sp (base_addr.GetSection());
+
+    strm.PutHex32 (m_uid);
+    strm.PutHex16 (m_type_data);
+    strm.PutHex16 (flags);
+    strm.PutHex8 (m_type);
+    strm.PutHex32 (m_flags);
+    strm.PutHex64 (section_sp ? section_sp->GetID() : 0);
+    strm.PutHex64 (base_addr.GetOffset());
+    strm.PutHex64 (m_addr_range.GetByteSize());
+    const char *cstr = name.AsCString("");
+    strm.Write (cstr, strlen (cstr) + 1);
+}
+
+bool
+Symbol::Decode (const DataExtractor &data, lldb::offset_t *offset_ptr, const SectionList *section_list)
+{
+    // uid, type data, flags, type, symbol flags, section ID, offset and size
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 4 + 2 + 2 + 1 + 4 + 8 + 8 + 8))
+        return false;
+    const uint32_t uid = data.GetU32 (offset_ptr);
+    const uint16_t type_data = data.GetU16 (offset_ptr);
+    const uint16_t flags = data.GetU16 (offset_ptr);
+    const uint8_t type = data.GetU8 (offset_ptr);
+    const uint32_t symbol_flags = data.GetU32 (offset_ptr);
+    const user_id_t section_id = data.GetU64 (offset_ptr);
+    const addr_t offset = data.GetU64 (offset_ptr);
+    const addr_t size = data.GetU64 (offset_ptr);
+    const char *cstr = data.GetCStr (offset_ptr);
+    if (cstr == nullptr || type > eSymbolTypeReExported)
+        return false;
+
+    SectionSP section_sp;
+    if (section_id != 0)
+    {
+        section_sp = section_list ? section_list->FindSectionByID (section_id) : SectionSP();
+        if (!section_sp)
+            return false;
+    }
+
+    m_uid = uid;
+    m_type_data = type_data;
+    m_type_data_resolved = false;
+    m_is_synthetic = (flags & eEncodedIsSynthetic) != 0;
+    m_is_debug = (flags & eEncodedIsDebug) != 0;
+    m_is_external = (flags & eEncodedIsExternal) != 0;
+    m_size_is_sibling = (flags & eEncodedSizeIsSibling) != 0;
+    m_size_is_synthesized = (flags & eEncodedSizeIsSynthesized) != 0;
+    m_size_is_valid = (flags & eEncodedSizeIsValid) != 0;
+    m_demangled_is_synthesized = (flags & eEncodedDemangledIsSynthesized) != 0;
+    m_contains_linker_annotations = (flags & eEncodedContainsLinkerAnnotations) != 0;
+    m_type = type;
+    m_mangled.SetValue (ConstString (cstr), (flags & eEncodedNameIsMangled) != 0);
+    if (section_sp)
+        m_addr_range.GetBaseAddress().SetSection (section_sp);
+    else
+        m_addr_range.GetBaseAddress().ClearSection();
+    m_addr_range.GetBaseAddress().SetOffset (offset);
+    m_addr_range.SetByteSize (size);
+    m_flags = symbol_flags;
+    return true;
+}
+
 bool
 Symbol::Compare(const ConstString& name, SymbolType type) const
 {
@@ -48,8 +48,11 @@ SymbolFile::FindPlugin (ObjectFile* obj_file)
 
         uint32_t best_symfile_abilities = 0;
 
-        SymbolFileCreateInstance create_callback;
-        for (uint32_t idx = 0; (create_callback = PluginManager::GetSymbolFileCreateCallbackAtIndex(idx)) != nullptr; ++idx)
+        // Only create the plug-ins that can work with this kind of object
+        // file.
+        std::vector<SymbolFileCreateInstance> create_callbacks;
+        PluginManager::GetSymbolFileCreateCallbacksForObjectFile (obj_file->GetPluginName(), create_callbacks);
+        for (SymbolFileCreateInstance create_callback : create_callbacks)
         {
             std::unique_ptr<SymbolFile> curr_symfile_ap(create_callback(obj_file));
 
@@ -19,6 +19,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/TypeSystem.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -547,6 +548,50 @@ SymbolVendor::SectionFileAddressesChanged ()
     }
 }
 
+void
+SymbolVendor::GetMemoryUsage (MemoryUsage &usage)
+{
+    ModuleSP module_sp(GetModule());
+    if (!module_sp)
+        return;
+
+    std::lock_guard<std::recursive_mutex> guard(module_sp->GetMutex());
+    if (m_sym_file_ap.get())
+        usage.symbol_file += m_sym_file_ap->GetCachedDataMemorySize();
+    usage.types += m_type_list.MemorySize();
+    for (const CompUnitSP &cu_sp : m_compile_units)
+    {
+        if (cu_sp)
+        {
+            usage.functions += cu_sp->GetFunctionsMemorySize();
+            usage.line_tables += cu_sp->GetLineTableMemorySize();
+        }
+    }
+    module_sp->ForEachTypeSystem ([&usage](TypeSystem *type_system) -> bool {
+        usage.type_systems += type_system->MemorySize();
+        return true;
+    });
+}
+
+size_t
+SymbolVendor::ReleaseCachedData ()
+{
+    ModuleSP module_sp(GetModule());
+    if (!module_sp)
+        return 0;
+
+    std::lock_guard<std::recursive_mutex> guard(module_sp->GetMutex());
+    size_t released = 0;
+    for (const CompUnitSP &cu_sp : m_compile_units)
+    {
+        if (cu_sp)
+            released += cu_sp->ReleaseLineTable();
+    }
+    if (m_sym_file_ap.get())
+        released += m_sym_file_ap->ReleaseCachedData();
+    return released;
+}
+
 //------------------------------------------------------------------
 // PluginInterface protocol
 //------------------------------------------------------------------
@@ -7,32 +7,58 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <string.h>
+#include <algorithm>
 #include <map>
 #include <set>
 
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/Symtab.h"
+#include "lldb/Target/Platform.h"
+#include "lldb/Utility/TaskPool.h"
 #include "Plugins/Language/ObjC/ObjCLanguage.h"
 #include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
+#include "Utility/ModuleCache.h"
+#include "llvm/Support/FileSystem.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+// Demangled Itanium names always contain a scope, an argument or template
+// argument list or a space ("vtable for ..."), so a plain identifier can
+// only be found by its mangled or C name.
+static bool
+IsDemangledCPlusPlusName (const char *name)
+{
+    return name != nullptr && ::strpbrk (name, "(:< ") != nullptr;
+}
+
 Symtab::Symtab(ObjectFile *objfile)
     : m_objfile(objfile),
       m_symbols(),
       m_file_addr_to_index(),
       m_name_to_index(),
       m_mutex(),
+      m_parse_time(0),
+      m_index_time(0),
       m_file_addr_to_index_computed(false),
-      m_name_indexes_computed(false)
+      m_name_indexes_computed(false),
+      m_demangled_names_indexed(true),
+      m_demangled_name_cache_loaded(false)
 {
 }
 
@@ -85,6 +111,13 @@ Symtab::SectionFileAddressesChanged ()
     m_file_addr_to_index_computed = false;
 }
 
+void
+Symtab::PreloadSymbols ()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    InitNameIndexes();
+}
+
 void
 Symtab::Dump (Stream *s, Target *target, SortOrder sort_order)
 {
@@ -264,7 +297,9 @@ Symtab::InitNameIndexes()
     if (!m_name_indexes_computed)
     {
         m_name_indexes_computed = true;
-        Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
+        IntervalTimer index_timer;
         // Create the name index vector to be able to quickly search by name
         const size_t num_symbols = m_symbols.size();
 #if 1
@@ -289,6 +324,20 @@ Symtab::InitNameIndexes()
         m_name_to_index.Reserve (actual_count);
 #endif
 
+        // Demangling is by far the most expensive part of building the name
+        // indexes. When lazy demangling is enabled only the mangled names are
+        // indexed now and the demangled names of C++ symbols are added by
+        // IndexDemangledNames() once a lookup needs them.
+        const bool lazy_demangling = Platform::GetGlobalPlatformProperties()->GetLazySymbolDemangling();
+        m_demangled_names_indexed = true;
+        m_demangled_name_cache_loaded = LoadDemangledNameCache();
+        if (!lazy_demangling)
+        {
+            DemangleSymbols();
+            if (!m_demangled_name_cache_loaded)
+                SaveDemangledNameCache();
+        }
+
         NameToIndexMap::Entry entry;
 
         // The "const char *" in "class_contexts" must come from a ConstString::GetCString()
@@ -329,15 +378,35 @@ Symtab::InitNameIndexes()
                          entry.cstring[2] != 'G' && // avoid guard variables
                          entry.cstring[2] != 'Z'))  // named local entities (if we eventually handle eSymbolTypeData, we will want this back)
                     {
-                        CPlusPlusLanguage::MethodName cxx_method (mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
-                        entry.cstring = ConstString(cxx_method.GetBasename()).GetCString();
+                        ConstString basename;
+                        ConstString context;
+                        bool has_qualifiers = false;
+                        std::string mangled_context, mangled_basename;
+                        if (lazy_demangling &&
+                            CPlusPlusLanguage::ExtractContextAndIdentifierFromMangledName(entry.cstring,
+                                                                                          mangled_context,
+                                                                                          mangled_basename,
+                                                                                          has_qualifiers))
+                        {
+                            basename.SetCString(mangled_basename.c_str());
+                            context.SetCString(mangled_context.c_str());
+                        }
+                        else
+                        {
+                            CPlusPlusLanguage::MethodName cxx_method (mangled.GetDemangledName(lldb::eLanguageTypeC_plus_plus));
+                            basename.SetString(cxx_method.GetBasename());
+                            context.SetString(cxx_method.GetContext());
+                            has_qualifiers = !cxx_method.GetQualifiers().empty();
+                        }
+
+                        entry.cstring = basename.GetCString();
                         if (entry.cstring && entry.cstring[0])
                         {
                             // ConstString objects permanently store the string in the pool so calling
                             // GetCString() on the value gets us a const char * that will never go away
-                            const char *const_context = ConstString(cxx_method.GetContext()).GetCString();
+                            const char *const_context = context.GetCString();
 
-                            if (entry.cstring[0] == '~' || !cxx_method.GetQualifiers().empty())
+                            if (entry.cstring[0] == '~' || has_qualifiers)
                             {
                                 // The first character of the demangled basename is '~' which
                                 // means we have a class destructor. We can use this information
@@ -378,6 +447,12 @@ Symtab::InitNameIndexes()
                 }
             }
             
+            if (lazy_demangling && CPlusPlusLanguage::IsCPPMangledName(mangled.GetMangledName().GetCString()))
+            {
+                m_demangled_names_indexed = false;
+                continue;
+            }
+
             entry.cstring = mangled.GetDemangledName(symbol->GetLanguage()).GetCString();
             if (entry.cstring && entry.cstring[0]) {
                 m_name_to_index.Append (entry);
@@ -431,14 +506,11 @@ Symtab::InitNameIndexes()
                 }
             }
         }
-        m_name_to_index.Sort();
-        m_name_to_index.SizeToFit();
-        m_selector_to_index.Sort();
-        m_selector_to_index.SizeToFit();
-        m_basename_to_index.Sort();
-        m_basename_to_index.SizeToFit();
-        m_method_to_index.Sort();
-        m_method_to_index.SizeToFit();
+        TaskPool::RunTasks(
+            [this]() { m_name_to_index.Sort(); m_name_to_index.SizeToFit(); },
+            [this]() { m_selector_to_index.Sort(); m_selector_to_index.SizeToFit(); },
+            [this]() { m_basename_to_index.Sort(); m_basename_to_index.SizeToFit(); },
+            [this]() { m_method_to_index.Sort(); m_method_to_index.SizeToFit(); });
     
 //        static StreamFile a ("/tmp/a.txt");
 //
@@ -460,7 +532,258 @@ Symtab::InitNameIndexes()
 //                    a.Printf ("%s METHOD\n", m_symbols[entry.value].GetMangled().GetName().GetCString());
 //            }
 //        }
+        m_index_time += index_timer.GetElapsedNanoSeconds();
+    }
+}
+
+//----------------------------------------------------------------------
+// DemangleSymbols
+//
+// Demangle all of the symbols in parallel. Mangled caches the result so
+// later calls to GetDemangledName() only have to look it up. Each task
+// works on its own range of symbols so no Mangled object is touched by
+// more than one thread and the ConstString pool is thread safe.
+//----------------------------------------------------------------------
+void
+Symtab::DemangleSymbols ()
+{
+    // Protected function, no need to lock mutex...
+    const size_t num_symbols = m_symbols.size();
+    const size_t symbols_per_task = 1024;
+    auto demangle_fn = [this, num_symbols, symbols_per_task](size_t start_idx)
+    {
+        const size_t end_idx = std::min(start_idx + symbols_per_task, num_symbols);
+        for (size_t idx = start_idx; idx < end_idx; ++idx)
+        {
+            const Symbol &symbol = m_symbols[idx];
+            if (!symbol.IsTrampoline())
+                symbol.GetMangled().GetDemangledName(symbol.GetLanguage());
+        }
+    };
+
+    // Not worth the overhead of the task pool for small symbol tables
+    if (num_symbols <= symbols_per_task)
+    {
+        demangle_fn(0);
+        return;
+    }
+
+    TaskRunner<void> task_runner;
+    for (size_t start_idx = 0; start_idx < num_symbols; start_idx += symbols_per_task)
+        task_runner.AddTask(demangle_fn, start_idx);
+    task_runner.WaitForAllTasks();
+}
+
+//----------------------------------------------------------------------
+// IndexDemangledNames
+//
+// Add the demangled names of the C++ symbols that InitNameIndexes()
+// skipped because lazy demangling was enabled.
+//----------------------------------------------------------------------
+void
+Symtab::IndexDemangledNames ()
+{
+    // Protected function, no need to lock mutex...
+    if (m_demangled_names_indexed)
+        return;
+    m_demangled_names_indexed = true;
+
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
+    IntervalTimer index_timer;
+    DemangleSymbols();
+
+    NameToIndexMap::Entry entry;
+    const size_t num_symbols = m_symbols.size();
+    for (entry.value = 0; entry.value < num_symbols; ++entry.value)
+    {
+        const Symbol *symbol = &m_symbols[entry.value];
+        if (symbol->IsTrampoline())
+            continue;
+
+        const Mangled &mangled = symbol->GetMangled();
+        if (!CPlusPlusLanguage::IsCPPMangledName(mangled.GetMangledName().GetCString()))
+            continue;
+
+        entry.cstring = mangled.GetDemangledName(symbol->GetLanguage()).GetCString();
+        if (entry.cstring && entry.cstring[0])
+        {
+            m_name_to_index.Append (entry);
+
+            if (symbol->ContainsLinkerAnnotations())
+            {
+                entry.cstring = ConstString(m_objfile->StripLinkerSymbolAnnotations(entry.cstring)).GetCString();
+                m_name_to_index.Append (entry);
+            }
+        }
+    }
+    m_name_to_index.Sort();
+    m_name_to_index.SizeToFit();
+
+    if (!m_demangled_name_cache_loaded)
+        SaveDemangledNameCache();
+
+    m_index_time += index_timer.GetElapsedNanoSeconds();
+}
+
+namespace {
+
+    // Bump this whenever the encoding of the demangled name cache changes
+    const char *g_demangled_name_cache_magic = "LLDBDMNG";
+    const uint32_t g_demangled_name_cache_version = 1;
+
+}  // anonymous namespace
+
+void
+Symtab::Encode (Stream &strm) const
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    strm.PutHex32 (m_symbols.size());
+    for (const Symbol &symbol : m_symbols)
+        symbol.Encode (strm);
+}
+
+bool
+Symtab::Decode (const DataExtractor &data, lldb::offset_t *offset_ptr, const SectionList *section_list)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, 4))
+        return false;
+    const uint32_t count = data.GetU32 (offset_ptr);
+    // Each symbol is at least 37 bytes of fields and a NULL terminator
+    if (count > data.BytesLeft (*offset_ptr) / 38)
+        return false;
+
+    collection symbols (count);
+    for (Symbol &symbol : symbols)
+    {
+        if (!symbol.Decode (data, offset_ptr, section_list))
+            return false;
+    }
+    m_symbols.swap (symbols);
+    return true;
+}
+
+bool
+Symtab::GetDemangledNameCacheFileSpec (FileSpec &cache_file_spec) const
+{
+    PlatformProperties *properties = Platform::GetGlobalPlatformProperties().get();
+    if (!properties->GetUseDemangledNameCache() || m_objfile == nullptr)
+        return false;
+
+    ModuleSP module_sp (m_objfile->GetModule());
+    if (!module_sp || !module_sp->GetUUID().IsValid())
+        return false;
+
+    const FileSpec &obj_file_spec = m_objfile->GetFileSpec();
+    const TimeValue mod_time = obj_file_spec.GetModificationTime();
+    if (!mod_time.IsValid())
+        return false;
+
+    FileSpec dir_spec = properties->GetModuleCacheDirectory();
+    if (!dir_spec)
+        return false;
+
+    StreamString file_name;
+    file_name.Printf ("%s-%s-%" PRIu64 ".names",
+                      module_sp->GetUUID().GetAsString().c_str(),
+                      obj_file_spec.GetFilename().AsCString("<Unknown>"),
+                      mod_time.GetAsSecondsSinceJan1_1970());
+    cache_file_spec = dir_spec;
+    cache_file_spec.AppendPathComponent ("demangled_names");
+    cache_file_spec.AppendPathComponent (file_name.GetData());
+    return true;
+}
+
+bool
+Symtab::LoadDemangledNameCache ()
+{
+    FileSpec cache_file_spec;
+    if (!GetDemangledNameCacheFileSpec (cache_file_spec) || !cache_file_spec.Exists())
+        return false;
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    DataBufferSP data_sp = ModuleCache::MapDataFile (cache_file_spec);
+    if (!data_sp)
+        return false;
+
+    DataExtractor data (data_sp, endian::InlHostByteOrder(), 4);
+    lldb::offset_t offset = 0;
+    const size_t magic_len = strlen (g_demangled_name_cache_magic);
+    const char *magic = (const char *)data.GetData (&offset, magic_len);
+    const uint32_t version = data.GetU32 (&offset);
+    const uint32_t count = data.GetU32 (&offset);
+    if (magic == nullptr ||
+        ::memcmp (magic, g_demangled_name_cache_magic, magic_len) != 0 ||
+        version != g_demangled_name_cache_version ||
+        count > data.BytesLeft (offset) / 4)
+    {
+        if (log)
+            log->Printf ("Symtab::LoadDemangledNameCache() ignoring invalid cache file '%s'",
+                         cache_file_spec.GetPath().c_str());
+        return false;
+    }
+
+    // Registering the demangled names as the mangled counterparts of the
+    // mangled names makes Mangled::GetDemangledName() find them without
+    // running the demangler.
+    uint32_t num_loaded = 0;
+    for (; num_loaded < count; ++num_loaded)
+    {
+        const char *mangled_cstr = data.GetCStr (&offset);
+        const char *demangled_cstr = data.GetCStr (&offset);
+        if (mangled_cstr == nullptr || demangled_cstr == nullptr)
+            break;
+        ConstString demangled;
+        demangled.SetCStringWithMangledCounterpart (demangled_cstr, ConstString (mangled_cstr));
+    }
+
+    if (log)
+        log->Printf ("Symtab::LoadDemangledNameCache() loaded %u of %u names from '%s'",
+                     num_loaded, count, cache_file_spec.GetPath().c_str());
+    return num_loaded == count;
+}
+
+void
+Symtab::SaveDemangledNameCache () const
+{
+    FileSpec cache_file_spec;
+    if (!GetDemangledNameCacheFileSpec (cache_file_spec))
+        return;
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    StreamString names (Stream::eBinary, 4, endian::InlHostByteOrder());
+    uint32_t count = 0;
+    for (const Symbol &symbol : m_symbols)
+    {
+        const Mangled &mangled = symbol.GetMangled();
+        ConstString mangled_name = mangled.GetMangledName();
+        if (!CPlusPlusLanguage::IsCPPMangledName(mangled_name.GetCString()))
+            continue;
+        ConstString demangled_name = mangled.GetDemangledName(symbol.GetLanguage());
+        if (!demangled_name)
+            continue;
+        names.Write (mangled_name.GetCString(), mangled_name.GetLength() + 1);
+        names.Write (demangled_name.GetCString(), demangled_name.GetLength() + 1);
+        ++count;
+    }
+
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    strm.Write (g_demangled_name_cache_magic, strlen (g_demangled_name_cache_magic));
+    strm.PutHex32 (g_demangled_name_cache_version);
+    strm.PutHex32 (count);
+    strm.Write (names.GetData(), names.GetSize());
+
+    const std::string cache_path = cache_file_spec.GetPath();
+    Error error = ModuleCache::WriteDataFile (cache_file_spec, strm.GetData(), strm.GetSize());
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf ("Symtab::SaveDemangledNameCache() failed to write '%s': %s",
+                         cache_path.c_str(), error.AsCString());
     }
+    else if (log)
+        log->Printf ("Symtab::SaveDemangledNameCache() saved %u names to '%s'", count, cache_path.c_str());
 }
 
 void
@@ -471,7 +794,8 @@ Symtab::AppendSymbolNamesToMap (const IndexCollection &indexes,
 {
     if (add_demangled || add_mangled)
     {
-        Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
         std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
         // Create the name index vector to be able to quickly search by name
@@ -632,7 +956,8 @@ Symtab::SortSymbolIndexesByValue (std::vector<uint32_t>& indexes, bool remove_du
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__,__PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,__PRETTY_FUNCTION__);
     // No need to sort if we have zero or one items...
     if (indexes.size() <= 1)
         return;
@@ -657,12 +982,15 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, std::vector
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
     if (symbol_name)
     {
         const char *symbol_cstr = symbol_name.GetCString();
         if (!m_name_indexes_computed)
             InitNameIndexes();
+        if (!m_demangled_names_indexed && IsDemangledCPlusPlusName(symbol_cstr))
+            IndexDemangledNames();
 
         return m_name_to_index.GetValues (symbol_cstr, indexes);
     }
@@ -674,7 +1002,8 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, Debug symbo
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
     if (symbol_name)
     {
         const size_t old_size = indexes.size();
@@ -682,6 +1011,8 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, Debug symbo
             InitNameIndexes();
 
         const char *symbol_cstr = symbol_name.GetCString();
+        if (!m_demangled_names_indexed && IsDemangledCPlusPlusName(symbol_cstr))
+            IndexDemangledNames();
         
         std::vector<uint32_t> all_name_indexes;
         const size_t name_match_count = m_name_to_index.GetValues (symbol_cstr, all_name_indexes);
@@ -810,7 +1141,8 @@ Symtab::FindAllSymbolsWithNameAndType (const ConstString &name, SymbolType symbo
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
     // Initialize all of the lookup by name indexes before converting NAME
     // to a uniqued string NAME_STR below.
     if (!m_name_indexes_computed)
@@ -830,7 +1162,8 @@ Symtab::FindAllSymbolsWithNameAndType (const ConstString &name, SymbolType symbo
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
     // Initialize all of the lookup by name indexes before converting NAME
     // to a uniqued string NAME_STR below.
     if (!m_name_indexes_computed)
@@ -859,7 +1192,8 @@ Symtab::FindFirstSymbolWithNameAndType (const ConstString &name, SymbolType symb
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s", __PRETTY_FUNCTION__);
     if (!m_name_indexes_computed)
         InitNameIndexes();
 
@@ -1017,6 +1351,9 @@ Symtab::InitAddressIndexes()
 
             // Sort again in case the range size changes the ordering
             m_file_addr_to_index.Sort();
+            // ForEachSymbolContainingFileAddress() looks for all the symbols
+            // that contain an address.
+            m_file_addr_to_index.BuildContainmentIndex();
         }
     }
 }
@@ -85,6 +85,12 @@ TypeList::GetSize() const
     return m_types.size();
 }
 
+size_t
+TypeList::MemorySize() const
+{
+    return sizeof(TypeList) + m_types.capacity() * sizeof(lldb::TypeSP) + m_types.size() * sizeof(Type);
+}
+
 // GetTypeAtIndex isn't used a lot for large type lists, currently only for
 // type lists that are returned for "image dump -t TYPENAME" commands and other
 // simple symbol queries that grab the first result...
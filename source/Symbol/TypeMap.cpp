@@ -25,6 +25,7 @@
 #include "clang/Basic/SourceManager.h"
 #include "clang/Basic/TargetInfo.h"
 
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/FormattedStream.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -215,6 +216,11 @@ TypeMap::RemoveMismatchedTypes (const std::string &type_scope,
     // types to it, and then swap it into m_types at the end
     collection matching_types;
 
+    // The same type is often found many times, e.g. once in every module
+    // that uses it, so only split each distinct name into its scope and
+    // basename once.
+    llvm::DenseMap<const char *, bool> name_matches;
+
     iterator pos, end = m_types.end();
     
     for (pos = m_types.begin(); pos != end; ++pos)
@@ -231,7 +237,12 @@ TypeMap::RemoveMismatchedTypes (const std::string &type_scope,
         }
 
         ConstString match_type_name_const_str (the_type->GetQualifiedName());
-        if (match_type_name_const_str)
+        auto name_match_pos = name_matches.find (match_type_name_const_str.GetCString());
+        if (name_match_pos != name_matches.end())
+        {
+            keep_match = name_match_pos->second;
+        }
+        else if (match_type_name_const_str)
         {
             const char *match_type_name = match_type_name_const_str.GetCString();
             std::string match_type_scope;
@@ -287,6 +298,7 @@ TypeMap::RemoveMismatchedTypes (const std::string &type_scope,
                 // is no type scope...
                 keep_match = type_scope.empty() && type_basename.compare(match_type_name) == 0;
             }
+            name_matches[match_type_name] = keep_match;
         }
         
         if (keep_match)
@@ -245,6 +245,16 @@ UnwindPlan::Row::SetRegisterInfo (uint32_t reg_num, const UnwindPlan::Row::Regis
     m_register_locations[reg_num] = register_location;
 }
 
+void
+UnwindPlan::Row::ForEachRegisterInfo (const std::function<bool(uint32_t, const RegisterLocation &)> &callback) const
+{
+    for (const auto &pos : m_register_locations)
+    {
+        if (!callback (pos.first, pos.second))
+            break;
+    }
+}
+
 bool
 UnwindPlan::Row::SetRegisterLocationToAtCFAPlusOffset (uint32_t reg_num, int32_t offset, bool can_replace)
 {
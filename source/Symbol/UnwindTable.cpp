@@ -11,6 +11,8 @@
 
 #include <stdio.h>
 
+#include <algorithm>
+
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
 #include "lldb/Symbol/ObjectFile.h"
@@ -30,8 +32,11 @@ using namespace lldb_private;
 UnwindTable::UnwindTable(ObjectFile &objfile)
     : m_object_file(objfile),
       m_unwinds(),
+      m_functions(),
       m_initialized(false),
       m_mutex(),
+      m_cached_rows_mutex(),
+      m_cached_rows(),
       m_eh_frame_up(),
       m_compact_unwind_up(),
       m_arm_unwind_up()
@@ -59,6 +64,19 @@ UnwindTable::Initialize ()
         if (sect.get())
         {
             m_eh_frame_up.reset(new DWARFCallFrameInfo(m_object_file, sect, eRegisterKindEHFrame, true));
+
+            DWARFCallFrameInfo::FunctionAddressAndSizeVector functions;
+            m_eh_frame_up->GetFunctionAddressAndSizeVector (functions);
+            const size_t num_functions = functions.GetSize();
+            m_functions.reserve (num_functions);
+            for (size_t i = 0; i < num_functions; ++i)
+            {
+                const DWARFCallFrameInfo::FunctionAddressAndSizeVector::Entry *entry = functions.GetEntryAtIndex (i);
+                if (entry && entry->GetByteSize() > 0)
+                    m_functions.push_back (FunctionEntry{entry->GetRangeBase(), entry->GetByteSize(), FuncUnwindersSP()});
+            }
+            std::sort (m_functions.begin(), m_functions.end(),
+                       [](const FunctionEntry &lhs, const FunctionEntry &rhs) { return lhs.base < rhs.base; });
         }
         sect = sl->FindSectionByType (eSectionTypeCompactUnwind, true);
         if (sect.get())
@@ -90,23 +108,37 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
 
     Initialize();
 
-    std::lock_guard<std::mutex> guard(m_mutex);
-
     // There is an UnwindTable per object file, so we can safely use file handles
     addr_t file_addr = addr.GetFileAddress();
-    iterator end = m_unwinds.end ();
-    iterator insert_pos = end;
-    if (!m_unwinds.empty())
+
+    // Functions with an FDE are found without locking. Their FuncUnwinders
+    // span the FDE, if two threads race to create one the first wins.
+    FunctionEntry *function = FindFunctionEntry (file_addr);
+    if (function)
     {
-        insert_pos = m_unwinds.lower_bound (file_addr);
-        iterator pos = insert_pos;
-        if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second->GetFunctionStartAddress() != addr))
-            --pos;
+        FuncUnwindersSP func_unwinder_sp (std::atomic_load (&function->unwinders));
+        if (func_unwinder_sp)
+            return func_unwinder_sp;
+
+        AddressRange range (function->base, function->size, m_object_file.GetSectionList());
+        if (range.GetBaseAddress().IsValid())
+        {
+            FuncUnwindersSP new_unwinder_sp (new FuncUnwinders(*this, range));
+            if (std::atomic_compare_exchange_strong (&function->unwinders, &func_unwinder_sp, new_unwinder_sp))
+                return new_unwinder_sp;
+            return func_unwinder_sp;
+        }
+    }
 
-        if (pos->second->ContainsAddress (addr))
-            return pos->second;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        FuncUnwindersSP func_unwinder_sp (FindFuncUnwinders (addr, file_addr));
+        if (func_unwinder_sp)
+            return func_unwinder_sp;
     }
 
+    // Threads can be unwound in parallel, don't hold the lock while the
+    // function bounds are looked up in the eh_frame.
     AddressRange range;
     if (!sc.GetAddressRange(eSymbolContextFunction | eSymbolContextSymbol, 0, false, range) || !range.GetBaseAddress().IsValid())
     {
@@ -117,13 +149,52 @@ UnwindTable::GetFuncUnwindersContainingAddress (const Address& addr, SymbolConte
         }
     }
 
-    FuncUnwindersSP func_unwinder_sp(new FuncUnwinders(*this, range));
-    m_unwinds.insert (insert_pos, std::make_pair(range.GetBaseAddress().GetFileAddress(), func_unwinder_sp));
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    // Another thread may have added the function in the meantime.
+    FuncUnwindersSP func_unwinder_sp (FindFuncUnwinders (addr, file_addr));
+    if (func_unwinder_sp)
+        return func_unwinder_sp;
+
+    func_unwinder_sp.reset(new FuncUnwinders(*this, range));
+    m_unwinds.insert (std::make_pair(range.GetBaseAddress().GetFileAddress(), func_unwinder_sp));
 //    StreamFile s(stdout, false);
 //    Dump (s);
     return func_unwinder_sp;
 }
 
+// The caller must hold m_mutex.
+FuncUnwindersSP
+UnwindTable::FindFuncUnwinders (const Address& addr, addr_t file_addr)
+{
+    if (m_unwinds.empty())
+        return FuncUnwindersSP();
+
+    iterator pos = m_unwinds.lower_bound (file_addr);
+    if ((pos == m_unwinds.end ()) || (pos != m_unwinds.begin() && pos->second->GetFunctionStartAddress() != addr))
+        --pos;
+
+    if (pos->second->ContainsAddress (addr))
+        return pos->second;
+    return FuncUnwindersSP();
+}
+
+UnwindTable::FunctionEntry *
+UnwindTable::FindFunctionEntry (addr_t file_addr)
+{
+    if (m_functions.empty() || file_addr == LLDB_INVALID_ADDRESS)
+        return nullptr;
+
+    auto pos = std::upper_bound (m_functions.begin(), m_functions.end(), file_addr,
+                                 [](addr_t addr, const FunctionEntry &entry) { return addr < entry.base; });
+    if (pos == m_functions.begin())
+        return nullptr;
+    --pos;
+    if (file_addr - pos->base < pos->size)
+        return &*pos;
+    return nullptr;
+}
+
 // Ignore any existing FuncUnwinders for this function, create a new one and don't add it to the
 // UnwindTable.  This is intended for use by target modules show-unwind where we want to create 
 // new UnwindPlans, not re-use existing ones.
@@ -160,6 +231,12 @@ UnwindTable::Dump (Stream &s)
     {
         s.Printf ("[%u] 0x%16.16" PRIx64 "\n", (unsigned)std::distance (begin, pos), pos->first);
     }
+    for (size_t i = 0; i < m_functions.size(); ++i)
+    {
+        s.Printf ("[%u] 0x%16.16" PRIx64 " - 0x%16.16" PRIx64 "%s\n", (unsigned)i, m_functions[i].base,
+                  m_functions[i].base + m_functions[i].size,
+                  std::atomic_load (&m_functions[i].unwinders) ? " (unwinders)" : "");
+    }
     s.EOL();
 }
 
@@ -184,6 +261,24 @@ UnwindTable::GetArmUnwindInfo ()
     return m_arm_unwind_up.get();
 }
 
+bool
+UnwindTable::LookupCachedUnwindRow (addr_t file_addr, CachedUnwindRow &row)
+{
+    std::lock_guard<std::mutex> guard(m_cached_rows_mutex);
+    auto pos = m_cached_rows.find (file_addr);
+    if (pos == m_cached_rows.end())
+        return false;
+    row = pos->second;
+    return true;
+}
+
+void
+UnwindTable::AddCachedUnwindRow (addr_t file_addr, const CachedUnwindRow &row)
+{
+    std::lock_guard<std::mutex> guard(m_cached_rows_mutex);
+    m_cached_rows[file_addr] = row;
+}
+
 bool
 UnwindTable::GetArchitecture (lldb_private::ArchSpec &arch)
 {
@@ -0,0 +1,409 @@
+//===-- FastTracepoint.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Target/FastTracepoint.h"
+#include "lldb/Core/Address.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Disassembler.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // "jmp rel32" when the trampoline is within 2GB of the tracepoint,
+    // "jmp *0(%rip)" followed by the absolute address otherwise.
+    const size_t k_near_jump_size = 5;
+    const size_t k_far_jump_size = 14;
+
+    // The ring buffer starts with the next sequence number, padded to 16
+    // bytes. Each record is the sequence number and the saved registers.
+    const size_t k_buffer_header_size = 16;
+    const size_t k_record_size = 8 + FastTracepoint::kNumSavedRegisters * 8;
+
+    // The trampoline stays out of the red zone of the interrupted code.
+    const uint32_t k_red_zone_size = 128;
+
+    void
+    AppendBytes (std::vector<uint8_t> &code, std::initializer_list<uint8_t> bytes)
+    {
+        code.insert (code.end(), bytes);
+    }
+
+    void
+    AppendLittleEndian (std::vector<uint8_t> &code, uint64_t value, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+            code.push_back ((value >> (i * 8)) & 0xff);
+    }
+
+    void
+    AppendFarJump (std::vector<uint8_t> &code, addr_t target)
+    {
+        AppendBytes (code, { 0xff, 0x25, 0x00, 0x00, 0x00, 0x00 });
+        AppendLittleEndian (code, target, 8);
+    }
+
+    const char *g_register_names[FastTracepoint::kNumRegisters] =
+    {
+        "r15", "r14", "r13", "r12", "r11", "r10", "r9", "r8",
+        "rdi", "rsi", "rbp", "rsp", "rbx", "rdx", "rcx", "rax",
+        "rflags", "rip"
+    };
+}
+
+FastTracepoint::FastTracepoint (Process &process, lldb::user_id_t id, lldb::addr_t addr, uint32_t capacity) :
+    UserID (id),
+    m_process (process),
+    m_addr (addr),
+    m_capacity (1),
+    m_installed (false),
+    m_original_bytes (),
+    m_trampoline_addr (LLDB_INVALID_ADDRESS),
+    m_trampoline_size (0),
+    m_buffer_addr (LLDB_INVALID_ADDRESS)
+{
+    // The trampoline masks the sequence number, keep it a power of two.
+    while (m_capacity < capacity && m_capacity < (1u << 20))
+        m_capacity <<= 1;
+}
+
+FastTracepoint::~FastTracepoint ()
+{
+}
+
+const char *
+FastTracepoint::GetRegisterName (uint32_t reg)
+{
+    if (reg < kNumRegisters)
+        return g_register_names[reg];
+    return nullptr;
+}
+
+bool
+FastTracepoint::IsAnyThreadInRange (lldb::addr_t addr, size_t size, bool include_start) const
+{
+    ThreadList &thread_list = m_process.GetThreadList();
+    const uint32_t num_threads = thread_list.GetSize();
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        ThreadSP thread_sp (thread_list.GetThreadAtIndex (i));
+        RegisterContextSP reg_ctx_sp (thread_sp ? thread_sp->GetRegisterContext() : RegisterContextSP());
+        if (!reg_ctx_sp)
+            continue;
+        const addr_t pc = reg_ctx_sp->GetPC();
+        if (pc == addr && !include_start)
+            continue;
+        if (pc >= addr && pc < addr + size)
+            return true;
+    }
+    return false;
+}
+
+Error
+FastTracepoint::GetRelocatableInstructions (size_t min_length, std::vector<uint8_t> &bytes)
+{
+    // Reading memory gives us the original bytes even under breakpoints.
+    const ArchSpec &arch = m_process.GetTarget().GetArchitecture();
+    uint8_t buffer[k_far_jump_size + 16];
+    Error error;
+    const size_t bytes_read = m_process.ReadMemory (m_addr, buffer, sizeof(buffer), error);
+    if (bytes_read < min_length)
+        return Error ("unable to read the instructions at 0x%" PRIx64, m_addr);
+
+    DisassemblerSP disassembler_sp (Disassembler::FindPlugin (arch, nullptr, nullptr));
+    if (!disassembler_sp)
+        return Error ("no disassembler for %s", arch.GetArchitectureName());
+
+    DataExtractor data (buffer, bytes_read, arch.GetByteOrder(), arch.GetAddressByteSize());
+    disassembler_sp->DecodeInstructions (Address (m_addr), data, 0, UINT32_MAX, false, false);
+    InstructionList &insns = disassembler_sp->GetInstructionList();
+
+    ExecutionContext exe_ctx;
+    m_process.CalculateExecutionContext (exe_ctx);
+
+    size_t length = 0;
+    for (size_t i = 0; i < insns.GetSize() && length < min_length; ++i)
+    {
+        InstructionSP insn_sp (insns.GetInstructionAtIndex (i));
+        const size_t insn_size = insn_sp ? insn_sp->GetOpcode().GetByteSize() : 0;
+        if (insn_size == 0)
+            break;
+        const addr_t insn_addr = m_addr + length;
+        if (insn_sp->DoesBranch())
+            return Error ("the branch at 0x%" PRIx64 " can't be relocated", insn_addr);
+        // These would address memory relative to the trampoline.
+        const char *operands = insn_sp->GetOperands (&exe_ctx);
+        if (operands && ::strstr (operands, "rip"))
+            return Error ("the RIP relative instruction at 0x%" PRIx64 " can't be relocated", insn_addr);
+        length += insn_size;
+    }
+    if (length < min_length || length > bytes_read)
+        return Error ("unable to decode %" PRIu64 " bytes of instructions at 0x%" PRIx64, (uint64_t)min_length, m_addr);
+
+    // Don't patch past the end of the function into code that may be
+    // reached without going through the tracepoint.
+    Address so_addr;
+    if (m_process.GetTarget().ResolveLoadAddress (m_addr, so_addr))
+    {
+        SymbolContext sc;
+        AddressRange range;
+        so_addr.CalculateSymbolContext (&sc, eSymbolContextFunction | eSymbolContextSymbol);
+        if (sc.GetAddressRange (eSymbolContextFunction | eSymbolContextSymbol, 0, false, range))
+        {
+            const addr_t func_end = range.GetBaseAddress().GetLoadAddress (&m_process.GetTarget()) + range.GetByteSize();
+            if (m_addr + length > func_end)
+                return Error ("the tracepoint at 0x%" PRIx64 " is too close to the end of the function", m_addr);
+        }
+    }
+
+    bytes.assign (buffer, buffer + length);
+    return Error();
+}
+
+void
+FastTracepoint::BuildTrampoline (const std::vector<uint8_t> &relocated, std::vector<uint8_t> &code) const
+{
+    code.clear();
+
+    // lea -0x80(%rsp), %rsp; pushfq
+    AppendBytes (code, { 0x48, 0x8d, 0x64, 0x24, (uint8_t)-k_red_zone_size, 0x9c });
+    // push %rax, %rcx, %rdx, %rbx, %rsp, %rbp, %rsi, %rdi, %r8 ... %r15
+    for (uint8_t reg = 0; reg < 8; ++reg)
+        code.push_back (0x50 + reg);
+    for (uint8_t reg = 0; reg < 8; ++reg)
+        AppendBytes (code, { 0x41, (uint8_t)(0x50 + reg) });
+
+    // movabs $buffer, %rax
+    AppendBytes (code, { 0x48, 0xb8 });
+    AppendLittleEndian (code, m_buffer_addr, 8);
+    // mov $1, %ecx; lock xadd %rcx, (%rax); mov %rcx, %rdx
+    AppendBytes (code, { 0xb9, 0x01, 0x00, 0x00, 0x00 });
+    AppendBytes (code, { 0xf0, 0x48, 0x0f, 0xc1, 0x08 });
+    AppendBytes (code, { 0x48, 0x89, 0xca });
+    // and $(capacity - 1), %rcx; imul $record_size, %rcx, %rcx
+    AppendBytes (code, { 0x48, 0x81, 0xe1 });
+    AppendLittleEndian (code, m_capacity - 1, 4);
+    AppendBytes (code, { 0x48, 0x69, 0xc9 });
+    AppendLittleEndian (code, k_record_size, 4);
+    // lea 0x10(%rax,%rcx), %rdi; mov %rdx, (%rdi); add $8, %rdi
+    AppendBytes (code, { 0x48, 0x8d, 0x7c, 0x08, (uint8_t)k_buffer_header_size });
+    AppendBytes (code, { 0x48, 0x89, 0x17 });
+    AppendBytes (code, { 0x48, 0x83, 0xc7, 0x08 });
+    // mov %rsp, %rsi; mov $count, %ecx; cld; rep movsq
+    AppendBytes (code, { 0x48, 0x89, 0xe6 });
+    AppendBytes (code, { 0xb9 });
+    AppendLittleEndian (code, kNumSavedRegisters, 4);
+    AppendBytes (code, { 0xfc, 0xf3, 0x48, 0xa5 });
+
+    // pop %r15 ... %r8, %rdi, %rsi, %rbp
+    for (uint8_t reg = 8; reg > 0; --reg)
+        AppendBytes (code, { 0x41, (uint8_t)(0x57 + reg) });
+    AppendBytes (code, { 0x5f, 0x5e, 0x5d });
+    // lea 8(%rsp), %rsp to skip the saved %rsp
+    AppendBytes (code, { 0x48, 0x8d, 0x64, 0x24, 0x08 });
+    // pop %rbx, %rdx, %rcx, %rax; popfq; lea 0x80(%rsp), %rsp
+    AppendBytes (code, { 0x5b, 0x5a, 0x59, 0x58, 0x9d });
+    AppendBytes (code, { 0x48, 0x8d, 0xa4, 0x24 });
+    AppendLittleEndian (code, k_red_zone_size, 4);
+
+    code.insert (code.end(), relocated.begin(), relocated.end());
+    AppendFarJump (code, m_addr + relocated.size());
+}
+
+Error
+FastTracepoint::Install ()
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+
+    if (m_installed)
+        return Error();
+
+    if (m_process.GetTarget().GetArchitecture().GetMachine() != llvm::Triple::x86_64)
+        return Error ("fast tracepoints are only supported on x86_64");
+
+    Error error;
+    const uint32_t permissions = ePermissionsReadable | ePermissionsExecutable;
+    const size_t buffer_size = k_buffer_header_size + m_capacity * k_record_size;
+    m_buffer_addr = m_process.AllocateMemory (buffer_size, ePermissionsReadable | ePermissionsWritable, error);
+    if (m_buffer_addr == LLDB_INVALID_ADDRESS)
+        return error;
+
+    // Size the trampoline for the largest patch, which relocates at most a
+    // far jump's worth of bytes plus one more (up to 15 byte) instruction.
+    std::vector<uint8_t> relocated;
+    std::vector<uint8_t> code;
+    error = GetRelocatableInstructions (k_near_jump_size, relocated);
+    if (error.Success())
+    {
+        BuildTrampoline (relocated, code);
+        m_trampoline_size = code.size() - relocated.size() + k_far_jump_size + 15;
+        m_trampoline_addr = m_process.AllocateMemory (m_trampoline_size, permissions, error);
+    }
+
+    // Fall back to an absolute jump if the trampoline isn't in reach of a
+    // 32 bit displacement.
+    if (error.Success())
+    {
+        const int64_t displacement = (int64_t)(m_trampoline_addr - (m_addr + k_near_jump_size));
+        if (displacement != (int32_t)displacement)
+        {
+            error = GetRelocatableInstructions (k_far_jump_size, relocated);
+            if (error.Success())
+                BuildTrampoline (relocated, code);
+        }
+    }
+    if (error.Success() && code.size() > m_trampoline_size)
+        error.SetErrorString ("the trampoline doesn't fit its allocation");
+
+    std::vector<uint8_t> patch;
+    if (error.Success())
+    {
+        const int64_t displacement = (int64_t)(m_trampoline_addr - (m_addr + k_near_jump_size));
+        if (relocated.size() < k_far_jump_size && displacement == (int32_t)displacement)
+        {
+            patch.push_back (0xe9);
+            AppendLittleEndian (patch, displacement, 4);
+        }
+        else
+            AppendFarJump (patch, m_trampoline_addr);
+        // Trap if anything jumps into the middle of the patch.
+        patch.resize (relocated.size(), 0xcc);
+
+        if (IsAnyThreadInRange (m_addr, patch.size(), false))
+            error.SetErrorStringWithFormat ("a thread is stopped inside the instructions at 0x%" PRIx64, m_addr);
+    }
+
+    if (error.Success())
+    {
+        BreakpointSiteList sites;
+        if (m_process.GetBreakpointSiteList().FindInRange (m_addr, m_addr + patch.size(), sites))
+            error.SetErrorStringWithFormat ("a breakpoint is set inside the instructions at 0x%" PRIx64, m_addr);
+    }
+
+    // The ring buffer starts out empty.
+    if (error.Success())
+    {
+        const uint8_t zeros[k_buffer_header_size] = { 0 };
+        m_process.WriteMemory (m_buffer_addr, zeros, sizeof(zeros), error);
+    }
+    if (error.Success())
+        m_process.WriteMemory (m_trampoline_addr, code.data(), code.size(), error);
+    if (error.Success())
+        m_process.WriteMemory (m_addr, patch.data(), patch.size(), error);
+
+    if (error.Fail())
+    {
+        if (m_trampoline_addr != LLDB_INVALID_ADDRESS)
+            m_process.DeallocateMemory (m_trampoline_addr);
+        m_process.DeallocateMemory (m_buffer_addr);
+        m_trampoline_addr = LLDB_INVALID_ADDRESS;
+        m_buffer_addr = LLDB_INVALID_ADDRESS;
+        return error;
+    }
+
+    if (log)
+        log->Printf ("FastTracepoint::%s patched %" PRIu64 " bytes at 0x%" PRIx64 " to jump to 0x%" PRIx64 ", buffer at 0x%" PRIx64,
+                     __FUNCTION__, (uint64_t)patch.size(), m_addr, m_trampoline_addr, m_buffer_addr);
+
+    m_original_bytes.swap (relocated);
+    m_installed = true;
+    return Error();
+}
+
+Error
+FastTracepoint::Remove ()
+{
+    if (!m_installed)
+        return Error();
+
+    Error error;
+    m_process.WriteMemory (m_addr, m_original_bytes.data(), m_original_bytes.size(), error);
+    if (error.Fail())
+        return error;
+    m_installed = false;
+
+    // A thread that is in the middle of the trampoline will still come back
+    // through it, leak it rather than pull the code from under it.
+    if (!IsAnyThreadInRange (m_trampoline_addr, m_trampoline_size, true))
+    {
+        m_process.DeallocateMemory (m_trampoline_addr);
+        m_process.DeallocateMemory (m_buffer_addr);
+    }
+    m_trampoline_addr = LLDB_INVALID_ADDRESS;
+    m_buffer_addr = LLDB_INVALID_ADDRESS;
+    return Error();
+}
+
+void
+FastTracepoint::Invalidate ()
+{
+    m_installed = false;
+    m_original_bytes.clear();
+    m_trampoline_addr = LLDB_INVALID_ADDRESS;
+    m_buffer_addr = LLDB_INVALID_ADDRESS;
+}
+
+Error
+FastTracepoint::ReadSamples (std::vector<Sample> &samples, uint64_t &total_hits)
+{
+    samples.clear();
+    total_hits = 0;
+    if (!m_installed)
+        return Error ("the tracepoint at 0x%" PRIx64 " is not installed", m_addr);
+
+    Error error;
+    total_hits = m_process.ReadUnsignedIntegerFromMemory (m_buffer_addr, 8, 0, error);
+    if (error.Fail())
+        return error;
+
+    const uint64_t count = std::min<uint64_t> (total_hits, m_capacity);
+    if (count == 0)
+        return Error();
+
+    // Read the whole buffer at once and walk the slots from the oldest one.
+    DataBufferHeap records (m_capacity * k_record_size, 0);
+    if (m_process.ReadMemory (m_buffer_addr + k_buffer_header_size, records.GetBytes(), records.GetByteSize(), error) != records.GetByteSize())
+        return error;
+    DataExtractor data (records.GetBytes(), records.GetByteSize(), lldb::eByteOrderLittle, 8);
+
+    samples.reserve (count);
+    for (uint64_t sequence = total_hits - count; sequence < total_hits; ++sequence)
+    {
+        lldb::offset_t offset = (sequence & (m_capacity - 1)) * k_record_size;
+        Sample sample;
+        sample.sequence = data.GetU64 (&offset);
+        // A slot that doesn't match was still being written.
+        if (sample.sequence != sequence)
+            continue;
+        for (uint32_t reg = 0; reg < kNumSavedRegisters; ++reg)
+            sample.registers[reg] = data.GetU64 (&offset);
+        // %rsp was pushed after the red zone and five other registers.
+        sample.registers[eRegisterRSP] += k_red_zone_size + 5 * 8;
+        sample.registers[eRegisterRIP] = m_addr;
+        samples.push_back (sample);
+    }
+    return Error();
+}
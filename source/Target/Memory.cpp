@@ -11,17 +11,34 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/RangeMap.h"
+#include "lldb/Core/Section.h"
 #include "lldb/Core/State.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/SectionLoadList.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+// The L2 cache keeps the most recently used lines up to this many bytes.
+static const size_t g_max_L2_cache_byte_size = 8 * 1024 * 1024;
+
+// How many lines a miss can read at once when we read memory sequentially.
+static const uint32_t g_max_L2_readahead_lines = 16;
+
+// How many ranges we remember whether they are file backed before we
+// start over.
+static const size_t g_max_file_backed_ranges = 4096;
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
@@ -29,9 +46,16 @@ MemoryCache::MemoryCache(Process &process)
     : m_mutex(),
       m_L1_cache(),
       m_L2_cache(),
+      m_L2_lru(),
+      m_L2_cache_byte_size(0),
+      m_L2_next_sequential_addr(LLDB_INVALID_ADDRESS),
+      m_L2_readahead_lines(1),
       m_invalid_ranges(),
+      m_file_backed_ranges(),
       m_process(process),
-      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize())
+      m_L2_cache_line_byte_size(process.GetMemoryCacheLineSize()),
+      m_generation(0),
+      m_stats()
 {
 }
 
@@ -46,11 +70,53 @@ void
 MemoryCache::Clear(bool clear_invalid_ranges)
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    m_L1_cache.clear();
-    m_L2_cache.clear();
+    ++m_generation;
+    m_L2_next_sequential_addr = LLDB_INVALID_ADDRESS;
+    m_L2_readahead_lines = 1;
     if (clear_invalid_ranges)
+    {
         m_invalid_ranges.Clear();
-    m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+        m_file_backed_ranges.Clear();
+    }
+
+    const uint32_t cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+    if (cache_line_byte_size != m_L2_cache_line_byte_size)
+    {
+        m_L2_cache_line_byte_size = cache_line_byte_size;
+        m_L2_cache.clear();
+        m_L2_lru.clear();
+        m_L2_cache_byte_size = 0;
+    }
+
+    // Read only memory that is mapped from a file can't have changed since
+    // the last stop, keep what we have of it.
+    for (BlockMap::iterator pos = m_L1_cache.begin(); pos != m_L1_cache.end();)
+    {
+        if (IsPersistent (pos->first, pos->second->GetByteSize()))
+            ++pos;
+        else
+            pos = m_L1_cache.erase(pos);
+    }
+    std::vector<lldb::addr_t> lines_to_erase;
+    for (const auto &pair : m_L2_cache)
+    {
+        if (!IsPersistent (pair.first, pair.second.data_sp->GetByteSize()))
+            lines_to_erase.push_back (pair.first);
+    }
+    for (lldb::addr_t line_addr : lines_to_erase)
+        EraseL2Line (m_L2_cache.find (line_addr));
+}
+
+void
+MemoryCache::ClearFileBackedRanges ()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    ++m_generation;
+    m_file_backed_ranges.Clear();
+    m_L1_cache.clear();
+    m_L2_cache.clear();
+    m_L2_lru.clear();
+    m_L2_cache_byte_size = 0;
 }
 
 void
@@ -73,6 +139,17 @@ MemoryCache::Flush (addr_t addr, size_t size)
         return;
 
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    ++m_generation;
+
+    // Somebody wrote to the memory, it doesn't match the file anymore and
+    // can change again.
+    const AddrRange written_range(addr, size);
+    for (size_t i = 0; i < m_file_backed_ranges.GetSize(); ++i)
+    {
+        FileBackedRanges::Entry *entry = m_file_backed_ranges.GetMutableEntryAtIndex(i);
+        if (entry->data != eNotFileBacked && entry->DoesIntersect(written_range))
+            entry->data = eFileBackedWritten;
+    }
 
     // Erase any blocks from the L1 cache that intersect with the flush range
     if (!m_L1_cache.empty())
@@ -111,9 +188,9 @@ MemoryCache::Flush (addr_t addr, size_t size)
              cache_idx < num_cache_lines;
              curr_addr += cache_line_byte_size, ++cache_idx)
         {
-            BlockMap::iterator pos = m_L2_cache.find (curr_addr);
+            L2LineMap::iterator pos = m_L2_cache.find (curr_addr);
             if (pos != m_L2_cache.end())
-                m_L2_cache.erase(pos);
+                EraseL2Line (pos);
         }
     }
 }
@@ -147,7 +224,250 @@ MemoryCache::RemoveInvalidRange (lldb::addr_t base_addr, lldb::addr_t byte_size)
     return false;
 }
 
+MemoryCache::Statistics
+MemoryCache::GetStatistics ()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    Statistics stats = m_stats;
+    stats.num_cached_lines = m_L2_cache.size();
+    stats.num_file_backed_ranges = m_file_backed_ranges.GetSize();
+    stats.cached_bytes = m_L2_cache_byte_size;
+    return stats;
+}
+
+DataBufferSP
+MemoryCache::FindL2Line (addr_t line_addr)
+{
+    L2LineMap::iterator pos = m_L2_cache.find (line_addr);
+    if (pos == m_L2_cache.end())
+        return DataBufferSP();
+
+    // Move the line to the front of the LRU list.
+    m_L2_lru.splice (m_L2_lru.begin(), m_L2_lru, pos->second.lru_pos);
+    return pos->second.data_sp;
+}
+
+void
+MemoryCache::InsertL2Line (addr_t line_addr, const DataBufferSP &data_sp)
+{
+    // Another thread may have read the same line meanwhile, keep the line
+    // that is already there.
+    if (m_L2_cache.count (line_addr))
+        return;
+
+    m_L2_lru.push_front (line_addr);
+    L2Line &line = m_L2_cache[line_addr];
+    line.data_sp = data_sp;
+    line.lru_pos = m_L2_lru.begin();
+    m_L2_cache_byte_size += data_sp->GetByteSize();
+
+    while (m_L2_cache_byte_size > g_max_L2_cache_byte_size && m_L2_lru.size() > 1)
+    {
+        EraseL2Line (m_L2_cache.find (m_L2_lru.back()));
+        ++m_stats.num_evictions;
+    }
+}
+
+void
+MemoryCache::EraseL2Line (L2LineMap::iterator pos)
+{
+    m_L2_cache_byte_size -= pos->second.data_sp->GetByteSize();
+    m_L2_lru.erase (pos->second.lru_pos);
+    m_L2_cache.erase (pos);
+}
+
+MemoryCache::FileBackedRanges::Entry *
+MemoryCache::FindFileBackedRange (addr_t addr)
+{
+    FileBackedRanges::Entry *entry = m_file_backed_ranges.FindEntryThatContains(addr);
+    if (entry)
+        return entry;
+
+    if (m_file_backed_ranges.GetSize() >= g_max_file_backed_ranges)
+        m_file_backed_ranges.Clear();
+
+    // The memory is file backed if the process maps it read only and a
+    // section of a loaded module has file contents at the address. Without
+    // memory region information we don't know whether the memory is read
+    // only, and we only remember the line we were asked about.
+    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+    FileBackedRanges::Entry new_entry (addr - (addr % cache_line_byte_size), cache_line_byte_size, eNotFileBacked);
+
+    MemoryRegionInfo region_info;
+    if (m_process.GetMemoryRegionInfo(addr, region_info).Success() && region_info.GetRange().Contains(addr))
+    {
+        if (region_info.GetWritable() != MemoryRegionInfo::eNo)
+        {
+            new_entry.SetRangeBase(region_info.GetRange().GetRangeBase());
+            new_entry.SetRangeEnd(region_info.GetRange().GetRangeEnd());
+        }
+        else
+        {
+            Target &target = m_process.GetTarget();
+            Address so_addr;
+            SectionSP section_sp;
+            if (target.GetSectionLoadList().ResolveLoadAddress(addr, so_addr))
+                section_sp = so_addr.GetSection();
+            const addr_t section_load_addr = section_sp ? section_sp->GetLoadBaseAddress(&target) : LLDB_INVALID_ADDRESS;
+            if (section_load_addr != LLDB_INVALID_ADDRESS && addr - section_load_addr < section_sp->GetFileSize())
+            {
+                new_entry.SetRangeBase(std::max(region_info.GetRange().GetRangeBase(), section_load_addr));
+                new_entry.SetRangeEnd(std::min(region_info.GetRange().GetRangeEnd(), section_load_addr + section_sp->GetFileSize()));
+                new_entry.data = eFileBackedUnverified;
+            }
+        }
+    }
+
+    m_file_backed_ranges.Append(new_entry);
+    m_file_backed_ranges.Sort();
+    return m_file_backed_ranges.FindEntryThatContains(addr);
+}
+
+bool
+MemoryCache::IsPersistent (addr_t addr, size_t size)
+{
+    const FileBackedRanges::Entry *entry = m_file_backed_ranges.FindEntryThatContains(addr);
+    if (entry == nullptr || !entry->Contains(AddrRange(addr, size)))
+        return false;
+    return entry->data == eFileBackedUnverified ||
+           entry->data == eFileBackedIdentical ||
+           entry->data == eFileBackedDifferent;
+}
+
+size_t
+MemoryCache::ReadFromFile (addr_t addr, void *dst, size_t size)
+{
+    Address so_addr;
+    if (!m_process.GetTarget().GetSectionLoadList().ResolveLoadAddress(addr, so_addr))
+        return 0;
+    SectionSP section_sp (so_addr.GetSection());
+    ModuleSP module_sp (section_sp ? section_sp->GetModule() : ModuleSP());
+    ObjectFile *objfile = module_sp ? module_sp->GetObjectFile() : nullptr;
+    if (objfile == nullptr || so_addr.GetOffset() + size > section_sp->GetFileSize())
+        return 0;
+    return objfile->ReadSectionData(section_sp.get(), so_addr.GetOffset(), dst, size);
+}
+
+DataBufferSP
+MemoryCache::FillL2Lines (std::unique_lock<std::recursive_mutex> &guard,
+                          addr_t first_line_addr,
+                          uint32_t cache_line_byte_size,
+                          uint32_t num_lines,
+                          Error &error)
+{
+    // Don't read lines again that are cached already, or that we know we
+    // can't read.
+    uint32_t num_lines_to_read = 1;
+    while (num_lines_to_read < num_lines)
+    {
+        const addr_t line_addr = first_line_addr + num_lines_to_read * cache_line_byte_size;
+        if (line_addr < first_line_addr)
+            break; // Wrapped around the end of the address space
+        if (m_L2_cache.count (line_addr) || m_invalid_ranges.FindEntryThatContains (line_addr))
+            break;
+        ++num_lines_to_read;
+    }
+
+    DataBufferHeap data (num_lines_to_read * cache_line_byte_size, 0);
+    const uint32_t generation = m_generation;
+    size_t bytes_read = 0;
+
+    // Memory we found to be identical to the file it is mapped from we
+    // take from the file, as long as the lines don't go past it.
+    FileBackedRanges::Entry *file_range = FindFileBackedRange (first_line_addr);
+    const addr_t file_lines_size = file_range ? file_range->GetRangeEnd() - first_line_addr : 0;
+    if (file_range && file_range->data == eFileBackedIdentical && file_lines_size >= cache_line_byte_size)
+    {
+        const size_t file_read_size = std::min<size_t> (data.GetByteSize(),
+                                                        file_lines_size - (file_lines_size % cache_line_byte_size));
+        bytes_read = ReadFromFile (first_line_addr, data.GetBytes(), file_read_size);
+        if (bytes_read == file_read_size)
+            ++m_stats.num_file_reads;
+        else
+            bytes_read = 0;
+    }
+
+    if (bytes_read == 0)
+    {
+        guard.unlock();
+        bytes_read = m_process.ReadMemoryFromInferior (first_line_addr,
+                                                       data.GetBytes(),
+                                                       data.GetByteSize(),
+                                                       error);
+        guard.lock();
+        ++m_stats.num_inferior_reads;
+        m_stats.inferior_bytes_read += bytes_read;
+
+        // Some remote stubs fail the whole read when the end of it isn't
+        // readable, try again with just the line we need.
+        if (bytes_read == 0)
+        {
+            if (num_lines_to_read > 1)
+                return FillL2Lines (guard, first_line_addr, cache_line_byte_size, 1, error);
+            return DataBufferSP();
+        }
+
+        // The first time we read from a file backed range we check whether
+        // the file has the same bytes.
+        if (generation == m_generation)
+        {
+            file_range = FindFileBackedRange (first_line_addr);
+            if (file_range && file_range->data == eFileBackedUnverified)
+            {
+                const size_t compare_size = std::min<size_t> (bytes_read, file_range->GetRangeEnd() - first_line_addr);
+                std::vector<uint8_t> file_bytes (compare_size);
+                if (ReadFromFile (first_line_addr, file_bytes.data(), compare_size) == compare_size &&
+                    memcmp (file_bytes.data(), data.GetBytes(), compare_size) == 0)
+                    file_range->data = eFileBackedIdentical;
+                else
+                    file_range->data = eFileBackedDifferent;
+            }
+        }
+    }
 
+    DataBufferSP first_line_sp;
+    for (size_t offset = 0; offset < bytes_read; offset += cache_line_byte_size)
+    {
+        const size_t line_size = std::min<size_t> (cache_line_byte_size, bytes_read - offset);
+        DataBufferSP line_sp (new DataBufferHeap (data.GetBytes() + offset, line_size));
+        if (!first_line_sp)
+            first_line_sp = line_sp;
+
+        // What we read while something flushed the cache may be stale,
+        // we hand it out without caching it.
+        if (generation == m_generation)
+            InsertL2Line (first_line_addr + offset, line_sp);
+    }
+    m_L2_next_sequential_addr = first_line_addr + bytes_read;
+    return first_line_sp;
+}
+
+void
+MemoryCache::Prefetch (addr_t addr, size_t size)
+{
+    if (size == 0)
+        return;
+
+    std::unique_lock<std::recursive_mutex> guard(m_mutex);
+    const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+    addr_t curr_addr = addr - (addr % cache_line_byte_size);
+    const addr_t end_addr = addr + std::min<size_t> (size, g_max_L2_readahead_lines * cache_line_byte_size);
+
+    // Only the first run of missing lines is read, a hint shouldn't cost
+    // more than one read.
+    while (curr_addr < end_addr && m_L2_cache.count (curr_addr))
+        curr_addr += cache_line_byte_size;
+    if (curr_addr >= end_addr || m_invalid_ranges.FindEntryThatContains (curr_addr))
+        return;
+
+    const uint32_t num_lines = (end_addr - curr_addr + cache_line_byte_size - 1) / cache_line_byte_size;
+    ++m_stats.num_prefetches;
+    const addr_t next_sequential_addr = m_L2_next_sequential_addr;
+    Error error;
+    FillL2Lines (guard, curr_addr, cache_line_byte_size, num_lines, error);
+    // Prefetches aren't part of the sequential reads of the caller.
+    m_L2_next_sequential_addr = next_sequential_addr;
+}
 
 size_t
 MemoryCache::Read (addr_t addr,  
@@ -164,7 +484,11 @@ MemoryCache::Read (addr_t addr,
     // m_L2_cache_line_byte_size bytes in size, so we don't try anything
     // tricky when reading from them (no partial reads from the L1 cache).
 
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    // The lock isn't held while we read from the process so that other
+    // threads can use the cache, or read from the process too, meanwhile.
+    // What we read only goes into the cache if nothing flushed the cache
+    // during the read, it could be stale otherwise.
+    std::unique_lock<std::recursive_mutex> guard(m_mutex);
     if (!m_L1_cache.empty())
     {
         AddrRange read_range(addr, dst_len);
@@ -176,6 +500,7 @@ MemoryCache::Read (addr_t addr,
         AddrRange chunk_range(pos->first, pos->second->GetByteSize());
         if (chunk_range.Contains(read_range))
         {
+            ++m_stats.num_L1_hits;
             memcpy(dst, pos->second->GetBytes() + addr - chunk_range.GetRangeBase(), dst_len);
             return dst_len;
         }
@@ -191,9 +516,14 @@ MemoryCache::Read (addr_t addr,
     // it in the cache.
     if (dst && dst_len > m_L2_cache_line_byte_size)
     {
+        const uint32_t generation = m_generation;
+        guard.unlock();
         size_t bytes_read = m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+        guard.lock();
+        ++m_stats.num_inferior_reads;
+        m_stats.inferior_bytes_read += bytes_read;
         // Add this non block sized range to the L1 cache if we actually read anything
-        if (bytes_read > 0)
+        if (bytes_read > 0 && generation == m_generation)
             AddL1CacheData(addr, dst, bytes_read);
         return bytes_read;
     }
@@ -213,68 +543,43 @@ MemoryCache::Read (addr_t addr,
                 return dst_len - bytes_left;
             }
 
-            BlockMap::const_iterator pos = m_L2_cache.find (curr_addr);
-            BlockMap::const_iterator end = m_L2_cache.end ();
-            
-            if (pos != end)
-            {
-                size_t curr_read_size = cache_line_byte_size - cache_offset;
-                if (curr_read_size > bytes_left)
-                    curr_read_size = bytes_left;
-                
-                memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes() + cache_offset, curr_read_size);
-                
-                bytes_left -= curr_read_size;
-                curr_addr += curr_read_size + cache_offset;
-                cache_offset = 0;
-                
-                if (bytes_left > 0)
-                {
-                    // Get sequential cache page hits
-                    for (++pos; (pos != end) && (bytes_left > 0); ++pos)
-                    {
-                        assert ((curr_addr % cache_line_byte_size) == 0);
-                        
-                        if (pos->first != curr_addr)
-                            break;
-                        
-                        curr_read_size = pos->second->GetByteSize();
-                        if (curr_read_size > bytes_left)
-                            curr_read_size = bytes_left;
-                        
-                        memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes(), curr_read_size);
-                        
-                        bytes_left -= curr_read_size;
-                        curr_addr += curr_read_size;
-                        
-                        // We have a cache page that succeeded to read some bytes
-                        // but not an entire page. If this happens, we must cap
-                        // off how much data we are able to read...
-                        if (pos->second->GetByteSize() != cache_line_byte_size)
-                            return dst_len - bytes_left;
-                    }
-                }
-            }
-            
-            // We need to read from the process
-            
-            if (bytes_left > 0)
+            DataBufferSP line_sp = FindL2Line (curr_addr);
+            if (line_sp)
+                ++m_stats.num_L2_hits;
+            else
             {
-                assert ((curr_addr % cache_line_byte_size) == 0);
-                std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (cache_line_byte_size, 0));
-                size_t process_bytes_read = m_process.ReadMemoryFromInferior (curr_addr, 
-                                                                              data_buffer_heap_ap->GetBytes(), 
-                                                                              data_buffer_heap_ap->GetByteSize(), 
-                                                                              error);
-                if (process_bytes_read == 0)
+                // We need to read from the process. Read all the lines the
+                // request needs at once, and when the misses keep following
+                // each other read more lines ahead each time.
+                ++m_stats.num_misses;
+                if (curr_addr == m_L2_next_sequential_addr)
+                    m_L2_readahead_lines = std::min (m_L2_readahead_lines * 2, g_max_L2_readahead_lines);
+                else
+                    m_L2_readahead_lines = 1;
+                const uint32_t num_lines_needed = (cache_offset + bytes_left + cache_line_byte_size - 1) / cache_line_byte_size;
+                line_sp = FillL2Lines (guard,
+                                       curr_addr,
+                                       cache_line_byte_size,
+                                       std::max (num_lines_needed, m_L2_readahead_lines),
+                                       error);
+                if (!line_sp)
                     return dst_len - bytes_left;
-                
-                if (process_bytes_read != cache_line_byte_size)
-                    data_buffer_heap_ap->SetByteSize (process_bytes_read);
-                m_L2_cache[curr_addr] = DataBufferSP (data_buffer_heap_ap.release());
-                // We have read data and put it into the cache, continue through the
-                // loop again to get the data out of the cache...
             }
+
+            size_t curr_read_size = line_sp->GetByteSize() > cache_offset ? line_sp->GetByteSize() - cache_offset : 0;
+            if (curr_read_size > bytes_left)
+                curr_read_size = bytes_left;
+            memcpy (dst_buf + dst_len - bytes_left, line_sp->GetBytes() + cache_offset, curr_read_size);
+            bytes_left -= curr_read_size;
+
+            // We have a cache line that succeeded to read some bytes
+            // but not an entire line. If this happens, we must cap
+            // off how much data we are able to read...
+            if (line_sp->GetByteSize() != cache_line_byte_size)
+                return dst_len - bytes_left;
+
+            curr_addr += cache_line_byte_size;
+            cache_offset = 0;
         }
     }
     
@@ -436,7 +741,22 @@ AllocatedBlock::FreeBlock (addr_t addr)
     return success;
 }
 
-AllocatedMemoryCache::AllocatedMemoryCache(Process &process) : m_process(process), m_mutex(), m_memory_map()
+uint32_t
+AllocatedBlock::GetBytesInUse () const
+{
+    uint32_t num_chunks = 0;
+    for (const auto &pos : m_offset_to_chunk_size)
+        num_chunks += pos.second;
+    return num_chunks * m_chunk_size;
+}
+
+AllocatedMemoryCache::AllocatedMemoryCache(Process &process) :
+    m_process(process),
+    m_mutex(),
+    m_memory_map(),
+    m_num_allocations(0),
+    m_num_deallocations(0),
+    m_num_process_allocations(0)
 {
 }
 
@@ -467,10 +787,22 @@ AllocatedMemoryCache::AllocatePage (uint32_t byte_size,
 {
     AllocatedBlockSP block_sp;
     const size_t page_size = 4096;
-    const size_t num_pages = (byte_size + page_size - 1) / page_size;
-    const size_t page_byte_size = num_pages * page_size;
+    // Every block costs a call into the process (often a function call
+    // that runs mmap), and the blocks are kept until the process goes
+    // away, so allocate in large blocks that many expressions can share.
+    const size_t min_block_size = 64 * 1024;
+    size_t num_pages = (std::max<size_t>(byte_size, min_block_size) + page_size - 1) / page_size;
+    size_t page_byte_size = num_pages * page_size;
 
     addr_t addr = m_process.DoAllocateMemory(page_byte_size, permissions, error);
+    if (addr == LLDB_INVALID_ADDRESS && byte_size < min_block_size)
+    {
+        // Fall back to just the pages needed.
+        num_pages = (byte_size + page_size - 1) / page_size;
+        page_byte_size = num_pages * page_size;
+        error.Clear();
+        addr = m_process.DoAllocateMemory(page_byte_size, permissions, error);
+    }
 
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
     if (log)
@@ -483,6 +815,7 @@ AllocatedMemoryCache::AllocatePage (uint32_t byte_size,
 
     if (addr != LLDB_INVALID_ADDRESS)
     {
+        ++m_num_process_allocations;
         block_sp.reset (new AllocatedBlock (addr, page_byte_size, permissions, chunk_size));
         m_memory_map.insert (std::make_pair (permissions, block_sp));
     }
@@ -496,6 +829,7 @@ AllocatedMemoryCache::AllocateMemory (size_t byte_size,
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
+    ++m_num_allocations;
     addr_t addr = LLDB_INVALID_ADDRESS;
     std::pair<PermissionsToBlockMap::iterator, PermissionsToBlockMap::iterator> range = m_memory_map.equal_range (permissions);
 
@@ -524,6 +858,7 @@ AllocatedMemoryCache::DeallocateMemory (lldb::addr_t addr)
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
+    ++m_num_deallocations;
     PermissionsToBlockMap::iterator pos, end = m_memory_map.end();
     bool success = false;
     for (pos = m_memory_map.begin(); pos != end; ++pos)
@@ -540,4 +875,27 @@ AllocatedMemoryCache::DeallocateMemory (lldb::addr_t addr)
     return success;
 }
 
+AllocatedMemoryCache::Statistics
+AllocatedMemoryCache::GetStatistics ()
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
+    Statistics stats;
+    stats.num_allocations = m_num_allocations;
+    stats.num_deallocations = m_num_deallocations;
+    stats.num_process_allocations = m_num_process_allocations;
+    stats.bytes_reserved = 0;
+    stats.bytes_in_use = 0;
+    for (const auto &pos : m_memory_map)
+    {
+        BlockStatistics block;
+        block.addr = pos.second->GetBaseAddress();
+        block.byte_size = pos.second->GetByteSize();
+        block.bytes_in_use = pos.second->GetBytesInUse();
+        block.permissions = pos.second->GetPermissions();
+        stats.bytes_reserved += block.byte_size;
+        stats.bytes_in_use += block.bytes_in_use;
+        stats.blocks.push_back(block);
+    }
+    return stats;
+}
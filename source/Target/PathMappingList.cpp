@@ -9,6 +9,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <climits>
 #include <cstring>
 
@@ -29,7 +30,12 @@ PathMappingList::PathMappingList () :
     m_pairs(),
     m_callback(nullptr),
     m_callback_baton(nullptr),
-    m_mod_id(0)
+    m_mod_id(0),
+    m_index_mutex(),
+    m_prefix_trie(),
+    m_remapped_paths(),
+    m_index_mod_id(0),
+    m_index_valid(false)
 {
 }
 
@@ -38,7 +44,12 @@ PathMappingList::PathMappingList (ChangedCallback callback,
     m_pairs (),
     m_callback (callback),
     m_callback_baton (callback_baton),
-    m_mod_id (0)
+    m_mod_id (0),
+    m_index_mutex (),
+    m_prefix_trie (),
+    m_remapped_paths (),
+    m_index_mod_id (0),
+    m_index_valid (false)
 {
 }
 
@@ -46,7 +57,12 @@ PathMappingList::PathMappingList (const PathMappingList &rhs) :
     m_pairs(rhs.m_pairs),
     m_callback(nullptr),
     m_callback_baton(nullptr),
-    m_mod_id(0)
+    m_mod_id(0),
+    m_index_mutex(),
+    m_prefix_trie(),
+    m_remapped_paths(),
+    m_index_mod_id(0),
+    m_index_valid(false)
 {
 }
 
@@ -59,6 +75,10 @@ PathMappingList::operator =(const PathMappingList &rhs)
         m_callback = nullptr;
         m_callback_baton = nullptr;
         m_mod_id = rhs.m_mod_id;
+        // The mod ID came with the pairs, it doesn't say that our index is
+        // still good.
+        std::lock_guard<std::mutex> guard(m_index_mutex);
+        m_index_valid = false;
     }
     return *this;
 }
@@ -169,28 +189,105 @@ PathMappingList::Clear (bool notify)
         m_callback (*this, m_callback_baton);
 }
 
+void
+PathMappingList::UpdateIndex () const
+{
+    if (m_index_valid && m_index_mod_id == m_mod_id)
+        return;
+
+    m_remapped_paths.clear();
+    m_prefix_trie.clear();
+    m_prefix_trie.push_back(PrefixNode());
+    m_prefix_trie.back().pair_idx = UINT32_MAX;
+    const uint32_t num_pairs = m_pairs.size();
+    for (uint32_t pair_idx = 0; pair_idx < num_pairs; ++pair_idx)
+    {
+        uint32_t node_idx = 0;
+        const char *prefix = m_pairs[pair_idx].first.GetCString();
+        for (const char *p = prefix ? prefix : ""; *p; ++p)
+        {
+            uint32_t child_idx = UINT32_MAX;
+            for (const auto &child : m_prefix_trie[node_idx].children)
+            {
+                if (child.first == *p)
+                {
+                    child_idx = child.second;
+                    break;
+                }
+            }
+            if (child_idx == UINT32_MAX)
+            {
+                child_idx = m_prefix_trie.size();
+                m_prefix_trie[node_idx].children.push_back(std::make_pair(*p, child_idx));
+                m_prefix_trie.push_back(PrefixNode());
+                m_prefix_trie.back().pair_idx = UINT32_MAX;
+            }
+            node_idx = child_idx;
+        }
+        // The first pair with a prefix wins, like a walk over m_pairs.
+        if (m_prefix_trie[node_idx].pair_idx == UINT32_MAX)
+            m_prefix_trie[node_idx].pair_idx = pair_idx;
+    }
+    m_index_mod_id = m_mod_id;
+    m_index_valid = true;
+}
+
+void
+PathMappingList::FindPairIndexesForPath (const char *path, std::vector<uint32_t> &pair_indexes) const
+{
+    pair_indexes.clear();
+    uint32_t node_idx = 0;
+    for (const char *p = path;; ++p)
+    {
+        const PrefixNode &node = m_prefix_trie[node_idx];
+        if (node.pair_idx != UINT32_MAX)
+            pair_indexes.push_back(node.pair_idx);
+        if (*p == '\0')
+            break;
+        node_idx = UINT32_MAX;
+        for (const auto &child : node.children)
+        {
+            if (child.first == *p)
+            {
+                node_idx = child.second;
+                break;
+            }
+        }
+        if (node_idx == UINT32_MAX)
+            break;
+    }
+    std::sort(pair_indexes.begin(), pair_indexes.end());
+}
+
 bool
 PathMappingList::RemapPath (const ConstString &path, ConstString &new_path) const
 {
     const char *path_cstr = path.GetCString();
     
-    if (!path_cstr)
+    if (!path_cstr || m_pairs.empty())
         return false;
-    
-    const_iterator pos, end = m_pairs.end();
-    for (pos = m_pairs.begin(); pos != end; ++pos)
-    {
-        const size_t prefixLen = pos->first.GetLength();
 
-        if (::strncmp (pos->first.GetCString(), path_cstr, prefixLen) == 0)
+    std::lock_guard<std::mutex> guard(m_index_mutex);
+    UpdateIndex();
+    auto pos = m_remapped_paths.find(path_cstr);
+    if (pos == m_remapped_paths.end())
+    {
+        ConstString remapped_path;
+        std::vector<uint32_t> pair_indexes;
+        FindPairIndexesForPath(path_cstr, pair_indexes);
+        if (!pair_indexes.empty())
         {
-            std::string new_path_str (pos->second.GetCString());
-            new_path_str.append(path.GetCString() + prefixLen);
-            new_path.SetCString(new_path_str.c_str());
-            return true;
+            const pair &match = m_pairs[pair_indexes.front()];
+            std::string new_path_str (match.second.GetCString());
+            new_path_str.append(path_cstr + match.first.GetLength());
+            remapped_path.SetCString(new_path_str.c_str());
         }
+        pos = m_remapped_paths.insert(std::make_pair(path_cstr, remapped_path)).first;
     }
-    return false;
+    if (pos->second.IsEmpty())
+        return false;
+    new_path = pos->second;
+    return true;
 }
 
 bool
@@ -199,19 +296,19 @@ PathMappingList::RemapPath (const char *path, std::string &new_path) const
     if (m_pairs.empty() || path == nullptr || path[0] == '\0')
         return false;
 
-    const_iterator pos, end = m_pairs.end();
-    for (pos = m_pairs.begin(); pos != end; ++pos)
+    std::vector<uint32_t> pair_indexes;
     {
-        const size_t prefix_len = pos->first.GetLength();
-        
-        if (::strncmp (pos->first.GetCString(), path, prefix_len) == 0)
-        {
-            new_path = pos->second.GetCString();
-            new_path.append(path + prefix_len);
-            return true;
-        }
+        std::lock_guard<std::mutex> guard(m_index_mutex);
+        UpdateIndex();
+        FindPairIndexesForPath(path, pair_indexes);
     }
-    return false;
+    if (pair_indexes.empty())
+        return false;
+
+    const pair &match = m_pairs[pair_indexes.front()];
+    new_path = match.second.GetCString();
+    new_path.append(path + match.first.GetLength());
+    return true;
 }
 
 bool
@@ -245,23 +342,24 @@ PathMappingList::FindFile (const FileSpec &orig_spec, FileSpec &new_spec) const
         const size_t orig_path_len = orig_spec.GetPath (orig_path, sizeof(orig_path));
         if (orig_path_len > 0)
         {
-            const_iterator pos, end = m_pairs.end();
-            for (pos = m_pairs.begin(); pos != end; ++pos)
+            // Try every pair that matches, in order, until one of them
+            // gives a file that exists.
+            std::vector<uint32_t> pair_indexes;
+            {
+                std::lock_guard<std::mutex> guard(m_index_mutex);
+                UpdateIndex();
+                FindPairIndexesForPath(orig_path, pair_indexes);
+            }
+            for (uint32_t pair_idx : pair_indexes)
             {
-                const size_t prefix_len = pos->first.GetLength();
-                
-                if (orig_path_len >= prefix_len)
+                const pair &match = m_pairs[pair_idx];
+                const size_t prefix_len = match.first.GetLength();
+                const size_t new_path_len = snprintf(new_path, sizeof(new_path), "%s/%s", match.second.GetCString(), orig_path + prefix_len);
+                if (new_path_len < sizeof(new_path))
                 {
-                    if (::strncmp (pos->first.GetCString(), orig_path, prefix_len) == 0)
-                    {
-                        const size_t new_path_len = snprintf(new_path, sizeof(new_path), "%s/%s", pos->second.GetCString(), orig_path + prefix_len);
-                        if (new_path_len < sizeof(new_path))
-                        {
-                            new_spec.SetFile (new_path, true);
-                            if (new_spec.Exists())
-                                return true;
-                        }
-                    }
+                    new_spec.SetFile (new_path, true);
+                    if (new_spec.Exists())
+                        return true;
                 }
             }
         }
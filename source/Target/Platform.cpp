@@ -75,13 +75,23 @@ namespace {
     {
         { "use-module-cache"      , OptionValue::eTypeBoolean , true,  true, nullptr, nullptr, "Use module cache." },
         { "module-cache-directory", OptionValue::eTypeFileSpec, true,  0 ,   nullptr, nullptr, "Root directory for cached modules." },
+        { "lazy-symbol-demangling", OptionValue::eTypeBoolean , true,  false, nullptr, nullptr, "Only demangle C++ symbol names when a lookup needs them instead of when the symbol table is indexed." },
+        { "use-demangled-name-cache", OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "Store the demangled symbol names of each module in the module cache directory and reuse them for modules with the same UUID." },
+        { "use-decompressed-section-cache", OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "Store the decompressed contents of compressed debug info sections in the module cache directory and memory map them for modules with the same UUID." },
+        { "use-symbol-table-cache", OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "Store the parsed symbol table of each module in the module cache directory and memory map it for modules with the same UUID, so concurrent debug sessions share one copy instead of each parsing the symbols again." },
+        { "use-objc-class-cache", OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "Store the Objective-C classes found in each dyld shared cache in the module cache directory and reuse them for processes that use a shared cache with the same UUID." },
         {  nullptr                , OptionValue::eTypeInvalid , false, 0,    nullptr, nullptr, nullptr }
     };
 
     enum
     {
         ePropertyUseModuleCache,
-        ePropertyModuleCacheDirectory
+        ePropertyModuleCacheDirectory,
+        ePropertyLazySymbolDemangling,
+        ePropertyUseDemangledNameCache,
+        ePropertyUseDecompressedSectionCache,
+        ePropertyUseSymbolTableCache,
+        ePropertyUseObjCClassCache
     };
 
 }  // namespace
@@ -139,6 +149,46 @@ PlatformProperties::SetModuleCacheDirectory (const FileSpec& dir_spec)
     return m_collection_sp->SetPropertyAtIndexAsFileSpec (nullptr, ePropertyModuleCacheDirectory, dir_spec);
 }
 
+bool
+PlatformProperties::GetLazySymbolDemangling () const
+{
+    const auto idx = ePropertyLazySymbolDemangling;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+PlatformProperties::GetUseDemangledNameCache () const
+{
+    const auto idx = ePropertyUseDemangledNameCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+PlatformProperties::GetUseDecompressedSectionCache () const
+{
+    const auto idx = ePropertyUseDecompressedSectionCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+PlatformProperties::GetUseSymbolTableCache () const
+{
+    const auto idx = ePropertyUseSymbolTableCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+PlatformProperties::GetUseObjCClassCache () const
+{
+    const auto idx = ePropertyUseObjCClassCache;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean (
+        nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 //------------------------------------------------------------------
 /// Get the native host platform plug-in. 
 ///
@@ -1441,6 +1491,19 @@ Platform::PutFile (const FileSpec& source,
 
     if (!source_file.IsValid())
         return Error("PutFile: unable to open source file");
+
+    // Don't send files the destination already has, like the same inferior
+    // that is installed again for every run.
+    uint64_t src_low = 0, src_high = 0, dst_low = 0, dst_high = 0;
+    if (FileSystem::CalculateMD5(source, src_low, src_high) &&
+        CalculateMD5(destination, dst_low, dst_high) &&
+        src_low == dst_low && src_high == dst_high)
+    {
+        if (log)
+            log->Printf("[PutFile] %s is up to date, skipping the transfer\n", destination.GetPath().c_str());
+        return error;
+    }
+
     lldb::user_id_t dest_file = OpenFile (destination,
                                           File::eOpenOptionCanCreate |
                                           File::eOpenOptionWrite |
@@ -1455,7 +1518,8 @@ Platform::PutFile (const FileSpec& source,
         return error;
     if (dest_file == UINT64_MAX)
         return Error("unable to open target file");
-    lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024, 0));
+    // Big blocks let the remote side pipeline the transfer.
+    lldb::DataBufferSP buffer_sp(new DataBufferHeap(1024 * 1024, 0));
     uint64_t offset = 0;
     for (;;)
     {
@@ -1889,7 +1953,7 @@ Platform::DownloadModuleSlice (const FileSpec& src_file_spec,
        return error;
    }
 
-    std::vector<char> buffer (1024);
+    std::vector<char> buffer (1024 * 1024);
     auto offset = src_offset;
     uint64_t total_bytes_read = 0;
     while (total_bytes_read < src_size)
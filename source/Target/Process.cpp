@@ -9,6 +9,7 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
 #include <atomic>
 #include <mutex>
 
@@ -23,12 +24,15 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/PluginManager.h"
+#include "lldb/Core/SourceManager.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/StreamFile.h"
+#include "lldb/Core/Timer.h"
 #include "lldb/Expression/DiagnosticManager.h"
 #include "lldb/Expression/IRDynamicChecks.h"
 #include "lldb/Expression/UserExpression.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/FileSystem.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/HostInfo.h"
@@ -38,10 +42,12 @@
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/OptionValueProperties.h"
 #include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Target/ABI.h"
 #include "lldb/Target/CPPLanguageRuntime.h"
 #include "lldb/Target/DynamicLoader.h"
+#include "lldb/Target/FastTracepoint.h"
 #include "lldb/Target/InstrumentationRuntime.h"
 #include "lldb/Target/JITLoader.h"
 #include "lldb/Target/JITLoaderList.h"
@@ -53,6 +59,7 @@
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/StopInfo.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Target.h"
@@ -61,7 +68,10 @@
 #include "lldb/Target/ThreadPlan.h"
 #include "lldb/Target/ThreadPlanBase.h"
 #include "lldb/Target/UnixSignals.h"
+#include "lldb/Utility/MemorySearch.h"
 #include "lldb/Utility/NameMatches.h"
+#include "lldb/Utility/TaskPool.h"
+#include "lldb/Utility/TriageRecord.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -125,6 +135,7 @@ g_properties[] =
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, nullptr, nullptr, "If true, detach will attempt to keep the process stopped." },
     { "memory-cache-line-size" , OptionValue::eTypeUInt64, false, 512, nullptr, nullptr, "The memory cache line size" },
     { "optimization-warnings" , OptionValue::eTypeBoolean, false, true, nullptr, nullptr, "If true, warn when stopped in code that is optimized where stepping and variable availability may not behave as expected." },
+    { "displaced-stepping" , OptionValue::eTypeBoolean, false, true, nullptr, nullptr, "If true, step over breakpoints by executing a copy of the instruction out of line when possible, so the other threads can keep running with the breakpoint inserted." },
     {  nullptr                  , OptionValue::eTypeInvalid, false, 0, nullptr, nullptr, nullptr  }
 };
 
@@ -137,7 +148,8 @@ enum {
     ePropertyStopOnSharedLibraryEvents,
     ePropertyDetachKeepsStopped,
     ePropertyMemCacheLineSize,
-    ePropertyWarningOptimization
+    ePropertyWarningOptimization,
+    ePropertyDisplacedStepping
 };
 
 ProcessProperties::ProcessProperties (lldb_private::Process *process) :
@@ -278,6 +290,13 @@ ProcessProperties::GetWarningsOptimization () const
     return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool
+ProcessProperties::GetDisplacedStepping () const
+{
+    const uint32_t idx = ePropertyDisplacedStepping;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 void
 ProcessInstanceInfo::Dump (Stream &s, Platform *platform) const
 {
@@ -742,8 +761,20 @@ Process::Process(lldb::TargetSP target_sp, ListenerSP listener_sp, const UnixSig
       m_queue_list_stop_id(0),
       m_notifications(),
       m_image_tokens(),
+      m_fast_tracepoints(),
+      m_next_fast_tracepoint_id(1),
+      m_expression_helper_library_attempted(false),
       m_listener_sp(listener_sp),
       m_breakpoint_site_list(),
+      m_bp_site_batch_mutex(),
+      m_bp_site_batch_thread(),
+      m_bp_site_batch_depth(0),
+      m_bp_sites_to_enable(),
+      m_bp_sites_to_disable(),
+      m_displaced_step_tid(LLDB_INVALID_THREAD_ID),
+      m_displaced_step_pc(LLDB_INVALID_ADDRESS),
+      m_displaced_step_scratch_addr(LLDB_INVALID_ADDRESS),
+      m_displaced_step_saved_bytes(),
       m_dynamic_checkers_ap(),
       m_unix_signals_sp(unix_signals_sp),
       m_abi_sp(),
@@ -886,8 +917,12 @@ Process::Finalize()
     std::vector<Notifications> empty_notifications;
     m_notifications.swap(empty_notifications);
     m_image_tokens.clear();
+    m_fast_tracepoints.clear();
+    m_expression_helper_library_attempted = false;
     m_memory_cache.Clear();
     m_allocated_memory_cache.Clear();
+    // A helper library has to be loaded into the new image again.
+    m_expression_helper_library_attempted = false;
     m_language_runtimes.clear();
     m_instrumentation_runtimes.clear();
     m_next_event_action_ap.reset();
@@ -2069,11 +2104,20 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
         {
             bp_site_sp->AddOwner (owner);
             owner->SetBreakpointSite (bp_site_sp);
+            BreakpointSiteConditionsChanged (bp_site_sp.get());
             return bp_site_sp->GetID();
         }
         else
         {
             bp_site_sp.reset (new BreakpointSite (&m_breakpoint_site_list, owner, load_addr, use_hardware));
+            if (bp_site_sp && IsBatchingBreakpointSites ())
+            {
+                // The site is enabled when the batch is flushed, and removed
+                // again if that fails.
+                m_bp_sites_to_enable.push_back (bp_site_sp);
+                owner->SetBreakpointSite (bp_site_sp);
+                return m_breakpoint_site_list.Add (bp_site_sp);
+            }
             if (bp_site_sp)
             {
                 Error error = EnableBreakpointSite (bp_site_sp.get());
@@ -2107,38 +2151,261 @@ Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_
     uint32_t num_owners = bp_site_sp->RemoveOwner (owner_id, owner_loc_id);
     if (num_owners == 0)
     {
+        if (IsBatchingBreakpointSites ())
+        {
+            // A site that was created in this batch was never enabled.
+            auto pos = std::find (m_bp_sites_to_enable.begin(), m_bp_sites_to_enable.end(), bp_site_sp);
+            if (pos != m_bp_sites_to_enable.end())
+                m_bp_sites_to_enable.erase (pos);
+            else
+                m_bp_sites_to_disable.push_back (bp_site_sp);
+        }
         // Don't try to disable the site if we don't have a live process anymore.
-        if (IsAlive())
+        else if (IsAlive())
             DisableBreakpointSite (bp_site_sp.get());
         m_breakpoint_site_list.RemoveByAddress(bp_site_sp->GetLoadAddress());
     }
+    else if (IsAlive())
+        BreakpointSiteConditionsChanged (bp_site_sp.get());
+}
+
+void
+Process::EnableBreakpointSites (const std::vector<BreakpointSiteSP> &bp_sites, std::vector<Error> &errors)
+{
+    errors.clear();
+    errors.reserve (bp_sites.size());
+    for (const BreakpointSiteSP &bp_site_sp : bp_sites)
+        errors.push_back (EnableBreakpointSite (bp_site_sp.get()));
+}
+
+void
+Process::DisableBreakpointSites (const std::vector<BreakpointSiteSP> &bp_sites)
+{
+    for (const BreakpointSiteSP &bp_site_sp : bp_sites)
+    {
+        if (bp_site_sp->IsEnabled())
+            DisableBreakpointSite (bp_site_sp.get());
+    }
+}
+
+bool
+Process::IsBatchingBreakpointSites ()
+{
+    std::lock_guard<std::mutex> guard(m_bp_site_batch_mutex);
+    return m_bp_site_batch_depth > 0 && m_bp_site_batch_thread == std::this_thread::get_id();
+}
+
+Process::BreakpointSiteBatch::BreakpointSiteBatch (const ProcessSP &process_sp) :
+    m_process_sp ()
+{
+    if (!process_sp)
+        return;
+
+    // Only one thread batches at a time, sites that other threads add or
+    // remove in the meantime are handled right away.
+    std::lock_guard<std::mutex> guard(process_sp->m_bp_site_batch_mutex);
+    if (process_sp->m_bp_site_batch_depth == 0)
+        process_sp->m_bp_site_batch_thread = std::this_thread::get_id();
+    else if (process_sp->m_bp_site_batch_thread != std::this_thread::get_id())
+        return;
+    ++process_sp->m_bp_site_batch_depth;
+    m_process_sp = process_sp;
+}
+
+Process::BreakpointSiteBatch::~BreakpointSiteBatch ()
+{
+    if (!m_process_sp)
+        return;
+
+    std::vector<BreakpointSiteSP> to_enable;
+    std::vector<BreakpointSiteSP> to_disable;
+    {
+        std::lock_guard<std::mutex> guard(m_process_sp->m_bp_site_batch_mutex);
+        if (--m_process_sp->m_bp_site_batch_depth > 0)
+            return;
+        to_enable.swap (m_process_sp->m_bp_sites_to_enable);
+        to_disable.swap (m_process_sp->m_bp_sites_to_disable);
+    }
+
+    const bool is_alive = m_process_sp->IsAlive();
+    if (is_alive && !to_disable.empty())
+        m_process_sp->DisableBreakpointSites (to_disable);
+
+    if (to_enable.empty())
+        return;
+
+    std::vector<Error> errors;
+    m_process_sp->EnableBreakpointSites (to_enable, errors);
+    for (size_t i = 0; i < to_enable.size(); ++i)
+    {
+        if (i < errors.size() && errors[i].Success())
+            continue;
+
+        BreakpointSiteSP bp_site_sp (to_enable[i]);
+        const size_t num_owners = bp_site_sp->GetNumberOfOwners();
+        if (num_owners == 0)
+            continue;
+
+        if (is_alive)
+        {
+            BreakpointLocationSP owner (bp_site_sp->GetOwnerAtIndex (0));
+            const char *error_cstr = i < errors.size() ? errors[i].AsCString() : nullptr;
+            m_process_sp->GetTarget().GetDebugger().GetErrorFile()->Printf ("warning: failed to set breakpoint site at 0x%" PRIx64 " for breakpoint %i.%i: %s\n",
+                                                                            bp_site_sp->GetLoadAddress(),
+                                                                            owner->GetBreakpoint().GetID(),
+                                                                            owner->GetID(),
+                                                                            error_cstr ? error_cstr : "unknown error");
+        }
+
+        // Unresolve the owners, like CreateBreakpointSite does when the
+        // site can't be enabled. The last one removes the site.
+        std::vector<BreakpointLocationSP> owners;
+        for (size_t j = 0; j < num_owners; ++j)
+            owners.push_back (bp_site_sp->GetOwnerAtIndex (j));
+        for (BreakpointLocationSP &owner : owners)
+            owner->ClearBreakpointSite();
+    }
+}
+
+addr_t
+Process::GetDisplacedStepScratchAddress (size_t size)
+{
+    ModuleSP exe_module_sp (GetTarget().GetExecutableModule());
+    ObjectFile *obj_file = exe_module_sp ? exe_module_sp->GetObjectFile() : nullptr;
+    if (obj_file == nullptr)
+        return LLDB_INVALID_ADDRESS;
+
+    const addr_t scratch_addr = obj_file->GetEntryPointAddress().GetOpcodeLoadAddress(&GetTarget());
+    if (scratch_addr == LLDB_INVALID_ADDRESS)
+        return LLDB_INVALID_ADDRESS;
+
+    // Don't overwrite a breakpoint someone placed on the entry point.
+    BreakpointSiteList bp_sites;
+    if (m_breakpoint_site_list.FindInRange(scratch_addr, scratch_addr + size, bp_sites))
+        return LLDB_INVALID_ADDRESS;
+    return scratch_addr;
+}
+
+bool
+Process::ReserveDisplacedStep (lldb::tid_t tid, size_t size)
+{
+    if (!GetDisplacedStepping())
+        return false;
+    if (m_displaced_step_tid != LLDB_INVALID_THREAD_ID && m_displaced_step_tid != tid)
+        return false;
+    if (GetDisplacedStepScratchAddress(size) == LLDB_INVALID_ADDRESS)
+        return false;
+    m_displaced_step_tid = tid;
+    return true;
+}
+
+void
+Process::ReleaseDisplacedStep (lldb::tid_t tid)
+{
+    if (m_displaced_step_tid != tid)
+        return;
+    FinishDisplacedStep();
+    m_displaced_step_tid = LLDB_INVALID_THREAD_ID;
+}
+
+Error
+Process::BeginDisplacedStep (Thread &thread, addr_t pc, const std::vector<uint8_t> &opcode)
+{
+    Error error;
+    if (m_displaced_step_tid != thread.GetID() || m_displaced_step_pc != LLDB_INVALID_ADDRESS)
+    {
+        error.SetErrorString("the displaced stepping scratch area is not available");
+        return error;
+    }
+
+    const addr_t scratch_addr = GetDisplacedStepScratchAddress(opcode.size());
+    RegisterContextSP reg_ctx_sp (thread.GetRegisterContext());
+    if (scratch_addr == LLDB_INVALID_ADDRESS || !reg_ctx_sp)
+    {
+        error.SetErrorString("no displaced stepping scratch area");
+        return error;
+    }
+
+    std::vector<uint8_t> saved_bytes(opcode.size());
+    if (ReadMemory(scratch_addr, saved_bytes.data(), saved_bytes.size(), error) != saved_bytes.size())
+        return error;
+    if (WriteMemory(scratch_addr, opcode.data(), opcode.size(), error) != opcode.size())
+        return error;
+    if (!reg_ctx_sp->SetPC(scratch_addr))
+    {
+        WriteMemory(scratch_addr, saved_bytes.data(), saved_bytes.size(), error);
+        error.SetErrorString("failed to set the pc");
+        return error;
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    if (log)
+        log->Printf("Process::%s tid 0x%" PRIx64 " stepping the instruction at 0x%" PRIx64 " at 0x%" PRIx64,
+                    __FUNCTION__, thread.GetID(), pc, scratch_addr);
+
+    m_displaced_step_pc = pc;
+    m_displaced_step_scratch_addr = scratch_addr;
+    m_displaced_step_saved_bytes.swap(saved_bytes);
+    return error;
+}
+
+void
+Process::FinishDisplacedStep ()
+{
+    if (m_displaced_step_pc == LLDB_INVALID_ADDRESS)
+        return;
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    const addr_t scratch_addr = m_displaced_step_scratch_addr;
+    const size_t size = m_displaced_step_saved_bytes.size();
+
+    // The thread either executed the copy, or stopped for something else
+    // before it got to run it.
+    ThreadSP thread_sp (m_thread_list.FindThreadByID(m_displaced_step_tid, false));
+    RegisterContextSP reg_ctx_sp (thread_sp ? thread_sp->GetRegisterContext() : RegisterContextSP());
+    if (reg_ctx_sp)
+    {
+        const addr_t thread_pc = reg_ctx_sp->GetPC();
+        if (thread_pc >= scratch_addr && thread_pc <= scratch_addr + size)
+            reg_ctx_sp->SetPC(m_displaced_step_pc + (thread_pc - scratch_addr));
+        else if (log)
+            log->Printf("Process::%s tid 0x%" PRIx64 " left the scratch area, pc = 0x%" PRIx64,
+                        __FUNCTION__, m_displaced_step_tid, thread_pc);
+    }
+
+    Error error;
+    if (WriteMemory(scratch_addr, m_displaced_step_saved_bytes.data(), size, error) != size && log)
+        log->Printf("Process::%s failed to restore the scratch area at 0x%" PRIx64 ": %s",
+                    __FUNCTION__, scratch_addr, error.AsCString());
+
+    m_displaced_step_pc = LLDB_INVALID_ADDRESS;
+    m_displaced_step_scratch_addr = LLDB_INVALID_ADDRESS;
+    m_displaced_step_saved_bytes.clear();
 }
 
 size_t
 Process::RemoveBreakpointOpcodesFromBuffer (addr_t bp_addr, size_t size, uint8_t *buf) const
 {
     size_t bytes_removed = 0;
-    BreakpointSiteList bp_sites_in_range;
 
-    if (m_breakpoint_site_list.FindInRange (bp_addr, bp_addr + size, bp_sites_in_range))
-    {
-        bp_sites_in_range.ForEach([bp_addr, size, buf, &bytes_removed](BreakpointSite *bp_site) -> void {
-            if (bp_site->GetType() == BreakpointSite::eSoftware)
+    // This runs on every memory read, so look at the sites in place rather
+    // than collecting them into another list.
+    m_breakpoint_site_list.ForEachInRange(bp_addr, bp_addr + size, [bp_addr, size, buf](const BreakpointSiteSP &bp_site) -> void {
+        if (bp_site->GetType() == BreakpointSite::eSoftware)
+        {
+            addr_t intersect_addr;
+            size_t intersect_size;
+            size_t opcode_offset;
+            if (bp_site->IntersectsRange(bp_addr, size, &intersect_addr, &intersect_size, &opcode_offset))
             {
-                addr_t intersect_addr;
-                size_t intersect_size;
-                size_t opcode_offset;
-                if (bp_site->IntersectsRange(bp_addr, size, &intersect_addr, &intersect_size, &opcode_offset))
-                {
-                    assert(bp_addr <= intersect_addr && intersect_addr < bp_addr + size);
-                    assert(bp_addr < intersect_addr + intersect_size && intersect_addr + intersect_size <= bp_addr + size);
-                    assert(opcode_offset + intersect_size <= bp_site->GetByteSize());
-                    size_t buf_offset = intersect_addr - bp_addr;
-                    ::memcpy(buf + buf_offset, bp_site->GetSavedOpcodeBytes() + opcode_offset, intersect_size);
-                }
+                assert(bp_addr <= intersect_addr && intersect_addr < bp_addr + size);
+                assert(bp_addr < intersect_addr + intersect_size && intersect_addr + intersect_size <= bp_addr + size);
+                assert(opcode_offset + intersect_size <= bp_site->GetByteSize());
+                size_t buf_offset = intersect_addr - bp_addr;
+                ::memcpy(buf + buf_offset, bp_site->GetSavedOpcodeBytes() + opcode_offset, intersect_size);
             }
-        });
-    }
+        }
+    });
     return bytes_removed;
 }
 
@@ -2495,6 +2762,13 @@ Process::ReadCStringFromMemory (addr_t addr, char *dst, size_t dst_max_len, Erro
     return total_cstr_len;
 }
 
+void
+Process::PrefetchMemory (addr_t addr, size_t size)
+{
+    if (!GetDisableMemoryCache())
+        m_memory_cache.Prefetch (addr, size);
+}
+
 size_t
 Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &error)
 {
@@ -2523,6 +2797,139 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+lldb::addr_t
+Process::FindInMemory (lldb::addr_t low, lldb::addr_t high, const uint8_t *pattern, size_t pattern_size)
+{
+    // The chunks are read around the memory cache, a search would only
+    // evict what is in it.
+    auto read_memory = [this](lldb::addr_t addr, void *buf, size_t size) -> size_t {
+        Error error;
+        return ReadMemoryFromInferior (addr, buf, size, error);
+    };
+    auto region_info = [this](lldb::addr_t addr, lldb::addr_t &region_end, bool &readable) -> bool {
+        MemoryRegionInfo info;
+        if (GetMemoryRegionInfo (addr, info).Fail())
+            return false;
+        region_end = info.GetRange().GetRangeEnd();
+        readable = info.GetReadable() != MemoryRegionInfo::eNo;
+        return true;
+    };
+    return MemorySearch::Find (low, high, pattern, pattern_size, read_memory, region_info);
+}
+
+Error
+Process::FindReferences (lldb::addr_t value, size_t max_matches, std::vector<lldb::addr_t> &matches)
+{
+    matches.clear();
+
+    const uint32_t pointer_size = GetAddressByteSize();
+    const ByteOrder byte_order = GetByteOrder();
+    auto read_memory = [this](lldb::addr_t addr, void *buf, size_t size) -> size_t {
+        Error error;
+        return ReadMemoryFromInferior (addr, buf, size, error);
+    };
+
+    lldb::addr_t addr = 0;
+    while (matches.size() < max_matches)
+    {
+        MemoryRegionInfo info;
+        Error error = GetMemoryRegionInfo (addr, info);
+        if (error.Fail())
+        {
+            // Without any region information we don't know what to scan
+            if (addr == 0)
+                return error;
+            break;
+        }
+
+        const lldb::addr_t region_end = info.GetRange().GetRangeEnd();
+        if (region_end <= addr)
+            break;
+        if (info.GetReadable() == MemoryRegionInfo::eYes && info.GetWritable() == MemoryRegionInfo::eYes)
+        {
+            MemorySearch::FindPointers (std::max (addr, info.GetRange().GetRangeBase()), region_end, value,
+                                        pointer_size, byte_order, read_memory, max_matches, matches);
+        }
+        addr = region_end;
+    }
+    return Error();
+}
+
+void
+Process::DescribeMemoryLocations (const std::vector<lldb::addr_t> &addrs, std::vector<std::string> &descriptions)
+{
+    descriptions.clear();
+    descriptions.resize (addrs.size());
+
+    // The stack memory of a frame goes from the CFA of the frame it called,
+    // or the stack pointer for the innermost frame, up to its own CFA.
+    struct FrameRange
+    {
+        lldb::addr_t low;
+        lldb::addr_t high;
+        lldb::ThreadSP thread_sp;
+        uint32_t frame_idx;
+    };
+    std::vector<FrameRange> frame_ranges;
+    bool frame_ranges_computed = false;
+    const uint32_t max_frames = 512;
+
+    Target &target = GetTarget();
+    for (size_t i = 0; i < addrs.size(); ++i)
+    {
+        StreamString strm;
+        Address so_addr;
+        if (target.GetSectionLoadList().ResolveLoadAddress (addrs[i], so_addr) && so_addr.GetModule())
+        {
+            so_addr.Dump (&strm, this, Address::DumpStyleResolvedDescription, Address::DumpStyleModuleWithFileAddress);
+            descriptions[i] = strm.GetString();
+            continue;
+        }
+
+        if (!frame_ranges_computed)
+        {
+            frame_ranges_computed = true;
+            for (ThreadSP thread_sp : Threads())
+            {
+                RegisterContextSP reg_ctx_sp (thread_sp->GetRegisterContext());
+                if (!reg_ctx_sp)
+                    continue;
+                lldb::addr_t low = reg_ctx_sp->GetSP();
+                for (uint32_t frame_idx = 0; frame_idx < max_frames; ++frame_idx)
+                {
+                    StackFrameSP frame_sp (thread_sp->GetStackFrameAtIndex (frame_idx));
+                    if (!frame_sp)
+                        break;
+                    const lldb::addr_t cfa = frame_sp->GetStackID().GetCallFrameAddress();
+                    if (cfa == LLDB_INVALID_ADDRESS || cfa <= low)
+                        continue;
+                    FrameRange range = { low, cfa, thread_sp, frame_idx };
+                    frame_ranges.push_back (range);
+                    low = cfa;
+                }
+            }
+        }
+
+        for (const FrameRange &range : frame_ranges)
+        {
+            if (range.low <= addrs[i] && addrs[i] < range.high)
+            {
+                strm.Printf ("stack of thread #%u, frame #%u", range.thread_sp->GetIndexID(), range.frame_idx);
+                StackFrameSP frame_sp (range.thread_sp->GetStackFrameAtIndex (range.frame_idx));
+                if (frame_sp)
+                {
+                    const char *func_name = frame_sp->GetSymbolContext (eSymbolContextFunction |
+                                                                        eSymbolContextSymbol).GetFunctionName().AsCString();
+                    if (func_name)
+                        strm.Printf (" %s", func_name);
+                }
+                break;
+            }
+        }
+        descriptions[i] = strm.GetString();
+    }
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -2823,6 +3230,49 @@ Process::DeallocateMemory (addr_t ptr)
     return error;
 }
 
+void
+Process::LoadExpressionHelperLibrary ()
+{
+    if (m_expression_helper_library_attempted)
+        return;
+
+    FileSpec helper_file = GetTarget().GetExpressionHelperLibrary();
+    if (!helper_file)
+        return;
+
+    // Loading the library runs an expression, which might want a utility
+    // function itself.
+    m_expression_helper_library_attempted = true;
+
+    PlatformSP platform_sp = GetTarget().GetPlatform();
+    if (!platform_sp)
+        return;
+
+    // A remote platform copies the library to its working directory, on
+    // the host it is loaded from where it is.
+    Error error;
+    uint32_t image_token;
+    if (platform_sp->IsRemote())
+        image_token = platform_sp->LoadImage(this, helper_file, FileSpec(), error);
+    else
+        image_token = platform_sp->LoadImage(this, helper_file, helper_file, error);
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    if (log)
+        log->Printf("Process::LoadExpressionHelperLibrary loading \"%s\" => %s",
+                    helper_file.GetPath().c_str(),
+                    image_token != LLDB_INVALID_IMAGE_TOKEN ? "success" : error.AsCString("failed"));
+
+    if (image_token == LLDB_INVALID_IMAGE_TOKEN)
+    {
+        StreamSP error_sp = GetTarget().GetDebugger().GetAsyncErrorStream();
+        error_sp->Printf("warning: couldn't load the expression helper library \"%s\": %s\n",
+                         helper_file.GetPath().c_str(),
+                         error.AsCString("unknown error"));
+        error_sp->Flush();
+    }
+}
+
 ModuleSP
 Process::ReadModuleFromMemory (const FileSpec& file_spec, 
                                lldb::addr_t header_addr,
@@ -3560,6 +4010,10 @@ Process::PrivateResume ()
                     m_thread_list.DidResume();
                     if (log)
                         log->Printf ("Process thinks the process has resumed.");
+                    // Expressions are usually evaluated right after the
+                    // next stop, get the parser ready while we run.
+                    if (!m_mod_id.IsLastResumeForUserExpression())
+                        GetTarget().WarmUpExpressionParser();
                 }
             }
         }
@@ -3709,6 +4163,7 @@ Process::Detach (bool keep_stopped)
     
         m_thread_list.DiscardThreadPlans();
         DisableAllBreakpointSites();
+        RemoveAllFastTracepoints();
 
         error = DoDetach(keep_stopped);
         if (error.Success())
@@ -4480,6 +4935,24 @@ Process::ProcessEventData::GetFlavor () const
     return ProcessEventData::GetFlavorString ();
 }
 
+// "up" and "finish" usually show the caller's source next, read it in
+// the background while the stop is being reported.
+static void
+PrefetchCallerSource (Process &process)
+{
+    ThreadSP thread_sp (process.GetThreadList().GetSelectedThread());
+    if (!thread_sp)
+        return;
+
+    StackFrameSP frame_sp (thread_sp->GetStackFrameAtIndex (1));
+    if (!frame_sp)
+        return;
+
+    const SymbolContext &sc = frame_sp->GetSymbolContext (eSymbolContextLineEntry);
+    if (sc.line_entry.file)
+        process.GetTarget().GetSourceManager().PrefetchFile (sc.line_entry.file);
+}
+
 void
 Process::ProcessEventData::DoOnRemoval (Event *event_ptr)
 {
@@ -4614,6 +5087,11 @@ Process::ProcessEventData::DoOnRemoval (Event *event_ptr)
                 process_sp->GetTarget().RunStopHooks();
                 if (process_sp->GetPrivateState() == eStateRunning)
                     SetRestarted(true);
+                else
+                {
+                    PrefetchCallerSource (*process_sp);
+                    process_sp->GetTarget().EnforceDebugInfoMemoryBudget();
+                }
             }
         }
     }
@@ -6315,9 +6793,17 @@ Process::DidExec ()
     m_dyld_ap.reset();
     m_jit_loaders_ap.reset();
     m_image_tokens.clear();
+    // The patched code and the trampolines went away with the old image.
+    for (auto &tracepoint_sp : m_fast_tracepoints)
+        tracepoint_sp->Invalidate();
+    m_fast_tracepoints.clear();
     m_allocated_memory_cache.Clear();
     m_language_runtimes.clear();
     m_instrumentation_runtimes.clear();
+    // The scratch area of a displaced step went away with the old image.
+    m_displaced_step_pc = LLDB_INVALID_ADDRESS;
+    m_displaced_step_scratch_addr = LLDB_INVALID_ADDRESS;
+    m_displaced_step_saved_bytes.clear();
     m_thread_list.DiscardThreadPlans();
     m_memory_cache.Clear(true);
     m_stop_info_override_callback = nullptr;
@@ -6369,6 +6855,9 @@ Process::ResolveIndirectFunction(const Address *address, Error &error)
 void
 Process::ModulesDidLoad (ModuleList &module_list)
 {
+    // The memory of the new modules may have been known as not file backed.
+    m_memory_cache.ClearFileBackedRanges();
+
     SystemRuntime *sys_runtime = GetSystemRuntime();
     if (sys_runtime)
     {
@@ -6410,6 +6899,13 @@ Process::ModulesDidLoad (ModuleList &module_list)
         LoadOperatingSystemPlugin(false);
 }
 
+void
+Process::ModulesDidUnload (ModuleList &module_list)
+{
+    // Something else can be mapped where the modules were.
+    m_memory_cache.ClearFileBackedRanges();
+}
+
 void
 Process::PrintWarning (uint64_t warning_type, const void *repeat_key, const char *fmt, ...)
 {
@@ -6539,6 +7035,189 @@ Process::ResetImageToken(size_t token)
         m_image_tokens[token] = LLDB_INVALID_IMAGE_TOKEN;
 }
 
+void
+Process::UnwindAllThreads (uint32_t max_frames)
+{
+    if (IsLiveDebugSession() || max_frames == 0)
+        return;
+
+    // Don't hold the thread list lock while the tasks run, looking up a
+    // thread from an unwinding task would deadlock.
+    std::vector<ThreadSP> threads;
+    for (ThreadSP thread_sp : Threads())
+        threads.push_back (thread_sp);
+    if (threads.size() < 2)
+        return;
+
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat, "%s (%" PRIu64 " threads)", __PRETTY_FUNCTION__, (uint64_t)threads.size());
+
+    TaskRunner<void> task_runner;
+    for (const ThreadSP &thread_sp : threads)
+    {
+        task_runner.AddTask ([thread_sp, max_frames]()
+        {
+            if (max_frames == UINT32_MAX)
+                thread_sp->GetStackFrameCount();
+            else
+                thread_sp->GetStackFrameAtIndex (max_frames - 1);
+        });
+    }
+    task_runner.WaitForAllTasks();
+}
+
+Error
+Process::SaveTriageRecord (const FileSpec &file, uint32_t max_frames)
+{
+    Error error;
+    if (!StateIsStoppedState (GetState(), true))
+    {
+        error.SetErrorString ("the process must be stopped to save a triage record");
+        return error;
+    }
+
+    UnwindAllThreads (max_frames);
+
+    Target &target = GetTarget();
+    TriageRecordWriter writer (GetID());
+
+    std::map<const lldb_private::Module *, uint32_t> module_indexes;
+    const ModuleList &images = target.GetImages();
+    const size_t num_modules = images.GetSize();
+    for (size_t i = 0; i < num_modules; ++i)
+    {
+        ModuleSP module_sp (images.GetModuleAtIndex (i));
+        if (!module_sp)
+            continue;
+
+        lldb::addr_t load_addr = LLDB_INVALID_ADDRESS;
+        ObjectFile *objfile = module_sp->GetObjectFile();
+        if (objfile)
+            load_addr = objfile->GetHeaderAddress().GetLoadAddress (&target);
+
+        UUID uuid (module_sp->GetUUID());
+        const uint8_t *uuid_bytes = static_cast<const uint8_t *>(uuid.GetBytes());
+        ConstString path (module_sp->GetFileSpec().GetPath().c_str());
+        module_indexes[module_sp.get()] = writer.AddModule (uuid.IsValid() ? uuid_bytes : nullptr,
+                                                            uuid.IsValid() ? uuid.GetByteSize() : 0,
+                                                            path,
+                                                            load_addr);
+    }
+
+    for (ThreadSP thread_sp : Threads())
+    {
+        writer.AddThread (thread_sp->GetID(), thread_sp->GetIndexID());
+        for (uint32_t idx = 0; idx < max_frames; ++idx)
+        {
+            StackFrameSP frame_sp (thread_sp->GetStackFrameAtIndex (idx));
+            if (!frame_sp)
+                break;
+
+            const Address &pc_addr = frame_sp->GetFrameCodeAddress();
+            uint32_t module_idx = TriageRecord::kInvalidIndex;
+            ModuleSP module_sp (pc_addr.GetModule());
+            if (module_sp)
+            {
+                auto pos = module_indexes.find (module_sp.get());
+                if (pos != module_indexes.end())
+                    module_idx = pos->second;
+            }
+
+            const SymbolContext &sc = frame_sp->GetSymbolContext (eSymbolContextFunction | eSymbolContextBlock | eSymbolContextSymbol);
+            writer.AddFrame (pc_addr.GetLoadAddress (&target),
+                             module_idx,
+                             pc_addr.GetFileAddress(),
+                             sc.GetFunctionName());
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+    writer.GetBytes (bytes);
+
+    File output (file, File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate);
+    if (!output.IsValid())
+    {
+        error.SetErrorStringWithFormat ("unable to open '%s' for writing", file.GetPath().c_str());
+        return error;
+    }
+
+    size_t num_bytes = bytes.size();
+    error = output.Write (bytes.data(), num_bytes);
+    if (error.Success() && num_bytes != bytes.size())
+        error.SetErrorStringWithFormat ("only wrote %" PRIu64 " of %" PRIu64 " bytes", (uint64_t)num_bytes, (uint64_t)bytes.size());
+    return error;
+}
+
+lldb::user_id_t
+Process::CreateFastTracepoint (lldb::addr_t addr, uint32_t capacity, Error &error)
+{
+    if (!StateIsStoppedState (GetState(), true))
+    {
+        error.SetErrorString ("the process must be stopped to install a fast tracepoint");
+        return LLDB_INVALID_UID;
+    }
+
+    for (const auto &tracepoint_sp : m_fast_tracepoints)
+    {
+        if (tracepoint_sp->GetLoadAddress() == addr)
+        {
+            error.SetErrorStringWithFormat ("fast tracepoint %" PRIu64 " is already installed at 0x%" PRIx64,
+                                            tracepoint_sp->GetID(), addr);
+            return LLDB_INVALID_UID;
+        }
+    }
+
+    FastTracepointSP tracepoint_sp (new FastTracepoint (*this, m_next_fast_tracepoint_id, addr, capacity));
+    error = tracepoint_sp->Install();
+    if (error.Fail())
+        return LLDB_INVALID_UID;
+    m_fast_tracepoints.push_back (tracepoint_sp);
+    return m_next_fast_tracepoint_id++;
+}
+
+Error
+Process::RemoveFastTracepoint (lldb::user_id_t id)
+{
+    for (auto pos = m_fast_tracepoints.begin(); pos != m_fast_tracepoints.end(); ++pos)
+    {
+        if ((*pos)->GetID() == id)
+        {
+            Error error ((*pos)->Remove());
+            if (error.Success())
+                m_fast_tracepoints.erase (pos);
+            return error;
+        }
+    }
+    return Error ("invalid fast tracepoint ID %" PRIu64, id);
+}
+
+void
+Process::RemoveAllFastTracepoints ()
+{
+    for (auto &tracepoint_sp : m_fast_tracepoints)
+        tracepoint_sp->Remove();
+    m_fast_tracepoints.clear();
+}
+
+lldb::FastTracepointSP
+Process::GetFastTracepointByID (lldb::user_id_t id)
+{
+    for (const auto &tracepoint_sp : m_fast_tracepoints)
+    {
+        if (tracepoint_sp->GetID() == id)
+            return tracepoint_sp;
+    }
+    return FastTracepointSP();
+}
+
+lldb::FastTracepointSP
+Process::GetFastTracepointAtIndex (size_t idx)
+{
+    if (idx < m_fast_tracepoints.size())
+        return m_fast_tracepoints[idx];
+    return FastTracepointSP();
+}
+
 Address
 Process::AdvanceAddressToNextBranchInstruction (Address default_stop_addr, AddressRange range_bounds)
 {
@@ -44,7 +44,7 @@ SectionLoadHistory::GetLastStopID() const
         return m_stop_id_to_section_load_list.rbegin()->first;
 }
 
-SectionLoadList *
+SectionLoadListSP
 SectionLoadHistory::GetSectionLoadListForStopID (uint32_t stop_id, bool read_only)
 {
     if (!m_stop_id_to_section_load_list.empty())
@@ -59,17 +59,17 @@ SectionLoadHistory::GetSectionLoadListForStopID (uint32_t stop_id, bool read_onl
                 // If we are asking for the latest and greatest value, it is always
                 // at the end of our list because that will be the highest stop ID.
                 StopIDToSectionLoadList::reverse_iterator rpos = m_stop_id_to_section_load_list.rbegin();
-                return rpos->second.get();
+                return rpos->second;
             }
             else
             {
                 StopIDToSectionLoadList::iterator pos = m_stop_id_to_section_load_list.lower_bound(stop_id);
                 if (pos != m_stop_id_to_section_load_list.end() && pos->first == stop_id)
-                    return pos->second.get();
+                    return pos->second;
                 else if (pos != m_stop_id_to_section_load_list.begin())
                 {
                     --pos;
-                    return pos->second.get();
+                    return pos->second;
                 }
             }
         }
@@ -85,7 +85,7 @@ SectionLoadHistory::GetSectionLoadListForStopID (uint32_t stop_id, bool read_onl
             if (pos != m_stop_id_to_section_load_list.end() && pos->first == stop_id)
             {
                 // We already have an entry for this value
-                return pos->second.get();
+                return pos->second;
             }
             
             // We must make a new section load list that is based on the last valid
@@ -94,14 +94,14 @@ SectionLoadHistory::GetSectionLoadListForStopID (uint32_t stop_id, bool read_onl
             StopIDToSectionLoadList::reverse_iterator rpos = m_stop_id_to_section_load_list.rbegin();
             SectionLoadListSP section_load_list_sp(new SectionLoadList(*rpos->second.get()));
             m_stop_id_to_section_load_list[stop_id] = section_load_list_sp;
-            return section_load_list_sp.get();
+            return section_load_list_sp;
         }
     }
     SectionLoadListSP section_load_list_sp(new SectionLoadList());
     if (stop_id == eStopIDNow)
         stop_id = 0;
     m_stop_id_to_section_load_list[stop_id] = section_load_list_sp;
-    return section_load_list_sp.get();
+    return section_load_list_sp;
 }
 
 SectionLoadList &
@@ -109,8 +109,8 @@ SectionLoadHistory::GetCurrentSectionLoadList ()
 {
     const bool read_only = true;
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    SectionLoadList *section_load_list = GetSectionLoadListForStopID (eStopIDNow, read_only);
-    assert(section_load_list != NULL);
+    SectionLoadListSP section_load_list = GetSectionLoadListForStopID (eStopIDNow, read_only);
+    assert(section_load_list);
     return *section_load_list;
 }
 
@@ -119,17 +119,21 @@ SectionLoadHistory::GetSectionLoadAddress (uint32_t stop_id, const lldb::Section
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
     const bool read_only = true;
-    SectionLoadList *section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
+    SectionLoadListSP section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
     return section_load_list->GetSectionLoadAddress(section_sp);
 }
 
 bool
 SectionLoadHistory::ResolveLoadAddress (uint32_t stop_id, addr_t load_addr, Address &so_addr)
 {
-    // First find the top level section that this load address exists in
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    const bool read_only = true;
-    SectionLoadList *section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
+    // Only look up the section load list with the lock held, it resolves
+    // addresses without locking.
+    SectionLoadListSP section_load_list;
+    {
+        std::lock_guard<std::recursive_mutex> guard(m_mutex);
+        const bool read_only = true;
+        section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
+    }
     return section_load_list->ResolveLoadAddress (load_addr, so_addr);
 }
 
@@ -141,7 +145,7 @@ SectionLoadHistory::SetSectionLoadAddress (uint32_t stop_id,
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
     const bool read_only = false;
-    SectionLoadList *section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
+    SectionLoadListSP section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
     return section_load_list->SetSectionLoadAddress(section_sp, load_addr, warn_multiple);
 }
 
@@ -150,7 +154,7 @@ SectionLoadHistory::SetSectionUnloaded (uint32_t stop_id, const lldb::SectionSP
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
     const bool read_only = false;
-    SectionLoadList *section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
+    SectionLoadListSP section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
     return section_load_list->SetSectionUnloaded (section_sp);
 }
 
@@ -159,7 +163,7 @@ SectionLoadHistory::SetSectionUnloaded (uint32_t stop_id, const lldb::SectionSP
 {
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
     const bool read_only = false;
-    SectionLoadList *section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
+    SectionLoadListSP section_load_list = GetSectionLoadListForStopID (stop_id, read_only);
     return section_load_list->SetSectionUnloaded (section_sp, load_addr);
 }
 
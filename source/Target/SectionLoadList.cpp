@@ -11,6 +11,9 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+#include <atomic>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Log.h"
@@ -24,11 +27,16 @@
 using namespace lldb;
 using namespace lldb_private;
 
-SectionLoadList::SectionLoadList(const SectionLoadList &rhs) : m_addr_to_sect(), m_sect_to_addr(), m_mutex()
+SectionLoadList::SectionLoadList(const SectionLoadList &rhs) :
+    m_addr_to_sect(),
+    m_sect_to_addr(),
+    m_loaded_sections(),
+    m_mutex()
 {
     std::lock_guard<std::recursive_mutex> guard(rhs.m_mutex);
     m_addr_to_sect = rhs.m_addr_to_sect;
     m_sect_to_addr = rhs.m_sect_to_addr;
+    std::atomic_store(&m_loaded_sections, std::atomic_load(&rhs.m_loaded_sections));
 }
 
 void
@@ -38,6 +46,34 @@ SectionLoadList::operator=(const SectionLoadList &rhs)
     std::lock_guard<std::recursive_mutex> rhs_guard(rhs.m_mutex);
     m_addr_to_sect = rhs.m_addr_to_sect;
     m_sect_to_addr = rhs.m_sect_to_addr;
+    std::atomic_store(&m_loaded_sections, std::atomic_load(&rhs.m_loaded_sections));
+}
+
+SectionLoadList::LoadedSectionArraySP
+SectionLoadList::GetLoadedSections () const
+{
+    LoadedSectionArraySP loaded_sections = std::atomic_load(&m_loaded_sections);
+    if (loaded_sections)
+        return loaded_sections;
+
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    loaded_sections = std::atomic_load(&m_loaded_sections);
+    if (!loaded_sections)
+    {
+        std::shared_ptr<LoadedSectionArray> new_sections(new LoadedSectionArray());
+        new_sections->reserve(m_addr_to_sect.size());
+        for (const auto &entry : m_addr_to_sect)
+            new_sections->push_back(LoadedSection{entry.first, entry.second});
+        loaded_sections = new_sections;
+        std::atomic_store(&m_loaded_sections, loaded_sections);
+    }
+    return loaded_sections;
+}
+
+void
+SectionLoadList::InvalidateLoadedSections ()
+{
+    std::atomic_store(&m_loaded_sections, LoadedSectionArraySP());
 }
 
 bool
@@ -53,6 +89,7 @@ SectionLoadList::Clear ()
     std::lock_guard<std::recursive_mutex> guard(m_mutex);
     m_addr_to_sect.clear();
     m_sect_to_addr.clear();
+    InvalidateLoadedSections();
 }
 
 addr_t
@@ -141,6 +178,7 @@ SectionLoadList::SetSectionLoadAddress (const lldb::SectionSP &section, addr_t l
         }
         else
             m_addr_to_sect[load_addr] = section;
+        InvalidateLoadedSections();
         return true;    // Changed
 
     }
@@ -192,7 +230,10 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp)
 
             addr_to_sect_collection::iterator ats_pos = m_addr_to_sect.find(load_addr);
             if (ats_pos != m_addr_to_sect.end())
+            {
                 m_addr_to_sect.erase (ats_pos);
+                InvalidateLoadedSections();
+            }
         }
     }
     return unload_count;
@@ -231,6 +272,7 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp, addr_t l
     {
         erased = true;
         m_addr_to_sect.erase (ats_pos);
+        InvalidateLoadedSections();
     }
 
     return erased;
@@ -240,42 +282,21 @@ SectionLoadList::SetSectionUnloaded (const lldb::SectionSP &section_sp, addr_t l
 bool
 SectionLoadList::ResolveLoadAddress (addr_t load_addr, Address &so_addr) const
 {
-    // First find the top level section that this load address exists in
-    std::lock_guard<std::recursive_mutex> guard(m_mutex);
-    if (!m_addr_to_sect.empty())
+    // First find the top level section that this load address exists in,
+    // the last one that starts at or before it.
+    LoadedSectionArraySP loaded_sections = GetLoadedSections();
+    LoadedSectionArray::const_iterator pos =
+        std::upper_bound(loaded_sections->begin(), loaded_sections->end(), load_addr,
+                         [](addr_t addr, const LoadedSection &loaded) { return addr < loaded.load_addr; });
+    if (pos != loaded_sections->begin())
     {
-        addr_to_sect_collection::const_iterator pos = m_addr_to_sect.lower_bound (load_addr);
-        if (pos != m_addr_to_sect.end())
+        --pos;
+        addr_t offset = load_addr - pos->load_addr;
+        if (offset < pos->section_sp->GetByteSize())
         {
-            if (load_addr != pos->first && pos != m_addr_to_sect.begin())
-                --pos;
-            const addr_t pos_load_addr = pos->first;
-            if (load_addr >= pos_load_addr)
-            {
-                addr_t offset = load_addr - pos_load_addr;
-                if (offset < pos->second->GetByteSize())
-                {
-                    // We have found the top level section, now we need to find the
-                    // deepest child section.
-                    return pos->second->ResolveContainedAddress (offset, so_addr);
-                }
-            }
-        }
-        else
-        {
-            // There are no entries that have an address that is >= load_addr,
-            // so we need to check the last entry on our collection.
-            addr_to_sect_collection::const_reverse_iterator rpos = m_addr_to_sect.rbegin();
-            if (load_addr >= rpos->first)
-            {
-                addr_t offset = load_addr - rpos->first;
-                if (offset < rpos->second->GetByteSize())
-                {
-                    // We have found the top level section, now we need to find the
-                    // deepest child section.
-                    return rpos->second->ResolveContainedAddress (offset, so_addr);
-                }
-            }
+            // We have found the top level section, now we need to find the
+            // deepest child section.
+            return pos->section_sp->ResolveContainedAddress (offset, so_addr);
         }
     }
     so_addr.Clear();
@@ -560,17 +560,38 @@ StackFrame::GetInScopeVariableList (bool get_file_globals, bool must_have_valid_
 
     if (m_sc.block)
     {
-        const bool can_create = true;
-        const bool get_parent_variables = true;
-        const bool stop_if_block_is_inlined_function = true;
-        m_sc.block->AppendVariables (can_create, 
-                                     get_parent_variables,
-                                     stop_if_block_is_inlined_function,
-                                     [this, must_have_valid_location](Variable* v)
-                                     {
-                                         return v->IsInScope(this) && (!must_have_valid_location || v->LocationIsValidForFrame(this));
-                                     },
-                                     var_list_sp.get());
+        // The variables in scope only depend on the innermost block and
+        // the address in it, frames that stop at the same address again
+        // reuse the filtered list. Only addresses that are loaded can be
+        // cached, the locations of the variables are checked against the
+        // load address of the function.
+        TargetSP target_sp (CalculateTarget());
+        const Address &frame_code_addr = GetFrameCodeAddress();
+        addr_t file_addr = LLDB_INVALID_ADDRESS;
+        if (frame_code_addr.GetLoadAddress(target_sp.get()) != LLDB_INVALID_ADDRESS)
+            file_addr = frame_code_addr.GetFileAddress();
+
+        VariableListSP block_var_list_sp;
+        if (file_addr != LLDB_INVALID_ADDRESS)
+            block_var_list_sp = m_sc.block->GetCachedInScopeVariables (file_addr, must_have_valid_location);
+        if (!block_var_list_sp)
+        {
+            block_var_list_sp.reset(new VariableList);
+            const bool can_create = true;
+            const bool get_parent_variables = true;
+            const bool stop_if_block_is_inlined_function = true;
+            m_sc.block->AppendVariables (can_create, 
+                                         get_parent_variables,
+                                         stop_if_block_is_inlined_function,
+                                         [this, must_have_valid_location](Variable* v)
+                                         {
+                                             return v->IsInScope(this) && (!must_have_valid_location || v->LocationIsValidForFrame(this));
+                                         },
+                                         block_var_list_sp.get());
+            if (file_addr != LLDB_INVALID_ADDRESS)
+                m_sc.block->CacheInScopeVariables (file_addr, must_have_valid_location, block_var_list_sp);
+        }
+        var_list_sp->AddVariables (block_var_list_sp.get());
     }
                      
     if (m_sc.comp_unit && get_file_globals)
@@ -1485,6 +1506,18 @@ StackFrame::UpdatePreviousFrameFromCurrentFrame (StackFrame &curr_frame)
     m_frame_base_error.Clear();
 }
     
+void
+StackFrame::UpdateFrameIndexForReuse (uint32_t frame_index, uint32_t concrete_frame_index)
+{
+    std::lock_guard<std::recursive_mutex> guard(m_mutex);
+    m_frame_index = frame_index;
+    m_concrete_frame_index = concrete_frame_index;
+    m_reg_context_sp.reset();
+    m_flags.Clear(GOT_FRAME_BASE);
+    m_frame_base.Clear();
+    m_frame_base_error.Clear();
+}
+
 bool
 StackFrame::HasCachedData () const
 {
@@ -15,6 +15,7 @@
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/Breakpoint.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/SourceManager.h"
 #include "lldb/Symbol/Block.h"
@@ -246,6 +247,60 @@ StackFrameList::SetCurrentInlinedDepth (uint32_t new_depth)
         m_current_inlined_pc = m_thread.GetRegisterContext()->GetPC();
 }
 
+bool
+StackFrameList::ReuseUnchangedFrames (uint32_t concrete_idx, lldb::addr_t cfa, lldb::addr_t pc)
+{
+    // Frame zero has always moved since the previous stop.
+    if (concrete_idx == 0 || !m_prev_frames_sp)
+        return false;
+    StackFrameList *prev_frames = m_prev_frames_sp.get();
+    if (!prev_frames->GetAllFramesFetched() || prev_frames->m_show_inlined_frames != m_show_inlined_frames)
+        return false;
+
+    // The first frame of each concrete frame is the one that was unwound,
+    // the ones after it are its inlined callers.
+    const size_t num_prev_frames = prev_frames->m_frames.size();
+    size_t match_idx = num_prev_frames;
+    for (size_t i = 0; i < num_prev_frames; ++i)
+    {
+        StackFrame *prev_frame = prev_frames->m_frames[i].get();
+        if (prev_frame == nullptr)
+            return false;
+        // The symbol context of frame zero is looked up with its PC rather
+        // than the return address, so it can't become a caller frame.
+        if (prev_frame->GetConcreteFrameIndex() == 0 ||
+            prev_frames->m_frames[i - 1]->GetConcreteFrameIndex() == prev_frame->GetConcreteFrameIndex())
+            continue;
+        const StackID &prev_id = prev_frame->GetStackID();
+        if (prev_id.GetCallFrameAddress() == cfa && prev_id.GetPC() == pc)
+        {
+            match_idx = i;
+            break;
+        }
+    }
+    if (match_idx == num_prev_frames)
+        return false;
+
+    // A frame that is at the same PC with the same CFA didn't run since the
+    // previous stop, so neither did its callers and the rest of the stack
+    // doesn't need to be unwound again.
+    const uint32_t prev_concrete_idx = prev_frames->m_frames[match_idx]->GetConcreteFrameIndex();
+    for (size_t i = match_idx; i < num_prev_frames; ++i)
+    {
+        StackFrameSP frame_sp (prev_frames->m_frames[i]);
+        frame_sp->UpdateFrameIndexForReuse (m_frames.size(),
+                                            concrete_idx + frame_sp->GetConcreteFrameIndex() - prev_concrete_idx);
+        m_frames.push_back (frame_sp);
+    }
+    SetAllFramesFetched();
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    if (log && log->GetVerbose())
+        log->Printf ("StackFrameList::ReuseUnchangedFrames: reused %" PRIu64 " frames from concrete frame %u.\n",
+                     (uint64_t)(num_prev_frames - match_idx), concrete_idx);
+    return true;
+}
+
 void
 StackFrameList::GetFramesUpTo(uint32_t end_idx)
 {
@@ -331,6 +386,8 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
                     SetAllFramesFetched();
                     break;
                 }
+                if (ReuseUnchangedFrames (idx, cfa, pc))
+                    break;
                 const bool cfa_is_valid = true;
                 const bool stop_id_is_valid = false;
                 const bool is_history_frame = false;
@@ -367,23 +424,34 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
                     }
                 }
                     
-                SymbolContext next_frame_sc;
-                Address next_frame_address;
-                
-                while (unwind_sc.GetParentOfInlinedScope(curr_frame_address, next_frame_sc, next_frame_address))
+                // The module caches the inlined callers of each block range,
+                // so each concrete frame only needs a single lookup.
+                Module::InlinedCallChain inlined_callers;
+                if (unwind_sc.module_sp)
+                    unwind_sc.module_sp->GetInlinedCallChain(unwind_block, curr_frame_address, inlined_callers);
+
+                for (const Module::InlinedCallSite &caller : inlined_callers)
                 {
-                    next_frame_sc.line_entry.ApplyFileMappings(target_sp);
+                    SymbolContext next_frame_sc;
+                    next_frame_sc.module_sp = unwind_sc.module_sp;
+                    next_frame_sc.comp_unit = unwind_sc.comp_unit;
+                    next_frame_sc.function = unwind_sc.function;
+                    next_frame_sc.block = caller.block;
+                    next_frame_sc.line_entry.range.GetBaseAddress() = caller.call_address;
+                    next_frame_sc.line_entry.file = caller.call_site.GetFile();
+                    next_frame_sc.line_entry.original_file = caller.call_site.GetFile();
+                    next_frame_sc.line_entry.line = caller.call_site.GetLine();
+                    next_frame_sc.line_entry.column = caller.call_site.GetColumn();
+                    next_frame_sc.line_entry.ApplyFileMappings(target_sp);
                     StackFrameSP frame_sp(new StackFrame(m_thread.shared_from_this(),
                                                          m_frames.size(),
                                                          idx,
                                                          unwind_frame_sp->GetRegisterContextSP (),
                                                          cfa,
-                                                         next_frame_address,
-                                                         &next_frame_sc));  
+                                                         caller.call_address,
+                                                         &next_frame_sc));
 
                     m_frames.push_back (frame_sp);
-                    unwind_sc = next_frame_sc;
-                    curr_frame_address = next_frame_address;
                 }
             }
         } while (m_frames.size() - 1 < end_idx);
@@ -435,6 +503,10 @@ StackFrameList::GetFramesUpTo(uint32_t end_idx)
                 if (curr_frame == nullptr || prev_frame == nullptr)
                     break;
 
+                // Frames reused by ReuseUnchangedFrames are already the same
+                if (curr_frame == prev_frame)
+                    continue;
+
                 // Check the stack ID to make sure they are equal
                 if (curr_frame->GetStackID() != prev_frame->GetStackID())
                     break;
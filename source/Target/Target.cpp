@@ -9,15 +9,22 @@
 
 // C Includes
 // C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <map>
 #include <mutex>
+#include <set>
+#include <thread>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Target/Target.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/BreakpointResolver.h"
 #include "lldb/Breakpoint/BreakpointResolverAddress.h"
 #include "lldb/Breakpoint/BreakpointResolverFileLine.h"
 #include "lldb/Breakpoint/BreakpointResolverFileRegex.h"
 #include "lldb/Breakpoint/BreakpointResolverName.h"
+#include "lldb/Breakpoint/StoppointCallbackContext.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Event.h"
@@ -34,6 +41,7 @@
 #include "lldb/Expression/REPL.h"
 #include "lldb/Expression/UserExpression.h"
 #include "Plugins/ExpressionParser/Clang/ClangASTSource.h"
+#include "Plugins/ExpressionParser/Clang/ClangExpressionParser.h"
 #include "Plugins/ExpressionParser/Clang/ClangPersistentVariables.h"
 #include "Plugins/ExpressionParser/Clang/ClangModulesDeclVendor.h"
 #include "lldb/Host/FileSpec.h"
@@ -43,10 +51,16 @@
 #include "lldb/Interpreter/OptionGroupWatchpoint.h"
 #include "lldb/Interpreter/OptionValues.h"
 #include "lldb/Interpreter/Property.h"
+#include "lldb/Symbol/Block.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
+#include "lldb/Symbol/Symtab.h"
+#include "lldb/Symbol/TypeList.h"
+#include "lldb/Symbol/VariableList.h"
 #include "lldb/Target/Language.h"
 #include "lldb/Target/LanguageRuntime.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
@@ -55,8 +69,10 @@
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Target/Thread.h"
+#include "lldb/Target/ThreadPlan.h"
 #include "lldb/Target/ThreadSpec.h"
 #include "lldb/Utility/LLDBAssert.h"
+#include "lldb/Utility/TaskPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -91,7 +107,16 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
       m_stop_hook_next_id(0),
       m_valid(true),
       m_suppress_stop_hooks(false),
-      m_is_dummy_target(is_dummy_target)
+      m_defer_module_load_notifications(false),
+      m_is_dummy_target(is_dummy_target),
+      m_expression_stats_mutex(),
+      m_expression_stats(),
+      m_user_expression_cache_mutex(),
+      m_user_expression_cache(),
+      m_expression_parser_warm_up_pending(false),
+      m_global_lookup_cache_mutex(),
+      m_global_lookup_cache(),
+      m_global_lookup_cache_generation(0)
 
 {
     SetEventName(eBroadcastBitBreakpointChanged, "breakpoint-changed");
@@ -183,6 +208,13 @@ Target::DeleteCurrentProcess ()
 {
     if (m_process_sp)
     {
+        // The cached expressions' code and data live in the process.
+        ClearUserExpressionCache();
+        if (m_function_call_return_bp_sp)
+        {
+            RemoveBreakpointByID (m_function_call_return_bp_sp->GetID());
+            m_function_call_return_bp_sp.reset();
+        }
         m_section_load_history.Clear();
         if (m_process_sp->IsAlive())
             m_process_sp->Destroy(false);
@@ -272,6 +304,397 @@ Target::SetREPL (lldb::LanguageType language, lldb::REPLSP repl_sp)
     m_repl_map[language] = repl_sp;
 }
 
+void
+Target::RecordExpressionInterpreted ()
+{
+    std::lock_guard<std::mutex> guard(m_expression_stats_mutex);
+    ++m_expression_stats.num_interpreted;
+}
+
+void
+Target::RecordExpressionJITed (const char *reason)
+{
+    std::lock_guard<std::mutex> guard(m_expression_stats_mutex);
+    ++m_expression_stats.num_jitted;
+    ++m_expression_stats.jit_reasons[reason && reason[0] ? reason : "unknown"];
+}
+
+void
+Target::RecordExpressionEvaluation (bool success, uint64_t nanos)
+{
+    std::lock_guard<std::mutex> guard(m_expression_stats_mutex);
+    ++m_expression_stats.num_evaluations;
+    if (!success)
+        ++m_expression_stats.num_failed_evaluations;
+    m_expression_stats.total_evaluation_nanos += nanos;
+    if (nanos > m_expression_stats.max_evaluation_nanos)
+        m_expression_stats.max_evaluation_nanos = nanos;
+}
+
+Target::ExpressionStatistics
+Target::GetExpressionStatistics ()
+{
+    std::lock_guard<std::mutex> guard(m_expression_stats_mutex);
+    return m_expression_stats;
+}
+
+void
+Target::ClearExpressionStatistics ()
+{
+    std::lock_guard<std::mutex> guard(m_expression_stats_mutex);
+    m_expression_stats = ExpressionStatistics();
+}
+
+static StructuredData::ObjectSP
+GetModuleStatistics (Module &module)
+{
+    StructuredData::Dictionary *module_stats = new StructuredData::Dictionary();
+    module_stats->AddStringItem ("path", module.GetFileSpec().GetPath());
+    if (module.GetUUID().IsValid())
+        module_stats->AddStringItem ("uuid", module.GetUUID().GetAsString());
+
+    std::lock_guard<std::recursive_mutex> guard(module.GetMutex());
+    ObjectFile *objfile = module.GetObjectFile();
+    Symtab *symtab = objfile ? objfile->GetSymtabIfParsed() : nullptr;
+    if (symtab)
+    {
+        module_stats->AddIntegerItem ("num_symbols", symtab->GetNumSymbols());
+        module_stats->AddFloatItem ("symtab_parse_time", symtab->GetParseTime() / 1000000000.0);
+        module_stats->AddFloatItem ("symtab_index_time", symtab->GetIndexTime() / 1000000000.0);
+    }
+
+    SymbolVendor *sym_vendor = module.GetSymbolVendor(false);
+    SymbolFile *sym_file = sym_vendor ? sym_vendor->GetSymbolFile() : nullptr;
+    if (sym_file)
+        sym_file->GetStatistics (*module_stats);
+
+    return StructuredData::ObjectSP(module_stats);
+}
+
+size_t
+Target::EnforceDebugInfoMemoryBudget ()
+{
+    const uint64_t budget = GetDebugInfoMemoryBudget();
+    if (budget == 0)
+        return 0;
+
+    typedef std::pair<size_t, ModuleSP> ModuleMemory;
+    std::vector<ModuleMemory> module_memory;
+    uint64_t total = 0;
+    const size_t num_modules = m_images.GetSize();
+    for (size_t i = 0; i < num_modules; ++i)
+    {
+        ModuleSP module_sp (m_images.GetModuleAtIndex(i));
+        SymbolVendor *sym_vendor = module_sp ? module_sp->GetSymbolVendor(false) : nullptr;
+        if (sym_vendor == nullptr)
+            continue;
+        SymbolVendor::MemoryUsage usage;
+        sym_vendor->GetMemoryUsage (usage);
+        total += usage.GetTotal();
+        module_memory.push_back (ModuleMemory (usage.GetTotal(), module_sp));
+    }
+    if (total <= budget)
+        return 0;
+
+    // The modules the threads are stopped in are the likeliest to be
+    // looked at next, keep them.
+    std::set<Module *> hot_modules;
+    if (m_process_sp)
+    {
+        ThreadList &thread_list = m_process_sp->GetThreadList();
+        std::lock_guard<std::recursive_mutex> guard(thread_list.GetMutex());
+        const uint32_t num_threads = thread_list.GetSize(false);
+        for (uint32_t i = 0; i < num_threads; ++i)
+        {
+            StackFrameSP frame_sp (thread_list.GetThreadAtIndex(i, false)->GetStackFrameAtIndex(0));
+            if (frame_sp)
+                hot_modules.insert (frame_sp->GetFrameCodeAddress().GetModule().get());
+        }
+    }
+
+    std::sort (module_memory.begin(), module_memory.end(),
+               [](const ModuleMemory &lhs, const ModuleMemory &rhs) { return lhs.first > rhs.first; });
+
+    size_t released = 0;
+    for (const ModuleMemory &entry : module_memory)
+    {
+        if (total <= budget)
+            break;
+        if (hot_modules.count(entry.second.get()))
+            continue;
+        const size_t module_released = entry.second->GetSymbolVendor(false)->ReleaseCachedData();
+        released += module_released;
+        total -= std::min<uint64_t> (module_released, total);
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+    if (log)
+        log->Printf ("Target::%s released %" PRIu64 " bytes of debug info, %" PRIu64 " bytes are left for a budget of %" PRIu64,
+                     __FUNCTION__, (uint64_t)released, total, budget);
+    return released;
+}
+
+StructuredData::ObjectSP
+Target::GetStatistics ()
+{
+    StructuredData::Dictionary *target_stats = new StructuredData::Dictionary();
+    StructuredData::ObjectSP target_stats_sp(target_stats);
+
+    StructuredData::Array *modules = new StructuredData::Array();
+    const size_t num_modules = m_images.GetSize();
+    for (size_t i = 0; i < num_modules; ++i)
+    {
+        ModuleSP module_sp (m_images.GetModuleAtIndex(i));
+        if (module_sp)
+            modules->AddItem (GetModuleStatistics(*module_sp));
+    }
+    target_stats->AddItem ("modules", StructuredData::ObjectSP(modules));
+
+    target_stats->AddIntegerItem ("const_string_memory", ConstString::StaticMemorySize());
+
+    const ExpressionStatistics expr_stats = GetExpressionStatistics();
+    StructuredData::Dictionary *expressions = new StructuredData::Dictionary();
+    expressions->AddIntegerItem ("evaluations", expr_stats.num_evaluations);
+    expressions->AddIntegerItem ("failures", expr_stats.num_failed_evaluations);
+    expressions->AddIntegerItem ("interpreted", expr_stats.num_interpreted);
+    expressions->AddIntegerItem ("jitted", expr_stats.num_jitted);
+    expressions->AddFloatItem ("total_time", expr_stats.total_evaluation_nanos / 1000000000.0);
+    expressions->AddFloatItem ("max_time", expr_stats.max_evaluation_nanos / 1000000000.0);
+    if (expr_stats.num_evaluations > 0)
+        expressions->AddFloatItem ("average_time", expr_stats.total_evaluation_nanos / 1000000000.0 / expr_stats.num_evaluations);
+    target_stats->AddItem ("expressions", StructuredData::ObjectSP(expressions));
+
+    StructuredData::Array *breakpoints = new StructuredData::Array();
+    {
+        std::unique_lock<std::recursive_mutex> lock;
+        BreakpointList &breakpoint_list = GetBreakpointList();
+        breakpoint_list.GetListMutex(lock);
+        const size_t num_breakpoints = breakpoint_list.GetSize();
+        for (size_t i = 0; i < num_breakpoints; ++i)
+        {
+            BreakpointSP bp_sp = breakpoint_list.GetBreakpointAtIndex(i);
+            StructuredData::Dictionary *bp_stats = new StructuredData::Dictionary();
+            bp_stats->AddIntegerItem ("id", bp_sp->GetID());
+            bp_stats->AddIntegerItem ("num_locations", bp_sp->GetNumLocations());
+            bp_stats->AddFloatItem ("resolve_time", bp_sp->GetResolveTime() / 1000000000.0);
+            breakpoints->AddItem (StructuredData::ObjectSP(bp_stats));
+        }
+    }
+    target_stats->AddItem ("breakpoints", StructuredData::ObjectSP(breakpoints));
+
+    ProcessSP process_sp = GetProcessSP();
+    if (process_sp)
+    {
+        const MemoryCache::Statistics cache_stats = process_sp->GetMemoryCacheStatistics();
+        StructuredData::Dictionary *memory_cache = new StructuredData::Dictionary();
+        memory_cache->AddIntegerItem ("l1_hits", cache_stats.num_L1_hits);
+        memory_cache->AddIntegerItem ("l2_hits", cache_stats.num_L2_hits);
+        memory_cache->AddIntegerItem ("misses", cache_stats.num_misses);
+        memory_cache->AddIntegerItem ("prefetches", cache_stats.num_prefetches);
+        memory_cache->AddIntegerItem ("process_reads", cache_stats.num_inferior_reads);
+        memory_cache->AddIntegerItem ("process_bytes_read", cache_stats.inferior_bytes_read);
+        memory_cache->AddIntegerItem ("file_reads", cache_stats.num_file_reads);
+        memory_cache->AddIntegerItem ("file_backed_ranges", cache_stats.num_file_backed_ranges);
+        memory_cache->AddIntegerItem ("evictions", cache_stats.num_evictions);
+        memory_cache->AddIntegerItem ("lines", cache_stats.num_cached_lines);
+        memory_cache->AddIntegerItem ("bytes", cache_stats.cached_bytes);
+        target_stats->AddItem ("memory_cache", StructuredData::ObjectSP(memory_cache));
+
+        process_sp->GetStatistics (*target_stats);
+    }
+
+    return target_stats_sp;
+}
+
+// The number of parsed expressions Target keeps around
+static const size_t g_max_cached_user_expressions = 64;
+
+lldb::UserExpressionSP
+Target::FindCachedUserExpression (const std::string &key, ExecutionContext &exe_ctx)
+{
+    std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+    for (UserExpressionCache::iterator pos = m_user_expression_cache.begin(), end = m_user_expression_cache.end();
+         pos != end;
+         ++pos)
+    {
+        if (pos->first == key && pos->second->MatchesContext(exe_ctx))
+        {
+            m_user_expression_cache.splice(m_user_expression_cache.begin(), m_user_expression_cache, pos);
+            return m_user_expression_cache.front().second;
+        }
+    }
+    return lldb::UserExpressionSP();
+}
+
+void
+Target::CacheUserExpression (const std::string &key, const lldb::UserExpressionSP &user_expression_sp)
+{
+    std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+    m_user_expression_cache.push_front(std::make_pair(key, user_expression_sp));
+    if (m_user_expression_cache.size() > g_max_cached_user_expressions)
+        m_user_expression_cache.pop_back();
+}
+
+void
+Target::ClearUserExpressionCache ()
+{
+    UserExpressionCache user_expressions;
+    {
+        // Destroy the expressions after unlocking, they may free memory
+        // in the process.
+        std::lock_guard<std::mutex> guard(m_user_expression_cache_mutex);
+        user_expressions.swap(m_user_expression_cache);
+    }
+}
+
+// Bound the cache, most expressions use only a few names.
+static const size_t g_max_global_lookups = 4096;
+
+void
+Target::FindGlobalVariablesForExpressions (const ConstString &name, VariableList &variables)
+{
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+        GlobalLookupCache::iterator pos = m_global_lookup_cache.find(name.GetCString());
+        if (pos != m_global_lookup_cache.end() && pos->second.variables_valid)
+        {
+            for (const VariableSP &var_sp : pos->second.variables)
+                variables.AddVariable(var_sp);
+            return;
+        }
+        generation = m_global_lookup_cache_generation;
+    }
+
+    // Don't hold the lock while searching, the modules may be searched
+    // from other threads too.
+    VariableList found_variables;
+    m_images.FindGlobalVariables(name, true, -1, found_variables);
+
+    std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+    if (generation == m_global_lookup_cache_generation && m_global_lookup_cache.size() < g_max_global_lookups)
+    {
+        GlobalLookup &lookup = m_global_lookup_cache[name.GetCString()];
+        lookup.variables_valid = true;
+        lookup.variables.clear();
+        for (size_t i = 0, e = found_variables.GetSize(); i < e; ++i)
+            lookup.variables.push_back(found_variables.GetVariableAtIndex(i));
+    }
+    variables.AddVariables(&found_variables);
+}
+
+void
+Target::FindFunctionsForExpressions (const ConstString &name, SymbolContextList &sc_list)
+{
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+        GlobalLookupCache::iterator pos = m_global_lookup_cache.find(name.GetCString());
+        if (pos != m_global_lookup_cache.end() && pos->second.functions_valid)
+        {
+            sc_list.Append(pos->second.functions);
+            return;
+        }
+        generation = m_global_lookup_cache_generation;
+    }
+
+    const bool include_symbols = true;
+    const bool include_inlines = false;
+    const bool append = false;
+    SymbolContextList found_functions;
+    m_images.FindFunctions(name, eFunctionNameTypeFull, include_symbols, include_inlines, append, found_functions);
+
+    std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+    if (generation == m_global_lookup_cache_generation && m_global_lookup_cache.size() < g_max_global_lookups)
+    {
+        GlobalLookup &lookup = m_global_lookup_cache[name.GetCString()];
+        lookup.functions_valid = true;
+        lookup.functions = found_functions;
+    }
+    sc_list.Append(found_functions);
+}
+
+void
+Target::FindFirstTypeForExpressions (const ConstString &name, TypeList &types)
+{
+    uint32_t generation;
+    {
+        std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+        GlobalLookupCache::iterator pos = m_global_lookup_cache.find(name.GetCString());
+        if (pos != m_global_lookup_cache.end() && pos->second.types_valid)
+        {
+            for (const TypeSP &type_sp : pos->second.types)
+                types.Insert(type_sp);
+            return;
+        }
+        generation = m_global_lookup_cache_generation;
+    }
+
+    SymbolContext null_sc;
+    const bool exact_match = false;
+    llvm::DenseSet<SymbolFile *> searched_symbol_files;
+    TypeList found_types;
+    m_images.FindTypes(null_sc, name, exact_match, 1, searched_symbol_files, found_types);
+
+    std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+    if (generation == m_global_lookup_cache_generation && m_global_lookup_cache.size() < g_max_global_lookups)
+    {
+        GlobalLookup &lookup = m_global_lookup_cache[name.GetCString()];
+        lookup.types_valid = true;
+        lookup.types.clear();
+        for (size_t i = 0, e = found_types.GetSize(); i < e; ++i)
+            lookup.types.push_back(found_types.GetTypeAtIndex(i));
+    }
+    for (size_t i = 0, e = found_types.GetSize(); i < e; ++i)
+        types.Insert(found_types.GetTypeAtIndex(i));
+}
+
+void
+Target::ClearGlobalLookupCache ()
+{
+    GlobalLookupCache global_lookups;
+    {
+        // The results keep modules alive, release them after unlocking.
+        std::lock_guard<std::mutex> guard(m_global_lookup_cache_mutex);
+        global_lookups.swap(m_global_lookup_cache);
+        ++m_global_lookup_cache_generation;
+    }
+}
+
+void
+Target::WarmUpExpressionParser ()
+{
+    if (!m_valid || m_is_dummy_target || !GetWarmUpExpressionParser())
+        return;
+
+    // Everything below is created once and kept, so there is nothing to
+    // gain from more than one warm up at a time.
+    if (m_expression_parser_warm_up_pending.exchange(true))
+        return;
+
+    TargetWP target_wp (shared_from_this());
+    TaskPool::AddTask([target_wp]()
+    {
+        TargetSP target_sp (target_wp.lock());
+        if (!target_sp)
+            return;
+
+        Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+        // The scratch AST and the persistent variables live in the scratch
+        // type system, the modules decl vendor builds a compiler instance
+        // of its own. The first expression would create all of them.
+        target_sp->GetScratchClangASTContext(true);
+        target_sp->GetPersistentExpressionStateForLanguage(eLanguageTypeC);
+        target_sp->GetClangModulesDeclVendor();
+        ClangExpressionParser::WarmUp(ArchSpec(target_sp->GetArchitecture()));
+
+        if (log)
+            log->Printf("Target::WarmUpExpressionParser() done for target %p", static_cast<void *>(target_sp.get()));
+        target_sp->m_expression_parser_warm_up_pending = false;
+    });
+}
+
 void
 Target::Destroy()
 {
@@ -292,6 +715,7 @@ Target::Destroy()
     m_stop_hooks.clear();
     m_stop_hook_next_id = 0;
     m_suppress_stop_hooks = false;
+    ClearUserExpressionCache();
 }
 
 BreakpointList &
@@ -441,6 +865,42 @@ Target::CreateBreakpoint (const Address &addr, bool internal, bool hardware)
     return CreateBreakpoint (filter_sp, resolver_sp, internal, hardware, false);
 }
 
+static bool
+FunctionCallReturnBreakpointHit (void *baton,
+                                 StoppointCallbackContext *context,
+                                 lldb::user_id_t break_id,
+                                 lldb::user_id_t break_loc_id)
+{
+    // The breakpoint stays in place between calls, only stop the threads
+    // whose call function plan is waiting for it.
+    ThreadSP thread_sp (context->exe_ctx_ref.GetThreadSP());
+    if (!thread_sp)
+        return false;
+    ThreadPlan *plan = thread_sp->GetCurrentPlan();
+    return plan && plan->GetKind() == ThreadPlan::eKindCallFunction;
+}
+
+lldb::BreakpointSP
+Target::GetFunctionCallReturnBreakpoint (const Address &addr)
+{
+    if (m_function_call_return_bp_sp)
+    {
+        BreakpointLocationSP location_sp (m_function_call_return_bp_sp->GetLocationAtIndex(0));
+        if (location_sp && location_sp->GetAddress() == addr)
+            return m_function_call_return_bp_sp;
+        RemoveBreakpointByID (m_function_call_return_bp_sp->GetID());
+        m_function_call_return_bp_sp.reset();
+    }
+
+    m_function_call_return_bp_sp = CreateBreakpoint (addr, true, false);
+    if (m_function_call_return_bp_sp)
+    {
+        m_function_call_return_bp_sp->SetCallback (FunctionCallReturnBreakpointHit, nullptr, true);
+        m_function_call_return_bp_sp->SetBreakpointKind ("function-call-return");
+    }
+    return m_function_call_return_bp_sp;
+}
+
 lldb::BreakpointSP
 Target::CreateAddressInModuleBreakpoint (lldb::addr_t file_addr,
                                          bool internal,
@@ -1239,7 +1699,8 @@ Target::SetExecutableModule (ModuleSP& executable_sp, bool get_dependent_files)
     
     if (executable_sp)
     {
-        Timer scoped_timer (__PRETTY_FUNCTION__,
+        static Timer::Category func_cat(__PRETTY_FUNCTION__);
+        Timer scoped_timer (func_cat,
                             "Target::SetExecutableModule (executable = '%s')",
                             executable_sp->GetFileSpec().GetPath().c_str());
 
@@ -1381,6 +1842,8 @@ Target::MergeArchitecture (const ArchSpec &arch_spec)
 void
 Target::WillClearList (const ModuleList& module_list)
 {
+    ClearUserExpressionCache();
+    ClearGlobalLookupCache();
 }
 
 void
@@ -1389,9 +1852,13 @@ Target::ModuleAdded (const ModuleList& module_list, const ModuleSP &module_sp)
     // A module is being added to this target for the first time
     if (m_valid)
     {
+        ClearGlobalLookupCache();
+        LoadScriptingResourceForModule(module_sp, this);
+        if (m_defer_module_load_notifications)
+            return;
+
         ModuleList my_module_list;
         my_module_list.Append(module_sp);
-        LoadScriptingResourceForModule(module_sp, this);
         ModulesDidLoad (my_module_list);
     }
 }
@@ -1414,16 +1881,79 @@ Target::ModuleUpdated (const ModuleList& module_list, const ModuleSP &old_module
     // A module is replacing an already added module
     if (m_valid)
     {
+        ClearUserExpressionCache();
+        ClearGlobalLookupCache();
         m_breakpoint_list.UpdateBreakpointsWhenModuleIsReplaced(old_module_sp, new_module_sp);
         m_internal_breakpoint_list.UpdateBreakpointsWhenModuleIsReplaced(old_module_sp, new_module_sp);
     }
 }
 
+//----------------------------------------------------------------------
+// Resolving breakpoints in a batch of new modules looks names up in one
+// module after the other, and each lookup builds that module's indexes.
+// If many modules were loaded at once (e.g. a program dlopen'ing its
+// plug-ins) build the indexes on a few threads first so the lookups find
+// them ready. This doesn't use the TaskPool since indexing a module runs
+// tasks of its own there, and pool tasks must not wait for other tasks.
+//
+// If nothing has to be resolved right away, only the symbol tables are
+// built before returning and the debug info is indexed in the background.
+//----------------------------------------------------------------------
+static void
+PreloadModuleSymbols (ModuleList &module_list, bool index_debug_info)
+{
+    std::vector<ModuleSP> modules;
+    {
+        std::lock_guard<std::recursive_mutex> guard(module_list.GetMutex());
+        for (ModuleSP module_sp : module_list.ModulesNoLocking())
+        {
+            if (module_sp)
+                modules.push_back(module_sp);
+        }
+    }
+    if (modules.empty())
+        return;
+
+    const size_t num_threads = std::min<size_t>(modules.size(), std::max(1u, std::thread::hardware_concurrency()));
+    std::atomic<size_t> next_module_idx(0);
+    auto preload = [&modules, &next_module_idx, index_debug_info]()
+    {
+        for (size_t idx = next_module_idx++; idx < modules.size(); idx = next_module_idx++)
+            modules[idx]->PreloadSymbols(index_debug_info);
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; ++i)
+        threads.push_back(std::thread(preload));
+    preload();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    if (!index_debug_info)
+    {
+        // Each module's index is built in parallel on the TaskPool, at low
+        // priority and a few compile units at a time so that stopping and
+        // backtraces don't wait for it. One thread is enough to go through
+        // the modules.
+        std::thread([modules]() {
+            for (const ModuleSP &module_sp : modules)
+                module_sp->PreloadSymbolsInBackground();
+        }).detach();
+    }
+}
+
 void
 Target::ModulesDidLoad (ModuleList &module_list)
 {
     if (m_valid && module_list.GetSize())
     {
+        // Names in the expressions may resolve differently now.
+        ClearUserExpressionCache();
+        ClearGlobalLookupCache();
+        if (m_breakpoint_list.GetSize() > 0)
+            PreloadModuleSymbols (module_list, true);
+        else if (GetPreloadSymbols())
+            PreloadModuleSymbols (module_list, false);
         m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
         m_internal_breakpoint_list.UpdateBreakpoints (module_list, true, false);
         if (m_process_sp)
@@ -1431,6 +1961,7 @@ Target::ModulesDidLoad (ModuleList &module_list)
             m_process_sp->ModulesDidLoad (module_list);
         }
         BroadcastEvent (eBroadcastBitModulesLoaded, new TargetEventData (this->shared_from_this(), module_list));
+        WarmUpExpressionParser();
     }
 }
 
@@ -1439,6 +1970,7 @@ Target::SymbolsDidLoad (ModuleList &module_list)
 {
     if (m_valid && module_list.GetSize())
     {
+        ClearGlobalLookupCache();
         if (m_process_sp)
         {
             LanguageRuntime* runtime = m_process_sp->GetLanguageRuntime(lldb::eLanguageTypeObjC);
@@ -1460,7 +1992,11 @@ Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
 {
     if (m_valid && module_list.GetSize())
     {
+        ClearUserExpressionCache();
+        ClearGlobalLookupCache();
         UnloadModuleSections (module_list);
+        if (m_process_sp)
+            m_process_sp->ModulesDidUnload (module_list);
         m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         m_internal_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
         BroadcastEvent (eBroadcastBitModulesUnloaded, new TargetEventData (this->shared_from_this(), module_list));
@@ -2892,6 +3428,98 @@ Target::ResolveFileAddress (lldb::addr_t file_addr, Address &resolved_addr)
     return m_images.ResolveFileAddress(file_addr, resolved_addr);
 }
 
+// Whether the symbol context of an address is also the one of addr,
+// which is after it in the same module.
+static bool
+SymbolContextCoversAddress (const SymbolContext &sc, const Address &addr, uint32_t resolve_scope)
+{
+    // Variables go by their own ranges, and without a line table entry we
+    // can't tell whether the next symbol starts in between.
+    if ((resolve_scope & eSymbolContextVariable) || !(resolve_scope & eSymbolContextLineEntry))
+        return false;
+
+    const addr_t file_addr = addr.GetFileAddress();
+    if (!sc.line_entry.IsValid() || !sc.line_entry.range.ContainsFileAddress(file_addr))
+        return false;
+
+    if (resolve_scope & (eSymbolContextFunction | eSymbolContextBlock))
+    {
+        if (sc.function == nullptr || !sc.function->GetAddressRange().ContainsFileAddress(file_addr))
+            return false;
+    }
+
+    if (resolve_scope & eSymbolContextBlock)
+    {
+        // The block has to be the innermost one for addr too.
+        AddressRange range;
+        if (sc.block == nullptr || !sc.block->GetRangeContainingAddress(addr, range))
+            return false;
+        for (Block *child = sc.block->GetFirstChild(); child != nullptr; child = child->GetSibling())
+        {
+            if (child->GetRangeContainingAddress(addr, range))
+                return false;
+        }
+    }
+
+    if (resolve_scope & eSymbolContextSymbol)
+    {
+        if (sc.symbol != nullptr && !sc.symbol->ContainsFileAddress(file_addr))
+            return false;
+    }
+    return true;
+}
+
+void
+Target::ResolveLoadAddresses (const addr_t *load_addrs, size_t num_addrs, uint32_t resolve_scope, SymbolContextList &sc_list)
+{
+    std::vector<Address> so_addrs (num_addrs);
+    std::vector<SymbolContext> contexts (num_addrs);
+
+    // The indexes of the addresses of each module.
+    std::map<ModuleSP, std::vector<size_t>> module_addrs;
+    for (size_t i = 0; i < num_addrs; ++i)
+    {
+        if (ResolveLoadAddress (load_addrs[i], so_addrs[i]))
+        {
+            ModuleSP module_sp (so_addrs[i].GetModule());
+            if (module_sp)
+                module_addrs[module_sp].push_back(i);
+        }
+    }
+
+    auto resolve_module_addrs = [&so_addrs, &contexts, resolve_scope](const ModuleSP &module_sp, std::vector<size_t> &indexes)
+    {
+        std::stable_sort (indexes.begin(), indexes.end(), [&so_addrs](size_t lhs, size_t rhs) {
+            return so_addrs[lhs].GetFileAddress() < so_addrs[rhs].GetFileAddress();
+        });
+
+        const SymbolContext *prev_sc = nullptr;
+        for (size_t index : indexes)
+        {
+            SymbolContext &sc = contexts[index];
+            if (prev_sc && SymbolContextCoversAddress (*prev_sc, so_addrs[index], resolve_scope))
+                sc = *prev_sc;
+            else
+                module_sp->ResolveSymbolContextForAddress (so_addrs[index], resolve_scope, sc);
+            prev_sc = &sc;
+        }
+    };
+
+    // The modules don't share anything we resolve, they can go in parallel.
+    if (module_addrs.size() == 1)
+        resolve_module_addrs (module_addrs.begin()->first, module_addrs.begin()->second);
+    else if (module_addrs.size() > 1)
+    {
+        TaskRunner<void> task_runner;
+        for (auto &pair : module_addrs)
+            task_runner.AddTask([&resolve_module_addrs, &pair]() { resolve_module_addrs (pair.first, pair.second); });
+        task_runner.WaitForAllTasks();
+    }
+
+    for (const SymbolContext &sc : contexts)
+        sc_list.Append (sc);
+}
+
 bool
 Target::SetSectionLoadAddress (const SectionSP &section_sp, addr_t new_section_load_addr, bool warn_multiple)
 {
@@ -3423,6 +4051,9 @@ g_properties[] =
     { "move-to-nearest-code"               , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Move breakpoints to nearest code." },
     { "language"                           , OptionValue::eTypeLanguage  , false, eLanguageTypeUnknown      , nullptr, nullptr, "The language to use when interpreting expressions entered in commands." },
     { "expr-prefix"                        , OptionValue::eTypeFileSpec  , false, 0                         , nullptr, nullptr, "Path to a file containing expressions to be prepended to all expressions." },
+    { "expr-helper-library"                , OptionValue::eTypeFileSpec  , false, 0                         , nullptr, nullptr, "Path to a shared library built for the target that provides precompiled versions of the utility functions lldb runs in the process, "
+      "e.g. __lldb_apple_objc_v2_get_dynamic_class_info.  It is loaded into the process the first time a utility function is needed, "
+      "and the functions it exports are called instead of compiling them with the expression parser." },
     { "prefer-dynamic-value"               , OptionValue::eTypeEnum      , false, eDynamicDontRunTarget     , nullptr, g_dynamic_value_types, "Should printed values be shown as their dynamic value." },
     { "enable-synthetic-value"             , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Should synthetic values be used by default whenever available." },
     { "skip-prologue"                      , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Skip function prologues when setting breakpoints by name." },
@@ -3433,10 +4064,18 @@ g_properties[] =
       "Each element of the array is checked in order and the first one that results in a match wins." },
     { "exec-search-paths"                  , OptionValue::eTypeFileSpecList, false, 0                       , nullptr, nullptr, "Executable search paths to use when locating executable files whose paths don't match the local file system." },
     { "debug-file-search-paths"            , OptionValue::eTypeFileSpecList, false, 0                       , nullptr, nullptr, "List of directories to be searched when locating debug symbol files." },
+    { "use-debug-file-index"               , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Find debug symbol files by build ID through an index of the .build-id directories of the debug file search paths. The index is saved in the module cache directory." },
+    { "symbol-server-urls"                 , OptionValue::eTypeArray     , false, OptionValue::eTypeString  , nullptr, nullptr, "A list of debuginfod style symbol server URLs to download debug symbol files from by build ID when they can't be found locally. Downloaded files are kept in the module cache directory." },
+    { "preload-symbols"                    , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Build the symbol tables of new modules on several threads as soon as they are loaded, and index their debug info in the background. "
+      "If false, symbol tables and debug info are only read when a lookup needs them, or up front when breakpoints have to be resolved in the new modules." },
+    { "debug-info-memory-budget"           , OptionValue::eTypeUInt64    , false, 0                         , nullptr, nullptr, "The number of bytes the parsed debug info of the target's modules may use before the line tables and the DWARF DIEs of the modules that no thread is stopped in are released when the process stops. "
+      "They are parsed again when they are needed. Zero means there is no limit." },
     { "clang-module-search-paths"          , OptionValue::eTypeFileSpecList, false, 0                       , nullptr, nullptr, "List of directories to be searched when locating modules for Clang." },
     { "auto-import-clang-modules"          , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Automatically load Clang modules referred to by the program." },
     { "auto-apply-fixits"                  , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Automatically apply fixit hints to expressions." },
     { "notify-about-fixits"                , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Print the fixed expression text." },
+    { "warm-up-expression-parser"          , OptionValue::eTypeBoolean   , false, true                      , nullptr, nullptr, "Set up the expression parser on a background thread when modules are loaded and when the process resumes, "
+      "so that the first expression after a stop doesn't have to." },
     { "max-children-count"                 , OptionValue::eTypeSInt64    , false, 256                       , nullptr, nullptr, "Maximum number of children to expand in any level of depth." },
     { "max-string-summary-length"          , OptionValue::eTypeSInt64    , false, 1024                      , nullptr, nullptr, "Maximum number of characters to show when using %s in summary strings." },
     { "max-memory-read-size"               , OptionValue::eTypeSInt64    , false, 1024                      , nullptr, nullptr, "Maximum number of bytes that 'memory read' will fetch before --force must be specified." },
@@ -3485,16 +4124,22 @@ enum
     ePropertyMoveToNearestCode,
     ePropertyLanguage,
     ePropertyExprPrefix,
+    ePropertyExprHelperLibrary,
     ePropertyPreferDynamic,
     ePropertyEnableSynthetic,
     ePropertySkipPrologue,
     ePropertySourceMap,
     ePropertyExecutableSearchPaths,
     ePropertyDebugFileSearchPaths,
+    ePropertyUseDebugFileIndex,
+    ePropertySymbolServerURLs,
+    ePropertyPreloadSymbols,
+    ePropertyDebugInfoMemoryBudget,
     ePropertyClangModuleSearchPaths,
     ePropertyAutoImportClangModules,
     ePropertyAutoApplyFixIts,
     ePropertyNotifyAboutFixIts,
+    ePropertyWarmUpExpressionParser,
     ePropertyMaxChildrenCount,
     ePropertyMaxSummaryLength,
     ePropertyMaxMemReadSize,
@@ -3851,6 +4496,34 @@ TargetProperties::GetDebugFileSearchPaths ()
     return option_value->GetCurrentValue();
 }
 
+bool
+TargetProperties::GetUseDebugFileIndex () const
+{
+    const uint32_t idx = ePropertyUseDebugFileIndex;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+bool
+TargetProperties::GetPreloadSymbols () const
+{
+    const uint32_t idx = ePropertyPreloadSymbols;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
+uint64_t
+TargetProperties::GetDebugInfoMemoryBudget () const
+{
+    const uint32_t idx = ePropertyDebugInfoMemoryBudget;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64(nullptr, idx, g_properties[idx].default_uint_value);
+}
+
+bool
+TargetProperties::GetSymbolServerURLs (Args &urls) const
+{
+    const uint32_t idx = ePropertySymbolServerURLs;
+    return m_collection_sp->GetPropertyAtIndexAsArgs(nullptr, idx, urls);
+}
+
 FileSpecList &
 TargetProperties::GetClangModuleSearchPaths ()
 {
@@ -3881,6 +4554,13 @@ TargetProperties::GetEnableNotifyAboutFixIts() const
     return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
 }
 
+bool
+TargetProperties::GetWarmUpExpressionParser () const
+{
+    const uint32_t idx = ePropertyWarmUpExpressionParser;
+    return m_collection_sp->GetPropertyAtIndexAsBoolean(nullptr, idx, g_properties[idx].default_uint_value != 0);
+}
+
 bool
 TargetProperties::GetEnableSyntheticValue () const
 {
@@ -3968,6 +4648,13 @@ TargetProperties::GetExpressionPrefixContentsAsCString ()
     return nullptr;
 }
 
+FileSpec
+TargetProperties::GetExpressionHelperLibrary () const
+{
+    const uint32_t idx = ePropertyExprHelperLibrary;
+    return m_collection_sp->GetPropertyAtIndexAsFileSpec(nullptr, idx);
+}
+
 void
 TargetProperties::SetStandardErrorPath (const char *p)
 {
@@ -386,7 +386,8 @@ TargetList::CreateTargetInternal (Debugger &debugger,
                                   lldb::TargetSP &target_sp,
                                   bool is_dummy_target)
 {
-    Timer scoped_timer (__PRETTY_FUNCTION__,
+    static Timer::Category func_cat(__PRETTY_FUNCTION__);
+    Timer scoped_timer (func_cat,
                         "TargetList::CreateTarget (file = '%s', arch = '%s')",
                         user_exe_path,
                         specified_arch.GetArchitectureName());
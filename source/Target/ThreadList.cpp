@@ -336,38 +336,39 @@ ThreadList::ShouldStop (Event *event_ptr)
     // Now we run through all the threads and get their stop info's.  We want to make sure to do this first before
     // we start running the ShouldStop, because one thread's ShouldStop could destroy information (like deleting a
     // thread specific breakpoint another thread had stopped at) which could lead us to compute the StopInfo incorrectly.
-    // We don't need to use it here, we just want to make sure it gets computed.
-    
+    // While we are at it, remember the threads that have a stop reason: Thread::ShouldStop() returns false for all
+    // the others, so with many threads we only need to consult the few interesting ones.
+    collection threads_with_stop_reason;
     for (pos = threads_copy.begin(); pos != end; ++pos)
     {
         ThreadSP thread_sp(*pos);
         thread_sp->GetStopInfo();
+        if (thread_sp->ThreadStoppedForAReason())
+            threads_with_stop_reason.push_back(thread_sp);
     }
-    
-    for (pos = threads_copy.begin(); pos != end; ++pos)
+
+    // We should never get a stop for which no thread had a stop reason, but sometimes we do see this -
+    // for instance when we first connect to a remote stub.  In that case we should stop, since we can't figure out
+    // the right thing to do and stopping gives the user control over what to do in this instance.
+    //
+    // Note, this causes a problem when you have a thread specific breakpoint, and a bunch of threads hit the breakpoint,
+    // but not the thread which we are waiting for.  All the threads that are not "supposed" to hit the breakpoint
+    // are marked as having no stop reason, which is right, they should not show a stop reason.  But that triggers this
+    // code and causes us to stop seemingly for no reason.
+    //
+    // Since the only way we ever saw this error was on first attach, I'm only going to trigger set did_anybody_stop_for_a_reason
+    // to true unless this is the first stop.
+    //
+    // If this becomes a problem, we'll have to have another StopReason like "StopInfoHidden" which will look invalid
+    // everywhere but at this check.
+    if (!threads_copy.empty() && m_process->GetStopID() > 1)
+        did_anybody_stop_for_a_reason = true;
+    else
+        did_anybody_stop_for_a_reason = !threads_with_stop_reason.empty();
+
+    for (pos = threads_with_stop_reason.begin(); pos != threads_with_stop_reason.end(); ++pos)
     {
         ThreadSP thread_sp(*pos);
-        
-        // We should never get a stop for which no thread had a stop reason, but sometimes we do see this -
-        // for instance when we first connect to a remote stub.  In that case we should stop, since we can't figure out
-        // the right thing to do and stopping gives the user control over what to do in this instance.
-        //
-        // Note, this causes a problem when you have a thread specific breakpoint, and a bunch of threads hit the breakpoint,
-        // but not the thread which we are waiting for.  All the threads that are not "supposed" to hit the breakpoint
-        // are marked as having no stop reason, which is right, they should not show a stop reason.  But that triggers this
-        // code and causes us to stop seemingly for no reason.
-        //
-        // Since the only way we ever saw this error was on first attach, I'm only going to trigger set did_anybody_stop_for_a_reason
-        // to true unless this is the first stop.
-        //
-        // If this becomes a problem, we'll have to have another StopReason like "StopInfoHidden" which will look invalid
-        // everywhere but at this check.
-    
-        if (thread_sp->GetProcess()->GetStopID() > 1)
-            did_anybody_stop_for_a_reason = true;
-        else
-            did_anybody_stop_for_a_reason |= thread_sp->ThreadStoppedForAReason();
-        
         const bool thread_should_stop = thread_sp->ShouldStop(event_ptr);
         if (thread_should_stop)
             should_stop |= true;
@@ -534,6 +535,10 @@ ThreadList::RefreshStateAfterStop ()
     collection::iterator pos, end = m_threads.end();
     for (pos = m_threads.begin(); pos != end; ++pos)
         (*pos)->RefreshStateAfterStop ();
+
+    // Get a thread that was stepping out of line back to where it belongs
+    // before anybody looks at its PC.
+    m_process->FinishDisplacedStep ();
 }
 
 void
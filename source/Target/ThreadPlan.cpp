@@ -19,6 +19,7 @@
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
+#include "lldb/Target/Unwind.h"
 #include "lldb/Utility/ConvertEnum.h"
 
 using namespace lldb;
@@ -214,6 +215,17 @@ ThreadPlan::IsUsuallyUnexplainedStopReason(lldb::StopReason reason)
     }
 }
 
+bool
+ThreadPlan::GetFrameZeroCFA (lldb::addr_t &cfa)
+{
+    cfa = LLDB_INVALID_ADDRESS;
+    Unwind *unwinder = m_thread.GetUnwinder();
+    if (unwinder == nullptr)
+        return false;
+    lldb::addr_t pc = LLDB_INVALID_ADDRESS;
+    return unwinder->GetFrameInfoAtIndex(0, cfa, pc);
+}
+
 //----------------------------------------------------------------------
 // ThreadPlanNull
 //----------------------------------------------------------------------
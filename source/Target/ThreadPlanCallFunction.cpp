@@ -143,6 +143,7 @@ ThreadPlanCallFunction::ThreadPlanCallFunction (Thread &thread,
     m_ignore_breakpoints (options.DoesIgnoreBreakpoints()),
     m_debug_execution (options.GetDebug()),
     m_trap_exceptions (options.GetTrapExceptions()),
+    m_light_call (options.GetLightCall()),
     m_function_addr (function),
     m_function_sp (0),
     m_takedown_done (false),
@@ -180,6 +181,7 @@ ThreadPlanCallFunction::ThreadPlanCallFunction(Thread &thread,
     m_ignore_breakpoints(options.DoesIgnoreBreakpoints()),
     m_debug_execution(options.GetDebug()),
     m_trap_exceptions(options.GetTrapExceptions()),
+    m_light_call(options.GetLightCall()),
     m_function_addr(function),
     m_function_sp(0),
     m_takedown_done(false),
@@ -341,6 +343,17 @@ ThreadPlanCallFunction::DoPlanExplainsStop (Event *event_ptr)
     if (log)
         log->Printf ("ThreadPlanCallFunction::PlanExplainsStop: Got stop reason - %s.", Thread::StopReasonAsCString(stop_reason));
 
+    // Light calls don't have a subplan, they are done when the thread is back
+    // at the return address.
+    if (m_light_call && !m_subplan_sp && stop_reason == eStopReasonBreakpoint &&
+        m_thread.GetRegisterContext()->GetPC() == m_start_addr.GetLoadAddress(&GetTarget()))
+    {
+        if (log)
+            log->Printf ("ThreadPlanCallFunction::PlanExplainsStop: light call returned, setting plan complete.");
+        SetPlanComplete();
+        return true;
+    }
+
     if (stop_reason == eStopReasonBreakpoint && BreakpointsExplainStop())
         return true;
     
@@ -468,6 +481,11 @@ ThreadPlanCallFunction::DidPush ()
     GetThread().SetStopInfoToNothing();
     
 #ifndef SINGLE_STEP_EXPRESSIONS
+    // Light calls return to a breakpoint the target keeps around, if it
+    // can't be set fall back to running to the address.
+    if (m_light_call && GetTarget().GetFunctionCallReturnBreakpoint(m_start_addr))
+        return;
+
     m_subplan_sp.reset(new ThreadPlanRunToAddress(m_thread, m_start_addr, m_stop_other_threads));
     
     m_thread.QueueThreadPlan(m_subplan_sp, false);
@@ -566,7 +584,9 @@ ThreadPlanCallFunction::BreakpointsExplainStop()
 void
 ThreadPlanCallFunction::SetStopOthers (bool new_value)
 {
-    m_subplan_sp->SetStopOthers(new_value);
+    m_stop_other_threads = new_value;
+    if (m_subplan_sp)
+        m_subplan_sp->SetStopOthers(new_value);
 }
 
 bool
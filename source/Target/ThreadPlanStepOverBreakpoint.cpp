@@ -10,17 +10,80 @@
 #include "lldb/Target/ThreadPlanStepOverBreakpoint.h"
 
 // C Includes
+#include <string.h>
+
 // C++ Includes
+#include <memory>
+
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Disassembler.h"
+#include "lldb/Core/EmulateInstruction.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+namespace
+{
+    // Callbacks for a dry run of the emulator: reads come from the thread,
+    // writes are dropped, and any access to the PC is noted.
+    struct DisplacedStepEmulationBaton
+    {
+        Process *process;
+        RegisterContext *reg_ctx;
+        bool uses_pc;
+    };
+
+    bool
+    IsPCRegister (const RegisterInfo *reg_info)
+    {
+        return reg_info->kinds[eRegisterKindGeneric] == LLDB_REGNUM_GENERIC_PC;
+    }
+
+    size_t
+    DryRunReadMemory (EmulateInstruction *instruction, void *baton, const EmulateInstruction::Context &context,
+                      addr_t addr, void *dst, size_t length)
+    {
+        Error error;
+        return static_cast<DisplacedStepEmulationBaton *>(baton)->process->ReadMemory(addr, dst, length, error);
+    }
+
+    size_t
+    DryRunWriteMemory (EmulateInstruction *instruction, void *baton, const EmulateInstruction::Context &context,
+                       addr_t addr, const void *dst, size_t length)
+    {
+        return length;
+    }
+
+    bool
+    DryRunReadRegister (EmulateInstruction *instruction, void *baton, const RegisterInfo *reg_info,
+                        RegisterValue &reg_value)
+    {
+        DisplacedStepEmulationBaton *dry_run = static_cast<DisplacedStepEmulationBaton *>(baton);
+        if (IsPCRegister(reg_info))
+            dry_run->uses_pc = true;
+        const RegisterInfo *thread_reg_info = dry_run->reg_ctx->GetRegisterInfoByName(reg_info->name);
+        return thread_reg_info && dry_run->reg_ctx->ReadRegister(thread_reg_info, reg_value);
+    }
+
+    bool
+    DryRunWriteRegister (EmulateInstruction *instruction, void *baton, const EmulateInstruction::Context &context,
+                         const RegisterInfo *reg_info, const RegisterValue &reg_value)
+    {
+        if (IsPCRegister(reg_info))
+            static_cast<DisplacedStepEmulationBaton *>(baton)->uses_pc = true;
+        return true;
+    }
+}
+
 //----------------------------------------------------------------------
 // ThreadPlanStepOverBreakpoint: Single steps over a breakpoint bp_site_sp at the pc.
 //----------------------------------------------------------------------
@@ -34,17 +97,87 @@ ThreadPlanStepOverBreakpoint::ThreadPlanStepOverBreakpoint (Thread &thread) :
                             // over a breakpoint
     m_breakpoint_addr (LLDB_INVALID_ADDRESS),
     m_auto_continue(false),
-    m_reenabled_breakpoint_site (false)
+    m_reenabled_breakpoint_site (false),
+    m_use_displaced_step (false),
+    m_displaced_opcode ()
 
 {
     m_breakpoint_addr = m_thread.GetRegisterContext()->GetPC();
     m_breakpoint_site_id =  m_thread.GetProcess()->GetBreakpointSiteList().FindIDByAddress (m_breakpoint_addr);
+
+    // Decide now since StopOthers() is asked before we get to resume.
+    if (GetDisplaceableOpcode (m_displaced_opcode))
+        m_use_displaced_step = m_thread.GetProcess()->ReserveDisplacedStep (m_thread.GetID(), m_displaced_opcode.size());
 }
 
 ThreadPlanStepOverBreakpoint::~ThreadPlanStepOverBreakpoint ()
 {
 }
 
+bool
+ThreadPlanStepOverBreakpoint::GetDisplaceableOpcode (std::vector<uint8_t> &opcode)
+{
+    ProcessSP process_sp (m_thread.GetProcess());
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+    if (!process_sp || !reg_ctx_sp || !process_sp->GetDisplacedStepping())
+        return false;
+
+    // Running ARM code out of line would need the Thumb state and IT blocks
+    // to be handled.
+    const ArchSpec &arch = process_sp->GetTarget().GetArchitecture();
+    const llvm::Triple::ArchType machine = arch.GetMachine();
+    if (machine == llvm::Triple::arm || machine == llvm::Triple::armeb ||
+        machine == llvm::Triple::thumb || machine == llvm::Triple::thumbeb)
+        return false;
+
+    // Reading memory gives us the original instruction, not the trap.
+    uint8_t bytes[16];
+    Error error;
+    const size_t bytes_read = process_sp->ReadMemory (m_breakpoint_addr, bytes, sizeof(bytes), error);
+    if (bytes_read == 0)
+        return false;
+
+    DisassemblerSP disassembler_sp (Disassembler::FindPlugin (arch, nullptr, nullptr));
+    if (!disassembler_sp)
+        return false;
+    DataExtractor data (bytes, bytes_read, arch.GetByteOrder(), arch.GetAddressByteSize());
+    disassembler_sp->DecodeInstructions (Address (m_breakpoint_addr), data, 0, 1, false, false);
+    InstructionSP insn_sp (disassembler_sp->GetInstructionList().GetInstructionAtIndex (0));
+    if (!insn_sp || insn_sp->DoesBranch() || insn_sp->HasDelaySlot())
+        return false;
+    const size_t insn_size = insn_sp->GetOpcode().GetByteSize();
+    if (insn_size == 0 || insn_size > bytes_read)
+        return false;
+
+    // Instructions that use the PC can't run anywhere else. Ask the emulator
+    // where there is one, it knows exactly which registers an instruction
+    // touches. There is no x86 emulator, but there the only PC relative
+    // operands are RIP relative memory operands.
+    std::unique_ptr<EmulateInstruction> emulator_ap (EmulateInstruction::FindPlugin (arch, eInstructionTypeAny, nullptr));
+    if (emulator_ap)
+    {
+        DisplacedStepEmulationBaton baton = { process_sp.get(), reg_ctx_sp.get(), false };
+        emulator_ap->SetBaton (&baton);
+        emulator_ap->SetCallbacks (DryRunReadMemory, DryRunWriteMemory, DryRunReadRegister, DryRunWriteRegister);
+        if (!emulator_ap->SetInstruction (insn_sp->GetOpcode(), Address (m_breakpoint_addr), nullptr) ||
+            !emulator_ap->EvaluateInstruction (eEmulateInstructionOptionIgnoreConditions) ||
+            baton.uses_pc)
+            return false;
+    }
+    else if (machine == llvm::Triple::x86 || machine == llvm::Triple::x86_64)
+    {
+        ExecutionContext exe_ctx (m_thread.shared_from_this());
+        const char *operands = insn_sp->GetOperands (&exe_ctx);
+        if (operands && ::strstr (operands, "rip"))
+            return false;
+    }
+    else
+        return false;
+
+    opcode.assign (bytes, bytes + insn_size);
+    return true;
+}
+
 void
 ThreadPlanStepOverBreakpoint::GetDescription (Stream *s, lldb::DescriptionLevel level)
 {
@@ -103,7 +236,8 @@ ThreadPlanStepOverBreakpoint::ShouldStop (Event *event_ptr)
 bool
 ThreadPlanStepOverBreakpoint::StopOthers ()
 {
-    return true;
+    // The other threads can't miss the breakpoint if it stays inserted.
+    return !m_use_displaced_step;
 }
 
 StateType
@@ -117,6 +251,20 @@ ThreadPlanStepOverBreakpoint::DoWillResume (StateType resume_state, bool current
 {
     if (current_plan)
     {
+        if (m_use_displaced_step)
+        {
+            Error error = m_thread.GetProcess()->BeginDisplacedStep (m_thread, m_breakpoint_addr, m_displaced_opcode);
+            if (error.Success())
+                return true;
+
+            // Fall back to lifting the breakpoint. The other threads are
+            // already going to run, so they may miss it this once.
+            Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+            if (log)
+                log->Printf("Displaced step over breakpoint at 0x%" PRIx64 " failed: %s", (uint64_t)m_breakpoint_addr, error.AsCString());
+            ReleaseDisplacedStep ();
+        }
+
         BreakpointSiteSP bp_site_sp (m_thread.GetProcess()->GetBreakpointSiteList().FindByAddress (m_breakpoint_addr));
         if (bp_site_sp  && bp_site_sp->IsEnabled())
             m_thread.GetProcess()->DisableBreakpointSite (bp_site_sp.get());
@@ -149,6 +297,7 @@ ThreadPlanStepOverBreakpoint::MischiefManaged ()
             log->Printf("Completed step over breakpoint plan.");
         // Otherwise, re-enable the breakpoint we were stepping over, and we're done.
         ReenableBreakpointSite ();
+        ReleaseDisplacedStep ();
         ThreadPlan::MischiefManaged ();
         return true;
     }
@@ -157,6 +306,10 @@ ThreadPlanStepOverBreakpoint::MischiefManaged ()
 void
 ThreadPlanStepOverBreakpoint::ReenableBreakpointSite ()
 {
+    // A displaced step never lifted the breakpoint.
+    if (m_use_displaced_step)
+        return;
+
     if (!m_reenabled_breakpoint_site)
     {
         m_reenabled_breakpoint_site = true;
@@ -167,10 +320,27 @@ ThreadPlanStepOverBreakpoint::ReenableBreakpointSite ()
         }
     }
 }
+void
+ThreadPlanStepOverBreakpoint::WillPop ()
+{
+    ReleaseDisplacedStep ();
+}
+
 void
 ThreadPlanStepOverBreakpoint::ThreadDestroyed ()
 {
     ReenableBreakpointSite ();
+    ReleaseDisplacedStep ();
+}
+
+void
+ThreadPlanStepOverBreakpoint::ReleaseDisplacedStep ()
+{
+    if (m_use_displaced_step)
+    {
+        m_use_displaced_step = false;
+        m_thread.GetProcess()->ReleaseDisplacedStep (m_thread.GetID());
+    }
 }
 
 void
@@ -143,6 +143,14 @@ ThreadPlanStepOverRange::ShouldStop (Event *event_ptr)
         log->Printf("ThreadPlanStepOverRange reached %s.", s.GetData());
     }
     
+    // Most stops are still in the range of the frame we started in, keep
+    // going without making stack frames or resolving symbol contexts.
+    if (InRangeOfStartFrame())
+    {
+        SetNextBranchBreakpoint();
+        return false;
+    }
+
     // If we're out of the range but in the same frame or in our caller's frame
     // then we should stop.
     // When stepping out we only stop others if we are forcing running one thread.
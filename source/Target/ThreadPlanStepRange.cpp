@@ -131,6 +131,24 @@ ThreadPlanStepRange::DumpRanges(Stream *s)
     }
 }
 
+bool
+ThreadPlanStepRange::GetSteppingRange (lldb::addr_t &start, lldb::addr_t &end)
+{
+    Target *target = m_thread.CalculateTarget().get();
+    lldb::addr_t pc_load_addr = m_thread.GetRegisterContext()->GetPC();
+
+    for (const AddressRange &range : m_address_ranges)
+    {
+        if (range.ContainsLoadAddress(pc_load_addr, target))
+        {
+            start = range.GetBaseAddress().GetLoadAddress(target);
+            end = start + range.GetByteSize();
+            return start != LLDB_INVALID_ADDRESS;
+        }
+    }
+    return false;
+}
+
 bool
 ThreadPlanStepRange::InRange ()
 {
@@ -246,6 +264,34 @@ ThreadPlanStepRange::InSymbol()
     return false;
 }
 
+bool
+ThreadPlanStepRange::InRangeOfStartFrame ()
+{
+    if (!m_stack_id.IsValid())
+        return false;
+
+    lldb::addr_t pc_load_addr = m_thread.GetRegisterContext()->GetPC();
+    Target *target = m_thread.CalculateTarget().get();
+    bool in_range = false;
+    for (const AddressRange &range : m_address_ranges)
+    {
+        if (range.ContainsLoadAddress(pc_load_addr, target))
+        {
+            in_range = true;
+            break;
+        }
+    }
+    if (!in_range)
+        return false;
+
+    // Every frame that can have this pc in its range and the same CFA is
+    // the frame we started in, a recursive call would have a younger CFA.
+    lldb::addr_t cfa = LLDB_INVALID_ADDRESS;
+    if (!GetFrameZeroCFA(cfa))
+        return false;
+    return cfa == m_stack_id.GetCallFrameAddress();
+}
+
 // FIXME: This should also handle inlining if we aren't going to do inlining in the
 // main stack.
 //
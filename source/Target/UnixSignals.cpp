@@ -71,13 +71,15 @@ UnixSignals::Create(const ArchSpec &arch)
 //----------------------------------------------------------------------
 // UnixSignals constructor
 //----------------------------------------------------------------------
-UnixSignals::UnixSignals ()
+UnixSignals::UnixSignals () :
+    m_version (0)
 {
     Reset ();
 }
 
 UnixSignals::UnixSignals(const UnixSignals &rhs)
-    : m_signals(rhs.m_signals)
+    : m_signals(rhs.m_signals),
+      m_version(rhs.m_version)
 {
 }
 
@@ -136,6 +138,7 @@ UnixSignals::AddSignal(int signo,
 {
     Signal new_signal (name, default_suppress, default_stop, default_notify, description, alias);
     m_signals.insert (std::make_pair(signo, new_signal));
+    ++m_version;
 }
 
 void
@@ -143,7 +146,10 @@ UnixSignals::RemoveSignal (int signo)
 {
     collection::iterator pos = m_signals.find (signo);
     if (pos != m_signals.end())
+    {
         m_signals.erase (pos);
+        ++m_version;
+    }
 }
 
 const char *
@@ -253,6 +259,7 @@ UnixSignals::SetShouldSuppress (int signo, bool value)
     if (pos != m_signals.end())
     {
         pos->second.m_suppress = value;
+        ++m_version;
         return true;
     }
     return false;
@@ -283,6 +290,7 @@ UnixSignals::SetShouldStop (int signo, bool value)
     if (pos != m_signals.end())
     {
         pos->second.m_stop = value;
+        ++m_version;
         return true;
     }
     return false;
@@ -313,6 +321,7 @@ UnixSignals::SetShouldNotify (int signo, bool value)
     if (pos != m_signals.end())
     {
         pos->second.m_notify = value;
+        ++m_version;
         return true;
     }
     return false;
@@ -342,3 +351,16 @@ UnixSignals::GetSignalAtIndex(int32_t index) const
     std::advance(it, index);
     return it->first;
 }
+
+std::vector<int32_t>
+UnixSignals::GetFilteredSignals (bool should_suppress, bool should_stop, bool should_notify) const
+{
+    std::vector<int32_t> signals;
+    for (const auto &entry : m_signals)
+    {
+        const Signal &signal = entry.second;
+        if (signal.m_suppress == should_suppress && signal.m_stop == should_stop && signal.m_notify == should_notify)
+            signals.push_back (entry.first);
+    }
+    return signals;
+}
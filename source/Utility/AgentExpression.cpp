@@ -0,0 +1,331 @@
+//===-- AgentExpression.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <inttypes.h>
+
+// C++ Includes
+#include <utility>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Utility/AgentExpression.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Keep a looping or runaway expression from hanging the stub.
+    const size_t k_max_stack_depth = 1024;
+    const size_t k_max_executed_opcodes = 100000;
+
+    uint64_t
+    SignExtend (uint64_t value, uint32_t bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        const uint64_t sign_bit = 1ull << (bits - 1);
+        value &= (sign_bit << 1) - 1;
+        return (value ^ sign_bit) - sign_bit;
+    }
+
+    uint64_t
+    ZeroExtend (uint64_t value, uint32_t bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        return value & ((1ull << bits) - 1);
+    }
+}
+
+AgentExpression::AgentExpression () :
+    m_bytes()
+{
+}
+
+AgentExpression::AgentExpression (const uint8_t *bytes, size_t length) :
+    m_bytes(bytes, bytes + length)
+{
+}
+
+void
+AgentExpression::AppendOpcode (Opcode opcode)
+{
+    m_bytes.push_back(opcode);
+}
+
+void
+AgentExpression::AppendOpcode (Opcode opcode, uint8_t operand)
+{
+    m_bytes.push_back(opcode);
+    m_bytes.push_back(operand);
+}
+
+void
+AgentExpression::AppendConstant (uint64_t value)
+{
+    // The operands are big endian and zero extended when pushed.
+    size_t size;
+    if (value <= UINT8_MAX)
+    {
+        m_bytes.push_back(eOpcodeConst8);
+        size = 1;
+    }
+    else if (value <= UINT16_MAX)
+    {
+        m_bytes.push_back(eOpcodeConst16);
+        size = 2;
+    }
+    else if (value <= UINT32_MAX)
+    {
+        m_bytes.push_back(eOpcodeConst32);
+        size = 4;
+    }
+    else
+    {
+        m_bytes.push_back(eOpcodeConst64);
+        size = 8;
+    }
+
+    for (size_t i = size; i > 0; --i)
+        m_bytes.push_back((value >> ((i - 1) * 8)) & 0xff);
+}
+
+void
+AgentExpression::AppendRegister (uint32_t reg_num)
+{
+    m_bytes.push_back(eOpcodeReg);
+    m_bytes.push_back((reg_num >> 8) & 0xff);
+    m_bytes.push_back(reg_num & 0xff);
+}
+
+Error
+AgentExpression::Evaluate (const ReadRegisterCallback &read_register,
+                           const ReadMemoryCallback &read_memory,
+                           uint64_t &result) const
+{
+    std::vector<uint64_t> stack;
+    size_t pc = 0;
+    const size_t length = m_bytes.size();
+
+    // Reads a big endian operand of "size" bytes following the opcode.
+    auto read_operand = [this, &pc, length](size_t size, uint64_t &value) -> bool
+    {
+        if (pc + size > length)
+            return false;
+        value = 0;
+        for (size_t i = 0; i < size; ++i)
+            value = (value << 8) | m_bytes[pc++];
+        return true;
+    };
+
+    for (size_t executed = 0; executed < k_max_executed_opcodes; ++executed)
+    {
+        if (pc >= length)
+            return Error("agent expression ends without an end opcode");
+
+        const size_t opcode_offset = pc;
+        const uint8_t opcode = m_bytes[pc++];
+
+        // Check that the stack holds enough operands for the opcode.
+        size_t needed = 0;
+        switch (opcode)
+        {
+            case eOpcodeAdd:        case eOpcodeSub:          case eOpcodeMul:
+            case eOpcodeDivSigned:  case eOpcodeDivUnsigned:  case eOpcodeRemSigned:
+            case eOpcodeRemUnsigned:case eOpcodeLsh:          case eOpcodeRshSigned:
+            case eOpcodeRshUnsigned:case eOpcodeBitAnd:       case eOpcodeBitOr:
+            case eOpcodeBitXor:     case eOpcodeEqual:        case eOpcodeLessSigned:
+            case eOpcodeLessUnsigned: case eOpcodeSwap:
+                needed = 2;
+                break;
+            case eOpcodeRot:
+                needed = 3;
+                break;
+            case eOpcodeLogNot:     case eOpcodeBitNot:       case eOpcodeExt:
+            case eOpcodeZeroExt:    case eOpcodeRef8:         case eOpcodeRef16:
+            case eOpcodeRef32:      case eOpcodeRef64:        case eOpcodeIfGoto:
+            case eOpcodeEnd:        case eOpcodeDup:          case eOpcodePop:
+                needed = 1;
+                break;
+            default:
+                break;
+        }
+        if (stack.size() < needed)
+            return Error("agent expression stack underflow at offset %" PRIu64, (uint64_t)opcode_offset);
+
+        uint64_t operand = 0;
+        switch (opcode)
+        {
+            case eOpcodeAdd:
+            case eOpcodeSub:
+            case eOpcodeMul:
+            case eOpcodeDivSigned:
+            case eOpcodeDivUnsigned:
+            case eOpcodeRemSigned:
+            case eOpcodeRemUnsigned:
+            case eOpcodeLsh:
+            case eOpcodeRshSigned:
+            case eOpcodeRshUnsigned:
+            case eOpcodeBitAnd:
+            case eOpcodeBitOr:
+            case eOpcodeBitXor:
+            case eOpcodeEqual:
+            case eOpcodeLessSigned:
+            case eOpcodeLessUnsigned:
+            {
+                const uint64_t b = stack.back();
+                stack.pop_back();
+                const uint64_t a = stack.back();
+                uint64_t value = 0;
+                switch (opcode)
+                {
+                    case eOpcodeAdd:            value = a + b; break;
+                    case eOpcodeSub:            value = a - b; break;
+                    case eOpcodeMul:            value = a * b; break;
+                    case eOpcodeLsh:            value = b < 64 ? a << b : 0; break;
+                    case eOpcodeRshSigned:      value = (uint64_t)((int64_t)a >> (b < 64 ? b : 63)); break;
+                    case eOpcodeRshUnsigned:    value = b < 64 ? a >> b : 0; break;
+                    case eOpcodeBitAnd:         value = a & b; break;
+                    case eOpcodeBitOr:          value = a | b; break;
+                    case eOpcodeBitXor:         value = a ^ b; break;
+                    case eOpcodeEqual:          value = a == b; break;
+                    case eOpcodeLessSigned:     value = (int64_t)a < (int64_t)b; break;
+                    case eOpcodeLessUnsigned:   value = a < b; break;
+                    default:
+                        if (b == 0)
+                            return Error("agent expression divides by zero at offset %" PRIu64, (uint64_t)opcode_offset);
+                        if (opcode == eOpcodeDivSigned)
+                            value = (uint64_t)((int64_t)a / (int64_t)b);
+                        else if (opcode == eOpcodeDivUnsigned)
+                            value = a / b;
+                        else if (opcode == eOpcodeRemSigned)
+                            value = (uint64_t)((int64_t)a % (int64_t)b);
+                        else
+                            value = a % b;
+                        break;
+                }
+                stack.back() = value;
+                break;
+            }
+
+            case eOpcodeLogNot:
+                stack.back() = stack.back() == 0;
+                break;
+
+            case eOpcodeBitNot:
+                stack.back() = ~stack.back();
+                break;
+
+            case eOpcodeExt:
+            case eOpcodeZeroExt:
+                if (!read_operand(1, operand))
+                    return Error("agent expression truncated at offset %" PRIu64, (uint64_t)opcode_offset);
+                if (opcode == eOpcodeExt)
+                    stack.back() = SignExtend(stack.back(), operand);
+                else
+                    stack.back() = ZeroExtend(stack.back(), operand);
+                break;
+
+            case eOpcodeRef8:
+            case eOpcodeRef16:
+            case eOpcodeRef32:
+            case eOpcodeRef64:
+            {
+                const size_t size = 1u << (opcode - eOpcodeRef8);
+                uint64_t value = 0;
+                if (!read_memory || !read_memory(stack.back(), size, value))
+                    return Error("agent expression failed to read %" PRIu64 " bytes at 0x%" PRIx64, (uint64_t)size, stack.back());
+                stack.back() = value;
+                break;
+            }
+
+            case eOpcodeIfGoto:
+            case eOpcodeGoto:
+            {
+                if (!read_operand(2, operand))
+                    return Error("agent expression truncated at offset %" PRIu64, (uint64_t)opcode_offset);
+                bool jump = true;
+                if (opcode == eOpcodeIfGoto)
+                {
+                    jump = stack.back() != 0;
+                    stack.pop_back();
+                }
+                if (jump)
+                {
+                    if (operand >= length)
+                        return Error("agent expression jumps out of bounds at offset %" PRIu64, (uint64_t)opcode_offset);
+                    pc = operand;
+                }
+                break;
+            }
+
+            case eOpcodeConst8:
+            case eOpcodeConst16:
+            case eOpcodeConst32:
+            case eOpcodeConst64:
+                if (!read_operand(1u << (opcode - eOpcodeConst8), operand))
+                    return Error("agent expression truncated at offset %" PRIu64, (uint64_t)opcode_offset);
+                stack.push_back(operand);
+                break;
+
+            case eOpcodeReg:
+            {
+                if (!read_operand(2, operand))
+                    return Error("agent expression truncated at offset %" PRIu64, (uint64_t)opcode_offset);
+                uint64_t value = 0;
+                if (!read_register || !read_register(operand, value))
+                    return Error("agent expression failed to read register %" PRIu64, operand);
+                stack.push_back(value);
+                break;
+            }
+
+            case eOpcodeEnd:
+                result = stack.back();
+                return Error();
+
+            case eOpcodeDup:
+                stack.push_back(stack.back());
+                break;
+
+            case eOpcodePop:
+                stack.pop_back();
+                break;
+
+            case eOpcodeSwap:
+                std::swap(stack[stack.size() - 1], stack[stack.size() - 2]);
+                break;
+
+            case eOpcodePick:
+                if (!read_operand(1, operand))
+                    return Error("agent expression truncated at offset %" PRIu64, (uint64_t)opcode_offset);
+                if (operand >= stack.size())
+                    return Error("agent expression stack underflow at offset %" PRIu64, (uint64_t)opcode_offset);
+                stack.push_back(stack[stack.size() - 1 - operand]);
+                break;
+
+            case eOpcodeRot:
+            {
+                // a b c => c b a
+                const size_t n = stack.size();
+                std::swap(stack[n - 1], stack[n - 3]);
+                break;
+            }
+
+            default:
+                return Error("unsupported agent expression opcode 0x%2.2x at offset %" PRIu64, opcode, (uint64_t)opcode_offset);
+        }
+
+        if (stack.size() > k_max_stack_depth)
+            return Error("agent expression stack overflow");
+    }
+
+    return Error("agent expression did not terminate");
+}
@@ -0,0 +1,243 @@
+//===-- CRC32.cpp -----------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/CRC32.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__ARM_FEATURE_CRC32) && !defined(__ARM_BIG_ENDIAN)
+#include <arm_acle.h>
+#define LLDB_CRC32_USE_ARM_CRC 1
+#endif
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Utility/TaskPool.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // The reflected polynomial of CRC-32.
+    const uint32_t g_polynomial = 0xedb88320;
+
+    // Blocks at least this big are checksummed in parallel, in chunks of
+    // this size.
+    const size_t g_min_parallel_length = 16 * 1024 * 1024;
+    const size_t g_parallel_chunk_length = 4 * 1024 * 1024;
+
+#if !defined(LLDB_CRC32_USE_ARM_CRC)
+    //------------------------------------------------------------------
+    // The tables to process 8 bytes per step ("slice-by-8"): table[0] is
+    // the usual table of a byte at a time, table[k] gives the effect on
+    // the crc of a byte that is followed by k more bytes.
+    //------------------------------------------------------------------
+    struct CRC32Tables
+    {
+        uint32_t table[8][256];
+
+        CRC32Tables()
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+            {
+                uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit)
+                    crc = (crc & 1) ? (crc >> 1) ^ g_polynomial : crc >> 1;
+                table[0][i] = crc;
+            }
+            for (uint32_t i = 0; i < 256; ++i)
+                for (int k = 1; k < 8; ++k)
+                    table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xff];
+        }
+    };
+
+    const CRC32Tables &
+    GetTables ()
+    {
+        static const CRC32Tables g_tables;
+        return g_tables;
+    }
+
+    // The input is read as little endian words whatever the host is.
+    inline uint32_t
+    Read32 (const uint8_t *p)
+    {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+#endif
+
+    struct ParallelState
+    {
+        ParallelState (const uint8_t *d, size_t len) :
+            data(d),
+            length(len),
+            num_chunks((len + g_parallel_chunk_length - 1) / g_parallel_chunk_length),
+            next_chunk(0),
+            crcs(num_chunks, 0),
+            num_done(0)
+        {
+        }
+
+        const uint8_t *data;
+        const size_t length;
+        const size_t num_chunks;
+        std::atomic<size_t> next_chunk;
+        std::vector<uint32_t> crcs;
+        std::mutex mutex;
+        std::condition_variable done_cond;
+        size_t num_done;
+    };
+
+    // Checksum chunks until there are none left. The caller runs this too,
+    // so it never waits for a task that hasn't been started, and tasks that
+    // start after all chunks are taken don't look at the data.
+    void
+    RunChunks (ParallelState &state)
+    {
+        size_t idx;
+        while ((idx = state.next_chunk++) < state.num_chunks)
+        {
+            const size_t offset = idx * g_parallel_chunk_length;
+            const size_t length = std::min(g_parallel_chunk_length, state.length - offset);
+            state.crcs[idx] = CRC32(0, state.data + offset, length);
+
+            std::lock_guard<std::mutex> guard(state.mutex);
+            if (++state.num_done == state.num_chunks)
+                state.done_cond.notify_all();
+        }
+    }
+
+    // Multiply the 32x32 matrix over GF(2) by a vector.
+    uint32_t
+    MatrixTimes (const uint32_t *matrix, uint32_t vector)
+    {
+        uint32_t sum = 0;
+        for (; vector; vector >>= 1, ++matrix)
+            if (vector & 1)
+                sum ^= *matrix;
+        return sum;
+    }
+
+    void
+    MatrixSquare (uint32_t *square, const uint32_t *matrix)
+    {
+        for (int n = 0; n < 32; ++n)
+            square[n] = MatrixTimes(matrix, matrix[n]);
+    }
+}
+
+uint32_t
+lldb_private::CRC32 (uint32_t crc, const void *data, size_t length)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+
+#if defined(LLDB_CRC32_USE_ARM_CRC)
+    // The ARMv8 CRC32 instructions use the CRC-32 polynomial.
+    for (; length >= 8; p += 8, length -= 8)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        crc = __crc32d(crc, value);
+    }
+    for (; length; ++p, --length)
+        crc = __crc32b(crc, *p);
+#else
+    const CRC32Tables &tables = GetTables();
+    const uint32_t (*t)[256] = tables.table;
+    for (; length >= 8; p += 8, length -= 8)
+    {
+        const uint32_t one = Read32(p) ^ crc;
+        const uint32_t two = Read32(p + 4);
+        crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^ t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+              t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^ t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+    }
+    for (; length; ++p, --length)
+        crc = t[0][(crc ^ *p) & 0xff] ^ (crc >> 8);
+#endif
+
+    return ~crc;
+}
+
+uint32_t
+lldb_private::CRC32Combine (uint32_t crc1, uint32_t crc2, uint64_t length2)
+{
+    // This is the method of zlib's crc32_combine(): appending length2 zero
+    // bytes to the first block is a linear operation on its crc, applied
+    // by squaring the operator for one zero bit for each bit of length2.
+    if (length2 == 0)
+        return crc1;
+
+    uint32_t even[32]; // operator for an even power of two zero bits
+    uint32_t odd[32];  // operator for an odd power of two zero bits
+
+    odd[0] = g_polynomial;
+    uint32_t row = 1;
+    for (int n = 1; n < 32; ++n)
+    {
+        odd[n] = row;
+        row <<= 1;
+    }
+
+    MatrixSquare(even, odd); // two zero bits
+    MatrixSquare(odd, even); // four zero bits
+
+    do
+    {
+        // The first square gives the operator for one zero byte
+        MatrixSquare(even, odd);
+        if (length2 & 1)
+            crc1 = MatrixTimes(even, crc1);
+        length2 >>= 1;
+        if (length2 == 0)
+            break;
+
+        MatrixSquare(odd, even);
+        if (length2 & 1)
+            crc1 = MatrixTimes(odd, crc1);
+        length2 >>= 1;
+    } while (length2 != 0);
+
+    return crc1 ^ crc2;
+}
+
+uint32_t
+lldb_private::CRC32Parallel (uint32_t crc, const void *data, size_t length)
+{
+    if (length < g_min_parallel_length)
+        return CRC32(crc, data, length);
+
+    auto state = std::make_shared<ParallelState>(static_cast<const uint8_t *>(data), length);
+    const size_t num_tasks = std::min<size_t>(state->num_chunks, std::max(1u, std::thread::hardware_concurrency())) - 1;
+    for (size_t i = 0; i < num_tasks; ++i)
+        TaskPool::AddTask([state]() { RunChunks(*state); });
+    RunChunks(*state);
+
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->done_cond.wait(lock, [&state]() { return state->num_done == state->num_chunks; });
+    }
+
+    for (size_t idx = 0; idx < state->num_chunks; ++idx)
+    {
+        const size_t offset = idx * g_parallel_chunk_length;
+        crc = CRC32Combine(crc, state->crcs[idx], std::min(g_parallel_chunk_length, length - offset));
+    }
+    return crc;
+}
@@ -0,0 +1,183 @@
+//===-- HexEncoding.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <stdint.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Utility/HexEncoding.h"
+
+using namespace lldb_private;
+
+static const char g_hex_chars[] = "0123456789abcdef";
+
+static inline int
+HexDigitValue (char ch)
+{
+    if (ch >= '0' && ch <= '9')
+        return ch - '0';
+    if (ch >= 'a' && ch <= 'f')
+        return 10 + ch - 'a';
+    if (ch >= 'A' && ch <= 'F')
+        return 10 + ch - 'A';
+    return -1;
+}
+
+#if defined(__SSE2__)
+
+// Turns 16 nibbles into their hex digits: '0' + n, plus 39 more to get
+// from ':' to 'a' for values above 9.
+static inline __m128i
+NibblesToHexDigits (__m128i nibbles)
+{
+    const __m128i above_nine = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+    return _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')),
+                        _mm_and_si128(above_nine, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+static inline void
+EncodeBlock (const uint8_t *src, char *dst)
+{
+    const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+    const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+    const __m128i hi = NibblesToHexDigits(_mm_and_si128(_mm_srli_epi16(bytes, 4), nibble_mask));
+    const __m128i lo = NibblesToHexDigits(_mm_and_si128(bytes, nibble_mask));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), _mm_unpackhi_epi8(hi, lo));
+}
+
+// Returns the values of 16 hex digits, or false if any of them isn't one.
+static inline bool
+HexDigitsToNibbles (__m128i chars, __m128i &nibbles)
+{
+    // Unsigned x <= limit is min(x, limit) == x.
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xffff)
+        return false;
+    nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                           _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+    return true;
+}
+
+static inline bool
+DecodeBlock (const char *src, uint8_t *dst)
+{
+    __m128i first, second;
+    if (!HexDigitsToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src)), first) ||
+        !HexDigitsToNibbles(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 16)), second))
+        return false;
+
+    // Each 16 bit lane holds the high nibble in its low byte and the low
+    // nibble in its high byte.
+    const __m128i byte_mask = _mm_set1_epi16(0x00ff);
+    first = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(first, 4), _mm_srli_epi16(first, 8)), byte_mask);
+    second = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(second, 4), _mm_srli_epi16(second, 8)), byte_mask);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_packus_epi16(first, second));
+    return true;
+}
+
+#define HEX_ENCODING_HAS_BLOCKS 1
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+static inline uint8x16_t
+NibblesToHexDigits (uint8x16_t nibbles)
+{
+    const uint8x16_t above_nine = vcgtq_u8(nibbles, vdupq_n_u8(9));
+    return vaddq_u8(vaddq_u8(nibbles, vdupq_n_u8('0')), vandq_u8(above_nine, vdupq_n_u8('a' - '0' - 10)));
+}
+
+static inline void
+EncodeBlock (const uint8_t *src, char *dst)
+{
+    const uint8x16_t bytes = vld1q_u8(src);
+    uint8x16x2_t hex;
+    hex.val[0] = NibblesToHexDigits(vshrq_n_u8(bytes, 4));
+    hex.val[1] = NibblesToHexDigits(vandq_u8(bytes, vdupq_n_u8(0x0f)));
+    vst2q_u8(reinterpret_cast<uint8_t *>(dst), hex);
+}
+
+static inline bool
+HexDigitsToNibbles (uint8x16_t chars, uint8x16_t &nibbles)
+{
+    const uint8x16_t digit = vsubq_u8(chars, vdupq_n_u8('0'));
+    const uint8x16_t is_digit = vcleq_u8(digit, vdupq_n_u8(9));
+    const uint8x16_t letter = vsubq_u8(vorrq_u8(chars, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    const uint8x16_t is_letter = vcleq_u8(letter, vdupq_n_u8(5));
+    if (vminvq_u8(vorrq_u8(is_digit, is_letter)) == 0)
+        return false;
+    nibbles = vorrq_u8(vandq_u8(is_digit, digit), vandq_u8(is_letter, vaddq_u8(letter, vdupq_n_u8(10))));
+    return true;
+}
+
+static inline bool
+DecodeBlock (const char *src, uint8_t *dst)
+{
+    // Split the even (high nibble) and odd (low nibble) characters.
+    const uint8x16x2_t chars = vld2q_u8(reinterpret_cast<const uint8_t *>(src));
+    uint8x16_t hi, lo;
+    if (!HexDigitsToNibbles(chars.val[0], hi) || !HexDigitsToNibbles(chars.val[1], lo))
+        return false;
+    vst1q_u8(dst, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    return true;
+}
+
+#define HEX_ENCODING_HAS_BLOCKS 1
+
+#endif
+
+void
+lldb_private::HexEncode (const void *src_void, size_t length, char *dst)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(src_void);
+    size_t i = 0;
+#if defined(HEX_ENCODING_HAS_BLOCKS)
+    for (; i + 16 <= length; i += 16)
+        EncodeBlock(src + i, dst + 2 * i);
+#endif
+    for (; i < length; ++i)
+    {
+        dst[2 * i] = g_hex_chars[src[i] >> 4];
+        dst[2 * i + 1] = g_hex_chars[src[i] & 0x0f];
+    }
+}
+
+size_t
+lldb_private::HexDecode (const char *src, size_t length, void *dst_void)
+{
+    uint8_t *dst = static_cast<uint8_t *>(dst_void);
+    size_t i = 0;
+#if defined(HEX_ENCODING_HAS_BLOCKS)
+    // A block with a bad character is redone below to find it.
+    for (; i + 16 <= length; i += 16)
+    {
+        if (!DecodeBlock(src + 2 * i, dst + i))
+            break;
+    }
+#endif
+    for (; i < length; ++i)
+    {
+        const int hi_nibble = HexDigitValue(src[2 * i]);
+        const int lo_nibble = HexDigitValue(src[2 * i + 1]);
+        if (hi_nibble == -1 || lo_nibble == -1)
+            break;
+        dst[i] = static_cast<uint8_t>((hi_nibble << 4) | lo_nibble);
+    }
+    return i;
+}
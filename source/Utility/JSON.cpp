@@ -691,3 +691,347 @@ JSONParser::ParseJSONValue ()
     return JSONValue::SP();
     
 }
+
+JSONPullParser::JSONPullParser (llvm::StringRef text) :
+    m_text (text),
+    m_index (0),
+    m_event_offset (0),
+    m_state (State::Value),
+    m_event (Event::Error),
+    m_value (),
+    m_unescaped (),
+    m_containers ()
+{
+}
+
+void
+JSONPullParser::SetOffset (size_t offset)
+{
+    m_index = offset;
+    m_event_offset = offset;
+    m_state = State::Value;
+    m_event = Event::Error;
+    m_value = llvm::StringRef();
+    m_containers.clear();
+}
+
+JSONPullParser::Event
+JSONPullParser::Next ()
+{
+    m_value = llvm::StringRef();
+    SkipSpaces();
+    m_event_offset = m_index;
+    const char ch = m_index < m_text.size() ? m_text[m_index] : '\0';
+    switch (m_state)
+    {
+        case State::Error:
+            return m_event = Event::Error;
+
+        case State::Done:
+            return m_event = Event::EndOfFile;
+
+        case State::Separator:
+            if (ch != ',')
+                return m_event = CloseContainer(ch);
+            ++m_index;
+            m_state = m_containers.back() == '{' ? State::Key : State::Value;
+            return Next();
+
+        case State::FirstKey:
+            if (ch == '}')
+                return m_event = CloseContainer(ch);
+            // Fall through
+        case State::Key:
+            if (ch != '"' || ReadString(Event::Key) == Event::Error)
+                return m_event = SetError();
+            SkipSpaces();
+            if (m_index >= m_text.size() || m_text[m_index] != ':')
+                return m_event = SetError();
+            ++m_index;
+            m_state = State::Value;
+            return m_event = Event::Key;
+
+        case State::FirstElement:
+            if (ch == ']')
+                return m_event = CloseContainer(ch);
+            // Fall through
+        case State::Value:
+            return m_event = ReadValue();
+    }
+    return m_event = SetError();
+}
+
+bool
+JSONPullParser::SkipValue ()
+{
+    switch (m_event)
+    {
+        case Event::ObjectStart:
+        case Event::ArrayStart:
+            {
+                // Read up to the end that closes the container we are in
+                const size_t depth = m_containers.size();
+                while (1)
+                {
+                    const Event event = Next();
+                    if (event == Event::Error || event == Event::EndOfFile)
+                        return false;
+                    if ((event == Event::ObjectEnd || event == Event::ArrayEnd) && m_containers.size() < depth)
+                        return true;
+                }
+            }
+
+        case Event::Error:
+        case Event::ObjectEnd:
+        case Event::ArrayEnd:
+        case Event::Key:
+        case Event::EndOfFile:
+            return false;
+
+        default:
+            break;
+    }
+    return true;
+}
+
+uint64_t
+JSONPullParser::GetValueAsUnsigned (uint64_t fail_value) const
+{
+    if (m_event != Event::Integer)
+        return fail_value;
+    if (m_value.startswith("-"))
+        return static_cast<uint64_t>(GetValueAsSigned(static_cast<int64_t>(fail_value)));
+    uint64_t uval;
+    if (m_value.getAsInteger(10, uval))
+        return fail_value;
+    return uval;
+}
+
+int64_t
+JSONPullParser::GetValueAsSigned (int64_t fail_value) const
+{
+    if (m_event != Event::Integer)
+        return fail_value;
+    int64_t sval;
+    if (m_value.getAsInteger(10, sval))
+    {
+        uint64_t uval;
+        if (m_value.getAsInteger(10, uval))
+            return fail_value;
+        return static_cast<int64_t>(uval);
+    }
+    return sval;
+}
+
+JSONPullParser::Event
+JSONPullParser::ReadValue ()
+{
+    const char ch = m_index < m_text.size() ? m_text[m_index] : '\0';
+    switch (ch)
+    {
+        case '{':
+            ++m_index;
+            m_containers.push_back(ch);
+            m_state = State::FirstKey;
+            return Event::ObjectStart;
+
+        case '[':
+            ++m_index;
+            m_containers.push_back(ch);
+            m_state = State::FirstElement;
+            return Event::ArrayStart;
+
+        case '"':
+            if (ReadString(Event::String) == Event::Error)
+                return Event::Error;
+            return EndValue(Event::String);
+
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return ReadNumber();
+
+        case 't':
+            return ReadLiteral("true", Event::True);
+
+        case 'f':
+            return ReadLiteral("false", Event::False);
+
+        case 'n':
+            return ReadLiteral("null", Event::Null);
+
+        default:
+            break;
+    }
+    return SetError();
+}
+
+JSONPullParser::Event
+JSONPullParser::ReadString (Event event)
+{
+    // Skip the opening quote
+    const size_t start = ++m_index;
+
+    // Most strings have no escapes, those are returned without a copy
+    const size_t end = m_text.find_first_of("\"\\", start);
+    if (end == llvm::StringRef::npos)
+        return SetError();
+    if (m_text[end] == '"')
+    {
+        m_value = m_text.slice(start, end);
+        m_index = end + 1;
+        return event;
+    }
+
+    m_unescaped.assign(m_text.data() + start, end - start);
+    m_index = end;
+    while (1)
+    {
+        if (m_index >= m_text.size())
+            return SetError();
+        char ch = m_text[m_index++];
+        if (ch == '"')
+            break;
+        if (ch != '\\')
+        {
+            m_unescaped.push_back(ch);
+            continue;
+        }
+
+        if (m_index >= m_text.size())
+            return SetError();
+        ch = m_text[m_index++];
+        switch (ch)
+        {
+            case 'b': m_unescaped.push_back('\b'); break;
+            case 'f': m_unescaped.push_back('\f'); break;
+            case 'n': m_unescaped.push_back('\n'); break;
+            case 'r': m_unescaped.push_back('\r'); break;
+            case 't': m_unescaped.push_back('\t'); break;
+            case 'u':
+                {
+                    uint32_t code = 0;
+                    if (m_index + 4 > m_text.size() || m_text.substr(m_index, 4).getAsInteger(16, code))
+                        return SetError();
+                    m_index += 4;
+
+                    // Return the character as UTF-8
+                    if (code < 0x80)
+                    {
+                        m_unescaped.push_back(static_cast<char>(code));
+                    }
+                    else if (code < 0x800)
+                    {
+                        m_unescaped.push_back(static_cast<char>(0xc0 | (code >> 6)));
+                        m_unescaped.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+                    }
+                    else
+                    {
+                        m_unescaped.push_back(static_cast<char>(0xe0 | (code >> 12)));
+                        m_unescaped.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+                        m_unescaped.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+                    }
+                }
+                break;
+
+            default:
+                // '"', '\\' and '/' stand for themselves
+                m_unescaped.push_back(ch);
+                break;
+        }
+    }
+    m_value = m_unescaped;
+    return event;
+}
+
+JSONPullParser::Event
+JSONPullParser::ReadNumber ()
+{
+    const size_t start = m_index;
+    auto peek = [this] () -> char { return m_index < m_text.size() ? m_text[m_index] : '\0'; };
+    auto skip_digits = [this, &peek] () -> bool
+    {
+        const size_t digits_start = m_index;
+        while (peek() >= '0' && peek() <= '9')
+            ++m_index;
+        return m_index > digits_start;
+    };
+
+    bool is_float = false;
+    if (peek() == '-')
+        ++m_index;
+    if (!skip_digits())
+        return SetError();
+    if (peek() == '.')
+    {
+        ++m_index;
+        is_float = true;
+        if (!skip_digits())
+            return SetError();
+    }
+    if (peek() == 'e' || peek() == 'E')
+    {
+        ++m_index;
+        is_float = true;
+        if (peek() == '+' || peek() == '-')
+            ++m_index;
+        if (!skip_digits())
+            return SetError();
+    }
+    m_value = m_text.slice(start, m_index);
+    return EndValue(is_float ? Event::Float : Event::Integer);
+}
+
+JSONPullParser::Event
+JSONPullParser::ReadLiteral (llvm::StringRef literal, Event event)
+{
+    if (!m_text.substr(m_index).startswith(literal))
+        return SetError();
+    m_index += literal.size();
+    return EndValue(event);
+}
+
+JSONPullParser::Event
+JSONPullParser::CloseContainer (char ch)
+{
+    if (m_containers.empty() || (ch != '}' && ch != ']') || m_containers.back() != (ch == '}' ? '{' : '['))
+        return SetError();
+    ++m_index;
+    m_containers.pop_back();
+    return EndValue(ch == '}' ? Event::ObjectEnd : Event::ArrayEnd);
+}
+
+JSONPullParser::Event
+JSONPullParser::EndValue (Event event)
+{
+    m_state = m_containers.empty() ? State::Done : State::Separator;
+    return event;
+}
+
+JSONPullParser::Event
+JSONPullParser::SetError ()
+{
+    m_state = State::Error;
+    m_value = llvm::StringRef();
+    return Event::Error;
+}
+
+void
+JSONPullParser::SkipSpaces ()
+{
+    while (m_index < m_text.size())
+    {
+        const char ch = m_text[m_index];
+        if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r')
+            break;
+        ++m_index;
+    }
+}
@@ -0,0 +1,32 @@
+//===-- LLVMTargets.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/LLVMTargets.h"
+
+// C Includes
+// C++ Includes
+#include <mutex>
+
+// Other libraries and framework includes
+#include "llvm/Support/TargetSelect.h"
+
+void
+lldb_private::InitializeLLVMTargets ()
+{
+    static std::once_flag g_once_flag;
+    std::call_once(g_once_flag, []()
+    {
+        llvm::InitializeAllTargetInfos();
+        llvm::InitializeAllTargets();
+        llvm::InitializeAllTargetMCs();
+        llvm::InitializeAllAsmPrinters();
+        llvm::InitializeAllAsmParsers();
+        llvm::InitializeAllDisassemblers();
+    });
+}
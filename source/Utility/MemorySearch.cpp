@@ -0,0 +1,193 @@
+//===-- MemorySearch.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/MemorySearch.h"
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-defines.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // Appends the offsets of the words equal to "needle", "needle" has the
+    // byte order of the memory.
+    template <typename T>
+    size_t
+    FindWords (const uint8_t *buf, size_t buf_size, T needle, lldb::addr_t base_addr,
+               size_t max_matches, std::vector<lldb::addr_t> &matches)
+    {
+        const size_t num_words = buf_size / sizeof(T);
+        for (size_t i = 0; i < num_words && matches.size() < max_matches; ++i)
+        {
+            T word;
+            ::memcpy(&word, buf + i * sizeof(T), sizeof(T));
+            if (word == needle)
+                matches.push_back(base_addr + i * sizeof(T));
+        }
+        return num_words * sizeof(T);
+    }
+}
+
+const uint8_t *
+MemorySearch::FindInBuffer (const uint8_t *buf, size_t buf_size, const uint8_t *pattern, size_t pattern_size)
+{
+    if (pattern_size == 0 || buf_size < pattern_size)
+        return nullptr;
+
+    const uint8_t first = pattern[0];
+    const uint8_t *pos = buf;
+    // The last position a match can start at
+    const uint8_t *last = buf + buf_size - pattern_size;
+    while (pos <= last)
+    {
+        pos = static_cast<const uint8_t *>(::memchr(pos, first, last - pos + 1));
+        if (pos == nullptr)
+            return nullptr;
+        if (::memcmp(pos + 1, pattern + 1, pattern_size - 1) == 0)
+            return pos;
+        ++pos;
+    }
+    return nullptr;
+}
+
+lldb::addr_t
+MemorySearch::Find (lldb::addr_t low,
+                    lldb::addr_t high,
+                    const uint8_t *pattern,
+                    size_t pattern_size,
+                    const ReadMemoryCallback &read_memory,
+                    const RegionInfoCallback &region_info,
+                    size_t chunk_size)
+{
+    if (pattern_size == 0 || low >= high || chunk_size == 0)
+        return LLDB_INVALID_ADDRESS;
+
+    std::vector<uint8_t> chunk (chunk_size + pattern_size - 1);
+    lldb::addr_t addr = low;
+    while (addr < high)
+    {
+        lldb::addr_t region_end = LLDB_INVALID_ADDRESS;
+        bool readable = true;
+        if (region_info && !region_info(addr, region_end, readable))
+            region_end = LLDB_INVALID_ADDRESS;
+        if (region_end != LLDB_INVALID_ADDRESS && region_end <= addr)
+            region_end = LLDB_INVALID_ADDRESS;
+
+        if (!readable)
+        {
+            if (region_end == LLDB_INVALID_ADDRESS)
+                break;
+            addr = region_end;
+            continue;
+        }
+
+        // The matches that start in this chunk, they may extend into the
+        // next region when it is readable too.
+        lldb::addr_t num_starts = std::min<lldb::addr_t>(chunk_size, high - addr);
+        if (region_end != LLDB_INVALID_ADDRESS)
+            num_starts = std::min<lldb::addr_t>(num_starts, region_end - addr);
+        const size_t read_size = num_starts + pattern_size - 1;
+
+        size_t bytes_read = read_memory(addr, chunk.data(), read_size);
+        if (bytes_read < pattern_size && read_size > num_starts)
+        {
+            // Reads that fail as a whole when they reach unreadable memory
+            // are retried without the overlap.
+            bytes_read = std::max(bytes_read, read_memory(addr, chunk.data(), num_starts));
+        }
+
+        if (bytes_read < pattern_size)
+        {
+            // Nothing at addr can match, go on after the region if there is
+            // one.
+            if (region_end == LLDB_INVALID_ADDRESS)
+                break;
+            addr = region_end;
+            continue;
+        }
+
+        const uint8_t *match = FindInBuffer(chunk.data(), bytes_read, pattern, pattern_size);
+        if (match != nullptr)
+        {
+            const lldb::addr_t match_addr = addr + (match - chunk.data());
+            return match_addr < high ? match_addr : LLDB_INVALID_ADDRESS;
+        }
+
+        // Every position that had the whole pattern in the buffer was
+        // checked, the rest is searched with the next chunk.
+        addr += std::min<lldb::addr_t>(num_starts, bytes_read - pattern_size + 1);
+    }
+    return LLDB_INVALID_ADDRESS;
+}
+
+lldb::addr_t
+MemorySearch::FindPointers (lldb::addr_t low,
+                            lldb::addr_t high,
+                            uint64_t value,
+                            uint32_t pointer_size,
+                            lldb::ByteOrder byte_order,
+                            const ReadMemoryCallback &read_memory,
+                            size_t max_matches,
+                            std::vector<lldb::addr_t> &matches,
+                            size_t chunk_size)
+{
+    if ((pointer_size != 4 && pointer_size != 8) || chunk_size < pointer_size)
+        return low;
+
+    // The value as it is stored in the memory of the process
+    uint8_t value_bytes[8];
+    for (uint32_t i = 0; i < pointer_size; ++i)
+    {
+        const uint8_t byte = (value >> (i * 8)) & 0xff;
+        if (byte_order == lldb::eByteOrderBig)
+            value_bytes[pointer_size - 1 - i] = byte;
+        else
+            value_bytes[i] = byte;
+    }
+    uint32_t needle32;
+    uint64_t needle64;
+    ::memcpy(&needle32, value_bytes, sizeof(needle32));
+    ::memcpy(&needle64, value_bytes, sizeof(needle64));
+
+    chunk_size -= chunk_size % pointer_size;
+    std::vector<uint8_t> chunk (chunk_size);
+    lldb::addr_t addr = (low + pointer_size - 1) & ~(lldb::addr_t)(pointer_size - 1);
+    if (addr < low)
+        return high;
+    while (addr < high && high - addr >= pointer_size)
+    {
+        if (matches.size() >= max_matches)
+            return addr;
+
+        const size_t read_size = std::min<lldb::addr_t>(chunk_size, high - addr);
+        const size_t bytes_read = read_memory(addr, chunk.data(), read_size);
+
+        size_t bytes_scanned;
+        if (pointer_size == 8)
+            bytes_scanned = FindWords(chunk.data(), bytes_read, needle64, addr, max_matches, matches);
+        else
+            bytes_scanned = FindWords(chunk.data(), bytes_read, needle32, addr, max_matches, matches);
+
+        if (matches.size() >= max_matches)
+            return matches.back() + pointer_size;
+
+        // Skip the rest of a chunk that couldn't be read
+        addr += (bytes_read < read_size) ? read_size : bytes_scanned;
+    }
+    return high;
+}
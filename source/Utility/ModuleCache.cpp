@@ -9,17 +9,21 @@
 
 #include "ModuleCache.h"
 
+#include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Host/File.h"
+#include "lldb/Core/StreamString.h"
 #include "lldb/Host/FileSystem.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Host/LockFile.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
 
 #include <assert.h>
+#include <inttypes.h>
 
 #include <cstdio>
 
@@ -320,3 +324,47 @@ ModuleCache::GetAndPut (const FileSpec &root_dir_spec,
     cached_module_sp->SetSymbolFileFileSpec (symfile_spec);
     return Error ();
 }
+
+Error
+ModuleCache::WriteDataFile (const FileSpec &file_spec, const void *data, size_t size)
+{
+    auto error = MakeDirectory (FileSpec (file_spec.GetDirectory ().AsCString (), false));
+    if (error.Fail ())
+        return error;
+
+    const auto path = file_spec.GetPath ();
+    StreamString tmp_path;
+    tmp_path.Printf ("%s.%" PRIu64 "%s", path.c_str (), (uint64_t)Host::GetCurrentProcessID (), kTempFileName);
+    {
+        File file (tmp_path.GetData (),
+                   File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate | File::eOpenOptionCloseOnExec);
+        size_t num_bytes = size;
+        if (file.IsValid ())
+            error = file.Write (data, num_bytes);
+        else
+            error.SetErrorToErrno ();
+        if (error.Success () && num_bytes != size)
+            error.SetErrorString ("short write");
+    }
+
+    if (error.Success ())
+    {
+        const auto err_code = llvm::sys::fs::rename (tmp_path.GetData (), path.c_str ());
+        if (err_code)
+            error.SetErrorString (err_code.message ().c_str ());
+    }
+
+    if (error.Fail ())
+        llvm::sys::fs::remove (tmp_path.GetData ());
+    return error;
+}
+
+DataBufferSP
+ModuleCache::MapDataFile (const FileSpec &file_spec)
+{
+    // The files are replaced by renaming, never written in place, so a
+    // mapping always sees one complete version of the file.
+    if (!file_spec.Exists () || file_spec.GetByteSize () == 0)
+        return DataBufferSP ();
+    return file_spec.MemoryMapFileContents ();
+}
@@ -58,6 +58,32 @@ public:
               lldb::ModuleSP &cached_module_sp,
               bool *did_create_ptr);
 
+    //------------------------------------------------------------------
+    /// Write a file with data parsed from a module (symbol table,
+    /// demangled names, debug info index) to a cache directory that
+    /// other debugger processes read it from.
+    ///
+    /// The data goes to a temporary file of this process that is then
+    /// renamed into place, so concurrent processes neither see a
+    /// partially written file nor write over each other. The directory
+    /// of the file is created if needed.
+    //------------------------------------------------------------------
+    static Error
+    WriteDataFile (const FileSpec &file_spec, const void *data, size_t size);
+
+    //------------------------------------------------------------------
+    /// Map a file written by WriteDataFile() read only.
+    ///
+    /// All processes that use the same file share one copy of it in the
+    /// page cache instead of each reading it into its own memory.
+    ///
+    /// @return
+    ///     The contents of the file, or an empty shared pointer if the
+    ///     file doesn't exist or can't be mapped.
+    //------------------------------------------------------------------
+    static lldb::DataBufferSP
+    MapDataFile (const FileSpec &file_spec);
+
 private:
     Error
     Put (const FileSpec &root_dir_spec,
@@ -13,8 +13,11 @@
 #include <stdlib.h>
 
 // C++ Includes
+#include <algorithm>
+
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Utility/HexEncoding.h"
 
 static inline int
 xdigit_to_sint (char ch)
@@ -352,7 +355,9 @@ size_t
 StringExtractor::GetHexBytes (void *dst_void, size_t dst_len, uint8_t fail_fill_value)
 {
     uint8_t *dst = (uint8_t*)dst_void;
-    size_t bytes_extracted = 0;
+    size_t bytes_extracted = GetHexBytesAvail (dst, dst_len);
+
+    // Let GetHexU8 deal with a bad or incomplete byte, if any.
     while (bytes_extracted < dst_len && GetBytesLeft ())
     {
         dst[bytes_extracted] = GetHexU8 (fail_fill_value);
@@ -377,18 +382,12 @@ StringExtractor::GetHexBytes (void *dst_void, size_t dst_len, uint8_t fail_fill_
 size_t
 StringExtractor::GetHexBytesAvail (void *dst_void, size_t dst_len)
 {
-    uint8_t *dst = (uint8_t*)dst_void;
-    size_t bytes_extracted = 0;
-    while (bytes_extracted < dst_len)
-    {
-        int decode = DecodeHexU8();
-        if (decode == -1)
-        {
-            break;
-        }
-        dst[bytes_extracted++] = (uint8_t)decode;
-    }
-    return bytes_extracted;
+    const size_t max_bytes = std::min<size_t>(dst_len, GetBytesLeft() / 2);
+    if (max_bytes == 0)
+        return 0;
+    const size_t bytes_decoded = lldb_private::HexDecode (m_packet.data() + m_index, max_bytes, dst_void);
+    m_index += bytes_decoded * 2;
+    return bytes_decoded;
 }
 
 // Consume ASCII hex nibble character pairs until we have decoded byte_size
@@ -88,13 +88,18 @@ StringExtractorGDBRemote::GetServerPacketType () const
         case 'E':
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment;
             if (PACKET_STARTS_WITH ("QEnvironmentHexEncoded:")) return eServerPacketType_QEnvironmentHexEncoded;
+            if (PACKET_STARTS_WITH ("QEnableCompression:"))     return eServerPacketType_QEnableCompression;
+            if (PACKET_MATCHES ("QEnableBinaryFraming"))        return eServerPacketType_QEnableBinaryFraming;
             break;
 
         case 'S':
             if (PACKET_MATCHES ("QStartNoAckMode"))               return eServerPacketType_QStartNoAckMode;
             if (PACKET_STARTS_WITH ("QSaveRegisterState"))        return eServerPacketType_QSaveRegisterState;
+            if (PACKET_MATCHES ("QSaveCheckpoint"))               return eServerPacketType_QSaveCheckpoint;
             if (PACKET_STARTS_WITH ("QSetDisableASLR:"))          return eServerPacketType_QSetDisableASLR;
             if (PACKET_STARTS_WITH ("QSetDetachOnError:"))        return eServerPacketType_QSetDetachOnError;
+            if (PACKET_STARTS_WITH ("QSetExpeditedRegisters:"))   return eServerPacketType_QSetExpeditedRegisters;
+            if (PACKET_STARTS_WITH ("QSetSharedMemory:"))         return eServerPacketType_QSetSharedMemory;
             if (PACKET_STARTS_WITH ("QSetSTDIN:"))                return eServerPacketType_QSetSTDIN;
             if (PACKET_STARTS_WITH ("QSetSTDOUT:"))               return eServerPacketType_QSetSTDOUT;
             if (PACKET_STARTS_WITH ("QSetSTDERR:"))               return eServerPacketType_QSetSTDERR;
@@ -111,8 +116,17 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_MATCHES("QListThreadsInStopReply"))        return eServerPacketType_QListThreadsInStopReply;
             break;
 
+        case 'N':
+            if (PACKET_STARTS_WITH ("QNonStop:"))                 return eServerPacketType_QNonStop;
+            break;
+
+        case 'P':
+            if (PACKET_STARTS_WITH ("QPassSignals:"))             return eServerPacketType_QPassSignals;
+            break;
+
         case 'R':
             if (PACKET_STARTS_WITH ("QRestoreRegisterState:"))    return eServerPacketType_QRestoreRegisterState;
+            if (PACKET_STARTS_WITH ("QRestoreCheckpoint:"))       return eServerPacketType_QRestoreCheckpoint;
             break;
 
         case 'T':
@@ -134,6 +148,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_STARTS_WITH ("qfThreadInfo"))            return eServerPacketType_qfThreadInfo;
             break;
 
+        case 'B':
+            if (PACKET_MATCHES ("qBreakpointHitCounts"))        return eServerPacketType_qBreakpointHitCounts;
+            break;
+
         case 'C':
             if (packet_size == 2)                               return eServerPacketType_qC;
             break;
@@ -144,6 +162,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
 
         case 'F':
             if (PACKET_STARTS_WITH ("qFileLoadAddress:"))       return eServerPacketType_qFileLoadAddress;
+            if (PACKET_STARTS_WITH ("qFindReferences:"))        return eServerPacketType_qFindReferences;
             break;
 
         case 'G':
@@ -188,9 +207,11 @@ StringExtractorGDBRemote::GetServerPacketType () const
         case 'R':
             if (PACKET_STARTS_WITH ("qRcmd,"))                  return eServerPacketType_qRcmd;
             if (PACKET_STARTS_WITH ("qRegisterInfo"))           return eServerPacketType_qRegisterInfo;
+            if (PACKET_STARTS_WITH ("qReadMemoryShared:"))      return eServerPacketType_qReadMemoryShared;
             break;
 
         case 'S':
+            if (PACKET_STARTS_WITH ("qSearch:memory:"))         return eServerPacketType_qSearch_memory;
             if (PACKET_STARTS_WITH ("qSpeedTest:"))             return eServerPacketType_qSpeedTest;
             if (PACKET_MATCHES ("qShlibInfoAddr"))              return eServerPacketType_qShlibInfoAddr;
             if (PACKET_MATCHES ("qStepPacketSupported"))        return eServerPacketType_qStepPacketSupported;
@@ -218,13 +239,19 @@ StringExtractorGDBRemote::GetServerPacketType () const
 
         case 'X':
             if (PACKET_STARTS_WITH ("qXfer:auxv:read::"))       return eServerPacketType_qXfer_auxv_read;
+            if (PACKET_STARTS_WITH ("qXfer:libraries-svr4:read::")) return eServerPacketType_qXfer_libraries_svr4_read;
             break;
         }
         break;
 
     case 'j':
+        if (PACKET_STARTS_WITH("jSampleRead:"))                 return eServerPacketType_jSampleRead;
+        if (PACKET_STARTS_WITH("jSample:"))                     return eServerPacketType_jSample;
         if (PACKET_MATCHES("jSignalsInfo"))                     return eServerPacketType_jSignalsInfo;
         if (PACKET_MATCHES("jThreadsInfo"))                     return eServerPacketType_jThreadsInfo;
+        if (PACKET_STARTS_WITH("jTraceRead:"))                  return eServerPacketType_jTraceRead;
+        if (PACKET_STARTS_WITH("jTraceStart:"))                 return eServerPacketType_jTraceStart;
+        if (PACKET_STARTS_WITH("jTraceStop:"))                  return eServerPacketType_jTraceStop;
         break;
 
     case 'v':
@@ -249,6 +276,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
               if (PACKET_STARTS_WITH ("vAttachName;"))          return eServerPacketType_vAttachName;
               if (PACKET_STARTS_WITH("vCont;"))                 return eServerPacketType_vCont;
               if (PACKET_MATCHES ("vCont?"))                    return eServerPacketType_vCont_actions;
+              if (PACKET_MATCHES ("vStopped"))                  return eServerPacketType_vStopped;
             }
             break;
       case '_':
@@ -277,7 +305,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         break;
 
       case 'g':
-        if (packet_size == 1) return eServerPacketType_g;
+        if (packet_size == 1 || packet_cstr[1] == ';') return eServerPacketType_g;
         break;
 
       case 'G':
@@ -297,6 +325,9 @@ StringExtractorGDBRemote::GetServerPacketType () const
         return eServerPacketType_m;
 
       case 'M':
+        if (PACKET_STARTS_WITH ("MultiMemRead:"))               return eServerPacketType_MultiMemRead;
+        if (PACKET_STARTS_WITH ("MultiMemHash:"))               return eServerPacketType_MultiMemHash;
+        if (PACKET_STARTS_WITH ("MultiBreakpoint:"))            return eServerPacketType_MultiBreakpoint;
         return eServerPacketType_M;
 
       case 'p':
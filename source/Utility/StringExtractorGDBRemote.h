@@ -72,6 +72,7 @@ public:
         eServerPacketType_A, // Program arguments packet
         eServerPacketType_qfProcessInfo,
         eServerPacketType_qsProcessInfo,
+        eServerPacketType_qBreakpointHitCounts,
         eServerPacketType_qC,
         eServerPacketType_qEcho,
         eServerPacketType_qGroupName,
@@ -87,9 +88,13 @@ public:
         eServerPacketType_qGetWorkingDir,
         eServerPacketType_qFileLoadAddress,
         eServerPacketType_QEnvironment,
+        eServerPacketType_QEnableCompression,
+        eServerPacketType_QEnableBinaryFraming,
         eServerPacketType_QLaunchArch,
         eServerPacketType_QSetDisableASLR,
         eServerPacketType_QSetDetachOnError,
+        eServerPacketType_QSetExpeditedRegisters,
+        eServerPacketType_QSetSharedMemory,
         eServerPacketType_QSetSTDIN,
         eServerPacketType_QSetSTDOUT,
         eServerPacketType_QSetSTDERR,
@@ -112,7 +117,11 @@ public:
       // debug server packages
         eServerPacketType_QEnvironmentHexEncoded,
         eServerPacketType_QListThreadsInStopReply,
+        eServerPacketType_QNonStop,
+        eServerPacketType_QPassSignals,
+        eServerPacketType_QRestoreCheckpoint,
         eServerPacketType_QRestoreRegisterState,
+        eServerPacketType_QSaveCheckpoint,
         eServerPacketType_QSaveRegisterState,
         eServerPacketType_QSetLogging,
         eServerPacketType_QSetMaxPacketSize,
@@ -124,6 +133,7 @@ public:
         eServerPacketType_jThreadsInfo,
         eServerPacketType_qsThreadInfo,
         eServerPacketType_qfThreadInfo,
+        eServerPacketType_qFindReferences,
         eServerPacketType_qGetPid,
         eServerPacketType_qGetProfileData,
         eServerPacketType_qGDBServerVersion,
@@ -132,6 +142,8 @@ public:
         eServerPacketType_qProcessInfo,
         eServerPacketType_qRcmd,
         eServerPacketType_qRegisterInfo,
+        eServerPacketType_qReadMemoryShared,
+        eServerPacketType_qSearch_memory,
         eServerPacketType_qShlibInfoAddr,
         eServerPacketType_qStepPacketSupported,
         eServerPacketType_qSupported,
@@ -142,8 +154,14 @@ public:
         eServerPacketType_qWatchpointSupportInfo,
         eServerPacketType_qWatchpointSupportInfoSupported,
         eServerPacketType_qXfer_auxv_read,
+        eServerPacketType_qXfer_libraries_svr4_read,
 
+        eServerPacketType_jSample,
+        eServerPacketType_jSampleRead,
         eServerPacketType_jSignalsInfo,
+        eServerPacketType_jTraceRead,
+        eServerPacketType_jTraceStart,
+        eServerPacketType_jTraceStop,
 
         eServerPacketType_vAttach,
         eServerPacketType_vAttachWait,
@@ -151,6 +169,7 @@ public:
         eServerPacketType_vAttachName,
         eServerPacketType_vCont,
         eServerPacketType_vCont_actions, // vCont?
+        eServerPacketType_vStopped,
 
         eServerPacketType_stop_reason, // '?'
 
@@ -164,6 +183,9 @@ public:
         eServerPacketType_k,
         eServerPacketType_m,
         eServerPacketType_M,
+        eServerPacketType_MultiMemRead,
+        eServerPacketType_MultiMemHash,
+        eServerPacketType_MultiBreakpoint,
         eServerPacketType_p,
         eServerPacketType_P,
         eServerPacketType_s,
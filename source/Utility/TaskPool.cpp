@@ -9,8 +9,13 @@
 
 #include "lldb/Utility/TaskPool.h"
 
+#include <algorithm>
+#include <deque>
+
 namespace
 {
+    const size_t kNumPriorities = TaskPool::ePriorityLow + 1;
+
     class TaskPoolImpl
     {
     public:
@@ -18,17 +23,37 @@ namespace
         GetInstance();
 
         void
-        AddTask(std::function<void()>&& task_fn);
+        AddTask(TaskPool::Priority priority, std::function<void()>&& task_fn);
 
     private:
+        // Every worker thread owns one of these queues. New tasks are distributed between the
+        // queues in a round robin fashion and a worker without work in its own queue steals tasks
+        // from the other queues.
+        struct WorkerQueue
+        {
+            std::mutex                        m_mutex;
+            std::deque<std::function<void()>> m_tasks[kNumPriorities];
+        };
+
         TaskPoolImpl();
 
         static void
-        Worker(TaskPoolImpl* pool);
+        Worker(TaskPoolImpl* pool, uint32_t worker_idx);
 
-        std::queue<std::function<void()>> m_tasks;
-        std::mutex                        m_tasks_mutex;
-        uint32_t                          m_thread_count;
+        bool
+        GetNextTask(uint32_t worker_idx, std::function<void()>& task_fn);
+
+        bool
+        HasPendingTasks() const;
+
+        const uint32_t                 m_max_threads;
+        std::unique_ptr<WorkerQueue[]> m_queues;
+        std::atomic<uint32_t>          m_next_queue_idx;
+        std::atomic<uint32_t>          m_thread_count;
+        std::atomic<uint32_t>          m_idle_count;
+        std::atomic<size_t>            m_num_pending[kNumPriorities]; // Updated with the queue mutex held
+        std::mutex                     m_wait_mutex;
+        std::condition_variable        m_wait_cv;
     };
 
 } // end of anonymous namespace
@@ -36,54 +61,122 @@ namespace
 TaskPoolImpl&
 TaskPoolImpl::GetInstance()
 {
-    static TaskPoolImpl g_task_pool_impl;
-    return g_task_pool_impl;
+    // The worker threads are never stopped so the pool is intentionally leaked to make sure it
+    // outlives them during process shutdown.
+    static TaskPoolImpl *g_task_pool_impl = new TaskPoolImpl();
+    return *g_task_pool_impl;
 }
 
 void
-TaskPool::AddTaskImpl(std::function<void()>&& task_fn)
+TaskPool::AddTaskImpl(Priority priority, std::function<void()>&& task_fn)
 {
-    TaskPoolImpl::GetInstance().AddTask(std::move(task_fn));
+    TaskPoolImpl::GetInstance().AddTask(priority, std::move(task_fn));
 }
 
 TaskPoolImpl::TaskPoolImpl() :
-    m_thread_count(0)
+    m_max_threads(std::max<uint32_t>(1, std::thread::hardware_concurrency())),
+    m_queues(new WorkerQueue[m_max_threads]),
+    m_next_queue_idx(0),
+    m_thread_count(0),
+    m_idle_count(0)
 {
+    for (size_t i = 0; i < kNumPriorities; ++i)
+        m_num_pending[i] = 0;
 }
 
 void
-TaskPoolImpl::AddTask(std::function<void()>&& task_fn)
+TaskPoolImpl::AddTask(TaskPool::Priority priority, std::function<void()>&& task_fn)
+{
+    WorkerQueue &queue = m_queues[m_next_queue_idx++ % m_max_threads];
+    {
+        std::lock_guard<std::mutex> guard(queue.m_mutex);
+        queue.m_tasks[priority].emplace_back(std::move(task_fn));
+        m_num_pending[priority]++;
+    }
+
+    // Spin up the worker threads lazily until we reach the maximum number of threads
+    uint32_t thread_count = m_thread_count;
+    while (thread_count < m_max_threads)
+    {
+        if (m_thread_count.compare_exchange_weak(thread_count, thread_count + 1))
+        {
+            std::thread (Worker, this, thread_count).detach();
+            return;
+        }
+    }
+
+    // Wake up a sleeping worker if there is one. Taking the mutex makes sure the worker either
+    // sees the new task before going to sleep or is already waiting for the notification.
+    if (m_idle_count > 0)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_wait_mutex);
+        }
+        m_wait_cv.notify_one();
+    }
+}
+
+bool
+TaskPoolImpl::HasPendingTasks() const
 {
-    static const uint32_t max_threads = std::thread::hardware_concurrency();
+    for (size_t i = 0; i < kNumPriorities; ++i)
+    {
+        if (m_num_pending[i] > 0)
+            return true;
+    }
+    return false;
+}
 
-    std::unique_lock<std::mutex> lock(m_tasks_mutex);
-    m_tasks.emplace(std::move(task_fn));
-    if (m_thread_count < max_threads)
+bool
+TaskPoolImpl::GetNextTask(uint32_t worker_idx, std::function<void()>& task_fn)
+{
+    for (size_t priority = 0; priority < kNumPriorities; ++priority)
     {
-        m_thread_count++;
-        // Note that this detach call needs to happen with the m_tasks_mutex held. This prevents the thread
-        // from exiting prematurely and triggering a linux libc bug
-        // (https://sourceware.org/bugzilla/show_bug.cgi?id=19951).
-        std::thread (Worker, this).detach();
+        if (m_num_pending[priority] == 0)
+            continue;
+
+        // Check our own queue first and then try to steal from the others. We take the oldest
+        // task from our own queue and the newest one from the other queues.
+        for (uint32_t i = 0; i < m_max_threads; ++i)
+        {
+            WorkerQueue &queue = m_queues[(worker_idx + i) % m_max_threads];
+            std::lock_guard<std::mutex> guard(queue.m_mutex);
+            std::deque<std::function<void()>> &tasks = queue.m_tasks[priority];
+            if (tasks.empty())
+                continue;
+
+            if (i == 0)
+            {
+                task_fn = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            else
+            {
+                task_fn = std::move(tasks.back());
+                tasks.pop_back();
+            }
+            m_num_pending[priority]--;
+            return true;
+        }
     }
+    return false;
 }
 
 void
-TaskPoolImpl::Worker(TaskPoolImpl* pool)
+TaskPoolImpl::Worker(TaskPoolImpl* pool, uint32_t worker_idx)
 {
     while (true)
     {
-        std::unique_lock<std::mutex> lock(pool->m_tasks_mutex);
-        if (pool->m_tasks.empty())
+        std::function<void()> f;
+        if (pool->GetNextTask(worker_idx, f))
         {
-            pool->m_thread_count--;
-            break;
+            f();
+            continue;
         }
 
-        std::function<void()> f = pool->m_tasks.front();
-        pool->m_tasks.pop();
-        lock.unlock();
-
-        f();
+        std::unique_lock<std::mutex> lock(pool->m_wait_mutex);
+        pool->m_idle_count++;
+        pool->m_wait_cv.wait(lock, [pool]() { return pool->HasPendingTasks(); });
+        pool->m_idle_count--;
     }
 }
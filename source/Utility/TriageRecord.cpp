@@ -0,0 +1,240 @@
+//===-- TriageRecord.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Utility/TriageRecord.h"
+
+using namespace lldb_private;
+
+const uint32_t TriageRecord::kVersion;
+const uint32_t TriageRecord::kInvalidIndex;
+
+static_assert(sizeof(TriageRecord::Header) == 88, "the triage record header layout changed");
+static_assert(sizeof(TriageRecord::Module) == 40, "the triage record module layout changed");
+static_assert(sizeof(TriageRecord::Thread) == 24, "the triage record thread layout changed");
+static_assert(sizeof(TriageRecord::Frame) == 24, "the triage record frame layout changed");
+
+namespace
+{
+    uint64_t
+    AlignTo8 (uint64_t value)
+    {
+        return (value + 7) & ~7ull;
+    }
+
+    template <typename T>
+    void
+    AppendTable (std::vector<uint8_t> &bytes, uint64_t offset, const std::vector<T> &table)
+    {
+        if (!table.empty())
+            ::memcpy (bytes.data() + offset, table.data(), table.size() * sizeof(T));
+    }
+
+    // Checks that a table of "count" entries at "offset" is inside the
+    // record and aligned.
+    bool
+    IsValidTable (uint64_t offset, uint64_t count, uint64_t entry_size, size_t size, uint64_t alignment)
+    {
+        if (offset % alignment != 0 || offset > size)
+            return false;
+        return count <= (size - offset) / entry_size;
+    }
+}
+
+TriageRecordWriter::TriageRecordWriter (uint64_t pid) :
+    m_pid (pid),
+    m_modules (),
+    m_threads (),
+    m_frames (),
+    m_strings (),
+    m_string_indexes ()
+{
+}
+
+uint32_t
+TriageRecordWriter::AddString (const ConstString &str)
+{
+    if (!str)
+        return TriageRecord::kInvalidIndex;
+
+    auto pos = m_string_indexes.find (str.GetCString());
+    if (pos != m_string_indexes.end())
+        return pos->second;
+
+    const uint32_t idx = m_strings.size();
+    m_strings.push_back (str);
+    m_string_indexes[str.GetCString()] = idx;
+    return idx;
+}
+
+uint32_t
+TriageRecordWriter::AddModule (const uint8_t *uuid, size_t uuid_size, const ConstString &path, uint64_t load_address)
+{
+    TriageRecord::Module module;
+    ::memset (&module, 0, sizeof(module));
+    module.uuid_size = std::min (uuid_size, sizeof(module.uuid));
+    if (uuid && module.uuid_size)
+        ::memcpy (module.uuid, uuid, module.uuid_size);
+    module.path = AddString (path);
+    module.load_address = load_address;
+    m_modules.push_back (module);
+    return m_modules.size() - 1;
+}
+
+void
+TriageRecordWriter::AddThread (uint64_t tid, uint32_t index_id)
+{
+    TriageRecord::Thread thread;
+    ::memset (&thread, 0, sizeof(thread));
+    thread.tid = tid;
+    thread.index_id = index_id;
+    thread.first_frame = m_frames.size();
+    m_threads.push_back (thread);
+}
+
+void
+TriageRecordWriter::AddFrame (uint64_t pc, uint32_t module_idx, uint64_t file_address, const ConstString &name)
+{
+    if (m_threads.empty())
+        return;
+
+    TriageRecord::Frame frame;
+    frame.pc = pc;
+    frame.file_address = file_address;
+    frame.module = module_idx;
+    frame.name = AddString (name);
+    m_frames.push_back (frame);
+    ++m_threads.back().num_frames;
+}
+
+void
+TriageRecordWriter::GetBytes (std::vector<uint8_t> &bytes) const
+{
+    TriageRecord::Header header;
+    ::memset (&header, 0, sizeof(header));
+    ::strncpy (header.magic, TriageRecord::GetMagic(), sizeof(header.magic));
+    header.version = TriageRecord::kVersion;
+    header.pid = m_pid;
+    header.num_modules = m_modules.size();
+    header.num_threads = m_threads.size();
+    header.num_frames = m_frames.size();
+    header.num_strings = m_strings.size();
+
+    header.modules_offset = AlignTo8 (sizeof(header));
+    header.threads_offset = AlignTo8 (header.modules_offset + m_modules.size() * sizeof(TriageRecord::Module));
+    header.frames_offset = AlignTo8 (header.threads_offset + m_threads.size() * sizeof(TriageRecord::Thread));
+    header.strings_offset = AlignTo8 (header.frames_offset + m_frames.size() * sizeof(TriageRecord::Frame));
+    header.string_data_offset = AlignTo8 (header.strings_offset + m_strings.size() * sizeof(uint32_t));
+
+    std::vector<uint32_t> string_offsets;
+    string_offsets.reserve (m_strings.size());
+    for (const ConstString &str : m_strings)
+    {
+        string_offsets.push_back (header.string_data_size);
+        header.string_data_size += str.GetLength() + 1;
+    }
+
+    bytes.assign (header.string_data_offset + header.string_data_size, 0);
+    ::memcpy (bytes.data(), &header, sizeof(header));
+    AppendTable (bytes, header.modules_offset, m_modules);
+    AppendTable (bytes, header.threads_offset, m_threads);
+    AppendTable (bytes, header.frames_offset, m_frames);
+    AppendTable (bytes, header.strings_offset, string_offsets);
+    for (size_t i = 0; i < m_strings.size(); ++i)
+        ::memcpy (bytes.data() + header.string_data_offset + string_offsets[i], m_strings[i].GetCString(), m_strings[i].GetLength());
+}
+
+TriageRecordReader::TriageRecordReader () :
+    m_bytes (nullptr),
+    m_size (0),
+    m_header (nullptr)
+{
+}
+
+bool
+TriageRecordReader::SetData (const void *bytes, size_t size)
+{
+    m_bytes = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+
+    if (bytes == nullptr || size < sizeof(TriageRecord::Header) || ((uintptr_t)bytes % 8) != 0)
+        return false;
+
+    const TriageRecord::Header *header = static_cast<const TriageRecord::Header *>(bytes);
+    if (::strncmp (header->magic, TriageRecord::GetMagic(), sizeof(header->magic)) != 0 ||
+        header->version != TriageRecord::kVersion)
+        return false;
+
+    if (!IsValidTable (header->modules_offset, header->num_modules, sizeof(TriageRecord::Module), size, 8) ||
+        !IsValidTable (header->threads_offset, header->num_threads, sizeof(TriageRecord::Thread), size, 8) ||
+        !IsValidTable (header->frames_offset, header->num_frames, sizeof(TriageRecord::Frame), size, 8) ||
+        !IsValidTable (header->strings_offset, header->num_strings, sizeof(uint32_t), size, 8) ||
+        !IsValidTable (header->string_data_offset, header->string_data_size, 1, size, 1))
+        return false;
+
+    // The string data has to end with a terminator so that every string
+    // does.
+    const char *string_data = static_cast<const char *>(bytes) + header->string_data_offset;
+    if (header->num_strings > 0 && (header->string_data_size == 0 || string_data[header->string_data_size - 1] != '\0'))
+        return false;
+
+    m_bytes = static_cast<const uint8_t *>(bytes);
+    m_size = size;
+    m_header = header;
+
+    // Frames of a thread that fall outside the frame table are dropped
+    // by GetFrameAtIndex, strings past the data by GetString.
+    return true;
+}
+
+const TriageRecord::Module *
+TriageRecordReader::GetModuleAtIndex (uint32_t idx) const
+{
+    if (idx >= GetNumModules())
+        return nullptr;
+    return reinterpret_cast<const TriageRecord::Module *>(m_bytes + m_header->modules_offset) + idx;
+}
+
+const TriageRecord::Thread *
+TriageRecordReader::GetThreadAtIndex (uint32_t idx) const
+{
+    if (idx >= GetNumThreads())
+        return nullptr;
+    return reinterpret_cast<const TriageRecord::Thread *>(m_bytes + m_header->threads_offset) + idx;
+}
+
+const TriageRecord::Frame *
+TriageRecordReader::GetFrameAtIndex (const TriageRecord::Thread &thread, uint32_t idx) const
+{
+    if (m_header == nullptr || idx >= thread.num_frames)
+        return nullptr;
+    const uint64_t frame_idx = (uint64_t)thread.first_frame + idx;
+    if (frame_idx >= m_header->num_frames)
+        return nullptr;
+    return reinterpret_cast<const TriageRecord::Frame *>(m_bytes + m_header->frames_offset) + frame_idx;
+}
+
+const char *
+TriageRecordReader::GetString (uint32_t idx) const
+{
+    if (m_header == nullptr || idx >= m_header->num_strings)
+        return nullptr;
+    const uint32_t offset = reinterpret_cast<const uint32_t *>(m_bytes + m_header->strings_offset)[idx];
+    if (offset >= m_header->string_data_size)
+        return nullptr;
+    return reinterpret_cast<const char *>(m_bytes + m_header->string_data_offset + offset);
+}
@@ -0,0 +1,116 @@
+//===-- XXHash.cpp ----------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/XXHash.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    const uint64_t g_prime1 = 11400714785074694791ULL;
+    const uint64_t g_prime2 = 14029467366897019727ULL;
+    const uint64_t g_prime3 = 1609587929392839161ULL;
+    const uint64_t g_prime4 = 9650029242287828579ULL;
+    const uint64_t g_prime5 = 2870177450012600261ULL;
+
+    inline uint64_t
+    RotateLeft (uint64_t value, unsigned bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    // The input is read as little endian words whatever the host is.
+    inline uint64_t
+    Read64 (const uint8_t *p)
+    {
+        return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+               ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+    }
+
+    inline uint32_t
+    Read32 (const uint8_t *p)
+    {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    inline uint64_t
+    Round (uint64_t acc, uint64_t input)
+    {
+        acc += input * g_prime2;
+        acc = RotateLeft(acc, 31);
+        return acc * g_prime1;
+    }
+
+    inline uint64_t
+    MergeRound (uint64_t acc, uint64_t value)
+    {
+        acc ^= Round(0, value);
+        return acc * g_prime1 + g_prime4;
+    }
+}
+
+uint64_t
+lldb_private::XXHash64 (const void *data, size_t length, uint64_t seed)
+{
+    const uint8_t *p = static_cast<const uint8_t *>(data);
+    const uint8_t *const end = p + length;
+    uint64_t hash;
+
+    if (length >= 32)
+    {
+        // Four independent lanes of 8 bytes each.
+        uint64_t v1 = seed + g_prime1 + g_prime2;
+        uint64_t v2 = seed + g_prime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - g_prime1;
+        const uint8_t *const limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        hash = RotateLeft(v1, 1) + RotateLeft(v2, 7) + RotateLeft(v3, 12) + RotateLeft(v4, 18);
+        hash = MergeRound(hash, v1);
+        hash = MergeRound(hash, v2);
+        hash = MergeRound(hash, v3);
+        hash = MergeRound(hash, v4);
+    }
+    else
+        hash = seed + g_prime5;
+
+    hash += length;
+
+    for (; p + 8 <= end; p += 8)
+    {
+        hash ^= Round(0, Read64(p));
+        hash = RotateLeft(hash, 27) * g_prime1 + g_prime4;
+    }
+    if (p + 4 <= end)
+    {
+        hash ^= (uint64_t)Read32(p) * g_prime1;
+        hash = RotateLeft(hash, 23) * g_prime2 + g_prime3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+    {
+        hash ^= (uint64_t)*p * g_prime5;
+        hash = RotateLeft(hash, 11) * g_prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= g_prime2;
+    hash ^= hash >> 29;
+    hash *= g_prime3;
+    hash ^= hash >> 32;
+    return hash;
+}
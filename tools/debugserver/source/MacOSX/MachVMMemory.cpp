@@ -469,6 +469,20 @@ MachVMMemory::Read(task_t task, nub_addr_t address, void *data, nub_size_t data_
     if (data == NULL || data_count == 0)
         return 0;
 
+    // Most reads are of memory that is mapped entirely, read it straight
+    // into the caller's buffer with a single VM call. mach_vm_read_overwrite
+    // fails as a whole if any page isn't readable, in which case we fall
+    // back to reading page by page to get as many bytes as we can.
+    if (data_count > MaxBytesLeftInPage(task, address, data_count))
+    {
+        mach_vm_size_t bytes_read = 0;
+        m_err = ::mach_vm_read_overwrite (task, address, data_count, (mach_vm_address_t)data, &bytes_read);
+        if (DNBLogCheckLogBit(LOG_MEMORY))
+            m_err.LogThreaded("::mach_vm_read_overwrite ( task = 0x%4.4x, addr = 0x%8.8llx, size = %llu, data => %8.8p, outsize => %llu )", task, (uint64_t)address, (uint64_t)data_count, data, (uint64_t)bytes_read);
+        if (m_err.Success() && bytes_read == data_count)
+            return data_count;
+    }
+
     nub_size_t total_bytes_read = 0;
     nub_addr_t curr_addr = address;
     uint8_t *curr_data = (uint8_t*)data;
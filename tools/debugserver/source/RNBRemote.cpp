@@ -46,6 +46,7 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <unordered_set>
@@ -220,6 +221,8 @@ RNBRemote::CreatePacketTable  ()
     t.push_back (Packet (read_memory,                   &RNBRemote::HandlePacket_m,             NULL, "m", "Read memory"));
     t.push_back (Packet (read_register,                 &RNBRemote::HandlePacket_p,             NULL, "p", "Read one register"));
     t.push_back (Packet (read_general_regs,             &RNBRemote::HandlePacket_g,             NULL, "g", "Read registers"));
+    // Must come before "M", packets are matched by prefix in table order.
+    t.push_back (Packet (multi_mem_read,                &RNBRemote::HandlePacket_MultiMemRead,  NULL, "MultiMemRead:", "Read several ranges of memory"));
     t.push_back (Packet (write_memory,                  &RNBRemote::HandlePacket_M,             NULL, "M", "Write memory"));
     t.push_back (Packet (write_register,                &RNBRemote::HandlePacket_P,             NULL, "P", "Write one register"));
     t.push_back (Packet (write_general_regs,            &RNBRemote::HandlePacket_G,             NULL, "G", "Write registers"));
@@ -3139,6 +3142,121 @@ RNBRemote::HandlePacket_x (const char *p)
     return SendPacket (ostrm.str ());
 }
 
+// MultiMemRead:ranges:ADDRESS,LENGTH,ADDRESS,LENGTH,...;
+//
+// The ranges are sorted and the ones that overlap or touch are merged, so
+// that every contiguous span is read with one memory read. The reply has
+// the number of bytes read from each range, in the order they were
+// requested, a ';' and then the bytes of all of the ranges.
+rnb_err_t
+RNBRemote::HandlePacket_MultiMemRead (const char *p)
+{
+    if (!m_ctx.HasValidProcessID())
+        return SendPacket ("E15");
+
+    const char *ranges_str = strstr (p, "ranges:");
+    if (ranges_str == NULL)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "No ranges in MultiMemRead packet");
+    ranges_str += strlen ("ranges:");
+
+    // Keep the response within the packet size we advertise in qSupported
+    const uint64_t max_total_size = 128 * 1024;
+
+    struct MemoryRange
+    {
+        nub_addr_t addr;
+        nub_size_t size;
+        nub_size_t buf_offset;
+        nub_size_t bytes_read;
+    };
+    std::vector<MemoryRange> ranges;
+    uint64_t total_size = 0;
+    const char *c = ranges_str;
+    while (*c != '\0' && *c != ';')
+    {
+        char *end;
+        MemoryRange range;
+        errno = 0;
+        range.addr = strtoull (c, &end, 16);
+        if (errno != 0 || end == c || *end != ',')
+            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in MultiMemRead packet");
+        c = end + 1;
+        errno = 0;
+        range.size = strtoull (c, &end, 16);
+        if (errno != 0 || end == c)
+            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in MultiMemRead packet");
+        c = end;
+        if (*c == ',')
+            ++c;
+        else if (*c != '\0' && *c != ';')
+            return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Comma sep missing in MultiMemRead packet");
+
+        range.buf_offset = total_size;
+        range.bytes_read = 0;
+        total_size += range.size;
+        if (total_size > max_total_size)
+            return SendPacket ("E78");
+        ranges.push_back (range);
+    }
+    if (ranges.empty())
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "No ranges in MultiMemRead packet");
+
+    std::vector<uint8_t> buf (total_size);
+
+    // Read the ranges in address order, merging the ones that overlap or
+    // are adjacent into one span.
+    std::vector<size_t> order (ranges.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::sort (order.begin(), order.end(), [&ranges](size_t lhs, size_t rhs) {
+        return ranges[lhs].addr < ranges[rhs].addr;
+    });
+
+    std::vector<uint8_t> span_buf;
+    size_t span_first = 0;
+    while (span_first < order.size())
+    {
+        const nub_addr_t span_addr = ranges[order[span_first]].addr;
+        nub_addr_t span_end = span_addr + ranges[order[span_first]].size;
+        size_t span_last = span_first + 1;
+        while (span_last < order.size() && ranges[order[span_last]].addr <= span_end)
+        {
+            span_end = std::max<nub_addr_t> (span_end, ranges[order[span_last]].addr + ranges[order[span_last]].size);
+            ++span_last;
+        }
+
+        span_buf.resize (span_end - span_addr);
+        nub_size_t span_bytes_read = 0;
+        if (!span_buf.empty())
+            span_bytes_read = DNBProcessMemoryRead (m_ctx.ProcessID(), span_addr, span_buf.size(), &span_buf[0]);
+
+        // A read stops at the first address that can't be read, every range
+        // gets the bytes of the span up to that address.
+        for (size_t i = span_first; i < span_last; ++i)
+        {
+            MemoryRange &range = ranges[order[i]];
+            const nub_size_t offset = range.addr - span_addr;
+            if (span_bytes_read > offset)
+                range.bytes_read = std::min<nub_size_t> (range.size, span_bytes_read - offset);
+            if (range.bytes_read > 0)
+                memcpy (&buf[range.buf_offset], &span_buf[offset], range.bytes_read);
+        }
+        span_first = span_last;
+    }
+
+    std::ostringstream ostrm;
+    for (size_t i = 0; i < ranges.size(); ++i)
+        ostrm << (i > 0 ? "," : "") << std::hex << (uint64_t)ranges[i].bytes_read;
+    ostrm << ';';
+    for (const MemoryRange &range : ranges)
+    {
+        if (range.bytes_read > 0)
+            ostrm << binary_encode_string (std::string ((const char *)&buf[range.buf_offset], range.bytes_read));
+    }
+
+    return SendPacket (ostrm.str ());
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_X (const char *p)
 {
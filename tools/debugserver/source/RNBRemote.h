@@ -71,6 +71,7 @@ public:
         vcont_list_actions,             // 'vCont?'
         read_data_from_memory,          // 'x'
         write_data_to_memory,           // 'X'
+        multi_mem_read,                 // 'MultiMemRead:'
         insert_mem_bp,                  // 'Z0'
         remove_mem_bp,                  // 'z0'
         insert_hardware_bp,             // 'Z1'
@@ -220,6 +221,7 @@ public:
     rnb_err_t HandlePacket_M (const char *p);
     rnb_err_t HandlePacket_x (const char *p);
     rnb_err_t HandlePacket_X (const char *p);
+    rnb_err_t HandlePacket_MultiMemRead (const char *p);
     rnb_err_t HandlePacket_g (const char *p);
     rnb_err_t HandlePacket_G (const char *p);
     rnb_err_t HandlePacket_z (const char *p);
@@ -25,6 +25,13 @@
 #include <unistd.h>
 #endif
 
+#if !defined(_WIN32)
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include <algorithm>
 #include <string>
 
 #include "lldb/API/SBBreakpoint.h"
@@ -36,6 +43,7 @@
 #include "lldb/API/SBHostOS.h"
 #include "lldb/API/SBLanguageRuntime.h"
 #include "lldb/API/SBListener.h"
+#include "lldb/API/SBModule.h"
 #include "lldb/API/SBProcess.h"
 #include "lldb/API/SBStream.h"
 #include "lldb/API/SBStringList.h"
@@ -83,6 +91,7 @@ typedef struct
 } OptionDefinition;
 
 #define LLDB_3_TO_5 LLDB_OPT_SET_3|LLDB_OPT_SET_4|LLDB_OPT_SET_5
+#define LLDB_3_TO_5_AND_8 LLDB_3_TO_5|LLDB_OPT_SET_8
 #define LLDB_4_TO_5 LLDB_OPT_SET_4|LLDB_OPT_SET_5
 
 static OptionDefinition g_options[] =
@@ -108,22 +117,22 @@ static OptionDefinition g_options[] =
         "Tells the debugger to read in and execute the lldb commands in the given file, after any file provided on the command line has been loaded." },
     { LLDB_3_TO_5,       false, "one-line"         , 'o', required_argument, 0,  eArgTypeNone,
         "Tells the debugger to execute this one-line lldb command after any file provided on the command line has been loaded." },
-    { LLDB_3_TO_5,       false, "source-before-file"         , 'S', required_argument, 0,  eArgTypeFilename,
+    { LLDB_3_TO_5_AND_8, false, "source-before-file"         , 'S', required_argument, 0,  eArgTypeFilename,
         "Tells the debugger to read in and execute the lldb commands in the given file, before any file provided on the command line has been loaded." },
-    { LLDB_3_TO_5,       false, "one-line-before-file"         , 'O', required_argument, 0,  eArgTypeNone,
+    { LLDB_3_TO_5_AND_8, false, "one-line-before-file"         , 'O', required_argument, 0,  eArgTypeNone,
         "Tells the debugger to execute this one-line lldb command before any file provided on the command line has been loaded." },
     { LLDB_3_TO_5,       false, "one-line-on-crash"         , 'k', required_argument, 0,  eArgTypeNone,
         "When in batch mode, tells the debugger to execute this one-line lldb command if the target crashes." },
     { LLDB_3_TO_5,       false, "source-on-crash"         , 'K', required_argument, 0,  eArgTypeFilename,
         "When in batch mode, tells the debugger to source this file of lldb commands if the target crashes." },
-    { LLDB_3_TO_5,       false, "source-quietly"          , 'Q', no_argument      , 0,  eArgTypeNone,
+    { LLDB_3_TO_5_AND_8, false, "source-quietly"          , 'Q', no_argument      , 0,  eArgTypeNone,
         "Tells the debugger to execute this one-line lldb command before any file provided on the command line has been loaded." },
     { LLDB_3_TO_5,       false, "batch"          , 'b', no_argument      , 0,  eArgTypeNone,
         "Tells the debugger to running the commands from -s, -S, -o & -O, and then quit.  However if any run command stopped due to a signal or crash, "
         "the debugger will return to the interactive prompt at the place of the crash." },
     { LLDB_3_TO_5,       false, "editor"         , 'e', no_argument      , 0,  eArgTypeNone,
         "Tells the debugger to open source files using the host's \"external editor\" mechanism." },
-    { LLDB_3_TO_5,       false, "no-lldbinit"    , 'x', no_argument      , 0,  eArgTypeNone,
+    { LLDB_3_TO_5_AND_8, false, "no-lldbinit"    , 'x', no_argument      , 0,  eArgTypeNone,
         "Do not automatically parse any '.lldbinit' files." },
     { LLDB_3_TO_5,       false, "no-use-colors"  , 'X', no_argument      , 0,  eArgTypeNone,
         "Do not use colors." },
@@ -139,6 +148,11 @@ static OptionDefinition g_options[] =
         "Runs lldb in REPL mode with a stub process." },
     { LLDB_OPT_SET_7,  true , "repl-language"      , 'R', required_argument, 0,  eArgTypeNone,
         "Chooses the language for the REPL." },
+    { LLDB_OPT_SET_8,  true , "server-mode"        , 'M', required_argument, 0,  eArgTypePath,
+        "Keeps the debugger running and accepts batch jobs on the Unix socket at <path>.  Each connection is "
+        "one job: the client writes lldb commands, one per line, and shuts down its side of the connection.  "
+        "The output of the commands is sent back and the targets the job created are deleted, the modules "
+        "they loaded stay cached for the next jobs." },
     { 0,                 false, NULL             , 0  , 0                , 0,  eArgTypeNone,         NULL }
 };
 
@@ -428,6 +442,7 @@ Driver::OptionData::OptionData () :
     m_process_pid(LLDB_INVALID_PROCESS_ID),
     m_use_external_editor(false),
     m_batch(false),
+    m_server_socket_path(),
     m_seen_options()
 {
 }
@@ -473,6 +488,7 @@ Driver::OptionData::Clear ()
     m_wait_for = false;
     m_process_name.erase();
     m_batch = false;
+    m_server_socket_path.clear();
     m_after_crash_commands.clear();
 
     m_process_pid = LLDB_INVALID_PROCESS_ID;
@@ -736,6 +752,10 @@ Driver::ParseArgs (int argc, const char *argv[], FILE *out_fh, bool &exiting)
                         m_option_data.m_batch = true;
                         break;
 
+                    case 'M':
+                        m_option_data.m_server_socket_path = optarg;
+                        break;
+
                     case 'c':
                         {
                             SBFileSpec file(optarg);
@@ -1246,6 +1266,224 @@ Driver::MainLoop ()
     SBDebugger::Destroy (m_debugger);
 }
 
+#if !defined(_WIN32)
+// Write all of the data to the job connection, a client that went away
+// truncates its output but the job still runs to completion.
+static void
+WriteToJobConnection (int fd, const char *data, size_t length)
+{
+    while (length > 0)
+    {
+        const ssize_t bytes_written = ::write (fd, data, length);
+        if (bytes_written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return;
+        }
+        data += bytes_written;
+        length -= bytes_written;
+    }
+}
+
+static void
+WriteToJobConnection (int fd, const char *cstr)
+{
+    if (cstr)
+        WriteToJobConnection (fd, cstr, strlen (cstr));
+}
+#endif
+
+// The modules of the deleted job targets that are kept alive for the next
+// jobs, the least recently used ones are dropped first.
+static const size_t g_server_module_cache_size = 1024;
+
+void
+Driver::RunServerJob (int fd, std::vector<SBModule> &module_cache)
+{
+#if !defined(_WIN32)
+    // The client shuts down its side of the connection once it has sent
+    // all of the commands of the job.
+    std::string commands;
+    char buffer[4096];
+    while (1)
+    {
+        const ssize_t bytes_read = ::read (fd, buffer, sizeof(buffer));
+        if (bytes_read < 0 && errno == EINTR)
+            continue;
+        if (bytes_read <= 0)
+            break;
+        commands.append (buffer, bytes_read);
+    }
+
+    // Targets that already existed, e.g. from the -O commands, are shared by
+    // all of the jobs, the ones the job creates are deleted when it is done.
+    std::vector<SBTarget> server_targets;
+    const uint32_t num_server_targets = m_debugger.GetNumTargets();
+    for (uint32_t i = 0; i < num_server_targets; ++i)
+        server_targets.push_back (m_debugger.GetTargetAtIndex (i));
+    SBTarget selected_target = m_debugger.GetSelectedTarget();
+
+    SBCommandInterpreter sb_interpreter = m_debugger.GetCommandInterpreter();
+    size_t line_start = 0;
+    while (line_start < commands.size())
+    {
+        size_t line_end = commands.find ('\n', line_start);
+        if (line_end == std::string::npos)
+            line_end = commands.size();
+        std::string command = commands.substr (line_start, line_end - line_start);
+        line_start = line_end + 1;
+        if (!command.empty() && command.back() == '\r')
+            command.pop_back();
+        if (command.empty())
+            continue;
+
+        WriteToJobConnection (fd, "(lldb) ");
+        WriteToJobConnection (fd, command.c_str());
+        WriteToJobConnection (fd, "\n");
+
+        SBCommandReturnObject result;
+        sb_interpreter.HandleCommand (command.c_str(), result, false);
+        WriteToJobConnection (fd, result.GetOutput(), result.GetOutputSize());
+        WriteToJobConnection (fd, result.GetError(), result.GetErrorSize());
+
+        // "quit" ends the job, not the server.
+        if (result.GetStatus() == eReturnStatusQuit)
+            break;
+    }
+
+    for (uint32_t i = m_debugger.GetNumTargets(); i > 0; --i)
+    {
+        SBTarget target = m_debugger.GetTargetAtIndex (i - 1);
+        if (std::find (server_targets.begin(), server_targets.end(), target) != server_targets.end())
+            continue;
+
+        // Deleting a target throws away the shared modules nothing else
+        // uses, hold on to them so the next jobs on the same binaries don't
+        // have to parse their object and symbol files again.
+        const uint32_t num_modules = target.GetNumModules();
+        for (uint32_t module_idx = 0; module_idx < num_modules; ++module_idx)
+        {
+            SBModule module = target.GetModuleAtIndex (module_idx);
+            std::vector<SBModule>::iterator pos = std::find (module_cache.begin(), module_cache.end(), module);
+            if (pos != module_cache.end())
+                module_cache.erase (pos);
+            module_cache.push_back (module);
+        }
+        if (module_cache.size() > g_server_module_cache_size)
+            module_cache.erase (module_cache.begin(),
+                                module_cache.begin() + (module_cache.size() - g_server_module_cache_size));
+
+        m_debugger.DeleteTarget (target);
+    }
+    if (selected_target.IsValid())
+        m_debugger.SetSelectedTarget (selected_target);
+#endif
+}
+
+void
+Driver::ServerLoop ()
+{
+#if defined(_WIN32)
+    ::fprintf (stderr, "error: --server-mode is not supported on this platform\n");
+#else
+    ::setbuf (stdout, NULL);
+
+    m_debugger.SetErrorFileHandle (stderr, false);
+    m_debugger.SetOutputFileHandle (stdout, false);
+
+    // The commands of a job run one after the other, a command that resumes
+    // a process only returns once the process stopped again.
+    m_debugger.SetAsync (false);
+
+    SBCommandInterpreter sb_interpreter = m_debugger.GetCommandInterpreter();
+    SBCommandReturnObject result;
+    sb_interpreter.SourceInitFileInHomeDirectory(result);
+    if (GetDebugMode())
+    {
+        result.PutError (m_debugger.GetErrorFileHandle());
+        result.PutOutput (m_debugger.GetOutputFileHandle());
+    }
+
+    // The -O and -S commands set up the server, they run once before the
+    // first job.
+    SBStream commands_stream;
+    WriteCommandsForSourcing (eCommandPlacementBeforeFile, commands_stream);
+    std::string setup_commands (commands_stream.GetData() ? commands_stream.GetData() : "");
+    size_t line_start = 0;
+    while (line_start < setup_commands.size())
+    {
+        size_t line_end = setup_commands.find ('\n', line_start);
+        if (line_end == std::string::npos)
+            line_end = setup_commands.size();
+        std::string command = setup_commands.substr (line_start, line_end - line_start);
+        line_start = line_end + 1;
+        if (command.empty())
+            continue;
+        SBCommandReturnObject setup_result;
+        sb_interpreter.HandleCommand (command.c_str(), setup_result, false);
+        setup_result.PutError (m_debugger.GetErrorFileHandle());
+        setup_result.PutOutput (m_debugger.GetOutputFileHandle());
+        if (setup_result.GetStatus() == eReturnStatusQuit)
+        {
+            SBDebugger::Destroy (m_debugger);
+            return;
+        }
+    }
+
+    const char *socket_path = m_option_data.m_server_socket_path.c_str();
+    struct sockaddr_un addr;
+    memset (&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (m_option_data.m_server_socket_path.size() >= sizeof(addr.sun_path))
+    {
+        ::fprintf (stderr, "error: the --server-mode socket path is too long: '%s'\n", socket_path);
+        SBDebugger::Destroy (m_debugger);
+        return;
+    }
+    strncpy (addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+    int listen_fd = ::socket (AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0)
+    {
+        ::fprintf (stderr, "error: couldn't create the --server-mode socket: %s\n", strerror (errno));
+        SBDebugger::Destroy (m_debugger);
+        return;
+    }
+
+    // Remove the socket a previous server left behind.
+    ::unlink (socket_path);
+    if (::bind (listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || ::listen (listen_fd, 16) < 0)
+    {
+        ::fprintf (stderr, "error: couldn't listen on '%s': %s\n", socket_path, strerror (errno));
+        ::close (listen_fd);
+        SBDebugger::Destroy (m_debugger);
+        return;
+    }
+    ::fprintf (stdout, "lldb server listening on '%s'\n", socket_path);
+
+    std::vector<SBModule> module_cache;
+    while (1)
+    {
+        const int fd = ::accept (listen_fd, NULL, NULL);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            ::fprintf (stderr, "error: couldn't accept a job on '%s': %s\n", socket_path, strerror (errno));
+            break;
+        }
+        RunServerJob (fd, module_cache);
+        ::close (fd);
+    }
+
+    ::close (listen_fd);
+    ::unlink (socket_path);
+#endif
+
+    SBDebugger::Destroy (m_debugger);
+}
+
 
 void
 Driver::ResizeWindow (unsigned short col)
@@ -1353,7 +1591,10 @@ main(int argc, char const *argv[])
             }
             else if (!exiting)
             {
-                driver.MainLoop();
+                if (driver.IsServerMode())
+                    driver.ServerLoop();
+                else
+                    driver.MainLoop();
             }
         }
 
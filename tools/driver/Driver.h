@@ -22,6 +22,7 @@
 #include "lldb/API/SBBroadcaster.h"
 #include "lldb/API/SBDebugger.h"
 #include "lldb/API/SBError.h"
+#include "lldb/API/SBModule.h"
 
 class IOChannel;
 
@@ -43,6 +44,17 @@ public:
     void
     MainLoop ();
 
+    // Run the jobs sent to the --server-mode socket until the server is
+    // killed.
+    void
+    ServerLoop ();
+
+    bool
+    IsServerMode () const
+    {
+        return !m_option_data.m_server_socket_path.empty();
+    }
+
     lldb::SBError
     ParseArgs (int argc, const char *argv[], FILE *out_fh, bool &do_exit);
 
@@ -114,6 +126,7 @@ public:
         lldb::pid_t m_process_pid;
         bool m_use_external_editor;  // FIXME: When we have set/show variables we can remove this from here.
         bool m_batch;
+        std::string m_server_socket_path;
         typedef std::set<char> OptionSet;
         OptionSet m_seen_options;
     };
@@ -143,6 +156,9 @@ private:
 
     void
     ReadyForCommand ();
+
+    void
+    RunServerJob (int fd, std::vector<lldb::SBModule> &module_cache);
 };
 
 #endif // lldb_Driver_h_
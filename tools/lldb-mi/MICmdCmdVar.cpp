@@ -368,7 +368,20 @@ CMICmdCmdVarUpdate::Execute()
     if (pArgPrintValues->GetFound())
         eVarInfoFormat = static_cast<CMICmnLLDBDebugSessionInfo::VariableInfoFormat_e>(pArgPrintValues->GetValue());
 
+    // "*" updates all of the var objects, which is what front ends do after every step
     const CMIUtilString &rVarObjName(pArgName->GetValue());
+    if (rVarObjName == "*")
+    {
+        CMIUtilString::VecString_t vecVarObjNames;
+        CMICmnLLDBDebugSessionInfoVarObj::VarObjGetNames(vecVarObjNames);
+        for (const CMIUtilString &rName : vecVarObjNames)
+        {
+            if (!UpdateVarObj(rName, eVarInfoFormat))
+                return MIstatus::failure;
+        }
+        return MIstatus::success;
+    }
+
     CMICmnLLDBDebugSessionInfoVarObj varObj;
     if (!CMICmnLLDBDebugSessionInfoVarObj::VarObjGet(rVarObjName, varObj))
     {
@@ -376,18 +389,42 @@ CMICmdCmdVarUpdate::Execute()
         return MIstatus::failure;
     }
 
+    return UpdateVarObj(rVarObjName, eVarInfoFormat);
+}
+
+//++ ------------------------------------------------------------------------------------
+// Details: Check a var object for a change and add it to the change list if it changed.
+//          Only a changed var object is formatted again, and only if its value is
+//          printed, others keep the formatted value cached by the var object.
+// Type:    Method.
+// Args:    vrStrVarObjName - (R) Session var object's name.
+//          veVarInfoFormat - (R) Which values to print.
+// Return:  MIstatus::success - Functional succeeded.
+//          MIstatus::failure - Functional failed.
+// Throws:  None.
+//--
+bool
+CMICmdCmdVarUpdate::UpdateVarObj(const CMIUtilString &vrStrVarObjName,
+                                 const CMICmnLLDBDebugSessionInfo::VariableInfoFormat_e veVarInfoFormat)
+{
+    CMICmnLLDBDebugSessionInfoVarObj varObj;
+    if (!CMICmnLLDBDebugSessionInfoVarObj::VarObjGet(vrStrVarObjName, varObj))
+        return MIstatus::success;
+
     lldb::SBValue &rValue = varObj.GetValue();
-    if (!ExamineSBValueForChange(rValue, m_bValueChanged))
+    bool bValueChanged = false;
+    if (!ExamineSBValueForChange(rValue, bValueChanged))
         return MIstatus::failure;
 
-    if (m_bValueChanged)
+    if (bValueChanged)
     {
+        m_bValueChanged = true;
         varObj.UpdateValue();
-        const bool bPrintValue((eVarInfoFormat == CMICmnLLDBDebugSessionInfo::eVariableInfoFormat_AllValues) ||
-                               (eVarInfoFormat == CMICmnLLDBDebugSessionInfo::eVariableInfoFormat_SimpleValues && rValue.GetNumChildren() == 0));
+        const bool bPrintValue((veVarInfoFormat == CMICmnLLDBDebugSessionInfo::eVariableInfoFormat_AllValues) ||
+                               (veVarInfoFormat == CMICmnLLDBDebugSessionInfo::eVariableInfoFormat_SimpleValues && rValue.GetNumChildren() == 0));
         const CMIUtilString strValue(bPrintValue ? varObj.GetValueFormatted() : "");
         const CMIUtilString strInScope(rValue.IsInScope() ? "true" : "false");
-        MIFormResponse(rVarObjName, bPrintValue ? strValue.c_str() : nullptr, strInScope);
+        MIFormResponse(vrStrVarObjName, bPrintValue ? strValue.c_str() : nullptr, strInScope);
     }
 
     return MIstatus::success;
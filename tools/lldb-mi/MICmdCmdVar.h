@@ -113,6 +113,7 @@ class CMICmdCmdVarUpdate : public CMICmdBase
     // Methods:
   private:
     bool ExamineSBValueForChange(lldb::SBValue &vrwValue, bool &vrwbChanged);
+    bool UpdateVarObj(const CMIUtilString &vrStrVarObjName, const CMICmnLLDBDebugSessionInfo::VariableInfoFormat_e veVarInfoFormat);
     void MIFormResponse(const CMIUtilString &vrStrVarName, const char *const vpValue, const CMIUtilString &vrStrScope);
 
     // Attribute:
@@ -35,6 +35,7 @@ CMICmnLLDBDebugSessionInfoVarObj::varFormat_e CMICmnLLDBDebugSessionInfoVarObj::
 CMICmnLLDBDebugSessionInfoVarObj::CMICmnLLDBDebugSessionInfoVarObj()
     : m_eVarFormat(eVarFormat_Natural)
     , m_eVarType(eVarType_Internal)
+    , m_bFormattedValueValid(false)
 {
     // Do not call UpdateValue() in here as not necessary
 }
@@ -55,6 +56,7 @@ CMICmnLLDBDebugSessionInfoVarObj::CMICmnLLDBDebugSessionInfoVarObj(const CMIUtil
     , m_strName(vrStrName)
     , m_SBValue(vrValue)
     , m_strNameReal(vrStrNameReal)
+    , m_bFormattedValueValid(false)
 {
     UpdateValue();
 }
@@ -76,6 +78,7 @@ CMICmnLLDBDebugSessionInfoVarObj::CMICmnLLDBDebugSessionInfoVarObj(const CMIUtil
     , m_strName(vrStrName)
     , m_SBValue(vrValue)
     , m_strNameReal(vrStrNameReal)
+    , m_bFormattedValueValid(false)
     , m_strVarObjParentName(vrStrVarObjParentName)
 {
     UpdateValue();
@@ -166,6 +169,7 @@ CMICmnLLDBDebugSessionInfoVarObj::CopyOther(const CMICmnLLDBDebugSessionInfoVarO
     m_SBValue = vrOther.m_SBValue;
     m_strNameReal = vrOther.m_strNameReal;
     m_strFormattedValue = vrOther.m_strFormattedValue;
+    m_bFormattedValueValid = vrOther.m_bFormattedValueValid;
     m_strVarObjParentName = vrOther.m_strVarObjParentName;
 
     return MIstatus::success;
@@ -193,6 +197,7 @@ CMICmnLLDBDebugSessionInfoVarObj::MoveOther(CMICmnLLDBDebugSessionInfoVarObj &vr
     vrwOther.m_SBValue.Clear();
     vrwOther.m_strNameReal.clear();
     vrwOther.m_strFormattedValue.clear();
+    vrwOther.m_bFormattedValueValid = false;
     vrwOther.m_strVarObjParentName.clear();
 
     return MIstatus::success;
@@ -412,6 +417,22 @@ CMICmnLLDBDebugSessionInfoVarObj::VarObjGet(const CMIUtilString &vrVarName, CMIC
     return false;
 }
 
+//++ ------------------------------------------------------------------------------------
+// Details: Retrieve the names of all the var objects in the internal container.
+// Type:    Static method.
+// Args:    vrwVecNames - (W) The var object names.
+// Returns: None.
+// Throws:  None.
+//--
+void
+CMICmnLLDBDebugSessionInfoVarObj::VarObjGetNames(CMIUtilString::VecString_t &vrwVecNames)
+{
+    vrwVecNames.clear();
+    vrwVecNames.reserve(ms_mapVarIdToVarObj.size());
+    for (const auto &rPair : ms_mapVarIdToVarObj)
+        vrwVecNames.push_back(rPair.first);
+}
+
 //++ ------------------------------------------------------------------------------------
 // Details: A count is kept of the number of var value objects created. This is count is
 //          used to ID the var value object. Reset the count to 0.
@@ -505,6 +526,21 @@ CMICmnLLDBDebugSessionInfoVarObj::GetNameReal() const
 const CMIUtilString &
 CMICmnLLDBDebugSessionInfoVarObj::GetValueFormatted() const
 {
+    if (!m_bFormattedValueValid)
+    {
+        m_strFormattedValue = GetValueStringFormatted(m_SBValue, m_eVarFormat);
+        m_bFormattedValueValid = true;
+
+        // Callers work on copies of the var object, keep the formatted value
+        // in the container too so it is not formatted again until the next update
+        const MapKeyToVarObj_t::iterator it = ms_mapVarIdToVarObj.find(m_strName);
+        if ((it != ms_mapVarIdToVarObj.end()) && (&(*it).second != this))
+        {
+            (*it).second.m_strFormattedValue = m_strFormattedValue;
+            (*it).second.m_bFormattedValueValid = true;
+        }
+    }
+
     return m_strFormattedValue;
 }
 
@@ -563,7 +599,10 @@ CMICmnLLDBDebugSessionInfoVarObj::SetVarFormat(const varFormat_e veVarFormat)
 void
 CMICmnLLDBDebugSessionInfoVarObj::UpdateValue()
 {
-    m_strFormattedValue = GetValueStringFormatted(m_SBValue, m_eVarFormat);
+    // Formatting walks the children of composite values, only do it when the
+    // value is asked for. Var objects listed without values are never formatted.
+    m_strFormattedValue.clear();
+    m_bFormattedValueValid = false;
 
     MIuint64 nValue = 0;
     if (CMICmnLLDBProxySBValue::GetValueAsUnsigned(m_SBValue, nValue) == MIstatus::failure)
@@ -60,6 +60,7 @@ class CMICmnLLDBDebugSessionInfoVarObj
     static void VarObjDelete(const CMIUtilString &vrVarName);
     static bool VarObjGet(const CMIUtilString &vrVarName, CMICmnLLDBDebugSessionInfoVarObj &vrwVarObj);
     static void VarObjUpdate(const CMICmnLLDBDebugSessionInfoVarObj &vrVarObj);
+    static void VarObjGetNames(CMIUtilString::VecString_t &vrwVecNames);
     static void VarObjIdInc();
     static MIuint VarObjIdGet();
     static void VarObjIdResetToZero();
@@ -123,7 +124,8 @@ class CMICmnLLDBDebugSessionInfoVarObj
     CMIUtilString m_strName;
     lldb::SBValue m_SBValue;
     CMIUtilString m_strNameReal;
-    CMIUtilString m_strFormattedValue;
+    mutable CMIUtilString m_strFormattedValue; // Cached, formatted on first use after an update
+    mutable bool m_bFormattedValueValid;
     CMIUtilString m_strVarObjParentName;
     // *** Update the copy move constructors and assignment operator ***
 };
@@ -0,0 +1,173 @@
+//===-- lldb-perf-backtrace.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string>
+
+using namespace lldb_perf;
+
+// Measures loading a core file of a process with many threads and running
+// "bt all" on it. Each iteration starts over with a new target so that
+// nothing is cached from the previous one.
+class BacktraceTest : public TestCase
+{
+public:
+    BacktraceTest () :
+        TestCase(),
+        m_time_load_core ([this] () -> void
+                          {
+                              m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+                              m_process = m_target.LoadCore(m_core_path.c_str());
+                          }, "time-load-core", "The time it takes to create the target and load the core file."),
+        m_time_bt_all ([this] () -> void
+                       {
+                           RunCommand("bt all");
+                       }, "time-bt-all", "The time it takes to run \"bt all\" the first time after loading the core file."),
+        m_time_bt_all_again ([this] () -> void
+                             {
+                                 RunCommand("bt all");
+                             }, "time-bt-all-again", "The time it takes to run \"bt all\" again, once the stacks were unwound."),
+        m_memory_total (),
+        m_exe_path (),
+        m_core_path (),
+        m_out_path (),
+        m_iterations (5),
+        m_num_threads (0)
+    {
+    }
+
+    virtual
+    ~BacktraceTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty() || m_core_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' and '--core=PATH' options are mandatory\n");
+            return false;
+        }
+        return true;
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        m_memory_total.Start();
+        for (int i = 0; i < m_iterations; ++i)
+        {
+            m_time_load_core();
+            if (!m_process.IsValid())
+            {
+                fprintf (stderr, "error: couldn't load the core file '%s'\n", m_core_path.c_str());
+                exit(1);
+            }
+            m_num_threads = m_process.GetNumThreads();
+            m_time_bt_all();
+            m_time_bt_all_again();
+
+            m_debugger.DeleteTarget(m_target);
+            m_process.Clear();
+            m_target.Clear();
+        }
+        m_memory_total.Stop();
+        next_action.Kill();
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        results_dict.AddUnsigned ("num-threads", "The number of threads in the core file.", m_num_threads);
+        m_time_load_core.WriteAverageAndStandardDeviation(results);
+        m_time_bt_all.WriteAverageAndStandardDeviation(results);
+        m_time_bt_all_again.WriteAverageAndStandardDeviation(results);
+        results_dict.Add ("memory-total",
+                          "The total memory that lldb is using at the end of the test.",
+                          m_memory_total.GetStopValue().GetResult(NULL, NULL));
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",    no_argument,        NULL, 'v' },
+            { "test-file",  required_argument,  NULL, 't' },
+            { "core",       required_argument,  NULL, 'c' },
+            { "iterations", required_argument,  NULL, 'i' },
+            { "out-file",   required_argument,  NULL, 'o' },
+            { NULL,         0,                  NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose(true);
+                return true;
+            case 't':
+                m_exe_path = optarg;
+                return true;
+            case 'c':
+                m_core_path = optarg;
+                return true;
+            case 'i':
+                m_iterations = atoi(optarg);
+                return m_iterations > 0;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    void
+    RunCommand (const char *command)
+    {
+        SBCommandReturnObject result;
+        m_debugger.GetCommandInterpreter().HandleCommand(command, result);
+        if (GetVerbose())
+            printf ("%s", result.GetOutput());
+    }
+
+    TimeMeasurement<std::function<void()>> m_time_load_core;
+    TimeMeasurement<std::function<void()>> m_time_bt_all;
+    TimeMeasurement<std::function<void()>> m_time_bt_all_again;
+    MemoryGauge m_memory_total;
+    std::string m_exe_path;
+    std::string m_core_path;
+    std::string m_out_path;
+    int m_iterations;
+    uint32_t m_num_threads;
+};
+
+int main(int argc, const char * argv[])
+{
+    BacktraceTest test;
+    return TestCase::Run(test, argc, argv);
+}
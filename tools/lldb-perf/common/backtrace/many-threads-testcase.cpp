@@ -0,0 +1,55 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Starts a lot of threads that each recurse a while and then crashes, so
+// that there is a core file with many threads with deep stacks. Run with
+// "ulimit -c unlimited".
+
+static pthread_barrier_t g_barrier;
+static int g_depth = 32;
+
+static int
+recurse (int depth, volatile int *sink)
+{
+    if (depth == 0)
+    {
+        pthread_barrier_wait (&g_barrier);
+        while (1)
+            pause ();
+    }
+    *sink += depth;
+    return recurse (depth - 1, sink) + *sink;
+}
+
+static void *
+thread_func (void *arg)
+{
+    volatile int sink = (int)(long)arg;
+    recurse (g_depth, &sink);
+    return NULL;
+}
+
+int main (int argc, char **argv)
+{
+    int num_threads = argc > 1 ? atoi (argv[1]) : 200;
+    if (argc > 2)
+        g_depth = atoi (argv[2]);
+
+    pthread_barrier_init (&g_barrier, NULL, num_threads + 1);
+    for (int i = 0; i < num_threads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create (&thread, NULL, thread_func, (void *)(long)i) != 0)
+        {
+            perror ("pthread_create");
+            return 1;
+        }
+    }
+    pthread_barrier_wait (&g_barrier);
+    printf ("%d threads are ready, crashing.\n", num_threads);
+    fflush (stdout);
+    abort ();
+    return 0;
+}
@@ -14,6 +14,9 @@
 #include "lldb-perf/lib/TestCase.h"
 #include "lldb-perf/lib/Xcode.h"
 #include "llvm/ADT/STLExtras.h"
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
 #include <iostream>
 #include <unistd.h>
 #include <fstream>
@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <map>
+#include <string>
+#include <vector>
+
+struct Point
+{
+    int x;
+    int y;
+
+    int
+    Sum () const
+    {
+        return x + y;
+    }
+};
+
+class Shape
+{
+public:
+    Shape (const char *name) : m_name (name), m_points () {}
+
+    void
+    AddPoint (int x, int y)
+    {
+        Point pt = { x, y };
+        m_points.push_back (pt);
+    }
+
+    size_t
+    GetNumPoints () const
+    {
+        return m_points.size();
+    }
+
+    std::string m_name;
+    std::vector<Point> m_points;
+};
+
+static int
+square (int value)
+{
+    return value * value;
+}
+
+int main (int argc, char **argv)
+{
+    Shape shape ("polygon");
+    for (int i = 0; i < 100; ++i)
+        shape.AddPoint (i, argc * i);
+    std::map<std::string, int> counts;
+    counts["points"] = shape.GetNumPoints();
+    int local = square (argc);
+    printf ("Break here to evaluate expressions: %d %zu\n", local, counts.size()); // break here
+    return 0;
+}
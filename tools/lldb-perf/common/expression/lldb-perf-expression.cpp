@@ -0,0 +1,155 @@
+//===-- lldb-perf-expression.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string>
+
+using namespace lldb_perf;
+
+// Measures the latency of expression evaluation on expression-testcase.cpp:
+// the first expression, which has to set up the expression parser, and then
+// repeated expressions of increasing complexity.
+class ExpressionTest : public TestCase
+{
+public:
+    ExpressionTest () :
+        TestCase(),
+        m_time_first_expr ([] (SBFrame frame) -> void
+                           {
+                               frame.EvaluateExpression("local + 1");
+                           }, "time-first-expr", "The time it takes to evaluate the first expression."),
+        m_time_local_expr ([] (SBFrame frame) -> void
+                           {
+                               frame.EvaluateExpression("local * 2 + argc");
+                           }, "time-local-expr", "The time it takes to evaluate an expression using local variables."),
+        m_time_member_expr ([] (SBFrame frame) -> void
+                            {
+                                frame.EvaluateExpression("shape.m_points[10].x + shape.m_points[20].y");
+                            }, "time-member-expr", "The time it takes to evaluate an expression accessing class members."),
+        m_time_call_expr ([] (SBFrame frame) -> void
+                          {
+                              frame.EvaluateExpression("square(local) + shape.m_points[1].Sum()");
+                          }, "time-call-expr", "The time it takes to evaluate an expression that calls functions in the inferior."),
+        m_time_stl_expr ([] (SBFrame frame) -> void
+                         {
+                             frame.EvaluateExpression("counts.size() + shape.GetNumPoints()");
+                         }, "time-stl-expr", "The time it takes to evaluate an expression that calls methods of STL containers."),
+        m_exe_path (),
+        m_out_path (),
+        m_iterations (20)
+    {
+    }
+
+    virtual
+    ~ExpressionTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' option is mandatory\n");
+            return false;
+        }
+        m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+        m_target.BreakpointCreateBySourceRegex("// break here", SBFileSpec("expression-testcase.cpp"));
+        return Launch({ m_exe_path.c_str() });
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        if (counter == 0)
+        {
+            SBFrame frame (m_thread.GetFrameAtIndex(0));
+            m_time_first_expr(frame);
+            for (int i = 0; i < m_iterations; ++i)
+            {
+                m_time_local_expr(frame);
+                m_time_member_expr(frame);
+                m_time_call_expr(frame);
+                m_time_stl_expr(frame);
+            }
+        }
+        next_action.Kill();
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        m_time_first_expr.WriteAverageAndStandardDeviation(results);
+        m_time_local_expr.WriteAverageAndStandardDeviation(results);
+        m_time_member_expr.WriteAverageAndStandardDeviation(results);
+        m_time_call_expr.WriteAverageAndStandardDeviation(results);
+        m_time_stl_expr.WriteAverageAndStandardDeviation(results);
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",    no_argument,        NULL, 'v' },
+            { "test-file",  required_argument,  NULL, 't' },
+            { "iterations", required_argument,  NULL, 'i' },
+            { "out-file",   required_argument,  NULL, 'o' },
+            { NULL,         0,                  NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose(true);
+                return true;
+            case 't':
+                m_exe_path = optarg;
+                return true;
+            case 'i':
+                m_iterations = atoi(optarg);
+                return m_iterations > 0;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    TimeMeasurement<std::function<void(SBFrame)>> m_time_first_expr;
+    TimeMeasurement<std::function<void(SBFrame)>> m_time_local_expr;
+    TimeMeasurement<std::function<void(SBFrame)>> m_time_member_expr;
+    TimeMeasurement<std::function<void(SBFrame)>> m_time_call_expr;
+    TimeMeasurement<std::function<void(SBFrame)>> m_time_stl_expr;
+    std::string m_exe_path;
+    std::string m_out_path;
+    int m_iterations;
+};
+
+int main(int argc, const char * argv[])
+{
+    ExpressionTest test;
+    return TestCase::Run(test, argc, argv);
+}
@@ -0,0 +1,337 @@
+//===-- lldb-perf-remote-stepping.cpp ---------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Xcode.h has "using namespace lldb", which makes pid_t ambiguous for the
+// system headers, so it comes last.
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+
+extern char **environ;
+
+using namespace lldb_perf;
+
+//----------------------------------------------------------------------
+// Forwards the gdb-remote connection between lldb and lldb-server and
+// delays every chunk of data by a fixed latency, to see how stepping
+// behaves over a slow link.
+//----------------------------------------------------------------------
+class LatencyProxy
+{
+public:
+    LatencyProxy () :
+        m_server_listen_fd (-1),
+        m_client_listen_fd (-1),
+        m_latency_usec (0),
+        m_threads ()
+    {
+    }
+
+    ~LatencyProxy ()
+    {
+        for (std::thread &thread : m_threads)
+            thread.detach();
+    }
+
+    // Listens on two ports on 127.0.0.1, one for lldb-server to connect to
+    // with --reverse-connect and one for lldb.
+    bool
+    Listen (uint32_t latency_usec)
+    {
+        m_latency_usec = latency_usec;
+        m_server_listen_fd = ListenOnAnyPort();
+        m_client_listen_fd = ListenOnAnyPort();
+        return m_server_listen_fd >= 0 && m_client_listen_fd >= 0;
+    }
+
+    uint16_t
+    GetServerPort () const
+    {
+        return GetPort(m_server_listen_fd);
+    }
+
+    uint16_t
+    GetClientPort () const
+    {
+        return GetPort(m_client_listen_fd);
+    }
+
+    // Accepts both connections and starts forwarding in the background.
+    void
+    Start ()
+    {
+        m_threads.push_back(std::thread([this] () -> void
+                                        {
+                                            const int server_fd = ::accept(m_server_listen_fd, NULL, NULL);
+                                            const int client_fd = ::accept(m_client_listen_fd, NULL, NULL);
+                                            if (server_fd < 0 || client_fd < 0)
+                                                return;
+                                            std::thread to_server(&LatencyProxy::Forward, this, client_fd, server_fd);
+                                            Forward(server_fd, client_fd);
+                                            to_server.join();
+                                        }));
+    }
+
+private:
+    static int
+    ListenOnAnyPort ()
+    {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0)
+            return -1;
+        struct sockaddr_in addr;
+        ::memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (::bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || ::listen(fd, 1) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    static uint16_t
+    GetPort (int fd)
+    {
+        struct sockaddr_in addr;
+        socklen_t addr_len = sizeof(addr);
+        if (fd < 0 || ::getsockname(fd, (struct sockaddr *)&addr, &addr_len) != 0)
+            return 0;
+        return ntohs(addr.sin_port);
+    }
+
+    void
+    Forward (int from_fd, int to_fd)
+    {
+        const int one = 1;
+        ::setsockopt(to_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        char buffer[4096];
+        while (true)
+        {
+            const ssize_t bytes_read = ::read(from_fd, buffer, sizeof(buffer));
+            if (bytes_read <= 0)
+                break;
+            if (m_latency_usec > 0)
+                std::this_thread::sleep_for(std::chrono::microseconds(m_latency_usec));
+            for (ssize_t offset = 0; offset < bytes_read; )
+            {
+                const ssize_t bytes_written = ::write(to_fd, buffer + offset, bytes_read - offset);
+                if (bytes_written <= 0)
+                    return;
+                offset += bytes_written;
+            }
+        }
+        ::shutdown(to_fd, SHUT_WR);
+    }
+
+    int m_server_listen_fd;
+    int m_client_listen_fd;
+    uint32_t m_latency_usec;
+    std::vector<std::thread> m_threads;
+};
+
+// Steps over the lines of stepping-testcase.cpp through lldb-server and a
+// LatencyProxy, timing every step.
+class RemoteStepTest : public TestCase
+{
+    typedef void (*no_function) (void);
+
+public:
+    RemoteStepTest () :
+        TestCase(),
+        m_time_connect (),
+        m_time_step (nullptr, "time-step", "The time it takes to step over one line."),
+        m_proxy (),
+        m_server_pid (0),
+        m_exe_path (),
+        m_server_path (),
+        m_out_path (),
+        m_latency_usec (1000),
+        m_num_steps (20),
+        m_steps_taken (0)
+    {
+    }
+
+    virtual
+    ~RemoteStepTest ()
+    {
+        if (m_server_pid > 0)
+        {
+            ::kill(m_server_pid, SIGKILL);
+            ::waitpid(m_server_pid, NULL, 0);
+        }
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty() || m_server_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' and '--lldb-server=PATH' options are mandatory\n");
+            return false;
+        }
+
+        if (!m_proxy.Listen(m_latency_usec))
+        {
+            fprintf (stderr, "error: couldn't listen for the proxy connections\n");
+            return false;
+        }
+        m_proxy.Start();
+
+        std::string server_address = "127.0.0.1:" + std::to_string(m_proxy.GetServerPort());
+        const char *server_argv[] = { m_server_path.c_str(), "gdbserver", "--reverse-connect", server_address.c_str(), "--", m_exe_path.c_str(), NULL };
+        if (::posix_spawn(&m_server_pid, m_server_path.c_str(), NULL, NULL, const_cast<char **>(server_argv), environ) != 0)
+        {
+            fprintf (stderr, "error: couldn't launch '%s'\n", m_server_path.c_str());
+            m_server_pid = 0;
+            return false;
+        }
+
+        m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+        m_first_bp = m_target.BreakpointCreateBySourceRegex("Here is some code to stop at originally.", SBFileSpec("stepping-testcase.cpp"));
+
+        std::string url = "connect://127.0.0.1:" + std::to_string(m_proxy.GetClientPort());
+        SBError error;
+        m_time_connect.Start();
+        m_process = m_target.ConnectRemote(m_listener, url.c_str(), "gdb-remote", error);
+        m_time_connect.Stop();
+        if (!m_process.IsValid() || error.Fail())
+        {
+            fprintf (stderr, "error: couldn't connect to lldb-server: %s\n", error.GetCString());
+            return false;
+        }
+        return true;
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        if (m_steps_taken == 0)
+        {
+            // Run to the first breakpoint, we might get a stop for the
+            // connection first.
+            SBThread thread (m_process.GetThreadAtIndex(0));
+            if (thread.GetStopReason() != eStopReasonBreakpoint)
+            {
+                next_action.Continue();
+                return;
+            }
+            m_first_bp.SetEnabled(false);
+        }
+        else
+        {
+            m_time_step.Stop();
+        }
+
+        if (m_steps_taken++ >= m_num_steps)
+        {
+            next_action.Kill();
+            return;
+        }
+
+        next_action.StepOver(m_process.GetThreadAtIndex(0));
+        m_time_step.Start();
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        results_dict.AddUnsigned ("latency-usec", "The latency the proxy added to each packet, in microseconds.", m_latency_usec);
+        results_dict.AddDouble ("time-connect", "The time it takes to connect to lldb-server.", m_time_connect.GetDeltaValue());
+        m_time_step.WriteAverageAndStandardDeviation(results);
+        results_dict.AddDouble ("total-time", "Total time spent stepping.", m_time_step.GetMetric().GetSum());
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",        no_argument,        NULL, 'v' },
+            { "test-file",      required_argument,  NULL, 't' },
+            { "lldb-server",    required_argument,  NULL, 's' },
+            { "latency-usec",   required_argument,  NULL, 'l' },
+            { "num-steps",      required_argument,  NULL, 'n' },
+            { "out-file",       required_argument,  NULL, 'o' },
+            { NULL,             0,                  NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose(true);
+                return true;
+            case 't':
+                m_exe_path = optarg;
+                return true;
+            case 's':
+                m_server_path = optarg;
+                return true;
+            case 'l':
+                m_latency_usec = strtoul(optarg, NULL, 0);
+                return true;
+            case 'n':
+                m_num_steps = atoi(optarg);
+                return m_num_steps > 0;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    SBBreakpoint m_first_bp;
+    TimeGauge m_time_connect;
+    TimeMeasurement<no_function> m_time_step;
+    LatencyProxy m_proxy;
+    ::pid_t m_server_pid;
+    std::string m_exe_path;
+    std::string m_server_path;
+    std::string m_out_path;
+    uint32_t m_latency_usec;
+    int m_num_steps;
+    int m_steps_taken;
+};
+
+int main(int argc, const char * argv[])
+{
+    RemoteStepTest test;
+    return TestCase::Run(test, argc, argv);
+}
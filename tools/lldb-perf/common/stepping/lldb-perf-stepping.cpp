@@ -1,4 +1,3 @@
-#include <CoreFoundation/CoreFoundation.h>
 
 #include "lldb-perf/lib/Timer.h"
 #include "lldb-perf/lib/Metric.h"
@@ -6,6 +5,7 @@
 #include "lldb-perf/lib/TestCase.h"
 #include "lldb-perf/lib/Xcode.h"
 
+#include <string.h>
 #include <unistd.h>
 #include <string>
 #include <getopt.h>
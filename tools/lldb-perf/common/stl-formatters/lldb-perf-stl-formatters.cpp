@@ -0,0 +1,147 @@
+//===-- lldb-perf-stl-formatters.cpp ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string>
+
+using namespace lldb_perf;
+
+// Measures displaying large STL containers with the data formatters, the
+// way an IDE variables view would, on stl-formatters-testcase.cpp.
+class STLFormattersTest : public TestCase
+{
+public:
+    STLFormattersTest () :
+        TestCase(),
+        m_exe_path (),
+        m_out_path (),
+        m_max_children (10000),
+        m_num_elements (100000)
+    {
+        const char *names[] = { "int_vector", "string_vector", "int_list", "int_string_map", "int_set", "int_unordered_map", "long_string" };
+        for (const char *name : names)
+        {
+            std::string measurement_name = std::string("time-display-") + name;
+            m_names.push_back(name);
+            m_measurements.push_back(CreateTimeMeasurement(std::function<void(SBValue)>([] (SBValue value) -> void
+                                                                                        {
+                                                                                            Xcode::FetchVariable (value, 1, false);
+                                                                                        }), measurement_name.c_str(), NULL));
+        }
+    }
+
+    virtual
+    ~STLFormattersTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' option is mandatory\n");
+            return false;
+        }
+
+        std::string command = "settings set target.max-children-count " + std::to_string(m_max_children);
+        Xcode::RunCommand(m_debugger, command.c_str(), GetVerbose());
+
+        m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+        m_target.BreakpointCreateBySourceRegex("// break here", SBFileSpec("stl-formatters-testcase.cpp"));
+        std::string num_elements = std::to_string(m_num_elements);
+        return Launch({ m_exe_path.c_str(), num_elements.c_str() });
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        if (counter == 0)
+        {
+            SBFrame frame (m_thread.GetFrameAtIndex(0));
+            for (size_t i = 0; i < m_names.size(); ++i)
+                m_measurements[i](frame.FindVariable(m_names[i]));
+        }
+        next_action.Kill();
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        results_dict.AddUnsigned ("num-elements", "The number of elements in each container.", m_num_elements);
+        results_dict.AddUnsigned ("max-children", "The value of target.max-children-count.", m_max_children);
+        for (auto &measurement : m_measurements)
+            measurement.WriteAverageAndStandardDeviation(results);
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",        no_argument,        NULL, 'v' },
+            { "test-file",      required_argument,  NULL, 't' },
+            { "num-elements",   required_argument,  NULL, 'n' },
+            { "max-children",   required_argument,  NULL, 'm' },
+            { "out-file",       required_argument,  NULL, 'o' },
+            { NULL,             0,                  NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose(true);
+                return true;
+            case 't':
+                m_exe_path = optarg;
+                return true;
+            case 'n':
+                m_num_elements = strtoul(optarg, NULL, 0);
+                return true;
+            case 'm':
+                m_max_children = strtoul(optarg, NULL, 0);
+                return true;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    std::vector<const char *> m_names;
+    std::vector<TimeMeasurement<std::function<void(SBValue)>>> m_measurements;
+    std::string m_exe_path;
+    std::string m_out_path;
+    uint32_t m_max_children;
+    uint32_t m_num_elements;
+};
+
+int main(int argc, const char * argv[])
+{
+    STLFormattersTest test;
+    return TestCase::Run(test, argc, argv);
+}
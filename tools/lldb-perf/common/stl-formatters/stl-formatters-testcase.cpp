@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+int main (int argc, char **argv)
+{
+    const int num_elements = argc > 1 ? atoi (argv[1]) : 100000;
+
+    std::vector<int> int_vector;
+    std::vector<std::string> string_vector;
+    std::list<int> int_list;
+    std::map<int, std::string> int_string_map;
+    std::set<int> int_set;
+    std::unordered_map<int, int> int_unordered_map;
+    std::string long_string (num_elements, 'x');
+
+    for (int i = 0; i < num_elements; ++i)
+    {
+        char buffer[32];
+        snprintf (buffer, sizeof(buffer), "string %d", i);
+        int_vector.push_back (i);
+        string_vector.push_back (buffer);
+        int_list.push_back (i);
+        int_string_map[i] = buffer;
+        int_set.insert (i);
+        int_unordered_map[i] = i;
+    }
+
+    printf ("Break here to display the containers: %zu\n", int_vector.size() + long_string.size()); // break here
+    return 0;
+}
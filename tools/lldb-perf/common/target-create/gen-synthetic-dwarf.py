@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+
+"""Writes a C++ source file that compiles into a binary with a lot of DWARF.
+
+Every generated namespace has classes with members, methods and template
+instantiations, so indexing the binary exercises the same paths that big
+real world programs do.
+
+Usage: gen-synthetic-dwarf.py --output=FILE [--namespaces=N --classes=N]
+"""
+
+import optparse
+import sys
+
+
+def write_namespace(out, ns_idx, num_classes):
+    out.write('namespace ns%d {\n' % ns_idx)
+    out.write('template <typename T> struct Holder { T value; int count; '
+              'T get() const { return value; } };\n')
+    for i in range(num_classes):
+        base = ' : public Class%d' % (i - 1) if i > 0 and i % 4 else ''
+        out.write('struct Class%d%s {\n' % (i, base))
+        out.write('    int m_int_%d; double m_double_%d; const char *m_name_%d;\n' % (i, i, i))
+        out.write('    Holder<Class%d *> m_holder_%d;\n' % (i, i))
+        out.write('    int method_%d(int a) { return a + m_int_%d; }\n' % (i, i))
+        out.write('    virtual double virtual_%d() { return m_double_%d; }\n' % (i, i))
+        out.write('};\n')
+        out.write('int function_%d(Class%d &c, int a) '
+                  '{ return c.method_%d(a) + c.m_holder_%d.count; }\n' % (i, i, i, i))
+    out.write('int run() {\n    int sum = 0;\n')
+    for i in range(num_classes):
+        out.write('    { Class%d c; c.m_int_%d = %d; c.m_holder_%d.count = 1; '
+                  'sum += function_%d(c, sum) + (int)c.virtual_%d(); }\n'
+                  % (i, i, i, i, i, i))
+    out.write('    return sum;\n}\n')
+    out.write('} // namespace ns%d\n\n' % ns_idx)
+
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option('--output', help='the source file to write')
+    parser.add_option('--namespaces', type='int', default=40)
+    parser.add_option('--classes', type='int', default=250,
+                      help='the number of classes in each namespace')
+    (options, args) = parser.parse_args()
+    if not options.output:
+        parser.error('--output is required')
+
+    with open(options.output, 'w') as out:
+        out.write('// Generated by gen-synthetic-dwarf.py, do not edit.\n\n')
+        for ns_idx in range(options.namespaces):
+            write_namespace(out, ns_idx, options.classes)
+        out.write('int main(int argc, char **argv)\n{\n    int sum = argc;\n')
+        for ns_idx in range(options.namespaces):
+            out.write('    sum += ns%d::run();\n' % ns_idx)
+        out.write('    return sum == 0;\n}\n')
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
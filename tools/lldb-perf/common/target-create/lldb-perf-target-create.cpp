@@ -0,0 +1,163 @@
+//===-- lldb-perf-target-create.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+
+#include <getopt.h>
+#include <string>
+
+using namespace lldb_perf;
+
+// Measures "target create" and the first lookups that have to index all of
+// the debug info, on a binary built from gen-synthetic-dwarf.py.
+class TargetCreateTest : public TestCase
+{
+public:
+    TargetCreateTest () :
+        TestCase(),
+        m_time_create_target ([this] () -> void
+                              {
+                                  m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+                              }, "time-create-target", "The time it takes to create the target."),
+        m_time_index ([this] () -> void
+                      {
+                          m_target.BreakpointCreateByName("function_0");
+                      }, "time-index", "The time it takes to set the first breakpoint by name, which indexes the debug info."),
+        m_time_find_type ([this] () -> void
+                          {
+                              m_target.FindFirstType("ns0::Class0");
+                          }, "time-find-type", "The time it takes to find a type by name after indexing."),
+        m_time_regex_breakpoint ([this] () -> void
+                                 {
+                                     m_target.BreakpointCreateByRegex("^ns[0-9]+::function_1$");
+                                 }, "time-regex-breakpoint", "The time it takes to set a breakpoint by function name regex."),
+        m_memory_create_target (),
+        m_memory_index (),
+        m_memory_total (),
+        m_exe_path (),
+        m_out_path ()
+    {
+    }
+
+    virtual
+    ~TargetCreateTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' option is mandatory\n");
+            return false;
+        }
+        return true;
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        m_memory_total.Start();
+
+        m_memory_create_target.Start();
+        m_time_create_target();
+        m_memory_create_target.Stop();
+        if (!m_target.IsValid())
+        {
+            fprintf (stderr, "error: couldn't create a target for '%s'\n", m_exe_path.c_str());
+            exit(1);
+        }
+
+        m_memory_index.Start();
+        m_time_index();
+        m_memory_index.Stop();
+
+        m_time_find_type();
+        m_time_regex_breakpoint();
+
+        m_memory_total.Stop();
+        next_action.Kill();
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        m_time_create_target.WriteAverageAndStandardDeviation(results);
+        m_time_index.WriteAverageAndStandardDeviation(results);
+        m_time_find_type.WriteAverageAndStandardDeviation(results);
+        m_time_regex_breakpoint.WriteAverageAndStandardDeviation(results);
+        results_dict.Add ("memory-change-create-target",
+                          "Memory increase that occurs due to creating the target.",
+                          m_memory_create_target.GetDeltaValue().GetResult(NULL, NULL));
+        results_dict.Add ("memory-change-index",
+                          "Memory increase that occurs due to indexing the debug info.",
+                          m_memory_index.GetDeltaValue().GetResult(NULL, NULL));
+        results_dict.Add ("memory-total",
+                          "The total memory that lldb is using after all the lookups.",
+                          m_memory_total.GetStopValue().GetResult(NULL, NULL));
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",    no_argument,        NULL, 'v' },
+            { "test-file",  required_argument,  NULL, 't' },
+            { "out-file",   required_argument,  NULL, 'o' },
+            { NULL,         0,                  NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose(true);
+                return true;
+            case 't':
+                m_exe_path = optarg;
+                return true;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+private:
+    TimeMeasurement<std::function<void()>> m_time_create_target;
+    TimeMeasurement<std::function<void()>> m_time_index;
+    TimeMeasurement<std::function<void()>> m_time_find_type;
+    TimeMeasurement<std::function<void()>> m_time_regex_breakpoint;
+    MemoryGauge m_memory_create_target;
+    MemoryGauge m_memory_index;
+    MemoryGauge m_memory_total;
+    std::string m_exe_path;
+    std::string m_out_path;
+};
+
+int main(int argc, const char * argv[])
+{
+    TargetCreateTest test;
+    return TestCase::Run(test, argc, argv);
+}
@@ -0,0 +1,89 @@
+#!/usr/bin/env python
+
+"""Compares two sets of lldb-perf JSON results and reports regressions.
+
+Usage: compare-results.py [--threshold=PERCENT] BASELINE NEW
+
+BASELINE and NEW are either two result files or two directories of result
+files with the same names, e.g. the --out-file outputs of two releases.
+Every number in the results is compared. The script exits with 1 if any
+"time-*" or "memory-*" value grew by more than the threshold.
+"""
+
+import json
+import optparse
+import os
+import sys
+
+
+def flatten(results, prefix=''):
+    """Returns a dictionary of dotted key to number for the results."""
+    values = {}
+    for key, value in results.items():
+        name = prefix + key
+        if isinstance(value, dict):
+            if 'value' in value and not isinstance(value['value'], dict):
+                value = value['value']
+            else:
+                values.update(flatten(value, name + '.'))
+                continue
+        if isinstance(value, (int, float)) and not isinstance(value, bool):
+            values[name] = value
+    return values
+
+
+def load(path):
+    with open(path) as result_file:
+        return flatten(json.load(result_file))
+
+
+def is_checked(name):
+    leaf = name.split('.')[0]
+    return leaf.startswith('time-') or leaf.startswith('memory-')
+
+
+def compare(name, baseline, new, threshold):
+    regressed = False
+    for key in sorted(set(baseline) | set(new)):
+        if key not in baseline or key not in new:
+            print('%s: %s only in %s' % (name, key, 'new' if key in new else 'baseline'))
+            continue
+        old_value = baseline[key]
+        new_value = new[key]
+        change = 0.0
+        if old_value:
+            change = 100.0 * (new_value - old_value) / abs(old_value)
+        marker = ''
+        if is_checked(key) and change > threshold:
+            marker = '  <-- REGRESSION'
+            regressed = True
+        print('%s: %-40s %14.6g %14.6g %+8.1f%%%s' % (name, key, old_value, new_value, change, marker))
+    return regressed
+
+
+def main():
+    parser = optparse.OptionParser(usage='%prog [options] BASELINE NEW')
+    parser.add_option('--threshold', type='float', default=10.0,
+                      help='the percentage a value may grow by before it is a regression')
+    (options, args) = parser.parse_args()
+    if len(args) != 2:
+        parser.error('expected a baseline and a new result path')
+
+    baseline_path, new_path = args
+    if os.path.isdir(baseline_path):
+        pairs = []
+        for file_name in sorted(os.listdir(baseline_path)):
+            if file_name.endswith('.json') and os.path.exists(os.path.join(new_path, file_name)):
+                pairs.append((file_name, os.path.join(baseline_path, file_name),
+                              os.path.join(new_path, file_name)))
+    else:
+        pairs = [(os.path.basename(new_path), baseline_path, new_path)]
+
+    regressed = False
+    for name, baseline_file, new_file in pairs:
+        if compare(name, load(baseline_file), load(new_file), options.threshold):
+            regressed = True
+    return 1 if regressed else 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -11,15 +11,19 @@
 #include "lldb/lldb-forward.h"
 #include <assert.h>
 #include <cmath>
+#include <stdio.h>
+#include <string.h>
+#if defined(__APPLE__)
 #include <mach/mach.h>
 #include <mach/task.h>
 #include <mach/mach_traps.h>
+#endif
 
 using namespace lldb_perf;
 
-MemoryStats::MemoryStats (mach_vm_size_t virtual_size,
-                          mach_vm_size_t resident_size,
-                          mach_vm_size_t max_resident_size) :
+MemoryStats::MemoryStats (uint64_t virtual_size,
+                          uint64_t resident_size,
+                          uint64_t max_resident_size) :
     m_virtual_size (virtual_size),
     m_resident_size (resident_size),
     m_max_resident_size (max_resident_size)
@@ -101,6 +105,7 @@ MemoryStats::GetResult (const char *name, const char *description) const
 MemoryGauge::ValueType
 MemoryGauge::Now ()
 {
+#if defined(__APPLE__)
     task_t task = mach_task_self();
     mach_task_basic_info_data_t taskBasicInfo;
     mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
@@ -109,6 +114,30 @@ MemoryGauge::Now ()
         return MemoryStats(taskBasicInfo.virtual_size, taskBasicInfo.resident_size, taskBasicInfo.resident_size_max);
     }
     return 0;
+#elif defined(__linux__)
+    // The sizes in /proc/self/status are in kB.
+    FILE *file = ::fopen ("/proc/self/status", "r");
+    if (file == NULL)
+        return 0;
+    uint64_t virtual_size = 0;
+    uint64_t resident_size = 0;
+    uint64_t max_resident_size = 0;
+    char line[256];
+    while (::fgets (line, sizeof(line), file))
+    {
+        unsigned long long kb = 0;
+        if (::sscanf (line, "VmSize: %llu kB", &kb) == 1)
+            virtual_size = kb * 1024;
+        else if (::sscanf (line, "VmRSS: %llu kB", &kb) == 1)
+            resident_size = kb * 1024;
+        else if (::sscanf (line, "VmHWM: %llu kB", &kb) == 1)
+            max_resident_size = kb * 1024;
+    }
+    ::fclose (file);
+    return MemoryStats(virtual_size, resident_size, max_resident_size);
+#else
+    return 0;
+#endif
 }
 
 MemoryGauge::MemoryGauge () :
@@ -12,7 +12,6 @@
 
 #include <vector>
 #include <string>
-#include <mach/task_info.h>
 
 namespace lldb_perf {
 
@@ -9,6 +9,10 @@
 
 #include "Results.h"
 #include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
 
 #ifdef __APPLE__
 #include "CFCMutableArray.h"
@@ -19,6 +23,7 @@
 
 using namespace lldb_perf;
 
+#ifdef __APPLE__
 static void
 AddResultToArray (CFCMutableArray &array, Results::Result *result);
 
@@ -154,26 +159,154 @@ AddResultToDictionary (CFCMutableDictionary &parent_dict, const char *key, Resul
         break;
     }
 }
+#endif // #ifdef __APPLE__
+
+static void
+WriteJSONString (FILE *out, const char *str)
+{
+    fputc ('"', out);
+    for (const char *p = str ? str : ""; *p; ++p)
+    {
+        const unsigned char ch = *p;
+        switch (ch)
+        {
+        case '"':  fputs ("\\\"", out); break;
+        case '\\': fputs ("\\\\", out); break;
+        case '\n': fputs ("\\n", out); break;
+        case '\t': fputs ("\\t", out); break;
+        default:
+            if (ch < 0x20)
+                fprintf (out, "\\u%4.4x", ch);
+            else
+                fputc (ch, out);
+            break;
+        }
+    }
+    fputc ('"', out);
+}
+
+static void
+WriteJSONResult (FILE *out, Results::Result *result, int indent)
+{
+    switch (result->GetType())
+    {
+    case Results::Result::Type::Invalid:
+        fputs ("null", out);
+        break;
+
+    case Results::Result::Type::Array:
+        {
+            bool first = true;
+            fputs ("[", out);
+            result->GetAsArray()->ForEach([out, indent, &first](const Results::ResultSP &value_sp) -> bool
+                                          {
+                                              fprintf (out, "%s\n%*s", first ? "" : ",", indent + 2, "");
+                                              WriteJSONResult (out, value_sp.get(), indent + 2);
+                                              first = false;
+                                              return true;
+                                          });
+            if (!first)
+                fprintf (out, "\n%*s", indent, "");
+            fputs ("]", out);
+        }
+        break;
+
+    case Results::Result::Type::Dictionary:
+        {
+            bool first = true;
+            fputs ("{", out);
+            result->GetAsDictionary()->ForEach([out, indent, &first](const std::string &key, const Results::ResultSP &value_sp) -> bool
+                                               {
+                                                   fprintf (out, "%s\n%*s", first ? "" : ",", indent + 2, "");
+                                                   WriteJSONString (out, key.c_str());
+                                                   fputs (": ", out);
+                                                   WriteJSONResult (out, value_sp.get(), indent + 2);
+                                                   first = false;
+                                                   return true;
+                                               });
+            if (result->GetDescription())
+            {
+                fprintf (out, "%s\n%*s\"description\": ", first ? "" : ",", indent + 2, "");
+                WriteJSONString (out, result->GetDescription());
+                first = false;
+            }
+            if (!first)
+                fprintf (out, "\n%*s", indent, "");
+            fputs ("}", out);
+        }
+        break;
+
+    case Results::Result::Type::Double:
+        fprintf (out, "%.9g", result->GetAsDouble()->GetValue());
+        break;
+
+    case Results::Result::Type::String:
+        WriteJSONString (out, result->GetAsString()->GetValue());
+        break;
+
+    case Results::Result::Type::Unsigned:
+        fprintf (out, "%" PRIu64, result->GetAsUnsigned()->GetValue());
+        break;
+    }
+}
+
 void
 Results::Write (const char *out_path)
 {
+    Format format = Format::eJSON;
 #ifdef __APPLE__
-    CFCMutableDictionary dict;
-    
-    m_results.ForEach([&dict](const std::string &key, const ResultSP &value_sp) -> bool
-                      {
-                          AddResultToDictionary (dict, key.c_str(), value_sp.get());
-                          return true;
-                      });
-    CFDataRef xmlData = CFPropertyListCreateData(kCFAllocatorDefault, dict.get(), kCFPropertyListXMLFormat_v1_0, 0, NULL);
-    
-    if (out_path == NULL)
-        out_path = "/dev/stdout";
+    // Keep writing plists for the existing Xcode tooling unless JSON was
+    // asked for with the file extension.
+    const size_t path_len = out_path ? strlen (out_path) : 0;
+    if (path_len < 5 || strcmp (out_path + path_len - 5, ".json") != 0)
+        format = Format::ePlist;
+#endif
+    Write (out_path, format);
+}
 
-    CFURLRef file = CFURLCreateFromFileSystemRepresentation(NULL, (const UInt8*)out_path, strlen(out_path), FALSE);
-    
-    CFURLWriteDataAndPropertiesToResource(file, xmlData, NULL, NULL);
+void
+Results::Write (const char *out_path, Format format)
+{
+    if (format == Format::ePlist)
+    {
+#ifdef __APPLE__
+        CFCMutableDictionary dict;
+        
+        m_results.ForEach([&dict](const std::string &key, const ResultSP &value_sp) -> bool
+                          {
+                              AddResultToDictionary (dict, key.c_str(), value_sp.get());
+                              return true;
+                          });
+        CFDataRef xmlData = CFPropertyListCreateData(kCFAllocatorDefault, dict.get(), kCFPropertyListXMLFormat_v1_0, 0, NULL);
+        
+        if (out_path == NULL)
+            out_path = "/dev/stdout";
+
+        CFURLRef file = CFURLCreateFromFileSystemRepresentation(NULL, (const UInt8*)out_path, strlen(out_path), FALSE);
+        
+        CFURLWriteDataAndPropertiesToResource(file, xmlData, NULL, NULL);
+        return;
+#else
+        fprintf (stderr, "warning: plist results are only supported on Darwin, writing JSON\n");
 #endif
+    }
+
+    FILE *out = stdout;
+    if (out_path && out_path[0] && strcmp (out_path, "/dev/stdout") != 0)
+    {
+        out = fopen (out_path, "w");
+        if (out == NULL)
+        {
+            fprintf (stderr, "error: couldn't open '%s' for writing: %s\n", out_path, strerror (errno));
+            return;
+        }
+    }
+    WriteJSONResult (out, &m_results, 0);
+    fputs ("\n", out);
+    if (out != stdout)
+        fclose (out);
+    else
+        fflush (out);
 }
 
 Results::ResultSP
@@ -11,7 +11,9 @@
 #define __PerfTestDriver_Results_h__
 
 #include "lldb/lldb-forward.h"
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -301,8 +303,19 @@ public:
         return m_results;
     }
 
+    enum class Format
+    {
+        ePlist,
+        eJSON
+    };
+
+    // Writes JSON, or a plist on Darwin unless the path ends in ".json".
+    // A NULL path writes to stdout.
     void
     Write (const char *path);
+
+    void
+    Write (const char *path, Format format);
     
 protected:
     Dictionary m_results;
@@ -58,6 +58,7 @@ using namespace lldb_private::process_gdb_remote;
 
 static int g_debug = 0;
 static int g_verbose = 0;
+static int g_compression = 0;
 
 static struct option g_long_options[] =
 {
@@ -72,6 +73,7 @@ static struct option g_long_options[] =
     { "native-regs",        no_argument,        NULL,               'r' },  // Specify to use the native registers instead of the gdb defaults for the architecture.  NOTE: this is a do-nothing arg as it's behavior is default now.  FIXME remove call from lldb-platform.
     { "reverse-connect",    no_argument,        NULL,               'R' },  // Specifies that llgs attaches to the client address:port rather than llgs listening for a connection from address on port.
     { "setsid",             no_argument,        NULL,               'S' },  // Call setsid() to make llgs run in its own session.
+    { "compression",        no_argument,        &g_compression,     1   },  // Allow the client to enable compression of the packets llgs sends, useful on slow connections.
     { NULL,                 0,                  NULL,               0   }
 };
 
@@ -123,6 +125,7 @@ display_usage (const char *progname, const char* subcommand)
             "[--log-channels log-channel-list] "
             "[--platform platform_name] "
             "[--setsid] "
+            "[--compression] "
             "[--named-pipe named-pipe-path] "
             "[--native-regs] "
             "[--attach pid] "
@@ -552,6 +555,7 @@ main_gdbserver (int argc, char *argv[])
     lldb::PlatformSP platform_sp = setup_platform (platform_name);
 
     GDBRemoteCommunicationServerLLGS gdb_server (platform_sp, mainloop);
+    gdb_server.SetCompressionAllowed (g_compression != 0);
 
     const char *const host_and_port = argv[0];
     argc -= 1;
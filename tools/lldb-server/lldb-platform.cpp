@@ -51,6 +51,7 @@ using namespace llvm;
 static int g_debug = 0;
 static int g_verbose = 0;
 static int g_server = 0;
+static int g_compression = 0;
 
 static struct option g_long_options[] =
 {
@@ -64,7 +65,9 @@ static struct option g_long_options[] =
     { "min-gdbserver-port", required_argument,  NULL,               'm' },
     { "max-gdbserver-port", required_argument,  NULL,               'M' },
     { "socket-file",        required_argument,  NULL,               'f' },
+    { "gdbserver-pool-size", required_argument, NULL,               'g' },  // Keep this many gdbservers started so launches don't wait for them.
     { "server",             no_argument,        &g_server,          1   },
+    { "compression",        no_argument,        &g_compression,     1   },  // Allow the client to enable compression of the packets we send, useful for file transfers on slow connections.
     { NULL,                 0,                  NULL,               0   }
 };
 
@@ -97,7 +100,7 @@ signal_handler(int signo)
 static void
 display_usage (const char *progname, const char *subcommand)
 {
-    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] [--port-file port-file-path] --server --listen port\n", progname, subcommand);
+    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] [--port-file port-file-path] [--compression] [--gdbserver-pool-size count] --server --listen port\n", progname, subcommand);
     exit(0);
 }
 
@@ -157,6 +160,7 @@ main_platform (int argc, char *argv[])
     int min_gdbserver_port = 0;
     int max_gdbserver_port = 0;
     uint16_t port_offset = 0;
+    uint32_t gdbserver_pool_size = 0;
 
     FileSpec socket_file;
     bool show_usage = false;
@@ -222,6 +226,14 @@ main_platform (int argc, char *argv[])
             }
             break;
                 
+        case 'g':
+            if (StringRef(optarg).getAsInteger(0, gdbserver_pool_size))
+            {
+                fprintf (stderr, "error: invalid gdbserver pool size %s\n", optarg);
+                option_error = 6;
+            }
+            break;
+
         case 'P':
         case 'm':
         case 'M':
@@ -332,6 +344,9 @@ main_platform (int argc, char *argv[])
             platform.SetPortMap(std::move(gdbserver_portmap));
         }
 
+        platform.SetCompressionAllowed (g_compression != 0);
+        platform.SetGDBServerPoolSize (gdbserver_pool_size);
+
         const bool children_inherit_accept_socket = true;
         Connection* conn = nullptr;
         error = acceptor_up->Accept(children_inherit_accept_socket, conn);
@@ -390,6 +405,12 @@ main_platform (int argc, char *argv[])
             // After we connected, we need to get an initial ack from...
             if (platform.HandshakeWithClient())
             {
+                // Start the pool after forking, so that the gdbservers
+                // belong to the process that serves this client. They
+                // start up while the client sets up its session.
+                platform.FillGDBServerPool();
+
+
                 bool interrupt = false;
                 bool done = false;
                 while (!interrupt && !done)
@@ -0,0 +1,214 @@
+//===-- lldb-replay.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// C++ Includes
+#include <memory>
+#include <string>
+
+// Other libraries and framework includes
+#include "llvm/ADT/StringRef.h"
+
+#include "lldb/Core/Error.h"
+#include "lldb/Host/HostGetOpt.h"
+#include "lldb/Host/OptionParser.h"
+#include "Acceptor.h"
+#include "LLDBServerUtilities.h"
+#include "Plugins/Process/gdb-remote/GDBRemoteCommunicationReplayServer.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::lldb_server;
+using namespace lldb_private::process_gdb_remote;
+using namespace llvm;
+
+//----------------------------------------------------------------------
+// option descriptors for getopt_long_only()
+//----------------------------------------------------------------------
+
+static int g_recorded_timing = 0;
+
+static struct option g_long_options[] =
+{
+    { "log-file",           required_argument,  NULL,               'l' },
+    { "log-channels",       required_argument,  NULL,               'c' },
+    { "listen",             required_argument,  NULL,               'L' },
+    { "rtt-ms",             required_argument,  NULL,               'r' },  // The simulated round trip time in milliseconds.
+    { "bandwidth",          required_argument,  NULL,               'b' },  // The simulated bandwidth in bytes per second.
+    { "recorded-timing",    no_argument,        &g_recorded_timing, 1   },  // Respond as fast as the recorded server did.
+    { NULL,                 0,                  NULL,               0   }
+};
+
+static void
+display_usage (const char *progname, const char *subcommand)
+{
+    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] [--rtt-ms milliseconds] [--bandwidth bytes-per-second] [--recorded-timing] --listen port recording-file\n", progname, subcommand);
+    exit(0);
+}
+
+//----------------------------------------------------------------------
+// main
+//----------------------------------------------------------------------
+int
+main_replay (int argc, char *argv[])
+{
+    const char *progname = argv[0];
+    const char *subcommand = argv[1];
+    argc--;
+    argv++;
+    signal (SIGPIPE, SIG_IGN);
+    int long_option_index = 0;
+    Error error;
+    std::string listen_host_port;
+    int ch;
+
+    std::string log_file;
+    StringRef log_channels; // e.g. "gdb-remote packets"
+
+    uint64_t round_trip_msec = 0;
+    uint64_t bytes_per_second = 0;
+    bool show_usage = false;
+    int option_error = 0;
+    int socket_error = -1;
+
+    std::string short_options(OptionParser::GetShortOptionString(g_long_options));
+
+#if __GLIBC__
+    optind = 0;
+#else
+    optreset = 1;
+    optind = 1;
+#endif
+
+    while ((ch = getopt_long_only(argc, argv, short_options.c_str(), g_long_options, &long_option_index)) != -1)
+    {
+        switch (ch)
+        {
+        case 0:   // Any optional that auto set themselves will return 0
+            break;
+
+        case 'L':
+            listen_host_port.append (optarg);
+            break;
+
+        case 'l': // Set Log File
+            if (optarg && optarg[0])
+                log_file.assign(optarg);
+            break;
+
+        case 'c': // Log Channels
+            if (optarg && optarg[0])
+                log_channels = StringRef(optarg);
+            break;
+
+        case 'r':
+        case 'b':
+            {
+                uint64_t value = 0;
+                if (StringRef(optarg).getAsInteger(0, value))
+                {
+                    fprintf (stderr, "error: invalid number %s\n", optarg);
+                    option_error = 1;
+                }
+                else if (ch == 'r')
+                    round_trip_msec = value;
+                else
+                    bytes_per_second = value;
+            }
+            break;
+
+        case 'h':   /* fall-through is intentional */
+        case '?':
+            show_usage = true;
+            break;
+        }
+    }
+
+    if (!LLDBServerUtilities::SetupLogging(log_file, log_channels, 0))
+        return -1;
+
+    // Skip any options we consumed with getopt_long_only.
+    argc -= optind;
+    argv += optind;
+
+    // Print usage and exit if no listening port or recording is specified.
+    if (listen_host_port.empty() || argc != 1)
+        show_usage = true;
+
+    if (show_usage || option_error)
+    {
+        display_usage(progname, subcommand);
+        exit(option_error);
+    }
+
+    GDBRemoteCommunicationReplayServer replay_server;
+    error = replay_server.LoadRecording(argv[0]);
+    if (error.Fail())
+    {
+        fprintf(stderr, "error: %s\n", error.AsCString());
+        return 1;
+    }
+    replay_server.SetRoundTripTime(round_trip_msec * 1000);
+    replay_server.SetBandwidth(bytes_per_second);
+    replay_server.SetUseRecordedTiming(g_recorded_timing != 0);
+
+    std::unique_ptr<Acceptor> acceptor_up(Acceptor::Create(listen_host_port, false, error));
+    if (error.Fail())
+    {
+        fprintf(stderr, "failed to create acceptor: %s", error.AsCString());
+        exit(socket_error);
+    }
+
+    error = acceptor_up->Listen(1);
+    if (error.Fail())
+    {
+        printf("failed to listen: %s\n", error.AsCString());
+        exit(socket_error);
+    }
+
+    Connection* conn = nullptr;
+    error = acceptor_up->Accept(false, conn);
+    if (error.Fail())
+    {
+        printf ("error: %s\n", error.AsCString());
+        exit(socket_error);
+    }
+    printf ("Connection established.\n");
+    acceptor_up.reset();
+    replay_server.SetConnection (conn);
+
+    // After we connected, we need to get an initial ack from...
+    if (replay_server.HandshakeWithClient())
+    {
+        bool done = false;
+        while (!done)
+        {
+            if (replay_server.ReplayPacket (UINT32_MAX, error, done) != GDBRemoteCommunication::PacketResult::Success)
+                break;
+        }
+
+        if (error.Fail())
+        {
+            fprintf(stderr, "error: %s\n", error.AsCString());
+        }
+    }
+    else
+    {
+        fprintf(stderr, "error: handshake with client failed\n");
+    }
+
+    fprintf(stderr, "lldb-server exiting...\n");
+
+    return 0;
+}
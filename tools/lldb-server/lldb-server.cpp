@@ -26,13 +26,15 @@ display_usage (const char *progname)
             "  %s v[ersion]\n"
             "  %s g[dbserver] [options]\n"
             "  %s p[latform] [options]\n"
-            "Invoke subcommand for additional help\n", progname, progname, progname);
+            "  %s r[eplay] [options]\n"
+            "Invoke subcommand for additional help\n", progname, progname, progname, progname);
     exit(0);
 }
 
 // Forward declarations of subcommand main methods.
 int main_gdbserver (int argc, char *argv[]);
 int main_platform (int argc, char *argv[]);
+int main_replay (int argc, char *argv[]);
 
 static void
 initialize ()
@@ -72,6 +74,11 @@ main (int argc, char *argv[])
             main_platform(argc, argv);
             terminate();
             break;
+        case 'r':
+            initialize();
+            main_replay(argc, argv);
+            terminate();
+            break;
         case 'v':
             fprintf(stderr, "%s\n", lldb_private::GetVersion());
             break;
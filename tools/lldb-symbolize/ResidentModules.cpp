@@ -0,0 +1,177 @@
+//===-- ResidentModules.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ResidentModules.h"
+
+// C Includes
+#include <ctype.h>
+
+// Other libraries and framework includes
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/Symbols.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::lldb_symbolize;
+
+// Returns true and fills in uuid if module_name is a UUID or build ID
+// in hex.
+static bool
+ParseUUID (const std::string &module_name, UUID &uuid)
+{
+    size_t num_hex_digits = 0;
+    for (char c : module_name)
+    {
+        if (isxdigit(c))
+            ++num_hex_digits;
+        else if (c != '-')
+            return false;
+    }
+    if (num_hex_digits < 8 || num_hex_digits % 2 != 0)
+        return false;
+
+    const uint32_t num_uuid_bytes = num_hex_digits / 2;
+    return uuid.SetFromCString(module_name.c_str(), num_uuid_bytes) > 0 && uuid.GetByteSize() == num_uuid_bytes;
+}
+
+// The size of the files behind the module. Everything lldb builds from
+// them, the symbol table, the name indexes and the parsed debug
+// information, grows with the size of the files, so this is the measure
+// the memory budget uses.
+static uint64_t
+GetModuleByteSize (Module &module)
+{
+    uint64_t byte_size = 0;
+    ObjectFile *objfile = module.GetObjectFile();
+    if (objfile)
+        byte_size += objfile->GetByteSize();
+
+    SymbolVendor *symbol_vendor = module.GetSymbolVendor();
+    SymbolFile *symbol_file = symbol_vendor ? symbol_vendor->GetSymbolFile() : nullptr;
+    if (symbol_file && symbol_file->GetObjectFile() && symbol_file->GetObjectFile() != objfile)
+        byte_size += symbol_file->GetObjectFile()->GetByteSize();
+    return byte_size;
+}
+
+ResidentModules::ResidentModules (uint64_t byte_budget) :
+    m_modules (),
+    m_lru (),
+    m_byte_budget (byte_budget),
+    m_byte_size (0),
+    m_num_evictions (0)
+{
+}
+
+ResidentModules::~ResidentModules ()
+{
+}
+
+ModuleSP
+ResidentModules::GetModule (const std::string &module_name, Error &error)
+{
+    collection::iterator pos = m_modules.find(module_name);
+    if (pos != m_modules.end())
+    {
+        m_lru.splice(m_lru.begin(), m_lru, pos->second.lru_pos);
+        if (!pos->second.module_sp)
+            error.SetErrorString(pos->second.error.c_str());
+        return pos->second.module_sp;
+    }
+
+    Entry entry;
+    entry.module_sp = LoadModule(module_name, error);
+    entry.byte_size = entry.module_sp ? GetModuleByteSize(*entry.module_sp) : 0;
+    if (error.Fail())
+        entry.error = error.AsCString("unknown error");
+    m_lru.push_front(module_name);
+    entry.lru_pos = m_lru.begin();
+    m_modules[module_name] = entry;
+
+    m_byte_size += entry.byte_size;
+    Evict();
+    return entry.module_sp;
+}
+
+ModuleSP
+ResidentModules::LoadModule (const std::string &module_name, Error &error)
+{
+    ModuleSpec module_spec;
+    FileSpec file_spec(module_name.c_str(), true);
+    UUID uuid;
+    if (file_spec.Exists())
+    {
+        module_spec.GetFileSpec() = file_spec;
+    }
+    else if (ParseUUID(module_name, uuid))
+    {
+        module_spec.GetUUID() = uuid;
+
+        // Without a Target there is no list of images to find the module
+        // in, look for the binary and then for its debug file. A debug
+        // file has the symbol table and the debug information of the
+        // binary at the same file addresses, so it can stand in for it.
+        ModuleSpec located_spec = Symbols::LocateExecutableObjectFile(module_spec);
+        if (located_spec.GetFileSpec().Exists())
+        {
+            module_spec.GetFileSpec() = located_spec.GetFileSpec();
+            module_spec.GetSymbolFileSpec() = located_spec.GetSymbolFileSpec();
+        }
+        else
+        {
+            FileSpec symbol_file_spec = Symbols::LocateExecutableSymbolFile(module_spec);
+            if (!symbol_file_spec.Exists())
+            {
+                error.SetErrorStringWithFormat("no binary or debug file found for UUID %s", uuid.GetAsString().c_str());
+                return ModuleSP();
+            }
+            module_spec.GetFileSpec() = symbol_file_spec;
+        }
+    }
+    else
+    {
+        error.SetErrorStringWithFormat("'%s' does not exist", module_name.c_str());
+        return ModuleSP();
+    }
+
+    ModuleSP module_sp;
+    error = ModuleList::GetSharedModule(module_spec, module_sp, nullptr, nullptr, nullptr);
+    if (error.Success() && (!module_sp || !module_sp->GetObjectFile()))
+        error.SetErrorStringWithFormat("'%s' is not an object file", module_spec.GetFileSpec().GetPath().c_str());
+    if (error.Fail())
+        module_sp.reset();
+    return module_sp;
+}
+
+void
+ResidentModules::Evict ()
+{
+    while (m_byte_size > m_byte_budget && m_lru.size() > 1)
+    {
+        collection::iterator pos = m_modules.find(m_lru.back());
+        m_lru.pop_back();
+
+        // The shared module list holds a reference too, the module is only
+        // freed once it is gone from there.
+        ModuleSP module_sp = pos->second.module_sp;
+        m_byte_size -= pos->second.byte_size;
+        m_modules.erase(pos);
+        if (module_sp)
+        {
+            ModuleList::RemoveSharedModule(module_sp);
+            ++m_num_evictions;
+        }
+    }
+}
@@ -0,0 +1,107 @@
+//===-- ResidentModules.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_SYMBOLIZE_RESIDENT_MODULES_H
+#define LLDB_SYMBOLIZE_RESIDENT_MODULES_H
+
+// C++ Includes
+#include <list>
+#include <map>
+#include <string>
+
+// Other libraries and framework includes
+#include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private
+{
+namespace lldb_symbolize
+{
+//------------------------------------------------------------------
+/// @class ResidentModules
+/// @brief Keeps the modules of recent requests loaded.
+///
+/// Modules are looked up by path or by UUID. Once a module is loaded
+/// its symbol table, DWARF index and parsed debug information stay
+/// around for the next request that names it. When the modules use
+/// more than the memory budget the least recently used ones are
+/// removed from the shared module list and freed. Modules that can't
+/// be found are remembered too so that they aren't searched for again.
+//------------------------------------------------------------------
+class ResidentModules
+{
+public:
+    ResidentModules (uint64_t byte_budget);
+
+    ~ResidentModules ();
+
+    //------------------------------------------------------------------
+    /// Get a module, loading it if needed.
+    ///
+    /// @param[in] module_name
+    ///     The path of the module or its UUID as a hex string, with or
+    ///     without '-' separators.
+    ///
+    /// @param[out] error
+    ///     Why the module couldn't be loaded.
+    ///
+    /// @return
+    ///     The module, or an empty shared pointer.
+    //------------------------------------------------------------------
+    lldb::ModuleSP
+    GetModule (const std::string &module_name, Error &error);
+
+    size_t
+    GetNumModules () const
+    {
+        return m_modules.size();
+    }
+
+    uint64_t
+    GetByteSize () const
+    {
+        return m_byte_size;
+    }
+
+    uint64_t
+    GetNumEvictions () const
+    {
+        return m_num_evictions;
+    }
+
+private:
+    struct Entry
+    {
+        lldb::ModuleSP module_sp;
+        uint64_t byte_size;
+        std::string error;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    typedef std::map<std::string, Entry> collection;
+
+    lldb::ModuleSP
+    LoadModule (const std::string &module_name, Error &error);
+
+    // Free least recently used modules, but never the most recent one,
+    // until the modules fit in the budget.
+    void
+    Evict ();
+
+    collection m_modules;
+    std::list<std::string> m_lru; // The most recently used module first.
+    uint64_t m_byte_budget;
+    uint64_t m_byte_size;
+    uint64_t m_num_evictions;
+};
+
+} // namespace lldb_symbolize
+} // namespace lldb_private
+
+#endif // LLDB_SYMBOLIZE_RESIDENT_MODULES_H
@@ -0,0 +1,82 @@
+//===-- SystemInitializerSymbolize.cpp --------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "SystemInitializerSymbolize.h"
+
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/PluginManager.h"
+#include "lldb/Symbol/ClangASTContext.h"
+#include "lldb/Symbol/GoASTContext.h"
+#include "lldb/Symbol/JavaASTContext.h"
+#include "Plugins/SymbolFile/DWARF/SymbolFileDWARF.h"
+#include "Plugins/SymbolFile/DWARF/SymbolFileDWARFDebugMap.h"
+#include "Plugins/SymbolFile/Symtab/SymbolFileSymtab.h"
+#include "Plugins/SymbolVendor/ELF/SymbolVendorELF.h"
+
+#if defined(__APPLE__)
+#include "Plugins/SymbolVendor/MacOSX/SymbolVendorMacOSX.h"
+#endif
+
+using namespace lldb_private;
+using namespace lldb_private::lldb_symbolize;
+
+SystemInitializerSymbolize::SystemInitializerSymbolize()
+{
+}
+
+SystemInitializerSymbolize::~SystemInitializerSymbolize()
+{
+}
+
+void
+SystemInitializerSymbolize::Initialize()
+{
+    SystemInitializerCommon::Initialize();
+
+    // SymbolFileDWARF makes functions through the type system of the
+    // compile unit's language.
+    ClangASTContext::Initialize();
+    GoASTContext::Initialize();
+    JavaASTContext::Initialize();
+
+    SymbolVendorELF::Initialize();
+    SymbolFileDWARF::Initialize();
+    SymbolFileSymtab::Initialize();
+    SymbolFileDWARFDebugMap::Initialize();
+#if defined(__APPLE__)
+    SymbolVendorMacOSX::Initialize();
+#endif
+
+    PluginManager::Initialize();
+
+    // The settings need to know about the installed plug-ins.
+    Debugger::SettingsInitialize();
+}
+
+void
+SystemInitializerSymbolize::Terminate()
+{
+    Debugger::SettingsTerminate();
+
+    SymbolVendorELF::Terminate();
+    SymbolFileDWARF::Terminate();
+    SymbolFileSymtab::Terminate();
+    SymbolFileDWARFDebugMap::Terminate();
+#if defined(__APPLE__)
+    SymbolVendorMacOSX::Terminate();
+#endif
+
+    PluginManager::Terminate();
+
+    ClangASTContext::Terminate();
+    GoASTContext::Terminate();
+    JavaASTContext::Terminate();
+
+    SystemInitializerCommon::Terminate();
+}
@@ -0,0 +1,39 @@
+//===-- SystemInitializerSymbolize.h ----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_SYMBOLIZE_SYSTEM_INITIALIZER_SYMBOLIZE_H
+#define LLDB_SYMBOLIZE_SYSTEM_INITIALIZER_SYMBOLIZE_H
+
+#include "lldb/Initialization/SystemInitializerCommon.h"
+
+namespace lldb_private
+{
+namespace lldb_symbolize
+{
+//------------------------------------------------------------------
+/// Initializes the parts of lldb that lldb-symbolize needs.
+///
+/// On top of the common plug-ins these are the type systems, symbol
+/// vendors and symbol files, and the debugger settings so that the
+/// symbol file settings, like the DWARF index cache, can be changed.
+//------------------------------------------------------------------
+class SystemInitializerSymbolize : public SystemInitializerCommon
+{
+  public:
+    SystemInitializerSymbolize();
+    ~SystemInitializerSymbolize() override;
+
+    void Initialize() override;
+    void Terminate() override;
+};
+
+} // namespace lldb_symbolize
+} // namespace lldb_private
+
+#endif // LLDB_SYMBOLIZE_SYSTEM_INITIALIZER_SYMBOLIZE_H
@@ -0,0 +1,268 @@
+//===-- lldb-symbolize.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/ManagedStatic.h"
+
+#include "lldb/Core/Address.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Host/HostGetOpt.h"
+#include "lldb/Host/OptionParser.h"
+#include "lldb/Host/StringConvert.h"
+#include "lldb/Initialization/SystemLifetimeManager.h"
+#include "lldb/Symbol/LineEntry.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "ResidentModules.h"
+#include "SystemInitializerSymbolize.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::lldb_symbolize;
+
+static llvm::ManagedStatic<SystemLifetimeManager> g_debugger_lifetime;
+
+//----------------------------------------------------------------------
+// option descriptors for getopt_long_only()
+//----------------------------------------------------------------------
+
+static int g_index_cache = 0;
+static int g_verbose = 0;
+
+static struct option g_long_options[] =
+{
+    { "memory-budget",        required_argument,  NULL,             'm' },
+    { "debug-file-directory", required_argument,  NULL,             'd' },
+    { "setting",              required_argument,  NULL,             's' },
+    { "index-cache",          no_argument,        &g_index_cache,   1   },
+    { "verbose",              no_argument,        &g_verbose,       1   },
+    { "help",                 no_argument,        NULL,             'h' },
+    { NULL,                   0,                  NULL,             0   }
+};
+
+static const uint64_t g_default_memory_budget_mb = 1024;
+
+static void
+display_usage (const char *progname)
+{
+    fprintf(stderr, "Usage:\n  %s [--memory-budget megabytes] [--debug-file-directory dir]... [--setting name=value]... [--index-cache] [--verbose]\n"
+            "\n"
+            "Reads requests from stdin, one per line:\n"
+            "  <module> <address>\n"
+            "The module is a path or a UUID (build ID) in hex. The address is a file\n"
+            "address in the module, for shared libraries and position independent\n"
+            "executables this is the offset from the load address. Each request is\n"
+            "answered with a function name and a file:line:column pair per frame,\n"
+            "the innermost inlined frame first, followed by an empty line.\n"
+            "\n"
+            "Modules stay loaded between requests until they use more than the memory\n"
+            "budget (%" PRIu64 " MB by default), then the least recently used ones are freed.\n",
+            progname, g_default_memory_budget_mb);
+    exit(0);
+}
+
+static void
+print_frame (const SymbolContext &sc)
+{
+    ConstString name = sc.GetFunctionName();
+    printf("%s\n", name ? name.GetCString() : "??");
+
+    if (sc.line_entry.IsValid() && sc.line_entry.file)
+    {
+        std::string path = sc.line_entry.file.GetPath();
+        printf("%s:%u:%u\n", path.c_str(), sc.line_entry.line, sc.line_entry.column);
+    }
+    else
+    {
+        printf("??:0:0\n");
+    }
+}
+
+static void
+symbolize (ResidentModules &modules, const std::string &module_name, addr_t file_addr)
+{
+    Error error;
+    ModuleSP module_sp = modules.GetModule(module_name, error);
+    Address so_addr;
+    if (!module_sp || !module_sp->ResolveFileAddress(file_addr, so_addr))
+    {
+        if (g_verbose)
+        {
+            if (error.Fail())
+                fprintf(stderr, "error: %s\n", error.AsCString());
+            else
+                fprintf(stderr, "error: 0x%" PRIx64 " is not an address in %s\n", file_addr, module_name.c_str());
+        }
+        printf("??\n??:0:0\n");
+        return;
+    }
+
+    const uint32_t resolve_scope = eSymbolContextModule | eSymbolContextCompUnit | eSymbolContextFunction |
+                                   eSymbolContextBlock | eSymbolContextLineEntry | eSymbolContextSymbol;
+    SymbolContext sc;
+    module_sp->ResolveSymbolContextForAddress(so_addr, resolve_scope, sc);
+    print_frame(sc);
+
+    // Walk out of the inlined functions, the line entries of the parents
+    // are the call sites.
+    Address curr_addr(so_addr);
+    SymbolContext parent_sc;
+    Address parent_addr;
+    while (sc.GetParentOfInlinedScope(curr_addr, parent_sc, parent_addr))
+    {
+        print_frame(parent_sc);
+        sc = parent_sc;
+        curr_addr = parent_addr;
+    }
+}
+
+//----------------------------------------------------------------------
+// main
+//----------------------------------------------------------------------
+int
+main (int argc, char *argv[])
+{
+    const char *progname = argv[0];
+    uint64_t memory_budget_mb = g_default_memory_budget_mb;
+    std::vector<std::string> debug_file_directories;
+    std::vector<std::string> settings;
+    int option_error = 0;
+    int ch;
+    int long_option_index = 0;
+
+    std::string short_options(OptionParser::GetShortOptionString(g_long_options));
+
+    while ((ch = getopt_long_only(argc, argv, short_options.c_str(), g_long_options, &long_option_index)) != -1)
+    {
+        switch (ch)
+        {
+        case 0:   // Any optional that auto set themselves will return 0
+            break;
+
+        case 'm':
+            {
+                bool success = false;
+                memory_budget_mb = StringConvert::ToUInt64(optarg, 0, 0, &success);
+                if (!success)
+                {
+                    fprintf(stderr, "error: invalid memory budget '%s'\n", optarg);
+                    option_error = 1;
+                }
+            }
+            break;
+
+        case 'd':
+            if (optarg && optarg[0])
+                debug_file_directories.push_back(optarg);
+            break;
+
+        case 's':
+            if (optarg && strchr(optarg, '='))
+                settings.push_back(optarg);
+            else
+            {
+                fprintf(stderr, "error: the setting '%s' isn't of the form name=value\n", optarg);
+                option_error = 1;
+            }
+            break;
+
+        case 'h':
+            display_usage(progname);
+            break;
+
+        default:
+            option_error = 1;
+            break;
+        }
+    }
+
+    if (option_error)
+    {
+        display_usage(progname);
+        exit(option_error);
+    }
+
+    g_debugger_lifetime->Initialize(llvm::make_unique<SystemInitializerSymbolize>(), nullptr);
+
+    // There is no Target or Process, the debugger only holds the settings
+    // that the symbol vendors and symbol files read.
+    DebuggerSP debugger_sp = Debugger::CreateInstance();
+    Error error;
+    if (g_index_cache)
+        error = debugger_sp->SetPropertyValue(nullptr, eVarSetOperationAssign, "plugin.symbol-file.dwarf.use-index-cache", "true");
+    for (size_t i = 0; error.Success() && i < debug_file_directories.size(); ++i)
+        error = debugger_sp->SetPropertyValue(nullptr, eVarSetOperationAppend, "target.debug-file-search-paths",
+                                              debug_file_directories[i].c_str());
+    for (size_t i = 0; error.Success() && i < settings.size(); ++i)
+    {
+        const size_t equal_pos = settings[i].find('=');
+        const std::string name(settings[i], 0, equal_pos);
+        const std::string value(settings[i], equal_pos + 1);
+        error = debugger_sp->SetPropertyValue(nullptr, eVarSetOperationAssign, name.c_str(), value.c_str());
+    }
+    if (error.Fail())
+    {
+        fprintf(stderr, "error: %s\n", error.AsCString());
+        Debugger::Destroy(debugger_sp);
+        g_debugger_lifetime->Terminate();
+        return 1;
+    }
+
+    uint64_t num_requests = 0;
+    {
+        ResidentModules modules(memory_budget_mb * 1024 * 1024);
+
+        char line[4096];
+        while (fgets(line, sizeof(line), stdin))
+        {
+            char *module_name = strtok(line, " \t\r\n");
+            char *address_str = module_name ? strtok(nullptr, " \t\r\n") : nullptr;
+            if (module_name == nullptr)
+                continue;
+
+            bool success = false;
+            const addr_t file_addr = address_str ? StringConvert::ToUInt64(address_str, LLDB_INVALID_ADDRESS, 0, &success)
+                                                 : LLDB_INVALID_ADDRESS;
+            if (success)
+                symbolize(modules, module_name, file_addr);
+            else
+            {
+                if (g_verbose)
+                    fprintf(stderr, "error: invalid request, expected '<module> <address>'\n");
+                printf("??\n??:0:0\n");
+            }
+
+            // Let the reader on the other end of a pipe match the answer
+            // to its request right away.
+            printf("\n");
+            fflush(stdout);
+            ++num_requests;
+        }
+
+        if (g_verbose)
+            fprintf(stderr, "%" PRIu64 " requests, %" PRIu64 " modules resident using %" PRIu64 " bytes, %" PRIu64 " evicted\n",
+                    num_requests, (uint64_t)modules.GetNumModules(), modules.GetByteSize(), modules.GetNumEvictions());
+    }
+
+    Debugger::Destroy(debugger_sp);
+    g_debugger_lifetime->Terminate();
+    return 0;
+}
@@ -0,0 +1,63 @@
+//===-- ConnectionSharedMemoryTest.cpp --------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if !defined(_WIN32) && !defined(__ANDROID_NDK__)
+
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ConnectionSharedMemory.h"
+#include "lldb/Core/Error.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    std::string
+    GetTestName ()
+    {
+        return "/lldb-test-" + std::to_string(::getpid());
+    }
+}
+
+TEST(ConnectionSharedMemoryTest, WritesAreShared)
+{
+    const std::string name = GetTestName();
+    const size_t size = 4096;
+
+    ConnectionSharedMemory creator;
+    Error error;
+    ASSERT_EQ(eConnectionStatusSuccess, creator.Open(true, name.c_str(), size, &error)) << error.AsCString();
+    ASSERT_EQ(size, creator.GetByteSize());
+
+    ConnectionSharedMemory opener;
+    ASSERT_EQ(eConnectionStatusSuccess, opener.Open(false, name.c_str(), size, &error)) << error.AsCString();
+    creator.Unlink();
+
+    ::memcpy(opener.GetBytes() + 100, "hello", 6);
+    EXPECT_STREQ("hello", (const char *)creator.GetBytes() + 100);
+}
+
+TEST(ConnectionSharedMemoryTest, OpenMissing)
+{
+    const std::string name = GetTestName() + "-missing";
+
+    ConnectionSharedMemory opener;
+    Error error;
+    EXPECT_EQ(eConnectionStatusError, opener.Open(false, name.c_str(), 4096, &error));
+    EXPECT_TRUE(error.Fail());
+    EXPECT_FALSE(opener.IsConnected());
+}
+
+#endif
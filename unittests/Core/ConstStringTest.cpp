@@ -0,0 +1,83 @@
+//===-- ConstStringTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/ConstString.h"
+
+using namespace lldb_private;
+
+TEST(ConstStringTest, UniquesStrings)
+{
+    std::string foo("foo");
+    ConstString foo1("foo");
+    ConstString foo2(foo.c_str());
+    ConstString bar("bar");
+
+    EXPECT_EQ(foo1.GetCString(), foo2.GetCString());
+    EXPECT_NE(foo1.GetCString(), bar.GetCString());
+    EXPECT_NE(foo.c_str(), foo1.GetCString());
+    EXPECT_STREQ("foo", foo1.GetCString());
+}
+
+TEST(ConstStringTest, GetLength)
+{
+    EXPECT_EQ(0u, ConstString().GetLength());
+    EXPECT_EQ(0u, ConstString("").GetLength());
+    EXPECT_EQ(3u, ConstString("foo").GetLength());
+
+    // Strings with embedded NULL characters keep their full length
+    ConstString embedded_null("a\0b", 3);
+    EXPECT_EQ(3u, embedded_null.GetLength());
+    EXPECT_EQ(3u, embedded_null.GetStringRef().size());
+}
+
+TEST(ConstStringTest, MangledCounterpart)
+{
+    ConstString mangled("_Z3foov");
+    ConstString demangled;
+    demangled.SetCStringWithMangledCounterpart("foo()", mangled);
+
+    ConstString counterpart;
+    EXPECT_TRUE(mangled.GetMangledCounterpart(counterpart));
+    EXPECT_EQ(demangled, counterpart);
+    EXPECT_TRUE(demangled.GetMangledCounterpart(counterpart));
+    EXPECT_EQ(mangled, counterpart);
+}
+
+TEST(ConstStringTest, ConcurrentInsertion)
+{
+    const int num_threads = 4;
+    const int num_strings = 1000;
+    std::vector<std::vector<const char *>> results(num_threads);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        threads.emplace_back([t, &results]() {
+            for (int i = 0; i < num_strings; ++i)
+                results[t].push_back(ConstString(std::to_string(i).c_str()).GetCString());
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+
+    for (int t = 1; t < num_threads; ++t)
+        EXPECT_EQ(results[0], results[t]);
+}
@@ -13,12 +13,61 @@
 #include <eh.h>
 #endif
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "lldb/Core/DataExtractor.h"
 
 using namespace lldb_private;
 
+namespace
+{
+    void
+    AppendULEB128 (std::vector<uint8_t> &bytes, uint64_t value)
+    {
+        do
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            if (value)
+                byte |= 0x80;
+            bytes.push_back(byte);
+        } while (value);
+    }
+
+    void
+    AppendSLEB128 (std::vector<uint8_t> &bytes, int64_t value)
+    {
+        bool more = true;
+        while (more)
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            more = !((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40)));
+            if (more)
+                byte |= 0x80;
+            bytes.push_back(byte);
+        }
+    }
+
+    // Values of every encoded length, with the sign bit of the last group
+    // both set and clear.
+    std::vector<uint64_t>
+    GetLEB128TestValues ()
+    {
+        std::vector<uint64_t> values;
+        for (unsigned bits = 0; bits <= 64; ++bits)
+        {
+            const uint64_t value = bits == 64 ? UINT64_MAX : (1ULL << bits) - 1;
+            values.push_back(value);
+            values.push_back(value + 1);
+            values.push_back(value ^ 0x5555555555555555ULL);
+        }
+        return values;
+    }
+}
+
 TEST(DataExtractorTest, GetBitfield)
 {
     char buffer[] = { 0x01, 0x23, 0x45, 0x67 };
@@ -37,3 +86,72 @@ TEST(DataExtractorTest, GetBitfield)
     offset = 0;
     ASSERT_EQ(buffer[1], BE.GetMaxS64Bitfield(&offset, sizeof(buffer), 8, 8));
 }
+
+TEST(DataExtractorTest, GetULEB128)
+{
+    // Decode the values in the middle of the data and at its end, where
+    // there are fewer than 8 bytes left.
+    const std::vector<uint64_t> values = GetLEB128TestValues();
+    std::vector<uint8_t> bytes;
+    for (uint64_t value : values)
+        AppendULEB128(bytes, value);
+    for (uint64_t value : values)
+        AppendULEB128(bytes, value);
+    DataExtractor data(bytes.data(), bytes.size(), lldb::eByteOrderLittle, sizeof(void *));
+
+    lldb::offset_t offset = 0;
+    for (size_t i = 0; i < 2 * values.size(); ++i)
+    {
+        const uint64_t value = values[i % values.size()];
+        const lldb::offset_t start = offset;
+        EXPECT_EQ(value, data.GetULEB128(&offset)) << i;
+
+        std::vector<uint8_t> encoded;
+        AppendULEB128(encoded, value);
+        EXPECT_EQ(start + encoded.size(), offset) << i;
+
+        lldb::offset_t skip_offset = start;
+        EXPECT_EQ(encoded.size() - 1, data.Skip_LEB128(&skip_offset)) << i;
+        EXPECT_EQ(offset, skip_offset) << i;
+    }
+    EXPECT_EQ(bytes.size(), offset);
+}
+
+TEST(DataExtractorTest, GetSLEB128)
+{
+    const std::vector<uint64_t> values = GetLEB128TestValues();
+    std::vector<uint8_t> bytes;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (uint64_t value : values)
+        {
+            AppendSLEB128(bytes, (int64_t)value);
+            AppendSLEB128(bytes, (int64_t)(0 - value));
+        }
+    }
+    DataExtractor data(bytes.data(), bytes.size(), lldb::eByteOrderLittle, sizeof(void *));
+
+    lldb::offset_t offset = 0;
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (uint64_t value : values)
+        {
+            EXPECT_EQ((int64_t)value, data.GetSLEB128(&offset)) << value;
+            EXPECT_EQ((int64_t)(0 - value), data.GetSLEB128(&offset)) << value;
+        }
+    }
+    EXPECT_EQ(bytes.size(), offset);
+}
+
+TEST(DataExtractorTest, LEB128AtEndOfData)
+{
+    // A number that isn't terminated before the end of the data.
+    const uint8_t bytes[] = { 0x81, 0x82, 0x83 };
+    DataExtractor data(bytes, sizeof(bytes), lldb::eByteOrderLittle, sizeof(void *));
+
+    lldb::offset_t offset = 0;
+    EXPECT_EQ(0x01ULL | (0x02ULL << 7) | (0x03ULL << 14), data.GetULEB128(&offset));
+    EXPECT_EQ(3U, offset);
+    EXPECT_EQ(0U, data.GetULEB128(&offset));
+    EXPECT_EQ(3U, offset);
+}
@@ -0,0 +1,89 @@
+//===-- RangeMapTest.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/RangeMap.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    typedef RangeDataVector<uint32_t, uint32_t, uint32_t> RangeDataVectorT;
+
+    std::vector<uint32_t>
+    FindEntryIndexes (const RangeDataVectorT &map, uint32_t addr)
+    {
+        std::vector<uint32_t> indexes;
+        map.FindEntryIndexesThatContain(addr, indexes);
+        return indexes;
+    }
+}
+
+TEST(RangeDataVectorTest, FindEntryIndexesThatContain)
+{
+    RangeDataVectorT map;
+    map.Append(RangeDataVectorT::Entry(10, 10, 0));  // [10, 20)
+    map.Append(RangeDataVectorT::Entry(0, 100, 1));  // [0, 100)
+    map.Append(RangeDataVectorT::Entry(15, 1, 2));   // [15, 16)
+    map.Append(RangeDataVectorT::Entry(30, 0, 3));   // empty
+    map.Append(RangeDataVectorT::Entry(50, 10, 4));  // [50, 60)
+    map.Sort();
+
+    // Before the index is built every entry is looked at, afterwards only
+    // the ones that can contain the address. The answers have to be the
+    // same, in the order of the entries.
+    for (int indexed = 0; indexed < 2; ++indexed)
+    {
+        if (indexed)
+            map.BuildContainmentIndex();
+        EXPECT_EQ(std::vector<uint32_t>({1}), FindEntryIndexes(map, 0));
+        EXPECT_EQ(std::vector<uint32_t>({1, 0}), FindEntryIndexes(map, 10));
+        EXPECT_EQ(std::vector<uint32_t>({1, 0, 2}), FindEntryIndexes(map, 15));
+        EXPECT_EQ(std::vector<uint32_t>({1}), FindEntryIndexes(map, 20));
+        EXPECT_EQ(std::vector<uint32_t>({1}), FindEntryIndexes(map, 30));
+        EXPECT_EQ(std::vector<uint32_t>({1, 4}), FindEntryIndexes(map, 59));
+        EXPECT_TRUE(FindEntryIndexes(map, 100).empty());
+    }
+}
+
+TEST(RangeDataVectorTest, ContainmentIndexMatchesLinearScan)
+{
+    // Nested and overlapping ranges of all sizes, like the symbols of a
+    // binary with synthesized symbol sizes.
+    RangeDataVectorT linear;
+    RangeDataVectorT indexed;
+    for (uint32_t i = 0; i < 500; ++i)
+    {
+        const uint32_t base = (i * 37) % 1000;
+        const uint32_t size = (i * 13) % 97;
+        linear.Append(RangeDataVectorT::Entry(base, size, i));
+        indexed.Append(RangeDataVectorT::Entry(base, size, i));
+    }
+    linear.Sort();
+    indexed.Sort();
+    indexed.BuildContainmentIndex();
+
+    for (uint32_t addr = 0; addr < 1100; ++addr)
+        EXPECT_EQ(FindEntryIndexes(linear, addr), FindEntryIndexes(indexed, addr)) << "addr = " << addr;
+}
+
+TEST(RangeDataVectorTest, AppendDropsContainmentIndex)
+{
+    RangeDataVectorT map;
+    map.Append(RangeDataVectorT::Entry(0, 10, 0));
+    map.Sort();
+    map.BuildContainmentIndex();
+    map.Append(RangeDataVectorT::Entry(20, 10, 1));
+    map.Sort();
+
+    EXPECT_EQ(std::vector<uint32_t>({1}), FindEntryIndexes(map, 25));
+}
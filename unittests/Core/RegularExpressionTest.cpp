@@ -0,0 +1,69 @@
+//===-- RegularExpressionTest.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/RegularExpression.h"
+
+using namespace lldb_private;
+
+TEST(RegularExpressionTest, LiteralPrefix)
+{
+    RegularExpression regex("^MyNamespace::Handler.*");
+    ASSERT_TRUE(regex.IsValid());
+    EXPECT_EQ("MyNamespace::Handler", regex.GetLiteralPrefix());
+    EXPECT_EQ("MyNamespace::Handler", regex.GetRequiredLiteral());
+
+    EXPECT_TRUE(regex.Execute("MyNamespace::HandlerImpl::Run()"));
+    EXPECT_FALSE(regex.Execute("Other::MyNamespace::Handler"));
+    EXPECT_FALSE(regex.Execute("MyNamespace::Handle"));
+}
+
+TEST(RegularExpressionTest, RequiredLiteral)
+{
+    RegularExpression regex("[a-z]+_handler\\(int\\)");
+    ASSERT_TRUE(regex.IsValid());
+    EXPECT_EQ("", regex.GetLiteralPrefix());
+    EXPECT_EQ("_handler(int)", regex.GetRequiredLiteral());
+
+    EXPECT_TRUE(regex.Execute("signal_handler(int)"));
+    EXPECT_FALSE(regex.Execute("signal_handler(long)"));
+}
+
+TEST(RegularExpressionTest, OptionalCharactersAreNotRequired)
+{
+    RegularExpression regex("^abc?d*e{0,2}f");
+    ASSERT_TRUE(regex.IsValid());
+    EXPECT_EQ("ab", regex.GetLiteralPrefix());
+
+    EXPECT_TRUE(regex.Execute("abf"));
+    EXPECT_TRUE(regex.Execute("abcddeef"));
+    EXPECT_FALSE(regex.Execute("acf"));
+}
+
+TEST(RegularExpressionTest, NoLiteralsInAlternativesAndGroups)
+{
+    RegularExpression alternatives("^foo|bar");
+    ASSERT_TRUE(alternatives.IsValid());
+    EXPECT_EQ("", alternatives.GetLiteralPrefix());
+    EXPECT_EQ("", alternatives.GetRequiredLiteral());
+    EXPECT_TRUE(alternatives.Execute("xbar"));
+
+    RegularExpression group("^(foo)?bar");
+    ASSERT_TRUE(group.IsValid());
+    EXPECT_EQ("", group.GetLiteralPrefix());
+    EXPECT_EQ("bar", group.GetRequiredLiteral());
+    EXPECT_TRUE(group.Execute("bar"));
+    EXPECT_TRUE(group.Execute("foobar"));
+
+    RegularExpression classes("^\\w+\\.cpp");
+    ASSERT_TRUE(classes.IsValid());
+    EXPECT_EQ("", classes.GetLiteralPrefix());
+    EXPECT_EQ(".cpp", classes.GetRequiredLiteral());
+}
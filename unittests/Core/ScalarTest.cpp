@@ -79,3 +79,29 @@ TEST(ScalarTest, CastOperations)
     ASSERT_EQ((unsigned long long)a, a_scalar.ULongLong());
 }
 
+
+TEST(ScalarTest, FloatArithmetic)
+{
+    float a = 1.5f;
+    float b = 2.25f;
+    double c = 7.0;
+    double d = 0.1;
+    Scalar a_scalar(a);
+    Scalar b_scalar(b);
+    Scalar c_scalar(c);
+    Scalar d_scalar(d);
+    ASSERT_EQ(a + b, (a_scalar + b_scalar).Float());
+    ASSERT_EQ(a - b, (a_scalar - b_scalar).Float());
+    ASSERT_EQ(a * b, (a_scalar * b_scalar).Float());
+    ASSERT_EQ(a / b, (a_scalar / b_scalar).Float());
+    ASSERT_EQ(c * d, (c_scalar * d_scalar).Double());
+    ASSERT_EQ(c / d, (c_scalar / d_scalar).Double());
+
+    Scalar sum_scalar(c);
+    sum_scalar += d_scalar;
+    ASSERT_EQ(c + d, sum_scalar.Double());
+
+    // Dividing by zero doesn't give a value.
+    Scalar zero_scalar(0.0);
+    ASSERT_EQ(Scalar::e_void, (c_scalar / zero_scalar).GetType());
+}
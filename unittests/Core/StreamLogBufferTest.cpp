@@ -0,0 +1,100 @@
+//===-- StreamLogBufferTest.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/StreamLogBuffer.h"
+#include "lldb/Core/StreamString.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+TEST(StreamLogBufferTest, FlightRecorderKeepsLatest)
+{
+    StreamString *output = new StreamString();
+    StreamSP output_sp(output);
+    StreamLogBuffer buffer(output_sp, StreamLogBuffer::eModeFlightRecorder, 4);
+
+    for (int i = 0; i < 6; ++i)
+        buffer.Printf("line %d\n", i);
+
+    // Nothing is written until the records are drained.
+    EXPECT_TRUE(output->GetString().empty());
+
+    buffer.Drain();
+    EXPECT_EQ(std::string("line 2\nline 3\nline 4\nline 5\nwarning: 2 log messages were dropped\n"), output->GetString());
+    EXPECT_EQ(2u, buffer.GetNumDroppedMessages());
+
+    // Records are only written once.
+    output->Clear();
+    buffer.Drain();
+    EXPECT_TRUE(output->GetString().empty());
+
+    output->Clear();
+    buffer.PutCString("last\n");
+    EXPECT_EQ(1u, StreamLogBuffer::DrainFlightRecorders());
+    EXPECT_EQ(std::string("last\n"), output->GetString());
+}
+
+TEST(StreamLogBufferTest, TruncatesLongMessages)
+{
+    StreamString *output = new StreamString();
+    StreamSP output_sp(output);
+    StreamLogBuffer buffer(output_sp, StreamLogBuffer::eModeFlightRecorder, 2);
+
+    std::string message(StreamLogBuffer::kRecordSize + 10, 'x');
+    buffer.PutCString(message.c_str());
+    buffer.Drain();
+
+    ASSERT_EQ(StreamLogBuffer::kRecordSize, output->GetString().size());
+    EXPECT_EQ(std::string("...\n"), output->GetString().substr(StreamLogBuffer::kRecordSize - 4));
+}
+
+TEST(StreamLogBufferTest, AsyncWritesEverything)
+{
+    StreamString *output = new StreamString();
+    StreamSP output_sp(output);
+    {
+        StreamLogBuffer buffer(output_sp, StreamLogBuffer::eModeAsync, 1024);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.push_back(std::thread([&buffer, t]() {
+                for (int i = 0; i < 100; ++i)
+                    buffer.Printf("%d\n", t);
+            }));
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+
+        // Destroying the buffer writes out what is left.
+    }
+
+    const std::string &text = output->GetString();
+    size_t counts[4] = { 0, 0, 0, 0 };
+    for (char c : text)
+    {
+        if (c >= '0' && c <= '3')
+            ++counts[c - '0'];
+    }
+    for (size_t count : counts)
+        EXPECT_EQ(100u, count);
+    EXPECT_EQ(std::string::npos, text.find("dropped"));
+}
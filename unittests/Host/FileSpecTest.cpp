@@ -109,3 +109,21 @@ TEST(FileSpecTest, Equal)
     EXPECT_TRUE(FileSpec::Equal(forward, backward, !full_match, remove_backup_dots));
     EXPECT_TRUE(FileSpec::Equal(forward, backward, !full_match, !remove_backup_dots));
 }
+
+TEST(FileSpecTest, RemoveBackupDots)
+{
+    ConstString result;
+    FileSpec::RemoveBackupDots(ConstString("/foo/bar/../baz"), result);
+    EXPECT_STREQ("/foo/baz", result.GetCString());
+    // The second time the cached result is used.
+    FileSpec::RemoveBackupDots(ConstString("/foo/bar/../baz"), result);
+    EXPECT_STREQ("/foo/baz", result.GetCString());
+
+    ConstString no_dots("/foo/bar");
+    FileSpec::RemoveBackupDots(no_dots, result);
+    EXPECT_EQ(no_dots, result);
+
+    FileSpec dotted("/foo/bar/../baz/file.c", false, FileSpec::ePathSyntaxPosix);
+    FileSpec plain("/foo/baz/file.c", false, FileSpec::ePathSyntaxPosix);
+    EXPECT_TRUE(FileSpec::Equal(dotted, plain, true, true));
+}
@@ -0,0 +1,147 @@
+//===-- MainLoopTest.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _WIN32
+
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/Error.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/MainLoop.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    class MainLoopTest : public testing::Test
+    {
+    public:
+        void
+        SetUp() override
+        {
+            ASSERT_EQ(0, pipe(m_fds));
+        }
+
+        void
+        TearDown() override
+        {
+            close(m_fds[0]);
+            close(m_fds[1]);
+        }
+
+    protected:
+        int m_fds[2];
+    };
+}
+
+TEST_F(MainLoopTest, ReadObject)
+{
+    MainLoop loop;
+    Error error;
+    int callback_count = 0;
+    lldb::IOObjectSP file_sp(new File(m_fds[0], false));
+    MainLoop::ReadHandleUP handle = loop.RegisterReadObject(file_sp,
+        [&] (MainLoopBase &loop)
+        {
+            char c;
+            EXPECT_EQ(1, read(m_fds[0], &c, 1));
+            if (++callback_count == 2)
+                loop.RequestTermination();
+        }, error);
+    ASSERT_TRUE(handle != nullptr) << error.AsCString();
+
+    // Two bytes, one callback each: the descriptor stays ready until it
+    // has been read.
+    ASSERT_EQ(2, write(m_fds[1], "xy", 2));
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_EQ(2, callback_count);
+}
+
+TEST_F(MainLoopTest, ReadObjectTwice)
+{
+    MainLoop loop;
+    Error error;
+    lldb::IOObjectSP file_sp(new File(m_fds[0], false));
+    MainLoop::ReadHandleUP handle = loop.RegisterReadObject(file_sp, [] (MainLoopBase &) {}, error);
+    ASSERT_TRUE(handle != nullptr);
+    EXPECT_TRUE(loop.RegisterReadObject(file_sp, [] (MainLoopBase &) {}, error) == nullptr);
+    EXPECT_TRUE(error.Fail());
+}
+
+TEST_F(MainLoopTest, ReregisterAfterUnregister)
+{
+    MainLoop loop;
+    Error error;
+    lldb::IOObjectSP file_sp(new File(m_fds[0], false));
+    MainLoop::ReadHandleUP handle = loop.RegisterReadObject(file_sp, [] (MainLoopBase &) {}, error);
+    ASSERT_TRUE(handle != nullptr);
+    handle.reset();
+
+    bool called = false;
+    handle = loop.RegisterReadObject(file_sp,
+        [&] (MainLoopBase &loop)
+        {
+            called = true;
+            loop.RequestTermination();
+        }, error);
+    ASSERT_TRUE(handle != nullptr) << error.AsCString();
+    ASSERT_EQ(1, write(m_fds[1], "x", 1));
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_TRUE(called);
+}
+
+TEST_F(MainLoopTest, HighFileDescriptor)
+{
+    // Descriptors above FD_SETSIZE can't be waited for with pselect.
+    int fd = fcntl(m_fds[0], F_DUPFD, FD_SETSIZE + 10);
+    if (fd == -1)
+        return; // The descriptor limit is too low.
+
+    MainLoop loop;
+    Error error;
+    bool called = false;
+    lldb::IOObjectSP file_sp(new File(fd, true));
+    MainLoop::ReadHandleUP handle = loop.RegisterReadObject(file_sp,
+        [&] (MainLoopBase &loop)
+        {
+            called = true;
+            loop.RequestTermination();
+        }, error);
+    ASSERT_TRUE(handle != nullptr) << error.AsCString();
+    ASSERT_EQ(1, write(m_fds[1], "x", 1));
+#if defined(__linux__)
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_TRUE(called);
+#endif
+}
+
+TEST_F(MainLoopTest, Signal)
+{
+    MainLoop loop;
+    Error error;
+    bool called = false;
+    MainLoop::SignalHandleUP handle = loop.RegisterSignal(SIGUSR1,
+        [&] (MainLoopBase &loop)
+        {
+            called = true;
+            loop.RequestTermination();
+        }, error);
+    ASSERT_TRUE(handle != nullptr) << error.AsCString();
+
+    // The signal is blocked outside of Run, so it is delivered while we wait.
+    kill(getpid(), SIGUSR1);
+    ASSERT_TRUE(loop.Run().Success());
+    EXPECT_TRUE(called);
+}
+
+#endif // _WIN32
@@ -0,0 +1,86 @@
+//===-- CPlusPlusLanguageTest.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "Plugins/Language/CPlusPlus/CPlusPlusLanguage.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    bool
+    Extract (const char *mangled_name, std::string &context, std::string &identifier, bool &has_qualifiers)
+    {
+        has_qualifiers = false;
+        return CPlusPlusLanguage::ExtractContextAndIdentifierFromMangledName(mangled_name, context, identifier,
+                                                                             has_qualifiers);
+    }
+}
+
+TEST(CPlusPlusLanguageTest, ExtractFromMangledFunctionNames)
+{
+    std::string context, identifier;
+    bool has_qualifiers;
+
+    EXPECT_TRUE(Extract("_Z3foov", context, identifier, has_qualifiers));
+    EXPECT_EQ("", context);
+    EXPECT_EQ("foo", identifier);
+    EXPECT_FALSE(has_qualifiers);
+
+    EXPECT_TRUE(Extract("_ZL6helperi", context, identifier, has_qualifiers));
+    EXPECT_EQ("", context);
+    EXPECT_EQ("helper", identifier);
+
+    EXPECT_TRUE(Extract("_ZNK4lldb8SBTarget20GetBreakpointAtIndexEj", context, identifier, has_qualifiers));
+    EXPECT_EQ("lldb::SBTarget", context);
+    EXPECT_EQ("GetBreakpointAtIndex", identifier);
+    EXPECT_TRUE(has_qualifiers);
+
+    EXPECT_TRUE(Extract("_ZNSt6vector5clearEv", context, identifier, has_qualifiers));
+    EXPECT_EQ("std::vector", context);
+    EXPECT_EQ("clear", identifier);
+    EXPECT_FALSE(has_qualifiers);
+
+    EXPECT_TRUE(Extract("_ZN12_GLOBAL__N_13fooEv", context, identifier, has_qualifiers));
+    EXPECT_EQ("(anonymous namespace)", context);
+    EXPECT_EQ("foo", identifier);
+}
+
+TEST(CPlusPlusLanguageTest, ExtractFromMangledConstructorsAndDestructors)
+{
+    std::string context, identifier;
+    bool has_qualifiers;
+
+    EXPECT_TRUE(Extract("_ZN2ns3FooC2Ev", context, identifier, has_qualifiers));
+    EXPECT_EQ("ns::Foo", context);
+    EXPECT_EQ("Foo", identifier);
+
+    EXPECT_TRUE(Extract("_ZN2ns3FooD1Ev", context, identifier, has_qualifiers));
+    EXPECT_EQ("ns::Foo", context);
+    EXPECT_EQ("~Foo", identifier);
+}
+
+TEST(CPlusPlusLanguageTest, ExtractFromMangledNamesNeedingDemangler)
+{
+    std::string context("unchanged"), identifier("unchanged");
+    bool has_qualifiers = false;
+
+    EXPECT_FALSE(Extract("main", context, identifier, has_qualifiers));
+    EXPECT_FALSE(Extract("_Z3fooIiEvT_", context, identifier, has_qualifiers));       // templates
+    EXPECT_FALSE(Extract("_ZN3FooplERKS_", context, identifier, has_qualifiers));     // operators
+    EXPECT_FALSE(Extract("_ZNSt6vectorIiE5clearEv", context, identifier, has_qualifiers));
+    EXPECT_FALSE(Extract("_ZN3Foo3barB5cxx11Ev", context, identifier, has_qualifiers)); // ABI tags
+    EXPECT_FALSE(Extract("_ZN3Foo", context, identifier, has_qualifiers));            // truncated
+    EXPECT_FALSE(Extract("_Z99foo", context, identifier, has_qualifiers));
+    EXPECT_EQ("unchanged", context);
+    EXPECT_EQ("unchanged", identifier);
+}
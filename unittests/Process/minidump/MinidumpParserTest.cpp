@@ -0,0 +1,213 @@
+//===-- MinidumpParserTest.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+#include "lldb/Core/DataBufferHeap.h"
+
+#include "Plugins/Process/minidump/MinidumpParser.h"
+#include "Plugins/Process/minidump/MinidumpTypes.h"
+
+using namespace lldb;
+using namespace lldb_private;
+using namespace lldb_private::minidump;
+
+namespace
+{
+    // Writes a minidump into a buffer, the streams are appended in the
+    // order they are added.
+    class MinidumpBuilder
+    {
+    public:
+        void
+        AddStream (uint32_t stream_type, const std::vector<uint8_t> &data)
+        {
+            m_streams.push_back(std::make_pair(stream_type, data));
+        }
+
+        DataBufferSP
+        Finish ()
+        {
+            std::vector<uint8_t> file;
+            const uint32_t directory_rva = sizeof(MinidumpHeader);
+            uint32_t rva = directory_rva + m_streams.size() * sizeof(MinidumpDirectory);
+
+            Append32(file, MINIDUMP_SIGNATURE);
+            Append32(file, MINIDUMP_VERSION);
+            Append32(file, m_streams.size());
+            Append32(file, directory_rva);
+            file.resize(sizeof(MinidumpHeader), 0);
+
+            for (const auto &stream : m_streams)
+            {
+                Append32(file, stream.first);
+                Append32(file, stream.second.size());
+                Append32(file, rva);
+                rva += stream.second.size();
+            }
+            for (const auto &stream : m_streams)
+                file.insert(file.end(), stream.second.begin(), stream.second.end());
+            return DataBufferSP(new DataBufferHeap(file.data(), file.size()));
+        }
+
+        // The RVA the data of the next stream will have.
+        uint32_t
+        GetNextStreamRVA (size_t num_streams) const
+        {
+            uint32_t rva = sizeof(MinidumpHeader) + num_streams * sizeof(MinidumpDirectory);
+            for (const auto &stream : m_streams)
+                rva += stream.second.size();
+            return rva;
+        }
+
+        static void
+        Append32 (std::vector<uint8_t> &data, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i)
+                data.push_back((value >> (i * 8)) & 0xff);
+        }
+
+        static void
+        Append64 (std::vector<uint8_t> &data, uint64_t value)
+        {
+            Append32(data, value & 0xffffffff);
+            Append32(data, value >> 32);
+        }
+
+    private:
+        std::vector<std::pair<uint32_t, std::vector<uint8_t>>> m_streams;
+    };
+
+    std::vector<uint8_t>
+    MakeSystemInfo (uint16_t arch, uint32_t platform)
+    {
+        std::vector<uint8_t> data (sizeof(MinidumpSystemInfo), 0);
+        data[0] = arch & 0xff;
+        data[1] = arch >> 8;
+        memcpy(&data[offsetof(MinidumpSystemInfo, platform_id)], &platform, sizeof(platform));
+        return data;
+    }
+}
+
+TEST (MinidumpParserTest, RejectsInvalidData)
+{
+    Error error;
+    DataBufferSP data_sp (new DataBufferHeap(64, 0));
+    EXPECT_FALSE(MinidumpParser::IsMinidump(data_sp));
+    EXPECT_FALSE(MinidumpParser::Create(data_sp, error));
+    EXPECT_TRUE(error.Fail());
+
+    // A directory that is past the end of the file
+    std::vector<uint8_t> file;
+    MinidumpBuilder::Append32(file, MINIDUMP_SIGNATURE);
+    MinidumpBuilder::Append32(file, MINIDUMP_VERSION);
+    MinidumpBuilder::Append32(file, 10);
+    MinidumpBuilder::Append32(file, 1000);
+    file.resize(sizeof(MinidumpHeader), 0);
+    data_sp.reset(new DataBufferHeap(file.data(), file.size()));
+    EXPECT_TRUE(MinidumpParser::IsMinidump(data_sp));
+    error.Clear();
+    EXPECT_FALSE(MinidumpParser::Create(data_sp, error));
+    EXPECT_TRUE(error.Fail());
+}
+
+TEST (MinidumpParserTest, SystemInfoAndPid)
+{
+    MinidumpBuilder builder;
+    builder.AddStream(MINIDUMP_STREAM_SYSTEM_INFO, MakeSystemInfo(MINIDUMP_CPU_ARCHITECTURE_AMD64, MINIDUMP_OS_LINUX));
+    const char *status = "Name:\ta.out\nState:\tS (sleeping)\nPid:\t4242\n";
+    builder.AddStream(MINIDUMP_STREAM_LINUX_PROC_STATUS, std::vector<uint8_t>(status, status + strlen(status)));
+
+    Error error;
+    MinidumpParser::UP parser = MinidumpParser::Create(builder.Finish(), error);
+    ASSERT_TRUE(parser.get() != nullptr);
+    EXPECT_EQ("x86_64-unknown-linux", parser->GetArchitecture().GetTriple().getTriple());
+    EXPECT_EQ(4242u, parser->GetPid());
+    EXPECT_TRUE(parser->GetStream(MINIDUMP_STREAM_EXCEPTION).empty());
+    EXPECT_TRUE(parser->GetExceptionStream() == nullptr);
+}
+
+TEST (MinidumpParserTest, Threads)
+{
+    MinidumpBuilder builder;
+    std::vector<uint8_t> thread_list;
+    MinidumpBuilder::Append32(thread_list, 2);
+    for (uint32_t tid = 16; tid < 18; ++tid)
+    {
+        std::vector<uint8_t> thread (sizeof(MinidumpThread), 0);
+        memcpy(&thread[0], &tid, sizeof(tid));
+        thread_list.insert(thread_list.end(), thread.begin(), thread.end());
+    }
+    builder.AddStream(MINIDUMP_STREAM_THREAD_LIST, thread_list);
+
+    Error error;
+    MinidumpParser::UP parser = MinidumpParser::Create(builder.Finish(), error);
+    ASSERT_TRUE(parser.get() != nullptr);
+    llvm::ArrayRef<MinidumpThread> threads = parser->GetThreads();
+    ASSERT_EQ(2u, threads.size());
+    EXPECT_EQ(16u, threads[0].thread_id);
+    EXPECT_EQ(17u, threads[1].thread_id);
+    EXPECT_TRUE(parser->GetModuleList().empty());
+}
+
+TEST (MinidumpParserTest, MemoryRanges)
+{
+    MinidumpBuilder builder;
+    const size_t num_streams = 3;
+
+    // A MemoryList with one range, the bytes of the range are in a stream
+    // of their own right after the list.
+    std::vector<uint8_t> memory_list;
+    MinidumpBuilder::Append32(memory_list, 1);
+    MinidumpBuilder::Append64(memory_list, 0x1000);
+    MinidumpBuilder::Append32(memory_list, 4);
+    MinidumpBuilder::Append32(memory_list, builder.GetNextStreamRVA(num_streams) + 4 + sizeof(MinidumpMemoryDescriptor));
+    builder.AddStream(MINIDUMP_STREAM_MEMORY_LIST, memory_list);
+    const uint8_t bytes[] = { 0xde, 0xad, 0xbe, 0xef };
+    builder.AddStream(0x10000, std::vector<uint8_t>(bytes, bytes + sizeof(bytes)));
+
+    // A Memory64List with two ranges stored back to back
+    std::vector<uint8_t> memory64_list;
+    const uint32_t memory64_list_rva = builder.GetNextStreamRVA(num_streams);
+    MinidumpBuilder::Append64(memory64_list, 2);
+    MinidumpBuilder::Append64(memory64_list, memory64_list_rva + 16 + 2 * sizeof(MinidumpMemoryDescriptor64));
+    MinidumpBuilder::Append64(memory64_list, 0x3000);
+    MinidumpBuilder::Append64(memory64_list, 2);
+    MinidumpBuilder::Append64(memory64_list, 0x2000);
+    MinidumpBuilder::Append64(memory64_list, 3);
+    const uint8_t bytes64[] = { 1, 2, 3, 4, 5 };
+    memory64_list.insert(memory64_list.end(), bytes64, bytes64 + sizeof(bytes64));
+    builder.AddStream(MINIDUMP_STREAM_MEMORY64_LIST, memory64_list);
+
+    Error error;
+    MinidumpParser::UP parser = MinidumpParser::Create(builder.Finish(), error);
+    ASSERT_TRUE(parser.get() != nullptr);
+
+    MinidumpParser::MemoryRange range;
+    ASSERT_TRUE(parser->FindMemoryRange(0x1002, range));
+    EXPECT_EQ(0x1000u, range.start);
+    ASSERT_EQ(4u, range.data.size());
+    EXPECT_EQ(0xde, range.data[0]);
+
+    ASSERT_TRUE(parser->FindMemoryRange(0x3001, range));
+    EXPECT_EQ(0x3000u, range.start);
+    ASSERT_EQ(2u, range.data.size());
+    EXPECT_EQ(1, range.data[0]);
+
+    ASSERT_TRUE(parser->FindMemoryRange(0x2000, range));
+    EXPECT_EQ(0x2000u, range.start);
+    ASSERT_EQ(3u, range.data.size());
+    EXPECT_EQ(3, range.data[0]);
+
+    EXPECT_FALSE(parser->FindMemoryRange(0x1004, range));
+    EXPECT_FALSE(parser->FindMemoryRange(0x2003, range));
+}
@@ -0,0 +1,75 @@
+//===-- TestLineTable.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <memory>
+
+#include "lldb/Symbol/LineTable.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    void
+    AppendRow (LineTable &line_table, LineSequence *sequence, addr_t file_addr, uint16_t file_idx, uint32_t line,
+               bool is_terminal_entry = false)
+    {
+        line_table.AppendLineEntryToSequence (sequence, file_addr, line, 0, file_idx, true, false, false, false,
+                                              is_terminal_entry);
+    }
+}
+
+TEST(LineTableTest, FindLineEntryIndexByFileIndex)
+{
+    LineTable line_table (nullptr);
+
+    std::unique_ptr<LineSequence> sequence (line_table.CreateLineSequenceContainer());
+    AppendRow (line_table, sequence.get(), 0x100, 1, 10);
+    AppendRow (line_table, sequence.get(), 0x104, 1, 12);
+    AppendRow (line_table, sequence.get(), 0x108, 2, 5);
+    AppendRow (line_table, sequence.get(), 0x10c, 1, 10);
+    AppendRow (line_table, sequence.get(), 0x110, 1, 20);
+    AppendRow (line_table, sequence.get(), 0x114, 1, 20, true);
+    line_table.InsertSequence (sequence.get());
+    ASSERT_EQ (6u, line_table.GetSize());
+
+    EXPECT_EQ (0u, line_table.FindLineEntryIndexByFileIndex (0, 1, 10, true, nullptr));
+    EXPECT_EQ (3u, line_table.FindLineEntryIndexByFileIndex (1, 1, 10, true, nullptr));
+    EXPECT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (4, 1, 10, true, nullptr));
+    EXPECT_EQ (2u, line_table.FindLineEntryIndexByFileIndex (0, 2, 5, true, nullptr));
+    EXPECT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 3, 5, false, nullptr));
+
+    // The closest line after the one asked for, the terminal row doesn't count.
+    EXPECT_EQ (1u, line_table.FindLineEntryIndexByFileIndex (0, 1, 11, false, nullptr));
+    EXPECT_EQ (4u, line_table.FindLineEntryIndexByFileIndex (2, 1, 11, false, nullptr));
+    EXPECT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 1, 11, true, nullptr));
+    EXPECT_EQ (UINT32_MAX, line_table.FindLineEntryIndexByFileIndex (0, 1, 21, false, nullptr));
+
+    // An exact match in one file wins over a closer row in another one.
+    std::vector<uint32_t> file_indexes;
+    file_indexes.push_back (1);
+    file_indexes.push_back (2);
+    EXPECT_EQ (2u, line_table.FindLineEntryIndexByFileIndex (0, file_indexes, 5, false, nullptr));
+    EXPECT_EQ (1u, line_table.FindLineEntryIndexByFileIndex (0, file_indexes, 11, false, nullptr));
+    EXPECT_EQ (3u, line_table.FindLineEntryIndexByFileIndex (1, file_indexes, 10, true, nullptr));
+
+    // Inserting a sequence in front moves the rows.
+    sequence->Clear();
+    AppendRow (line_table, sequence.get(), 0x10, 1, 11);
+    AppendRow (line_table, sequence.get(), 0x14, 1, 11, true);
+    line_table.InsertSequence (sequence.get());
+    ASSERT_EQ (8u, line_table.GetSize());
+
+    EXPECT_EQ (0u, line_table.FindLineEntryIndexByFileIndex (0, 1, 11, true, nullptr));
+    EXPECT_EQ (2u, line_table.FindLineEntryIndexByFileIndex (0, 1, 10, true, nullptr));
+    EXPECT_EQ (5u, line_table.FindLineEntryIndexByFileIndex (3, 1, 10, true, nullptr));
+    EXPECT_EQ (3u, line_table.FindLineEntryIndexByFileIndex (1, 1, 11, false, nullptr));
+}
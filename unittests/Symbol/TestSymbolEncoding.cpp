@@ -0,0 +1,116 @@
+//===-- TestSymbolEncoding.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Section.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Symbol/Symbol.h"
+#include "lldb/Symbol/Symtab.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    DataExtractor
+    GetData (const StreamString &strm)
+    {
+        DataBufferSP data_sp (new DataBufferHeap (strm.GetData(), strm.GetSize()));
+        return DataExtractor (data_sp, endian::InlHostByteOrder(), 4);
+    }
+}
+
+TEST(SymbolEncodingTest, RoundTrip)
+{
+    SectionList section_list;
+    SectionSP text_sp (new Section (ModuleSP(), nullptr, 7, ConstString(".text"), eSectionTypeCode,
+                                    0x1000, 0x2000, 0x1000, 0x2000, 4, 0));
+    section_list.AddSection (text_sp);
+
+    Symbol code (12, "_Z3fooi", true, eSymbolTypeCode, true, false, false, false,
+                 text_sp, 0x40, 0x20, true, false, 0x12);
+    Symbol absolute (13, "abs_value", false, eSymbolTypeAbsolute, false, true, false, true,
+                     SectionSP(), 0x1234, 0, false, false, 0);
+
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    code.Encode (strm);
+    absolute.Encode (strm);
+
+    DataExtractor data = GetData (strm);
+    lldb::offset_t offset = 0;
+    Symbol decoded_code;
+    Symbol decoded_absolute;
+    ASSERT_TRUE (decoded_code.Decode (data, &offset, &section_list));
+    ASSERT_TRUE (decoded_absolute.Decode (data, &offset, &section_list));
+    EXPECT_EQ (strm.GetSize(), offset);
+
+    EXPECT_EQ (12u, decoded_code.GetID());
+    EXPECT_EQ (ConstString("_Z3fooi"), decoded_code.GetMangled().GetMangledName());
+    EXPECT_EQ (eSymbolTypeCode, decoded_code.GetType());
+    EXPECT_TRUE (decoded_code.IsExternal());
+    EXPECT_EQ (text_sp, decoded_code.GetAddressRef().GetSection());
+    EXPECT_EQ (0x40u, decoded_code.GetAddressRef().GetOffset());
+    EXPECT_EQ (0x20u, decoded_code.GetByteSize());
+    EXPECT_EQ (0x12u, decoded_code.GetFlags());
+
+    EXPECT_EQ (13u, decoded_absolute.GetID());
+    EXPECT_EQ (ConstString("abs_value"), decoded_absolute.GetName());
+    EXPECT_EQ (eSymbolTypeAbsolute, decoded_absolute.GetType());
+    EXPECT_TRUE (decoded_absolute.IsDebug());
+    EXPECT_TRUE (decoded_absolute.IsSynthetic());
+    EXPECT_FALSE (decoded_absolute.GetAddressRef().GetSection());
+    EXPECT_EQ (0x1234u, decoded_absolute.GetAddressRef().GetOffset());
+}
+
+TEST(SymbolEncodingTest, MissingSection)
+{
+    SectionSP text_sp (new Section (ModuleSP(), nullptr, 7, ConstString(".text"), eSectionTypeCode,
+                                    0x1000, 0x2000, 0x1000, 0x2000, 4, 0));
+    Symbol code (1, "main", false, eSymbolTypeCode, true, false, false, false,
+                 text_sp, 0x10, 0x20, true, false, 0);
+
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    code.Encode (strm);
+
+    // The section the symbol is in isn't in the list any more.
+    SectionList section_list;
+    DataExtractor data = GetData (strm);
+    lldb::offset_t offset = 0;
+    Symbol decoded;
+    EXPECT_FALSE (decoded.Decode (data, &offset, &section_list));
+}
+
+TEST(SymbolEncodingTest, SymtabRejectsTruncatedData)
+{
+    Symtab symtab (nullptr);
+    symtab.AddSymbol (Symbol (1, "first", false, eSymbolTypeData, true, false, false, false,
+                              SectionSP(), 0x100, 8, true, false, 0));
+    symtab.AddSymbol (Symbol (2, "second", false, eSymbolTypeData, true, false, false, false,
+                              SectionSP(), 0x108, 8, true, false, 0));
+
+    StreamString strm (Stream::eBinary, 4, endian::InlHostByteOrder());
+    symtab.Encode (strm);
+
+    Symtab decoded (nullptr);
+    DataExtractor data = GetData (strm);
+    lldb::offset_t offset = 0;
+    ASSERT_TRUE (decoded.Decode (data, &offset, nullptr));
+    ASSERT_EQ (2u, decoded.GetNumSymbols());
+    EXPECT_EQ (ConstString("second"), decoded.SymbolAtIndex(1)->GetName());
+
+    DataExtractor truncated (data, 0, data.GetByteSize() - 4);
+    Symtab rejected (nullptr);
+    offset = 0;
+    EXPECT_FALSE (rejected.Decode (truncated, &offset, nullptr));
+    EXPECT_EQ (0u, rejected.GetNumSymbols());
+}
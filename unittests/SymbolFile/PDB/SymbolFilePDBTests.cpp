@@ -452,6 +452,30 @@ TEST_F(SymbolFilePDBTests, REQUIRES_DIA_SDK(TestClassInNamespace))
     EXPECT_EQ(GetGlobalConstantInteger(session, "sizeof_NSClass"), udt_type->GetByteSize());
 }
 
+TEST_F(SymbolFilePDBTests, REQUIRES_DIA_SDK(TestCompleteClassTypes))
+{
+    FileSpec fspec(m_types_test_exe.c_str(), false);
+    ArchSpec aspec("i686-pc-windows");
+    lldb::ModuleSP module = std::make_shared<Module>(fspec, aspec);
+
+    SymbolVendor *plugin = module->GetSymbolVendor();
+    SymbolFilePDB *symfile = static_cast<SymbolFilePDB *>(plugin->GetSymbolFile());
+    SymbolContext sc;
+    llvm::DenseSet<SymbolFile *> searched_files;
+    TypeMap results;
+    EXPECT_EQ(1u, symfile->FindTypes(sc, ConstString("NS::NSClass"), nullptr, false, 0, searched_files, results));
+    EXPECT_EQ(1u, results.GetSize());
+    lldb::TypeSP udt_type = results.GetTypeAtIndex(0);
+
+    // The members are only added when the complete type is needed.
+    CompilerType compiler_type = udt_type->GetFullCompilerType();
+    clang::RecordDecl *record_decl = ClangASTContext::GetAsRecordDecl(compiler_type);
+    ASSERT_NE(nullptr, record_decl);
+    EXPECT_TRUE(record_decl->isCompleteDefinition());
+    EXPECT_EQ(2, std::distance(record_decl->field_begin(), record_decl->field_end()));
+    EXPECT_EQ(ConstString("f"), ConstString(record_decl->field_begin()->getName()));
+}
+
 TEST_F(SymbolFilePDBTests, REQUIRES_DIA_SDK(TestEnumTypes))
 {
     FileSpec fspec(m_types_test_exe.c_str(), false);
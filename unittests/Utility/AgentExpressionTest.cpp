@@ -0,0 +1,122 @@
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/AgentExpression.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    class AgentExpressionTest: public ::testing::Test
+    {
+    };
+
+    bool
+    ReadRegister (uint32_t reg_num, uint64_t &value)
+    {
+        value = 0x1000 + reg_num;
+        return true;
+    }
+
+    bool
+    ReadMemory (lldb::addr_t addr, size_t size, uint64_t &value)
+    {
+        if (addr != 0x2000)
+            return false;
+        // A 32 bit -5 followed by zeros.
+        value = size == 4 ? 0xfffffffbull : 0xfbull;
+        return true;
+    }
+
+    Error
+    Evaluate (const AgentExpression &expr, uint64_t &result)
+    {
+        return expr.Evaluate(ReadRegister, ReadMemory, result);
+    }
+}
+
+TEST_F (AgentExpressionTest, Constants)
+{
+    AgentExpression expr;
+    expr.AppendConstant(0x12);
+    expr.AppendConstant(0x1234);
+    expr.AppendOpcode(AgentExpression::eOpcodeAdd);
+    expr.AppendConstant(0x123456789aull);
+    expr.AppendOpcode(AgentExpression::eOpcodeAdd);
+    expr.AppendOpcode(AgentExpression::eOpcodeEnd);
+
+    // const8, const16, add, const64, add, end
+    ASSERT_EQ(2u + 3u + 1u + 9u + 1u + 1u, expr.GetBytes().size());
+
+    uint64_t result = 0;
+    ASSERT_TRUE(Evaluate(expr, result).Success());
+    ASSERT_EQ(0x12 + 0x1234 + 0x123456789aull, result);
+}
+
+TEST_F (AgentExpressionTest, SignedMemoryCompare)
+{
+    // *(int32_t *)($r0 + 0x1000) < 0, where $r0 reads as 0x1000
+    AgentExpression expr;
+    expr.AppendRegister(0);
+    expr.AppendConstant(0x1000);
+    expr.AppendOpcode(AgentExpression::eOpcodeAdd);
+    expr.AppendOpcode(AgentExpression::eOpcodeRef32);
+    expr.AppendOpcode(AgentExpression::eOpcodeExt, 32);
+    expr.AppendConstant(0);
+    expr.AppendOpcode(AgentExpression::eOpcodeLessSigned);
+    expr.AppendOpcode(AgentExpression::eOpcodeEnd);
+
+    uint64_t result = 0;
+    ASSERT_TRUE(Evaluate(expr, result).Success());
+    ASSERT_EQ(1u, result);
+
+    // Without the sign extension the value is a large positive number.
+    AgentExpression unsigned_expr;
+    unsigned_expr.AppendConstant(0x2000);
+    unsigned_expr.AppendOpcode(AgentExpression::eOpcodeRef32);
+    unsigned_expr.AppendConstant(0);
+    unsigned_expr.AppendOpcode(AgentExpression::eOpcodeLessSigned);
+    unsigned_expr.AppendOpcode(AgentExpression::eOpcodeEnd);
+
+    ASSERT_TRUE(Evaluate(unsigned_expr, result).Success());
+    ASSERT_EQ(0u, result);
+}
+
+TEST_F (AgentExpressionTest, Goto)
+{
+    // if (1) goto 8; const8 0; end; 8: const8 7; end
+    const uint8_t bytes[] = { 0x22, 0x01, 0x20, 0x00, 0x08, 0x22, 0x00, 0x27, 0x22, 0x07, 0x27 };
+    AgentExpression expr(bytes, sizeof(bytes));
+
+    uint64_t result = 0;
+    ASSERT_TRUE(Evaluate(expr, result).Success());
+    ASSERT_EQ(7u, result);
+}
+
+TEST_F (AgentExpressionTest, Errors)
+{
+    uint64_t result = 0;
+
+    // Missing end opcode.
+    const uint8_t no_end[] = { 0x22, 0x01 };
+    ASSERT_TRUE(Evaluate(AgentExpression(no_end, sizeof(no_end)), result).Fail());
+
+    // Stack underflow.
+    const uint8_t underflow[] = { 0x22, 0x01, 0x02, 0x27 };
+    ASSERT_TRUE(Evaluate(AgentExpression(underflow, sizeof(underflow)), result).Fail());
+
+    // Truncated operand.
+    const uint8_t truncated[] = { 0x24, 0x01, 0x02 };
+    ASSERT_TRUE(Evaluate(AgentExpression(truncated, sizeof(truncated)), result).Fail());
+
+    // Unreadable memory.
+    const uint8_t bad_read[] = { 0x22, 0x10, 0x17, 0x27 };
+    ASSERT_TRUE(Evaluate(AgentExpression(bad_read, sizeof(bad_read)), result).Fail());
+
+    // Infinite loop.
+    const uint8_t loop[] = { 0x21, 0x00, 0x00 };
+    ASSERT_TRUE(Evaluate(AgentExpression(loop, sizeof(loop)), result).Fail());
+
+    // Division by zero.
+    const uint8_t div_zero[] = { 0x22, 0x01, 0x22, 0x00, 0x06, 0x27 };
+    ASSERT_TRUE(Evaluate(AgentExpression(div_zero, sizeof(div_zero)), result).Fail());
+}
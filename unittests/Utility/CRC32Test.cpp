@@ -0,0 +1,91 @@
+//===-- CRC32Test.cpp -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/CRC32.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    uint32_t
+    BytewiseCRC32 (const uint8_t *data, size_t length)
+    {
+        uint32_t crc = ~0U;
+        while (length--)
+        {
+            crc ^= *data++;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+        }
+        return ~crc;
+    }
+
+    std::vector<uint8_t>
+    MakeBytes (size_t length)
+    {
+        std::vector<uint8_t> bytes(length);
+        for (size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<uint8_t>(i * 37 + (i >> 9));
+        return bytes;
+    }
+}
+
+TEST(CRC32Test, ReferenceValues)
+{
+    EXPECT_EQ(0U, CRC32(0, "", 0));
+    EXPECT_EQ(0xcbf43926U, CRC32(0, "123456789", 9));
+    EXPECT_EQ(0x414fa339U, CRC32(0, "The quick brown fox jumps over the lazy dog", 43));
+}
+
+TEST(CRC32Test, MatchesBytewise)
+{
+    // Every alignment and tail length around the 8 byte steps.
+    std::vector<uint8_t> bytes = MakeBytes(100);
+    for (size_t start = 0; start < 8; ++start)
+        for (size_t length = 0; start + length <= bytes.size(); ++length)
+            EXPECT_EQ(BytewiseCRC32(bytes.data() + start, length), CRC32(0, bytes.data() + start, length))
+                << start << " " << length;
+}
+
+TEST(CRC32Test, Continue)
+{
+    std::vector<uint8_t> bytes = MakeBytes(1000);
+    const uint32_t crc = CRC32(0, bytes.data(), bytes.size());
+    EXPECT_EQ(crc, CRC32(CRC32(0, bytes.data(), 333), bytes.data() + 333, bytes.size() - 333));
+}
+
+TEST(CRC32Test, Combine)
+{
+    std::vector<uint8_t> bytes = MakeBytes(5000);
+    const uint32_t crc = CRC32(0, bytes.data(), bytes.size());
+    for (size_t split : {0, 1, 7, 8, 2500, 4999, 5000})
+    {
+        const uint32_t crc1 = CRC32(0, bytes.data(), split);
+        const uint32_t crc2 = CRC32(0, bytes.data() + split, bytes.size() - split);
+        EXPECT_EQ(crc, CRC32Combine(crc1, crc2, bytes.size() - split)) << split;
+    }
+}
+
+TEST(CRC32Test, Parallel)
+{
+    // Big enough to be split in chunks, with a partial last chunk.
+    std::vector<uint8_t> bytes = MakeBytes(37 * 1024 * 1024 + 123);
+    const uint32_t crc = CRC32(0, bytes.data(), bytes.size());
+    EXPECT_EQ(crc, CRC32Parallel(0, bytes.data(), bytes.size()));
+    EXPECT_EQ(CRC32(crc, "abc", 3), CRC32Parallel(crc, "abc", 3));
+
+    const uint32_t start = CRC32(0, "abc", 3);
+    EXPECT_EQ(CRC32(start, bytes.data(), bytes.size()), CRC32Parallel(start, bytes.data(), bytes.size()));
+}
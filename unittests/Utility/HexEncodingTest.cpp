@@ -0,0 +1,107 @@
+//===-- HexEncodingTest.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/HexEncoding.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    std::vector<uint8_t>
+    MakeBytes (size_t length)
+    {
+        std::vector<uint8_t> bytes(length);
+        for (size_t i = 0; i < length; ++i)
+            bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+        return bytes;
+    }
+
+    std::string
+    ScalarEncode (const std::vector<uint8_t> &bytes)
+    {
+        static const char hex_chars[] = "0123456789abcdef";
+        std::string hex;
+        for (uint8_t byte : bytes)
+        {
+            hex.push_back(hex_chars[byte >> 4]);
+            hex.push_back(hex_chars[byte & 0xf]);
+        }
+        return hex;
+    }
+}
+
+TEST (HexEncodingTest, Encode)
+{
+    const uint8_t bytes[] = { 0x00, 0x7f, 0x80, 0xab, 0xff };
+    char hex[10];
+    HexEncode(bytes, sizeof(bytes), hex);
+    EXPECT_EQ("007f80abff", std::string(hex, sizeof(hex)));
+}
+
+TEST (HexEncodingTest, EncodeAllLengths)
+{
+    // Covers the vector blocks and the tails after them.
+    for (size_t length = 0; length < 100; ++length)
+    {
+        std::vector<uint8_t> bytes = MakeBytes(length);
+        std::string hex(2 * length, '\0');
+        HexEncode(bytes.data(), length, &hex[0]);
+        EXPECT_EQ(ScalarEncode(bytes), hex) << "length " << length;
+    }
+}
+
+TEST (HexEncodingTest, DecodeAllLengths)
+{
+    for (size_t length = 0; length < 100; ++length)
+    {
+        std::vector<uint8_t> bytes = MakeBytes(length);
+        const std::string hex = ScalarEncode(bytes);
+        std::vector<uint8_t> decoded(length);
+        EXPECT_EQ(length, HexDecode(hex.data(), length, decoded.data()));
+        EXPECT_EQ(bytes, decoded) << "length " << length;
+    }
+}
+
+TEST (HexEncodingTest, DecodeUpperCase)
+{
+    const std::string hex = "0123456789ABCDEFabcdefAbCdEf0A1b";
+    uint8_t bytes[16];
+    ASSERT_EQ(16u, HexDecode(hex.data(), 16, bytes));
+    const uint8_t expected[] = { 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+                                 0xab, 0xcd, 0xef, 0xab, 0xcd, 0xef, 0x0a, 0x1b };
+    EXPECT_EQ(0, memcmp(expected, bytes, sizeof(bytes)));
+}
+
+TEST (HexEncodingTest, DecodeStopsAtBadCharacter)
+{
+    const std::vector<uint8_t> bytes = MakeBytes(40);
+    const std::string good_hex = ScalarEncode(bytes);
+    const char bad_chars[] = { 'g', 'G', ':', '@', '`', '/', ' ', '\0', '\x80', '\xff' };
+
+    for (size_t pos = 0; pos < good_hex.size(); ++pos)
+    {
+        for (char bad_char : bad_chars)
+        {
+            std::string hex = good_hex;
+            hex[pos] = bad_char;
+            std::vector<uint8_t> decoded(bytes.size(), 0);
+            ASSERT_EQ(pos / 2, HexDecode(hex.data(), bytes.size(), decoded.data()))
+                << "bad character " << int(bad_char) << " at " << pos;
+            EXPECT_TRUE(std::equal(bytes.begin(), bytes.begin() + pos / 2, decoded.begin()));
+        }
+    }
+}
@@ -0,0 +1,106 @@
+//===-- JSONPullParserTest.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/JSON.h"
+
+using namespace lldb_private;
+
+typedef JSONPullParser::Event PullEvent;
+
+TEST(JSONPullParserTest, Object)
+{
+    JSONPullParser parser("{ \"tid\" : 1234, \"name\": \"main\", \"regs\": [-1, 2.5e3, true, false, null] }");
+    ASSERT_EQ(PullEvent::ObjectStart, parser.Next());
+    ASSERT_EQ(PullEvent::Key, parser.Next());
+    EXPECT_EQ("tid", parser.GetValue());
+    ASSERT_EQ(PullEvent::Integer, parser.Next());
+    EXPECT_EQ(1234u, parser.GetValueAsUnsigned(0));
+    ASSERT_EQ(PullEvent::Key, parser.Next());
+    EXPECT_EQ("name", parser.GetValue());
+    ASSERT_EQ(PullEvent::String, parser.Next());
+    EXPECT_EQ("main", parser.GetValue());
+    ASSERT_EQ(PullEvent::Key, parser.Next());
+    ASSERT_EQ(PullEvent::ArrayStart, parser.Next());
+    ASSERT_EQ(PullEvent::Integer, parser.Next());
+    EXPECT_EQ(-1, parser.GetValueAsSigned(0));
+    ASSERT_EQ(PullEvent::Float, parser.Next());
+    EXPECT_EQ("2.5e3", parser.GetValue());
+    EXPECT_EQ(PullEvent::True, parser.Next());
+    EXPECT_EQ(PullEvent::False, parser.Next());
+    EXPECT_EQ(PullEvent::Null, parser.Next());
+    EXPECT_EQ(PullEvent::ArrayEnd, parser.Next());
+    EXPECT_EQ(PullEvent::ObjectEnd, parser.Next());
+    EXPECT_EQ(PullEvent::EndOfFile, parser.Next());
+}
+
+TEST(JSONPullParserTest, Escapes)
+{
+    JSONPullParser parser("[\"a\\\"b\\\\c\\/d\\n\", \"\\u0041\\u00e9\"]");
+    ASSERT_EQ(PullEvent::ArrayStart, parser.Next());
+    ASSERT_EQ(PullEvent::String, parser.Next());
+    EXPECT_EQ("a\"b\\c/d\n", parser.GetValue());
+    ASSERT_EQ(PullEvent::String, parser.Next());
+    EXPECT_EQ("A\xc3\xa9", parser.GetValue());
+    EXPECT_EQ(PullEvent::ArrayEnd, parser.Next());
+}
+
+TEST(JSONPullParserTest, SkipValue)
+{
+    JSONPullParser parser("{\"skip\": {\"a\": [1, {\"b\": []}], \"c\": {}}, \"keep\": 7}");
+    ASSERT_EQ(PullEvent::ObjectStart, parser.Next());
+    ASSERT_EQ(PullEvent::Key, parser.Next());
+    ASSERT_EQ(PullEvent::ObjectStart, parser.Next());
+    ASSERT_TRUE(parser.SkipValue());
+    ASSERT_EQ(PullEvent::Key, parser.Next());
+    EXPECT_EQ("keep", parser.GetValue());
+    ASSERT_EQ(PullEvent::Integer, parser.Next());
+    ASSERT_TRUE(parser.SkipValue());
+    EXPECT_EQ(7u, parser.GetValueAsUnsigned(0));
+    EXPECT_EQ(PullEvent::ObjectEnd, parser.Next());
+}
+
+TEST(JSONPullParserTest, SetOffset)
+{
+    const char *text = "[{\"tid\": 1}, {\"tid\": 2}]";
+    JSONPullParser parser(text);
+    ASSERT_EQ(PullEvent::ArrayStart, parser.Next());
+    ASSERT_EQ(PullEvent::ObjectStart, parser.Next());
+    ASSERT_TRUE(parser.SkipValue());
+    ASSERT_EQ(PullEvent::ObjectStart, parser.Next());
+    const size_t offset = parser.GetEventOffset();
+    EXPECT_EQ('{', text[offset]);
+
+    // The object is read as if it was the whole text.
+    parser.SetOffset(offset);
+    ASSERT_EQ(PullEvent::ObjectStart, parser.Next());
+    ASSERT_EQ(PullEvent::Key, parser.Next());
+    ASSERT_EQ(PullEvent::Integer, parser.Next());
+    EXPECT_EQ(2u, parser.GetValueAsUnsigned(0));
+    EXPECT_EQ(PullEvent::ObjectEnd, parser.Next());
+    EXPECT_EQ(PullEvent::EndOfFile, parser.Next());
+}
+
+TEST(JSONPullParserTest, Errors)
+{
+    const char *bad[] = { "", "{", "[1 2]", "{\"a\" 1}", "{1: 2}", "[1,]", "[}", "\"abc", "tru", "-", "1.", "1e" };
+    for (const char *text : bad)
+    {
+        JSONPullParser parser(text);
+        PullEvent event;
+        do
+        {
+            event = parser.Next();
+        } while (event != PullEvent::Error && event != PullEvent::EndOfFile);
+        EXPECT_EQ(PullEvent::Error, event) << text;
+        // Errors are sticky.
+        EXPECT_EQ(PullEvent::Error, parser.Next()) << text;
+    }
+}
@@ -0,0 +1,206 @@
+//===-- MemorySearchTest.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+#include <vector>
+
+#include "lldb/lldb-defines.h"
+#include "lldb/Utility/MemorySearch.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    // Memory at [base, base + bytes.size()) where [hole_begin, hole_end)
+    // can't be read.
+    class FakeMemory
+    {
+    public:
+        FakeMemory (lldb::addr_t base, size_t size) :
+            m_base (base),
+            m_bytes (size, 0),
+            m_hole_begin (0),
+            m_hole_end (0)
+        {
+        }
+
+        void
+        Write (lldb::addr_t addr, const char *str)
+        {
+            memcpy (&m_bytes[addr - m_base], str, strlen(str));
+        }
+
+        void
+        SetHole (lldb::addr_t begin, lldb::addr_t end)
+        {
+            m_hole_begin = begin;
+            m_hole_end = end;
+        }
+
+        size_t
+        Read (lldb::addr_t addr, void *buf, size_t size)
+        {
+            ++m_num_reads;
+            size_t bytes_read = 0;
+            while (bytes_read < size)
+            {
+                const lldb::addr_t a = addr + bytes_read;
+                if (a < m_base || a >= m_base + m_bytes.size() || (a >= m_hole_begin && a < m_hole_end))
+                    break;
+                static_cast<uint8_t *>(buf)[bytes_read++] = m_bytes[a - m_base];
+            }
+            return bytes_read;
+        }
+
+        bool
+        GetRegion (lldb::addr_t addr, lldb::addr_t &region_end, bool &readable)
+        {
+            if (addr >= m_hole_begin && addr < m_hole_end)
+            {
+                region_end = m_hole_end;
+                readable = false;
+            }
+            else if (addr < m_hole_begin)
+            {
+                region_end = m_hole_begin;
+                readable = true;
+            }
+            else
+            {
+                region_end = m_base + m_bytes.size();
+                readable = true;
+            }
+            return true;
+        }
+
+        MemorySearch::ReadMemoryCallback
+        GetReader ()
+        {
+            return [this](lldb::addr_t addr, void *buf, size_t size) { return Read(addr, buf, size); };
+        }
+
+        MemorySearch::RegionInfoCallback
+        GetRegionInfo ()
+        {
+            return [this](lldb::addr_t addr, lldb::addr_t &end, bool &readable) { return GetRegion(addr, end, readable); };
+        }
+
+        size_t m_num_reads = 0;
+
+    private:
+        lldb::addr_t m_base;
+        std::vector<uint8_t> m_bytes;
+        lldb::addr_t m_hole_begin;
+        lldb::addr_t m_hole_end;
+    };
+
+    lldb::addr_t
+    Find (FakeMemory &memory, lldb::addr_t low, lldb::addr_t high, const char *pattern, size_t chunk_size,
+          bool use_regions = true)
+    {
+        return MemorySearch::Find (low, high, reinterpret_cast<const uint8_t *>(pattern), strlen(pattern),
+                                   memory.GetReader(),
+                                   use_regions ? memory.GetRegionInfo() : MemorySearch::RegionInfoCallback(),
+                                   chunk_size);
+    }
+}
+
+TEST (MemorySearchTest, FindInBuffer)
+{
+    const uint8_t buf[] = "abcabdabe";
+    const uint8_t pattern[] = "abd";
+    EXPECT_EQ(buf + 3, MemorySearch::FindInBuffer(buf, 9, pattern, 3));
+    EXPECT_EQ(nullptr, MemorySearch::FindInBuffer(buf, 5, pattern, 3));
+    EXPECT_EQ(buf + 6, MemorySearch::FindInBuffer(buf, 9, reinterpret_cast<const uint8_t *>("abe"), 3));
+    EXPECT_EQ(nullptr, MemorySearch::FindInBuffer(buf, 2, pattern, 3));
+}
+
+TEST (MemorySearchTest, MatchAcrossChunks)
+{
+    FakeMemory memory (0x1000, 0x1000);
+    memory.Write(0x1ffe - 0x800, "needle");
+    for (size_t chunk_size = 1; chunk_size < 16; ++chunk_size)
+        EXPECT_EQ(0x17feu, Find(memory, 0x1000, 0x2000, "needle", chunk_size));
+
+    // Far fewer reads than bytes
+    memory.m_num_reads = 0;
+    EXPECT_EQ(0x17feu, Find(memory, 0x1000, 0x2000, "needle", 0x100));
+    EXPECT_LE(memory.m_num_reads, 16u);
+}
+
+TEST (MemorySearchTest, Bounds)
+{
+    FakeMemory memory (0x1000, 0x1000);
+    memory.Write(0x1100, "needle");
+    memory.Write(0x1200, "needle");
+    EXPECT_EQ(0x1100u, Find(memory, 0x1000, 0x2000, "needle", 64));
+    EXPECT_EQ(0x1200u, Find(memory, 0x1101, 0x2000, "needle", 64));
+
+    // A match may extend past the high address, but not start there.
+    EXPECT_EQ(0x1100u, Find(memory, 0x1000, 0x1101, "needle", 64));
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, Find(memory, 0x1000, 0x1100, "needle", 64));
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, Find(memory, 0x1201, 0x2000, "needle", 64));
+}
+
+TEST (MemorySearchTest, SkipsUnreadableMemory)
+{
+    FakeMemory memory (0x1000, 0x1000);
+    memory.SetHole(0x1400, 0x1800);
+    memory.Write(0x1900, "needle");
+    EXPECT_EQ(0x1900u, Find(memory, 0x1000, 0x2000, "needle", 0x100));
+
+    // Without region information the search stops at the hole.
+    EXPECT_EQ(LLDB_INVALID_ADDRESS, Find(memory, 0x1000, 0x2000, "needle", 0x100, false));
+
+    // Matches can't span the hole
+    memory.Write(0x13fd, "nee");
+    memory.Write(0x1800, "dle");
+    EXPECT_EQ(0x1900u, Find(memory, 0x1000, 0x2000, "needle", 0x100));
+}
+
+TEST (MemorySearchTest, FindPointers)
+{
+    FakeMemory memory (0x1000, 0x1000);
+    memory.Write(0x1008, "\x88\x77\x66\x55\x44\x33\x22\x11");
+    memory.Write(0x1013, "\x88\x77\x66\x55\x44\x33\x22\x11"); // not aligned
+    memory.Write(0x1800, "\x88\x77\x66\x55\x44\x33\x22\x11");
+    memory.Write(0x1ff8, "\x88\x77\x66\x55\x44\x33\x22\x11");
+
+    std::vector<lldb::addr_t> matches;
+    EXPECT_EQ(0x2000u, MemorySearch::FindPointers(0x1000, 0x2000, 0x1122334455667788ull, 8, lldb::eByteOrderLittle,
+                                                  memory.GetReader(), 100, matches, 0x100));
+    ASSERT_EQ(3u, matches.size());
+    EXPECT_EQ(0x1008u, matches[0]);
+    EXPECT_EQ(0x1800u, matches[1]);
+    EXPECT_EQ(0x1ff8u, matches[2]);
+
+    // Resume after the first match
+    matches.clear();
+    const lldb::addr_t resume_addr = MemorySearch::FindPointers(0x1000, 0x2000, 0x1122334455667788ull, 8,
+                                                                lldb::eByteOrderLittle, memory.GetReader(), 1,
+                                                                matches, 0x100);
+    EXPECT_EQ(0x1010u, resume_addr);
+    matches.clear();
+    MemorySearch::FindPointers(resume_addr, 0x2000, 0x1122334455667788ull, 8, lldb::eByteOrderLittle,
+                               memory.GetReader(), 100, matches, 0x100);
+    EXPECT_EQ(2u, matches.size());
+
+    // 32 bit big endian pointers, the unreadable part is skipped
+    memory.Write(0x1104, "\x11\x22\x33\x44");
+    memory.Write(0x1904, "\x11\x22\x33\x44");
+    memory.SetHole(0x1200, 0x1400);
+    matches.clear();
+    MemorySearch::FindPointers(0x1000, 0x2000, 0x11223344, 4, lldb::eByteOrderBig, memory.GetReader(), 100,
+                               matches, 0x100);
+    ASSERT_EQ(2u, matches.size());
+    EXPECT_EQ(0x1104u, matches[0]);
+    EXPECT_EQ(0x1904u, matches[1]);
+}
@@ -60,3 +60,84 @@ TEST (TaskPoolTest, TaskRunner)
 
     ASSERT_EQ(4, count);
 }
+
+TEST (TaskPoolTest, AddTaskWithPriority)
+{
+    auto fn = [](int x) { return x * x + 1; };
+
+    auto f1 = TaskPool::AddTaskWithPriority(TaskPool::ePriorityLow, fn, 1);
+    auto f2 = TaskPool::AddTaskWithPriority(TaskPool::ePriorityHigh, fn, 2);
+    auto f3 = TaskPool::AddTaskWithPriority(TaskPool::ePriorityNormal, fn, 3);
+
+    ASSERT_EQ (10, f3.get());
+    ASSERT_EQ ( 2, f1.get());
+    ASSERT_EQ ( 5, f2.get());
+}
+
+TEST (TaskPoolTest, CancellationToken)
+{
+    TaskCancellationToken token;
+    std::atomic<int> cancelled_count(0);
+
+    std::promise<void> started;
+    std::promise<void> cancel;
+    std::shared_future<void> cancel_future(cancel.get_future());
+
+    auto f = TaskPool::AddTask([&, token]() {
+        started.set_value();
+        cancel_future.wait();
+        if (token.IsCancelled())
+            cancelled_count++;
+    });
+
+    started.get_future().wait();
+    ASSERT_FALSE (token.IsCancelled());
+    token.Cancel();
+    cancel.set_value();
+    f.wait();
+
+    ASSERT_TRUE (token.IsCancelled());
+    ASSERT_EQ (1, cancelled_count);
+}
+
+TEST (TaskPoolTest, Throughput)
+{
+    // Lots of tiny tasks added from several threads at once to make sure none of them get lost or
+    // run twice when the workers are stealing work from each other.
+    const int num_producers = 4;
+    const int num_tasks = 20000;
+    std::atomic<int> count(0);
+
+    std::vector<std::thread> producers;
+    producers.emplace_back([&]() {
+        TaskRunner<void> tr(TaskPool::ePriorityLow);
+        for (int i = 0; i < num_tasks; ++i)
+            tr.AddTask([&count]() { count++; });
+        tr.WaitForAllTasks();
+    });
+    producers.emplace_back([&]() {
+        TaskRunner<int> tr;
+        for (int i = 0; i < num_tasks; ++i)
+            tr.AddTask([&count](int x) { count++; return x; }, i);
+        tr.WaitForAllTasks();
+    });
+    producers.emplace_back([&]() {
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < num_tasks; ++i)
+            futures.push_back(TaskPool::AddTaskWithPriority(TaskPool::ePriorityHigh, [&count]() { count++; }));
+        for (auto &f : futures)
+            f.wait();
+    });
+    producers.emplace_back([&]() {
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < num_tasks; ++i)
+            futures.push_back(TaskPool::AddTask([&count]() { count++; }));
+        for (auto &f : futures)
+            f.wait();
+    });
+
+    for (auto &t : producers)
+        t.join();
+
+    ASSERT_EQ (num_producers * num_tasks, count);
+}
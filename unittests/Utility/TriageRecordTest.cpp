@@ -0,0 +1,107 @@
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/TriageRecord.h"
+
+#include <string.h>
+
+using namespace lldb_private;
+
+namespace
+{
+    class TriageRecordTest: public ::testing::Test
+    {
+    };
+
+    // Keep the bytes 8 byte aligned like a memory mapped file.
+    void
+    CopyAligned (const std::vector<uint8_t> &bytes, std::vector<uint64_t> &aligned)
+    {
+        aligned.assign ((bytes.size() + 7) / 8, 0);
+        ::memcpy (aligned.data(), bytes.data(), bytes.size());
+    }
+}
+
+TEST_F (TriageRecordTest, RoundTrip)
+{
+    TriageRecordWriter writer(1234);
+    const uint8_t uuid[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    const uint32_t exe_idx = writer.AddModule(uuid, sizeof(uuid), ConstString("/bin/a.out"), 0x400000);
+    const uint32_t libc_idx = writer.AddModule(nullptr, 0, ConstString("/lib/libc.so.6"), 0x7f0000000000);
+
+    writer.AddThread(100, 1);
+    writer.AddFrame(0x7f0000001000, libc_idx, 0x1000, ConstString("raise"));
+    writer.AddFrame(0x401000, exe_idx, 0x401000, ConstString("main"));
+    writer.AddThread(101, 2);
+    writer.AddFrame(0x7f0000001000, libc_idx, 0x1000, ConstString("raise"));
+    writer.AddFrame(0x500000, TriageRecord::kInvalidIndex, 0x500000, ConstString());
+
+    std::vector<uint8_t> bytes;
+    writer.GetBytes(bytes);
+    std::vector<uint64_t> aligned;
+    CopyAligned(bytes, aligned);
+
+    TriageRecordReader reader;
+    ASSERT_TRUE(reader.SetData(aligned.data(), bytes.size()));
+    EXPECT_EQ(1234u, reader.GetHeader().pid);
+    ASSERT_EQ(2u, reader.GetNumModules());
+    ASSERT_EQ(2u, reader.GetNumThreads());
+
+    // Function names and paths are only stored once.
+    EXPECT_EQ(4u, reader.GetHeader().num_strings);
+
+    const TriageRecord::Module *exe = reader.GetModuleAtIndex(0);
+    ASSERT_TRUE(exe != nullptr);
+    EXPECT_EQ(16u, exe->uuid_size);
+    EXPECT_EQ(0, ::memcmp(uuid, exe->uuid, sizeof(uuid)));
+    EXPECT_STREQ("/bin/a.out", reader.GetString(exe->path));
+    EXPECT_EQ(0x400000u, exe->load_address);
+    EXPECT_EQ(0u, reader.GetModuleAtIndex(1)->uuid_size);
+
+    const TriageRecord::Thread *thread = reader.GetThreadAtIndex(0);
+    ASSERT_TRUE(thread != nullptr);
+    EXPECT_EQ(100u, thread->tid);
+    ASSERT_EQ(2u, thread->num_frames);
+    EXPECT_STREQ("raise", reader.GetString(reader.GetFrameAtIndex(*thread, 0)->name));
+    EXPECT_STREQ("main", reader.GetString(reader.GetFrameAtIndex(*thread, 1)->name));
+    EXPECT_EQ(exe_idx, reader.GetFrameAtIndex(*thread, 1)->module);
+    EXPECT_TRUE(reader.GetFrameAtIndex(*thread, 2) == nullptr);
+
+    thread = reader.GetThreadAtIndex(1);
+    ASSERT_TRUE(thread != nullptr);
+    EXPECT_EQ(2u, thread->index_id);
+    const TriageRecord::Frame *frame = reader.GetFrameAtIndex(*thread, 1);
+    ASSERT_TRUE(frame != nullptr);
+    EXPECT_EQ(0x500000u, frame->pc);
+    EXPECT_EQ(TriageRecord::kInvalidIndex, frame->module);
+    EXPECT_TRUE(reader.GetString(frame->name) == nullptr);
+}
+
+TEST_F (TriageRecordTest, Invalid)
+{
+    TriageRecordWriter writer(1);
+    writer.AddThread(1, 1);
+    writer.AddFrame(0x1000, TriageRecord::kInvalidIndex, 0x1000, ConstString("main"));
+
+    std::vector<uint8_t> bytes;
+    writer.GetBytes(bytes);
+    std::vector<uint64_t> aligned;
+    CopyAligned(bytes, aligned);
+
+    TriageRecordReader reader;
+    ASSERT_TRUE(reader.SetData(aligned.data(), bytes.size()));
+
+    // Truncated
+    EXPECT_FALSE(reader.SetData(aligned.data(), bytes.size() - 1));
+    EXPECT_FALSE(reader.SetData(aligned.data(), sizeof(TriageRecord::Header) - 1));
+    EXPECT_EQ(0u, reader.GetNumThreads());
+
+    // Bad magic
+    std::vector<uint64_t> bad(aligned);
+    reinterpret_cast<char *>(bad.data())[0] = 'X';
+    EXPECT_FALSE(reader.SetData(bad.data(), bytes.size()));
+
+    // Frame table out of range
+    bad = aligned;
+    reinterpret_cast<TriageRecord::Header *>(bad.data())->num_frames = 1000;
+    EXPECT_FALSE(reader.SetData(bad.data(), bytes.size()));
+}
@@ -0,0 +1,60 @@
+//===-- XXHashTest.cpp ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string.h>
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/XXHash.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    uint64_t
+    Hash (const char *str, uint64_t seed = 0)
+    {
+        return XXHash64(str, strlen(str), seed);
+    }
+}
+
+TEST(XXHashTest, ReferenceValues)
+{
+    // The values of the reference implementation.
+    EXPECT_EQ(0xef46db3751d8e999ULL, Hash(""));
+    EXPECT_EQ(0xd24ec4f1a98c6e5bULL, Hash("a"));
+    EXPECT_EQ(0x44bc2cf5ad770999ULL, Hash("abc"));
+    EXPECT_EQ(0xfbcea83c8a378bf1ULL, Hash("Nobody inspects the spammish repetition"));
+}
+
+TEST(XXHashTest, Seed)
+{
+    EXPECT_NE(Hash("abc", 0), Hash("abc", 1));
+    EXPECT_EQ(Hash("abc", 1), Hash("abc", 1));
+}
+
+TEST(XXHashTest, EveryByteCounts)
+{
+    // Lengths that end in each of the tails after the 32 byte stripes.
+    std::vector<uint8_t> bytes(100);
+    for (size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<uint8_t>(i * 37 + 11);
+
+    for (size_t length = 1; length <= bytes.size(); ++length)
+    {
+        const uint64_t hash = XXHash64(bytes.data(), length);
+        EXPECT_NE(hash, XXHash64(bytes.data(), length - 1)) << length;
+        bytes[length - 1] ^= 1;
+        EXPECT_NE(hash, XXHash64(bytes.data(), length)) << length;
+        bytes[length - 1] ^= 1;
+        EXPECT_EQ(hash, XXHash64(bytes.data(), length)) << length;
+    }
+}